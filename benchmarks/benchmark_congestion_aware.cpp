@@ -0,0 +1,717 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "common/Observers.h"
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/Coroutine.h"
+#include "congestion_aware/Dragonfly.h"
+#include "congestion_aware/FatTree.h"
+#include "congestion_aware/FlowModel.h"
+#include "congestion_aware/FullyConnected.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_aware/LatencyHistograms.h"
+#include "congestion_aware/Mesh2D.h"
+#include "congestion_aware/OptimisticSimulation.h"
+#include "congestion_aware/ParallelSimulation.h"
+#include "congestion_aware/Ring.h"
+#include "congestion_aware/SparseMesh2D.h"
+#include "congestion_aware/Switch.h"
+#include "congestion_aware/Torus.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// link bandwidth used by the benchmarks (GB/s)
+constexpr Bandwidth bandwidth = 50.0;
+
+/// link latency used by the benchmarks (ns)
+constexpr Latency latency = 500.0;
+
+/// chunk size used by the benchmarks (1 MB)
+constexpr ChunkSize chunk_size = 1'048'576;
+
+void chunk_arrived_callback(void* const arg) {}
+
+void event_callback(void* const arg) {}
+
+/**
+ * Construct a topology of (about) the given number of NPUs.
+ *
+ * @param npus_count number of NPUs
+ * @return constructed topology
+ */
+template <typename TopologyType> std::shared_ptr<TopologyType> make_topology(const int npus_count) {
+    return std::make_shared<TopologyType>(npus_count, bandwidth, latency);
+}
+
+/**
+ * SparseMesh2D: square grid of npus_count nodes, with the last corner excluded.
+ */
+template <> std::shared_ptr<SparseMesh2D> make_topology<SparseMesh2D>(const int npus_count) {
+    const auto width = static_cast<int>(std::lround(std::sqrt(npus_count)));
+    const auto excluded_coords = std::set<std::pair<int, int>>({{width - 1, width - 1}});
+    return std::make_shared<SparseMesh2D>(width, width, excluded_coords, bandwidth, latency);
+}
+
+/**
+ * Torus: square 2D torus of npus_count nodes.
+ */
+template <> std::shared_ptr<Torus> make_topology<Torus>(const int npus_count) {
+    const auto width = static_cast<int>(std::lround(std::sqrt(npus_count)));
+    return std::make_shared<Torus>(width, width, bandwidth, latency);
+}
+
+template <> std::shared_ptr<FatTree> make_topology<FatTree>(const int npus_count) {
+    return std::make_shared<FatTree>(npus_count, 8, 3, bandwidth, latency);
+}
+
+template <> std::shared_ptr<Dragonfly> make_topology<Dragonfly>(const int npus_count) {
+    // groups of 4 routers with 2 NPUs each, with just enough global links to reach every other group
+    const auto groups_count = npus_count / 8;
+    return std::make_shared<Dragonfly>(npus_count, 2, 4, (groups_count - 1 + 3) / 4, bandwidth, latency);
+}
+
+/**
+ * Run an all-gather (every NPU sends one chunk to every other NPU)
+ * on the given topology until the event queue drains.
+ *
+ * @param topology topology to run the all-gather on
+ * @param event_queue event queue driving the simulation
+ * @return simulation finish time
+ */
+EventTime run_all_gather(Topology& topology, EventQueue& event_queue) {
+    const auto npus_count = topology.get_npus_count();
+
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src == dest) {
+                continue;
+            }
+
+            topology.send(chunk_size, src, dest, chunk_arrived_callback, nullptr);
+        }
+    }
+
+    while (!event_queue.finished()) {
+        event_queue.proceed();
+    }
+
+    return event_queue.get_current_time();
+}
+
+/**
+ * Count the events a workload takes: every hop of a delivered chunk is two events (its serialization and arrival).
+ * The hops are taken from latency histograms, as the event queue only counts events with statistics compiled in
+ * (none are counted without the observer hooks).
+ *
+ * @param topology topology the workload runs on
+ * @param workload function running the workload until the simulation drains
+ * @return number of events
+ */
+template <typename Workload> double count_events(Topology& topology, Workload workload) {
+    if constexpr (!observers_enabled) {
+        workload();
+        return 0;
+    }
+
+    const auto latency_histograms = std::make_shared<LatencyHistograms>();
+    topology.set_latency_histograms(latency_histograms);
+    workload();
+    topology.set_latency_histograms(nullptr);
+
+    const auto hops = latency_histograms->get_hops();
+    return 2 * std::round(hops.get_mean() * static_cast<double>(hops.get_count()));
+}
+
+/**
+ * Report the events of a benchmark and its simulated events per second (of wall time).
+ *
+ * @param state benchmark state
+ * @param events_count number of events of an iteration
+ */
+void report_events(benchmark::State& state, const double events_count) {
+    state.counters["events"] = events_count;
+    state.counters["events_per_second"] =
+        benchmark::Counter(events_count, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/**
+ * Benchmark an all-gather with the given topology and event queue implementation.
+ * state.range(0): event queue type, state.range(1): number of NPUs
+ */
+template <typename TopologyType> void BM_AllGather(benchmark::State& state) {
+    const auto event_queue_type = static_cast<EventQueueType>(state.range(0));
+    const auto npus_count = static_cast<int>(state.range(1));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const auto event_queue = std::make_shared<EventQueue>(event_queue_type);
+        Topology::set_event_queue(event_queue);
+        const auto topology = make_topology<TopologyType>(npus_count);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(run_all_gather(*topology, *event_queue));
+    }
+}
+
+/**
+ * Benchmark a pairwise-exchange all-to-all (Collective, Ring algorithm).
+ * state.range(0): number of NPUs
+ */
+template <typename TopologyType> void BM_AllToAll(benchmark::State& state) {
+    const auto npus_count = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const auto event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+        const auto topology = make_topology<TopologyType>(npus_count);
+        const auto collective_size = topology->get_npus_count() * chunk_size;
+        auto all_to_all = Collective(topology, CollectiveType::AllToAll, CollectiveAlgorithm::Ring, collective_size);
+        state.ResumeTiming();
+
+        all_to_all.start();
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        benchmark::DoNotOptimize(all_to_all.get_finish_time());
+    }
+}
+
+/**
+ * Benchmark a flow-level all-to-all (FlowModel), the NPUs starting one after another,
+ * and flows of 1 to 8 MB draining at different times.
+ * state.range(0): number of NPUs
+ */
+template <typename TopologyType> void BM_FlowModelAllToAll(benchmark::State& state) {
+    const auto npus_count = static_cast<int>(state.range(0));
+    const auto topology = make_topology<TopologyType>(npus_count);
+    constexpr auto start_interval = EventTime(1'000);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto flow_model = FlowModel(topology);
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest++) {
+                if (src != dest) {
+                    flow_model.add_flow(src * start_interval, src, dest, (1 + (7 * src + dest) % 8) * chunk_size);
+                }
+            }
+        }
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(flow_model.run());
+    }
+}
+
+/**
+ * Benchmark a collective (Ring algorithm, a 1 MB shard per NPU) as the NPUs grow, i.e., weak scaling,
+ * reporting its simulated events per second.
+ * state.range(0): collective type, state.range(1): number of NPUs
+ */
+template <typename TopologyType> void BM_CollectiveScaling(benchmark::State& state) {
+    const auto collective_type = static_cast<CollectiveType>(state.range(0));
+    const auto npus_count = static_cast<int>(state.range(1));
+
+    // the events of a run, counted once on a topology of its own
+    const auto counted_event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(counted_event_queue);
+    const auto counted_topology = make_topology<TopologyType>(npus_count);
+    const auto events_count = count_events(*counted_topology, [&] {
+        const auto collective_size = counted_topology->get_npus_count() * chunk_size;
+        auto collective = Collective(counted_topology, collective_type, CollectiveAlgorithm::Ring, collective_size);
+        collective.start();
+        counted_event_queue->run_to_completion();
+    });
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const auto event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+        const auto topology = make_topology<TopologyType>(npus_count);
+        const auto collective_size = topology->get_npus_count() * chunk_size;
+        auto collective = Collective(topology, collective_type, CollectiveAlgorithm::Ring, collective_size);
+        state.ResumeTiming();
+
+        collective.start();
+        event_queue->run_to_completion();
+        benchmark::DoNotOptimize(collective.get_finish_time());
+    }
+
+    report_events(state, events_count);
+}
+
+/**
+ * Count the events of an all-gather (every NPU sends one chunk to every other NPU) on a 2D mesh.
+ *
+ * @param npus_count number of NPUs
+ * @return number of events
+ */
+double count_mesh_all_gather_events(const int npus_count) {
+    const auto event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(event_queue);
+    const auto topology = make_topology<Mesh2D>(npus_count);
+    return count_events(*topology, [&] { run_all_gather(*topology, *event_queue); });
+}
+
+/**
+ * Benchmark an all-gather (every NPU sends one chunk to every other NPU) on a 2D mesh,
+ * invoking the events of the same time concurrently (see EventQueue::set_parallel_invocation).
+ * state.range(0): number of threads, state.range(1): number of NPUs
+ */
+void BM_ParallelInvocation(benchmark::State& state) {
+    const auto threads_count = static_cast<int>(state.range(0));
+    const auto npus_count = static_cast<int>(state.range(1));
+    const auto events_count = count_mesh_all_gather_events(npus_count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const auto event_queue = std::make_shared<EventQueue>();
+        Topology::register_event_resources(*event_queue);
+        event_queue->set_parallel_invocation(threads_count);
+        Topology::set_event_queue(event_queue);
+        const auto topology = make_topology<Mesh2D>(npus_count);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(run_all_gather(*topology, *event_queue));
+    }
+
+    report_events(state, events_count);
+}
+
+/**
+ * Benchmark an all-gather (every NPU sends one chunk to every other NPU) on a 2D mesh,
+ * simulated by a ParallelSimulation of a partition per thread (the same hops, hence events, as sequentially).
+ * state.range(0): number of threads, state.range(1): number of NPUs
+ */
+void BM_ParallelSimulation(benchmark::State& state) {
+    const auto threads_count = static_cast<int>(state.range(0));
+    const auto npus_count = static_cast<int>(state.range(1));
+    const auto events_count = count_mesh_all_gather_events(npus_count);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Topology::set_event_queue(std::make_shared<EventQueue>());
+        const auto topology = make_topology<Mesh2D>(npus_count);
+        auto simulation = ParallelSimulation(topology, threads_count, threads_count);
+        state.ResumeTiming();
+
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    simulation.send(chunk_size, src, dest, chunk_arrived_callback, nullptr);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(simulation.run());
+    }
+
+    report_events(state, events_count);
+}
+
+/**
+ * Benchmark the all-gather of BM_ParallelSimulation on a 2D mesh,
+ * simulated by an OptimisticSimulation of a partition per thread (rolling back stragglers instead of waiting).
+ * The rate counts committed events only; events undone by rollbacks are reported per iteration.
+ * state.range(0): number of threads, state.range(1): number of NPUs
+ */
+void BM_OptimisticSimulation(benchmark::State& state) {
+    const auto threads_count = static_cast<int>(state.range(0));
+    const auto npus_count = static_cast<int>(state.range(1));
+    auto rolled_back_events_count = int64_t(0);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Topology::set_event_queue(std::make_shared<EventQueue>());
+        const auto topology = make_topology<Mesh2D>(npus_count);
+        auto simulation = OptimisticSimulation(topology, threads_count, threads_count);
+        state.ResumeTiming();
+
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    simulation.send(chunk_size, src, dest, chunk_arrived_callback, nullptr);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(simulation.run());
+        rolled_back_events_count += simulation.get_rolled_back_events_count();
+    }
+
+    report_events(state, count_mesh_all_gather_events(npus_count));
+    state.counters["rolled_back"] =
+        benchmark::Counter(static_cast<double>(rolled_back_events_count), benchmark::Counter::kAvgIterations);
+}
+
+/// context of a ring step written with callbacks, allocated for every send
+struct RingStepContext {
+    Topology* topology;
+    DeviceId npu;
+    int remaining_steps;
+};
+
+/**
+ * Callback of a ring step: free the context of the arrived chunk, and send the next one with a new context.
+ *
+ * @param arg pointer to the RingStepContext
+ */
+void ring_step_arrived(void* const arg) {
+    auto* const context = static_cast<RingStepContext*>(arg);
+    const auto topology = context->topology;
+    const auto npu = context->npu;
+    const auto remaining_steps = context->remaining_steps;
+    delete context;
+
+    if (remaining_steps > 0) {
+        auto* const next_context = new RingStepContext{topology, npu, remaining_steps - 1};
+        const auto next_npu = (npu + 1) % topology->get_npus_count();
+        topology->send(chunk_size, npu, next_npu, ring_step_arrived, next_context);
+    }
+}
+
+/**
+ * Ring steps of an NPU written as a coroutine.
+ *
+ * @param topology topology to send through
+ * @param npu NPU sending
+ * @param steps_count number of chunks to send, one after the other
+ * @return coroutine
+ */
+Task ring_steps(Topology& topology, const DeviceId npu, const int steps_count) {
+    const auto next_npu = (npu + 1) % topology.get_npus_count();
+    for (auto step = 0; step < steps_count; step++) {
+        co_await send(topology, chunk_size, npu, next_npu);
+    }
+}
+
+/**
+ * Benchmark a multi-step workload (every NPU of a ring sends npus_count - 1 chunks to the next NPU, one after the
+ * other) written with callbacks and heap-allocated contexts, or as coroutines resumed by the chunk arrivals.
+ * state.range(0): 0 for callbacks, 1 for coroutines, state.range(1): number of NPUs
+ */
+void BM_WorkloadAuthoring(benchmark::State& state) {
+    const auto coroutines = state.range(0) == 1;
+    const auto npus_count = static_cast<int>(state.range(1));
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        const auto event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+        const auto topology = make_topology<Ring>(npus_count);
+        state.ResumeTiming();
+
+        for (auto npu = 0; npu < npus_count; npu++) {
+            if (coroutines) {
+                ring_steps(*topology, npu, npus_count - 1).start();
+            } else {
+                ring_step_arrived(new RingStepContext{topology.get(), npu, npus_count - 1});
+            }
+        }
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        benchmark::DoNotOptimize(event_queue->get_current_time());
+    }
+
+    report_events(state, 2.0 * npus_count * (npus_count - 1));
+}
+
+/**
+ * Benchmark computing routes (route cache disabled) between every pair of NPUs.
+ * state.range(0): number of NPUs
+ */
+template <typename TopologyType> void BM_Route(benchmark::State& state) {
+    const auto npus_count = static_cast<int>(state.range(0));
+    Topology::set_event_queue(std::make_shared<EventQueue>());
+    const auto topology = make_topology<TopologyType>(npus_count);
+    topology->set_route_cache_capacity(0);
+    const auto topology_npus_count = topology->get_npus_count();
+
+    for (auto _ : state) {
+        for (auto src = 0; src < topology_npus_count; src++) {
+            for (auto dest = 0; dest < topology_npus_count; dest++) {
+                if (src != dest) {
+                    benchmark::DoNotOptimize(topology->route(src, dest));
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * topology_npus_count * (topology_npus_count - 1));
+}
+
+/**
+ * Benchmark constructing a square SparseMesh2D from a bitmap of valid cells, with about 1 in 13 dies defective.
+ * state.range(0): grid width (and height)
+ */
+void BM_SparseMesh2DConstruction(benchmark::State& state) {
+    const auto width = static_cast<int>(state.range(0));
+    Topology::set_event_queue(std::make_shared<EventQueue>());
+    auto valid_cells = std::vector<bool>(static_cast<size_t>(width) * width, true);
+    for (auto cell = size_t(0); cell < valid_cells.size(); cell += 13) {
+        valid_cells[cell] = false;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::make_shared<SparseMesh2D>(width, width, valid_cells, bandwidth, latency));
+    }
+
+    state.SetItemsProcessed(state.iterations() * width * width);
+}
+
+/// synthetic network configs of the startup benchmarks
+enum class SyntheticConfig { FullyConnected = 0, Mesh2D, SparseMesh2D, MultiDim };
+
+/**
+ * Write a synthetic network config of the given size into a temporary file.
+ * SparseMesh2D excludes about 1 in 64 cells, drawn from a fixed seed so every run parses the same grid.
+ *
+ * @param config kind of config
+ * @param size number of NPUs (FullyConnected), grid width and height (Mesh2D, SparseMesh2D),
+ *     or NPUs of the last dimension of a Ring(8) x FullyConnected(8) x Switch(size) stack (MultiDim)
+ * @return path of the config file
+ */
+std::string write_synthetic_config(const SyntheticConfig config, const int size) {
+    auto yaml = std::ostringstream();
+    switch (config) {
+    case SyntheticConfig::FullyConnected:
+        yaml << "topology: [ FullyConnected ]\n"
+             << "npus_count: [ " << size << " ]\n"
+             << "bandwidth: [ " << bandwidth << " ]\n"
+             << "latency: [ " << latency << " ]\n";
+        break;
+    case SyntheticConfig::Mesh2D:
+    case SyntheticConfig::SparseMesh2D:
+        yaml << "topology: [ Mesh2D ]\n"
+             << "npus_count: [ " << size * size << " ]\n"
+             << "width: " << size << "\n"
+             << "height: " << size << "\n"
+             << "bandwidth: [ " << bandwidth << " ]\n"
+             << "latency: [ " << latency << " ]\n";
+        if (config == SyntheticConfig::SparseMesh2D) {
+            auto random_engine = std::mt19937(size);
+            auto coord = std::uniform_int_distribution<int>(0, size - 1);
+            yaml << "excluded: [";
+            for (auto i = 0; i < size * size / 64; i++) {
+                yaml << ((i == 0) ? " " : ", ") << "[ " << coord(random_engine) << ", " << coord(random_engine)
+                     << " ]";
+            }
+            yaml << " ]\n";
+        }
+        break;
+    case SyntheticConfig::MultiDim:
+        yaml << "topology: [ Ring, FullyConnected, Switch ]\n"
+             << "npus_count: [ 8, 8, " << size << " ]\n"
+             << "bandwidth: [ 200.0, 100.0, " << bandwidth << " ]\n"
+             << "latency: [ 50.0, 500.0, " << latency << " ]\n";
+        break;
+    }
+
+    const auto path = std::filesystem::temp_directory_path() /
+                      ("benchmark_config_" + std::to_string(static_cast<int>(config)) + "_" + std::to_string(size) +
+                       ".yml");
+    auto file = std::ofstream(path);
+    file << yaml.str();
+    return path.string();
+}
+
+/**
+ * Benchmark parsing a synthetic network config.
+ * state.range(0): synthetic config, state.range(1): its size (see write_synthetic_config)
+ */
+void BM_ParseConfig(benchmark::State& state) {
+    const auto path = write_synthetic_config(static_cast<SyntheticConfig>(state.range(0)),
+                                             static_cast<int>(state.range(1)));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(NetworkParser(path));
+    }
+
+    std::filesystem::remove(path);
+}
+
+/**
+ * Benchmark constructing the topology of a parsed synthetic network config,
+ * reporting its NPUs, links, and memory footprint (bytes) as counters.
+ * state.range(0): synthetic config, state.range(1): its size (see write_synthetic_config)
+ */
+void BM_ConstructTopology(benchmark::State& state) {
+    const auto path = write_synthetic_config(static_cast<SyntheticConfig>(state.range(0)),
+                                             static_cast<int>(state.range(1)));
+    const auto network_parser = NetworkParser(path);
+    std::filesystem::remove(path);
+    const auto event_queue = std::make_shared<EventQueue>();
+
+    for (auto _ : state) {
+        auto topology = construct_topology(network_parser, event_queue);
+
+        // the footprint and the destruction are not part of the construction
+        state.PauseTiming();
+        state.counters["npus"] = topology->get_npus_count();
+        state.counters["links"] = topology->get_links_count();
+        state.counters["bytes"] = static_cast<double>(topology->get_memory_footprint().total_bytes());
+        topology.reset();
+        state.ResumeTiming();
+    }
+}
+
+/**
+ * Register (synthetic config) x (size) arguments, up to 4K NPUs and 256 x 256 grids.
+ */
+void synthetic_config_arguments(benchmark::internal::Benchmark* const benchmark) {
+    for (const auto size : {256, 1'024, 4'096}) {
+        benchmark->Args({static_cast<int64_t>(SyntheticConfig::FullyConnected), size});
+    }
+    for (const auto config : {SyntheticConfig::Mesh2D, SyntheticConfig::SparseMesh2D}) {
+        for (const auto width : {64, 128, 256}) {
+            benchmark->Args({static_cast<int64_t>(config), width});
+        }
+    }
+    for (const auto size : {4, 16, 64}) {
+        benchmark->Args({static_cast<int64_t>(SyntheticConfig::MultiDim), size});
+    }
+    benchmark->ArgNames({"config", "size"});
+}
+
+/**
+ * Benchmark scheduling and proceeding one event while the given number of events are pending.
+ * state.range(0): event queue type, state.range(1): number of pending events
+ */
+void BM_EventQueue(benchmark::State& state) {
+    const auto event_queue_type = static_cast<EventQueueType>(state.range(0));
+    const auto pending_events_count = static_cast<int>(state.range(1));
+    auto event_queue = EventQueue(event_queue_type);
+
+    // pending events spread over distinct times
+    constexpr auto time_step = EventTime(7);
+    for (auto i = 1; i <= pending_events_count; i++) {
+        event_queue.schedule_event(i * time_step, event_callback, nullptr);
+    }
+
+    // hold model: each event scheduled replaces the earliest one
+    for (auto _ : state) {
+        const auto event_time = event_queue.get_current_time() + (pending_events_count + 1) * time_step;
+        event_queue.schedule_event(event_time, event_callback, nullptr);
+        event_queue.proceed();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Register (event queue type) x (NPUs count) arguments.
+ */
+void event_queue_arguments(benchmark::internal::Benchmark* const benchmark) {
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::Heap, EventQueueType::TimingWheel}) {
+        for (const auto npus_count : {16, 64}) {
+            benchmark->Args({static_cast<int64_t>(event_queue_type), npus_count});
+        }
+    }
+    benchmark->ArgNames({"event_queue", "npus"});
+}
+
+/**
+ * Register (collective type) x (NPUs count) arguments.
+ */
+void collective_scaling_arguments(benchmark::internal::Benchmark* const benchmark) {
+    const auto collective_types = {CollectiveType::AllGather, CollectiveType::AllReduce, CollectiveType::AllToAll};
+    for (const auto collective_type : collective_types) {
+        for (const auto npus_count : {16, 64, 256}) {
+            benchmark->Args({static_cast<int64_t>(collective_type), npus_count});
+        }
+    }
+    benchmark->ArgNames({"collective", "npus"});
+}
+
+/**
+ * Register (threads count) x (NPUs count) arguments.
+ */
+void threads_scaling_arguments(benchmark::internal::Benchmark* const benchmark) {
+    for (const auto npus_count : {64, 256}) {
+        for (const auto threads_count : {1, 2, 4, 8}) {
+            benchmark->Args({threads_count, npus_count});
+        }
+    }
+    benchmark->ArgNames({"threads", "npus"});
+}
+
+/**
+ * Register (event queue type) x (pending events count) arguments.
+ */
+void pending_events_arguments(benchmark::internal::Benchmark* const benchmark) {
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::Heap, EventQueueType::TimingWheel}) {
+        for (const auto pending_events_count : {16, 1'024, 65'536}) {
+            benchmark->Args({static_cast<int64_t>(event_queue_type), pending_events_count});
+        }
+    }
+    benchmark->ArgNames({"event_queue", "pending"});
+}
+
+}  // namespace
+
+BENCHMARK(BM_EventQueue)->Apply(pending_events_arguments);
+
+BENCHMARK_TEMPLATE(BM_Route, Ring)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, Switch)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, FullyConnected)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, Mesh2D)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, SparseMesh2D)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, Torus)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, FatTree)->Arg(16)->Arg(64)->ArgName("npus");
+BENCHMARK_TEMPLATE(BM_Route, Dragonfly)->Arg(16)->Arg(64)->ArgName("npus");
+
+BENCHMARK(BM_ParseConfig)->Apply(synthetic_config_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConstructTopology)->Apply(synthetic_config_arguments)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_SparseMesh2DConstruction)->RangeMultiplier(2)->Range(32, 256)->ArgName("width")->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_AllGather, Ring)->Apply(event_queue_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllGather, Switch)->Apply(event_queue_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllGather, FullyConnected)->Apply(event_queue_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllGather, Mesh2D)->Apply(event_queue_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllGather, SparseMesh2D)->Apply(event_queue_arguments)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_AllToAll, Ring)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, Switch)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, FullyConnected)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, Mesh2D)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, SparseMesh2D)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, Torus)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, FatTree)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllToAll, Dragonfly)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_FlowModelAllToAll, Ring)->Arg(16)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_FlowModelAllToAll, Switch)->Arg(32)->Arg(64)->ArgName("npus")->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_CollectiveScaling, Ring)->Apply(collective_scaling_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CollectiveScaling, Switch)->Apply(collective_scaling_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CollectiveScaling, FullyConnected)
+    ->Apply(collective_scaling_arguments)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CollectiveScaling, Mesh2D)->Apply(collective_scaling_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CollectiveScaling, Torus)->Apply(collective_scaling_arguments)->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ParallelInvocation)->Apply(threads_scaling_arguments)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelSimulation)->Apply(threads_scaling_arguments)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OptimisticSimulation)->Apply(threads_scaling_arguments)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WorkloadAuthoring)
+    ->ArgsProduct({{0, 1}, {64, 256}})
+    ->ArgNames({"coroutines", "npus"})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,127 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Type.h"
+#include "congestion_unaware/DelayKernel.h"
+#include "congestion_unaware/FullyConnected.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/Switch.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// link bandwidth used by the benchmarks (GB/s)
+constexpr Bandwidth bandwidth = 50.0;
+
+/// link latency used by the benchmarks (ns)
+constexpr Latency latency = 500.0;
+
+/// chunk size used by the benchmarks (1 MB)
+constexpr ChunkSize chunk_size = 1'048'576;
+
+/**
+ * Benchmark evaluating the full NxN delay matrix with one send() per pair.
+ * state.range(0): number of NPUs
+ */
+template <typename TopologyType> void BM_DelayMatrixSend(benchmark::State& state) {
+    const auto npus_count = static_cast<int>(state.range(0));
+    const auto topology = TopologyType(npus_count, bandwidth, latency);
+
+    for (auto _ : state) {
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    benchmark::DoNotOptimize(topology.send(src, dest, chunk_size));
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * npus_count * (npus_count - 1));
+}
+
+/**
+ * Benchmark evaluating the full NxN delay matrix with one send_batch() per row.
+ * state.range(0): SIMD level, state.range(1): number of NPUs
+ */
+template <typename TopologyType> void BM_DelayMatrixBatch(benchmark::State& state) {
+    DelayKernel::set_simd_level(static_cast<SimdLevel>(state.range(0)));
+    const auto npus_count = static_cast<int>(state.range(1));
+    const auto topology = TopologyType(npus_count, bandwidth, latency);
+
+    // one row of the matrix: (src, every other dest)
+    auto srcs = std::vector<DeviceId>(npus_count - 1);
+    auto dests = std::vector<DeviceId>(npus_count - 1);
+    auto chunk_sizes = std::vector<ChunkSize>(npus_count - 1, chunk_size);
+    auto delays = std::vector<EventTime>(npus_count - 1);
+
+    for (auto _ : state) {
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0, i = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    srcs[i] = src;
+                    dests[i] = dest;
+                    i++;
+                }
+            }
+
+            topology.send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), npus_count - 1);
+            benchmark::DoNotOptimize(delays.data());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * npus_count * (npus_count - 1));
+    DelayKernel::set_simd_level(DelayKernel::get_supported_simd_level());
+}
+
+/**
+ * Benchmark send() throughput on a 3-dim Ring x FullyConnected x Switch topology.
+ * state.range(0): number of NPUs per dimension
+ */
+void BM_MultiDimSend(benchmark::State& state) {
+    const auto dim_size = static_cast<int>(state.range(0));
+    auto topology = MultiDimTopology();
+    topology.append_dimension(std::make_unique<Ring>(dim_size, bandwidth, latency));
+    topology.append_dimension(std::make_unique<FullyConnected>(dim_size, bandwidth, latency));
+    topology.append_dimension(std::make_unique<Switch>(dim_size, bandwidth, latency));
+    const auto npus_count = topology.get_npus_count();
+
+    for (auto _ : state) {
+        for (auto src = 0; src < npus_count; src++) {
+            // a fixed stride of peers per src, covering every dimension
+            for (auto offset = 1; offset < npus_count; offset += 7) {
+                benchmark::DoNotOptimize(topology.send(src, (src + offset) % npus_count, chunk_size));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * npus_count * ((npus_count + 5) / 7));
+}
+
+/**
+ * Register (SIMD level) x (NPUs count) arguments.
+ */
+void simd_arguments(benchmark::internal::Benchmark* const benchmark) {
+    for (const auto simd_level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        benchmark->Args({static_cast<int64_t>(simd_level), 4096});
+    }
+    benchmark->ArgNames({"simd", "npus"});
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_DelayMatrixSend, Ring)->Arg(4096)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DelayMatrixBatch, Ring)->Apply(simd_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DelayMatrixSend, Switch)->Arg(4096)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DelayMatrixBatch, Switch)->Apply(simd_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DelayMatrixSend, FullyConnected)->Arg(4096)->ArgName("npus")->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DelayMatrixBatch, FullyConnected)->Apply(simd_arguments)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MultiDimSend)->Arg(8)->Arg(16)->ArgName("dim_npus")->Unit(benchmark::kMillisecond);
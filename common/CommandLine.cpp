@@ -0,0 +1,134 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/CommandLine.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+CommandLine::CommandLine(const int argc,
+                         const char* const argv[],
+                         const std::vector<std::string>& option_names,
+                         std::string usage) noexcept
+    : usage(std::move(usage)) {
+    assert(argc >= 1);
+
+    for (auto i = 1; i < argc; i++) {
+        const auto argument = std::string(argv[i]);
+        if (argument == "--help") {
+            std::cout << this->usage << std::endl;
+            std::exit(0);
+        }
+        if (argument.rfind("--", 0) != 0) {
+            fail("Unexpected argument " + argument);
+        }
+
+        const auto name = argument.substr(2);
+        if (std::find(option_names.begin(), option_names.end(), name) == option_names.end()) {
+            fail("Unknown option " + argument);
+        }
+        if (i + 1 >= argc) {
+            fail("Missing value of option " + argument);
+        }
+        options[name] = argv[++i];
+    }
+}
+
+bool CommandLine::has(const std::string& name) const noexcept {
+    return options.find(name) != options.end();
+}
+
+std::string CommandLine::get_string(const std::string& name, const std::string& default_value) const noexcept {
+    const auto option = options.find(name);
+    return (option != options.end()) ? option->second : default_value;
+}
+
+uint64_t CommandLine::get_uint64(const std::string& name, const uint64_t default_value) const noexcept {
+    const auto option = options.find(name);
+    if (option == options.end()) {
+        return default_value;
+    }
+
+    const auto& value = option->second;
+    auto* value_end = static_cast<char*>(nullptr);
+    const auto parsed_value = std::strtoull(value.c_str(), &value_end, 10);
+    if (value.empty() || value[0] == '-' || *value_end != '\0') {
+        fail("Option --" + name + " should be a non-negative integer, not " + value);
+    }
+    return parsed_value;
+}
+
+CollectiveType CommandLine::get_collective_type(const std::string& name,
+                                                const CollectiveType default_value) const noexcept {
+    const auto value = get_string(name, "");
+    if (value.empty()) {
+        return default_value;
+    }
+
+    if (value == "AllGather") {
+        return CollectiveType::AllGather;
+    }
+    if (value == "ReduceScatter") {
+        return CollectiveType::ReduceScatter;
+    }
+    if (value == "AllReduce") {
+        return CollectiveType::AllReduce;
+    }
+    if (value == "AllToAll") {
+        return CollectiveType::AllToAll;
+    }
+    fail("Unknown collective type " + value);
+}
+
+CollectiveAlgorithm CommandLine::get_collective_algorithm(const std::string& name,
+                                                          const CollectiveAlgorithm default_value) const noexcept {
+    const auto value = get_string(name, "");
+    if (value.empty()) {
+        return default_value;
+    }
+
+    if (value == "Ring") {
+        return CollectiveAlgorithm::Ring;
+    }
+    if (value == "Direct") {
+        return CollectiveAlgorithm::Direct;
+    }
+    if (value == "HalvingDoubling") {
+        return CollectiveAlgorithm::HalvingDoubling;
+    }
+    if (value == "Hierarchical") {
+        return CollectiveAlgorithm::Hierarchical;
+    }
+    fail("Unknown collective algorithm " + value);
+}
+
+EventQueueType CommandLine::get_event_queue_type(const std::string& name,
+                                                 const EventQueueType default_value) const noexcept {
+    const auto value = get_string(name, "");
+    if (value.empty()) {
+        return default_value;
+    }
+
+    if (value == "List") {
+        return EventQueueType::List;
+    }
+    if (value == "Heap") {
+        return EventQueueType::Heap;
+    }
+    if (value == "TimingWheel") {
+        return EventQueueType::TimingWheel;
+    }
+    fail("Unknown event queue type " + value);
+}
+
+void CommandLine::fail(const std::string& message) const noexcept {
+    std::cerr << "[Error] (network/analytical) " << message << std::endl;
+    std::cerr << usage << std::endl;
+    std::exit(-1);
+}
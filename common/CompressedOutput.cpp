@@ -0,0 +1,298 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/CompressedOutput.h"
+#include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_ZLIB
+    #include <zlib.h>
+#endif
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// number of compressed bytes produced per deflate/inflate call
+constexpr size_t zlib_chunk_size = 1 << 16;
+
+/**
+ * Check whether bytes start a gzip stream.
+ *
+ * @param contents bytes to check
+ * @return true if the gzip magic bytes lead the contents, false otherwise
+ */
+bool gzip_stream(const std::string& contents) noexcept {
+    return contents.size() >= 2 && static_cast<unsigned char>(contents[0]) == 0x1F &&
+           static_cast<unsigned char>(contents[1]) == 0x8B;
+}
+
+}  // namespace
+
+struct CompressedOutput::Deflater {
+#ifdef NETWORK_ANALYTICAL_ENABLE_ZLIB
+    /// deflate stream state
+    z_stream stream = {};
+
+    /// compressed bytes, before being written
+    std::vector<char> compressed = std::vector<char>(zlib_chunk_size);
+
+    ~Deflater() noexcept {
+        deflateEnd(&stream);
+    }
+#endif
+};
+
+bool CompressedOutput::supports(const Compression compression) noexcept {
+    switch (compression) {
+    case Compression::None:
+        return true;
+    case Compression::Gzip:
+#ifdef NETWORK_ANALYTICAL_ENABLE_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    default:
+        return false;
+    }
+}
+
+std::string CompressedOutput::read_file(const std::string& path) noexcept {
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[Error] (network/analytical) " << "cannot open " << path << std::endl;
+        std::exit(-1);
+    }
+    auto contents = std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    // uncompressed files are returned as is
+    if (!gzip_stream(contents)) {
+        return contents;
+    }
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_ZLIB
+    auto stream = z_stream();
+    [[maybe_unused]] const auto init_status = inflateInit2(&stream, 16 + MAX_WBITS);
+    assert(init_status == Z_OK);
+    assert(contents.size() <= UINT_MAX);
+    stream.next_in = reinterpret_cast<Bytef*>(contents.data());
+    stream.avail_in = static_cast<uInt>(contents.size());
+
+    auto decompressed = std::string();
+    auto inflated = std::vector<char>(zlib_chunk_size);
+    auto status = Z_OK;
+    while (status == Z_OK) {
+        stream.next_out = reinterpret_cast<Bytef*>(inflated.data());
+        stream.avail_out = static_cast<uInt>(inflated.size());
+        status = inflate(&stream, Z_NO_FLUSH);
+        decompressed.append(inflated.data(), inflated.size() - stream.avail_out);
+    }
+    inflateEnd(&stream);
+
+    if (status != Z_STREAM_END) {
+        std::cerr << "[Error] (network/analytical) " << path << " is truncated or corrupted" << std::endl;
+        std::exit(-1);
+    }
+    return decompressed;
+#else
+    std::cerr << "[Error] (network/analytical) " << "cannot read " << path
+              << ": gzip compression isn't available (zlib wasn't found at build time)" << std::endl;
+    std::exit(-1);
+#endif
+}
+
+CompressedOutput::CompressedOutput(const std::string& path,
+                                   const Compression compression,
+                                   const size_t block_size,
+                                   const int max_pending_blocks) noexcept
+    : std::ostream(nullptr),
+      file(path, std::ios::binary | std::ios::trunc),
+      compression(compression),
+      deflater(nullptr),
+      block_size(block_size),
+      max_pending_blocks(max_pending_blocks),
+      buffer(*this),
+      closing(false),
+      input_size(0),
+      output_size(0) {
+    assert(block_size > 0);
+    assert(max_pending_blocks > 0);
+
+    if (!supports(compression)) {
+        std::cerr << "[Error] (network/analytical) " << "cannot write " << path
+                  << ": gzip compression isn't available (zlib wasn't found at build time)" << std::endl;
+        std::exit(-1);
+    }
+    if (!file) {
+        std::cerr << "[Error] (network/analytical) " << "cannot open " << path << std::endl;
+        std::exit(-1);
+    }
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_ZLIB
+    if (compression == Compression::Gzip) {
+        // fastest level: compression runs alongside the simulation and should keep up with it
+        deflater = std::make_unique<Deflater>();
+        [[maybe_unused]] const auto init_status =
+            deflateInit2(&deflater->stream, Z_BEST_SPEED, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+        assert(init_status == Z_OK);
+    }
+#endif
+
+    rdbuf(&buffer);
+    writer = std::thread(&CompressedOutput::write_blocks, this);
+}
+
+CompressedOutput::~CompressedOutput() noexcept {
+    close();
+}
+
+void CompressedOutput::close() noexcept {
+    if (!writer.joinable()) {
+        return;
+    }
+
+    // hand over the last (partial) block, then let the writer finish the stream
+    buffer.hand_over();
+    {
+        const auto lock = std::lock_guard<std::mutex>(blocks_mutex);
+        closing = true;
+    }
+    blocks_changed.notify_all();
+    writer.join();
+
+    file.close();
+}
+
+bool CompressedOutput::is_open() const noexcept {
+    return writer.joinable();
+}
+
+uint64_t CompressedOutput::get_input_size() const noexcept {
+    return input_size;
+}
+
+uint64_t CompressedOutput::get_output_size() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(blocks_mutex);
+    return output_size;
+}
+
+void CompressedOutput::hand_over(std::vector<char>& block) noexcept {
+    assert(!block.empty());
+
+    input_size += block.size();
+
+    // wait for room, so a writer falling behind doesn't pile up memory
+    auto lock = std::unique_lock<std::mutex>(blocks_mutex);
+    assert(!closing);
+    blocks_changed.wait(lock, [this] { return pending_blocks.size() < static_cast<size_t>(max_pending_blocks); });
+    pending_blocks.push_back(std::move(block));
+
+    // keep filling a recycled block if any
+    if (free_blocks.empty()) {
+        block = std::vector<char>();
+    } else {
+        block = std::move(free_blocks.back());
+        free_blocks.pop_back();
+    }
+
+    lock.unlock();
+    blocks_changed.notify_all();
+    block.resize(block_size);
+}
+
+void CompressedOutput::write_blocks() noexcept {
+    auto lock = std::unique_lock<std::mutex>(blocks_mutex);
+
+    while (true) {
+        blocks_changed.wait(lock, [this] { return !pending_blocks.empty() || closing; });
+        if (pending_blocks.empty()) {
+            // closing with nothing left to write
+            lock.unlock();
+            const auto written_size = write_bytes(nullptr, 0, true);
+            lock.lock();
+            output_size += written_size;
+            return;
+        }
+
+        // write without holding the lock, so blocks keep being handed over meanwhile
+        auto block = std::move(pending_blocks.front());
+        pending_blocks.pop_front();
+        lock.unlock();
+        const auto written_size = write_bytes(block.data(), block.size(), false);
+        lock.lock();
+
+        output_size += written_size;
+        block.clear();
+        free_blocks.push_back(std::move(block));
+        blocks_changed.notify_all();
+    }
+}
+
+uint64_t CompressedOutput::write_bytes(const char* const data, const size_t size, const bool finish) noexcept {
+    if (deflater == nullptr) {
+        file.write(data, static_cast<std::streamsize>(size));
+        return size;
+    }
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_ZLIB
+    auto& stream = deflater->stream;
+    auto& compressed = deflater->compressed;
+    assert(size <= UINT_MAX);
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(size);
+
+    // deflate until the input is consumed (and the stream finished) without filling the output
+    auto written_size = uint64_t(0);
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+        stream.avail_out = static_cast<uInt>(compressed.size());
+        [[maybe_unused]] const auto status = deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+        assert(status != Z_STREAM_ERROR);
+
+        const auto compressed_size = compressed.size() - stream.avail_out;
+        file.write(compressed.data(), static_cast<std::streamsize>(compressed_size));
+        written_size += compressed_size;
+    } while (stream.avail_out == 0);
+    return written_size;
+#else
+    return 0;
+#endif
+}
+
+CompressedOutput::BlockBuffer::BlockBuffer(CompressedOutput& output) noexcept
+    : output(output),
+      block(output.block_size) {
+    setp(block.data(), block.data() + block.size());
+}
+
+void CompressedOutput::BlockBuffer::hand_over() noexcept {
+    const auto size = static_cast<size_t>(pptr() - pbase());
+    if (size == 0) {
+        return;
+    }
+
+    block.resize(size);
+    output.hand_over(block);
+    setp(block.data(), block.data() + block.size());
+}
+
+CompressedOutput::BlockBuffer::int_type CompressedOutput::BlockBuffer::overflow(const int_type ch) {
+    hand_over();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int CompressedOutput::BlockBuffer::sync() {
+    hand_over();
+    return 0;
+}
@@ -0,0 +1,421 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/ExecutionTrace.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Parse an unsigned integer attribute value.
+ *
+ * @param value attribute value
+ * @param parsed output: parsed value
+ * @return true if the whole value is a valid unsigned integer, false otherwise
+ */
+bool parse_unsigned(const std::string& value, uint64_t& parsed) noexcept {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        return false;
+    }
+    parsed = std::strtoull(value.c_str(), nullptr, 10);
+    return true;
+}
+
+}  // namespace
+
+ExecutionTraceReader::ExecutionTraceReader(const std::string& trace_path) noexcept
+    : trace_path(trace_path),
+      trace_file(trace_path),
+      line_number(0) {
+    if (!trace_file) {
+        std::cerr << "[Error] (network/analytical) " << "cannot open execution trace " << trace_path << std::endl;
+        std::exit(-1);
+    }
+}
+
+bool ExecutionTraceReader::next(ExecutionTraceNode& node) noexcept {
+    auto line = std::string();
+    while (std::getline(trace_file, line)) {
+        line_number++;
+
+        // skip empty lines and comments
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        node = ExecutionTraceNode();
+        auto has_id = false;
+        auto has_type = false;
+
+        // parse key=value attributes
+        auto tokens = std::istringstream(line);
+        auto token = std::string();
+        while (tokens >> token) {
+            const auto separator = token.find('=');
+            if (separator == std::string::npos) {
+                parse_error("attribute without value: " + token);
+            }
+            const auto key = token.substr(0, separator);
+            const auto value = token.substr(separator + 1);
+            auto number = uint64_t(0);
+
+            if (key == "type") {
+                has_type = true;
+                if (value == "COMP_NODE") {
+                    node.node_type = ExecutionTraceNodeType::Compute;
+                } else if (value == "COMM_SEND_NODE") {
+                    node.node_type = ExecutionTraceNodeType::Send;
+                } else if (value == "COMM_RECV_NODE") {
+                    node.node_type = ExecutionTraceNodeType::Recv;
+                } else if (value == "COMM_COLL_NODE") {
+                    node.node_type = ExecutionTraceNodeType::Collective;
+                } else {
+                    parse_error("unsupported node type: " + value);
+                }
+            } else if (key == "comm_type") {
+                if (value == "ALL_REDUCE") {
+                    node.collective_type = CollectiveType::AllReduce;
+                } else if (value == "ALL_GATHER") {
+                    node.collective_type = CollectiveType::AllGather;
+                } else if (value == "REDUCE_SCATTER") {
+                    node.collective_type = CollectiveType::ReduceScatter;
+                } else if (value == "ALL_TO_ALL") {
+                    node.collective_type = CollectiveType::AllToAll;
+                } else {
+                    parse_error("unsupported collective type: " + value);
+                }
+            } else if (key == "deps") {
+                // comma-separated node ids (may be empty)
+                auto dependencies = std::istringstream(value);
+                auto dependency = std::string();
+                while (std::getline(dependencies, dependency, ',')) {
+                    if (!parse_unsigned(dependency, number)) {
+                        parse_error("invalid dependency: " + dependency);
+                    }
+                    node.dependencies.push_back(number);
+                }
+            } else if (!parse_unsigned(value, number)) {
+                parse_error("invalid value of " + key + ": " + value);
+            } else if (key == "id") {
+                has_id = true;
+                node.id = number;
+            } else if (key == "comm_src" || key == "comm_dst") {
+                node.peer = static_cast<DeviceId>(number);
+            } else if (key == "comm_size") {
+                node.size = number;
+            } else if (key == "comm_tag") {
+                node.tag = static_cast<int>(number);
+            } else if (key == "duration_micros") {
+                node.duration = number * 1'000;
+            } else {
+                parse_error("unsupported attribute: " + key);
+            }
+        }
+
+        if (!has_id || !has_type) {
+            parse_error("node without id or type");
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void ExecutionTraceReader::parse_error(const std::string& message) const noexcept {
+    std::cerr << "[Error] (network/analytical) " << "execution trace " << trace_path << ", line " << line_number
+              << ": " << message << std::endl;
+    std::exit(-1);
+}
+
+ExecutionTraceReplay::ExecutionTraceReplay(ExecutionTraceNetwork& network,
+                                           const std::vector<std::string>& trace_paths,
+                                           const int window_size) noexcept
+    : network(network),
+      npus_count(network.get_npus_count()),
+      window_size(window_size),
+      issuing(false),
+      finish_reported(false),
+      completed_nodes_count(0),
+      peak_window_size(0),
+      finish_time(0),
+      callback(nullptr),
+      callback_arg(nullptr) {
+    assert(window_size > 0);
+
+    if (static_cast<int>(trace_paths.size()) != npus_count) {
+        std::cerr << "[Error] (network/analytical) " << "got " << trace_paths.size() << " execution traces for "
+                  << npus_count << " NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    for (const auto& trace_path : trace_paths) {
+        traces.emplace_back(trace_path);
+    }
+}
+
+void ExecutionTraceReplay::start(const Callback callback, const CallbackArg callback_arg) noexcept {
+    this->callback = callback;
+    this->callback_arg = callback_arg;
+
+    // read the first window of every trace, then issue whatever is ready
+    for (auto npu = 0; npu < npus_count; npu++) {
+        fill_window(npu);
+    }
+    issue_ready_nodes();
+}
+
+bool ExecutionTraceReplay::finished() const noexcept {
+    for (const auto& trace : traces) {
+        if (!trace.exhausted || !trace.window.empty()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+EventTime ExecutionTraceReplay::get_finish_time() const noexcept {
+    assert(finished());
+
+    return finish_time;
+}
+
+uint64_t ExecutionTraceReplay::get_completed_nodes_count() const noexcept {
+    return completed_nodes_count;
+}
+
+int ExecutionTraceReplay::get_peak_window_size() const noexcept {
+    return peak_window_size;
+}
+
+void ExecutionTraceReplay::operation_completed(void* const operation_ptr) noexcept {
+    assert(operation_ptr != nullptr);
+
+    // recycle the operation
+    auto* const operation = static_cast<Operation*>(operation_ptr);
+    auto* const replay = operation->replay;
+    const auto npu = operation->npu;
+    const auto node_id = operation->node_id;
+    const auto collective_id = operation->collective_id;
+    replay->free_operations.push_back(operation);
+
+    if (collective_id < 0) {
+        replay->complete_node(npu, node_id);
+        return;
+    }
+
+    // a collective completes the collective node of every NPU
+    const auto collective = replay->ready_collectives.find(collective_id);
+    assert(collective != replay->ready_collectives.end());
+    const auto collective_nodes = std::move(collective->second);
+    replay->ready_collectives.erase(collective);
+    for (const auto& [collective_npu, collective_node_id] : collective_nodes) {
+        replay->complete_node(collective_npu, collective_node_id);
+    }
+}
+
+void ExecutionTraceReplay::message_delivered(void* const operation_ptr) noexcept {
+    assert(operation_ptr != nullptr);
+
+    // recycle the operation
+    auto* const operation = static_cast<Operation*>(operation_ptr);
+    auto* const replay = operation->replay;
+    const auto src = operation->npu;
+    const auto node_id = operation->node_id;
+    replay->free_operations.push_back(operation);
+
+    // the send node is still in its window until completed here
+    const auto& send_node = replay->traces[src].window.at(node_id).node;
+    const auto key = MessageKey(send_node.peer, src, send_node.tag);
+
+    // hand the message to a waiting recv, or keep it until one is ready
+    const auto waiting = replay->waiting_recvs.find(key);
+    if (waiting != replay->waiting_recvs.end()) {
+        const auto recv_node_id = waiting->second.front();
+        waiting->second.pop_front();
+        if (waiting->second.empty()) {
+            replay->waiting_recvs.erase(waiting);
+        }
+        replay->complete_node(std::get<0>(key), recv_node_id);
+    } else {
+        replay->unmatched_messages[key]++;
+    }
+
+    replay->complete_node(src, node_id);
+}
+
+void ExecutionTraceReplay::fill_window(const DeviceId npu) noexcept {
+    assert(0 <= npu && npu < npus_count);
+
+    auto& trace = traces[npu];
+    auto node = ExecutionTraceNode();
+    while (!trace.exhausted && static_cast<int>(trace.window.size()) < window_size) {
+        if (!trace.reader.next(node)) {
+            trace.exhausted = true;
+            break;
+        }
+
+        // ids increase, so a dependency is either in the window or completed
+        if (trace.started && node.id <= trace.last_read_id) {
+            std::cerr << "[Error] (network/analytical) " << "execution trace of NPU " << npu << ": node " << node.id
+                      << " doesn't increase the node id" << std::endl;
+            std::exit(-1);
+        }
+        const auto is_p2p = (node.node_type == ExecutionTraceNodeType::Send) ||
+                            (node.node_type == ExecutionTraceNodeType::Recv);
+        const auto is_comm = is_p2p || (node.node_type == ExecutionTraceNodeType::Collective);
+        if ((is_p2p && (node.peer < 0 || node.peer >= npus_count || node.peer == npu)) ||
+            (is_comm && node.size == 0)) {
+            std::cerr << "[Error] (network/analytical) " << "execution trace of NPU " << npu << ": node " << node.id
+                      << " has an invalid peer or size" << std::endl;
+            std::exit(-1);
+        }
+
+        auto window_node = WindowNode();
+        for (const auto dependency : node.dependencies) {
+            if (dependency >= node.id) {
+                std::cerr << "[Error] (network/analytical) " << "execution trace of NPU " << npu << ": node "
+                          << node.id << " depends on a later node " << dependency << std::endl;
+                std::exit(-1);
+            }
+            const auto dependency_node = trace.window.find(dependency);
+            if (dependency_node != trace.window.end()) {
+                dependency_node->second.dependents.push_back(node.id);
+                window_node.pending_dependencies++;
+            }
+        }
+
+        trace.started = true;
+        trace.last_read_id = node.id;
+        const auto node_id = node.id;
+        const auto ready = (window_node.pending_dependencies == 0);
+        window_node.node = std::move(node);
+        trace.window.emplace(node_id, std::move(window_node));
+        peak_window_size = std::max(peak_window_size, static_cast<int>(trace.window.size()));
+
+        if (ready) {
+            ready_nodes.emplace_back(npu, node_id);
+        }
+    }
+}
+
+void ExecutionTraceReplay::issue_ready_nodes() noexcept {
+    // nodes completing while being issued make others ready: issue them in this loop
+    if (issuing) {
+        return;
+    }
+    issuing = true;
+
+    while (!ready_nodes.empty()) {
+        const auto [npu, node_id] = ready_nodes.back();
+        ready_nodes.pop_back();
+        issue_node(npu, node_id);
+    }
+
+    issuing = false;
+
+    // the last node completed (or the traces are empty)
+    if (!finish_reported && finished()) {
+        finish_reported = true;
+        finish_time = network.get_scheduler().get_current_time();
+        if (callback != nullptr) {
+            (*callback)(callback_arg);
+        }
+    }
+}
+
+void ExecutionTraceReplay::issue_node(const DeviceId npu, const uint64_t node_id) noexcept {
+    auto& trace = traces[npu];
+    const auto& node = trace.window.at(node_id).node;
+    auto& scheduler = network.get_scheduler();
+
+    switch (node.node_type) {
+    case ExecutionTraceNodeType::Compute: {
+        // network-only replay: compute takes its recorded duration
+        auto* const operation = acquire_operation(npu, node_id, -1);
+        scheduler.schedule_event(scheduler.get_current_time() + node.duration, operation_completed,
+                                 static_cast<void*>(operation));
+        break;
+    }
+    case ExecutionTraceNodeType::Send: {
+        auto* const operation = acquire_operation(npu, node_id, -1);
+        network.send(npu, node.peer, node.size, message_delivered, static_cast<void*>(operation));
+        break;
+    }
+    case ExecutionTraceNodeType::Recv: {
+        // receive a delivered message, or wait for it
+        const auto key = MessageKey(npu, node.peer, node.tag);
+        const auto unmatched = unmatched_messages.find(key);
+        if (unmatched != unmatched_messages.end()) {
+            if (--unmatched->second == 0) {
+                unmatched_messages.erase(unmatched);
+            }
+            complete_node(npu, node_id);
+        } else {
+            waiting_recvs[key].push_back(node_id);
+        }
+        break;
+    }
+    case ExecutionTraceNodeType::Collective: {
+        // the collective starts once every NPU reached its collective node of the same sequence number
+        const auto collective_id = trace.collectives_issued++;
+        auto& collective_nodes = ready_collectives[collective_id];
+        collective_nodes.emplace_back(npu, node_id);
+        if (static_cast<int>(collective_nodes.size()) == npus_count) {
+            auto* const operation = acquire_operation(npu, node_id, collective_id);
+            network.run_collective(node.collective_type, node.size, operation_completed,
+                                   static_cast<void*>(operation));
+        }
+        break;
+    }
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical) " << "not supported execution trace node type" << std::endl;
+        std::exit(-1);
+    }
+}
+
+void ExecutionTraceReplay::complete_node(const DeviceId npu, const uint64_t node_id) noexcept {
+    auto& trace = traces[npu];
+    const auto window_node = trace.window.find(node_id);
+    assert(window_node != trace.window.end());
+
+    // release the dependents
+    for (const auto dependent : window_node->second.dependents) {
+        auto& dependent_node = trace.window.at(dependent);
+        assert(dependent_node.pending_dependencies > 0);
+        if (--dependent_node.pending_dependencies == 0) {
+            ready_nodes.emplace_back(npu, dependent);
+        }
+    }
+    trace.window.erase(window_node);
+    completed_nodes_count++;
+
+    // the freed slot lets the trace stream further
+    fill_window(npu);
+    issue_ready_nodes();
+}
+
+ExecutionTraceReplay::Operation* ExecutionTraceReplay::acquire_operation(const DeviceId npu,
+                                                                         const uint64_t node_id,
+                                                                         const int collective_id) noexcept {
+    auto* operation = static_cast<Operation*>(nullptr);
+    if (!free_operations.empty()) {
+        operation = free_operations.back();
+        free_operations.pop_back();
+    } else {
+        operation = &operations.emplace_back();
+    }
+    *operation = Operation{this, npu, node_id, collective_id};
+
+    return operation;
+}
@@ -0,0 +1,122 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/FrameSocket.h"
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// largest frame accepted, so a corrupted length can't exhaust the memory
+constexpr uint64_t max_frame_size = 1ull << 32;
+
+/**
+ * Write a whole buffer into a socket.
+ *
+ * @return true if written, false if the peer is gone
+ */
+bool write_fully(const int fd, const char* data, size_t size) noexcept {
+    while (size > 0) {
+        const auto written = send(fd, data, size, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * Read a whole buffer from a socket.
+ *
+ * @return true if read, false if the peer is gone
+ */
+bool read_fully(const int fd, char* data, size_t size) noexcept {
+    while (size > 0) {
+        const auto read_size = recv(fd, data, size, 0);
+        if (read_size <= 0) {
+            return false;
+        }
+        data += read_size;
+        size -= static_cast<size_t>(read_size);
+    }
+    return true;
+}
+
+}  // namespace
+
+bool NetworkAnalytical::send_frame(const int fd, const std::string& frame) noexcept {
+    const auto frame_size = static_cast<uint64_t>(frame.size());
+    return write_fully(fd, reinterpret_cast<const char*>(&frame_size), sizeof(frame_size)) &&
+           write_fully(fd, frame.data(), frame.size());
+}
+
+bool NetworkAnalytical::receive_frame(const int fd, std::string& frame) noexcept {
+    auto frame_size = uint64_t();
+    if (!read_fully(fd, reinterpret_cast<char*>(&frame_size), sizeof(frame_size)) || frame_size > max_frame_size) {
+        return false;
+    }
+    frame.resize(frame_size);
+    return read_fully(fd, frame.data(), frame.size());
+}
+
+int NetworkAnalytical::listen_tcp(const uint16_t port, uint16_t& bound_port) noexcept {
+    const auto fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    // a restarted coordinator can take the port over right away
+    const auto reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    auto address = sockaddr_in();
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    auto address_length = static_cast<socklen_t>(sizeof(address));
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, SOMAXCONN) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&address), &address_length) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    bound_port = ntohs(address.sin_port);
+    return fd;
+}
+
+int NetworkAnalytical::connect_tcp(const std::string& host, const uint16_t port) noexcept {
+    auto hints = addrinfo();
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    auto* addresses = static_cast<addrinfo*>(nullptr);
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0) {
+        return -1;
+    }
+
+    auto fd = -1;
+    for (auto* address = addresses; address != nullptr && fd == -1; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd != -1 && connect(fd, address->ai_addr, address->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+
+    // frames are small request/answer pairs: send them right away
+    if (fd != -1) {
+        const auto no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    }
+    return fd;
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace NetworkAnalytical;
+
+Histogram::Histogram(const int precision_bits) noexcept
+    : precision_bits(precision_bits),
+      count(0),
+      sum(0),
+      min(std::numeric_limits<uint64_t>::max()),
+      max(0) {
+    if (precision_bits < 1 || precision_bits > 16) {
+        std::cerr << "[Error] (network/analytical) " << "histogram precision should be 1 to 16 bits, got "
+                  << precision_bits << std::endl;
+        std::exit(-1);
+    }
+
+    exact_count = uint64_t(1) << precision_bits;
+    half_count = exact_count / 2;
+    counts.assign(exact_count + ((64 - precision_bits) * half_count), 0);
+}
+
+void Histogram::merge(const Histogram& other) noexcept {
+    assert(other.precision_bits == precision_bits);
+
+    for (size_t index = 0; index < counts.size(); index++) {
+        counts[index] += other.counts[index];
+    }
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void Histogram::reset() noexcept {
+    std::fill(counts.begin(), counts.end(), 0);
+    count = 0;
+    sum = 0;
+    min = std::numeric_limits<uint64_t>::max();
+    max = 0;
+}
+
+uint64_t Histogram::get_count() const noexcept {
+    return count;
+}
+
+uint64_t Histogram::get_min() const noexcept {
+    return (count > 0) ? min : 0;
+}
+
+uint64_t Histogram::get_max() const noexcept {
+    return max;
+}
+
+double Histogram::get_mean() const noexcept {
+    return (count > 0) ? static_cast<double>(sum) / count : 0;
+}
+
+uint64_t Histogram::get_percentile(const double percentile) const noexcept {
+    assert(0 <= percentile && percentile <= 100);
+
+    if (count == 0) {
+        return 0;
+    }
+
+    // the bucket holding the sample of that rank (the first sample for the 0th percentile)
+    const auto rank = std::max(static_cast<uint64_t>(std::ceil(percentile / 100 * count)), uint64_t(1));
+    auto seen_count = uint64_t(0);
+    for (size_t index = 0; index < counts.size(); index++) {
+        seen_count += counts[index];
+        if (seen_count >= rank) {
+            return std::clamp(bucket_max(index), get_min(), max);
+        }
+    }
+
+    // shouldn't reach here
+    return max;
+}
+
+int Histogram::get_buckets_count() const noexcept {
+    return static_cast<int>(counts.size());
+}
+
+uint64_t Histogram::bucket_max(const uint64_t index) const noexcept {
+    if (index < exact_count) {
+        return index;
+    }
+
+    // reverse bucket_index: the bucket spans 2^shift values (wrapping to the largest value for the last one)
+    const auto group = (index - exact_count) / half_count;
+    const auto mantissa = half_count + ((index - exact_count) % half_count);
+    const auto shift = group + 1;
+    return ((mantissa + 1) << shift) - 1;
+}
@@ -0,0 +1,61 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Logger.h"
+#include <cassert>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+
+// only errors and warnings are printed by default
+LogLevel Logger::level = LogLevel::Warning;
+
+std::ostream* Logger::output = &std::cerr;
+
+void Logger::set_level(const LogLevel new_level) noexcept {
+    level = new_level;
+}
+
+LogLevel Logger::get_level() noexcept {
+    return level;
+}
+
+bool Logger::enabled(const LogLevel log_level) noexcept {
+    assert(log_level != LogLevel::Off);
+
+    return static_cast<int>(log_level) <= static_cast<int>(level);
+}
+
+void Logger::set_output(std::ostream& new_output) noexcept {
+    output = &new_output;
+}
+
+std::ostream& Logger::stream(const LogLevel log_level) noexcept {
+    assert(output != nullptr);
+
+    // write the level tag
+    switch (log_level) {
+    case LogLevel::Error:
+        *output << "[Error] ";
+        break;
+    case LogLevel::Warning:
+        *output << "[Warning] ";
+        break;
+    case LogLevel::Info:
+        *output << "[Info] ";
+        break;
+    case LogLevel::Debug:
+        *output << "[Debug] ";
+        break;
+    case LogLevel::Trace:
+        *output << "[Trace] ";
+        break;
+    default:
+        // LogLevel::Off is never printed
+        assert(false);
+    }
+
+    return *output;
+}
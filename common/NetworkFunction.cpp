@@ -4,6 +4,7 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
@@ -15,3 +16,76 @@ Bandwidth NetworkAnalytical::bw_GBps_to_Bpns(const Bandwidth bw_GBps) noexcept {
     // 1 s is 10^9 ns
     return bw_GBps * (1 << 30) / (1'000'000'000);  // GB/s to B/ns
 }
+
+uint64_t NetworkAnalytical::mix_bits(uint64_t value) noexcept {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+ChunkSize NetworkAnalytical::ring_stripe_size(const ChunkSize chunk_size,
+                                             const int hops_count,
+                                             const int opposite_hops_count) noexcept {
+    assert(hops_count > 0);
+    assert(opposite_hops_count > 0);
+
+    // split quotient and remainder, so large transfers don't overflow
+    const auto distance = static_cast<ChunkSize>(hops_count + opposite_hops_count);
+    const auto share = static_cast<ChunkSize>(opposite_hops_count);
+    return (chunk_size / distance) * share + (chunk_size % distance) * share / distance;
+}
+
+std::pair<int, int> NetworkAnalytical::hilbert_cell(const int side, int position) noexcept {
+    assert(side > 0 && (side & (side - 1)) == 0);
+
+    auto x = 0;
+    auto y = 0;
+    for (auto scale = 1; scale < side; scale *= 2) {
+        const auto rx = 1 & (position / 2);
+        const auto ry = 1 & (position ^ rx);
+
+        // rotate the quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = scale - 1 - x;
+                y = scale - 1 - y;
+            }
+            std::swap(x, y);
+        }
+
+        x += scale * rx;
+        y += scale * ry;
+        position /= 4;
+    }
+    return {x, y};
+}
+
+std::vector<int> NetworkAnalytical::locality_order(const int width, const int height) noexcept {
+    assert(width > 0);
+    assert(height > 0);
+
+    // squares of the smallest power of 2 holding the shorter side, so at most 8x the cells are walked
+    auto side = 1;
+    while (side < std::min(width, height)) {
+        side *= 2;
+    }
+    const auto along_x = width >= height;
+    const auto squares_count = ((along_x ? width : height) + side - 1) / side;
+
+    auto order = std::vector<int>();
+    order.reserve(static_cast<size_t>(width) * height);
+    for (auto square = 0; square < squares_count; square++) {
+        for (auto position = 0; position < side * side; position++) {
+            auto [x, y] = hilbert_cell(side, position);
+            if (along_x) {
+                x += square * side;
+            } else {
+                y += square * side;
+            }
+            if (x < width && y < height) {
+                order.push_back(y * width + x);
+            }
+        }
+    }
+    return order;
+}
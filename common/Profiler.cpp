@@ -0,0 +1,137 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Profiler.h"
+#include <cassert>
+#include <chrono>
+#include <iomanip>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+
+#if NETWORK_ANALYTICAL_ENABLE_ITT
+    #include <ittnotify.h>
+#endif
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// number of zones
+constexpr int zones_count = static_cast<int>(ProfileZone::Count);
+
+/// names of the zones
+constexpr const char* zone_names[zones_count] = {"event_loop", "chunk_arrival", "link_free", "route",
+                                                 "send",       "link_send",     "callback"};
+
+#if NETWORK_ANALYTICAL_ENABLE_ITT
+/// ITT domain of the zones
+__itt_domain* const itt_domain = __itt_domain_create("network/analytical");
+
+/**
+ * Get the ITT name handle of a zone, created once.
+ *
+ * @param zone zone
+ * @return name handle of the zone
+ */
+__itt_string_handle* itt_zone_handle(const ProfileZone zone) noexcept {
+    static const auto handles = [] {
+        auto zone_handles = std::array<__itt_string_handle*, zones_count>();
+        for (auto zone_index = 0; zone_index < zones_count; zone_index++) {
+            zone_handles[zone_index] = __itt_string_handle_create(zone_names[zone_index]);
+        }
+        return zone_handles;
+    }();
+    return handles[static_cast<int>(zone)];
+}
+#endif
+
+}  // namespace
+
+std::array<std::atomic<uint64_t>, static_cast<int>(ProfileZone::Count)> Profiler::calls = {};
+
+std::array<std::atomic<uint64_t>, static_cast<int>(ProfileZone::Count)> Profiler::cycles = {};
+
+const char* Profiler::zone_name(const ProfileZone zone) noexcept {
+    assert(0 <= static_cast<int>(zone) && static_cast<int>(zone) < zones_count);
+
+    return zone_names[static_cast<int>(zone)];
+}
+
+uint64_t Profiler::read_cycles() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    // no timestamp counter: ns of a steady clock
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+}
+
+void Profiler::record(const ProfileZone zone, const uint64_t zone_cycles) noexcept {
+    assert(0 <= static_cast<int>(zone) && static_cast<int>(zone) < zones_count);
+
+    // zones may be entered by several threads at once (e.g., parallel simulations)
+    calls[static_cast<int>(zone)].fetch_add(1, std::memory_order_relaxed);
+    cycles[static_cast<int>(zone)].fetch_add(zone_cycles, std::memory_order_relaxed);
+}
+
+ProfileCounters Profiler::get_counters(const ProfileZone zone) noexcept {
+    assert(0 <= static_cast<int>(zone) && static_cast<int>(zone) < zones_count);
+
+    auto counters = ProfileCounters();
+    counters.calls = calls[static_cast<int>(zone)].load(std::memory_order_relaxed);
+    counters.cycles = cycles[static_cast<int>(zone)].load(std::memory_order_relaxed);
+    return counters;
+}
+
+void Profiler::reset() noexcept {
+    for (auto zone_index = 0; zone_index < zones_count; zone_index++) {
+        calls[zone_index].store(0, std::memory_order_relaxed);
+        cycles[zone_index].store(0, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::report(std::ostream& output) noexcept {
+    const auto event_loop_cycles = get_counters(ProfileZone::EventLoop).cycles;
+    const auto flags = output.flags();
+    const auto precision = output.precision();
+
+    output << std::left << std::setw(16) << "zone" << std::right << std::setw(14) << "calls" << std::setw(18)
+           << "cycles" << std::setw(14) << "cycles/call" << std::setw(10) << "share" << '\n';
+    for (auto zone_index = 0; zone_index < zones_count; zone_index++) {
+        const auto counters = get_counters(static_cast<ProfileZone>(zone_index));
+        if (counters.calls == 0) {
+            continue;
+        }
+
+        const auto cycles_per_call = static_cast<double>(counters.cycles) / static_cast<double>(counters.calls);
+        output << std::left << std::setw(16) << zone_names[zone_index] << std::right << std::setw(14)
+               << counters.calls << std::setw(18) << counters.cycles << std::setw(14) << std::fixed
+               << std::setprecision(1) << cycles_per_call;
+        if (event_loop_cycles > 0) {
+            const auto share = 100.0 * static_cast<double>(counters.cycles) / static_cast<double>(event_loop_cycles);
+            output << std::setw(9) << share << '%';
+        }
+        output << '\n';
+    }
+    output.flags(flags);
+    output.precision(precision);
+}
+
+ProfileScope::ProfileScope(const ProfileZone zone) noexcept : zone(zone), start_cycles(Profiler::read_cycles()) {
+#if NETWORK_ANALYTICAL_ENABLE_ITT
+    __itt_task_begin(itt_domain, __itt_null, __itt_null, itt_zone_handle(zone));
+#endif
+}
+
+ProfileScope::~ProfileScope() noexcept {
+    Profiler::record(zone, Profiler::read_cycles() - start_cycles);
+
+#if NETWORK_ANALYTICAL_ENABLE_ITT
+    __itt_task_end(itt_domain);
+#endif
+}
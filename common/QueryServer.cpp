@@ -0,0 +1,230 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/QueryServer.h"
+#include "common/BinaryBuffer.h"
+#include "common/FrameSocket.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Build the address of a Unix domain socket.
+ *
+ * @param socket_path path of the socket
+ * @return address of the socket
+ */
+sockaddr_un socket_address(const std::string& socket_path) noexcept {
+    auto address = sockaddr_un();
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "[Error] (network/analytical) " << "Socket path " << socket_path << " is too long" << std::endl;
+        std::exit(-1);
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    return address;
+}
+
+}  // namespace
+
+std::string ChunkQuery::encode() const noexcept {
+    assert(srcs.size() == dests.size() && srcs.size() == chunk_sizes.size());
+
+    auto request = std::string();
+    append_binary(request, static_cast<uint32_t>(config_path.size()));
+    append_binary(request, config_path.data(), config_path.size());
+    append_binary(request, static_cast<uint32_t>(srcs.size()));
+    append_binary(request, srcs.data(), srcs.size());
+    append_binary(request, dests.data(), dests.size());
+    append_binary(request, chunk_sizes.data(), chunk_sizes.size());
+    return request;
+}
+
+bool ChunkQuery::decode(const std::string& request, ChunkQuery& query) noexcept {
+    auto reader = BinaryReader(request, 0);
+
+    const auto path_length = reader.read<uint32_t>();
+    if (!reader.has(path_length)) {
+        return false;
+    }
+    query.config_path.resize(path_length);
+    reader.read(query.config_path.data(), path_length);
+
+    const auto chunks_count = reader.read<uint32_t>();
+    if (!reader.has(static_cast<uint64_t>(chunks_count) * (2 * sizeof(DeviceId) + sizeof(ChunkSize)))) {
+        return false;
+    }
+    query.srcs.resize(chunks_count);
+    query.dests.resize(chunks_count);
+    query.chunk_sizes.resize(chunks_count);
+    reader.read(query.srcs.data(), chunks_count);
+    reader.read(query.dests.data(), chunks_count);
+    reader.read(query.chunk_sizes.data(), chunks_count);
+    return reader.done();
+}
+
+std::string ChunkQuery::encode_answer(const std::vector<EventTime>& times) noexcept {
+    auto answer = std::string();
+    append_binary(answer, times.data(), times.size());
+    return answer;
+}
+
+bool ChunkQuery::decode_answer(const std::string& answer, std::vector<EventTime>& times) noexcept {
+    if (answer.empty() || answer.size() % sizeof(EventTime) != 0) {
+        return false;
+    }
+    times.resize(answer.size() / sizeof(EventTime));
+    std::memcpy(times.data(), answer.data(), answer.size());
+    return true;
+}
+
+QueryServer::QueryServer(std::string socket_path, Handler handler, const size_t cache_capacity) noexcept
+    : socket_path(std::move(socket_path)),
+      handler(std::move(handler)),
+      cache_capacity(cache_capacity),
+      listen_fd(-1),
+      requests_count(0),
+      cache_hits_count(0) {
+    assert(this->handler != nullptr);
+}
+
+QueryServer::~QueryServer() noexcept {
+    stop();
+}
+
+void QueryServer::start() noexcept {
+    assert(listen_fd == -1);
+
+    const auto address = socket_address(socket_path);
+    listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str());
+    if (listen_fd == -1 || bind(listen_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listen_fd, SOMAXCONN) != 0) {
+        std::cerr << "[Error] (network/analytical) " << "Cannot listen on socket " << socket_path << std::endl;
+        std::exit(-1);
+    }
+
+    accept_thread = std::thread(&QueryServer::accept_clients, this);
+}
+
+void QueryServer::stop() noexcept {
+    if (listen_fd == -1) {
+        return;
+    }
+
+    // wake up the blocking accept and recv calls
+    shutdown(listen_fd, SHUT_RDWR);
+    accept_thread.join();
+    close(listen_fd);
+    listen_fd = -1;
+
+    {
+        const auto lock = std::lock_guard<std::mutex>(clients_mutex);
+        for (const auto client_fd : client_fds) {
+            shutdown(client_fd, SHUT_RDWR);
+        }
+    }
+    for (auto& client_thread : client_threads) {
+        client_thread.join();
+    }
+    for (const auto client_fd : client_fds) {
+        close(client_fd);
+    }
+    client_threads.clear();
+    client_fds.clear();
+
+    unlink(socket_path.c_str());
+}
+
+uint64_t QueryServer::get_requests_count() const noexcept {
+    return requests_count.load();
+}
+
+uint64_t QueryServer::get_cache_hits_count() const noexcept {
+    return cache_hits_count.load();
+}
+
+void QueryServer::accept_clients() noexcept {
+    while (true) {
+        const auto client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd == -1) {
+            // the server stopped
+            return;
+        }
+
+        const auto lock = std::lock_guard<std::mutex>(clients_mutex);
+        client_fds.push_back(client_fd);
+        client_threads.emplace_back(&QueryServer::serve_client, this, client_fd);
+    }
+}
+
+void QueryServer::serve_client(const int client_fd) noexcept {
+    auto request = std::string();
+    while (receive_frame(client_fd, request)) {
+        if (!send_frame(client_fd, answer(request))) {
+            return;
+        }
+    }
+}
+
+std::string QueryServer::answer(const std::string& request) noexcept {
+    requests_count++;
+
+    if (cache_capacity > 0) {
+        const auto lock = std::lock_guard<std::mutex>(cache_mutex);
+        const auto cached_answer = cached_answers.find(request);
+        if (cached_answer != cached_answers.end()) {
+            cache_hits_count++;
+            return cached_answer->second;
+        }
+    }
+
+    // concurrent misses of the same request are both computed, as the handler gives the same answer
+    auto new_answer = handler(request);
+
+    // malformed requests aren't cached
+    if (cache_capacity > 0 && !new_answer.empty()) {
+        const auto lock = std::lock_guard<std::mutex>(cache_mutex);
+        if (cached_answers.emplace(request, new_answer).second) {
+            cached_requests.push_back(request);
+            if (cached_requests.size() > cache_capacity) {
+                cached_answers.erase(cached_requests.front());
+                cached_requests.pop_front();
+            }
+        }
+    }
+
+    return new_answer;
+}
+
+QueryClient::QueryClient(const std::string& socket_path) noexcept {
+    const auto address = socket_address(socket_path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "[Error] (network/analytical) " << "Cannot connect to socket " << socket_path << std::endl;
+        std::exit(-1);
+    }
+}
+
+QueryClient::~QueryClient() noexcept {
+    close(fd);
+}
+
+std::string QueryClient::query(const std::string& request) noexcept {
+    auto answer = std::string();
+    if (!send_frame(fd, request) || !receive_frame(fd, answer)) {
+        return std::string();
+    }
+    return answer;
+}
@@ -0,0 +1,81 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Reclaimer.h"
+
+using namespace NetworkAnalytical;
+
+Reclaimer& Reclaimer::get() noexcept {
+    static auto reclaimer = Reclaimer();
+    return reclaimer;
+}
+
+Reclaimer::Reclaimer() noexcept : releasing(false), stopping(false), released_count(0) {}
+
+Reclaimer::~Reclaimer() noexcept {
+    {
+        const auto lock = std::lock_guard<std::mutex>(pending_mutex);
+        stopping = true;
+    }
+    pending_changed.notify_all();
+
+    if (release_thread.joinable()) {
+        release_thread.join();
+    }
+}
+
+void Reclaimer::drain() noexcept {
+    auto lock = std::unique_lock<std::mutex>(pending_mutex);
+    pending_changed.wait(lock, [this] { return pending.empty() && !releasing; });
+}
+
+uint64_t Reclaimer::get_released_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(pending_mutex);
+    return released_count;
+}
+
+void Reclaimer::enqueue(std::unique_ptr<Holder> holder) noexcept {
+    {
+        const auto lock = std::lock_guard<std::mutex>(pending_mutex);
+        if (pending.size() < static_cast<size_t>(max_pending_count)) {
+            pending.push_back(std::move(holder));
+            if (!release_thread.joinable()) {
+                release_thread = std::thread(&Reclaimer::release_pending, this);
+            }
+        }
+    }
+
+    // the background thread is behind: release on the discarding thread
+    if (holder != nullptr) {
+        holder.reset();
+        const auto lock = std::lock_guard<std::mutex>(pending_mutex);
+        released_count++;
+        return;
+    }
+
+    pending_changed.notify_all();
+}
+
+void Reclaimer::release_pending() noexcept {
+    auto lock = std::unique_lock<std::mutex>(pending_mutex);
+    while (true) {
+        pending_changed.wait(lock, [this] { return !pending.empty() || stopping; });
+        if (pending.empty()) {
+            // stopping, with nothing left to release
+            return;
+        }
+
+        // release outside the lock, so storages keep being handed over meanwhile
+        auto holder = std::move(pending.front());
+        pending.pop_front();
+        releasing = true;
+        lock.unlock();
+        holder.reset();
+        lock.lock();
+        releasing = false;
+        released_count++;
+        pending_changed.notify_all();
+    }
+}
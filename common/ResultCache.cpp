@@ -0,0 +1,180 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/ResultCache.h"
+#include "common/BinaryBuffer.h"
+#include "common/TimeBase.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+/*
+ * Result file layout (native byte order, no padding):
+ *   header: magic (8 B), version (u32)
+ *   key length (u32), then its characters
+ *   finish time (u64)
+ *   stats count (u32), then per stat: name length (u32), its characters, and value (u64)
+ */
+
+namespace {
+
+/// first bytes of every result file
+constexpr char result_magic[8] = {'A', 'N', 'A', 'N', 'E', 'T', 'R', 'C'};
+
+/// backend the results are simulated with
+#ifdef NETWORK_ANALYTICAL_CONGESTION_AWARE
+constexpr const char* backend_name = "congestion_aware";
+#else
+constexpr const char* backend_name = "congestion_unaware";
+#endif
+
+/**
+ * Hash bytes (64-bit FNV-1a).
+ *
+ * @param bytes bytes to hash
+ * @return hash of the bytes
+ */
+uint64_t hash_bytes(const std::string& bytes) noexcept {
+    auto hash = static_cast<uint64_t>(0xCBF29CE484222325ULL);
+    for (const auto byte : bytes) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/**
+ * Format a hash as 16 hex digits.
+ *
+ * @param hash hash to format
+ * @return hex digits
+ */
+std::string to_hex(const uint64_t hash) noexcept {
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string(hex);
+}
+
+}  // namespace
+
+ResultCache::ResultCache(std::string directory) noexcept
+    : directory(std::move(directory)),
+      hits_count(0),
+      misses_count(0) {
+    auto error = std::error_code();
+    std::filesystem::create_directories(this->directory, error);
+    if (!std::filesystem::is_directory(this->directory)) {
+        std::cerr << "[Error] (network/analytical) " << "Cannot create result cache directory " << this->directory
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+std::string ResultCache::make_key(const NetworkParser& network_parser, const std::string& workload) noexcept {
+    return std::string(backend_name) + ";ticks_per_ns=" + std::to_string(ticks_per_ns) +
+           ";network=" + to_hex(network_parser.get_config_hash()) + ";workload=" + workload;
+}
+
+uint64_t ResultCache::hash_file(const std::string& path) noexcept {
+    auto contents = std::string();
+    if (!read_binary_file(path, contents)) {
+        std::cerr << "[Error] (network/analytical) " << "bad file: " << path << std::endl;
+        std::exit(-1);
+    }
+    return hash_bytes(contents);
+}
+
+bool ResultCache::lookup(const std::string& key, CachedResult& result) const noexcept {
+    auto buffer = std::string();
+    if (!read_binary_file(get_path(key), buffer) || buffer.size() < sizeof(result_magic) ||
+        std::memcmp(buffer.data(), result_magic, sizeof(result_magic)) != 0) {
+        return false;
+    }
+
+    // stale versions and colliding keys are misses
+    auto reader = BinaryReader(buffer, sizeof(result_magic));
+    const auto file_version = reader.read<uint32_t>();
+    const auto key_length = reader.read<uint32_t>();
+    if (file_version != version || key_length != key.size() || !reader.has(key_length)) {
+        return false;
+    }
+    auto file_key = std::string(key_length, '\0');
+    reader.read(file_key.data(), key_length);
+    if (file_key != key) {
+        return false;
+    }
+
+    auto file_result = CachedResult();
+    file_result.finish_time = reader.read<uint64_t>();
+    const auto stats_count = reader.read<uint32_t>();
+    for (auto i = uint32_t(0); i < stats_count; i++) {
+        const auto name_length = reader.read<uint32_t>();
+        if (!reader.has(name_length)) {
+            return false;
+        }
+        auto name = std::string(name_length, '\0');
+        reader.read(name.data(), name_length);
+        file_result.stats[name] = reader.read<uint64_t>();
+    }
+    if (!reader.done()) {
+        return false;
+    }
+
+    result = std::move(file_result);
+    return true;
+}
+
+bool ResultCache::store(const std::string& key, const CachedResult& result) const noexcept {
+    auto buffer = std::string();
+    buffer.append(result_magic, sizeof(result_magic));
+    append_binary(buffer, version);
+    append_binary(buffer, static_cast<uint32_t>(key.size()));
+    buffer.append(key);
+    append_binary(buffer, static_cast<uint64_t>(result.finish_time));
+    append_binary(buffer, static_cast<uint32_t>(result.stats.size()));
+    for (const auto& [name, value] : result.stats) {
+        append_binary(buffer, static_cast<uint32_t>(name.size()));
+        buffer.append(name);
+        append_binary(buffer, value);
+    }
+    return write_binary_file(get_path(key), buffer);
+}
+
+CachedResult ResultCache::get_or_simulate(const std::string& key,
+                                          const std::function<CachedResult()>& simulate) noexcept {
+    assert(simulate != nullptr);
+
+    auto result = CachedResult();
+    if (lookup(key, result)) {
+        hits_count++;
+        return result;
+    }
+
+    misses_count++;
+    result = simulate();
+    if (!store(key, result)) {
+        std::cerr << "[Warning] (network/analytical) " << "cannot write cached result " << get_path(key)
+                  << std::endl;
+    }
+    return result;
+}
+
+uint64_t ResultCache::get_hits_count() const noexcept {
+    return hits_count.load();
+}
+
+uint64_t ResultCache::get_misses_count() const noexcept {
+    return misses_count.load();
+}
+
+std::string ResultCache::get_path(const std::string& key) const noexcept {
+    return (std::filesystem::path(directory) / (to_hex(hash_bytes(key)) + ".result")).string();
+}
@@ -0,0 +1,333 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/SendGraph.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace NetworkAnalytical;
+
+SendGraph::SendGraph() noexcept : max_npu_id(-1), finalized(false) {}
+
+SendNodeId SendGraph::add_send(const DeviceId src,
+                               const DeviceId dest,
+                               const ChunkSize size,
+                               const EventTime delay) noexcept {
+    assert(!finalized);
+    assert(src >= 0 && dest >= 0);
+    assert(size >= 0);
+    assert(delay >= 0);
+
+    if (size > 0 && src == dest) {
+        std::cerr << "[Error] (network/analytical) " << "send graph node sends " << size << " bytes from NPU " << src
+                  << " to itself" << std::endl;
+        std::exit(-1);
+    }
+    assert(srcs.size() < std::numeric_limits<SendNodeId>::max());
+
+    const auto node = static_cast<SendNodeId>(srcs.size());
+    srcs.push_back(src);
+    dests.push_back(dest);
+    sizes.push_back(size);
+    max_npu_id = std::max({max_npu_id, src, dest});
+
+    // delays are only stored once a node has one
+    if (delay > 0 && delays.empty()) {
+        delays.resize(node, 0);
+    }
+    if (!delays.empty()) {
+        delays.push_back(delay);
+    }
+
+    return node;
+}
+
+void SendGraph::add_dependency(const SendNodeId dependency, const SendNodeId dependent) noexcept {
+    assert(!finalized);
+    assert(dependency < srcs.size() && dependent < srcs.size());
+
+    if (dependency == dependent) {
+        std::cerr << "[Error] (network/analytical) " << "send graph node " << dependency << " depends on itself"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    added_dependencies.emplace_back(dependency, dependent);
+}
+
+void SendGraph::finalize() noexcept {
+    assert(!finalized);
+    assert(added_dependencies.size() < std::numeric_limits<uint32_t>::max());
+
+    // count the dependents and dependencies of each node
+    const auto nodes_count = srcs.size();
+    dependents_offsets.assign(nodes_count + 1, 0);
+    dependencies_counts.assign(nodes_count, 0);
+    for (const auto& [dependency, dependent] : added_dependencies) {
+        dependents_offsets[dependency + 1]++;
+        dependencies_counts[dependent]++;
+    }
+    for (auto node = size_t(0); node < nodes_count; node++) {
+        dependents_offsets[node + 1] += dependents_offsets[node];
+    }
+
+    // place the dependents of each node in its row, in insertion order
+    dependents.resize(added_dependencies.size());
+    auto next_slots = std::vector<uint32_t>(dependents_offsets.begin(), dependents_offsets.end() - 1);
+    for (const auto& [dependency, dependent] : added_dependencies) {
+        dependents[next_slots[dependency]++] = dependent;
+    }
+    added_dependencies = std::vector<std::pair<SendNodeId, SendNodeId>>();
+    finalized = true;
+
+    // every node is reached by releasing dependencies (Kahn's algorithm) unless they form a cycle
+    auto pending = dependencies_counts;
+    auto reached = std::vector<SendNodeId>();
+    reached.reserve(nodes_count);
+    for (auto node = SendNodeId(0); node < nodes_count; node++) {
+        if (pending[node] == 0) {
+            reached.push_back(node);
+        }
+    }
+    for (auto i = size_t(0); i < reached.size(); i++) {
+        const auto [first, last] = get_dependents(reached[i]);
+        for (auto dependent = first; dependent != last; dependent++) {
+            if (--pending[*dependent] == 0) {
+                reached.push_back(*dependent);
+            }
+        }
+    }
+    if (reached.size() != nodes_count) {
+        std::cerr << "[Error] (network/analytical) " << "send graph dependencies form a cycle ("
+                  << (nodes_count - reached.size()) << " nodes never get ready)" << std::endl;
+        std::exit(-1);
+    }
+}
+
+bool SendGraph::is_finalized() const noexcept {
+    return finalized;
+}
+
+SendNodeId SendGraph::get_nodes_count() const noexcept {
+    return static_cast<SendNodeId>(srcs.size());
+}
+
+uint64_t SendGraph::get_dependencies_count() const noexcept {
+    return finalized ? dependents.size() : added_dependencies.size();
+}
+
+DeviceId SendGraph::get_src(const SendNodeId node) const noexcept {
+    assert(node < srcs.size());
+
+    return srcs[node];
+}
+
+DeviceId SendGraph::get_dest(const SendNodeId node) const noexcept {
+    assert(node < dests.size());
+
+    return dests[node];
+}
+
+ChunkSize SendGraph::get_size(const SendNodeId node) const noexcept {
+    assert(node < sizes.size());
+
+    return sizes[node];
+}
+
+EventTime SendGraph::get_delay(const SendNodeId node) const noexcept {
+    assert(node < srcs.size());
+
+    return delays.empty() ? 0 : delays[node];
+}
+
+uint32_t SendGraph::get_node_dependencies_count(const SendNodeId node) const noexcept {
+    assert(finalized);
+    assert(node < dependencies_counts.size());
+
+    return dependencies_counts[node];
+}
+
+std::pair<const SendNodeId*, const SendNodeId*> SendGraph::get_dependents(const SendNodeId node) const noexcept {
+    assert(finalized);
+    assert(node < srcs.size());
+
+    const auto* const row = dependents.data();
+    return {row + dependents_offsets[node], row + dependents_offsets[node + 1]};
+}
+
+DeviceId SendGraph::get_max_npu_id() const noexcept {
+    return max_npu_id;
+}
+
+uint64_t SendGraph::get_allocated_bytes() const noexcept {
+    return sizeof(SendGraph) + srcs.capacity() * sizeof(DeviceId) + dests.capacity() * sizeof(DeviceId) +
+           sizes.capacity() * sizeof(ChunkSize) + delays.capacity() * sizeof(EventTime) +
+           added_dependencies.capacity() * sizeof(std::pair<SendNodeId, SendNodeId>) +
+           dependents_offsets.capacity() * sizeof(uint32_t) + dependents.capacity() * sizeof(SendNodeId) +
+           dependencies_counts.capacity() * sizeof(uint32_t);
+}
+
+SendGraphRun::SendGraphRun(ExecutionTraceNetwork& network, const SendGraph& graph) noexcept
+    : network(network),
+      graph(graph),
+      ready_head(0),
+      issuing(false),
+      finish_reported(false),
+      completed_nodes_count(0),
+      in_flight_count(0),
+      peak_in_flight_count(0),
+      finish_time(0),
+      callback(nullptr),
+      callback_arg(nullptr) {
+    assert(graph.is_finalized());
+
+    if (graph.get_max_npu_id() >= network.get_npus_count()) {
+        std::cerr << "[Error] (network/analytical) " << "send graph refers to NPU " << graph.get_max_npu_id()
+                  << " of a network of " << network.get_npus_count() << " NPUs" << std::endl;
+        std::exit(-1);
+    }
+}
+
+void SendGraphRun::start(const Callback callback, const CallbackArg callback_arg) noexcept {
+    this->callback = callback;
+    this->callback_arg = callback_arg;
+
+    // the nodes without dependencies are ready, in id order
+    const auto nodes_count = graph.get_nodes_count();
+    pending_dependencies.resize(nodes_count);
+    for (auto node = SendNodeId(0); node < nodes_count; node++) {
+        pending_dependencies[node] = graph.get_node_dependencies_count(node);
+        if (pending_dependencies[node] == 0) {
+            ready_nodes.push_back(node);
+        }
+    }
+    issue_ready_nodes();
+}
+
+bool SendGraphRun::finished() const noexcept {
+    return completed_nodes_count == graph.get_nodes_count();
+}
+
+EventTime SendGraphRun::get_finish_time() const noexcept {
+    assert(finished());
+
+    return finish_time;
+}
+
+uint64_t SendGraphRun::get_completed_nodes_count() const noexcept {
+    return completed_nodes_count;
+}
+
+uint64_t SendGraphRun::get_peak_in_flight_count() const noexcept {
+    return peak_in_flight_count;
+}
+
+void SendGraphRun::delay_elapsed(void* const operation_ptr) noexcept {
+    assert(operation_ptr != nullptr);
+
+    auto* const operation = static_cast<Operation*>(operation_ptr);
+    operation->run->send(operation);
+}
+
+void SendGraphRun::operation_completed(void* const operation_ptr) noexcept {
+    assert(operation_ptr != nullptr);
+
+    // recycle the operation
+    auto* const operation = static_cast<Operation*>(operation_ptr);
+    auto* const run = operation->run;
+    const auto node = operation->node;
+    run->free_operations.push_back(operation);
+
+    run->complete_node(node);
+    run->issue_ready_nodes();
+}
+
+void SendGraphRun::issue_ready_nodes() noexcept {
+    // nodes completing while being issued make others ready: issue them in this loop
+    if (issuing) {
+        return;
+    }
+    issuing = true;
+
+    while (ready_head < ready_nodes.size()) {
+        issue_node(ready_nodes[ready_head++]);
+    }
+    ready_nodes.clear();
+    ready_head = 0;
+
+    issuing = false;
+
+    // the last node completed (or the graph is empty)
+    if (!finish_reported && finished()) {
+        finish_reported = true;
+        finish_time = network.get_scheduler().get_current_time();
+        if (callback != nullptr) {
+            (*callback)(callback_arg);
+        }
+    }
+}
+
+void SendGraphRun::issue_node(const SendNodeId node) noexcept {
+    auto* const operation = acquire_operation(node);
+    in_flight_count++;
+    peak_in_flight_count = std::max(peak_in_flight_count, in_flight_count);
+
+    // wait for the delay first, if any
+    const auto delay = graph.get_delay(node);
+    if (delay > 0) {
+        auto& scheduler = network.get_scheduler();
+        scheduler.schedule_event(scheduler.get_current_time() + delay, delay_elapsed, static_cast<void*>(operation));
+        return;
+    }
+
+    send(operation);
+}
+
+void SendGraphRun::send(Operation* const operation) noexcept {
+    assert(operation != nullptr);
+
+    const auto node = operation->node;
+    const auto size = graph.get_size(node);
+    if (size == 0) {
+        free_operations.push_back(operation);
+        complete_node(node);
+        issue_ready_nodes();
+        return;
+    }
+
+    network.send(graph.get_src(node), graph.get_dest(node), size, operation_completed, static_cast<void*>(operation));
+}
+
+void SendGraphRun::complete_node(const SendNodeId node) noexcept {
+    assert(in_flight_count > 0);
+
+    // release the dependents
+    const auto [first, last] = graph.get_dependents(node);
+    for (auto dependent = first; dependent != last; dependent++) {
+        assert(pending_dependencies[*dependent] > 0);
+        if (--pending_dependencies[*dependent] == 0) {
+            ready_nodes.push_back(*dependent);
+        }
+    }
+
+    in_flight_count--;
+    completed_nodes_count++;
+}
+
+SendGraphRun::Operation* SendGraphRun::acquire_operation(const SendNodeId node) noexcept {
+    auto* operation = static_cast<Operation*>(nullptr);
+    if (!free_operations.empty()) {
+        operation = free_operations.back();
+        free_operations.pop_back();
+    } else {
+        operation = &operations.emplace_back();
+    }
+    *operation = Operation{this, node};
+
+    return operation;
+}
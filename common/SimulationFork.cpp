@@ -0,0 +1,127 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/SimulationFork.h"
+#include "common/FrameSocket.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/// branch running in a child process
+struct RunningBranch {
+    /// branch id
+    int branch;
+
+    /// process of the branch
+    pid_t pid;
+
+    /// socket the result arrives through
+    int fd;
+};
+
+/**
+ * Start a branch in a child process.
+ *
+ * @param branch_id id of the branch
+ * @param branch simulates the branch
+ * @return the running branch
+ */
+RunningBranch start_branch(const int branch_id, const SimulationBranch& branch) noexcept {
+    // fds[0]: parent's end, fds[1]: child's end
+    auto fds = std::array<int, 2>();
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds.data()) != 0) {
+        std::cerr << "[Error] (network/analytical) " << "failed to create the socket of branch " << branch_id
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // buffered output would be written by both processes otherwise
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(nullptr);
+
+    const auto pid = fork();
+    if (pid == -1) {
+        std::cerr << "[Error] (network/analytical) " << "failed to fork branch " << branch_id << std::endl;
+        std::exit(-1);
+    }
+
+    if (pid == 0) {
+        // child: simulate the branch, report its result, and leave without running the parent's exit handlers
+        close(fds[0]);
+        const auto result = branch(branch_id);
+        const auto sent = send_frame(fds[1], result);
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+        _exit(sent ? 0 : 1);
+    }
+
+    close(fds[1]);
+    return RunningBranch{branch_id, pid, fds[0]};
+}
+
+/**
+ * Wait for a branch to finish and collect its result.
+ *
+ * @param running_branch the branch
+ * @param result output: result of the branch
+ */
+void finish_branch(const RunningBranch& running_branch, std::string& result) noexcept {
+    const auto received = receive_frame(running_branch.fd, result);
+    close(running_branch.fd);
+
+    auto status = 0;
+    while (waitpid(running_branch.pid, &status, 0) == -1) {
+        // interrupted by a signal: wait again
+    }
+    if (!received || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "[Error] (network/analytical) " << "branch " << running_branch.branch
+                  << " failed before returning its result" << std::endl;
+        std::exit(-1);
+    }
+}
+
+}  // namespace
+
+std::vector<std::string> NetworkAnalytical::fork_branches(const int branches_count,
+                                                          const SimulationBranch& branch,
+                                                          int max_concurrent_branches) noexcept {
+    assert(branches_count >= 0);
+    assert(max_concurrent_branches >= 0);
+
+    if (max_concurrent_branches == 0) {
+        max_concurrent_branches = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // keep at most max_concurrent_branches children alive, collecting results in branch order
+    auto results = std::vector<std::string>(branches_count);
+    auto running_branches = std::deque<RunningBranch>();
+    for (auto branch_id = 0; branch_id < branches_count; branch_id++) {
+        if (static_cast<int>(running_branches.size()) == max_concurrent_branches) {
+            const auto oldest_branch = running_branches.front();
+            running_branches.pop_front();
+            finish_branch(oldest_branch, results[oldest_branch.branch]);
+        }
+        running_branches.push_back(start_branch(branch_id, branch));
+    }
+    for (const auto& running_branch : running_branches) {
+        finish_branch(running_branch, results[running_branch.branch]);
+    }
+
+    return results;
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/Telemetry.h"
+#include "common/FrameSocket.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Append a metric in the Prometheus text format.
+ *
+ * @param output stream to write to
+ * @param name metric name
+ * @param type metric type ("gauge" or "counter")
+ * @param help description of the metric
+ * @param value value of the metric
+ */
+template <typename Value>
+void render_metric(std::ostringstream& output,
+                   const std::string& name,
+                   const char* const type,
+                   const std::string& help,
+                   const Value value) noexcept {
+    output << "# HELP " << name << " " << help << "\n"
+           << "# TYPE " << name << " " << type << "\n"
+           << name << " " << value << "\n";
+}
+
+}  // namespace
+
+Telemetry::Telemetry(const int publish_interval) noexcept
+    : publish_interval(publish_interval),
+      current_time(0),
+      events_processed(0),
+      events_per_second(0),
+      pending_event_lists(0),
+      published_wall_time(std::chrono::steady_clock::now()),
+      published_events_processed(0),
+      sweep_points_count(0),
+      sweep_points_completed(0),
+      listen_fd(-1) {
+    if (publish_interval <= 0) {
+        std::cerr << "[Error] (network/analytical) " << "telemetry publish interval should be positive, got "
+                  << publish_interval << std::endl;
+        std::exit(-1);
+    }
+}
+
+Telemetry::~Telemetry() noexcept {
+    stop();
+}
+
+int Telemetry::get_publish_interval() const noexcept {
+    return publish_interval;
+}
+
+void Telemetry::publish(const EventTime new_current_time,
+                        const uint64_t new_events_processed,
+                        const int new_pending_event_lists) noexcept {
+    // the rate between this publication and the previous one
+    const auto wall_time = std::chrono::steady_clock::now();
+    const auto elapsed = std::chrono::duration<double>(wall_time - published_wall_time).count();
+    if (elapsed > 0 && new_events_processed >= published_events_processed) {
+        events_per_second.store(static_cast<double>(new_events_processed - published_events_processed) / elapsed,
+                                std::memory_order_relaxed);
+    }
+    published_wall_time = wall_time;
+    published_events_processed = new_events_processed;
+
+    current_time.store(new_current_time, std::memory_order_relaxed);
+    events_processed.store(new_events_processed, std::memory_order_relaxed);
+    pending_event_lists.store(new_pending_event_lists, std::memory_order_relaxed);
+
+    const auto lock = std::lock_guard<std::mutex>(gauges_mutex);
+    for (auto& [name, gauge] : gauges) {
+        gauge.value = gauge.sampler();
+    }
+}
+
+void Telemetry::set_gauge(const std::string& name, std::string help, GaugeSampler sampler) noexcept {
+    assert(sampler != nullptr);
+
+    const auto lock = std::lock_guard<std::mutex>(gauges_mutex);
+    auto& gauge = gauges[name];
+    gauge.help = std::move(help);
+    gauge.sampler = std::move(sampler);
+    gauge.value = gauge.sampler();
+}
+
+void Telemetry::remove_gauge(const std::string& name) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(gauges_mutex);
+    gauges.erase(name);
+}
+
+void Telemetry::start_sweep(const int points_count) noexcept {
+    assert(points_count >= 0);
+
+    sweep_points_completed.store(0, std::memory_order_relaxed);
+    sweep_points_count.store(points_count, std::memory_order_relaxed);
+}
+
+void Telemetry::complete_sweep_point() noexcept {
+    sweep_points_completed.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string Telemetry::render() const noexcept {
+    auto output = std::ostringstream();
+    render_metric(output, "network_analytical_simulated_time_ns", "gauge", "Current simulated time (ns).",
+                  current_time.load(std::memory_order_relaxed));
+    render_metric(output, "network_analytical_events_processed_total", "counter", "Events processed.",
+                  events_processed.load(std::memory_order_relaxed));
+    render_metric(output, "network_analytical_events_per_second", "gauge",
+                  "Events processed per second of wall time, over the latest publication interval.",
+                  events_per_second.load(std::memory_order_relaxed));
+    render_metric(output, "network_analytical_pending_event_lists", "gauge", "EventLists pending.",
+                  pending_event_lists.load(std::memory_order_relaxed));
+    render_metric(output, "network_analytical_sweep_points", "gauge", "Points of the sweep.",
+                  sweep_points_count.load(std::memory_order_relaxed));
+    render_metric(output, "network_analytical_sweep_points_completed", "gauge", "Completed points of the sweep.",
+                  sweep_points_completed.load(std::memory_order_relaxed));
+
+    const auto lock = std::lock_guard<std::mutex>(gauges_mutex);
+    for (const auto& [name, gauge] : gauges) {
+        render_metric(output, name, "gauge", gauge.help, gauge.value);
+    }
+    return output.str();
+}
+
+uint16_t Telemetry::serve(const uint16_t port) noexcept {
+    assert(listen_fd == -1);
+
+    auto bound_port = uint16_t(0);
+    listen_fd = listen_tcp(port, bound_port);
+    if (listen_fd == -1) {
+        std::cerr << "[Error] (network/analytical) " << "Cannot serve telemetry on port " << port << std::endl;
+        std::exit(-1);
+    }
+
+    serve_thread = std::thread(&Telemetry::serve_scrapes, this);
+    return bound_port;
+}
+
+void Telemetry::stop() noexcept {
+    if (listen_fd == -1) {
+        return;
+    }
+
+    // wake up the blocking accept call
+    shutdown(listen_fd, SHUT_RDWR);
+    serve_thread.join();
+    close(listen_fd);
+    listen_fd = -1;
+}
+
+void Telemetry::serve_scrapes() noexcept {
+    while (true) {
+        const auto client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd == -1) {
+            // serving stopped
+            return;
+        }
+
+        // every request is a scrape: read its header, then answer with the metrics and close
+        auto request = std::string();
+        char buffer[1'024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 16 * sizeof(buffer)) {
+            const auto read_size = recv(client_fd, buffer, sizeof(buffer), 0);
+            if (read_size <= 0) {
+                break;
+            }
+            request.append(buffer, static_cast<size_t>(read_size));
+        }
+
+        const auto body = render();
+        const auto response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: " +
+                              std::to_string(body.size()) + "\r\n\r\n" + body;
+        auto data = response.data();
+        auto size = response.size();
+        while (size > 0) {
+            const auto written = send(client_fd, data, size, MSG_NOSIGNAL);
+            if (written <= 0) {
+                break;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        close(client_fd);
+    }
+}
@@ -0,0 +1,220 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#ifdef __linux__
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Parse a Linux CPU list, e.g., "0-3,8,10-11".
+ *
+ * @param cpu_list CPU list
+ * @return CPU ids, in the order listed
+ */
+std::vector<int> parse_cpu_list(const std::string& cpu_list) noexcept {
+    auto cpus = std::vector<int>();
+    auto input = std::istringstream(cpu_list);
+    auto range = std::string();
+    while (std::getline(input, range, ',')) {
+        if (range.find_first_of("0123456789") == std::string::npos) {
+            continue;
+        }
+        const auto dash = range.find('-');
+        const auto first = std::stoi(range.substr(0, dash));
+        const auto last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+        for (auto cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+/**
+ * Get the CPUs of each NUMA node, from sysfs.
+ *
+ * @return CPU ids of each node, by node id (empty if the NUMA layout is unknown)
+ */
+std::vector<std::vector<int>> read_numa_nodes() noexcept {
+    auto nodes = std::vector<std::vector<int>>();
+    for (auto node = 0;; node++) {
+        auto file = std::ifstream("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) {
+            return nodes;
+        }
+        auto cpu_list = std::string();
+        std::getline(file, cpu_list);
+        nodes.push_back(parse_cpu_list(cpu_list));
+    }
+}
+
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(const int threads_count) noexcept
+    : threads_count(threads_count),
+      thread_pinning(false) {
+    assert(threads_count >= 0);
+
+    // use every hardware thread by default
+    if (threads_count == 0) {
+        this->threads_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+}
+
+void WorkStealingExecutor::run(const int tasks_count, const Task& task) noexcept {
+    assert(tasks_count >= 0);
+    assert(task != nullptr);
+
+    if (tasks_count == 0) {
+        return;
+    }
+
+    // deal tasks round-robin to the workers
+    const auto workers_count = std::min(threads_count, tasks_count);
+    auto worker_queues = std::vector<WorkerQueue>(workers_count);
+    for (auto task_id = 0; task_id < tasks_count; task_id++) {
+        worker_queues[task_id % workers_count].task_ids.push_back(task_id);
+    }
+
+    // each worker runs until no task is left anywhere, on its own core if pinned
+    const auto pinned_cores = thread_pinning ? get_pinned_cores() : std::vector<int>();
+    const auto work = [&worker_queues, &task, &pinned_cores](const int worker_id) {
+#ifdef __linux__
+        if (!pinned_cores.empty()) {
+            auto cpu_set = cpu_set_t();
+            CPU_ZERO(&cpu_set);
+            CPU_SET(pinned_cores[worker_id % pinned_cores.size()], &cpu_set);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+        }
+#endif
+
+        auto task_id = -1;
+        while (take_task(worker_queues, worker_id, task_id)) {
+            task(task_id);
+        }
+    };
+
+#ifdef __linux__
+    // the calling thread serves as worker 0: restore its affinity afterwards
+    auto caller_cpu_set = cpu_set_t();
+    const auto caller_pinned =
+        !pinned_cores.empty() && pthread_getaffinity_np(pthread_self(), sizeof(caller_cpu_set), &caller_cpu_set) == 0;
+#endif
+
+    // the calling thread serves as worker 0
+    auto workers = std::vector<std::thread>();
+    for (auto worker_id = 1; worker_id < workers_count; worker_id++) {
+        workers.emplace_back(work, worker_id);
+    }
+    work(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+#ifdef __linux__
+    if (caller_pinned) {
+        pthread_setaffinity_np(pthread_self(), sizeof(caller_cpu_set), &caller_cpu_set);
+    }
+#endif
+}
+
+void WorkStealingExecutor::set_thread_pinning(const bool enabled) noexcept {
+    thread_pinning = enabled;
+}
+
+std::vector<int> WorkStealingExecutor::get_pinned_cores() noexcept {
+    auto pinned_cores = std::vector<int>();
+#ifdef __linux__
+    // the cores the process may run on
+    auto allowed_cpu_set = cpu_set_t();
+    if (sched_getaffinity(0, sizeof(allowed_cpu_set), &allowed_cpu_set) != 0) {
+        return pinned_cores;
+    }
+    const auto allowed = [&allowed_cpu_set](const int cpu) {
+        return 0 <= cpu && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed_cpu_set);
+    };
+
+    // the allowed cores of each node (a single node holding every allowed core if unknown)
+    auto nodes = read_numa_nodes();
+    for (auto& node : nodes) {
+        node.erase(std::remove_if(node.begin(), node.end(), [&allowed](const int cpu) { return !allowed(cpu); }),
+                   node.end());
+    }
+    nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const auto& node) { return node.empty(); }),
+                nodes.end());
+    if (nodes.empty()) {
+        nodes.emplace_back();
+        for (auto cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (allowed(cpu)) {
+                nodes.back().push_back(cpu);
+            }
+        }
+    }
+
+    // deal the cores round-robin over the nodes
+    for (auto index = size_t(0); pinned_cores.size() < static_cast<size_t>(CPU_COUNT(&allowed_cpu_set)); index++) {
+        auto dealt = false;
+        for (const auto& node : nodes) {
+            if (index < node.size()) {
+                pinned_cores.push_back(node[index]);
+                dealt = true;
+            }
+        }
+        if (!dealt) {
+            break;
+        }
+    }
+#endif
+    return pinned_cores;
+}
+
+int WorkStealingExecutor::get_threads_count() const noexcept {
+    assert(threads_count > 0);
+
+    return threads_count;
+}
+
+bool WorkStealingExecutor::take_task(std::vector<WorkerQueue>& worker_queues,
+                                     const int worker_id,
+                                     int& task_id) noexcept {
+    const auto workers_count = static_cast<int>(worker_queues.size());
+
+    // own queue first
+    {
+        auto& own_queue = worker_queues[worker_id];
+        const auto lock = std::lock_guard<std::mutex>(own_queue.mutex);
+        if (!own_queue.task_ids.empty()) {
+            task_id = own_queue.task_ids.front();
+            own_queue.task_ids.pop_front();
+            return true;
+        }
+    }
+
+    // steal from the back of the other queues
+    for (auto offset = 1; offset < workers_count; offset++) {
+        auto& victim_queue = worker_queues[(worker_id + offset) % workers_count];
+        const auto lock = std::lock_guard<std::mutex>(victim_queue.mutex);
+        if (!victim_queue.task_ids.empty()) {
+            task_id = victim_queue.task_ids.back();
+            victim_queue.task_ids.pop_back();
+            return true;
+        }
+    }
+
+    // no task is left (tasks are never added during a run)
+    return false;
+}
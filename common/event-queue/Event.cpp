@@ -9,22 +9,23 @@ LICENSE file in the root directory of this source tree.
 using namespace NetworkAnalytical;
 
 Event::Event(const Callback callback, const CallbackArg callback_arg) noexcept
-    : callback(callback),
+    : event_kind(EventKind::UserCallback),
+      callback(callback),
       callback_arg(callback_arg) {
     assert(callback != nullptr);
 }
 
-void Event::invoke_event() noexcept {
-    // check the validity of the event
-    assert(callback != nullptr);
+Event::Event(const EventKind event_kind, const CallbackArg callback_arg) noexcept
+    : event_kind(event_kind),
+      callback(nullptr),
+      callback_arg(callback_arg) {
+    assert(event_kind != EventKind::UserCallback);
+}
 
-    // invoke the callback function
-    (*callback)(callback_arg);
+EventKind Event::get_kind() const noexcept {
+    return event_kind;
 }
 
 std::pair<Callback, CallbackArg> Event::get_handler_arg() const noexcept {
-    // check the validity of the event
-    assert(callback != nullptr);
-
     return {callback, callback_arg};
 }
@@ -5,6 +5,7 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/EventList.h"
 #include <cassert>
+#include <cstddef>
 
 using namespace NetworkAnalytical;
 
@@ -12,13 +13,20 @@ EventList::EventList(const EventTime event_time) noexcept : event_time(event_tim
     assert(event_time >= 0);
 
     // create an empty event list
-    events = std::list<Event>();
+    events = std::vector<Event>();
 }
 
 EventTime EventList::get_event_time() const noexcept {
     return event_time;
 }
 
+void EventList::reset(const EventTime new_event_time) noexcept {
+    // only a fully processed event list can be recycled
+    assert(events.empty());
+
+    event_time = new_event_time;
+}
+
 void EventList::add_event(const Callback callback, const CallbackArg callback_arg) noexcept {
     assert(callback != nullptr);
 
@@ -26,10 +34,64 @@ void EventList::add_event(const Callback callback, const CallbackArg callback_ar
     events.emplace_back(callback, callback_arg);
 }
 
-void EventList::invoke_events() noexcept {
+void EventList::add_event(const Event& event) noexcept {
+    // add the event to the event list
+    events.push_back(event);
+}
+
+int EventList::invoke_events() noexcept {
     // invoke all events in the event list
-    while (!events.empty()) {
-        events.front().invoke_event();
-        events.pop_front();
+    // an invoked event may register new events (i.e., reallocate the storage),
+    // so iterate by index and invoke a copy of each event
+    auto i = static_cast<size_t>(0);
+    while (i < events.size()) {
+#if NETWORK_ANALYTICAL_CONGESTION_AWARE
+        // hand a run of link frees over at once, copying their arguments as the storage may be reallocated
+        // (events added meanwhile follow the run)
+        if (events[i].get_kind() == EventKind::LinkFree && i + 1 < events.size() &&
+            events[i + 1].get_kind() == EventKind::LinkFree) {
+            link_free_args.clear();
+            while (i < events.size() && events[i].get_kind() == EventKind::LinkFree) {
+                link_free_args.push_back(events[i].get_handler_arg().second);
+                i++;
+            }
+            invoke_link_frees(link_free_args.data(), static_cast<int>(link_free_args.size()));
+            continue;
+        }
+#endif
+
+        auto event = events[i];
+        event.invoke_event();
+        i++;
     }
+
+    // drop invoked events, keeping the storage capacity
+    const auto invoked_events_count = static_cast<int>(events.size());
+    events.clear();
+
+    return invoked_events_count;
+}
+
+int EventList::get_events_count() const noexcept {
+    return static_cast<int>(events.size());
+}
+
+Event EventList::get_event(const int index) const noexcept {
+    assert(0 <= index && index < events.size());
+
+    return events[index];
+}
+
+void EventList::set_event(const int index, const Event& event) noexcept {
+    assert(0 <= index && index < events.size());
+
+    events[index] = event;
+}
+
+void EventList::clear_events() noexcept {
+    events.clear();
+}
+
+uint64_t EventList::get_allocated_bytes() const noexcept {
+    return sizeof(EventList) + (events.capacity() * sizeof(Event)) + (link_free_args.capacity() * sizeof(CallbackArg));
 }
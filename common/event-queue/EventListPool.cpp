@@ -0,0 +1,42 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventListPool.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+EventListPool::EventListPool() noexcept {
+    // create empty pool
+    free_event_lists = std::vector<std::unique_ptr<EventList>>();
+}
+
+std::unique_ptr<EventList> EventListPool::acquire(const EventTime event_time) noexcept {
+    // no recycled event list: allocate a new one
+    if (free_event_lists.empty()) {
+        return std::make_unique<EventList>(event_time);
+    }
+
+    // reuse the most recently released event list (likely still in cache)
+    auto event_list = std::move(free_event_lists.back());
+    free_event_lists.pop_back();
+    event_list->reset(event_time);
+
+    return event_list;
+}
+
+void EventListPool::release(std::unique_ptr<EventList> event_list) noexcept {
+    assert(event_list != nullptr);
+
+    free_event_lists.push_back(std::move(event_list));
+}
+
+uint64_t EventListPool::get_allocated_bytes() const noexcept {
+    auto allocated_bytes = static_cast<uint64_t>(free_event_lists.capacity() * sizeof(std::unique_ptr<EventList>));
+    for (const auto& event_list : free_event_lists) {
+        allocated_bytes += event_list->get_allocated_bytes();
+    }
+    return allocated_bytes;
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventListTable.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+EventListTable::EventListTable() noexcept : table_size_log2(6), entries_count(0) {
+    // create empty table
+    entries = std::vector<Entry>(static_cast<size_t>(1) << table_size_log2, Entry{0, nullptr});
+}
+
+EventList* EventListTable::find(const EventTime event_time) const noexcept {
+    const auto mask = entries.size() - 1;
+
+    // probe until the event time or an empty entry is found
+    for (auto index = home_index(event_time);; index = (index + 1) & mask) {
+        const auto& entry = entries[index];
+        if (entry.event_list == nullptr) {
+            return nullptr;
+        }
+        if (entry.event_time == event_time) {
+            return entry.event_list;
+        }
+    }
+}
+
+void EventListTable::insert(EventList* const event_list) noexcept {
+    assert(event_list != nullptr);
+    assert(find(event_list->get_event_time()) == nullptr);
+
+    // keep the load factor at most 1/2
+    if (2 * (entries_count + 1) > entries.size()) {
+        grow();
+    }
+
+    // place the entry at the first empty index
+    const auto mask = entries.size() - 1;
+    const auto event_time = event_list->get_event_time();
+    auto index = home_index(event_time);
+    while (entries[index].event_list != nullptr) {
+        index = (index + 1) & mask;
+    }
+    entries[index] = Entry{event_time, event_list};
+    entries_count++;
+}
+
+void EventListTable::erase(const EventTime event_time) noexcept {
+    const auto mask = entries.size() - 1;
+
+    // find the entry to erase
+    auto hole = home_index(event_time);
+    while (entries[hole].event_time != event_time || entries[hole].event_list == nullptr) {
+        assert(entries[hole].event_list != nullptr);
+        hole = (hole + 1) & mask;
+    }
+    entries[hole].event_list = nullptr;
+    entries_count--;
+
+    // backward-shift the following entries of the probe sequence into the hole,
+    // so that no tombstone is needed
+    for (auto index = (hole + 1) & mask; entries[index].event_list != nullptr; index = (index + 1) & mask) {
+        const auto home = home_index(entries[index].event_time);
+
+        // the entry stays if its home lies cyclically in (hole, index]
+        const auto stays = (hole <= index) ? (hole < home && home <= index) : (hole < home || home <= index);
+        if (stays) {
+            continue;
+        }
+
+        // move the entry into the hole
+        entries[hole] = entries[index];
+        entries[index].event_list = nullptr;
+        hole = index;
+    }
+}
+
+uint64_t EventListTable::get_allocated_bytes() const noexcept {
+    return entries.capacity() * sizeof(Entry);
+}
+
+size_t EventListTable::home_index(const EventTime event_time) const noexcept {
+    // Fibonacci hashing: multiply by 2^64 / golden ratio and keep the top bits
+    return static_cast<size_t>((event_time * 0x9E3779B97F4A7C15ULL) >> (64 - table_size_log2));
+}
+
+void EventListTable::grow() noexcept {
+    // double the table
+    auto old_entries = std::move(entries);
+    table_size_log2++;
+    entries = std::vector<Entry>(static_cast<size_t>(1) << table_size_log2, Entry{0, nullptr});
+    entries_count = 0;
+
+    // re-register all entries
+    for (const auto& entry : old_entries) {
+        if (entry.event_list != nullptr) {
+            insert(entry.event_list);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/EventMailbox.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+EventMailbox::EventMailbox() noexcept {
+    // create empty mailbox
+    events = std::vector<std::pair<EventTime, Event>>();
+}
+
+void EventMailbox::post(const EventTime event_time, const Callback callback, const CallbackArg callback_arg) noexcept {
+    assert(event_time >= 0);
+    assert(callback != nullptr);
+
+    events.emplace_back(event_time, Event(callback, callback_arg));
+}
+
+void EventMailbox::post(const EventTime event_time, const EventKind event_kind, const CallbackArg callback_arg) noexcept {
+    assert(event_time >= 0);
+
+    events.emplace_back(event_time, Event(event_kind, callback_arg));
+}
+
+void EventMailbox::deliver(EventQueue& event_queue) noexcept {
+    for (const auto& [event_time, event] : events) {
+        event_queue.schedule_event(event_time, event);
+    }
+
+    // keep the storage for the next round
+    events.clear();
+}
+
+void EventMailbox::take(std::vector<std::pair<EventTime, Event>>& taken_events) noexcept {
+    taken_events.clear();
+    taken_events.swap(events);
+}
+
+bool EventMailbox::empty() const noexcept {
+    return events.empty();
+}
@@ -4,13 +4,74 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/EventQueue.h"
+#include "common/HeapEventScheduler.h"
+#include "common/ListEventScheduler.h"
+#include "common/Profiler.h"
+#include "common/TimingWheelEventScheduler.h"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <utility>
 
 using namespace NetworkAnalytical;
 
-EventQueue::EventQueue() noexcept : current_time(0) {
+// declaring per-thread deferred scheduling state
+thread_local EventQueue* EventQueue::deferring_event_queue = nullptr;
+thread_local std::vector<EventQueue::DeferredEvent>* EventQueue::deferred_events = nullptr;
+
+namespace {
+
+/// event times invoked between two checks of the wall-clock budget of a bounded run
+constexpr int wall_clock_check_interval = 256;
+
+}  // namespace
+
+EventQueue::EventQueue(const EventQueueType event_queue_type) noexcept
+    : current_time(0),
+      event_queue_type(event_queue_type),
+      event_resources_per_kind(),
+      event_order_keys_per_kind(),
+      deterministic_order(false),
+      min_batch_size(0),
+      queued_events_count(0),
+      tombstones_count(0),
+      invoked_events_total(0),
+      posted_events(nullptr),
+      telemetry(nullptr),
+      telemetry_countdown(0),
+      telemetry_events_processed(0),
+      time_quantum(1),
+      min_event_delay(std::numeric_limits<EventTime>::max()) {
     // create empty event queue
-    event_queue = std::list<EventList>();
+    switch (event_queue_type) {
+    case EventQueueType::List:
+        event_queue = std::make_unique<ListEventScheduler>();
+        break;
+    case EventQueueType::Heap:
+        event_queue = std::make_unique<HeapEventScheduler>();
+        break;
+    case EventQueueType::TimingWheel:
+        event_queue = std::make_unique<TimingWheelEventScheduler>();
+        break;
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical) " << "not supported event queue type" << std::endl;
+        std::exit(-1);
+    }
+}
+
+EventQueue::~EventQueue() noexcept {
+    auto* posted_event = posted_events.exchange(nullptr, std::memory_order_acquire);
+    while (posted_event != nullptr) {
+        delete std::exchange(posted_event, posted_event->previous);
+    }
+}
+
+EventQueueType EventQueue::get_event_queue_type() const noexcept {
+    return event_queue_type;
 }
 
 EventTime EventQueue::get_current_time() const noexcept {
@@ -18,54 +79,578 @@ EventTime EventQueue::get_current_time() const noexcept {
 }
 
 bool EventQueue::finished() const noexcept {
-    // check whether event queue is empty
-    return event_queue.empty();
+    // check whether event queue is empty (or holds cancelled events only)
+    return (event_queue->empty() || queued_events_count == tombstones_count) &&
+           posted_events.load(std::memory_order_acquire) == nullptr;
 }
 
 void EventQueue::proceed() noexcept {
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::EventLoop);
+
     // to proceed, next event should exist
     assert(!finished());
+    drain_posted_events();
+
+    // cancelled events don't advance the current time
+    if (tombstones_count > 0) {
+        drop_cancelled_event_lists();
+    }
 
     // proceed to the next event time
-    auto& current_event_list = event_queue.front();
+    auto& current_event_list = event_queue->front();
 
     // check the validity and update current time
-    assert(current_event_list.get_event_time() > current_time);
+    // (run_until may have advanced the current time up to the next event time)
+    assert(current_event_list.get_event_time() >= current_time);
     current_time = current_event_list.get_event_time();
 
     // invoke events
-    current_event_list.invoke_events();
+    // events scheduled at current_time while invoking are appended to this list
+    const auto invoked_events_count = (executor != nullptr)      ? invoke_events_in_parallel(current_event_list)
+                                      : deterministic_order ? invoke_events_in_order(current_event_list)
+                                                            : current_event_list.invoke_events();
+    NETWORK_ANALYTICAL_STATS(stats.events_processed += invoked_events_count);
+    NETWORK_ANALYTICAL_STATS(stats.event_lists_processed++);
+    queued_events_count -= invoked_events_count;
+    invoked_events_total += invoked_events_count;
 
     // drop processed event list
-    event_queue.pop_front();
+    event_queue->pop_front();
+
+    // publish the progress every telemetry interval of EventLists
+    if (telemetry != nullptr) {
+        telemetry_events_processed += invoked_events_count;
+        if (--telemetry_countdown == 0) {
+            publish_telemetry();
+        }
+    }
 }
 
-void EventQueue::schedule_event(const EventTime event_time,
-                                const Callback callback,
-                                const CallbackArg callback_arg) noexcept {
+EventTime EventQueue::get_next_event_time() noexcept {
+    drain_posted_events();
+    if (tombstones_count > 0) {
+        drop_cancelled_event_lists();
+    }
+
+    // no event: nothing happens before the end of time
+    if (finished()) {
+        return std::numeric_limits<EventTime>::max();
+    }
+
+    return event_queue->front().get_event_time();
+}
+
+void EventQueue::run_until(const EventTime until_time) noexcept {
+    assert(until_time >= current_time);
+
+    // invoke events up to until_time
+    while (get_next_event_time() <= until_time && !finished()) {
+        proceed();
+    }
+
+    // events from now on are scheduled relative to until_time
+    current_time = until_time;
+}
+
+EventTime EventQueue::run_to_completion() noexcept {
+    while (!finished()) {
+        proceed();
+    }
+
+    if (telemetry != nullptr) {
+        publish_telemetry();
+    }
+
+    return current_time;
+}
+
+BoundedRun EventQueue::run_bounded(const RunBounds& bounds) noexcept {
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto events_budget_end = (bounds.events_budget > std::numeric_limits<uint64_t>::max() - invoked_events_total)
+                                       ? std::numeric_limits<uint64_t>::max()
+                                       : invoked_events_total + bounds.events_budget;
+    const auto wall_clock_bounded = bounds.wall_clock_budget < std::numeric_limits<double>::infinity();
+    auto event_times_count = 0;
+
+    auto bounded_run = BoundedRun();
+    while (true) {
+        const auto next_event_time = get_next_event_time();
+        if (finished()) {
+            break;
+        }
+
+        // stop before the event times past the bounds
+        bounded_run.finish_time = next_event_time;
+        if (next_event_time > bounds.time_bound || invoked_events_total >= events_budget_end) {
+            return bounded_run;
+        }
+        if (wall_clock_bounded && event_times_count++ % wall_clock_check_interval == 0) {
+            const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time);
+            if (elapsed.count() >= bounds.wall_clock_budget) {
+                return bounded_run;
+            }
+        }
+
+        proceed();
+    }
+
+    if (telemetry != nullptr) {
+        publish_telemetry();
+    }
+
+    bounded_run.completed = true;
+    bounded_run.finish_time = current_time;
+    return bounded_run;
+}
+
+void EventQueue::schedule_event(const EventTime event_time, const Event& event) noexcept {
     // time should be at least larger than current time
     assert(event_time >= current_time);
 
-    // find the entry to insert event
-    auto event_list_it = event_queue.begin();
-    while (event_list_it != event_queue.end() && event_list_it->get_event_time() < event_time) {
-        event_list_it++;
+    // invoked as a part of a batch: registered once the batch finishes
+    if (deferring_event_queue == this) {
+        assert(deferred_events != nullptr);
+        deferred_events->emplace_back(event_time, event);
+        return;
+    }
+
+    // approximate simulation: round the event time up to the next quantum
+    auto quantized_time = event_time;
+    if (time_quantum > 1) {
+        if (event_time > current_time) {
+            min_event_delay = std::min(min_event_delay, event_time - current_time);
+        }
+        quantized_time = (event_time + time_quantum - 1) / time_quantum * time_quantum;
+    }
+
+    // find (or create) the event list matching with event_time,
+    // then add event to event_list
+    [[maybe_unused]] const auto pending_event_lists = stats_enabled ? event_queue->size() : 0;
+    auto& event_list = event_queue->get_or_create(quantized_time);
+    event_list.add_event(event);
+    queued_events_count++;
+
+    NETWORK_ANALYTICAL_STATS(stats.events_scheduled++);
+    NETWORK_ANALYTICAL_STATS(stats.event_lists_created += (event_queue->size() > pending_event_lists) ? 1 : 0);
+    NETWORK_ANALYTICAL_STATS(stats.max_pending_event_lists = std::max(stats.max_pending_event_lists, event_queue->size()));
+}
+
+EventHandle EventQueue::schedule_cancellable_event(const EventTime event_time,
+                                                   const Callback callback,
+                                                   const CallbackArg callback_arg) noexcept {
+    assert(callback != nullptr);
+
+    // slots aren't shared across threads
+    assert(deferring_event_queue != this);
+
+    // take a free slot, or a new one
+    auto slot = uint32_t(0);
+    if (free_cancellable_slots.empty()) {
+        assert(cancellable_events.size() < std::numeric_limits<uint32_t>::max());
+        slot = static_cast<uint32_t>(cancellable_events.size());
+        cancellable_events.push_back({this, nullptr, nullptr, slot, 0, false});
+    } else {
+        slot = free_cancellable_slots.back();
+        free_cancellable_slots.pop_back();
+    }
+
+    auto& cancellable_event = cancellable_events[slot];
+    cancellable_event.callback = callback;
+    cancellable_event.callback_arg = callback_arg;
+    cancellable_event.scheduled = true;
+
+    schedule_event(event_time, Event(invoke_cancellable_event, &cancellable_event));
+
+    return {slot, cancellable_event.generation};
+}
+
+bool EventQueue::cancel(const EventHandle handle) noexcept {
+    if (!is_scheduled(handle)) {
+        return false;
+    }
+
+    // leave a tombstone, skipped once reached
+    cancellable_events[handle.slot].scheduled = false;
+    tombstones_count++;
+    return true;
+}
+
+EventHandle EventQueue::reschedule(const EventHandle handle, const EventTime event_time) noexcept {
+    if (!is_scheduled(handle)) {
+        return EventHandle();
+    }
+
+    // the slot stays taken by the tombstone until reached
+    const auto& cancellable_event = cancellable_events[handle.slot];
+    const auto callback = cancellable_event.callback;
+    const auto callback_arg = cancellable_event.callback_arg;
+    cancel(handle);
+
+    return schedule_cancellable_event(event_time, callback, callback_arg);
+}
+
+bool EventQueue::is_scheduled(const EventHandle handle) const noexcept {
+    if (handle.slot >= cancellable_events.size()) {
+        return false;
+    }
+
+    const auto& cancellable_event = cancellable_events[handle.slot];
+    return cancellable_event.generation == handle.generation && cancellable_event.scheduled;
+}
+
+void EventQueue::invoke_cancellable_event(void* const event_ptr) noexcept {
+    auto* const cancellable_event = static_cast<CancellableEvent*>(event_ptr);
+    auto* const event_queue = cancellable_event->event_queue;
+
+    // a tombstone: nothing to invoke
+    if (!cancellable_event->scheduled) {
+        event_queue->tombstones_count--;
+        event_queue->release_cancellable_event(*cancellable_event);
+        return;
+    }
+
+    // release first, so the callback may schedule into the same slot
+    const auto callback = cancellable_event->callback;
+    const auto callback_arg = cancellable_event->callback_arg;
+    event_queue->release_cancellable_event(*cancellable_event);
+    (*callback)(callback_arg);
+}
+
+void EventQueue::release_cancellable_event(CancellableEvent& event) noexcept {
+    // stale handles no longer match the slot
+    event.scheduled = false;
+    event.generation++;
+    free_cancellable_slots.push_back(event.slot);
+}
+
+void EventQueue::drop_cancelled_event_lists() noexcept {
+    while (tombstones_count > 0 && !event_queue->empty()) {
+        auto& event_list = event_queue->front();
+
+        // stop at the first EventList with an event to invoke
+        const auto events_count = event_list.get_events_count();
+        for (auto index = 0; index < events_count; index++) {
+            const auto event = event_list.get_event(index);
+            const auto [callback, callback_arg] = event.get_handler_arg();
+            if (event.get_kind() != EventKind::UserCallback || callback != invoke_cancellable_event ||
+                static_cast<const CancellableEvent*>(callback_arg)->scheduled) {
+                return;
+            }
+        }
+
+        for (auto index = 0; index < events_count; index++) {
+            const auto [callback, callback_arg] = event_list.get_event(index).get_handler_arg();
+            release_cancellable_event(*static_cast<CancellableEvent*>(callback_arg));
+        }
+        tombstones_count -= events_count;
+        queued_events_count -= events_count;
+
+        event_list.clear_events();
+        event_queue->pop_front();
+    }
+}
+
+void EventQueue::post_event(const EventTime event_time,
+                            const Callback callback,
+                            const CallbackArg callback_arg) noexcept {
+    assert(callback != nullptr);
+
+    // push onto the stack of staged events
+    auto* const posted_event = new PostedEvent{event_time, Event(callback, callback_arg), nullptr};
+    posted_event->previous = posted_events.load(std::memory_order_relaxed);
+    while (!posted_events.compare_exchange_weak(posted_event->previous, posted_event, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+        // previous is reloaded by the failed exchange
+    }
+}
+
+void EventQueue::drain_posted_events() noexcept {
+    // fast path: nothing staged
+    if (posted_events.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+
+    // take the whole stack at once, then reverse it into posting order
+    auto* posted_event = posted_events.exchange(nullptr, std::memory_order_acquire);
+    auto* first_posted_event = static_cast<PostedEvent*>(nullptr);
+    while (posted_event != nullptr) {
+        first_posted_event = std::exchange(posted_event, std::exchange(posted_event->previous, first_posted_event));
+    }
+
+    // the list is now linked from the first event on
+    while (first_posted_event != nullptr) {
+        schedule_event(std::max(first_posted_event->event_time, current_time), first_posted_event->event);
+        delete std::exchange(first_posted_event, first_posted_event->previous);
+    }
+}
+
+void EventQueue::reset() noexcept {
+    auto* posted_event = posted_events.exchange(nullptr, std::memory_order_acquire);
+    while (posted_event != nullptr) {
+        delete std::exchange(posted_event, posted_event->previous);
+    }
+    event_queue->clear();
+    current_time = 0;
+    stats = EventQueueStats();
+
+    // every cancellable event is dropped: its handle goes stale
+    queued_events_count = 0;
+    tombstones_count = 0;
+    invoked_events_total = 0;
+    min_event_delay = std::numeric_limits<EventTime>::max();
+    free_cancellable_slots.clear();
+    for (auto& cancellable_event : cancellable_events) {
+        cancellable_event.scheduled = false;
+        cancellable_event.generation++;
+        free_cancellable_slots.push_back(cancellable_event.slot);
+    }
+}
+
+void EventQueue::set_telemetry(std::shared_ptr<Telemetry> new_telemetry) noexcept {
+    telemetry = std::move(new_telemetry);
+    telemetry_events_processed = 0;
+    if (telemetry != nullptr) {
+        publish_telemetry();
+    }
+}
+
+void EventQueue::set_time_quantum(const EventTime quantum) noexcept {
+    assert(quantum >= 1);
+    assert(queued_events_count == 0);
+
+    time_quantum = quantum;
+    min_event_delay = std::numeric_limits<EventTime>::max();
+}
+
+EventTime EventQueue::get_time_quantum() const noexcept {
+    return time_quantum;
+}
+
+double EventQueue::get_time_error_bound() const noexcept {
+    if (time_quantum == 1 || min_event_delay == std::numeric_limits<EventTime>::max()) {
+        return 0;
+    }
+
+    return static_cast<double>(time_quantum - 1) / static_cast<double>(min_event_delay);
+}
+
+void EventQueue::publish_telemetry() noexcept {
+    assert(telemetry != nullptr);
+
+    telemetry_countdown = telemetry->get_publish_interval();
+    telemetry->publish(current_time, telemetry_events_processed, event_queue->size());
+}
+
+uint64_t EventQueue::get_invoked_events_count() const noexcept {
+    return invoked_events_total;
+}
+
+const EventQueueStats& EventQueue::get_stats() const noexcept {
+    return stats;
+}
+
+MemoryUsage EventQueue::get_memory_usage() const noexcept {
+    auto memory_usage = event_queue->get_memory_usage();
+    memory_usage.bytes += sizeof(EventQueue);
+    memory_usage.peak_bytes += sizeof(EventQueue);
+    return memory_usage;
+}
+
+void EventQueue::register_event_resource(const Callback callback, const EventResource resource) noexcept {
+    assert(callback != nullptr);
+    assert(resource != nullptr);
+
+    event_resources[callback] = resource;
+}
+
+void EventQueue::register_event_resource(const EventKind event_kind, const EventResource resource) noexcept {
+    assert(event_kind != EventKind::UserCallback);
+    assert(resource != nullptr);
+
+    event_resources_per_kind[static_cast<int>(event_kind)] = resource;
+}
+
+void EventQueue::register_event_order_key(const Callback callback, const EventOrderKey order_key) noexcept {
+    assert(callback != nullptr);
+    assert(order_key != nullptr);
+
+    event_order_keys[callback] = order_key;
+}
+
+void EventQueue::register_event_order_key(const EventKind event_kind, const EventOrderKey order_key) noexcept {
+    assert(event_kind != EventKind::UserCallback);
+    assert(order_key != nullptr);
+
+    event_order_keys_per_kind[static_cast<int>(event_kind)] = order_key;
+}
+
+void EventQueue::set_deterministic_order(const bool enabled) noexcept {
+    deterministic_order = enabled;
+}
+
+void EventQueue::set_parallel_invocation(const int threads_count, const int min_batch_size) noexcept {
+    assert(threads_count >= 0);
+    assert(min_batch_size >= 1);
+
+    executor = (threads_count == 1) ? nullptr : std::make_unique<WorkStealingExecutor>(threads_count);
+    this->min_batch_size = min_batch_size;
+}
+
+int EventQueue::invoke_events_in_parallel(EventList& event_list) noexcept {
+    assert(executor != nullptr);
+
+    // events invoked concurrently, grouped by resource
+    auto batch = std::vector<Event>();
+    auto batch_resources = std::vector<const void*>();
+    auto groups = std::vector<std::vector<int>>();
+    auto group_per_resource = std::unordered_map<const void*, int>();
+    auto deferred_events_per_event = std::vector<std::vector<DeferredEvent>>();
+
+    // events scheduled at current_time while invoking are appended to the list,
+    // so the list is walked by index
+    auto index = 0;
+    auto round_end = 0;
+    while (index < event_list.get_events_count()) {
+        // in the deterministic order, events scheduled while invoking a round are ordered as the next round
+        if (deterministic_order && index == round_end) {
+            order_events(event_list, index);
+            round_end = event_list.get_events_count();
+        }
+        const auto batch_end = deterministic_order ? round_end : event_list.get_events_count();
+
+        // collect consecutive events with resources
+        batch.clear();
+        batch_resources.clear();
+        while (index + static_cast<int>(batch.size()) < batch_end) {
+            const auto event = event_list.get_event(index + static_cast<int>(batch.size()));
+            const auto* const resource = get_event_resource(event);
+            if (resource == nullptr) {
+                break;
+            }
+            batch.push_back(event);
+            batch_resources.push_back(resource);
+        }
+
+        // small batches (and events without resources) are invoked one by one
+        if (batch.size() < static_cast<size_t>(std::max(min_batch_size, 1))) {
+            const auto serial_events_count = std::max(static_cast<int>(batch.size()), 1);
+            for (auto i = 0; i < serial_events_count; i++) {
+                auto event = event_list.get_event(index + i);
+                event.invoke_event();
+            }
+            index += serial_events_count;
+            continue;
+        }
+
+        // group the batch by resource, keeping the registration order within each group
+        groups.clear();
+        group_per_resource.clear();
+        for (auto i = 0; i < static_cast<int>(batch.size()); i++) {
+            const auto [it, inserted] = group_per_resource.try_emplace(batch_resources[i], groups.size());
+            if (inserted) {
+                groups.emplace_back();
+            }
+            groups[it->second].push_back(i);
+        }
+
+        // invoke the groups concurrently, deferring their schedules
+        deferred_events_per_event.resize(batch.size());
+        executor->run(static_cast<int>(groups.size()), [&](const int group_id) {
+            deferring_event_queue = this;
+            for (const auto i : groups[group_id]) {
+                deferred_events = &deferred_events_per_event[i];
+                batch[i].invoke_event();
+            }
+            deferring_event_queue = nullptr;
+            deferred_events = nullptr;
+        });
+
+        // register the deferred events in the order a serial invocation would have
+        for (auto i = 0; i < static_cast<int>(batch.size()); i++) {
+            for (const auto& [event_time, event] : deferred_events_per_event[i]) {
+                schedule_event(event_time, event);
+            }
+            deferred_events_per_event[i].clear();
+        }
+        index += static_cast<int>(batch.size());
+    }
+
+    // drop invoked events, keeping the storage capacity
+    event_list.clear_events();
+
+    return index;
+}
+
+int EventQueue::invoke_events_in_order(EventList& event_list) noexcept {
+    // events scheduled at current_time while invoking a round are appended to the list,
+    // and ordered as the next round once the current one is invoked
+    auto index = 0;
+    while (index < event_list.get_events_count()) {
+        order_events(event_list, index);
+        const auto round_end = event_list.get_events_count();
+        for (; index < round_end; index++) {
+            auto event = event_list.get_event(index);
+            event.invoke_event();
+        }
+    }
+
+    // drop invoked events, keeping the storage capacity
+    event_list.clear_events();
+
+    return index;
+}
+
+void EventQueue::order_events(EventList& event_list, const int first_index) noexcept {
+    const auto events_count = event_list.get_events_count();
+    if (events_count - first_index < 2) {
+        return;
+    }
+
+    // sort by (kind, order key, registration index), a total order
+    ordered_events.clear();
+    for (auto index = first_index; index < events_count; index++) {
+        const auto event = event_list.get_event(index);
+        ordered_events.push_back({event.get_kind(), get_event_order_key(event), index, event});
+    }
+    std::sort(ordered_events.begin(), ordered_events.end(), [](const OrderedEvent& lhs, const OrderedEvent& rhs) {
+        return std::tie(lhs.event_kind, lhs.order_key, lhs.index) < std::tie(rhs.event_kind, rhs.order_key, rhs.index);
+    });
+
+    for (auto i = 0; i < static_cast<int>(ordered_events.size()); i++) {
+        event_list.set_event(first_index + i, ordered_events[i].event);
+    }
+}
+
+uint64_t EventQueue::get_event_order_key(const Event& event) const noexcept {
+    const auto [callback, callback_arg] = event.get_handler_arg();
+
+    // internal events
+    if (event.get_kind() != EventKind::UserCallback) {
+        const auto order_key = event_order_keys_per_kind[static_cast<int>(event.get_kind())];
+        return (order_key != nullptr) ? order_key(callback_arg) : 0;
+    }
+
+    const auto it = event_order_keys.find(callback);
+    if (it == event_order_keys.end()) {
+        return 0;
+    }
+
+    return (it->second)(callback_arg);
+}
+
+const void* EventQueue::get_event_resource(const Event& event) const noexcept {
+    const auto [callback, callback_arg] = event.get_handler_arg();
+
+    // internal events
+    if (event.get_kind() != EventKind::UserCallback) {
+        const auto resource = event_resources_per_kind[static_cast<int>(event.get_kind())];
+        return (resource != nullptr) ? resource(callback_arg) : nullptr;
     }
 
-    // There can be three scenarios:
-    // (1) event list matching with event_time is found
-    // (2) there's no event list matching with event_time
-    //   (2-1) the event_time requested is
-    //   larger than the largest event time scheduled
-    //   (2-2) the event_time requested is
-    //   smaller than the largest event time scheduled
-    // for both (2-1) or (2-2), a new event should be created
-    if (event_list_it == event_queue.end() || event_time < event_list_it->get_event_time()) {
-        // insert new event_list
-        event_list_it = event_queue.insert(event_list_it, EventList(event_time));
+    const auto it = event_resources.find(callback);
+    if (it == event_resources.end()) {
+        return nullptr;
     }
 
-    // now, whether (1) or (2), the entry to insert the event is found
-    // add event to event_list
-    event_list_it->add_event(callback, callback_arg);
+    return (it->second)(callback_arg);
 }
@@ -0,0 +1,91 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/HeapEventScheduler.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+HeapEventScheduler::HeapEventScheduler() noexcept {
+    // create empty heap
+    heap = std::vector<std::unique_ptr<EventList>>();
+}
+
+bool HeapEventScheduler::empty() const noexcept {
+    return heap.empty();
+}
+
+int HeapEventScheduler::size() const noexcept {
+    return static_cast<int>(heap.size());
+}
+
+EventList& HeapEventScheduler::front() noexcept {
+    assert(!empty());
+
+    // heap top holds the earliest event list
+    return *heap.front();
+}
+
+void HeapEventScheduler::pop_front() noexcept {
+    assert(!empty());
+
+    // unregister the earliest event time
+    event_lists.erase(heap.front()->get_event_time());
+
+    // move the earliest event list to the back, then recycle it
+    std::pop_heap(heap.begin(), heap.end(), later);
+    event_list_pool.release(std::move(heap.back()));
+    heap.pop_back();
+}
+
+std::unique_ptr<EventList> HeapEventScheduler::extract_front() noexcept {
+    assert(!empty());
+
+    // unregister the earliest event time
+    event_lists.erase(heap.front()->get_event_time());
+
+    // move the earliest event list to the back, then take it out
+    std::pop_heap(heap.begin(), heap.end(), later);
+    auto event_list = std::move(heap.back());
+    heap.pop_back();
+
+    return event_list;
+}
+
+EventList& HeapEventScheduler::get_or_create(const EventTime event_time) noexcept {
+    // event list matching with event_time already exists
+    auto* const existing_event_list = event_lists.find(event_time);
+    if (existing_event_list != nullptr) {
+        return *existing_event_list;
+    }
+
+    // otherwise, take an event list from the pool and push it into the heap
+    auto event_list = event_list_pool.acquire(event_time);
+    auto* const event_list_ptr = event_list.get();
+    heap.push_back(std::move(event_list));
+    std::push_heap(heap.begin(), heap.end(), later);
+
+    // register the new event time
+    event_lists.insert(event_list_ptr);
+    return *event_list_ptr;
+}
+
+MemoryUsage HeapEventScheduler::get_memory_usage() const noexcept {
+    // scheduled event lists, with the heap and the lookup table
+    auto memory_usage = MemoryUsage();
+    memory_usage.bytes = heap.capacity() * sizeof(std::unique_ptr<EventList>) + event_lists.get_allocated_bytes();
+    for (const auto& event_list : heap) {
+        memory_usage.bytes += event_list->get_allocated_bytes();
+    }
+
+    // recycled event lists held memory at the peak
+    memory_usage.peak_bytes = memory_usage.bytes + event_list_pool.get_allocated_bytes();
+    return memory_usage;
+}
+
+bool HeapEventScheduler::later(const std::unique_ptr<EventList>& lhs, const std::unique_ptr<EventList>& rhs) noexcept {
+    return lhs->get_event_time() > rhs->get_event_time();
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/ListEventScheduler.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+ListEventScheduler::ListEventScheduler() noexcept {
+    // create empty list
+    event_lists = std::list<EventList>();
+    free_event_lists = std::list<EventList>();
+}
+
+bool ListEventScheduler::empty() const noexcept {
+    return event_lists.empty();
+}
+
+int ListEventScheduler::size() const noexcept {
+    return static_cast<int>(event_lists.size());
+}
+
+EventList& ListEventScheduler::front() noexcept {
+    assert(!empty());
+
+    return event_lists.front();
+}
+
+void ListEventScheduler::pop_front() noexcept {
+    assert(!empty());
+
+    // move the processed node into the free list
+    free_event_lists.splice(free_event_lists.end(), event_lists, event_lists.begin());
+}
+
+EventList& ListEventScheduler::get_or_create(const EventTime event_time) noexcept {
+    // find the entry to insert event
+    auto event_list_it = event_lists.begin();
+    while (event_list_it != event_lists.end() && event_list_it->get_event_time() < event_time) {
+        event_list_it++;
+    }
+
+    // There can be three scenarios:
+    // (1) event list matching with event_time is found
+    // (2) there's no event list matching with event_time
+    //   (2-1) the event_time requested is
+    //   larger than the largest event time scheduled
+    //   (2-2) the event_time requested is
+    //   smaller than the largest event time scheduled
+    // for both (2-1) or (2-2), a new event should be created
+    if (event_list_it == event_lists.end() || event_time < event_list_it->get_event_time()) {
+        // insert new event_list, reusing a free node if available
+        if (free_event_lists.empty()) {
+            event_list_it = event_lists.insert(event_list_it, EventList(event_time));
+        } else {
+            free_event_lists.front().reset(event_time);
+            event_lists.splice(event_list_it, free_event_lists, free_event_lists.begin());
+            event_list_it--;
+        }
+    }
+
+    // now, whether (1) or (2), the entry to insert the event is found
+    return *event_list_it;
+}
+
+MemoryUsage ListEventScheduler::get_memory_usage() const noexcept {
+    // every list node also holds its two links
+    constexpr auto node_overhead = 2 * sizeof(void*);
+
+    auto memory_usage = MemoryUsage();
+    for (const auto& event_list : event_lists) {
+        memory_usage.bytes += event_list.get_allocated_bytes() + node_overhead;
+    }
+
+    // recycled event lists held memory at the peak
+    memory_usage.peak_bytes = memory_usage.bytes;
+    for (const auto& event_list : free_event_lists) {
+        memory_usage.peak_bytes += event_list.get_allocated_bytes() + node_overhead;
+    }
+    return memory_usage;
+}
@@ -0,0 +1,20 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkScheduler.h"
+
+using namespace NetworkAnalytical;
+
+void NetworkScheduler::schedule_event(const EventTime event_time,
+                                      const Callback callback,
+                                      const CallbackArg callback_arg) noexcept {
+    schedule_event(event_time, Event(callback, callback_arg));
+}
+
+void NetworkScheduler::schedule_event(const EventTime event_time,
+                                      const EventKind event_kind,
+                                      const CallbackArg callback_arg) noexcept {
+    schedule_event(event_time, Event(event_kind, callback_arg));
+}
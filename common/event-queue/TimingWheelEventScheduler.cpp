@@ -0,0 +1,157 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/TimingWheelEventScheduler.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+
+TimingWheelEventScheduler::TimingWheelEventScheduler(const int slots_count_log2) noexcept
+    : wheel_start(0),
+      wheel_event_lists_count(0),
+      overflow() {
+    assert(6 <= slots_count_log2 && slots_count_log2 < 32);
+
+    // setup wheel geometry
+    slots_count = static_cast<EventTime>(1) << slots_count_log2;
+    slot_mask = slots_count - 1;
+
+    // create empty slots
+    slots.resize(slots_count);
+    occupied.resize(slots_count / 64, 0);
+}
+
+bool TimingWheelEventScheduler::empty() const noexcept {
+    return wheel_event_lists_count == 0 && overflow.empty();
+}
+
+int TimingWheelEventScheduler::size() const noexcept {
+    return wheel_event_lists_count + overflow.size();
+}
+
+EventList& TimingWheelEventScheduler::front() noexcept {
+    assert(!empty());
+
+    // wheel is empty: the earliest overflow event is the earliest event
+    if (wheel_event_lists_count == 0) {
+        return overflow.front();
+    }
+
+    // every overflow event is beyond the window,
+    // so the earliest occupied slot holds the earliest event
+    // (the window stays put, so earlier events can still be scheduled after peeking)
+    return *slots[find_first_occupied_slot()];
+}
+
+void TimingWheelEventScheduler::pop_front() noexcept {
+    assert(!empty());
+
+    // the earliest event time becomes the new window start
+    // (wheel is empty: jump the window to the earliest overflow event first)
+    if (wheel_event_lists_count == 0) {
+        advance_window(overflow.front().get_event_time());
+    }
+    advance_window(slots[find_first_occupied_slot()]->get_event_time());
+
+    const auto slot = wheel_start & slot_mask;
+    assert(slots[slot] != nullptr);
+    assert(slots[slot]->get_event_time() == wheel_start);
+
+    // recycle the event list
+    event_list_pool.release(std::move(slots[slot]));
+    occupied[slot / 64] &= ~(static_cast<uint64_t>(1) << (slot % 64));
+    wheel_event_lists_count--;
+}
+
+EventList& TimingWheelEventScheduler::get_or_create(const EventTime event_time) noexcept {
+    assert(event_time >= wheel_start);
+
+    // far-future event: keep in overflow heap
+    if (!in_window(event_time)) {
+        return overflow.get_or_create(event_time);
+    }
+
+    // event list matching with event_time already exists
+    const auto slot = event_time & slot_mask;
+    if (slots[slot] != nullptr) {
+        assert(slots[slot]->get_event_time() == event_time);
+        return *slots[slot];
+    }
+
+    // otherwise, create a new event list
+    return insert_into_wheel(event_list_pool.acquire(event_time));
+}
+
+MemoryUsage TimingWheelEventScheduler::get_memory_usage() const noexcept {
+    // event lists in the wheel, with the slots and the occupancy bitmap
+    auto memory_usage = overflow.get_memory_usage();
+    memory_usage.bytes += slots.capacity() * sizeof(std::unique_ptr<EventList>);
+    memory_usage.bytes += occupied.capacity() * sizeof(uint64_t);
+    for (const auto& event_list : slots) {
+        if (event_list != nullptr) {
+            memory_usage.bytes += event_list->get_allocated_bytes();
+        }
+    }
+
+    // recycled event lists held memory at the peak
+    memory_usage.peak_bytes = memory_usage.bytes + event_list_pool.get_allocated_bytes();
+    return memory_usage;
+}
+
+bool TimingWheelEventScheduler::in_window(const EventTime event_time) const noexcept {
+    return event_time - wheel_start < slots_count;
+}
+
+EventTime TimingWheelEventScheduler::find_first_occupied_slot() const noexcept {
+    assert(wheel_event_lists_count > 0);
+
+    const auto words_count = occupied.size();
+    const auto start_slot = wheel_start & slot_mask;
+    auto word_index = start_slot / 64;
+
+    // first word: ignore slots before the window start
+    auto word = occupied[word_index] & (~static_cast<uint64_t>(0) << (start_slot % 64));
+
+    // scan words circularly until an occupied slot is found
+    while (word == 0) {
+        word_index = (word_index + 1) % words_count;
+        word = occupied[word_index];
+    }
+
+    return word_index * 64 + __builtin_ctzll(word);
+}
+
+EventList& TimingWheelEventScheduler::insert_into_wheel(std::unique_ptr<EventList> event_list) noexcept {
+    assert(event_list != nullptr);
+    assert(in_window(event_list->get_event_time()));
+
+    const auto slot = event_list->get_event_time() & slot_mask;
+    assert(slots[slot] == nullptr);
+
+    // place the event list and mark the slot occupied
+    slots[slot] = std::move(event_list);
+    occupied[slot / 64] |= static_cast<uint64_t>(1) << (slot % 64);
+    wheel_event_lists_count++;
+
+    return *slots[slot];
+}
+
+void TimingWheelEventScheduler::clear() noexcept {
+    EventScheduler::clear();
+
+    // the window starts over from time 0
+    wheel_start = 0;
+}
+
+void TimingWheelEventScheduler::advance_window(const EventTime new_wheel_start) noexcept {
+    assert(new_wheel_start >= wheel_start);
+
+    wheel_start = new_wheel_start;
+
+    // migrate overflow event lists that fall inside the new window
+    while (!overflow.empty() && in_window(overflow.front().get_event_time())) {
+        insert_into_wheel(overflow.extract_front());
+    }
+}
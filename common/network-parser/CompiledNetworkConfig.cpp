@@ -0,0 +1,373 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkParser.h"
+#include "common/BinaryBuffer.h"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+/*
+ * Compiled network configuration layout (native byte order, no padding):
+ *   header: magic (8 B), version (u32), byte order mark (u32), source hash (u64)
+ *   dims_count (i32), then per dimension: topology (i32), npus_count (i32), bandwidth (f64), latency (f64)
+ *   mesh width, height, depth, routing (i32 each)
+ *   fat-tree radix, tiers, oversubscription (i32 each)
+ *   dragonfly npus_per_router, routers_per_group, global_links_per_router, routing (i32 each)
+ *   multi-rail rails count, routing (i32 each)
+ *   excluded regions count (u32), then (x_min, y_min, x_max, y_max) rectangles (i32 each)
+ *   excluded bitmap path length (u32), then its characters
+ *   npu placement pattern (i32), explicit entries count (u32), then (x, y, npu_id) triples (i32 each)
+ *   edge list path length (u32), then its characters
+ *   link classes count (u32), then per class: bandwidth, latency (f64 each),
+ *   bandwidth steps count (u32), (time, bandwidth) steps, background steps count (u32), (time, utilization) steps
+ *   link pair overrides count (u32), then (src, dest, link class) triples (i32 each)
+ *   link group overrides count (u32), then per override: group length (u32), its characters, link class (i32)
+ *   Mesh3D vertical bandwidth, latency (f64 each),
+ *   then excluded boxes count (u32), then (x_min, y_min, z_min, x_max, y_max, z_max) boxes (i32 each)
+ *
+ * Every value is a fixed-size scalar, so the file can be read (or mapped) as a flat buffer.
+ */
+
+namespace {
+
+/// written after the version, to reject files of another byte order
+constexpr uint32_t byte_order_mark = 0x01020304;
+
+}  // namespace
+
+NetworkParser NetworkParser::load_cached(const std::string& path, std::string compiled_path) noexcept {
+    if (compiled_path.empty()) {
+        compiled_path = path + ".bin";
+    }
+
+    // the yml contents decide whether the compiled file is current (reading is cheap, parsing isn't)
+    const auto source = read_source(path);
+
+    // load the compiled configuration if current
+    auto compiled_network_parser = NetworkParser();
+    if (compiled_network_parser.load_compiled(compiled_path, hash_source(source))) {
+        return compiled_network_parser;
+    }
+
+    // otherwise parse the yml contents, and compile them for the next runs
+    auto network_parser = NetworkParser();
+    network_parser.parse_network_config_source(source);
+    if (!network_parser.save_compiled(compiled_path)) {
+        std::cerr << "[Warning] (network/analytical) " << "cannot write compiled network config " << compiled_path
+                  << std::endl;
+    }
+    return network_parser;
+}
+
+bool NetworkParser::save_compiled(const std::string& compiled_path) const noexcept {
+    auto buffer = std::string();
+
+    // header
+    buffer.append(compiled_magic, sizeof(compiled_magic));
+    append_binary(buffer, compiled_version);
+    append_binary(buffer, byte_order_mark);
+    append_binary(buffer, source_hash);
+
+    append_config(buffer);
+    return write_binary_file(compiled_path, buffer);
+}
+
+uint64_t NetworkParser::get_config_hash() const noexcept {
+    // the compiled form holds the parsed values only, so formatting and comments of the yml don't matter
+    auto buffer = std::string();
+    append_binary(buffer, compiled_version);
+    append_config(buffer);
+    return hash_source(buffer);
+}
+
+void NetworkParser::append_config(std::string& buffer) const noexcept {
+    // dimensions
+    append_binary(buffer, static_cast<int32_t>(dims_count));
+    for (auto dim = 0; dim < dims_count; dim++) {
+        append_binary(buffer, static_cast<int32_t>(topology_per_dim[dim]));
+        append_binary(buffer, static_cast<int32_t>(npus_count_per_dim[dim]));
+        append_binary(buffer, static_cast<double>(bandwidth_per_dim[dim]));
+        append_binary(buffer, static_cast<double>(latency_per_dim[dim]));
+    }
+
+    // topology-specific shapes
+    for (const auto value : {mesh_width, mesh_height, mesh_depth, static_cast<int>(mesh_routing), fat_tree_radix,
+                             fat_tree_tiers, fat_tree_oversubscription, dragonfly_npus_per_router,
+                             dragonfly_routers_per_group, dragonfly_global_links_per_router,
+                             static_cast<int>(dragonfly_routing), multi_rail_rails_count,
+                             static_cast<int>(multi_rail_routing)}) {
+        append_binary(buffer, static_cast<int32_t>(value));
+    }
+
+    // SparseMesh2D exclusions and placement, in their compact (unexpanded) form
+    append_binary(buffer, static_cast<uint32_t>(excluded_regions.size()));
+    for (const auto& region : excluded_regions) {
+        for (const auto value : region) {
+            append_binary(buffer, static_cast<int32_t>(value));
+        }
+    }
+    append_binary(buffer, static_cast<uint32_t>(excluded_bitmap_path.size()));
+    buffer.append(excluded_bitmap_path);
+    append_binary(buffer, static_cast<int32_t>(placement_pattern));
+    append_binary(buffer, static_cast<uint32_t>(npu_placement_entries.size()));
+    for (const auto& entry : npu_placement_entries) {
+        for (const auto value : entry) {
+            append_binary(buffer, static_cast<int32_t>(value));
+        }
+    }
+
+    // Custom edge list
+    append_binary(buffer, static_cast<uint32_t>(edge_list_path.size()));
+    buffer.append(edge_list_path);
+
+    // link overrides
+    append_binary(buffer, static_cast<uint32_t>(link_classes.size()));
+    for (const auto& link_class : link_classes) {
+        append_binary(buffer, static_cast<double>(link_class.bandwidth));
+        append_binary(buffer, static_cast<double>(link_class.latency));
+        append_binary(buffer, static_cast<uint32_t>(link_class.bandwidth_schedule.size()));
+        for (const auto& [time, bandwidth] : link_class.bandwidth_schedule) {
+            append_binary(buffer, static_cast<double>(time));
+            append_binary(buffer, static_cast<double>(bandwidth));
+        }
+        append_binary(buffer, static_cast<uint32_t>(link_class.background_schedule.size()));
+        for (const auto& [time, utilization] : link_class.background_schedule) {
+            append_binary(buffer, static_cast<double>(time));
+            append_binary(buffer, utilization);
+        }
+    }
+    append_binary(buffer, static_cast<uint32_t>(link_pair_overrides.size()));
+    for (const auto& link_override : link_pair_overrides) {
+        append_binary(buffer, static_cast<int32_t>(link_override.src));
+        append_binary(buffer, static_cast<int32_t>(link_override.dest));
+        append_binary(buffer, static_cast<int32_t>(link_override.link_class));
+    }
+    append_binary(buffer, static_cast<uint32_t>(link_group_overrides.size()));
+    for (const auto& link_override : link_group_overrides) {
+        append_binary(buffer, static_cast<uint32_t>(link_override.group.size()));
+        buffer.append(link_override.group);
+        append_binary(buffer, static_cast<int32_t>(link_override.link_class));
+    }
+
+    // Mesh3D vertical links and exclusions
+    append_binary(buffer, static_cast<double>(vertical_bandwidth));
+    append_binary(buffer, static_cast<double>(vertical_latency));
+    append_binary(buffer, static_cast<uint32_t>(excluded_boxes.size()));
+    for (const auto& box : excluded_boxes) {
+        for (const auto value : box) {
+            append_binary(buffer, static_cast<int32_t>(value));
+        }
+    }
+}
+
+std::string NetworkParser::read_source(const std::string& path) noexcept {
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file) {
+        // loading network config file failed
+        std::cerr << "[Error] (network/analytical) " << "bad file: " << path << std::endl;
+        std::exit(-1);
+    }
+
+    auto source = std::ostringstream();
+    source << file.rdbuf();
+    return source.str();
+}
+
+std::optional<NetworkParser> NetworkParser::try_load(const std::string& path,
+                                                     std::vector<ConfigError>& errors) noexcept {
+    auto source = std::string();
+    if (!read_binary_file(path, source)) {
+        errors.push_back({"", "bad file: " + path});
+        return std::nullopt;
+    }
+
+    auto network_config = YAML::Node();
+    try {
+        network_config = YAML::Load(source);
+    } catch (const YAML::Exception& e) {
+        // the contents aren't valid yml
+        errors.push_back({"", e.what()});
+        return std::nullopt;
+    }
+    auto network_parser = try_parse(network_config, errors);
+    if (network_parser.has_value()) {
+        network_parser->source_hash = hash_source(source);
+    }
+    return network_parser;
+}
+
+void NetworkParser::parse_network_config_source(const std::string& source) noexcept {
+    try {
+        // parse network configs, tagged with the contents they come from
+        parse_network_config_yml(YAML::Load(source));
+        source_hash = hash_source(source);
+    } catch (const YAML::Exception& e) {
+        // the contents aren't valid yml, or a value is of the wrong type
+        std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
+        std::exit(-1);
+    }
+}
+
+uint64_t NetworkParser::hash_source(const std::string& source) noexcept {
+    auto hash = static_cast<uint64_t>(0xCBF29CE484222325ULL);
+    for (const auto byte : source) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+bool NetworkParser::load_compiled(const std::string& compiled_path, const uint64_t expected_source_hash) noexcept {
+    auto buffer = std::string();
+    if (!read_binary_file(compiled_path, buffer) || buffer.size() < sizeof(compiled_magic)) {
+        return false;
+    }
+
+    // header: stale or foreign files are ignored
+    if (std::memcmp(buffer.data(), compiled_magic, sizeof(compiled_magic)) != 0) {
+        return false;
+    }
+    auto reader = BinaryReader(buffer, sizeof(compiled_magic));
+    if (reader.read<uint32_t>() != compiled_version || reader.read<uint32_t>() != byte_order_mark ||
+        reader.read<uint64_t>() != expected_source_hash) {
+        return false;
+    }
+
+    // dimensions
+    dims_count = reader.read<int32_t>();
+    if (dims_count <= 0 || !reader.has(static_cast<uint64_t>(dims_count) * 24)) {
+        return false;
+    }
+    for (auto dim = 0; dim < dims_count; dim++) {
+        topology_per_dim.push_back(static_cast<TopologyBuildingBlock>(reader.read<int32_t>()));
+        npus_count_per_dim.push_back(reader.read<int32_t>());
+        bandwidth_per_dim.push_back(reader.read<double>());
+        latency_per_dim.push_back(reader.read<double>());
+    }
+
+    // topology-specific shapes
+    mesh_width = reader.read<int32_t>();
+    mesh_height = reader.read<int32_t>();
+    mesh_depth = reader.read<int32_t>();
+    mesh_routing = static_cast<MeshRouting>(reader.read<int32_t>());
+    fat_tree_radix = reader.read<int32_t>();
+    fat_tree_tiers = reader.read<int32_t>();
+    fat_tree_oversubscription = reader.read<int32_t>();
+    dragonfly_npus_per_router = reader.read<int32_t>();
+    dragonfly_routers_per_group = reader.read<int32_t>();
+    dragonfly_global_links_per_router = reader.read<int32_t>();
+    dragonfly_routing = static_cast<DragonflyRouting>(reader.read<int32_t>());
+    multi_rail_rails_count = reader.read<int32_t>();
+    multi_rail_routing = static_cast<RailRouting>(reader.read<int32_t>());
+
+    // SparseMesh2D exclusions and placement
+    const auto excluded_regions_count = reader.read<uint32_t>();
+    if (!reader.has(static_cast<uint64_t>(excluded_regions_count) * 16)) {
+        return false;
+    }
+    excluded_regions.resize(excluded_regions_count);
+    for (auto& region : excluded_regions) {
+        for (auto& value : region) {
+            value = reader.read<int32_t>();
+        }
+    }
+    const auto excluded_bitmap_path_length = reader.read<uint32_t>();
+    if (!reader.has(excluded_bitmap_path_length)) {
+        return false;
+    }
+    excluded_bitmap_path.resize(excluded_bitmap_path_length);
+    reader.read(excluded_bitmap_path.data(), excluded_bitmap_path_length);
+    placement_pattern = static_cast<PlacementPattern>(reader.read<int32_t>());
+    const auto npu_placement_entries_count = reader.read<uint32_t>();
+    if (!reader.has(static_cast<uint64_t>(npu_placement_entries_count) * 12)) {
+        return false;
+    }
+    npu_placement_entries.resize(npu_placement_entries_count);
+    for (auto& entry : npu_placement_entries) {
+        for (auto& value : entry) {
+            value = reader.read<int32_t>();
+        }
+    }
+
+    // Custom edge list
+    const auto edge_list_path_length = reader.read<uint32_t>();
+    if (!reader.has(edge_list_path_length)) {
+        return false;
+    }
+    edge_list_path.resize(edge_list_path_length);
+    reader.read(edge_list_path.data(), edge_list_path_length);
+
+    // link overrides
+    const auto link_classes_count = reader.read<uint32_t>();
+    if (!reader.has(static_cast<uint64_t>(link_classes_count) * 24)) {
+        return false;
+    }
+    link_classes.resize(link_classes_count);
+    for (auto& link_class : link_classes) {
+        link_class.bandwidth = reader.read<double>();
+        link_class.latency = reader.read<double>();
+        const auto steps_count = reader.read<uint32_t>();
+        if (!reader.has(static_cast<uint64_t>(steps_count) * 16)) {
+            return false;
+        }
+        link_class.bandwidth_schedule.resize(steps_count);
+        for (auto& [time, bandwidth] : link_class.bandwidth_schedule) {
+            time = reader.read<double>();
+            bandwidth = reader.read<double>();
+        }
+        const auto background_steps_count = reader.read<uint32_t>();
+        if (!reader.has(static_cast<uint64_t>(background_steps_count) * 16)) {
+            return false;
+        }
+        link_class.background_schedule.resize(background_steps_count);
+        for (auto& [time, utilization] : link_class.background_schedule) {
+            time = reader.read<double>();
+            utilization = reader.read<double>();
+        }
+    }
+    const auto link_pair_overrides_count = reader.read<uint32_t>();
+    if (!reader.has(static_cast<uint64_t>(link_pair_overrides_count) * 12)) {
+        return false;
+    }
+    link_pair_overrides.resize(link_pair_overrides_count);
+    for (auto& link_override : link_pair_overrides) {
+        link_override.src = reader.read<int32_t>();
+        link_override.dest = reader.read<int32_t>();
+        link_override.link_class = reader.read<int32_t>();
+    }
+    const auto link_group_overrides_count = reader.read<uint32_t>();
+    link_group_overrides.clear();
+    for (auto i = static_cast<uint32_t>(0); i < link_group_overrides_count; i++) {
+        const auto group_length = reader.read<uint32_t>();
+        if (!reader.has(static_cast<uint64_t>(group_length) + 4)) {
+            return false;
+        }
+        auto group = std::string(group_length, '\0');
+        reader.read(group.data(), group_length);
+        link_group_overrides.push_back({std::move(group), reader.read<int32_t>()});
+    }
+
+    // Mesh3D vertical links and exclusions
+    vertical_bandwidth = reader.read<double>();
+    vertical_latency = reader.read<double>();
+    const auto excluded_boxes_count = reader.read<uint32_t>();
+    if (!reader.has(static_cast<uint64_t>(excluded_boxes_count) * 24)) {
+        return false;
+    }
+    excluded_boxes.resize(excluded_boxes_count);
+    for (auto& box : excluded_boxes) {
+        for (auto& value : box) {
+            value = reader.read<int32_t>();
+        }
+    }
+
+    // the configuration was validated when compiled
+    source_hash = expected_source_hash;
+    return reader.done();
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkConfig.h"
+
+using namespace NetworkAnalytical;
+
+NetworkConfig::NetworkConfig() noexcept : parser() {
+    parser.dims_count = 0;
+}
+
+NetworkConfig& NetworkConfig::add_dim(const TopologyBuildingBlock topology,
+                                      const int npus_count,
+                                      const Bandwidth bandwidth,
+                                      const Latency latency) noexcept {
+    parser.topology_per_dim.push_back(topology);
+    parser.npus_count_per_dim.push_back(npus_count);
+    parser.bandwidth_per_dim.push_back(bandwidth);
+    parser.latency_per_dim.push_back(latency);
+    parser.dims_count++;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_mesh_size(const int width, const int height, const int depth) noexcept {
+    parser.mesh_width = width;
+    parser.mesh_height = height;
+    parser.mesh_depth = depth;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_vertical_link(const Bandwidth bandwidth, const Latency latency) noexcept {
+    parser.vertical_bandwidth = bandwidth;
+    parser.vertical_latency = latency;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::exclude_region(const int x_min,
+                                             const int y_min,
+                                             const int x_max,
+                                             const int y_max) noexcept {
+    parser.excluded_regions.push_back({x_min, y_min, x_max, y_max});
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::exclude_box(const int x_min,
+                                          const int y_min,
+                                          const int z_min,
+                                          const int x_max,
+                                          const int y_max,
+                                          const int z_max) noexcept {
+    parser.excluded_boxes.push_back({x_min, y_min, z_min, x_max, y_max, z_max});
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_excluded_bitmap(const std::string& path) noexcept {
+    parser.excluded_bitmap_path = path;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_placement_pattern(const PlacementPattern pattern) noexcept {
+    if (pattern == PlacementPattern::Explicit) {
+        errors.push_back({"npu_placement", "explicit NPU placements are set by place_npu"});
+        return *this;
+    }
+    parser.placement_pattern = pattern;
+    parser.npu_placement_entries.clear();
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::place_npu(const int x, const int y, const int npu_id) noexcept {
+    parser.placement_pattern = PlacementPattern::Explicit;
+    parser.npu_placement_entries.push_back({x, y, npu_id});
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_mesh_routing(const MeshRouting routing) noexcept {
+    parser.mesh_routing = routing;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_fat_tree(const int radix, const int tiers, const int oversubscription) noexcept {
+    parser.fat_tree_radix = radix;
+    parser.fat_tree_tiers = tiers;
+    parser.fat_tree_oversubscription = oversubscription;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_dragonfly(const int npus_per_router,
+                                            const int routers_per_group,
+                                            const int global_links_per_router,
+                                            const DragonflyRouting routing) noexcept {
+    parser.dragonfly_npus_per_router = npus_per_router;
+    parser.dragonfly_routers_per_group = routers_per_group;
+    parser.dragonfly_global_links_per_router = global_links_per_router;
+    parser.dragonfly_routing = routing;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_multi_rail(const int rails_count, const RailRouting routing) noexcept {
+    parser.multi_rail_rails_count = rails_count;
+    parser.multi_rail_routing = routing;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::set_edge_list(const std::string& path) noexcept {
+    parser.edge_list_path = path;
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::override_link_pair(const DeviceId src,
+                                                 const DeviceId dest,
+                                                 const Bandwidth bandwidth,
+                                                 const Latency latency) noexcept {
+    if (src < 0 || dest < 0 || src == dest) {
+        errors.push_back({"link_overrides", "link override pair should be two distinct devices"});
+        return *this;
+    }
+    const auto link_class = add_link_class(bandwidth, latency);
+    if (link_class != -1) {
+        parser.link_pair_overrides.push_back({src, dest, link_class});
+    }
+    return *this;
+}
+
+NetworkConfig& NetworkConfig::override_link_group(const std::string& group,
+                                                  const Bandwidth bandwidth,
+                                                  const Latency latency) noexcept {
+    const auto link_class = add_link_class(bandwidth, latency);
+    if (link_class != -1) {
+        parser.link_group_overrides.push_back({group, link_class});
+    }
+    return *this;
+}
+
+int NetworkConfig::add_link_class(const Bandwidth bandwidth, const Latency latency) noexcept {
+    // invalid parameters are reported when the configuration is checked
+    const auto error_scope = NetworkParser::ErrorScope(errors);
+    return parser.add_link_class(bandwidth, latency);
+}
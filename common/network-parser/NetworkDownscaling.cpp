@@ -0,0 +1,161 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkDownscaling.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Traffic of uniform all-to-all traffic in a dimension, per NPU of the network.
+ */
+struct DimTraffic {
+    /// average hops a message takes in the dimension (0 for the messages staying in the NPU's coordinate)
+    double hops;
+
+    /// bytes each of the busiest links of the dimension carries per byte a message holds
+    double link_load;
+};
+
+/**
+ * Compute the traffic of a dimension under uniform all-to-all traffic.
+ *
+ * @param topology building block of the dimension
+ * @param dim_npus_count NPUs of the dimension
+ * @param npus_count NPUs of the network
+ * @return traffic of the dimension
+ */
+DimTraffic dim_traffic(const TopologyBuildingBlock topology, const int dim_npus_count, const int npus_count) noexcept {
+    assert(dim_npus_count >= 1);
+    assert(npus_count >= 2);
+
+    // hops of a message crossing the dimension, and hops it takes over each of the busiest links of an NPU
+    auto crossing_hops = 0.0;
+    auto busiest_link_hops = 0.0;
+    switch (topology) {
+    case TopologyBuildingBlock::Ring:
+        // shortest way around the (bidirectional) ring, half-way messages going clockwise,
+        // so the clockwise links are the busiest
+        for (auto offset = 1; offset < dim_npus_count; offset++) {
+            crossing_hops += std::min(offset, dim_npus_count - offset);
+        }
+        for (auto offset = 1; offset <= dim_npus_count / 2; offset++) {
+            busiest_link_hops += offset;
+        }
+        crossing_hops /= std::max(dim_npus_count - 1, 1);
+        busiest_link_hops /= std::max(dim_npus_count - 1, 1);
+        break;
+    case TopologyBuildingBlock::FullyConnected:
+        // a link to each other NPU
+        crossing_hops = 1;
+        busiest_link_hops = 1.0 / std::max(dim_npus_count - 1, 1);
+        break;
+    case TopologyBuildingBlock::Switch:
+        // up to the switch and down, over one link each way
+        crossing_hops = 2;
+        busiest_link_hops = 1;
+        break;
+    default:
+        assert(false);
+    }
+
+    // each NPU sends a message to every other NPU, the ones at another coordinate crossing the dimension
+    const auto crossing_messages = static_cast<double>(npus_count) * (dim_npus_count - 1) / dim_npus_count;
+    return {crossing_messages * crossing_hops / (npus_count - 1), crossing_messages * busiest_link_hops};
+}
+
+}  // namespace
+
+DownscaledNetwork NetworkAnalytical::downscale_network(const NetworkParser& network_parser,
+                                                       const std::vector<int>& npus_counts_per_dim) noexcept {
+    const auto dims_count = network_parser.get_dims_count();
+    const auto topologies = network_parser.get_topologies_per_dim();
+    const auto full_npus_counts = network_parser.get_npus_counts_per_dim();
+    const auto bandwidths = network_parser.get_bandwidths_per_dim();
+    const auto latencies = network_parser.get_latencies_per_dim();
+
+    // only dimensions whose traffic is known from their size can be scaled
+    for (const auto topology : topologies) {
+        if (topology != TopologyBuildingBlock::Ring && topology != TopologyBuildingBlock::FullyConnected &&
+            topology != TopologyBuildingBlock::Switch) {
+            std::cerr << "[Error] (network/analytical) "
+                      << "downscaling only supports Ring, FullyConnected, and Switch dimensions" << std::endl;
+            std::exit(-1);
+        }
+    }
+    if (!network_parser.get_link_pair_overrides().empty() || !network_parser.get_link_group_overrides().empty()) {
+        std::cerr << "[Error] (network/analytical) " << "link overrides can't be downscaled" << std::endl;
+        std::exit(-1);
+    }
+    if (static_cast<int>(npus_counts_per_dim.size()) != dims_count) {
+        std::cerr << "[Error] (network/analytical) " << "downscaling to " << npus_counts_per_dim.size()
+                  << " dimensions a network of " << dims_count << " dimensions" << std::endl;
+        std::exit(-1);
+    }
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto npus_count = npus_counts_per_dim[dim];
+        if (npus_count > full_npus_counts[dim] || npus_count < std::min(2, full_npus_counts[dim])) {
+            std::cerr << "[Error] (network/analytical) " << "downscaling dimension " << dim << " of "
+                      << full_npus_counts[dim] << " NPUs to " << npus_count << " NPUs" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    auto downscaled = DownscaledNetwork();
+    downscaled.full_npus_count = 1;
+    downscaled.npus_count = 1;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        downscaled.full_npus_count *= full_npus_counts[dim];
+        downscaled.npus_count *= npus_counts_per_dim[dim];
+    }
+    assert(downscaled.npus_count >= 2);
+    downscaled.npus_scale = static_cast<double>(downscaled.full_npus_count) / downscaled.npus_count;
+
+    // every NPU injects as many bytes, the messages to its fewer peers getting larger
+    downscaled.message_size_scale =
+        static_cast<double>(downscaled.full_npus_count - 1) / static_cast<double>(downscaled.npus_count - 1);
+    downscaled.buffer_size_scale = downscaled.message_size_scale / downscaled.npus_scale;
+
+    // links keep their load relative to their bandwidth, and messages the time they spend in each dimension
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto full_traffic = dim_traffic(topologies[dim], full_npus_counts[dim], downscaled.full_npus_count);
+        const auto traffic = dim_traffic(topologies[dim], npus_counts_per_dim[dim], downscaled.npus_count);
+        const auto bandwidth_scale = downscaled.message_size_scale * traffic.link_load / full_traffic.link_load;
+        const auto latency_scale = (traffic.hops > 0) ? full_traffic.hops / traffic.hops : 1.0;
+        downscaled.bandwidth_scales.push_back(bandwidth_scale);
+        downscaled.latency_scales.push_back(latency_scale);
+        downscaled.network_config.add_dim(topologies[dim], npus_counts_per_dim[dim], bandwidths[dim] * bandwidth_scale,
+                                          latencies[dim] * latency_scale);
+    }
+
+    return downscaled;
+}
+
+DownscaledNetwork NetworkAnalytical::downscale_network(const NetworkParser& network_parser,
+                                                       const int target_npus_count) noexcept {
+    assert(target_npus_count >= 2);
+
+    // every dimension shrinks by the same factor, keeping at least 2 NPUs
+    const auto full_npus_counts = network_parser.get_npus_counts_per_dim();
+    auto full_npus_count = 1.0;
+    for (const auto npus_count : full_npus_counts) {
+        full_npus_count *= npus_count;
+    }
+    const auto dims_count = static_cast<double>(full_npus_counts.size());
+    const auto shrink_factor = std::pow(std::min(1.0, target_npus_count / full_npus_count), 1.0 / dims_count);
+
+    auto npus_counts_per_dim = std::vector<int>();
+    for (const auto npus_count : full_npus_counts) {
+        const auto scaled_npus_count = static_cast<int>(std::lround(npus_count * shrink_factor));
+        npus_counts_per_dim.push_back(std::clamp(scaled_npus_count, std::min(2, npus_count), npus_count));
+    }
+    return downscale_network(network_parser, npus_counts_per_dim);
+}
@@ -4,31 +4,223 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "common/NetworkParser.h"
+#include "common/NetworkConfig.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <map>
 #include <set>
+#include <sstream>
 
 using namespace NetworkAnalytical;
 
-NetworkParser::NetworkParser(const std::string& path) noexcept : dims_count(-1), mesh_width(-1), mesh_height(-1) {
+namespace {
+
+/**
+ * Concatenate values into a string, as written to a stream.
+ *
+ * @param values values to concatenate
+ * @return concatenated string
+ */
+template <typename... Values> std::string concat(const Values&... values) noexcept {
+    auto stream = std::ostringstream();
+    (stream << ... << values);
+    return stream.str();
+}
+
+/**
+ * GridDistance computes hop distances over the valid cells of a grid (the links of SparseMesh2D),
+ * by breadth-first searches stopping as soon as the target is found.
+ */
+class GridDistance {
+  public:
+    GridDistance(const std::vector<bool>& valid_cells, const int width, const int height) noexcept
+        : valid_cells(valid_cells),
+          width(width),
+          height(height),
+          visit_stamps(valid_cells.size(), 0),
+          distances(valid_cells.size(), 0),
+          stamp(0) {}
+
+    /**
+     * Get the hops between two valid cells.
+     *
+     * @return hops from src to dest (-1 if unreachable)
+     */
+    int operator()(const int src, const int dest) noexcept {
+        // consecutive cells are mostly neighbors
+        if (std::abs(src % width - dest % width) + std::abs(src / width - dest / width) <= 1) {
+            return (src == dest) ? 0 : 1;
+        }
+        const auto found = search(src, [dest](const int cell) { return cell == dest; });
+        return (found < 0) ? -1 : distances[found];
+    }
+
+    /**
+     * Get the valid cell nearest to a cell among the ones not taken yet (the first found on ties).
+     *
+     * @return nearest cell not taken (-1 if none is reachable)
+     */
+    int nearest(const int src, const std::vector<bool>& taken) noexcept {
+        return search(src, [&taken](const int cell) { return !taken[cell]; });
+    }
+
+  private:
+    const std::vector<bool>& valid_cells;
+    int width;
+    int height;
+
+    /// search each cell was last visited by
+    std::vector<int> visit_stamps;
+
+    /// hops of each cell visited by the current search
+    std::vector<int> distances;
+
+    /// cells to visit, in order
+    std::vector<int> frontier;
+
+    /// id of the current search
+    int stamp;
+
+    /**
+     * Search the valid cells from src outward, neighbors in +x, -x, +y, -y order.
+     *
+     * @return first cell (other than src) satisfying found (-1 if none)
+     */
+    template <typename Found> int search(const int src, const Found& found) noexcept {
+        stamp++;
+        frontier.clear();
+        frontier.push_back(src);
+        visit_stamps[src] = stamp;
+        distances[src] = 0;
+        for (auto i = static_cast<size_t>(0); i < frontier.size(); i++) {
+            const auto cell = frontier[i];
+            const auto x = cell % width;
+            const auto y = cell / width;
+            for (const auto& [dx, dy] : {std::pair(1, 0), std::pair(-1, 0), std::pair(0, 1), std::pair(0, -1)}) {
+                if (x + dx < 0 || x + dx >= width || y + dy < 0 || y + dy >= height) {
+                    continue;
+                }
+                const auto next = cell + dy * width + dx;
+                if (!valid_cells[next] || visit_stamps[next] == stamp) {
+                    continue;
+                }
+                visit_stamps[next] = stamp;
+                distances[next] = distances[cell] + 1;
+                if (found(next)) {
+                    return next;
+                }
+                frontier.push_back(next);
+            }
+        }
+        return -1;
+    }
+};
+
+}  // namespace
+
+NetworkParser::NetworkParser() noexcept
+    : dims_count(-1),
+      mesh_width(-1),
+      mesh_height(-1),
+      mesh_depth(-1),
+      vertical_bandwidth(-1),
+      vertical_latency(-1),
+      placement_pattern(PlacementPattern::RowMajor),
+      mesh_routing(MeshRouting::XY),
+      fat_tree_radix(-1),
+      fat_tree_tiers(2),
+      fat_tree_oversubscription(1),
+      dragonfly_npus_per_router(1),
+      dragonfly_routers_per_group(-1),
+      dragonfly_global_links_per_router(-1),
+      dragonfly_routing(DragonflyRouting::Minimal),
+      multi_rail_rails_count(-1),
+      multi_rail_routing(RailRouting::Hashed),
+      source_hash(0) {
     // initialize values
     npus_count_per_dim = {};
     bandwidth_per_dim = {};
     latency_per_dim = {};
     topology_per_dim = {};
+}
 
-    try {
-        // load network config file
-        const auto network_config = YAML::LoadFile(path);
+NetworkParser::NetworkParser(const std::string& path) noexcept : NetworkParser() {
+    // load and parse network config file
+    parse_network_config_source(read_source(path));
+}
 
+NetworkParser::NetworkParser(const YAML::Node& network_config) noexcept : NetworkParser() {
+    try {
         // parse network configs
         parse_network_config_yml(network_config);
-    } catch (const YAML::BadFile& e) {
-        // loading network config file failed
-        std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
-        std::exit(-1);
+    } catch (const YAML::Exception& e) {
+        // a value of the wrong type
+        report_error("", e.what());
+    }
+}
+
+NetworkParser::NetworkParser(const NetworkConfig& network_config) noexcept : NetworkParser(network_config.parser) {
+    // errors of the setters, then complete and check the built network config
+    for (const auto& error : network_config.errors) {
+        report_error(error.key, error.message);
+    }
+    finalize();
+}
+
+std::optional<NetworkParser> NetworkParser::try_parse(const YAML::Node& network_config,
+                                                      std::vector<ConfigError>& errors) noexcept {
+    const auto errors_count = errors.size();
+    auto network_parser = NetworkParser();
+    {
+        const auto error_scope = ErrorScope(errors);
+        try {
+            network_parser.parse_network_config_yml(network_config);
+        } catch (const YAML::Exception& e) {
+            // a value of the wrong type
+            errors.push_back({"", e.what()});
+        }
+    }
+
+    if (errors.size() != errors_count) {
+        return std::nullopt;
+    }
+    return network_parser;
+}
+
+std::optional<NetworkParser> NetworkParser::try_parse(const NetworkConfig& network_config,
+                                                      std::vector<ConfigError>& errors) noexcept {
+    const auto errors_count = errors.size();
+    errors.insert(errors.end(), network_config.errors.begin(), network_config.errors.end());
+    auto network_parser = network_config.parser;
+    {
+        const auto error_scope = ErrorScope(errors);
+        network_parser.finalize();
+    }
+
+    if (errors.size() != errors_count) {
+        return std::nullopt;
     }
+    return network_parser;
+}
+
+thread_local std::vector<ConfigError>* NetworkParser::error_sink = nullptr;
+
+void NetworkParser::report_error(const std::string& key, const std::string& message) noexcept {
+    // collected by try_parse
+    if (error_sink != nullptr) {
+        error_sink->push_back({key, message});
+        return;
+    }
+
+    std::cerr << "[Error] (network/analytical) " << message << std::endl;
+    std::exit(-1);
 }
 
 int NetworkParser::get_dims_count() const noexcept {
@@ -73,15 +265,445 @@ int NetworkParser::get_mesh_height() const noexcept {
     return mesh_height;
 }
 
+int NetworkParser::get_mesh_depth() const noexcept {
+    return mesh_depth;
+}
+
+Bandwidth NetworkParser::get_vertical_bandwidth() const noexcept {
+    assert(!bandwidth_per_dim.empty());
+
+    return (vertical_bandwidth > 0) ? vertical_bandwidth : bandwidth_per_dim[0];
+}
+
+Latency NetworkParser::get_vertical_latency() const noexcept {
+    assert(!latency_per_dim.empty());
+
+    return (vertical_latency >= 0) ? vertical_latency : latency_per_dim[0];
+}
+
+std::vector<bool> NetworkParser::get_valid_cells_3d() const noexcept {
+    assert(mesh_width > 0);
+    assert(mesh_height > 0);
+    assert(mesh_depth > 0);
+
+    auto valid_cells = std::vector<bool>(static_cast<size_t>(mesh_width) * mesh_height * mesh_depth, true);
+
+    // excluded boxes, clipped to the grid
+    for (const auto& [x_min, y_min, z_min, x_max, y_max, z_max] : excluded_boxes) {
+        for (auto z = std::max(z_min, 0); z <= std::min(z_max, mesh_depth - 1); z++) {
+            for (auto y = std::max(y_min, 0); y <= std::min(y_max, mesh_height - 1); y++) {
+                for (auto x = std::max(x_min, 0); x <= std::min(x_max, mesh_width - 1); x++) {
+                    valid_cells[(static_cast<size_t>(z) * mesh_height + y) * mesh_width + x] = false;
+                }
+            }
+        }
+    }
+    return valid_cells;
+}
+
 std::set<std::pair<int, int>> NetworkParser::get_excluded_coords() const noexcept {
+    auto excluded_coords = std::set<std::pair<int, int>>();
+
+    // without a grid, only the excluded regions are known
+    if (mesh_width <= 0 || mesh_height <= 0) {
+        for (const auto& [x_min, y_min, x_max, y_max] : excluded_regions) {
+            for (auto y = y_min; y <= y_max; y++) {
+                for (auto x = x_min; x <= x_max; x++) {
+                    excluded_coords.emplace(x, y);
+                }
+            }
+        }
+        return excluded_coords;
+    }
+
+    const auto valid_cells = get_valid_cells();
+    for (auto y = 0; y < mesh_height; y++) {
+        for (auto x = 0; x < mesh_width; x++) {
+            if (!valid_cells[static_cast<size_t>(y) * mesh_width + x]) {
+                excluded_coords.emplace_hint(excluded_coords.end(), x, y);
+            }
+        }
+    }
     return excluded_coords;
 }
 
 std::map<std::pair<int, int>, int> NetworkParser::get_npu_placement() const noexcept {
+    auto npu_placement = std::map<std::pair<int, int>, int>();
+
+    // explicit entries are kept as given
+    if (placement_pattern == PlacementPattern::Explicit) {
+        for (const auto& [x, y, npu_id] : npu_placement_entries) {
+            npu_placement[{x, y}] = npu_id;
+        }
+        return npu_placement;
+    }
+
+    const auto npu_placement_grid = get_npu_placement_grid();
+    for (auto cell = static_cast<size_t>(0); cell < npu_placement_grid.size(); cell++) {
+        if (npu_placement_grid[cell] >= 0) {
+            const auto x = static_cast<int>(cell % mesh_width);
+            const auto y = static_cast<int>(cell / mesh_width);
+            npu_placement[{x, y}] = npu_placement_grid[cell];
+        }
+    }
     return npu_placement;
 }
 
-void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) noexcept {
+std::vector<bool> NetworkParser::get_valid_cells() const noexcept {
+    assert(mesh_width > 0);
+    assert(mesh_height > 0);
+
+    auto valid_cells = std::vector<bool>(static_cast<size_t>(mesh_width) * mesh_height, true);
+
+    // excluded regions, clipped to the grid
+    for (const auto& [x_min, y_min, x_max, y_max] : excluded_regions) {
+        for (auto y = std::max(y_min, 0); y <= std::min(y_max, mesh_height - 1); y++) {
+            for (auto x = std::max(x_min, 0); x <= std::min(x_max, mesh_width - 1); x++) {
+                valid_cells[static_cast<size_t>(y) * mesh_width + x] = false;
+            }
+        }
+    }
+
+    // excluded bitmap (checked by validate)
+    if (!excluded_bitmap_path.empty() && !apply_excluded_bitmap(valid_cells)) {
+        std::cerr << "[Error] (network/analytical) " << excluded_bitmap_error() << std::endl;
+        std::exit(-1);
+    }
+
+    return valid_cells;
+}
+
+bool NetworkParser::apply_excluded_bitmap(std::vector<bool>& valid_cells) const noexcept {
+    assert(valid_cells.size() == static_cast<size_t>(mesh_width) * mesh_height);
+
+    // a row per line, '1' or 'x' for an excluded cell, '0' or '.' for a valid one
+    const auto bitmap = read_source(excluded_bitmap_path);
+    auto x = 0;
+    auto y = 0;
+    for (const auto c : bitmap) {
+        if (c == '\n') {
+            if (x == 0) {
+                // blank line
+                continue;
+            }
+            if (x != mesh_width) {
+                break;
+            }
+            x = 0;
+            y++;
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r') {
+            continue;
+        }
+        if ((c != '0' && c != '.' && c != '1' && c != 'x') || x >= mesh_width || y >= mesh_height) {
+            x = -1;
+            break;
+        }
+        if (c == '1' || c == 'x') {
+            valid_cells[static_cast<size_t>(y) * mesh_width + x] = false;
+        }
+        x++;
+    }
+    if (x == mesh_width) {
+        // last line without a newline
+        x = 0;
+        y++;
+    }
+    return x == 0 && y == mesh_height;
+}
+
+std::string NetworkParser::excluded_bitmap_error() const noexcept {
+    return concat("excluded_bitmap ", excluded_bitmap_path, " should hold ", mesh_height, " rows of ", mesh_width,
+                  " cells ('0'/'.' valid, '1'/'x' excluded)");
+}
+
+PlacementPattern NetworkParser::get_placement_pattern() const noexcept {
+    return placement_pattern;
+}
+
+std::vector<int> NetworkParser::get_npu_placement_grid() const noexcept {
+    // the default numbering is row-major
+    if (placement_pattern == PlacementPattern::RowMajor) {
+        return {};
+    }
+
+    assert(mesh_width > 0);
+    assert(mesh_height > 0);
+
+    auto npu_placement_grid = std::vector<int>(static_cast<size_t>(mesh_width) * mesh_height, -1);
+
+    // explicit entries: out-of-grid ones are dropped
+    if (placement_pattern == PlacementPattern::Explicit) {
+        for (const auto& [x, y, npu_id] : npu_placement_entries) {
+            if (x < 0 || x >= mesh_width || y < 0 || y >= mesh_height) {
+                std::cerr << "[Warning] (network/analytical) " << "npu_placement (" << x << ", " << y << ") -> "
+                          << npu_id << " is out of the grid, ignored" << std::endl;
+                continue;
+            }
+            npu_placement_grid[static_cast<size_t>(y) * mesh_width + x] = npu_id;
+        }
+        return npu_placement_grid;
+    }
+
+    // patterns: number the valid cells in order along the path
+    const auto valid_cells = get_valid_cells();
+    auto npu_id = 0;
+    const auto place = [&](const int x, const int y) {
+        const auto cell = static_cast<size_t>(y) * mesh_width + x;
+        if (valid_cells[cell]) {
+            npu_placement_grid[cell] = npu_id++;
+        }
+    };
+
+    if (placement_pattern == PlacementPattern::Snake) {
+        for (auto y = 0; y < mesh_height; y++) {
+            for (auto i = 0; i < mesh_width; i++) {
+                place(y % 2 == 0 ? i : mesh_width - 1 - i, y);
+            }
+        }
+        return npu_placement_grid;
+    }
+
+    // RingOrder: the searched order
+    if (placement_pattern == PlacementPattern::RingOrder) {
+        for (const auto cell : search_ring_order(valid_cells)) {
+            npu_placement_grid[cell] = npu_id++;
+        }
+        return npu_placement_grid;
+    }
+
+    // Hilbert: the curve covers the smallest power-of-2 square holding the grid
+    assert(placement_pattern == PlacementPattern::Hilbert);
+    auto side = 1;
+    while (side < std::max(mesh_width, mesh_height)) {
+        side *= 2;
+    }
+    for (auto position = 0; position < side * side; position++) {
+        const auto [x, y] = hilbert_cell(side, position);
+        if (x < mesh_width && y < mesh_height) {
+            place(x, y);
+        }
+    }
+    return npu_placement_grid;
+}
+
+std::vector<int> NetworkParser::get_ring_dilations() const noexcept {
+    assert(mesh_width > 0);
+    assert(mesh_height > 0);
+
+    // cell of each placed NPU, in id order (valid cells in row-major order by default)
+    const auto valid_cells = get_valid_cells();
+    const auto npu_placement_grid = get_npu_placement_grid();
+    auto npu_cells = std::map<int, int>();
+    auto row_major_npu_id = 0;
+    for (auto cell = 0; cell < static_cast<int>(valid_cells.size()); cell++) {
+        if (!valid_cells[cell]) {
+            continue;
+        }
+        const auto npu_id = npu_placement_grid.empty() ? row_major_npu_id++ : npu_placement_grid[cell];
+        if (npu_id >= 0) {
+            npu_cells[npu_id] = cell;
+        }
+    }
+
+    // hops from each NPU to the next one, around the ring
+    auto grid_distance = GridDistance(valid_cells, mesh_width, mesh_height);
+    auto dilations = std::vector<int>();
+    dilations.reserve(npu_cells.size());
+    for (auto it = npu_cells.begin(); it != npu_cells.end(); ++it) {
+        const auto next = std::next(it);
+        const auto next_cell = (next == npu_cells.end()) ? npu_cells.begin()->second : next->second;
+        dilations.push_back(grid_distance(it->second, next_cell));
+    }
+    return dilations;
+}
+
+std::vector<int> NetworkParser::search_ring_order(const std::vector<bool>& valid_cells) const noexcept {
+    assert(valid_cells.size() == static_cast<size_t>(mesh_width) * mesh_height);
+
+    const auto width = mesh_width;
+    const auto height = mesh_height;
+    const auto cell_at = [width](const int x, const int y) { return y * width + x; };
+    auto grid_distance = GridDistance(valid_cells, width, height);
+
+    // candidate orders over every cell of the grid (excluded cells are dropped when scored)
+    auto candidates = std::vector<std::vector<int>>();
+    const auto add_snake = [&](const bool by_rows, const bool ring) {
+        // rows (or columns) alternate direction; a ring-closing snake leaves the first column (or row)
+        // to return along, which closes the ring on an even number of rows (or columns)
+        const auto lines_count = by_rows ? height : width;
+        const auto line_length = by_rows ? width : height;
+        const auto first = ring ? 1 : 0;
+        auto& order = candidates.emplace_back();
+        for (auto line = 0; line < lines_count; line++) {
+            for (auto i = first; i < line_length; i++) {
+                const auto position = (line % 2 == 0) ? i : line_length - 1 + first - i;
+                order.push_back(by_rows ? cell_at(position, line) : cell_at(line, position));
+            }
+        }
+        if (ring) {
+            for (auto line = lines_count - 1; line >= 0; line--) {
+                order.push_back(by_rows ? cell_at(0, line) : cell_at(line, 0));
+            }
+        }
+    };
+    add_snake(true, false);
+    add_snake(false, false);
+    add_snake(true, true);
+    add_snake(false, true);
+
+    // Hilbert curve over the smallest power-of-2 square holding the grid
+    auto side = 1;
+    while (side < std::max(width, height)) {
+        side *= 2;
+    }
+    auto& hilbert_order = candidates.emplace_back();
+    for (auto position = 0; position < side * side; position++) {
+        const auto [x, y] = hilbert_cell(side, position);
+        if (x < width && y < height) {
+            hilbert_order.push_back(cell_at(x, y));
+        }
+    }
+
+    // greedy walk to the nearest valid cell not taken yet, from the first valid cell
+    const auto first_valid = std::find(valid_cells.begin(), valid_cells.end(), true);
+    if (first_valid == valid_cells.end()) {
+        return {};
+    }
+    auto taken = std::vector<bool>(valid_cells.size(), false);
+    auto& greedy_order = candidates.emplace_back();
+    auto current = static_cast<int>(first_valid - valid_cells.begin());
+    while (current >= 0) {
+        taken[current] = true;
+        greedy_order.push_back(current);
+        current = grid_distance.nearest(current, taken);
+    }
+
+    // a grid split by the excluded cells strands the walk
+    if (greedy_order.size() < static_cast<size_t>(std::count(valid_cells.begin(), valid_cells.end(), true))) {
+        candidates.pop_back();
+    }
+
+    // keep the valid cells of the order with the least total (then largest) dilation;
+    // unreachable pairs count as a hop per grid cell
+    auto best_order = std::vector<int>();
+    auto best_cost = std::pair<int64_t, int>(std::numeric_limits<int64_t>::max(), 0);
+    for (const auto& candidate : candidates) {
+        auto order = std::vector<int>();
+        std::copy_if(candidate.begin(), candidate.end(), std::back_inserter(order),
+                     [&valid_cells](const int cell) { return valid_cells[cell]; });
+        auto cost = std::pair<int64_t, int>(0, 0);
+        for (auto i = static_cast<size_t>(0); i < order.size(); i++) {
+            const auto hops = grid_distance(order[i], order[(i + 1) % order.size()]);
+            const auto dilation = (hops < 0) ? width * height : hops;
+            cost.first += dilation;
+            cost.second = std::max(cost.second, dilation);
+        }
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_order = std::move(order);
+        }
+    }
+    return best_order;
+}
+
+bool NetworkParser::save_npu_placement(const std::string& path, const std::string& output_path) noexcept {
+    auto network_config = YAML::Load(read_source(path));
+    const auto network_parser = NetworkParser(network_config);
+    assert(network_parser.mesh_width > 0);
+    assert(network_parser.mesh_height > 0);
+
+    // one flow-style (x, y, npu_id) entry per placed cell, row-major placement written out too
+    const auto width = network_parser.mesh_width;
+    const auto valid_cells = network_parser.get_valid_cells();
+    const auto npu_placement_grid = network_parser.get_npu_placement_grid();
+    auto npu_placement = YAML::Node(YAML::NodeType::Sequence);
+    auto row_major_npu_id = 0;
+    for (auto cell = 0; cell < static_cast<int>(valid_cells.size()); cell++) {
+        if (!valid_cells[cell]) {
+            continue;
+        }
+        const auto npu_id = npu_placement_grid.empty() ? row_major_npu_id++ : npu_placement_grid[cell];
+        if (npu_id < 0) {
+            continue;
+        }
+        auto entry = YAML::Node(YAML::NodeType::Sequence);
+        entry.SetStyle(YAML::EmitterStyle::Flow);
+        entry.push_back(cell % width);
+        entry.push_back(cell / width);
+        entry.push_back(npu_id);
+        npu_placement.push_back(entry);
+    }
+    network_config["npu_placement"] = npu_placement;
+
+    auto output_file = std::ofstream(output_path);
+    if (!output_file) {
+        return false;
+    }
+    auto emitter = YAML::Emitter();
+    emitter << network_config;
+    output_file << emitter.c_str() << std::endl;
+    return static_cast<bool>(output_file);
+}
+
+MeshRouting NetworkParser::get_mesh_routing() const noexcept {
+    return mesh_routing;
+}
+
+int NetworkParser::get_fat_tree_radix() const noexcept {
+    return fat_tree_radix;
+}
+
+int NetworkParser::get_fat_tree_tiers() const noexcept {
+    return fat_tree_tiers;
+}
+
+int NetworkParser::get_fat_tree_oversubscription() const noexcept {
+    return fat_tree_oversubscription;
+}
+
+int NetworkParser::get_dragonfly_npus_per_router() const noexcept {
+    return dragonfly_npus_per_router;
+}
+
+int NetworkParser::get_dragonfly_routers_per_group() const noexcept {
+    return dragonfly_routers_per_group;
+}
+
+int NetworkParser::get_dragonfly_global_links_per_router() const noexcept {
+    return dragonfly_global_links_per_router;
+}
+
+DragonflyRouting NetworkParser::get_dragonfly_routing() const noexcept {
+    return dragonfly_routing;
+}
+
+int NetworkParser::get_multi_rail_rails_count() const noexcept {
+    return multi_rail_rails_count;
+}
+
+RailRouting NetworkParser::get_multi_rail_routing() const noexcept {
+    return multi_rail_routing;
+}
+
+std::string NetworkParser::get_edge_list_path() const noexcept {
+    return edge_list_path;
+}
+
+const std::vector<LinkClass>& NetworkParser::get_link_classes() const noexcept {
+    return link_classes;
+}
+
+const std::vector<LinkPairOverride>& NetworkParser::get_link_pair_overrides() const noexcept {
+    return link_pair_overrides;
+}
+
+const std::vector<LinkGroupOverride>& NetworkParser::get_link_group_overrides() const noexcept {
+    return link_group_overrides;
+}
+
+void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) {
     // parse topology_per_dim
     const auto topology_names = parse_vector<std::string>(network_config["topology"]);
     for (const auto& topology_name : topology_names) {
@@ -97,51 +719,272 @@ void NetworkParser::parse_network_config_yml(const YAML::Node& network_config) n
     bandwidth_per_dim = parse_vector<Bandwidth>(network_config["bandwidth"]);
     latency_per_dim = parse_vector<Latency>(network_config["latency"]);
 
-    // parse optional mesh dimensions (for Mesh2D topology)
+    // parse optional mesh dimensions (for Mesh2D and Torus topology)
     if (network_config["width"]) {
         mesh_width = network_config["width"].as<int>();
     }
     if (network_config["height"]) {
         mesh_height = network_config["height"].as<int>();
     }
+    if (network_config["depth"]) {
+        mesh_depth = network_config["depth"].as<int>();
+    }
+
+    // parse optional vertical link parameters (for Mesh3D topology)
+    if (network_config["vertical_bandwidth"]) {
+        vertical_bandwidth = network_config["vertical_bandwidth"].as<Bandwidth>();
+    }
+    if (network_config["vertical_latency"]) {
+        vertical_latency = network_config["vertical_latency"].as<Latency>();
+    }
 
-    // parse optional excluded coordinates (for SparseMesh2D topology)
-    // Format: excluded: [ [x1, y1], [x2, y2], ... ]
+    // parse optional excluded cells (for SparseMesh2D and Mesh3D topology), kept as regions until expanded
+    // Format: excluded: [ [x1, y1], [x_min, y_min, x_max, y_max], ... ]  (cells, or rectangles with corners included)
+    //     or: excluded: [ [x1, y1, z1], [x_min, y_min, z_min, x_max, y_max, z_max], ... ]  (for Mesh3D)
     if (network_config["excluded"]) {
-        for (const auto& coord : network_config["excluded"]) {
-            if (coord.size() >= 2) {
-                int x = coord[0].as<int>();
-                int y = coord[1].as<int>();
-                excluded_coords.insert({x, y});
-            }
-        }
-        
-        // If excluded coords are present, switch topology type to SparseMesh2D
-        if (!excluded_coords.empty() && !topology_per_dim.empty()) {
-            if (topology_per_dim[0] == TopologyBuildingBlock::Mesh2D) {
-                topology_per_dim[0] = TopologyBuildingBlock::SparseMesh2D;
+        for (const auto& region : network_config["excluded"]) {
+            if (region.size() == 2) {
+                const auto x = region[0].as<int>();
+                const auto y = region[1].as<int>();
+                excluded_regions.push_back({x, y, x, y});
+            } else if (region.size() == 4) {
+                excluded_regions.push_back(
+                    {region[0].as<int>(), region[1].as<int>(), region[2].as<int>(), region[3].as<int>()});
+            } else if (region.size() == 3) {
+                const auto x = region[0].as<int>();
+                const auto y = region[1].as<int>();
+                const auto z = region[2].as<int>();
+                excluded_boxes.push_back({x, y, z, x, y, z});
+            } else if (region.size() == 6) {
+                excluded_boxes.push_back({region[0].as<int>(), region[1].as<int>(), region[2].as<int>(),
+                                          region[3].as<int>(), region[4].as<int>(), region[5].as<int>()});
+            } else {
+                report_error("excluded", "excluded entries should be [x, y] cells, [x_min, y_min, x_max, y_max] "
+                                         "rectangles, [x, y, z] cells, or [x_min, y_min, z_min, x_max, y_max, z_max] "
+                                         "boxes");
             }
         }
     }
 
+    // parse optional bitmap file of excluded cells (for SparseMesh2D topology), read when expanded
+    // Format: excluded_bitmap: path  (a row per line, '1' or 'x' for an excluded cell, '0' or '.' for a valid one)
+    if (network_config["excluded_bitmap"]) {
+        excluded_bitmap_path = network_config["excluded_bitmap"].as<std::string>();
+    }
+
     // parse optional custom NPU placement (for SparseMesh2D topology)
-    // Format: npu_placement: [ [x1, y1, npu_id1], [x2, y2, npu_id2], ... ]
+    // Format: npu_placement: Snake  (a named pattern: RowMajor, Snake, Hilbert, or RingOrder)
+    //     or: npu_placement: [ [x1, y1, npu_id1], [x2, y2, npu_id2], ... ]
     // This allows custom NPU ID assignment for optimized ring routing (e.g., snake patterns)
     if (network_config["npu_placement"]) {
-        for (const auto& entry : network_config["npu_placement"]) {
-            if (entry.size() >= 3) {
-                int x = entry[0].as<int>();
-                int y = entry[1].as<int>();
-                int npu_id = entry[2].as<int>();
-                npu_placement[{x, y}] = npu_id;
+        if (network_config["npu_placement"].IsScalar()) {
+            placement_pattern = parse_placement_pattern_name(network_config["npu_placement"].as<std::string>());
+        } else {
+            placement_pattern = PlacementPattern::Explicit;
+            for (const auto& entry : network_config["npu_placement"]) {
+                if (entry.size() >= 3) {
+                    npu_placement_entries.push_back({entry[0].as<int>(), entry[1].as<int>(), entry[2].as<int>()});
+                }
             }
         }
     }
 
-    // check the validity of the parsed network config
+    // parse optional routing policy (for Mesh2D, Dragonfly, and MultiRail topology)
+    // Format: routing: O1Turn
+    const auto is_dragonfly = topology_per_dim.size() == 1 && topology_per_dim[0] == TopologyBuildingBlock::Dragonfly;
+    const auto is_multi_rail = topology_per_dim.size() == 1 && topology_per_dim[0] == TopologyBuildingBlock::MultiRail;
+    if (network_config["routing"]) {
+        const auto routing_name = network_config["routing"].as<std::string>();
+        if (is_dragonfly) {
+            dragonfly_routing = NetworkParser::parse_dragonfly_routing_name(routing_name);
+        } else if (is_multi_rail) {
+            multi_rail_routing = NetworkParser::parse_rail_routing_name(routing_name);
+        } else {
+            mesh_routing = NetworkParser::parse_mesh_routing_name(routing_name);
+        }
+    }
+
+    // parse optional fat-tree shape (for FatTree topology)
+    if (network_config["radix"]) {
+        fat_tree_radix = network_config["radix"].as<int>();
+    }
+    if (network_config["tiers"]) {
+        fat_tree_tiers = network_config["tiers"].as<int>();
+    }
+    if (network_config["oversubscription"]) {
+        fat_tree_oversubscription = network_config["oversubscription"].as<int>();
+    }
+
+    // parse optional dragonfly shape (for Dragonfly topology)
+    if (network_config["npus_per_router"]) {
+        dragonfly_npus_per_router = network_config["npus_per_router"].as<int>();
+    }
+    if (network_config["routers_per_group"]) {
+        dragonfly_routers_per_group = network_config["routers_per_group"].as<int>();
+    }
+    if (network_config["global_links_per_router"]) {
+        dragonfly_global_links_per_router = network_config["global_links_per_router"].as<int>();
+    }
+
+    // parse optional rails count (for MultiRail topology)
+    if (network_config["rails"]) {
+        multi_rail_rails_count = network_config["rails"].as<int>();
+    }
+
+    // parse optional edge list (for Custom topology)
+    // Format: edge_list: path  (a CSV or binary edge list, see CustomTopology)
+    if (network_config["edge_list"]) {
+        edge_list_path = network_config["edge_list"].as<std::string>();
+    }
+
+    // parse optional link classes and per-link overrides
+    // Format: link_classes: { name: { bandwidth: b, latency: l[, bandwidth_schedule: [[t, b], ...]]
+    //                                 [, background_utilization: u | [[t, u], ...]] }, ... }
+    //         link_overrides: [ { pair: [src, dest] | row: y | column: x | group: name,
+    //                             class: name | bandwidth: b, latency: l }, ... ]
+    auto link_class_ids = std::map<std::string, int>();
+    for (const auto& named_class : network_config["link_classes"]) {
+        const auto name = named_class.first.as<std::string>();
+        const auto& parameters = named_class.second;
+        if (!parameters["bandwidth"] || !parameters["latency"]) {
+            report_error("link_classes", "link class " + name + " requires bandwidth and latency");
+            continue;
+        }
+        auto bandwidth_schedule = std::vector<std::pair<Latency, Bandwidth>>();
+        for (const auto& step : parameters["bandwidth_schedule"]) {
+            const auto time_and_bandwidth = parse_vector<double>(step);
+            if (time_and_bandwidth.size() != 2) {
+                report_error("link_classes", "bandwidth schedule steps of link class " + name +
+                                                 " should be [time, bandwidth]");
+                continue;
+            }
+            bandwidth_schedule.emplace_back(time_and_bandwidth[0], time_and_bandwidth[1]);
+        }
+        // a constant background utilization is a single step at time 0
+        auto background_schedule = std::vector<std::pair<Latency, double>>();
+        const auto& background = parameters["background_utilization"];
+        if (background && background.IsScalar()) {
+            background_schedule.emplace_back(0, background.as<double>());
+        }
+        for (const auto& step : background) {
+            const auto time_and_utilization = parse_vector<double>(step);
+            if (time_and_utilization.size() != 2) {
+                report_error("link_classes", "background utilization steps of link class " + name +
+                                                 " should be [time, utilization]");
+                continue;
+            }
+            background_schedule.emplace_back(time_and_utilization[0], time_and_utilization[1]);
+        }
+        link_class_ids[name] =
+            add_link_class(parameters["bandwidth"].as<Bandwidth>(), parameters["latency"].as<Latency>(),
+                           bandwidth_schedule, background_schedule);
+    }
+    for (const auto& link_override : network_config["link_overrides"]) {
+        parse_link_override(link_override, link_class_ids);
+    }
+
+    // complete and check the parsed network config
+    finalize();
+}
+
+void NetworkParser::finalize() noexcept {
+    // If excluded cells are present, switch topology type to SparseMesh2D
+    if ((!excluded_regions.empty() || !excluded_bitmap_path.empty()) && !topology_per_dim.empty()) {
+        if (topology_per_dim[0] == TopologyBuildingBlock::Mesh2D) {
+            topology_per_dim[0] = TopologyBuildingBlock::SparseMesh2D;
+        }
+    }
+
+    // a Torus2D without explicit dimensions is square
+    const auto is_torus_2d = topology_per_dim.size() == 1 && topology_per_dim[0] == TopologyBuildingBlock::Torus2D;
+    if (is_torus_2d && mesh_width < 0 && mesh_height < 0 && npus_count_per_dim.size() == 1) {
+        mesh_width = static_cast<int>(std::lround(std::sqrt(npus_count_per_dim[0])));
+        mesh_height = mesh_width;
+    }
+
+    // check the validity of the network config
     check_validity();
 }
 
+int NetworkParser::add_link_class(const Bandwidth bandwidth,
+                                  const Latency latency,
+                                  const std::vector<std::pair<Latency, Bandwidth>>& bandwidth_schedule,
+                                  const std::vector<std::pair<Latency, double>>& background_schedule) noexcept {
+    if (bandwidth <= 0 || latency < 0) {
+        report_error("link_overrides", concat("link overrides require a positive bandwidth and a non-negative "
+                                              "latency, got ", bandwidth, " and ", latency));
+        return -1;
+    }
+    for (auto step = static_cast<size_t>(0); step < bandwidth_schedule.size(); step++) {
+        const auto [time, step_bandwidth] = bandwidth_schedule[step];
+        if (time < 0 || step_bandwidth <= 0 || (step > 0 && time <= bandwidth_schedule[step - 1].first)) {
+            report_error("link_classes", concat("bandwidth schedule steps require increasing non-negative times "
+                                                "and positive bandwidths, got [", time, ", ", step_bandwidth, "]"));
+            return -1;
+        }
+    }
+    for (auto step = static_cast<size_t>(0); step < background_schedule.size(); step++) {
+        const auto [time, utilization] = background_schedule[step];
+        if (time < 0 || utilization < 0 || utilization >= 1 ||
+            (step > 0 && time <= background_schedule[step - 1].first)) {
+            report_error("link_classes", concat("background utilization steps require increasing non-negative "
+                                                "times and utilizations in [0, 1), got [", time, ", ", utilization,
+                                                "]"));
+            return -1;
+        }
+    }
+
+    // overrides of the same parameters share their class (there are few distinct ones)
+    for (auto link_class = 0; link_class < static_cast<int>(link_classes.size()); link_class++) {
+        const auto& other = link_classes[link_class];
+        if (other.bandwidth == bandwidth && other.latency == latency &&
+            other.bandwidth_schedule == bandwidth_schedule && other.background_schedule == background_schedule) {
+            return link_class;
+        }
+    }
+
+    link_classes.push_back({bandwidth, latency, bandwidth_schedule, background_schedule});
+    return static_cast<int>(link_classes.size()) - 1;
+}
+
+void NetworkParser::parse_link_override(const YAML::Node& link_override,
+                                        const std::map<std::string, int>& link_class_ids) {
+    // the parameters: a named class, or given inline
+    auto link_class = -1;
+    if (link_override["class"]) {
+        const auto name = link_override["class"].as<std::string>();
+        const auto it = link_class_ids.find(name);
+        if (it == link_class_ids.end()) {
+            report_error("link_overrides", "link class " + name + " not defined");
+            return;
+        }
+        link_class = it->second;
+    } else if (link_override["bandwidth"] && link_override["latency"]) {
+        link_class = add_link_class(link_override["bandwidth"].as<Bandwidth>(), link_override["latency"].as<Latency>());
+    } else {
+        report_error("link_overrides", "link overrides require a class, or bandwidth and latency");
+        return;
+    }
+
+    // the links: a device pair, a mesh row or column, or any link group
+    if (link_override["pair"]) {
+        const auto pair = parse_vector<int>(link_override["pair"]);
+        if (pair.size() != 2 || pair[0] < 0 || pair[1] < 0 || pair[0] == pair[1]) {
+            report_error("link_overrides", "link override pair should be two distinct devices");
+            return;
+        }
+        link_pair_overrides.push_back({pair[0], pair[1], link_class});
+    } else if (link_override["row"]) {
+        link_group_overrides.push_back({"row " + std::to_string(link_override["row"].as<int>()), link_class});
+    } else if (link_override["column"]) {
+        link_group_overrides.push_back({"column " + std::to_string(link_override["column"].as<int>()), link_class});
+    } else if (link_override["group"]) {
+        link_group_overrides.push_back({link_override["group"].as<std::string>(), link_class});
+    } else {
+        report_error("link_overrides", "link overrides require a pair, row, column, or group");
+    }
+}
+
 TopologyBuildingBlock NetworkParser::parse_topology_name(const std::string& topology_name) noexcept {
     assert(!topology_name.empty());
 
@@ -165,55 +1008,343 @@ TopologyBuildingBlock NetworkParser::parse_topology_name(const std::string& topo
         return TopologyBuildingBlock::SparseMesh2D;
     }
 
+    if (topology_name == "Mesh3D") {
+        return TopologyBuildingBlock::Mesh3D;
+    }
+
+    if (topology_name == "Torus2D") {
+        return TopologyBuildingBlock::Torus2D;
+    }
+
+    if (topology_name == "Torus3D") {
+        return TopologyBuildingBlock::Torus3D;
+    }
+
+    if (topology_name == "FatTree") {
+        return TopologyBuildingBlock::FatTree;
+    }
+
+    if (topology_name == "Dragonfly") {
+        return TopologyBuildingBlock::Dragonfly;
+    }
+
+    if (topology_name == "MultiRail") {
+        return TopologyBuildingBlock::MultiRail;
+    }
+
+    if (topology_name == "Custom") {
+        return TopologyBuildingBlock::Custom;
+    }
+
     // shouldn't reach here
-    std::cerr << "[Error] (network/analytical) " << "Topology name " << topology_name << " not supported" << std::endl;
-    std::exit(-1);
+    report_error("topology", "Topology name " + topology_name + " not supported");
+    return TopologyBuildingBlock::Undefined;
+}
+
+MeshRouting NetworkParser::parse_mesh_routing_name(const std::string& routing_name) noexcept {
+    assert(!routing_name.empty());
+
+    if (routing_name == "XY") {
+        return MeshRouting::XY;
+    }
+
+    if (routing_name == "O1Turn") {
+        return MeshRouting::O1Turn;
+    }
+
+    if (routing_name == "WestFirst") {
+        return MeshRouting::WestFirst;
+    }
+
+    // shouldn't reach here
+    report_error("routing", "Mesh routing " + routing_name + " not supported");
+    return MeshRouting::XY;
+}
+
+PlacementPattern NetworkParser::parse_placement_pattern_name(const std::string& pattern_name) noexcept {
+    assert(!pattern_name.empty());
+
+    if (pattern_name == "RowMajor") {
+        return PlacementPattern::RowMajor;
+    }
+
+    if (pattern_name == "Snake") {
+        return PlacementPattern::Snake;
+    }
+
+    if (pattern_name == "Hilbert") {
+        return PlacementPattern::Hilbert;
+    }
+
+    if (pattern_name == "RingOrder") {
+        return PlacementPattern::RingOrder;
+    }
+
+    // shouldn't reach here
+    report_error("npu_placement", "NPU placement " + pattern_name + " not supported");
+    return PlacementPattern::RowMajor;
+}
+
+DragonflyRouting NetworkParser::parse_dragonfly_routing_name(const std::string& routing_name) noexcept {
+    assert(!routing_name.empty());
+
+    if (routing_name == "Minimal") {
+        return DragonflyRouting::Minimal;
+    }
+
+    if (routing_name == "Valiant") {
+        return DragonflyRouting::Valiant;
+    }
+
+    // shouldn't reach here
+    report_error("routing", "Dragonfly routing " + routing_name + " not supported");
+    return DragonflyRouting::Minimal;
+}
+
+RailRouting NetworkParser::parse_rail_routing_name(const std::string& routing_name) noexcept {
+    assert(!routing_name.empty());
+
+    if (routing_name == "Hashed") {
+        return RailRouting::Hashed;
+    }
+
+    if (routing_name == "Sprayed") {
+        return RailRouting::Sprayed;
+    }
+
+    // shouldn't reach here
+    report_error("routing", "MultiRail routing " + routing_name + " not supported");
+    return RailRouting::Hashed;
 }
 
 void NetworkParser::check_validity() const noexcept {
+    for (const auto& error : validate()) {
+        report_error(error.key, error.message);
+    }
+}
+
+std::vector<ConfigError> NetworkParser::validate() const noexcept {
+    auto errors = std::vector<ConfigError>();
+
     // dims_count should match
+    if (dims_count < 1) {
+        errors.push_back({"topology", "at least 1 dimension is required"});
+        return errors;
+    }
     if (dims_count != npus_count_per_dim.size()) {
-        std::cerr << "[Error] (network/analytical) " << "length of npus_count (" << npus_count_per_dim.size()
-                  << ") doesn't match with dimensions (" << dims_count << ")" << std::endl;
-        std::exit(-1);
+        errors.push_back({"npus_count", concat("length of npus_count (", npus_count_per_dim.size(),
+                                               ") doesn't match with dimensions (", dims_count, ")")});
     }
-
     if (dims_count != bandwidth_per_dim.size()) {
-        std::cerr << "[Error] (network/analytical) " << "length of bandwidth (" << bandwidth_per_dim.size()
-                  << ") doesn't match with dims_count (" << dims_count << ")" << std::endl;
-        std::exit(-1);
+        errors.push_back({"bandwidth", concat("length of bandwidth (", bandwidth_per_dim.size(),
+                                              ") doesn't match with dims_count (", dims_count, ")")});
     }
-
     if (dims_count != latency_per_dim.size()) {
-        std::cerr << "[Error] (network/analytical) " << "length of latency (" << latency_per_dim.size()
-                  << ") doesn't match with dims_count (" << dims_count << ")" << std::endl;
-        std::exit(-1);
+        errors.push_back({"latency", concat("length of latency (", latency_per_dim.size(),
+                                            ") doesn't match with dims_count (", dims_count, ")")});
+    }
+    if (!errors.empty()) {
+        // the checks below look up each dimension
+        return errors;
     }
 
     // npus_count should be all positive
     for (const auto& npus_count : npus_count_per_dim) {
         if (npus_count <= 1) {
-            std::cerr << "[Error] (network/analytical) " << "npus_count (" << npus_count << ") should be larger than 1"
-                      << std::endl;
-            std::exit(-1);
+            errors.push_back({"npus_count", concat("npus_count (", npus_count, ") should be larger than 1")});
         }
     }
 
     // bandwidths should be all positive
     for (const auto& bandwidth : bandwidth_per_dim) {
         if (bandwidth <= 0) {
-            std::cerr << "[Error] (network/analytical) " << "bandwidth (" << bandwidth << ") should be larger than 0"
-                      << std::endl;
-            std::exit(-1);
+            errors.push_back({"bandwidth", concat("bandwidth (", bandwidth, ") should be larger than 0")});
         }
     }
 
     // latency should be non-negative
     for (const auto& latency : latency_per_dim) {
         if (latency < 0) {
-            std::cerr << "[Error] (network/analytical) " << "latency (" << latency << ") should be non-negative"
-                      << std::endl;
-            std::exit(-1);
+            errors.push_back({"latency", concat("latency (", latency, ") should be non-negative")});
+        }
+    }
+
+    // only Ring, FullyConnected, and Switch stack up into multi-dim topologies
+    for (const auto& topology : topology_per_dim) {
+        if (topology == TopologyBuildingBlock::Undefined) {
+            errors.push_back({"topology", "topology of every dimension is required"});
+        } else if (dims_count > 1 && topology != TopologyBuildingBlock::Ring &&
+                   topology != TopologyBuildingBlock::FullyConnected && topology != TopologyBuildingBlock::Switch) {
+            errors.push_back({"topology", "not supported basic-topology in multi-dim topology"});
+        }
+    }
+
+    // excluded rectangles and boxes should be well-formed
+    for (const auto& [x_min, y_min, x_max, y_max] : excluded_regions) {
+        if (x_min > x_max || y_min > y_max) {
+            errors.push_back({"excluded", concat("excluded rectangle [", x_min, ", ", y_min, ", ", x_max, ", ", y_max,
+                                                 "] should have its min corner first")});
+        }
+    }
+    for (const auto& [x_min, y_min, z_min, x_max, y_max, z_max] : excluded_boxes) {
+        if (x_min > x_max || y_min > y_max || z_min > z_max) {
+            errors.push_back({"excluded", concat("excluded box [", x_min, ", ", y_min, ", ", z_min, ", ", x_max, ", ",
+                                                 y_max, ", ", z_max, "] should have its min corner first")});
         }
     }
+
+    // a bitmap or a placement pattern is laid over the grid
+    const auto has_grid = mesh_width > 0 && mesh_height > 0;
+    if (!has_grid && (!excluded_bitmap_path.empty() || placement_pattern == PlacementPattern::Snake ||
+                      placement_pattern == PlacementPattern::Hilbert ||
+                      placement_pattern == PlacementPattern::RingOrder)) {
+        errors.push_back({"npu_placement", "excluded_bitmap and npu_placement patterns require width and height"});
+    }
+
+    // a sparse mesh is laid over a grid
+    if (topology_per_dim[0] == TopologyBuildingBlock::SparseMesh2D && !has_grid) {
+        errors.push_back({"width", "SparseMesh2D requires width and height"});
+    }
+
+    // a full mesh places an NPU on every cell of its grid (square without width and height)
+    if (topology_per_dim[0] == TopologyBuildingBlock::Mesh2D) {
+        const auto npus_count = npus_count_per_dim[0];
+        const auto side = static_cast<int>(std::lround(std::sqrt(npus_count)));
+        if (has_grid && mesh_width * mesh_height != npus_count) {
+            errors.push_back({"width", concat("Mesh2D width (", mesh_width, ") and height (", mesh_height,
+                                              ") should multiply to npus_count (", npus_count, ")")});
+        } else if (!has_grid && side * side != npus_count) {
+            errors.push_back({"npus_count", concat("Mesh2D npus_count (", npus_count,
+                                                   ") should be a perfect square without width and height")});
+        }
+    }
+
+    // files the topology is loaded from should be readable, and a bitmap should cover the grid
+    if (!excluded_bitmap_path.empty() && !std::ifstream(excluded_bitmap_path)) {
+        errors.push_back({"excluded_bitmap", "bad file: " + excluded_bitmap_path});
+    } else if (!excluded_bitmap_path.empty() && has_grid) {
+        auto valid_cells = std::vector<bool>(static_cast<size_t>(mesh_width) * mesh_height, true);
+        if (!apply_excluded_bitmap(valid_cells)) {
+            errors.push_back({"excluded_bitmap", excluded_bitmap_error()});
+        }
+    }
+    if (!edge_list_path.empty() && !std::ifstream(edge_list_path)) {
+        errors.push_back({"edge_list", "bad file: " + edge_list_path});
+    }
+
+    // a fat-tree is a 1-dim topology of a given radix, whose top tier reaches every leaf (2 tiers) or pod (3 tiers)
+    for (const auto& topology : topology_per_dim) {
+        if (topology != TopologyBuildingBlock::FatTree) {
+            continue;
+        }
+        if (dims_count != 1 || fat_tree_radix <= 0) {
+            errors.push_back({"radix", "FatTree is a 1-dim topology, and requires radix"});
+            continue;
+        }
+        if (fat_tree_tiers != 2 && fat_tree_tiers != 3) {
+            errors.push_back({"tiers", concat("FatTree tiers (", fat_tree_tiers, ") should be 2 or 3")});
+            continue;
+        }
+        if (fat_tree_radix % 2 != 0 || fat_tree_oversubscription < 1 ||
+            fat_tree_radix % (fat_tree_oversubscription + 1) != 0) {
+            errors.push_back({"radix", concat("FatTree radix (", fat_tree_radix,
+                                              ") should be even and divisible by oversubscription (",
+                                              fat_tree_oversubscription, ") + 1")});
+            continue;
+        }
+        const auto leaf_down_ports = fat_tree_radix - fat_tree_radix / (fat_tree_oversubscription + 1);
+        const auto leaves_count = (npus_count_per_dim[0] + leaf_down_ports - 1) / leaf_down_ports;
+        const auto pods_count = (leaves_count + fat_tree_radix / 2 - 1) / (fat_tree_radix / 2);
+        if (((fat_tree_tiers == 2) ? leaves_count : pods_count) > fat_tree_radix) {
+            errors.push_back({"npus_count", concat("a ", fat_tree_tiers, "-tier FatTree of radix ", fat_tree_radix,
+                                                   " can't connect ", npus_count_per_dim[0], " NPUs")});
+        }
+    }
+
+    // a dragonfly is a 1-dim topology of whole groups, each reaching every other group
+    for (const auto& topology : topology_per_dim) {
+        if (topology != TopologyBuildingBlock::Dragonfly) {
+            continue;
+        }
+        if (dims_count != 1 || dragonfly_npus_per_router <= 0 || dragonfly_routers_per_group <= 0 ||
+            dragonfly_global_links_per_router <= 0) {
+            errors.push_back({"routers_per_group", "Dragonfly is a 1-dim topology, and requires routers_per_group "
+                                                   "and global_links_per_router"});
+            continue;
+        }
+        const auto group_npus_count = dragonfly_npus_per_router * dragonfly_routers_per_group;
+        const auto groups_count = npus_count_per_dim[0] / group_npus_count;
+        if (npus_count_per_dim[0] % group_npus_count != 0 ||
+            groups_count - 1 > dragonfly_routers_per_group * dragonfly_global_links_per_router) {
+            errors.push_back({"npus_count", concat("Dragonfly npus_count (", npus_count_per_dim[0],
+                                                   ") should fill whole groups, each with a global link to every "
+                                                   "other group")});
+        }
+    }
+
+    // a multi-rail topology is a 1-dim topology of a given number of rails
+    for (const auto& topology : topology_per_dim) {
+        if (topology == TopologyBuildingBlock::MultiRail && (dims_count != 1 || multi_rail_rails_count <= 0)) {
+            errors.push_back({"rails", "MultiRail is a 1-dim topology, and requires rails"});
+        }
+    }
+
+    // a custom topology is a 1-dim topology loaded from an edge list
+    for (const auto& topology : topology_per_dim) {
+        if (topology == TopologyBuildingBlock::Custom && (dims_count != 1 || edge_list_path.empty())) {
+            errors.push_back({"edge_list", "Custom is a 1-dim topology, and requires edge_list"});
+        }
+    }
+
+    // torus dimensions should cover every NPU
+    for (const auto& topology : topology_per_dim) {
+        if (topology != TopologyBuildingBlock::Torus2D && topology != TopologyBuildingBlock::Torus3D) {
+            continue;
+        }
+        if (dims_count != 1) {
+            errors.push_back({"topology", "Torus2D and Torus3D are 1-dim topologies only"});
+            continue;
+        }
+        const auto depth = (topology == TopologyBuildingBlock::Torus3D) ? mesh_depth : 1;
+        if (mesh_width <= 0 || mesh_height <= 0 || depth <= 0 ||
+            mesh_width * mesh_height * depth != npus_count_per_dim[0]) {
+            errors.push_back({"width", concat("torus width, height (and depth) should multiply to npus_count (",
+                                              npus_count_per_dim[0], ")")});
+        }
+    }
+
+    // a 3D mesh is a 1-dim topology, whose valid cells cover every NPU
+    const auto is_mesh_3d = dims_count == 1 && topology_per_dim[0] == TopologyBuildingBlock::Mesh3D;
+    for (const auto& topology : topology_per_dim) {
+        if (topology != TopologyBuildingBlock::Mesh3D) {
+            continue;
+        }
+        if (dims_count != 1 || mesh_width <= 0 || mesh_height <= 0 || mesh_depth <= 0) {
+            errors.push_back({"depth", "Mesh3D is a 1-dim topology, and requires width, height, and depth"});
+            continue;
+        }
+        const auto valid_cells = get_valid_cells_3d();
+        const auto valid_cells_count = std::count(valid_cells.begin(), valid_cells.end(), true);
+        if (valid_cells_count != npus_count_per_dim[0]) {
+            errors.push_back({"npus_count", concat("Mesh3D has ", valid_cells_count, " valid cells, but npus_count is ",
+                                                   npus_count_per_dim[0])});
+        }
+    }
+
+    // excluded boxes and vertical links only shape 3D meshes
+    const auto has_vertical_links = vertical_bandwidth != -1 || vertical_latency != -1;
+    if ((!excluded_boxes.empty() || has_vertical_links) && !is_mesh_3d) {
+        errors.push_back({"excluded", "[x, y, z] excluded cells, vertical_bandwidth, and vertical_latency require a "
+                                      "Mesh3D topology"});
+    }
+    if (is_mesh_3d && (!excluded_regions.empty() || !excluded_bitmap_path.empty())) {
+        errors.push_back({"excluded", "Mesh3D excluded entries should be [x, y, z] cells or "
+                                      "[x_min, y_min, z_min, x_max, y_max, z_max] boxes"});
+    }
+    if ((vertical_bandwidth != -1 && vertical_bandwidth <= 0) || (vertical_latency != -1 && vertical_latency < 0)) {
+        errors.push_back({"vertical_bandwidth", "vertical_bandwidth should be positive, and vertical_latency "
+                                                "non-negative"});
+    }
+
+    return errors;
 }
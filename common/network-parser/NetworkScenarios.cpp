@@ -0,0 +1,155 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/NetworkScenarios.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+namespace {
+
+/**
+ * Replace top-level keys of a network configuration.
+ *
+ * @param network_config network configuration, modified
+ * @param delta keys to replace, with their values (a name key is skipped)
+ */
+void apply_delta(YAML::Node& network_config, const YAML::Node& delta) {
+    for (const auto& entry : delta) {
+        const auto key = entry.first.as<std::string>();
+        if (key != "name") {
+            network_config[key] = YAML::Clone(entry.second);
+        }
+    }
+}
+
+/**
+ * Format a yml value on a single line, e.g., "[100]".
+ *
+ * @param value yml value
+ * @return value in flow style
+ */
+std::string flow_string(const YAML::Node& value) {
+    auto emitter = YAML::Emitter();
+    emitter << YAML::Flow << value;
+    return emitter.c_str();
+}
+
+}  // namespace
+
+NetworkScenarios::NetworkScenarios(const std::string& path) noexcept {
+    auto scenarios_config = YAML::Node();
+    try {
+        scenarios_config = YAML::LoadFile(path);
+    } catch (const YAML::Exception& e) {
+        // the file can't be read, or isn't valid yml
+        std::cerr << "[Error] (network/analytical) " << path << ": " << e.what() << std::endl;
+        std::exit(-1);
+    }
+    build_scenarios(scenarios_config);
+}
+
+NetworkScenarios::NetworkScenarios(const YAML::Node& scenarios_config) noexcept {
+    build_scenarios(scenarios_config);
+}
+
+int NetworkScenarios::get_scenarios_count() const noexcept {
+    return static_cast<int>(names.size());
+}
+
+const std::string& NetworkScenarios::get_name(const int scenario) const noexcept {
+    assert(0 <= scenario && scenario < get_scenarios_count());
+
+    return names[scenario];
+}
+
+const std::optional<NetworkParser>& NetworkScenarios::get_network_parser(const int scenario) const noexcept {
+    assert(0 <= scenario && scenario < get_scenarios_count());
+
+    return network_parsers[scenario];
+}
+
+const std::vector<ConfigError>& NetworkScenarios::get_config_errors(const int scenario) const noexcept {
+    assert(0 <= scenario && scenario < get_scenarios_count());
+
+    return config_errors[scenario];
+}
+
+void NetworkScenarios::build_scenarios(const YAML::Node& scenarios_config) noexcept {
+    try {
+        // the base is every key but the scenarios and the sweep
+        auto base = YAML::Node(YAML::NodeType::Map);
+        for (const auto& entry : scenarios_config) {
+            const auto key = entry.first.as<std::string>();
+            if (key != "scenarios" && key != "sweep") {
+                base[key] = entry.second;
+            }
+        }
+
+        // the scenarios apply their deltas to the base (the base alone if there is none)
+        auto scenario_names = std::vector<std::string>();
+        auto scenario_configs = std::vector<YAML::Node>();
+        const auto deltas = scenarios_config["scenarios"];
+        const auto deltas_count = deltas ? deltas.size() : 0;
+        for (auto i = size_t(0); i < deltas_count; i++) {
+            scenario_names.push_back(deltas[i]["name"] ? deltas[i]["name"].as<std::string>() : std::to_string(i));
+            scenario_configs.push_back(YAML::Clone(base));
+            apply_delta(scenario_configs.back(), deltas[i]);
+        }
+        if (scenario_configs.empty()) {
+            scenario_names.emplace_back("base");
+            scenario_configs.push_back(base);
+        }
+
+        // every combination of the swept values applies to every scenario, the last key varying fastest
+        auto swept_keys = std::vector<std::string>();
+        auto swept_values = std::vector<YAML::Node>();
+        for (const auto& entry : scenarios_config["sweep"]) {
+            swept_keys.push_back(entry.first.as<std::string>());
+            swept_values.push_back(entry.second);
+            if (!entry.second.IsSequence() || entry.second.size() == 0) {
+                std::cerr << "[Error] (network/analytical) " << "swept key " << swept_keys.back()
+                          << " should list its values" << std::endl;
+                std::exit(-1);
+            }
+        }
+        for (auto scenario = size_t(0); scenario < scenario_configs.size(); scenario++) {
+            auto value_indices = std::vector<size_t>(swept_keys.size(), 0);
+            while (true) {
+                auto network_config = YAML::Clone(scenario_configs[scenario]);
+                auto name = scenario_names[scenario];
+                for (auto key = size_t(0); key < swept_keys.size(); key++) {
+                    const auto& value = swept_values[key][value_indices[key]];
+                    network_config[swept_keys[key]] = YAML::Clone(value);
+                    name += " " + swept_keys[key] + "=" + flow_string(value);
+                }
+                add_scenario(std::move(name), network_config);
+
+                // next combination, as an odometer
+                auto key = swept_keys.size();
+                while (key > 0 && ++value_indices[key - 1] == swept_values[key - 1].size()) {
+                    value_indices[key - 1] = 0;
+                    key--;
+                }
+                if (key == 0) {
+                    break;
+                }
+            }
+        }
+    } catch (const YAML::Exception& e) {
+        // the scenarios or the sweep aren't shaped as expected
+        std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
+        std::exit(-1);
+    }
+}
+
+void NetworkScenarios::add_scenario(std::string name, const YAML::Node& network_config) noexcept {
+    names.push_back(std::move(name));
+    config_errors.emplace_back();
+    network_parsers.push_back(NetworkParser::try_parse(network_config, config_errors.back()));
+}
@@ -29,9 +29,6 @@ BasicTopology::BasicTopology(const int npus_count,
     dims_count = 1;
     npus_count_per_dim.push_back(npus_count);
     bandwidth_per_dim.push_back(bandwidth);
-
-    // instantiate devices
-    instantiate_devices();
 }
 
 // default destructor
@@ -42,3 +39,36 @@ TopologyBuildingBlock BasicTopology::get_basic_topology_type() const noexcept {
 
     return basic_topology_type;
 }
+
+EventTime BasicTopology::get_zero_load_latency(const DeviceId src,
+                                               const DeviceId dest,
+                                               const ChunkSize chunk_size) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(chunk_size > 0);
+
+    // multi-dimensional building blocks override this, or take the default
+    if (dims_count != 1) {
+        return Topology::get_zero_load_latency(src, dest, chunk_size);
+    }
+
+    const auto hops_count = get_hops_count(src, dest);
+    return (hops_count > 0) ? hops_count * dim_link_delay(0, chunk_size) : 0;
+}
+
+EventTime BasicTopology::dim_link_delay(const int dim, const ChunkSize chunk_size) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(chunk_size > 0);
+
+    // link ids follow the construction order, so the first link of a dimension comes early
+    const auto links_count = get_links_count();
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        if (get_link_dim(link_id) == dim) {
+            return get_link(link_id).communication_delay(chunk_size);
+        }
+    }
+
+    // shouldn't reach here
+    assert(false);
+    return 0;
+}
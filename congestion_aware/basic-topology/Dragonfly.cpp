@@ -0,0 +1,250 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Dragonfly.h"
+#include "common/Logger.h"
+#include "common/NetworkFunction.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+Dragonfly::Dragonfly(const int npus_count,
+                     const int npus_per_router,
+                     const int routers_per_group,
+                     const int global_links_per_router,
+                     const Bandwidth bandwidth,
+                     const Latency latency) noexcept
+    : npus_per_router(npus_per_router),
+      routers_per_group(routers_per_group),
+      global_links_per_router(global_links_per_router),
+      groups_count(npus_count / (npus_per_router * routers_per_group)),
+      routing(DragonflyRouting::Minimal),
+      BasicTopology(npus_count, npus_count + npus_count / npus_per_router, bandwidth, latency) {
+    assert(npus_count > 0);
+    assert(npus_per_router > 0);
+    assert(routers_per_group > 0);
+    assert(global_links_per_router > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    if (npus_count % (npus_per_router * routers_per_group) != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Dragonfly NPUs count (" << npus_count
+                  << ") should be a multiple of NPUs per group (" << npus_per_router * routers_per_group << ")"
+                  << std::endl;
+        std::exit(-1);
+    }
+    if (groups_count - 1 > routers_per_group * global_links_per_router) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Dragonfly groups ("
+                  << routers_per_group * global_links_per_router << " global links each) can't reach all "
+                  << groups_count << " groups" << std::endl;
+        std::exit(-1);
+    }
+
+    basic_topology_type = TopologyBuildingBlock::Dragonfly;
+
+    // NPU links, local links within every group, and a global link between every two groups
+    const auto routers_count = groups_count * routers_per_group;
+    links.reserve(2 * npus_count + routers_count * (routers_per_group - 1) + groups_count * (groups_count - 1));
+
+    // NPUs to their routers
+    for (auto npu = 0; npu < npus_count; npu++) {
+        connect(npu, get_router(npu), bandwidth, latency, true);
+    }
+
+    // routers of a group to each other
+    for (auto group = 0; group < groups_count; group++) {
+        const auto first_router_id = npus_count + group * routers_per_group;
+        for (auto i = 0; i < routers_per_group; i++) {
+            for (auto j = i + 1; j < routers_per_group; j++) {
+                connect(first_router_id + i, first_router_id + j, bandwidth, latency, true);
+            }
+        }
+    }
+
+    // groups to each other
+    for (auto group = 0; group < groups_count; group++) {
+        for (auto target_group = group + 1; target_group < groups_count; target_group++) {
+            connect(gateway_router(group, target_group), gateway_router(target_group, group), bandwidth, latency,
+                    true);
+        }
+    }
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[DRAGONFLY-INIT] " << npus_count << " NPUs, " << groups_count << " groups of "
+                                               << routers_per_group << " routers, " << links.size()
+                                               << " directed links");
+}
+
+Route Dragonfly::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // follow the next hops until reaching dest
+    auto route = Route();
+    route.push_back(src);
+    for (auto current = src; current != dest;) {
+        current = next_hop(current, dest);
+        route.push_back(current);
+    }
+
+    return route;
+}
+
+DeviceId Dragonfly::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // NPUs go to their router
+    if (current < npus_count) {
+        return get_router(current);
+    }
+
+    // routers go down to dest, over to the dest router within its group, or toward its group
+    const auto dest_router = get_router(dest);
+    if (current == dest_router) {
+        return dest;
+    }
+    const auto dest_group = get_group(dest_router);
+    if (get_group(current) == dest_group) {
+        return dest_router;
+    }
+    return step_to_group(current, dest_group);
+}
+
+const Route* Dragonfly::select_route(const DeviceId src, const DeviceId dest, const uint64_t chunk_id) const noexcept {
+    // Valiant routing needs a group other than the src and dest groups
+    const auto src_group = get_group(get_router(src));
+    const auto dest_group = get_group(get_router(dest));
+    if (routing != DragonflyRouting::Valiant || src_group == dest_group || groups_count < 3) {
+        return shared_route(src, dest);
+    }
+
+    // pick the intermediate group among the others
+    auto intermediate_group = static_cast<int>(mix_bits(chunk_id) % static_cast<uint64_t>(groups_count - 2));
+    for (const auto skipped_group : {std::min(src_group, dest_group), std::max(src_group, dest_group)}) {
+        if (intermediate_group >= skipped_group) {
+            intermediate_group++;
+        }
+    }
+    return valiant_route(src, dest, intermediate_group);
+}
+
+const Route* Dragonfly::valiant_route(const DeviceId src,
+                                      const DeviceId dest,
+                                      const int intermediate_group) const noexcept {
+    // intern the route (unordered_map nodes never move)
+    const auto key = (static_cast<uint64_t>(src) * npus_count + dest) * groups_count + intermediate_group;
+    auto& route = valiant_routes[key];
+    if (route.empty()) {
+        route = compute_valiant_route(src, dest, intermediate_group);
+        resolve_links(route);
+    }
+    return &route;
+}
+
+bool Dragonfly::has_fixed_routes() const noexcept {
+    return routing == DragonflyRouting::Minimal && Topology::has_fixed_routes();
+}
+
+void Dragonfly::build_route_tables() const noexcept {
+    Topology::build_route_tables();
+
+    // Valiant routing passes through any group other than the src and dest groups
+    if (routing != DragonflyRouting::Valiant || groups_count < 3) {
+        return;
+    }
+    for (auto src = 0; src < npus_count; src++) {
+        const auto src_group = get_group(get_router(src));
+        for (auto dest = 0; dest < npus_count; dest++) {
+            const auto dest_group = get_group(get_router(dest));
+            for (auto group = 0; group < groups_count; group++) {
+                if (src_group != dest_group && group != src_group && group != dest_group) {
+                    static_cast<void>(valiant_route(src, dest, group));
+                }
+            }
+        }
+    }
+}
+
+void Dragonfly::set_routing(const DragonflyRouting new_routing) noexcept {
+    routing = new_routing;
+}
+
+DragonflyRouting Dragonfly::get_routing() const noexcept {
+    return routing;
+}
+
+int Dragonfly::get_groups_count() const noexcept {
+    return groups_count;
+}
+
+DeviceId Dragonfly::get_router(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    return npus_count + npu_id / npus_per_router;
+}
+
+int Dragonfly::get_group(const DeviceId router_id) const noexcept {
+    assert(npus_count <= router_id && router_id < devices_count);
+
+    return (router_id - npus_count) / routers_per_group;
+}
+
+DeviceId Dragonfly::gateway_router(const int group, const int target_group) const noexcept {
+    assert(0 <= group && group < groups_count);
+    assert(0 <= target_group && target_group < groups_count);
+    assert(group != target_group);
+
+    // global ports of a group are numbered by the distance to the target group
+    const auto global_port = (target_group - group - 1 + groups_count) % groups_count;
+    return npus_count + group * routers_per_group + global_port / global_links_per_router;
+}
+
+DeviceId Dragonfly::step_to_group(const DeviceId router_id, const int target_group) const noexcept {
+    const auto group = get_group(router_id);
+    assert(group != target_group);
+
+    // local hop to the gateway, then the global hop
+    const auto gateway = gateway_router(group, target_group);
+    return (router_id != gateway) ? gateway : gateway_router(target_group, group);
+}
+
+Route Dragonfly::compute_valiant_route(const DeviceId src,
+                                       const DeviceId dest,
+                                       const int intermediate_group) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // minimal route to the intermediate group
+    auto route = Route();
+    route.push_back(src);
+    auto current = get_router(src);
+    route.push_back(current);
+    while (get_group(current) != intermediate_group) {
+        current = step_to_group(current, intermediate_group);
+        route.push_back(current);
+    }
+
+    // then the minimal route to dest
+    while (current != dest) {
+        current = next_hop(current, dest);
+        route.push_back(current);
+    }
+
+    return route;
+}
+
+uint64_t Dragonfly::get_route_tables_bytes() const noexcept {
+    // every interned Valiant route is a hash node (route and next pointer), plus the bucket array
+    auto allocated_bytes = Topology::get_route_tables_bytes();
+    allocated_bytes += valiant_routes.bucket_count() * sizeof(void*);
+    for (const auto& [key, valiant_route] : valiant_routes) {
+        allocated_bytes += sizeof(void*) + sizeof(std::pair<const uint64_t, Route>) + valiant_route.get_heap_bytes();
+    }
+    return allocated_bytes;
+}
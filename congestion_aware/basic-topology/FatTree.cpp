@@ -0,0 +1,191 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/FatTree.h"
+#include "common/Logger.h"
+#include "common/NetworkFunction.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Divide, rounding up.
+ *
+ * @param dividend dividend
+ * @param divisor divisor
+ * @return dividend / divisor, rounded up
+ */
+int ceil_div(const int dividend, const int divisor) noexcept {
+    return (dividend + divisor - 1) / divisor;
+}
+
+}  // namespace
+
+FatTree::FatTree(const int npus_count,
+                 const int radix,
+                 const int tiers,
+                 const Bandwidth bandwidth,
+                 const Latency latency,
+                 const int oversubscription) noexcept
+    : radix(radix),
+      tiers(tiers),
+      leaf_up_ports(radix / (oversubscription + 1)),
+      leaf_down_ports(radix - radix / (oversubscription + 1)),
+      leaves_count(ceil_div(npus_count, leaf_down_ports)),
+      leaves_per_pod((tiers == 3) ? radix / 2 : leaves_count),
+      pods_count(ceil_div(leaves_count, leaves_per_pod)),
+      first_leaf_id(npus_count),
+      first_spine_id(npus_count + leaves_count),
+      first_core_id(first_spine_id + pods_count * leaf_up_ports),
+      BasicTopology(npus_count, devices_count_of(npus_count, radix, tiers, oversubscription), bandwidth, latency) {
+    assert(npus_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // spines (2 tiers) and cores (3 tiers) connect to every leaf and pod, respectively
+    const auto top_ports_used = (tiers == 2) ? leaves_count : pods_count;
+    if (top_ports_used > radix) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "a " << tiers << "-tier fat-tree of radix "
+                  << radix << " can't connect " << npus_count << " NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    basic_topology_type = TopologyBuildingBlock::FatTree;
+
+    // every NPU and leaf uplink has a link, as has every aggregation uplink for 3 tiers
+    const auto aggregation_links_count = (tiers == 3) ? pods_count * leaf_up_ports * (radix / 2) : 0;
+    links.reserve(2 * (npus_count + leaves_count * leaf_up_ports + aggregation_links_count));
+
+    // NPUs to their leaves
+    for (auto npu = 0; npu < npus_count; npu++) {
+        connect(npu, get_leaf(npu), bandwidth, latency, true);
+    }
+
+    // leaves to the spines (aggregation switches) of their pod
+    for (auto leaf = 0; leaf < leaves_count; leaf++) {
+        const auto pod = leaf / leaves_per_pod;
+        for (auto port = 0; port < leaf_up_ports; port++) {
+            connect(first_leaf_id + leaf, first_spine_id + pod * leaf_up_ports + port, bandwidth, latency, true);
+        }
+    }
+
+    // aggregation switch a of every pod to the cores of group a
+    for (auto pod = 0; pod < pods_count && tiers == 3; pod++) {
+        for (auto aggregation = 0; aggregation < leaf_up_ports; aggregation++) {
+            for (auto port = 0; port < radix / 2; port++) {
+                connect(first_spine_id + pod * leaf_up_ports + aggregation,
+                        first_core_id + aggregation * (radix / 2) + port, bandwidth, latency, true);
+            }
+        }
+    }
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[FAT-TREE-INIT] " << npus_count << " NPUs, radix " << radix << ", " << tiers << " tiers, "
+                                              << leaves_count << " leaves, " << pods_count << " pods, "
+                                              << (devices_count - npus_count) << " switches, " << links.size()
+                                              << " directed links");
+}
+
+Route FatTree::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // follow the next hops until reaching dest
+    auto route = Route();
+    route.push_back(src);
+    for (auto current = src; current != dest;) {
+        current = next_hop(current, dest);
+        route.push_back(current);
+    }
+
+    return route;
+}
+
+DeviceId FatTree::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    const auto dest_leaf = get_leaf(dest);
+    const auto dest_pod = (dest_leaf - first_leaf_id) / leaves_per_pod;
+
+    // NPUs go to their leaf
+    if (current < first_leaf_id) {
+        return get_leaf(current);
+    }
+
+    // leaves go down to dest, or up to a spine (aggregation switch) of their pod
+    if (current < first_spine_id) {
+        if (current == dest_leaf) {
+            return dest;
+        }
+        const auto pod = (current - first_leaf_id) / leaves_per_pod;
+        return first_spine_id + pod * leaf_up_ports + ecmp_port(current, dest, leaf_up_ports);
+    }
+
+    // spines (aggregation switches) go down within dest's pod, or up to a core of their group
+    if (current < first_core_id) {
+        const auto pod = (current - first_spine_id) / leaf_up_ports;
+        if (pod == dest_pod) {
+            return dest_leaf;
+        }
+        assert(tiers == 3);
+        const auto group = (current - first_spine_id) % leaf_up_ports;
+        return first_core_id + group * (radix / 2) + ecmp_port(current, dest, radix / 2);
+    }
+
+    // cores go down to the aggregation switch of their group in dest's pod
+    const auto group = (current - first_core_id) / (radix / 2);
+    return first_spine_id + dest_pod * leaf_up_ports + group;
+}
+
+int FatTree::get_tiers() const noexcept {
+    return tiers;
+}
+
+DeviceId FatTree::get_leaf(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    return first_leaf_id + npu_id / leaf_down_ports;
+}
+
+int FatTree::devices_count_of(const int npus_count,
+                              const int radix,
+                              const int tiers,
+                              const int oversubscription) noexcept {
+    if (tiers != 2 && tiers != 3) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "fat-tree tiers (" << tiers
+                  << ") should be 2 or 3" << std::endl;
+        std::exit(-1);
+    }
+    if (radix < 2 || radix % 2 != 0 || oversubscription < 1 || radix % (oversubscription + 1) != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "fat-tree radix (" << radix
+                  << ") should be even and divisible by oversubscription (" << oversubscription << ") + 1"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    const auto leaf_up_ports = radix / (oversubscription + 1);
+    const auto leaves_count = ceil_div(npus_count, radix - leaf_up_ports);
+    if (tiers == 2) {
+        return npus_count + leaves_count + leaf_up_ports;
+    }
+
+    // 3 tiers: aggregation switches per pod, and radix / 2 cores per aggregation switch of a pod
+    const auto pods_count = ceil_div(leaves_count, radix / 2);
+    return npus_count + leaves_count + pods_count * leaf_up_ports + leaf_up_ports * (radix / 2);
+}
+
+int FatTree::ecmp_port(const DeviceId current, const DeviceId dest, const int up_ports_count) noexcept {
+    assert(up_ports_count > 0);
+
+    // hash (current, dest): deterministic, and consistent for every route through current
+    const auto key = (static_cast<uint64_t>(current) << 32) | static_cast<uint64_t>(dest);
+    return static_cast<int>(mix_bits(key) % static_cast<uint64_t>(up_ports_count));
+}
@@ -4,12 +4,17 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/FullyConnected.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
 using namespace NetworkAnalyticalCongestionAware;
 
 FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth, const Latency latency) noexcept
-    : BasicTopology(npus_count, npus_count, bandwidth, latency) {
+    : BasicTopology(npus_count, npus_count, bandwidth, latency),
+      routing(FullyConnectedRouting::Direct),
+      adaptive_threshold(2) {
     assert(npus_count > 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
@@ -17,17 +22,34 @@ FullyConnected::FullyConnected(const int npus_count, const Bandwidth bandwidth,
     // set topology type
     basic_topology_type = TopologyBuildingBlock::FullyConnected;
 
-    // fully-connect every src-dest pairs
-    for (auto src = 0; src < npus_count; src++) {
-        for (auto dest = 0; dest < npus_count; dest++) {
-            if (src != dest) {
-                connect(src, dest, bandwidth, latency, false);
-            }
-        }
+    // fully-connect every src-dest pairs, in src-major order
+    // links are only materialized once a chunk goes through them (a workload rarely uses all N^2)
+    const auto links_count = npus_count * (npus_count - 1);
+    links.make_lazy(
+        links_count,
+        [npus_count](const LinkId link_id) {
+            const auto src = link_id / (npus_count - 1);
+            const auto dest_index = link_id % (npus_count - 1);
+            return std::make_pair(src, (dest_index < src) ? dest_index : dest_index + 1);
+        },
+        bandwidth, latency);
+}
+
+LinkId FullyConnected::find_link(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // no self-loop
+    if (src == dest) {
+        return -1;
     }
+
+    // links of src skip src itself
+    return src * (npus_count - 1) + ((dest < src) ? dest : dest - 1);
 }
 
-Route FullyConnected::route(const DeviceId src, const DeviceId dest) const noexcept {
+Route FullyConnected::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
@@ -35,8 +57,132 @@ Route FullyConnected::route(const DeviceId src, const DeviceId dest) const noexc
     // construct route
     // directly connected
     auto route = Route();
-    route.push_back(devices[src]);
-    route.push_back(devices[dest]);
+    route.push_back(src);
+    route.push_back(dest);
 
     return route;
 }
+
+DeviceId FullyConnected::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // directly connected
+    return dest;
+}
+
+const Route* FullyConnected::select_route(const DeviceId src,
+                                          const DeviceId dest,
+                                          const uint64_t chunk_id) const noexcept {
+    // indirect routing needs an NPU other than src and dest
+    if (routing == FullyConnectedRouting::Direct || src == dest || npus_count < 3) {
+        return shared_route(src, dest);
+    }
+
+    // pick the intermediate NPU among the others
+    auto intermediate = static_cast<DeviceId>(mix_bits(chunk_id) % static_cast<uint64_t>(npus_count - 2));
+    for (const auto skipped_npu : {std::min(src, dest), std::max(src, dest)}) {
+        if (intermediate >= skipped_npu) {
+            intermediate++;
+        }
+    }
+
+    // adaptive: keep the direct link unless it's congested, and worse than the indirect route
+    if (routing == FullyConnectedRouting::Adaptive) {
+        const auto direct_queued_chunks = get_link(find_link(src, dest)).get_queued_chunks_count();
+        const auto indirect_queued_chunks = get_link(find_link(src, intermediate)).get_queued_chunks_count();
+        if (direct_queued_chunks < adaptive_threshold || direct_queued_chunks <= 2 * indirect_queued_chunks) {
+            return shared_route(src, dest);
+        }
+    }
+
+    return indirect_route(src, dest, intermediate);
+}
+
+bool FullyConnected::has_fixed_routes() const noexcept {
+    return routing == FullyConnectedRouting::Direct && Topology::has_fixed_routes();
+}
+
+void FullyConnected::build_route_tables() const noexcept {
+    Topology::build_route_tables();
+
+    // indirect routing passes through any NPU other than src and dest
+    if (routing == FullyConnectedRouting::Direct || npus_count < 3) {
+        return;
+    }
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            for (auto intermediate = 0; intermediate < npus_count; intermediate++) {
+                if (src != dest && intermediate != src && intermediate != dest) {
+                    static_cast<void>(indirect_route(src, dest, intermediate));
+                }
+            }
+        }
+    }
+}
+
+void FullyConnected::set_routing(const FullyConnectedRouting new_routing, const int new_adaptive_threshold) noexcept {
+    assert(new_adaptive_threshold >= 0);
+
+    routing = new_routing;
+    adaptive_threshold = new_adaptive_threshold;
+}
+
+FullyConnectedRouting FullyConnected::get_routing() const noexcept {
+    return routing;
+}
+
+const Route* FullyConnected::indirect_route(const DeviceId src,
+                                            const DeviceId dest,
+                                            const DeviceId intermediate) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(intermediate != src && intermediate != dest);
+
+    // intern the route (unordered_map nodes never move)
+    const auto key = (static_cast<uint64_t>(src) * npus_count + dest) * npus_count + intermediate;
+    auto& route = indirect_routes[key];
+    if (route.empty()) {
+        route.push_back(src);
+        route.push_back(intermediate);
+        route.push_back(dest);
+        resolve_links(route);
+    }
+    return &route;
+}
+
+uint64_t FullyConnected::get_route_tables_bytes() const noexcept {
+    // every interned indirect route is a hash node (route and next pointer), plus the bucket array
+    auto allocated_bytes = Topology::get_route_tables_bytes();
+    allocated_bytes += indirect_routes.bucket_count() * sizeof(void*);
+    for (const auto& [key, route] : indirect_routes) {
+        allocated_bytes += sizeof(void*) + sizeof(std::pair<const uint64_t, Route>) + route.get_heap_bytes();
+    }
+    return allocated_bytes;
+}
+
+int FullyConnected::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // directly connected
+    return 1;
+}
+
+TopologyMetrics FullyConnected::compute_metrics(const int threads_count) const noexcept {
+    (void)threads_count;
+
+    auto metrics = TopologyMetrics();
+    metrics.links_count_per_dim = {get_links_count()};
+    if (npus_count < 2) {
+        return metrics;
+    }
+
+    // every NPU of a half is linked to every NPU of the other
+    metrics.diameter = 1;
+    metrics.average_hops_count = 1;
+    metrics.bisection_bandwidth = (npus_count / 2) * (npus_count - (npus_count / 2)) * get_link_capacity(0);
+    return metrics;
+}
@@ -4,15 +4,32 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Mesh2D.h"
+#include "common/Logger.h"
+#include "common/NetworkFunction.h"
+#include <array>
 #include <cassert>
-#include <cstdlib>
 #include <cmath>
-#include <iostream>
-#include <ostream>
-#include <iomanip> // Required for std::setw
+#include <cstdlib>
+#include <utility>
+#include <vector>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+namespace {
+
+/**
+ * Check whether a chunk takes its YX route with MeshRouting::O1Turn.
+ * Chunk ids are mixed, so consecutive chunks of a pair don't just alternate.
+ *
+ * @param chunk_id id of the chunk
+ * @return true for the YX route, false for the XY route
+ */
+bool takes_yx_route(const uint64_t chunk_id) noexcept {
+    return (mix_bits(chunk_id) & 1) != 0;
+}
+
+}  // namespace
+
 /**
  * Constructor: Initialize 2D Mesh Topology
  *
@@ -33,7 +50,10 @@ using namespace NetworkAnalyticalCongestionAware;
  *             = 2 × (4 × 2 + 3 × 3) = 2 × 17 = 34 directed links (bidirectional)
  */
 Mesh2D::Mesh2D(const int width, const int height, const Bandwidth bandwidth, const Latency latency) noexcept
-    : width(width), height(height), BasicTopology(width * height, width * height, bandwidth, latency) {
+    : width(width),
+      height(height),
+      routing(MeshRouting::XY),
+      BasicTopology(width * height, width * height, bandwidth, latency) {
     
     // Validate input parameters
     assert(width > 0);
@@ -50,18 +70,10 @@ Mesh2D::Mesh2D(const int width, const int height, const Bandwidth bandwidth, con
     bandwidth_per_dim.push_back(bandwidth);  // bandwidth per dim (uniform)
     bandwidth_per_dim.push_back(bandwidth);
 
-    // =====================================================
-    // MESH2D TOPOLOGY CONSTRUCTION - DETAILED LOGGING
-    // =====================================================
-    std::cerr << "\n";
-    std::cerr << "╔════════════════════════════════════════════════════════════════════════════╗\n";
-    std::cerr << "║                  MESH2D TOPOLOGY INITIALIZATION                            ║\n";
-    std::cerr << "╚════════════════════════════════════════════════════════════════════════════╝\n";
-    
-    std::cerr << "\n[MESH2D-INIT] Dimensions: " << width << " (width) × " << height << " (height)\n";
-    std::cerr << "[MESH2D-INIT] Total NPUs: " << (width * height) << "\n";
-    std::cerr << "[MESH2D-INIT] Bandwidth per link: " << bandwidth << " GB/s\n";
-    std::cerr << "[MESH2D-INIT] Latency per link: " << latency << " ns\n";
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[MESH2D-INIT] " << width << " (width) x " << height << " (height) = " << (width * height)
+                                            << " NPUs, bandwidth " << bandwidth << " GB/s, latency " << latency
+                                            << " ns per link");
 
     // Set the topology type identifier
     basic_topology_type = TopologyBuildingBlock::Mesh2D;
@@ -70,7 +82,9 @@ Mesh2D::Mesh2D(const int width, const int height, const Bandwidth bandwidth, con
      * Connect mesh nodes in 4-neighbor topology
      * 
      * Strategy:
-     * - Iterate through each position in the grid
+     * - Iterate through each position in the grid, in locality order (see locality_order):
+     *   link ids follow the order, so the links of a region sit close in memory
+     *   (instead of a row apart with row-major ids), while NPU ids stay row-major
      * - Connect each node to its right neighbor (if exists)
      * - Connect each node to its bottom neighbor (if exists)
      * - Use bidirectional connections so reverse links are automatic
@@ -78,64 +92,40 @@ Mesh2D::Mesh2D(const int width, const int height, const Bandwidth bandwidth, con
      * This avoids duplicate connections and creates the proper mesh structure
      */
     
-    int link_count = 0;
-    std::cerr << "\n[MESH2D-INIT] Creating mesh links...\n";
-    std::cerr << "[MESH2D-INIT] Grid layout:\n\n";
-    
-    for (int y = 0; y < height; ++y) {
-        std::cerr << "                  ";
-        for (int x = 0; x < width; ++x) {
-            std::cerr << std::setw(3) << (y * width + x);
-            if (x < width - 1) std::cerr << " --- ";
-        }
-        std::cerr << "\n";
-        
-        if (y < height - 1) {
-            std::cerr << "                  ";
-            for (int x = 0; x < width; ++x) {
-                std::cerr << "  |  ";
-                if (x < width - 1) std::cerr << "     ";
-            }
-            std::cerr << "\n";
-        }
-    }
-    std::cerr << "\n";
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            // Current node ID in linear indexing: y * width + x
-            DeviceId current = coords_to_npu_id(x, y);
-
-            // Connect to right neighbor (x + 1, y) if it exists
-            if (x + 1 < width) {
-                DeviceId right = coords_to_npu_id(x + 1, y);
-                // Bidirectional connection: both current↔right
-                connect(current, right, bandwidth, latency, true);
-                link_count += 2;  // bidirectional = 2 directed links
-                std::cerr << "[MESH2D-LINK] NPU " << current << " (at " << x << "," << y << ") "
-                          << "↔ NPU " << right << " (at " << (x+1) << "," << y << ")\n";
-            }
+    // two directed links per neighbor pair: their endpoints are listed first, so the links are constructed at once
+    auto endpoints = std::vector<std::pair<DeviceId, DeviceId>>();
+    endpoints.reserve(2 * ((width - 1) * height + width * (height - 1)));
+    for (const auto cell : locality_order(width, height)) {
+        const auto x = cell % width;
+        const auto y = cell / width;
 
-            // Connect to bottom neighbor (x, y + 1) if it exists
-            if (y + 1 < height) {
-                DeviceId bottom = coords_to_npu_id(x, y + 1);
-                // Bidirectional connection: both current↔bottom
-                connect(current, bottom, bandwidth, latency, true);
-                link_count += 2;  // bidirectional = 2 directed links
-                std::cerr << "[MESH2D-LINK] NPU " << current << " (at " << x << "," << y << ") "
-                          << "↔ NPU " << bottom << " (at " << x << "," << (y+1) << ")\n";
-            }
+        // Current node ID in linear indexing: y * width + x
+        DeviceId current = coords_to_npu_id(x, y);
+
+        // Connect to right neighbor (x + 1, y) if it exists
+        if (x + 1 < width) {
+            DeviceId right = coords_to_npu_id(x + 1, y);
+            // Bidirectional connection: both current↔right
+            endpoints.emplace_back(current, right);
+            endpoints.emplace_back(right, current);
+            NETWORK_ANALYTICAL_LOG(LogLevel::Trace, "[MESH2D-LINK] NPU " << current << " <-> NPU " << right);
+        }
 
-            // Top and left neighbors are implicitly connected through previous iterations
-            // - When we processed (x-1, y), it connected to current
-            // - When we processed (x, y-1), it connected to current
+        // Connect to bottom neighbor (x, y + 1) if it exists
+        if (y + 1 < height) {
+            DeviceId bottom = coords_to_npu_id(x, y + 1);
+            // Bidirectional connection: both current↔bottom
+            endpoints.emplace_back(current, bottom);
+            endpoints.emplace_back(bottom, current);
+            NETWORK_ANALYTICAL_LOG(LogLevel::Trace, "[MESH2D-LINK] NPU " << current << " <-> NPU " << bottom);
         }
+
+        // Top and left neighbors are connected when visiting them
     }
+    connect_all(endpoints, bandwidth, latency);
+    const auto link_count = endpoints.size();
     
-    std::cerr << "\n[MESH2D-INIT] Total bidirectional links created: " << (link_count / 2) << "\n";
-    std::cerr << "[MESH2D-INIT] Total directed links: " << link_count << "\n";
-    std::cerr << "[MESH2D-INIT] Mesh2D topology construction COMPLETE ✓\n";
-    std::cerr << "\n";
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info, "[MESH2D-INIT] " << link_count << " directed links created");
 }
 
 /**
@@ -157,15 +147,9 @@ Mesh2D::Mesh2D(const int npus_count, const Bandwidth bandwidth, const Latency la
     // Validate that npus_count is a perfect square
     const int width_height = static_cast<int>(std::sqrt(npus_count));
     if (width_height * width_height != npus_count) {
-        std::cerr << "\n⚠️  [MESH2D-CONSTRUCTOR] WARNING: npus_count " << npus_count 
-                  << " is NOT a perfect square!\n";
-        std::cerr << "[MESH2D-CONSTRUCTOR] Using approximation: " << width_height << "×" << width_height 
-                  << " = " << (width_height * width_height) << " NPUs\n";
-        std::cerr << "[MESH2D-CONSTRUCTOR] Lost NPUs: " << (npus_count - (width_height * width_height)) << "\n";
-        std::cerr << "[MESH2D-CONSTRUCTOR] For perfect square, use: ";
-        int next_square = (width_height + 1) * (width_height + 1);
-        int prev_square = width_height * width_height;
-        std::cerr << prev_square << " or " << next_square << "\n\n";
+        NETWORK_ANALYTICAL_LOG(LogLevel::Warning,
+                               "[MESH2D-CONSTRUCTOR] npus_count " << npus_count << " is not a perfect square, using "
+                                                                  << width_height << "x" << width_height << " NPUs");
     }
 }
 
@@ -196,104 +180,26 @@ Mesh2D::Mesh2D(const int npus_count, const Bandwidth bandwidth, const Latency la
  *     Step 5: Move Y: (3, 1) → (3, 2) → NPU 11
  *   Total hops: 5 = |3-0| + |2-0| = Manhattan distance ✓
  */
-Route Mesh2D::route(const DeviceId src, const DeviceId dest) const noexcept {
+Route Mesh2D::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
     // Validate source and destination are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
-    // Handle trivial case: source == destination
-    if (src == dest) {
-        Route route;
-        route.push_back(devices[src]);
-        std::cerr << "[MESH2D-ROUTE] Same source/dest (NPU " << src << ") - No routing needed\n";
-        return route;
-    }
-
-    // Decompose source and destination into 2D coordinates
-    auto [src_x, src_y] = get_2d_coords(src);
-    auto [dest_x, dest_y] = get_2d_coords(dest);
+    // XY route: along X dimension first, then along Y dimension
+    auto devices = std::vector<DeviceId>(get_max_route_length());
+    const auto length = write_route(src, dest, devices.data());
 
-    // Initialize route with source node
     Route route;
-    route.push_back(devices[src]);
-
-    std::cerr << "\n┌─────────────────────────────────────────────────────────────┐\n";
-    std::cerr << "│              MESH2D XY ROUTING - TRACE LOG                   │\n";
-    std::cerr << "└─────────────────────────────────────────────────────────────┘\n";
-    std::cerr << "[MESH2D-ROUTE] Source NPU: " << src << " at coordinates (" << src_x << ", " << src_y << ")\n";
-    std::cerr << "[MESH2D-ROUTE] Destination NPU: " << dest << " at coordinates (" << dest_x << ", " << dest_y << ")\n";
-    std::cerr << "[MESH2D-ROUTE] Mesh dimensions: " << width << " × " << height << "\n";
-    std::cerr << "[MESH2D-ROUTE] Manhattan distance: |" << dest_x << " - " << src_x << "| + |" << dest_y 
-              << " - " << src_y << "| = " << (std::abs(dest_x - src_x) + std::abs(dest_y - src_y)) << " hops\n\n";
-
-    /**
-     * PHASE 1: Move along X dimension (left or right)
-     */
-    int x = src_x;
-    int y = src_y;
-
-    std::cerr << "═══ PHASE 1: Move along X dimension ═══\n";
-    std::cerr << "[MESH2D-ROUTE] Current position: (" << x << ", " << y << ")\n";
-    std::cerr << "[MESH2D-ROUTE] Target X: " << dest_x << "\n";
-    
-    int phase1_hops = 0;
-    while (x != dest_x) {
-        // Determine direction: +1 for right, -1 for left
-        int direction = (dest_x > x) ? 1 : -1;
-        std::string dir_str = (direction > 0) ? "RIGHT" : "LEFT";
-        
-        x += direction;
-        phase1_hops++;
-        
-        // Add the next node to route
-        DeviceId next_npu = coords_to_npu_id(x, y);
-        route.push_back(devices[next_npu]);
-        
-        std::cerr << "[MESH2D-ROUTE] Hop " << phase1_hops << ": Move " << dir_str 
-                  << " → NPU " << next_npu << " at (" << x << ", " << y << ")\n";
+    for (auto i = 0; i < length; i++) {
+        route.push_back(devices[i]);
     }
-    
-    std::cerr << "[MESH2D-ROUTE] Phase 1 complete: " << phase1_hops << " hops in X direction\n\n";
 
-    /**
-     * PHASE 2: Move along Y dimension (up or down)
-     */
-    std::cerr << "═══ PHASE 2: Move along Y dimension ═══\n";
-    std::cerr << "[MESH2D-ROUTE] Current position: (" << x << ", " << y << ")\n";
-    std::cerr << "[MESH2D-ROUTE] Target Y: " << dest_y << "\n";
-    
-    int phase2_hops = 0;
-    while (y != dest_y) {
-        // Determine direction: +1 for down, -1 for up
-        int direction = (dest_y > y) ? 1 : -1;
-        std::string dir_str = (direction > 0) ? "DOWN" : "UP";
-        
-        y += direction;
-        phase2_hops++;
-        
-        // Add the next node to route
-        DeviceId next_npu = coords_to_npu_id(x, y);
-        route.push_back(devices[next_npu]);
-        
-        std::cerr << "[MESH2D-ROUTE] Hop " << (phase1_hops + phase2_hops) << ": Move " << dir_str 
-                  << " → NPU " << next_npu << " at (" << x << ", " << y << ")\n";
-    }
-    
-    std::cerr << "[MESH2D-ROUTE] Phase 2 complete: " << phase2_hops << " hops in Y direction\n\n";
-
-    // Summary
-    std::cerr << "╔═════════════════════════════════════════════════════════════╗\n";
-    std::cerr << "║                 ROUTE SUMMARY                               ║\n";
-    std::cerr << "╚═════════════════════════════════════════════════════════════╝\n";
-    std::cerr << "[MESH2D-ROUTE] Total route length: " << route.size() << " nodes (including source and destination)\n";
-    std::cerr << "[MESH2D-ROUTE] Total hops: " << (route.size() - 1) << "\n";
-    std::cerr << "[MESH2D-ROUTE] Path breakdown: X=" << phase1_hops << " hops + Y=" << phase2_hops << " hops\n";
-    std::cerr << "[MESH2D-ROUTE] Latency (link): " << latency << " ns per hop × " << (route.size() - 1) 
-              << " hops = " << (latency * (route.size() - 1)) << " ns total\n";
-    std::cerr << "\n";
-
-    // At this point, we're at (dest_x, dest_y) which is the destination
-    // Return the complete route
+    NETWORK_ANALYTICAL_LOG(LogLevel::Debug,
+                           "[MESH2D-ROUTE] NPU " << src << " (" << get_2d_coords(src).first << ", "
+                                                 << get_2d_coords(src).second << ") -> NPU " << dest << " ("
+                                                 << get_2d_coords(dest).first << ", " << get_2d_coords(dest).second
+                                                 << "): " << (length - 1) << " hops");
+
     return route;
 }
 
@@ -350,3 +256,198 @@ int Mesh2D::manhattan_distance(const DeviceId src, const DeviceId dest) const no
     // Return sum (Manhattan distance)
     return dx + dy;
 }
+
+DeviceId Mesh2D::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    // Validate current and destination are in valid range
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    if (routing == MeshRouting::WestFirst) {
+        return adaptive_next_hop(current, dest);
+    }
+
+    const auto [x, y] = get_2d_coords(current);
+    const auto [dest_x, dest_y] = get_2d_coords(dest);
+
+    // XY routing: move along X until aligned, then along Y
+    if (x != dest_x) {
+        return coords_to_npu_id(x + ((dest_x > x) ? 1 : -1), y);
+    }
+    return coords_to_npu_id(x, y + ((dest_y > y) ? 1 : -1));
+}
+
+const Route* Mesh2D::select_route(const DeviceId src, const DeviceId dest, const uint64_t chunk_id) const noexcept {
+    if (routing != MeshRouting::O1Turn || !takes_yx_route(chunk_id)) {
+        return shared_route(src, dest);
+    }
+    return yx_route(src, dest);
+}
+
+const Route* Mesh2D::yx_route(const DeviceId src, const DeviceId dest) const noexcept {
+    // YX routes are interned like the shared XY routes
+    auto& route = route_table_entry(yx_routes, src, dest);
+    if (route.empty()) {
+        route = compute_yx_route(src, dest);
+        resolve_links(route);
+    }
+    return &route;
+}
+
+bool Mesh2D::has_fixed_routes() const noexcept {
+    // O1TURN picks the route per chunk
+    return routing != MeshRouting::O1Turn && Topology::has_fixed_routes();
+}
+
+void Mesh2D::build_route_tables() const noexcept {
+    Topology::build_route_tables();
+
+    // O1TURN takes the YX route of every other chunk
+    if (routing != MeshRouting::O1Turn) {
+        return;
+    }
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                static_cast<void>(yx_route(src, dest));
+            }
+        }
+    }
+}
+
+void Mesh2D::set_routing(const MeshRouting new_routing) noexcept {
+    routing = new_routing;
+
+    // adaptive routes are only known hop by hop
+    set_hop_by_hop_routing(routing == MeshRouting::WestFirst);
+}
+
+MeshRouting Mesh2D::get_routing() const noexcept {
+    return routing;
+}
+
+Route Mesh2D::compute_yx_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    auto [x, y] = get_2d_coords(src);
+    const auto [dest_x, dest_y] = get_2d_coords(dest);
+
+    // move along Y first, then along X
+    auto route = Route();
+    route.push_back(src);
+    while (y != dest_y) {
+        y += (dest_y > y) ? 1 : -1;
+        route.push_back(coords_to_npu_id(x, y));
+    }
+    while (x != dest_x) {
+        x += (dest_x > x) ? 1 : -1;
+        route.push_back(coords_to_npu_id(x, y));
+    }
+
+    return route;
+}
+
+DeviceId Mesh2D::adaptive_next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    const auto [x, y] = get_2d_coords(current);
+    const auto [dest_x, dest_y] = get_2d_coords(dest);
+
+    // west-first: every west hop is taken before any other,
+    // so no chunk ever turns into west (which rules out cyclic waits)
+    if (dest_x < x) {
+        return coords_to_npu_id(x - 1, y);
+    }
+
+    // otherwise pick the least occupied productive direction, X first on ties
+    auto candidates = std::array<DeviceId, 2>();
+    auto candidates_count = 0;
+    if (dest_x > x) {
+        candidates[candidates_count++] = coords_to_npu_id(x + 1, y);
+    }
+    if (dest_y != y) {
+        candidates[candidates_count++] = coords_to_npu_id(x, y + ((dest_y > y) ? 1 : -1));
+    }
+    assert(candidates_count > 0);
+
+    auto next = candidates[0];
+    auto least_queued_chunks = get_link(find_link(current, next)).get_queued_chunks_count();
+    for (auto i = 1; i < candidates_count; i++) {
+        const auto queued_chunks = get_link(find_link(current, candidates[i])).get_queued_chunks_count();
+        if (queued_chunks < least_queued_chunks) {
+            next = candidates[i];
+            least_queued_chunks = queued_chunks;
+        }
+    }
+
+    return next;
+}
+
+std::string Mesh2D::get_link_group(const LinkId link_id) const noexcept {
+    const auto [src, dest] = links.endpoints(link_id);
+    const auto [src_x, src_y] = get_2d_coords(src);
+    const auto [dest_x, dest_y] = get_2d_coords(dest);
+    return (src_y == dest_y) ? "row " + std::to_string(src_y) : "column " + std::to_string(src_x);
+}
+
+uint64_t Mesh2D::get_route_tables_bytes() const noexcept {
+    return Topology::get_route_tables_bytes() + route_table_bytes(yx_routes);
+}
+
+int Mesh2D::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    return manhattan_distance(src, dest);
+}
+
+EventTime Mesh2D::get_zero_load_latency(const DeviceId src,
+                                        const DeviceId dest,
+                                        const ChunkSize chunk_size) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(chunk_size > 0);
+
+    // row hops cross dimension 0 links, column hops dimension 1 links
+    const auto [src_x, src_y] = get_2d_coords(src);
+    const auto [dest_x, dest_y] = get_2d_coords(dest);
+    const auto row_hops_count = std::abs(dest_x - src_x);
+    const auto column_hops_count = std::abs(dest_y - src_y);
+    auto zero_load_latency = EventTime(0);
+    if (row_hops_count > 0) {
+        zero_load_latency += row_hops_count * dim_link_delay(0, chunk_size);
+    }
+    if (column_hops_count > 0) {
+        zero_load_latency += column_hops_count * dim_link_delay(1, chunk_size);
+    }
+    return zero_load_latency;
+}
+
+TopologyMetrics Mesh2D::compute_metrics(const int threads_count) const noexcept {
+    // the NPU halves split the highest dimension longer than 1
+    const auto split_size = (height > 1) ? height : width;
+    if (split_size % 2 != 0) {
+        return Topology::compute_metrics(threads_count);
+    }
+
+    auto metrics = TopologyMetrics();
+    metrics.links_count_per_dim = {2 * height * (width - 1), 2 * width * (height - 1)};
+    if (npus_count < 2) {
+        return metrics;
+    }
+
+    // a line of links crosses the middle of that dimension
+    metrics.diameter = (width - 1) + (height - 1);
+    metrics.average_hops_count = grid_average_hops_count({width, height}, false);
+    metrics.bisection_bandwidth = (npus_count / split_size) * get_link_capacity(0);
+    return metrics;
+}
+
+std::vector<DeviceId> Mesh2D::get_ring_order() const noexcept {
+    // NPU ids are the cell indices
+    return grid_ring_order(width, height);
+}
+
+int Mesh2D::get_link_dim(const LinkId link_id) const noexcept {
+    const auto [src, dest] = links.endpoints(link_id);
+    return (get_2d_coords(src).second == get_2d_coords(dest).second) ? 0 : 1;
+}
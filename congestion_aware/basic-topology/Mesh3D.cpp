@@ -0,0 +1,349 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Mesh3D.h"
+#include "common/Logger.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// grid directions (+X, -X, +Y, -Y, +Z, -Z), in routing preference order
+constexpr int directions_count = 6;
+
+/// next-hop table entry of the destination itself and of unreachable NPUs (no direction bit set)
+constexpr uint8_t no_next_hop = 0;
+
+/**
+ * Get the first direction set in a next-hop table entry.
+ *
+ * @param directions next-hop table entry, a bit per direction
+ * @return direction
+ */
+int first_direction(const uint8_t directions) noexcept {
+    assert(directions != no_next_hop);
+
+    for (auto direction = 0; direction < directions_count; direction++) {
+        if ((directions & (1 << direction)) != 0) {
+            return direction;
+        }
+    }
+
+    // shouldn't reach here
+    assert(false);
+    return 0;
+}
+
+}  // namespace
+
+Mesh3D::Mesh3D(const int width,
+               const int height,
+               const int depth,
+               const Bandwidth bandwidth,
+               const Latency latency,
+               const Bandwidth vertical_bandwidth,
+               const Latency vertical_latency) noexcept
+    : Mesh3D(width, height, depth, {}, bandwidth, latency, vertical_bandwidth, vertical_latency) {}
+
+Mesh3D::Mesh3D(const int width,
+               const int height,
+               const int depth,
+               const std::vector<bool>& valid_cells,
+               const Bandwidth bandwidth,
+               const Latency latency,
+               const Bandwidth vertical_bandwidth,
+               const Latency vertical_latency) noexcept
+    : BasicTopology(count_valid_cells(width, height, depth, valid_cells),
+                    count_valid_cells(width, height, depth, valid_cells),
+                    bandwidth,
+                    latency),
+      sizes({width, height, depth}),
+      strides({1, width, width * height}) {
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+    assert(vertical_bandwidth > 0);
+    assert(vertical_latency >= 0);
+
+    dims_count = mesh_dims_count;
+    npus_count_per_dim.assign(sizes.begin(), sizes.end());
+    bandwidth_per_dim = {bandwidth, bandwidth, vertical_bandwidth};
+    basic_topology_type = TopologyBuildingBlock::Mesh3D;
+
+    // number the valid cells contiguously, X first, then Y, then Z
+    const auto cells_count = width * height * depth;
+    if (npus_count < cells_count) {
+        cell_to_npu.assign(cells_count, -1);
+        npu_to_cell.reserve(npus_count);
+        for (auto cell = 0; cell < cells_count; cell++) {
+            if (valid_cells[cell]) {
+                cell_to_npu[cell] = static_cast<DeviceId>(npu_to_cell.size());
+                npu_to_cell.push_back(cell);
+            }
+        }
+
+        next_hop_tables.resize(npus_count);
+        next_hop_tables_built = std::make_unique<std::once_flag[]>(npus_count);
+    }
+
+    // connect every NPU to its positive neighbor along each dimension,
+    // listing the endpoints first so the links are constructed at once:
+    // the stacks of cells are visited in locality order, so the links of a region get close link ids
+    auto endpoints = std::vector<std::pair<DeviceId, DeviceId>>();
+    endpoints.reserve(2 * mesh_dims_count * static_cast<size_t>(npus_count));
+    for (const auto layer_cell : locality_order(width, height)) {
+        for (auto z = 0; z < depth; z++) {
+            const auto cell = layer_cell + z * strides[2];
+            const auto npu = cell_to_npu.empty() ? cell : cell_to_npu[cell];
+            if (npu < 0) {
+                continue;
+            }
+            for (auto dim = 0; dim < mesh_dims_count; dim++) {
+                const auto next_npu = neighbor(npu, 2 * dim);
+                if (next_npu >= 0) {
+                    endpoints.emplace_back(npu, next_npu);
+                    endpoints.emplace_back(next_npu, npu);
+                }
+            }
+        }
+    }
+    connect_all(endpoints, bandwidth, latency);
+
+    // vertical links get their own parameters
+    if (depth > 1) {
+        set_dim_parameters(2, vertical_bandwidth, vertical_latency);
+    }
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[MESH3D-INIT] " << width << " x " << height << " x " << depth << " grid, " << npus_count
+                                            << " NPUs, " << endpoints.size() << " directed links, bandwidth "
+                                            << bandwidth << " GB/s, latency " << latency << " ns per planar link, "
+                                            << "bandwidth " << vertical_bandwidth << " GB/s, latency "
+                                            << vertical_latency << " ns per vertical link");
+}
+
+int Mesh3D::count_valid_cells(const int width,
+                              const int height,
+                              const int depth,
+                              const std::vector<bool>& valid_cells) noexcept {
+    assert(width > 0);
+    assert(height > 0);
+    assert(depth > 0);
+
+    const auto cells_count = static_cast<size_t>(width) * height * depth;
+    if (valid_cells.empty()) {
+        return static_cast<int>(cells_count);
+    }
+    if (valid_cells.size() != cells_count) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Mesh3D valid cells bitmap has "
+                  << valid_cells.size() << " cells, expected " << width << " x " << height << " x " << depth
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    return static_cast<int>(std::count(valid_cells.begin(), valid_cells.end(), true));
+}
+
+DeviceId Mesh3D::neighbor(const DeviceId npu_id, const int direction) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+    assert(0 <= direction && direction < directions_count);
+
+    const auto dim = direction / 2;
+    const auto step = (direction % 2 == 0) ? 1 : -1;
+    const auto cell = cell_of(npu_id);
+    const auto coord = coordinate(cell, dim) + step;
+    if (coord < 0 || coord >= sizes[dim]) {
+        return -1;
+    }
+
+    const auto next_cell = cell + step * strides[dim];
+    return cell_to_npu.empty() ? next_cell : cell_to_npu[next_cell];
+}
+
+std::array<int, 3> Mesh3D::get_coords(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    const auto cell = cell_of(npu_id);
+    return {coordinate(cell, 0), coordinate(cell, 1), coordinate(cell, 2)};
+}
+
+DeviceId Mesh3D::get_npu_at(const int x, const int y, const int z) const noexcept {
+    if (x < 0 || x >= sizes[0] || y < 0 || y >= sizes[1] || z < 0 || z >= sizes[2]) {
+        return -1;
+    }
+
+    const auto cell = x + y * strides[1] + z * strides[2];
+    return cell_to_npu.empty() ? cell : cell_to_npu[cell];
+}
+
+const std::vector<uint8_t>& Mesh3D::next_hop_table(const DeviceId dest) const noexcept {
+    assert(0 <= dest && dest < npus_count);
+    assert(!cell_to_npu.empty());
+
+    std::call_once(next_hop_tables_built[dest], [this, dest] { build_next_hop_table(dest); });
+    return next_hop_tables[dest];
+}
+
+void Mesh3D::build_next_hop_table(const DeviceId dest) const noexcept {
+    assert(0 <= dest && dest < npus_count);
+
+    // hop distance of every NPU to the destination
+    auto distances = std::vector<int>(npus_count, -1);
+    auto frontier = std::vector<DeviceId>({dest});
+    distances[dest] = 0;
+    for (auto head = size_t(0); head < frontier.size(); head++) {
+        const auto npu = frontier[head];
+        for (auto direction = 0; direction < directions_count; direction++) {
+            const auto next_npu = neighbor(npu, direction);
+            if (next_npu >= 0 && distances[next_npu] < 0) {
+                distances[next_npu] = distances[npu] + 1;
+                frontier.push_back(next_npu);
+            }
+        }
+    }
+
+    // every NPU may move to any neighbor one hop closer
+    auto& table = next_hop_tables[dest];
+    table.assign(npus_count, no_next_hop);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        if (npu == dest || distances[npu] < 0) {
+            continue;
+        }
+        for (auto direction = 0; direction < directions_count; direction++) {
+            const auto next_npu = neighbor(npu, direction);
+            if (next_npu >= 0 && distances[next_npu] == distances[npu] - 1) {
+                table[npu] |= static_cast<uint8_t>(1 << direction);
+            }
+        }
+    }
+}
+
+Route Mesh3D::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // an unreachable destination keeps the single-device route
+    auto route = Route();
+    route.push_back(src);
+    if (!cell_to_npu.empty() && src != dest && next_hop_table(dest)[src] == no_next_hop) {
+        NETWORK_ANALYTICAL_LOG(LogLevel::Error,
+                               "[MESH3D-ROUTE] No path found from " << src << " to " << dest << "!");
+        return route;
+    }
+
+    // follow the next hops until reaching dest
+    for (auto current = src; current != dest;) {
+        current = next_hop(current, dest);
+        route.push_back(current);
+    }
+
+    return route;
+}
+
+DeviceId Mesh3D::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // the next-hop table of the destination holds the directions to move in around the holes
+    if (!cell_to_npu.empty()) {
+        const auto directions = next_hop_table(dest)[current];
+        assert(directions != no_next_hop);
+        return neighbor(current, first_direction(directions));
+    }
+
+    // move along the first unaligned dimension
+    for (auto dim = 0; dim < mesh_dims_count; dim++) {
+        const auto coord = coordinate(current, dim);
+        const auto dest_coord = coordinate(dest, dim);
+        if (coord != dest_coord) {
+            return current + ((coord < dest_coord) ? strides[dim] : -strides[dim]);
+        }
+    }
+
+    // shouldn't reach here
+    assert(false);
+    return dest;
+}
+
+std::array<int, 3> Mesh3D::count_hops(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    auto hops_counts = std::array<int, mesh_dims_count>({0, 0, 0});
+
+    // Manhattan distance along each dimension
+    if (cell_to_npu.empty()) {
+        for (auto dim = 0; dim < mesh_dims_count; dim++) {
+            hops_counts[dim] = std::abs(coordinate(dest, dim) - coordinate(src, dim));
+        }
+        return hops_counts;
+    }
+
+    // the route of compute_route, without constructing it (no hop if dest is unreachable)
+    if (src == dest || next_hop_table(dest)[src] == no_next_hop) {
+        return hops_counts;
+    }
+    const auto& table = next_hop_table(dest);
+    for (auto npu = src; npu != dest;) {
+        const auto direction = first_direction(table[npu]);
+        hops_counts[direction / 2]++;
+        npu = neighbor(npu, direction);
+    }
+    return hops_counts;
+}
+
+int Mesh3D::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    const auto hops_counts = count_hops(src, dest);
+    return hops_counts[0] + hops_counts[1] + hops_counts[2];
+}
+
+EventTime Mesh3D::get_zero_load_latency(const DeviceId src,
+                                        const DeviceId dest,
+                                        const ChunkSize chunk_size) const noexcept {
+    assert(chunk_size > 0);
+
+    // hops along each dimension cross the links of that dimension
+    const auto hops_counts = count_hops(src, dest);
+    auto zero_load_latency = EventTime(0);
+    for (auto dim = 0; dim < mesh_dims_count; dim++) {
+        if (hops_counts[dim] > 0) {
+            zero_load_latency += hops_counts[dim] * dim_link_delay(dim, chunk_size);
+        }
+    }
+    return zero_load_latency;
+}
+
+int Mesh3D::get_link_dim(const LinkId link_id) const noexcept {
+    const auto [src, dest] = links.endpoints(link_id);
+    const auto src_cell = cell_of(src);
+    const auto dest_cell = cell_of(dest);
+
+    // neighbors differ along a single dimension
+    for (auto dim = 0; dim < mesh_dims_count - 1; dim++) {
+        if (coordinate(src_cell, dim) != coordinate(dest_cell, dim)) {
+            return dim;
+        }
+    }
+    return mesh_dims_count - 1;
+}
+
+std::string Mesh3D::get_link_group(const LinkId link_id) const noexcept {
+    const auto [x, y, z] = get_coords(links.endpoints(link_id).first);
+
+    switch (get_link_dim(link_id)) {
+    case 0:
+        return "layer " + std::to_string(z) + " row " + std::to_string(y);
+    case 1:
+        return "layer " + std::to_string(z) + " column " + std::to_string(x);
+    default:
+        return "pillar " + std::to_string(x) + "," + std::to_string(y);
+    }
+}
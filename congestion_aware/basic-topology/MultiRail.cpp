@@ -0,0 +1,172 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/MultiRail.h"
+#include "common/Logger.h"
+#include "common/NetworkFunction.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+MultiRail::MultiRail(const int npus_count,
+                     const int rails_count,
+                     const Bandwidth bandwidth,
+                     const Latency latency) noexcept
+    : rails_count(rails_count),
+      routing(RailRouting::Hashed),
+      BasicTopology(npus_count, npus_count + npus_count * rails_count + rails_count, bandwidth, latency) {
+    assert(npus_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    if (rails_count <= 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "MultiRail rails count (" << rails_count
+                  << ") should be positive" << std::endl;
+        std::exit(-1);
+    }
+
+    basic_topology_type = TopologyBuildingBlock::MultiRail;
+
+    // every NPU to its NICs, and every NIC to its rail switch
+    links.reserve(4 * npus_count * rails_count);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        for (auto rail = 0; rail < rails_count; rail++) {
+            connect(npu, get_nic(npu, rail), bandwidth, latency, true);
+            connect(get_nic(npu, rail), get_rail_switch(rail), bandwidth, latency, true);
+        }
+    }
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[MULTIRAIL-INIT] " << npus_count << " NPUs, " << rails_count << " rails, "
+                                               << links.size() << " directed links");
+}
+
+Route MultiRail::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    return compute_rail_route(src, dest, hashed_rail(src, dest));
+}
+
+DeviceId MultiRail::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // NPUs go to their NIC on the hashed rail
+    if (current < npus_count) {
+        return get_nic(current, hashed_rail(current, dest));
+    }
+
+    // NICs go up to their rail switch, or down to their NPU (dest's NIC)
+    const auto first_switch = npus_count + npus_count * rails_count;
+    if (current < first_switch) {
+        const auto nic_npu = (current - npus_count) / rails_count;
+        return (nic_npu == dest) ? dest : get_rail_switch((current - npus_count) % rails_count);
+    }
+
+    // rail switches go to dest's NIC on their rail
+    return get_nic(dest, current - first_switch);
+}
+
+const Route* MultiRail::select_route(const DeviceId src, const DeviceId dest, const uint64_t chunk_id) const noexcept {
+    // hashed chunks (and chunks sprayed onto the hashed rail) take the shared route
+    const auto rail = static_cast<int>(chunk_id % static_cast<uint64_t>(rails_count));
+    if (routing != RailRouting::Sprayed || rail == hashed_rail(src, dest)) {
+        return shared_route(src, dest);
+    }
+    return rail_route(src, dest, rail);
+}
+
+const Route* MultiRail::rail_route(const DeviceId src, const DeviceId dest, const int rail) const noexcept {
+    // intern the route (unordered_map nodes never move)
+    const auto key = (static_cast<uint64_t>(src) * npus_count + dest) * rails_count + rail;
+    auto& route = rail_routes[key];
+    if (route.empty()) {
+        route = compute_rail_route(src, dest, rail);
+        resolve_links(route);
+    }
+    return &route;
+}
+
+bool MultiRail::has_fixed_routes() const noexcept {
+    return routing == RailRouting::Hashed && Topology::has_fixed_routes();
+}
+
+void MultiRail::build_route_tables() const noexcept {
+    Topology::build_route_tables();
+
+    // sprayed chunks take every rail
+    if (routing != RailRouting::Sprayed) {
+        return;
+    }
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            for (auto rail = 0; rail < rails_count; rail++) {
+                if (src != dest && rail != hashed_rail(src, dest)) {
+                    static_cast<void>(rail_route(src, dest, rail));
+                }
+            }
+        }
+    }
+}
+
+void MultiRail::set_routing(const RailRouting new_routing) noexcept {
+    routing = new_routing;
+}
+
+RailRouting MultiRail::get_routing() const noexcept {
+    return routing;
+}
+
+int MultiRail::get_rails_count() const noexcept {
+    return rails_count;
+}
+
+DeviceId MultiRail::get_nic(const DeviceId npu_id, const int rail) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+    assert(0 <= rail && rail < rails_count);
+
+    return npus_count + npu_id * rails_count + rail;
+}
+
+DeviceId MultiRail::get_rail_switch(const int rail) const noexcept {
+    assert(0 <= rail && rail < rails_count);
+
+    return npus_count + npus_count * rails_count + rail;
+}
+
+int MultiRail::hashed_rail(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    const auto pair = static_cast<uint64_t>(src) * npus_count + dest;
+    return static_cast<int>(mix_bits(pair) % static_cast<uint64_t>(rails_count));
+}
+
+uint64_t MultiRail::get_route_tables_bytes() const noexcept {
+    // every interned rail route is a hash node (route and next pointer), plus the bucket array
+    auto allocated_bytes = Topology::get_route_tables_bytes();
+    allocated_bytes += rail_routes.bucket_count() * sizeof(void*);
+    for (const auto& [key, rail_route] : rail_routes) {
+        allocated_bytes += sizeof(void*) + sizeof(std::pair<const uint64_t, Route>) + rail_route.get_heap_bytes();
+    }
+    return allocated_bytes;
+}
+
+Route MultiRail::compute_rail_route(const DeviceId src, const DeviceId dest, const int rail) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // up through src's NIC to the rail switch, then down through dest's NIC
+    auto route = Route();
+    route.push_back(src);
+    route.push_back(get_nic(src, rail));
+    route.push_back(get_rail_switch(rail));
+    route.push_back(get_nic(dest, rail));
+    route.push_back(dest);
+
+    return route;
+}
@@ -4,7 +4,10 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Ring.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
 #include <cassert>
+#include <vector>
 
 using namespace NetworkAnalyticalCongestionAware;
 
@@ -15,54 +18,158 @@ Ring::Ring(const int npus_count, const Bandwidth bandwidth, const Latency latenc
     assert(bandwidth > 0);
     assert(latency >= 0);
 
-    // connect npus in a ring
+    // connect npus in a ring (allocating the link table once)
+    links.reserve(bidirectional ? 2 * npus_count : npus_count);
     for (auto i = 0; i < npus_count - 1; i++) {
         connect(i, i + 1, bandwidth, latency, bidirectional);
     }
-    connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+    // close the ring (a bidirectional 2-NPU ring is already closed)
+    if (npus_count > 2 || (npus_count == 2 && !bidirectional)) {
+        connect(npus_count - 1, 0, bandwidth, latency, bidirectional);
+    }
 }
 
-Route Ring::route(DeviceId src, DeviceId dest) const noexcept {
+Route Ring::compute_route(DeviceId src, DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
 
-    // construct empty route
+    // construct the route
+    auto devices = std::vector<DeviceId>(get_max_route_length());
+    const auto length = write_route(src, dest, devices.data());
+
     auto route = Route();
+    for (auto i = 0; i < length; i++) {
+        route.push_back(devices[i]);
+    }
+    return route;
+}
 
-    auto step = 1;  // default direction: clockwise
-    if (bidirectional) {
-        // check whether going anticlockwise is shorter
-        auto clockwise_dist = dest - src;
-        if (clockwise_dist < 0) {
-            clockwise_dist += npus_count;
-        }
-        const auto anticlockwise_dist = npus_count - clockwise_dist;
+DeviceId Ring::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
 
-        if (anticlockwise_dist < clockwise_dist) {
-            // traverse the ring anticlockwise
-            step = -1;
-        }
+    // move one step, wrapping around
+    const auto next = current + ring_step(current, dest);
+    if (next < 0) {
+        return next + npus_count;
     }
+    return (next >= npus_count) ? next - npus_count : next;
+}
 
-    // construct the route
-    auto current = src;
-    while (current != dest) {
-        // traverse the ring until reaches dest
-        route.push_back(devices[current]);
-        current = (current + step);
-
-        // wrap around
-        if (current < 0) {
-            current += npus_count;
-        } else if (current >= npus_count) {
-            current -= npus_count;
-        }
+void Ring::send_striped(const ChunkSize chunk_size,
+                        const DeviceId src,
+                        const DeviceId dest,
+                        const Callback callback,
+                        const CallbackArg callback_arg,
+                        const int traffic_class,
+                        const int job_id) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(chunk_size > 0);
+    assert(callback != nullptr);
+
+    // the longer way takes the smaller stripe, if any
+    const auto hops_count = get_hops_count(src, dest);
+    const auto stripe_size =
+        (bidirectional && hops_count > 0) ? ring_stripe_size(chunk_size, hops_count, npus_count - hops_count) : 0;
+    if (stripe_size == 0 || stripe_size == chunk_size) {
+        send(chunk_size, src, dest, callback, callback_arg, traffic_class, job_id);
+        return;
     }
 
-    // arrives at dest
-    route.push_back(devices[dest]);
+    // reuse the slot of an arrived transfer if any
+    auto transfer_id = static_cast<int>(striped_transfers.size());
+    if (free_transfer_ids.empty()) {
+        striped_transfers.emplace_back();
+    } else {
+        transfer_id = free_transfer_ids.back();
+        free_transfer_ids.pop_back();
+    }
+    auto& transfer = striped_transfers[transfer_id];
+    transfer = StripedTransfer{this, transfer_id, 2, callback, callback_arg};
+
+    // the larger stripe goes the shorter way
+    send(stripe_size, src, dest, stripe_arrived, &transfer, traffic_class, job_id);
+    send_along(&opposite_route(src, dest), chunk_size - stripe_size, stripe_arrived, &transfer, traffic_class,
+               job_id);
+}
+
+int Ring::get_active_striped_transfers_count() const noexcept {
+    return static_cast<int>(striped_transfers.size() - free_transfer_ids.size());
+}
+
+const Route& Ring::opposite_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(bidirectional);
+    assert(src != dest);
 
-    // return the constructed route
+    // traverse the ring against the direction of write_route
+    auto& route = route_table_entry(opposite_routes, src, dest);
+    if (route.empty()) {
+        const auto step = -ring_step(src, dest);
+        for (auto current = src; current != dest;) {
+            route.push_back(current);
+            current = (current + step + npus_count) % npus_count;
+        }
+        route.push_back(dest);
+        resolve_links(route);
+    }
     return route;
 }
+
+uint64_t Ring::get_route_tables_bytes() const noexcept {
+    return Topology::get_route_tables_bytes() + route_table_bytes(opposite_routes);
+}
+
+void Ring::stripe_arrived(void* const transfer_ptr) noexcept {
+    assert(transfer_ptr != nullptr);
+
+    auto& transfer = *static_cast<StripedTransfer*>(transfer_ptr);
+    assert(transfer.pending_stripes_count > 0);
+
+    // the transfer arrived with its last stripe
+    transfer.pending_stripes_count--;
+    if (transfer.pending_stripes_count > 0) {
+        return;
+    }
+    const auto callback = transfer.callback;
+    const auto callback_arg = transfer.callback_arg;
+    transfer.topology->free_transfer_ids.push_back(transfer.transfer_id);
+    (*callback)(callback_arg);
+}
+
+int Ring::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // the shorter way around, if bidirectional
+    auto clockwise_dist = dest - src;
+    if (clockwise_dist < 0) {
+        clockwise_dist += npus_count;
+    }
+    return bidirectional ? std::min(clockwise_dist, npus_count - clockwise_dist) : clockwise_dist;
+}
+
+TopologyMetrics Ring::compute_metrics(const int threads_count) const noexcept {
+    (void)threads_count;
+
+    auto metrics = TopologyMetrics();
+    metrics.links_count_per_dim = {get_links_count()};
+    if (npus_count < 2) {
+        return metrics;
+    }
+
+    // the halves are joined by the links between NPUs N/2 - 1 and N/2, and between NPUs N - 1 and 0
+    if (bidirectional) {
+        metrics.diameter = npus_count / 2;
+        metrics.average_hops_count = static_cast<double>(npus_count * npus_count / 4) / (npus_count - 1);
+        metrics.bisection_bandwidth = ((npus_count > 2) ? 2 : 1) * get_link_capacity(0);
+    } else {
+        metrics.diameter = npus_count - 1;
+        metrics.average_hops_count = npus_count / 2.0;
+        metrics.bisection_bandwidth = get_link_capacity(0);
+    }
+    return metrics;
+}
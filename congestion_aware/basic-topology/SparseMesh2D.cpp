@@ -4,31 +4,53 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/SparseMesh2D.h"
+#include "common/Logger.h"
+#include "common/NetworkFunction.h"
+#include <bitset>
 #include <cassert>
 #include <cstdlib>
 #include <cmath>
-#include <iostream>
 #include <iomanip>
-#include <queue>
-#include <unordered_map>
-#include <unordered_set>
-#include <algorithm>  // for std::reverse
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <algorithm>
 
 using namespace NetworkAnalyticalCongestionAware;
 
-// Helper function to calculate valid NPU count before calling base constructor
-static int calculate_valid_npu_count(int width, int height, 
-                                      const std::set<std::pair<int, int>>& excluded) {
-    int total_positions = width * height;
-    int excluded_count = 0;
-    for (const auto& [x, y] : excluded) {
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            excluded_count++;
+namespace {
+
+/// grid directions, in routing preference order (X before Y)
+constexpr int directions_count = 4;
+constexpr int direction_dx[directions_count] = {1, -1, 0, 0};
+constexpr int direction_dy[directions_count] = {0, 0, 1, -1};
+
+/// next-hop table entry of the destination itself and of unreachable NPUs (no direction bit set)
+constexpr uint8_t no_next_hop = 0;
+
+/**
+ * Get the direction of the n-th bit set in a next-hop table entry.
+ *
+ * @param directions next-hop table entry, a bit per direction
+ * @param n index of the bit among the set ones
+ * @return direction
+ */
+int nth_direction(const uint8_t directions, int n) noexcept {
+    assert(directions != no_next_hop);
+
+    for (auto direction = 0; direction < directions_count; direction++) {
+        if ((directions & (1 << direction)) != 0 && n-- == 0) {
+            return direction;
         }
     }
-    return total_positions - excluded_count;
+
+    // shouldn't reach here
+    assert(false);
+    return 0;
 }
 
+}  // namespace
+
 /**
  * Constructor: Initialize Sparse 2D Mesh Topology
  *
@@ -39,160 +61,34 @@ static int calculate_valid_npu_count(int width, int height,
 SparseMesh2D::SparseMesh2D(const int width, const int height,
                            const std::set<std::pair<int, int>>& excluded_coords,
                            const Bandwidth bandwidth, const Latency latency) noexcept
-    : width(width), height(height), excluded(excluded_coords),
-      BasicTopology(calculate_valid_npu_count(width, height, excluded_coords),
-                    calculate_valid_npu_count(width, height, excluded_coords), 
-                    bandwidth, latency) {
-    
-    // Validate input parameters
-    assert(width > 0);
-    assert(height > 0);
+    : SparseMesh2D(width, height, valid_cells_from_excluded(width, height, excluded_coords), bandwidth, latency) {}
+
+SparseMesh2D::SparseMesh2D(const int width, const int height, const std::vector<bool>& valid_cells,
+                           const Bandwidth bandwidth, const Latency latency) noexcept
+    : BasicTopology(count_valid_cells(width, height, valid_cells), count_valid_cells(width, height, valid_cells),
+                    bandwidth, latency),
+      width(width),
+      height(height),
+      valid_npu_count(npus_count),
+      valid_cells(valid_cells),
+      grid_to_npu(static_cast<size_t>(width) * height, -1),
+      npu_to_grid(npus_count),
+      next_hop_tables(npus_count),
+      next_hop_tables_built(std::make_unique<std::once_flag[]>(npus_count)),
+      multipath_routes_count(1) {
     assert(bandwidth > 0);
     assert(latency >= 0);
 
-    // =====================================================
-    // SPARSE MESH2D TOPOLOGY CONSTRUCTION - DETAILED LOGGING
-    // =====================================================
-    std::cerr << "\n";
-    std::cerr << "╔════════════════════════════════════════════════════════════════════════════╗\n";
-    std::cerr << "║              SPARSE MESH2D TOPOLOGY INITIALIZATION                         ║\n";
-    std::cerr << "╚════════════════════════════════════════════════════════════════════════════╝\n";
-    
-    std::cerr << "\n[SPARSE-MESH2D-INIT] Maximum Grid: " << width << " (width) × " << height << " (height)\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Excluded positions: " << excluded_coords.size() << "\n";
-    
-    // Print excluded coordinates
-    if (!excluded_coords.empty()) {
-        std::cerr << "[SPARSE-MESH2D-INIT] Excluded coordinates: ";
-        for (const auto& [x, y] : excluded_coords) {
-            std::cerr << "(" << x << "," << y << ") ";
-        }
-        std::cerr << "\n";
-    }
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[SPARSE-MESH2D-INIT] Maximum grid " << width << " (width) x " << height << " (height), "
+                                                                << (width * height - valid_npu_count)
+                                                                << " excluded positions");
 
-    // Initialize grid_to_npu mapping
-    grid_to_npu.resize(width * height, -1);
-    
-    // Count valid positions and assign NPU IDs
-    valid_npu_count = 0;
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            if (excluded.find({x, y}) == excluded.end()) {
-                // This position is valid
-                int grid_idx = coords_to_grid_index(x, y);
-                grid_to_npu[grid_idx] = valid_npu_count;
-                npu_to_grid.push_back({x, y});
-                valid_npu_count++;
-            }
-        }
-    }
-
-    std::cerr << "[SPARSE-MESH2D-INIT] Valid NPUs: " << valid_npu_count << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Bandwidth per link: " << bandwidth << " GB/s\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Latency per link: " << latency << " ns\n";
-
-    // Note: npus_count, devices_count, and devices are already set correctly 
-    // by BasicTopology constructor (we passed valid_npu_count to it)
-
-    // Fix topology metadata
-    dims_count = 2;
-    npus_count_per_dim.clear();
-    npus_count_per_dim.push_back(width);   // X dimension (max)
-    npus_count_per_dim.push_back(height);  // Y dimension (max)
-    bandwidth_per_dim.clear();
-    bandwidth_per_dim.push_back(bandwidth);
-    bandwidth_per_dim.push_back(bandwidth);
+    // number valid positions contiguously, in row-major order
+    auto npu_id_used = std::vector<bool>(valid_npu_count, false);
+    number_unplaced_npus(npu_id_used);
 
-    basic_topology_type = TopologyBuildingBlock::Mesh2D;  // Use Mesh2D type for compatibility
-
-    // Print grid layout with NPU IDs
-    std::cerr << "\n[SPARSE-MESH2D-INIT] Grid layout:\n\n";
-    
-    for (int y = 0; y < height; ++y) {
-        std::cerr << "                  ";
-        for (int x = 0; x < width; ++x) {
-            int npu_id = get_npu_at(x, y);
-            if (npu_id >= 0) {
-                std::cerr << std::setw(3) << npu_id;
-            } else {
-                std::cerr << "  x";
-            }
-            
-            // Only print horizontal connector if BOTH current AND next position are valid
-            if (x < width - 1) {
-                int next_npu = get_npu_at(x + 1, y);
-                if (npu_id >= 0 && next_npu >= 0) {
-                    std::cerr << " --- ";
-                } else {
-                    std::cerr << "     ";
-                }
-            }
-        }
-        std::cerr << "\n";
-        
-        // Print vertical connectors row
-        if (y < height - 1) {
-            std::cerr << "                  ";
-            for (int x = 0; x < width; ++x) {
-                int npu_id = get_npu_at(x, y);
-                int below_npu = get_npu_at(x, y + 1);
-                if (npu_id >= 0 && below_npu >= 0) {
-                    std::cerr << "  |  ";
-                } else {
-                    std::cerr << "     ";
-                }
-                if (x < width - 1) std::cerr << "     ";
-            }
-            std::cerr << "\n";
-        }
-    }
-    std::cerr << "\n";
-
-    // Create mesh links between adjacent valid nodes
-    int link_count = 0;
-    std::cerr << "[SPARSE-MESH2D-INIT] Creating mesh links...\n";
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int current_npu = get_npu_at(x, y);
-            if (current_npu < 0) continue;  // Skip excluded positions
-
-            // Connect to right neighbor (x + 1, y) if valid
-            if (x + 1 < width) {
-                int right_npu = get_npu_at(x + 1, y);
-                if (right_npu >= 0) {
-                    connect(current_npu, right_npu, bandwidth, latency, true);
-                    link_count += 2;
-                    std::cerr << "[SPARSE-MESH2D-LINK] NPU " << current_npu << " (at " << x << "," << y << ") "
-                              << "↔ NPU " << right_npu << " (at " << (x+1) << "," << y << ")\n";
-                }
-            }
-
-            // Connect to bottom neighbor (x, y + 1) if valid
-            if (y + 1 < height) {
-                int bottom_npu = get_npu_at(x, y + 1);
-                if (bottom_npu >= 0) {
-                    connect(current_npu, bottom_npu, bandwidth, latency, true);
-                    link_count += 2;
-                    std::cerr << "[SPARSE-MESH2D-LINK] NPU " << current_npu << " (at " << x << "," << y << ") "
-                              << "↔ NPU " << bottom_npu << " (at " << x << "," << (y+1) << ")\n";
-                }
-            }
-        }
-    }
-    
-    std::cerr << "\n[SPARSE-MESH2D-INIT] Total bidirectional links created: " << (link_count / 2) << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Total directed links: " << link_count << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Sparse Mesh2D topology construction COMPLETE ✓\n";
-    std::cerr << "\n";
-
-    // Print ring order for collective communication
-    std::cerr << "[SPARSE-MESH2D-INIT] Ring order for collectives: ";
-    for (int i = 0; i < valid_npu_count; ++i) {
-        std::cerr << i;
-        if (i < valid_npu_count - 1) std::cerr << " → ";
-    }
-    std::cerr << " → 0 (wrap)\n\n";
+    build_mesh(bandwidth, latency);
 }
 
 /**
@@ -205,229 +101,256 @@ SparseMesh2D::SparseMesh2D(const int width, const int height,
                            const std::set<std::pair<int, int>>& excluded_coords,
                            const std::map<std::pair<int, int>, int>& npu_placement,
                            const Bandwidth bandwidth, const Latency latency) noexcept
-    : width(width), height(height), excluded(excluded_coords),
-      BasicTopology(calculate_valid_npu_count(width, height, excluded_coords),
-                    calculate_valid_npu_count(width, height, excluded_coords), 
-                    bandwidth, latency) {
-    
-    // Validate input parameters
-    assert(width > 0);
-    assert(height > 0);
+    : SparseMesh2D(width, height, valid_cells_from_excluded(width, height, excluded_coords), npu_placement,
+                   bandwidth, latency) {}
+
+SparseMesh2D::SparseMesh2D(const int width, const int height, const std::vector<bool>& valid_cells,
+                           const std::map<std::pair<int, int>, int>& npu_placement, const Bandwidth bandwidth,
+                           const Latency latency) noexcept
+    : SparseMesh2D(width, height, valid_cells, placement_grid_from_map(width, height, npu_placement), bandwidth,
+                   latency) {}
+
+SparseMesh2D::SparseMesh2D(const int width, const int height, const std::vector<bool>& valid_cells,
+                           const std::vector<int>& npu_placement_grid, const Bandwidth bandwidth,
+                           const Latency latency) noexcept
+    : BasicTopology(count_valid_cells(width, height, valid_cells), count_valid_cells(width, height, valid_cells),
+                    bandwidth, latency),
+      width(width),
+      height(height),
+      valid_npu_count(npus_count),
+      valid_cells(valid_cells),
+      grid_to_npu(static_cast<size_t>(width) * height, -1),
+      npu_to_grid(npus_count),
+      next_hop_tables(npus_count),
+      next_hop_tables_built(std::make_unique<std::once_flag[]>(npus_count)),
+      multipath_routes_count(1) {
     assert(bandwidth > 0);
     assert(latency >= 0);
 
-    std::cerr << "\n";
-    std::cerr << "╔════════════════════════════════════════════════════════════════════════════╗\n";
-    std::cerr << "║         SPARSE MESH2D TOPOLOGY - CUSTOM NPU PLACEMENT                      ║\n";
-    std::cerr << "╚════════════════════════════════════════════════════════════════════════════╝\n";
-    
-    std::cerr << "\n[SPARSE-MESH2D-INIT] Maximum Grid: " << width << " (width) × " << height << " (height)\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Excluded positions: " << excluded_coords.size() << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Custom NPU placement: ENABLED\n";
-    
-    // Print excluded coordinates
-    if (!excluded_coords.empty()) {
-        std::cerr << "[SPARSE-MESH2D-INIT] Excluded coordinates: ";
-        for (const auto& [x, y] : excluded_coords) {
-            std::cerr << "(" << x << "," << y << ") ";
-        }
-        std::cerr << "\n";
-    }
-
-    // Calculate expected valid NPU count
-    int expected_count = calculate_valid_npu_count(width, height, excluded_coords);
-    valid_npu_count = expected_count;
-
-    // Initialize grid_to_npu mapping
-    grid_to_npu.resize(width * height, -1);
-    npu_to_grid.resize(valid_npu_count);
-
-    // Use custom placement to set up mappings
-    std::cerr << "[SPARSE-MESH2D-INIT] Applying custom NPU placement:\n";
-    
-    // First, validate and apply the custom placement
-    std::set<int> used_npu_ids;
-    for (const auto& [coord, npu_id] : npu_placement) {
-        int x = coord.first;
-        int y = coord.second;
-        
-        // Check coordinate is in bounds
-        if (x < 0 || x >= width || y < 0 || y >= height) {
-            std::cerr << "[SPARSE-MESH2D-ERROR] NPU placement (" << x << "," << y << ") -> " 
-                      << npu_id << " is out of bounds!\n";
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[SPARSE-MESH2D-INIT] Maximum grid " << width << " (width) x " << height << " (height), "
+                                                                << (width * height - valid_npu_count)
+                                                                << " excluded positions, custom NPU placement");
+
+    // validate and apply the custom placement
+    assert(npu_placement_grid.size() == static_cast<size_t>(width) * height);
+    auto npu_id_used = std::vector<bool>(valid_npu_count, false);
+    auto placed_npus_count = 0;
+    for (auto cell = 0; cell < width * height; cell++) {
+        const auto npu_id = npu_placement_grid[cell];
+        if (npu_id == -1) {
             continue;
         }
-        
+        const auto x = cell % width;
+        const auto y = cell / width;
+
         // Check coordinate is not excluded
-        if (excluded.find({x, y}) != excluded.end()) {
-            std::cerr << "[SPARSE-MESH2D-ERROR] NPU placement (" << x << "," << y << ") -> " 
-                      << npu_id << " is at an excluded position!\n";
+        if (!is_valid_position(x, y)) {
+            NETWORK_ANALYTICAL_LOG(LogLevel::Error, "[SPARSE-MESH2D] NPU placement (" << x << "," << y << ") -> "
+                                                                          << npu_id << " is at an excluded position!");
             continue;
         }
-        
+
         // Check NPU ID is in valid range
         if (npu_id < 0 || npu_id >= valid_npu_count) {
-            std::cerr << "[SPARSE-MESH2D-ERROR] NPU ID " << npu_id << " is out of range [0, " 
-                      << valid_npu_count << ")!\n";
+            NETWORK_ANALYTICAL_LOG(LogLevel::Error, "[SPARSE-MESH2D] NPU ID " << npu_id << " is out of range [0, "
+                                                                          << valid_npu_count << ")!");
             continue;
         }
-        
+
         // Check NPU ID is not already used
-        if (used_npu_ids.count(npu_id)) {
-            std::cerr << "[SPARSE-MESH2D-ERROR] NPU ID " << npu_id << " is assigned multiple times!\n";
+        if (npu_id_used[npu_id]) {
+            NETWORK_ANALYTICAL_LOG(LogLevel::Error,
+                                   "[SPARSE-MESH2D] NPU ID " << npu_id << " is assigned multiple times!");
             continue;
         }
-        
+
         // Apply the mapping
-        int grid_idx = coords_to_grid_index(x, y);
-        grid_to_npu[grid_idx] = npu_id;
+        grid_to_npu[coords_to_grid_index(x, y)] = npu_id;
         npu_to_grid[npu_id] = {x, y};
-        used_npu_ids.insert(npu_id);
-        
-        std::cerr << "  ├─ Position (" << x << "," << y << ") → NPU " << npu_id << "\n";
+        npu_id_used[npu_id] = true;
+        placed_npus_count++;
+        NETWORK_ANALYTICAL_LOG(LogLevel::Trace,
+                               "[SPARSE-MESH2D-INIT] Position (" << x << "," << y << ") -> NPU " << npu_id);
     }
-    
+
     // Validate all NPU IDs are assigned
-    if (used_npu_ids.size() != valid_npu_count) {
-        std::cerr << "[SPARSE-MESH2D-ERROR] Expected " << valid_npu_count << " NPU placements, got " 
-                  << used_npu_ids.size() << "!\n";
-        // Fall back to auto-assignment for missing positions
-        int next_auto_id = 0;
-        for (int y = 0; y < height; ++y) {
-            for (int x = 0; x < width; ++x) {
-                if (excluded.find({x, y}) == excluded.end()) {
-                    int grid_idx = coords_to_grid_index(x, y);
-                    if (grid_to_npu[grid_idx] < 0) {
-                        // Find next unused ID
-                        while (used_npu_ids.count(next_auto_id)) next_auto_id++;
-                        grid_to_npu[grid_idx] = next_auto_id;
-                        npu_to_grid[next_auto_id] = {x, y};
-                        used_npu_ids.insert(next_auto_id);
-                        std::cerr << "  ├─ [AUTO] Position (" << x << "," << y << ") → NPU " << next_auto_id << "\n";
-                        next_auto_id++;
-                    }
-                }
-            }
+    if (placed_npus_count != valid_npu_count) {
+        NETWORK_ANALYTICAL_LOG(LogLevel::Warning, "[SPARSE-MESH2D] Expected " << valid_npu_count
+                                                                              << " NPU placements, got "
+                                                                              << placed_npus_count
+                                                                              << ", auto-assigning the rest");
+        number_unplaced_npus(npu_id_used);
+    }
+
+    build_mesh(bandwidth, latency);
+}
+
+std::vector<bool> SparseMesh2D::valid_cells_from_excluded(
+    const int width, const int height, const std::set<std::pair<int, int>>& excluded_coords) noexcept {
+    assert(width > 0);
+    assert(height > 0);
+
+    auto valid_cells = std::vector<bool>(static_cast<size_t>(width) * height, true);
+    for (const auto& [x, y] : excluded_coords) {
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            valid_cells[static_cast<size_t>(y) * width + x] = false;
         }
     }
+    return valid_cells;
+}
 
-    std::cerr << "[SPARSE-MESH2D-INIT] Valid NPUs: " << valid_npu_count << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Bandwidth per link: " << bandwidth << " GB/s\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Latency per link: " << latency << " ns\n";
+std::vector<int> SparseMesh2D::placement_grid_from_map(
+    const int width, const int height, const std::map<std::pair<int, int>, int>& npu_placement) noexcept {
+    assert(width > 0);
+    assert(height > 0);
+
+    auto npu_placement_grid = std::vector<int>(static_cast<size_t>(width) * height, -1);
+    for (const auto& [coord, npu_id] : npu_placement) {
+        const auto [x, y] = coord;
+
+        // Check coordinate is in bounds
+        if (x < 0 || x >= width || y < 0 || y >= height) {
+            NETWORK_ANALYTICAL_LOG(LogLevel::Error, "[SPARSE-MESH2D] NPU placement (" << x << "," << y << ") -> "
+                                                                          << npu_id << " is out of bounds!");
+            continue;
+        }
+
+        npu_placement_grid[static_cast<size_t>(y) * width + x] = npu_id;
+    }
+    return npu_placement_grid;
+}
+
+int SparseMesh2D::count_valid_cells(const int width, const int height, const std::vector<bool>& valid_cells) noexcept {
+    assert(width > 0);
+    assert(height > 0);
+
+    if (valid_cells.size() != static_cast<size_t>(width) * height) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "SparseMesh2D valid cells bitmap has "
+                  << valid_cells.size() << " cells, expected " << width << " x " << height << std::endl;
+        std::exit(-1);
+    }
+
+    return static_cast<int>(std::count(valid_cells.begin(), valid_cells.end(), true));
+}
+
+void SparseMesh2D::number_unplaced_npus(std::vector<bool>& npu_id_used) noexcept {
+    assert(npu_id_used.size() == static_cast<size_t>(valid_npu_count));
+
+    // the next unused ID only moves forward, so numbering is linear
+    auto next_npu_id = 0;
+    for (auto grid_index = 0; grid_index < width * height; grid_index++) {
+        if (!valid_cells[grid_index] || grid_to_npu[grid_index] >= 0) {
+            continue;
+        }
+        while (npu_id_used[next_npu_id]) {
+            next_npu_id++;
+        }
+        grid_to_npu[grid_index] = next_npu_id;
+        npu_to_grid[next_npu_id] = {grid_index % width, grid_index / width};
+        npu_id_used[next_npu_id] = true;
+    }
+}
+
+void SparseMesh2D::build_mesh(const Bandwidth bandwidth, const Latency latency) noexcept {
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[SPARSE-MESH2D-INIT] " << valid_npu_count << " valid NPUs, bandwidth " << bandwidth
+                                                   << " GB/s, latency " << latency << " ns per link");
+
+    // Note: npus_count, devices_count, and devices are already set correctly
+    // by BasicTopology constructor (we passed valid_npu_count to it)
 
     // Fix topology metadata
     dims_count = 2;
     npus_count_per_dim.clear();
-    npus_count_per_dim.push_back(width);
-    npus_count_per_dim.push_back(height);
+    npus_count_per_dim.push_back(width);   // X dimension (max)
+    npus_count_per_dim.push_back(height);  // Y dimension (max)
     bandwidth_per_dim.clear();
     bandwidth_per_dim.push_back(bandwidth);
     bandwidth_per_dim.push_back(bandwidth);
 
-    basic_topology_type = TopologyBuildingBlock::Mesh2D;
+    basic_topology_type = TopologyBuildingBlock::Mesh2D;  // Use Mesh2D type for compatibility
+
+    // the layout is only rendered if debug logs are printed
+    NETWORK_ANALYTICAL_LOG(LogLevel::Debug, "[SPARSE-MESH2D-INIT] Grid layout:\n" << grid_layout());
+
+    // list the endpoints of the links first, so the links are constructed at once,
+    // visiting the grid in locality order so the links of a region get close link ids (and sit close in memory)
+    auto endpoints = std::vector<std::pair<DeviceId, DeviceId>>();
+    for (const auto cell : locality_order(width, height)) {
+        const auto x = cell % width;
+        const auto y = cell / width;
+        const auto current_npu = get_npu_at(x, y);
+        if (current_npu < 0) {
+            continue;  // Skip excluded positions
+        }
+
+        // Connect to right neighbor (x + 1, y) if valid
+        const auto right_npu = get_npu_at(x + 1, y);
+        if (right_npu >= 0) {
+            endpoints.emplace_back(current_npu, right_npu);
+            endpoints.emplace_back(right_npu, current_npu);
+            NETWORK_ANALYTICAL_LOG(LogLevel::Trace,
+                                   "[SPARSE-MESH2D-LINK] NPU " << current_npu << " <-> NPU " << right_npu);
+        }
+
+        // Connect to bottom neighbor (x, y + 1) if valid
+        const auto bottom_npu = get_npu_at(x, y + 1);
+        if (bottom_npu >= 0) {
+            endpoints.emplace_back(current_npu, bottom_npu);
+            endpoints.emplace_back(bottom_npu, current_npu);
+            NETWORK_ANALYTICAL_LOG(LogLevel::Trace,
+                                   "[SPARSE-MESH2D-LINK] NPU " << current_npu << " <-> NPU " << bottom_npu);
+        }
+    }
+    connect_all(endpoints, bandwidth, latency);
+    const auto links_count = endpoints.size();
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info, "[SPARSE-MESH2D-INIT] " << links_count << " directed links created");
+}
+
+std::string SparseMesh2D::grid_layout() const noexcept {
+    auto layout = std::ostringstream();
 
-    // Print grid layout with custom NPU IDs
-    std::cerr << "\n[SPARSE-MESH2D-INIT] Grid layout (custom placement):\n\n";
-    
     for (int y = 0; y < height; ++y) {
-        std::cerr << "                  ";
+        // NPU ids, with horizontal connectors between valid neighbors
         for (int x = 0; x < width; ++x) {
-            int npu_id = get_npu_at(x, y);
+            const auto npu_id = get_npu_at(x, y);
             if (npu_id >= 0) {
-                std::cerr << std::setw(3) << npu_id;
+                layout << std::setw(3) << npu_id;
             } else {
-                std::cerr << "  x";
+                layout << "  x";
             }
-            
+
             if (x < width - 1) {
-                int next_npu = get_npu_at(x + 1, y);
-                if (npu_id >= 0 && next_npu >= 0) {
-                    std::cerr << " --- ";
-                } else {
-                    std::cerr << "     ";
-                }
+                const auto next_npu = get_npu_at(x + 1, y);
+                layout << ((npu_id >= 0 && next_npu >= 0) ? " --- " : "     ");
             }
         }
-        std::cerr << "\n";
-        
+        layout << "\n";
+
+        // vertical connectors between valid neighbors
         if (y < height - 1) {
-            std::cerr << "                  ";
             for (int x = 0; x < width; ++x) {
-                int npu_id = get_npu_at(x, y);
-                int below_npu = get_npu_at(x, y + 1);
-                if (npu_id >= 0 && below_npu >= 0) {
-                    std::cerr << "  |  ";
-                } else {
-                    std::cerr << "     ";
+                const auto npu_id = get_npu_at(x, y);
+                const auto below_npu = get_npu_at(x, y + 1);
+                layout << ((npu_id >= 0 && below_npu >= 0) ? "  |" : "   ");
+                if (x < width - 1) {
+                    layout << "     ";
                 }
-                if (x < width - 1) std::cerr << "     ";
             }
-            std::cerr << "\n";
+            layout << "\n";
         }
     }
-    std::cerr << "\n";
 
-    // Create mesh links between adjacent valid nodes (same as before)
-    int link_count = 0;
-    std::cerr << "[SPARSE-MESH2D-INIT] Creating mesh links...\n";
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            int current_npu = get_npu_at(x, y);
-            if (current_npu < 0) continue;
-
-            // Connect to right neighbor
-            if (x + 1 < width) {
-                int right_npu = get_npu_at(x + 1, y);
-                if (right_npu >= 0) {
-                    connect(current_npu, right_npu, bandwidth, latency, true);
-                    link_count += 2;
-                    std::cerr << "[SPARSE-MESH2D-LINK] NPU " << current_npu << " (at " << x << "," << y << ") "
-                              << "↔ NPU " << right_npu << " (at " << (x+1) << "," << y << ")\n";
-                }
-            }
-
-            // Connect to bottom neighbor
-            if (y + 1 < height) {
-                int bottom_npu = get_npu_at(x, y + 1);
-                if (bottom_npu >= 0) {
-                    connect(current_npu, bottom_npu, bandwidth, latency, true);
-                    link_count += 2;
-                    std::cerr << "[SPARSE-MESH2D-LINK] NPU " << current_npu << " (at " << x << "," << y << ") "
-                              << "↔ NPU " << bottom_npu << " (at " << x << "," << (y+1) << ")\n";
-                }
-            }
-        }
-    }
-    
-    std::cerr << "\n[SPARSE-MESH2D-INIT] Total bidirectional links created: " << (link_count / 2) << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Total directed links: " << link_count << "\n";
-    std::cerr << "[SPARSE-MESH2D-INIT] Sparse Mesh2D topology (custom placement) COMPLETE ✓\n";
-    std::cerr << "\n";
-
-    // Print ring order - shows the CUSTOM order
-    std::cerr << "[SPARSE-MESH2D-INIT] Ring order for collectives: ";
-    for (int i = 0; i < valid_npu_count; ++i) {
-        std::cerr << i;
-        if (i < valid_npu_count - 1) std::cerr << " → ";
-    }
-    std::cerr << " → 0 (wrap)\n";
-    
-    // Also show physical path of ring
-    std::cerr << "[SPARSE-MESH2D-INIT] Ring physical locations: ";
-    for (int i = 0; i < valid_npu_count; ++i) {
-        auto [x, y] = npu_to_grid[i];
-        std::cerr << i << "@(" << x << "," << y << ")";
-        if (i < valid_npu_count - 1) std::cerr << " → ";
-    }
-    std::cerr << " → 0 (wrap)\n\n";
+    return layout.str();
 }
 
 bool SparseMesh2D::is_valid_position(int x, int y) const noexcept {
     if (x < 0 || x >= width || y < 0 || y >= height) {
         return false;
     }
-    return excluded.find({x, y}) == excluded.end();
+    return valid_cells[coords_to_grid_index(x, y)];
 }
 
 int SparseMesh2D::get_npu_at(int x, int y) const noexcept {
@@ -442,81 +365,80 @@ std::pair<int, int> SparseMesh2D::get_coords(DeviceId npu_id) const noexcept {
     return npu_to_grid[npu_id];
 }
 
-std::vector<std::pair<int, int>> SparseMesh2D::get_valid_neighbors(int x, int y) const noexcept {
-    std::vector<std::pair<int, int>> neighbors;
-    
-    // Check all 4 directions
-    const int dx[] = {1, -1, 0, 0};
-    const int dy[] = {0, 0, 1, -1};
-    
-    for (int i = 0; i < 4; ++i) {
-        int nx = x + dx[i];
-        int ny = y + dy[i];
-        if (is_valid_position(nx, ny)) {
-            neighbors.push_back({nx, ny});
-        }
-    }
-    
-    return neighbors;
+std::string SparseMesh2D::get_link_group(const LinkId link_id) const noexcept {
+    const auto [src, dest] = links.endpoints(link_id);
+    const auto [src_x, src_y] = get_coords(src);
+    const auto [dest_x, dest_y] = get_coords(dest);
+    return (src_y == dest_y) ? "row " + std::to_string(src_y) : "column " + std::to_string(src_x);
 }
 
-/**
- * Route using BFS to find shortest path (handles holes).
- */
-Route SparseMesh2D::bfs_route(DeviceId src, DeviceId dest) const noexcept {
-    auto [src_x, src_y] = get_coords(src);
-    auto [dest_x, dest_y] = get_coords(dest);
-    
-    // BFS to find shortest path
-    std::queue<std::pair<int, int>> q;
-    std::map<std::pair<int, int>, std::pair<int, int>> parent;  // For path reconstruction
-    std::set<std::pair<int, int>> visited;
-    
-    q.push({src_x, src_y});
-    visited.insert({src_x, src_y});
-    parent[{src_x, src_y}] = {-1, -1};  // Mark source
-    
-    while (!q.empty()) {
-        auto [cx, cy] = q.front();
-        q.pop();
-        
-        if (cx == dest_x && cy == dest_y) {
-            // Found destination - reconstruct path
-            Route route;
-            std::vector<std::pair<int, int>> path;
-            
-            auto current = std::make_pair(dest_x, dest_y);
-            while (current.first != -1) {
-                path.push_back(current);
-                current = parent[current];
+void SparseMesh2D::build_next_hop_tables(const int threads_count) const noexcept {
+    assert(threads_count >= 0);
+
+    const auto hardware_threads_count = static_cast<int>(std::thread::hardware_concurrency());
+    const auto requested_threads_count = (threads_count > 0) ? threads_count : hardware_threads_count;
+    const auto workers_count = std::max(1, std::min(valid_npu_count, requested_threads_count));
+
+    // each worker builds the tables of every workers_count-th destination
+    auto workers = std::vector<std::thread>();
+    for (auto worker = 0; worker < workers_count; worker++) {
+        workers.emplace_back([this, worker, workers_count] {
+            for (auto dest = worker; dest < valid_npu_count; dest += workers_count) {
+                static_cast<void>(next_hop_table(dest));
             }
-            
-            // Reverse to get src → dest order
-            std::reverse(path.begin(), path.end());
-            
-            for (const auto& [px, py] : path) {
-                int npu_id = get_npu_at(px, py);
-                route.push_back(devices[npu_id]);
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+const std::vector<uint8_t>& SparseMesh2D::next_hop_table(const DeviceId dest) const noexcept {
+    assert(0 <= dest && dest < valid_npu_count);
+
+    std::call_once(next_hop_tables_built[dest], [this, dest] { build_next_hop_table(dest); });
+    return next_hop_tables[dest];
+}
+
+void SparseMesh2D::build_next_hop_table(const DeviceId dest) const noexcept {
+    assert(0 <= dest && dest < valid_npu_count);
+
+    // failed links are routed around like holes
+    const auto live = [this](const DeviceId from, const DeviceId to) {
+        return failed_links.empty() || failed_links.count(find_link(from, to)) == 0;
+    };
+
+    // hop distance of every NPU to the destination
+    auto distances = std::vector<int>(valid_npu_count, -1);
+    auto frontier = std::vector<DeviceId>({dest});
+    distances[dest] = 0;
+    for (auto head = size_t(0); head < frontier.size(); head++) {
+        const auto npu = frontier[head];
+        const auto [x, y] = npu_to_grid[npu];
+        for (auto direction = 0; direction < directions_count; direction++) {
+            const auto neighbor = get_npu_at(x + direction_dx[direction], y + direction_dy[direction]);
+            if (neighbor >= 0 && distances[neighbor] < 0 && live(neighbor, npu)) {
+                distances[neighbor] = distances[npu] + 1;
+                frontier.push_back(neighbor);
             }
-            
-            return route;
         }
-        
-        // Explore neighbors
-        for (const auto& [nx, ny] : get_valid_neighbors(cx, cy)) {
-            if (visited.find({nx, ny}) == visited.end()) {
-                visited.insert({nx, ny});
-                parent[{nx, ny}] = {cx, cy};
-                q.push({nx, ny});
+    }
+
+    // every NPU may move to any neighbor one hop closer
+    auto& table = next_hop_tables[dest];
+    table.assign(valid_npu_count, no_next_hop);
+    for (auto npu = 0; npu < valid_npu_count; npu++) {
+        if (npu == dest || distances[npu] < 0) {
+            continue;
+        }
+        const auto [x, y] = npu_to_grid[npu];
+        for (auto direction = 0; direction < directions_count; direction++) {
+            const auto neighbor = get_npu_at(x + direction_dx[direction], y + direction_dy[direction]);
+            if (neighbor >= 0 && distances[neighbor] == distances[npu] - 1 && live(npu, neighbor)) {
+                table[npu] |= static_cast<uint8_t>(1 << direction);
             }
         }
     }
-    
-    // Should not reach here if mesh is connected
-    std::cerr << "[SPARSE-MESH2D-ROUTE] ERROR: No path found from " << src << " to " << dest << "!\n";
-    Route route;
-    route.push_back(devices[src]);
-    return route;
 }
 
 /**
@@ -525,42 +447,341 @@ Route SparseMesh2D::bfs_route(DeviceId src, DeviceId dest) const noexcept {
  * Uses BFS for sparse meshes since XY routing may not work when there are holes.
  * BFS guarantees shortest path in terms of hop count.
  */
-Route SparseMesh2D::route(const DeviceId src, const DeviceId dest) const noexcept {
+Route SparseMesh2D::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
     assert(0 <= src && src < valid_npu_count);
     assert(0 <= dest && dest < valid_npu_count);
 
     // Handle trivial case
     if (src == dest) {
         Route route;
-        route.push_back(devices[src]);
+        route.push_back(src);
         return route;
     }
 
-    auto [src_x, src_y] = get_coords(src);
-    auto [dest_x, dest_y] = get_coords(dest);
+    // walk the next-hop table of the destination
+    const auto& table = next_hop_table(dest);
+    if (table[src] == no_next_hop) {
+        NETWORK_ANALYTICAL_LOG(LogLevel::Error, "[SPARSE-MESH2D-ROUTE] No path found from " << src << " to " << dest
+                                                                                           << "!");
+        Route route;
+        route.push_back(src);
+        return route;
+    }
+
+    Route route;
+    auto npu = src;
+    route.push_back(npu);
+    while (npu != dest) {
+        const auto [x, y] = npu_to_grid[npu];
+        const auto direction = nth_direction(table[npu], 0);
+        npu = get_npu_at(x + direction_dx[direction], y + direction_dy[direction]);
+        route.push_back(npu);
+    }
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Debug, "[SPARSE-MESH2D-ROUTE] NPU " << src << " -> NPU " << dest << ": "
+                                                                         << (route.size() - 1) << " hops");
+
+    return route;
+}
+
+void SparseMesh2D::repair_routes(const std::vector<LinkId>& changed_link_ids, const bool failed) noexcept {
+    // hops from an NPU to the destination along a table (-1 if unreachable)
+    const auto hops_to_dest = [this](const std::vector<uint8_t>& table, DeviceId npu, const DeviceId dest) {
+        auto hops = 0;
+        for (; npu != dest; npu = next_hop(npu, dest)) {
+            if (table[npu] == no_next_hop) {
+                return -1;
+            }
+            hops++;
+        }
+        return hops;
+    };
+
+    // tables not built yet are built over the live links when first used
+    for (auto dest = 0; dest < valid_npu_count; dest++) {
+        const auto& table = next_hop_tables[dest];
+        if (table.empty()) {
+            continue;
+        }
+
+        auto affected = false;
+        for (const auto link_id : changed_link_ids) {
+            const auto& link = get_link(link_id);
+            const auto [src_x, src_y] = npu_to_grid[link.get_src()];
+            const auto [dest_x, dest_y] = npu_to_grid[link.get_dest()];
+            if (link.get_src() == dest) {
+                continue;
+            }
+            if (failed) {
+                // a failed link matters if the table may take it
+                for (auto direction = 0; direction < directions_count; direction++) {
+                    if (src_x + direction_dx[direction] == dest_x && src_y + direction_dy[direction] == dest_y) {
+                        affected = (table[link.get_src()] & (1 << direction)) != 0;
+                    }
+                }
+            } else {
+                // a restored link matters if it may shorten (or tie) a route of the table
+                const auto link_dest_hops = hops_to_dest(table, link.get_dest(), dest);
+                const auto link_src_hops = hops_to_dest(table, link.get_src(), dest);
+                affected = link_dest_hops >= 0 && (link_src_hops < 0 || link_dest_hops + 1 <= link_src_hops);
+            }
+            if (affected) {
+                break;
+            }
+        }
+        if (affected) {
+            build_next_hop_table(dest);
+        }
+    }
+}
+
+DeviceId SparseMesh2D::live_next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    return (next_hop_table(dest)[current] == no_next_hop) ? -1 : next_hop(current, dest);
+}
 
-    std::cerr << "\n┌─────────────────────────────────────────────────────────────┐\n";
-    std::cerr << "│          SPARSE MESH2D ROUTING - TRACE LOG                   │\n";
-    std::cerr << "└─────────────────────────────────────────────────────────────┘\n";
-    std::cerr << "[SPARSE-MESH2D-ROUTE] Source NPU: " << src << " at (" << src_x << ", " << src_y << ")\n";
-    std::cerr << "[SPARSE-MESH2D-ROUTE] Destination NPU: " << dest << " at (" << dest_x << ", " << dest_y << ")\n";
-    std::cerr << "[SPARSE-MESH2D-ROUTE] Using BFS for shortest path (handles holes)\n";
+int SparseMesh2D::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    const auto [row_hops_count, column_hops_count] = count_hops(src, dest);
+    return row_hops_count + column_hops_count;
+}
 
-    Route route = bfs_route(src, dest);
+EventTime SparseMesh2D::get_zero_load_latency(const DeviceId src,
+                                              const DeviceId dest,
+                                              const ChunkSize chunk_size) const noexcept {
+    assert(chunk_size > 0);
 
-    // Log the path
-    std::cerr << "[SPARSE-MESH2D-ROUTE] Path: ";
-    size_t idx = 0;
-    for (const auto& device : route) {
-        int npu_id = device->get_id();
-        auto [x, y] = get_coords(npu_id);
-        std::cerr << npu_id << "(" << x << "," << y << ")";
-        if (idx < route.size() - 1) std::cerr << " → ";
-        idx++;
+    // row hops cross dimension 0 links, column hops dimension 1 links
+    const auto [row_hops_count, column_hops_count] = count_hops(src, dest);
+    auto zero_load_latency = EventTime(0);
+    if (row_hops_count > 0) {
+        zero_load_latency += row_hops_count * dim_link_delay(0, chunk_size);
+    }
+    if (column_hops_count > 0) {
+        zero_load_latency += column_hops_count * dim_link_delay(1, chunk_size);
+    }
+    return zero_load_latency;
+}
+
+std::pair<int, int> SparseMesh2D::count_hops(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < valid_npu_count);
+    assert(0 <= dest && dest < valid_npu_count);
+
+    // the route of compute_route, without constructing it (no hop if dest is unreachable)
+    const auto& table = next_hop_table(dest);
+    if (src == dest || table[src] == no_next_hop) {
+        return {0, 0};
+    }
+    auto row_hops_count = 0;
+    auto column_hops_count = 0;
+    for (auto npu = src; npu != dest;) {
+        const auto [x, y] = npu_to_grid[npu];
+        const auto direction = nth_direction(table[npu], 0);
+        if (direction_dy[direction] == 0) {
+            row_hops_count++;
+        } else {
+            column_hops_count++;
+        }
+        npu = get_npu_at(x + direction_dx[direction], y + direction_dy[direction]);
+    }
+    return {row_hops_count, column_hops_count};
+}
+
+DeviceId SparseMesh2D::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < valid_npu_count);
+    assert(0 <= dest && dest < valid_npu_count);
+    assert(current != dest);
+
+    // the next-hop table of the destination holds the directions to move in, take the first one
+    const auto directions = next_hop_table(dest)[current];
+    assert(directions != no_next_hop);
+    const auto direction = nth_direction(directions, 0);
+    const auto [x, y] = npu_to_grid[current];
+    return get_npu_at(x + direction_dx[direction], y + direction_dy[direction]);
+}
+
+const Route* SparseMesh2D::select_route(const DeviceId src,
+                                        const DeviceId dest,
+                                        const uint64_t chunk_id) const noexcept {
+    // path 0 is the shared route, which takes the first direction at every hop
+    const auto path = static_cast<int>(mix_bits(chunk_id) % static_cast<uint64_t>(multipath_routes_count));
+    if (path == 0 || src == dest) {
+        return shared_route(src, dest);
+    }
+    return multipath_route(src, dest, path);
+}
+
+const Route* SparseMesh2D::multipath_route(const DeviceId src, const DeviceId dest, const int path) const noexcept {
+    assert(0 < path && path < multipath_routes_count);
+
+    // the other paths are interned like the shared routes
+    auto& route = route_table_entry(multipath_routes[path - 1], src, dest);
+    if (route.empty()) {
+        route = compute_multipath_route(src, dest, path);
+        resolve_links(route);
+    }
+    return &route;
+}
+
+bool SparseMesh2D::has_fixed_routes() const noexcept {
+    // multipath routes are picked per chunk
+    return multipath_routes_count == 1 && Topology::has_fixed_routes();
+}
+
+void SparseMesh2D::build_route_tables() const noexcept {
+    Topology::build_route_tables();
+
+    for (auto path = 1; path < multipath_routes_count; path++) {
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    static_cast<void>(multipath_route(src, dest, path));
+                }
+            }
+        }
+    }
+}
+
+void SparseMesh2D::set_multipath_routes_count(const int routes_count) noexcept {
+    assert(routes_count > 0);
+
+    multipath_routes_count = routes_count;
+    multipath_routes.clear();
+    multipath_routes.resize(routes_count - 1);
+}
+
+int SparseMesh2D::get_multipath_routes_count() const noexcept {
+    return multipath_routes_count;
+}
+
+Route SparseMesh2D::compute_multipath_route(const DeviceId src, const DeviceId dest, const int path) const noexcept {
+    assert(0 <= src && src < valid_npu_count);
+    assert(0 <= dest && dest < valid_npu_count);
+    assert(src != dest);
+
+    // unreachable destinations keep the single-device route
+    const auto& table = next_hop_table(dest);
+    if (table[src] == no_next_hop) {
+        return compute_route(src, dest);
+    }
+
+    // at every NPU with several shortest next hops, the path picks one of them by hashing (path, NPU)
+    Route route;
+    auto npu = src;
+    route.push_back(npu);
+    while (npu != dest) {
+        const auto directions = table[npu];
+        const auto candidates_count = std::bitset<directions_count>(directions).count();
+        const auto choice = mix_bits((static_cast<uint64_t>(path) << 32) | static_cast<uint64_t>(npu)) %
+                            static_cast<uint64_t>(candidates_count);
+        const auto direction = nth_direction(directions, static_cast<int>(choice));
+        const auto [x, y] = npu_to_grid[npu];
+        npu = get_npu_at(x + direction_dx[direction], y + direction_dy[direction]);
+        route.push_back(npu);
     }
-    std::cerr << "\n";
-    std::cerr << "[SPARSE-MESH2D-ROUTE] Total hops: " << (route.size() - 1) << "\n";
-    std::cerr << "[SPARSE-MESH2D-ROUTE] Latency: " << (latency * (route.size() - 1)) << " ns\n\n";
 
     return route;
 }
+
+uint64_t SparseMesh2D::get_route_tables_bytes() const noexcept {
+    auto allocated_bytes = Topology::get_route_tables_bytes();
+
+    // next-hop tables built so far
+    allocated_bytes += next_hop_tables.capacity() * sizeof(std::vector<uint8_t>);
+    for (const auto& next_hop_table : next_hop_tables) {
+        allocated_bytes += next_hop_table.capacity() * sizeof(uint8_t);
+    }
+
+    // interned multipath routes
+    for (const auto& multipath_route_table : multipath_routes) {
+        allocated_bytes += sizeof(RouteTable) + route_table_bytes(multipath_route_table);
+    }
+    return allocated_bytes;
+}
+
+int SparseMesh2D::get_link_dim(const LinkId link_id) const noexcept {
+    const auto [src, dest] = links.endpoints(link_id);
+    return (get_coords(src).second == get_coords(dest).second) ? 0 : 1;
+}
+
+std::vector<DeviceId> SparseMesh2D::get_ring_order() const noexcept {
+    auto ring_order = std::vector<DeviceId>();
+    ring_order.reserve(valid_npu_count);
+
+    // no holes: the ring of the full grid
+    if (valid_npu_count == width * height) {
+        for (const auto cell : grid_ring_order(width, height)) {
+            ring_order.push_back(grid_to_npu[cell]);
+        }
+        return ring_order;
+    }
+
+    constexpr int dx[] = {1, 0, -1, 0};
+    constexpr int dy[] = {0, 1, 0, -1};
+    auto visited = std::vector<bool>(static_cast<size_t>(width) * height, false);
+    const auto unvisited = [&](const int x, const int y) {
+        return get_npu_at(x, y) >= 0 && !visited[coords_to_grid_index(x, y)];
+    };
+
+    // start at the first valid cell
+    auto cell = static_cast<int>(std::find(valid_cells.begin(), valid_cells.end(), true) - valid_cells.begin());
+    while (true) {
+        visited[cell] = true;
+        ring_order.push_back(grid_to_npu[cell]);
+        if (static_cast<int>(ring_order.size()) == valid_npu_count) {
+            return ring_order;
+        }
+
+        // the unvisited neighbor with the fewest onward moves, leaving no dead end behind
+        const auto x = cell % width;
+        const auto y = cell / width;
+        auto next_cell = -1;
+        auto fewest_moves = 5;
+        for (auto direction = 0; direction < 4; direction++) {
+            const auto next_x = x + dx[direction];
+            const auto next_y = y + dy[direction];
+            if (!unvisited(next_x, next_y)) {
+                continue;
+            }
+            auto moves = 0;
+            for (auto onward = 0; onward < 4; onward++) {
+                moves += unvisited(next_x + dx[onward], next_y + dy[onward]) ? 1 : 0;
+            }
+            if (moves < fewest_moves) {
+                next_cell = coords_to_grid_index(next_x, next_y);
+                fewest_moves = moves;
+            }
+        }
+
+        // stuck: the nearest unvisited node (BFS over the valid cells, possibly reached through visited ones)
+        if (next_cell < 0) {
+            auto reached = std::vector<bool>(visited.size(), false);
+            auto frontier = std::vector<int>{cell};
+            reached[cell] = true;
+            for (auto head = size_t(0); head < frontier.size() && next_cell < 0; head++) {
+                const auto current = frontier[head];
+                for (auto direction = 0; direction < 4; direction++) {
+                    const auto next_x = current % width + dx[direction];
+                    const auto next_y = current / width + dy[direction];
+                    if (get_npu_at(next_x, next_y) < 0 || reached[coords_to_grid_index(next_x, next_y)]) {
+                        continue;
+                    }
+                    const auto neighbor = coords_to_grid_index(next_x, next_y);
+                    reached[neighbor] = true;
+                    if (!visited[neighbor]) {
+                        next_cell = neighbor;
+                        break;
+                    }
+                    frontier.push_back(neighbor);
+                }
+            }
+
+            // unreachable nodes: the first unvisited one
+            if (next_cell < 0) {
+                next_cell = 0;
+                while (!unvisited(next_cell % width, next_cell / width)) {
+                    next_cell++;
+                }
+            }
+        }
+        cell = next_cell;
+    }
+}
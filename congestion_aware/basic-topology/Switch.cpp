@@ -4,6 +4,7 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Switch.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalyticalCongestionAware;
@@ -19,13 +20,24 @@ Switch::Switch(const int npus_count, const Bandwidth bandwidth, const Latency la
     // set switch id
     switch_id = npus_count;
 
-    // connect npus and switches, the link should be bidirectional
+    // connect npus and switches, the link should be bidirectional (allocating the link table once)
+    links.reserve(2 * npus_count);
     for (auto i = 0; i < npus_count; i++) {
         connect(i, switch_id, bandwidth, latency, true);
     }
+
+    // one-hop routes of in-network reductions
+    uplink_routes.reserve(npus_count);
+    downlink_routes.reserve(npus_count);
+    for (auto i = 0; i < npus_count; i++) {
+        uplink_routes.push_back(Route({i, switch_id}));
+        resolve_links(uplink_routes.back());
+        downlink_routes.push_back(Route({switch_id, i}));
+        resolve_links(downlink_routes.back());
+    }
 }
 
-Route Switch::route(DeviceId src, DeviceId dest) const noexcept {
+Route Switch::compute_route(DeviceId src, DeviceId dest) const noexcept {
     // assert npus are in valid range
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
@@ -33,9 +45,124 @@ Route Switch::route(DeviceId src, DeviceId dest) const noexcept {
     // construct route
     // start at source, and go to switch, then go to destination
     auto route = Route();
-    route.push_back(devices[src]);
-    route.push_back(devices[switch_id]);
-    route.push_back(devices[dest]);
+    route.push_back(src);
+    route.push_back(switch_id);
+    route.push_back(dest);
 
     return route;
 }
+
+DeviceId Switch::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    // assert devices are in valid range
+    assert((0 <= current && current < npus_count) || current == switch_id);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // npus go to the switch, the switch goes to the destination
+    return (current == switch_id) ? dest : switch_id;
+}
+
+Switch::ReductionId Switch::create_reduction(const std::vector<DeviceId>& members,
+                                             const ChunkSize chunk_size,
+                                             const Callback callback,
+                                             const CallbackArg callback_arg) noexcept {
+    assert(!members.empty());
+    assert(chunk_size > 0);
+    assert(callback != nullptr);
+
+    // reuse the slot of a finished reduction if any
+    auto reduction_id = static_cast<ReductionId>(reductions.size());
+    if (free_reduction_ids.empty()) {
+        reductions.emplace_back();
+    } else {
+        reduction_id = free_reduction_ids.back();
+        free_reduction_ids.pop_back();
+    }
+
+    const auto members_count = static_cast<int>(members.size());
+    reductions[reduction_id] =
+        Reduction{this, reduction_id, members, chunk_size, members_count, members_count, callback, callback_arg};
+    return reduction_id;
+}
+
+void Switch::contribute(const ReductionId reduction_id, const DeviceId npu) noexcept {
+    assert(0 <= reduction_id && reduction_id < static_cast<ReductionId>(reductions.size()));
+    assert(0 <= npu && npu < npus_count);
+
+    auto& reduction = reductions[reduction_id];
+    assert(reduction.pending_contributions_count > 0);
+    assert(std::find(reduction.members.begin(), reduction.members.end(), npu) != reduction.members.end());
+
+    // the contribution is consumed by the switch
+    send_along(&uplink_routes[npu], reduction.chunk_size, contribution_arrived, &reduction);
+}
+
+void Switch::all_reduce(const std::vector<DeviceId>& members,
+                        const ChunkSize chunk_size,
+                        const Callback callback,
+                        const CallbackArg callback_arg) noexcept {
+    const auto reduction_id = create_reduction(members, chunk_size, callback, callback_arg);
+    for (const auto member : members) {
+        contribute(reduction_id, member);
+    }
+}
+
+int Switch::get_active_reductions_count() const noexcept {
+    return static_cast<int>(reductions.size() - free_reduction_ids.size());
+}
+
+void Switch::contribution_arrived(void* const reduction_ptr) noexcept {
+    assert(reduction_ptr != nullptr);
+
+    auto& reduction = *static_cast<Reduction*>(reduction_ptr);
+    assert(reduction.pending_contributions_count > 0);
+
+    // the switch sends the aggregated result once every contribution arrived
+    reduction.pending_contributions_count--;
+    if (reduction.pending_contributions_count > 0) {
+        return;
+    }
+    for (const auto member : reduction.members) {
+        reduction.topology->send_along(&reduction.topology->downlink_routes[member], reduction.chunk_size,
+                                       result_arrived, &reduction);
+    }
+}
+
+void Switch::result_arrived(void* const reduction_ptr) noexcept {
+    assert(reduction_ptr != nullptr);
+
+    auto& reduction = *static_cast<Reduction*>(reduction_ptr);
+    assert(reduction.pending_results_count > 0);
+
+    (*reduction.callback)(reduction.callback_arg);
+
+    // the reduction is over once its result arrived at every member
+    reduction.pending_results_count--;
+    if (reduction.pending_results_count == 0) {
+        reduction.topology->free_reduction_ids.push_back(reduction.reduction_id);
+    }
+}
+
+int Switch::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // up to the switch, then down to dest
+    return 2;
+}
+
+TopologyMetrics Switch::compute_metrics(const int threads_count) const noexcept {
+    (void)threads_count;
+
+    auto metrics = TopologyMetrics();
+    metrics.links_count_per_dim = {get_links_count()};
+    if (npus_count < 2) {
+        return metrics;
+    }
+
+    // the smaller half is bound by its links to the switch
+    metrics.diameter = 2;
+    metrics.average_hops_count = 2;
+    metrics.bisection_bandwidth = (npus_count / 2) * get_link_capacity(0);
+    return metrics;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Torus.h"
+#include "common/Logger.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <vector>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+Torus::Torus(const int width, const int height, const Bandwidth bandwidth, const Latency latency) noexcept
+    : Torus(width, height, 1, bandwidth, latency) {}
+
+Torus::Torus(const int width,
+             const int height,
+             const int depth,
+             const Bandwidth bandwidth,
+             const Latency latency) noexcept
+    : sizes({width, height, depth}),
+      strides({1, width, width * height}),
+      BasicTopology(width * height * depth, width * height * depth, bandwidth, latency) {
+    assert(width > 0);
+    assert(height > 0);
+    assert(depth > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // topology metadata reflects every torus dimension
+    const auto torus_dims_count = (depth > 1) ? 3 : 2;
+    dims_count = torus_dims_count;
+    npus_count_per_dim.assign(sizes.begin(), sizes.begin() + torus_dims_count);
+    bandwidth_per_dim.assign(torus_dims_count, bandwidth);
+    basic_topology_type = (torus_dims_count == 3) ? TopologyBuildingBlock::Torus3D : TopologyBuildingBlock::Torus2D;
+
+    // each ring of k > 2 nodes has k links, a ring of 2 nodes a single one
+    auto links_count = 0;
+    for (auto dim = 0; dim < max_torus_dims; dim++) {
+        const auto rings_count = npus_count / sizes[dim];
+        const auto ring_links_count = (sizes[dim] > 2) ? sizes[dim] : sizes[dim] - 1;
+        links_count += 2 * rings_count * ring_links_count;
+    }
+    links.reserve(links_count);
+
+    // connect every NPU to its positive neighbor along each dimension (wrapping around)
+    for (auto npu = 0; npu < npus_count; npu++) {
+        for (auto dim = 0; dim < max_torus_dims; dim++) {
+            const auto coord = coordinate(npu, dim);
+            if (coord + 1 < sizes[dim]) {
+                connect(npu, npu + strides[dim], bandwidth, latency, true);
+            } else if (sizes[dim] > 2) {
+                connect(npu, npu - coord * strides[dim], bandwidth, latency, true);
+            }
+        }
+    }
+    assert(static_cast<int>(links.size()) == links_count);
+
+    NETWORK_ANALYTICAL_LOG(LogLevel::Info,
+                           "[TORUS-INIT] " << width << " x " << height << " x " << depth << " = " << npus_count
+                                           << " NPUs, " << links_count << " directed links, bandwidth " << bandwidth
+                                           << " GB/s, latency " << latency << " ns per link");
+}
+
+Route Torus::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // follow the next hops until reaching dest
+    auto route = Route();
+    route.push_back(src);
+    for (auto current = src; current != dest;) {
+        current = next_hop(current, dest);
+        route.push_back(current);
+    }
+
+    return route;
+}
+
+DeviceId Torus::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // move along the first unaligned dimension
+    for (auto dim = 0; dim < max_torus_dims; dim++) {
+        const auto coord = coordinate(current, dim);
+        const auto step = ring_step(dim, coord, coordinate(dest, dim));
+        if (step == 0) {
+            continue;
+        }
+
+        // wrap around the ring
+        const auto next_coord = (coord + step + sizes[dim]) % sizes[dim];
+        return current + (next_coord - coord) * strides[dim];
+    }
+
+    // shouldn't reach here
+    assert(false);
+    return dest;
+}
+
+int Torus::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // shorter way around each ring
+    auto hops_count = 0;
+    for (auto dim = 0; dim < max_torus_dims; dim++) {
+        const auto distance = std::abs(coordinate(dest, dim) - coordinate(src, dim));
+        hops_count += std::min(distance, sizes[dim] - distance);
+    }
+    return hops_count;
+}
+
+int Torus::ring_step(const int dim, const int from, const int to) const noexcept {
+    if (from == to) {
+        return 0;
+    }
+
+    // positive distance around the ring
+    auto positive_distance = to - from;
+    if (positive_distance < 0) {
+        positive_distance += sizes[dim];
+    }
+
+    // take the negative way if it's strictly shorter
+    return (sizes[dim] - positive_distance < positive_distance) ? -1 : 1;
+}
+
+TopologyMetrics Torus::compute_metrics(const int threads_count) const noexcept {
+    // the NPU halves split the highest dimension longer than 1
+    auto split_dim = dims_count - 1;
+    while (split_dim > 0 && sizes[split_dim] == 1) {
+        split_dim--;
+    }
+    if (sizes[split_dim] % 2 != 0) {
+        return Topology::compute_metrics(threads_count);
+    }
+
+    // each ring of k > 2 nodes has k links per direction, a ring of 2 nodes a single one
+    auto metrics = TopologyMetrics();
+    const auto sizes_per_dim = std::vector<int>(sizes.begin(), sizes.begin() + dims_count);
+    for (const auto size : sizes_per_dim) {
+        metrics.links_count_per_dim.push_back(2 * (npus_count / size) * ((size > 2) ? size : size - 1));
+        metrics.diameter += size / 2;
+    }
+    if (npus_count < 2) {
+        return metrics;
+    }
+
+    // each ring of that dimension crosses the middle twice (once for 2 nodes)
+    metrics.average_hops_count = grid_average_hops_count(sizes_per_dim, true);
+    const auto split_size = sizes[split_dim];
+    metrics.bisection_bandwidth = (npus_count / split_size) * ((split_size > 2) ? 2 : 1) * get_link_capacity(0);
+    return metrics;
+}
+
+int Torus::get_link_dim(const LinkId link_id) const noexcept {
+    const auto [src, dest] = links.endpoints(link_id);
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (coordinate(src, dim) != coordinate(dest, dim)) {
+            return dim;
+        }
+    }
+
+    // shouldn't reach here
+    assert(false);
+    return 0;
+}
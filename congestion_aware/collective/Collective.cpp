@@ -0,0 +1,454 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Collective.h"
+#include "common/EventQueue.h"
+#include "congestion_aware/FullyConnected.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Mesh2D.h"
+#include "congestion_aware/Ring.h"
+#include "congestion_aware/Switch.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+Collective::Collective(std::shared_ptr<Topology> topology,
+                       const CollectiveType collective_type,
+                       const CollectiveAlgorithm collective_algorithm,
+                       const ChunkSize collective_size,
+                       const int chunks_count) noexcept
+    : topology(std::move(topology)),
+      collective_type(collective_type),
+      collective_algorithm(collective_algorithm),
+      collective_size(collective_size),
+      chunks_count(chunks_count),
+      symmetric(false),
+      bidirectional(false),
+      traffic_class(0),
+      job_id(0),
+      sent_messages_count(0),
+      finished_pairs_count(0),
+      finish_time(0),
+      callback(nullptr),
+      callback_arg(nullptr) {
+    assert(this->topology != nullptr);
+    assert(collective_size > 0);
+    assert(chunks_count > 0);
+
+    npus_count = this->topology->get_npus_count();
+    simulated_ranks_count = npus_count;
+
+    // count the steps of the algorithm
+    const auto is_all_reduce = (collective_type == CollectiveType::AllReduce);
+    switch (collective_algorithm) {
+    case CollectiveAlgorithm::Ring:
+        steps_count = (npus_count - 1) * (is_all_reduce ? 2 : 1);
+
+        // around the ring embedded in the topology
+        ring_order = this->topology->get_ring_order();
+        assert(static_cast<int>(ring_order.size()) == npus_count);
+        ring_positions.resize(npus_count);
+        for (auto position = 0; position < npus_count; position++) {
+            ring_positions[ring_order[position]] = position;
+        }
+        break;
+    case CollectiveAlgorithm::Direct:
+        steps_count = (npus_count > 1) ? (is_all_reduce ? 2 : 1) : 0;
+        break;
+    case CollectiveAlgorithm::HalvingDoubling: {
+        if (collective_type == CollectiveType::AllToAll) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "HalvingDoubling does not support AllToAll" << std::endl;
+            std::exit(-1);
+        }
+        if ((npus_count & (npus_count - 1)) != 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "HalvingDoubling requires a power-of-2 number of NPUs, got " << npus_count << std::endl;
+            std::exit(-1);
+        }
+        auto log_npus_count = 0;
+        while ((1 << log_npus_count) < npus_count) {
+            log_npus_count++;
+        }
+        steps_count = log_npus_count * (is_all_reduce ? 2 : 1);
+        break;
+    }
+    case CollectiveAlgorithm::Hierarchical: {
+        // Reduce-Scatter up the dimensions, each on the shard left by the lower ones
+        npus_count_per_dim = this->topology->get_npus_count_per_dim();
+        auto stride = 1;
+        auto shard_size = collective_size;
+        auto reduce_scatter_steps = std::vector<std::pair<int, ChunkSize>>();
+        for (auto dim = 0; dim < static_cast<int>(npus_count_per_dim.size()); dim++) {
+            const auto dim_size = npus_count_per_dim[dim];
+            stride_per_dim.push_back(stride);
+            stride *= dim_size;
+            shard_size /= dim_size;
+            reduce_scatter_steps.insert(reduce_scatter_steps.end(), dim_size - 1, {dim, shard_size});
+        }
+        assert(stride == npus_count);
+
+        // the ring along each dimension: the next coordinate, but folded over the lines of a Mesh2D
+        const auto lines = (dynamic_cast<const Mesh2D*>(this->topology.get()) != nullptr);
+        for (const auto dim_size : npus_count_per_dim) {
+            auto& next_coordinate = next_coordinate_per_dim.emplace_back(dim_size);
+            const auto cells = lines ? Topology::grid_ring_order(dim_size, 1) : std::vector<int>();
+            for (auto coordinate = 0; coordinate < dim_size; coordinate++) {
+                if (lines) {
+                    next_coordinate[cells[coordinate]] = cells[(coordinate + 1) % dim_size];
+                } else {
+                    next_coordinate[coordinate] = (coordinate + 1) % dim_size;
+                }
+            }
+        }
+
+        // AllToAll: transpose each dimension in turn, exchanging with the NPUs k apart both ways at step k,
+        // so only the links of one dimension are loaded at a time, in both directions
+        if (collective_type == CollectiveType::AllToAll) {
+            for (auto dim = 0; dim < static_cast<int>(npus_count_per_dim.size()); dim++) {
+                const auto dim_size = npus_count_per_dim[dim];
+                for (auto shift = 1; 2 * shift <= dim_size; shift++) {
+                    hierarchical_steps.emplace_back(dim, collective_size / dim_size);
+                    hierarchical_shifts.push_back(shift);
+                }
+            }
+            steps_count = static_cast<int>(hierarchical_steps.size());
+            break;
+        }
+
+        // All-Gather back down with the same steps
+        if (collective_type != CollectiveType::AllGather) {
+            hierarchical_steps = reduce_scatter_steps;
+        }
+        if (collective_type != CollectiveType::ReduceScatter) {
+            hierarchical_steps.insert(hierarchical_steps.end(), reduce_scatter_steps.rbegin(),
+                                      reduce_scatter_steps.rend());
+        }
+        hierarchical_shifts.assign(hierarchical_steps.size(), 1);
+        steps_count = static_cast<int>(hierarchical_steps.size());
+        break;
+    }
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported collective algorithm"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // progress of every (rank, chunk)
+    issued_steps.assign(npus_count * chunks_count, 0);
+    received_messages.assign(static_cast<size_t>(npus_count) * chunks_count * steps_count, 0);
+}
+
+void Collective::start(const Callback callback, const CallbackArg callback_arg) noexcept {
+    this->callback = callback;
+    this->callback_arg = callback_arg;
+
+    // issue the first step of every (rank, chunk)
+    for (auto rank = 0; rank < simulated_ranks_count; rank++) {
+        for (auto chunk_id = 0; chunk_id < chunks_count; chunk_id++) {
+            advance(rank, chunk_id);
+        }
+    }
+}
+
+void Collective::set_symmetric(const bool new_symmetric) noexcept {
+    // symmetric mode can't be changed once started
+    assert(sent_messages_count == 0);
+
+    symmetric = new_symmetric;
+    simulated_ranks_count = symmetric ? 1 : npus_count;
+    if (!symmetric) {
+        return;
+    }
+
+    if (!supports_symmetric()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "symmetric collectives require a Ring, FullyConnected, or Switch topology "
+                  << "and the Ring or Direct algorithm" << std::endl;
+        std::exit(-1);
+    }
+
+    // routes are mapped on first use
+    symmetric_routes.resize(npus_count);
+}
+
+bool Collective::supports_symmetric() const noexcept {
+    // rank r's traffic is rank 0's shifted by r only if both the topology and the algorithm are rotation-symmetric
+    const auto* const raw_topology = topology.get();
+    const auto symmetric_topology = dynamic_cast<const Ring*>(raw_topology) != nullptr ||
+                                    dynamic_cast<const FullyConnected*>(raw_topology) != nullptr ||
+                                    dynamic_cast<const Switch*>(raw_topology) != nullptr;
+    return symmetric_topology &&
+           (collective_algorithm == CollectiveAlgorithm::Ring || collective_algorithm == CollectiveAlgorithm::Direct);
+}
+
+void Collective::set_bidirectional(const bool new_bidirectional) noexcept {
+    // the direction can't be changed once started
+    assert(sent_messages_count == 0);
+
+    if (new_bidirectional &&
+        (collective_algorithm != CollectiveAlgorithm::Ring || collective_type == CollectiveType::AllToAll)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "bidirectional collectives require the Ring algorithm and a collective other than AllToAll"
+                  << std::endl;
+        std::exit(-1);
+    }
+    bidirectional = new_bidirectional;
+}
+
+void Collective::set_traffic_class(const int new_traffic_class) noexcept {
+    assert(0 <= new_traffic_class && new_traffic_class < Link::max_traffic_classes);
+
+    traffic_class = new_traffic_class;
+}
+
+void Collective::set_job_id(const int new_job_id) noexcept {
+    assert(0 <= new_job_id && new_job_id < Chunk::max_jobs_count);
+
+    job_id = new_job_id;
+}
+
+bool Collective::cross_check(std::shared_ptr<Topology> reference_topology) const noexcept {
+    assert(reference_topology != nullptr);
+    assert(reference_topology->get_npus_count() == npus_count);
+    assert(finished());
+
+    // simulate every rank on the reference topology
+    const auto reference_event_queue = std::make_shared<EventQueue>();
+    reference_topology->attach_event_queue(reference_event_queue);
+    auto reference = Collective(std::move(reference_topology), collective_type, collective_algorithm,
+                                collective_size, chunks_count);
+    reference.set_bidirectional(bidirectional);
+    reference.start();
+    reference_event_queue->run_to_completion();
+
+    if (!reference.finished() || reference.get_finish_time() != finish_time) {
+        std::cerr << "[Warning] (network/analytical/congestion_aware) " << "collective finished at " << finish_time
+                  << ", but the reference at " << (reference.finished() ? reference.get_finish_time() : 0)
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Collective::finished() const noexcept {
+    return finished_pairs_count == simulated_ranks_count * chunks_count;
+}
+
+EventTime Collective::get_finish_time() const noexcept {
+    assert(finished());
+
+    return finish_time;
+}
+
+int Collective::get_steps_count() const noexcept {
+    return steps_count;
+}
+
+int Collective::get_peak_in_flight_messages_count() const noexcept {
+    return static_cast<int>(messages.size());
+}
+
+uint64_t Collective::get_messages_count() const noexcept {
+    // every rank sends as many messages as rank 0
+    return symmetric ? sent_messages_count * npus_count : sent_messages_count;
+}
+
+void Collective::message_arrived(void* const message_ptr) noexcept {
+    assert(message_ptr != nullptr);
+
+    // recycle the message
+    auto* const message = static_cast<Message*>(message_ptr);
+    auto* const collective = message->collective;
+    const auto rank = message->rank;
+    const auto chunk_id = message->chunk_id;
+    const auto step = message->step;
+    collective->free_messages.push_back(message);
+
+    // record the arrival and issue whatever it unblocked
+    const auto pair = collective->pair_index(rank, chunk_id);
+    collective->received_messages[static_cast<size_t>(pair) * collective->steps_count + step]++;
+    collective->advance(rank, chunk_id);
+}
+
+void Collective::advance(const DeviceId rank, const int chunk_id) noexcept {
+    const auto pair = pair_index(rank, chunk_id);
+    auto& issued = issued_steps[pair];
+    const auto* const received = &received_messages[static_cast<size_t>(pair) * steps_count];
+
+    // a step depends on every message of the previous step
+    while (issued < steps_count && (issued == 0 || received[issued - 1] == get_fanout(issued - 1))) {
+        issue_step(rank, chunk_id, issued);
+        issued++;
+    }
+
+    // the pair finishes once every step was issued and its last step arrived
+    // (messages of the pair stop arriving after that, so it is counted once)
+    if (issued < steps_count || (steps_count > 0 && received[steps_count - 1] < get_fanout(steps_count - 1))) {
+        return;
+    }
+    finished_pairs_count++;
+
+    if (finished()) {
+        const auto scheduler = topology->get_scheduler();
+        finish_time = (scheduler != nullptr) ? scheduler->get_current_time() : 0;
+
+        if (callback != nullptr) {
+            (*callback)(callback_arg);
+        }
+    }
+}
+
+void Collective::issue_step(const DeviceId rank, const int chunk_id, const int step) noexcept {
+    assert(0 <= step && step < steps_count);
+
+    const auto chunk_size = std::max<ChunkSize>(get_message_size(step) / chunks_count, 1);
+    const auto fanout = get_fanout(step);
+
+    for (auto message_id = 0; message_id < fanout; message_id++) {
+        const auto peer = get_peer(rank, step, message_id);
+        assert(peer != rank);
+
+        // take a message slot
+        auto* message = static_cast<Message*>(nullptr);
+        if (!free_messages.empty()) {
+            message = free_messages.back();
+            free_messages.pop_back();
+        } else {
+            message = &messages.emplace_back();
+        }
+        sent_messages_count++;
+
+        // symmetric mode: rank 0 receives its peer's message (rotated by the peer) as the peer receives rank 0's
+        if (symmetric) {
+            *message = Message{this, rank, chunk_id, step};
+            topology->send_along(symmetric_route(peer), chunk_size, message_arrived, static_cast<void*>(message),
+                                 traffic_class, job_id);
+            continue;
+        }
+
+        *message = Message{this, peer, chunk_id, step};
+        topology->send(chunk_size, rank, peer, message_arrived, static_cast<void*>(message), traffic_class, job_id);
+    }
+}
+
+int Collective::get_fanout(const int step) const noexcept {
+    assert(0 <= step && step < steps_count);
+
+    if (collective_algorithm == CollectiveAlgorithm::Hierarchical && collective_type == CollectiveType::AllToAll) {
+        // both ways, but halfway around the dimension
+        const auto dim_size = npus_count_per_dim[hierarchical_steps[step].first];
+        return (2 * hierarchical_shifts[step] == dim_size) ? 1 : 2;
+    }
+    if (collective_algorithm == CollectiveAlgorithm::Direct) {
+        return npus_count - 1;
+    }
+    return bidirectional ? 2 : 1;
+}
+
+DeviceId Collective::get_peer(const DeviceId rank, const int step, const int message_id) const noexcept {
+    assert(0 <= rank && rank < npus_count);
+    assert(0 <= step && step < steps_count);
+
+    switch (collective_algorithm) {
+    case CollectiveAlgorithm::Ring: {
+        // pairwise exchange for AllToAll, next NPU otherwise (and previous one, both ways)
+        const auto position = ring_positions[rank];
+        if (collective_type == CollectiveType::AllToAll) {
+            return ring_order[(position + step + 1) % npus_count];
+        }
+        const auto shift = (message_id == 0) ? 1 : (npus_count - 1);
+        return ring_order[(position + shift) % npus_count];
+    }
+    case CollectiveAlgorithm::Direct:
+        return (rank + message_id + 1) % npus_count;
+    case CollectiveAlgorithm::HalvingDoubling: {
+        const auto half_steps_count = (collective_type == CollectiveType::AllReduce) ? (steps_count / 2) : steps_count;
+        const auto halving = (collective_type == CollectiveType::ReduceScatter) ||
+                             (collective_type == CollectiveType::AllReduce && step < half_steps_count);
+        const auto level = step % half_steps_count;
+
+        // halving: farthest peer first, doubling: nearest peer first
+        return halving ? (rank ^ (npus_count >> (level + 1))) : (rank ^ (1 << level));
+    }
+    case CollectiveAlgorithm::Hierarchical: {
+        // NPU along the dimension of the step: the next one in the ring along it,
+        // but for AllToAll (shifted forward, then backward)
+        const auto dim = hierarchical_steps[step].first;
+        const auto dim_size = npus_count_per_dim[dim];
+        const auto stride = stride_per_dim[dim];
+        const auto coordinate = (rank / stride) % dim_size;
+        if (collective_type != CollectiveType::AllToAll) {
+            return rank + ((next_coordinate_per_dim[dim][coordinate] - coordinate) * stride);
+        }
+        const auto shift = (message_id == 0) ? hierarchical_shifts[step] : (dim_size - hierarchical_shifts[step]);
+        const auto peer_coordinate = (coordinate + shift) % dim_size;
+        return rank + ((peer_coordinate - coordinate) * stride);
+    }
+    default:
+        // shouldn't reach here
+        std::exit(-1);
+    }
+}
+
+ChunkSize Collective::get_message_size(const int step) const noexcept {
+    assert(0 <= step && step < steps_count);
+
+    if (collective_algorithm == CollectiveAlgorithm::Hierarchical) {
+        return hierarchical_steps[step].second;
+    }
+
+    const auto shard_size = collective_size / npus_count;
+    if (collective_algorithm != CollectiveAlgorithm::HalvingDoubling) {
+        // half of the shard each way
+        return bidirectional ? (shard_size / 2) : shard_size;
+    }
+
+    const auto half_steps_count = (collective_type == CollectiveType::AllReduce) ? (steps_count / 2) : steps_count;
+    const auto halving = (collective_type == CollectiveType::ReduceScatter) ||
+                         (collective_type == CollectiveType::AllReduce && step < half_steps_count);
+    const auto level = step % half_steps_count;
+
+    // halving sends half of the remaining buffer, doubling sends all gathered so far
+    return halving ? (collective_size >> (level + 1)) : (shard_size << level);
+}
+
+const Route* Collective::symmetric_route(const DeviceId peer) noexcept {
+    assert(symmetric);
+    assert(0 < peer && peer < npus_count);
+
+    auto& route = symmetric_routes[peer];
+    if (route.size() > 0) {
+        return &route;
+    }
+
+    // rotate a device by -shift NPUs (the switch of a Switch stays in place)
+    const auto rotate = [this](const DeviceId device, const DeviceId shift) {
+        return (device < npus_count) ? (device - shift + npus_count) % npus_count : device;
+    };
+
+    // map each hop onto the link of its rotation class starting (or, into an NPU, ending) at rank 0
+    route = topology->route(0, peer);
+    for (auto hop = 0; hop < route.size() - 1; hop++) {
+        const auto& link = topology->get_link(route.link_id(hop));
+        const auto shift = (link.get_src() < npus_count) ? link.get_src() : link.get_dest();
+        const auto link_id = topology->find_link(rotate(link.get_src(), shift), rotate(link.get_dest(), shift));
+        assert(link_id >= 0);
+        route.set_link_id(hop, link_id);
+    }
+    return &route;
+}
+
+int Collective::pair_index(const DeviceId rank, const int chunk_id) const noexcept {
+    assert(0 <= rank && rank < npus_count);
+    assert(0 <= chunk_id && chunk_id < chunks_count);
+
+    return rank * chunks_count + chunk_id;
+}
@@ -0,0 +1,119 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CollectivePlanner.h"
+#include "congestion_aware/Link.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+CollectivePlanner::CollectivePlanner(std::shared_ptr<Topology> topology) noexcept : topology(std::move(topology)) {
+    assert(this->topology != nullptr);
+}
+
+bool CollectivePlanner::applicable(const CollectiveType collective_type,
+                                   const CollectiveAlgorithm collective_algorithm) const noexcept {
+    switch (collective_algorithm) {
+    case CollectiveAlgorithm::HalvingDoubling: {
+        const auto npus_count = topology->get_npus_count();
+        return collective_type != CollectiveType::AllToAll && (npus_count & (npus_count - 1)) == 0;
+    }
+    case CollectiveAlgorithm::Hierarchical:
+        // a single dimension is just a Ring (but for AllToAll, exchanging both ways)
+        return collective_type == CollectiveType::AllToAll || topology->get_dims_count() > 1;
+    default:
+        return true;
+    }
+}
+
+EventTime CollectivePlanner::estimate(const CollectiveType collective_type,
+                                      const CollectiveAlgorithm collective_algorithm,
+                                      const ChunkSize collective_size) const noexcept {
+    assert(applicable(collective_type, collective_algorithm));
+    assert(collective_size > 0);
+
+    // the collective only describes its steps here, it's never started
+    const auto collective = Collective(topology, collective_type, collective_algorithm, collective_size);
+    const auto steps_count = collective.get_steps_count();
+
+    // Ring and Direct steps all look alike (but the pairwise exchange of AllToAll)
+    const auto uniform_steps =
+        (collective_algorithm == CollectiveAlgorithm::Ring || collective_algorithm == CollectiveAlgorithm::Direct);
+    if (uniform_steps && collective_type != CollectiveType::AllToAll) {
+        return (steps_count > 0) ? steps_count * estimate_step(collective, 0) : 0;
+    }
+    auto estimated_time = EventTime(0);
+    for (auto step = 0; step < steps_count; step++) {
+        estimated_time += estimate_step(collective, step);
+    }
+    return estimated_time;
+}
+
+CollectivePlan CollectivePlanner::plan(const CollectiveType collective_type,
+                                       const ChunkSize collective_size) const noexcept {
+    auto collective_plan = CollectivePlan();
+    collective_plan.collective_type = collective_type;
+    collective_plan.collective_size = collective_size;
+
+    for (const auto collective_algorithm : {CollectiveAlgorithm::Ring, CollectiveAlgorithm::Direct,
+                                            CollectiveAlgorithm::HalvingDoubling, CollectiveAlgorithm::Hierarchical}) {
+        if (!applicable(collective_type, collective_algorithm)) {
+            continue;
+        }
+
+        const auto estimated_time = estimate(collective_type, collective_algorithm, collective_size);
+        collective_plan.estimates.emplace_back(collective_algorithm, estimated_time);
+        if (collective_plan.estimates.size() == 1 || estimated_time < collective_plan.estimated_time) {
+            collective_plan.collective_algorithm = collective_algorithm;
+            collective_plan.estimated_time = estimated_time;
+        }
+    }
+
+    return collective_plan;
+}
+
+EventTime CollectivePlanner::estimate_step(const Collective& collective, const int step) const noexcept {
+    const auto npus_count = topology->get_npus_count();
+    const auto message_size = collective.get_message_size(step);
+    const auto fanout = collective.get_fanout(step);
+    link_loads.resize(topology->get_links_count(), 0);
+
+    // the slowest message along its route, and the bytes crossing every link
+    auto slowest_message_time = EventTime(0);
+    auto largest_route_latency = EventTime(0);
+    for (auto rank = 0; rank < npus_count; rank++) {
+        for (auto message_id = 0; message_id < fanout; message_id++) {
+            const auto* const route = topology->shared_route(rank, collective.get_peer(rank, step, message_id));
+            auto message_time = EventTime(0);
+            auto route_latency = EventTime(0);
+            for (auto hop = 0; hop < route->size() - 1; hop++) {
+                const auto link_id = route->link_id(hop);
+                const auto& link = topology->get_link(link_id);
+                message_time += link.communication_delay(message_size);
+                route_latency += link.communication_delay(0);
+                if (link_loads[link_id] == 0) {
+                    loaded_links.push_back(link_id);
+                }
+                link_loads[link_id] += message_size;
+            }
+            slowest_message_time = std::max(slowest_message_time, message_time);
+            largest_route_latency = std::max(largest_route_latency, route_latency);
+        }
+    }
+
+    // the most loaded link serializes every byte crossing it
+    auto busiest_link_time = EventTime(0);
+    for (const auto link_id : loaded_links) {
+        const auto& link = topology->get_link(link_id);
+        busiest_link_time =
+            std::max(busiest_link_time, link.communication_delay(link_loads[link_id]) - link.communication_delay(0));
+        link_loads[link_id] = 0;
+    }
+    loaded_links.clear();
+
+    return std::max(slowest_message_time, busiest_link_time + largest_route_latency);
+}
@@ -0,0 +1,164 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CollectiveTuner.h"
+#include "common/EventQueue.h"
+#include "common/WorkStealingExecutor.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/Helper.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// largest default candidate chunk count
+constexpr int max_default_chunks_count = 64;
+
+/// number of candidates verified by default
+constexpr int default_verified_count = 3;
+
+}  // namespace
+
+CollectiveTuner::CollectiveTuner(NetworkParser network_parser,
+                                 const CollectiveType collective_type,
+                                 const CollectiveAlgorithm collective_algorithm,
+                                 const ChunkSize collective_size) noexcept
+    : network_parser(std::move(network_parser)),
+      collective_type(collective_type),
+      collective_algorithm(collective_algorithm),
+      collective_size(collective_size),
+      verified_count(default_verified_count),
+      topology_setup(nullptr) {
+    assert(collective_size > 0);
+
+    for (auto chunks_count = 1; chunks_count <= max_default_chunks_count && chunks_count <= collective_size;
+         chunks_count *= 2) {
+        chunks_counts.push_back(chunks_count);
+    }
+}
+
+void CollectiveTuner::set_chunks_counts(std::vector<int> new_chunks_counts) noexcept {
+    if (new_chunks_counts.empty()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no candidate chunk count given"
+                  << std::endl;
+        std::exit(-1);
+    }
+    for (const auto chunks_count : new_chunks_counts) {
+        if (chunks_count <= 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "chunk counts should be positive, got " << chunks_count << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    chunks_counts = std::move(new_chunks_counts);
+}
+
+void CollectiveTuner::set_verified_count(const int new_verified_count) noexcept {
+    if (new_verified_count <= 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "at least one candidate should be verified, got " << new_verified_count << std::endl;
+        std::exit(-1);
+    }
+
+    verified_count = new_verified_count;
+}
+
+void CollectiveTuner::set_topology_setup(TopologySetup new_topology_setup) noexcept {
+    topology_setup = std::move(new_topology_setup);
+}
+
+CollectiveTuning CollectiveTuner::tune(const int threads_count) noexcept {
+    assert(threads_count >= 0);
+
+    auto executor = WorkStealingExecutor(threads_count);
+    const auto candidates_count = static_cast<int>(chunks_counts.size());
+
+    // estimate every candidate with the fast model
+    candidates.assign(candidates_count, CollectiveTuning());
+    executor.run(candidates_count, [this](const int candidate) {
+        candidates[candidate].chunks_count = chunks_counts[candidate];
+        candidates[candidate].estimated_time = simulate(chunks_counts[candidate], true);
+    });
+    const auto by_estimated_time = [](const CollectiveTuning& lhs, const CollectiveTuning& rhs) {
+        return std::make_pair(lhs.estimated_time, lhs.chunks_count) <
+               std::make_pair(rhs.estimated_time, rhs.chunks_count);
+    };
+    std::sort(candidates.begin(), candidates.end(), by_estimated_time);
+
+    // verify the best ones by a full simulation,
+    // dropping a candidate as soon as it falls behind the best verified one so far
+    const auto verified_candidates_count = std::min(verified_count, candidates_count);
+    auto best_verified_time = std::atomic<EventTime>(std::numeric_limits<EventTime>::max());
+    executor.run(verified_candidates_count, [&](const int candidate) {
+        auto& tuning = candidates[candidate];
+        const auto time_bound = best_verified_time.load(std::memory_order_relaxed);
+        const auto run = simulate_bounded(tuning.chunks_count, false, time_bound);
+        tuning.verified_time = run.finish_time;
+        tuning.pruned = !run.completed;
+        if (!run.completed) {
+            return;
+        }
+
+        auto best_time = best_verified_time.load(std::memory_order_relaxed);
+        while (run.finish_time < best_time &&
+               !best_verified_time.compare_exchange_weak(best_time, run.finish_time, std::memory_order_relaxed)) {}
+    });
+
+    const auto best = std::min_element(
+        candidates.begin(), candidates.begin() + verified_candidates_count,
+        [](const CollectiveTuning& lhs, const CollectiveTuning& rhs) {
+            return std::make_pair(lhs.verified_time, lhs.chunks_count) <
+                   std::make_pair(rhs.verified_time, rhs.chunks_count);
+        });
+    return *best;
+}
+
+const std::vector<CollectiveTuning>& CollectiveTuner::get_candidates() const noexcept {
+    return candidates;
+}
+
+EventTime CollectiveTuner::simulate(const int chunks_count, const bool fast) const noexcept {
+    const auto run = simulate_bounded(chunks_count, fast, std::numeric_limits<EventTime>::max());
+    assert(run.completed);
+    return run.finish_time;
+}
+
+BoundedRun CollectiveTuner::simulate_bounded(const int chunks_count,
+                                             const bool fast,
+                                             const EventTime time_bound) const noexcept {
+    assert(chunks_count > 0);
+
+    const auto event_queue = std::make_shared<EventQueue>();
+    const auto topology = construct_topology(network_parser, event_queue);
+    if (topology_setup != nullptr) {
+        topology_setup(*topology);
+    }
+
+    auto collective = Collective(topology, collective_type, collective_algorithm, collective_size, chunks_count);
+    if (fast) {
+        topology->set_fast_forward(true);
+        collective.set_symmetric(collective.supports_symmetric());
+    }
+    collective.start();
+    auto bounds = RunBounds();
+    bounds.time_bound = time_bound;
+    auto run = event_queue->run_bounded(bounds);
+
+    // the collective may finish within the bound, with events left past it
+    if (collective.finished()) {
+        run.completed = true;
+        run.finish_time = collective.get_finish_time();
+    }
+    return run;
+}
@@ -0,0 +1,63 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ExecutionTraceAdapter.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+ExecutionTraceAdapter::ExecutionTraceAdapter(std::shared_ptr<Topology> topology,
+                                             const CollectiveAlgorithm collective_algorithm,
+                                             const int chunks_count) noexcept
+    : topology(std::move(topology)),
+      collective_algorithm(collective_algorithm),
+      chunks_count(chunks_count) {
+    assert(this->topology != nullptr);
+    assert(this->topology->get_scheduler() != nullptr);
+    assert(chunks_count > 0);
+}
+
+NetworkScheduler& ExecutionTraceAdapter::get_scheduler() noexcept {
+    return *topology->get_scheduler();
+}
+
+int ExecutionTraceAdapter::get_npus_count() const noexcept {
+    return topology->get_npus_count();
+}
+
+void ExecutionTraceAdapter::send(const DeviceId src,
+                                 const DeviceId dest,
+                                 const ChunkSize size,
+                                 const Callback callback,
+                                 const CallbackArg callback_arg) noexcept {
+    topology->send(size, src, dest, callback, callback_arg);
+}
+
+void ExecutionTraceAdapter::run_collective(const CollectiveType collective_type,
+                                           const ChunkSize size,
+                                           const Callback callback,
+                                           const CallbackArg callback_arg) noexcept {
+    // drop the collectives that finished meanwhile
+    for (const auto finished_collective : finished_collectives) {
+        running_collectives.erase(finished_collective);
+    }
+    finished_collectives.clear();
+
+    auto& running_collective = running_collectives.emplace_back(RunningCollective{
+        this, Collective(topology, collective_type, collective_algorithm, size, chunks_count), callback, callback_arg, {}});
+    running_collective.position = std::prev(running_collectives.end());
+    running_collective.collective.start(collective_finished, static_cast<void*>(&running_collective));
+}
+
+void ExecutionTraceAdapter::collective_finished(void* const running_collective_ptr) noexcept {
+    assert(running_collective_ptr != nullptr);
+
+    // the collective is still unwinding: destroy it later
+    auto* const running_collective = static_cast<RunningCollective*>(running_collective_ptr);
+    running_collective->adapter->finished_collectives.push_back(running_collective->position);
+
+    (*running_collective->callback)(running_collective->callback_arg);
+}
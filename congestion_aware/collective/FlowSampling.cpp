@@ -0,0 +1,140 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/FlowSampling.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <unordered_set>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// two-sided 95% quantiles of Student's t distribution, by degrees of freedom (1 to 30)
+constexpr auto t_quantiles = std::array<double, 30>{
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131,
+    2.120,  2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+/// two-sided 95% quantile of the normal distribution, for more degrees of freedom
+constexpr auto normal_quantile = 1.960;
+
+}  // namespace
+
+FlowSamplingResult FlowSampling::estimate_all_to_all(const TopologyFactory& topology_factory,
+                                                     const ChunkSize flow_size,
+                                                     const FlowSamplingConfig& config,
+                                                     const int threads_count) noexcept {
+    assert(topology_factory != nullptr);
+    assert(flow_size > 0);
+    assert(0 < config.sampling_fraction && config.sampling_fraction <= 1);
+    assert(config.replicas_count >= 2);
+
+    // every src sends to the same number of dests (at least one)
+    const auto npus_count = topology_factory()->get_npus_count();
+    assert(npus_count > 1);
+    const auto dests_count = std::clamp(static_cast<int>(std::lround(config.sampling_fraction * (npus_count - 1))),
+                                        1, npus_count - 1);
+
+    auto result = FlowSamplingResult();
+    result.flows_count = static_cast<uint64_t>(npus_count) * (npus_count - 1);
+    result.sampled_flows_count = static_cast<uint64_t>(npus_count) * dests_count;
+    result.effective_fraction = static_cast<double>(dests_count) / (npus_count - 1);
+    result.sample_finish_times.resize(config.replicas_count);
+
+    // sampled flows serialize as their flow on links scaled down to the fraction
+    const auto sampled_flow_size =
+        static_cast<ChunkSize>(std::llround(static_cast<double>(flow_size) / result.effective_fraction));
+
+    // each sample writes its own slot, so no synchronization is required
+    auto mean_flow_times = std::vector<double>(config.replicas_count);
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(config.replicas_count, [&](const int replica) {
+        // independent simulation: own event queue and topology
+        const auto event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+        const auto topology = topology_factory();
+        assert(topology != nullptr);
+        assert(topology->get_npus_count() == npus_count);
+        topology->attach_event_queue(event_queue);
+
+        auto random_engine = std::mt19937_64(config.seed + replica);
+        auto arrivals = SampleArrivals{event_queue.get(), 0, 0};
+        for (auto src = 0; src < npus_count; src++) {
+            for (const auto dest : sample_dests(npus_count, src, dests_count, random_engine)) {
+                topology->send(sampled_flow_size, src, dest, flow_arrived, &arrivals);
+            }
+        }
+        event_queue->run_to_completion();
+
+        result.sample_finish_times[replica] = arrivals.finish_time;
+        mean_flow_times[replica] = arrivals.arrival_times_sum / static_cast<double>(result.sampled_flows_count);
+    });
+
+    result.finish_time =
+        estimate(std::vector<double>(result.sample_finish_times.begin(), result.sample_finish_times.end()));
+    result.mean_flow_time = estimate(mean_flow_times);
+    return result;
+}
+
+std::vector<DeviceId> FlowSampling::sample_dests(const int npus_count,
+                                                 const DeviceId src,
+                                                 const int dests_count,
+                                                 std::mt19937_64& random_engine) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dests_count && dests_count < npus_count);
+
+    // draw among the npus_count - 1 other NPUs, by index skipping src
+    const auto candidates_count = npus_count - 1;
+    auto drawn = std::unordered_set<int>();
+    drawn.reserve(dests_count);
+    for (auto last = candidates_count - dests_count; last < candidates_count; last++) {
+        const auto index = std::uniform_int_distribution<int>(0, last)(random_engine);
+        drawn.insert(drawn.count(index) > 0 ? last : index);
+    }
+
+    auto dests = std::vector<DeviceId>();
+    dests.reserve(dests_count);
+    for (const auto index : drawn) {
+        dests.push_back((index < src) ? index : index + 1);
+    }
+    std::sort(dests.begin(), dests.end());
+    return dests;
+}
+
+void FlowSampling::flow_arrived(void* const arrivals_ptr) noexcept {
+    assert(arrivals_ptr != nullptr);
+
+    auto& arrivals = *static_cast<SampleArrivals*>(arrivals_ptr);
+    const auto current_time = arrivals.event_queue->get_current_time();
+    arrivals.finish_time = std::max(arrivals.finish_time, current_time);
+    arrivals.arrival_times_sum += static_cast<double>(current_time);
+}
+
+SampledEstimate FlowSampling::estimate(const std::vector<double>& samples) noexcept {
+    assert(samples.size() >= 2);
+
+    const auto samples_count = static_cast<double>(samples.size());
+    auto sum = 0.0;
+    for (const auto sample : samples) {
+        sum += sample;
+    }
+    const auto mean = sum / samples_count;
+
+    // standard error of the mean, from the unbiased sample variance
+    auto squared_deviations_sum = 0.0;
+    for (const auto sample : samples) {
+        squared_deviations_sum += (sample - mean) * (sample - mean);
+    }
+    const auto standard_error = std::sqrt(squared_deviations_sum / (samples_count - 1) / samples_count);
+
+    const auto degrees_of_freedom = samples.size() - 1;
+    const auto quantile =
+        (degrees_of_freedom <= t_quantiles.size()) ? t_quantiles[degrees_of_freedom - 1] : normal_quantile;
+    return {mean, mean - quantile * standard_error, mean + quantile * standard_error};
+}
@@ -0,0 +1,216 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/InjectionPipeline.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+InjectionPipeline::InjectionPipeline(std::shared_ptr<Topology> topology,
+                                     Generator generator,
+                                     const bool precompute_routes,
+                                     const int capacity) noexcept
+    : topology(std::move(topology)),
+      generator(std::move(generator)),
+      precompute_routes(precompute_routes),
+      ring(static_cast<size_t>(capacity)),
+      stop_requested(false),
+      producer_done(false),
+      last_injection_time(0),
+      injected_count(0),
+      delivered_count(0),
+      stalls_count(0),
+      exhausted(false),
+      finish_reported(false),
+      finish_time(0),
+      callback(nullptr),
+      callback_arg(nullptr) {
+    assert(this->topology != nullptr);
+    assert(this->generator != nullptr);
+    assert(capacity > 0);
+}
+
+InjectionPipeline::~InjectionPipeline() noexcept {
+    stop_requested.store(true, std::memory_order_relaxed);
+    if (producer.joinable()) {
+        producer.join();
+    }
+}
+
+void InjectionPipeline::start(const Callback callback, const CallbackArg callback_arg) noexcept {
+    assert(!producer.joinable());
+
+    this->callback = callback;
+    this->callback_arg = callback_arg;
+
+    if (topology->get_scheduler() == nullptr) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "the topology should have a scheduler to run an injection pipeline" << std::endl;
+        std::exit(-1);
+    }
+    if (precompute_routes && !topology->has_fixed_routes()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "routes can only be precomputed by an injection pipeline on topologies with fixed routes"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    producer = std::thread([this] { produce(); });
+    schedule_next_injection();
+}
+
+bool InjectionPipeline::finished() const noexcept {
+    return finish_reported;
+}
+
+EventTime InjectionPipeline::get_finish_time() const noexcept {
+    assert(finished());
+
+    return finish_time;
+}
+
+uint64_t InjectionPipeline::get_injected_count() const noexcept {
+    return injected_count;
+}
+
+uint64_t InjectionPipeline::get_delivered_count() const noexcept {
+    return delivered_count;
+}
+
+uint64_t InjectionPipeline::get_stalls_count() const noexcept {
+    return stalls_count;
+}
+
+void InjectionPipeline::produce() noexcept {
+    auto injection = PipelinedInjection();
+    while (!stop_requested.load(std::memory_order_relaxed) && generator(injection)) {
+        // local injections are delivered at once, without a chunk
+        auto prepared = PreparedInjection{injection, nullptr};
+        const auto npus_count = topology->get_npus_count();
+        const auto valid = 0 <= injection.src && injection.src < npus_count && 0 <= injection.dest &&
+                           injection.dest < npus_count && injection.size > 0;
+        if (precompute_routes && valid && injection.src != injection.dest) {
+            auto route = topology->compute_route(injection.src, injection.dest);
+            prepared.chunk =
+                std::make_unique<Chunk>(injection.size, std::move(route), chunk_delivered, static_cast<void*>(this));
+        }
+
+        // wait for the simulation to catch up
+        while (!ring.try_push(prepared)) {
+            if (stop_requested.load(std::memory_order_relaxed)) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    producer_done.store(true, std::memory_order_release);
+}
+
+void InjectionPipeline::inject_ready(void* const pipeline_ptr) noexcept {
+    assert(pipeline_ptr != nullptr);
+
+    auto* const pipeline = static_cast<InjectionPipeline*>(pipeline_ptr);
+    const auto current_time = pipeline->topology->get_scheduler()->get_current_time();
+
+    // inject every prepared chunk reached by now
+    auto* prepared = pipeline->wait_next();
+    while (prepared != nullptr && prepared->injection.time <= current_time) {
+        pipeline->inject(*prepared);
+        pipeline->ring.pop();
+        prepared = pipeline->wait_next();
+    }
+
+    pipeline->schedule_next_injection();
+}
+
+void InjectionPipeline::chunk_delivered(void* const pipeline_ptr) noexcept {
+    assert(pipeline_ptr != nullptr);
+
+    auto* const pipeline = static_cast<InjectionPipeline*>(pipeline_ptr);
+    pipeline->delivered_count++;
+    pipeline->check_finished();
+}
+
+InjectionPipeline::PreparedInjection* InjectionPipeline::wait_next() noexcept {
+    auto stalled = false;
+    while (true) {
+        auto* const prepared = ring.front();
+        if (prepared != nullptr) {
+            return prepared;
+        }
+
+        // injections pushed before the producer finished are visible once it's seen finished
+        if (producer_done.load(std::memory_order_acquire)) {
+            return ring.front();
+        }
+        if (!stalled) {
+            stalls_count++;
+            stalled = true;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void InjectionPipeline::inject(PreparedInjection& prepared) noexcept {
+    const auto& injection = prepared.injection;
+    const auto npus_count = topology->get_npus_count();
+    if (injection.src < 0 || injection.src >= npus_count || injection.dest < 0 || injection.dest >= npus_count ||
+        injection.size == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "injection pipeline has an invalid injection "
+                  << injection.src << " -> " << injection.dest << " of " << injection.size << " bytes" << std::endl;
+        std::exit(-1);
+    }
+    if (injection.time < last_injection_time) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "injection pipeline injections should be in non-decreasing time order, got " << injection.time
+                  << " after " << last_injection_time << std::endl;
+        std::exit(-1);
+    }
+    last_injection_time = injection.time;
+    injected_count++;
+
+    // local injections are delivered at once
+    if (injection.src == injection.dest) {
+        delivered_count++;
+        return;
+    }
+
+    if (prepared.chunk != nullptr) {
+        topology->send(std::move(prepared.chunk));
+    } else {
+        topology->send(injection.size, injection.src, injection.dest, chunk_delivered, static_cast<void*>(this));
+    }
+}
+
+void InjectionPipeline::schedule_next_injection() noexcept {
+    const auto* const prepared = wait_next();
+    if (prepared == nullptr) {
+        exhausted = true;
+        check_finished();
+        return;
+    }
+
+    // injections before the pipeline started are injected right away
+    const auto scheduler = topology->get_scheduler();
+    const auto inject_time = std::max(prepared->injection.time, scheduler->get_current_time());
+    scheduler->schedule_event(inject_time, inject_ready, static_cast<void*>(this));
+}
+
+void InjectionPipeline::check_finished() noexcept {
+    if (finish_reported || !exhausted || delivered_count < injected_count) {
+        return;
+    }
+
+    finish_reported = true;
+    finish_time = topology->get_scheduler()->get_current_time();
+    if (callback != nullptr) {
+        (*callback)(callback_arg);
+    }
+}
@@ -0,0 +1,241 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SyntheticTraffic.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+void LoadLatencyCurve::write_csv(const std::string& csv_path) const noexcept {
+    auto csv_file = std::ofstream(csv_path);
+    if (!csv_file) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "cannot open " << csv_path << std::endl;
+        std::exit(-1);
+    }
+
+    csv_file << "offered_load,accepted_load,mean_latency,max_latency,measured_chunks" << std::endl;
+    for (const auto& point : points) {
+        csv_file << point.offered_load << "," << point.accepted_load << "," << point.mean_latency << ","
+                 << point.max_latency << "," << point.measured_chunks_count << "\n";
+    }
+}
+
+LoadLatencyCurve SyntheticTraffic::sweep_load(const TopologyFactory& topology_factory,
+                                              const SyntheticTrafficConfig& config,
+                                              std::vector<double> offered_loads,
+                                              const double saturation_latency_factor,
+                                              const int threads_count) noexcept {
+    assert(topology_factory != nullptr);
+    assert(!offered_loads.empty());
+    assert(saturation_latency_factor > 1);
+
+    // each load writes its own point, so no synchronization is required
+    std::sort(offered_loads.begin(), offered_loads.end());
+    auto curve = LoadLatencyCurve{std::vector<LoadLatencyPoint>(offered_loads.size()), -1};
+
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(static_cast<int>(offered_loads.size()), [&](const int point_id) {
+        // independent simulation: own event queue and topology
+        const auto event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(event_queue);
+        const auto topology = topology_factory();
+        assert(topology != nullptr);
+        topology->attach_event_queue(event_queue);
+
+        auto point_config = config;
+        point_config.offered_load = offered_loads[point_id];
+        auto traffic = SyntheticTraffic(topology, point_config);
+        traffic.start();
+        event_queue->run_to_completion();
+        curve.points[point_id] = traffic.get_result();
+    });
+
+    // saturation: latency blows up compared to the lowest load
+    const auto zero_load_latency = curve.points.front().mean_latency;
+    for (const auto& point : curve.points) {
+        if (point.mean_latency > saturation_latency_factor * zero_load_latency) {
+            curve.saturation_load = point.offered_load;
+            break;
+        }
+    }
+
+    return curve;
+}
+
+SyntheticTraffic::SyntheticTraffic(std::shared_ptr<Topology> topology, const SyntheticTrafficConfig& config) noexcept
+    : topology(std::move(topology)),
+      config(config),
+      random_engine(config.seed),
+      measured_chunks_count(0),
+      latency_sum(0),
+      max_latency(0),
+      measured_delivered_bytes(0) {
+    assert(this->topology != nullptr);
+    assert(config.offered_load > 0);
+    assert(config.injection_bandwidth > 0);
+    assert(config.chunk_size > 0);
+    assert(config.measure_time > 0);
+
+    npus_count = this->topology->get_npus_count();
+
+    // NPUs form a square grid unless told otherwise
+    grid_width = config.grid_width;
+    if (grid_width == 0) {
+        grid_width = static_cast<int>(std::lround(std::sqrt(npus_count)));
+        if (grid_width * grid_width != npus_count) {
+            grid_width = npus_count;
+        }
+    }
+    if (grid_width <= 0 || npus_count % grid_width != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "grid width " << grid_width
+                  << " doesn't divide " << npus_count << " NPUs" << std::endl;
+        std::exit(-1);
+    }
+    grid_height = npus_count / grid_width;
+    if (config.pattern == TrafficPattern::Transpose && grid_width != grid_height) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Transpose requires a square grid, got "
+                  << grid_width << "x" << grid_height << std::endl;
+        std::exit(-1);
+    }
+    assert(0 <= config.hotspot && config.hotspot < npus_count);
+
+    // a chunk per slot saturates the injection bandwidth
+    const auto injection_bandwidth_Bpns = bw_GBps_to_Bpns(config.injection_bandwidth);
+    slot_time = std::max(ns_to_ticks(static_cast<double>(config.chunk_size) / injection_bandwidth_Bpns),
+                         static_cast<EventTime>(1));
+
+    sources.reserve(npus_count);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        sources.push_back({this, npu});
+    }
+}
+
+void SyntheticTraffic::start() noexcept {
+    const auto scheduler = topology->get_scheduler();
+    assert(scheduler != nullptr);
+
+    const auto current_time = scheduler->get_current_time();
+    for (auto& source : sources) {
+        scheduler->schedule_event(current_time + next_interarrival_time(), inject, &source);
+    }
+}
+
+DeviceId SyntheticTraffic::pick_dest(const DeviceId src) noexcept {
+    assert(0 <= src && src < npus_count);
+
+    const auto x = src % grid_width;
+    const auto y = src / grid_width;
+    switch (config.pattern) {
+    case TrafficPattern::UniformRandom:
+        return uniform_dest(src);
+    case TrafficPattern::Transpose:
+        return x * grid_width + y;
+    case TrafficPattern::BitComplement:
+        return npus_count - 1 - src;
+    case TrafficPattern::Tornado: {
+        const auto dest_x = (x + (grid_width + 1) / 2 - 1) % grid_width;
+        const auto dest_y = (y + (grid_height + 1) / 2 - 1) % grid_height;
+        return dest_y * grid_width + dest_x;
+    }
+    case TrafficPattern::Hotspot: {
+        auto distribution = std::bernoulli_distribution(config.hotspot_fraction);
+        return (distribution(random_engine) && src != config.hotspot) ? config.hotspot : uniform_dest(src);
+    }
+    default:
+        // shouldn't reach here
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported traffic pattern"
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+LoadLatencyPoint SyntheticTraffic::get_result() const noexcept {
+    // accepted load relative to the injection bandwidth of every NPU over the measurement
+    const auto injection_bandwidth_Bptick = bw_GBps_to_Bpns(config.injection_bandwidth) / ticks_per_ns;
+    const auto capacity = injection_bandwidth_Bptick * static_cast<double>(config.measure_time) * npus_count;
+    const auto mean_latency =
+        (measured_chunks_count > 0) ? latency_sum / static_cast<double>(measured_chunks_count) : 0.0;
+
+    return LoadLatencyPoint{config.offered_load, static_cast<double>(measured_delivered_bytes) / capacity,
+                            mean_latency, max_latency, measured_chunks_count};
+}
+
+void SyntheticTraffic::inject(void* const source_ptr) noexcept {
+    assert(source_ptr != nullptr);
+
+    const auto& source = *static_cast<Source*>(source_ptr);
+    auto* const traffic = source.traffic;
+    const auto scheduler = traffic->topology->get_scheduler();
+    const auto current_time = scheduler->get_current_time();
+
+    // injection stops once the measurement is over
+    const auto& config = traffic->config;
+    if (current_time >= config.warmup_time + config.measure_time) {
+        return;
+    }
+
+    // NPUs the pattern maps to themselves skip their slot
+    const auto dest = traffic->pick_dest(source.npu);
+    if (dest != source.npu) {
+        traffic->topology->send_with_payload(config.chunk_size, source.npu, dest, chunk_delivered,
+                                             Delivery{traffic, current_time});
+    }
+    scheduler->schedule_event(current_time + traffic->next_interarrival_time(), inject, source_ptr);
+}
+
+void SyntheticTraffic::chunk_delivered(void* const delivery_ptr) noexcept {
+    assert(delivery_ptr != nullptr);
+
+    const auto& delivery = *static_cast<const Delivery*>(delivery_ptr);
+    auto* const traffic = delivery.traffic;
+    const auto& config = traffic->config;
+    const auto current_time = traffic->topology->get_scheduler()->get_current_time();
+    const auto measure_end_time = config.warmup_time + config.measure_time;
+
+    // latency of the chunks injected during the measurement
+    if (config.warmup_time <= delivery.inject_time && delivery.inject_time < measure_end_time) {
+        const auto latency = current_time - delivery.inject_time;
+        traffic->measured_chunks_count++;
+        traffic->latency_sum += static_cast<double>(latency);
+        traffic->max_latency = std::max(traffic->max_latency, latency);
+    }
+
+    // throughput of the chunks delivered during the measurement
+    if (config.warmup_time <= current_time && current_time < measure_end_time) {
+        traffic->measured_delivered_bytes += config.chunk_size;
+    }
+}
+
+EventTime SyntheticTraffic::next_interarrival_time() noexcept {
+    if (config.injection_process == InjectionProcess::Bernoulli) {
+        // number of slots up to the next successful trial
+        if (config.offered_load >= 1) {
+            return slot_time;
+        }
+        auto distribution = std::geometric_distribution<EventTime>(config.offered_load);
+        return (distribution(random_engine) + 1) * slot_time;
+    }
+
+    auto distribution = std::exponential_distribution<double>(config.offered_load / static_cast<double>(slot_time));
+    return std::max(static_cast<EventTime>(std::llround(distribution(random_engine))), static_cast<EventTime>(1));
+}
+
+DeviceId SyntheticTraffic::uniform_dest(const DeviceId src) noexcept {
+    assert(npus_count > 1);
+
+    // draw among the other NPUs
+    auto distribution = std::uniform_int_distribution<DeviceId>(0, npus_count - 2);
+    const auto dest = distribution(random_engine);
+    return (dest >= src) ? dest + 1 : dest;
+}
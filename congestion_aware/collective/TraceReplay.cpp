@@ -0,0 +1,275 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/TraceReplay.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+void TraceReplay::write_trace(const std::string& trace_path, const std::vector<TraceRecord>& records) noexcept {
+    auto trace_file = std::ofstream(trace_path, std::ios::binary | std::ios::trunc);
+    if (!trace_file) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "cannot open trace file " << trace_path
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    const auto header = TraceHeader{TraceHeader::trace_magic, records.size()};
+    trace_file.write(reinterpret_cast<const char*>(&header), sizeof(TraceHeader));
+    trace_file.write(reinterpret_cast<const char*>(records.data()),
+                     static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+}
+
+TraceReplay::TraceReplay(std::shared_ptr<Topology> topology, const std::string& trace_path) noexcept
+    : topology(std::move(topology)),
+      trace_path(trace_path),
+      mapped_trace(nullptr),
+      mapped_size(0),
+      records(nullptr),
+      records_count(0),
+      next_record(0),
+      delivered_count(0),
+      finish_time(0),
+      job_id(0),
+      callback(nullptr),
+      callback_arg(nullptr) {
+    assert(this->topology != nullptr);
+
+    // map the whole trace file; pages are read in as the replay reaches them
+    const auto trace_fd = open(trace_path.c_str(), O_RDONLY);
+    if (trace_fd < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "cannot open trace file " << trace_path
+                  << std::endl;
+        std::exit(-1);
+    }
+    struct stat trace_stat {};
+    if (fstat(trace_fd, &trace_stat) != 0 || static_cast<size_t>(trace_stat.st_size) < sizeof(TraceHeader)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace file " << trace_path
+                  << " has no header" << std::endl;
+        std::exit(-1);
+    }
+    mapped_size = static_cast<size_t>(trace_stat.st_size);
+    mapped_trace = mmap(nullptr, mapped_size, PROT_READ, MAP_PRIVATE, trace_fd, 0);
+    close(trace_fd);
+    if (mapped_trace == MAP_FAILED) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "cannot map trace file " << trace_path
+                  << std::endl;
+        std::exit(-1);
+    }
+    madvise(mapped_trace, mapped_size, MADV_SEQUENTIAL);
+
+    // check the header
+    const auto* const header = static_cast<const TraceHeader*>(mapped_trace);
+    if (header->magic != TraceHeader::trace_magic ||
+        header->records_count != (mapped_size - sizeof(TraceHeader)) / sizeof(TraceRecord)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace file " << trace_path
+                  << " is not a valid trace" << std::endl;
+        std::exit(-1);
+    }
+    records_count = header->records_count;
+    records = reinterpret_cast<const TraceRecord*>(header + 1);
+
+    // 1 bit per record
+    delivered.assign((records_count + 63) / 64, 0);
+}
+
+TraceReplay::~TraceReplay() noexcept {
+    if (mapped_trace != nullptr) {
+        munmap(mapped_trace, mapped_size);
+    }
+}
+
+void TraceReplay::start(const Callback callback, const CallbackArg callback_arg) noexcept {
+    this->callback = callback;
+    this->callback_arg = callback_arg;
+
+    if (topology->get_scheduler() == nullptr) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "the topology should have a scheduler to replay a trace" << std::endl;
+        std::exit(-1);
+    }
+
+    // an empty trace finishes right away
+    if (records_count == 0) {
+        finish_time = topology->get_scheduler()->get_current_time();
+        if (callback != nullptr) {
+            (*callback)(callback_arg);
+        }
+        return;
+    }
+
+    schedule_next_injection();
+}
+
+void TraceReplay::set_job_id(const int new_job_id) noexcept {
+    assert(0 <= new_job_id && new_job_id < Chunk::max_jobs_count);
+
+    job_id = new_job_id;
+}
+
+bool TraceReplay::finished() const noexcept {
+    return delivered_count == records_count;
+}
+
+EventTime TraceReplay::get_finish_time() const noexcept {
+    assert(finished());
+
+    return finish_time;
+}
+
+uint64_t TraceReplay::get_records_count() const noexcept {
+    return records_count;
+}
+
+uint64_t TraceReplay::get_delivered_count() const noexcept {
+    return delivered_count;
+}
+
+int TraceReplay::get_peak_in_flight_messages_count() const noexcept {
+    return static_cast<int>(messages.size());
+}
+
+void TraceReplay::inject_records(void* const trace_replay_ptr) noexcept {
+    assert(trace_replay_ptr != nullptr);
+
+    auto* const trace_replay = static_cast<TraceReplay*>(trace_replay_ptr);
+    const auto current_time = trace_replay->topology->get_scheduler()->get_current_time();
+
+    // inject every record reached by now
+    while (trace_replay->next_record < trace_replay->records_count &&
+           trace_replay->records[trace_replay->next_record].inject_time <= current_time) {
+        trace_replay->inject_record(trace_replay->next_record);
+        trace_replay->next_record++;
+    }
+
+    trace_replay->schedule_next_injection();
+}
+
+void TraceReplay::message_delivered(void* const message_ptr) noexcept {
+    assert(message_ptr != nullptr);
+
+    // recycle the message
+    auto* const message = static_cast<Message*>(message_ptr);
+    auto* const trace_replay = message->trace_replay;
+    const auto record_index = message->record_index;
+    trace_replay->free_messages.push_back(message);
+
+    trace_replay->deliver_record(record_index);
+}
+
+void TraceReplay::schedule_next_injection() noexcept {
+    if (next_record >= records_count) {
+        return;
+    }
+
+    // records are sorted by inject time
+    const auto& record = records[next_record];
+    if (next_record > 0 && record.inject_time < records[next_record - 1].inject_time) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace file " << trace_path
+                  << " is not sorted by inject time at record " << next_record << std::endl;
+        std::exit(-1);
+    }
+
+    // records before the replay started are injected right away
+    const auto scheduler = topology->get_scheduler();
+    const auto inject_time = std::max(record.inject_time, scheduler->get_current_time());
+    scheduler->schedule_event(inject_time, inject_records, static_cast<void*>(this));
+}
+
+void TraceReplay::inject_record(const uint64_t record_index) noexcept {
+    assert(record_index < records_count);
+
+    const auto& record = records[record_index];
+    const auto npus_count = topology->get_npus_count();
+    if (record.src < 0 || record.src >= npus_count || record.dest < 0 || record.dest >= npus_count ||
+        record.size == 0 || record.dependency < TraceRecord::no_dependency ||
+        record.dependency >= static_cast<int64_t>(record_index)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "trace file " << trace_path
+                  << " has an invalid record " << record_index << std::endl;
+        std::exit(-1);
+    }
+
+    // wait for the dependency to be delivered
+    if (record.dependency != TraceRecord::no_dependency) {
+        const auto dependency = static_cast<uint64_t>(record.dependency);
+        if (!record_delivered(dependency)) {
+            waiting_records[dependency].push_back(record_index);
+            return;
+        }
+    }
+
+    send_record(record_index);
+}
+
+void TraceReplay::send_record(const uint64_t record_index) noexcept {
+    const auto& record = records[record_index];
+
+    // local messages are delivered at once
+    if (record.src == record.dest) {
+        deliver_record(record_index);
+        return;
+    }
+
+    // take a message slot
+    auto* message = static_cast<Message*>(nullptr);
+    if (!free_messages.empty()) {
+        message = free_messages.back();
+        free_messages.pop_back();
+    } else {
+        message = &messages.emplace_back();
+    }
+    *message = Message{this, record_index};
+
+    topology->send(record.size, record.src, record.dest, message_delivered, static_cast<void*>(message), 0, job_id);
+}
+
+void TraceReplay::deliver_record(const uint64_t record_index) noexcept {
+    // delivering a local message may deliver its waiting records in turn
+    auto delivered_records = std::vector<uint64_t>{record_index};
+    while (!delivered_records.empty()) {
+        const auto delivered_record = delivered_records.back();
+        delivered_records.pop_back();
+
+        assert(!record_delivered(delivered_record));
+        delivered[delivered_record / 64] |= static_cast<uint64_t>(1) << (delivered_record % 64);
+        delivered_count++;
+
+        // inject the records waiting for it
+        const auto waiting = waiting_records.find(delivered_record);
+        if (waiting != waiting_records.end()) {
+            const auto waiting_indices = std::move(waiting->second);
+            waiting_records.erase(waiting);
+            for (const auto waiting_index : waiting_indices) {
+                if (records[waiting_index].src == records[waiting_index].dest) {
+                    delivered_records.push_back(waiting_index);
+                } else {
+                    send_record(waiting_index);
+                }
+            }
+        }
+    }
+
+    if (finished()) {
+        finish_time = topology->get_scheduler()->get_current_time();
+        if (callback != nullptr) {
+            (*callback)(callback_arg);
+        }
+    }
+}
+
+bool TraceReplay::record_delivered(const uint64_t record_index) const noexcept {
+    assert(record_index < records_count);
+
+    return (delivered[record_index / 64] >> (record_index % 64)) & 1;
+}
@@ -0,0 +1,151 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/TrafficSource.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+AllToAllSource::AllToAllSource(const DeviceId rank,
+                               const int npus_count,
+                               const ChunkSize message_size,
+                               const int chunks_count) noexcept
+    : rank(rank),
+      npus_count(npus_count),
+      chunk_size(message_size / chunks_count),
+      chunks_count(chunks_count),
+      next_chunk(0) {
+    assert(0 <= rank && rank < npus_count);
+    assert(chunks_count > 0);
+    assert(chunk_size > 0);
+}
+
+bool AllToAllSource::pull(DeviceId& dest, ChunkSize& chunk_size) noexcept {
+    // every chunk of the message to rank + 1, then to rank + 2, ...
+    if (next_chunk == static_cast<int64_t>(npus_count - 1) * chunks_count) {
+        return false;
+    }
+    const auto step = static_cast<int>(next_chunk / chunks_count);
+    next_chunk++;
+
+    dest = (rank + step + 1) % npus_count;
+    chunk_size = this->chunk_size;
+    return true;
+}
+
+TrafficInjector::TrafficInjector(std::shared_ptr<Topology> topology, const int window_size) noexcept
+    : topology(std::move(topology)),
+      window_size(window_size),
+      active_sources_count(0),
+      in_flight_chunks_count(0),
+      peak_in_flight_chunks_count(0),
+      delivered_chunks_count(0),
+      started(false),
+      finish_time(0),
+      callback(nullptr),
+      callback_arg(nullptr) {
+    assert(this->topology != nullptr);
+    assert(window_size > 0);
+
+    // every NPU starts without a source
+    const auto npus_count = this->topology->get_npus_count();
+    injectors.reserve(npus_count);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        injectors.push_back({this, npu, nullptr, 0, true});
+    }
+}
+
+void TrafficInjector::set_source(const DeviceId npu, std::unique_ptr<TrafficSource> source) noexcept {
+    assert(0 <= npu && npu < static_cast<DeviceId>(injectors.size()));
+    assert(source != nullptr);
+    assert(!started);
+
+    auto& injector = injectors[npu];
+    if (injector.exhausted) {
+        active_sources_count++;
+    }
+    injector.source = std::move(source);
+    injector.exhausted = false;
+}
+
+void TrafficInjector::start(const Callback callback, const CallbackArg callback_arg) noexcept {
+    assert(!started);
+
+    this->callback = callback;
+    this->callback_arg = callback_arg;
+    started = true;
+
+    // every NPU injects up to its window
+    for (auto& injector : injectors) {
+        fill_window(injector);
+    }
+    check_finished();
+}
+
+bool TrafficInjector::finished() const noexcept {
+    return started && active_sources_count == 0 && in_flight_chunks_count == 0;
+}
+
+EventTime TrafficInjector::get_finish_time() const noexcept {
+    assert(finished());
+
+    return finish_time;
+}
+
+uint64_t TrafficInjector::get_delivered_chunks_count() const noexcept {
+    return delivered_chunks_count;
+}
+
+int TrafficInjector::get_peak_in_flight_chunks_count() const noexcept {
+    return peak_in_flight_chunks_count;
+}
+
+void TrafficInjector::chunk_delivered(void* const injector_ptr) noexcept {
+    assert(injector_ptr != nullptr);
+
+    auto& injector = *static_cast<Injector*>(injector_ptr);
+    auto* const traffic_injector = injector.traffic_injector;
+    assert(injector.in_flight_chunks_count > 0);
+
+    // the delivered chunk makes room for the next one of its NPU
+    injector.in_flight_chunks_count--;
+    traffic_injector->in_flight_chunks_count--;
+    traffic_injector->delivered_chunks_count++;
+    traffic_injector->fill_window(injector);
+    traffic_injector->check_finished();
+}
+
+void TrafficInjector::fill_window(Injector& injector) noexcept {
+    while (!injector.exhausted && injector.in_flight_chunks_count < window_size) {
+        auto dest = DeviceId();
+        auto chunk_size = ChunkSize();
+        if (!injector.source->pull(dest, chunk_size)) {
+            // the source is done, and can be dropped
+            injector.exhausted = true;
+            injector.source.reset();
+            active_sources_count--;
+            break;
+        }
+
+        injector.in_flight_chunks_count++;
+        in_flight_chunks_count++;
+        peak_in_flight_chunks_count = std::max(peak_in_flight_chunks_count, in_flight_chunks_count);
+        topology->send(chunk_size, injector.npu, dest, chunk_delivered, &injector);
+    }
+}
+
+void TrafficInjector::check_finished() noexcept {
+    if (!finished()) {
+        return;
+    }
+
+    const auto scheduler = topology->get_scheduler();
+    finish_time = (scheduler != nullptr) ? scheduler->get_current_time() : 0;
+    if (callback != nullptr) {
+        (*callback)(callback_arg);
+    }
+}
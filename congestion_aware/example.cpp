@@ -3,65 +3,254 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/CommandLine.h"
 #include "common/EventQueue.h"
+#include "common/ExecutionTrace.h"
+#include "common/JsonObject.h"
+#include "common/NetworkDownscaling.h"
 #include "common/NetworkParser.h"
-#include "congestion_aware/Chunk.h"
+#include "common/Profiler.h"
+#include "common/ResultCache.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/CollectivePlanner.h"
+#include "congestion_aware/ExecutionTraceAdapter.h"
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/SteadyState.h"
+#include "congestion_aware/TraceReplay.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-void chunk_arrived_callback(void* const event_queue_ptr) {
-    // typecast event_queue_ptr
-    auto* const event_queue = static_cast<EventQueue*>(event_queue_ptr);
+namespace {
 
-    // print chunk arrival time
-    const auto current_time = event_queue->get_current_time();
-    std::cout << "A chunk arrived at destination at time: " << current_time << " ns" << std::endl;
+/// usage of the driver
+constexpr const char* usage = R"(Usage: Analytical_Congestion_Aware [options]
+Simulates a workload on a network and prints the results as JSON.
+
+Network:
+  --network PATH           network config (default: ../input/Ring.yml)
+  --downscale NPUS         simulate a similarity-scaled instance of the network of about NPUS NPUs
+                           (see downscale_network), the collective size scaled along (collectives only)
+
+Workload (a collective unless a trace is given):
+  --collective TYPE        AllGather (default), ReduceScatter, AllReduce, or AllToAll
+  --algorithm ALGORITHM    Ring, Direct (default), HalvingDoubling, Hierarchical,
+                           or Auto (selected by CollectivePlanner)
+  --size BYTES             collective size (default: 16777216)
+  --chunks COUNT           chunks each collective message is split into (default: 1)
+  --iterations COUNT       collective iterations, back to back; once they converge (see SteadyState),
+                           the remaining ones are extrapolated (default: 1)
+  --trace PATH             binary message trace to replay (see TraceReplay)
+  --execution-trace PREFIX execution traces PREFIX.<NPU>.txt to replay (see ExecutionTraceReader)
+
+Engine:
+  --event-queue TYPE       List, Heap (default), or TimingWheel
+  --threads COUNT          threads invoking same-time events of different links concurrently (default: 1)
+  --time-quantum NS        approximate simulation: event times rounded up to multiples of NS,
+                           chunks arriving together coalesced, reporting the assumed error bound
+
+Output:
+  --output PATH            JSON results file (default: stdout)
+  --cache DIR              result cache: a workload simulated before on the same network is read from it)";
+
+/// seconds elapsed since a start time
+double seconds_since(const std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 }
 
-int main() {
-    // Instantiate shared resources
-    const auto event_queue = std::make_shared<EventQueue>();
-    Topology::set_event_queue(event_queue);
-
-    // Parse network config and create topology
-    const auto network_parser = NetworkParser("../input/Ring.yml");
-    const auto topology = construct_topology(network_parser);
-    const auto npus_count = topology->get_npus_count();
-    const auto devices_count = topology->get_devices_count();
-
-    // message settings
-    const auto chunk_size = 1'048'576;  // 1 MB
-
-    // Run All-Gather
-    for (int i = 0; i < npus_count; i++) {
-        for (int j = 0; j < npus_count; j++) {
-            if (i == j) {
-                continue;
+}  // namespace
+
+int main(const int argc, const char* const argv[]) {
+    const auto command_line = CommandLine(argc, argv,
+                                          {"network", "downscale", "collective", "algorithm", "size", "chunks",
+                                           "iterations", "trace", "execution-trace", "event-queue", "threads",
+                                           "time-quantum", "output", "cache"},
+                                          usage);
+    const auto network_path = command_line.get_string("network", "../input/Ring.yml");
+    const auto output_path = command_line.get_string("output", "");
+    const auto threads_count = static_cast<int>(command_line.get_uint64("threads", 1));
+
+    // Instantiate the event queue, parse network config and create topology
+    const auto setup_start = std::chrono::steady_clock::now();
+    const auto event_queue = std::make_shared<EventQueue>(
+        command_line.get_event_queue_type("event-queue", EventQueueType::Heap));
+    if (threads_count > 1) {
+        // only events of registered kinds are invoked concurrently (the same setup as the ParallelEventInvocation test)
+        Topology::register_event_resources(*event_queue);
+        event_queue->set_parallel_invocation(threads_count);
+    }
+    auto network_parser = NetworkParser(network_path);
+    auto downscaled = std::optional<DownscaledNetwork>();
+    if (command_line.has("downscale")) {
+        if (command_line.has("trace") || command_line.has("execution-trace")) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Only collectives can be downscaled"
+                      << std::endl;
+            std::exit(-1);
+        }
+        downscaled = downscale_network(network_parser, static_cast<int>(command_line.get_uint64("downscale", 0)));
+        network_parser = NetworkParser(downscaled->network_config);
+    }
+    const auto topology = construct_topology(network_parser, event_queue);
+    const auto time_quantum_ns = command_line.get_uint64("time-quantum", 0);
+    if (time_quantum_ns > 0) {
+        event_queue->set_time_quantum(std::max(ns_to_ticks(static_cast<double>(time_quantum_ns)), EventTime(1)));
+        topology->set_chunk_coalescing(true);
+    }
+    const auto setup_seconds = seconds_since(setup_start);
+
+    // Describe the workload (also keying the result cache)
+    auto workload = JsonObject();
+    auto collective_size = command_line.get_uint64("size", 16 * 1'048'576);  // 16 MB
+    if (downscaled.has_value()) {
+        collective_size = static_cast<uint64_t>(std::llround(static_cast<double>(collective_size) *
+                                                             downscaled->buffer_size_scale));
+    }
+    const auto chunks_count = static_cast<int>(command_line.get_uint64("chunks", 1));
+    const auto iterations_count = static_cast<int64_t>(command_line.get_uint64("iterations", 1));
+    const auto trace_path = command_line.get_string("trace", "");
+    const auto trace_prefix = command_line.get_string("execution-trace", "");
+    auto trace_paths = std::vector<std::string>();
+    if (!trace_path.empty()) {
+        workload.add("type", "trace").add("path", trace_path);
+        workload.add("contents_hash", ResultCache::hash_file(trace_path));
+    } else if (!trace_prefix.empty()) {
+        workload.add("type", "execution_trace").add("prefix", trace_prefix);
+        auto contents_hashes = JsonObject();
+        for (auto npu = 0; npu < topology->get_npus_count(); npu++) {
+            trace_paths.push_back(trace_prefix + "." + std::to_string(npu) + ".txt");
+            contents_hashes.add(std::to_string(npu), ResultCache::hash_file(trace_paths.back()));
+        }
+        workload.add("contents_hashes", contents_hashes);
+    } else {
+        workload.add("type", "collective").add("collective", command_line.get_string("collective", "AllGather"));
+        workload.add("algorithm", command_line.get_string("algorithm", "Direct")).add("size", collective_size);
+        workload.add("chunks", chunks_count).add("iterations", iterations_count);
+    }
+    if (time_quantum_ns > 0) {
+        workload.add("time_quantum_ns", time_quantum_ns);
+    }
+
+    // Simulate the workload
+    auto simulation_seconds = 0.0;
+    const auto simulate = [&]() {
+        auto result = CachedResult();
+        const auto simulation_start = std::chrono::steady_clock::now();
+        if (!trace_path.empty()) {
+            // Replay a binary message trace
+            auto trace_replay = TraceReplay(topology, trace_path);
+            trace_replay.start();
+            result.finish_time = event_queue->run_to_completion();
+            result.stats["messages_delivered"] = trace_replay.get_delivered_count();
+        } else if (!trace_prefix.empty()) {
+            // Replay an execution trace per NPU
+            auto network = ExecutionTraceAdapter(topology);
+            auto replay = ExecutionTraceReplay(network, trace_paths);
+            replay.start();
+            result.finish_time = event_queue->run_to_completion();
+            if (!replay.finished()) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) " << "Execution traces of "
+                          << trace_prefix << " stalled" << std::endl;
+                std::exit(-1);
+            }
+            result.stats["nodes_completed"] = replay.get_completed_nodes_count();
+        } else {
+            // Run the collective iteration after iteration, extrapolating the rest once they converge
+            const auto collective_type = command_line.get_collective_type("collective", CollectiveType::AllGather);
+            const auto collective_algorithm =
+                (command_line.get_string("algorithm", "Direct") == "Auto")
+                    ? CollectivePlanner(topology).plan(collective_type, collective_size).collective_algorithm
+                    : command_line.get_collective_algorithm("algorithm", CollectiveAlgorithm::Direct);
+            auto steady_state = SteadyState(topology);
+            for (auto iteration = int64_t(0); iteration < iterations_count; iteration++) {
+                auto collective =
+                    Collective(topology, collective_type, collective_algorithm, collective_size, chunks_count);
+                collective.start();
+                result.finish_time = event_queue->run_to_completion();
+                if (steady_state.end_iteration(result.finish_time)) {
+                    result.finish_time = steady_state.extrapolate(iterations_count - iteration - 1);
+                    break;
+                }
             }
+            result.stats["simulated_iterations"] = steady_state.get_iterations_count();
+        }
+        simulation_seconds = seconds_since(simulation_start);
 
-            // crate a chunk
-            auto route = topology->route(i, j);
-            auto* event_queue_ptr = static_cast<void*>(event_queue.get());
-            auto chunk = std::make_unique<Chunk>(chunk_size, route, chunk_arrived_callback, event_queue_ptr);
+        // Timing error bound assumed by the time quantum (parts per million)
+        if (time_quantum_ns > 0) {
+            result.stats["time_error_bound_ppm"] =
+                static_cast<uint64_t>(std::llround(event_queue->get_time_error_bound() * 1e6));
+        }
 
-            // send a chunk
-            topology->send(std::move(chunk));
+        // Simulation statistics (if collected)
+        if constexpr (stats_enabled) {
+            const auto& stats = event_queue->get_stats();
+            result.stats["events_scheduled"] = stats.events_scheduled;
+            result.stats["events_processed"] = stats.events_processed;
+            result.stats["chunks_delivered"] = topology->get_chunk_stats().chunks_delivered;
         }
+        return result;
+    };
+
+    // Read the result from the cache if simulated before
+    auto result = CachedResult();
+    auto cached = false;
+    if (command_line.has("cache")) {
+        auto result_cache = ResultCache(command_line.get_string("cache", ""));
+        result = result_cache.get_or_simulate(ResultCache::make_key(network_parser, workload.str()), simulate);
+        cached = (result_cache.get_hits_count() > 0);
+    } else {
+        result = simulate();
     }
 
-    // Run simulation
-    while (!event_queue->finished()) {
-        event_queue->proceed();
+    // Report simulation result
+    const auto finish_time = result.finish_time;
+    auto results = JsonObject();
+    results.add("backend", "congestion_aware").add("network", network_path).add("workload", workload);
+    results.add("npus_count", topology->get_npus_count()).add("devices_count", topology->get_devices_count());
+    if (downscaled.has_value()) {
+        auto downscaling = JsonObject();
+        downscaling.add("full_npus_count", downscaled->full_npus_count).add("npus_scale", downscaled->npus_scale);
+        downscaling.add("message_size_scale", downscaled->message_size_scale);
+        downscaling.add("buffer_size_scale", downscaled->buffer_size_scale);
+        results.add("downscaling", downscaling);
+    }
+    results.add("finish_time", finish_time).add("time_unit", time_unit).add("finish_time_ns", ticks_to_ns(finish_time));
+    for (const auto& [name, value] : result.stats) {
+        results.add(name, value);
+    }
+    results.add("cached", cached).add("setup_seconds", setup_seconds).add("simulation_seconds", simulation_seconds);
+    results.add("stats_enabled", stats_enabled);
+    if (stats_enabled && !cached) {
+        const auto events_processed = static_cast<double>(result.stats["events_processed"]);
+        results.add("events_per_second", events_processed / simulation_seconds);
+    }
+
+    if (output_path.empty()) {
+        std::cout << results.str() << std::endl;
+    } else {
+        auto output_file = std::ofstream(output_path);
+        if (!(output_file << results.str() << std::endl)) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Cannot write " << output_path
+                      << std::endl;
+            std::exit(-1);
+        }
     }
 
-    // Print simulation result
-    const auto finish_time = event_queue->get_current_time();
-    std::cout << "Total NPUs Count: " << npus_count << std::endl;
-    std::cout << "Total devices Count: " << devices_count << std::endl;
-    std::cout << "Simulation finished at time: " << finish_time << " ns" << std::endl;
+    // Time spent per zone of the simulator (if profiled), apart from the results
+    if (profiling_enabled && !cached) {
+        Profiler::report(std::cerr);
+    }
 
     return 0;
 }
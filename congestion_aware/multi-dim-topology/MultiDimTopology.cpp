@@ -0,0 +1,253 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/MultiDimTopology.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+MultiDimTopology::MultiDimTopology(std::vector<std::unique_ptr<BasicTopology>> topology_per_dim,
+                                   std::vector<DimFidelity> fidelity_per_dim) noexcept
+    : topology_per_dim(std::move(topology_per_dim)),
+      fidelity_per_dim(std::move(fidelity_per_dim)),
+      Topology() {
+    // check the number of dimensions
+    dims_count = static_cast<int>(this->topology_per_dim.size());
+    if (dims_count <= 0 || dims_count > max_dims_count) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "multi-dim topology requires 1 to "
+                  << max_dims_count << " dimensions" << std::endl;
+        std::exit(-1);
+    }
+
+    // every dimension is congestion-aware unless specified
+    if (this->fidelity_per_dim.empty()) {
+        this->fidelity_per_dim.resize(dims_count, DimFidelity::CongestionAware);
+    }
+    if (this->fidelity_per_dim.size() != dims_count) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "multi-dim topology has " << dims_count
+                  << " dimensions, but " << this->fidelity_per_dim.size() << " fidelities" << std::endl;
+        std::exit(-1);
+    }
+
+    // setup npus count and strides
+    npus_count = 1;
+    for (const auto& topology : this->topology_per_dim) {
+        assert(topology != nullptr);
+
+        const auto topology_size = topology->get_npus_count();
+        stride_per_dim.push_back(npus_count);
+        npus_count *= topology_size;
+
+        npus_count_per_dim.push_back(topology_size);
+        bandwidth_per_dim.push_back(topology->get_bandwidth_per_dim()[0]);
+    }
+
+    // non-NPU devices of every slice are placed after the NPUs
+    devices_count = npus_count;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto topology_size = npus_count_per_dim[dim];
+        // ClosedForm dimensions connect NPUs directly
+        const auto closed_form = (this->fidelity_per_dim[dim] == DimFidelity::ClosedForm);
+        const auto extra_devices_count =
+            closed_form ? 0 : this->topology_per_dim[dim]->get_devices_count() - topology_size;
+        const auto slices_count = npus_count / topology_size;
+
+        extra_devices_count_per_dim.push_back(extra_devices_count);
+        extra_devices_offset_per_dim.push_back(devices_count);
+        devices_count += slices_count * extra_devices_count;
+    }
+
+    // replicate links
+    links.reserve(expected_links_count());
+    connect_slices();
+}
+
+Route MultiDimTopology::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    // assert npus are in valid range
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // construct route, starting at src
+    auto route = Route();
+    route.push_back(src);
+
+    // traverse each dimension in order
+    auto current = src;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto stride = stride_per_dim[dim];
+        const auto topology_size = npus_count_per_dim[dim];
+        const auto current_local_id = (current / stride) % topology_size;
+        const auto dest_local_id = (dest / stride) % topology_size;
+
+        // already aligned in this dimension
+        if (current_local_id == dest_local_id) {
+            continue;
+        }
+
+        // ClosedForm dimensions are crossed in one hop
+        if (fidelity_per_dim[dim] == DimFidelity::ClosedForm) {
+            current += (dest_local_id - current_local_id) * stride;
+            route.push_back(current);
+            continue;
+        }
+
+        // append the route inside the slice (excluding the current NPU, already in the route)
+        // (computed without the slice's route cache, so routes may be computed concurrently, see route_batch)
+        const auto slice = slice_id(dim, current);
+        const auto local_route = topology_per_dim[dim]->compute_route(current_local_id, dest_local_id);
+        for (auto i = 1; i < local_route.size(); i++) {
+            route.push_back(global_device_id(dim, slice, local_route[i]));
+        }
+
+        // move to the dest coordinate of this dimension
+        current += (dest_local_id - current_local_id) * stride;
+    }
+
+    // arrives at dest
+    assert(current == dest);
+
+    // return the constructed route
+    return route;
+}
+
+int MultiDimTopology::get_link_dim(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < get_links_count());
+
+    // last dimension starting at or before the link
+    const auto it = std::upper_bound(links_offset_per_dim.begin(), links_offset_per_dim.end(), link_id);
+    return static_cast<int>(it - links_offset_per_dim.begin()) - 1;
+}
+
+DimFidelity MultiDimTopology::get_dim_fidelity(const int dim) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    return fidelity_per_dim[dim];
+}
+
+int MultiDimTopology::slice_id(const int dim, const DeviceId npu_id) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    // drop the coordinate of the given dimension
+    const auto stride = stride_per_dim[dim];
+    const auto upper_stride = stride * npus_count_per_dim[dim];
+    return (npu_id / upper_stride) * stride + (npu_id % stride);
+}
+
+DeviceId MultiDimTopology::global_device_id(const int dim, const int slice_id, const DeviceId local_id) const noexcept {
+    assert(0 <= dim && dim < dims_count);
+
+    const auto topology_size = npus_count_per_dim[dim];
+    const auto extra_devices_count = extra_devices_count_per_dim[dim];
+    assert(0 <= local_id && local_id < topology_size + extra_devices_count);
+
+    // non-NPU device of the slice
+    if (local_id >= topology_size) {
+        return extra_devices_offset_per_dim[dim] + (slice_id * extra_devices_count) + (local_id - topology_size);
+    }
+
+    // NPU: put the local id back as the coordinate of the given dimension
+    const auto stride = stride_per_dim[dim];
+    const auto base_npu_id = (slice_id / stride) * stride * topology_size + (slice_id % stride);
+    return base_npu_id + (local_id * stride);
+}
+
+int MultiDimTopology::expected_links_count() const noexcept {
+    auto links_count = 0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto topology_size = npus_count_per_dim[dim];
+        const auto slices_count = npus_count / topology_size;
+        const auto slice_links_count = (fidelity_per_dim[dim] == DimFidelity::ClosedForm)
+                                           ? topology_size * (topology_size - 1)
+                                           : topology_per_dim[dim]->get_links_count();
+        links_count += slices_count * slice_links_count;
+    }
+
+    return links_count;
+}
+
+void MultiDimTopology::connect_slices() noexcept {
+    for (auto dim = 0; dim < dims_count; dim++) {
+        links_offset_per_dim.push_back(static_cast<LinkId>(links.size()));
+        if (fidelity_per_dim[dim] == DimFidelity::ClosedForm) {
+            connect_closed_form_slices(dim);
+            continue;
+        }
+
+        const auto& topology = *topology_per_dim[dim];
+        const auto slices_count = npus_count / npus_count_per_dim[dim];
+        const auto topology_links_count = topology.get_links_count();
+
+        // copy every directed link of the BasicTopology into each slice
+        for (auto slice = 0; slice < slices_count; slice++) {
+            for (auto link_id = 0; link_id < topology_links_count; link_id++) {
+                const auto& link = topology.get_link(link_id);
+                const auto src = global_device_id(dim, slice, link.get_src());
+                const auto dest = global_device_id(dim, slice, link.get_dest());
+                connect(src, dest, link.get_bandwidth(), link.get_latency(), false);
+            }
+        }
+    }
+}
+
+void MultiDimTopology::connect_closed_form_slices(const int dim) noexcept {
+    assert(fidelity_per_dim[dim] == DimFidelity::ClosedForm);
+
+    const auto& topology = *topology_per_dim[dim];
+    const auto topology_size = npus_count_per_dim[dim];
+    const auto slices_count = npus_count / topology_size;
+
+    // closed form of each NPU pair: route latency and bottleneck bandwidth
+    auto pair_bandwidths = std::vector<Bandwidth>(topology_size * topology_size);
+    auto pair_latencies = std::vector<Latency>(topology_size * topology_size);
+    for (auto src = 0; src < topology_size; src++) {
+        for (auto dest = 0; dest < topology_size; dest++) {
+            if (src == dest) {
+                continue;
+            }
+
+            const auto route = topology.route(src, dest);
+            auto bandwidth = topology.get_link(topology.find_link(route[0], route[1])).get_bandwidth();
+            auto latency = static_cast<Latency>(0);
+            for (auto hop = 0; hop < route.size() - 1; hop++) {
+                const auto& link = topology.get_link(topology.find_link(route[hop], route[hop + 1]));
+                bandwidth = std::min(bandwidth, link.get_bandwidth());
+                latency += link.get_latency();
+            }
+            pair_bandwidths[src * topology_size + dest] = bandwidth;
+            pair_latencies[src * topology_size + dest] = latency;
+        }
+    }
+
+    // connect every NPU pair of each slice
+    for (auto slice = 0; slice < slices_count; slice++) {
+        for (auto src = 0; src < topology_size; src++) {
+            for (auto dest = 0; dest < topology_size; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+
+                const auto pair = src * topology_size + dest;
+                connect(global_device_id(dim, slice, src), global_device_id(dim, slice, dest), pair_bandwidths[pair],
+                        pair_latencies[pair], false);
+                links[links.size() - 1].set_contention_free(true);
+            }
+        }
+    }
+}
+
+uint64_t MultiDimTopology::get_route_tables_bytes() const noexcept {
+    auto allocated_bytes = Topology::get_route_tables_bytes();
+
+    // routes inside slices are looked up from the BasicTopology of each dimension
+    for (const auto& topology : topology_per_dim) {
+        allocated_bytes += topology->get_memory_footprint().route_tables.bytes;
+    }
+    return allocated_bytes;
+}
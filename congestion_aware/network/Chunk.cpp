@@ -4,14 +4,22 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Chunk.h"
-#include "congestion_aware/Device.h"
+#include "common/Profiler.h"
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/CompletionLog.h"
 #include "congestion_aware/Link.h"
+#include "congestion_aware/Topology.h"
 #include <cassert>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+void NetworkAnalytical::invoke_chunk_arrival(void* const chunk_ptr) noexcept {
+    Chunk::chunk_arrived_next_device(chunk_ptr);
+}
+
 void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     assert(chunk_ptr != nullptr);
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::ChunkArrival);
 
     // cast to unique_ptr<Chunk>
     auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
@@ -20,41 +28,129 @@ void Chunk::chunk_arrived_next_device(void* const chunk_ptr) noexcept {
     chunk->mark_arrived_next_device();
 
     if (chunk->arrived_dest()) {
-        // chunk arrived dest, invoke callback
-        // as chunk is unique_ptr, will be destroyed automatically
-        chunk->invoke_callback();
+        // multicast chunks arrive at a node of their tree, and fork to its children
+        if (chunk->multicast_tree != nullptr) {
+            auto* const topology = chunk->topology;
+            topology->arrive_multicast(std::move(chunk));
+            return;
+        }
+
+        // chunks are written through the ingress of their destination first, which may postpone their delivery
+        if (chunk->topology->write_through_ingress(chunk)) {
+            return;
+        }
+
+        // messages are delivered chunk by chunk
+        if (chunk->message_chunks_count > 1) {
+            auto* const topology = chunk->topology;
+            topology->deliver_message_chunk(std::move(chunk));
+            return;
+        }
+
+        // chunk arrived dest, account its delivery and invoke callback
+        chunk->topology->deliver_chunk(*chunk);
+
+        // pooled chunks are recycled,
+        // otherwise, as chunk is unique_ptr, will be destroyed automatically
+        if (chunk->chunk_pool != nullptr) {
+            auto* const chunk_pool = chunk->chunk_pool;
+            chunk_pool->release(std::move(chunk));
+        }
     } else {
         // send this chunk to next dest
-        const auto current_node = chunk->current_device();
-        current_node->send(std::move(chunk));  // send chunk to next des
+        auto* const topology = chunk->topology;
+        assert(topology != nullptr);
+        topology->send(std::move(chunk));  // send chunk to next des
     }
 }
 
 Chunk::Chunk(const ChunkSize chunk_size, Route route, const Callback callback, const CallbackArg callback_arg) noexcept
+    : Chunk(chunk_size, nullptr, std::make_unique<Route>(std::move(route)), callback, callback_arg) {}
+
+Chunk::Chunk(const ChunkSize chunk_size,
+             const Route* const shared_route,
+             const Callback callback,
+             const CallbackArg callback_arg) noexcept
+    : Chunk(chunk_size, shared_route, nullptr, callback, callback_arg) {}
+
+Chunk::Chunk(const ChunkSize chunk_size,
+             const DeviceId* const device_ids,
+             const int devices_count,
+             const Callback callback,
+             const CallbackArg callback_arg) noexcept
+    : Chunk(chunk_size, nullptr, std::make_unique<Route>(device_ids, devices_count), callback, callback_arg) {
+    assert(devices_count >= 2);
+}
+
+Chunk::Chunk(const ChunkSize chunk_size,
+             const Route* const shared_route,
+             std::unique_ptr<Route> own_route,
+             const Callback callback,
+             const CallbackArg callback_arg) noexcept
     : chunk_size(chunk_size),
-      route(std::move(route)),
+      route((own_route != nullptr) ? own_route.get() : shared_route),
+      owned_route(std::move(own_route)),
+      route_index(0),
+      src(route->front()),
+      dest(route->back()),
+      hops_count(0),
+      hop_by_hop(false),
+      topology(nullptr),
       callback(callback),
-      callback_arg(callback_arg) {
+      callback_arg(callback_arg),
+      chunk_pool(nullptr),
+      enqueued_time(0),
+      queueing_delay(0),
+      chunk_id(0),
+      inject_time(0),
+      tail_arrival_time(0),
+      next_queued_chunk(nullptr),
+      next_source_chunk(nullptr),
+      source_tail_chunk(nullptr),
+      queue_source(-1),
+      coalesced_chunks(nullptr),
+      transmission_size(chunk_size),
+      message_chunks_count(1),
+      message_head_arrival_time(0),
+      buffer_credit(0),
+      critical_path_step(-1),
+      multicast_tree(nullptr),
+      multicast_node(0),
+      has_payload(false),
+      traffic_class(0),
+      job_id(0),
+      nic_metered(false) {
     assert(chunk_size > 0);
-    assert(!this->route.empty());
+    assert(!route->empty());
     assert(callback != nullptr);
 }
 
-std::shared_ptr<Device> Chunk::current_device() const noexcept {
+DeviceId Chunk::current_device() const noexcept {
     // assert the route is not empty
-    assert(!route.empty());
+    assert(!route->empty());
 
-    // return the first npu in route
-    return route.front();
+    // return the device at the cursor
+    return (*route)[route_index];
 }
 
-std::shared_ptr<Device> Chunk::next_device() const noexcept {
+DeviceId Chunk::next_device() const noexcept {
     // assert the chunk has next dest
     assert(!arrived_dest());
 
     // return next dest
-    const auto next_dest = std::next(route.begin(), 1);
-    return *next_dest;
+    return (*route)[route_index + 1];
+}
+
+DeviceId Chunk::get_src() const noexcept {
+    return src;
+}
+
+DeviceId Chunk::get_dest() const noexcept {
+    return dest;
+}
+
+int Chunk::get_hops_count() const noexcept {
+    return hops_count;
 }
 
 void Chunk::mark_arrived_next_device() noexcept {
@@ -62,15 +158,21 @@ void Chunk::mark_arrived_next_device() noexcept {
     // it means the chunk hasn't arrived its final dest yet
     assert(!arrived_dest());
 
-    // pop previous node from the route
+    // advance the cursor
     // marking the current node has been changed
-    route.pop_front();
+    route_index++;
+    hops_count++;
 }
 
 bool Chunk::arrived_dest() const noexcept {
-    // if a chunk arrived dest, route length should be 1
-    // i.e., only containing the dest node
-    return route.size() == 1;
+    // hop-by-hop routes end at the next device, not necessarily the dest
+    if (hop_by_hop) {
+        return current_device() == dest;
+    }
+
+    // if a chunk arrived dest, the cursor should point to
+    // the last (dest) node of the route
+    return route_index == route->size() - 1;
 }
 
 ChunkSize Chunk::get_size() const noexcept {
@@ -81,6 +183,32 @@ ChunkSize Chunk::get_size() const noexcept {
 }
 
 void Chunk::invoke_callback() noexcept {
-    // invoke callback
-    (*callback)(callback_arg);
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::Callback);
+
+    // invoke callback, with the inline payload if set
+    (*callback)(has_payload ? static_cast<void*>(payload_bytes) : callback_arg);
+}
+
+EventTime Chunk::get_queueing_delay() const noexcept {
+    return queueing_delay;
+}
+
+void Chunk::set_traffic_class(const int new_traffic_class) noexcept {
+    assert(0 <= new_traffic_class && new_traffic_class < Link::max_traffic_classes);
+
+    traffic_class = static_cast<uint8_t>(new_traffic_class);
+}
+
+int Chunk::get_traffic_class() const noexcept {
+    return traffic_class;
+}
+
+void Chunk::set_job_id(const int new_job_id) noexcept {
+    assert(0 <= new_job_id && new_job_id < max_jobs_count);
+
+    job_id = static_cast<uint16_t>(new_job_id);
+}
+
+int Chunk::get_job_id() const noexcept {
+    return job_id;
 }
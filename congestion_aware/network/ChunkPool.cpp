@@ -0,0 +1,51 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkPool.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+ChunkPool::ChunkPool() noexcept : allocated_chunks_count(0) {
+    // create empty pool
+    free_chunks = std::vector<std::unique_ptr<Chunk>>();
+}
+
+std::unique_ptr<Chunk> ChunkPool::acquire(const ChunkSize chunk_size,
+                                          const Route* const shared_route,
+                                          const Callback callback,
+                                          const CallbackArg callback_arg) noexcept {
+    auto chunk = std::unique_ptr<Chunk>();
+
+    if (free_chunks.empty()) {
+        // no recycled chunk: allocate a new one
+        chunk = std::make_unique<Chunk>(chunk_size, shared_route, callback, callback_arg);
+        allocated_chunks_count++;
+    } else {
+        // reuse a recycled chunk
+        chunk = std::move(free_chunks.back());
+        free_chunks.pop_back();
+        *chunk = Chunk(chunk_size, shared_route, callback, callback_arg);
+    }
+
+    // the chunk returns to this pool when it arrives
+    chunk->chunk_pool = this;
+    return chunk;
+}
+
+void ChunkPool::release(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(chunk->chunk_pool == this);
+
+    free_chunks.push_back(std::move(chunk));
+}
+
+int ChunkPool::get_free_chunks_count() const noexcept {
+    return static_cast<int>(free_chunks.size());
+}
+
+int ChunkPool::get_allocated_chunks_count() const noexcept {
+    return allocated_chunks_count;
+}
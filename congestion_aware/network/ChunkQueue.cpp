@@ -0,0 +1,147 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ChunkQueue.h"
+#include <cassert>
+#include <tuple>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+ChunkQueue::ChunkQueue() noexcept : head(nullptr), tail(nullptr), chunks_count(0), source_arbitration(false) {}
+
+ChunkQueue::~ChunkQueue() noexcept {
+    // destroy the chunks still queued
+    while (!empty()) {
+        std::ignore = pop_front();
+    }
+}
+
+ChunkQueue::ChunkQueue(ChunkQueue&& other) noexcept
+    : head(other.head),
+      tail(other.tail),
+      chunks_count(other.chunks_count),
+      source_arbitration(other.source_arbitration) {
+    // other no longer owns the chunks
+    other.head = nullptr;
+    other.tail = nullptr;
+    other.chunks_count = 0;
+}
+
+ChunkQueue& ChunkQueue::operator=(ChunkQueue&& other) noexcept {
+    if (this != &other) {
+        // drop own chunks, then take over other's
+        while (!empty()) {
+            std::ignore = pop_front();
+        }
+        head = other.head;
+        tail = other.tail;
+        chunks_count = other.chunks_count;
+        source_arbitration = other.source_arbitration;
+
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.chunks_count = 0;
+    }
+
+    return *this;
+}
+
+void ChunkQueue::set_source_arbitration(const bool new_source_arbitration) noexcept {
+    assert(empty());
+
+    source_arbitration = new_source_arbitration;
+}
+
+void ChunkQueue::push_back(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // link the chunk after the tail
+    auto* const chunk_ptr = chunk.release();
+    chunk_ptr->next_queued_chunk = nullptr;
+
+    // source arbitration: link the chunk after the tail of its source's sub-queue, or start a new sub-queue
+    if (source_arbitration) {
+        chunks_count++;
+        for (auto* source_head = head; source_head != nullptr; source_head = source_head->next_source_chunk) {
+            if (source_head->queue_source == chunk_ptr->queue_source) {
+                source_head->source_tail_chunk->next_queued_chunk = chunk_ptr;
+                source_head->source_tail_chunk = chunk_ptr;
+                return;
+            }
+        }
+        chunk_ptr->source_tail_chunk = chunk_ptr;
+        append_source(chunk_ptr);
+        return;
+    }
+    if (tail == nullptr) {
+        head = chunk_ptr;
+    } else {
+        tail->next_queued_chunk = chunk_ptr;
+    }
+    tail = chunk_ptr;
+    chunks_count++;
+}
+
+std::unique_ptr<Chunk> ChunkQueue::pop_front() noexcept {
+    assert(!empty());
+
+    // source arbitration: serve the first sub-queue, whose rest (if any) moves behind the others
+    if (source_arbitration) {
+        auto* const chunk_ptr = head;
+        head = chunk_ptr->next_source_chunk;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        auto* const next_chunk = chunk_ptr->next_queued_chunk;
+        if (next_chunk != nullptr) {
+            next_chunk->source_tail_chunk = chunk_ptr->source_tail_chunk;
+            append_source(next_chunk);
+        }
+        chunk_ptr->next_queued_chunk = nullptr;
+        chunk_ptr->next_source_chunk = nullptr;
+        chunk_ptr->source_tail_chunk = nullptr;
+        chunks_count--;
+
+        return std::unique_ptr<Chunk>(chunk_ptr);
+    }
+
+    // unlink the head
+    auto* const chunk_ptr = head;
+    head = chunk_ptr->next_queued_chunk;
+    if (head == nullptr) {
+        tail = nullptr;
+    }
+    chunk_ptr->next_queued_chunk = nullptr;
+    chunks_count--;
+
+    return std::unique_ptr<Chunk>(chunk_ptr);
+}
+
+const Chunk& ChunkQueue::front() const noexcept {
+    assert(!empty());
+
+    return *head;
+}
+
+bool ChunkQueue::empty() const noexcept {
+    return head == nullptr;
+}
+
+int ChunkQueue::size() const noexcept {
+    return chunks_count;
+}
+
+void ChunkQueue::append_source(Chunk* const source_head) noexcept {
+    assert(source_arbitration);
+    assert(source_head != nullptr);
+
+    source_head->next_source_chunk = nullptr;
+    if (tail == nullptr) {
+        head = source_head;
+    } else {
+        tail->next_source_chunk = source_head;
+    }
+    tail = source_head;
+}
@@ -0,0 +1,39 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CompletionGroup.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+void CompletionGroup::chunk_arrived(void* const group_ptr) noexcept {
+    assert(group_ptr != nullptr);
+
+    auto* const group = static_cast<CompletionGroup*>(group_ptr);
+    assert(group->remaining_chunks_count > 0);
+
+    // the last arrival completes the group
+    group->remaining_chunks_count--;
+    if (group->remaining_chunks_count == 0 && group->callback != nullptr) {
+        (*group->callback)(group->callback_arg);
+    }
+}
+
+CompletionGroup::CompletionGroup(const int chunks_count,
+                                 const Callback callback,
+                                 const CallbackArg callback_arg) noexcept
+    : remaining_chunks_count(chunks_count),
+      callback(callback),
+      callback_arg(callback_arg) {
+    assert(chunks_count > 0);
+}
+
+int CompletionGroup::get_remaining_chunks_count() const noexcept {
+    return remaining_chunks_count;
+}
+
+bool CompletionGroup::completed() const noexcept {
+    return remaining_chunks_count == 0;
+}
@@ -0,0 +1,215 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CompletionLog.h"
+#include "congestion_aware/Chunk.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Write a column to a binary stream.
+ *
+ * @param output stream to write to
+ * @param column column to write
+ */
+template <typename T>
+void write_column(std::ostream& output, const std::vector<T>& column) noexcept {
+    output.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+}
+
+/**
+ * Append a column of the given number of records read from a binary stream.
+ *
+ * @param input stream to read from
+ * @param column column to append to
+ * @param count number of records to read
+ */
+template <typename T>
+void read_column(std::istream& input, std::vector<T>& column, const size_t count) noexcept {
+    const auto offset = column.size();
+    column.resize(offset + count);
+    input.read(reinterpret_cast<char*>(column.data() + offset), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+}  // namespace
+
+size_t CompletionColumns::size() const noexcept {
+    return chunk_ids.size();
+}
+
+void CompletionColumns::clear() noexcept {
+    chunk_ids.clear();
+    srcs.clear();
+    dests.clear();
+    sizes.clear();
+    inject_times.clear();
+    arrival_times.clear();
+    hops.clear();
+    queueing_delays.clear();
+}
+
+void CompletionColumns::reserve(const size_t capacity) noexcept {
+    chunk_ids.reserve(capacity);
+    srcs.reserve(capacity);
+    dests.reserve(capacity);
+    sizes.reserve(capacity);
+    inject_times.reserve(capacity);
+    arrival_times.reserve(capacity);
+    hops.reserve(capacity);
+    queueing_delays.reserve(capacity);
+}
+
+CompletionColumns CompletionLog::read_log(const std::string& log_path) noexcept {
+    auto log_file = std::istringstream(CompressedOutput::read_file(log_path));
+    auto magic = uint64_t(0);
+    log_file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!log_file || magic != log_magic) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << log_path << " is not a completion log"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    auto columns = CompletionColumns();
+    auto count = uint64_t(0);
+    while (log_file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        read_column(log_file, columns.chunk_ids, count);
+        read_column(log_file, columns.srcs, count);
+        read_column(log_file, columns.dests, count);
+        read_column(log_file, columns.sizes, count);
+        read_column(log_file, columns.inject_times, count);
+        read_column(log_file, columns.arrival_times, count);
+        read_column(log_file, columns.hops, count);
+        read_column(log_file, columns.queueing_delays, count);
+        if (!log_file) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << log_path << " is truncated" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    return columns;
+}
+
+CompletionLog::CompletionLog(const std::string& log_path,
+                             const size_t block_size,
+                             const Compression compression) noexcept
+    : log_path(log_path),
+      log_file(log_path, compression),
+      block_size(block_size),
+      flush_pending(false),
+      closing(false),
+      records_count(0) {
+    assert(block_size > 0);
+
+    log_file.write(reinterpret_cast<const char*>(&log_magic), sizeof(log_magic));
+
+    // both blocks are allocated up front, so recording never allocates
+    active_block.reserve(block_size);
+    flushing_block.reserve(block_size);
+
+    writer = std::thread(&CompletionLog::write_blocks, this);
+}
+
+CompletionLog::~CompletionLog() noexcept {
+    close();
+}
+
+void CompletionLog::record(const Chunk& chunk, const EventTime arrival_time) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(record_mutex);
+    assert(!closing);
+
+    active_block.chunk_ids.push_back(chunk.chunk_id);
+    active_block.srcs.push_back(chunk.src);
+    active_block.dests.push_back(chunk.dest);
+    active_block.sizes.push_back(chunk.chunk_size);
+    active_block.inject_times.push_back(chunk.inject_time);
+    active_block.arrival_times.push_back(arrival_time);
+    active_block.hops.push_back(chunk.hops_count);
+    active_block.queueing_delays.push_back(chunk.queueing_delay);
+    records_count++;
+
+    if (active_block.size() == block_size) {
+        swap_blocks();
+    }
+}
+
+void CompletionLog::close() noexcept {
+    if (!writer.joinable()) {
+        return;
+    }
+
+    // hand over the last (partial) block, then let the writer finish
+    {
+        const auto lock = std::lock_guard<std::mutex>(record_mutex);
+        if (active_block.size() > 0) {
+            swap_blocks();
+        }
+    }
+    {
+        const auto lock = std::lock_guard<std::mutex>(flush_mutex);
+        closing = true;
+    }
+    flush_condition.notify_all();
+    writer.join();
+
+    log_file.close();
+}
+
+uint64_t CompletionLog::get_records_count() const noexcept {
+    return records_count;
+}
+
+void CompletionLog::swap_blocks() noexcept {
+    auto lock = std::unique_lock<std::mutex>(flush_mutex);
+
+    // the writer should be done with the previous block
+    flush_condition.wait(lock, [this] { return !flush_pending; });
+
+    std::swap(active_block, flushing_block);
+    active_block.clear();
+    flush_pending = true;
+
+    lock.unlock();
+    flush_condition.notify_all();
+}
+
+void CompletionLog::write_blocks() noexcept {
+    auto lock = std::unique_lock<std::mutex>(flush_mutex);
+
+    while (true) {
+        flush_condition.wait(lock, [this] { return flush_pending || closing; });
+        if (!flush_pending) {
+            // closing with nothing left to write
+            return;
+        }
+
+        // write without holding the lock; the simulation only touches flushing_block after flush_pending clears
+        lock.unlock();
+        write_block(flushing_block);
+        lock.lock();
+
+        flush_pending = false;
+        flush_condition.notify_all();
+    }
+}
+
+void CompletionLog::write_block(const CompletionColumns& block) noexcept {
+    const auto count = static_cast<uint64_t>(block.size());
+    log_file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    write_column(log_file, block.chunk_ids);
+    write_column(log_file, block.srcs);
+    write_column(log_file, block.dests);
+    write_column(log_file, block.sizes);
+    write_column(log_file, block.inject_times);
+    write_column(log_file, block.arrival_times);
+    write_column(log_file, block.hops);
+    write_column(log_file, block.queueing_delays);
+}
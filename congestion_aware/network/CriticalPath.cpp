@@ -0,0 +1,154 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CriticalPath.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Topology.h"
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <map>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+CriticalPath::CriticalPath() noexcept : last_delivery_step(-1) {}
+
+void CriticalPath::record_transmission(const Link* const link,
+                                       const DeviceId link_src,
+                                       const DeviceId link_dest,
+                                       Chunk& chunk,
+                                       const EventTime ready_time,
+                                       const EventTime start_time,
+                                       const EventTime link_free_time,
+                                       const EventTime arrival_time) noexcept {
+    assert(link != nullptr);
+    assert(ready_time <= start_time);
+    assert(start_time <= link_free_time);
+
+    const auto lock = std::lock_guard<std::mutex>(critical_path_mutex);
+    const auto step_id = static_cast<int64_t>(steps.size());
+
+    // a chunk starting late waited for the previous transmission on the link,
+    // otherwise its inbound hop determined the start
+    auto& last_link_step = last_step_per_link.try_emplace(link, -1).first->second;
+    const auto waited_for_link = (start_time > ready_time) && (last_link_step >= 0);
+    const auto predecessor = waited_for_link ? last_link_step : chunk.critical_path_step;
+    steps.push_back({link_src, link_dest, chunk.src, chunk.dest, chunk.chunk_id, ready_time, start_time,
+                     link_free_time, arrival_time, predecessor, waited_for_link});
+    last_link_step = step_id;
+    chunk.critical_path_step = step_id;
+
+    // the run finishes with the last delivery
+    if (link_dest == chunk.dest &&
+        (last_delivery_step < 0 || arrival_time >= steps[last_delivery_step].arrival_time)) {
+        last_delivery_step = step_id;
+    }
+}
+
+std::vector<CriticalPathStep> CriticalPath::extract() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(critical_path_mutex);
+
+    // follow the predecessors back from the last delivery
+    auto path = std::vector<CriticalPathStep>();
+    for (auto step_id = last_delivery_step; step_id >= 0; step_id = steps[step_id].predecessor) {
+        path.push_back(steps[step_id]);
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+void CriticalPath::dump(std::ostream& output) const noexcept {
+    const auto path = extract();
+    if (path.empty()) {
+        output << "[CriticalPath] no chunk delivered" << std::endl;
+        return;
+    }
+
+    output << "[CriticalPath] finish time: " << path.back().arrival_time << " " << time_unit << ", " << path.size()
+           << " steps" << std::endl;
+
+    // steps, with the time each one added to the path
+    auto serialization_time_per_link = std::map<std::pair<DeviceId, DeviceId>, EventTime>();
+    auto wait_time_per_link = std::map<std::pair<DeviceId, DeviceId>, EventTime>();
+    for (const auto& step : path) {
+        const auto wait_time = step.start_time - step.ready_time;
+        output << "[CriticalPath] link " << step.link_src << " -> " << step.link_dest << ": chunk " << step.chunk_id
+               << " (" << step.chunk_src << " -> " << step.chunk_dest << "), ready " << step.ready_time << ", start "
+               << step.start_time << " (waited " << wait_time << (step.waited_for_link ? ", link held" : "")
+               << "), free " << step.link_free_time << ", arrived " << step.arrival_time << std::endl;
+
+        const auto link = std::make_pair(step.link_src, step.link_dest);
+        serialization_time_per_link[link] += step.link_free_time - step.start_time;
+        wait_time_per_link[link] += wait_time;
+    }
+
+    // time spent on each link of the path: more bandwidth only helps where serialization dominates
+    for (const auto& [link, serialization_time] : serialization_time_per_link) {
+        output << "[CriticalPath] link " << link.first << " -> " << link.second << ": serialization "
+               << serialization_time << " " << time_unit << ", waiting " << wait_time_per_link[link] << " "
+               << time_unit << std::endl;
+    }
+}
+
+std::vector<BandwidthSensitivity> CriticalPath::bandwidth_sensitivity(const Topology& topology) const noexcept {
+    // every group of materialized links, with its busiest link
+    auto sensitivities = std::vector<BandwidthSensitivity>();
+    const auto find_group = [&sensitivities](const std::string& name) {
+        auto group = std::find_if(sensitivities.begin(), sensitivities.end(),
+                                  [&name](const auto& sensitivity) { return sensitivity.group == name; });
+        if (group == sensitivities.end()) {
+            group = sensitivities.insert(sensitivities.end(), BandwidthSensitivity{name});
+        }
+        return group;
+    };
+    for (const auto link_id : topology.rank_links()) {
+        auto group = find_group(topology.get_link_group(link_id));
+        group->max_link_busy_time =
+            std::max(group->max_link_busy_time, topology.get_link(link_id).get_stats().busy_time);
+    }
+
+    // d(size / bandwidth) / d(bandwidth) = -(size / bandwidth) / bandwidth, per step of the path
+    for (const auto& step : extract()) {
+        const auto link_id = topology.find_link(step.link_src, step.link_dest);
+        assert(link_id >= 0);
+
+        const auto serialization_time = step.link_free_time - step.start_time;
+        auto group = find_group(topology.get_link_group(link_id));
+        group->serialization_time += serialization_time;
+        group->finish_time_per_GBps -=
+            static_cast<double>(serialization_time) / topology.get_link(link_id).get_bandwidth();
+    }
+
+    std::stable_sort(sensitivities.begin(), sensitivities.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.finish_time_per_GBps < rhs.finish_time_per_GBps;
+    });
+    return sensitivities;
+}
+
+void CriticalPath::dump_bandwidth_sensitivity(const Topology& topology, std::ostream& output) const noexcept {
+    output << std::fixed << std::setprecision(3);
+    for (const auto& sensitivity : bandwidth_sensitivity(topology)) {
+        output << "[CriticalPath] group " << sensitivity.group << ": serialization on path "
+               << sensitivity.serialization_time << " " << time_unit << ", d(finish time)/d(bandwidth) "
+               << sensitivity.finish_time_per_GBps << " " << time_unit << " per GB/s, busiest link busy "
+               << sensitivity.max_link_busy_time << " " << time_unit << std::endl;
+    }
+    output.unsetf(std::ios_base::floatfield);
+}
+
+void CriticalPath::clear() noexcept {
+    const auto lock = std::lock_guard<std::mutex>(critical_path_mutex);
+    steps.clear();
+    last_step_per_link.clear();
+    last_delivery_step = -1;
+}
+
+uint64_t CriticalPath::get_transmissions_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(critical_path_mutex);
+    return steps.size();
+}
@@ -0,0 +1,109 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LatencyHistograms.h"
+#include "congestion_aware/Chunk.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+LatencyHistograms::LatencyHistograms(const int classes_count,
+                                     Classifier classifier,
+                                     const int precision_bits) noexcept
+    : classifier(std::move(classifier)) {
+    if (classes_count <= 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "latency histograms need at least one class, got " << classes_count << std::endl;
+        std::exit(-1);
+    }
+
+    const auto histogram = Histogram(precision_bits);
+    class_histograms.assign(classes_count, ClassHistograms{histogram, histogram, histogram});
+}
+
+void LatencyHistograms::record(const Chunk& chunk, const EventTime arrival_time) noexcept {
+    assert(arrival_time >= chunk.inject_time);
+
+    const auto class_id = (classifier != nullptr) ? classifier(chunk.src, chunk.dest) : 0;
+    assert(0 <= class_id && class_id < static_cast<int>(class_histograms.size()));
+
+    const auto lock = std::lock_guard<std::mutex>(record_mutex);
+    auto& histograms = class_histograms[class_id];
+    histograms.latency.record(arrival_time - chunk.inject_time);
+    histograms.queueing_delay.record(chunk.queueing_delay);
+    histograms.hops.record(chunk.hops_count);
+}
+
+void LatencyHistograms::reset() noexcept {
+    const auto lock = std::lock_guard<std::mutex>(record_mutex);
+
+    for (auto& histograms : class_histograms) {
+        histograms.latency.reset();
+        histograms.queueing_delay.reset();
+        histograms.hops.reset();
+    }
+}
+
+int LatencyHistograms::get_classes_count() const noexcept {
+    return static_cast<int>(class_histograms.size());
+}
+
+Histogram LatencyHistograms::get_latency(const int class_id) const noexcept {
+    return get_histogram(class_id, &ClassHistograms::latency);
+}
+
+Histogram LatencyHistograms::get_queueing_delay(const int class_id) const noexcept {
+    return get_histogram(class_id, &ClassHistograms::queueing_delay);
+}
+
+Histogram LatencyHistograms::get_hops(const int class_id) const noexcept {
+    return get_histogram(class_id, &ClassHistograms::hops);
+}
+
+void LatencyHistograms::dump(std::ostream& output) const noexcept {
+    output << "class,metric,count,min,mean,p50,p90,p99,p99.9,max" << std::endl;
+
+    const auto dump_class = [&](const int class_id) {
+        const auto class_name = (class_id < 0) ? std::string("all") : std::to_string(class_id);
+        for (const auto& [metric, member] : {std::make_pair("latency", &ClassHistograms::latency),
+                                             std::make_pair("queueing_delay", &ClassHistograms::queueing_delay),
+                                             std::make_pair("hops", &ClassHistograms::hops)}) {
+            const auto histogram = get_histogram(class_id, member);
+            output << class_name << "," << metric << "," << histogram.get_count() << "," << histogram.get_min()
+                   << "," << histogram.get_mean() << "," << histogram.get_percentile(50) << ","
+                   << histogram.get_percentile(90) << "," << histogram.get_percentile(99) << ","
+                   << histogram.get_percentile(99.9) << "," << histogram.get_max() << std::endl;
+        }
+    };
+
+    dump_class(-1);
+    if (class_histograms.size() > 1) {
+        for (auto class_id = 0; class_id < static_cast<int>(class_histograms.size()); class_id++) {
+            dump_class(class_id);
+        }
+    }
+}
+
+Histogram LatencyHistograms::get_histogram(const int class_id, Histogram ClassHistograms::*const member) const
+    noexcept {
+    assert(-1 <= class_id && class_id < static_cast<int>(class_histograms.size()));
+
+    const auto lock = std::lock_guard<std::mutex>(record_mutex);
+    if (class_id >= 0) {
+        return class_histograms[class_id].*member;
+    }
+
+    // every class merged
+    auto merged = class_histograms[0].*member;
+    for (auto merged_class_id = 1; merged_class_id < static_cast<int>(class_histograms.size()); merged_class_id++) {
+        merged.merge(class_histograms[merged_class_id].*member);
+    }
+    return merged;
+}
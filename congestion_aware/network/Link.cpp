@@ -5,18 +5,85 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_aware/Link.h"
 #include "common/NetworkFunction.h"
+#include "common/Observers.h"
+#include "common/Profiler.h"
 #include "congestion_aware/Chunk.h"
-#include "congestion_aware/Device.h"
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/CriticalPath.h"
+#include "congestion_aware/LinkTable.h"
+#include "congestion_aware/LinkTrace.h"
+#include "congestion_aware/UtilizationSampler.h"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <iterator>
+#include <limits>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-// declaring static event_queue
-std::shared_ptr<EventQueue> Link::event_queue;
+namespace {
+
+/// link-free events ahead whose link is prefetched while freeing a link
+constexpr int link_free_prefetch_distance = 4;
+
+/**
+ * Find the step of a schedule in effect at the given time, the last one started by then,
+ * and narrow [step_begin, step_end) to the time it's in effect.
+ *
+ * @param schedule steps of the schedule, in increasing time order (nullptr: none)
+ * @param time time to look up
+ * @param step_begin time the steps in effect start
+ * @param step_end time the steps in effect end
+ * @return index of the step, -1 if none started yet
+ */
+template <typename Schedule>
+int look_up_step(const Schedule* const schedule,
+                 const EventTime time,
+                 EventTime& step_begin,
+                 EventTime& step_end) noexcept {
+    if (schedule == nullptr) {
+        return -1;
+    }
+
+    const auto& steps = *schedule;
+    const auto next_step = std::upper_bound(steps.begin(), steps.end(), time, [](const EventTime t, const auto& step) {
+        return t < step.time;
+    });
+    const auto step = static_cast<int>(next_step - steps.begin()) - 1;
+    if (step >= 0) {
+        step_begin = std::max(step_begin, steps[step].time);
+    }
+    if (next_step != steps.end()) {
+        step_end = std::min(step_end, next_step->time);
+    }
+    return step;
+}
+
+}  // namespace
+
+void NetworkAnalytical::invoke_link_free(void* const link_ptr) noexcept {
+    Link::link_become_free(link_ptr);
+}
+
+void NetworkAnalytical::invoke_link_frees(const CallbackArg* const link_ptrs, const int count) noexcept {
+    assert(link_ptrs != nullptr);
+    assert(count > 0);
+
+    // links are scattered in memory: fetch the state of the links a few events ahead while freeing this one
+    for (auto i = 0; i < count; i++) {
+#if defined(__GNUC__)
+        if (i + link_free_prefetch_distance < count) {
+            __builtin_prefetch(link_ptrs[i + link_free_prefetch_distance], 1);
+        }
+#endif
+        Link::link_become_free(link_ptrs[i]);
+    }
+}
 
 void Link::link_become_free(void* const link_ptr) noexcept {
     assert(link_ptr != nullptr);
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::LinkFree);
 
     // cast to Link*
     auto* const link = static_cast<Link*>(link_ptr);
@@ -24,88 +91,630 @@ void Link::link_become_free(void* const link_ptr) noexcept {
     // set link free
     link->set_free();
 
+    // a chunk held back by backpressure goes first (the next link's buffer may have room now)
+    if (link->stalled_chunk != nullptr) {
+        retry_stalled_transmission(link_ptr);
+        return;
+    }
+
     // process pending chunks if one exist
     if (link->pending_chunk_exists()) {
         link->process_pending_transmission();
     }
 }
 
-void Link::set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept {
-    assert(event_queue_ptr != nullptr);
+void Link::retry_stalled_transmission(void* const link_ptr) noexcept {
+    assert(link_ptr != nullptr);
 
-    // set the event queue
-    Link::event_queue = std::move(event_queue_ptr);
+    // the chunk may have been retried already, e.g., by a channel getting free meanwhile
+    auto* const link = static_cast<Link*>(link_ptr);
+    if (link->stalled_chunk == nullptr || link->busy) {
+        return;
+    }
+
+    NETWORK_ANALYTICAL_STATS(link->stats.backpressure_time +=
+                             link->scheduler->get_current_time() - link->stalled_since);
+    link->start_transmission(std::move(link->stalled_chunk));
 }
 
-Link::Link(const Bandwidth bandwidth, const Latency latency) noexcept
-    : bandwidth(bandwidth),
+Link::Link(const DeviceId src,
+           const DeviceId dest,
+           const Bandwidth bandwidth,
+           const Latency latency,
+           NetworkScheduler* const scheduler) noexcept
+    : scheduler(scheduler),
+      arrival_mailbox(nullptr),
+      link_trace(nullptr),
+      critical_path(nullptr),
+      utilization_sampler(nullptr),
+      src(src),
+      dest(dest),
+      sampler_row(-1),
+      link_model(LinkModel::Event),
+      switching_mode(SwitchingMode::StoreAndForward),
+      busy(false),
+      channels_count(1),
+      channel_mode(ChannelMode::Striped),
+      busy_channels(0),
+      contention_free(false),
+      chunk_coalescing(false),
+      source_arbitration(false),
+      bandwidth(bandwidth),
+      bandwidth_schedule(nullptr),
+      background_schedule(nullptr),
+      bandwidth_step_begin(0),
+      bandwidth_step_end(0),
+      bandwidth_step(-1),
+      background_step(-1),
+      bandwidth_share(1),
+      transmission_bandwidth_Bpns(0),
       latency(latency),
+      latency_ticks(0),
+      busy_until(0),
+      serving_until(0),
+      packet_size(0),
+      protocol(nullptr),
       pending_chunks(),
-      busy(false) {
+      pending_bytes(0),
+      queueing_policy(QueueingPolicy::FIFO),
+      class_queues(nullptr),
+      calendar(nullptr),
+      buffer_capacity(0),
+      buffered_bytes(0),
+      link_table(nullptr),
+      stalled_chunk(nullptr),
+      stalled_since(0),
+      blocked_links() {
+    assert(src >= 0);
+    assert(dest >= 0);
     assert(bandwidth > 0);
     assert(latency >= 0);
 
-    // convert bandwidth from GB/s to B/ns
-    bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    // convert bandwidth from GB/s to B/ns (serialization delays divide by it) and latency to ticks
+    set_parameters(bandwidth, latency);
+}
+
+void Link::set_scheduler(NetworkScheduler* const new_scheduler) noexcept {
+    assert(new_scheduler != nullptr);
+
+    // set the scheduler
+    scheduler = new_scheduler;
+}
+
+void Link::set_link_model(const LinkModel new_link_model) noexcept {
+    // link model can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    link_model = new_link_model;
+    update_transmission_bandwidth();
+
+    // only calendars hold reservations
+    if (link_model == LinkModel::Calendar) {
+        calendar = std::make_unique<std::map<EventTime, EventTime>>();
+    } else {
+        calendar = nullptr;
+    }
+}
+
+EventTime Link::get_current_time() const noexcept {
+    assert(scheduler != nullptr);
+
+    return scheduler->get_current_time();
+}
+
+void Link::set_link_trace(LinkTrace* const new_link_trace) noexcept {
+    link_trace = new_link_trace;
+}
+
+void Link::set_critical_path(CriticalPath* const new_critical_path) noexcept {
+    critical_path = new_critical_path;
+}
+
+void Link::set_utilization_sampler(UtilizationSampler* const new_utilization_sampler,
+                                   const int new_sampler_row) noexcept {
+    utilization_sampler = new_utilization_sampler;
+    sampler_row = new_sampler_row;
+}
+
+void Link::set_arrival_mailbox(EventMailbox* const new_arrival_mailbox) noexcept {
+    arrival_mailbox = new_arrival_mailbox;
+}
+
+LinkModel Link::get_link_model() const noexcept {
+    return link_model;
+}
+
+void Link::set_packet_size(const ChunkSize new_packet_size) noexcept {
+    // packet size can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    packet_size = new_packet_size;
+}
+
+ChunkSize Link::get_packet_size() const noexcept {
+    return packet_size;
+}
+
+void Link::set_switching_mode(const SwitchingMode new_switching_mode) noexcept {
+    // switching mode can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    switching_mode = new_switching_mode;
+}
+
+SwitchingMode Link::get_switching_mode() const noexcept {
+    return switching_mode;
+}
+
+void Link::set_protocol(const LinkProtocol* const new_protocol) noexcept {
+    // protocol can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+    assert(new_protocol == nullptr || new_protocol->packet_gap >= 0);
+
+    protocol = new_protocol;
+}
+
+const LinkProtocol* Link::get_protocol() const noexcept {
+    return protocol;
+}
+
+void Link::set_bandwidth_schedule(const BandwidthSchedule* const new_bandwidth_schedule) noexcept {
+    // bandwidth can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    bandwidth_schedule = new_bandwidth_schedule;
+    bandwidth_step = -1;
+    if (bandwidth_schedule == nullptr && background_schedule == nullptr) {
+        update_transmission_bandwidth();
+        return;
+    }
+
+    // start from the step in effect at time 0
+    look_up_bandwidth_step(0);
+}
+
+const BandwidthSchedule* Link::get_bandwidth_schedule() const noexcept {
+    return bandwidth_schedule;
+}
+
+void Link::set_background_schedule(const BackgroundSchedule* const new_background_schedule) noexcept {
+    // bandwidth can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    background_schedule = new_background_schedule;
+    background_step = -1;
+    if (bandwidth_schedule == nullptr && background_schedule == nullptr) {
+        update_transmission_bandwidth();
+        return;
+    }
+
+    // start from the step in effect at time 0
+    look_up_bandwidth_step(0);
+}
+
+const BackgroundSchedule* Link::get_background_schedule() const noexcept {
+    return background_schedule;
+}
+
+void Link::set_bandwidth_share(const double new_bandwidth_share) noexcept {
+    assert(0 < new_bandwidth_share && new_bandwidth_share <= 1);
+
+    bandwidth_share = new_bandwidth_share;
+    update_transmission_bandwidth();
+}
+
+double Link::get_bandwidth_share() const noexcept {
+    return bandwidth_share;
+}
+
+void Link::set_queueing_policy(const QueueingPolicy new_queueing_policy,
+                               const std::array<int, max_traffic_classes>& class_weights) noexcept {
+    // queueing policy can't be changed while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    queueing_policy = new_queueing_policy;
+    if (queueing_policy == QueueingPolicy::FIFO) {
+        class_queues = nullptr;
+        return;
+    }
+
+    // each class gets a queue of its own
+    class_queues = std::make_unique<ClassQueues>();
+    class_queues->weights = class_weights;
+    for (const auto weight : class_weights) {
+        assert(queueing_policy != QueueingPolicy::WeightedRoundRobin || weight > 0);
+    }
+    for (auto& queue : class_queues->queues) {
+        queue.set_source_arbitration(source_arbitration);
+    }
+}
+
+QueueingPolicy Link::get_queueing_policy() const noexcept {
+    return queueing_policy;
+}
+
+void Link::set_source_arbitration(const bool new_source_arbitration) noexcept {
+    // arbitration can't be toggled while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    source_arbitration = new_source_arbitration;
+    pending_chunks.set_source_arbitration(source_arbitration);
+    if (class_queues != nullptr) {
+        for (auto& queue : class_queues->queues) {
+            queue.set_source_arbitration(source_arbitration);
+        }
+    }
+}
+
+void Link::set_chunk_coalescing(const bool new_chunk_coalescing) noexcept {
+    // chunk coalescing can't be toggled while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    chunk_coalescing = new_chunk_coalescing;
+}
+
+void Link::set_buffer_capacity(const ChunkSize new_buffer_capacity, const LinkTable* const new_link_table) noexcept {
+    // buffers can't be resized while chunks are in flight
+    assert(!busy && !pending_chunk_exists() && buffered_bytes == 0);
+    assert(new_buffer_capacity == 0 || new_link_table != nullptr);
+
+    buffer_capacity = new_buffer_capacity;
+    link_table = new_link_table;
+}
+
+ChunkSize Link::get_buffer_capacity() const noexcept {
+    return buffer_capacity;
+}
+
+bool Link::charges_next_buffers() const noexcept {
+    return link_table != nullptr;
+}
+
+void Link::set_contention_free(const bool new_contention_free) noexcept {
+    // contention can't be toggled while chunks are in flight
+    assert(!busy && !pending_chunk_exists());
+
+    contention_free = new_contention_free;
+    update_transmission_bandwidth();
+}
+
+bool Link::is_contention_free() const noexcept {
+    return contention_free;
 }
 
 void Link::send(std::unique_ptr<Chunk> chunk) noexcept {
     assert(chunk != nullptr);
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::LinkSend);
 
-    if (busy) {
-        // link is busy, add to pending chunks
-        pending_chunks.push_back(std::move(chunk));
+    // chunk starts waiting for the link
+    if (stats_enabled || (observers_enabled && critical_path != nullptr)) {
+        chunk->enqueued_time = scheduler->get_current_time();
+    }
+
+    if (contention_free || link_model != LinkModel::Event) {
+        // start time is known at enqueue
+        schedule_virtual_time_transmission(std::move(chunk));
+    } else if (busy || stalled_chunk != nullptr) {
+        // link is busy (or holding a chunk back), add to pending chunks
+        // (a message as its chunks, which other chunks may then interleave with)
+        if (chunk->message_chunks_count > 1) {
+            enqueue_message_chunks(std::move(chunk));
+        } else {
+            enqueue_pending_chunk(std::move(chunk));
+        }
+        sample_pending_chunks();
+        NETWORK_ANALYTICAL_STATS(stats.max_pending_chunks =
+                                     std::max(stats.max_pending_chunks, pending_chunks_count()));
     } else {
         // service this chunk immediately
-        schedule_chunk_transmission(std::move(chunk));
+        start_transmission(std::move(chunk));
+    }
+}
+
+void Link::send_batch(std::unique_ptr<Chunk>* const chunks, const int count) noexcept {
+    assert(chunks != nullptr);
+    assert(count > 0);
+    assert(link_model == LinkModel::Event);
+
+    // contention-free chunks don't queue
+    if (contention_free) {
+        for (auto i = 0; i < count; i++) {
+            send(std::move(chunks[i]));
+        }
+        return;
+    }
+
+    // chunks start waiting for the link
+    if (stats_enabled || (observers_enabled && critical_path != nullptr)) {
+        const auto current_time = scheduler->get_current_time();
+        for (auto i = 0; i < count; i++) {
+            chunks[i]->enqueued_time = current_time;
+        }
     }
+
+    // service the first chunks immediately while the link has a free channel
+    auto first_pending = 0;
+    while (first_pending < count && !busy && stalled_chunk == nullptr) {
+        start_transmission(std::move(chunks[first_pending]));
+        first_pending++;
+    }
+    if (first_pending == count) {
+        return;
+    }
+
+    // add the others to the pending chunks
+    for (auto i = first_pending; i < count; i++) {
+        enqueue_pending_chunk(std::move(chunks[i]));
+    }
+    sample_pending_chunks();
+    NETWORK_ANALYTICAL_STATS(stats.max_pending_chunks = std::max(stats.max_pending_chunks, pending_chunks_count()));
 }
 
 void Link::process_pending_transmission() noexcept {
     // pending chunk should exist
     assert(pending_chunk_exists());
 
-    // get chunk to process
-    auto chunk = std::move(pending_chunks.front());
-    pending_chunks.pop_front();
+    // get chunk to process (following the queueing policy), along with the chunks behind it on the same route
+    auto& queue = next_pending_queue();
+    const auto queue_size = queue.size();
+    auto chunk = queue.pop_front();
+    if (chunk_coalescing) {
+        coalesce_pending_chunks(*chunk, queue);
+    }
+    if (class_queues != nullptr) {
+        class_queues->chunks_count -= queue_size - queue.size();
+    }
+    pending_bytes -= chunk->transmission_size;
+    sample_pending_chunks();
 
     // service this chunk
-    schedule_chunk_transmission(std::move(chunk));
+    start_transmission(std::move(chunk));
+}
+
+std::vector<std::unique_ptr<Chunk>> Link::take_waiting_chunks() noexcept {
+    auto waiting_chunks = std::vector<std::unique_ptr<Chunk>>();
+
+    // the chunk held back goes first
+    if (stalled_chunk != nullptr) {
+        NETWORK_ANALYTICAL_STATS(stats.backpressure_time += scheduler->get_current_time() - stalled_since);
+        waiting_chunks.push_back(std::move(stalled_chunk));
+    }
+    while (pending_chunk_exists()) {
+        auto& queue = next_pending_queue();
+        waiting_chunks.push_back(queue.pop_front());
+        if (class_queues != nullptr) {
+            class_queues->chunks_count--;
+        }
+    }
+    pending_bytes = 0;
+    sample_pending_chunks();
+
+    for (auto& chunk : waiting_chunks) {
+        release_buffer(*chunk);
+    }
+    return waiting_chunks;
 }
 
 bool Link::pending_chunk_exists() const noexcept {
     // check pending chunks is not empty
-    return !pending_chunks.empty();
+    return pending_chunks_count() > 0;
+}
+
+int Link::get_queued_chunks_count() const noexcept {
+    return pending_chunks_count() + busy_channels + ((stalled_chunk != nullptr) ? 1 : 0);
+}
+
+ChunkSize Link::get_pending_bytes() const noexcept {
+    return pending_bytes + ((stalled_chunk != nullptr) ? stalled_chunk->transmission_size : 0);
+}
+
+EventTime Link::get_busy_until() const noexcept {
+    return (link_model != LinkModel::Event) ? busy_until : serving_until;
+}
+
+LinkLoad Link::get_load() const noexcept {
+    return {get_queued_chunks_count(), get_pending_bytes(), get_busy_until()};
 }
 
 void Link::set_busy() noexcept {
-    // set busy to true
-    busy = true;
+    // the link is busy once all its channels are (striped chunks take all of them at once)
+    const auto concurrent_chunks = (channel_mode == ChannelMode::PerChunk) ? channels_count : 1;
+    assert(busy_channels < concurrent_chunks);
+
+    busy_channels++;
+    busy = (busy_channels == concurrent_chunks);
 }
 
 void Link::set_free() noexcept {
-    // set busy to false
+    assert(busy_channels > 0);
+
+    busy_channels--;
     busy = false;
 }
 
+void Link::reset() noexcept {
+    busy = false;
+    busy_channels = 0;
+    busy_until = 0;
+    serving_until = 0;
+    if (calendar != nullptr) {
+        calendar->clear();
+    }
+    stats = LinkStats();
+    buffered_bytes = 0;
+    blocked_links.clear();
+    if (stalled_chunk != nullptr) {
+        enqueue_pending_chunk(std::move(stalled_chunk));
+    }
+
+    // drop the pending chunks (and the chunks coalesced into them), recycling pooled ones
+    pending_bytes = 0;
+    while (pending_chunk_exists()) {
+        auto& queue = next_pending_queue();
+        auto chunk = queue.pop_front();
+        if (class_queues != nullptr) {
+            class_queues->chunks_count--;
+        }
+        while (chunk != nullptr) {
+            auto next_chunk = std::move(chunk->coalesced_chunks);
+            if (chunk->chunk_pool != nullptr) {
+                auto* const chunk_pool = chunk->chunk_pool;
+                chunk_pool->release(std::move(chunk));
+            }
+            chunk = std::move(next_chunk);
+        }
+    }
+    if (class_queues != nullptr) {
+        class_queues->current_class = 0;
+        class_queues->served_count = 0;
+    }
+
+    // rewind the bandwidth schedule, with the whole bandwidth
+    bandwidth_share = 1;
+    if (bandwidth_schedule != nullptr || background_schedule != nullptr) {
+        look_up_bandwidth_step(0);
+    } else {
+        update_transmission_bandwidth();
+    }
+}
+
+void Link::set_parameters(const Bandwidth new_bandwidth, const Latency new_latency) noexcept {
+    assert(new_bandwidth > 0);
+    assert(new_latency >= 0);
+    assert(!busy && !pending_chunk_exists());
+
+    bandwidth = new_bandwidth;
+    latency = new_latency;
+
+    // latency rounded down to a tick
+    update_transmission_bandwidth();
+    latency_ticks = ns_to_ticks(latency);
+}
+
+void Link::set_channels(const int new_channels_count, const ChannelMode new_channel_mode) noexcept {
+    assert(new_channels_count > 0);
+    assert(!busy && busy_channels == 0 && !pending_chunk_exists());
+
+    channels_count = new_channels_count;
+    channel_mode = new_channel_mode;
+    update_transmission_bandwidth();
+}
+
+int Link::get_channels_count() const noexcept {
+    return channels_count;
+}
+
+ChannelMode Link::get_channel_mode() const noexcept {
+    return channel_mode;
+}
+
+void Link::update_transmission_bandwidth() noexcept {
+    // striped chunks are serialized by all channels at once, others by a single channel
+    const auto striped = channel_mode == ChannelMode::Striped || contention_free || link_model != LinkModel::Event;
+    const auto scheduled_bandwidth = (bandwidth_step < 0) ? bandwidth : (*bandwidth_schedule)[bandwidth_step].bandwidth;
+    const auto background_share =
+        (background_step < 0) ? 1.0 : 1.0 - (*background_schedule)[background_step].utilization;
+    const auto current_bandwidth = scheduled_bandwidth * bandwidth_share * background_share;
+    const auto transmission_bandwidth = striped ? current_bandwidth * channels_count : current_bandwidth;
+
+    transmission_bandwidth_Bpns = bw_GBps_to_Bpns(transmission_bandwidth);
+}
+
+void Link::look_up_bandwidth_step(const EventTime time) noexcept {
+    assert(bandwidth_schedule != nullptr || background_schedule != nullptr);
+
+    // the steps in effect are the last ones started by then (transmissions may start out of order if
+    // contention-free), until either schedule steps again
+    bandwidth_step_begin = 0;
+    bandwidth_step_end = std::numeric_limits<EventTime>::max();
+    bandwidth_step = look_up_step(bandwidth_schedule, time, bandwidth_step_begin, bandwidth_step_end);
+    background_step = look_up_step(background_schedule, time, bandwidth_step_begin, bandwidth_step_end);
+    update_transmission_bandwidth();
+}
+
+DeviceId Link::get_src() const noexcept {
+    return src;
+}
+
+DeviceId Link::get_dest() const noexcept {
+    return dest;
+}
+
+Bandwidth Link::get_bandwidth() const noexcept {
+    return bandwidth;
+}
+
+Latency Link::get_latency() const noexcept {
+    return latency;
+}
+
+const LinkStats& Link::get_stats() const noexcept {
+    return stats;
+}
+
+bool Link::idle_at(const EventTime time, const Chunk& chunk) noexcept {
+    assert(link_model != LinkModel::Event);
+
+    if (contention_free) {
+        return true;
+    }
+    if (calendar != nullptr) {
+        auto timing = TrainTiming();
+        return find_calendar_gap(time, chunk, timing) == time;
+    }
+    return busy_until <= time;
+}
+
+Link::TrainTiming Link::plan_transmission(const EventTime start_time,
+                                          const Chunk& chunk,
+                                          const EventTime tail_arrival_time) noexcept {
+    assert(link_model == LinkModel::VirtualTime);
+
+    apply_bandwidth_schedule(start_time);
+    return train_timing(start_time, chunk.transmission_size, tail_arrival_time, train_packet_size(chunk));
+}
+
+void Link::reserve(const EventTime start_time, const TrainTiming& timing, Chunk& chunk) noexcept {
+    assert(link_model == LinkModel::VirtualTime);
+    assert(idle_at(start_time, chunk));
+
+    // occupy the link until the last packet is serialized (unless contention-free)
+    if (!contention_free) {
+        busy_until = timing.link_free_time;
+    }
+    record_transmission(chunk, start_time, start_time, timing);
+
+    // account the transmission
+    NETWORK_ANALYTICAL_STATS(stats.chunks_transmitted++);
+    NETWORK_ANALYTICAL_STATS(stats.bytes_transmitted += chunk.transmission_size);
+    NETWORK_ANALYTICAL_STATS(stats.busy_time += timing.link_free_time - start_time);
+
+    // head packet reaches the next device first, the last packet at tail_arrival_time
+    chunk.tail_arrival_time = timing.tail_arrival_time;
+}
+
 EventTime Link::serialization_delay(const ChunkSize chunk_size) const noexcept {
     assert(chunk_size > 0);
 
-    // calculate serialization delay
-    const auto delay = static_cast<Bandwidth>(chunk_size) / bandwidth_Bpns;
+    // calculate serialization delay, rounded down to a tick
+    // (divided by the bandwidth rather than multiplied by its reciprocal, which would round differently)
+    if (protocol == nullptr) {
+        const auto delay = static_cast<Bandwidth>(chunk_size) * ticks_per_ns / transmission_bandwidth_Bpns;
+        return static_cast<EventTime>(delay);
+    }
 
-    // return serialization delay in EventTime type
-    return static_cast<EventTime>(delay);
+    // framed: every packet adds its header bytes and gap
+    const auto packets_count = (protocol->mtu == 0) ? 1 : (chunk_size + protocol->mtu - 1) / protocol->mtu;
+    const auto wire_size = chunk_size + packets_count * protocol->header_size;
+    const auto delay = static_cast<Bandwidth>(wire_size) * ticks_per_ns / transmission_bandwidth_Bpns;
+    return static_cast<EventTime>(delay) + packets_count * ns_to_ticks(protocol->packet_gap);
 }
 
 EventTime Link::communication_delay(const ChunkSize chunk_size) const noexcept {
     assert(chunk_size > 0);
 
     // calculate communication delay
-    const auto delay = latency + (static_cast<Bandwidth>(chunk_size) / bandwidth_Bpns);
-
-    // return communication delay in EventTime type
-    return static_cast<EventTime>(delay);
+    return latency_ticks + serialization_delay(chunk_size);
 }
 
 void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
@@ -114,22 +723,490 @@ void Link::schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept {
     // link should be free
     assert(!busy);
 
+    // scheduler should be set
+    assert(scheduler != nullptr);
+
     // set link busy
     set_busy();
 
     // get metadata
-    const auto chunk_size = chunk->get_size();
-    const auto current_time = Link::event_queue->get_current_time();
+    const auto chunk_size = chunk->transmission_size;
+    const auto current_time = scheduler->get_current_time();
+    apply_bandwidth_schedule(current_time);
+    const auto timing = train_timing(current_time, chunk_size, chunk->tail_arrival_time, train_packet_size(*chunk));
+
+    // account the transmission: the chunk waited since it was enqueued,
+    // and occupies the link until its last packet is serialized
+    NETWORK_ANALYTICAL_STATS(chunk->queueing_delay += current_time - chunk->enqueued_time);
+    NETWORK_ANALYTICAL_STATS(stats.queueing_delay += current_time - chunk->enqueued_time);
+    NETWORK_ANALYTICAL_STATS(stats.chunks_transmitted++);
+    NETWORK_ANALYTICAL_STATS(stats.bytes_transmitted += chunk_size);
+    NETWORK_ANALYTICAL_STATS(stats.busy_time += timing.link_free_time - current_time);
+    record_transmission(*chunk, chunk->enqueued_time, current_time, timing);
+    serving_until = std::max(serving_until, timing.link_free_time);
 
     // schedule chunk arrival event
-    const auto communication_time = communication_delay(chunk_size);
-    const auto chunk_arrival_time = current_time + communication_time;
-    auto* const chunk_ptr = static_cast<void*>(chunk.release());
-    Link::event_queue->schedule_event(chunk_arrival_time, Chunk::chunk_arrived_next_device, chunk_ptr);
+    schedule_train_arrival(timing, std::move(chunk));
 
     // schedule link free time
-    const auto serialization_time = serialization_delay(chunk_size);
-    const auto link_free_time = current_time + serialization_time;
     auto* const link_ptr = static_cast<void*>(this);
-    Link::event_queue->schedule_event(link_free_time, link_become_free, link_ptr);
+    scheduler->schedule_event(timing.link_free_time, EventKind::LinkFree, link_ptr);
+}
+
+void Link::start_transmission(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // hold the chunk back until the next link's buffer has room (an empty buffer takes any chunk)
+    auto* const next_link = next_buffered_link(*chunk);
+    const auto chunk_size = chunk->transmission_size;
+    if (next_link != nullptr && next_link->buffered_bytes > 0 &&
+        next_link->buffered_bytes + chunk_size > next_link->buffer_capacity) {
+        next_link->blocked_links.push_back(this);
+        stalled_since = scheduler->get_current_time();
+        stalled_chunk = std::move(chunk);
+        return;
+    }
+
+    // the chunk moves from this link's buffer to the next one's
+    release_buffer(*chunk);
+    if (next_link != nullptr) {
+        next_link->buffered_bytes += chunk_size;
+        chunk->buffer_credit = chunk_size;
+    }
+
+    schedule_chunk_transmission(std::move(chunk));
+}
+
+Link* Link::next_buffered_link(const Chunk& chunk) const noexcept {
+    // unbounded buffers, or no next link (the next device is the destination, or isn't routed yet)
+    if (link_table == nullptr || chunk.hop_by_hop || chunk.multicast_tree != nullptr ||
+        chunk.route_index + 2 >= chunk.route->size()) {
+        return nullptr;
+    }
+
+    // only links queueing their chunks (LinkModel::Event) release their buffers
+    auto& next_link = (*link_table)[chunk.route->link_id(chunk.route_index + 1)];
+    if (next_link.buffer_capacity == 0 || next_link.contention_free || next_link.link_model != LinkModel::Event) {
+        return nullptr;
+    }
+    return &next_link;
+}
+
+void Link::release_buffer(Chunk& chunk) noexcept {
+    auto released_bytes = static_cast<ChunkSize>(0);
+    for (auto* buffered_chunk = &chunk; buffered_chunk != nullptr;
+         buffered_chunk = buffered_chunk->coalesced_chunks.get()) {
+        released_bytes += buffered_chunk->buffer_credit;
+        buffered_chunk->buffer_credit = 0;
+    }
+    if (released_bytes == 0) {
+        return;
+    }
+    assert(released_bytes <= buffered_bytes);
+    buffered_bytes -= released_bytes;
+
+    // blocked upstream links retry their stalled chunks
+    const auto current_time = scheduler->get_current_time();
+    for (auto* const blocked_link : blocked_links) {
+        scheduler->schedule_event(current_time, retry_stalled_transmission, static_cast<void*>(blocked_link));
+    }
+    blocked_links.clear();
+}
+
+void Link::schedule_virtual_time_transmission(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(contention_free || link_model != LinkModel::Event);
+
+    // scheduler should be set
+    assert(scheduler != nullptr);
+
+    // get metadata
+    const auto chunk_size = chunk->transmission_size;
+    const auto current_time = scheduler->get_current_time();
+
+    // calendar: chunk starts in the earliest gap fitting it, possibly ahead of slots reserved in advance
+    auto start_time = current_time;
+    auto timing = TrainTiming();
+    if (!contention_free && calendar != nullptr) {
+        start_time = find_calendar_gap(current_time, *chunk, timing);
+        book_calendar_slot(start_time, timing.link_free_time);
+    } else {
+        // FIFO: chunk starts once the chunks ahead of it are serialized
+        // (contention-free: right away, leaving the link free for the next chunks)
+        start_time = contention_free ? current_time : std::max(current_time, busy_until);
+        apply_bandwidth_schedule(start_time);
+        timing = train_timing(start_time, chunk_size, chunk->tail_arrival_time, train_packet_size(*chunk));
+        if (!contention_free) {
+            busy_until = timing.link_free_time;
+        }
+    }
+
+    // account the transmission
+    // (max_pending_chunks isn't tracked, as no pending chunks are kept)
+    NETWORK_ANALYTICAL_STATS(chunk->queueing_delay += start_time - current_time);
+    NETWORK_ANALYTICAL_STATS(stats.queueing_delay += start_time - current_time);
+    NETWORK_ANALYTICAL_STATS(stats.chunks_transmitted++);
+    NETWORK_ANALYTICAL_STATS(stats.bytes_transmitted += chunk_size);
+    NETWORK_ANALYTICAL_STATS(stats.busy_time += timing.link_free_time - start_time);
+    record_transmission(*chunk, current_time, start_time, timing);
+
+    // schedule chunk arrival event
+    schedule_train_arrival(timing, std::move(chunk));
+}
+
+EventTime Link::find_calendar_gap(const EventTime earliest_start_time,
+                                  const Chunk& chunk,
+                                  TrainTiming& timing) noexcept {
+    assert(calendar != nullptr);
+
+    // slots over by now can't hold anything anymore
+    auto& slots = *calendar;
+    const auto current_time = scheduler->get_current_time();
+    while (!slots.empty() && slots.begin()->second <= current_time) {
+        slots.erase(slots.begin());
+    }
+
+    // first fit: skip past the slot covering the start time, or past the next slot if the chunk overruns it
+    const auto chunk_packet_size = train_packet_size(chunk);
+    auto start_time = earliest_start_time;
+    while (true) {
+        const auto next_slot = slots.upper_bound(start_time);
+        if (next_slot != slots.begin() && std::prev(next_slot)->second > start_time) {
+            start_time = std::prev(next_slot)->second;
+            continue;
+        }
+
+        apply_bandwidth_schedule(start_time);
+        timing = train_timing(start_time, chunk.transmission_size, chunk.tail_arrival_time, chunk_packet_size);
+        if (next_slot != slots.end() && next_slot->first < timing.link_free_time) {
+            start_time = next_slot->second;
+            continue;
+        }
+        return start_time;
+    }
+}
+
+void Link::book_calendar_slot(const EventTime start_time, const EventTime end_time) noexcept {
+    assert(calendar != nullptr);
+    assert(start_time <= end_time);
+
+    busy_until = std::max(busy_until, end_time);
+    if (start_time == end_time) {
+        return;
+    }
+
+    // back-to-back chunks share a slot, so the calendar only grows with its gaps
+    auto& slots = *calendar;
+    auto next_slot = slots.lower_bound(start_time);
+    assert(next_slot == slots.end() || next_slot->first >= end_time);
+    auto slot_end_time = end_time;
+    if (next_slot != slots.end() && next_slot->first == end_time) {
+        slot_end_time = next_slot->second;
+        next_slot = slots.erase(next_slot);
+    }
+    if (next_slot != slots.begin() && std::prev(next_slot)->second == start_time) {
+        std::prev(next_slot)->second = slot_end_time;
+        return;
+    }
+    slots.emplace_hint(next_slot, start_time, slot_end_time);
+}
+
+ChunkSize Link::train_packet_size(const Chunk& chunk) const noexcept {
+    // the chunks of a message are packets of their own, unless packets are smaller
+    if (chunk.message_chunks_count > 1 && (packet_size == 0 || chunk.chunk_size < packet_size)) {
+        return chunk.chunk_size;
+    }
+
+    return packet_size;
+}
+
+Link::TrainTiming Link::train_timing(const EventTime start_time,
+                                     const ChunkSize chunk_size,
+                                     const EventTime tail_arrival_time,
+                                     const ChunkSize chunk_packet_size) const noexcept {
+    assert(chunk_size > 0);
+
+    auto timing = TrainTiming();
+
+    // cut-through: the head advances after the latency,
+    // and the serialization window can't end before the tail arrived from the previous hop
+    if (switching_mode == SwitchingMode::CutThrough) {
+        const auto serialization_time = serialization_delay(chunk_size);
+        const auto earliest_start_time =
+            (tail_arrival_time > serialization_time) ? tail_arrival_time - serialization_time : 0;
+        const auto serialization_start_time = std::max(start_time, earliest_start_time);
+        timing.link_free_time = serialization_start_time + serialization_time;
+        timing.head_arrival_time = start_time + latency_ticks;
+        timing.tail_arrival_time = serialization_start_time + communication_delay(chunk_size);
+        return timing;
+    }
+
+    // unpacketized: the whole chunk is a single packet (store-and-forward),
+    // which can't leave before it fully arrived from the previous hop
+    if (chunk_packet_size == 0 || chunk_size <= chunk_packet_size) {
+        const auto ready_time = std::max(start_time, tail_arrival_time);
+        timing.link_free_time = ready_time + serialization_delay(chunk_size);
+        timing.head_arrival_time = ready_time + communication_delay(chunk_size);
+        timing.tail_arrival_time = timing.head_arrival_time;
+        return timing;
+    }
+
+    // the train is a full-sized head packet, ..., and a (possibly smaller) last packet
+    const auto packets_count = (chunk_size + chunk_packet_size - 1) / chunk_packet_size;
+    const auto last_packet_offset = (packets_count - 1) * chunk_packet_size;
+    const auto last_packet_size = chunk_size - last_packet_offset;
+
+    // packets are serialized back to back,
+    // but the last one can't leave before it arrived from the previous hop
+    const auto last_packet_start_time =
+        std::max(start_time + serialization_delay(last_packet_offset), tail_arrival_time);
+
+    timing.link_free_time = last_packet_start_time + serialization_delay(last_packet_size);
+    timing.head_arrival_time = start_time + communication_delay(chunk_packet_size);
+    timing.tail_arrival_time = last_packet_start_time + communication_delay(last_packet_size);
+    return timing;
+}
+
+void Link::record_transmission(Chunk& chunk,
+                               const EventTime ready_time,
+                               const EventTime start_time,
+                               const TrainTiming& timing) const noexcept {
+    if constexpr (!observers_enabled) {
+        return;
+    }
+
+    if (link_trace != nullptr) {
+        link_trace->record_transmission(src, dest, chunk.src, chunk.dest, chunk.transmission_size, chunk.chunk_id,
+                                        get_queued_chunks_count(), start_time, timing.link_free_time,
+                                        timing.tail_arrival_time);
+    }
+
+    if (critical_path != nullptr) {
+        critical_path->record_transmission(this, src, dest, chunk, ready_time, start_time, timing.link_free_time,
+                                           timing.tail_arrival_time);
+    }
+
+    if (utilization_sampler != nullptr) {
+        utilization_sampler->record_transmission(sampler_row, chunk.transmission_size, start_time,
+                                                 timing.link_free_time);
+    }
+}
+
+void Link::sample_pending_chunks() const noexcept {
+    if (observers_enabled && utilization_sampler != nullptr) {
+        utilization_sampler->record_pending_chunks(sampler_row, scheduler->get_current_time(), pending_chunks_count());
+    }
+}
+
+void Link::schedule_train_arrival(const TrainTiming& timing, std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // coalesced chunks are delivered one by one
+    if (chunk->coalesced_chunks != nullptr && chunk->next_device() == chunk->dest) {
+        schedule_coalesced_arrivals(timing.tail_arrival_time, std::move(chunk));
+        return;
+    }
+
+    // the chunk is delivered once its last packet arrives,
+    // but is forwarded as soon as its head packet arrives (cut-through)
+    chunk->tail_arrival_time = timing.tail_arrival_time;
+    const auto next_device_is_dest = (chunk->next_device() == chunk->dest);
+    auto arrival_time = next_device_is_dest ? timing.tail_arrival_time : timing.head_arrival_time;
+
+    // the chunks of a message arrive one after the other, the first one after the later ones' serialization
+    // (and once their head arrived), and the message is delivered from the first one on
+    if (chunk->message_chunks_count > 1) {
+        const auto later_chunks_delay = serialization_delay(chunk->chunk_size * (chunk->message_chunks_count - 1));
+        const auto first_chunk_arrival_time = (timing.tail_arrival_time > later_chunks_delay)
+                                                  ? timing.tail_arrival_time - later_chunks_delay
+                                                  : timing.tail_arrival_time;
+        chunk->message_head_arrival_time = std::max(timing.head_arrival_time, first_chunk_arrival_time);
+        if (next_device_is_dest) {
+            arrival_time = chunk->message_head_arrival_time;
+        }
+    }
+    schedule_chunk_arrival(arrival_time, std::move(chunk));
+}
+
+void Link::schedule_chunk_arrival(const EventTime chunk_arrival_time, std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    auto* const chunk_ptr = static_cast<void*>(chunk.release());
+    if (arrival_mailbox != nullptr) {
+        arrival_mailbox->post(chunk_arrival_time, EventKind::ChunkArrival, chunk_ptr);
+    } else {
+        scheduler->schedule_event(chunk_arrival_time, EventKind::ChunkArrival, chunk_ptr);
+    }
+}
+
+void Link::enqueue_message_chunks(std::unique_ptr<Chunk> message) noexcept {
+    assert(message != nullptr);
+    assert(message->message_chunks_count > 1);
+    assert(message->chunk_pool != nullptr && message->owned_route == nullptr);
+
+    // the chunks reached the link one after the other, evenly from the head of the message to its tail
+    const auto chunks_count = message->message_chunks_count;
+    const auto head_arrival_time = message->message_head_arrival_time;
+    const auto arrival_span =
+        (message->tail_arrival_time > head_arrival_time) ? message->tail_arrival_time - head_arrival_time : 0;
+
+    // the message becomes its first chunk,
+    // its NIC slot goes to the last chunk (released once all are delivered), its buffer credit is split
+    const auto nic_metered = message->nic_metered;
+    const auto buffer_credit = message->buffer_credit / chunks_count;
+    message->message_chunks_count = 1;
+    message->transmission_size = message->chunk_size;
+    message->tail_arrival_time = head_arrival_time;
+    message->nic_metered = false;
+    message->buffer_credit = buffer_credit;
+    const auto& first_chunk = *message;
+    enqueue_pending_chunk(std::move(message));
+
+    // the later chunks, taken from the pool
+    for (auto i = static_cast<uint32_t>(1); i < chunks_count; i++) {
+        auto chunk = first_chunk.chunk_pool->acquire(first_chunk.chunk_size, first_chunk.route, first_chunk.callback,
+                                                     first_chunk.callback_arg);
+        chunk->route_index = first_chunk.route_index;
+        chunk->src = first_chunk.src;
+        chunk->dest = first_chunk.dest;
+        chunk->hops_count = first_chunk.hops_count;
+        chunk->hop_by_hop = first_chunk.hop_by_hop;
+        chunk->topology = first_chunk.topology;
+        chunk->chunk_id = first_chunk.chunk_id;
+        chunk->inject_time = first_chunk.inject_time;
+        chunk->enqueued_time = first_chunk.enqueued_time;
+        chunk->queueing_delay = first_chunk.queueing_delay;
+        chunk->critical_path_step = first_chunk.critical_path_step;
+        chunk->traffic_class = first_chunk.traffic_class;
+        chunk->job_id = first_chunk.job_id;
+        chunk->has_payload = first_chunk.has_payload;
+        std::memcpy(chunk->payload_bytes, first_chunk.payload_bytes, Chunk::payload_capacity);
+        chunk->buffer_credit = buffer_credit;
+        chunk->nic_metered = nic_metered && i == chunks_count - 1;
+        chunk->tail_arrival_time = head_arrival_time + arrival_span * i / (chunks_count - 1);
+        enqueue_pending_chunk(std::move(chunk));
+    }
+}
+
+void Link::enqueue_pending_chunk(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // input port: the previous device of the route (hop-by-hop routes only hold the current hop)
+    if (source_arbitration) {
+        const auto from_previous_hop = chunk->route_index > 0 && !chunk->hop_by_hop;
+        chunk->queue_source = from_previous_hop ? (*chunk->route)[chunk->route_index - 1] : chunk->src;
+    }
+    pending_bytes += chunk->transmission_size;
+
+    if (class_queues == nullptr) {
+        pending_chunks.push_back(std::move(chunk));
+        return;
+    }
+
+    const auto traffic_class = chunk->traffic_class;
+    class_queues->queues[traffic_class].push_back(std::move(chunk));
+    class_queues->chunks_count++;
+}
+
+ChunkQueue& Link::next_pending_queue() noexcept {
+    assert(pending_chunk_exists());
+
+    if (class_queues == nullptr) {
+        return pending_chunks;
+    }
+    auto& queues = class_queues->queues;
+
+    // strict priority: the most urgent class waiting
+    if (queueing_policy == QueueingPolicy::StrictPriority) {
+        auto traffic_class = 0;
+        while (queues[traffic_class].empty()) {
+            traffic_class++;
+        }
+        return queues[traffic_class];
+    }
+
+    // weighted round robin: the current class serves until its weight is used up or it runs empty,
+    // then the turn passes to the next class waiting
+    auto& current_class = class_queues->current_class;
+    auto& served_count = class_queues->served_count;
+    if (queues[current_class].empty() || served_count >= class_queues->weights[current_class]) {
+        do {
+            current_class = (current_class + 1) % max_traffic_classes;
+        } while (queues[current_class].empty());
+        served_count = 0;
+    }
+    served_count++;
+    return queues[current_class];
+}
+
+int Link::pending_chunks_count() const noexcept {
+    return (class_queues != nullptr) ? class_queues->chunks_count : pending_chunks.size();
+}
+
+void Link::coalesce_pending_chunks(Chunk& chunk, ChunkQueue& queue) noexcept {
+    // coalesced chunks travel as one store-and-forward transmission, recorded once
+    if (packet_size != 0 || switching_mode != SwitchingMode::StoreAndForward ||
+        (observers_enabled && critical_path != nullptr)) {
+        return;
+    }
+    if (chunk.hop_by_hop || chunk.multicast_tree != nullptr) {
+        return;
+    }
+
+    // find the last chunk coalesced so far
+    auto* tail_chunk = &chunk;
+    while (tail_chunk->coalesced_chunks != nullptr) {
+        tail_chunk = tail_chunk->coalesced_chunks.get();
+    }
+
+    // take the chunks behind on the same route, at the same position
+    while (!queue.empty()) {
+        const auto& next_chunk = queue.front();
+        if (next_chunk.route != chunk.route || next_chunk.route_index != chunk.route_index ||
+            next_chunk.hop_by_hop || next_chunk.multicast_tree != nullptr) {
+            break;
+        }
+
+        // the chunk stops waiting now
+        auto coalesced_chunk = queue.pop_front();
+        const auto current_time = scheduler->get_current_time();
+        NETWORK_ANALYTICAL_STATS(coalesced_chunk->queueing_delay += current_time - coalesced_chunk->enqueued_time);
+        NETWORK_ANALYTICAL_STATS(stats.queueing_delay += current_time - coalesced_chunk->enqueued_time);
+        NETWORK_ANALYTICAL_STATS(stats.chunks_coalesced++);
+        chunk.transmission_size += coalesced_chunk->transmission_size;
+        coalesced_chunk->transmission_size = coalesced_chunk->chunk_size;
+
+        // append it (with the chunks it carries) to the tail
+        tail_chunk->coalesced_chunks = std::move(coalesced_chunk);
+        while (tail_chunk->coalesced_chunks != nullptr) {
+            tail_chunk = tail_chunk->coalesced_chunks.get();
+        }
+    }
+}
+
+void Link::schedule_coalesced_arrivals(const EventTime tail_arrival_time, std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // the chunks share the position of the first one
+    const auto route_index = chunk->route_index;
+    const auto hops_count = chunk->hops_count;
+    auto* const topology = chunk->topology;
+
+    // each chunk arrives once the bytes up to its own are serialized
+    auto remaining_size = chunk->transmission_size;
+    while (chunk != nullptr) {
+        auto next_chunk = std::move(chunk->coalesced_chunks);
+        remaining_size -= chunk->chunk_size;
+        const auto arrival_time =
+            (remaining_size > 0) ? tail_arrival_time - serialization_delay(remaining_size) : tail_arrival_time;
+
+        chunk->route_index = route_index;
+        chunk->hops_count = hops_count;
+        chunk->topology = topology;
+        chunk->transmission_size = chunk->chunk_size;
+        chunk->tail_arrival_time = arrival_time;
+        schedule_chunk_arrival(arrival_time, std::move(chunk));
+
+        chunk = std::move(next_chunk);
+    }
 }
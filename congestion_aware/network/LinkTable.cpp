@@ -0,0 +1,522 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LinkTable.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <tuple>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+LinkTable::LinkTable() noexcept
+    : links_count(0),
+      materialized_links_count(0),
+      lazy_bandwidth(0),
+      lazy_latency(0),
+      scheduler(nullptr),
+      link_model(LinkModel::Event),
+      packet_size(0),
+      switching_mode(SwitchingMode::StoreAndForward),
+      protocol(nullptr),
+      chunk_coalescing(false),
+      source_arbitration(false),
+      channels_count(1),
+      channel_mode(ChannelMode::Striped),
+      buffer_capacity(0),
+      queueing_policy(QueueingPolicy::FIFO),
+      class_weights() {}
+
+void LinkTable::make_lazy(const int new_links_count,
+                          LinkEndpoints endpoints,
+                          const Bandwidth bandwidth,
+                          const Latency latency) noexcept {
+    assert(links_count == 0);
+    assert(new_links_count >= 0);
+    assert(endpoints != nullptr);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // only the page index is allocated upfront
+    links_count = new_links_count;
+    lazy_endpoints = std::move(endpoints);
+    lazy_bandwidth = bandwidth;
+    lazy_latency = latency;
+    pages.resize((links_count + page_size - 1) / page_size);
+}
+
+void LinkTable::copy_layout(const LinkTable& other) noexcept {
+    assert(links_count == 0);
+
+    if (other.lazy()) {
+        make_lazy(static_cast<int>(other.links_count), other.lazy_endpoints, other.lazy_bandwidth, other.lazy_latency);
+        override_parameters = other.override_parameters;
+        overridden_links = other.overridden_links;
+        channels_count = other.channels_count;
+        channel_mode = other.channel_mode;
+        copy_bandwidth_schedules(other);
+        return;
+    }
+
+    // appended tables are fully materialized, so their links are read as is
+    reserve(other.links_count);
+    for (const auto& link : other) {
+        emplace_back(link.get_src(), link.get_dest(), link.get_bandwidth(), link.get_latency());
+        (*this)[links_count - 1].set_contention_free(link.is_contention_free());
+        (*this)[links_count - 1].set_channels(link.get_channels_count(), link.get_channel_mode());
+    }
+    copy_bandwidth_schedules(other);
+}
+
+void LinkTable::set_lazy_parameters(const Bandwidth bandwidth, const Latency latency) noexcept {
+    assert(lazy());
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    lazy_bandwidth = bandwidth;
+    lazy_latency = latency;
+    override_parameters.clear();
+    overridden_links.clear();
+    for (auto& link : *this) {
+        link.set_parameters(bandwidth, latency);
+    }
+}
+
+void LinkTable::set_link_parameters(const LinkId link_id, const Bandwidth bandwidth, const Latency latency) noexcept {
+    assert(0 <= link_id && link_id < static_cast<LinkId>(links_count));
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    if (!lazy()) {
+        (*this)[link_id].set_parameters(bandwidth, latency);
+        return;
+    }
+
+    // a lazy link picks up its override once materialized
+    const auto parameters = std::make_pair(bandwidth, latency);
+    auto it = std::find(override_parameters.begin(), override_parameters.end(), parameters);
+    if (it == override_parameters.end()) {
+        it = override_parameters.insert(it, parameters);
+    }
+    overridden_links[link_id] = static_cast<int>(it - override_parameters.begin());
+    if (materialized(link_id)) {
+        (*this)[link_id].set_parameters(bandwidth, latency);
+    }
+}
+
+void LinkTable::set_bandwidth_schedule(const LinkId link_id, const BandwidthSchedule& schedule) noexcept {
+    assert(0 <= link_id && link_id < static_cast<LinkId>(links_count));
+    assert(std::all_of(schedule.begin(), schedule.end(), [](const auto& step) { return step.bandwidth > 0; }));
+
+    if (schedule.empty()) {
+        scheduled_links.erase(link_id);
+        if (!lazy() || materialized(link_id)) {
+            (*this)[link_id].set_bandwidth_schedule(nullptr);
+        }
+        return;
+    }
+
+    // links of the same schedule share it (there are few distinct ones)
+    const auto same_steps = [&schedule](const std::unique_ptr<BandwidthSchedule>& other) {
+        const auto same_step = [](const BandwidthStep& lhs, const BandwidthStep& rhs) {
+            return lhs.time == rhs.time && lhs.bandwidth == rhs.bandwidth;
+        };
+        return std::equal(schedule.begin(), schedule.end(), other->begin(), other->end(), same_step);
+    };
+    auto it = std::find_if(bandwidth_schedules.begin(), bandwidth_schedules.end(), same_steps);
+    if (it == bandwidth_schedules.end()) {
+        it = bandwidth_schedules.insert(it, std::make_unique<BandwidthSchedule>(schedule));
+    }
+    scheduled_links[link_id] = static_cast<int>(it - bandwidth_schedules.begin());
+
+    // a lazy link picks up its schedule once materialized
+    if (!lazy() || materialized(link_id)) {
+        (*this)[link_id].set_bandwidth_schedule(it->get());
+    }
+}
+
+void LinkTable::set_background_schedule(const LinkId link_id, const BackgroundSchedule& schedule) noexcept {
+    assert(0 <= link_id && link_id < static_cast<LinkId>(links_count));
+    assert(std::all_of(schedule.begin(), schedule.end(),
+                       [](const auto& step) { return 0 <= step.utilization && step.utilization < 1; }));
+
+    if (schedule.empty()) {
+        loaded_links.erase(link_id);
+        if (!lazy() || materialized(link_id)) {
+            (*this)[link_id].set_background_schedule(nullptr);
+        }
+        return;
+    }
+
+    // links of the same schedule share it (there are few distinct ones)
+    const auto same_steps = [&schedule](const std::unique_ptr<BackgroundSchedule>& other) {
+        const auto same_step = [](const BackgroundStep& lhs, const BackgroundStep& rhs) {
+            return lhs.time == rhs.time && lhs.utilization == rhs.utilization;
+        };
+        return std::equal(schedule.begin(), schedule.end(), other->begin(), other->end(), same_step);
+    };
+    auto it = std::find_if(background_schedules.begin(), background_schedules.end(), same_steps);
+    if (it == background_schedules.end()) {
+        it = background_schedules.insert(it, std::make_unique<BackgroundSchedule>(schedule));
+    }
+    loaded_links[link_id] = static_cast<int>(it - background_schedules.begin());
+
+    // a lazy link picks up its schedule once materialized
+    if (!lazy() || materialized(link_id)) {
+        (*this)[link_id].set_background_schedule(it->get());
+    }
+}
+
+bool LinkTable::lazy() const noexcept {
+    return lazy_endpoints != nullptr;
+}
+
+void LinkTable::reserve(const size_t new_links_count) noexcept {
+    assert(!lazy());
+
+    // the remaining links get a block of their own once the current one is full
+    pages.reserve((new_links_count + page_size - 1) / page_size);
+    if (new_links_count > links_count && (blocks.empty() || blocks.back().size() == blocks.back().capacity())) {
+        const auto pages_count = (new_links_count - links_count + page_size - 1) / page_size;
+        blocks.emplace_back(pages_count * page_size);
+    }
+}
+
+void LinkTable::emplace_back(const DeviceId src,
+                             const DeviceId dest,
+                             const Bandwidth bandwidth,
+                             const Latency latency) noexcept {
+    assert(!lazy());
+
+    // open a block of a page once the last one is full (blocks never reallocate)
+    if (blocks.empty() || blocks.back().size() == blocks.back().capacity()) {
+        blocks.emplace_back(page_size);
+    }
+
+    auto& block = blocks.back();
+    if (links_count % page_size == 0) {
+        pages.push_back(block.data() + block.size());
+    }
+    auto& link = block.emplace_at(block.size(), src, dest, bandwidth, latency, scheduler);
+    block.set_size(block.size() + 1);
+    apply_settings(link);
+    links_count++;
+    materialized_links_count++;
+}
+
+void LinkTable::assign(const std::vector<std::pair<DeviceId, DeviceId>>& endpoints,
+                       const Bandwidth bandwidth,
+                       const Latency latency,
+                       const int threads_count) noexcept {
+    assert(!lazy());
+    assert(links_count == 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+    assert(threads_count >= 0);
+
+    // every link goes in a single block, whose pages are disjoint, so each task constructs a run of them
+    // on its own (runs of 16 pages, about 150 KB, so small tables stay on the calling thread)
+    constexpr auto pages_per_task = 16;
+    const auto pages_count = (endpoints.size() + page_size - 1) / page_size;
+    const auto tasks_count = static_cast<int>((pages_count + pages_per_task - 1) / pages_per_task);
+    if (pages_count == 0) {
+        return;
+    }
+    auto& block = blocks.emplace_back(pages_count * page_size);
+    pages.resize(pages_count);
+    for (auto page = static_cast<size_t>(0); page < pages_count; page++) {
+        pages[page] = block.data() + (page * page_size);
+    }
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(tasks_count, [this, &block, &endpoints, bandwidth, latency, pages_count](const int task_id) {
+        const auto first_link_id = static_cast<size_t>(task_id) * pages_per_task * page_size;
+        const auto last_link_id =
+            std::min(std::min(static_cast<size_t>(task_id + 1) * pages_per_task, pages_count) * page_size,
+                     endpoints.size());
+        for (auto link_id = first_link_id; link_id < last_link_id; link_id++) {
+            const auto [src, dest] = endpoints[link_id];
+            auto& link = block.emplace_at(link_id, src, dest, bandwidth, latency, scheduler);
+            apply_settings(link);
+        }
+    });
+    block.set_size(endpoints.size());
+
+    links_count = endpoints.size();
+    materialized_links_count = links_count;
+}
+
+size_t LinkTable::size() const noexcept {
+    return links_count;
+}
+
+size_t LinkTable::materialized_size() const noexcept {
+    return materialized_links_count;
+}
+
+bool LinkTable::materialized(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < links_count);
+
+    return pages[link_id / page_size] != nullptr;
+}
+
+std::pair<DeviceId, DeviceId> LinkTable::endpoints(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < static_cast<LinkId>(links_count));
+
+    if (lazy()) {
+        return lazy_endpoints(link_id);
+    }
+
+    const auto& link = (*this)[link_id];
+    return {link.get_src(), link.get_dest()};
+}
+
+void LinkTable::materialize_all() noexcept {
+    for (auto page = static_cast<size_t>(0); page < pages.size(); page++) {
+        if (pages[page] == nullptr) {
+            materialize_page(page);
+        }
+    }
+}
+
+uint64_t LinkTable::get_allocated_bytes() const noexcept {
+    auto allocated_bytes =
+        static_cast<uint64_t>((pages.capacity() * sizeof(Link*)) + (blocks.capacity() * sizeof(LinkBlock)));
+    for (const auto& block : blocks) {
+        allocated_bytes += block.capacity() * sizeof(Link);
+    }
+    return allocated_bytes;
+}
+
+void LinkTable::set_scheduler(NetworkScheduler* const new_scheduler) noexcept {
+    assert(new_scheduler != nullptr);
+
+    scheduler = new_scheduler;
+    for (auto& link : *this) {
+        link.set_scheduler(scheduler);
+    }
+}
+
+void LinkTable::set_link_model(const LinkModel new_link_model) noexcept {
+    link_model = new_link_model;
+    for (auto& link : *this) {
+        link.set_link_model(link_model);
+    }
+}
+
+LinkModel LinkTable::get_link_model() const noexcept {
+    return link_model;
+}
+
+void LinkTable::set_packet_size(const ChunkSize new_packet_size) noexcept {
+    packet_size = new_packet_size;
+    for (auto& link : *this) {
+        link.set_packet_size(packet_size);
+    }
+}
+
+void LinkTable::set_switching_mode(const SwitchingMode new_switching_mode) noexcept {
+    switching_mode = new_switching_mode;
+    for (auto& link : *this) {
+        link.set_switching_mode(switching_mode);
+    }
+}
+
+void LinkTable::set_protocol(const LinkProtocol& new_protocol) noexcept {
+    // links point to the protocol, so it's updated in place once allocated
+    if (protocol == nullptr) {
+        protocol = std::make_unique<LinkProtocol>(new_protocol);
+    } else {
+        *protocol = new_protocol;
+    }
+    for (auto& link : *this) {
+        link.set_protocol(protocol.get());
+    }
+}
+
+void LinkTable::set_chunk_coalescing(const bool new_chunk_coalescing) noexcept {
+    chunk_coalescing = new_chunk_coalescing;
+    for (auto& link : *this) {
+        link.set_chunk_coalescing(chunk_coalescing);
+    }
+}
+
+void LinkTable::set_source_arbitration(const bool new_source_arbitration) noexcept {
+    source_arbitration = new_source_arbitration;
+    for (auto& link : *this) {
+        link.set_source_arbitration(source_arbitration);
+    }
+}
+
+void LinkTable::set_channels(const int new_channels_count, const ChannelMode new_channel_mode) noexcept {
+    channels_count = new_channels_count;
+    channel_mode = new_channel_mode;
+    for (auto& link : *this) {
+        link.set_channels(channels_count, channel_mode);
+    }
+}
+
+void LinkTable::set_buffer_capacity(const ChunkSize new_buffer_capacity) noexcept {
+    buffer_capacity = new_buffer_capacity;
+    for (auto& link : *this) {
+        link.set_buffer_capacity(buffer_capacity, (buffer_capacity > 0) ? this : nullptr);
+    }
+}
+
+void LinkTable::set_queueing_policy(const QueueingPolicy new_queueing_policy,
+                                    const std::array<int, Link::max_traffic_classes>& new_class_weights) noexcept {
+    queueing_policy = new_queueing_policy;
+    class_weights = new_class_weights;
+    for (auto& link : *this) {
+        link.set_queueing_policy(queueing_policy, class_weights);
+    }
+}
+
+LinkTable::iterator LinkTable::begin() noexcept {
+    return {&pages, links_count, 0};
+}
+
+LinkTable::iterator LinkTable::end() noexcept {
+    return {&pages, links_count, links_count};
+}
+
+LinkTable::const_iterator LinkTable::begin() const noexcept {
+    return {&pages, links_count, 0};
+}
+
+LinkTable::const_iterator LinkTable::end() const noexcept {
+    return {&pages, links_count, links_count};
+}
+
+void LinkTable::apply_settings(Link& link) const noexcept {
+    // links are created with the defaults, so only changed settings are applied
+    if (link_model != LinkModel::Event) {
+        link.set_link_model(link_model);
+    }
+    if (packet_size != 0) {
+        link.set_packet_size(packet_size);
+    }
+    if (switching_mode != SwitchingMode::StoreAndForward) {
+        link.set_switching_mode(switching_mode);
+    }
+    if (protocol != nullptr) {
+        link.set_protocol(protocol.get());
+    }
+    if (chunk_coalescing) {
+        link.set_chunk_coalescing(chunk_coalescing);
+    }
+    if (source_arbitration) {
+        link.set_source_arbitration(source_arbitration);
+    }
+    if (queueing_policy != QueueingPolicy::FIFO) {
+        link.set_queueing_policy(queueing_policy, class_weights);
+    }
+    if (buffer_capacity != 0) {
+        link.set_buffer_capacity(buffer_capacity, this);
+    }
+    if (channels_count != 1 || channel_mode != ChannelMode::Striped) {
+        link.set_channels(channels_count, channel_mode);
+    }
+}
+
+void LinkTable::copy_bandwidth_schedules(const LinkTable& other) noexcept {
+    for (const auto& [link_id, schedule_index] : other.scheduled_links) {
+        set_bandwidth_schedule(link_id, *other.bandwidth_schedules[schedule_index]);
+    }
+    for (const auto& [link_id, schedule_index] : other.loaded_links) {
+        set_background_schedule(link_id, *other.background_schedules[schedule_index]);
+    }
+}
+
+Link* LinkTable::materialize_page(const size_t page) const noexcept {
+    assert(lazy());
+    assert(page < pages.size());
+    assert(pages[page] == nullptr);
+
+    // create every link of the page, in a block of its own
+    const auto first_link_id = static_cast<LinkId>(page * page_size);
+    const auto last_link_id = std::min(first_link_id + page_size, static_cast<LinkId>(links_count));
+    auto& block = blocks.emplace_back(last_link_id - first_link_id);
+    for (auto link_id = first_link_id; link_id < last_link_id; link_id++) {
+        const auto [src, dest] = lazy_endpoints(link_id);
+        auto bandwidth = lazy_bandwidth;
+        auto latency = lazy_latency;
+        if (!overridden_links.empty()) {
+            const auto it = overridden_links.find(link_id);
+            if (it != overridden_links.end()) {
+                std::tie(bandwidth, latency) = override_parameters[it->second];
+            }
+        }
+        auto& link = block.emplace_at(link_id - first_link_id, src, dest, bandwidth, latency, scheduler);
+        apply_settings(link);
+        if (!scheduled_links.empty()) {
+            const auto it = scheduled_links.find(link_id);
+            if (it != scheduled_links.end()) {
+                link.set_bandwidth_schedule(bandwidth_schedules[it->second].get());
+            }
+        }
+        if (!loaded_links.empty()) {
+            const auto it = loaded_links.find(link_id);
+            if (it != loaded_links.end()) {
+                link.set_background_schedule(background_schedules[it->second].get());
+            }
+        }
+    }
+    block.set_size(block.capacity());
+    materialized_links_count += block.size();
+    pages[page] = block.data();
+    return block.data();
+}
+
+LinkTable::LinkBlock::LinkBlock(const size_t capacity) noexcept
+    : links(std::allocator<Link>().allocate(capacity)),
+      links_count(0),
+      links_capacity(capacity) {}
+
+LinkTable::LinkBlock::LinkBlock(LinkBlock&& other) noexcept
+    : links(other.links),
+      links_count(other.links_count),
+      links_capacity(other.links_capacity) {
+    other.links = nullptr;
+    other.links_count = 0;
+    other.links_capacity = 0;
+}
+
+LinkTable::LinkBlock::~LinkBlock() noexcept {
+    if (links == nullptr) {
+        return;
+    }
+    std::destroy_n(links, links_count);
+    std::allocator<Link>().deallocate(links, links_capacity);
+}
+
+Link* LinkTable::LinkBlock::data() const noexcept {
+    return links;
+}
+
+size_t LinkTable::LinkBlock::size() const noexcept {
+    return links_count;
+}
+
+size_t LinkTable::LinkBlock::capacity() const noexcept {
+    return links_capacity;
+}
+
+Link& LinkTable::LinkBlock::emplace_at(const size_t index,
+                                       const DeviceId src,
+                                       const DeviceId dest,
+                                       const Bandwidth bandwidth,
+                                       const Latency latency,
+                                       NetworkScheduler* const scheduler) noexcept {
+    assert(index < links_capacity);
+
+    return *new (links + index) Link(src, dest, bandwidth, latency, scheduler);
+}
+
+void LinkTable::LinkBlock::set_size(const size_t new_size) noexcept {
+    assert(new_size <= links_capacity);
+
+    links_count = new_size;
+}
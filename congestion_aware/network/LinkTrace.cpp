@@ -0,0 +1,181 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/LinkTrace.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+LinkTrace::LinkTrace(const std::string& trace_path, const size_t buffer_size, const Compression compression) noexcept
+    : trace_file(trace_path, compression, buffer_size),
+      transmissions_count(0),
+      first_event(true),
+      written_transmissions_count(0),
+      armed(false),
+      history_head(0),
+      history_count(0),
+      followup_count(0),
+      remaining_followup_count(0),
+      triggers_count(0) {
+    assert(buffer_size > 0);
+
+    trace_file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+}
+
+LinkTrace::~LinkTrace() noexcept {
+    close();
+}
+
+void LinkTrace::name_link(const DeviceId src, const DeviceId dest) noexcept {
+    assert(src >= 0);
+    assert(dest >= 0);
+
+    const auto lock = std::lock_guard<std::mutex>(trace_mutex);
+    const auto pid = std::to_string(src);
+    const auto tid = std::to_string(dest);
+    append_event("{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" + pid + ",\"args\":{\"name\":\"Device " + pid +
+                 "\"}}");
+    append_event("{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" + pid + ",\"tid\":" + tid +
+                 ",\"args\":{\"name\":\"Link " + pid + " -> " + tid + "\"}}");
+}
+
+void LinkTrace::arm(const TraceTrigger& new_trigger,
+                    const size_t history_size,
+                    const uint64_t new_followup_count) noexcept {
+    assert(history_size > 0);
+    assert(new_trigger.queue_depth_threshold > 0);
+
+    const auto lock = std::lock_guard<std::mutex>(trace_mutex);
+    armed = true;
+    trigger = new_trigger;
+    history.assign(history_size, Transmission());
+    history_head = 0;
+    history_count = 0;
+    followup_count = new_followup_count;
+    remaining_followup_count = 0;
+}
+
+void LinkTrace::record_transmission(const DeviceId src,
+                                    const DeviceId dest,
+                                    const DeviceId chunk_src,
+                                    const DeviceId chunk_dest,
+                                    const ChunkSize chunk_size,
+                                    const uint64_t chunk_id,
+                                    const int queue_depth,
+                                    const EventTime start_time,
+                                    const EventTime link_free_time,
+                                    const EventTime arrival_time) noexcept {
+    assert(start_time <= link_free_time);
+    assert(start_time <= arrival_time);
+
+    const auto lock = std::lock_guard<std::mutex>(trace_mutex);
+    const auto transmission = Transmission{transmissions_count++, src,        dest,           chunk_src,   chunk_dest,
+                                           chunk_size,            chunk_id,   start_time,     link_free_time,
+                                           arrival_time};
+    if (!armed) {
+        write_transmission(transmission);
+        return;
+    }
+
+    // a trigger writes the history leading to it, then its followup
+    if (fires(transmission, queue_depth)) {
+        triggers_count++;
+        for (auto i = size_t(0); i < history_count; i++) {
+            write_transmission(history[(history_head + i) % history.size()]);
+        }
+        history_head = 0;
+        history_count = 0;
+        write_transmission(transmission);
+        remaining_followup_count = followup_count;
+        return;
+    }
+    if (remaining_followup_count > 0) {
+        remaining_followup_count--;
+        write_transmission(transmission);
+        return;
+    }
+
+    // otherwise, the transmission overwrites the oldest one once the history is full
+    if (history_count < history.size()) {
+        history[(history_head + history_count) % history.size()] = transmission;
+        history_count++;
+    } else {
+        history[history_head] = transmission;
+        history_head = (history_head + 1) % history.size();
+    }
+}
+
+void LinkTrace::close() noexcept {
+    const auto lock = std::lock_guard<std::mutex>(trace_mutex);
+    if (!trace_file.is_open()) {
+        return;
+    }
+
+    trace_file << "\n]}\n";
+    trace_file.close();
+}
+
+uint64_t LinkTrace::get_transmissions_count() const noexcept {
+    return transmissions_count;
+}
+
+uint64_t LinkTrace::get_written_transmissions_count() const noexcept {
+    return written_transmissions_count;
+}
+
+uint64_t LinkTrace::get_triggers_count() const noexcept {
+    return triggers_count;
+}
+
+void LinkTrace::append_event(const std::string& event) noexcept {
+    assert(trace_file.is_open());
+
+    if (!first_event) {
+        trace_file << ",\n";
+    }
+    first_event = false;
+    trace_file << event;
+}
+
+bool LinkTrace::fires(const Transmission& transmission, const int queue_depth) const noexcept {
+    if (trigger.window_start <= transmission.start_time && transmission.start_time < trigger.window_end) {
+        return true;
+    }
+    if (transmission.src == trigger.link_src && transmission.dest == trigger.link_dest &&
+        queue_depth >= trigger.queue_depth_threshold) {
+        return true;
+    }
+    return trigger.chunk_id != TraceTrigger::no_chunk && transmission.chunk_id == trigger.chunk_id;
+}
+
+void LinkTrace::write_transmission(const Transmission& transmission) noexcept {
+    written_transmissions_count++;
+    const auto hop_id = std::to_string(transmission.hop_id);
+    const auto pid = std::to_string(transmission.src);
+    const auto tid = std::to_string(transmission.dest);
+    const auto args = ",\"args\":{\"chunk_src\":" + std::to_string(transmission.chunk_src) +
+                      ",\"chunk_dest\":" + std::to_string(transmission.chunk_dest) +
+                      ",\"bytes\":" + std::to_string(transmission.chunk_size) +
+                      ",\"chunk\":" + std::to_string(transmission.chunk_id) + "}}";
+
+    // busy interval of the link
+    append_event("{\"ph\":\"X\",\"cat\":\"link\",\"name\":\"busy\",\"pid\":" + pid + ",\"tid\":" + tid +
+                 ",\"ts\":" + timestamp(transmission.start_time) +
+                 ",\"dur\":" + timestamp(transmission.link_free_time - transmission.start_time) + args);
+
+    // hop span of the chunk
+    const auto hop_name = "\"hop " + pid + " -> " + tid + "\"";
+    append_event("{\"ph\":\"b\",\"cat\":\"hop\",\"name\":" + hop_name + ",\"id\":" + hop_id + ",\"pid\":" + pid +
+                 ",\"tid\":" + tid + ",\"ts\":" + timestamp(transmission.start_time) + args);
+    append_event("{\"ph\":\"e\",\"cat\":\"hop\",\"name\":" + hop_name + ",\"id\":" + hop_id + ",\"pid\":" + pid +
+                 ",\"tid\":" + tid + ",\"ts\":" + timestamp(transmission.arrival_time) + "}");
+}
+
+std::string LinkTrace::timestamp(const EventTime time) noexcept {
+    // trace timestamps are in us, keep the ns as fraction
+    const auto fraction = std::to_string(time % 1'000);
+    return std::to_string(time / 1'000) + "." + std::string(3 - fraction.size(), '0') + fraction;
+}
@@ -0,0 +1,96 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/MulticastTree.h"
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+MulticastTree::MulticastTree(const DeviceId src) noexcept : dests_count(0) {
+    assert(src >= 0);
+
+    // the root holds the src device
+    nodes.push_back({src, false, Route(), {}});
+    node_per_device.emplace(src, root);
+}
+
+void MulticastTree::add_route(const Route& route) noexcept {
+    assert(route.size() >= 2);
+    assert(route.front() == get_src());
+    assert(route.links_resolved());
+
+    // walk the route, attaching the devices the tree doesn't reach yet
+    auto parent = root;
+    for (auto hop = 0; hop < route.size() - 1; hop++) {
+        const auto device = route[hop + 1];
+        const auto [it, inserted] = node_per_device.try_emplace(device, static_cast<int>(nodes.size()));
+        if (inserted) {
+            auto edge_route = Route({route[hop], device});
+            edge_route.set_link_id(0, route.link_id(hop));
+            edge_route.mark_links_resolved();
+            nodes.push_back({device, false, std::move(edge_route), {}});
+            nodes[parent].children.push_back(it->second);
+        }
+        parent = it->second;
+    }
+
+    // the last device is a dest
+    if (!nodes[parent].dest) {
+        nodes[parent].dest = true;
+        dests_count++;
+    }
+}
+
+DeviceId MulticastTree::get_src() const noexcept {
+    return nodes[root].device;
+}
+
+int MulticastTree::get_nodes_count() const noexcept {
+    return static_cast<int>(nodes.size());
+}
+
+int MulticastTree::get_edges_count() const noexcept {
+    return static_cast<int>(nodes.size()) - 1;
+}
+
+int MulticastTree::get_dests_count() const noexcept {
+    return dests_count;
+}
+
+DeviceId MulticastTree::get_device(const int node) const noexcept {
+    assert(0 <= node && node < get_nodes_count());
+
+    return nodes[node].device;
+}
+
+bool MulticastTree::is_dest(const int node) const noexcept {
+    assert(0 <= node && node < get_nodes_count());
+
+    return nodes[node].dest;
+}
+
+const std::vector<int>& MulticastTree::get_children(const int node) const noexcept {
+    assert(0 <= node && node < get_nodes_count());
+
+    return nodes[node].children;
+}
+
+const Route& MulticastTree::get_edge_route(const int node) const noexcept {
+    assert(root < node && node < get_nodes_count());
+
+    return nodes[node].edge_route;
+}
+
+uint64_t MulticastTree::get_allocated_bytes() const noexcept {
+    auto bytes = static_cast<uint64_t>(nodes.capacity() * sizeof(Node));
+    for (const auto& node : nodes) {
+        bytes += node.children.capacity() * sizeof(int) + node.edge_route.get_heap_bytes();
+    }
+
+    // approximate the hash table by its entries and buckets
+    bytes += node_per_device.size() * (sizeof(std::pair<const DeviceId, int>) + sizeof(void*));
+    bytes += node_per_device.bucket_count() * sizeof(void*);
+    return bytes;
+}
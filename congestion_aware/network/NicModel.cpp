@@ -0,0 +1,113 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/NicModel.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/Topology.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+NicModel::NicModel(const int npus_count,
+                   const Bandwidth injection_bandwidth,
+                   const int max_outstanding_chunks,
+                   const int dma_engines_count) noexcept
+    : max_outstanding_chunks(max_outstanding_chunks),
+      dma_engines_count(dma_engines_count),
+      engine_ticks_per_byte(0),
+      outstanding_chunks_counts(npus_count, 0),
+      waiting_chunks(npus_count),
+      engine_free_times(static_cast<size_t>(npus_count) * dma_engines_count, 0) {
+    assert(npus_count > 0);
+    assert(injection_bandwidth >= 0);
+    assert(max_outstanding_chunks >= 0);
+    assert(dma_engines_count > 0);
+
+    // engines share the injection bandwidth
+    if (injection_bandwidth > 0) {
+        engine_ticks_per_byte =
+            static_cast<double>(ticks_per_ns) * dma_engines_count / bw_GBps_to_Bpns(injection_bandwidth);
+    }
+}
+
+void NicModel::chunk_injected(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
+    auto* const topology = chunk->topology;
+    assert(topology != nullptr);
+    topology->send(std::move(chunk));
+}
+
+void NicModel::inject(std::unique_ptr<Chunk> chunk, NetworkScheduler& scheduler) noexcept {
+    assert(chunk != nullptr);
+    assert(0 <= chunk->src && chunk->src < outstanding_chunks_counts.size());
+
+    // the chunk waits for an outstanding slot
+    const auto src = chunk->src;
+    if (max_outstanding_chunks > 0 && outstanding_chunks_counts[src] >= max_outstanding_chunks) {
+        waiting_chunks[src].push_back(std::move(chunk));
+        return;
+    }
+
+    start_dma(std::move(chunk), scheduler);
+}
+
+void NicModel::release(const DeviceId src, NetworkScheduler& scheduler) noexcept {
+    assert(0 <= src && src < outstanding_chunks_counts.size());
+    assert(outstanding_chunks_counts[src] > 0);
+
+    outstanding_chunks_counts[src]--;
+    if (!waiting_chunks[src].empty()) {
+        start_dma(waiting_chunks[src].pop_front(), scheduler);
+    }
+}
+
+int NicModel::get_outstanding_chunks_count(const DeviceId npu) const noexcept {
+    assert(0 <= npu && npu < outstanding_chunks_counts.size());
+
+    return outstanding_chunks_counts[npu];
+}
+
+int NicModel::get_waiting_chunks_count(const DeviceId npu) const noexcept {
+    assert(0 <= npu && npu < waiting_chunks.size());
+
+    return waiting_chunks[npu].size();
+}
+
+void NicModel::reset() noexcept {
+    std::fill(outstanding_chunks_counts.begin(), outstanding_chunks_counts.end(), 0);
+    std::fill(engine_free_times.begin(), engine_free_times.end(), 0);
+
+    // drop the waiting chunks, recycling pooled ones
+    for (auto& queue : waiting_chunks) {
+        while (!queue.empty()) {
+            auto chunk = queue.pop_front();
+            if (chunk->chunk_pool != nullptr) {
+                auto* const chunk_pool = chunk->chunk_pool;
+                chunk_pool->release(std::move(chunk));
+            }
+        }
+    }
+}
+
+void NicModel::start_dma(std::unique_ptr<Chunk> chunk, NetworkScheduler& scheduler) noexcept {
+    assert(chunk != nullptr);
+
+    outstanding_chunks_counts[chunk->src]++;
+
+    // the engine that frees up first moves the chunk
+    const auto first_engine = engine_free_times.begin() + static_cast<size_t>(chunk->src) * dma_engines_count;
+    const auto engine = std::min_element(first_engine, first_engine + dma_engines_count);
+    const auto start_time = std::max(scheduler.get_current_time(), *engine);
+    const auto dma_size = static_cast<double>(chunk->transmission_size);
+    const auto dma_delay = static_cast<EventTime>(dma_size * engine_ticks_per_byte);
+    *engine = start_time + dma_delay;
+
+    scheduler.schedule_event(*engine, chunk_injected, static_cast<void*>(chunk.release()));
+}
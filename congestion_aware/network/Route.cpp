@@ -0,0 +1,211 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Route.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+Route::Route() noexcept : devices_count(0), capacity(inline_capacity), resolved(false) {}
+
+Route::Route(const std::initializer_list<DeviceId> device_ids) noexcept : Route() {
+    for (const auto device_id : device_ids) {
+        push_back(device_id);
+    }
+}
+
+Route::Route(const DeviceId* const device_ids, const int devices_count) noexcept : Route() {
+    assert(device_ids != nullptr || devices_count == 0);
+    assert(devices_count >= 0);
+
+    if (devices_count > capacity) {
+        reserve(devices_count);
+    }
+    for (auto i = 0; i < devices_count; i++) {
+        push_back(device_ids[i]);
+    }
+}
+
+Route::Route(const Route& other) noexcept : Route() {
+    *this = other;
+}
+
+Route::Route(Route&& other) noexcept : Route() {
+    *this = std::move(other);
+}
+
+Route& Route::operator=(const Route& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    // make sure the storage can hold the other route
+    if (other.devices_count > capacity) {
+        heap_storage = std::make_unique<RouteIndex[]>(2 * other.devices_count);
+        capacity = other.devices_count;
+    }
+
+    std::copy(other.begin(), other.end(), data());
+    if (other.devices_count > 0) {
+        std::copy(other.link_data(), other.link_data() + other.devices_count - 1, link_data());
+    }
+    devices_count = other.devices_count;
+    resolved = other.resolved;
+    return *this;
+}
+
+Route& Route::operator=(Route&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+
+    if (other.heap_storage != nullptr) {
+        // steal the heap storage
+        heap_storage = std::move(other.heap_storage);
+        capacity = other.capacity;
+    } else {
+        // inline storage: copy the device and link ids
+        heap_storage = nullptr;
+        capacity = inline_capacity;
+        inline_storage = other.inline_storage;
+    }
+    devices_count = other.devices_count;
+    resolved = other.resolved;
+
+    // leave the other route empty
+    other.capacity = inline_capacity;
+    other.devices_count = 0;
+    other.resolved = false;
+    return *this;
+}
+
+void Route::push_back(const DeviceId device_id) noexcept {
+    assert(device_id >= 0);
+    if constexpr (max_route_index < INT32_MAX) {
+        if (device_id > max_route_index) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "device " << device_id
+                      << " exceeds the compact route ids (at most " << max_route_index
+                      << "), build without NETWORK_BACKEND_COMPACT_IDS" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    // grow the storage if full
+    if (devices_count == capacity) {
+        reserve(2 * capacity);
+    }
+
+    data()[devices_count] = static_cast<RouteIndex>(device_id);
+    devices_count++;
+
+    // the new hop has no link yet
+    resolved = false;
+}
+
+void Route::set_link_id(const int hop, const LinkId link_id) noexcept {
+    assert(0 <= hop && hop < devices_count - 1);
+    assert(link_id >= 0);
+    if constexpr (max_route_index < INT32_MAX) {
+        if (link_id > max_route_index) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "link " << link_id
+                      << " exceeds the compact route ids (at most " << max_route_index
+                      << "), build without NETWORK_BACKEND_COMPACT_IDS" << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    link_data()[hop] = static_cast<RouteIndex>(link_id);
+}
+
+LinkId Route::link_id(const int hop) const noexcept {
+    assert(resolved);
+    assert(0 <= hop && hop < devices_count - 1);
+
+    return link_data()[hop];
+}
+
+void Route::mark_links_resolved() noexcept {
+    resolved = true;
+}
+
+bool Route::links_resolved() const noexcept {
+    return resolved;
+}
+
+int Route::size() const noexcept {
+    assert(devices_count >= 0);
+
+    return devices_count;
+}
+
+bool Route::empty() const noexcept {
+    return devices_count == 0;
+}
+
+DeviceId Route::operator[](const int index) const noexcept {
+    assert(0 <= index && index < devices_count);
+
+    return data()[index];
+}
+
+DeviceId Route::front() const noexcept {
+    assert(!empty());
+
+    return data()[0];
+}
+
+DeviceId Route::back() const noexcept {
+    assert(!empty());
+
+    return data()[devices_count - 1];
+}
+
+const RouteIndex* Route::begin() const noexcept {
+    return data();
+}
+
+const RouteIndex* Route::end() const noexcept {
+    return data() + devices_count;
+}
+
+bool Route::operator==(const Route& other) const noexcept {
+    return std::equal(begin(), end(), other.begin(), other.end());
+}
+
+uint64_t Route::get_heap_bytes() const noexcept {
+    // device ids followed by link ids
+    return (heap_storage != nullptr) ? 2 * static_cast<uint64_t>(capacity) * sizeof(RouteIndex) : 0;
+}
+
+void Route::reserve(const int new_capacity) noexcept {
+    assert(new_capacity > capacity);
+
+    // device ids, then link ids
+    auto new_storage = std::make_unique<RouteIndex[]>(2 * new_capacity);
+    std::copy(begin(), end(), new_storage.get());
+    std::copy(link_data(), link_data() + std::max(devices_count - 1, 0), new_storage.get() + new_capacity);
+
+    heap_storage = std::move(new_storage);
+    capacity = new_capacity;
+}
+
+RouteIndex* Route::data() noexcept {
+    return (heap_storage != nullptr) ? heap_storage.get() : inline_storage.data();
+}
+
+const RouteIndex* Route::data() const noexcept {
+    return (heap_storage != nullptr) ? heap_storage.get() : inline_storage.data();
+}
+
+RouteIndex* Route::link_data() noexcept {
+    return data() + capacity;
+}
+
+const RouteIndex* Route::link_data() const noexcept {
+    return data() + capacity;
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SwitchModel.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/Topology.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+SwitchModel::SwitchModel(const int npus_count,
+                         const int devices_count,
+                         const Bandwidth crossbar_bandwidth,
+                         const Latency traversal_latency) noexcept
+    : npus_count(npus_count),
+      crossbar_ticks_per_byte(0),
+      traversal_delay(ns_to_ticks(traversal_latency)),
+      crossbar_free_times(devices_count - npus_count, 0),
+      switched_chunks_counts(devices_count - npus_count, 0),
+      crossbar_waiting_times(devices_count - npus_count, 0) {
+    assert(0 < npus_count && npus_count <= devices_count);
+    assert(crossbar_bandwidth >= 0);
+    assert(traversal_latency >= 0);
+
+    if (crossbar_bandwidth > 0) {
+        crossbar_ticks_per_byte = static_cast<double>(ticks_per_ns) / bw_GBps_to_Bpns(crossbar_bandwidth);
+    }
+}
+
+void SwitchModel::chunk_switched(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
+    auto* const topology = chunk->topology;
+    assert(topology != nullptr);
+    topology->forward(std::move(chunk));
+}
+
+void SwitchModel::traverse(std::unique_ptr<Chunk> chunk, NetworkScheduler& scheduler) noexcept {
+    assert(chunk != nullptr);
+
+    const auto switch_index = chunk->current_device() - npus_count;
+    assert(0 <= switch_index && switch_index < crossbar_free_times.size());
+
+    // the crossbar moves a chunk at a time
+    const auto current_time = scheduler.get_current_time();
+    auto& crossbar_free_time = crossbar_free_times[switch_index];
+    const auto start_time = std::max(current_time, crossbar_free_time);
+    const auto crossbar_delay =
+        static_cast<EventTime>(static_cast<double>(chunk->get_size()) * crossbar_ticks_per_byte);
+    crossbar_free_time = start_time + crossbar_delay;
+
+    switched_chunks_counts[switch_index]++;
+    crossbar_waiting_times[switch_index] += start_time - current_time;
+
+    scheduler.schedule_event(crossbar_free_time + traversal_delay, chunk_switched, static_cast<void*>(chunk.release()));
+}
+
+uint64_t SwitchModel::get_switched_chunks_count(const DeviceId device) const noexcept {
+    assert(npus_count <= device && device - npus_count < switched_chunks_counts.size());
+
+    return switched_chunks_counts[device - npus_count];
+}
+
+EventTime SwitchModel::get_crossbar_waiting_time(const DeviceId device) const noexcept {
+    assert(npus_count <= device && device - npus_count < crossbar_waiting_times.size());
+
+    return crossbar_waiting_times[device - npus_count];
+}
+
+void SwitchModel::reset() noexcept {
+    std::fill(crossbar_free_times.begin(), crossbar_free_times.end(), 0);
+    std::fill(switched_chunks_counts.begin(), switched_chunks_counts.end(), 0);
+    std::fill(crossbar_waiting_times.begin(), crossbar_waiting_times.end(), 0);
+}
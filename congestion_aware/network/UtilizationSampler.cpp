@@ -0,0 +1,209 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/UtilizationSampler.h"
+#include "common/NetworkFunction.h"
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+UtilizationSampler::UtilizationSampler(const EventTime bucket_width) noexcept : bucket_width(bucket_width) {
+    assert(bucket_width > 0);
+}
+
+int UtilizationSampler::add_link(const DeviceId src, const DeviceId dest, const Bandwidth bandwidth) noexcept {
+    assert(src >= 0);
+    assert(dest >= 0);
+    assert(bandwidth > 0);
+
+    auto samples = LinkSamples();
+    samples.src = src;
+    samples.dest = dest;
+    samples.bucket_capacity = bw_GBps_to_Bpns(bandwidth) * static_cast<double>(bucket_width);
+    rows.push_back(std::move(samples));
+
+    return static_cast<int>(rows.size()) - 1;
+}
+
+void UtilizationSampler::record_transmission(const int row,
+                                             const ChunkSize chunk_size,
+                                             const EventTime start_time,
+                                             const EventTime link_free_time) noexcept {
+    assert(0 <= row && row < get_rows_count());
+    assert(chunk_size > 0);
+    assert(start_time <= link_free_time);
+
+    auto& samples = rows[row];
+    const auto first_bucket = static_cast<size_t>(start_time / bucket_width);
+    const auto last_bucket = static_cast<size_t>((link_free_time > start_time ? link_free_time - 1 : start_time) /
+                                                 bucket_width);
+    cover_bucket(samples, last_bucket);
+
+    // an instant transmission falls into a single bucket
+    if (link_free_time == start_time) {
+        samples.bytes[first_bucket] += static_cast<double>(chunk_size);
+        return;
+    }
+
+    // spread the bytes over the busy interval
+    const auto bytes_per_ns = static_cast<double>(chunk_size) / static_cast<double>(link_free_time - start_time);
+    for (auto bucket = first_bucket; bucket <= last_bucket; bucket++) {
+        const auto bucket_start = static_cast<EventTime>(bucket) * bucket_width;
+        const auto busy_start = std::max(start_time, bucket_start);
+        const auto busy_end = std::min(link_free_time, bucket_start + bucket_width);
+        samples.bytes[bucket] += bytes_per_ns * static_cast<double>(busy_end - busy_start);
+    }
+}
+
+void UtilizationSampler::record_pending_chunks(const int row,
+                                               const EventTime time,
+                                               const int pending_chunks_count) noexcept {
+    assert(0 <= row && row < get_rows_count());
+    assert(pending_chunks_count >= 0);
+
+    auto& samples = rows[row];
+    const auto bucket = static_cast<size_t>(time / bucket_width);
+    assert(bucket >= samples.pending_chunks_bucket);
+    cover_bucket(samples, bucket);
+
+    // the previous count lasted until now (into this bucket, unless it just started)
+    const auto last_held_bucket = (time % bucket_width == 0) ? bucket : bucket + 1;
+    for (auto b = samples.pending_chunks_bucket + 1; b < last_held_bucket; b++) {
+        samples.max_pending_chunks[b] = std::max(samples.max_pending_chunks[b], samples.pending_chunks_count);
+    }
+    samples.max_pending_chunks[bucket] = std::max(samples.max_pending_chunks[bucket], pending_chunks_count);
+
+    samples.pending_chunks_count = pending_chunks_count;
+    samples.pending_chunks_bucket = bucket;
+}
+
+EventTime UtilizationSampler::get_bucket_width() const noexcept {
+    return bucket_width;
+}
+
+int UtilizationSampler::get_rows_count() const noexcept {
+    return static_cast<int>(rows.size());
+}
+
+size_t UtilizationSampler::get_buckets_count() const noexcept {
+    auto buckets_count = size_t(0);
+    for (const auto& samples : rows) {
+        buckets_count = std::max(buckets_count, samples.bytes.size());
+    }
+    return buckets_count;
+}
+
+double UtilizationSampler::get_bytes(const int row, const size_t bucket) const noexcept {
+    assert(0 <= row && row < get_rows_count());
+
+    const auto& samples = rows[row];
+    return (bucket < samples.bytes.size()) ? samples.bytes[bucket] : 0;
+}
+
+double UtilizationSampler::get_utilization(const int row, const size_t bucket) const noexcept {
+    assert(0 <= row && row < get_rows_count());
+
+    return get_bytes(row, bucket) / rows[row].bucket_capacity;
+}
+
+int UtilizationSampler::get_max_pending_chunks(const int row, const size_t bucket) const noexcept {
+    assert(0 <= row && row < get_rows_count());
+
+    const auto& samples = rows[row];
+    return (bucket < samples.max_pending_chunks.size()) ? samples.max_pending_chunks[bucket] : 0;
+}
+
+void UtilizationSampler::write_samples(const std::string& csv_path) const noexcept {
+    auto csv_file = std::ofstream(csv_path);
+    if (!csv_file) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "cannot open " << csv_path << std::endl;
+        std::exit(-1);
+    }
+
+    csv_file << "src,dest,bucket,bytes,utilization,max_pending_chunks" << std::endl;
+    for (auto row = 0; row < get_rows_count(); row++) {
+        const auto& samples = rows[row];
+        for (auto bucket = size_t(0); bucket < samples.bytes.size(); bucket++) {
+            if (samples.bytes[bucket] == 0 && samples.max_pending_chunks[bucket] == 0) {
+                continue;
+            }
+            csv_file << samples.src << "," << samples.dest << "," << bucket << "," << samples.bytes[bucket] << ","
+                     << get_utilization(row, bucket) << "," << samples.max_pending_chunks[bucket] << "\n";
+        }
+    }
+}
+
+void UtilizationSampler::write_heatmap(const std::string& csv_path,
+                                       const int width,
+                                       const int height,
+                                       const std::vector<std::pair<int, int>>& device_coords,
+                                       const size_t first_bucket,
+                                       const size_t last_bucket) const noexcept {
+    assert(width > 0);
+    assert(height > 0);
+
+    const auto end_bucket = (last_bucket == 0) ? get_buckets_count() : last_bucket;
+    assert(first_bucket <= end_bucket);
+
+    // hottest outgoing link of each grid cell (-1: no device)
+    auto heatmap = std::vector<double>(static_cast<size_t>(width) * height, -1);
+    for (const auto& [x, y] : device_coords) {
+        if (x >= 0 && y >= 0) {
+            assert(x < width && y < height);
+            heatmap[y * width + x] = 0;
+        }
+    }
+    for (auto row = 0; row < get_rows_count(); row++) {
+        const auto src = rows[row].src;
+        if (src >= static_cast<DeviceId>(device_coords.size())) {
+            continue;
+        }
+        const auto [x, y] = device_coords[src];
+        if (x < 0 || y < 0) {
+            continue;
+        }
+
+        auto bytes = 0.0;
+        for (auto bucket = first_bucket; bucket < end_bucket; bucket++) {
+            bytes += get_bytes(row, bucket);
+        }
+        const auto buckets_count = static_cast<double>(std::max(end_bucket - first_bucket, size_t(1)));
+        const auto utilization = bytes / (rows[row].bucket_capacity * buckets_count);
+        auto& cell = heatmap[y * width + x];
+        cell = std::max(cell, utilization);
+    }
+
+    auto csv_file = std::ofstream(csv_path);
+    if (!csv_file) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "cannot open " << csv_path << std::endl;
+        std::exit(-1);
+    }
+    for (auto y = 0; y < height; y++) {
+        for (auto x = 0; x < width; x++) {
+            if (x > 0) {
+                csv_file << ",";
+            }
+            const auto cell = heatmap[y * width + x];
+            if (cell >= 0) {
+                csv_file << cell;
+            }
+        }
+        csv_file << "\n";
+    }
+}
+
+void UtilizationSampler::cover_bucket(LinkSamples& samples, const size_t bucket) noexcept {
+    if (bucket < samples.bytes.size()) {
+        return;
+    }
+
+    // resize grows the rows geometrically
+    samples.bytes.resize(bucket + 1, 0);
+    samples.max_pending_chunks.resize(bucket + 1, 0);
+}
@@ -0,0 +1,243 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CApi.h"
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "congestion_aware/Helper.h"
+#include <algorithm>
+#include <cassert>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+// the C types are the C++ ones, so batches are passed through without conversion
+static_assert(std::is_same_v<DeviceId, int32_t>);
+static_assert(std::is_same_v<ChunkSize, uint64_t>);
+static_assert(std::is_same_v<EventTime, uint64_t>);
+
+namespace {
+
+/**
+ * A chunk in flight, identifying its delivery to the host.
+ */
+struct PendingChunk {
+    /// simulation the chunk belongs to
+    AnalyticalAwareSimulation* simulation;
+
+    /// tag of the chunk
+    uint64_t tag;
+};
+
+/**
+ * A delivered chunk, waiting to be polled.
+ */
+struct Delivery {
+    /// tag of the chunk
+    uint64_t tag;
+
+    /// delivery time of the chunk
+    EventTime delivery_time;
+};
+
+}  // namespace
+
+struct AnalyticalAwareSimulation {
+    /// event queue driving the topology
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// topology behind the handle
+    std::shared_ptr<Topology> topology;
+
+    /// slots of the chunks in flight (addresses stay valid as slots are added), and the free slots
+    std::deque<PendingChunk> pending_chunks;
+    std::vector<PendingChunk*> free_pending_chunks;
+
+    /// delivered chunks not polled yet, from polled_count on
+    std::vector<Delivery> deliveries;
+    size_t polled_count = 0;
+
+    /**
+     * Check if an NPU ID is valid on the topology.
+     *
+     * @param npu_id NPU ID
+     * @return true if valid, false otherwise
+     */
+    [[nodiscard]] bool is_valid_npu(const int32_t npu_id) const noexcept {
+        return npu_id >= 0 && npu_id < topology->get_npus_count();
+    }
+
+    /**
+     * Take a slot for a chunk in flight.
+     *
+     * @param tag tag of the chunk
+     * @return slot of the chunk
+     */
+    [[nodiscard]] PendingChunk* take_pending_chunk(const uint64_t tag) noexcept {
+        if (free_pending_chunks.empty()) {
+            pending_chunks.push_back(PendingChunk{this, tag});
+            return &pending_chunks.back();
+        }
+        auto* const pending_chunk = free_pending_chunks.back();
+        free_pending_chunks.pop_back();
+        pending_chunk->tag = tag;
+        return pending_chunk;
+    }
+};
+
+namespace {
+
+/**
+ * Callback of the chunks sent through the C API: queue the delivery for polling, and free the slot.
+ *
+ * @param pending_chunk_ptr pointer to the PendingChunk
+ */
+void record_delivery(void* const pending_chunk_ptr) noexcept {
+    auto* const pending_chunk = static_cast<PendingChunk*>(pending_chunk_ptr);
+    auto* const simulation = pending_chunk->simulation;
+    simulation->deliveries.push_back(Delivery{pending_chunk->tag, simulation->event_queue->get_current_time()});
+    simulation->free_pending_chunks.push_back(pending_chunk);
+}
+
+}  // namespace
+
+int analytical_aware_api_version(void) {
+    return ANALYTICAL_AWARE_API_VERSION;
+}
+
+AnalyticalAwareSimulation* analytical_aware_create(const char* const config_path) {
+    assert(config_path != nullptr);
+
+    // a bad path fails the call rather than the parser terminating the host
+    if (!std::ifstream(config_path)) {
+        return nullptr;
+    }
+
+    const auto network_parser = NetworkParser(config_path);
+    auto* const simulation = new AnalyticalAwareSimulation();
+    simulation->event_queue = std::make_shared<EventQueue>();
+    simulation->topology = construct_topology(network_parser, simulation->event_queue);
+    return simulation;
+}
+
+void analytical_aware_destroy(AnalyticalAwareSimulation* const simulation) {
+    delete simulation;
+}
+
+int32_t analytical_aware_npus_count(const AnalyticalAwareSimulation* const simulation) {
+    assert(simulation != nullptr);
+
+    return simulation->topology->get_npus_count();
+}
+
+int analytical_aware_send(AnalyticalAwareSimulation* const simulation,
+                          const int32_t src,
+                          const int32_t dest,
+                          const uint64_t chunk_size,
+                          const uint64_t tag) {
+    return analytical_aware_send_batch(simulation, &src, &dest, &chunk_size, &tag, 1);
+}
+
+int analytical_aware_send_batch(AnalyticalAwareSimulation* const simulation,
+                                const int32_t* const srcs,
+                                const int32_t* const dests,
+                                const uint64_t* const chunk_sizes,
+                                const uint64_t* const tags,
+                                const int32_t count) {
+    assert(simulation != nullptr);
+    assert(count >= 0);
+
+    for (auto i = 0; i < count; i++) {
+        if (!simulation->is_valid_npu(srcs[i]) || !simulation->is_valid_npu(dests[i])) {
+            return -1;
+        }
+    }
+
+    auto descriptors = std::vector<ChunkDescriptor>(count);
+    for (auto i = 0; i < count; i++) {
+        descriptors[i] = ChunkDescriptor{srcs[i], dests[i], chunk_sizes[i], record_delivery,
+                                         simulation->take_pending_chunk(tags[i])};
+    }
+    simulation->topology->send_batch(descriptors.data(), count);
+    return 0;
+}
+
+uint64_t analytical_aware_current_time(const AnalyticalAwareSimulation* const simulation) {
+    assert(simulation != nullptr);
+
+    return simulation->event_queue->get_current_time();
+}
+
+uint64_t analytical_aware_next_event_time(AnalyticalAwareSimulation* const simulation) {
+    assert(simulation != nullptr);
+
+    return simulation->event_queue->get_next_event_time();
+}
+
+int analytical_aware_step(AnalyticalAwareSimulation* const simulation) {
+    assert(simulation != nullptr);
+
+    if (simulation->event_queue->finished()) {
+        return -1;
+    }
+    simulation->event_queue->proceed();
+    return 0;
+}
+
+void analytical_aware_run_until(AnalyticalAwareSimulation* const simulation, const uint64_t until_time) {
+    assert(simulation != nullptr);
+
+    simulation->event_queue->run_until(until_time);
+}
+
+uint64_t analytical_aware_run_to_completion(AnalyticalAwareSimulation* const simulation) {
+    assert(simulation != nullptr);
+
+    return simulation->event_queue->run_to_completion();
+}
+
+int32_t analytical_aware_poll(AnalyticalAwareSimulation* const simulation,
+                              uint64_t* const tags,
+                              uint64_t* const delivery_times,
+                              const int32_t capacity) {
+    assert(simulation != nullptr);
+    assert(capacity >= 0);
+
+    auto& deliveries = simulation->deliveries;
+    const auto polled_count = std::min(deliveries.size() - simulation->polled_count, static_cast<size_t>(capacity));
+    for (auto i = size_t(0); i < polled_count; i++) {
+        const auto& delivery = deliveries[simulation->polled_count + i];
+        tags[i] = delivery.tag;
+        delivery_times[i] = delivery.delivery_time;
+    }
+    simulation->polled_count += polled_count;
+
+    // every delivery is polled: reuse the buffer from its start
+    if (simulation->polled_count == deliveries.size()) {
+        deliveries.clear();
+        simulation->polled_count = 0;
+    }
+    return static_cast<int32_t>(polled_count);
+}
+
+void analytical_aware_reset(AnalyticalAwareSimulation* const simulation) {
+    assert(simulation != nullptr);
+
+    simulation->topology->reset();
+    simulation->event_queue->reset();
+
+    // every chunk in flight is dropped, so every slot is free
+    simulation->free_pending_chunks.clear();
+    for (auto& pending_chunk : simulation->pending_chunks) {
+        simulation->free_pending_chunks.push_back(&pending_chunk);
+    }
+    simulation->deliveries.clear();
+    simulation->polled_count = 0;
+}
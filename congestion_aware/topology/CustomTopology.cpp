@@ -0,0 +1,268 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/CustomTopology.h"
+#include "common/BinaryBuffer.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+/*
+ * Binary edge list layout (native byte order, no padding):
+ *   header: magic (8 B), version (u32), byte order mark (u32)
+ *   links_count (i32), then per link: src (i32), dest (i32), bandwidth (f64), latency (f64)
+ */
+
+namespace {
+
+/// written after the version, to reject files of another byte order
+constexpr uint32_t byte_order_mark = 0x01020304;
+
+}  // namespace
+
+bool CustomTopology::save(const Topology& topology, const std::string& path) noexcept {
+    auto buffer = std::string();
+
+    // header
+    buffer.append(edge_list_magic, sizeof(edge_list_magic));
+    append_binary(buffer, edge_list_version);
+    append_binary(buffer, byte_order_mark);
+
+    // links, in LinkId order
+    append_binary(buffer, static_cast<int32_t>(topology.get_links_count()));
+    for (auto link_id = 0; link_id < topology.get_links_count(); link_id++) {
+        const auto& link = topology.get_link(link_id);
+        append_binary(buffer, static_cast<int32_t>(link.get_src()));
+        append_binary(buffer, static_cast<int32_t>(link.get_dest()));
+        append_binary(buffer, static_cast<double>(link.get_bandwidth()));
+        append_binary(buffer, static_cast<double>(link.get_latency()));
+    }
+
+    return write_binary_file(path, buffer);
+}
+
+CustomTopology::CustomTopology(const std::string& path,
+                               const int npus_count,
+                               const Bandwidth bandwidth,
+                               const Latency latency,
+                               const int threads_count) noexcept
+    : Topology() {
+    assert(npus_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+    assert(threads_count >= 0);
+
+    // read the edge list, binary or CSV
+    auto contents = std::string();
+    if (!read_binary_file(path, contents)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "bad file: " << path << std::endl;
+        std::exit(-1);
+    }
+    const auto binary = contents.size() >= sizeof(edge_list_magic) &&
+                        std::memcmp(contents.data(), edge_list_magic, sizeof(edge_list_magic)) == 0;
+    const auto edges = binary ? parse_binary(path, contents) : parse_csv(path, contents, bandwidth, latency);
+
+    // NPUs come first, followed by the switches listed in the edge list
+    this->npus_count = npus_count;
+    devices_count = npus_count;
+    for (const auto& edge : edges) {
+        devices_count = std::max({devices_count, edge.src + 1, edge.dest + 1});
+    }
+    dims_count = 1;
+    npus_count_per_dim.push_back(npus_count);
+    bandwidth_per_dim.push_back(bandwidth);
+
+    // connect the links, keeping their order
+    links.reserve(edges.size());
+    for (const auto& edge : edges) {
+        connect(edge.src, edge.dest, edge.bandwidth, edge.latency, false);
+    }
+
+    compute_next_hops(threads_count);
+}
+
+Route CustomTopology::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // follow the next hops
+    auto route = Route({src});
+    for (auto current = src; current != dest;) {
+        current = live_next_hop(current, dest);
+        if (current < 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "NPU " << src << " can't reach NPU "
+                      << dest << " around the failed links" << std::endl;
+            std::exit(-1);
+        }
+        route.push_back(current);
+    }
+    return route;
+}
+
+DeviceId CustomTopology::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    const auto next = next_hops[static_cast<size_t>(dest) * devices_count + current];
+    assert(next != -1);
+    return next;
+}
+
+std::vector<CustomTopology::Edge> CustomTopology::parse_csv(const std::string& path,
+                                                            const std::string& contents,
+                                                            const Bandwidth bandwidth,
+                                                            const Latency latency) noexcept {
+    auto edges = std::vector<Edge>();
+
+    auto lines = std::istringstream(contents);
+    auto line = std::string();
+    for (auto line_number = 1; std::getline(lines, line); line_number++) {
+        // skip blank lines and comments
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        // src,dest[,bandwidth,latency]
+        const auto fields_count = std::count(line.begin(), line.end(), ',') + 1;
+        std::replace(line.begin(), line.end(), ',', ' ');
+        auto fields = std::istringstream(line);
+        auto edge = Edge{-1, -1, bandwidth, latency};
+        fields >> edge.src >> edge.dest;
+        if (fields_count == 4) {
+            fields >> edge.bandwidth >> edge.latency;
+        }
+        auto rest = std::string();
+        if ((fields_count != 2 && fields_count != 4) || fields.fail() || (fields >> rest) || edge.src < 0 ||
+            edge.dest < 0 || edge.src == edge.dest || edge.bandwidth <= 0 || edge.latency < 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid link at " << path << ":"
+                      << line_number << std::endl;
+            std::exit(-1);
+        }
+        edges.push_back(edge);
+    }
+
+    return edges;
+}
+
+std::vector<CustomTopology::Edge> CustomTopology::parse_binary(const std::string& path,
+                                                               const std::string& contents) noexcept {
+    const auto fail = [&path]() {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid edge list " << path << std::endl;
+        std::exit(-1);
+    };
+
+    // header
+    auto reader = BinaryReader(contents, sizeof(edge_list_magic));
+    if (reader.read<uint32_t>() != edge_list_version || reader.read<uint32_t>() != byte_order_mark) {
+        fail();
+    }
+
+    // links
+    const auto links_count = reader.read<int32_t>();
+    if (links_count < 0 || !reader.has(static_cast<uint64_t>(links_count) * 24)) {
+        fail();
+    }
+    auto edges = std::vector<Edge>(links_count);
+    for (auto& edge : edges) {
+        edge.src = reader.read<int32_t>();
+        edge.dest = reader.read<int32_t>();
+        edge.bandwidth = reader.read<double>();
+        edge.latency = reader.read<double>();
+        if (edge.src < 0 || edge.dest < 0 || edge.src == edge.dest || edge.bandwidth <= 0 || edge.latency < 0) {
+            fail();
+        }
+    }
+    if (!reader.done()) {
+        fail();
+    }
+
+    return edges;
+}
+
+void CustomTopology::compute_next_hops(const int threads_count) noexcept {
+    // incoming links of each device, by ascending src
+    auto incoming_offsets = std::vector<int>(devices_count + 1, 0);
+    for (auto link_id = 0; link_id < get_links_count(); link_id++) {
+        incoming_offsets[links.endpoints(link_id).second + 1]++;
+    }
+    for (auto device = 0; device < devices_count; device++) {
+        incoming_offsets[device + 1] += incoming_offsets[device];
+    }
+    auto incoming_srcs = std::vector<DeviceId>(get_links_count());
+    auto fill_positions = std::vector<int>(incoming_offsets.begin(), incoming_offsets.end() - 1);
+    for (auto link_id = 0; link_id < get_links_count(); link_id++) {
+        const auto [src, dest] = links.endpoints(link_id);
+        incoming_srcs[fill_positions[dest]++] = src;
+    }
+    for (auto device = 0; device < devices_count; device++) {
+        const auto first_src = incoming_srcs.begin() + incoming_offsets[device];
+        std::sort(first_src, incoming_srcs.begin() + incoming_offsets[device + 1]);
+    }
+
+    // breadth-first search from each destination: every device reached moves to the device it was reached from
+    // (destinations write disjoint rows, so no synchronization is required)
+    next_hops.assign(static_cast<size_t>(npus_count) * devices_count, -1);
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(npus_count, [this, &incoming_offsets, &incoming_srcs](const int dest) {
+        auto* const dest_next_hops = &next_hops[static_cast<size_t>(dest) * devices_count];
+        auto frontier = std::vector<DeviceId>({dest});
+        dest_next_hops[dest] = dest;
+        for (auto index = static_cast<size_t>(0); index < frontier.size(); index++) {
+            const auto current = frontier[index];
+            for (auto i = incoming_offsets[current]; i < incoming_offsets[current + 1]; i++) {
+                const auto previous = incoming_srcs[i];
+                if (dest_next_hops[previous] == -1) {
+                    dest_next_hops[previous] = current;
+                    frontier.push_back(previous);
+                }
+            }
+        }
+        dest_next_hops[dest] = -1;
+    });
+
+    // every NPU should reach every other NPU
+    for (auto dest = 0; dest < npus_count; dest++) {
+        for (auto src = 0; src < npus_count; src++) {
+            if (src != dest && next_hops[static_cast<size_t>(dest) * devices_count + src] == -1) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) " << "NPU " << src
+                          << " can't reach NPU " << dest << " in the custom topology" << std::endl;
+                std::exit(-1);
+            }
+        }
+    }
+}
+
+uint64_t CustomTopology::get_route_tables_bytes() const noexcept {
+    return Topology::get_route_tables_bytes() + next_hops.capacity() * sizeof(DeviceId);
+}
+
+void CustomTopology::repair_routes(const std::vector<LinkId>& changed_link_ids, const bool failed) noexcept {
+    for (auto dest = 0; dest < npus_count; dest++) {
+        auto* const dest_next_hops = &next_hops[static_cast<size_t>(dest) * devices_count];
+        for (const auto link_id : changed_link_ids) {
+            if (next_hops_affected(dest_next_hops, dest, link_id, failed)) {
+                compute_live_next_hops(dest, dest_next_hops);
+                break;
+            }
+        }
+    }
+}
+
+DeviceId CustomTopology::live_next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    return next_hops[static_cast<size_t>(dest) * devices_count + current];
+}
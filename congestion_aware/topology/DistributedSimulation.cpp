@@ -0,0 +1,435 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/DistributedSimulation.h"
+#include "common/BinaryBuffer.h"
+#include "common/FrameSocket.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/ParallelSimulation.h"
+#include "congestion_aware/Route.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+/*
+ * Distributed simulation protocol (frames, see FrameSocket.h; native byte order):
+ *   rank -> rank 0, once: rank (i32), ranks count (i32), devices count (i32), links count (i32), lookahead (u64)
+ *   rank -> rank 0, every window: next event time (u64, the largest EventTime if none), current time (u64),
+ *                                 then migration records
+ *   rank 0 -> rank, every window: next window start (u64, the largest EventTime once finished),
+ *                                 latest current time among the ranks (u64), then the records to the rank
+ * A migration record is its dest rank (i32) and body length (u32), then the body:
+ *   arrival time, chunk id, chunk size, queueing delay, inject time, tail arrival time, tag (u64 each),
+ *   src, dest, route index, hops count (i32 each), route length (u32), route devices (i32 each),
+ *   hop-by-hop flag (u8), traffic class (u8), job id (u16)
+ */
+
+namespace {
+
+/// largest EventTime, marking no pending event
+constexpr auto no_event = std::numeric_limits<EventTime>::max();
+
+/**
+ * Report a rank lost and exit.
+ *
+ * @param rank rank that's gone
+ */
+[[noreturn]] void rank_lost(const int rank) noexcept {
+    std::cerr << "[Error] (network/analytical/congestion_aware) " << "Lost connection to rank " << rank << std::endl;
+    std::exit(-1);
+}
+
+}  // namespace
+
+DistributedSimulation::DistributedSimulation(std::shared_ptr<Topology> topology,
+                                             const int rank,
+                                             const int ranks_count,
+                                             const std::string& host,
+                                             const uint16_t port,
+                                             DeliveryHandler delivery_handler) noexcept
+    : topology(std::move(topology)),
+      rank(rank),
+      ranks_count(ranks_count),
+      event_queue(std::make_shared<EventQueue>()),
+      mailboxes(ranks_count),
+      lookahead(no_event),
+      delivery_handler(std::move(delivery_handler)),
+      listen_fd(-1),
+      fd(-1),
+      port(0),
+      windows_count(0),
+      migrated_chunks_count(0) {
+    assert(this->topology != nullptr);
+    assert(0 <= rank && rank < ranks_count);
+    assert(this->delivery_handler != nullptr);
+
+    // chunks are forwarded hop by hop, and NICs are released at the src, so both have to stay within a rank
+    // (as do crossbars and ingresses, scheduled on the topology's own event queue)
+    if (this->topology->fast_forward || this->topology->nic_model != nullptr ||
+        this->topology->switch_model != nullptr || this->topology->ingress_ticks_per_byte != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "distributed simulation doesn't support fast forwarding, NIC models, switch models "
+                  << "or ingress bandwidths" << std::endl;
+        std::exit(-1);
+    }
+
+    // assign the links of this rank's devices to its event queue,
+    // arrivals at other ranks are posted to mailboxes
+    rank_per_device = ParallelSimulation::partition_devices(*this->topology, ranks_count);
+    this->topology->links.materialize_all();
+    for (auto& link : this->topology->links) {
+        const auto src_rank = rank_per_device[link.get_src()];
+        const auto dest_rank = rank_per_device[link.get_dest()];
+        if (src_rank != dest_rank) {
+            lookahead = std::min(lookahead, ns_to_ticks(link.get_latency()));
+        }
+        if (src_rank != rank) {
+            continue;
+        }
+
+        link.set_scheduler(event_queue.get());
+        link.set_arrival_mailbox((dest_rank == rank) ? nullptr : &mailboxes[dest_rank]);
+    }
+
+    // a zero-latency cut would let ranks affect each other within the same instant
+    if (lookahead == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "links crossing ranks should have a latency of at least one tick" << std::endl;
+        std::exit(-1);
+    }
+
+    original_scheduler = this->topology->scheduler;
+    this->topology->scheduler = event_queue;
+    if (this->topology->adjacency_offsets.empty() && !this->topology->links.lazy()) {
+        this->topology->build_adjacency();
+    }
+
+    if (rank == 0) {
+        listen_fd = listen_tcp(port, this->port);
+        if (listen_fd == -1) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Cannot listen on port " << port
+                      << std::endl;
+            std::exit(-1);
+        }
+        return;
+    }
+
+    // introduce this rank to rank 0
+    fd = connect_tcp(host, port);
+    auto hello = std::string();
+    append_binary(hello, static_cast<int32_t>(rank));
+    append_binary(hello, static_cast<int32_t>(ranks_count));
+    append_binary(hello, static_cast<int32_t>(this->topology->get_devices_count()));
+    append_binary(hello, static_cast<int32_t>(this->topology->get_links_count()));
+    append_binary(hello, lookahead);
+    if (fd == -1 || !send_frame(fd, hello)) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Cannot connect to rank 0 at " << host
+                  << ":" << port << std::endl;
+        std::exit(-1);
+    }
+}
+
+DistributedSimulation::~DistributedSimulation() noexcept {
+    for (const auto rank_fd : rank_fds) {
+        if (rank_fd != -1) {
+            close(rank_fd);
+        }
+    }
+    if (listen_fd != -1) {
+        close(listen_fd);
+    }
+    if (fd != -1) {
+        close(fd);
+    }
+
+    // hand the links back to the topology
+    for (auto& link : topology->links) {
+        link.set_arrival_mailbox(nullptr);
+    }
+    topology->scheduler = nullptr;
+    if (original_scheduler != nullptr) {
+        topology->attach_scheduler(original_scheduler);
+    }
+}
+
+void DistributedSimulation::send(const ChunkSize chunk_size,
+                                 const DeviceId src,
+                                 const DeviceId dest,
+                                 const uint64_t tag) noexcept {
+    assert(0 <= src && src < topology->get_npus_count());
+    assert(0 <= dest && dest < topology->get_npus_count());
+
+    // every rank issues the same initial chunks, each keeping its own
+    const auto chunk_id = topology->next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+    if (rank_per_device[src] != rank) {
+        return;
+    }
+
+    auto chunk = std::make_unique<Chunk>(chunk_size, topology->select_route(src, dest, chunk_id), deliver, nullptr);
+    chunk->chunk_id = chunk_id;
+    chunk->set_payload(Delivery{this, tag, dest});
+    topology->send(std::move(chunk));
+}
+
+EventTime DistributedSimulation::run() noexcept {
+    if (rank == 0) {
+        accept_ranks();
+    }
+
+    while (true) {
+        // report this rank's state and migrated chunks, then take in the chunks migrated here
+        auto message = std::string();
+        append_binary(message, event_queue->finished() ? no_event : event_queue->get_next_event_time());
+        append_binary(message, event_queue->get_current_time());
+        encode_migrations(message);
+
+        const auto reply = exchange(message);
+        auto reader = BinaryReader(reply, 0);
+        const auto window_start = reader.read<EventTime>();
+        const auto finish_time = reader.read<EventTime>();
+        decode_migrations(reply, 2 * sizeof(EventTime));
+        if (window_start == no_event) {
+            return finish_time;
+        }
+
+        // events inside [window_start, window_end) can't affect other ranks before window_end
+        const auto window_end = (lookahead > no_event - window_start) ? no_event : window_start + lookahead;
+        windows_count++;
+        while (!event_queue->finished() && event_queue->get_next_event_time() < window_end) {
+            event_queue->proceed();
+        }
+    }
+}
+
+void DistributedSimulation::set_deterministic_order(const bool enabled) noexcept {
+    event_queue->set_deterministic_order(enabled);
+    Topology::register_event_order_keys(*event_queue);
+}
+
+EventTime DistributedSimulation::get_current_time() const noexcept {
+    return event_queue->get_current_time();
+}
+
+int DistributedSimulation::get_rank() const noexcept {
+    return rank;
+}
+
+int DistributedSimulation::get_rank_of(const DeviceId device) const noexcept {
+    assert(0 <= device && device < topology->get_devices_count());
+
+    return rank_per_device[device];
+}
+
+uint16_t DistributedSimulation::get_port() const noexcept {
+    return port;
+}
+
+EventTime DistributedSimulation::get_lookahead() const noexcept {
+    return lookahead;
+}
+
+int64_t DistributedSimulation::get_windows_count() const noexcept {
+    return windows_count;
+}
+
+int64_t DistributedSimulation::get_migrated_chunks_count() const noexcept {
+    return migrated_chunks_count;
+}
+
+void DistributedSimulation::deliver(void* const delivery_ptr) noexcept {
+    assert(delivery_ptr != nullptr);
+
+    const auto* const delivery = static_cast<const Delivery*>(delivery_ptr);
+    delivery->simulation->delivery_handler(delivery->dest, delivery->tag);
+}
+
+void DistributedSimulation::accept_ranks() noexcept {
+    rank_fds.assign(ranks_count, -1);
+    for (auto i = 1; i < ranks_count; i++) {
+        const auto rank_fd = accept(listen_fd, nullptr, nullptr);
+        auto hello = std::string();
+        if (rank_fd == -1 || !receive_frame(rank_fd, hello)) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Cannot accept rank" << std::endl;
+            std::exit(-1);
+        }
+
+        auto reader = BinaryReader(hello, 0);
+        const auto other_rank = reader.read<int32_t>();
+        const auto same_topology = reader.read<int32_t>() == ranks_count &&
+                                   reader.read<int32_t>() == topology->get_devices_count() &&
+                                   reader.read<int32_t>() == topology->get_links_count() &&
+                                   reader.read<EventTime>() == lookahead && reader.done();
+        if (other_rank <= 0 || other_rank >= ranks_count || rank_fds[other_rank] != -1 || !same_topology) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Rank " << other_rank
+                      << " doesn't simulate the same topology on " << ranks_count << " ranks" << std::endl;
+            std::exit(-1);
+        }
+        rank_fds[other_rank] = rank_fd;
+
+        // every window is a small message and reply: send them right away
+        const auto no_delay = 1;
+        setsockopt(rank_fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+    }
+}
+
+void DistributedSimulation::encode_migrations(std::string& message) noexcept {
+    auto events = std::vector<std::pair<EventTime, Event>>();
+    for (auto dest_rank = 0; dest_rank < ranks_count; dest_rank++) {
+        mailboxes[dest_rank].take(events);
+        for (const auto& [arrival_time, event] : events) {
+            assert(event.get_kind() == EventKind::ChunkArrival);
+            auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(event.get_handler_arg().second));
+            if (chunk->coalesced_chunks != nullptr || chunk->multicast_tree != nullptr || chunk->buffer_credit > 0) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) "
+                          << "coalesced, multicast, and buffered chunks can't migrate across ranks" << std::endl;
+                std::exit(-1);
+            }
+
+            auto delivery = Delivery();
+            std::memcpy(&delivery, chunk->payload_bytes, sizeof(Delivery));
+            const auto& route = *chunk->route;
+            auto body = std::string();
+            append_binary(body, arrival_time);
+            append_binary(body, chunk->chunk_id);
+            append_binary(body, chunk->chunk_size);
+            append_binary(body, chunk->queueing_delay);
+            append_binary(body, chunk->inject_time);
+            append_binary(body, chunk->tail_arrival_time);
+            append_binary(body, delivery.tag);
+            append_binary(body, static_cast<int32_t>(chunk->src));
+            append_binary(body, static_cast<int32_t>(chunk->dest));
+            append_binary(body, static_cast<int32_t>(chunk->route_index));
+            append_binary(body, static_cast<int32_t>(chunk->hops_count));
+            append_binary(body, static_cast<uint32_t>(route.size()));
+            for (auto i = 0; i < route.size(); i++) {
+                append_binary(body, static_cast<int32_t>(route[i]));
+            }
+            append_binary(body, static_cast<uint8_t>(chunk->hop_by_hop));
+            append_binary(body, chunk->traffic_class);
+            append_binary(body, chunk->job_id);
+
+            append_binary(message, static_cast<int32_t>(dest_rank));
+            append_binary(message, static_cast<uint32_t>(body.size()));
+            message += body;
+            migrated_chunks_count++;
+        }
+    }
+}
+
+void DistributedSimulation::decode_migrations(const std::string& message, const size_t offset) noexcept {
+    auto reader = BinaryReader(message, offset);
+    while (reader.has(1)) {
+        [[maybe_unused]] const auto dest_rank = reader.read<int32_t>();
+        assert(dest_rank == rank);
+        reader.read<uint32_t>();
+
+        const auto arrival_time = reader.read<EventTime>();
+        const auto chunk_id = reader.read<uint64_t>();
+        const auto chunk_size = reader.read<ChunkSize>();
+        const auto queueing_delay = reader.read<EventTime>();
+        const auto inject_time = reader.read<EventTime>();
+        const auto tail_arrival_time = reader.read<EventTime>();
+        const auto tag = reader.read<uint64_t>();
+        const auto src = reader.read<int32_t>();
+        const auto dest = reader.read<int32_t>();
+        const auto route_index = reader.read<int32_t>();
+        const auto hops_count = reader.read<int32_t>();
+        const auto route_length = reader.read<uint32_t>();
+        auto route = Route();
+        for (auto i = uint32_t(0); i < route_length; i++) {
+            route.push_back(reader.read<int32_t>());
+        }
+
+        auto chunk = std::make_unique<Chunk>(chunk_size, std::move(route), deliver, nullptr);
+        chunk->hop_by_hop = (reader.read<uint8_t>() != 0);
+        chunk->traffic_class = reader.read<uint8_t>();
+        chunk->job_id = reader.read<uint16_t>();
+        chunk->chunk_id = chunk_id;
+        chunk->queueing_delay = queueing_delay;
+        chunk->inject_time = inject_time;
+        chunk->tail_arrival_time = tail_arrival_time;
+        chunk->src = src;
+        chunk->dest = dest;
+        chunk->route_index = route_index;
+        chunk->hops_count = hops_count;
+        chunk->topology = topology.get();
+        chunk->set_payload(Delivery{this, tag, dest});
+
+        // the chunk resumes as if it crossed the link within this rank
+        event_queue->schedule_event(arrival_time, EventKind::ChunkArrival, chunk.release());
+    }
+
+    if (!reader.done()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Malformed migration records" << std::endl;
+        std::exit(-1);
+    }
+}
+
+std::string DistributedSimulation::exchange(const std::string& message) noexcept {
+    if (rank != 0) {
+        auto reply = std::string();
+        if (!send_frame(fd, message) || !receive_frame(fd, reply)) {
+            rank_lost(0);
+        }
+        return reply;
+    }
+
+    // gather the messages in rank order, routing the records by dest rank
+    auto window_start = no_event;
+    auto finish_time = static_cast<EventTime>(0);
+    auto records = std::vector<std::string>(ranks_count);
+    for (auto src_rank = 0; src_rank < ranks_count; src_rank++) {
+        auto received = std::string();
+        if (src_rank > 0 && !receive_frame(rank_fds[src_rank], received)) {
+            rank_lost(src_rank);
+        }
+        const auto& src_message = (src_rank == 0) ? message : received;
+
+        auto reader = BinaryReader(src_message, 0);
+        window_start = std::min(window_start, reader.read<EventTime>());
+        finish_time = std::max(finish_time, reader.read<EventTime>());
+        while (reader.has(1)) {
+            const auto dest_rank = reader.read<int32_t>();
+            const auto body_length = reader.read<uint32_t>();
+            auto body = std::string(body_length, '\0');
+            if (dest_rank < 0 || dest_rank >= ranks_count || !reader.read(body.data(), body_length)) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) " << "Malformed message of rank "
+                          << src_rank << std::endl;
+                std::exit(-1);
+            }
+
+            // a migrated chunk arrives at its dest rank no earlier than its arrival time
+            window_start = std::min(window_start, BinaryReader(body, 0).read<EventTime>());
+            append_binary(records[dest_rank], dest_rank);
+            append_binary(records[dest_rank], body_length);
+            records[dest_rank] += body;
+        }
+    }
+
+    // answer every rank with the next window and its records
+    auto own_reply = std::string();
+    for (auto dest_rank = 0; dest_rank < ranks_count; dest_rank++) {
+        auto reply = std::string();
+        append_binary(reply, window_start);
+        append_binary(reply, finish_time);
+        reply += records[dest_rank];
+        if (dest_rank == 0) {
+            own_reply = std::move(reply);
+        } else if (!send_frame(rank_fds[dest_rank], reply)) {
+            rank_lost(dest_rank);
+        }
+    }
+    return own_reply;
+}
@@ -0,0 +1,389 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/FlowModel.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// flows with fewer bytes left are considered drained (absorbs rounding errors)
+constexpr double drained_bytes_threshold = 1e-6;
+
+/// no pending event
+constexpr double never = std::numeric_limits<double>::infinity();
+
+/// relative margin below which a flow is considered slower than a changed flow (absorbs rounding errors)
+constexpr double fixed_rate_tolerance = 1e-9;
+
+}  // namespace
+
+FlowModel::FlowModel(std::shared_ptr<Topology> topology) noexcept
+    : topology(std::move(topology)),
+      active_flows_count(0),
+      current_time(0),
+      stale_drain_events_count(0),
+      min_drained_rate(never),
+      rate_updates_count(0),
+      visit_epoch(0) {
+    assert(this->topology != nullptr);
+
+    // convert every link bandwidth from GB/s to B/tick
+    const auto links_count = this->topology->get_links_count();
+    link_capacities.reserve(links_count);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        const auto bandwidth = this->topology->get_link(link_id).get_bandwidth();
+        link_capacities.push_back(bw_GBps_to_Bpns(bandwidth) / static_cast<double>(ticks_per_ns));
+    }
+
+    link_flows.resize(links_count);
+    link_visit_epochs.assign(links_count, 0);
+    residual_capacities.resize(links_count);
+    unfrozen_flows_count.resize(links_count);
+}
+
+FlowModel::FlowId FlowModel::add_flow(const EventTime start_time,
+                                      const DeviceId src,
+                                      const DeviceId dest,
+                                      const ChunkSize flow_size,
+                                      const Callback callback,
+                                      const CallbackArg callback_arg) noexcept {
+    assert(static_cast<double>(start_time) >= current_time);
+    assert(src != dest);
+    assert(flow_size > 0);
+
+    auto flow = Flow();
+    flow.route = topology->route(src, dest);
+    flow.start_time = start_time;
+    flow.remaining_bytes = static_cast<double>(flow_size);
+    flow.rate = 0;
+    flow.update_time = static_cast<double>(start_time);
+    flow.generation = 0;
+    flow.active = false;
+    flow.visit_epoch = 0;
+    flow.first_link_slot = static_cast<int>(link_slots.size());
+    flow.finish_time = 0;
+    flow.callback = callback;
+    flow.callback_arg = callback_arg;
+
+    // propagation latency along the route
+    flow.path_latency = 0;
+    for (auto hop = 0; hop < flow.route.size() - 1; hop++) {
+        flow.path_latency += topology->get_link(flow.route.link_id(hop)).get_latency() * ticks_per_ns;
+    }
+
+    const auto flow_id = static_cast<FlowId>(flows.size());
+    link_slots.resize(link_slots.size() + flow.route.size() - 1);
+    flows.push_back(std::move(flow));
+    pending_flows.emplace(static_cast<double>(start_time), flow_id);
+
+    return flow_id;
+}
+
+EventTime FlowModel::run() noexcept {
+    auto last_finish_time = EventTime(0);
+
+    while (!pending_flows.empty() || active_flows_count > 0 || !delivering_flows.empty()) {
+        // next time any flow starts, drains, or finishes
+        const auto next_start_time = pending_flows.empty() ? never : pending_flows.top().first;
+        const auto next_finish_time = delivering_flows.empty() ? never : delivering_flows.top().first;
+        const auto next_time = std::min({next_start_time, next_finish_time, next_drain_time()});
+        assert(next_time < never);
+
+        // rates are constant until next_time
+        current_time = next_time;
+        drain();
+
+        // finish flows whose last byte arrived
+        while (!delivering_flows.empty() && delivering_flows.top().first <= current_time) {
+            const auto flow_id = delivering_flows.top().second;
+            delivering_flows.pop();
+
+            auto& flow = flows[flow_id];
+            flow.finish_time = static_cast<EventTime>(current_time);
+            last_finish_time = std::max(last_finish_time, flow.finish_time);
+
+            // the callback may add new flows
+            if (flow.callback != nullptr) {
+                (*flow.callback)(flow.callback_arg);
+            }
+        }
+
+        // start flows
+        while (!pending_flows.empty() && pending_flows.top().first <= current_time) {
+            activate(pending_flows.top().second);
+            pending_flows.pop();
+        }
+
+        // the flows of some links changed: share their bandwidth again, once for every simultaneous change
+        if (!changed_links.empty()) {
+            allocate_rates();
+        }
+    }
+
+    return last_finish_time;
+}
+
+EventTime FlowModel::get_finish_time(const FlowId flow_id) const noexcept {
+    assert(0 <= flow_id && flow_id < flows.size());
+
+    return flows[flow_id].finish_time;
+}
+
+EventTime FlowModel::get_current_time() const noexcept {
+    return static_cast<EventTime>(current_time);
+}
+
+int FlowModel::get_flows_count() const noexcept {
+    return static_cast<int>(flows.size());
+}
+
+uint64_t FlowModel::get_rate_updates_count() const noexcept {
+    return rate_updates_count;
+}
+
+void FlowModel::activate(const FlowId flow_id) noexcept {
+    auto& flow = flows[flow_id];
+    assert(!flow.active);
+
+    // append the flow to the flows of each link of its route
+    for (auto hop = 0; hop < flow.route.size() - 1; hop++) {
+        const auto link_id = flow.route.link_id(hop);
+        link_slots[flow.first_link_slot + hop] = static_cast<int>(link_flows[link_id].size());
+        link_flows[link_id].push_back(flow_id);
+        changed_links.push_back(link_id);
+    }
+
+    flow.active = true;
+    flow.rate = 0;
+    flow.update_time = current_time;
+    started_flows.push_back(flow_id);
+    active_flows_count++;
+}
+
+void FlowModel::deactivate(const FlowId flow_id) noexcept {
+    auto& flow = flows[flow_id];
+    assert(flow.active);
+
+    // remove the flow from the flows of each link of its route,
+    // moving the link's last flow to its slot
+    for (auto hop = 0; hop < flow.route.size() - 1; hop++) {
+        const auto link_id = flow.route.link_id(hop);
+        auto& flows_of_link = link_flows[link_id];
+        const auto slot = link_slots[flow.first_link_slot + hop];
+        const auto moved_flow_id = flows_of_link.back();
+        flows_of_link[slot] = moved_flow_id;
+        flows_of_link.pop_back();
+
+        // routes cross a link at most once
+        if (moved_flow_id != flow_id) {
+            const auto& moved_flow = flows[moved_flow_id];
+            for (auto moved_hop = 0; moved_hop < moved_flow.route.size() - 1; moved_hop++) {
+                if (moved_flow.route.link_id(moved_hop) == link_id) {
+                    link_slots[moved_flow.first_link_slot + moved_hop] = slot;
+                    break;
+                }
+            }
+        }
+        changed_links.push_back(link_id);
+    }
+
+    flow.active = false;
+    flow.generation++;
+    min_drained_rate = std::min(min_drained_rate, flow.rate);
+    active_flows_count--;
+}
+
+double FlowModel::next_drain_time() noexcept {
+    while (!drain_events.empty()) {
+        const auto [drain_time, flow_id, generation] = drain_events.front();
+        const auto& flow = flows[flow_id];
+        if (flow.active && flow.generation == generation) {
+            return drain_time;
+        }
+        std::pop_heap(drain_events.begin(), drain_events.end(), std::greater<>());
+        drain_events.pop_back();
+        stale_drain_events_count--;
+    }
+    return never;
+}
+
+void FlowModel::drain() noexcept {
+    while (next_drain_time() < never) {
+        const auto flow_id = std::get<1>(drain_events.front());
+        auto& flow = flows[flow_id];
+
+        // the earliest flow to drain isn't drained yet
+        const auto remaining_bytes = flow.remaining_bytes - flow.rate * (current_time - flow.update_time);
+        if (remaining_bytes > drained_bytes_threshold) {
+            break;
+        }
+
+        // last byte left src: arrives after the propagation latency
+        std::pop_heap(drain_events.begin(), drain_events.end(), std::greater<>());
+        drain_events.pop_back();
+        flow.remaining_bytes = 0;
+        flow.update_time = current_time;
+        deactivate(flow_id);
+        delivering_flows.emplace(current_time + flow.path_latency, flow_id);
+    }
+}
+
+void FlowModel::allocate_rates() noexcept {
+    // a started flow gets at least the even share of its links
+    auto changed_rate = min_drained_rate;
+    for (const auto flow_id : started_flows) {
+        const auto& route = flows[flow_id].route;
+        for (auto hop = 0; hop < route.size() - 1; hop++) {
+            const auto link_id = route.link_id(hop);
+            changed_rate = std::min(changed_rate, link_capacities[link_id] / link_flows[link_id].size());
+        }
+    }
+
+    // progressive filling is unchanged below changed_rate: slower flows keep their rates
+    const auto fixed_rate_limit = changed_rate * (1 - fixed_rate_tolerance);
+    const auto recomputed = [&](const Flow& flow) {
+        return flow.rate >= fixed_rate_limit;
+    };
+
+    // collect the recomputed flows connected to the changed links, and their links
+    visit_epoch++;
+    component_links.clear();
+    component_flows.clear();
+    const auto visit_link = [this](const LinkId link_id) {
+        if (link_visit_epochs[link_id] != visit_epoch) {
+            link_visit_epochs[link_id] = visit_epoch;
+            component_links.push_back(link_id);
+        }
+    };
+    const auto visit_flow = [&](const FlowId flow_id) {
+        auto& flow = flows[flow_id];
+        flow.visit_epoch = visit_epoch;
+        component_flows.push_back(flow_id);
+        for (auto hop = 0; hop < flow.route.size() - 1; hop++) {
+            visit_link(flow.route.link_id(hop));
+        }
+    };
+    for (const auto flow_id : started_flows) {
+        visit_flow(flow_id);
+    }
+    for (const auto link_id : changed_links) {
+        visit_link(link_id);
+    }
+    for (auto i = size_t(0); i < component_links.size(); i++) {
+        for (const auto flow_id : link_flows[component_links[i]]) {
+            const auto& flow = flows[flow_id];
+            if (flow.visit_epoch != visit_epoch && recomputed(flow)) {
+                visit_flow(flow_id);
+            }
+        }
+    }
+    changed_links.clear();
+    started_flows.clear();
+    min_drained_rate = never;
+
+    // drain the flows at their current rates up to now (their drain events become stale)
+    for (const auto flow_id : component_flows) {
+        auto& flow = flows[flow_id];
+        if (flow.rate > 0) {
+            stale_drain_events_count++;
+        }
+        flow.remaining_bytes = std::max(flow.remaining_bytes - flow.rate * (current_time - flow.update_time), 0.0);
+        flow.update_time = current_time;
+    }
+
+    // the links are left with the bandwidth the fixed flows don't take
+    for (const auto link_id : component_links) {
+        residual_capacities[link_id] = link_capacities[link_id];
+        unfrozen_flows_count[link_id] = 0;
+        for (const auto flow_id : link_flows[link_id]) {
+            const auto& flow = flows[flow_id];
+            if (flow.visit_epoch == visit_epoch) {
+                unfrozen_flows_count[link_id]++;
+            } else {
+                residual_capacities[link_id] -= flow.rate;
+            }
+        }
+    }
+    for (const auto flow_id : component_flows) {
+        flows[flow_id].rate = -1;  // unfrozen
+    }
+
+    // progressive filling: repeatedly saturate the most constrained link,
+    // fixing the rate of the flows crossing it to its fair share.
+    // Freezing flows at the smallest share only raises the shares of the other links,
+    // so outdated shares are refreshed when popped.
+    auto link_shares = LinkShares();
+    for (const auto link_id : component_links) {
+        if (unfrozen_flows_count[link_id] > 0) {
+            link_shares.emplace(residual_capacities[link_id] / unfrozen_flows_count[link_id], link_id);
+        }
+    }
+    while (!link_shares.empty()) {
+        const auto [share, bottleneck_link] = link_shares.top();
+        link_shares.pop();
+        if (unfrozen_flows_count[bottleneck_link] == 0) {
+            continue;
+        }
+        const auto current_share = residual_capacities[bottleneck_link] / unfrozen_flows_count[bottleneck_link];
+        if (current_share > share) {
+            link_shares.emplace(current_share, bottleneck_link);
+            continue;
+        }
+        const auto fair_share = std::max(current_share, 0.0);
+
+        // freeze its flows
+        for (const auto flow_id : link_flows[bottleneck_link]) {
+            auto& flow = flows[flow_id];
+            if (flow.visit_epoch != visit_epoch || flow.rate >= 0) {
+                continue;
+            }
+
+            flow.rate = fair_share;
+            for (auto hop = 0; hop < flow.route.size() - 1; hop++) {
+                const auto link_id = flow.route.link_id(hop);
+                residual_capacities[link_id] -= fair_share;
+                unfrozen_flows_count[link_id]--;
+            }
+        }
+    }
+
+    // project the drain time of every updated flow, invalidating its earlier ones
+    for (const auto flow_id : component_flows) {
+        flows[flow_id].generation++;
+    }
+    rate_updates_count += component_flows.size();
+
+    // most drain events are stale (e.g., all-to-all): drop them and rebuild the heap in linear time,
+    // rather than popping them one by one
+    const auto rebuild = (2 * stale_drain_events_count >= drain_events.size());
+    if (rebuild) {
+        const auto stale = [this](const DrainEvent& drain_event) {
+            const auto& flow = flows[std::get<1>(drain_event)];
+            return !flow.active || flow.generation != std::get<2>(drain_event);
+        };
+        drain_events.erase(std::remove_if(drain_events.begin(), drain_events.end(), stale), drain_events.end());
+        stale_drain_events_count = 0;
+    }
+    for (const auto flow_id : component_flows) {
+        const auto& flow = flows[flow_id];
+        assert(flow.rate >= 0);
+        if (flow.rate > 0) {
+            drain_events.emplace_back(current_time + (flow.remaining_bytes / flow.rate), flow_id, flow.generation);
+            if (!rebuild) {
+                std::push_heap(drain_events.begin(), drain_events.end(), std::greater<>());
+            }
+        }
+    }
+    if (rebuild) {
+        std::make_heap(drain_events.begin(), drain_events.end(), std::greater<>());
+    }
+}
@@ -4,19 +4,36 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Helper.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/CustomTopology.h"
+#include "congestion_aware/Dragonfly.h"
+#include "congestion_aware/FatTree.h"
 #include "congestion_aware/FullyConnected.h"
 #include "congestion_aware/Ring.h"
 #include "congestion_aware/Switch.h"
 #include "congestion_aware/Mesh2D.h"
+#include "congestion_aware/Mesh3D.h"
+#include "congestion_aware/MultiDimTopology.h"
+#include "congestion_aware/MultiRail.h"
 #include "congestion_aware/SparseMesh2D.h"
+#include "congestion_aware/Torus.h"
+#include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <unordered_set>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionAware;
 
-std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
-    const NetworkParser& network_parser) noexcept {
+namespace {
+
+/**
+ * Construct the devices and links of a topology from a NetworkParser, with the bandwidth and latency of each dim.
+ *
+ * @param network_parser NetworkParser to parse the network input file
+ * @return pointer to the constructed topology
+ */
+std::shared_ptr<Topology> construct_topology_shape(const NetworkParser& network_parser) noexcept {
     // get network_parser info
     const auto dims_count = network_parser.get_dims_count();
     const auto topologies_per_dim = network_parser.get_topologies_per_dim();
@@ -24,10 +41,37 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
     const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
     const auto latencies_per_dim = network_parser.get_latencies_per_dim();
 
-    // for now, congestion_aware backend supports 1-dim topology only
-    if (dims_count != 1) {
-        std::cerr << "[Error] (network/analytical/congestion_aware) " << "only support 1-dim topology" << std::endl;
-        std::exit(-1);
+    // multi-dim topology: stack up basic topologies
+    if (dims_count > 1) {
+        auto topology_per_dim = std::vector<std::unique_ptr<BasicTopology>>();
+
+        for (auto dim = 0; dim < dims_count; dim++) {
+            // retrieve info
+            const auto topology_type = topologies_per_dim[dim];
+            const auto npus_count = npus_counts_per_dim[dim];
+            const auto bandwidth = bandwidths_per_dim[dim];
+            const auto latency = latencies_per_dim[dim];
+
+            // create a network dim
+            switch (topology_type) {
+            case TopologyBuildingBlock::Ring:
+                topology_per_dim.push_back(std::make_unique<Ring>(npus_count, bandwidth, latency));
+                break;
+            case TopologyBuildingBlock::Switch:
+                topology_per_dim.push_back(std::make_unique<Switch>(npus_count, bandwidth, latency));
+                break;
+            case TopologyBuildingBlock::FullyConnected:
+                topology_per_dim.push_back(std::make_unique<FullyConnected>(npus_count, bandwidth, latency));
+                break;
+            default:
+                // Mesh2D, SparseMesh2D, Mesh3D, Torus, FatTree, and Dragonfly are configured as 1-dim topologies only
+                std::cerr << "[Error] (network/analytical/congestion_aware) "
+                          << "not supported basic-topology in multi-dim topology" << std::endl;
+                std::exit(-1);
+            }
+        }
+
+        return std::make_shared<MultiDimTopology>(std::move(topology_per_dim));
     }
 
     // retrieve basic basic-topology info
@@ -39,12 +83,6 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
     // get mesh dimensions (for Mesh2D topology)
     const auto mesh_width = network_parser.get_mesh_width();
     const auto mesh_height = network_parser.get_mesh_height();
-    
-    // get excluded coordinates (for SparseMesh2D topology)
-    const auto excluded_coords = network_parser.get_excluded_coords();
-    
-    // get custom NPU placement (for SparseMesh2D topology with custom layout)
-    const auto npu_placement = network_parser.get_npu_placement();
 
     switch (topology_type) {
     case TopologyBuildingBlock::Ring:
@@ -53,31 +91,201 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
         return std::make_shared<Switch>(npus_count, bandwidth, latency);
     case TopologyBuildingBlock::FullyConnected:
         return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
-    case TopologyBuildingBlock::Mesh2D:
+    case TopologyBuildingBlock::Mesh2D: {
         // Use explicit width/height if provided, otherwise fall back to square mesh
-        if (mesh_width > 0 && mesh_height > 0) {
-            return std::make_shared<Mesh2D>(mesh_width, mesh_height, bandwidth, latency);
-        } else {
-            return std::make_shared<Mesh2D>(npus_count, bandwidth, latency);
-        }
+        const auto mesh = (mesh_width > 0 && mesh_height > 0)
+                              ? std::make_shared<Mesh2D>(mesh_width, mesh_height, bandwidth, latency)
+                              : std::make_shared<Mesh2D>(npus_count, bandwidth, latency);
+        mesh->set_routing(network_parser.get_mesh_routing());
+        return mesh;
+    }
     case TopologyBuildingBlock::SparseMesh2D:
         // SparseMesh2D requires width, height, and excluded coordinates
         if (mesh_width > 0 && mesh_height > 0) {
-            // Use custom placement constructor if npu_placement is provided
-            if (!npu_placement.empty()) {
-                return std::make_shared<SparseMesh2D>(mesh_width, mesh_height, excluded_coords, 
-                                                      npu_placement, bandwidth, latency);
-            } else {
-                return std::make_shared<SparseMesh2D>(mesh_width, mesh_height, excluded_coords, 
+            // excluded cells and custom placement are expanded into grids only now
+            const auto valid_cells = network_parser.get_valid_cells();
+            const auto npu_placement_grid = network_parser.get_npu_placement_grid();
+            if (!npu_placement_grid.empty()) {
+                return std::make_shared<SparseMesh2D>(mesh_width, mesh_height, valid_cells, npu_placement_grid,
                                                       bandwidth, latency);
+            } else {
+                return std::make_shared<SparseMesh2D>(mesh_width, mesh_height, valid_cells, bandwidth, latency);
             }
         } else {
             std::cerr << "[Error] (network/analytical/congestion_aware) SparseMesh2D requires width and height" << std::endl;
             std::exit(-1);
         }
+    case TopologyBuildingBlock::Mesh3D:
+        // dimensions and excluded cells are checked by the parser
+        return std::make_shared<Mesh3D>(mesh_width, mesh_height, network_parser.get_mesh_depth(),
+                                        network_parser.get_valid_cells_3d(), bandwidth, latency,
+                                        network_parser.get_vertical_bandwidth(), network_parser.get_vertical_latency());
+    case TopologyBuildingBlock::Torus2D:
+        // dimensions are checked (or derived) by the parser
+        return std::make_shared<Torus>(mesh_width, mesh_height, bandwidth, latency);
+    case TopologyBuildingBlock::Torus3D:
+        return std::make_shared<Torus>(mesh_width, mesh_height, network_parser.get_mesh_depth(), bandwidth, latency);
+    case TopologyBuildingBlock::FatTree:
+        return std::make_shared<FatTree>(npus_count, network_parser.get_fat_tree_radix(),
+                                         network_parser.get_fat_tree_tiers(), bandwidth, latency,
+                                         network_parser.get_fat_tree_oversubscription());
+    case TopologyBuildingBlock::Dragonfly: {
+        const auto dragonfly = std::make_shared<Dragonfly>(npus_count, network_parser.get_dragonfly_npus_per_router(),
+                                                           network_parser.get_dragonfly_routers_per_group(),
+                                                           network_parser.get_dragonfly_global_links_per_router(),
+                                                           bandwidth, latency);
+        dragonfly->set_routing(network_parser.get_dragonfly_routing());
+        return dragonfly;
+    }
+    case TopologyBuildingBlock::MultiRail: {
+        const auto multi_rail = std::make_shared<MultiRail>(npus_count, network_parser.get_multi_rail_rails_count(),
+                                                            bandwidth, latency);
+        multi_rail->set_routing(network_parser.get_multi_rail_routing());
+        return multi_rail;
+    }
+    case TopologyBuildingBlock::Custom:
+        return std::make_shared<CustomTopology>(network_parser.get_edge_list_path(), npus_count, bandwidth, latency);
     default:
         // shouldn't reaach here
         std::cerr << "[Error] (network/analytical/congestion_aware) " << "not supported basic-topology" << std::endl;
         std::exit(-1);
     }
 }
+
+/**
+ * Check that every link override of a NetworkParser refers to links of a topology.
+ *
+ * @param topology topology whose links are overridden
+ * @param network_parser network parser holding the overrides
+ * @return errors found (empty: every override applies)
+ */
+std::vector<ConfigError> check_link_overrides(const Topology& topology, const NetworkParser& network_parser) noexcept {
+    auto errors = std::vector<ConfigError>();
+
+    // link groups are named after their links
+    const auto& group_overrides = network_parser.get_link_group_overrides();
+    if (!group_overrides.empty()) {
+        auto groups = std::unordered_set<std::string>();
+        for (auto link_id = 0; link_id < topology.get_links_count(); link_id++) {
+            groups.insert(topology.get_link_group(link_id));
+        }
+        for (const auto& [group, link_class] : group_overrides) {
+            if (groups.count(group) == 0) {
+                errors.push_back({"link_overrides", "no link in group " + group + " to override"});
+            }
+        }
+    }
+
+    // a device pair should be linked in at least one direction
+    const auto devices_count = topology.get_devices_count();
+    const auto connected = [&](const DeviceId from, const DeviceId to) {
+        return from < devices_count && to < devices_count && topology.find_link(from, to) >= 0;
+    };
+    for (const auto& [src, dest, link_class] : network_parser.get_link_pair_overrides()) {
+        if (!connected(src, dest) && !connected(dest, src)) {
+            errors.push_back({"link_overrides", "no link between " + std::to_string(src) + " and " +
+                                                    std::to_string(dest) + " to override"});
+        }
+    }
+
+    return errors;
+}
+
+}  // namespace
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
+    const NetworkParser& network_parser) noexcept {
+    auto topology = construct_topology_shape(network_parser);
+    apply_link_overrides(*topology, network_parser);
+
+    return topology;
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::try_construct_topology(
+    const NetworkParser& network_parser,
+    std::vector<ConfigError>& errors) noexcept {
+    auto topology = construct_topology_shape(network_parser);
+
+    // overrides are checked against the constructed links
+    auto override_errors = check_link_overrides(*topology, network_parser);
+    if (!override_errors.empty()) {
+        errors.insert(errors.end(), override_errors.begin(), override_errors.end());
+        return nullptr;
+    }
+    apply_link_overrides(*topology, network_parser);
+
+    return topology;
+}
+
+void NetworkAnalyticalCongestionAware::apply_link_overrides(Topology& topology,
+                                                            const NetworkParser& network_parser) noexcept {
+    const auto override_errors = check_link_overrides(topology, network_parser);
+    if (!override_errors.empty()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << override_errors.front().message
+                  << std::endl;
+        std::exit(-1);
+    }
+    const auto& link_classes = network_parser.get_link_classes();
+
+    // bandwidth and background traffic schedules of the link classes, in ticks
+    auto bandwidth_schedules = std::vector<BandwidthSchedule>(link_classes.size());
+    for (auto link_class = static_cast<size_t>(0); link_class < link_classes.size(); link_class++) {
+        for (const auto& [time, bandwidth] : link_classes[link_class].bandwidth_schedule) {
+            bandwidth_schedules[link_class].push_back({ns_to_ticks(time), bandwidth});
+        }
+    }
+    auto background_schedules = std::vector<BackgroundSchedule>(link_classes.size());
+    for (auto link_class = static_cast<size_t>(0); link_class < link_classes.size(); link_class++) {
+        for (const auto& [time, utilization] : link_classes[link_class].background_schedule) {
+            background_schedules[link_class].push_back({ns_to_ticks(time), utilization});
+        }
+    }
+
+    // groups first, so device pairs refine them
+    for (const auto& [group, link_class] : network_parser.get_link_group_overrides()) {
+        topology.set_link_group_parameters(group, link_classes[link_class].bandwidth,
+                                           link_classes[link_class].latency);
+        topology.set_link_group_bandwidth_schedule(group, bandwidth_schedules[link_class]);
+        topology.set_link_group_background_schedule(group, background_schedules[link_class]);
+    }
+
+    // a device pair overrides its links in both directions (a directed topology may only have one)
+    const auto devices_count = topology.get_devices_count();
+    const auto connected = [&](const DeviceId from, const DeviceId to) {
+        return from < devices_count && to < devices_count && topology.find_link(from, to) >= 0;
+    };
+    for (const auto& [src, dest, link_class] : network_parser.get_link_pair_overrides()) {
+        const auto bandwidth = link_classes[link_class].bandwidth;
+        const auto latency = link_classes[link_class].latency;
+        for (const auto& [from, to] : {std::make_pair(src, dest), std::make_pair(dest, src)}) {
+            if (connected(from, to)) {
+                topology.set_link_parameters(from, to, bandwidth, latency);
+                topology.set_link_bandwidth_schedule(from, to, bandwidth_schedules[link_class]);
+                topology.set_link_background_schedule(from, to, background_schedules[link_class]);
+            }
+        }
+    }
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
+    const NetworkParser& network_parser,
+    std::shared_ptr<EventQueue> event_queue) noexcept {
+    assert(event_queue != nullptr);
+
+    // construct the topology and attach the event queue
+    auto topology = construct_topology(network_parser);
+    topology->attach_event_queue(std::move(event_queue));
+
+    return topology;
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
+    const NetworkConfig& network_config) noexcept {
+    return construct_topology(NetworkParser(network_config));
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionAware::construct_topology(
+    const NetworkConfig& network_config,
+    std::shared_ptr<EventQueue> event_queue) noexcept {
+    return construct_topology(NetworkParser(network_config), std::move(event_queue));
+}
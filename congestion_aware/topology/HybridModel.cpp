@@ -0,0 +1,305 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/HybridModel.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// flows with fewer bytes left are considered drained (absorbs rounding errors)
+constexpr double drained_bytes_threshold = 1e-6;
+
+/// smallest share of a link left to its chunks, so a link saturated by flows still serializes them
+constexpr double min_bandwidth_share = 1e-3;
+
+/// no pending event
+constexpr double never = std::numeric_limits<double>::infinity();
+
+}  // namespace
+
+HybridModel::HybridModel(std::shared_ptr<Topology> topology, const ChunkSize flow_threshold) noexcept
+    : topology(std::move(topology)),
+      flow_threshold(flow_threshold),
+      last_drain_time(0),
+      flows_count(0),
+      chunks_count(0) {
+    assert(this->topology != nullptr);
+    assert(flow_threshold > 0);
+
+    event_queue = this->topology->get_event_queue();
+    assert(event_queue != nullptr);
+
+    const auto links_count = this->topology->get_links_count();
+    link_flows_count.assign(links_count, 0);
+    link_chunks_count.assign(links_count, 0);
+    residual_capacities.assign(links_count, 0);
+    unfrozen_counts.assign(links_count, 0);
+    flow_rates.assign(links_count, 0);
+}
+
+HybridModel::~HybridModel() noexcept {
+    for (const auto link_id : shared_links) {
+        topology->set_link_bandwidth_share(link_id, 1);
+    }
+}
+
+void HybridModel::send(const ChunkSize transfer_size,
+                       const DeviceId src,
+                       const DeviceId dest,
+                       const Callback callback,
+                       const CallbackArg callback_arg) noexcept {
+    assert(transfer_size > 0);
+    assert(src != dest);
+
+    const auto* const route = topology->shared_route(src, dest);
+    const auto transfer_id = acquire_transfer(route, callback, callback_arg);
+    auto& transfer = transfers[transfer_id];
+
+    // elephant: a flow sharing the bandwidth from now on
+    if (transfer_size >= flow_threshold) {
+        flows_count++;
+        drain();
+        transfer.is_flow = true;
+        transfer.remaining_bytes = static_cast<double>(transfer_size);
+        active_flows.push_back(transfer_id);
+        for (auto hop = 0; hop < route->size() - 1; hop++) {
+            link_flows_count[route->link_id(hop)]++;
+        }
+        allocate_rates();
+        return;
+    }
+
+    // mouse: a chunk, taking its share of the links it shares with flows
+    chunks_count++;
+    auto shares_changed = false;
+    for (auto hop = 0; hop < route->size() - 1; hop++) {
+        const auto link_id = route->link_id(hop);
+        if (link_chunks_count[link_id]++ == 0 && link_flows_count[link_id] > 0) {
+            shares_changed = true;
+        }
+    }
+    if (shares_changed) {
+        drain();
+        allocate_rates();
+    }
+    topology->send_along(route, transfer_size, transfer_arrived, &transfer);
+}
+
+ChunkSize HybridModel::get_flow_threshold() const noexcept {
+    return flow_threshold;
+}
+
+int HybridModel::get_flows_count() const noexcept {
+    return flows_count;
+}
+
+int HybridModel::get_chunks_count() const noexcept {
+    return chunks_count;
+}
+
+int HybridModel::acquire_transfer(const Route* const route,
+                                  const Callback callback,
+                                  const CallbackArg callback_arg) noexcept {
+    auto transfer_id = 0;
+    if (free_transfers.empty()) {
+        transfer_id = static_cast<int>(transfers.size());
+        transfers.emplace_back();
+    } else {
+        transfer_id = free_transfers.back();
+        free_transfers.pop_back();
+    }
+
+    auto& transfer = transfers[transfer_id];
+    transfer.model = this;
+    transfer.id = transfer_id;
+    transfer.is_flow = false;
+    transfer.route = route;
+    transfer.remaining_bytes = 0;
+    transfer.rate = 0;
+    transfer.callback = callback;
+    transfer.callback_arg = callback_arg;
+    return transfer_id;
+}
+
+void HybridModel::complete_transfer(const int transfer_id) noexcept {
+    const auto callback = transfers[transfer_id].callback;
+    const auto callback_arg = transfers[transfer_id].callback_arg;
+    free_transfers.push_back(transfer_id);
+
+    // the callback may send new transfers
+    if (callback != nullptr) {
+        (*callback)(callback_arg);
+    }
+}
+
+double HybridModel::link_capacity(const LinkId link_id) const noexcept {
+    const auto bandwidth = topology->get_link(link_id).get_bandwidth();
+    return bw_GBps_to_Bpns(bandwidth) / static_cast<double>(ticks_per_ns);
+}
+
+void HybridModel::drain() noexcept {
+    const auto current_time = event_queue->get_current_time();
+    const auto duration = static_cast<double>(current_time - last_drain_time);
+    last_drain_time = current_time;
+
+    auto still_active_flows_count = size_t(0);
+    for (const auto flow_id : active_flows) {
+        auto& flow = transfers[flow_id];
+        flow.remaining_bytes -= flow.rate * duration;
+        if (flow.remaining_bytes > drained_bytes_threshold) {
+            active_flows[still_active_flows_count++] = flow_id;
+            continue;
+        }
+
+        // last byte left src: arrives after the latency of the route
+        auto path_latency = EventTime(0);
+        for (auto hop = 0; hop < flow.route->size() - 1; hop++) {
+            const auto link_id = flow.route->link_id(hop);
+            link_flows_count[link_id]--;
+            path_latency += ns_to_ticks(topology->get_link(link_id).get_latency());
+        }
+        event_queue->schedule_event(current_time + path_latency, transfer_arrived, &flow);
+    }
+    active_flows.resize(still_active_flows_count);
+}
+
+void HybridModel::allocate_rates() noexcept {
+    // contenders of each link: its flows, plus its chunks as a single flow
+    auto used_links = std::vector<LinkId>();
+    for (const auto flow_id : active_flows) {
+        const auto* const route = transfers[flow_id].route;
+        for (auto hop = 0; hop < route->size() - 1; hop++) {
+            const auto link_id = route->link_id(hop);
+            if (unfrozen_counts[link_id] == 0) {
+                used_links.push_back(link_id);
+                residual_capacities[link_id] = link_capacity(link_id);
+                unfrozen_counts[link_id] = (link_chunks_count[link_id] > 0) ? 1 : 0;
+                flow_rates[link_id] = 0;
+            }
+            unfrozen_counts[link_id]++;
+        }
+        transfers[flow_id].rate = -1;  // unfrozen
+    }
+
+    // progressive filling: repeatedly saturate the most constrained link,
+    // fixing the rate of its contenders to its fair share
+    auto unfrozen_flows_count = static_cast<int>(active_flows.size());
+    while (unfrozen_flows_count > 0) {
+        auto bottleneck_link = -1;
+        auto fair_share = never;
+        for (const auto link_id : used_links) {
+            if (unfrozen_counts[link_id] == 0) {
+                continue;
+            }
+            const auto share = residual_capacities[link_id] / unfrozen_counts[link_id];
+            if (share < fair_share) {
+                bottleneck_link = link_id;
+                fair_share = share;
+            }
+        }
+        assert(bottleneck_link >= 0);
+        fair_share = std::max(fair_share, 0.0);
+
+        // the chunks of the bottleneck take their share
+        unfrozen_counts[bottleneck_link] = 0;
+        if (link_chunks_count[bottleneck_link] > 0) {
+            residual_capacities[bottleneck_link] -= fair_share;
+        }
+
+        // and so do its flows, on every link they cross
+        for (const auto flow_id : active_flows) {
+            auto& flow = transfers[flow_id];
+            if (flow.rate >= 0) {
+                continue;
+            }
+            auto crosses_bottleneck = false;
+            for (auto hop = 0; hop < flow.route->size() - 1; hop++) {
+                crosses_bottleneck |= (flow.route->link_id(hop) == bottleneck_link);
+            }
+            if (!crosses_bottleneck) {
+                continue;
+            }
+
+            flow.rate = fair_share;
+            unfrozen_flows_count--;
+            for (auto hop = 0; hop < flow.route->size() - 1; hop++) {
+                const auto link_id = flow.route->link_id(hop);
+                residual_capacities[link_id] -= fair_share;
+                flow_rates[link_id] += fair_share;
+                if (link_id != bottleneck_link) {
+                    unfrozen_counts[link_id]--;
+                }
+            }
+        }
+    }
+
+    // the chunks of each link get the bandwidth left by its flows
+    // (links no longer crossed by flows get it all back)
+    for (const auto link_id : shared_links) {
+        if (link_flows_count[link_id] == 0) {
+            topology->set_link_bandwidth_share(link_id, 1);
+        }
+    }
+    for (const auto link_id : used_links) {
+        const auto share = 1 - flow_rates[link_id] / link_capacity(link_id);
+        topology->set_link_bandwidth_share(link_id, std::clamp(share, min_bandwidth_share, 1.0));
+        unfrozen_counts[link_id] = 0;
+    }
+    shared_links = std::move(used_links);
+
+    // the next flow to drain
+    auto next_drain_time = never;
+    for (const auto flow_id : active_flows) {
+        const auto& flow = transfers[flow_id];
+        if (flow.rate > 0) {
+            next_drain_time = std::min(next_drain_time, flow.remaining_bytes / flow.rate);
+        }
+    }
+    event_queue->cancel(drain_event);
+    if (next_drain_time < never) {
+        const auto drain_time = last_drain_time + static_cast<EventTime>(std::ceil(next_drain_time));
+        drain_event = event_queue->schedule_cancellable_event(drain_time, flow_drained, this);
+    }
+}
+
+void HybridModel::flow_drained(void* const model) noexcept {
+    assert(model != nullptr);
+
+    auto* const hybrid_model = static_cast<HybridModel*>(model);
+    hybrid_model->drain();
+    hybrid_model->allocate_rates();
+}
+
+void HybridModel::transfer_arrived(void* const transfer) noexcept {
+    assert(transfer != nullptr);
+
+    auto* const arrived_transfer = static_cast<Transfer*>(transfer);
+    auto* const model = arrived_transfer->model;
+
+    // a chunk leaves the links it shared with flows
+    if (!arrived_transfer->is_flow) {
+        auto shares_changed = false;
+        for (auto hop = 0; hop < arrived_transfer->route->size() - 1; hop++) {
+            const auto link_id = arrived_transfer->route->link_id(hop);
+            if (--model->link_chunks_count[link_id] == 0 && model->link_flows_count[link_id] > 0) {
+                shares_changed = true;
+            }
+        }
+        if (shares_changed) {
+            model->drain();
+            model->allocate_rates();
+        }
+    }
+
+    model->complete_transfer(arrived_transfer->id);
+}
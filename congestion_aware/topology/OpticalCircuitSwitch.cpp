@@ -0,0 +1,353 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/OpticalCircuitSwitch.h"
+#include "common/TimeBase.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+OpticalCircuitSwitch::OpticalCircuitSwitch(const int npus_count,
+                                           const int ports_count,
+                                           const Bandwidth bandwidth,
+                                           const Latency latency,
+                                           const Latency reconfiguration_delay,
+                                           const std::vector<Circuit>& circuits) noexcept
+    : Topology(),
+      ports_count(ports_count),
+      reconfiguration_delay(ns_to_ticks(reconfiguration_delay)),
+      circuits(circuits),
+      reconfiguring(false),
+      reconfigurations_count(0) {
+    assert(npus_count > 1);
+    assert(ports_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+    assert(reconfiguration_delay >= 0);
+
+    this->npus_count = npus_count;
+    devices_count = npus_count;
+    dims_count = 1;
+    npus_count_per_dim.push_back(npus_count);
+    bandwidth_per_dim.push_back(bandwidth);
+
+    std::sort(this->circuits.begin(), this->circuits.end());
+    check_circuits(this->circuits);
+
+    // every NPU pair may be connected, in src-major order (as FullyConnected)
+    links.make_lazy(
+        npus_count * (npus_count - 1),
+        [npus_count](const LinkId link_id) {
+            const auto src = link_id / (npus_count - 1);
+            const auto dest_index = link_id % (npus_count - 1);
+            return std::make_pair(src, (dest_index < src) ? dest_index : dest_index + 1);
+        },
+        bandwidth, latency);
+
+    // links other than the circuits are dark
+    incoming_circuits.resize(npus_count);
+    for (const auto& [src, dest] : this->circuits) {
+        incoming_circuits[dest].push_back(src);
+    }
+    for (auto link_id = 0; link_id < get_links_count(); link_id++) {
+        const auto [src, dest] = links.endpoints(link_id);
+        if (!std::binary_search(this->circuits.begin(), this->circuits.end(), Circuit(src, dest))) {
+            failed_links.insert(link_id);
+        }
+    }
+
+    // routes change with the circuits, so they aren't cached (select_route keeps them per version instead)
+    set_route_cache_capacity(0);
+
+    next_hops.assign(static_cast<size_t>(npus_count) * npus_count, -1);
+    route_versions.assign(npus_count, 0);
+    for (auto dest = 0; dest < npus_count; dest++) {
+        compute_next_hops(dest);
+    }
+}
+
+void OpticalCircuitSwitch::reconfigure(const std::vector<Circuit>& new_circuits) noexcept {
+    if (reconfiguring) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "the optical circuit switch is reconfigured before its previous reconfiguration is done"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    auto sorted_circuits = new_circuits;
+    std::sort(sorted_circuits.begin(), sorted_circuits.end());
+    check_circuits(sorted_circuits);
+
+    // the circuits leaving the configuration, and the ones joining it
+    auto torn_down_circuits = std::vector<Circuit>();
+    std::set_difference(circuits.begin(), circuits.end(), sorted_circuits.begin(), sorted_circuits.end(),
+                        std::back_inserter(torn_down_circuits));
+    lighting_circuits.clear();
+    std::set_difference(sorted_circuits.begin(), sorted_circuits.end(), circuits.begin(), circuits.end(),
+                        std::back_inserter(lighting_circuits));
+    circuits = std::move(sorted_circuits);
+    reconfigurations_count++;
+    reconfiguring = !lighting_circuits.empty();
+
+    // tear the leaving circuits down at once (rerouting the chunks waiting for them)
+    auto torn_down_link_ids = std::vector<LinkId>();
+    for (const auto& [src, dest] : torn_down_circuits) {
+        auto& srcs = incoming_circuits[dest];
+        srcs.erase(std::lower_bound(srcs.begin(), srcs.end(), src));
+        torn_down_link_ids.push_back(find_link(src, dest));
+    }
+    set_links_failed(torn_down_link_ids, true);
+
+    // and light the new ones up after the blackout
+    if (!reconfiguring) {
+        return;
+    }
+    if (reconfiguration_delay == 0) {
+        light_up_circuits();
+        return;
+    }
+    if (scheduler == nullptr) {
+        assert(default_event_queue != nullptr);
+        attach_event_queue(default_event_queue);
+    }
+    scheduler->schedule_event(scheduler->get_current_time() + reconfiguration_delay, reconfiguration_done,
+                              static_cast<void*>(this));
+}
+
+void OpticalCircuitSwitch::schedule_reconfiguration(const EventTime time, std::vector<Circuit> new_circuits) noexcept {
+    // topologies created before the default event queue was set pick it up now
+    if (scheduler == nullptr) {
+        assert(default_event_queue != nullptr);
+        attach_event_queue(default_event_queue);
+    }
+    assert(time >= scheduler->get_current_time());
+
+    scheduled_reconfigurations.push_back({time, std::move(new_circuits)});
+    scheduler->schedule_event(time, apply_scheduled_reconfigurations, static_cast<void*>(this));
+}
+
+const std::vector<OpticalCircuitSwitch::Circuit>& OpticalCircuitSwitch::get_circuits() const noexcept {
+    return circuits;
+}
+
+bool OpticalCircuitSwitch::is_reconfiguring() const noexcept {
+    return reconfiguring;
+}
+
+int OpticalCircuitSwitch::get_reconfigurations_count() const noexcept {
+    return reconfigurations_count;
+}
+
+Route OpticalCircuitSwitch::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // unreachable: the direct link, whose chunks wait for the circuits to light up
+    if (src != dest && live_next_hop(src, dest) < 0) {
+        return Route({src, dest});
+    }
+
+    // follow the next hops
+    auto route = Route({src});
+    for (auto current = src; current != dest;) {
+        current = live_next_hop(current, dest);
+        assert(current >= 0);
+        route.push_back(current);
+    }
+    return route;
+}
+
+DeviceId OpticalCircuitSwitch::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // unreachable: the direct link (see compute_route)
+    const auto next = live_next_hop(current, dest);
+    return (next < 0) ? dest : next;
+}
+
+LinkId OpticalCircuitSwitch::find_link(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // no self-loop
+    if (src == dest) {
+        return -1;
+    }
+
+    // links of src skip src itself
+    return src * (npus_count - 1) + ((dest < src) ? dest : dest - 1);
+}
+
+const Route* OpticalCircuitSwitch::select_route(const DeviceId src,
+                                                const DeviceId dest,
+                                                const uint64_t chunk_id) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    (void)chunk_id;
+
+    // a row of routes is allocated on the first route from its src
+    if (versioned_routes.empty()) {
+        versioned_routes.resize(npus_count);
+    }
+    auto& src_routes = versioned_routes[src];
+    if (src_routes == nullptr) {
+        src_routes = std::make_unique<VersionedRoute[]>(npus_count);
+    }
+
+    // recompute the route once the routes toward dest changed
+    auto& versioned_route = src_routes[dest];
+    if (versioned_route.route == nullptr || versioned_route.version != route_versions[dest]) {
+        if (versioned_route.route != nullptr) {
+            retired_routes.push_back(std::move(versioned_route.route));
+        }
+        versioned_route.route = std::make_unique<Route>(compute_route(src, dest));
+        versioned_route.version = route_versions[dest];
+        resolve_links(*versioned_route.route);
+    }
+    return versioned_route.route.get();
+}
+
+bool OpticalCircuitSwitch::has_fixed_routes() const noexcept {
+    // routes change as circuits are reconfigured
+    return false;
+}
+
+void OpticalCircuitSwitch::check_circuits(const std::vector<Circuit>& sorted_circuits) const noexcept {
+    auto outgoing_counts = std::vector<int>(npus_count, 0);
+    auto incoming_counts = std::vector<int>(npus_count, 0);
+    for (auto i = size_t(0); i < sorted_circuits.size(); i++) {
+        const auto [src, dest] = sorted_circuits[i];
+        if (src < 0 || src >= npus_count || dest < 0 || dest >= npus_count || src == dest) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid circuit " << src << " -> "
+                      << dest << std::endl;
+            std::exit(-1);
+        }
+        if (i > 0 && sorted_circuits[i - 1] == sorted_circuits[i]) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "circuit " << src << " -> " << dest
+                      << " is listed twice" << std::endl;
+            std::exit(-1);
+        }
+        if (++outgoing_counts[src] > ports_count || ++incoming_counts[dest] > ports_count) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "circuit " << src << " -> " << dest
+                      << " exceeds the " << ports_count << " ports of an NPU" << std::endl;
+            std::exit(-1);
+        }
+    }
+}
+
+void OpticalCircuitSwitch::compute_next_hops(const DeviceId dest) noexcept {
+    assert(0 <= dest && dest < npus_count);
+
+    // breadth-first search from dest: every NPU reached moves to the NPU it was reached from
+    auto* const dest_next_hops = &next_hops[static_cast<size_t>(dest) * npus_count];
+    std::fill(dest_next_hops, dest_next_hops + npus_count, -1);
+    auto frontier = std::vector<DeviceId>({dest});
+    dest_next_hops[dest] = dest;
+    for (auto index = static_cast<size_t>(0); index < frontier.size(); index++) {
+        const auto current = frontier[index];
+        for (const auto previous : incoming_circuits[current]) {
+            if (dest_next_hops[previous] == -1) {
+                dest_next_hops[previous] = current;
+                frontier.push_back(previous);
+            }
+        }
+    }
+    dest_next_hops[dest] = -1;
+
+    // chunks sent from now on toward dest take the new routes
+    route_versions[dest]++;
+}
+
+void OpticalCircuitSwitch::light_up_circuits() noexcept {
+    assert(reconfiguring);
+
+    reconfiguring = false;
+    auto lit_link_ids = std::vector<LinkId>();
+    for (const auto& [src, dest] : lighting_circuits) {
+        auto& srcs = incoming_circuits[dest];
+        srcs.insert(std::upper_bound(srcs.begin(), srcs.end(), src), src);
+        lit_link_ids.push_back(find_link(src, dest));
+        failed_links.erase(lit_link_ids.back());
+    }
+    lighting_circuits.clear();
+
+    // then the chunks waiting for the circuits take them
+    repair_routes(lit_link_ids, false);
+    resume_stranded_chunks();
+}
+
+void OpticalCircuitSwitch::reconfiguration_done(void* const topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    static_cast<OpticalCircuitSwitch*>(topology_ptr)->light_up_circuits();
+}
+
+void OpticalCircuitSwitch::apply_scheduled_reconfigurations(void* const topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    auto* const topology = static_cast<OpticalCircuitSwitch*>(topology_ptr);
+    const auto current_time = topology->scheduler->get_current_time();
+
+    // start the reconfigurations due by now in the order scheduled (one may already be started by an earlier event)
+    auto& scheduled = topology->scheduled_reconfigurations;
+    const auto due_end = std::stable_partition(scheduled.begin(), scheduled.end(),
+                                               [current_time](const ScheduledReconfiguration& reconfiguration) {
+                                                   return reconfiguration.time <= current_time;
+                                               });
+    auto due_reconfigurations = std::vector<ScheduledReconfiguration>(std::make_move_iterator(scheduled.begin()),
+                                                                      std::make_move_iterator(due_end));
+    scheduled.erase(scheduled.begin(), due_end);
+
+    for (const auto& reconfiguration : due_reconfigurations) {
+        topology->reconfigure(reconfiguration.circuits);
+    }
+}
+
+bool OpticalCircuitSwitch::links_restoring() const noexcept {
+    return reconfiguring || !scheduled_reconfigurations.empty();
+}
+
+void OpticalCircuitSwitch::repair_routes(const std::vector<LinkId>& changed_link_ids, const bool failed) noexcept {
+    for (auto dest = 0; dest < npus_count; dest++) {
+        const auto* const dest_next_hops = &next_hops[static_cast<size_t>(dest) * npus_count];
+        for (const auto link_id : changed_link_ids) {
+            if (next_hops_affected(dest_next_hops, dest, link_id, failed)) {
+                compute_next_hops(dest);
+                break;
+            }
+        }
+    }
+}
+
+DeviceId OpticalCircuitSwitch::live_next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    return next_hops[static_cast<size_t>(dest) * npus_count + current];
+}
+
+uint64_t OpticalCircuitSwitch::get_route_tables_bytes() const noexcept {
+    auto bytes = Topology::get_route_tables_bytes() + next_hops.capacity() * sizeof(DeviceId);
+    for (const auto& src_routes : versioned_routes) {
+        if (src_routes == nullptr) {
+            continue;
+        }
+        bytes += npus_count * sizeof(VersionedRoute);
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src_routes[dest].route != nullptr) {
+                bytes += sizeof(Route) + src_routes[dest].route->get_heap_bytes();
+            }
+        }
+    }
+    return bytes;
+}
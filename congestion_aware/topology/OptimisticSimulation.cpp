@@ -0,0 +1,338 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/OptimisticSimulation.h"
+#include "common/TimeBase.h"
+#include "congestion_aware/ParallelSimulation.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <tuple>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// no event left
+constexpr auto never = std::numeric_limits<EventTime>::max();
+
+}  // namespace
+
+bool OptimisticSimulation::Event::operator<(const Event& other) const noexcept {
+    return std::tie(time, chunk, hop) < std::tie(other.time, other.chunk, other.hop);
+}
+
+OptimisticSimulation::OptimisticSimulation(std::shared_ptr<Topology> topology,
+                                           const int partitions_count,
+                                           const int threads_count) noexcept
+    : OptimisticSimulation(topology,
+                           ParallelSimulation::partition_devices(*topology, partitions_count),
+                           threads_count) {}
+
+OptimisticSimulation::OptimisticSimulation(std::shared_ptr<Topology> topology,
+                                           std::vector<int> partition_per_device,
+                                           const int threads_count) noexcept
+    : topology(std::move(topology)),
+      partition_per_device(std::move(partition_per_device)),
+      batch_size(1024),
+      optimism_window(never),
+      current_time(0),
+      chunk_injected(false),
+      executor(threads_count),
+      rounds_count(0),
+      committed_events_count(0) {
+    assert(this->topology != nullptr);
+    assert(this->partition_per_device.size() == this->topology->get_devices_count());
+
+    partitions_count = *std::max_element(this->partition_per_device.begin(), this->partition_per_device.end()) + 1;
+    partitions.resize(partitions_count);
+    for (auto& partition : partitions) {
+        partition.rollbacks_count = 0;
+        partition.rolled_back_events_count = 0;
+    }
+    outboxes.resize(partitions_count * partitions_count);
+    link_free_times.assign(this->topology->get_links_count(), 0);
+}
+
+void OptimisticSimulation::send(const ChunkSize chunk_size,
+                                const DeviceId src,
+                                const DeviceId dest,
+                                const Callback callback,
+                                const CallbackArg callback_arg) noexcept {
+    assert(chunk_size > 0);
+    assert(0 <= src && src < topology->get_npus_count());
+    assert(0 <= dest && dest < topology->get_npus_count());
+    assert(src != dest);
+
+    // resolve the hops upfront, so partitions never touch the topology
+    const auto* const route = topology->shared_route(src, dest);
+    auto chunk = OptimisticChunk();
+    for (auto hop = 0; hop < route->size() - 1; hop++) {
+        const auto link_id = route->link_id(hop);
+        const auto& link = topology->get_link(link_id);
+        if (link.get_channels_count() > 1 || link.get_packet_size() > 0 ||
+            link.get_switching_mode() != SwitchingMode::StoreAndForward ||
+            link.get_queueing_policy() != QueueingPolicy::FIFO || link.get_bandwidth_schedule() != nullptr ||
+            link.get_background_schedule() != nullptr || link.get_buffer_capacity() > 0 || link.is_contention_free()) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "optimistic simulation only supports FIFO store-and-forward links" << std::endl;
+            std::exit(-1);
+        }
+
+        const auto latency = ns_to_ticks(link.get_latency());
+        chunk.hops.push_back(
+            {link_id, partition_per_device[link.get_src()], link.communication_delay(chunk_size) - latency, latency});
+    }
+    chunk.dest_partition = partition_per_device[dest];
+    chunk.callback = callback;
+    chunk.callback_arg = callback_arg;
+
+    // inject the chunk at its src at the current time
+    // (during a commit, this may roll back events the src partition already processed)
+    const auto chunk_index = static_cast<int>(chunks.size());
+    chunks.push_back(std::move(chunk));
+    const auto src_partition = partition_per_device[src];
+    partitions[src_partition].inbox.push_back({{current_time, chunk_index, 0}, false});
+    chunk_injected = true;
+}
+
+void OptimisticSimulation::set_batch_size(const int new_batch_size) noexcept {
+    assert(new_batch_size > 0);
+
+    batch_size = new_batch_size;
+}
+
+void OptimisticSimulation::set_optimism_window(const EventTime new_optimism_window) noexcept {
+    assert(new_optimism_window > 0);
+
+    optimism_window = new_optimism_window;
+}
+
+EventTime OptimisticSimulation::run() noexcept {
+    while (true) {
+        commit(compute_gvt());
+
+        // done once nothing is pending, in transit, or left to commit
+        auto events_left = false;
+        for (const auto& partition : partitions) {
+            events_left |= !partition.pending_events.empty() || !partition.inbox.empty() ||
+                           !partition.processed_events.empty();
+        }
+        if (!events_left) {
+            break;
+        }
+
+        // partitions process their events past the GVT optimistically
+        const auto gvt = compute_gvt();
+        const auto window_end = (optimism_window > never - gvt) ? never : gvt + optimism_window;
+        rounds_count++;
+        executor.run(partitions_count, [&](const int partition_id) { run_partition(partition_id, window_end); });
+
+        // deliver the messages of the round, keeping the order of each (src, dest) pair,
+        // so an anti-message never overtakes the event it cancels
+        for (auto src_partition = 0; src_partition < partitions_count; src_partition++) {
+            for (auto dest_partition = 0; dest_partition < partitions_count; dest_partition++) {
+                auto& outbox = outboxes[src_partition * partitions_count + dest_partition];
+                auto& inbox = partitions[dest_partition].inbox;
+                inbox.insert(inbox.end(), outbox.begin(), outbox.end());
+                outbox.clear();
+            }
+        }
+    }
+
+    return current_time;
+}
+
+EventTime OptimisticSimulation::get_current_time() const noexcept {
+    return current_time;
+}
+
+int OptimisticSimulation::get_partitions_count() const noexcept {
+    return partitions_count;
+}
+
+int64_t OptimisticSimulation::get_rounds_count() const noexcept {
+    return rounds_count;
+}
+
+int64_t OptimisticSimulation::get_committed_events_count() const noexcept {
+    return committed_events_count;
+}
+
+int64_t OptimisticSimulation::get_rollbacks_count() const noexcept {
+    auto rollbacks_count = static_cast<int64_t>(0);
+    for (const auto& partition : partitions) {
+        rollbacks_count += partition.rollbacks_count;
+    }
+    return rollbacks_count;
+}
+
+int64_t OptimisticSimulation::get_rolled_back_events_count() const noexcept {
+    auto rolled_back_events_count = static_cast<int64_t>(0);
+    for (const auto& partition : partitions) {
+        rolled_back_events_count += partition.rolled_back_events_count;
+    }
+    return rolled_back_events_count;
+}
+
+int OptimisticSimulation::event_partition(const Event& event) const noexcept {
+    const auto& chunk = chunks[event.chunk];
+    if (event.hop == static_cast<int>(chunk.hops.size())) {
+        return chunk.dest_partition;
+    }
+    return chunk.hops[event.hop].partition;
+}
+
+void OptimisticSimulation::post(const int src_partition, const int dest_partition, const Message& message) noexcept {
+    if (src_partition != dest_partition) {
+        outboxes[src_partition * partitions_count + dest_partition].push_back(message);
+        return;
+    }
+
+    // a partition's own events always come after the one sending them, so they are never stragglers
+    auto& pending_events = partitions[src_partition].pending_events;
+    if (message.anti) {
+        [[maybe_unused]] const auto erased_count = pending_events.erase(message.event);
+        assert(erased_count == 1);
+    } else {
+        pending_events.insert(message.event);
+    }
+}
+
+void OptimisticSimulation::run_partition(const int partition_id, const EventTime window_end) noexcept {
+    auto& partition = partitions[partition_id];
+
+    // apply the received messages, rolling back past stragglers
+    for (const auto& message : partition.inbox) {
+        if (message.anti) {
+            if (partition.pending_events.erase(message.event) == 0) {
+                rollback(partition_id, message.event, true);
+                [[maybe_unused]] const auto erased_count = partition.pending_events.erase(message.event);
+                assert(erased_count == 1);
+            }
+            continue;
+        }
+        rollback(partition_id, message.event, false);
+        partition.pending_events.insert(message.event);
+    }
+    partition.inbox.clear();
+
+    // process events in order, as far as the batch and window allow
+    for (auto processed_count = 0; processed_count < batch_size; processed_count++) {
+        if (partition.pending_events.empty() || partition.pending_events.begin()->time >= window_end) {
+            break;
+        }
+        const auto event = *partition.pending_events.begin();
+        partition.pending_events.erase(partition.pending_events.begin());
+        process(partition_id, event);
+    }
+}
+
+void OptimisticSimulation::process(const int partition_id, const Event& event) noexcept {
+    auto& partition = partitions[partition_id];
+    const auto& chunk = chunks[event.chunk];
+
+    // arrived: the callback is invoked once committed
+    if (event.hop == static_cast<int>(chunk.hops.size())) {
+        partition.processed_events.push_back({event, 0, {}, -1});
+        return;
+    }
+
+    // serialize the chunk once the link is free, saving the link state
+    const auto& hop = chunk.hops[event.hop];
+    auto& link_free_time = link_free_times[hop.link_id];
+    const auto saved_link_free_time = link_free_time;
+    link_free_time = std::max(event.time, link_free_time) + hop.serialization_delay;
+
+    // and send it to the next hop
+    const auto next_event = Event{link_free_time + hop.latency, event.chunk, event.hop + 1};
+    const auto next_partition = event_partition(next_event);
+    partition.processed_events.push_back({event, saved_link_free_time, next_event, next_partition});
+    post(partition_id, next_partition, {next_event, false});
+}
+
+void OptimisticSimulation::rollback(const int partition_id, const Event& event, const bool inclusive) noexcept {
+    auto& partition = partitions[partition_id];
+    auto undone_count = 0;
+
+    // undo in reverse order, so each link gets back the state before the earliest undone event
+    while (!partition.processed_events.empty()) {
+        const auto& processed_event = partition.processed_events.back();
+        if (processed_event.event < event || (!inclusive && !(event < processed_event.event))) {
+            break;
+        }
+
+        if (processed_event.sent_partition >= 0) {
+            const auto& hop = chunks[processed_event.event.chunk].hops[processed_event.event.hop];
+            link_free_times[hop.link_id] = processed_event.saved_link_free_time;
+            post(partition_id, processed_event.sent_partition, {processed_event.sent_event, true});
+        }
+        partition.pending_events.insert(processed_event.event);
+        partition.processed_events.pop_back();
+        undone_count++;
+    }
+
+    if (undone_count > 0) {
+        partition.rollbacks_count++;
+        partition.rolled_back_events_count += undone_count;
+    }
+}
+
+EventTime OptimisticSimulation::compute_gvt() const noexcept {
+    // rounds are over, so every message in transit sits in an inbox
+    auto gvt = never;
+    for (const auto& partition : partitions) {
+        if (!partition.pending_events.empty()) {
+            gvt = std::min(gvt, partition.pending_events.begin()->time);
+        }
+        for (const auto& message : partition.inbox) {
+            gvt = std::min(gvt, message.event.time);
+        }
+    }
+    return gvt;
+}
+
+void OptimisticSimulation::commit(const EventTime gvt) noexcept {
+    auto commit_end = gvt;
+    chunk_injected = false;
+
+    while (true) {
+        // the earliest uncommitted event among the partitions
+        auto* earliest_partition = static_cast<Partition*>(nullptr);
+        for (auto& partition : partitions) {
+            if (partition.processed_events.empty()) {
+                continue;
+            }
+            if (earliest_partition == nullptr ||
+                partition.processed_events.front().event < earliest_partition->processed_events.front().event) {
+                earliest_partition = &partition;
+            }
+        }
+        if (earliest_partition == nullptr || earliest_partition->processed_events.front().event.time >= commit_end) {
+            break;
+        }
+
+        // it can't be rolled back anymore: free its saved state
+        const auto processed_event = earliest_partition->processed_events.front();
+        earliest_partition->processed_events.pop_front();
+        current_time = processed_event.event.time;
+        committed_events_count++;
+        if (processed_event.sent_partition >= 0) {
+            continue;
+        }
+
+        // arrived
+        const auto& chunk = chunks[processed_event.event.chunk];
+        if (chunk.callback != nullptr) {
+            (*chunk.callback)(chunk.callback_arg);
+        }
+        if (chunk_injected) {
+            commit_end = current_time;
+        }
+    }
+}
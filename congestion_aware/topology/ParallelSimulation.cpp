@@ -0,0 +1,296 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/ParallelSimulation.h"
+#include "congestion_aware/Chunk.h"
+#include "common/TimeBase.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+// declaring per-thread current partition
+thread_local int ParallelSimulation::current_partition = -1;
+
+ParallelSimulation::ParallelSimulation(std::shared_ptr<Topology> topology,
+                                       const int partitions_count,
+                                       const int threads_count) noexcept
+    : ParallelSimulation(topology, partition_devices(*topology, partitions_count), threads_count) {}
+
+ParallelSimulation::ParallelSimulation(std::shared_ptr<Topology> topology,
+                                       std::vector<int> partition_per_device,
+                                       const int threads_count) noexcept
+    : topology(std::move(topology)),
+      partition_per_device(std::move(partition_per_device)),
+      lookahead(std::numeric_limits<EventTime>::max()),
+      executor(threads_count),
+      windows_count(0) {
+    assert(this->topology != nullptr);
+    assert(this->partition_per_device.size() == this->topology->get_devices_count());
+
+    // chunks are forwarded hop by hop, so reservations made ahead of time can't be honored,
+    // and crossbars and ingresses schedule their chunks on the topology's own event queue rather than their partition's
+    if (this->topology->fast_forward || this->topology->switch_model != nullptr ||
+        this->topology->ingress_ticks_per_byte != 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "parallel simulation doesn't support fast forwarding, switch models or ingress bandwidths"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // create the event queue of each partition
+    partitions_count = *std::max_element(this->partition_per_device.begin(), this->partition_per_device.end()) + 1;
+    for (auto partition = 0; partition < partitions_count; partition++) {
+        event_queues.push_back(std::make_shared<EventQueue>());
+    }
+    mailboxes.resize(partitions_count * partitions_count);
+    set_deterministic_order(true);
+
+    // assign the links to the partition of their src,
+    // arrivals crossing partitions are posted to mailboxes
+    // (lazy links are materialized upfront, as partitions can't create them concurrently)
+    this->topology->links.materialize_all();
+    for (auto& link : this->topology->links) {
+        const auto src_partition = this->partition_per_device[link.get_src()];
+        const auto dest_partition = this->partition_per_device[link.get_dest()];
+        assert(0 <= src_partition && src_partition < partitions_count);
+        assert(0 <= dest_partition && dest_partition < partitions_count);
+
+        link.set_scheduler(event_queues[src_partition].get());
+        if (src_partition == dest_partition) {
+            link.set_arrival_mailbox(nullptr);
+            continue;
+        }
+
+        link.set_arrival_mailbox(&mailboxes[src_partition * partitions_count + dest_partition]);
+        lookahead = std::min(lookahead, ns_to_ticks(link.get_latency()));
+    }
+
+    // a zero-latency cut would let partitions affect each other within the same instant
+    if (lookahead == 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "links crossing partitions should have a latency of at least one tick" << std::endl;
+        std::exit(-1);
+    }
+
+    // the topology's own scheduler must be set, otherwise sends would re-attach the default one
+    original_scheduler = this->topology->scheduler;
+    this->topology->scheduler = event_queues[0];
+
+    // build shared lookup structures before workers read them concurrently
+    if (this->topology->adjacency_offsets.empty() && !this->topology->links.lazy()) {
+        this->topology->build_adjacency();
+    }
+}
+
+ParallelSimulation::~ParallelSimulation() noexcept {
+    // hand the links back to the topology
+    for (auto& link : topology->links) {
+        link.set_arrival_mailbox(nullptr);
+    }
+    topology->scheduler = nullptr;
+    if (original_scheduler != nullptr) {
+        topology->attach_scheduler(original_scheduler);
+    }
+}
+
+std::vector<int> ParallelSimulation::partition_devices(const Topology& topology, const int partitions_count) noexcept {
+    const auto npus_count = topology.get_npus_count();
+    const auto devices_count = topology.get_devices_count();
+    assert(1 <= partitions_count && partitions_count <= npus_count);
+
+    // NPU coordinates (dim 0 varying fastest), if NPU ids cover the full grid
+    auto npus_count_per_dim = topology.get_npus_count_per_dim();
+    auto grid_npus_count = 1;
+    for (const auto dim_npus_count : npus_count_per_dim) {
+        grid_npus_count *= dim_npus_count;
+    }
+    if (grid_npus_count != npus_count) {
+        npus_count_per_dim = {npus_count};
+    }
+    const auto dims_count = static_cast<int>(npus_count_per_dim.size());
+
+    // factor partitions_count, largest factor first
+    auto factors = std::vector<int>();
+    auto remaining = partitions_count;
+    for (auto factor = 2; factor <= remaining; factor++) {
+        while (remaining % factor == 0) {
+            factors.push_back(factor);
+            remaining /= factor;
+        }
+    }
+    std::reverse(factors.begin(), factors.end());
+
+    // split the dimension with the largest tile extent by each factor
+    // (ties are broken toward the outer dimension)
+    auto partitions_per_dim = std::vector<int>(dims_count, 1);
+    for (const auto factor : factors) {
+        auto best_dim = -1;
+        auto best_extent = 0.0;
+        for (auto dim = dims_count - 1; dim >= 0; dim--) {
+            if (partitions_per_dim[dim] * factor > npus_count_per_dim[dim]) {
+                continue;
+            }
+            const auto extent = static_cast<double>(npus_count_per_dim[dim]) / partitions_per_dim[dim];
+            if (extent > best_extent) {
+                best_dim = dim;
+                best_extent = extent;
+            }
+        }
+
+        // no dimension can be split further: fall back to contiguous NPU blocks
+        if (best_dim < 0) {
+            npus_count_per_dim = {npus_count};
+            partitions_per_dim = {partitions_count};
+            break;
+        }
+        partitions_per_dim[best_dim] *= factor;
+    }
+
+    // tile the NPUs
+    auto partition_per_device = std::vector<int>(devices_count, -1);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        auto remaining_id = npu;
+        auto partition = 0;
+        auto partition_stride = 1;
+        for (auto dim = 0; dim < static_cast<int>(npus_count_per_dim.size()); dim++) {
+            const auto coordinate = remaining_id % npus_count_per_dim[dim];
+            remaining_id /= npus_count_per_dim[dim];
+
+            const auto tile_coordinate = coordinate * partitions_per_dim[dim] / npus_count_per_dim[dim];
+            partition += tile_coordinate * partition_stride;
+            partition_stride *= partitions_per_dim[dim];
+        }
+        partition_per_device[npu] = partition;
+    }
+
+    // non-NPU devices join their lowest-id NPU neighbor (partition 0 if none)
+    auto lowest_npu_neighbor = std::vector<DeviceId>(devices_count, npus_count);
+    for (auto link_id = 0; link_id < topology.get_links_count(); link_id++) {
+        const auto& link = topology.get_link(link_id);
+        if (link.get_src() >= npus_count && link.get_dest() < npus_count) {
+            lowest_npu_neighbor[link.get_src()] = std::min(lowest_npu_neighbor[link.get_src()], link.get_dest());
+        }
+    }
+    for (auto device = npus_count; device < devices_count; device++) {
+        const auto neighbor = lowest_npu_neighbor[device];
+        partition_per_device[device] = (neighbor < npus_count) ? partition_per_device[neighbor] : 0;
+    }
+
+    return partition_per_device;
+}
+
+void ParallelSimulation::send(const ChunkSize chunk_size,
+                              const DeviceId src,
+                              const DeviceId dest,
+                              const Callback callback,
+                              const CallbackArg callback_arg) noexcept {
+    assert(0 <= src && src < topology->get_npus_count());
+    assert(0 <= dest && dest < topology->get_npus_count());
+
+    // inside a window, a partition can only inject chunks from its own devices
+    assert(current_partition < 0 || current_partition == partition_per_device[src]);
+
+    // the shared routes are computed lazily for all partitions
+    const auto chunk_id = topology->next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+    auto route = static_cast<const Route*>(nullptr);
+    {
+        const auto lock = std::lock_guard<std::mutex>(route_mutex);
+        route = topology->select_route(src, dest, chunk_id);
+    }
+
+    // chunks are not pooled, as the pool is shared by the partitions
+    auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, callback_arg);
+    chunk->chunk_id = chunk_id;
+    topology->send(std::move(chunk));
+}
+
+EventTime ParallelSimulation::run() noexcept {
+    while (true) {
+        deliver_mailboxes();
+
+        // the window starts at the earliest pending event
+        auto events_pending = false;
+        auto window_start = std::numeric_limits<EventTime>::max();
+        for (const auto& event_queue : event_queues) {
+            if (!event_queue->finished()) {
+                events_pending = true;
+                window_start = std::min(window_start, event_queue->get_next_event_time());
+            }
+        }
+        if (!events_pending) {
+            break;
+        }
+
+        // events inside [window_start, window_end) can't affect other partitions before window_end
+        // (without links crossing partitions, a single window covers the whole simulation)
+        const auto max_event_time = std::numeric_limits<EventTime>::max();
+        const auto window_end = (lookahead > max_event_time - window_start) ? max_event_time : window_start + lookahead;
+        windows_count++;
+
+        executor.run(partitions_count, [&](const int partition) {
+            current_partition = partition;
+            auto& event_queue = *event_queues[partition];
+            while (!event_queue.finished() && event_queue.get_next_event_time() < window_end) {
+                event_queue.proceed();
+            }
+            current_partition = -1;
+        });
+    }
+
+    return get_current_time();
+}
+
+void ParallelSimulation::set_deterministic_order(const bool enabled) noexcept {
+    for (const auto& event_queue : event_queues) {
+        event_queue->set_deterministic_order(enabled);
+        Topology::register_event_order_keys(*event_queue);
+    }
+}
+
+EventTime ParallelSimulation::get_current_time() const noexcept {
+    if (current_partition >= 0) {
+        return event_queues[current_partition]->get_current_time();
+    }
+
+    auto current_time = static_cast<EventTime>(0);
+    for (const auto& event_queue : event_queues) {
+        current_time = std::max(current_time, event_queue->get_current_time());
+    }
+    return current_time;
+}
+
+int ParallelSimulation::get_partitions_count() const noexcept {
+    return partitions_count;
+}
+
+int ParallelSimulation::get_partition(const DeviceId device) const noexcept {
+    assert(0 <= device && device < topology->get_devices_count());
+
+    return partition_per_device[device];
+}
+
+EventTime ParallelSimulation::get_lookahead() const noexcept {
+    return lookahead;
+}
+
+int64_t ParallelSimulation::get_windows_count() const noexcept {
+    return windows_count;
+}
+
+void ParallelSimulation::deliver_mailboxes() noexcept {
+    for (auto src_partition = 0; src_partition < partitions_count; src_partition++) {
+        for (auto dest_partition = 0; dest_partition < partitions_count; dest_partition++) {
+            auto& mailbox = mailboxes[src_partition * partitions_count + dest_partition];
+            if (!mailbox.empty()) {
+                mailbox.deliver(*event_queues[dest_partition]);
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/RouteCache.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+RouteCache::RouteCache(const int capacity) noexcept : capacity(capacity) {
+    assert(capacity >= 0);
+}
+
+void RouteCache::set_capacity(const int new_capacity) noexcept {
+    assert(new_capacity >= 0);
+
+    // drop all cached routes
+    capacity = new_capacity;
+    entries.clear();
+    entries.shrink_to_fit();
+}
+
+int RouteCache::get_capacity() const noexcept {
+    assert(capacity >= 0);
+
+    return capacity;
+}
+
+bool RouteCache::enabled() const noexcept {
+    return capacity > 0;
+}
+
+const Route* RouteCache::find(const DeviceId src, const DeviceId dest, const int npus_count) const noexcept {
+    if (entries.empty()) {
+        // nothing cached yet
+        return nullptr;
+    }
+
+    const auto key = key_of(src, dest, npus_count);
+    const auto& entry = entries[key % static_cast<int64_t>(entries.size())];
+
+    return (entry.key == key) ? &entry.route : nullptr;
+}
+
+void RouteCache::insert(const DeviceId src, const DeviceId dest, const int npus_count, const Route& route) noexcept {
+    assert(enabled());
+
+    if (entries.empty()) {
+        // allocate slots: all pairs if they fit, otherwise the capacity
+        const auto pairs_count = static_cast<int64_t>(npus_count) * npus_count;
+        const auto slots_count = std::min(pairs_count, static_cast<int64_t>(capacity));
+        entries.resize(slots_count, Entry{empty_key, Route()});
+    }
+
+    const auto key = key_of(src, dest, npus_count);
+    auto& entry = entries[key % static_cast<int64_t>(entries.size())];
+    entry.key = key;
+    entry.route = route;
+}
+
+uint64_t RouteCache::get_allocated_bytes() const noexcept {
+    auto allocated_bytes = static_cast<uint64_t>(entries.capacity() * sizeof(Entry));
+    for (const auto& entry : entries) {
+        allocated_bytes += entry.route.get_heap_bytes();
+    }
+    return allocated_bytes;
+}
+
+int64_t RouteCache::key_of(const DeviceId src, const DeviceId dest, const int npus_count) noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    return static_cast<int64_t>(src) * npus_count + dest;
+}
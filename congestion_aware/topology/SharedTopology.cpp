@@ -0,0 +1,84 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SharedTopology.h"
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+SharedTopology::SharedTopology(std::shared_ptr<const Topology> topology) noexcept : topology(std::move(topology)) {
+    assert(this->topology != nullptr);
+
+    // every route the topology may select is built now, so lookups don't write it afterwards
+    this->topology->build_route_tables();
+}
+
+const Topology& SharedTopology::get_topology() const noexcept {
+    return *topology;
+}
+
+const Route* SharedTopology::select_route(const DeviceId src,
+                                          const DeviceId dest,
+                                          const uint64_t chunk_id) const noexcept {
+    return topology->select_route(src, dest, chunk_id);
+}
+
+Route SharedTopology::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    return topology->compute_route(src, dest);
+}
+
+DeviceId SharedTopology::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    return topology->next_hop(current, dest);
+}
+
+LinkId SharedTopology::find_link(const DeviceId src, const DeviceId dest) const noexcept {
+    return topology->find_link(src, dest);
+}
+
+TopologyInstance::TopologyInstance(std::shared_ptr<const SharedTopology> shared_topology) noexcept
+    : Topology(),
+      shared_topology(std::move(shared_topology)) {
+    assert(this->shared_topology != nullptr);
+
+    // same devices and dimensions
+    const auto& topology = this->shared_topology->get_topology();
+    devices_count = topology.get_devices_count();
+    npus_count = topology.get_npus_count();
+    dims_count = topology.get_dims_count();
+    npus_count_per_dim = topology.get_npus_count_per_dim();
+    bandwidth_per_dim = topology.get_bandwidth_per_dim();
+
+    // same links (in LinkId order), with state of their own
+    links.copy_layout(topology.links);
+}
+
+const Route* TopologyInstance::select_route(const DeviceId src,
+                                            const DeviceId dest,
+                                            const uint64_t chunk_id) const noexcept {
+    return shared_topology->select_route(src, dest, chunk_id);
+}
+
+bool TopologyInstance::has_fixed_routes() const noexcept {
+    // links fail on the instance, routes are spread by the shared topology
+    return shared_topology->get_topology().has_fixed_routes() && Topology::has_fixed_routes();
+}
+
+Route TopologyInstance::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    return shared_topology->compute_route(src, dest);
+}
+
+DeviceId TopologyInstance::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    return shared_topology->next_hop(current, dest);
+}
+
+int TopologyInstance::get_link_dim(const LinkId link_id) const noexcept {
+    // links are never added to the shared topology
+    return shared_topology->get_topology().get_link_dim(link_id);
+}
+
+LinkId TopologyInstance::find_link(const DeviceId src, const DeviceId dest) const noexcept {
+    return shared_topology->find_link(src, dest);
+}
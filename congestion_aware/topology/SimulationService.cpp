@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SimulationService.h"
+#include "common/NetworkParser.h"
+#include "congestion_aware/Helper.h"
+#include <fstream>
+#include <vector>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * A chunk of a request, recording its delivery time.
+ */
+struct RequestChunk {
+    /// event queue driving the simulation
+    const EventQueue* event_queue;
+
+    /// delivery time of the chunk
+    EventTime* delivery_time;
+};
+
+/**
+ * Callback of the chunks of a request: record the delivery time.
+ *
+ * @param request_chunk_ptr pointer to the RequestChunk
+ */
+void record_delivery(void* const request_chunk_ptr) noexcept {
+    const auto* const request_chunk = static_cast<const RequestChunk*>(request_chunk_ptr);
+    *request_chunk->delivery_time = request_chunk->event_queue->get_current_time();
+}
+
+}  // namespace
+
+std::string SimulationService::answer(const std::string& request) noexcept {
+    auto query = ChunkQuery();
+    if (!ChunkQuery::decode(request, query)) {
+        return std::string();
+    }
+
+    const auto simulation = get_simulation(query.config_path);
+    if (simulation == nullptr) {
+        return std::string();
+    }
+
+    const auto npus_count = simulation->topology->get_npus_count();
+    const auto chunks_count = static_cast<int>(query.srcs.size());
+    for (auto i = 0; i < chunks_count; i++) {
+        if (query.srcs[i] < 0 || query.srcs[i] >= npus_count || query.dests[i] < 0 || query.dests[i] >= npus_count) {
+            return std::string();
+        }
+    }
+
+    const auto lock = std::lock_guard<std::mutex>(simulation->mutex);
+
+    // every request starts from idle links at time 0, so its answer doesn't depend on the previous ones
+    simulation->topology->reset();
+    simulation->event_queue->reset();
+
+    auto delivery_times = std::vector<EventTime>(chunks_count);
+    auto request_chunks = std::vector<RequestChunk>(chunks_count);
+    auto descriptors = std::vector<ChunkDescriptor>(chunks_count);
+    for (auto i = 0; i < chunks_count; i++) {
+        request_chunks[i] = RequestChunk{simulation->event_queue.get(), &delivery_times[i]};
+        descriptors[i] = ChunkDescriptor{query.srcs[i], query.dests[i], query.chunk_sizes[i], record_delivery,
+                                         &request_chunks[i]};
+    }
+    simulation->topology->send_batch(descriptors.data(), chunks_count);
+    simulation->event_queue->run_to_completion();
+
+    return ChunkQuery::encode_answer(delivery_times);
+}
+
+int SimulationService::get_topologies_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(simulations_mutex);
+    return static_cast<int>(simulations.size());
+}
+
+std::shared_ptr<SimulationService::Simulation> SimulationService::get_simulation(
+    const std::string& config_path) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(simulations_mutex);
+
+    const auto cached_simulation = simulations.find(config_path);
+    if (cached_simulation != simulations.end()) {
+        return cached_simulation->second;
+    }
+
+    // a bad path fails the request rather than the parser terminating the server
+    if (!std::ifstream(config_path)) {
+        return nullptr;
+    }
+
+    const auto network_parser = NetworkParser(config_path);
+    auto simulation = std::make_shared<Simulation>();
+    simulation->event_queue = std::make_shared<EventQueue>();
+    simulation->topology = construct_topology(network_parser, simulation->event_queue);
+    simulations.emplace(config_path, simulation);
+    return simulation;
+}
@@ -0,0 +1,162 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SnapshotTopology.h"
+#include "common/BinaryBuffer.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+/*
+ * Snapshot layout (native byte order, no padding):
+ *   header: magic (8 B), version (u32), byte order mark (u32)
+ *   devices_count, npus_count, dims_count (i32 each)
+ *   per dimension: npus_count (i32), bandwidth (f64)
+ *   links_count (i32), then per link: src (i32), dest (i32), bandwidth (f64), latency (f64)
+ *   next-hop table: npus_count * devices_count device ids (i32), indexed by dest * devices_count + device
+ */
+
+namespace {
+
+/// written after the version, to reject files of another byte order
+constexpr uint32_t byte_order_mark = 0x01020304;
+
+}  // namespace
+
+bool SnapshotTopology::save(const Topology& topology, const std::string& path) noexcept {
+    const auto devices_count = topology.get_devices_count();
+    const auto npus_count = topology.get_npus_count();
+    auto buffer = std::string();
+
+    // header
+    buffer.append(snapshot_magic, sizeof(snapshot_magic));
+    append_binary(buffer, snapshot_version);
+    append_binary(buffer, byte_order_mark);
+
+    // devices and dimensions
+    append_binary(buffer, static_cast<int32_t>(devices_count));
+    append_binary(buffer, static_cast<int32_t>(npus_count));
+    append_binary(buffer, static_cast<int32_t>(topology.get_dims_count()));
+    const auto npus_count_per_dim = topology.get_npus_count_per_dim();
+    const auto bandwidth_per_dim = topology.get_bandwidth_per_dim();
+    for (auto dim = 0; dim < topology.get_dims_count(); dim++) {
+        append_binary(buffer, static_cast<int32_t>(npus_count_per_dim[dim]));
+        append_binary(buffer, static_cast<double>(bandwidth_per_dim[dim]));
+    }
+
+    // links, in LinkId order
+    append_binary(buffer, static_cast<int32_t>(topology.get_links_count()));
+    for (auto link_id = 0; link_id < topology.get_links_count(); link_id++) {
+        const auto& link = topology.get_link(link_id);
+        append_binary(buffer, static_cast<int32_t>(link.get_src()));
+        append_binary(buffer, static_cast<int32_t>(link.get_dest()));
+        append_binary(buffer, static_cast<double>(link.get_bandwidth()));
+        append_binary(buffer, static_cast<double>(link.get_latency()));
+    }
+
+    // next-hop table: routing is consistent, so a device reached by an earlier route already knows its next hop
+    auto next_hops = std::vector<int32_t>(static_cast<size_t>(npus_count) * devices_count, -1);
+    for (auto dest = 0; dest < npus_count; dest++) {
+        auto* const dest_next_hops = &next_hops[static_cast<size_t>(dest) * devices_count];
+        for (auto src = 0; src < npus_count; src++) {
+            if (src == dest || dest_next_hops[src] != -1) {
+                continue;
+            }
+            const auto route = topology.route(src, dest);
+            for (auto hop = 0; hop + 1 < route.size() && dest_next_hops[route[hop]] == -1; hop++) {
+                dest_next_hops[route[hop]] = route[hop + 1];
+            }
+        }
+    }
+    append_binary(buffer, next_hops.data(), next_hops.size());
+
+    return write_binary_file(path, buffer);
+}
+
+SnapshotTopology::SnapshotTopology(const std::string& path) noexcept : Topology() {
+    const auto fail = [&path]() {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid topology snapshot " << path
+                  << std::endl;
+        std::exit(-1);
+    };
+
+    auto buffer = std::string();
+    if (!read_binary_file(path, buffer) || buffer.size() < sizeof(snapshot_magic) ||
+        std::memcmp(buffer.data(), snapshot_magic, sizeof(snapshot_magic)) != 0) {
+        fail();
+    }
+
+    // header
+    auto reader = BinaryReader(buffer, sizeof(snapshot_magic));
+    if (reader.read<uint32_t>() != snapshot_version || reader.read<uint32_t>() != byte_order_mark) {
+        fail();
+    }
+
+    // devices and dimensions
+    devices_count = reader.read<int32_t>();
+    npus_count = reader.read<int32_t>();
+    dims_count = reader.read<int32_t>();
+    if (npus_count <= 0 || devices_count < npus_count || dims_count <= 0 || !reader.has(dims_count * 12)) {
+        fail();
+    }
+    for (auto dim = 0; dim < dims_count; dim++) {
+        npus_count_per_dim.push_back(reader.read<int32_t>());
+        bandwidth_per_dim.push_back(reader.read<double>());
+    }
+
+    // links, keeping their ids
+    const auto links_count = reader.read<int32_t>();
+    if (links_count < 0 || !reader.has(static_cast<uint64_t>(links_count) * 24)) {
+        fail();
+    }
+    links.reserve(links_count);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        const auto src = reader.read<int32_t>();
+        const auto dest = reader.read<int32_t>();
+        const auto bandwidth = reader.read<double>();
+        const auto latency = reader.read<double>();
+        if (src < 0 || src >= devices_count || dest < 0 || dest >= devices_count || bandwidth <= 0 || latency < 0) {
+            fail();
+        }
+        connect(src, dest, bandwidth, latency, false);
+    }
+
+    // next-hop table, read at once
+    next_hops.resize(static_cast<size_t>(npus_count) * devices_count);
+    if (!reader.read(next_hops.data(), next_hops.size()) || !reader.done()) {
+        fail();
+    }
+}
+
+Route SnapshotTopology::compute_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // follow the next hops
+    auto route = Route({src});
+    for (auto current = src; current != dest;) {
+        current = next_hop(current, dest);
+        route.push_back(current);
+    }
+    return route;
+}
+
+DeviceId SnapshotTopology::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    const auto next = next_hops[static_cast<size_t>(dest) * devices_count + current];
+    assert(next != -1);
+    return next;
+}
+
+uint64_t SnapshotTopology::get_route_tables_bytes() const noexcept {
+    return Topology::get_route_tables_bytes() + next_hops.capacity() * sizeof(DeviceId);
+}
@@ -0,0 +1,27 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/StaticRouting.h"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+std::optional<StaticTopology> NetworkAnalyticalCongestionAware::resolve_static_topology(
+    const Topology& topology) noexcept {
+    // concrete types are final, so each check is a single type comparison
+    if (const auto* const ring = dynamic_cast<const Ring*>(&topology)) {
+        return ring;
+    }
+    if (const auto* const switch_topology = dynamic_cast<const Switch*>(&topology)) {
+        return switch_topology;
+    }
+    if (const auto* const fully_connected = dynamic_cast<const FullyConnected*>(&topology)) {
+        return fully_connected;
+    }
+    if (const auto* const mesh_2d = dynamic_cast<const Mesh2D*>(&topology)) {
+        return mesh_2d;
+    }
+    return std::nullopt;
+}
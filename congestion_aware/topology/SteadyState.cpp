@@ -0,0 +1,122 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SteadyState.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Mix a value into a 64-bit FNV-1a hash.
+ *
+ * @param hash hash to update
+ * @param value value to mix in
+ */
+void mix(uint64_t& hash, const uint64_t value) noexcept {
+    for (auto byte = 0; byte < 8; byte++) {
+        hash ^= (value >> (8 * byte)) & 0xff;
+        hash *= 1'099'511'628'211ull;
+    }
+}
+
+}  // namespace
+
+SteadyState::SteadyState(std::shared_ptr<Topology> topology, const int matching_iterations_count) noexcept
+    : topology(std::move(topology)),
+      matching_iterations_count(matching_iterations_count),
+      iteration_start_time(0),
+      iteration_time(0),
+      iterations_count(0),
+      signature(0),
+      matching_count(0) {
+    assert(this->topology != nullptr);
+
+    if (matching_iterations_count < 2) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "steady state needs at least 2 matching iterations, got " << matching_iterations_count
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // baselines of the first iteration
+    const auto scheduler = this->topology->get_scheduler();
+    iteration_start_time = (scheduler != nullptr) ? scheduler->get_current_time() : 0;
+    static_cast<void>(sign_iteration(iteration_start_time));
+}
+
+bool SteadyState::end_iteration(const EventTime time) noexcept {
+    assert(time >= iteration_start_time);
+
+    const auto iteration_signature = sign_iteration(time);
+    matching_count = (iterations_count > 0 && iteration_signature == signature) ? matching_count + 1 : 1;
+    signature = iteration_signature;
+    iteration_time = time - iteration_start_time;
+    iteration_start_time = time;
+    iterations_count++;
+
+    return converged();
+}
+
+bool SteadyState::converged() const noexcept {
+    return matching_count >= matching_iterations_count;
+}
+
+EventTime SteadyState::get_iteration_time() const noexcept {
+    return iteration_time;
+}
+
+EventTime SteadyState::extrapolate(const int64_t remaining_iterations_count) const noexcept {
+    assert(converged());
+    assert(remaining_iterations_count >= 0);
+
+    return iteration_start_time + static_cast<EventTime>(remaining_iterations_count) * iteration_time;
+}
+
+int64_t SteadyState::get_iterations_count() const noexcept {
+    return iterations_count;
+}
+
+uint64_t SteadyState::get_signature() const noexcept {
+    return signature;
+}
+
+uint64_t SteadyState::sign_iteration(const EventTime time) noexcept {
+    auto hash = static_cast<uint64_t>(14'695'981'039'346'656'037ull);
+    mix(hash, time - iteration_start_time);
+
+    // chunks delivered during the iteration
+    const auto& current_chunk_stats = topology->get_chunk_stats();
+    mix(hash, current_chunk_stats.chunks_delivered - chunk_stats.chunks_delivered);
+    mix(hash, current_chunk_stats.hops_count - chunk_stats.hops_count);
+    mix(hash, current_chunk_stats.queueing_delay - chunk_stats.queueing_delay);
+    chunk_stats = current_chunk_stats;
+
+    // what every link did during the iteration, and what it still holds at its end (in LinkId order)
+    auto link_ids = topology->rank_links();
+    std::sort(link_ids.begin(), link_ids.end());
+    link_stats.resize(topology->get_links_count());
+    for (const auto link_id : link_ids) {
+        const auto& link = topology->get_link(link_id);
+        const auto& current_link_stats = link.get_stats();
+        auto& previous_link_stats = link_stats[link_id];
+        mix(hash, static_cast<uint64_t>(link_id));
+        mix(hash, current_link_stats.chunks_transmitted - previous_link_stats.chunks_transmitted);
+        mix(hash, current_link_stats.bytes_transmitted - previous_link_stats.bytes_transmitted);
+        mix(hash, current_link_stats.busy_time - previous_link_stats.busy_time);
+        mix(hash, current_link_stats.queueing_delay - previous_link_stats.queueing_delay);
+        mix(hash, current_link_stats.backpressure_time - previous_link_stats.backpressure_time);
+        mix(hash, static_cast<uint64_t>(link.get_queued_chunks_count()));
+        previous_link_stats = current_link_stats;
+    }
+
+    return hash;
+}
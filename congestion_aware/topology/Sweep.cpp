@@ -0,0 +1,231 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/Sweep.h"
+#include "common/WorkStealingExecutor.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_aware/SweepTable.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iterator>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+std::vector<NetworkParser> Sweep::parameter_grid(const std::string& topology_name,
+                                                 const std::vector<int>& npus_counts,
+                                                 const std::vector<Bandwidth>& bandwidths,
+                                                 const std::vector<Latency>& latencies) noexcept {
+    assert(!topology_name.empty());
+
+    auto network_parsers = std::vector<NetworkParser>();
+
+    for (const auto npus_count : npus_counts) {
+        for (const auto bandwidth : bandwidths) {
+            for (const auto latency : latencies) {
+                // same layout as a 1-dim YAML network config
+                auto network_config = YAML::Node();
+                network_config["topology"].push_back(topology_name);
+                network_config["npus_count"].push_back(npus_count);
+                network_config["bandwidth"].push_back(bandwidth);
+                network_config["latency"].push_back(latency);
+
+                network_parsers.emplace_back(network_config);
+            }
+        }
+    }
+
+    return network_parsers;
+}
+
+std::vector<EventTime> Sweep::run_shared(const std::shared_ptr<const SharedTopology>& shared_topology,
+                                         const std::vector<Workload>& workloads,
+                                         const int threads_count,
+                                         const EventQueueType event_queue_type) noexcept {
+    assert(shared_topology != nullptr);
+    assert(threads_count >= 0);
+
+    // each simulation writes its own entry, so no synchronization is required
+    auto finish_times = std::vector<EventTime>(workloads.size());
+
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(static_cast<int>(workloads.size()), [&](const int workload_id) {
+        assert(workloads[workload_id] != nullptr);
+
+        // independent simulation: own event queue and link state, shared graph and routes
+        const auto event_queue = std::make_shared<EventQueue>(event_queue_type);
+        auto topology = TopologyInstance(shared_topology);
+        topology.attach_event_queue(event_queue);
+        topology.set_background_teardown(true);
+
+        // inject the workload and run the simulation
+        workloads[workload_id](topology);
+        event_queue->run_to_completion();
+        finish_times[workload_id] = event_queue->get_current_time();
+    });
+
+    return finish_times;
+}
+
+Sweep::Sweep(std::vector<NetworkParser> network_parsers, const EventQueueType event_queue_type) noexcept
+    : network_parsers(std::make_move_iterator(network_parsers.begin()), std::make_move_iterator(network_parsers.end())),
+      config_errors(network_parsers.size()),
+      event_queue_type(event_queue_type),
+      result_cache(nullptr),
+      telemetry(nullptr),
+      result_table(nullptr),
+      thread_pinning(false) {}
+
+Sweep::Sweep(const std::vector<NetworkConfig>& network_configs, const EventQueueType event_queue_type) noexcept
+    : config_errors(network_configs.size()),
+      event_queue_type(event_queue_type),
+      result_cache(nullptr),
+      telemetry(nullptr),
+      result_table(nullptr),
+      thread_pinning(false) {
+    for (auto point_id = 0; point_id < static_cast<int>(network_configs.size()); point_id++) {
+        network_parsers.push_back(NetworkParser::try_parse(network_configs[point_id], config_errors[point_id]));
+    }
+}
+
+Sweep::Sweep(const NetworkScenarios& network_scenarios, const EventQueueType event_queue_type) noexcept
+    : event_queue_type(event_queue_type),
+      result_cache(nullptr),
+      telemetry(nullptr),
+      result_table(nullptr),
+      thread_pinning(false) {
+    for (auto point_id = 0; point_id < network_scenarios.get_scenarios_count(); point_id++) {
+        network_parsers.push_back(network_scenarios.get_network_parser(point_id));
+        config_errors.push_back(network_scenarios.get_config_errors(point_id));
+    }
+}
+
+void Sweep::set_result_cache(std::shared_ptr<ResultCache> new_result_cache, std::string new_workload_key) noexcept {
+    assert(new_result_cache == nullptr || !new_workload_key.empty());
+
+    result_cache = std::move(new_result_cache);
+    workload_key = std::move(new_workload_key);
+}
+
+void Sweep::set_telemetry(std::shared_ptr<Telemetry> new_telemetry) noexcept {
+    telemetry = std::move(new_telemetry);
+}
+
+void Sweep::set_result_table(std::shared_ptr<SweepTable> new_result_table) noexcept {
+    result_table = std::move(new_result_table);
+}
+
+void Sweep::set_thread_pinning(const bool enabled) noexcept {
+    thread_pinning = enabled;
+}
+
+std::vector<SweepResult> Sweep::run(const Workload& workload, const int threads_count) const noexcept {
+    assert(workload != nullptr);
+    assert(threads_count >= 0);
+
+    // each point writes its own row, so no synchronization is required
+    auto results = std::vector<SweepResult>(network_parsers.size());
+
+    if (telemetry != nullptr) {
+        telemetry->start_sweep(get_points_count());
+    }
+
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.set_thread_pinning(thread_pinning);
+    executor.run(get_points_count(), [this, &workload, &results](const int point_id) {
+        results[point_id] = run_point(point_id, workload);
+        if (result_table != nullptr) {
+            result_table->append(results[point_id]);
+        }
+        if (telemetry != nullptr) {
+            telemetry->complete_sweep_point();
+        }
+    });
+
+    if (result_table != nullptr) {
+        result_table->flush();
+    }
+
+    return results;
+}
+
+int Sweep::get_points_count() const noexcept {
+    return static_cast<int>(network_parsers.size());
+}
+
+SweepResult Sweep::describe_point(const int point_id) const noexcept {
+    assert(0 <= point_id && point_id < get_points_count());
+
+    // an invalid point is described by its errors only
+    if (!network_parsers[point_id].has_value()) {
+        return SweepResult{point_id, TopologyBuildingBlock::Undefined, 0, 0, 0, 0, false, config_errors[point_id]};
+    }
+
+    const auto& network_parser = *network_parsers[point_id];
+    return SweepResult{point_id,
+                       network_parser.get_topologies_per_dim()[0],
+                       network_parser.get_npus_counts_per_dim()[0],
+                       network_parser.get_bandwidths_per_dim()[0],
+                       network_parser.get_latencies_per_dim()[0],
+                       0};
+}
+
+SweepResult Sweep::run_point(const int point_id, const Workload& workload) const noexcept {
+    assert(0 <= point_id && point_id < get_points_count());
+
+    auto result = describe_point(point_id);
+    if (!network_parsers[point_id].has_value()) {
+        // invalid point: nothing to simulate
+        return result;
+    }
+    const auto& network_parser = *network_parsers[point_id];
+
+    // a point simulated before is read from the result cache
+    const auto key = (result_cache != nullptr) ? ResultCache::make_key(network_parser, workload_key) : "";
+    auto cached_result = CachedResult();
+    if (result_cache != nullptr && result_cache->lookup(key, cached_result)) {
+        result.finish_time = cached_result.finish_time;
+        result.cached = true;
+        return result;
+    }
+
+    // independent simulation: own event queue and topology
+    const auto event_queue = std::make_shared<EventQueue>(event_queue_type);
+    // the worker moves on to the next point while the finished simulation is released in the background
+    const auto topology = try_construct_topology(network_parser, result.config_errors);
+    if (topology == nullptr) {
+        // invalid point, only found against the constructed links: nothing to simulate
+        return result;
+    }
+    topology->attach_event_queue(event_queue);
+    topology->set_background_teardown(true);
+
+    // inject the workload and run the simulation
+    const auto start_time = std::chrono::steady_clock::now();
+    workload(*topology);
+    event_queue->run_to_completion();
+    result.finish_time = event_queue->get_current_time();
+    result.wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    result.events_count = event_queue->get_invoked_events_count();
+    if constexpr (stats_enabled) {
+        for (auto link_id = 0; link_id < topology->get_links_count(); link_id++) {
+            const auto& link_stats = topology->get_link(link_id).get_stats();
+            result.bytes_transmitted += link_stats.bytes_transmitted;
+            result.max_link_busy_time = std::max(result.max_link_busy_time, link_stats.busy_time);
+        }
+    }
+
+    if (result_cache != nullptr) {
+        cached_result.finish_time = result.finish_time;
+        if constexpr (stats_enabled) {
+            cached_result.stats["chunks_delivered"] = topology->get_chunk_stats().chunks_delivered;
+            cached_result.stats["events_processed"] = event_queue->get_stats().events_processed;
+        }
+        result_cache->store(key, cached_result);
+    }
+
+    return result;
+}
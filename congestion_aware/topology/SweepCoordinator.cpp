@@ -0,0 +1,326 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "common/BinaryBuffer.h"
+#include "common/FrameSocket.h"
+#include "congestion_aware/Sweep.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+/*
+ * Distributed sweep protocol (frames, see FrameSocket.h; native byte order):
+ *   worker -> coordinator, once: fingerprint of the worker's sweep (u64)
+ *   coordinator -> worker, once: 1 if the fingerprint matches, 0 otherwise (u8)
+ *   worker -> coordinator: reported point (i32, -1: none), and its finish time (u64)
+ *   coordinator -> worker: next point (i32, -1: every point is done)
+ * A coordinator holds back the answer of a pull while no point is left to hand out but some are in flight,
+ * as a worker disconnecting hands its point back.
+ */
+
+namespace {
+
+/// answer of a pull once every point is done
+constexpr int32_t no_point = -1;
+
+/**
+ * A worker connection of a coordinator.
+ */
+struct WorkerConnection {
+    /// socket of the worker
+    int fd;
+
+    /// true once the worker's fingerprint was accepted
+    bool accepted = false;
+
+    /// point handed out to the worker, not reported yet (-1: none)
+    int32_t point_id = no_point;
+
+    /// true while the worker's pull waits for a point
+    bool waiting = false;
+};
+
+/**
+ * Encode a pull of the next point.
+ *
+ * @param point_id reported point (-1: none)
+ * @param finish_time finish time of the reported point
+ * @return frame of the pull
+ */
+std::string encode_pull(const int32_t point_id, const EventTime finish_time) noexcept {
+    auto frame = std::string();
+    append_binary(frame, point_id);
+    append_binary(frame, static_cast<uint64_t>(finish_time));
+    return frame;
+}
+
+/**
+ * Encode a point handed out.
+ *
+ * @param point_id point (-1: every point is done)
+ * @return frame of the point
+ */
+std::string encode_point(const int32_t point_id) noexcept {
+    auto frame = std::string();
+    append_binary(frame, point_id);
+    return frame;
+}
+
+}  // namespace
+
+int Sweep::run_worker(const std::string& host,
+                      const uint16_t port,
+                      const Workload& workload,
+                      int threads_count) const noexcept {
+    assert(workload != nullptr);
+    assert(threads_count >= 0);
+
+    // use every hardware thread by default
+    if (threads_count == 0) {
+        threads_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+    // every thread pulls points through a connection of its own
+    auto fds = std::vector<int>(threads_count);
+    for (auto& fd : fds) {
+        fd = connect_tcp(host, port);
+        if (fd == -1) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Cannot connect to sweep coordinator "
+                      << host << ":" << port << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    auto points_counts = std::vector<int>(threads_count, 0);
+    auto threads = std::vector<std::thread>();
+    for (auto thread_id = 0; thread_id < threads_count; thread_id++) {
+        threads.emplace_back([this, &fds, &points_counts, &workload, thread_id]() {
+            points_counts[thread_id] = run_worker_connection(fds[thread_id], workload);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto fd : fds) {
+        close(fd);
+    }
+
+    auto points_count = 0;
+    for (const auto thread_points_count : points_counts) {
+        points_count += thread_points_count;
+    }
+    return points_count;
+}
+
+int Sweep::run_worker_connection(const int fd, const Workload& workload) const noexcept {
+    // handshake: the coordinator should distribute this very sweep
+    auto hello = std::string();
+    append_binary(hello, get_fingerprint());
+    auto accepted = std::string();
+    if (!send_frame(fd, hello) || !receive_frame(fd, accepted) || accepted.size() != 1 || accepted[0] != 1) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "Sweep coordinator rejected the worker: sweep points differ" << std::endl;
+        std::exit(-1);
+    }
+
+    auto points_count = 0;
+    auto reported_point_id = no_point;
+    auto finish_time = EventTime(0);
+    while (true) {
+        // report the last point, and pull the next one
+        auto frame = std::string();
+        if (!send_frame(fd, encode_pull(reported_point_id, finish_time)) || !receive_frame(fd, frame)) {
+            // the coordinator is gone
+            return points_count;
+        }
+        auto reader = BinaryReader(frame, 0);
+        const auto point_id = reader.read<int32_t>();
+        if (!reader.done() || point_id == no_point) {
+            return points_count;
+        }
+        if (point_id < 0 || point_id >= get_points_count()) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << "Sweep coordinator handed out point "
+                      << point_id << " out of range" << std::endl;
+            std::exit(-1);
+        }
+
+        finish_time = run_point(point_id, workload).finish_time;
+        reported_point_id = point_id;
+        points_count++;
+    }
+}
+
+uint64_t Sweep::get_fingerprint() const noexcept {
+    auto buffer = std::string();
+    for (const auto& network_parser : network_parsers) {
+        // invalid points count as 0
+        append_binary(buffer, network_parser.has_value() ? network_parser->get_config_hash() : uint64_t(0));
+    }
+
+    // 64-bit FNV-1a
+    auto fingerprint = static_cast<uint64_t>(0xCBF29CE484222325ULL);
+    for (const auto byte : buffer) {
+        fingerprint ^= static_cast<uint8_t>(byte);
+        fingerprint *= 0x100000001B3ULL;
+    }
+    return fingerprint;
+}
+
+SweepCoordinator::SweepCoordinator(const Sweep& sweep, const uint16_t port) noexcept : sweep(sweep), port(0) {
+    listen_fd = listen_tcp(port, this->port);
+    if (listen_fd == -1) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "Cannot listen on port " << port
+                  << std::endl;
+        std::exit(-1);
+    }
+}
+
+SweepCoordinator::~SweepCoordinator() noexcept {
+    close(listen_fd);
+}
+
+uint16_t SweepCoordinator::get_port() const noexcept {
+    return port;
+}
+
+std::vector<SweepResult> SweepCoordinator::run() noexcept {
+    const auto points_count = sweep.get_points_count();
+    auto results = std::vector<SweepResult>(points_count);
+    auto reported = std::vector<bool>(points_count, false);
+    auto remaining_count = points_count;
+
+    // invalid points and points already in the result cache aren't handed out
+    auto pending_point_ids = std::deque<int32_t>();
+    for (auto point_id = 0; point_id < points_count; point_id++) {
+        results[point_id] = sweep.describe_point(point_id);
+        const auto& network_parser = sweep.network_parsers[point_id];
+        auto cached_result = CachedResult();
+        if (!network_parser.has_value()) {
+            reported[point_id] = true;
+            remaining_count--;
+        } else if (sweep.result_cache != nullptr &&
+                   sweep.result_cache->lookup(ResultCache::make_key(*network_parser, sweep.workload_key),
+                                              cached_result)) {
+            results[point_id].finish_time = cached_result.finish_time;
+            results[point_id].cached = true;
+            reported[point_id] = true;
+            remaining_count--;
+        } else {
+            pending_point_ids.push_back(point_id);
+        }
+    }
+
+    const auto expected_fingerprint = sweep.get_fingerprint();
+    auto workers = std::vector<WorkerConnection>();
+    const auto disconnect = [&pending_point_ids](WorkerConnection& worker) {
+        // hand the point of the worker to another one
+        if (worker.point_id != no_point) {
+            pending_point_ids.push_front(worker.point_id);
+        }
+        close(worker.fd);
+        worker.fd = -1;
+    };
+
+    while (remaining_count > 0) {
+        // wait for new workers and pulls
+        auto poll_fds = std::vector<pollfd>{{listen_fd, POLLIN, 0}};
+        for (const auto& worker : workers) {
+            poll_fds.push_back({worker.fd, POLLIN, 0});
+        }
+        if (poll(poll_fds.data(), poll_fds.size(), -1) < 0) {
+            continue;
+        }
+
+        for (auto i = size_t(1); i < poll_fds.size(); i++) {
+            if (poll_fds[i].revents == 0) {
+                continue;
+            }
+            auto& worker = workers[i - 1];
+            auto frame = std::string();
+            if (!receive_frame(worker.fd, frame)) {
+                disconnect(worker);
+                continue;
+            }
+            auto reader = BinaryReader(frame, 0);
+
+            // handshake
+            if (!worker.accepted) {
+                worker.accepted = (reader.read<uint64_t>() == expected_fingerprint) && reader.done();
+                const auto accepted = std::string(1, worker.accepted ? 1 : 0);
+                if (!send_frame(worker.fd, accepted) || !worker.accepted) {
+                    disconnect(worker);
+                }
+                continue;
+            }
+
+            // record the reported point (once, even if it was handed out twice)
+            const auto point_id = reader.read<int32_t>();
+            const auto finish_time = reader.read<uint64_t>();
+            if (!reader.done() || point_id != worker.point_id) {
+                disconnect(worker);
+                continue;
+            }
+            if (point_id != no_point && !reported[point_id]) {
+                results[point_id].finish_time = finish_time;
+                reported[point_id] = true;
+                remaining_count--;
+                if (sweep.result_cache != nullptr) {
+                    auto cached_result = CachedResult();
+                    cached_result.finish_time = finish_time;
+                    sweep.result_cache->store(
+                        ResultCache::make_key(*sweep.network_parsers[point_id], sweep.workload_key), cached_result);
+                }
+            }
+            worker.point_id = no_point;
+            worker.waiting = true;
+        }
+
+        // new workers
+        if (poll_fds[0].revents != 0) {
+            const auto fd = accept(listen_fd, nullptr, nullptr);
+            if (fd != -1) {
+                workers.push_back(WorkerConnection{fd});
+            }
+        }
+
+        // hand out the pending points to the waiting workers
+        for (auto& worker : workers) {
+            while (worker.fd != -1 && worker.waiting && !pending_point_ids.empty()) {
+                const auto point_id = pending_point_ids.front();
+                pending_point_ids.pop_front();
+                if (reported[point_id]) {
+                    continue;
+                }
+                worker.point_id = point_id;
+                worker.waiting = false;
+                if (!send_frame(worker.fd, encode_point(point_id))) {
+                    disconnect(worker);
+                }
+            }
+        }
+        workers.erase(std::remove_if(workers.begin(), workers.end(),
+                                     [](const WorkerConnection& worker) { return worker.fd == -1; }),
+                      workers.end());
+    }
+
+    // every point is done: release the workers
+    for (auto& worker : workers) {
+        if (worker.waiting) {
+            send_frame(worker.fd, encode_point(no_point));
+        }
+        close(worker.fd);
+    }
+
+    return results;
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_aware/SweepTable.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/**
+ * Write a column to a binary stream.
+ *
+ * @param output stream to write to
+ * @param column column to write
+ */
+template <typename T>
+void write_column(std::ostream& output, const std::vector<T>& column) noexcept {
+    output.write(reinterpret_cast<const char*>(column.data()), static_cast<std::streamsize>(column.size() * sizeof(T)));
+}
+
+/**
+ * Append a column of the given number of rows read from a binary stream.
+ *
+ * @param input stream to read from
+ * @param column column to append to
+ * @param count number of rows to read
+ */
+template <typename T>
+void read_column(std::istream& input, std::vector<T>& column, const size_t count) noexcept {
+    const auto offset = column.size();
+    column.resize(offset + count);
+    input.read(reinterpret_cast<char*>(column.data() + offset), static_cast<std::streamsize>(count * sizeof(T)));
+}
+
+}  // namespace
+
+size_t SweepColumns::size() const noexcept {
+    return point_ids.size();
+}
+
+void SweepColumns::clear() noexcept {
+    point_ids.clear();
+    topology_types.clear();
+    npus_counts.clear();
+    bandwidths.clear();
+    latencies.clear();
+    finish_times.clear();
+    events_counts.clear();
+    bytes_transmitted.clear();
+    max_link_busy_times.clear();
+    wall_times.clear();
+    cached.clear();
+    config_errors_counts.clear();
+}
+
+void SweepColumns::reserve(const size_t capacity) noexcept {
+    point_ids.reserve(capacity);
+    topology_types.reserve(capacity);
+    npus_counts.reserve(capacity);
+    bandwidths.reserve(capacity);
+    latencies.reserve(capacity);
+    finish_times.reserve(capacity);
+    events_counts.reserve(capacity);
+    bytes_transmitted.reserve(capacity);
+    max_link_busy_times.reserve(capacity);
+    wall_times.reserve(capacity);
+    cached.reserve(capacity);
+    config_errors_counts.reserve(capacity);
+}
+
+SweepColumns SweepTable::read_table(const std::string& table_path) noexcept {
+    auto table_file = std::istringstream(CompressedOutput::read_file(table_path));
+    auto magic = uint64_t(0);
+    table_file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    if (!table_file || magic != table_magic) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << table_path << " is not a sweep table"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    auto columns = SweepColumns();
+    auto count = uint64_t(0);
+    while (table_file.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+        read_column(table_file, columns.point_ids, count);
+        read_column(table_file, columns.topology_types, count);
+        read_column(table_file, columns.npus_counts, count);
+        read_column(table_file, columns.bandwidths, count);
+        read_column(table_file, columns.latencies, count);
+        read_column(table_file, columns.finish_times, count);
+        read_column(table_file, columns.events_counts, count);
+        read_column(table_file, columns.bytes_transmitted, count);
+        read_column(table_file, columns.max_link_busy_times, count);
+        read_column(table_file, columns.wall_times, count);
+        read_column(table_file, columns.cached, count);
+        read_column(table_file, columns.config_errors_counts, count);
+        if (!table_file) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) " << table_path << " is truncated"
+                      << std::endl;
+            std::exit(-1);
+        }
+    }
+
+    return columns;
+}
+
+SweepTable::SweepTable(const std::string& table_path, const size_t block_size, const Compression compression) noexcept
+    : table_file(table_path, compression),
+      block_size(block_size),
+      rows_count(0) {
+    assert(block_size > 0);
+
+    table_file.write(reinterpret_cast<const char*>(&table_magic), sizeof(table_magic));
+    block.reserve(block_size);
+}
+
+SweepTable::~SweepTable() noexcept {
+    close();
+}
+
+void SweepTable::append(const SweepResult& result) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(table_mutex);
+    assert(table_file.is_open());
+
+    block.point_ids.push_back(result.point_id);
+    block.topology_types.push_back(static_cast<int32_t>(result.topology_type));
+    block.npus_counts.push_back(result.npus_count);
+    block.bandwidths.push_back(result.bandwidth);
+    block.latencies.push_back(result.latency);
+    block.finish_times.push_back(result.finish_time);
+    block.events_counts.push_back(result.events_count);
+    block.bytes_transmitted.push_back(result.bytes_transmitted);
+    block.max_link_busy_times.push_back(result.max_link_busy_time);
+    block.wall_times.push_back(result.wall_time);
+    block.cached.push_back(result.cached ? 1 : 0);
+    block.config_errors_counts.push_back(static_cast<int32_t>(result.config_errors.size()));
+    rows_count++;
+
+    if (block.size() == block_size) {
+        write_block();
+    }
+}
+
+void SweepTable::flush() noexcept {
+    const auto lock = std::lock_guard<std::mutex>(table_mutex);
+
+    if (block.size() > 0) {
+        write_block();
+    }
+}
+
+void SweepTable::close() noexcept {
+    const auto lock = std::lock_guard<std::mutex>(table_mutex);
+    if (!table_file.is_open()) {
+        return;
+    }
+
+    if (block.size() > 0) {
+        write_block();
+    }
+    table_file.close();
+}
+
+uint64_t SweepTable::get_rows_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(table_mutex);
+    return rows_count;
+}
+
+void SweepTable::write_block() noexcept {
+    const auto count = static_cast<uint64_t>(block.size());
+    table_file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    write_column(table_file, block.point_ids);
+    write_column(table_file, block.topology_types);
+    write_column(table_file, block.npus_counts);
+    write_column(table_file, block.bandwidths);
+    write_column(table_file, block.latencies);
+    write_column(table_file, block.finish_times);
+    write_column(table_file, block.events_counts);
+    write_column(table_file, block.bytes_transmitted);
+    write_column(table_file, block.max_link_busy_times);
+    write_column(table_file, block.wall_times);
+    write_column(table_file, block.cached);
+    write_column(table_file, block.config_errors_counts);
+
+    // hand the block over to the file right away, so interrupted sweeps keep their finished points
+    table_file.flush();
+    block.clear();
+}
@@ -4,20 +4,243 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_aware/Topology.h"
+#include "congestion_aware/CriticalPath.h"
+#include "common/NetworkFunction.h"
+#include "common/Observers.h"
+#include "common/Profiler.h"
+#include "common/Reclaimer.h"
+#include "common/TimeBase.h"
+#include "common/WorkStealingExecutor.h"
 #include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTrace.h"
+#include "congestion_aware/UtilizationSampler.h"
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 using namespace NetworkAnalyticalCongestionAware;
 
+namespace {
+
+/**
+ * Flow network solved by Dinic's algorithm.
+ */
+class FlowNetwork {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param nodes_count number of nodes
+     */
+    explicit FlowNetwork(const int nodes_count) noexcept : first_edges(nodes_count, -1) {}
+
+    /**
+     * Add a directed edge (and its residual reverse edge).
+     *
+     * @param from tail of the edge
+     * @param to head of the edge
+     * @param capacity capacity of the edge
+     */
+    void add_edge(const int from, const int to, const double capacity) noexcept {
+        edges.push_back({to, capacity, first_edges[from]});
+        first_edges[from] = static_cast<int>(edges.size()) - 1;
+        edges.push_back({from, 0, first_edges[to]});
+        first_edges[to] = static_cast<int>(edges.size()) - 1;
+    }
+
+    /**
+     * Compute the maximum flow from source to sink.
+     *
+     * @param source source node
+     * @param sink sink node
+     * @return maximum flow
+     */
+    [[nodiscard]] double max_flow(const int source, const int sink) noexcept {
+        auto flow = 0.0;
+        while (build_levels(source, sink)) {
+            next_edges = first_edges;
+            for (auto pushed = push(source, sink, std::numeric_limits<double>::infinity()); pushed > 0;
+                 pushed = push(source, sink, std::numeric_limits<double>::infinity())) {
+                flow += pushed;
+            }
+        }
+        return flow;
+    }
+
+  private:
+    /// an edge of the residual graph (its reverse edge is at index ^ 1)
+    struct Edge {
+        /// head of the edge
+        int to;
+
+        /// residual capacity
+        double capacity;
+
+        /// next edge with the same tail (-1: none)
+        int next;
+    };
+
+    /// residual capacities below this are considered saturated
+    static constexpr double epsilon = 1e-9;
+
+    /// edges of the residual graph
+    std::vector<Edge> edges;
+
+    /// first edge leaving each node (-1: none)
+    std::vector<int> first_edges;
+
+    /// next edge to try leaving each node in the current phase
+    std::vector<int> next_edges;
+
+    /// BFS level of each node in the current phase (-1: unreached)
+    std::vector<int> levels;
+
+    /**
+     * Level the nodes by their distance from the source over unsaturated edges.
+     *
+     * @return true if the sink is reached, false otherwise
+     */
+    bool build_levels(const int source, const int sink) noexcept {
+        levels.assign(first_edges.size(), -1);
+        levels[source] = 0;
+        auto queue = std::vector<int>{source};
+        for (auto head = 0; head < static_cast<int>(queue.size()); head++) {
+            const auto node = queue[head];
+            for (auto edge = first_edges[node]; edge >= 0; edge = edges[edge].next) {
+                if (edges[edge].capacity > epsilon && levels[edges[edge].to] < 0) {
+                    levels[edges[edge].to] = levels[node] + 1;
+                    queue.push_back(edges[edge].to);
+                }
+            }
+        }
+        return levels[sink] >= 0;
+    }
+
+    /**
+     * Push flow from a node to the sink along increasing levels.
+     *
+     * @return flow pushed
+     */
+    double push(const int node, const int sink, const double limit) noexcept {
+        if (node == sink) {
+            return limit;
+        }
+        for (auto& edge = next_edges[node]; edge >= 0; edge = edges[edge].next) {
+            const auto to = edges[edge].to;
+            if (edges[edge].capacity <= epsilon || levels[to] != levels[node] + 1) {
+                continue;
+            }
+            const auto pushed = push(to, sink, std::min(limit, edges[edge].capacity));
+            if (pushed > 0) {
+                edges[edge].capacity -= pushed;
+                edges[edge ^ 1].capacity += pushed;
+                return pushed;
+            }
+        }
+        return 0;
+    }
+};
+
+/**
+ * Exit if an observer is attached while the observer hooks are compiled out.
+ *
+ * @param attached true if an observer is being attached
+ */
+void check_observers_enabled(const bool attached) noexcept {
+    if (attached && !observers_enabled) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "observers are compiled out (build with NETWORK_BACKEND_ENABLE_OBSERVERS=ON)" << std::endl;
+        std::exit(-1);
+    }
+}
+
+}  // namespace
+
+// declaring per-thread default event queue
+thread_local std::shared_ptr<EventQueue> Topology::default_event_queue;
+
 void Topology::set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept {
     assert(event_queue != nullptr);
 
-    // pass the given event_queue to Link
-    Link::set_event_queue(std::move(event_queue));
+    // set the default event queue of this thread
+    Topology::default_event_queue = std::move(event_queue);
+}
+
+void Topology::register_event_resources(EventQueue& event_queue) noexcept {
+    event_queue.register_event_resource(EventKind::LinkFree, link_free_resource);
+    event_queue.register_event_resource(EventKind::ChunkArrival, chunk_arrival_resource);
+}
+
+void Topology::register_event_order_keys(EventQueue& event_queue) noexcept {
+    event_queue.register_event_order_key(EventKind::LinkFree, link_free_order_key);
+    event_queue.register_event_order_key(EventKind::ChunkArrival, chunk_arrival_order_key);
 }
 
-Topology::Topology() noexcept : npus_count(-1), devices_count(-1), dims_count(-1) {
+Topology::Topology() noexcept
+    : scheduler(default_event_queue),
+      event_queue(default_event_queue),
+      npus_count(-1),
+      devices_count(-1),
+      dims_count(-1),
+      fast_forward(false),
+      background_teardown(false),
+      nic_model(nullptr),
+      ingress_bandwidth(0),
+      ingress_ticks_per_byte(0),
+      switch_model(nullptr),
+      routes_computed(0),
+      job_accounting(false),
+      batch_callback(nullptr),
+      batch_callback_arg(nullptr),
+      next_chunk_id(0),
+      hop_by_hop_routing(false) {
     npus_count_per_dim = {};
+
+    // links created from now on are driven by the default event queue, if set
+    if (scheduler != nullptr) {
+        links.set_scheduler(scheduler.get());
+    }
+}
+
+Topology::~Topology() noexcept {
+    set_telemetry(nullptr);
+
+    // the bulk of the storage is moved out, leaving empty members to destroy
+    if (background_teardown) {
+        Reclaimer::get().reclaim(std::make_tuple(std::move(links), std::move(shared_routes), std::move(chunk_pool)));
+    }
+}
+
+void Topology::attach_event_queue(std::shared_ptr<EventQueue> new_event_queue) noexcept {
+    assert(new_event_queue != nullptr);
+
+    attach_scheduler(std::move(new_event_queue));
+}
+
+std::shared_ptr<EventQueue> Topology::get_event_queue() const noexcept {
+    return event_queue;
+}
+
+void Topology::attach_scheduler(std::shared_ptr<NetworkScheduler> new_scheduler) noexcept {
+    assert(new_scheduler != nullptr);
+
+    // pass the scheduler to every link in the topology
+    scheduler = std::move(new_scheduler);
+    event_queue = std::dynamic_pointer_cast<EventQueue>(scheduler);
+    links.set_scheduler(scheduler.get());
+}
+
+std::shared_ptr<NetworkScheduler> Topology::get_scheduler() const noexcept {
+    return scheduler;
 }
 
 int Topology::get_devices_count() const noexcept {
@@ -28,6 +251,38 @@ int Topology::get_devices_count() const noexcept {
     return devices_count;
 }
 
+int Topology::get_links_count() const noexcept {
+    return static_cast<int>(links.size());
+}
+
+int Topology::get_materialized_links_count() const noexcept {
+    return static_cast<int>(links.materialized_size());
+}
+
+const Link& Topology::get_link(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < links.size());
+
+    return links[link_id];
+}
+
+LinkLoad Topology::get_link_load(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < links.size());
+
+    return links.materialized(link_id) ? links[link_id].get_load() : LinkLoad();
+}
+
+void Topology::snapshot_link_loads(const LinkId first_link_id,
+                                   const int links_count,
+                                   LinkLoad* const loads) const noexcept {
+    assert(0 <= first_link_id && links_count >= 0);
+    assert(first_link_id + links_count <= links.size());
+    assert(loads != nullptr || links_count == 0);
+
+    for (auto i = 0; i < links_count; i++) {
+        loads[i] = get_link_load(first_link_id + i);
+    }
+}
+
 int Topology::get_npus_count() const noexcept {
     assert(devices_count > 0);
     assert(npus_count > 0);
@@ -54,44 +309,2312 @@ std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
     return bandwidth_per_dim;
 }
 
-void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
-    assert(chunk != nullptr);
+std::vector<DeviceId> Topology::get_ring_order() const noexcept {
+    auto ring_order = std::vector<DeviceId>(npus_count);
+    std::iota(ring_order.begin(), ring_order.end(), 0);
+    return ring_order;
+}
 
-    // get src npu node_id
-    const auto src = chunk->current_device()->get_id();
+TopologyMetrics Topology::compute_metrics(const int threads_count) const noexcept {
+    assert(threads_count >= 0);
 
-    // assert src is valid
-    assert(0 <= src && src < devices_count);
+    auto metrics = TopologyMetrics();
+    const auto links_count = get_links_count();
+    metrics.links_count_per_dim.assign(dims_count, 0);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        metrics.links_count_per_dim[get_link_dim(link_id)]++;
+    }
+    if (npus_count < 2) {
+        return metrics;
+    }
+
+    // BFS from every NPU (the adjacency is built upfront, as it's shared by the workers)
+    if (adjacency_offsets.empty()) {
+        build_adjacency();
+    }
+    auto farthest_hops_count = std::vector<int>(npus_count, 0);
+    auto total_hops_count = std::vector<uint64_t>(npus_count, 0);
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(npus_count, [&](const DeviceId src) {
+        auto hops_count = std::vector<int>(devices_count, -1);
+        auto queue = std::vector<DeviceId>{src};
+        queue.reserve(devices_count);
+        hops_count[src] = 0;
+        for (auto head = 0; head < static_cast<int>(queue.size()); head++) {
+            const auto device = queue[head];
+            for (auto slot = adjacency_offsets[device]; slot < adjacency_offsets[device + 1]; slot++) {
+                const auto next = adjacency_dests[slot];
+                if (hops_count[next] < 0) {
+                    hops_count[next] = hops_count[device] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (hops_count[dest] < 0) {
+                std::cerr << "[Error] (network/analytical/congestion_aware) " << "NPU " << dest
+                          << " is unreachable from NPU " << src << std::endl;
+                std::exit(-1);
+            }
+            farthest_hops_count[src] = std::max(farthest_hops_count[src], hops_count[dest]);
+            total_hops_count[src] += hops_count[dest];
+        }
+    });
+    metrics.diameter = *std::max_element(farthest_hops_count.begin(), farthest_hops_count.end());
+    const auto pairs_count = static_cast<double>(npus_count) * (npus_count - 1);
+    metrics.average_hops_count =
+        static_cast<double>(std::accumulate(total_hops_count.begin(), total_hops_count.end(), uint64_t(0))) /
+        pairs_count;
 
-    // initiate transmission from src
-    devices[src]->send(std::move(chunk));
+    // max-flow from the first half of the NPUs to the other half, through any device
+    const auto source = devices_count;
+    const auto sink = devices_count + 1;
+    auto flow_network = FlowNetwork(devices_count + 2);
+    auto total_capacity = 0.0;
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        const auto [src, dest] = links.endpoints(link_id);
+        const auto capacity = get_link_capacity(link_id);
+        flow_network.add_edge(src, dest, capacity);
+        total_capacity += capacity;
+    }
+    for (auto npu = 0; npu < npus_count; npu++) {
+        if (npu < npus_count / 2) {
+            flow_network.add_edge(source, npu, total_capacity);
+        } else {
+            flow_network.add_edge(npu, sink, total_capacity);
+        }
+    }
+    metrics.bisection_bandwidth = flow_network.max_flow(source, sink);
+
+    return metrics;
 }
 
-void Topology::connect(const DeviceId src,
-                       const DeviceId dest,
-                       const Bandwidth bandwidth,
-                       const Latency latency,
-                       const bool bidirectional) noexcept {
-    // assert the src and dest are valid
+Route Topology::route(const DeviceId src, const DeviceId dest) const noexcept {
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::Route);
+
+    if (!route_cache.enabled()) {
+        auto route = compute_route(src, dest);
+        NETWORK_ANALYTICAL_STATS(routes_computed.fetch_add(1, std::memory_order_relaxed));
+        resolve_links(route);
+        return route;
+    }
+
+    // serve from the cache if available
+    if (const auto* const cached_route = route_cache.find(src, dest, npus_count); cached_route != nullptr) {
+        return *cached_route;
+    }
+
+    // compute and cache the route, links included
+    auto route = compute_route(src, dest);
+    NETWORK_ANALYTICAL_STATS(routes_computed.fetch_add(1, std::memory_order_relaxed));
+    resolve_links(route);
+    route_cache.insert(src, dest, npus_count, route);
+    return route;
+}
+
+RouteBatch Topology::route_batch(const std::vector<std::pair<DeviceId, DeviceId>>& pairs,
+                                 const int threads_count) const noexcept {
+    assert(threads_count >= 0);
+
+    // the adjacency is built upfront, as routing may look links up concurrently
+    if (adjacency_offsets.empty()) {
+        build_adjacency();
+    }
+
+    // each task routes a run of pairs into a buffer of its own, counting the devices of each route
+    constexpr auto pairs_per_task = 256;
+    const auto pairs_count = pairs.size();
+    const auto tasks_count = static_cast<int>((pairs_count + pairs_per_task - 1) / pairs_per_task);
+    auto batch = RouteBatch();
+    batch.offsets.assign(pairs_count + 1, 0);
+    auto task_devices = std::vector<std::vector<DeviceId>>(tasks_count);
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(tasks_count, [&](const int task_id) {
+        const auto first_pair = static_cast<size_t>(task_id) * pairs_per_task;
+        const auto last_pair = std::min(first_pair + pairs_per_task, pairs_count);
+        for (auto pair = first_pair; pair < last_pair; pair++) {
+            const auto [src, dest] = pairs[pair];
+            assert(0 <= src && src < npus_count);
+            assert(0 <= dest && dest < npus_count);
+
+            const auto route = compute_route(src, dest);
+            NETWORK_ANALYTICAL_STATS(routes_computed.fetch_add(1, std::memory_order_relaxed));
+            task_devices[task_id].insert(task_devices[task_id].end(), route.begin(), route.end());
+            batch.offsets[pair + 1] = route.size();
+        }
+    });
+
+    // the offsets are the running sum of the route sizes, then each task copies its run into place
+    for (auto pair = static_cast<size_t>(0); pair < pairs_count; pair++) {
+        batch.offsets[pair + 1] += batch.offsets[pair];
+    }
+    batch.devices.resize(batch.offsets[pairs_count]);
+    executor.run(tasks_count, [&](const int task_id) {
+        const auto first_device = batch.offsets[static_cast<size_t>(task_id) * pairs_per_task];
+        std::copy(task_devices[task_id].begin(), task_devices[task_id].end(), batch.devices.begin() + first_device);
+        task_devices[task_id] = std::vector<DeviceId>();
+    });
+
+    return batch;
+}
+
+int Topology::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    return route(src, dest).size() - 1;
+}
+
+EventTime Topology::get_zero_load_latency(const DeviceId src,
+                                          const DeviceId dest,
+                                          const ChunkSize chunk_size) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(chunk_size > 0);
+
+    // routes carry the link of each hop
+    const auto hops_route = route(src, dest);
+    auto zero_load_latency = EventTime(0);
+    for (auto hop = 0; hop < hops_route.size() - 1; hop++) {
+        zero_load_latency += links[hops_route.link_id(hop)].communication_delay(chunk_size);
+    }
+    return zero_load_latency;
+}
+
+const Route* Topology::shared_route(const DeviceId src, const DeviceId dest) const noexcept {
+    // routes are computed once, and never move afterwards
+    auto& shared_route = route_table_entry(shared_routes, src, dest);
+    if (shared_route.empty()) {
+        NETWORK_ANALYTICAL_PROFILE(ProfileZone::Route);
+        shared_route = compute_route(src, dest);
+        NETWORK_ANALYTICAL_STATS(routes_computed.fetch_add(1, std::memory_order_relaxed));
+        resolve_links(shared_route);
+    }
+    return &shared_route;
+}
+
+const Route* Topology::select_route(const DeviceId src, const DeviceId dest, const uint64_t chunk_id) const noexcept {
+    // a single route per pair
+    (void)chunk_id;
+    return shared_route(src, dest);
+}
+
+bool Topology::has_fixed_routes() const noexcept {
+    return !hop_by_hop_routing && failed_links.empty() && scheduled_link_changes.empty();
+}
+
+void Topology::build_route_tables() const noexcept {
+    if (adjacency_offsets.empty()) {
+        build_adjacency();
+    }
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                static_cast<void>(shared_route(src, dest));
+            }
+        }
+    }
+}
+
+const MulticastTree& Topology::multicast_tree(const DeviceId src, const std::vector<DeviceId>& dests) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(!dests.empty());
+
+    // the same dests in any order share a tree
+    auto sorted_dests = dests;
+    std::sort(sorted_dests.begin(), sorted_dests.end());
+    sorted_dests.erase(std::unique(sorted_dests.begin(), sorted_dests.end()), sorted_dests.end());
+    auto key = std::vector<DeviceId>({src});
+    key.insert(key.end(), sorted_dests.begin(), sorted_dests.end());
+
+    // trees are computed once, and never move afterwards
+    auto& tree = multicast_trees[std::move(key)];
+    if (tree == nullptr) {
+        tree = compute_multicast_tree(src, sorted_dests);
+        assert(tree != nullptr && tree->get_src() == src);
+    }
+    return *tree;
+}
+
+std::unique_ptr<MulticastTree> Topology::compute_multicast_tree(const DeviceId src,
+                                                                const std::vector<DeviceId>& dests) const noexcept {
+    // merge the routes to every dest
+    auto tree = std::make_unique<MulticastTree>(src);
+    for (const auto dest : dests) {
+        assert(0 <= dest && dest < npus_count);
+        assert(dest != src);
+
+        tree->add_route(*shared_route(src, dest));
+    }
+    return tree;
+}
+
+Route& Topology::route_table_entry(RouteTable& route_table, const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+
+    // a row of routes is allocated on the first route from its src
+    if (route_table.empty()) {
+        route_table.resize(npus_count);
+    }
+    auto& src_routes = route_table[src];
+    if (src_routes == nullptr) {
+        src_routes = std::make_unique<Route[]>(npus_count);
+    }
+    return src_routes[dest];
+}
+
+void Topology::set_route_cache_capacity(const int capacity) noexcept {
+    assert(capacity >= 0);
+
+    route_cache.set_capacity(capacity);
+}
+
+void Topology::set_link_model(const LinkModel link_model) noexcept {
+    links.set_link_model(link_model);
+}
+
+void Topology::set_fast_forward(const bool enabled) noexcept {
+    fast_forward = enabled;
+
+    // reservations are made in virtual time (or in the links' calendars)
+    if (fast_forward && links.get_link_model() == LinkModel::Event) {
+        set_link_model(LinkModel::VirtualTime);
+    }
+}
+
+void Topology::set_link_trace(std::shared_ptr<LinkTrace> new_link_trace) noexcept {
+    check_observers_enabled(new_link_trace != nullptr);
+
+    link_trace = std::move(new_link_trace);
+
+    // every link gets its own track
+    links.materialize_all();
+    for (auto& link : links) {
+        if (link_trace != nullptr) {
+            link_trace->name_link(link.get_src(), link.get_dest());
+        }
+        link.set_link_trace(link_trace.get());
+    }
+}
+
+void Topology::set_critical_path(std::shared_ptr<CriticalPath> new_critical_path) noexcept {
+    check_observers_enabled(new_critical_path != nullptr);
+
+    critical_path = std::move(new_critical_path);
+
+    // every link records into the tracker
+    links.materialize_all();
+    for (auto& link : links) {
+        link.set_critical_path(critical_path.get());
+    }
+}
+
+void Topology::set_utilization_sampler(std::shared_ptr<UtilizationSampler> new_utilization_sampler) noexcept {
+    check_observers_enabled(new_utilization_sampler != nullptr);
+
+    utilization_sampler = std::move(new_utilization_sampler);
+
+    // every link gets its own row
+    links.materialize_all();
+    for (auto& link : links) {
+        if (utilization_sampler == nullptr) {
+            link.set_utilization_sampler(nullptr, -1);
+            continue;
+        }
+        const auto row = utilization_sampler->add_link(link.get_src(), link.get_dest(), link.get_bandwidth());
+        link.set_utilization_sampler(utilization_sampler.get(), row);
+    }
+}
+
+void Topology::set_completion_log(std::shared_ptr<CompletionLog> new_completion_log) noexcept {
+    check_observers_enabled(new_completion_log != nullptr);
+
+    completion_log = std::move(new_completion_log);
+}
+
+void Topology::set_latency_histograms(std::shared_ptr<LatencyHistograms> new_latency_histograms) noexcept {
+    check_observers_enabled(new_latency_histograms != nullptr);
+
+    latency_histograms = std::move(new_latency_histograms);
+}
+
+void Topology::set_telemetry(std::shared_ptr<Telemetry> new_telemetry) noexcept {
+    if (telemetry != nullptr) {
+        telemetry->remove_gauge("network_analytical_live_chunks");
+    }
+
+    telemetry = std::move(new_telemetry);
+    if (telemetry != nullptr) {
+        telemetry->set_gauge("network_analytical_live_chunks", "Chunks in flight.", [this] {
+            return static_cast<double>(chunk_pool.get_allocated_chunks_count() - chunk_pool.get_free_chunks_count());
+        });
+    }
+}
+
+void Topology::set_background_teardown(const bool enabled) noexcept {
+    background_teardown = enabled;
+}
+
+void Topology::set_batched_completion(const BatchCallback new_batch_callback,
+                                      const CallbackArg new_batch_callback_arg) noexcept {
+    batch_callback = new_batch_callback;
+    batch_callback_arg = new_batch_callback_arg;
+}
+
+void Topology::set_packet_size(const ChunkSize packet_size) noexcept {
+    links.set_packet_size(packet_size);
+}
+
+void Topology::set_switching_mode(const SwitchingMode switching_mode) noexcept {
+    links.set_switching_mode(switching_mode);
+}
+
+void Topology::set_link_protocol(const ChunkSize mtu,
+                                 const ChunkSize header_size,
+                                 const Latency packet_gap) noexcept {
+    if (packet_gap < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "packet gap should be non-negative, got "
+                  << packet_gap << std::endl;
+        std::exit(-1);
+    }
+
+    links.set_protocol(LinkProtocol{mtu, header_size, packet_gap});
+}
+
+void Topology::set_chunk_coalescing(const bool enabled) noexcept {
+    links.set_chunk_coalescing(enabled);
+}
+
+void Topology::set_source_arbitration(const bool enabled) noexcept {
+    links.set_source_arbitration(enabled);
+}
+
+void Topology::set_link_buffer_capacity(const ChunkSize buffer_capacity) noexcept {
+    links.set_buffer_capacity(buffer_capacity);
+}
+
+void Topology::set_nic_model(const Bandwidth injection_bandwidth,
+                             const int max_outstanding_chunks,
+                             const int dma_engines_count) noexcept {
+    if (injection_bandwidth < 0 || max_outstanding_chunks < 0 || dma_engines_count <= 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid NIC model: injection bandwidth "
+                  << injection_bandwidth << ", max outstanding chunks " << max_outstanding_chunks
+                  << ", DMA engines " << dma_engines_count << std::endl;
+        std::exit(-1);
+    }
+
+    // unlimited NICs don't meter anything
+    if (injection_bandwidth == 0 && max_outstanding_chunks == 0) {
+        nic_model = nullptr;
+        return;
+    }
+    nic_model = std::make_unique<NicModel>(npus_count, injection_bandwidth, max_outstanding_chunks, dma_engines_count);
+}
+
+const NicModel* Topology::get_nic_model() const noexcept {
+    return nic_model.get();
+}
+
+void Topology::set_ingress_bandwidth(const Bandwidth new_ingress_bandwidth) noexcept {
+    if (new_ingress_bandwidth < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid ingress bandwidth "
+                  << new_ingress_bandwidth << std::endl;
+        std::exit(-1);
+    }
+
+    // unlimited ingresses don't meter anything
+    ingress_bandwidth = new_ingress_bandwidth;
+    if (ingress_bandwidth == 0) {
+        ingress_ticks_per_byte = 0;
+        ingress_free_times = std::vector<EventTime>();
+        return;
+    }
+    ingress_ticks_per_byte = static_cast<double>(ticks_per_ns) / bw_GBps_to_Bpns(ingress_bandwidth);
+    ingress_free_times.assign(npus_count, 0);
+}
+
+Bandwidth Topology::get_ingress_bandwidth() const noexcept {
+    return ingress_bandwidth;
+}
+
+void Topology::set_switch_model(const Bandwidth crossbar_bandwidth,
+                                const Latency traversal_latency,
+                                const ChunkSize port_buffer_capacity) noexcept {
+    if (crossbar_bandwidth < 0 || traversal_latency < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "invalid switch model: crossbar bandwidth "
+                  << crossbar_bandwidth << ", traversal latency " << traversal_latency << std::endl;
+        std::exit(-1);
+    }
+    if (npus_count == devices_count) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) "
+                  << "no switch to model: the topology only has NPUs" << std::endl;
+        std::exit(-1);
+    }
+
+    // every link checks the buffer of the output port it forwards into
+    if (port_buffer_capacity > 0) {
+        links.materialize_all();
+        for (auto& link : links) {
+            const auto buffer_capacity =
+                (link.get_src() >= npus_count) ? port_buffer_capacity : link.get_buffer_capacity();
+            link.set_buffer_capacity(buffer_capacity, &links);
+        }
+    }
+
+    // unlimited crossbars crossed at once don't delay anything
+    if (crossbar_bandwidth == 0 && traversal_latency == 0) {
+        switch_model = nullptr;
+        return;
+    }
+    switch_model = std::make_unique<SwitchModel>(npus_count, devices_count, crossbar_bandwidth, traversal_latency);
+}
+
+const SwitchModel* Topology::get_switch_model() const noexcept {
+    return switch_model.get();
+}
+
+void Topology::set_link_failed(const DeviceId src, const DeviceId dest, const bool failed) noexcept {
+    const auto link_id = find_link(src, dest);
+    if (link_id < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link " << src << " -> " << dest
+                  << " to fail or restore" << std::endl;
+        std::exit(-1);
+    }
+
+    set_links_failed({link_id}, failed);
+}
+
+void Topology::set_device_failed(const DeviceId device, const bool failed) noexcept {
+    assert(0 <= device && device < devices_count);
+
+    auto link_ids = std::vector<LinkId>();
+    for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+        const auto [link_src, link_dest] = links.endpoints(link_id);
+        if (link_src == device || link_dest == device) {
+            link_ids.push_back(link_id);
+        }
+    }
+
+    set_links_failed(link_ids, failed);
+}
+
+void Topology::schedule_link_failure(const EventTime time,
+                                     const DeviceId src,
+                                     const DeviceId dest,
+                                     const bool failed) noexcept {
     assert(0 <= src && src < devices_count);
     assert(0 <= dest && dest < devices_count);
 
-    // assert bandwidth and latency are valid
-    assert(bandwidth > 0);
-    assert(latency >= 0);
+    // topologies created before the default event queue was set pick it up now
+    if (scheduler == nullptr) {
+        assert(default_event_queue != nullptr);
+        attach_event_queue(default_event_queue);
+    }
+    assert(time >= scheduler->get_current_time());
 
-    // connect src -> dest
-    devices[src]->connect(dest, bandwidth, latency);
+    scheduled_link_changes.push_back({time, src, dest, failed});
+    scheduler->schedule_event(time, apply_scheduled_link_changes, static_cast<void*>(this));
+}
 
-    // if bidirectional, connect dest -> src
-    if (bidirectional) {
-        devices[dest]->connect(src, bandwidth, latency);
+void Topology::schedule_device_failure(const EventTime time, const DeviceId device, const bool failed) noexcept {
+    assert(0 <= device && device < devices_count);
+
+    if (scheduler == nullptr) {
+        assert(default_event_queue != nullptr);
+        attach_event_queue(default_event_queue);
+    }
+    assert(time >= scheduler->get_current_time());
+
+    scheduled_link_changes.push_back({time, device, -1, failed});
+    scheduler->schedule_event(time, apply_scheduled_link_changes, static_cast<void*>(this));
+}
+
+bool Topology::is_link_failed(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < static_cast<LinkId>(links.size()));
+
+    return failed_links.count(link_id) > 0;
+}
+
+int Topology::get_failed_links_count() const noexcept {
+    return static_cast<int>(failed_links.size());
+}
+
+void Topology::apply_scheduled_link_changes(void* const topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    auto* const topology = static_cast<Topology*>(topology_ptr);
+    const auto current_time = topology->scheduler->get_current_time();
+
+    // apply the changes due by now in the order scheduled (a change may already be applied by an earlier event)
+    auto due_changes = std::vector<LinkStateChange>();
+    auto& scheduled_changes = topology->scheduled_link_changes;
+    const auto due_end = std::stable_partition(scheduled_changes.begin(), scheduled_changes.end(),
+                                               [current_time](const LinkStateChange& change) {
+                                                   return change.time <= current_time;
+                                               });
+    due_changes.assign(scheduled_changes.begin(), due_end);
+    scheduled_changes.erase(scheduled_changes.begin(), due_end);
+
+    for (const auto& change : due_changes) {
+        if (change.dest < 0) {
+            topology->set_device_failed(change.src, change.failed);
+        } else {
+            topology->set_link_failed(change.src, change.dest, change.failed);
+        }
+    }
+}
+
+void Topology::set_links_failed(const std::vector<LinkId>& link_ids, const bool failed) noexcept {
+    // only the links whose state changes
+    auto changed_link_ids = std::vector<LinkId>();
+    for (const auto link_id : link_ids) {
+        const auto changed = failed ? failed_links.insert(link_id).second : (failed_links.erase(link_id) > 0);
+        if (changed) {
+            changed_link_ids.push_back(link_id);
+        }
+    }
+    if (changed_link_ids.empty()) {
+        return;
+    }
+
+    repair_routes(changed_link_ids, failed);
+
+    // stranded chunks may get through the restored links
+    if (!failed) {
+        resume_stranded_chunks();
+        return;
+    }
+
+    // the chunks waiting for a failing link take another way from its src
+    if (scheduler != nullptr) {
+        for (const auto link_id : changed_link_ids) {
+            if (!links.materialized(link_id)) {
+                continue;
+            }
+            for (auto& chunk : links[link_id].take_waiting_chunks()) {
+                forward(std::move(chunk));
+            }
+        }
+    }
+}
+
+void Topology::repair_routes(const std::vector<LinkId>& changed_link_ids, const bool failed) noexcept {
+    // back to the topology's own routes once every link is restored
+    if (failed_links.empty()) {
+        detour_next_hops.clear();
+        return;
+    }
+
+    // recompute the detour tables the changed links affect
+    for (auto& [dest, next_hops] : detour_next_hops) {
+        for (const auto link_id : changed_link_ids) {
+            if (next_hops_affected(next_hops.data(), dest, link_id, failed)) {
+                compute_live_next_hops(dest, next_hops.data());
+                break;
+            }
+        }
+    }
+}
+
+DeviceId Topology::live_next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(0 <= current && current < devices_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(current != dest);
+
+    // detour tables are computed on the first chunk rerouted toward each destination
+    auto& next_hops = detour_next_hops[dest];
+    if (next_hops.empty()) {
+        next_hops.resize(devices_count);
+        compute_live_next_hops(dest, next_hops.data());
     }
+    return next_hops[current];
 }
 
-void Topology::instantiate_devices() noexcept {
-    // instantiate all devices
+void Topology::build_incoming_links() const noexcept {
+    if (!incoming_offsets.empty()) {
+        return;
+    }
+
+    // incoming links of each device, by ascending src
+    const auto links_count = static_cast<int>(links.size());
+    incoming_offsets.assign(devices_count + 1, 0);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        incoming_offsets[links.endpoints(link_id).second + 1]++;
+    }
+    for (auto i = 0; i < devices_count; i++) {
+        incoming_offsets[i + 1] += incoming_offsets[i];
+    }
+    incoming_link_ids.resize(links_count);
+    auto next_slot = std::vector<int>(incoming_offsets.begin(), incoming_offsets.end() - 1);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        incoming_link_ids[next_slot[links.endpoints(link_id).second]++] = link_id;
+    }
     for (auto i = 0; i < devices_count; i++) {
-        devices.push_back(std::make_shared<Device>(i));
+        const auto range_begin = incoming_link_ids.begin() + incoming_offsets[i];
+        const auto range_end = incoming_link_ids.begin() + incoming_offsets[i + 1];
+        std::sort(range_begin, range_end, [this](const LinkId a, const LinkId b) {
+            return links.endpoints(a).first < links.endpoints(b).first;
+        });
+    }
+}
+
+void Topology::compute_live_next_hops(const DeviceId dest, DeviceId* const next_hops) const noexcept {
+    assert(0 <= dest && dest < devices_count);
+    assert(next_hops != nullptr);
+
+    build_incoming_links();
+
+    // breadth-first search from dest: every device reached moves to the device it was reached from
+    std::fill(next_hops, next_hops + devices_count, -1);
+    auto frontier = std::vector<DeviceId>({dest});
+    next_hops[dest] = dest;
+    for (auto index = static_cast<size_t>(0); index < frontier.size(); index++) {
+        const auto current = frontier[index];
+        for (auto i = incoming_offsets[current]; i < incoming_offsets[current + 1]; i++) {
+            const auto link_id = incoming_link_ids[i];
+            const auto previous = links.endpoints(link_id).first;
+            if (next_hops[previous] == -1 && failed_links.count(link_id) == 0) {
+                next_hops[previous] = current;
+                frontier.push_back(previous);
+            }
+        }
+    }
+    next_hops[dest] = -1;
+}
+
+bool Topology::next_hops_affected(const DeviceId* const next_hops,
+                                  const DeviceId dest,
+                                  const LinkId link_id,
+                                  const bool failed) const noexcept {
+    const auto [link_src, link_dest] = links.endpoints(link_id);
+    if (link_src == dest) {
+        return false;
+    }
+
+    // a failed link matters if the table takes it
+    if (failed) {
+        return next_hops[link_src] == link_dest;
+    }
+
+    // a restored link matters if its dest reaches dest in no more hops than its src, minus one
+    const auto hops_to_dest = [next_hops, dest](DeviceId device) {
+        auto hops = 0;
+        for (; device != dest; device = next_hops[device]) {
+            if (device == -1) {
+                return -1;
+            }
+            hops++;
+        }
+        return hops;
+    };
+    const auto link_dest_hops = hops_to_dest(link_dest);
+    if (link_dest_hops < 0) {
+        return false;
+    }
+    const auto link_src_hops = hops_to_dest(link_src);
+    return link_src_hops < 0 || link_dest_hops + 1 <= link_src_hops;
+}
+
+void Topology::set_queueing_policy(const QueueingPolicy queueing_policy,
+                                   const std::vector<int>& class_weights) noexcept {
+    if (class_weights.size() > Link::max_traffic_classes) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "at most " << Link::max_traffic_classes
+                  << " traffic classes are supported, got " << class_weights.size() << " weights" << std::endl;
+        std::exit(-1);
+    }
+
+    // unweighted classes take one chunk per turn
+    auto weights = std::array<int, Link::max_traffic_classes>();
+    weights.fill(1);
+    for (auto traffic_class = 0; traffic_class < class_weights.size(); traffic_class++) {
+        if (class_weights[traffic_class] <= 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "traffic class weights should be positive" << std::endl;
+            std::exit(-1);
+        }
+        weights[traffic_class] = class_weights[traffic_class];
+    }
+
+    links.set_queueing_policy(queueing_policy, weights);
+}
+
+void Topology::send(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+    NETWORK_ANALYTICAL_PROFILE(ProfileZone::Send);
+
+    // get src npu node_id
+    const auto src = chunk->current_device();
+
+    // assert src is valid
+    assert(0 <= src && src < devices_count);
+
+    // topologies created before the default event queue was set pick it up now
+    if (scheduler == nullptr) {
+        assert(default_event_queue != nullptr);
+        attach_event_queue(default_event_queue);
+    }
+
+    // the chunk resolves its next hops through this topology
+    chunk->topology = this;
+
+    // hop-by-hop chunks are routed from their current device on (around the failed links, if any)
+    if (chunk->hop_by_hop && chunk->route_index > 0) {
+        if (failed_links.empty()) {
+            chunk->route = &one_hop_route(src, next_hop(src, chunk->dest));
+            chunk->route_index = 0;
+        } else if (!reroute(*chunk)) {
+            strand(std::move(chunk), true);
+            return;
+        }
+    }
+
+    // hand-built routes get their link ids on their first hop
+    if (!chunk->route->links_resolved()) {
+        assert(chunk->owned_route != nullptr);
+        resolve_links(*chunk->owned_route);
+    }
+
+    // assert the chunk hasn't arrived its final destination yet
+    assert(!chunk->arrived_dest());
+
+    // hand-built chunks get their id once injected (chunks leaving their NIC already have one)
+    if (chunk->hops_count == 0 && chunk->owned_route != nullptr && !chunk->nic_metered) {
+        chunk->chunk_id = next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // stamp newly injected chunks for the completion log, the latency histograms, and the job accounting
+    if (stamps_inject_time() && chunk->hops_count == 0 && !chunk->nic_metered) {
+        chunk->inject_time = links[chunk->route->link_id(0)].get_current_time();
+    }
+
+    // newly injected chunks go through the NIC of their src NPU first
+    if (nic_model != nullptr && chunk->hops_count == 0 && !chunk->nic_metered && chunk->multicast_tree == nullptr) {
+        chunk->nic_metered = true;
+        nic_model->inject(std::move(chunk), *scheduler);
+        return;
+    }
+
+    // chunks arriving at a switch cross its crossbar first
+    if (switch_model != nullptr && src >= npus_count && chunk->multicast_tree == nullptr) {
+        switch_model->traverse(std::move(chunk), *scheduler);
+        return;
+    }
+
+    forward(std::move(chunk));
+}
+
+void Topology::forward(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+
+    // chunks heading to a failed link are rerouted from here,
+    // each of the chunks coalesced into them on its own
+    if (!failed_links.empty() && chunk->multicast_tree == nullptr && crosses_failed_link(*chunk)) {
+        // the buffer reserved on the next link of the old route is given back
+        links[chunk->route->link_id(chunk->route_index)].release_buffer(*chunk);
+
+        auto coalesced_chunk = std::move(chunk->coalesced_chunks);
+        const auto route_index = chunk->route_index;
+        const auto hops_count = chunk->hops_count;
+        const auto tail_arrival_time = chunk->tail_arrival_time;
+        chunk->transmission_size = chunk->chunk_size;
+        if (reroute(*chunk)) {
+            forward(std::move(chunk));
+        } else {
+            strand(std::move(chunk), false);
+        }
+        while (coalesced_chunk != nullptr) {
+            auto next_chunk = std::move(coalesced_chunk->coalesced_chunks);
+            coalesced_chunk->route_index = route_index;
+            coalesced_chunk->hops_count = hops_count;
+            coalesced_chunk->tail_arrival_time = tail_arrival_time;
+            forward(std::move(coalesced_chunk));
+            coalesced_chunk = std::move(next_chunk);
+        }
+        return;
+    }
+
+    // skip the remaining hops at once if they're all idle (and no crossbar is on the way)
+    if (fast_forward && switch_model == nullptr && try_fast_forward(chunk)) {
+        return;
+    }
+
+    // initiate transmission through the next link,
+    // behind the chunks fast forwarded onto it by now, and ahead of the later ones it then overlaps
+    const auto link_id = chunk->route->link_id(chunk->route_index);
+    assert(links[link_id].get_src() == chunk->current_device());
+    const auto claimed = !link_claims.empty();
+    if (claimed) {
+        settle_link_claims(link_id);
+    }
+    links[link_id].send(std::move(chunk));
+    if (claimed) {
+        revoke_overlapped_claims(link_id);
+    }
+}
+
+void Topology::send(const ChunkSize chunk_size,
+                    const DeviceId src,
+                    const DeviceId dest,
+                    const Callback callback,
+                    const CallbackArg callback_arg,
+                    const int traffic_class,
+                    const int job_id) noexcept {
+    auto chunk = acquire_chunk(chunk_size, src, dest, callback, callback_arg);
+    chunk->set_traffic_class(traffic_class);
+    chunk->set_job_id(job_id);
+    send(std::move(chunk));
+}
+
+void Topology::send_message(const ChunkSize chunk_size,
+                            const int chunks_count,
+                            const DeviceId src,
+                            const DeviceId dest,
+                            const Callback callback,
+                            const CallbackArg callback_arg,
+                            const int traffic_class,
+                            const int job_id) noexcept {
+    assert(chunks_count > 0);
+
+    // a single chunk stands for the whole message
+    auto message = acquire_chunk(chunk_size, src, dest, callback, callback_arg);
+    message->set_traffic_class(traffic_class);
+    message->set_job_id(job_id);
+    message->message_chunks_count = static_cast<uint32_t>(chunks_count);
+    message->transmission_size = chunk_size * chunks_count;
+    send(std::move(message));
+}
+
+void Topology::multicast(const ChunkSize chunk_size,
+                         const DeviceId src,
+                         const std::vector<DeviceId>& dests,
+                         const Callback callback,
+                         const CallbackArg callback_arg) noexcept {
+    assert(!dests.empty());
+
+    // take a chunk from the pool, which forks at the root onwards
+    const auto& tree = multicast_tree(src, dests);
+    const auto first_child = tree.get_children(MulticastTree::root).front();
+    auto chunk = chunk_pool.acquire(chunk_size, &tree.get_edge_route(first_child), callback, callback_arg);
+    chunk->chunk_id = next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+    chunk->multicast_tree = &tree;
+    fork_multicast(std::move(chunk), MulticastTree::root);
+}
+
+void Topology::arrive_multicast(std::unique_ptr<Chunk> chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(chunk->multicast_tree != nullptr);
+
+    const auto node = chunk->multicast_node;
+    if (chunk->multicast_tree->is_dest(node)) {
+        deliver_chunk(*chunk);
+    }
+    fork_multicast(std::move(chunk), node);
+}
+
+void Topology::fork_multicast(std::unique_ptr<Chunk> chunk, const int node) noexcept {
+    assert(chunk != nullptr);
+    assert(chunk->chunk_pool != nullptr);
+
+    const auto* const tree = chunk->multicast_tree;
+    const auto& children = tree->get_children(node);
+
+    // leaves are where the chunk ends
+    if (children.empty()) {
+        chunk->chunk_pool->release(std::move(chunk));
+        return;
+    }
+
+    // point the chunk to the edge it crosses next
+    const auto head_to = [tree](Chunk& edge_chunk, const int child) {
+        edge_chunk.route = &tree->get_edge_route(child);
+        edge_chunk.route_index = 0;
+        edge_chunk.src = tree->get_src();
+        edge_chunk.dest = tree->get_device(child);
+        edge_chunk.multicast_node = child;
+    };
+
+    // copies of the chunk cross every edge but the first, carrying what the chunk accumulated so far
+    for (auto i = 1; i < static_cast<int>(children.size()); i++) {
+        auto copy = chunk_pool.acquire(chunk->chunk_size, &tree->get_edge_route(children[i]), chunk->callback,
+                                       chunk->callback_arg);
+        copy->chunk_id = chunk->chunk_id;
+        copy->hops_count = chunk->hops_count;
+        copy->queueing_delay = chunk->queueing_delay;
+        copy->inject_time = chunk->inject_time;
+        copy->critical_path_step = chunk->critical_path_step;
+        copy->multicast_tree = tree;
+        copy->job_id = chunk->job_id;
+        copy->has_payload = chunk->has_payload;
+        std::memcpy(copy->payload_bytes, chunk->payload_bytes, Chunk::payload_capacity);
+        head_to(*copy, children[i]);
+        send(std::move(copy));
+    }
+
+    head_to(*chunk, children.front());
+    send(std::move(chunk));
+}
+
+void Topology::send_along(const Route* const route,
+                          const ChunkSize chunk_size,
+                          const Callback callback,
+                          const CallbackArg callback_arg,
+                          const int traffic_class,
+                          const int job_id) noexcept {
+    assert(route != nullptr);
+    assert(route->links_resolved());
+
+    auto chunk = chunk_pool.acquire(chunk_size, route, callback, callback_arg);
+    chunk->set_traffic_class(traffic_class);
+    chunk->set_job_id(job_id);
+    chunk->chunk_id = next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+    send(std::move(chunk));
+}
+
+std::unique_ptr<Chunk> Topology::acquire_chunk(const ChunkSize chunk_size,
+                                               const DeviceId src,
+                                               const DeviceId dest,
+                                               const Callback callback,
+                                               const CallbackArg callback_arg) noexcept {
+    // hop-by-hop chunks only carry their first hop
+    if (hop_by_hop_routing) {
+        assert(src != dest);
+        auto chunk = chunk_pool.acquire(chunk_size, &one_hop_route(src, next_hop(src, dest)), callback, callback_arg);
+        chunk->chunk_id = next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+        chunk->dest = dest;
+        chunk->hop_by_hop = true;
+        return chunk;
+    }
+
+    // take a chunk from the pool, on the route selected for it
+    const auto chunk_id = next_chunk_id.fetch_add(1, std::memory_order_relaxed);
+    auto chunk = chunk_pool.acquire(chunk_size, select_route(src, dest, chunk_id), callback, callback_arg);
+    chunk->chunk_id = chunk_id;
+    return chunk;
+}
+
+void Topology::send_batch(const ChunkDescriptor* const descriptors, const int count) noexcept {
+    assert(count >= 0);
+    assert(descriptors != nullptr || count == 0);
+
+    // hop-by-hop chunks carry one-hop routes, fast-forwarded chunks reserve links beyond their first one,
+    // and chunks may have to be rerouted around failed links: these are sent one by one
+    if (hop_by_hop_routing || fast_forward || !failed_links.empty()) {
+        for (auto i = 0; i < count; i++) {
+            const auto& descriptor = descriptors[i];
+            send(descriptor.chunk_size, descriptor.src, descriptor.dest, descriptor.callback, descriptor.callback_arg,
+                 descriptor.traffic_class, descriptor.job_id);
+        }
+        return;
+    }
+
+    // topologies created before the default event queue was set pick it up now
+    if (scheduler == nullptr) {
+        assert(default_event_queue != nullptr);
+        attach_event_queue(default_event_queue);
+    }
+
+    // take the chunks from the pool, on the routes selected for them
+    const auto first_chunk_id = next_chunk_id.fetch_add(count, std::memory_order_relaxed);
+    const auto current_time = scheduler->get_current_time();
+    auto chunks = std::vector<std::unique_ptr<Chunk>>(count);
+    auto first_link_ids = std::vector<LinkId>(count);
+    auto groupable = true;
+    for (auto i = 0; i < count; i++) {
+        const auto& descriptor = descriptors[i];
+        assert(0 <= descriptor.src && descriptor.src < devices_count);
+        assert(descriptor.src != descriptor.dest);
+
+        const auto chunk_id = first_chunk_id + i;
+        auto& chunk = chunks[i];
+        chunk = chunk_pool.acquire(descriptor.chunk_size, select_route(descriptor.src, descriptor.dest, chunk_id),
+                                   descriptor.callback, descriptor.callback_arg);
+        chunk->chunk_id = chunk_id;
+        chunk->topology = this;
+        chunk->set_traffic_class(descriptor.traffic_class);
+        chunk->set_job_id(descriptor.job_id);
+        assert(chunk->route->links_resolved());
+
+        // stamp newly injected chunks for the completion log, the latency histograms, and the job accounting
+        if (stamps_inject_time()) {
+            chunk->inject_time = current_time;
+        }
+
+        // VirtualTime links schedule an event per enqueued chunk, so regrouping would reorder same-time events
+        first_link_ids[i] = chunk->route->link_id(0);
+        groupable = groupable && links[first_link_ids[i]].get_link_model() == LinkModel::Event;
+    }
+
+    if (!groupable) {
+        for (auto& chunk : chunks) {
+            links[chunk->route->link_id(0)].send(std::move(chunk));
+        }
+        return;
+    }
+
+    // group the chunks by first link, in the order each link first appears:
+    // only the first chunk of a free link schedules an event, so the events are scheduled in the same order
+    auto group_of_link = std::unordered_map<LinkId, int>();
+    auto group_links = std::vector<LinkId>();
+    auto group_offsets = std::vector<int>();
+    auto chunk_groups = std::vector<int>(count);
+    for (auto i = 0; i < count; i++) {
+        const auto [group, inserted] = group_of_link.try_emplace(first_link_ids[i], group_links.size());
+        if (inserted) {
+            group_links.push_back(first_link_ids[i]);
+            group_offsets.push_back(0);
+        }
+        chunk_groups[i] = group->second;
+        group_offsets[group->second]++;
+    }
+
+    // counting sort of the chunks by group, stable within a group
+    auto offset = 0;
+    for (auto& group_offset : group_offsets) {
+        offset += std::exchange(group_offset, offset);
+    }
+    auto grouped_chunks = std::vector<std::unique_ptr<Chunk>>(count);
+    for (auto i = 0; i < count; i++) {
+        grouped_chunks[group_offsets[chunk_groups[i]]++] = std::move(chunks[i]);
+    }
+
+    // enqueue each group to its link at once (group_offsets now hold the ends of the groups)
+    auto group_begin = 0;
+    for (auto group = 0; group < static_cast<int>(group_links.size()); group++) {
+        const auto group_end = group_offsets[group];
+        links[group_links[group]].send_batch(grouped_chunks.data() + group_begin, group_end - group_begin);
+        group_begin = group_end;
+    }
+}
+
+DeviceId Topology::next_hop(const DeviceId current, const DeviceId dest) const noexcept {
+    assert(current != dest);
+
+    // the shared route from the current device starts with the next hop
+    return (*shared_route(current, dest))[1];
+}
+
+void Topology::set_hop_by_hop_routing(const bool enabled) noexcept {
+    hop_by_hop_routing = enabled;
+
+    // next hops are looked up while chunks are in flight, so the adjacency is built upfront
+    // (lazy links are found in closed form instead)
+    if (enabled && adjacency_offsets.empty() && !links.lazy()) {
+        build_adjacency();
+    }
+
+    // every link gets the one-hop route its chunks share
+    if (enabled && link_routes.empty()) {
+        link_routes.reserve(links.size());
+        for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+            const auto [link_src, link_dest] = links.endpoints(link_id);
+            auto link_route = Route({link_src, link_dest});
+            link_route.set_link_id(0, link_id);
+            link_route.mark_links_resolved();
+            link_routes.push_back(std::move(link_route));
+        }
+    }
+}
+
+const Route& Topology::one_hop_route(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(!link_routes.empty());
+
+    const auto link_id = find_link(src, dest);
+    assert(link_id >= 0);
+    return link_routes[link_id];
+}
+
+void Topology::reset() noexcept {
+    // only materialized links carry state
+    for (auto& link : links) {
+        link.reset();
+    }
+
+    chunk_stats = ChunkStats();
+    job_stats.clear();
+    next_chunk_id = 0;
+    delivered_chunk_ids.clear();
+    if (critical_path != nullptr) {
+        critical_path->clear();
+    }
+    if (nic_model != nullptr) {
+        nic_model->reset();
+    }
+    std::fill(ingress_free_times.begin(), ingress_free_times.end(), 0);
+    if (switch_model != nullptr) {
+        switch_model->reset();
+    }
+    scheduled_link_changes.clear();
+    stranded_chunks.clear();
+    link_claims.clear();
+}
+
+void Topology::set_dim_parameters(const int dim, const Bandwidth bandwidth, const Latency latency) noexcept {
+    assert(0 <= dim && dim < dims_count);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // lazy links share their parameters (only 1-dim topologies are lazy)
+    if (links.lazy()) {
+        assert(dims_count == 1);
+        links.set_lazy_parameters(bandwidth, latency);
+    } else {
+        for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+            if (get_link_dim(link_id) == dim) {
+                links[link_id].set_parameters(bandwidth, latency);
+            }
+        }
+    }
+
+    bandwidth_per_dim[dim] = bandwidth;
+}
+
+void Topology::set_link_parameters(const DeviceId src,
+                                   const DeviceId dest,
+                                   const Bandwidth bandwidth,
+                                   const Latency latency) noexcept {
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    const auto link_id = find_link(src, dest);
+    if (link_id < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link " << src << " -> " << dest
+                  << " to override" << std::endl;
+        std::exit(-1);
+    }
+
+    links.set_link_parameters(link_id, bandwidth, latency);
+}
+
+void Topology::set_link_group_parameters(const std::string& group,
+                                         const Bandwidth bandwidth,
+                                         const Latency latency) noexcept {
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // groups are computed from the endpoints, so lazy links stay unmaterialized
+    auto links_changed = false;
+    for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+        if (get_link_group(link_id) == group) {
+            links.set_link_parameters(link_id, bandwidth, latency);
+            links_changed = true;
+        }
+    }
+
+    if (!links_changed) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link in group " << group
+                  << " to override" << std::endl;
+        std::exit(-1);
+    }
+}
+
+void Topology::set_link_bandwidth_schedule(const DeviceId src,
+                                           const DeviceId dest,
+                                           const BandwidthSchedule& schedule) noexcept {
+    check_bandwidth_schedule(schedule);
+
+    const auto link_id = find_link(src, dest);
+    if (link_id < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link " << src << " -> " << dest
+                  << " to schedule" << std::endl;
+        std::exit(-1);
+    }
+
+    links.set_bandwidth_schedule(link_id, schedule);
+}
+
+void Topology::set_link_group_bandwidth_schedule(const std::string& group,
+                                                 const BandwidthSchedule& schedule) noexcept {
+    check_bandwidth_schedule(schedule);
+
+    // groups are computed from the endpoints, so lazy links stay unmaterialized
+    auto links_changed = false;
+    for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+        if (get_link_group(link_id) == group) {
+            links.set_bandwidth_schedule(link_id, schedule);
+            links_changed = true;
+        }
+    }
+
+    if (!links_changed) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link in group " << group
+                  << " to schedule" << std::endl;
+        std::exit(-1);
+    }
+}
+
+void Topology::set_link_background_schedule(const DeviceId src,
+                                            const DeviceId dest,
+                                            const BackgroundSchedule& schedule) noexcept {
+    check_background_schedule(schedule);
+
+    const auto link_id = find_link(src, dest);
+    if (link_id < 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link " << src << " -> " << dest
+                  << " to load with background traffic" << std::endl;
+        std::exit(-1);
+    }
+
+    links.set_background_schedule(link_id, schedule);
+}
+
+void Topology::set_link_group_background_schedule(const std::string& group,
+                                                  const BackgroundSchedule& schedule) noexcept {
+    check_background_schedule(schedule);
+
+    // groups are computed from the endpoints, so lazy links stay unmaterialized
+    auto links_changed = false;
+    for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+        if (get_link_group(link_id) == group) {
+            links.set_background_schedule(link_id, schedule);
+            links_changed = true;
+        }
+    }
+
+    if (!links_changed) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "no link in group " << group
+                  << " to load with background traffic" << std::endl;
+        std::exit(-1);
+    }
+}
+
+void Topology::set_link_bandwidth_share(const LinkId link_id, const double share) noexcept {
+    assert(0 <= link_id && link_id < links.size());
+
+    links[link_id].set_bandwidth_share(share);
+}
+
+void Topology::check_bandwidth_schedule(const BandwidthSchedule& schedule) noexcept {
+    for (auto step = static_cast<size_t>(0); step < schedule.size(); step++) {
+        if (schedule[step].bandwidth <= 0) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "bandwidth schedule steps require a positive bandwidth, got " << schedule[step].bandwidth
+                      << std::endl;
+            std::exit(-1);
+        }
+        if (step > 0 && schedule[step].time <= schedule[step - 1].time) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "bandwidth schedule steps should be in increasing time order" << std::endl;
+            std::exit(-1);
+        }
+    }
+}
+
+void Topology::check_background_schedule(const BackgroundSchedule& schedule) noexcept {
+    for (auto step = static_cast<size_t>(0); step < schedule.size(); step++) {
+        // the link keeps some bandwidth for its own chunks
+        if (schedule[step].utilization < 0 || schedule[step].utilization >= 1) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "background traffic steps require a utilization in [0, 1), got "
+                      << schedule[step].utilization << std::endl;
+            std::exit(-1);
+        }
+        if (step > 0 && schedule[step].time <= schedule[step - 1].time) {
+            std::cerr << "[Error] (network/analytical/congestion_aware) "
+                      << "background traffic steps should be in increasing time order" << std::endl;
+            std::exit(-1);
+        }
+    }
+}
+
+void Topology::set_dim_channels(const int dim, const int channels_count, const ChannelMode channel_mode) noexcept {
+    assert(0 <= dim && dim < dims_count);
+    if (channels_count <= 0) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "channels count should be positive, got "
+                  << channels_count << std::endl;
+        std::exit(-1);
+    }
+
+    // lazy links share their channels (only 1-dim topologies are lazy)
+    if (links.lazy()) {
+        assert(dims_count == 1);
+        links.set_channels(channels_count, channel_mode);
+        return;
+    }
+    for (auto link_id = 0; link_id < static_cast<LinkId>(links.size()); link_id++) {
+        if (get_link_dim(link_id) == dim) {
+            links[link_id].set_channels(channels_count, channel_mode);
+        }
+    }
+}
+
+int Topology::get_link_dim(const LinkId link_id) const noexcept {
+    assert(0 <= link_id && link_id < links.size());
+    assert(dims_count == 1);
+
+    (void)link_id;
+    return 0;
+}
+
+std::string Topology::get_link_group(const LinkId link_id) const noexcept {
+    return "dim " + std::to_string(get_link_dim(link_id));
+}
+
+ChunkPool& Topology::get_chunk_pool() noexcept {
+    return chunk_pool;
+}
+
+void Topology::connect(const DeviceId src,
+                       const DeviceId dest,
+                       const Bandwidth bandwidth,
+                       const Latency latency,
+                       const bool bidirectional) noexcept {
+    // assert the src and dest are valid
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    // assert bandwidth and latency are valid
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // connect src -> dest
+    links.emplace_back(src, dest, bandwidth, latency);
+
+    // if bidirectional, connect dest -> src
+    if (bidirectional) {
+        links.emplace_back(dest, src, bandwidth, latency);
+    }
+
+    // the adjacency is rebuilt on its next use
+    adjacency_offsets.clear();
+}
+
+void Topology::connect_all(const std::vector<std::pair<DeviceId, DeviceId>>& endpoints,
+                           const Bandwidth bandwidth,
+                           const Latency latency,
+                           const int threads_count) noexcept {
+    assert(links.size() == 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // assert every src and dest is valid
+    for ([[maybe_unused]] const auto& endpoint : endpoints) {
+        assert(0 <= endpoint.first && endpoint.first < devices_count);
+        assert(0 <= endpoint.second && endpoint.second < devices_count);
+    }
+
+    links.assign(endpoints, bandwidth, latency, threads_count);
+
+    // the adjacency is rebuilt on its next use
+    adjacency_offsets.clear();
+}
+
+void Topology::build_adjacency() const noexcept {
+    assert(devices_count > 0);
+
+    // count the outgoing links of each device
+    const auto links_count = static_cast<int>(links.size());
+    adjacency_offsets.assign(devices_count + 1, 0);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        adjacency_offsets[links.endpoints(link_id).first + 1]++;
+    }
+    for (auto i = 0; i < devices_count; i++) {
+        adjacency_offsets[i + 1] += adjacency_offsets[i];
+    }
+
+    // place each link in its src's range
+    adjacency_dests.resize(links_count);
+    adjacency_link_ids.resize(links_count);
+    auto next_slot = std::vector<int>(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        const auto slot = next_slot[links.endpoints(link_id).first]++;
+        adjacency_link_ids[slot] = link_id;
+    }
+
+    // sort each range by dest for binary search
+    for (auto i = 0; i < devices_count; i++) {
+        const auto range_begin = adjacency_link_ids.begin() + adjacency_offsets[i];
+        const auto range_end = adjacency_link_ids.begin() + adjacency_offsets[i + 1];
+        std::sort(range_begin, range_end,
+                  [&](const LinkId a, const LinkId b) {
+                      return links.endpoints(a).second < links.endpoints(b).second;
+                  });
+    }
+    for (auto slot = 0; slot < links_count; slot++) {
+        adjacency_dests[slot] = links.endpoints(adjacency_link_ids[slot]).second;
+
+        // assert there's no duplicated connection
+        assert(slot == 0 || adjacency_dests[slot] != adjacency_dests[slot - 1] ||
+               links.endpoints(adjacency_link_ids[slot]).first !=
+                   links.endpoints(adjacency_link_ids[slot - 1]).first);
+    }
+}
+
+Bandwidth Topology::get_link_capacity(const LinkId link_id) const noexcept {
+    const auto& link = get_link(link_id);
+    return link.get_bandwidth() * link.get_channels_count();
+}
+
+double Topology::grid_average_hops_count(const std::vector<int>& sizes, const bool wrap_around) noexcept {
+    auto npus_count = 1.0;
+    for (const auto size : sizes) {
+        npus_count *= size;
+    }
+    if (npus_count < 2) {
+        return 0;
+    }
+
+    // NPU pairs are independent per dimension: (N / size)^2 pairs share each pair of coordinates
+    auto total_hops_count = 0.0;
+    for (const auto size : sizes) {
+        // sum of the distances between every (ordered) pair of coordinates
+        const auto coordinate_pairs_distance = wrap_around ? static_cast<double>(size) * (size * size / 4)
+                                                           : (static_cast<double>(size) * size * size - size) / 3;
+        total_hops_count += (npus_count / size) * (npus_count / size) * coordinate_pairs_distance;
+    }
+    return total_hops_count / (npus_count * (npus_count - 1));
+}
+
+std::vector<int> Topology::grid_ring_order(const int width, const int height) noexcept {
+    assert(width > 0 && height > 0);
+
+    auto cells = std::vector<int>();
+    cells.reserve(static_cast<size_t>(width) * height);
+
+    // a line: out over the even cells, back over the odd ones, every step 2 hops at most
+    if (width == 1 || height == 1) {
+        const auto length = width * height;
+        for (auto cell = 0; cell < length; cell += 2) {
+            cells.push_back(cell);
+        }
+        for (auto cell = ((length - 1) % 2 == 1) ? (length - 1) : (length - 2); cell > 0; cell -= 2) {
+            cells.push_back(cell);
+        }
+        return cells;
+    }
+
+    // no Hamiltonian cycle with both sides odd: rows in boustrophedon order
+    if (width % 2 == 1 && height % 2 == 1) {
+        for (auto y = 0; y < height; y++) {
+            for (auto step = 0; step < width; step++) {
+                cells.push_back(y * width + ((y % 2 == 0) ? step : (width - 1 - step)));
+            }
+        }
+        return cells;
+    }
+
+    // along the first line, snaking back over the other ones but their first cells, back along those
+    // (lines are rows if the height is even, columns otherwise)
+    const auto rows = (height % 2 == 0);
+    const auto lines_count = rows ? height : width;
+    const auto line_length = rows ? width : height;
+    const auto cell = [&](const int line, const int position) {
+        return rows ? (line * width + position) : (position * width + line);
+    };
+    for (auto position = 0; position < line_length; position++) {
+        cells.push_back(cell(0, position));
+    }
+    for (auto line = 1; line < lines_count; line++) {
+        for (auto step = 0; step < line_length - 1; step++) {
+            cells.push_back(cell(line, (line % 2 == 1) ? (line_length - 1 - step) : (step + 1)));
+        }
+    }
+    for (auto line = lines_count - 1; line > 0; line--) {
+        cells.push_back(cell(line, 0));
+    }
+    return cells;
+}
+
+LinkId Topology::find_link(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < devices_count);
+    assert(0 <= dest && dest < devices_count);
+
+    if (adjacency_offsets.empty()) {
+        build_adjacency();
+    }
+
+    // binary search over the outgoing links of src
+    const auto range_begin = adjacency_dests.begin() + adjacency_offsets[src];
+    const auto range_end = adjacency_dests.begin() + adjacency_offsets[src + 1];
+    const auto it = std::lower_bound(range_begin, range_end, dest);
+    if (it == range_end || *it != dest) {
+        return -1;
+    }
+
+    return adjacency_link_ids[it - adjacency_dests.begin()];
+}
+
+void Topology::resolve_links(Route& route) const noexcept {
+    for (auto hop = 0; hop < route.size() - 1; hop++) {
+        const auto link_id = find_link(route[hop], route[hop + 1]);
+
+        // assert the next device is connected
+        assert(link_id >= 0);
+
+        route.set_link_id(hop, link_id);
+    }
+
+    route.mark_links_resolved();
+}
+
+bool Topology::crosses_failed_link(const Chunk& chunk) const noexcept {
+    for (auto hop = chunk.route_index; hop < static_cast<int>(chunk.route->size()) - 1; hop++) {
+        if (failed_links.count(chunk.route->link_id(hop)) > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Topology::reroute(Chunk& chunk) const noexcept {
+    assert(chunk.coalesced_chunks == nullptr);
+
+    // next-hop tables reach every device of the way once they reach the current one
+    const auto current = chunk.current_device();
+    if (live_next_hop(current, chunk.dest) < 0) {
+        return false;
+    }
+
+    // hop-by-hop chunks only take the next hop
+    if (chunk.hop_by_hop) {
+        chunk.route = &one_hop_route(current, live_next_hop(current, chunk.dest));
+        chunk.route_index = 0;
+        return true;
+    }
+
+    // others get a route of their own, from the current device on
+    auto detour = std::make_unique<Route>(Route({current}));
+    for (auto device = current; device != chunk.dest;) {
+        device = live_next_hop(device, chunk.dest);
+        assert(device >= 0);
+        detour->push_back(device);
+    }
+    resolve_links(*detour);
+    chunk.owned_route = std::move(detour);
+    chunk.route = chunk.owned_route.get();
+    chunk.route_index = 0;
+    return true;
+}
+
+void Topology::strand(std::unique_ptr<Chunk> chunk, const bool resend) noexcept {
+    assert(chunk != nullptr);
+
+    if (!links_restoring()) {
+        std::cerr << "[Error] (network/analytical/congestion_aware) " << "device " << chunk->current_device()
+                  << " can't reach NPU " << chunk->dest << " around the failed links" << std::endl;
+        std::exit(-1);
+    }
+
+    stranded_chunks.emplace_back(std::move(chunk), resend);
+}
+
+bool Topology::links_restoring() const noexcept {
+    return std::any_of(scheduled_link_changes.begin(), scheduled_link_changes.end(),
+                       [](const LinkStateChange& change) { return !change.failed; });
+}
+
+void Topology::resume_stranded_chunks() noexcept {
+    // chunks still stranded are stranded again
+    auto resumed_chunks = std::move(stranded_chunks);
+    stranded_chunks.clear();
+    for (auto& [chunk, resend] : resumed_chunks) {
+        if (resend) {
+            send(std::move(chunk));
+        } else if (reroute(*chunk)) {
+            forward(std::move(chunk));
+        } else {
+            strand(std::move(chunk), false);
+        }
+    }
+}
+
+bool Topology::try_fast_forward(std::unique_ptr<Chunk>& chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(chunk->route->links_resolved());
+
+    // a single remaining hop costs one event either way
+    const auto last_hop = chunk->route->size() - 2;
+    if (chunk->route_index >= last_hop) {
+        return false;
+    }
+
+    // coalesced chunks are split at their last link (see Link::schedule_train_arrival)
+    if (chunk->coalesced_chunks != nullptr) {
+        return false;
+    }
+
+    // messages are delivered chunk by chunk from their head (see deliver_message_chunk)
+    if (chunk->message_chunks_count > 1) {
+        return false;
+    }
+
+    // the next link is reserved from now on if it's idle until the chunk is serialized
+    // (calendar links aren't, as chunks may overtake each other in their gaps)
+    const auto current_time = scheduler->get_current_time();
+    const auto first_link_id = chunk->route->link_id(chunk->route_index);
+    auto& first_link = links[first_link_id];
+    if (first_link.get_link_model() != LinkModel::VirtualTime) {
+        return false;
+    }
+    settle_link_claims(first_link_id);
+    const auto first_timing = first_link.plan_transmission(current_time, *chunk, chunk->tail_arrival_time);
+    if (!unclaimed_at(first_link_id, current_time, first_timing.link_free_time, *chunk)) {
+        return false;
+    }
+
+    // the following links are claimed as long as they're idle and unclaimed by the time the chunk reaches them
+    auto trip = std::unique_ptr<FastForwardTrip>();
+    if (spare_trips.empty()) {
+        trip = std::make_unique<FastForwardTrip>();
+    } else {
+        trip = std::move(spare_trips.back());
+        spare_trips.pop_back();
+        trip->claims.clear();
+    }
+    auto arrival_time = first_timing.head_arrival_time;
+    auto tail_arrival_time = first_timing.tail_arrival_time;
+    for (auto hop = chunk->route_index + 1; hop <= last_hop; hop++) {
+        const auto link_id = chunk->route->link_id(hop);
+        auto& link = links[link_id];
+        if (link.get_link_model() != LinkModel::VirtualTime) {
+            break;
+        }
+        const auto timing = link.plan_transmission(arrival_time, *chunk, tail_arrival_time);
+        if (!unclaimed_at(link_id, arrival_time, timing.link_free_time, *chunk)) {
+            break;
+        }
+        trip->claims.push_back({link_id, arrival_time, timing});
+        arrival_time = timing.head_arrival_time;
+        tail_arrival_time = timing.tail_arrival_time;
+    }
+    if (trip->claims.empty()) {
+        spare_trips.push_back(std::move(trip));
+        return false;
+    }
+
+    // reserve the next link, and file the claims of the following ones by start time
+    first_link.reserve(current_time, first_timing, *chunk);
+    const auto claims_count = static_cast<int>(trip->claims.size());
+    for (auto claim = 0; claim < claims_count; claim++) {
+        const auto start_time = trip->claims[claim].start_time;
+        auto& claims = link_claims[trip->claims[claim].link_id];
+        const auto position = std::find_if(claims.begin(), claims.end(), [start_time](const auto& other_claim) {
+            return other_claim.first->claims[other_claim.second].start_time > start_time;
+        });
+        claims.insert(position, {trip.get(), claim});
+    }
+    NETWORK_ANALYTICAL_STATS(chunk_stats.chunks_fast_forwarded++);
+
+    // the chunk sits at the device before its last claimed link, arriving past it next
+    // (the destination once its last packet arrives, another device once its head packet arrives)
+    const auto end_hop = chunk->route_index + claims_count;
+    if (end_hop == last_hop) {
+        arrival_time = tail_arrival_time;
+    }
+    chunk->hops_count += claims_count;
+    chunk->route_index = end_hop;
+    trip->topology = this;
+    trip->chunk = chunk.release();
+    trip->committed_count = 0;
+    trip->events_count = 1;
+    scheduler->schedule_event(arrival_time, fast_forward_arrival, static_cast<void*>(trip.release()));
+
+    return true;
+}
+
+bool Topology::unclaimed_at(const LinkId link_id,
+                            const EventTime start_time,
+                            const EventTime link_free_time,
+                            const Chunk& chunk) noexcept {
+    auto& link = links[link_id];
+    if (!link.idle_at(start_time, chunk)) {
+        return false;
+    }
+
+    // chunks don't contend for contention-free links
+    const auto claims = link_claims.find(link_id);
+    if (link.is_contention_free() || claims == link_claims.end()) {
+        return true;
+    }
+
+    return std::none_of(claims->second.begin(), claims->second.end(), [&](const auto& claim) {
+        const auto& other_claim = claim.first->claims[claim.second];
+        return other_claim.start_time < link_free_time && start_time < other_claim.timing.link_free_time;
+    });
+}
+
+void Topology::settle_link_claims(const LinkId link_id) noexcept {
+    // claims are in start time order (committing one removes it)
+    const auto current_time = scheduler->get_current_time();
+    auto claims = link_claims.find(link_id);
+    while (claims != link_claims.end()) {
+        const auto [trip, claim] = claims->second.front();
+        if (trip->claims[claim].start_time > current_time) {
+            return;
+        }
+        commit_claims(*trip, claim + 1);
+        claims = link_claims.find(link_id);
+    }
+}
+
+void Topology::revoke_overlapped_claims(const LinkId link_id) noexcept {
+    // revoking a claim may remove others of the link, so the claims are scanned again from the first one
+    auto& link = links[link_id];
+    auto claims = link_claims.find(link_id);
+    while (claims != link_claims.end()) {
+        const auto overlapped = std::find_if(claims->second.begin(), claims->second.end(), [&](const auto& claim) {
+            return !link.idle_at(claim.first->claims[claim.second].start_time, *claim.first->chunk);
+        });
+        if (overlapped == claims->second.end()) {
+            return;
+        }
+        revoke_claims(*overlapped->first, overlapped->second);
+        claims = link_claims.find(link_id);
+    }
+}
+
+void Topology::commit_claims(FastForwardTrip& trip, const int claims_count) noexcept {
+    assert(trip.chunk != nullptr);
+    assert(claims_count <= static_cast<int>(trip.claims.size()));
+
+    // the chunk's tail arrival time is carried from claim to claim
+    for (auto claim = trip.committed_count; claim < claims_count; claim++) {
+        const auto& link_claim = trip.claims[claim];
+        links[link_claim.link_id].reserve(link_claim.start_time, link_claim.timing, *trip.chunk);
+        remove_link_claim(&trip, claim);
+    }
+    trip.committed_count = std::max(trip.committed_count, claims_count);
+}
+
+void Topology::revoke_claims(FastForwardTrip& trip, const int first_claim) noexcept {
+    assert(trip.chunk != nullptr);
+    assert(trip.committed_count <= first_claim && first_claim < static_cast<int>(trip.claims.size()));
+
+    const auto claims_count = static_cast<int>(trip.claims.size());
+    for (auto claim = first_claim; claim < claims_count; claim++) {
+        remove_link_claim(&trip, claim);
+    }
+
+    // the chunk goes back to the src of the first revoked link, which it reaches when the claim started
+    const auto revoked_count = claims_count - first_claim;
+    const auto arrival_time = trip.claims[first_claim].start_time;
+    trip.chunk->route_index -= revoked_count;
+    trip.chunk->hops_count -= revoked_count;
+    trip.claims.resize(first_claim);
+    trip.events_count++;
+    scheduler->schedule_event(arrival_time, fast_forward_arrival, static_cast<void*>(&trip));
+}
+
+void Topology::remove_link_claim(FastForwardTrip* const trip, const int claim) noexcept {
+    const auto claims = link_claims.find(trip->claims[claim].link_id);
+    assert(claims != link_claims.end());
+
+    auto& link_claims_list = claims->second;
+    const auto position = std::find(link_claims_list.begin(), link_claims_list.end(), std::make_pair(trip, claim));
+    assert(position != link_claims_list.end());
+    link_claims_list.erase(position);
+    if (link_claims_list.empty()) {
+        link_claims.erase(claims);
+    }
+}
+
+void Topology::fast_forward_arrival(void* const trip_ptr) noexcept {
+    assert(trip_ptr != nullptr);
+
+    // the earliest arrival of the trip arrives the chunk, the later ones were superseded
+    auto* const trip = static_cast<FastForwardTrip*>(trip_ptr);
+    auto* const topology = trip->topology;
+    auto* const chunk = trip->chunk;
+    if (chunk != nullptr) {
+        topology->commit_claims(*trip, static_cast<int>(trip->claims.size()));
+        trip->chunk = nullptr;
+    }
+
+    // the trip is recycled once no arrival refers to it
+    trip->events_count--;
+    if (trip->events_count == 0) {
+        topology->spare_trips.push_back(std::unique_ptr<FastForwardTrip>(trip));
+    }
+
+    if (chunk != nullptr) {
+        Chunk::chunk_arrived_next_device(static_cast<void*>(chunk));
+    }
+}
+
+void Topology::deliver_chunk(Chunk& chunk) noexcept {
+    NETWORK_ANALYTICAL_STATS(record_chunk_delivery(chunk));
+    if (job_accounting) {
+        record_job_delivery(chunk);
+    }
+    if (chunk.nic_metered && nic_model != nullptr) {
+        // the chunk frees its outstanding slot at the NIC
+        nic_model->release(chunk.src, *scheduler);
+    }
+    if constexpr (observers_enabled) {
+        if (completion_log != nullptr) {
+            // the chunk is delivered once its last packet arrived
+            completion_log->record(chunk, chunk.tail_arrival_time);
+        }
+        if (latency_histograms != nullptr) {
+            latency_histograms->record(chunk, chunk.tail_arrival_time);
+        }
+    }
+    if (batch_callback != nullptr) {
+        batch_chunk_delivery(chunk);
+    } else {
+        chunk.invoke_callback();
+    }
+}
+
+bool Topology::write_through_ingress(std::unique_ptr<Chunk>& chunk) noexcept {
+    assert(chunk != nullptr);
+    assert(chunk->arrived_dest());
+
+    if (ingress_ticks_per_byte == 0) {
+        return false;
+    }
+
+    // the write overlaps the reception, so it only ends later if the writes ahead of it do
+    // (a message is written chunk by chunk: its first chunk ends first, the whole message last)
+    const auto current_time = scheduler->get_current_time();
+    const auto chunk_write_delay =
+        static_cast<EventTime>(static_cast<double>(chunk->chunk_size) * ingress_ticks_per_byte);
+    auto& ingress_free_time = ingress_free_times[chunk->dest];
+    const auto first_write_end = std::max(current_time, ingress_free_time + chunk_write_delay);
+    ingress_free_time = std::max(current_time, ingress_free_time + chunk_write_delay * chunk->message_chunks_count);
+    if (chunk->message_chunks_count > 1) {
+        chunk->tail_arrival_time = std::max(chunk->tail_arrival_time, ingress_free_time);
+    }
+    if (first_write_end == current_time) {
+        return false;
+    }
+
+    // deliver the chunk (the first chunk of a message) once written
+    if (chunk->message_chunks_count > 1) {
+        scheduler->schedule_event(first_write_end, message_chunk_arrived, static_cast<void*>(chunk.release()));
+        return true;
+    }
+    chunk->tail_arrival_time = first_write_end;
+    scheduler->schedule_event(first_write_end, chunk_written, static_cast<void*>(chunk.release()));
+    return true;
+}
+
+void Topology::chunk_written(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    auto chunk = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
+    auto* const topology = chunk->topology;
+    assert(topology != nullptr);
+    topology->deliver_chunk(*chunk);
+    if (chunk->chunk_pool != nullptr) {
+        auto* const chunk_pool = chunk->chunk_pool;
+        chunk_pool->release(std::move(chunk));
+    }
+}
+
+void Topology::deliver_message_chunk(std::unique_ptr<Chunk> message) noexcept {
+    assert(message != nullptr);
+    assert(message->arrived_dest());
+
+    // the last chunk is delivered as a chunk of its own
+    if (message->message_chunks_count == 1) {
+        deliver_chunk(*message);
+        if (message->chunk_pool != nullptr) {
+            auto* const chunk_pool = message->chunk_pool;
+            chunk_pool->release(std::move(message));
+        }
+        return;
+    }
+
+    // deliver the first chunk (the message keeps its NIC slot until the last one)
+    const auto current_time = scheduler->get_current_time();
+    const auto last_arrival_time = message->tail_arrival_time;
+    const auto nic_metered = message->nic_metered;
+    message->tail_arrival_time = current_time;
+    message->nic_metered = false;
+    deliver_chunk(*message);
+    message->tail_arrival_time = last_arrival_time;
+    message->nic_metered = nic_metered;
+
+    // the remaining chunks arrive evenly until the last one
+    message->message_chunks_count--;
+    const auto arrival_span = (last_arrival_time > current_time) ? last_arrival_time - current_time : 0;
+    message->message_head_arrival_time = current_time + arrival_span / message->message_chunks_count;
+    const auto next_arrival_time =
+        (message->message_chunks_count == 1) ? last_arrival_time : message->message_head_arrival_time;
+    scheduler->schedule_event(next_arrival_time, message_chunk_arrived, static_cast<void*>(message.release()));
+}
+
+void Topology::message_chunk_arrived(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    auto message = std::unique_ptr<Chunk>(static_cast<Chunk*>(chunk_ptr));
+    auto* const topology = message->topology;
+    assert(topology != nullptr);
+    topology->deliver_message_chunk(std::move(message));
+}
+
+void Topology::batch_chunk_delivery(const Chunk& chunk) noexcept {
+    assert(batch_callback != nullptr);
+
+    // the first chunk delivered at this time schedules the notification,
+    // which runs after the arrivals already scheduled at this time
+    if (delivered_chunk_ids.empty()) {
+        scheduler->schedule_event(scheduler->get_current_time(), notify_delivered_chunks, this);
+    }
+    delivered_chunk_ids.push_back(chunk.chunk_id);
+}
+
+void Topology::notify_delivered_chunks(void* const topology_ptr) noexcept {
+    assert(topology_ptr != nullptr);
+
+    auto* const topology = static_cast<Topology*>(topology_ptr);
+    auto& delivered_chunk_ids = topology->delivered_chunk_ids;
+    if (delivered_chunk_ids.empty() || topology->batch_callback == nullptr) {
+        // cleared by reset, or batching turned off meanwhile
+        delivered_chunk_ids.clear();
+        return;
+    }
+
+    // chunks sent by the callback arrive through later events, so the ids stay untouched meanwhile
+    // (and the buffer is kept for the next batch)
+    const auto chunks_count = static_cast<int>(delivered_chunk_ids.size());
+    (*topology->batch_callback)(delivered_chunk_ids.data(), chunks_count, topology->batch_callback_arg);
+    delivered_chunk_ids.clear();
+}
+
+const void* Topology::chunk_arrival_resource(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    const auto* const chunk = static_cast<const Chunk*>(chunk_ptr);
+    const auto* const topology = chunk->topology;
+    assert(topology != nullptr);
+
+    // arriving at the destination invokes the user callback,
+    // fast forwarding reserves several links,
+    // and hop-by-hop chunks don't know their next link yet
+    const auto arrived_device_index = chunk->route_index + 1;
+    if (arrived_device_index == chunk->route->size() - 1 || topology->fast_forward || chunk->hop_by_hop) {
+        return nullptr;
+    }
+
+    // messages split at a busy link take their chunks from the topology's pool,
+    // crossbars are shared by the links of their switch, and failed links reroute the chunk
+    const auto arrived_device = (*chunk->route)[arrived_device_index];
+    if (chunk->message_chunks_count > 1 || !topology->failed_links.empty() ||
+        (topology->switch_model != nullptr && arrived_device >= topology->npus_count)) {
+        return nullptr;
+    }
+
+    // the chunk is forwarded through the next link of its route (unless it also charges the buffer after it)
+    auto& next_link = topology->links[chunk->route->link_id(arrived_device_index)];
+    return link_free_resource(&next_link);
+}
+
+const void* Topology::link_free_resource(void* const link_ptr) noexcept {
+    assert(link_ptr != nullptr);
+
+    // a link with bounded buffers downstream charges the buffer of its chunks' next link, and stalls on it
+    const auto* const link = static_cast<const Link*>(link_ptr);
+    if (link->charges_next_buffers()) {
+        return nullptr;
+    }
+
+    return link_ptr;
+}
+
+uint64_t Topology::link_order_key(const DeviceId src, const DeviceId dest) noexcept {
+    assert(src >= 0);
+    assert(dest >= 0);
+
+    return (static_cast<uint64_t>(src) << 32) | static_cast<uint32_t>(dest);
+}
+
+uint64_t Topology::chunk_arrival_order_key(void* const chunk_ptr) noexcept {
+    assert(chunk_ptr != nullptr);
+
+    // the chunk hasn't been marked arrived yet, so it still sits at the link's src
+    const auto* const chunk = static_cast<const Chunk*>(chunk_ptr);
+    return link_order_key(chunk->current_device(), chunk->next_device());
+}
+
+uint64_t Topology::link_free_order_key(void* const link_ptr) noexcept {
+    assert(link_ptr != nullptr);
+
+    const auto* const link = static_cast<const Link*>(link_ptr);
+    return link_order_key(link->get_src(), link->get_dest());
+}
+
+const ChunkStats& Topology::get_chunk_stats() const noexcept {
+    return chunk_stats;
+}
+
+uint64_t Topology::get_routes_computed_count() const noexcept {
+    return routes_computed.load(std::memory_order_relaxed);
+}
+
+void Topology::record_chunk_delivery(const Chunk& chunk) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(chunk_stats_mutex);
+
+    chunk_stats.chunks_delivered++;
+    chunk_stats.hops_count += chunk.hops_count;
+    chunk_stats.queueing_delay += chunk.queueing_delay;
+    chunk_stats.max_queueing_delay = std::max(chunk_stats.max_queueing_delay, chunk.queueing_delay);
+}
+
+void Topology::set_job_accounting(const bool enabled) noexcept {
+    job_accounting = enabled;
+}
+
+const std::vector<JobStats>& Topology::get_job_stats() const noexcept {
+    return job_stats;
+}
+
+void Topology::record_job_delivery(const Chunk& chunk) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(job_stats_mutex);
+
+    if (chunk.job_id >= job_stats.size()) {
+        job_stats.resize(chunk.job_id + 1);
+    }
+
+    // the chunk is delivered once its last packet arrived
+    auto& stats = job_stats[chunk.job_id];
+    if (stats.chunks_delivered == 0) {
+        stats.first_inject_time = chunk.inject_time;
+        stats.last_delivery_time = chunk.tail_arrival_time;
+    } else {
+        stats.first_inject_time = std::min(stats.first_inject_time, chunk.inject_time);
+        stats.last_delivery_time = std::max(stats.last_delivery_time, chunk.tail_arrival_time);
+    }
+    stats.chunks_delivered++;
+    stats.bytes_delivered += chunk.chunk_size;
+}
+
+bool Topology::stamps_inject_time() const noexcept {
+    return (observers_enabled && (completion_log != nullptr || latency_histograms != nullptr)) || job_accounting;
+}
+
+void Topology::dump_stats(std::ostream& output) const noexcept {
+    if constexpr (!stats_enabled) {
+        output << "[Stats] statistics not collected (build with NETWORK_BACKEND_ENABLE_STATS=ON)" << std::endl;
+        return;
+    }
+
+    // event queue
+    const auto current_time = (scheduler != nullptr) ? scheduler->get_current_time() : 0;
+    output << "[Stats] simulated time: " << current_time << " " << time_unit << std::endl;
+    if (event_queue != nullptr) {
+        const auto& event_queue_stats = event_queue->get_stats();
+        output << "[Stats] events scheduled: " << event_queue_stats.events_scheduled
+               << ", processed: " << event_queue_stats.events_processed
+               << ", event times: " << event_queue_stats.event_lists_processed
+               << ", max pending event times: " << event_queue_stats.max_pending_event_lists << std::endl;
+    }
+
+    // links
+    auto bytes_transmitted = static_cast<uint64_t>(0);
+    auto busy_time = static_cast<EventTime>(0);
+    auto max_busy_time = static_cast<EventTime>(0);
+    auto max_pending_chunks = 0;
+    auto chunks_coalesced = static_cast<uint64_t>(0);
+    auto backpressure_time = static_cast<EventTime>(0);
+    for (const auto& link : links) {
+        const auto& link_stats = link.get_stats();
+        chunks_coalesced += link_stats.chunks_coalesced;
+        backpressure_time += link_stats.backpressure_time;
+        bytes_transmitted += link_stats.bytes_transmitted;
+        busy_time += link_stats.busy_time;
+        max_busy_time = std::max(max_busy_time, link_stats.busy_time);
+        max_pending_chunks = std::max(max_pending_chunks, link_stats.max_pending_chunks);
+    }
+    const auto links_count = static_cast<double>(links.size());
+    const auto elapsed_time = static_cast<double>(std::max(current_time, static_cast<EventTime>(1)));
+    output << std::fixed << std::setprecision(3);
+    output << "[Stats] links: " << links.size() << " (" << links.materialized_size() << " materialized)"
+           << ", bytes transmitted: " << bytes_transmitted
+           << ", mean utilization: " << (static_cast<double>(busy_time) / (links_count * elapsed_time))
+           << ", max utilization: " << (static_cast<double>(max_busy_time) / elapsed_time)
+           << ", max pending chunks: " << max_pending_chunks << ", chunks coalesced: " << chunks_coalesced
+           << ", backpressure time: " << backpressure_time << std::endl;
+
+    // chunks
+    const auto chunks_delivered = static_cast<double>(std::max(chunk_stats.chunks_delivered, static_cast<uint64_t>(1)));
+    output << "[Stats] chunks delivered: " << chunk_stats.chunks_delivered
+           << ", mean hops: " << (static_cast<double>(chunk_stats.hops_count) / chunks_delivered)
+           << ", mean queueing delay: " << (static_cast<double>(chunk_stats.queueing_delay) / chunks_delivered)
+           << " " << time_unit << ", max queueing delay: " << chunk_stats.max_queueing_delay
+           << " " << time_unit << ", fast forwarded: " << chunk_stats.chunks_fast_forwarded << std::endl;
+    output.unsetf(std::ios_base::floatfield);
+}
+
+std::vector<LinkId> Topology::rank_links() const noexcept {
+    // only materialized links were used
+    auto ranked_links = std::vector<LinkId>();
+    ranked_links.reserve(links.materialized_size());
+    for (auto link_id = 0; link_id < links.size(); link_id++) {
+        if (links.materialized(link_id)) {
+            ranked_links.push_back(link_id);
+        }
+    }
+
+    std::stable_sort(ranked_links.begin(), ranked_links.end(), [this](const LinkId lhs, const LinkId rhs) {
+        const auto& lhs_stats = links[lhs].get_stats();
+        const auto& rhs_stats = links[rhs].get_stats();
+        if (lhs_stats.busy_time != rhs_stats.busy_time) {
+            return lhs_stats.busy_time > rhs_stats.busy_time;
+        }
+        if (lhs_stats.queueing_delay != rhs_stats.queueing_delay) {
+            return lhs_stats.queueing_delay > rhs_stats.queueing_delay;
+        }
+        return lhs_stats.max_pending_chunks > rhs_stats.max_pending_chunks;
+    });
+    return ranked_links;
+}
+
+void Topology::dump_link_ranking(std::ostream& output, const int top_links_count) const noexcept {
+    assert(top_links_count >= 0);
+
+    if constexpr (!stats_enabled) {
+        output << "[Stats] statistics not collected (build with NETWORK_BACKEND_ENABLE_STATS=ON)" << std::endl;
+        return;
+    }
+
+    const auto ranked_links = rank_links();
+    const auto current_time = (scheduler != nullptr) ? scheduler->get_current_time() : 0;
+    const auto elapsed_time = static_cast<double>(std::max(current_time, static_cast<EventTime>(1)));
+
+    // aggregate the links per group, groups listed in order of their first (most loaded) link
+    struct GroupLoad {
+        std::string name;
+        int links_count = 0;
+        EventTime busy_time = 0;
+        EventTime queueing_delay = 0;
+        int max_pending_chunks = 0;
+    };
+    auto groups = std::vector<GroupLoad>();
+    for (const auto link_id : ranked_links) {
+        const auto name = get_link_group(link_id);
+        auto group = std::find_if(groups.begin(), groups.end(), [&name](const auto& g) { return g.name == name; });
+        if (group == groups.end()) {
+            group = groups.insert(groups.end(), GroupLoad{name});
+        }
+        const auto& link_stats = links[link_id].get_stats();
+        group->links_count++;
+        group->busy_time += link_stats.busy_time;
+        group->queueing_delay += link_stats.queueing_delay;
+        group->max_pending_chunks = std::max(group->max_pending_chunks, link_stats.max_pending_chunks);
+    }
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.busy_time > rhs.busy_time; });
+
+    output << std::fixed << std::setprecision(3);
+    for (const auto& group : groups) {
+        output << "[Stats] group " << group.name << ": links: " << group.links_count
+               << ", busy time: " << group.busy_time << " " << time_unit << ", mean utilization: "
+               << (static_cast<double>(group.busy_time) / (group.links_count * elapsed_time))
+               << ", queueing delay: " << group.queueing_delay
+               << " " << time_unit << ", max pending chunks: " << group.max_pending_chunks << std::endl;
+    }
+
+    // most loaded links
+    const auto listed_links_count = std::min(ranked_links.size(), static_cast<size_t>(top_links_count));
+    for (auto rank = static_cast<size_t>(0); rank < listed_links_count; rank++) {
+        const auto link_id = ranked_links[rank];
+        const auto& link = links[link_id];
+        const auto& link_stats = link.get_stats();
+        output << "[Stats] link #" << (rank + 1) << " " << link.get_src() << "->" << link.get_dest() << " ("
+               << get_link_group(link_id) << "): busy time: " << link_stats.busy_time << " " << time_unit
+               << ", utilization: " << (static_cast<double>(link_stats.busy_time) / elapsed_time)
+               << ", queueing delay: " << link_stats.queueing_delay << " " << time_unit
+               << ", max pending chunks: " << link_stats.max_pending_chunks << std::endl;
+    }
+    output.unsetf(std::ios_base::floatfield);
+}
+
+MemoryFootprint Topology::get_memory_footprint() const noexcept {
+    auto memory_footprint = MemoryFootprint();
+
+    // link graph only grows
+    auto& link_graph = memory_footprint.link_graph;
+    link_graph.bytes = links.get_allocated_bytes() + (adjacency_offsets.capacity() * sizeof(int)) +
+                       (adjacency_dests.capacity() * sizeof(DeviceId)) +
+                       (adjacency_link_ids.capacity() * sizeof(LinkId)) + (link_routes.capacity() * sizeof(Route));
+    link_graph.peak_bytes = link_graph.bytes;
+
+    // route tables only grow (unless the route cache is resized)
+    auto& route_tables = memory_footprint.route_tables;
+    route_tables.bytes = get_route_tables_bytes();
+    route_tables.peak_bytes = route_tables.bytes;
+
+    // chunks in flight, the pool keeping every chunk it allocated
+    const auto allocated_chunks_count = static_cast<uint64_t>(chunk_pool.get_allocated_chunks_count());
+    const auto free_chunks_count = static_cast<uint64_t>(chunk_pool.get_free_chunks_count());
+    auto& chunks = memory_footprint.chunks;
+    chunks.bytes = (allocated_chunks_count - free_chunks_count) * sizeof(Chunk);
+    chunks.peak_bytes = allocated_chunks_count * sizeof(Chunk);
+
+    // event lists, if driven by an event queue
+    if (event_queue != nullptr) {
+        memory_footprint.event_queue = event_queue->get_memory_usage();
+    }
+
+    // chunks queued at the (materialized) links
+    auto queued_chunks_count = static_cast<uint64_t>(0);
+    for (const auto& link : links) {
+        queued_chunks_count += link.get_queued_chunks_count();
+    }
+    auto& link_queues = memory_footprint.link_queues;
+    link_queues.bytes = queued_chunks_count * sizeof(Chunk);
+    link_queues.peak_bytes = link_queues.bytes;
+
+    // fold in the usage observed so far
+    memory_footprint.link_graph.update_peak(peak_memory_footprint.link_graph);
+    memory_footprint.route_tables.update_peak(peak_memory_footprint.route_tables);
+    memory_footprint.chunks.update_peak(peak_memory_footprint.chunks);
+    memory_footprint.event_queue.update_peak(peak_memory_footprint.event_queue);
+    memory_footprint.link_queues.update_peak(peak_memory_footprint.link_queues);
+    peak_memory_footprint = memory_footprint;
+
+    return memory_footprint;
+}
+
+void Topology::dump_memory_footprint(std::ostream& output) const noexcept {
+    const auto memory_footprint = get_memory_footprint();
+
+    // bytes (peak bytes) per category
+    const auto print = [&output](const char* const category, const MemoryUsage& memory_usage) {
+        output << "[Memory] " << category << ": " << memory_usage.bytes << " B (peak " << memory_usage.peak_bytes
+               << " B)" << std::endl;
+    };
+    print("link graph", memory_footprint.link_graph);
+    print("route tables", memory_footprint.route_tables);
+    print("chunks", memory_footprint.chunks);
+    print("event queue", memory_footprint.event_queue);
+    print("link queues", memory_footprint.link_queues);
+    output << "[Memory] total: " << memory_footprint.total_bytes()
+           << " B (peak at most " << memory_footprint.total_peak_bytes() << " B)" << std::endl;
+}
+
+uint64_t Topology::get_route_tables_bytes() const noexcept {
+    auto multicast_trees_bytes = static_cast<uint64_t>(0);
+    for (const auto& [key, tree] : multicast_trees) {
+        multicast_trees_bytes += key.capacity() * sizeof(DeviceId) + sizeof(MulticastTree);
+        multicast_trees_bytes += tree->get_allocated_bytes();
+    }
+
+    // detour tables around failed links, and the incoming adjacency they're computed from
+    auto detour_bytes = (incoming_offsets.capacity() + incoming_link_ids.capacity()) * sizeof(int);
+    detour_bytes += detour_next_hops.bucket_count() * sizeof(void*);
+    for (const auto& [dest, next_hops] : detour_next_hops) {
+        detour_bytes += sizeof(void*) + sizeof(std::pair<const DeviceId, std::vector<DeviceId>>);
+        detour_bytes += next_hops.capacity() * sizeof(DeviceId);
+    }
+
+    return route_table_bytes(shared_routes) + route_cache.get_allocated_bytes() + multicast_trees_bytes + detour_bytes;
+}
+
+uint64_t Topology::route_table_bytes(const RouteTable& route_table) const noexcept {
+    // row pointers, and the rows allocated so far
+    auto allocated_bytes = static_cast<uint64_t>(route_table.capacity() * sizeof(std::unique_ptr<Route[]>));
+    for (const auto& src_routes : route_table) {
+        if (src_routes == nullptr) {
+            continue;
+        }
+        allocated_bytes += static_cast<uint64_t>(npus_count) * sizeof(Route);
+        for (auto dest = 0; dest < npus_count; dest++) {
+            allocated_bytes += src_routes[dest].get_heap_bytes();
+        }
     }
+    return allocated_bytes;
 }
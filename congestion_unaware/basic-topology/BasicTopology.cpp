@@ -5,6 +5,10 @@ LICENSE file in the root directory of this source tree.
 
 #include "congestion_unaware/BasicTopology.h"
 #include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "congestion_unaware/DelayKernel.h"
+#include <algorithm>
+#include <array>
 #include <cassert>
 
 using namespace NetworkAnalytical;
@@ -25,8 +29,9 @@ BasicTopology::BasicTopology(const int npus_count, const Bandwidth bandwidth, co
     this->bandwidth = bandwidth;
     bandwidth_per_dim.push_back(bandwidth);
 
-    // translate bandwidth from GB/s to B/ns
-    bandwidth_Bpns = bw_GBps_to_Bpns(bandwidth);
+    // translate bandwidth from GB/s to B/tick, and latency from ns to ticks
+    bandwidth_Bptick = bw_GBps_to_Bpns(bandwidth) / static_cast<double>(ticks_per_ns);
+    latency_ticks = latency * static_cast<double>(ticks_per_ns);
 }
 
 // default destructor
@@ -45,13 +50,39 @@ EventTime BasicTopology::send(const DeviceId src, const DeviceId dest, const Chu
     return compute_communication_delay(hops_count, chunk_size);
 }
 
+void BasicTopology::send_batch(const DeviceId* const srcs,
+                               const DeviceId* const dests,
+                               const ChunkSize* const chunk_sizes,
+                               EventTime* const delays,
+                               const int count) const noexcept {
+    assert(count >= 0);
+
+    // process the batch block by block, keeping hop counts on the stack
+    auto hops_counts = std::array<int, batch_block_size>();
+    for (auto offset = 0; offset < count; offset += batch_block_size) {
+        const auto block_size = std::min(batch_block_size, count - offset);
+
+        compute_hops_counts(srcs + offset, dests + offset, hops_counts.data(), block_size);
+        compute_communication_delays(hops_counts.data(), chunk_sizes + offset, delays + offset, block_size);
+    }
+}
+
+void BasicTopology::compute_hops_counts(const DeviceId* const srcs,
+                                        const DeviceId* const dests,
+                                        int* const hops_counts,
+                                        const int count) const noexcept {
+    for (auto i = 0; i < count; i++) {
+        hops_counts[i] = compute_hops_count(srcs[i], dests[i]);
+    }
+}
+
 EventTime BasicTopology::compute_communication_delay(const int hops_count, const ChunkSize chunk_size) const noexcept {
     assert(hops_count > 0);
     assert(chunk_size > 0);
 
     // compute link delay and serialization delay
-    auto link_delay = hops_count * latency;
-    auto serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bpns;
+    auto link_delay = hops_count * latency_ticks;
+    auto serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bptick;
 
     // comms_delay is the summation of the two
     auto comms_delay = link_delay + serialization_delay;
@@ -60,8 +91,36 @@ EventTime BasicTopology::compute_communication_delay(const int hops_count, const
     return static_cast<EventTime>(comms_delay);
 }
 
+void BasicTopology::compute_communication_delays(const int* const hops_counts,
+                                                 const ChunkSize* const chunk_sizes,
+                                                 EventTime* const delays,
+                                                 const int count) const noexcept {
+    // same formula as compute_communication_delay, vectorized
+    DelayKernel::compute_delays(hops_counts, chunk_sizes, delays, count, latency_ticks, bandwidth_Bptick);
+}
+
 TopologyBuildingBlock BasicTopology::get_basic_topology_type() const noexcept {
     assert(basic_topology_type != TopologyBuildingBlock::Undefined);
 
     return basic_topology_type;
 }
+
+Latency BasicTopology::get_latency() const noexcept {
+    assert(latency >= 0);
+
+    return latency;
+}
+
+Bandwidth BasicTopology::get_link_bandwidth(const int link_id) const noexcept {
+    assert(0 <= link_id && link_id < get_links_count());
+
+    return bandwidth;
+}
+
+int BasicTopology::get_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    return compute_hops_count(src, dest);
+}
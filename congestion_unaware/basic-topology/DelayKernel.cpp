@@ -0,0 +1,302 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/DelayKernel.h"
+#include <algorithm>
+#include <cassert>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    #define NETWORK_ANALYTICAL_X86_SIMD 1
+    #include <immintrin.h>
+#endif
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/**
+ * Scalar delay kernel over [begin, end).
+ */
+void compute_delays_scalar(const int* const hops_counts,
+                           const ChunkSize* const chunk_sizes,
+                           EventTime* const delays,
+                           const int begin,
+                           const int end,
+                           const Latency latency,
+                           const Bandwidth bandwidth_Bpns) noexcept {
+    for (auto i = begin; i < end; i++) {
+        assert(hops_counts[i] > 0);
+        assert(chunk_sizes[i] > 0);
+
+        const auto link_delay = hops_counts[i] * latency;
+        const auto serialization_delay = static_cast<double>(chunk_sizes[i]) / bandwidth_Bpns;
+        delays[i] = static_cast<EventTime>(link_delay + serialization_delay);
+    }
+}
+
+/**
+ * Scalar ring hop count kernel over [begin, end).
+ */
+void compute_ring_hops_counts_scalar(const DeviceId* const srcs,
+                                     const DeviceId* const dests,
+                                     int* const hops_counts,
+                                     const int begin,
+                                     const int end,
+                                     const int npus_count,
+                                     const bool bidirectional) noexcept {
+    for (auto i = begin; i < end; i++) {
+        assert(0 <= srcs[i] && srcs[i] < npus_count);
+        assert(0 <= dests[i] && dests[i] < npus_count);
+        assert(srcs[i] != dests[i]);
+
+        // clockwise distance, wrapped into [1, npus_count)
+        auto clockwise_distance = dests[i] - srcs[i];
+        clockwise_distance += (clockwise_distance < 0) ? npus_count : 0;
+
+        // bidirectional: take the shorter direction
+        const auto anticlockwise_distance = npus_count - clockwise_distance;
+        hops_counts[i] = bidirectional ? std::min(clockwise_distance, anticlockwise_distance) : clockwise_distance;
+    }
+}
+
+#ifdef NETWORK_ANALYTICAL_X86_SIMD
+
+/// 2^52: doubles in [2^52, 2^53) hold integers in their low mantissa bits
+constexpr double two_pow_52 = 4'503'599'627'370'496.0;
+
+/**
+ * AVX2 delay kernel over [0, count - count % 4).
+ * AVX2 lacks uint64 <-> double conversion, so values are converted through the 2^52 trick,
+ * falling back to the scalar kernel for vectors holding values of 2^52 or more.
+ * FMA is not enabled, so results are rounded exactly as in the scalar kernel.
+ */
+__attribute__((target("avx2"))) void compute_delays_avx2(const int* const hops_counts,
+                                                         const ChunkSize* const chunk_sizes,
+                                                         EventTime* const delays,
+                                                         const int count,
+                                                         const Latency latency,
+                                                         const Bandwidth bandwidth_Bpns) noexcept {
+    const auto latency_vector = _mm256_set1_pd(latency);
+    const auto bandwidth_vector = _mm256_set1_pd(bandwidth_Bpns);
+    const auto magic_double = _mm256_set1_pd(two_pow_52);
+    const auto magic_bits = _mm256_castpd_si256(magic_double);
+    const auto high_bits_mask = _mm256_set1_epi64x(~((int64_t{1} << 52) - 1));
+
+    for (auto i = 0; i + 4 <= count; i += 4) {
+        const auto sizes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(chunk_sizes + i));
+
+        // chunk sizes of 2^52 or more: scalar
+        if (!_mm256_testz_si256(sizes, high_bits_mask)) {
+            compute_delays_scalar(hops_counts, chunk_sizes, delays, i, i + 4, latency, bandwidth_Bpns);
+            continue;
+        }
+
+        // hops * latency + size / bandwidth
+        const auto hops = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hops_counts + i)));
+        const auto sizes_double = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(sizes, magic_bits)), magic_double);
+        const auto link_delay = _mm256_mul_pd(hops, latency_vector);
+        const auto serialization_delay = _mm256_div_pd(sizes_double, bandwidth_vector);
+        const auto comms_delay = _mm256_add_pd(link_delay, serialization_delay);
+
+        // delays of 2^52 or more: scalar
+        if (_mm256_movemask_pd(_mm256_cmp_pd(comms_delay, magic_double, _CMP_GE_OQ)) != 0) {
+            compute_delays_scalar(hops_counts, chunk_sizes, delays, i, i + 4, latency, bandwidth_Bpns);
+            continue;
+        }
+
+        // truncate into uint64
+        const auto truncated = _mm256_round_pd(comms_delay, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        const auto delay_bits = _mm256_xor_si256(_mm256_castpd_si256(_mm256_add_pd(truncated, magic_double)), magic_bits);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(delays + i), delay_bits);
+    }
+}
+
+/**
+ * AVX-512 delay kernel over [0, count - count % 8).
+ * Explicitly rounded operations keep the compiler from contracting them into FMAs,
+ * so results are rounded exactly as in the scalar kernel.
+ */
+__attribute__((target("avx512f,avx512dq"))) void compute_delays_avx512(const int* const hops_counts,
+                                                                       const ChunkSize* const chunk_sizes,
+                                                                       EventTime* const delays,
+                                                                       const int count,
+                                                                       const Latency latency,
+                                                                       const Bandwidth bandwidth_Bpns) noexcept {
+    constexpr auto rounding = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC;
+    const auto latency_vector = _mm512_set1_pd(latency);
+    const auto bandwidth_vector = _mm512_set1_pd(bandwidth_Bpns);
+
+    for (auto i = 0; i + 8 <= count; i += 8) {
+        const auto hops = _mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(hops_counts + i)));
+        const auto sizes = _mm512_cvt_roundepu64_pd(_mm512_loadu_si512(chunk_sizes + i), rounding);
+
+        // hops * latency + size / bandwidth
+        const auto link_delay = _mm512_mul_round_pd(hops, latency_vector, rounding);
+        const auto serialization_delay = _mm512_div_round_pd(sizes, bandwidth_vector, rounding);
+        const auto comms_delay = _mm512_add_round_pd(link_delay, serialization_delay, rounding);
+
+        // truncate into uint64
+        _mm512_storeu_si512(delays + i, _mm512_cvtt_roundpd_epu64(comms_delay, _MM_FROUND_NO_EXC));
+    }
+}
+
+/**
+ * AVX2 ring hop count kernel over [0, count - count % 8).
+ */
+__attribute__((target("avx2"))) void compute_ring_hops_counts_avx2(const DeviceId* const srcs,
+                                                                   const DeviceId* const dests,
+                                                                   int* const hops_counts,
+                                                                   const int count,
+                                                                   const int npus_count,
+                                                                   const bool bidirectional) noexcept {
+    const auto zero = _mm256_setzero_si256();
+    const auto npus = _mm256_set1_epi32(npus_count);
+
+    for (auto i = 0; i + 8 <= count; i += 8) {
+        const auto src = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(srcs + i));
+        const auto dest = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dests + i));
+
+        // clockwise distance, wrapped into [1, npus_count)
+        auto clockwise_distance = _mm256_sub_epi32(dest, src);
+        const auto negative = _mm256_cmpgt_epi32(zero, clockwise_distance);
+        clockwise_distance = _mm256_add_epi32(clockwise_distance, _mm256_and_si256(negative, npus));
+
+        // bidirectional: take the shorter direction
+        auto hops = clockwise_distance;
+        if (bidirectional) {
+            hops = _mm256_min_epi32(clockwise_distance, _mm256_sub_epi32(npus, clockwise_distance));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hops_counts + i), hops);
+    }
+}
+
+/**
+ * AVX-512 ring hop count kernel over [0, count - count % 16).
+ */
+__attribute__((target("avx512f"))) void compute_ring_hops_counts_avx512(const DeviceId* const srcs,
+                                                                        const DeviceId* const dests,
+                                                                        int* const hops_counts,
+                                                                        const int count,
+                                                                        const int npus_count,
+                                                                        const bool bidirectional) noexcept {
+    const auto zero = _mm512_setzero_si512();
+    const auto npus = _mm512_set1_epi32(npus_count);
+
+    for (auto i = 0; i + 16 <= count; i += 16) {
+        const auto src = _mm512_loadu_si512(srcs + i);
+        const auto dest = _mm512_loadu_si512(dests + i);
+
+        // clockwise distance, wrapped into [1, npus_count)
+        auto clockwise_distance = _mm512_sub_epi32(dest, src);
+        const auto negative = _mm512_cmplt_epi32_mask(clockwise_distance, zero);
+        clockwise_distance = _mm512_mask_add_epi32(clockwise_distance, negative, clockwise_distance, npus);
+
+        // bidirectional: take the shorter direction
+        auto hops = clockwise_distance;
+        if (bidirectional) {
+            hops = _mm512_min_epi32(clockwise_distance, _mm512_sub_epi32(npus, clockwise_distance));
+        }
+        _mm512_storeu_si512(hops_counts + i, hops);
+    }
+}
+
+#endif
+
+/**
+ * Detect the most capable SIMD level supported by this CPU.
+ */
+SimdLevel detect_simd_level() noexcept {
+#ifdef NETWORK_ANALYTICAL_X86_SIMD
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+
+    return SimdLevel::Scalar;
+}
+
+}  // namespace
+
+SimdLevel DelayKernel::simd_level = detect_simd_level();
+
+SimdLevel DelayKernel::get_simd_level() noexcept {
+    return simd_level;
+}
+
+SimdLevel DelayKernel::get_supported_simd_level() noexcept {
+    return detect_simd_level();
+}
+
+void DelayKernel::set_simd_level(const SimdLevel new_simd_level) noexcept {
+    // clamp to the supported level
+    const auto supported_simd_level = detect_simd_level();
+    const auto clamped_simd_level = std::min(static_cast<int>(new_simd_level), static_cast<int>(supported_simd_level));
+    simd_level = static_cast<SimdLevel>(clamped_simd_level);
+}
+
+void DelayKernel::compute_delays(const int* const hops_counts,
+                                 const ChunkSize* const chunk_sizes,
+                                 EventTime* const delays,
+                                 const int count,
+                                 const Latency latency,
+                                 const Bandwidth bandwidth_Bpns) noexcept {
+    assert(count >= 0);
+    assert(bandwidth_Bpns > 0);
+    assert(latency >= 0);
+
+    // vector kernels process whole vectors, the scalar kernel the rest
+    auto processed_count = 0;
+
+#ifdef NETWORK_ANALYTICAL_X86_SIMD
+    switch (simd_level) {
+    case SimdLevel::AVX512:
+        compute_delays_avx512(hops_counts, chunk_sizes, delays, count, latency, bandwidth_Bpns);
+        processed_count = count - (count % 8);
+        break;
+    case SimdLevel::AVX2:
+        compute_delays_avx2(hops_counts, chunk_sizes, delays, count, latency, bandwidth_Bpns);
+        processed_count = count - (count % 4);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    compute_delays_scalar(hops_counts, chunk_sizes, delays, processed_count, count, latency, bandwidth_Bpns);
+}
+
+void DelayKernel::compute_ring_hops_counts(const DeviceId* const srcs,
+                                           const DeviceId* const dests,
+                                           int* const hops_counts,
+                                           const int count,
+                                           const int npus_count,
+                                           const bool bidirectional) noexcept {
+    assert(count >= 0);
+    assert(npus_count > 0);
+
+    // vector kernels process whole vectors, the scalar kernel the rest
+    auto processed_count = 0;
+
+#ifdef NETWORK_ANALYTICAL_X86_SIMD
+    switch (simd_level) {
+    case SimdLevel::AVX512:
+        compute_ring_hops_counts_avx512(srcs, dests, hops_counts, count, npus_count, bidirectional);
+        processed_count = count - (count % 16);
+        break;
+    case SimdLevel::AVX2:
+        compute_ring_hops_counts_avx2(srcs, dests, hops_counts, count, npus_count, bidirectional);
+        processed_count = count - (count % 8);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    compute_ring_hops_counts_scalar(srcs, dests, hops_counts, processed_count, count, npus_count, bidirectional);
+}
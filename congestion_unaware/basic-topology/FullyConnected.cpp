@@ -4,6 +4,7 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/FullyConnected.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
@@ -27,3 +28,30 @@ int FullyConnected::compute_hops_count(const DeviceId src, const DeviceId dest)
     // for FullyConnected, hops_count is always 1 (src -> dest)
     return 1;
 }
+
+void FullyConnected::compute_hops_counts(const DeviceId* const srcs,
+                                         const DeviceId* const dests,
+                                         int* const hops_counts,
+                                         const int count) const noexcept {
+    // for FullyConnected, hops_count is always 1 (src -> dest)
+    assert(count >= 0);
+    std::fill_n(hops_counts, count, 1);
+}
+
+int FullyConnected::get_links_count() const noexcept {
+    return npus_count * npus_count;
+}
+
+int FullyConnected::get_max_route_links_count() const noexcept {
+    return 1;
+}
+
+int FullyConnected::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // direct link
+    link_ids[0] = src * npus_count + dest;
+    return 1;
+}
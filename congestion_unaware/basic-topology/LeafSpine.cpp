@@ -0,0 +1,159 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/LeafSpine.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+LeafSpine::LeafSpine(const int npus_count,
+                     const int leaf_size,
+                     const double oversubscription,
+                     const Bandwidth bandwidth,
+                     const Latency latency) noexcept
+    : BasicTopology(npus_count, bandwidth, latency),
+      leaf_size(leaf_size),
+      leaves_count(0),
+      oversubscription(oversubscription) {
+    assert(npus_count > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    if (leaf_size <= 0 || oversubscription < 1) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "LeafSpine requires a positive leaf size "
+                  << "and an oversubscription of at least 1, got " << leaf_size << " and " << oversubscription
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    // set the building block type
+    basic_topology_type = TopologyBuildingBlock::FatTree;
+
+    leaves_count = (npus_count + leaf_size - 1) / leaf_size;
+
+    // same units as BasicTopology
+    latency_ticks = latency * static_cast<double>(ticks_per_ns);
+    leaf_bandwidth_Bptick = bw_GBps_to_Bpns(bandwidth) / static_cast<double>(ticks_per_ns);
+    spine_bandwidth_Bptick = leaf_bandwidth_Bptick / oversubscription;
+}
+
+EventTime LeafSpine::send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+    assert(chunk_size > 0);
+
+    return compute_delay(src / leaf_size != dest / leaf_size, chunk_size);
+}
+
+void LeafSpine::send_batch(const DeviceId* const srcs,
+                           const DeviceId* const dests,
+                           const ChunkSize* const chunk_sizes,
+                           EventTime* const delays,
+                           const int count) const noexcept {
+    assert(count >= 0);
+
+    for (auto i = 0; i < count; i++) {
+        delays[i] = compute_delay(srcs[i] / leaf_size != dests[i] / leaf_size, chunk_sizes[i]);
+    }
+}
+
+EventTime LeafSpine::compute_delay(const bool cross_spine, const ChunkSize chunk_size) const noexcept {
+    assert(chunk_size > 0);
+
+    // src -> leaf -> dest, or src -> leaf -> spine -> leaf -> dest at the effective cross-spine bandwidth
+    const auto link_delay = (cross_spine ? 4 : 2) * latency_ticks;
+    const auto serialization_delay =
+        static_cast<double>(chunk_size) / (cross_spine ? spine_bandwidth_Bptick : leaf_bandwidth_Bptick);
+
+    return static_cast<EventTime>(link_delay + serialization_delay);
+}
+
+int LeafSpine::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // 2 hops within a leaf, 4 across the spines
+    return (src / leaf_size == dest / leaf_size) ? 2 : 4;
+}
+
+void LeafSpine::compute_hops_counts(const DeviceId* const srcs,
+                                    const DeviceId* const dests,
+                                    int* const hops_counts,
+                                    const int count) const noexcept {
+    assert(count >= 0);
+
+    for (auto i = 0; i < count; i++) {
+        hops_counts[i] = (srcs[i] / leaf_size == dests[i] / leaf_size) ? 2 : 4;
+    }
+}
+
+int LeafSpine::get_links_count() const noexcept {
+    return 2 * npus_count + 2 * leaves_count;
+}
+
+Bandwidth LeafSpine::get_link_bandwidth(const int link_id) const noexcept {
+    assert(0 <= link_id && link_id < get_links_count());
+
+    // NPU links
+    const auto bandwidth = bandwidth_per_dim[0];
+    if (link_id < 2 * npus_count) {
+        return bandwidth;
+    }
+
+    // leaf-spine links carry the whole leaf at the oversubscribed bandwidth
+    return leaf_size * bandwidth / oversubscription;
+}
+
+int LeafSpine::get_max_route_links_count() const noexcept {
+    return 4;
+}
+
+int LeafSpine::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    const auto src_leaf = src / leaf_size;
+    const auto dest_leaf = dest / leaf_size;
+
+    // src -> leaf -> dest
+    if (src_leaf == dest_leaf) {
+        link_ids[0] = src;
+        link_ids[1] = npus_count + dest;
+        return 2;
+    }
+
+    // src -> leaf -> spine -> leaf -> dest
+    link_ids[0] = src;
+    link_ids[1] = 2 * npus_count + src_leaf;
+    link_ids[2] = 2 * npus_count + leaves_count + dest_leaf;
+    link_ids[3] = npus_count + dest;
+    return 4;
+}
+
+int LeafSpine::get_leaf_size() const noexcept {
+    return leaf_size;
+}
+
+int LeafSpine::get_leaves_count() const noexcept {
+    return leaves_count;
+}
+
+double LeafSpine::get_oversubscription() const noexcept {
+    return oversubscription;
+}
+
+int LeafSpine::get_leaf(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    return npu_id / leaf_size;
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/Mesh2D.h"
+#include <cassert>
+#include <cstdlib>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+Mesh2D::Mesh2D(const int width, const int height, const Bandwidth bandwidth, const Latency latency) noexcept
+    : width(width),
+      height(height),
+      BasicTopology(width * height, bandwidth, latency) {
+    assert(width > 0);
+    assert(height > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // set the building block type
+    basic_topology_type = TopologyBuildingBlock::Mesh2D;
+}
+
+int Mesh2D::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // for Mesh2D topology, Manhattan distance
+    return std::abs((dest % width) - (src % width)) + std::abs((dest / width) - (src / width));
+}
+
+void Mesh2D::compute_hops_counts(const DeviceId* const srcs,
+                                 const DeviceId* const dests,
+                                 int* const hops_counts,
+                                 const int count) const noexcept {
+    assert(count >= 0);
+
+    // same as compute_hops_count, as a tight loop
+    for (auto i = 0; i < count; i++) {
+        assert(0 <= srcs[i] && srcs[i] < npus_count);
+        assert(0 <= dests[i] && dests[i] < npus_count);
+        assert(srcs[i] != dests[i]);
+
+        hops_counts[i] = std::abs((dests[i] % width) - (srcs[i] % width)) +
+                         std::abs((dests[i] / width) - (srcs[i] / width));
+    }
+}
+
+int Mesh2D::get_links_count() const noexcept {
+    return 4 * npus_count;
+}
+
+int Mesh2D::get_max_route_links_count() const noexcept {
+    return (width - 1) + (height - 1);
+}
+
+int Mesh2D::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // XY routing: along X to the dest column, then along Y
+    auto links_count = 0;
+    auto current = src;
+    while (current % width != dest % width) {
+        const auto increasing = (current % width) < (dest % width);
+        link_ids[links_count++] = (increasing ? 0 : 1) * npus_count + current;
+        current += increasing ? 1 : -1;
+    }
+    while (current != dest) {
+        const auto increasing = current < dest;
+        link_ids[links_count++] = (increasing ? 2 : 3) * npus_count + current;
+        current += increasing ? width : -width;
+    }
+    return links_count;
+}
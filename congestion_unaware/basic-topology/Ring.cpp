@@ -4,6 +4,9 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/Ring.h"
+#include "common/NetworkFunction.h"
+#include "congestion_unaware/DelayKernel.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
@@ -20,6 +23,24 @@ Ring::Ring(const int npus_count, const Bandwidth bandwidth, const Latency latenc
     basic_topology_type = TopologyBuildingBlock::Ring;
 }
 
+EventTime Ring::send_striped(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+    assert(chunk_size > 0);
+
+    // the longer way takes the smaller stripe, if any
+    const auto hops_count = compute_hops_count(src, dest);
+    const auto stripe_size = bidirectional ? ring_stripe_size(chunk_size, hops_count, npus_count - hops_count) : 0;
+    if (stripe_size == 0 || stripe_size == chunk_size) {
+        return compute_communication_delay(hops_count, chunk_size);
+    }
+
+    // the transfer arrives with its slower stripe
+    return std::max(compute_communication_delay(hops_count, stripe_size),
+                    compute_communication_delay(npus_count - hops_count, chunk_size - stripe_size));
+}
+
 int Ring::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
     assert(0 <= src && src < npus_count);
     assert(0 <= dest && dest < npus_count);
@@ -47,3 +68,44 @@ int Ring::compute_hops_count(const DeviceId src, const DeviceId dest) const noex
     // bidirectional: return shorter distance
     return (clockwise_distance < anticlockwise_distance) ? clockwise_distance : anticlockwise_distance;
 }
+
+void Ring::compute_hops_counts(const DeviceId* const srcs,
+                               const DeviceId* const dests,
+                               int* const hops_counts,
+                               const int count) const noexcept {
+    // same as compute_hops_count, vectorized
+    DelayKernel::compute_ring_hops_counts(srcs, dests, hops_counts, count, npus_count, bidirectional);
+}
+
+int Ring::get_links_count() const noexcept {
+    return bidirectional ? 2 * npus_count : npus_count;
+}
+
+int Ring::get_max_route_links_count() const noexcept {
+    return bidirectional ? npus_count / 2 : npus_count - 1;
+}
+
+int Ring::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // same direction as compute_hops_count
+    auto clockwise_distance = (dest - src);
+    if (clockwise_distance < 0) {
+        clockwise_distance += npus_count;
+    }
+    const auto anticlockwise_distance = npus_count - clockwise_distance;
+
+    if (!bidirectional || clockwise_distance < anticlockwise_distance) {
+        for (auto hop = 0; hop < clockwise_distance; hop++) {
+            link_ids[hop] = (src + hop) % npus_count;
+        }
+        return clockwise_distance;
+    }
+
+    for (auto hop = 0; hop < anticlockwise_distance; hop++) {
+        link_ids[hop] = npus_count + (src - hop + npus_count) % npus_count;
+    }
+    return anticlockwise_distance;
+}
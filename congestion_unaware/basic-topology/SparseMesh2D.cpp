@@ -0,0 +1,221 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/SparseMesh2D.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// distance of the cells a BFS hasn't reached
+constexpr auto unreached = std::numeric_limits<uint16_t>::max();
+
+}  // namespace
+
+SparseMesh2D::SparseMesh2D(const int width,
+                           const int height,
+                           const std::vector<bool>& valid_cells,
+                           const Bandwidth bandwidth,
+                           const Latency latency) noexcept
+    : SparseMesh2D(width, height, valid_cells, std::vector<int>(), bandwidth, latency) {}
+
+SparseMesh2D::SparseMesh2D(const int width,
+                           const int height,
+                           const std::vector<bool>& valid_cells,
+                           const std::vector<int>& npu_placement_grid,
+                           const Bandwidth bandwidth,
+                           const Latency latency) noexcept
+    : width(width),
+      height(height),
+      BasicTopology(count_valid_cells(width, height, valid_cells), bandwidth, latency) {
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+    assert(npu_placement_grid.empty() || npu_placement_grid.size() == valid_cells.size());
+
+    // set the building block type
+    basic_topology_type = TopologyBuildingBlock::SparseMesh2D;
+
+    build(valid_cells, npu_placement_grid);
+}
+
+int SparseMesh2D::get_npu_cell(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
+
+    return npu_to_cell[npu_id];
+}
+
+uint64_t SparseMesh2D::get_distance_matrix_bytes() const noexcept {
+    return distances.capacity() * sizeof(uint16_t);
+}
+
+int SparseMesh2D::count_valid_cells(const int width, const int height, const std::vector<bool>& valid_cells) noexcept {
+    assert(width > 0);
+    assert(height > 0);
+
+    if (valid_cells.size() != static_cast<size_t>(width) * height) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "SparseMesh2D valid cells bitmap has "
+                  << valid_cells.size() << " cells, expected " << width << " x " << height << std::endl;
+        std::exit(-1);
+    }
+
+    return static_cast<int>(std::count(valid_cells.begin(), valid_cells.end(), true));
+}
+
+void SparseMesh2D::build(const std::vector<bool>& valid_cells, const std::vector<int>& npu_placement_grid) noexcept {
+    const auto cells_count = width * height;
+
+    // shortest paths visit each NPU at most once, so they fit in 16 bits below this size
+    if (npus_count >= unreached) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "SparseMesh2D supports up to "
+                  << (unreached - 1) << " NPUs, got " << npus_count << std::endl;
+        std::exit(-1);
+    }
+
+    // apply the custom placement, skipping the invalid entries (as the congestion-aware SparseMesh2D does)
+    cell_to_npu.assign(cells_count, -1);
+    auto npu_id_used = std::vector<bool>(npus_count, false);
+    npu_to_cell.assign(npus_count, -1);
+    for (auto cell = 0; cell < static_cast<int>(npu_placement_grid.size()); cell++) {
+        const auto npu_id = npu_placement_grid[cell];
+        if (npu_id == -1) {
+            continue;
+        }
+        if (!valid_cells[cell] || npu_id < 0 || npu_id >= npus_count || npu_id_used[npu_id]) {
+            std::cerr << "[Warning] (network/analytical/congestion_unaware) " << "ignoring SparseMesh2D placement ("
+                      << (cell % width) << ", " << (cell / width) << ") -> " << npu_id << std::endl;
+            continue;
+        }
+        cell_to_npu[cell] = npu_id;
+        npu_to_cell[npu_id] = cell;
+        npu_id_used[npu_id] = true;
+    }
+
+    // number the remaining valid cells in row-major order, with the lowest unused IDs
+    auto next_npu_id = 0;
+    for (auto cell = 0; cell < cells_count; cell++) {
+        if (!valid_cells[cell] || cell_to_npu[cell] >= 0) {
+            continue;
+        }
+        while (npu_id_used[next_npu_id]) {
+            next_npu_id++;
+        }
+        cell_to_npu[cell] = next_npu_id;
+        npu_to_cell[next_npu_id] = cell;
+        npu_id_used[next_npu_id] = true;
+    }
+
+    // BFS from each NPU over the valid cells
+    distances.assign(static_cast<size_t>(npus_count) * npus_count, unreached);
+    auto cell_distances = std::vector<uint16_t>(cells_count);
+    auto frontier = std::vector<int>();
+    frontier.reserve(cells_count);
+    for (auto src = 0; src < npus_count; src++) {
+        std::fill(cell_distances.begin(), cell_distances.end(), unreached);
+        frontier.clear();
+        cell_distances[npu_to_cell[src]] = 0;
+        frontier.push_back(npu_to_cell[src]);
+
+        // the frontier vector doubles as the BFS queue
+        for (size_t head = 0; head < frontier.size(); head++) {
+            const auto cell = frontier[head];
+            const auto x = cell % width;
+            const auto y = cell / width;
+            const int neighbors[4] = {(x > 0) ? cell - 1 : -1, (x + 1 < width) ? cell + 1 : -1,
+                                      (y > 0) ? cell - width : -1, (y + 1 < height) ? cell + width : -1};
+            for (const auto neighbor : neighbors) {
+                if (neighbor < 0 || !valid_cells[neighbor] || cell_distances[neighbor] != unreached) {
+                    continue;
+                }
+                cell_distances[neighbor] = cell_distances[cell] + 1;
+                frontier.push_back(neighbor);
+            }
+        }
+
+        // every NPU should be reachable
+        if (static_cast<int>(frontier.size()) != npus_count) {
+            std::cerr << "[Error] (network/analytical/congestion_unaware) " << "SparseMesh2D NPU " << src
+                      << " reaches only " << frontier.size() << " of " << npus_count << " NPUs" << std::endl;
+            std::exit(-1);
+        }
+
+        auto* const src_distances = &distances[static_cast<size_t>(src) * npus_count];
+        for (auto dest = 0; dest < npus_count; dest++) {
+            src_distances[dest] = cell_distances[npu_to_cell[dest]];
+        }
+    }
+}
+
+int SparseMesh2D::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // for SparseMesh2D topology, precomputed shortest distance
+    return distances[static_cast<size_t>(src) * npus_count + dest];
+}
+
+void SparseMesh2D::compute_hops_counts(const DeviceId* const srcs,
+                                       const DeviceId* const dests,
+                                       int* const hops_counts,
+                                       const int count) const noexcept {
+    assert(count >= 0);
+
+    // same as compute_hops_count, as a tight loop of lookups
+    for (auto i = 0; i < count; i++) {
+        assert(0 <= srcs[i] && srcs[i] < npus_count);
+        assert(0 <= dests[i] && dests[i] < npus_count);
+        assert(srcs[i] != dests[i]);
+
+        hops_counts[i] = distances[static_cast<size_t>(srcs[i]) * npus_count + dests[i]];
+    }
+}
+
+int SparseMesh2D::get_links_count() const noexcept {
+    return 4 * width * height;
+}
+
+int SparseMesh2D::get_max_route_links_count() const noexcept {
+    return npus_count - 1;
+}
+
+int SparseMesh2D::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // walk down the distances to dest, trying +X, -X, +Y, then -Y
+    const auto cells_count = width * height;
+    auto links_count = 0;
+    auto current_cell = npu_to_cell[src];
+    auto distance = static_cast<int>(distances[static_cast<size_t>(src) * npus_count + dest]);
+    while (distance > 0) {
+        const auto x = current_cell % width;
+        const auto y = current_cell / width;
+        const int neighbors[4] = {(x + 1 < width) ? current_cell + 1 : -1, (x > 0) ? current_cell - 1 : -1,
+                                  (y + 1 < height) ? current_cell + width : -1, (y > 0) ? current_cell - width : -1};
+        for (auto direction = 0; direction < 4; direction++) {
+            const auto neighbor = neighbors[direction];
+            if (neighbor < 0 || cell_to_npu[neighbor] < 0) {
+                continue;
+            }
+            const auto neighbor_npu = cell_to_npu[neighbor];
+            if (distances[static_cast<size_t>(neighbor_npu) * npus_count + dest] == distance - 1) {
+                link_ids[links_count++] = direction * cells_count + current_cell;
+                current_cell = neighbor;
+                distance--;
+                break;
+            }
+        }
+    }
+
+    assert(current_cell == npu_to_cell[dest]);
+    return links_count;
+}
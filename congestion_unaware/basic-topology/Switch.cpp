@@ -4,6 +4,7 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/Switch.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace NetworkAnalytical;
@@ -27,3 +28,31 @@ int Switch::compute_hops_count(const DeviceId src, const DeviceId dest) const no
     // for switch, hops_count is always 2 (src -> switch -> dest)
     return 2;
 }
+
+void Switch::compute_hops_counts(const DeviceId* const srcs,
+                                 const DeviceId* const dests,
+                                 int* const hops_counts,
+                                 const int count) const noexcept {
+    // for switch, hops_count is always 2 (src -> switch -> dest)
+    assert(count >= 0);
+    std::fill_n(hops_counts, count, 2);
+}
+
+int Switch::get_links_count() const noexcept {
+    return 2 * npus_count;
+}
+
+int Switch::get_max_route_links_count() const noexcept {
+    return 2;
+}
+
+int Switch::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // src -> switch -> dest
+    link_ids[0] = src;
+    link_ids[1] = npus_count + dest;
+    return 2;
+}
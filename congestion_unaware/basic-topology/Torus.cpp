@@ -0,0 +1,119 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/Torus.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+Torus::Torus(const int width, const int height, const Bandwidth bandwidth, const Latency latency) noexcept
+    : Torus(width, height, 1, bandwidth, latency) {}
+
+Torus::Torus(const int width,
+             const int height,
+             const int depth,
+             const Bandwidth bandwidth,
+             const Latency latency) noexcept
+    : sizes({width, height, depth}),
+      BasicTopology(width * height * depth, bandwidth, latency) {
+    assert(width > 0);
+    assert(height > 0);
+    assert(depth > 0);
+    assert(bandwidth > 0);
+    assert(latency >= 0);
+
+    // set the building block type
+    basic_topology_type = (depth > 1) ? TopologyBuildingBlock::Torus3D : TopologyBuildingBlock::Torus2D;
+}
+
+int Torus::compute_hops_count(const DeviceId src, const DeviceId dest) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // for Torus topology, sum the shorter way around the ring of each dimension
+    auto hops_count = 0;
+    auto src_rest = src;
+    auto dest_rest = dest;
+    for (const auto size : sizes) {
+        const auto distance = std::abs((dest_rest % size) - (src_rest % size));
+        hops_count += std::min(distance, size - distance);
+        src_rest /= size;
+        dest_rest /= size;
+    }
+    return hops_count;
+}
+
+void Torus::compute_hops_counts(const DeviceId* const srcs,
+                                const DeviceId* const dests,
+                                int* const hops_counts,
+                                const int count) const noexcept {
+    assert(count >= 0);
+
+    // same as compute_hops_count, one dimension at a time over the whole batch
+    const auto width = sizes[0];
+    const auto plane_size = sizes[0] * sizes[1];
+    for (auto i = 0; i < count; i++) {
+        assert(0 <= srcs[i] && srcs[i] < npus_count);
+        assert(0 <= dests[i] && dests[i] < npus_count);
+        assert(srcs[i] != dests[i]);
+
+        const auto distance = std::abs((dests[i] % width) - (srcs[i] % width));
+        hops_counts[i] = std::min(distance, width - distance);
+    }
+    for (auto i = 0; i < count; i++) {
+        const auto distance = std::abs(((dests[i] % plane_size) / width) - ((srcs[i] % plane_size) / width));
+        hops_counts[i] += std::min(distance, sizes[1] - distance);
+    }
+    for (auto i = 0; i < count && sizes[2] > 1; i++) {
+        const auto distance = std::abs((dests[i] / plane_size) - (srcs[i] / plane_size));
+        hops_counts[i] += std::min(distance, sizes[2] - distance);
+    }
+}
+
+int Torus::get_links_count() const noexcept {
+    return 2 * max_torus_dims * npus_count;
+}
+
+int Torus::get_max_route_links_count() const noexcept {
+    return (sizes[0] / 2) + (sizes[1] / 2) + (sizes[2] / 2);
+}
+
+int Torus::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(src != dest);
+
+    // dimension by dimension, the shorter way around each ring (as compute_hops_count)
+    auto links_count = 0;
+    auto current = src;
+    auto stride = 1;
+    for (auto dim = 0; dim < max_torus_dims; dim++) {
+        const auto size = sizes[dim];
+        const auto src_coord = (current / stride) % size;
+        const auto dest_coord = (dest / stride) % size;
+        auto up_distance = dest_coord - src_coord;
+        if (up_distance < 0) {
+            up_distance += size;
+        }
+        const auto increasing = (up_distance <= size - up_distance);
+        const auto hops_count = increasing ? up_distance : size - up_distance;
+
+        auto coord = src_coord;
+        for (auto hop = 0; hop < hops_count; hop++) {
+            link_ids[links_count++] = (dim * 2 + (increasing ? 0 : 1)) * npus_count + current;
+            const auto next_coord = increasing ? (coord + 1) % size : (coord - 1 + size) % size;
+            current += (next_coord - coord) * stride;
+            coord = next_coord;
+        }
+        stride *= size;
+    }
+
+    assert(current == dest);
+    return links_count;
+}
@@ -3,28 +3,169 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/CommandLine.h"
+#include "common/EventQueue.h"
+#include "common/ExecutionTrace.h"
+#include "common/JsonObject.h"
 #include "common/NetworkParser.h"
+#include "common/ResultCache.h"
+#include "common/TimeBase.h"
+#include "congestion_unaware/ExecutionTraceAdapter.h"
 #include "congestion_unaware/Helper.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
-int main() {
+namespace {
+
+/// usage of the driver
+constexpr const char* usage = R"(Usage: Analytical_Congestion_Unaware [options]
+Computes the time of a workload on a network and prints the results as JSON.
+
+Network:
+  --network PATH           network config (default: ../input/Ring_FullyConnected_Switch.yml)
+
+Workload (a send-recv unless a collective or trace is given):
+  --src NPU                src of the send-recv (default: 3)
+  --dest NPU               dest of the send-recv (default: 19)
+  --collective TYPE        ring collective: AllGather, ReduceScatter, AllReduce, or AllToAll
+  --size BYTES             send-recv or collective size (default: 1048576)
+  --execution-trace PREFIX execution traces PREFIX.<NPU>.txt to replay (see ExecutionTraceReader)
+
+Engine:
+  --event-queue TYPE       List, Heap (default), or TimingWheel (execution traces only)
+
+Output:
+  --output PATH            JSON results file (default: stdout)
+  --cache DIR              result cache: a workload computed before on the same network is read from it)";
+
+/// seconds elapsed since a start time
+double seconds_since(const std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(const int argc, const char* const argv[]) {
+    const auto command_line = CommandLine(argc, argv,
+                                          {"network", "src", "dest", "collective", "size", "execution-trace",
+                                           "event-queue", "output", "cache"},
+                                          usage);
+    const auto network_path = command_line.get_string("network", "../input/Ring_FullyConnected_Switch.yml");
+    const auto output_path = command_line.get_string("output", "");
+    const auto size = command_line.get_uint64("size", 1'048'576);  // 1 MB
+
     // Parse network config and create topology
-    const auto network_parser = NetworkParser("../input/Ring_FullyConnected_Switch.yml");
+    const auto setup_start = std::chrono::steady_clock::now();
+    const auto network_parser = NetworkParser(network_path);
     const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+    const auto setup_seconds = seconds_since(setup_start);
+
+    // Describe the workload (also keying the result cache)
+    auto workload = JsonObject();
+    const auto trace_prefix = command_line.get_string("execution-trace", "");
+    auto trace_paths = std::vector<std::string>();
+    const auto src = static_cast<DeviceId>(command_line.get_uint64("src", 3));
+    const auto dest = static_cast<DeviceId>(command_line.get_uint64("dest", 19));
+    if (!trace_prefix.empty()) {
+        workload.add("type", "execution_trace").add("prefix", trace_prefix);
+        auto contents_hashes = JsonObject();
+        for (auto npu = 0; npu < npus_count; npu++) {
+            trace_paths.push_back(trace_prefix + "." + std::to_string(npu) + ".txt");
+            contents_hashes.add(std::to_string(npu), ResultCache::hash_file(trace_paths.back()));
+        }
+        workload.add("contents_hashes", contents_hashes);
+    } else if (command_line.has("collective")) {
+        workload.add("type", "collective").add("collective", command_line.get_string("collective", ""));
+        workload.add("algorithm", "Ring").add("size", size);
+    } else {
+        if (src >= npus_count || dest >= npus_count) {
+            std::cerr << "[Error] (network/analytical/congestion_unaware) " << "NPU ID out of range [0, "
+                      << npus_count << ")" << std::endl;
+            std::exit(-1);
+        }
+        workload.add("type", "send").add("src", src).add("dest", dest).add("size", size);
+    }
+
+    // Compute the time of the workload
+    auto simulation_seconds = 0.0;
+    const auto simulate = [&]() {
+        auto result = CachedResult();
+        const auto simulation_start = std::chrono::steady_clock::now();
+        if (!trace_prefix.empty()) {
+            // Replay an execution trace per NPU
+            const auto event_queue = std::make_shared<EventQueue>(
+                command_line.get_event_queue_type("event-queue", EventQueueType::Heap));
+            auto network = ExecutionTraceAdapter(topology, event_queue);
+            auto replay = ExecutionTraceReplay(network, trace_paths);
+            replay.start();
+            event_queue->run_to_completion();
+            if (!replay.finished()) {
+                std::cerr << "[Error] (network/analytical/congestion_unaware) " << "Execution traces of "
+                          << trace_prefix << " stalled" << std::endl;
+                std::exit(-1);
+            }
+            result.finish_time = replay.get_finish_time();
+            result.stats["nodes_completed"] = replay.get_completed_nodes_count();
+
+            // Event statistics (if collected)
+            if constexpr (stats_enabled) {
+                result.stats["events_processed"] = event_queue->get_stats().events_processed;
+            }
+        } else if (command_line.has("collective")) {
+            // Compute the cost of a ring collective
+            const auto collective_type = command_line.get_collective_type("collective", CollectiveType::AllGather);
+            const auto network = ExecutionTraceAdapter(topology, std::make_shared<EventQueue>());
+            result.finish_time = network.compute_collective_cost(collective_type, size);
+        } else {
+            // Run sample send-recv
+            result.finish_time = topology->send(src, dest, size);
+        }
+        simulation_seconds = seconds_since(simulation_start);
+        return result;
+    };
 
-    // message settings
-    const auto chunk_size = 1'048'576;  // 1 MB
+    // Read the result from the cache if computed before
+    auto result = CachedResult();
+    auto cached = false;
+    if (command_line.has("cache")) {
+        auto result_cache = ResultCache(command_line.get_string("cache", ""));
+        result = result_cache.get_or_simulate(ResultCache::make_key(network_parser, workload.str()), simulate);
+        cached = (result_cache.get_hits_count() > 0);
+    } else {
+        result = simulate();
+    }
 
-    // Print basic-topology information
-    std::cout << "Total NPUs Count: " << topology->get_npus_count() << std::endl;
+    // Report result
+    const auto finish_time = result.finish_time;
+    auto results = JsonObject();
+    results.add("backend", "congestion_unaware").add("network", network_path).add("workload", workload);
+    results.add("npus_count", npus_count);
+    results.add("finish_time", finish_time).add("time_unit", time_unit).add("finish_time_ns", ticks_to_ns(finish_time));
+    for (const auto& [name, value] : result.stats) {
+        results.add(name, value);
+    }
+    results.add("cached", cached).add("setup_seconds", setup_seconds).add("simulation_seconds", simulation_seconds);
+    results.add("stats_enabled", stats_enabled);
 
-    // Run sample send-recv
-    const auto comm_delay = topology->send(3, 19, chunk_size);
-    std::cout << "comm_delay: " << comm_delay << std::endl;
+    if (output_path.empty()) {
+        std::cout << results.str() << std::endl;
+    } else {
+        auto output_file = std::ofstream(output_path);
+        if (!(output_file << results.str() << std::endl)) {
+            std::cerr << "[Error] (network/analytical/congestion_unaware) " << "Cannot write " << output_path
+                      << std::endl;
+            std::exit(-1);
+        }
+    }
 
-    // terminate
     return 0;
 }
@@ -4,14 +4,18 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/MultiDimTopology.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iostream>
+#include <numeric>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
-MultiDimTopology::MultiDimTopology() noexcept : Topology() {
+MultiDimTopology::MultiDimTopology() noexcept : dim_pipelining(true), Topology() {
     // initialize values
     topology_per_dim.clear();
     npus_count_per_dim = {};
@@ -22,29 +26,178 @@ MultiDimTopology::MultiDimTopology() noexcept : Topology() {
 }
 
 EventTime MultiDimTopology::send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
+    assert(chunk_size > 0);
+
     // translate src and dest to multi-dim address
     const auto src_address = translate_address(src);
     const auto dest_address = translate_address(dest);
 
-    // get dim to transfer
-    const auto dim_to_transfer = get_dim_to_transfer(src_address, dest_address);
+    // route through every dimension where the addresses differ
+    return compute_transfer_delay(src_address, dest_address, chunk_size,
+                                  [this](const int dim, const DeviceId src_local_id, const DeviceId dest_local_id) {
+                                      return topology_per_dim[dim]->get_hops_count(src_local_id, dest_local_id);
+                                  });
+}
+
+void MultiDimTopology::send_batch(const DeviceId* const srcs,
+                                  const DeviceId* const dests,
+                                  const ChunkSize* const chunk_sizes,
+                                  EventTime* const delays,
+                                  const int count) const noexcept {
+    assert(count >= 0);
 
-    // prepare localized topology and address info
-    auto* const topology = topology_per_dim[dim_to_transfer].get();
-    const auto src_local_id = src_address[dim_to_transfer];
-    const auto dest_local_id = dest_address[dim_to_transfer];
+    // addresses are fixed-size arrays, so no chunk allocates
+    for (auto i = 0; i < count; i++) {
+        delays[i] = MultiDimTopology::send(srcs[i], dests[i], chunk_sizes[i]);
+    }
+}
 
-    // run localized communication
-    const auto comms_delay = topology->send(src_local_id, dest_local_id, chunk_size);
+std::vector<EventTime> MultiDimTopology::compute_delay_matrix(const ChunkSize chunk_size,
+                                                             const int threads_count) const noexcept {
+    assert(chunk_size > 0);
+    assert(threads_count >= 0);
 
-    // return communication delay
-    return comms_delay;
+    // hop matrix of each dimension
+    auto hops_matrix_per_dim = std::vector<std::vector<int>>();
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto dim_size = npus_count_per_dim[dim];
+        auto hops_matrix = std::vector<int>(static_cast<size_t>(dim_size) * dim_size, 0);
+        for (auto src = 0; src < dim_size; src++) {
+            for (auto dest = 0; dest < dim_size; dest++) {
+                if (src != dest) {
+                    hops_matrix[src * dim_size + dest] = topology_per_dim[dim]->get_hops_count(src, dest);
+                }
+            }
+        }
+        hops_matrix_per_dim.push_back(std::move(hops_matrix));
+    }
+
+    auto delay_matrix = std::vector<EventTime>(static_cast<size_t>(npus_count) * npus_count, 0);
+
+    // combine: (src, dest) traverses every dimension where the addresses differ
+    const auto hops_count_of = [&](const int dim, const DeviceId src_local_id, const DeviceId dest_local_id) {
+        return hops_matrix_per_dim[dim][src_local_id * npus_count_per_dim[dim] + dest_local_id];
+    };
+    for_each_delay_matrix_row(threads_count, [&](const DeviceId src) {
+        const auto src_address = translate_address(src);
+        auto* const row = &delay_matrix[static_cast<size_t>(src) * npus_count];
+
+        for (auto dest = 0; dest < npus_count; dest++) {
+            row[dest] = compute_transfer_delay(src_address, translate_address(dest), chunk_size, hops_count_of);
+        }
+    });
+
+    return delay_matrix;
+}
+
+EventTime MultiDimTopology::compute_ring_all_reduce_cost(const ChunkSize all_reduce_size) const noexcept {
+    assert(all_reduce_size > 0);
+
+    if (npus_count == 1) {
+        return 0;
+    }
+
+    // every step is bound by the slowest dimension the ring crosses
+    const auto message_size = static_cast<double>(all_reduce_size) / npus_count;
+    auto step_delay = 0.0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (npus_count_per_dim[dim] > 1) {
+            const auto delay =
+                neighbor_link_delay_per_dim[dim] + (message_size * serialization_delay_per_byte_per_dim[dim]);
+            step_delay = std::max(step_delay, delay);
+        }
+    }
+
+    return ns_to_ticks(2 * (npus_count - 1) * step_delay);
+}
+
+EventTime MultiDimTopology::compute_hierarchical_all_reduce_cost(const ChunkSize all_reduce_size) const noexcept {
+    return compute_hierarchical_collective_cost(CollectiveType::AllReduce, all_reduce_size);
+}
+
+EventTime MultiDimTopology::compute_hierarchical_collective_cost(const CollectiveType collective_type,
+                                                                 const ChunkSize collective_size,
+                                                                 const int chunks_count) const noexcept {
+    assert(collective_size > 0);
+    assert(chunks_count > 0);
+
+    if (collective_type == CollectiveType::AllToAll) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) "
+                  << "hierarchical collectives do not support AllToAll" << std::endl;
+        std::exit(-1);
+    }
+
+    // Reduce-Scatter and All-Gather each cross every dimension once
+    const auto phases_count = (collective_type == CollectiveType::AllReduce) ? 2 : 1;
+
+    // each dimension works on the shard left by the lower ones, chunk by chunk
+    auto chunk_size = static_cast<double>(collective_size) / chunks_count;
+    auto chunk_cost = 0.0;
+    auto busiest_dim_cost = 0.0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto dim_size = npus_count_per_dim[dim];
+        chunk_size /= dim_size;
+
+        const auto serialization_delay = chunk_size * serialization_delay_per_byte_per_dim[dim];
+        chunk_cost += phases_count * (dim_size - 1) * (neighbor_link_delay_per_dim[dim] + serialization_delay);
+        busiest_dim_cost = std::max(busiest_dim_cost, phases_count * (dim_size - 1) * serialization_delay);
+    }
+
+    return ns_to_ticks(chunk_cost + ((chunks_count - 1) * busiest_dim_cost));
+}
+
+EventTime MultiDimTopology::compute_all_to_all_cost(const ChunkSize all_to_all_size) const noexcept {
+    assert(all_to_all_size > 0);
+
+    // every peer differing in dim crosses the links of dim: (N / dim_size) peers per local address
+    const auto message_size = static_cast<double>(all_to_all_size) / npus_count;
+    auto cost = 0.0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        cost += (npus_count / npus_count_per_dim[dim]) * peers_link_delay_per_dim[dim];
+    }
+
+    // stored and forwarded: every differing dimension serializes the message
+    if (!dim_pipelining) {
+        for (auto dim = 0; dim < dims_count; dim++) {
+            const auto dim_size = npus_count_per_dim[dim];
+            cost += (npus_count / dim_size) * (dim_size - 1) * message_size * serialization_delay_per_byte_per_dim[dim];
+        }
+        return ns_to_ticks(cost);
+    }
+
+    // pipelined: the slowest differing dimension serializes the message,
+    // i.e., dims from the slowest, each for the peers matching every slower dimension
+    auto dims_by_serialization = std::array<int, max_dims_count>();
+    std::iota(dims_by_serialization.begin(), dims_by_serialization.begin() + dims_count, 0);
+    std::stable_sort(dims_by_serialization.begin(), dims_by_serialization.begin() + dims_count,
+                     [&serialization_delays = serialization_delay_per_byte_per_dim](const int dim_a, const int dim_b) {
+                         return serialization_delays[dim_a] > serialization_delays[dim_b];
+                     });
+    auto remaining_npus_count = npus_count;
+    for (auto i = 0; i < dims_count; i++) {
+        const auto dim = dims_by_serialization[i];
+        const auto dim_size = npus_count_per_dim[dim];
+        remaining_npus_count /= dim_size;
+        cost += remaining_npus_count * (dim_size - 1) * message_size * serialization_delay_per_byte_per_dim[dim];
+    }
+
+    return ns_to_ticks(cost);
 }
 
 void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology) noexcept {
+    // check the number of dimensions
+    if (dims_count >= max_dims_count) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "at most " << max_dims_count
+                  << " dimensions are supported" << std::endl;
+        std::exit(-1);
+    }
+
     // increment dims_count
     dims_count++;
 
+    // the stride of the new dimension is the size of the lower dimensions
+    stride_per_dim.push_back(npus_count);
+
     // increase npus_count
     const auto topology_size = topology->get_npus_count();
     npus_count *= topology_size;
@@ -53,37 +206,63 @@ void MultiDimTopology::append_dimension(std::unique_ptr<BasicTopology> topology)
     const auto bandwidth = topology->get_bandwidth_per_dim()[0];
     bandwidth_per_dim.push_back(bandwidth);
 
+    // cost model coefficients for closed-form collectives
+    const auto latency = topology->get_latency();
+    auto peers_link_delay = 0.0;
+    for (auto peer = 1; peer < topology_size; peer++) {
+        peers_link_delay += topology->get_hops_count(0, peer) * latency;
+    }
+    neighbor_link_delay_per_dim.push_back((topology_size > 1) ? topology->get_hops_count(0, 1) * latency : 0.0);
+    peers_link_delay_per_dim.push_back(peers_link_delay);
+    serialization_delay_per_byte_per_dim.push_back(1.0 / bw_GBps_to_Bpns(bandwidth));
+    latency_ticks_per_dim.push_back(latency * static_cast<double>(ticks_per_ns));
+    bandwidth_Bptick_per_dim.push_back(bw_GBps_to_Bpns(bandwidth) / static_cast<double>(ticks_per_ns));
+
     // push back topology and npus_count
+    dim_topology_pointers.push_back(topology.get());
     topology_per_dim.push_back(std::move(topology));
     npus_count_per_dim.push_back(topology_size);
+
+    // precompute addresses
+    build_address_table();
 }
 
-MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
-    // If units-count if [2, 8, 4], and the given id is 47, then the id should be
-    // 47 // 16 = 2, leftover = 47 % 16 = 15
-    // 15 // 2 = 7, leftover = 15 % 2 = 1
-    // 1 // 1 = 1, leftover = 0
-    // therefore the address is [1, 7, 2]
+void MultiDimTopology::build_address_table() noexcept {
+    address_table.clear();
 
-    // create empty address
-    auto multi_dim_address = MultiDimAddress();
-    for (auto i = 0; i < dims_count; i++) {
-        multi_dim_address.push_back(-1);
+    // too many NPUs: decode addresses on the fly
+    if (npus_count > address_table_max_npus_count) {
+        address_table.shrink_to_fit();
+        return;
     }
 
-    auto leftover = npu_id;
-    auto denominator = npus_count;
+    address_table.resize(static_cast<size_t>(npus_count) * dims_count);
+    for (auto npu_id = 0; npu_id < npus_count; npu_id++) {
+        for (auto dim = 0; dim < dims_count; dim++) {
+            address_table[npu_id * dims_count + dim] = (npu_id / stride_per_dim[dim]) % npus_count_per_dim[dim];
+        }
+    }
+}
 
-    for (auto dim = dims_count - 1; dim >= 0; dim--) {
-        // change denominator
-        denominator /= npus_count_per_dim[dim];
+MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(const DeviceId npu_id) const noexcept {
+    assert(0 <= npu_id && npu_id < npus_count);
 
-        // get and update address
-        const auto quotient = leftover / denominator;
-        leftover %= denominator;
+    // If units-count if [2, 8, 4] (strides [1, 2, 16]), and the given id is 47, then the address is
+    // (47 // 1) % 2 = 1, (47 // 2) % 8 = 7, (47 // 16) % 4 = 2
+    // therefore the address is [1, 7, 2]
+
+    // create empty address
+    auto multi_dim_address = MultiDimAddress();
 
-        // update address
-        multi_dim_address[dim] = quotient;
+    if (!address_table.empty()) {
+        // look up the precomputed address
+        const auto* const address = &address_table[npu_id * dims_count];
+        std::copy(address, address + dims_count, multi_dim_address.begin());
+    } else {
+        // decode the address
+        for (auto dim = 0; dim < dims_count; dim++) {
+            multi_dim_address[dim] = (npu_id / stride_per_dim[dim]) % npus_count_per_dim[dim];
+        }
     }
 
     // check address translation
@@ -96,17 +275,146 @@ MultiDimTopology::MultiDimAddress MultiDimTopology::translate_address(const Devi
     return multi_dim_address;
 }
 
-int MultiDimTopology::get_dim_to_transfer(const MultiDimAddress& src_address,
-                                          const MultiDimAddress& dest_address) const noexcept {
+void MultiDimTopology::set_dim_pipelining(const bool pipelined) noexcept {
+    dim_pipelining = pipelined;
+}
+
+bool MultiDimTopology::get_dim_pipelining() const noexcept {
+    return dim_pipelining;
+}
+
+int MultiDimTopology::get_links_count() const noexcept {
+    return get_dims_links_count(dim_topology_pointers.data(), dims_count);
+}
+
+Bandwidth MultiDimTopology::get_link_bandwidth(const int link_id) const noexcept {
+    return get_dims_link_bandwidth(dim_topology_pointers.data(), dims_count, link_id);
+}
+
+int MultiDimTopology::get_max_route_links_count() const noexcept {
+    return get_dims_max_route_links_count(dim_topology_pointers.data(), dims_count);
+}
+
+int MultiDimTopology::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    return write_dims_route_links(dim_topology_pointers.data(), dims_count, src, dest, link_ids);
+}
+
+int MultiDimTopology::get_dims_links_count(const BasicTopology* const* const dim_topologies,
+                                           const int dims_count) noexcept {
+    auto npus_count = 1;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        npus_count *= dim_topologies[dim]->get_npus_count();
+    }
+
+    // a copy of each dimension's links per address of the other dimensions
+    auto links_count = 0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        links_count += (npus_count / dim_topologies[dim]->get_npus_count()) * dim_topologies[dim]->get_links_count();
+    }
+    return links_count;
+}
+
+Bandwidth MultiDimTopology::get_dims_link_bandwidth(const BasicTopology* const* const dim_topologies,
+                                                    const int dims_count,
+                                                    const int link_id) noexcept {
+    assert(0 <= link_id && link_id < get_dims_links_count(dim_topologies, dims_count));
+
+    auto npus_count = 1;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        npus_count *= dim_topologies[dim]->get_npus_count();
+    }
+
+    // find the dimension the link belongs to
+    auto links_offset = 0;
     for (auto dim = 0; dim < dims_count; dim++) {
-        // check the dim that has different address
-        if (src_address[dim] != dest_address[dim]) {
-            return dim;
+        const auto& topology = *dim_topologies[dim];
+        links_offset += (npus_count / topology.get_npus_count()) * topology.get_links_count();
+        if (link_id < links_offset) {
+            return topology.get_link_bandwidth(0);
         }
     }
 
     // shouldn't reach here
-    std::cerr << "[Error] (network/analytical/congestion_unaware): " << "src and dest have the same address"
+    std::cerr << "[Error] (network/analytical/congestion_unaware) " << "link " << link_id << " out of range"
               << std::endl;
     std::exit(-1);
 }
+
+int MultiDimTopology::get_dims_max_route_links_count(const BasicTopology* const* const dim_topologies,
+                                                     const int dims_count) noexcept {
+    auto max_route_links_count = 0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        max_route_links_count += dim_topologies[dim]->get_max_route_links_count();
+    }
+    return max_route_links_count;
+}
+
+int MultiDimTopology::write_dims_route_links(const BasicTopology* const* const dim_topologies,
+                                             const int dims_count,
+                                             const DeviceId src,
+                                             const DeviceId dest,
+                                             int* const link_ids) noexcept {
+    assert(src != dest);
+
+    auto npus_count = 1;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        npus_count *= dim_topologies[dim]->get_npus_count();
+    }
+
+    // dimension-ordered: the chunk sits at the dest address below dim, and the src address above
+    auto links_count = 0;
+    auto links_offset = 0;
+    auto current = src;
+    auto stride = 1;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        const auto& topology = *dim_topologies[dim];
+        const auto dim_size = topology.get_npus_count();
+        const auto copies_count = npus_count / dim_size;
+        const auto src_local_id = (current / stride) % dim_size;
+        const auto dest_local_id = (dest / stride) % dim_size;
+
+        if (src_local_id != dest_local_id) {
+            // address of the other dimensions picks the copy of the dimension's links
+            const auto copy = (current / (stride * dim_size)) * stride + (current % stride);
+            auto* const dim_link_ids = link_ids + links_count;
+            const auto dim_links_count = topology.write_route_links(src_local_id, dest_local_id, dim_link_ids);
+            for (auto i = links_count; i < links_count + dim_links_count; i++) {
+                link_ids[i] = links_offset + (link_ids[i] * copies_count) + copy;
+            }
+            links_count += dim_links_count;
+            current += (dest_local_id - src_local_id) * stride;
+        }
+
+        links_offset += copies_count * topology.get_links_count();
+        stride *= dim_size;
+    }
+
+    assert(current == dest);
+    return links_count;
+}
+
+template <typename HopsCountOf>
+EventTime MultiDimTopology::compute_transfer_delay(const MultiDimAddress& src_address,
+                                                   const MultiDimAddress& dest_address,
+                                                   const ChunkSize chunk_size,
+                                                   const HopsCountOf& hops_count_of) const noexcept {
+    // dimension-ordered routing: every dimension where the addresses differ, lowest first
+    auto link_delay = 0.0;
+    auto serialization_delay = 0.0;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        if (src_address[dim] == dest_address[dim]) {
+            continue;
+        }
+
+        const auto hops_count = hops_count_of(dim, src_address[dim], dest_address[dim]);
+        link_delay += hops_count * latency_ticks_per_dim[dim];
+
+        // pipelined: the bottleneck dimension serializes, otherwise each dimension does
+        const auto dim_serialization_delay = static_cast<double>(chunk_size) / bandwidth_Bptick_per_dim[dim];
+        serialization_delay = dim_pipelining ? std::max(serialization_delay, dim_serialization_delay)
+                                             : serialization_delay + dim_serialization_delay;
+    }
+
+    // same formula as BasicTopology on a single dimension
+    return static_cast<EventTime>(link_delay + serialization_delay);
+}
@@ -0,0 +1,12 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/StaticMultiDimTopology.h"
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+// prebuilt specializations
+template class NetworkAnalyticalCongestionUnaware::StaticMultiDimTopology<Ring, FullyConnected, Switch>;
@@ -0,0 +1,97 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/CApi.h"
+#include "common/NetworkParser.h"
+#include "congestion_unaware/Helper.h"
+#include <cassert>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+// the C types are the C++ ones, so batches are passed through without conversion
+static_assert(std::is_same_v<DeviceId, int32_t>);
+static_assert(std::is_same_v<ChunkSize, uint64_t>);
+static_assert(std::is_same_v<EventTime, uint64_t>);
+
+struct AnalyticalUnawareTopology {
+    /// topology behind the handle
+    std::shared_ptr<Topology> topology;
+};
+
+namespace {
+
+/**
+ * Check if an NPU ID is valid on a topology.
+ *
+ * @param handle handle of the topology
+ * @param npu_id NPU ID
+ * @return true if valid, false otherwise
+ */
+bool is_valid_npu(const AnalyticalUnawareTopology* const handle, const int32_t npu_id) noexcept {
+    return npu_id >= 0 && npu_id < handle->topology->get_npus_count();
+}
+
+}  // namespace
+
+int analytical_unaware_api_version(void) {
+    return ANALYTICAL_UNAWARE_API_VERSION;
+}
+
+AnalyticalUnawareTopology* analytical_unaware_create(const char* const config_path) {
+    assert(config_path != nullptr);
+
+    // a bad path fails the call rather than the parser terminating the host
+    if (!std::ifstream(config_path)) {
+        return nullptr;
+    }
+
+    const auto network_parser = NetworkParser(config_path);
+    return new AnalyticalUnawareTopology{construct_topology(network_parser)};
+}
+
+void analytical_unaware_destroy(AnalyticalUnawareTopology* const topology) {
+    delete topology;
+}
+
+int32_t analytical_unaware_npus_count(const AnalyticalUnawareTopology* const topology) {
+    assert(topology != nullptr);
+
+    return topology->topology->get_npus_count();
+}
+
+uint64_t analytical_unaware_send(const AnalyticalUnawareTopology* const topology,
+                                 const int32_t src,
+                                 const int32_t dest,
+                                 const uint64_t chunk_size) {
+    assert(topology != nullptr);
+
+    if (!is_valid_npu(topology, src) || !is_valid_npu(topology, dest)) {
+        return std::numeric_limits<uint64_t>::max();
+    }
+    return topology->topology->send(src, dest, chunk_size);
+}
+
+int analytical_unaware_send_batch(const AnalyticalUnawareTopology* const topology,
+                                  const int32_t* const srcs,
+                                  const int32_t* const dests,
+                                  const uint64_t* const chunk_sizes,
+                                  uint64_t* const delays,
+                                  const int32_t count) {
+    assert(topology != nullptr);
+    assert(count >= 0);
+
+    for (auto i = 0; i < count; i++) {
+        if (!is_valid_npu(topology, srcs[i]) || !is_valid_npu(topology, dests[i])) {
+            return -1;
+        }
+    }
+    topology->topology->send_batch(srcs, dests, chunk_sizes, delays, count);
+    return 0;
+}
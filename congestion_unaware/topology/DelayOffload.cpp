@@ -0,0 +1,160 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/DelayOffload.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// number of chunks evaluated by a host task
+constexpr int64_t host_block_size = 1 << 16;
+
+}  // namespace
+
+DelayOffload::DelayOffload(const NetworkParser& network_parser) noexcept
+    : plan(),
+      npus_count(1),
+      gpu_enabled(true) {
+    const auto dims_count = network_parser.get_dims_count();
+    const auto topologies_per_dim = network_parser.get_topologies_per_dim();
+    const auto npus_counts_per_dim = network_parser.get_npus_counts_per_dim();
+    const auto bandwidths_per_dim = network_parser.get_bandwidths_per_dim();
+    const auto latencies_per_dim = network_parser.get_latencies_per_dim();
+    if (dims_count > MultiDimTopology::max_dims_count) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "at most "
+                  << MultiDimTopology::max_dims_count << " dimensions are supported" << std::endl;
+        std::exit(-1);
+    }
+
+    // same coefficients as BasicTopology and MultiDimTopology
+    plan.dims_count = dims_count;
+    plan.dim_pipelining = true;
+    for (auto dim = 0; dim < dims_count; dim++) {
+        switch (topologies_per_dim[dim]) {
+        case TopologyBuildingBlock::Ring:
+            plan.hops_per_dim[dim] = DelayPlanHops::Ring;
+            break;
+        case TopologyBuildingBlock::FullyConnected:
+            plan.hops_per_dim[dim] = DelayPlanHops::FullyConnected;
+            break;
+        case TopologyBuildingBlock::Switch:
+            plan.hops_per_dim[dim] = DelayPlanHops::Switch;
+            break;
+        default:
+            std::cerr << "[Error] (network/analytical/congestion_unaware) "
+                      << "delay offload supports Ring, FullyConnected, and Switch dimensions only" << std::endl;
+            std::exit(-1);
+        }
+
+        plan.npus_count_per_dim[dim] = npus_counts_per_dim[dim];
+        plan.stride_per_dim[dim] = npus_count;
+        plan.latency_ticks_per_dim[dim] = latencies_per_dim[dim] * static_cast<double>(ticks_per_ns);
+        plan.bandwidth_Bptick_per_dim[dim] =
+            bw_GBps_to_Bpns(bandwidths_per_dim[dim]) / static_cast<double>(ticks_per_ns);
+        npus_count *= npus_counts_per_dim[dim];
+    }
+}
+
+bool DelayOffload::gpu_available() noexcept {
+#ifdef NETWORK_ANALYTICAL_ENABLE_CUDA
+    static const auto device_present = cuda_device_present();
+    return device_present;
+#else
+    return false;
+#endif
+}
+
+void DelayOffload::set_gpu_enabled(const bool enabled) noexcept {
+    gpu_enabled = enabled;
+}
+
+bool DelayOffload::uses_gpu() const noexcept {
+    return gpu_enabled && gpu_available();
+}
+
+void DelayOffload::set_dim_pipelining(const bool pipelined) noexcept {
+    plan.dim_pipelining = pipelined;
+}
+
+const DelayPlan& DelayOffload::get_plan() const noexcept {
+    return plan;
+}
+
+void DelayOffload::send_batch(const DeviceId* const srcs,
+                              const DeviceId* const dests,
+                              const ChunkSize* const chunk_sizes,
+                              EventTime* const delays,
+                              const int64_t count,
+                              const int threads_count) const noexcept {
+    assert(count >= 0);
+    assert(threads_count >= 0);
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_CUDA
+    if (uses_gpu() && cuda_send_batch(plan, srcs, dests, chunk_sizes, delays, count)) {
+        return;
+    }
+#endif
+
+    // host fallback: blocks of chunks over the threads
+    const auto evaluate_block = [&](const int block) {
+        const auto begin = block * host_block_size;
+        const auto end = std::min(count, begin + host_block_size);
+        for (auto i = begin; i < end; i++) {
+            assert(0 <= srcs[i] && srcs[i] < npus_count);
+            assert(0 <= dests[i] && dests[i] < npus_count);
+
+            delays[i] = evaluate_delay(plan, srcs[i], dests[i], chunk_sizes[i]);
+        }
+    };
+    const auto blocks_count = static_cast<int>((count + host_block_size - 1) / host_block_size);
+    if (threads_count == 1 || blocks_count <= 1) {
+        for (auto block = 0; block < blocks_count; block++) {
+            evaluate_block(block);
+        }
+        return;
+    }
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(blocks_count, evaluate_block);
+}
+
+std::vector<EventTime> DelayOffload::compute_delay_matrix(const ChunkSize chunk_size,
+                                                          const int threads_count) const noexcept {
+    assert(chunk_size > 0);
+    assert(threads_count >= 0);
+
+    auto delay_matrix = std::vector<EventTime>(static_cast<size_t>(npus_count) * npus_count, 0);
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_CUDA
+    if (uses_gpu() && cuda_compute_delay_matrix(plan, npus_count, chunk_size, delay_matrix.data())) {
+        return delay_matrix;
+    }
+#endif
+
+    // host fallback: one task per row
+    const auto evaluate_row = [&](const int src) {
+        auto* const row = &delay_matrix[static_cast<size_t>(src) * npus_count];
+        for (auto dest = 0; dest < npus_count; dest++) {
+            row[dest] = evaluate_delay(plan, src, dest, chunk_size);
+        }
+    };
+    if (threads_count == 1) {
+        for (auto src = 0; src < npus_count; src++) {
+            evaluate_row(src);
+        }
+        return delay_matrix;
+    }
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(npus_count, evaluate_row);
+    return delay_matrix;
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+// compiled only with NETWORK_BACKEND_ENABLE_CUDA (and --fmad=false, so results match the host bit for bit)
+
+#include "congestion_unaware/DelayOffload.h"
+#include <cuda_runtime.h>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/// threads per block of the kernels
+constexpr int threads_per_block = 256;
+
+/**
+ * Batch kernel: one thread per chunk.
+ */
+__global__ void send_batch_kernel(const DelayPlan plan,
+                                  const DeviceId* const srcs,
+                                  const DeviceId* const dests,
+                                  const ChunkSize* const chunk_sizes,
+                                  EventTime* const delays,
+                                  const int64_t count) {
+    const auto i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i < count) {
+        delays[i] = evaluate_delay(plan, srcs[i], dests[i], chunk_sizes[i]);
+    }
+}
+
+/**
+ * Delay matrix kernel: one thread per (src, dest) pair.
+ */
+__global__ void delay_matrix_kernel(const DelayPlan plan,
+                                    const int npus_count,
+                                    const ChunkSize chunk_size,
+                                    EventTime* const delay_matrix) {
+    const auto i = static_cast<int64_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i < static_cast<int64_t>(npus_count) * npus_count) {
+        const auto src = static_cast<DeviceId>(i / npus_count);
+        const auto dest = static_cast<DeviceId>(i % npus_count);
+        delay_matrix[i] = evaluate_delay(plan, src, dest, chunk_size);
+    }
+}
+
+/**
+ * Number of blocks covering a number of threads.
+ */
+unsigned int blocks_count(const int64_t threads_count) noexcept {
+    return static_cast<unsigned int>((threads_count + threads_per_block - 1) / threads_per_block);
+}
+
+}  // namespace
+
+bool NetworkAnalyticalCongestionUnaware::cuda_device_present() noexcept {
+    auto devices_count = 0;
+    return cudaGetDeviceCount(&devices_count) == cudaSuccess && devices_count > 0;
+}
+
+bool NetworkAnalyticalCongestionUnaware::cuda_send_batch(const DelayPlan& plan,
+                                                         const DeviceId* const srcs,
+                                                         const DeviceId* const dests,
+                                                         const ChunkSize* const chunk_sizes,
+                                                         EventTime* const delays,
+                                                         const int64_t count) noexcept {
+    if (count == 0) {
+        return true;
+    }
+
+    auto* device_srcs = static_cast<DeviceId*>(nullptr);
+    auto* device_dests = static_cast<DeviceId*>(nullptr);
+    auto* device_chunk_sizes = static_cast<ChunkSize*>(nullptr);
+    auto* device_delays = static_cast<EventTime*>(nullptr);
+    auto ok = cudaMalloc(&device_srcs, count * sizeof(DeviceId)) == cudaSuccess &&
+              cudaMalloc(&device_dests, count * sizeof(DeviceId)) == cudaSuccess &&
+              cudaMalloc(&device_chunk_sizes, count * sizeof(ChunkSize)) == cudaSuccess &&
+              cudaMalloc(&device_delays, count * sizeof(EventTime)) == cudaSuccess;
+    ok = ok && cudaMemcpy(device_srcs, srcs, count * sizeof(DeviceId), cudaMemcpyHostToDevice) == cudaSuccess &&
+         cudaMemcpy(device_dests, dests, count * sizeof(DeviceId), cudaMemcpyHostToDevice) == cudaSuccess &&
+         cudaMemcpy(device_chunk_sizes, chunk_sizes, count * sizeof(ChunkSize), cudaMemcpyHostToDevice) == cudaSuccess;
+    if (ok) {
+        send_batch_kernel<<<blocks_count(count), threads_per_block>>>(plan, device_srcs, device_dests,
+                                                                      device_chunk_sizes, device_delays, count);
+        ok = cudaGetLastError() == cudaSuccess &&
+             cudaMemcpy(delays, device_delays, count * sizeof(EventTime), cudaMemcpyDeviceToHost) == cudaSuccess;
+    }
+
+    cudaFree(device_srcs);
+    cudaFree(device_dests);
+    cudaFree(device_chunk_sizes);
+    cudaFree(device_delays);
+    return ok;
+}
+
+bool NetworkAnalyticalCongestionUnaware::cuda_compute_delay_matrix(const DelayPlan& plan,
+                                                                   const int npus_count,
+                                                                   const ChunkSize chunk_size,
+                                                                   EventTime* const delay_matrix) noexcept {
+    const auto count = static_cast<int64_t>(npus_count) * npus_count;
+    auto* device_delay_matrix = static_cast<EventTime*>(nullptr);
+    auto ok = cudaMalloc(&device_delay_matrix, count * sizeof(EventTime)) == cudaSuccess;
+    if (ok) {
+        delay_matrix_kernel<<<blocks_count(count), threads_per_block>>>(plan, npus_count, chunk_size,
+                                                                        device_delay_matrix);
+        ok = cudaGetLastError() == cudaSuccess &&
+             cudaMemcpy(delay_matrix, device_delay_matrix, count * sizeof(EventTime), cudaMemcpyDeviceToHost) ==
+                 cudaSuccess;
+    }
+
+    cudaFree(device_delay_matrix);
+    return ok;
+}
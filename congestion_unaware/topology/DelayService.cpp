@@ -0,0 +1,62 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/DelayService.h"
+#include "common/NetworkParser.h"
+#include "congestion_unaware/Helper.h"
+#include <fstream>
+#include <vector>
+
+using namespace NetworkAnalyticalCongestionUnaware;
+
+std::string DelayService::answer(const std::string& request) noexcept {
+    auto query = ChunkQuery();
+    if (!ChunkQuery::decode(request, query)) {
+        return std::string();
+    }
+
+    const auto topology = get_topology(query.config_path);
+    if (topology == nullptr) {
+        return std::string();
+    }
+
+    const auto npus_count = topology->get_npus_count();
+    const auto chunks_count = static_cast<int>(query.srcs.size());
+    for (auto i = 0; i < chunks_count; i++) {
+        if (query.srcs[i] < 0 || query.srcs[i] >= npus_count || query.dests[i] < 0 || query.dests[i] >= npus_count) {
+            return std::string();
+        }
+    }
+
+    // topologies are immutable once constructed, so requests are answered concurrently
+    auto delays = std::vector<EventTime>(chunks_count);
+    topology->send_batch(query.srcs.data(), query.dests.data(), query.chunk_sizes.data(), delays.data(),
+                         chunks_count);
+    return ChunkQuery::encode_answer(delays);
+}
+
+int DelayService::get_topologies_count() const noexcept {
+    const auto lock = std::lock_guard<std::mutex>(topologies_mutex);
+    return static_cast<int>(topologies.size());
+}
+
+std::shared_ptr<const Topology> DelayService::get_topology(const std::string& config_path) noexcept {
+    const auto lock = std::lock_guard<std::mutex>(topologies_mutex);
+
+    const auto cached_topology = topologies.find(config_path);
+    if (cached_topology != topologies.end()) {
+        return cached_topology->second;
+    }
+
+    // a bad path fails the request rather than the parser terminating the server
+    if (!std::ifstream(config_path)) {
+        return nullptr;
+    }
+
+    const auto network_parser = NetworkParser(config_path);
+    const auto topology = std::shared_ptr<const Topology>(construct_topology(network_parser));
+    topologies.emplace(config_path, topology);
+    return topology;
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/ExecutionTraceAdapter.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+ExecutionTraceAdapter::ExecutionTraceAdapter(std::shared_ptr<Topology> topology,
+                                             std::shared_ptr<NetworkScheduler> scheduler) noexcept
+    : topology(std::move(topology)),
+      scheduler(std::move(scheduler)) {
+    assert(this->topology != nullptr);
+    assert(this->scheduler != nullptr);
+}
+
+NetworkScheduler& ExecutionTraceAdapter::get_scheduler() noexcept {
+    return *scheduler;
+}
+
+int ExecutionTraceAdapter::get_npus_count() const noexcept {
+    return topology->get_npus_count();
+}
+
+void ExecutionTraceAdapter::send(const DeviceId src,
+                                 const DeviceId dest,
+                                 const ChunkSize size,
+                                 const Callback callback,
+                                 const CallbackArg callback_arg) noexcept {
+    const auto delay = topology->send(src, dest, size);
+    scheduler->schedule_event(scheduler->get_current_time() + delay, callback, callback_arg);
+}
+
+void ExecutionTraceAdapter::run_collective(const CollectiveType collective_type,
+                                           const ChunkSize size,
+                                           const Callback callback,
+                                           const CallbackArg callback_arg) noexcept {
+    const auto cost = compute_collective_cost(collective_type, size);
+    scheduler->schedule_event(scheduler->get_current_time() + cost, callback, callback_arg);
+}
+
+EventTime ExecutionTraceAdapter::compute_collective_cost(const CollectiveType collective_type,
+                                                         const ChunkSize size) const noexcept {
+    const auto key = std::make_pair(collective_type, size);
+    const auto memoized = collective_costs.find(key);
+    if (memoized != collective_costs.end()) {
+        return memoized->second;
+    }
+
+    // every step, each NPU sends a 1/N shard: to its next NPU,
+    // or to NPU (rank + step + 1) for AllToAll (pairwise exchange)
+    const auto npus_count = topology->get_npus_count();
+    const auto shard_size = std::max<ChunkSize>(size / npus_count, 1);
+    const auto is_all_to_all = (collective_type == CollectiveType::AllToAll);
+    const auto steps_count = (npus_count - 1) * ((collective_type == CollectiveType::AllReduce) ? 2 : 1);
+
+    // a step is bound by its slowest message
+    const auto compute_step_cost = [&](const int step) {
+        auto step_cost = EventTime(0);
+        for (auto rank = 0; rank < npus_count; rank++) {
+            const auto peer = (rank + (is_all_to_all ? step : 0) + 1) % npus_count;
+            step_cost = std::max(step_cost, topology->send(rank, peer, shard_size));
+        }
+        return step_cost;
+    };
+
+    // neighbor steps all cost the same
+    auto cost = EventTime(0);
+    if (is_all_to_all) {
+        for (auto step = 0; step < steps_count; step++) {
+            cost += compute_step_cost(step);
+        }
+    } else if (steps_count > 0) {
+        cost = steps_count * compute_step_cost(0);
+    }
+
+    collective_costs.emplace(key, cost);
+    return cost;
+}
@@ -6,17 +6,38 @@ LICENSE file in the root directory of this source tree.
 #include "congestion_unaware/Helper.h"
 #include "congestion_unaware/BasicTopology.h"
 #include "congestion_unaware/FullyConnected.h"
+#include "congestion_unaware/LeafSpine.h"
+#include "congestion_unaware/Mesh2D.h"
 #include "congestion_unaware/MultiDimTopology.h"
 #include "congestion_unaware/Ring.h"
+#include "congestion_unaware/SparseMesh2D.h"
+#include "congestion_unaware/StaticMultiDimTopology.h"
 #include "congestion_unaware/Switch.h"
+#include "congestion_unaware/Torus.h"
+#include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <string>
+#include <vector>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology(
     const NetworkParser& network_parser) noexcept {
+    auto errors = std::vector<ConfigError>();
+    auto topology = try_construct_topology(network_parser, errors);
+    if (topology == nullptr) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << errors.front().message << std::endl;
+        std::exit(-1);
+    }
+
+    return topology;
+}
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::try_construct_topology(
+    const NetworkParser& network_parser,
+    std::vector<ConfigError>& errors) noexcept {
     // get network_parser info
     const auto dims_count = network_parser.get_dims_count();
     const auto topologies_per_dim = network_parser.get_topologies_per_dim();
@@ -40,6 +61,56 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology
             return std::make_shared<Switch>(npus_count, bandwidth, latency);
         case TopologyBuildingBlock::FullyConnected:
             return std::make_shared<FullyConnected>(npus_count, bandwidth, latency);
+        case TopologyBuildingBlock::Mesh2D: {
+            // explicit width and height if given, otherwise a square mesh
+            const auto mesh_width = network_parser.get_mesh_width();
+            const auto mesh_height = network_parser.get_mesh_height();
+            if (mesh_width > 0 && mesh_height > 0) {
+                return std::make_shared<Mesh2D>(mesh_width, mesh_height, bandwidth, latency);
+            }
+            const auto width_height = static_cast<int>(std::lround(std::sqrt(npus_count)));
+            if (width_height * width_height != npus_count) {
+                errors.push_back({"width", "Mesh2D of " + std::to_string(npus_count) +
+                                                    " NPUs requires width and height"});
+                return nullptr;
+            }
+            return std::make_shared<Mesh2D>(width_height, width_height, bandwidth, latency);
+        }
+        case TopologyBuildingBlock::SparseMesh2D: {
+            const auto mesh_width = network_parser.get_mesh_width();
+            const auto mesh_height = network_parser.get_mesh_height();
+            if (mesh_width <= 0 || mesh_height <= 0) {
+                errors.push_back({"width", "SparseMesh2D requires width and height"});
+                return nullptr;
+            }
+
+            // excluded cells and custom placement are expanded into grids only now
+            return std::make_shared<SparseMesh2D>(mesh_width, mesh_height, network_parser.get_valid_cells(),
+                                                  network_parser.get_npu_placement_grid(), bandwidth, latency);
+        }
+        case TopologyBuildingBlock::Torus2D:
+            // dimensions are checked (or derived) by the parser
+            return std::make_shared<Torus>(network_parser.get_mesh_width(), network_parser.get_mesh_height(),
+                                           bandwidth, latency);
+        case TopologyBuildingBlock::Torus3D:
+            return std::make_shared<Torus>(network_parser.get_mesh_width(), network_parser.get_mesh_height(),
+                                           network_parser.get_mesh_depth(), bandwidth, latency);
+        case TopologyBuildingBlock::FatTree: {
+            // a 2-tier fat-tree is a leaf/spine switch: leaf ports split into downlinks and uplinks
+            if (network_parser.get_fat_tree_tiers() != 2) {
+                errors.push_back({"tiers", "FatTree supports 2 tiers only (a leaf/spine switch)"});
+                return nullptr;
+            }
+            const auto radix = network_parser.get_fat_tree_radix();
+            const auto leaf_up_ports = radix / (network_parser.get_fat_tree_oversubscription() + 1);
+            const auto leaf_size = radix - leaf_up_ports;
+            if (leaf_up_ports <= 0) {
+                errors.push_back({"oversubscription", "FatTree leaves require at least 1 uplink"});
+                return nullptr;
+            }
+            return std::make_shared<LeafSpine>(npus_count, leaf_size,
+                                               static_cast<double>(leaf_size) / leaf_up_ports, bandwidth, latency);
+        }
         default:
             // shouldn't reach here
             std::cerr << "[Error] (network/analytical/congestion_unaware)" << "Not supported topology" << std::endl;
@@ -47,6 +118,12 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology
         }
     }
 
+    // prebuilt dimension stacks are resolved at compile time
+    using RingFullyConnectedSwitch = StaticMultiDimTopology<Ring, FullyConnected, Switch>;
+    if (RingFullyConnectedSwitch::matches(network_parser)) {
+        return RingFullyConnectedSwitch::construct(network_parser);
+    }
+
     // otherwise, create multi-dim basic-topology
     const auto multi_dim_topology = std::make_shared<MultiDimTopology>();
 
@@ -84,3 +161,8 @@ std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology
     // return created multi-dimensional topology
     return multi_dim_topology;
 }
+
+std::shared_ptr<Topology> NetworkAnalyticalCongestionUnaware::construct_topology(
+    const NetworkConfig& network_config) noexcept {
+    return construct_topology(NetworkParser(network_config));
+}
@@ -0,0 +1,118 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/PlacementEvaluator.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+PlacementEvaluator::PlacementEvaluator(std::shared_ptr<const Topology> topology,
+                                       std::vector<JobMessage> messages,
+                                       const PlacementCost cost) noexcept
+    : topology(std::move(topology)),
+      messages(std::move(messages)),
+      cost(cost),
+      ranks_count(0) {
+    assert(this->topology != nullptr);
+
+    // ranks are numbered from 0 up to the largest one messaging
+    for (const auto& message : this->messages) {
+        assert(message.src_rank >= 0 && message.dest_rank >= 0);
+        assert(message.size > 0);
+
+        ranks_count = std::max({ranks_count, message.src_rank + 1, message.dest_rank + 1});
+    }
+
+    // link-load costs convert bytes to serialization time per link
+    if (cost == PlacementCost::LinkLoad) {
+        const auto links_count = this->topology->get_links_count();
+        link_time_per_byte.resize(links_count);
+        for (auto link_id = 0; link_id < links_count; link_id++) {
+            const auto bandwidth_Bptick =
+                bw_GBps_to_Bpns(this->topology->get_link_bandwidth(link_id)) / static_cast<double>(ticks_per_ns);
+            link_time_per_byte[link_id] = 1.0 / bandwidth_Bptick;
+        }
+    }
+}
+
+int PlacementEvaluator::get_ranks_count() const noexcept {
+    return ranks_count;
+}
+
+double PlacementEvaluator::evaluate(const std::vector<DeviceId>& placement) const noexcept {
+    assert(static_cast<int>(placement.size()) >= ranks_count);
+
+    return (cost == PlacementCost::Delay) ? evaluate_delay(placement) : evaluate_link_load(placement);
+}
+
+std::vector<PlacementScore> PlacementEvaluator::rank(const std::vector<std::vector<DeviceId>>& candidates,
+                                                     const int best_count,
+                                                     const int threads_count) const noexcept {
+    assert(best_count >= 0);
+    assert(threads_count >= 0);
+
+    // candidates are independent and write disjoint scores
+    const auto candidates_count = static_cast<int>(candidates.size());
+    auto scores = std::vector<PlacementScore>(candidates_count);
+    const auto score_candidate = [&](const int candidate) {
+        scores[candidate] = PlacementScore{candidate, evaluate(candidates[candidate])};
+    };
+    if (threads_count == 1) {
+        for (auto candidate = 0; candidate < candidates_count; candidate++) {
+            score_candidate(candidate);
+        }
+    } else {
+        auto executor = WorkStealingExecutor(threads_count);
+        executor.run(candidates_count, score_candidate);
+    }
+
+    // keep the best ones, in a deterministic order
+    const auto kept_count = std::min(best_count, candidates_count);
+    std::partial_sort(scores.begin(), scores.begin() + kept_count, scores.end(),
+                      [](const PlacementScore& lhs, const PlacementScore& rhs) {
+                          return (lhs.cost != rhs.cost) ? lhs.cost < rhs.cost : lhs.candidate < rhs.candidate;
+                      });
+    scores.resize(kept_count);
+    return scores;
+}
+
+double PlacementEvaluator::evaluate_delay(const std::vector<DeviceId>& placement) const noexcept {
+    auto max_delay = EventTime(0);
+    for (const auto& message : messages) {
+        const auto src = placement[message.src_rank];
+        const auto dest = placement[message.dest_rank];
+        if (src != dest) {
+            max_delay = std::max(max_delay, topology->send(src, dest, message.size));
+        }
+    }
+    return static_cast<double>(max_delay);
+}
+
+double PlacementEvaluator::evaluate_link_load(const std::vector<DeviceId>& placement) const noexcept {
+    // serialization time accumulated on every link along the routes
+    auto link_times = std::vector<double>(link_time_per_byte.size(), 0.0);
+    auto link_ids = std::vector<int>(topology->get_max_route_links_count());
+    auto max_link_time = 0.0;
+    for (const auto& message : messages) {
+        const auto src = placement[message.src_rank];
+        const auto dest = placement[message.dest_rank];
+        if (src == dest) {
+            continue;
+        }
+
+        const auto links_count = topology->write_route_links(src, dest, link_ids.data());
+        for (auto i = 0; i < links_count; i++) {
+            const auto link_id = link_ids[i];
+            link_times[link_id] += static_cast<double>(message.size) * link_time_per_byte[link_id];
+            max_link_time = std::max(max_link_time, link_times[link_id]);
+        }
+    }
+    return max_link_time;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "congestion_unaware/QueueingModel.h"
+#include "common/NetworkFunction.h"
+#include "common/TimeBase.h"
+#include "common/WorkStealingExecutor.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace NetworkAnalytical;
+using namespace NetworkAnalyticalCongestionUnaware;
+
+QueueingModel::QueueingModel(std::shared_ptr<const Topology> topology) noexcept : topology(std::move(topology)) {
+    assert(this->topology != nullptr);
+
+    npus_count = this->topology->get_npus_count();
+    max_route_links_count = this->topology->get_max_route_links_count();
+
+    // every link starts idle
+    const auto links_count = this->topology->get_links_count();
+    link_utilizations.assign(links_count, 0.0);
+    queueing_delay_per_byte.assign(links_count, 0.0);
+}
+
+void QueueingModel::set_traffic_matrix(const std::vector<Bandwidth>& traffic_matrix) noexcept {
+    assert(traffic_matrix.size() == static_cast<size_t>(npus_count) * npus_count);
+
+    // offered load of every link, along the route of each pair
+    auto link_loads = std::vector<double>(link_utilizations.size(), 0.0);
+    auto link_ids = std::vector<int>(max_route_links_count);
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            const auto offered_bandwidth = traffic_matrix[static_cast<size_t>(src) * npus_count + dest];
+            assert(offered_bandwidth >= 0);
+            if (src == dest || offered_bandwidth == 0) {
+                continue;
+            }
+
+            const auto links_count = topology->write_route_links(src, dest, link_ids.data());
+            for (auto i = 0; i < links_count; i++) {
+                link_loads[link_ids[i]] += offered_bandwidth;
+            }
+        }
+    }
+
+    // M/D/1 mean waiting time: rho / (2 (1 - rho)) service times, the service time being chunk_size / bandwidth
+    for (auto link_id = 0; link_id < static_cast<int>(link_loads.size()); link_id++) {
+        if (link_loads[link_id] == 0) {
+            link_utilizations[link_id] = 0.0;
+            queueing_delay_per_byte[link_id] = 0.0;
+            continue;
+        }
+
+        const auto bandwidth = topology->get_link_bandwidth(link_id);
+        const auto utilization = link_loads[link_id] / bandwidth;
+        const auto capped_utilization = std::min(utilization, max_utilization);
+        const auto bandwidth_Bptick = bw_GBps_to_Bpns(bandwidth) / static_cast<double>(ticks_per_ns);
+        link_utilizations[link_id] = utilization;
+        queueing_delay_per_byte[link_id] = capped_utilization / (2 * (1 - capped_utilization)) / bandwidth_Bptick;
+    }
+}
+
+double QueueingModel::get_link_utilization(const int link_id) const noexcept {
+    assert(0 <= link_id && link_id < static_cast<int>(link_utilizations.size()));
+
+    return link_utilizations[link_id];
+}
+
+double QueueingModel::get_max_link_utilization() const noexcept {
+    if (link_utilizations.empty()) {
+        return 0.0;
+    }
+
+    return *std::max_element(link_utilizations.begin(), link_utilizations.end());
+}
+
+int QueueingModel::get_saturated_links_count() const noexcept {
+    return static_cast<int>(std::count_if(link_utilizations.begin(), link_utilizations.end(),
+                                          [](const double utilization) { return utilization >= 1; }));
+}
+
+EventTime QueueingModel::send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const noexcept {
+    assert(0 <= src && src < npus_count);
+    assert(0 <= dest && dest < npus_count);
+    assert(chunk_size > 0);
+
+    if (src == dest) {
+        return 0;
+    }
+
+    auto link_ids = std::vector<int>(max_route_links_count);
+    const auto queueing_delay_per_byte = route_queueing_delay_per_byte(src, dest, link_ids.data());
+    const auto queueing_delay = static_cast<EventTime>(static_cast<double>(chunk_size) * queueing_delay_per_byte);
+    return topology->send(src, dest, chunk_size) + queueing_delay;
+}
+
+std::vector<EventTime> QueueingModel::compute_delay_matrix(const ChunkSize chunk_size,
+                                                           const int threads_count) const noexcept {
+    assert(chunk_size > 0);
+    assert(threads_count >= 0);
+
+    // uncongested delays, then the queueing delay of every pair row by row
+    auto delay_matrix = topology->compute_delay_matrix(chunk_size, threads_count);
+    const auto add_row_queueing_delays = [&](const DeviceId src) {
+        auto link_ids = std::vector<int>(max_route_links_count);
+        auto* const row = &delay_matrix[static_cast<size_t>(src) * npus_count];
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (dest != src) {
+                const auto queueing_delay_per_byte = route_queueing_delay_per_byte(src, dest, link_ids.data());
+                row[dest] += static_cast<EventTime>(static_cast<double>(chunk_size) * queueing_delay_per_byte);
+            }
+        }
+    };
+
+    // rows are independent and write disjoint parts of the matrix
+    if (threads_count == 1) {
+        for (auto src = 0; src < npus_count; src++) {
+            add_row_queueing_delays(src);
+        }
+    } else {
+        auto executor = WorkStealingExecutor(threads_count);
+        executor.run(npus_count, [&](const int src) { add_row_queueing_delays(src); });
+    }
+
+    return delay_matrix;
+}
+
+double QueueingModel::route_queueing_delay_per_byte(const DeviceId src,
+                                                    const DeviceId dest,
+                                                    int* const link_ids) const noexcept {
+    const auto links_count = topology->write_route_links(src, dest, link_ids);
+
+    auto delay_per_byte = 0.0;
+    for (auto i = 0; i < links_count; i++) {
+        delay_per_byte += queueing_delay_per_byte[link_ids[i]];
+    }
+    return delay_per_byte;
+}
@@ -4,13 +4,143 @@ LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
 #include "congestion_unaware/Topology.h"
+#include "common/WorkStealingExecutor.h"
 #include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
 
 using namespace NetworkAnalytical;
 using namespace NetworkAnalyticalCongestionUnaware;
 
 Topology::Topology() noexcept : npus_count(-1), dims_count(-1) {}
 
+void Topology::send_batch(const DeviceId* const srcs,
+                          const DeviceId* const dests,
+                          const ChunkSize* const chunk_sizes,
+                          EventTime* const delays,
+                          const int count) const noexcept {
+    assert(count >= 0);
+    assert(count == 0 || (srcs != nullptr && dests != nullptr && chunk_sizes != nullptr && delays != nullptr));
+
+    // fallback: one send per chunk
+    for (auto i = 0; i < count; i++) {
+        delays[i] = send(srcs[i], dests[i], chunk_sizes[i]);
+    }
+}
+
+std::vector<EventTime> Topology::compute_delay_matrix(const ChunkSize chunk_size,
+                                                     const int threads_count) const noexcept {
+    assert(chunk_size > 0);
+    assert(threads_count >= 0);
+
+    assert(npus_count > 0);
+
+    auto delay_matrix = std::vector<EventTime>(static_cast<size_t>(npus_count) * npus_count, 0);
+
+    // one batch per row: (src, dest) for every dest except src itself
+    for_each_delay_matrix_row(threads_count, [&](const DeviceId src) {
+        auto dests = std::vector<DeviceId>();
+        dests.reserve(npus_count - 1);
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (dest != src) {
+                dests.push_back(dest);
+            }
+        }
+
+        const auto count = static_cast<int>(dests.size());
+        const auto srcs = std::vector<DeviceId>(count, src);
+        const auto chunk_sizes = std::vector<ChunkSize>(count, chunk_size);
+        auto delays = std::vector<EventTime>(count);
+        send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), count);
+
+        auto* const row = &delay_matrix[static_cast<size_t>(src) * npus_count];
+        for (auto i = 0; i < count; i++) {
+            row[dests[i]] = delays[i];
+        }
+    });
+
+    return delay_matrix;
+}
+
+void Topology::export_delay_matrix(const std::string& path,
+                                   const ChunkSize chunk_size,
+                                   const int threads_count) const noexcept {
+    const auto delay_matrix = compute_delay_matrix(chunk_size, threads_count);
+
+    auto file = std::ofstream(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "cannot open " << path << " for writing"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    const auto matrix_npus_count = static_cast<int32_t>(npus_count);
+    const auto matrix_chunk_size = static_cast<uint64_t>(chunk_size);
+    file.write(reinterpret_cast<const char*>(&matrix_npus_count), sizeof(matrix_npus_count));
+    file.write(reinterpret_cast<const char*>(&matrix_chunk_size), sizeof(matrix_chunk_size));
+    file.write(reinterpret_cast<const char*>(delay_matrix.data()),
+               static_cast<std::streamsize>(delay_matrix.size() * sizeof(EventTime)));
+
+    if (!file) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "failed to write " << path << std::endl;
+        std::exit(-1);
+    }
+}
+
+std::vector<EventTime> Topology::import_delay_matrix(const std::string& path,
+                                                     int& npus_count,
+                                                     ChunkSize& chunk_size) noexcept {
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << "cannot open " << path << " for reading"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    auto matrix_npus_count = int32_t();
+    auto matrix_chunk_size = uint64_t();
+    file.read(reinterpret_cast<char*>(&matrix_npus_count), sizeof(matrix_npus_count));
+    file.read(reinterpret_cast<char*>(&matrix_chunk_size), sizeof(matrix_chunk_size));
+    if (!file || matrix_npus_count <= 0) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << path << " is not a delay matrix file"
+                  << std::endl;
+        std::exit(-1);
+    }
+
+    auto delay_matrix = std::vector<EventTime>(static_cast<size_t>(matrix_npus_count) * matrix_npus_count);
+    file.read(reinterpret_cast<char*>(delay_matrix.data()),
+              static_cast<std::streamsize>(delay_matrix.size() * sizeof(EventTime)));
+    if (!file) {
+        std::cerr << "[Error] (network/analytical/congestion_unaware) " << path << " is truncated" << std::endl;
+        std::exit(-1);
+    }
+
+    npus_count = matrix_npus_count;
+    chunk_size = matrix_chunk_size;
+    return delay_matrix;
+}
+
+void Topology::for_each_delay_matrix_row(const int threads_count,
+                                         const std::function<void(DeviceId src)>& row_task) const noexcept {
+    assert(threads_count >= 0);
+
+    assert(npus_count > 0);
+
+    // sequential: no worker threads to spawn
+    if (threads_count == 1) {
+        for (auto src = 0; src < npus_count; src++) {
+            row_task(src);
+        }
+        return;
+    }
+
+    // rows are independent and write disjoint parts of the matrix
+    auto executor = WorkStealingExecutor(threads_count);
+    executor.run(npus_count, [&](const int task_id) { row_task(task_id); });
+}
+
 int Topology::get_npus_count() const noexcept {
     assert(npus_count > 0);
 
@@ -34,3 +164,25 @@ std::vector<Bandwidth> Topology::get_bandwidth_per_dim() const noexcept {
 
     return bandwidth_per_dim;
 }
+
+int Topology::get_links_count() const noexcept {
+    exit_without_link_routing();
+}
+
+Bandwidth Topology::get_link_bandwidth(const int link_id) const noexcept {
+    exit_without_link_routing();
+}
+
+int Topology::get_max_route_links_count() const noexcept {
+    exit_without_link_routing();
+}
+
+int Topology::write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept {
+    exit_without_link_routing();
+}
+
+void Topology::exit_without_link_routing() noexcept {
+    std::cerr << "[Error] (network/analytical/congestion_unaware) " << "topology doesn't support link-level routing"
+              << std::endl;
+    std::exit(-1);
+}
@@ -0,0 +1,154 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <type_traits>
+
+namespace NetworkAnalytical {
+
+/**
+ * Append scalars to a flat binary buffer (native byte order, no padding).
+ *
+ * @param buffer buffer to append to
+ * @param values pointer to the first value
+ * @param count number of values
+ */
+template <typename T> void append_binary(std::string& buffer, const T* const values, const size_t count) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    buffer.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+}
+
+/**
+ * Append a scalar to a flat binary buffer (native byte order, no padding).
+ *
+ * @param buffer buffer to append to
+ * @param value value to append
+ */
+template <typename T> void append_binary(std::string& buffer, const T value) noexcept {
+    append_binary(buffer, &value, 1);
+}
+
+/**
+ * Read a whole binary file.
+ *
+ * @param path path of the file
+ * @param contents read contents
+ * @return true if the file is read, false otherwise
+ */
+inline bool read_binary_file(const std::string& path, std::string& contents) noexcept {
+    auto file = std::ifstream(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+/**
+ * Write a binary file through a temporary file replacing it at once,
+ * so concurrent readers see either version.
+ *
+ * @param path path of the file
+ * @param contents contents to write
+ * @return true if the file is written, false otherwise
+ */
+inline bool write_binary_file(const std::string& path, const std::string& contents) noexcept {
+    const auto temporary_path = path + ".tmp";
+    {
+        auto file = std::ofstream(temporary_path, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(contents.data(), static_cast<std::streamsize>(contents.size()))) {
+            return false;
+        }
+    }
+    return std::rename(temporary_path.c_str(), path.c_str()) == 0;
+}
+
+/**
+ * BinaryReader reads scalars from a flat binary buffer, failing once the buffer is exhausted.
+ */
+class BinaryReader {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param buffer buffer to read from, outliving the reader
+     * @param offset offset of the first read
+     */
+    BinaryReader(const std::string& buffer, const size_t offset) noexcept
+        : buffer(buffer),
+          offset(offset),
+          failed(false) {}
+
+    /**
+     * Read the next scalar.
+     *
+     * @return read value, zero if the buffer is exhausted
+     */
+    template <typename T> T read() noexcept {
+        auto value = T();
+        read(&value, 1);
+        return value;
+    }
+
+    /**
+     * Read the next scalars at once.
+     *
+     * @param values pointer to the first value to read into
+     * @param count number of values
+     * @return true if the values are read, false if the buffer is exhausted
+     */
+    template <typename T> bool read(T* const values, const size_t count) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (!has(static_cast<uint64_t>(count) * sizeof(T))) {
+            failed = true;
+            return false;
+        }
+        std::memcpy(values, buffer.data() + offset, count * sizeof(T));
+        offset += count * sizeof(T);
+        return true;
+    }
+
+    /**
+     * Check if every read succeeded and the whole buffer was read.
+     *
+     * @return true if the buffer was read exactly, false otherwise
+     */
+    [[nodiscard]] bool done() const noexcept {
+        return !failed && offset == buffer.size();
+    }
+
+    /**
+     * Check if the remaining buffer holds at least the given number of bytes.
+     *
+     * @param bytes number of bytes
+     * @return true if the bytes are available, false otherwise
+     */
+    [[nodiscard]] bool has(const uint64_t bytes) const noexcept {
+        return !failed && bytes <= buffer.size() - offset;
+    }
+
+  private:
+    /// buffer to read from
+    const std::string& buffer;
+
+    /// offset of the next read
+    size_t offset;
+
+    /// true if a read went past the buffer
+    bool failed;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,107 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * CommandLine parses the "--name value" options of a driver program.
+ * Unknown options, missing values, and malformed values terminate the program with the usage,
+ * and "--help" prints the usage and exits.
+ */
+class CommandLine {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param argc number of arguments
+     * @param argv arguments, the program name first
+     * @param option_names names of the accepted options (without "--")
+     * @param usage usage printed by "--help" and on errors
+     */
+    CommandLine(int argc,
+                const char* const argv[],
+                const std::vector<std::string>& option_names,
+                std::string usage) noexcept;
+
+    /**
+     * Check if an option is given.
+     *
+     * @param name name of the option
+     * @return true if given, false otherwise
+     */
+    [[nodiscard]] bool has(const std::string& name) const noexcept;
+
+    /**
+     * Get a string option.
+     *
+     * @param name name of the option
+     * @param default_value value if not given
+     * @return value of the option
+     */
+    [[nodiscard]] std::string get_string(const std::string& name, const std::string& default_value) const noexcept;
+
+    /**
+     * Get a non-negative integer option.
+     *
+     * @param name name of the option
+     * @param default_value value if not given
+     * @return value of the option
+     */
+    [[nodiscard]] uint64_t get_uint64(const std::string& name, uint64_t default_value) const noexcept;
+
+    /**
+     * Get a collective type option: AllGather, ReduceScatter, AllReduce, or AllToAll.
+     *
+     * @param name name of the option
+     * @param default_value value if not given
+     * @return value of the option
+     */
+    [[nodiscard]] CollectiveType get_collective_type(const std::string& name,
+                                                     CollectiveType default_value) const noexcept;
+
+    /**
+     * Get a collective algorithm option: Ring, Direct, HalvingDoubling, or Hierarchical.
+     *
+     * @param name name of the option
+     * @param default_value value if not given
+     * @return value of the option
+     */
+    [[nodiscard]] CollectiveAlgorithm get_collective_algorithm(const std::string& name,
+                                                               CollectiveAlgorithm default_value) const noexcept;
+
+    /**
+     * Get an event queue type option: List, Heap, or TimingWheel.
+     *
+     * @param name name of the option
+     * @param default_value value if not given
+     * @return value of the option
+     */
+    [[nodiscard]] EventQueueType get_event_queue_type(const std::string& name,
+                                                      EventQueueType default_value) const noexcept;
+
+  private:
+    /// usage of the program
+    std::string usage;
+
+    /// value of each given option
+    std::map<std::string, std::string> options;
+
+    /**
+     * Terminate the program with an error and the usage.
+     *
+     * @param message error message
+     */
+    [[noreturn]] void fail(const std::string& message) const noexcept;
+};
+
+}  // namespace NetworkAnalytical
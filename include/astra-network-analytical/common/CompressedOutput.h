@@ -0,0 +1,201 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * CompressedOutput is an output file stream that compresses and writes on a background thread,
+ * so tracing a large run (e.g., link-occupancy traces or chunk logs of an all-to-all, tens of GB raw)
+ * neither stalls the simulation on I/O nor fills up the disk.
+ * Every trace sink accepts one: LinkTrace and CompletionLog write through it,
+ * and logs, stats and dumps can be written to it as to any std::ostream (e.g., Logger::set_output).
+ *
+ * Bytes are buffered into blocks: a full (or flushed) block is handed to the background thread,
+ * at most max_pending_blocks wait at once (beyond that, the writer blocks until one is written),
+ * and written blocks are recycled, so memory stays bounded by (max_pending_blocks + 2) blocks.
+ */
+class CompressedOutput final : public std::ostream {
+  public:
+    /**
+     * Check whether a compression is available in this build.
+     *
+     * @param compression compression to check
+     * @return true if files can be written and read with the compression, false otherwise
+     */
+    [[nodiscard]] static bool supports(Compression compression) noexcept;
+
+    /**
+     * Read a whole file written by a CompressedOutput, decompressing it if compressed.
+     *
+     * @param path path of the file to read
+     * @return decompressed contents of the file
+     */
+    [[nodiscard]] static std::string read_file(const std::string& path) noexcept;
+
+    /**
+     * Constructor.
+     * Opens the file and starts the writer thread.
+     *
+     * @param path path of the file to write
+     * @param compression compression of the file
+     * @param block_size number of bytes buffered before being handed to the writer thread
+     * @param max_pending_blocks most blocks waiting to be written at once
+     */
+    explicit CompressedOutput(const std::string& path,
+                              Compression compression = Compression::Gzip,
+                              size_t block_size = 1 << 20,
+                              int max_pending_blocks = 4) noexcept;
+
+    /**
+     * Destructor.
+     * Closes the file if it's still open.
+     */
+    ~CompressedOutput() noexcept override;
+
+    CompressedOutput(const CompressedOutput&) = delete;
+    CompressedOutput& operator=(const CompressedOutput&) = delete;
+
+    /**
+     * Write the buffered bytes, finish the compressed stream, then close the file.
+     */
+    void close() noexcept;
+
+    /**
+     * Check whether the file is open.
+     *
+     * @return true until closed
+     */
+    [[nodiscard]] bool is_open() const noexcept;
+
+    /**
+     * Get the number of bytes written to the stream so far, before compression.
+     *
+     * @return number of bytes handed to the writer thread
+     */
+    [[nodiscard]] uint64_t get_input_size() const noexcept;
+
+    /**
+     * Get the number of bytes written to the file so far, after compression.
+     *
+     * @return number of bytes written by the writer thread
+     */
+    [[nodiscard]] uint64_t get_output_size() const noexcept;
+
+  private:
+    /**
+     * Stream buffer filling a block in place, handed to the writer thread once full or flushed.
+     */
+    class BlockBuffer final : public std::streambuf {
+      public:
+        /**
+         * Constructor.
+         *
+         * @param output stream the blocks are handed to
+         */
+        explicit BlockBuffer(CompressedOutput& output) noexcept;
+
+        /**
+         * Hand the buffered bytes over, if any.
+         */
+        void hand_over() noexcept;
+
+      protected:
+        int_type overflow(int_type ch) override;
+        int sync() override;
+
+      private:
+        /// stream the blocks are handed to
+        CompressedOutput& output;
+
+        /// block being filled (its size is the block size)
+        std::vector<char> block;
+    };
+
+    /// compressor state, defined along the compression library
+    struct Deflater;
+
+    /// file being written (by the writer thread)
+    std::ofstream file;
+
+    /// compression of the file
+    Compression compression;
+
+    /// compressor of a compressed file (nullptr: bytes are written as is)
+    std::unique_ptr<Deflater> deflater;
+
+    /// number of bytes buffered before being handed over
+    size_t block_size;
+
+    /// most blocks waiting to be written at once
+    int max_pending_blocks;
+
+    /// stream buffer filling blocks
+    BlockBuffer buffer;
+
+    /// blocks waiting to be written, guarded by blocks_mutex
+    std::deque<std::vector<char>> pending_blocks;
+
+    /// written blocks, recycled by the stream buffer, guarded by blocks_mutex
+    std::vector<std::vector<char>> free_blocks;
+
+    /// true once the file is being closed, guarded by blocks_mutex
+    bool closing;
+
+    /// number of bytes handed over so far
+    uint64_t input_size;
+
+    /// number of bytes written to the file so far, guarded by blocks_mutex
+    uint64_t output_size;
+
+    /// guards the blocks
+    mutable std::mutex blocks_mutex;
+
+    /// signals handed over and written blocks
+    std::condition_variable blocks_changed;
+
+    /// background thread compressing and writing the blocks
+    std::thread writer;
+
+    /**
+     * Hand a filled block to the writer thread, waiting for room if too many are pending,
+     * and replace it with an empty block of the block size.
+     *
+     * @param block filled block, resized to its number of bytes
+     */
+    void hand_over(std::vector<char>& block) noexcept;
+
+    /**
+     * Body of the writer thread.
+     */
+    void write_blocks() noexcept;
+
+    /**
+     * Compress (if compressed) and append bytes to the file. Called by the writer thread.
+     *
+     * @param data bytes to write
+     * @param size number of bytes
+     * @param finish true to finish the compressed stream
+     * @return number of bytes written to the file
+     */
+    uint64_t write_bytes(const char* data, size_t size, bool finish) noexcept;
+};
+
+}  // namespace NetworkAnalytical
@@ -6,17 +6,45 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/Type.h"
+#include <cassert>
 #include <tuple>
 
 namespace NetworkAnalytical {
 
+#if NETWORK_ANALYTICAL_CONGESTION_AWARE
+/**
+ * Handler of EventKind::ChunkArrival, implemented by the congestion-aware backend.
+ *
+ * @param chunk_ptr pointer to the chunk arrived at its next device
+ */
+void invoke_chunk_arrival(CallbackArg chunk_ptr) noexcept;
+
+/**
+ * Handler of EventKind::LinkFree, implemented by the congestion-aware backend.
+ *
+ * @param link_ptr pointer to the link becoming free
+ */
+void invoke_link_free(CallbackArg link_ptr) noexcept;
+
+/**
+ * Handler of a run of consecutive EventKind::LinkFree events, implemented by the congestion-aware backend.
+ * The links are freed in the given order, exactly as by invoking the events one by one.
+ *
+ * @param link_ptrs pointers to the links becoming free, in registration order
+ * @param count number of links
+ */
+void invoke_link_frees(const CallbackArg* link_ptrs, int count) noexcept;
+#endif
+
 /**
  * Event is a wrapper for a callback function and its argument.
+ * Internal events of the simulator are tagged with their kind instead,
+ * so that they're dispatched by direct calls.
  */
 class Event {
   public:
     /**
-     * Constructor.
+     * Constructor of a user callback event.
      *
      * @param callback function pointer
      * @param callback_arg argument of the callback function
@@ -24,23 +52,66 @@ class Event {
     Event(Callback callback, CallbackArg callback_arg) noexcept;
 
     /**
-     * Invoke the callback function.
+     * Constructor of an internal event.
+     *
+     * @param event_kind kind of the event, other than EventKind::UserCallback
+     * @param callback_arg argument of the event handler
+     */
+    Event(EventKind event_kind, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Invoke the callback function (or the handler of the event kind).
      */
     void invoke_event() noexcept;
 
+    /**
+     * Get the kind of the event.
+     *
+     * @return kind of the event
+     */
+    [[nodiscard]] EventKind get_kind() const noexcept;
+
     /**
      * Get the callback function and the argument.
      *
-     * @return callback function and its argument
+     * @return callback function (nullptr for internal events) and its argument
      */
     [[nodiscard]] std::pair<Callback, CallbackArg> get_handler_arg() const noexcept;
 
   private:
-    /// pointer to the callback function
+    /// kind of the event
+    EventKind event_kind;
+
+    /// pointer to the callback function (EventKind::UserCallback only)
     Callback callback;
 
     /// argument of the callback function
     CallbackArg callback_arg;
 };
 
+// defined here so that the dispatch is inlined into the event loop
+inline void Event::invoke_event() noexcept {
+    switch (event_kind) {
+    case EventKind::UserCallback:
+        // check the validity of the event
+        assert(callback != nullptr);
+
+        // invoke the callback function
+        (*callback)(callback_arg);
+        break;
+#if NETWORK_ANALYTICAL_CONGESTION_AWARE
+    case EventKind::ChunkArrival:
+        invoke_chunk_arrival(callback_arg);
+        break;
+    case EventKind::LinkFree:
+        invoke_link_free(callback_arg);
+        break;
+#endif
+    default:
+        // internal events are only scheduled by the congestion-aware backend
+        assert(false);
+        break;
+    }
+}
+
 }  // namespace NetworkAnalytical
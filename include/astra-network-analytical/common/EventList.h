@@ -7,7 +7,8 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Event.h"
 #include "common/Type.h"
-#include <list>
+#include <cstdint>
+#include <vector>
 
 namespace NetworkAnalytical {
 
@@ -30,6 +31,14 @@ class EventList {
      */
     [[nodiscard]] EventTime get_event_time() const noexcept;
 
+    /**
+     * Re-register the (empty) event list at a new event time,
+     * so that it can be recycled without reallocating its event storage.
+     *
+     * @param new_event_time new event time of the event list
+     */
+    void reset(EventTime new_event_time) noexcept;
+
     /**
      * Register an event into the event list.
      *
@@ -38,17 +47,69 @@ class EventList {
      */
     void add_event(Callback callback, CallbackArg callback_arg) noexcept;
 
+    /**
+     * Register an event into the event list.
+     *
+     * @param event event to register
+     */
+    void add_event(const Event& event) noexcept;
+
     /**
      * Invoke all events in the event list.
+     * Events added while invoking are also invoked.
+     * Runs of consecutive link-free events (e.g., every link of a synchronous collective phase getting free at once)
+     * are handed over to the backend at once, which frees them in a tight loop.
+     * The event storage is kept for reuse afterwards.
+     *
+     * @return number of invoked events
+     */
+    int invoke_events() noexcept;
+
+    /**
+     * Get the number of registered events (including the invoked ones not yet cleared).
+     *
+     * @return number of registered events
+     */
+    [[nodiscard]] int get_events_count() const noexcept;
+
+    /**
+     * Get a registered event.
+     *
+     * @param index index of the event, in registration order
+     * @return event of the given index
+     */
+    [[nodiscard]] Event get_event(int index) const noexcept;
+
+    /**
+     * Replace a registered event, e.g., to reorder the events not yet invoked.
+     *
+     * @param index index of the event, in registration order
+     * @param event event to register at the index instead
      */
-    void invoke_events() noexcept;
+    void set_event(int index, const Event& event) noexcept;
+
+    /**
+     * Drop every registered event, keeping the storage capacity.
+     * This is used once the events are invoked one by one.
+     */
+    void clear_events() noexcept;
+
+    /**
+     * Get the bytes held by the event list, including its event storage.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
 
   private:
     /// event time of the event list
     EventTime event_time;
 
-    /// list of registered events
-    std::list<Event> events;
+    /// registered events, in registration order
+    std::vector<Event> events;
+
+    /// arguments of the run of link-free events being invoked (kept to reuse the storage)
+    std::vector<CallbackArg> link_free_args;
 };
 
 }  // namespace NetworkAnalytical
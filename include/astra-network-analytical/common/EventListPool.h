@@ -0,0 +1,57 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventList.h"
+#include "common/Type.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * EventListPool recycles processed EventLists.
+ *
+ * A recycled EventList keeps the capacity of its event storage,
+ * so once the pool has warmed up, scheduling events allocates no memory.
+ */
+class EventListPool {
+  public:
+    /**
+     * Constructor.
+     */
+    EventListPool() noexcept;
+
+    /**
+     * Get an empty EventList registered at the given event time.
+     * A recycled EventList is used if available, otherwise a new one is allocated.
+     *
+     * @param event_time event time of the EventList
+     * @return empty EventList
+     */
+    [[nodiscard]] std::unique_ptr<EventList> acquire(EventTime event_time) noexcept;
+
+    /**
+     * Return a processed EventList to the pool.
+     *
+     * @param event_list EventList to recycle
+     */
+    void release(std::unique_ptr<EventList> event_list) noexcept;
+
+    /**
+     * Get the bytes held by the recycled event lists.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
+
+  private:
+    /// EventLists ready to be reused
+    std::vector<std::unique_ptr<EventList>> free_event_lists;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,91 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventList.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * EventListTable maps event times to their EventLists.
+ *
+ * Implemented as an open-addressing hash table with linear probing,
+ * so that lookups touch contiguous memory
+ * and inserting or erasing an entry never allocates
+ * (the table only grows when its load factor exceeds 1/2).
+ */
+class EventListTable {
+  public:
+    /**
+     * Constructor.
+     */
+    EventListTable() noexcept;
+
+    /**
+     * Find the EventList registered at the given event time.
+     *
+     * @param event_time event time to look up
+     * @return registered EventList, nullptr if not found
+     */
+    [[nodiscard]] EventList* find(EventTime event_time) const noexcept;
+
+    /**
+     * Register an EventList at its event time.
+     * The event time should not be registered yet.
+     *
+     * @param event_list EventList to register
+     */
+    void insert(EventList* event_list) noexcept;
+
+    /**
+     * Unregister the EventList at the given event time.
+     *
+     * @param event_time event time to unregister
+     */
+    void erase(EventTime event_time) noexcept;
+
+    /**
+     * Get the bytes held by the table storage (the EventLists aren't owned by the table).
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
+
+  private:
+    /// table entry, empty if event_list is nullptr
+    struct Entry {
+        EventTime event_time;
+        EventList* event_list;
+    };
+
+    /// table storage, size is a power of 2
+    std::vector<Entry> entries;
+
+    /// log2 of the table size
+    int table_size_log2;
+
+    /// number of registered EventLists
+    size_t entries_count;
+
+    /**
+     * Compute the home index of an event time (Fibonacci hashing).
+     *
+     * @param event_time event time to hash
+     * @return index of the table where the probe starts
+     */
+    [[nodiscard]] size_t home_index(EventTime event_time) const noexcept;
+
+    /**
+     * Double the table size and re-register all entries.
+     */
+    void grow() noexcept;
+};
+
+}  // namespace NetworkAnalytical
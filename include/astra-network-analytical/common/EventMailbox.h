@@ -0,0 +1,74 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Event.h"
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include <utility>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * EventMailbox buffers events posted for another EventQueue,
+ * so that they can be delivered at a synchronization point
+ * instead of being scheduled while the target EventQueue is running.
+ */
+class EventMailbox {
+  public:
+    /**
+     * Constructor.
+     */
+    EventMailbox() noexcept;
+
+    /**
+     * Post an event to be delivered later.
+     *
+     * @param event_time time of event
+     * @param callback callback function pointer
+     * @param callback_arg argument of the callback function
+     */
+    void post(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Post an internal event to be delivered later.
+     *
+     * @param event_time time of event
+     * @param event_kind kind of the event, other than EventKind::UserCallback
+     * @param callback_arg argument of the event handler
+     */
+    void post(EventTime event_time, EventKind event_kind, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Schedule every posted event into the target event queue (in posting order),
+     * then empty the mailbox.
+     *
+     * @param event_queue target event queue
+     */
+    void deliver(EventQueue& event_queue) noexcept;
+
+    /**
+     * Move every posted event out (in posting order), e.g., to hand it to another process,
+     * then empty the mailbox.
+     *
+     * @param taken_events output: posted (event time, event), replacing its contents
+     */
+    void take(std::vector<std::pair<EventTime, Event>>& taken_events) noexcept;
+
+    /**
+     * Check if no event is posted.
+     *
+     * @return true if the mailbox is empty, false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+  private:
+    /// posted (event time, event), in posting order
+    std::vector<std::pair<EventTime, Event>> events;
+};
+
+}  // namespace NetworkAnalytical
@@ -6,30 +6,121 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/EventList.h"
+#include "common/EventScheduler.h"
+#include "common/MemoryUsage.h"
+#include "common/NetworkScheduler.h"
+#include "common/Stats.h"
+#include "common/Telemetry.h"
 #include "common/Type.h"
+#include "common/WorkStealingExecutor.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace NetworkAnalytical {
 
+/**
+ * Statistics counters of an EventQueue.
+ * Only updated if NETWORK_ANALYTICAL_ENABLE_STATS is set.
+ */
+struct EventQueueStats {
+    /// number of scheduled events
+    uint64_t events_scheduled = 0;
+
+    /// number of invoked events
+    uint64_t events_processed = 0;
+
+    /// number of EventLists created by scheduled events (i.e., events scheduled at a new event time)
+    uint64_t event_lists_created = 0;
+
+    /// number of processed EventLists (i.e., distinct event times)
+    uint64_t event_lists_processed = 0;
+
+    /// largest number of EventLists pending at once
+    int max_pending_event_lists = 0;
+};
+
+/**
+ * Handle of an event scheduled by EventQueue::schedule_cancellable_event, to cancel or reschedule it.
+ * A handle goes stale once its event is invoked, cancelled or rescheduled.
+ */
+struct EventHandle {
+    /// slot of the event in its event queue
+    uint32_t slot = std::numeric_limits<uint32_t>::max();
+
+    /// generation of the slot when the event was scheduled
+    uint32_t generation = 0;
+};
+
+/**
+ * Bounds of EventQueue::run_bounded: the run stops early once any of them is exceeded.
+ */
+struct RunBounds {
+    /// latest time of interest: events after it aren't invoked
+    EventTime time_bound = std::numeric_limits<EventTime>::max();
+
+    /// most events to invoke (checked between event times, so the last time may take it over)
+    uint64_t events_budget = std::numeric_limits<uint64_t>::max();
+
+    /// most wall-clock time to run, in seconds (checked every few event times)
+    double wall_clock_budget = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * Outcome of EventQueue::run_bounded.
+ */
+struct BoundedRun {
+    /// true if the event queue drained, false if a bound stopped the run
+    bool completed = false;
+
+    /// time of the last event if completed,
+    /// otherwise a lower bound of it: the time of the next pending event (past time_bound if that stopped the run)
+    EventTime finish_time = 0;
+};
+
 /**
  * EventQueue manages scheduled EventLists.
  */
-class EventQueue {
+class EventQueue final : public NetworkScheduler {
   public:
     /**
      * Constructor.
+     *
+     * @param event_queue_type scheduler implementation used to order EventLists
      */
-    EventQueue() noexcept;
+    explicit EventQueue(EventQueueType event_queue_type = EventQueueType::Heap) noexcept;
+
+    /**
+     * Destructor. Drops the events still staged.
+     */
+    ~EventQueue() noexcept override;
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    /**
+     * Get the scheduler implementation of the event queue.
+     *
+     * @return scheduler implementation type
+     */
+    [[nodiscard]] EventQueueType get_event_queue_type() const noexcept;
 
     /**
      * Get current event time of the event queue.
      *
      * @return current event time
      */
-    [[nodiscard]] EventTime get_current_time() const noexcept;
+    [[nodiscard]] EventTime get_current_time() const noexcept override;
 
     /**
      * Check all registered events are invoked.
-     * i.e., check if the event queue is empty.
+     * i.e., check if the event queue is empty (and no event is staged by post_event).
      *
      * @return true if the event queue is empty, false otherwise
      */
@@ -43,21 +134,431 @@ class EventQueue {
      */
     void proceed() noexcept;
 
+    /**
+     * Get the time of the next registered event, without invoking it.
+     * A host simulator may use this as the network's earliest output time
+     * for conservative synchronization with its own event queue.
+     *
+     * @return next event time, std::numeric_limits<EventTime>::max() if the event queue is empty
+     */
+    [[nodiscard]] EventTime get_next_event_time() noexcept;
+
+    /**
+     * Invoke every event registered at or before the given time (including the ones scheduled meanwhile),
+     * then advance the current time to the given time,
+     * so the caller can schedule events from there on.
+     *
+     * @param until_time time to run until, should be at least the current time
+     */
+    void run_until(EventTime until_time) noexcept;
+
+    /**
+     * Invoke events until the event queue is empty.
+     *
+     * @return current event time after the last event
+     */
+    EventTime run_to_completion() noexcept;
+
+    /**
+     * Invoke events until the event queue is empty or a bound is exceeded,
+     * e.g., to drop a candidate of a search as soon as it can't beat the best one so far.
+     * A stopped run can be resumed by another run.
+     *
+     * @param bounds bounds of the run
+     * @return whether the run completed, with its finish time or a lower bound of it
+     */
+    BoundedRun run_bounded(const RunBounds& bounds) noexcept;
+
+    /**
+     * Rewind the event queue to time 0 for another simulation, keeping its storage and settings.
+     * Events still scheduled are dropped without being invoked, and statistics counters are cleared.
+     */
+    void reset() noexcept;
+
+    /// user callback and internal event overloads
+    using NetworkScheduler::schedule_event;
+
     /**
      * Schedule an event with a given event time.
      *
      * @param event_time time of event
+     * @param event event to schedule
+     */
+    void schedule_event(EventTime event_time, const Event& event) noexcept override;
+
+    /**
+     * Schedule a user callback event that can be cancelled or rescheduled later
+     * (e.g., by adaptive routing, failure injection or preemption).
+     * Cancelled events are left in place as tombstones, skipped once reached,
+     * so cancelling is O(1), and events scheduled by schedule_event don't pay for cancellation at all.
+     * EventLists left with tombstones only are dropped without advancing the current time.
+     * This shouldn't be called from events invoked concurrently (see set_parallel_invocation).
+     *
+     * @param event_time time of event, at least the current event time
      * @param callback callback function pointer
      * @param callback_arg argument of the callback function
+     * @return handle of the event
+     */
+    EventHandle schedule_cancellable_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Cancel an event, so it's never invoked.
+     *
+     * @param handle handle of the event
+     * @return true if the event was cancelled, false if it was already invoked or cancelled
+     */
+    bool cancel(EventHandle handle) noexcept;
+
+    /**
+     * Move an event to another event time, i.e., cancel it and schedule it again.
+     *
+     * @param handle handle of the event
+     * @param event_time new time of the event, at least the current event time
+     * @return new handle of the event, a stale handle if the event was already invoked or cancelled
+     */
+    EventHandle reschedule(EventHandle handle, EventTime event_time) noexcept;
+
+    /**
+     * Check whether an event is still scheduled, i.e., neither invoked nor cancelled.
+     *
+     * @param handle handle of the event
+     * @return true if the event is still scheduled, false otherwise
+     */
+    [[nodiscard]] bool is_scheduled(EventHandle handle) const noexcept;
+
+    /**
+     * Stage an event from any thread, e.g., a host worker injecting chunks while the simulation thread runs.
+     * Staged events are pushed to a lock-free stack, which the simulation thread drains
+     * (in posting order per producer) into the event queue before proceeding, checking the next event time,
+     * or running until a time.
+     * Events staged for a time already passed by then are scheduled at the current time.
+     *
+     * @param event_time time of event
+     * @param callback callback function pointer, invoked on the simulation thread
+     * @param callback_arg argument of the callback function
      */
-    void schedule_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+    void post_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Schedule the events staged by post_event so far.
+     * Called by the simulation thread only.
+     */
+    void drain_posted_events() noexcept;
+
+    /**
+     * Get the number of events invoked so far (since construction or the last reset),
+     * counted regardless of the statistics counters.
+     *
+     * @return number of invoked events
+     */
+    [[nodiscard]] uint64_t get_invoked_events_count() const noexcept;
+
+    /**
+     * Get the statistics counters of the event queue.
+     *
+     * @return statistics counters
+     */
+    [[nodiscard]] const EventQueueStats& get_stats() const noexcept;
+
+    /**
+     * Get the memory held by the scheduled EventLists (bytes),
+     * and by the EventLists recycled for reuse as well (peak_bytes).
+     * This is collected regardless of NETWORK_ANALYTICAL_ENABLE_STATS.
+     *
+     * @return memory usage of the event queue
+     */
+    [[nodiscard]] MemoryUsage get_memory_usage() const noexcept;
+
+    /**
+     * Register the resource events of the given callback touch.
+     * Events of unregistered callbacks always run alone.
+     *
+     * @param callback callback function pointer
+     * @param resource function returning the resource touched by an event of the callback
+     */
+    void register_event_resource(Callback callback, EventResource resource) noexcept;
+
+    /**
+     * Register the resource internal events of the given kind touch.
+     *
+     * @param event_kind kind of the events, other than EventKind::UserCallback
+     * @param resource function returning the resource touched by an event of the kind
+     */
+    void register_event_resource(EventKind event_kind, EventResource resource) noexcept;
+
+    /**
+     * Register the order key of the events of the given callback (see set_deterministic_order).
+     * Events of unregistered callbacks have key 0.
+     *
+     * @param callback callback function pointer
+     * @param order_key function returning the order key of an event of the callback
+     */
+    void register_event_order_key(Callback callback, EventOrderKey order_key) noexcept;
+
+    /**
+     * Register the order key of the internal events of the given kind (see set_deterministic_order).
+     *
+     * @param event_kind kind of the events, other than EventKind::UserCallback
+     * @param order_key function returning the order key of an event of the kind
+     */
+    void register_event_order_key(EventKind event_kind, EventOrderKey order_key) noexcept;
+
+    /**
+     * Invoke the events of the same event time in an explicit total order, rather than in registration order:
+     * by event kind, then by order key (e.g., the link or device the event touches, see register_event_order_key),
+     * then by registration order among events of equal kind and key.
+     * Registration order follows call order, which differs between sequential, parallel and distributed engines
+     * (e.g., arrivals crossing partitions are registered at synchronization points),
+     * so ordering by simulation state lets every engine produce bit-identical results.
+     * Events scheduled at the current time while invoking are ordered in turn, once the earlier ones are invoked.
+     *
+     * @param enabled true to order the events, false to invoke them in registration order (default)
+     */
+    void set_deterministic_order(bool enabled) noexcept;
+
+    /**
+     * Invoke independent events of the same event time concurrently.
+     * Consecutive events with registered resources form a batch:
+     * events touching the same resource run in registration order on the same worker,
+     * and events scheduled while invoking are registered in the batch's event order afterwards,
+     * so the simulation proceeds exactly as if the events were invoked one by one.
+     * An event without a resource (nullptr or unregistered) runs alone between batches.
+     *
+     * @param threads_count number of worker threads (0: number of hardware threads, 1: disabled)
+     * @param min_batch_size smaller batches are invoked serially, as spawning workers costs more
+     */
+    void set_parallel_invocation(int threads_count, int min_batch_size = 64) noexcept;
+
+    /**
+     * Publish the progress of the simulation (current time, events processed, pending EventLists)
+     * to the given telemetry every publish interval of EventLists, and once run_to_completion finishes.
+     * This is independent of NETWORK_ANALYTICAL_ENABLE_STATS.
+     *
+     * @param new_telemetry telemetry to publish to, nullptr to stop publishing
+     */
+    void set_telemetry(std::shared_ptr<Telemetry> new_telemetry) noexcept;
+
+    /**
+     * Quantize event times for approximate simulation: events are scheduled at their time rounded up
+     * to a multiple of the quantum, so events of nearby times merge into the same EventList
+     * (fewer distinct event times and queue operations), each event delayed by less than a quantum.
+     * Rounding up keeps causality: no event is scheduled before the current time.
+     * Combine with Topology::set_chunk_coalescing, so the chunks arriving together at a link are batched.
+     * This should be set before any event is scheduled.
+     *
+     * @param quantum time quantum, 1 for exact event times (default)
+     */
+    void set_time_quantum(EventTime quantum) noexcept;
+
+    /**
+     * Get the time quantum event times are rounded up to.
+     *
+     * @return time quantum, 1 if event times are exact
+     */
+    [[nodiscard]] EventTime get_time_quantum() const noexcept;
+
+    /**
+     * Get the relative timing error the time quantum was assumed to introduce so far, i.e.,
+     * (quantum - 1) / (shortest positive delay an event was scheduled with).
+     * Every step of a chain of events adds less than a quantum to a delay of at least the shortest one,
+     * so the time a chain ends at is late by at most this fraction of its duration,
+     * as long as quantization doesn't change the delays themselves (e.g., by reordering contending chunks).
+     * A bound of 1 or more means the quantum is too coarse for the delays of the simulation.
+     *
+     * @return bound of the relative timing error, 0 if event times are exact
+     */
+    [[nodiscard]] double get_time_error_bound() const noexcept;
 
   private:
+    /// (event time, event) scheduled while invoking a batch
+    using DeferredEvent = std::pair<EventTime, Event>;
+
+    /// event scheduled by schedule_cancellable_event
+    struct CancellableEvent {
+        /// event queue the event is scheduled on
+        EventQueue* event_queue;
+
+        /// callback function pointer
+        Callback callback;
+
+        /// argument of the callback function
+        CallbackArg callback_arg;
+
+        /// slot of the event
+        uint32_t slot;
+
+        /// generation of the slot, bumped whenever the slot is released
+        uint32_t generation;
+
+        /// true while the event is scheduled, false once cancelled (a tombstone) or released
+        bool scheduled;
+    };
+
+    /// event being ordered, with its sort key
+    struct OrderedEvent {
+        /// kind of the event
+        EventKind event_kind;
+
+        /// order key of the event
+        uint64_t order_key;
+
+        /// registration index of the event
+        int index;
+
+        /// event to order
+        Event event;
+    };
+
+    /// event staged by post_event
+    struct PostedEvent {
+        /// time of the event
+        EventTime event_time;
+
+        /// staged event
+        Event event;
+
+        /// event posted before this one (nullptr if first)
+        PostedEvent* previous;
+    };
+
+    /// event queue whose batch the calling thread is invoking (nullptr if none)
+    static thread_local EventQueue* deferring_event_queue;
+
+    /// events scheduled by the event the calling thread is invoking
+    static thread_local std::vector<DeferredEvent>* deferred_events;
+
     /// current time of the event queue
     EventTime current_time;
 
-    /// list of EventLists
-    std::list<EventList> event_queue;
+    /// scheduler implementation type
+    EventQueueType event_queue_type;
+
+    /// scheduler holding the EventLists
+    std::unique_ptr<EventScheduler> event_queue;
+
+    /// statistics counters
+    EventQueueStats stats;
+
+    /// registered resources, per callback
+    std::unordered_map<Callback, EventResource> event_resources;
+
+    /// registered resources, per internal event kind
+    std::array<EventResource, 3> event_resources_per_kind;
+
+    /// registered order keys, per callback
+    std::unordered_map<Callback, EventOrderKey> event_order_keys;
+
+    /// registered order keys, per internal event kind
+    std::array<EventOrderKey, 3> event_order_keys_per_kind;
+
+    /// whether the events of the same time are invoked in an explicit total order
+    bool deterministic_order;
+
+    /// events being ordered (kept to reuse the storage)
+    std::vector<OrderedEvent> ordered_events;
+
+    /// workers invoking batches (nullptr: events are invoked one by one)
+    std::unique_ptr<WorkStealingExecutor> executor;
+
+    /// smallest batch invoked concurrently
+    int min_batch_size;
+
+    /// slots of cancellable events (a deque, so events keep pointing to their slot as it grows)
+    std::deque<CancellableEvent> cancellable_events;
+
+    /// slots of cancellable events free for reuse
+    std::vector<uint32_t> free_cancellable_slots;
+
+    /// number of events in the EventLists (including tombstones)
+    uint64_t queued_events_count;
+
+    /// number of cancelled events still in the EventLists
+    uint64_t tombstones_count;
+
+    /// number of events invoked so far (counted regardless of statistics, for event budgets)
+    uint64_t invoked_events_total;
+
+    /// latest event staged by post_event (nullptr if none)
+    std::atomic<PostedEvent*> posted_events;
+
+    /// telemetry the progress is published to (nullptr: none)
+    std::shared_ptr<Telemetry> telemetry;
+
+    /// EventLists left to process until the progress is published next
+    int telemetry_countdown;
+
+    /// events processed since the telemetry was set
+    uint64_t telemetry_events_processed;
+
+    /// time quantum event times are rounded up to (1: exact event times)
+    EventTime time_quantum;
+
+    /// shortest positive delay an event was scheduled with while quantizing (max: none yet)
+    EventTime min_event_delay;
+
+    /**
+     * Publish the progress to the telemetry, and restart the countdown to the next publication.
+     */
+    void publish_telemetry() noexcept;
+
+    /**
+     * Invoke the events of an EventList, running independent events concurrently.
+     *
+     * @param event_list EventList to invoke
+     * @return number of invoked events
+     */
+    int invoke_events_in_parallel(EventList& event_list) noexcept;
+
+    /**
+     * Invoke a cancellable event, unless cancelled, releasing its slot.
+     *
+     * @param event_ptr pointer to the cancellable event
+     */
+    static void invoke_cancellable_event(void* event_ptr) noexcept;
+
+    /**
+     * Release the slot of a cancellable event once reached.
+     *
+     * @param event cancellable event
+     */
+    void release_cancellable_event(CancellableEvent& event) noexcept;
+
+    /**
+     * Drop the EventLists at the front holding tombstones only, without advancing the current time.
+     */
+    void drop_cancelled_event_lists() noexcept;
+
+    /**
+     * Invoke the events of an EventList one by one, in the deterministic order.
+     *
+     * @param event_list EventList to invoke
+     * @return number of invoked events
+     */
+    int invoke_events_in_order(EventList& event_list) noexcept;
+
+    /**
+     * Sort the events of an EventList not yet invoked into the deterministic order.
+     *
+     * @param event_list EventList to order
+     * @param first_index index of the first event not yet invoked
+     */
+    void order_events(EventList& event_list, int first_index) noexcept;
+
+    /**
+     * Get the order key of an event.
+     *
+     * @param event event to check
+     * @return order key of the event, 0 if unregistered
+     */
+    [[nodiscard]] uint64_t get_event_order_key(const Event& event) const noexcept;
+
+    /**
+     * Get the resource an event touches.
+     *
+     * @param event event to check
+     * @return resource of the event, nullptr if the event should run alone
+     */
+    [[nodiscard]] const void* get_event_resource(const Event& event) const noexcept;
 };
 
 }  // namespace NetworkAnalytical
@@ -0,0 +1,84 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventList.h"
+#include "common/MemoryUsage.h"
+#include "common/Type.h"
+
+namespace NetworkAnalytical {
+
+/**
+ * EventScheduler abstracts the data structure
+ * EventQueue uses to keep scheduled EventLists ordered by their event time.
+ *
+ * An EventList returned by the scheduler must stay valid
+ * until it is dropped with pop_front(),
+ * even if other EventLists are inserted in the meantime.
+ */
+class EventScheduler {
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~EventScheduler() noexcept = default;
+
+    /**
+     * Check if there's no scheduled EventList.
+     *
+     * @return true if no EventList is scheduled, false otherwise
+     */
+    [[nodiscard]] virtual bool empty() const noexcept = 0;
+
+    /**
+     * Get the number of scheduled EventLists.
+     *
+     * @return number of scheduled EventLists
+     */
+    [[nodiscard]] virtual int size() const noexcept = 0;
+
+    /**
+     * Get the EventList with the smallest event time.
+     *
+     * @return EventList with the earliest event time
+     */
+    [[nodiscard]] virtual EventList& front() noexcept = 0;
+
+    /**
+     * Drop the EventList with the smallest event time.
+     */
+    virtual void pop_front() noexcept = 0;
+
+    /**
+     * Get the EventList registered at the given event time.
+     * If there's no such EventList, a new one is created.
+     *
+     * @param event_time event time of the EventList
+     * @return EventList registered at event_time
+     */
+    [[nodiscard]] virtual EventList& get_or_create(EventTime event_time) noexcept = 0;
+
+    /**
+     * Drop every scheduled EventList (recycling its storage),
+     * so event times may start over from 0.
+     */
+    virtual void clear() noexcept {
+        while (!empty()) {
+            pop_front();
+        }
+    }
+
+    /**
+     * Get the memory held by the scheduler:
+     * bytes of the scheduled EventLists and the scheduler's own storage,
+     * plus the recycled EventLists kept for reuse as the peak.
+     *
+     * @return memory usage of the scheduler
+     */
+    [[nodiscard]] virtual MemoryUsage get_memory_usage() const noexcept = 0;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,366 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkScheduler.h"
+#include "common/Type.h"
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * A node of a (Chakra) execution trace.
+ */
+struct ExecutionTraceNode {
+    /// id of the node, increasing along its trace
+    uint64_t id = 0;
+
+    /// type of the node
+    ExecutionTraceNodeType node_type = ExecutionTraceNodeType::Compute;
+
+    /// pattern of a collective node
+    CollectiveType collective_type = CollectiveType::AllReduce;
+
+    /// peer NPU of a send (destination) or recv (source) node
+    DeviceId peer = -1;
+
+    /// message size of a communication node
+    ChunkSize size = 0;
+
+    /// tag matching a send with its recv
+    int tag = 0;
+
+    /// duration of a compute node
+    EventTime duration = 0;
+
+    /// ids of the earlier nodes this node depends on
+    std::vector<uint64_t> dependencies;
+};
+
+/**
+ * ExecutionTraceReader streams the nodes of one NPU's execution trace.
+ *
+ * The trace is a text export of the Chakra node attributes, one node per line
+ * (empty lines and lines starting with '#' are skipped), e.g.:
+ *   id=1 type=COMP_NODE duration_micros=5
+ *   id=2 type=COMM_SEND_NODE comm_dst=3 comm_size=1048576 comm_tag=0 deps=1
+ *   id=3 type=COMM_RECV_NODE comm_src=3 comm_size=1048576 comm_tag=0
+ *   id=4 type=COMM_COLL_NODE comm_type=ALL_REDUCE comm_size=4194304 deps=2,3
+ * comm_type is one of ALL_REDUCE, ALL_GATHER, REDUCE_SCATTER, ALL_TO_ALL.
+ */
+class ExecutionTraceReader {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param trace_path path of the trace file
+     */
+    explicit ExecutionTraceReader(const std::string& trace_path) noexcept;
+
+    /**
+     * Read the next node of the trace.
+     *
+     * @param node output: next node
+     * @return true if a node was read, false at the end of the trace
+     */
+    bool next(ExecutionTraceNode& node) noexcept;
+
+  private:
+    /// path of the trace file
+    std::string trace_path;
+
+    /// trace file
+    std::ifstream trace_file;
+
+    /// line number of the last read line
+    int line_number;
+
+    /**
+     * Report an invalid line of the trace and exit.
+     *
+     * @param message description of the problem
+     */
+    [[noreturn]] void parse_error(const std::string& message) const noexcept;
+};
+
+/**
+ * ExecutionTraceNetwork abstracts the backend an execution trace is replayed on.
+ */
+class ExecutionTraceNetwork {
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~ExecutionTraceNetwork() noexcept = default;
+
+    /**
+     * Get the scheduler the network is driven by.
+     *
+     * @return scheduler of the network
+     */
+    [[nodiscard]] virtual NetworkScheduler& get_scheduler() noexcept = 0;
+
+    /**
+     * Get the number of NPUs of the network.
+     *
+     * @return number of NPUs
+     */
+    [[nodiscard]] virtual int get_npus_count() const noexcept = 0;
+
+    /**
+     * Send a message, invoking the callback once it's delivered.
+     *
+     * @param src NPU sending the message
+     * @param dest NPU receiving the message
+     * @param size size of the message
+     * @param callback callback to be invoked when the message is delivered
+     * @param callback_arg argument of the callback
+     */
+    virtual void send(DeviceId src, DeviceId dest, ChunkSize size, Callback callback, CallbackArg callback_arg) noexcept = 0;
+
+    /**
+     * Run a collective among all NPUs, invoking the callback once it finishes.
+     *
+     * @param collective_type collective communication pattern
+     * @param size size of the buffer each NPU holds
+     * @param callback callback to be invoked when the collective finishes
+     * @param callback_arg argument of the callback
+     */
+    virtual void run_collective(CollectiveType collective_type,
+                                ChunkSize size,
+                                Callback callback,
+                                CallbackArg callback_arg) noexcept = 0;
+};
+
+/**
+ * ExecutionTraceReplay replays the communication of per-NPU execution traces on a network.
+ *
+ * Traces are streamed: each NPU keeps a window of at most window_size nodes that were read but not completed,
+ * and reads further nodes as its nodes complete, so memory stays flat regardless of the trace length.
+ * Dependencies are resolved incrementally, and should refer to earlier nodes of the same trace.
+ *   - compute nodes complete after their duration
+ *   - send nodes send a message to their peer and complete once it's delivered
+ *   - recv nodes complete once they're ready and the matching (src, tag) message was delivered
+ *   - the i-th collective node of every NPU forms a collective, which starts once all of them are ready
+ * A window too small to hold a node waiting on another NPU may stall the replay (see finished()).
+ */
+class ExecutionTraceReplay {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param network network to replay the traces on
+     * @param trace_paths trace file of every NPU, indexed by NPU id
+     * @param window_size maximum number of read but not completed nodes per NPU
+     */
+    ExecutionTraceReplay(ExecutionTraceNetwork& network,
+                         const std::vector<std::string>& trace_paths,
+                         int window_size = 1024) noexcept;
+
+    /**
+     * Issue the first ready nodes of every trace.
+     * The simulation is then driven by the network's scheduler.
+     *
+     * @param callback callback to be invoked when every node completed (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    void start(Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Check if every node of every trace completed.
+     *
+     * @return true if the replay finished, false otherwise
+     */
+    [[nodiscard]] bool finished() const noexcept;
+
+    /**
+     * Get the time the last node completed.
+     *
+     * @return finish time of the replay
+     */
+    [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+    /**
+     * Get the number of completed nodes.
+     *
+     * @return number of completed nodes
+     */
+    [[nodiscard]] uint64_t get_completed_nodes_count() const noexcept;
+
+    /**
+     * Get the largest number of nodes an NPU held in its window at once.
+     *
+     * @return peak window occupancy
+     */
+    [[nodiscard]] int get_peak_window_size() const noexcept;
+
+  private:
+    /// a read but not completed node
+    struct WindowNode {
+        /// the node
+        ExecutionTraceNode node;
+
+        /// number of dependencies not completed yet
+        int pending_dependencies = 0;
+
+        /// ids of the window nodes depending on this node
+        std::vector<uint64_t> dependents;
+    };
+
+    /// streaming state of an NPU's trace
+    struct Trace {
+        /// reader of the trace
+        ExecutionTraceReader reader;
+
+        /// read but not completed nodes, per id
+        std::unordered_map<uint64_t, WindowNode> window;
+
+        /// true once every node was read
+        bool exhausted = false;
+
+        /// true once a node was read
+        bool started = false;
+
+        /// id of the last read node
+        uint64_t last_read_id = 0;
+
+        /// number of collective nodes issued so far
+        int collectives_issued = 0;
+
+        explicit Trace(const std::string& trace_path) noexcept : reader(trace_path) {}
+    };
+
+    /// an issued node, passed as the callback argument of its operation
+    struct Operation {
+        /// replay the node belongs to
+        ExecutionTraceReplay* replay;
+
+        /// NPU of the node (the receiving NPU for sends)
+        DeviceId npu;
+
+        /// id of the node
+        uint64_t node_id;
+
+        /// sequence number of a collective node (-1: not a collective)
+        int collective_id;
+    };
+
+    /// ready recv nodes and delivered messages, matched per (dest, src, tag)
+    using MessageKey = std::tuple<DeviceId, DeviceId, int>;
+
+    /// network to replay the traces on
+    ExecutionTraceNetwork& network;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// maximum number of read but not completed nodes per NPU
+    int window_size;
+
+    /// streaming state, per NPU
+    std::deque<Trace> traces;
+
+    /// nodes whose dependencies completed, to be issued
+    std::vector<std::pair<DeviceId, uint64_t>> ready_nodes;
+
+    /// true while ready nodes are being issued
+    bool issuing;
+
+    /// true once the finish callback was invoked
+    bool finish_reported;
+
+    /// ready recv nodes waiting for their message, per (dest, src, tag)
+    std::map<MessageKey, std::deque<uint64_t>> waiting_recvs;
+
+    /// delivered messages not received yet, per (dest, src, tag)
+    std::map<MessageKey, int> unmatched_messages;
+
+    /// ready (npu, node id) of every collective, per collective sequence number
+    std::unordered_map<int, std::vector<std::pair<DeviceId, uint64_t>>> ready_collectives;
+
+    /// number of completed nodes
+    uint64_t completed_nodes_count;
+
+    /// largest window occupancy
+    int peak_window_size;
+
+    /// time the last node completed
+    EventTime finish_time;
+
+    /// callback to be invoked when every node completed
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+
+    /// storage of issued operations (stable addresses, grows to the peak in-flight count)
+    std::deque<Operation> operations;
+
+    /// operations ready to be reused
+    std::vector<Operation*> free_operations;
+
+    /**
+     * Callback of compute node completions and collective completions.
+     *
+     * @param operation_ptr pointer to the completed operation
+     */
+    static void operation_completed(void* operation_ptr) noexcept;
+
+    /**
+     * Callback of delivered send messages.
+     *
+     * @param operation_ptr pointer to the delivered operation
+     */
+    static void message_delivered(void* operation_ptr) noexcept;
+
+    /**
+     * Read nodes of an NPU's trace until its window is full or the trace ends.
+     *
+     * @param npu NPU id
+     */
+    void fill_window(DeviceId npu) noexcept;
+
+    /**
+     * Issue the ready nodes, including the ones they make ready,
+     * then invoke the finish callback if every node completed.
+     */
+    void issue_ready_nodes() noexcept;
+
+    /**
+     * Issue a node whose dependencies completed.
+     *
+     * @param npu NPU of the node
+     * @param node_id id of the node
+     */
+    void issue_node(DeviceId npu, uint64_t node_id) noexcept;
+
+    /**
+     * Complete a node: release its dependents and read further nodes.
+     *
+     * @param npu NPU of the node
+     * @param node_id id of the node
+     */
+    void complete_node(DeviceId npu, uint64_t node_id) noexcept;
+
+    /**
+     * Take an operation slot.
+     *
+     * @param npu NPU of the node
+     * @param node_id id of the node
+     * @param collective_id sequence number of a collective node (-1: not a collective)
+     * @return operation
+     */
+    Operation* acquire_operation(DeviceId npu, uint64_t node_id, int collective_id) noexcept;
+};
+
+}  // namespace NetworkAnalytical
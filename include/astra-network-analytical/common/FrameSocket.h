@@ -0,0 +1,54 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace NetworkAnalytical {
+
+/*
+ * Frames are the messages of the socket protocols (QueryServer, distributed sweeps):
+ * a length (u64, native byte order) followed by that many bytes.
+ */
+
+/**
+ * Send a frame through a socket.
+ *
+ * @param fd socket
+ * @param frame bytes of the frame
+ * @return true if sent, false if the peer is gone
+ */
+bool send_frame(int fd, const std::string& frame) noexcept;
+
+/**
+ * Receive a frame from a socket, blocking until it's complete.
+ *
+ * @param fd socket
+ * @param frame output: bytes of the frame
+ * @return true if received, false if the peer is gone or the frame is implausibly large
+ */
+bool receive_frame(int fd, std::string& frame) noexcept;
+
+/**
+ * Listen on a TCP port of every interface.
+ *
+ * @param port port to listen on (0: any free port)
+ * @param bound_port output: port listened on
+ * @return listening socket, -1 if the port can't be listened on
+ */
+[[nodiscard]] int listen_tcp(uint16_t port, uint16_t& bound_port) noexcept;
+
+/**
+ * Connect to a TCP port.
+ *
+ * @param host host name or address
+ * @param port port to connect to
+ * @return connected socket, -1 if the connection failed
+ */
+[[nodiscard]] int connect_tcp(const std::string& host, uint16_t port) noexcept;
+
+}  // namespace NetworkAnalytical
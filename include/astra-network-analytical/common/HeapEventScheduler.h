@@ -0,0 +1,90 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventListPool.h"
+#include "common/EventListTable.h"
+#include "common/EventScheduler.h"
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * HeapEventScheduler keeps EventLists in a binary min-heap keyed by event time.
+ * A hash table from event time to EventList preserves same-timestamp batching,
+ * so inserting a new event time takes O(log n) time
+ * and appending to an existing event time takes O(1) time.
+ * Processed EventLists are recycled through an EventListPool.
+ */
+class HeapEventScheduler final : public EventScheduler {
+  public:
+    /**
+     * Constructor.
+     */
+    HeapEventScheduler() noexcept;
+
+    /**
+     * Implementation of empty function in EventScheduler.
+     */
+    [[nodiscard]] bool empty() const noexcept override;
+
+    /**
+     * Implementation of size function in EventScheduler.
+     */
+    [[nodiscard]] int size() const noexcept override;
+
+    /**
+     * Implementation of front function in EventScheduler.
+     */
+    [[nodiscard]] EventList& front() noexcept override;
+
+    /**
+     * Implementation of pop_front function in EventScheduler.
+     */
+    void pop_front() noexcept override;
+
+    /**
+     * Implementation of get_or_create function in EventScheduler.
+     */
+    [[nodiscard]] EventList& get_or_create(EventTime event_time) noexcept override;
+
+    /**
+     * Implementation of get_memory_usage function in EventScheduler.
+     */
+    [[nodiscard]] MemoryUsage get_memory_usage() const noexcept override;
+
+    /**
+     * Remove the EventList with the smallest event time from the heap
+     * and hand its ownership over to the caller.
+     *
+     * @return EventList with the earliest event time
+     */
+    [[nodiscard]] std::unique_ptr<EventList> extract_front() noexcept;
+
+  private:
+    /// min-heap of EventLists, ordered by event time
+    /// EventLists are heap-allocated so that references stay valid while the heap is reordered
+    std::vector<std::unique_ptr<EventList>> heap;
+
+    /// table[event time] -> EventList registered at that time
+    EventListTable event_lists;
+
+    /// recycled EventLists
+    EventListPool event_list_pool;
+
+    /**
+     * Heap ordering: an EventList with a later event time has a lower priority.
+     *
+     * @param lhs first EventList
+     * @param rhs second EventList
+     * @return true if lhs should be placed below rhs in the heap
+     */
+    [[nodiscard]] static bool later(const std::unique_ptr<EventList>& lhs,
+                                    const std::unique_ptr<EventList>& rhs) noexcept;
+};
+
+}  // namespace NetworkAnalytical
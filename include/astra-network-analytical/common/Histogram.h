@@ -0,0 +1,150 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * Histogram counts non-negative integer samples (e.g., latencies) in constant memory, HDR-style:
+ * values below 2^precision_bits are counted exactly, larger ones in log-linear buckets,
+ * each power of two being split into 2^(precision_bits - 1) buckets of equal width,
+ * so every value is reported within a relative error of 2^-(precision_bits - 1).
+ * Recording a sample is a few bit operations and a counter increment.
+ */
+class Histogram {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param precision_bits bits of every value kept exactly (1 to 16; 7: within 1.6%)
+     */
+    explicit Histogram(int precision_bits = 7) noexcept;
+
+    /**
+     * Record a sample.
+     *
+     * @param value value of the sample
+     */
+    void record(const uint64_t value) noexcept {
+        counts[bucket_index(value)]++;
+        count++;
+        sum += value;
+        min = (value < min) ? value : min;
+        max = (value > max) ? value : max;
+    }
+
+    /**
+     * Add every sample of another histogram of the same precision.
+     *
+     * @param other histogram to merge
+     */
+    void merge(const Histogram& other) noexcept;
+
+    /**
+     * Drop every sample.
+     */
+    void reset() noexcept;
+
+    /**
+     * Get the number of samples.
+     *
+     * @return number of samples
+     */
+    [[nodiscard]] uint64_t get_count() const noexcept;
+
+    /**
+     * Get the smallest sample.
+     *
+     * @return smallest sample (0 if none)
+     */
+    [[nodiscard]] uint64_t get_min() const noexcept;
+
+    /**
+     * Get the largest sample.
+     *
+     * @return largest sample (0 if none)
+     */
+    [[nodiscard]] uint64_t get_max() const noexcept;
+
+    /**
+     * Get the mean of the samples (exact, as their sum is kept).
+     *
+     * @return mean of the samples (0 if none)
+     */
+    [[nodiscard]] double get_mean() const noexcept;
+
+    /**
+     * Get a percentile of the samples: the largest value of the bucket holding it, capped by the largest sample.
+     *
+     * @param percentile percentile, in [0, 100]
+     * @return value at the percentile (0 if no sample)
+     */
+    [[nodiscard]] uint64_t get_percentile(double percentile) const noexcept;
+
+    /**
+     * Get the number of buckets, i.e., the memory held by the histogram in counters.
+     *
+     * @return number of buckets
+     */
+    [[nodiscard]] int get_buckets_count() const noexcept;
+
+  private:
+    /// bits of every value kept exactly
+    int precision_bits;
+
+    /// number of values counted exactly (2^precision_bits)
+    uint64_t exact_count;
+
+    /// number of buckets per power of two beyond the exact values (2^(precision_bits - 1))
+    uint64_t half_count;
+
+    /// number of samples of each bucket
+    std::vector<uint64_t> counts;
+
+    /// number of samples
+    uint64_t count;
+
+    /// sum of the samples
+    uint64_t sum;
+
+    /// smallest sample
+    uint64_t min;
+
+    /// largest sample
+    uint64_t max;
+
+    /**
+     * Get the bucket of a value.
+     *
+     * @param value value
+     * @return index of the bucket
+     */
+    [[nodiscard]] uint64_t bucket_index(const uint64_t value) const noexcept {
+        if (value < exact_count) {
+            return value;
+        }
+
+        // the power of two of the value selects the bucket group, its next precision bits the bucket
+        const auto magnitude = 63 - __builtin_clzll(value);
+        const auto shift = magnitude - precision_bits + 1;
+        return exact_count + (static_cast<uint64_t>(magnitude - precision_bits) * half_count) +
+               ((value >> shift) - half_count);
+    }
+
+    /**
+     * Get the largest value of a bucket.
+     *
+     * @param index index of the bucket
+     * @return largest value counted by the bucket
+     */
+    [[nodiscard]] uint64_t bucket_max(uint64_t index) const noexcept;
+};
+
+}  // namespace NetworkAnalytical
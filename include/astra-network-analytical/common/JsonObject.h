@@ -0,0 +1,134 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace NetworkAnalytical {
+
+/**
+ * JsonObject builds a JSON object of results, e.g., the report of a driver program,
+ * keeping its members in insertion order.
+ */
+class JsonObject {
+  public:
+    /**
+     * Add a string member.
+     *
+     * @param key key of the member
+     * @param value value of the member
+     * @return this object
+     */
+    JsonObject& add(const std::string& key, const std::string& value) noexcept {
+        add_key(key);
+        append_string(value);
+        return *this;
+    }
+
+    /**
+     * Add a string member.
+     *
+     * @param key key of the member
+     * @param value value of the member
+     * @return this object
+     */
+    JsonObject& add(const std::string& key, const char* const value) noexcept {
+        return add(key, std::string(value));
+    }
+
+    /**
+     * Add a nested object member.
+     *
+     * @param key key of the member
+     * @param value value of the member
+     * @return this object
+     */
+    JsonObject& add(const std::string& key, const JsonObject& value) noexcept {
+        add_key(key);
+        members += value.str();
+        return *this;
+    }
+
+    /**
+     * Add a boolean or number member (non-finite numbers are written as null).
+     *
+     * @param key key of the member
+     * @param value value of the member
+     * @return this object
+     */
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    JsonObject& add(const std::string& key, const T value) noexcept {
+        add_key(key);
+        if constexpr (std::is_same_v<T, bool>) {
+            members += value ? "true" : "false";
+        } else if constexpr (std::is_integral_v<T>) {
+            members += std::to_string(value);
+        } else if (!std::isfinite(value)) {
+            members += "null";
+        } else {
+            auto number = std::ostringstream();
+            number.precision(std::numeric_limits<T>::digits10);
+            number << value;
+            members += number.str();
+        }
+        return *this;
+    }
+
+    /**
+     * Get the JSON text of the object.
+     *
+     * @return JSON text
+     */
+    [[nodiscard]] std::string str() const noexcept {
+        return "{" + members + "}";
+    }
+
+  private:
+    /// JSON text of the members, comma-separated
+    std::string members;
+
+    /**
+     * Start a member with its key.
+     *
+     * @param key key of the member
+     */
+    void add_key(const std::string& key) noexcept {
+        if (!members.empty()) {
+            members += ", ";
+        }
+        append_string(key);
+        members += ": ";
+    }
+
+    /**
+     * Append a string, escaped.
+     *
+     * @param value string to append
+     */
+    void append_string(const std::string& value) noexcept {
+        members += '"';
+        for (const auto character : value) {
+            if (character == '"' || character == '\\') {
+                members += '\\';
+                members += character;
+            } else if (static_cast<unsigned char>(character) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(character));
+                members += escaped;
+            } else {
+                members += character;
+            }
+        }
+        members += '"';
+    }
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,64 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventScheduler.h"
+#include <list>
+
+namespace NetworkAnalytical {
+
+/**
+ * ListEventScheduler keeps EventLists in a sorted linked list.
+ * Inserting a new event time takes O(n) time,
+ * n being the number of scheduled event times.
+ * Processed list nodes are spliced into a free list and reused, so they are not reallocated.
+ */
+class ListEventScheduler final : public EventScheduler {
+  public:
+    /**
+     * Constructor.
+     */
+    ListEventScheduler() noexcept;
+
+    /**
+     * Implementation of empty function in EventScheduler.
+     */
+    [[nodiscard]] bool empty() const noexcept override;
+
+    /**
+     * Implementation of size function in EventScheduler.
+     */
+    [[nodiscard]] int size() const noexcept override;
+
+    /**
+     * Implementation of front function in EventScheduler.
+     */
+    [[nodiscard]] EventList& front() noexcept override;
+
+    /**
+     * Implementation of pop_front function in EventScheduler.
+     */
+    void pop_front() noexcept override;
+
+    /**
+     * Implementation of get_or_create function in EventScheduler.
+     */
+    [[nodiscard]] EventList& get_or_create(EventTime event_time) noexcept override;
+
+    /**
+     * Implementation of get_memory_usage function in EventScheduler.
+     */
+    [[nodiscard]] MemoryUsage get_memory_usage() const noexcept override;
+
+  private:
+    /// list of EventLists, sorted by event time
+    std::list<EventList> event_lists;
+
+    /// processed EventLists ready to be reused
+    std::list<EventList> free_event_lists;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,85 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <ostream>
+
+/// Most verbose log level compiled in (0: Off, ..., 5: Trace)
+/// Logs above this level are removed at compile time.
+#ifndef NETWORK_ANALYTICAL_MAX_LOG_LEVEL
+    #define NETWORK_ANALYTICAL_MAX_LOG_LEVEL 5
+#endif
+
+/**
+ * Log a message at the given level, e.g.,
+ *   NETWORK_ANALYTICAL_LOG(LogLevel::Debug, "route " << src << " -> " << dest);
+ *
+ * The message is only evaluated if the level is both compiled in and enabled at runtime.
+ */
+#define NETWORK_ANALYTICAL_LOG(level, message)                                         \
+    do {                                                                               \
+        if constexpr (static_cast<int>(level) <= NETWORK_ANALYTICAL_MAX_LOG_LEVEL) {   \
+            if (NetworkAnalytical::Logger::enabled(level)) {                           \
+                NetworkAnalytical::Logger::stream(level) << message << '\n';           \
+            }                                                                          \
+        }                                                                              \
+    } while (false)
+
+namespace NetworkAnalytical {
+
+/**
+ * Logger holds the runtime verbosity and output stream of diagnostic logs.
+ * Logs should be emitted through the NETWORK_ANALYTICAL_LOG macro.
+ */
+class Logger {
+  public:
+    /**
+     * Set the runtime verbosity level.
+     *
+     * @param new_level most verbose level to be printed
+     */
+    static void set_level(LogLevel new_level) noexcept;
+
+    /**
+     * Get the runtime verbosity level.
+     *
+     * @return most verbose level to be printed
+     */
+    [[nodiscard]] static LogLevel get_level() noexcept;
+
+    /**
+     * Check if logs of the given level are printed.
+     *
+     * @param log_level level to check
+     * @return true if the level is enabled, false otherwise
+     */
+    [[nodiscard]] static bool enabled(LogLevel log_level) noexcept;
+
+    /**
+     * Set the stream logs are written to (std::cerr by default).
+     *
+     * @param new_output output stream
+     */
+    static void set_output(std::ostream& new_output) noexcept;
+
+    /**
+     * Get the output stream, with the level tag of a new log line written.
+     *
+     * @param log_level level of the log line
+     * @return output stream
+     */
+    [[nodiscard]] static std::ostream& stream(LogLevel log_level) noexcept;
+
+  private:
+    /// runtime verbosity level
+    static LogLevel level;
+
+    /// stream logs are written to
+    static std::ostream* output;
+};
+
+}  // namespace NetworkAnalytical
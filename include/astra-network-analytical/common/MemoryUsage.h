@@ -0,0 +1,47 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace NetworkAnalytical {
+
+/**
+ * Memory used by a part of the simulation.
+ * Pools and containers of the simulator retain their storage once grown,
+ * so the bytes they hold (in use or recycled) are their peak usage.
+ */
+struct MemoryUsage {
+    /// bytes currently in use
+    uint64_t bytes = 0;
+
+    /// largest number of bytes used at once (including storage kept for reuse)
+    uint64_t peak_bytes = 0;
+
+    /**
+     * Accumulate the usage of another part.
+     *
+     * @param other usage to add
+     * @return this usage
+     */
+    MemoryUsage& operator+=(const MemoryUsage& other) noexcept {
+        bytes += other.bytes;
+        peak_bytes += other.peak_bytes;
+        return *this;
+    }
+
+    /**
+     * Raise the peak to cover the given usage.
+     *
+     * @param other usage observed at another time
+     */
+    void update_peak(const MemoryUsage& other) noexcept {
+        peak_bytes = std::max({peak_bytes, bytes, other.peak_bytes, other.bytes});
+    }
+};
+
+}  // namespace NetworkAnalytical
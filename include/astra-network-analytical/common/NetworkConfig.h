@@ -0,0 +1,207 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include <string>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * NetworkConfig builds a network configuration in memory, without a yml file,
+ * e.g., by host simulators that already know the topology, or in the inner loop of a parameter sweep.
+ * Each setter stands for the yml key of the same meaning and returns the config, so calls can be chained:
+ *
+ *   const auto config = NetworkConfig().add_dim(TopologyBuildingBlock::Mesh2D, 16, 50, 500).set_mesh_size(4, 4);
+ *   const auto topology = construct_topology(config);
+ *
+ * The configuration is validated when turned into a NetworkParser (see NetworkParser(const NetworkConfig&)),
+ * the same way a parsed yml file is; it hashes equally to its yml equivalent (see NetworkParser::get_config_hash).
+ * Invalid values are only reported then, so NetworkParser::try_parse can collect them instead of exiting.
+ */
+class NetworkConfig {
+  public:
+    /**
+     * Constructor of an empty configuration.
+     */
+    NetworkConfig() noexcept;
+
+    /**
+     * Append a network dimension (the topology, npus_count, bandwidth, and latency keys).
+     *
+     * @param topology topology building block of the dimension
+     * @param npus_count number of NPUs of the dimension
+     * @param bandwidth bandwidth of the links of the dimension (GB/s)
+     * @param latency latency of the links of the dimension (ns)
+     * @return this config
+     */
+    NetworkConfig& add_dim(TopologyBuildingBlock topology,
+                           int npus_count,
+                           Bandwidth bandwidth,
+                           Latency latency) noexcept;
+
+    /**
+     * Set the grid size of a Mesh2D, SparseMesh2D, Mesh3D, Torus2D, or Torus3D topology.
+     *
+     * @param width number of nodes in X dimension
+     * @param height number of nodes in Y dimension
+     * @param depth number of layers (Z dimension), -1 for 2D topologies
+     * @return this config
+     */
+    NetworkConfig& set_mesh_size(int width, int height, int depth = -1) noexcept;
+
+    /**
+     * Set the vertical links of a Mesh3D topology.
+     *
+     * @param bandwidth bandwidth per vertical link (GB/s)
+     * @param latency latency per vertical link (ns)
+     * @return this config
+     */
+    NetworkConfig& set_vertical_link(Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Exclude a rectangle of cells of a 2D mesh, corners included (a Mesh2D then becomes a SparseMesh2D).
+     *
+     * @param x_min lowest X coordinate
+     * @param y_min lowest Y coordinate
+     * @param x_max highest X coordinate
+     * @param y_max highest Y coordinate
+     * @return this config
+     */
+    NetworkConfig& exclude_region(int x_min, int y_min, int x_max, int y_max) noexcept;
+
+    /**
+     * Exclude a box of cells of a Mesh3D topology, corners included.
+     *
+     * @param x_min lowest X coordinate
+     * @param y_min lowest Y coordinate
+     * @param z_min lowest Z coordinate
+     * @param x_max highest X coordinate
+     * @param y_max highest Y coordinate
+     * @param z_max highest Z coordinate
+     * @return this config
+     */
+    NetworkConfig& exclude_box(int x_min, int y_min, int z_min, int x_max, int y_max, int z_max) noexcept;
+
+    /**
+     * Exclude the cells of a 2D mesh marked in a bitmap file (see the excluded_bitmap key).
+     *
+     * @param path path of the bitmap file
+     * @return this config
+     */
+    NetworkConfig& set_excluded_bitmap(const std::string& path) noexcept;
+
+    /**
+     * Set the NPU placement pattern of a SparseMesh2D topology.
+     *
+     * @param pattern placement pattern (Explicit is set by place_npu instead)
+     * @return this config
+     */
+    NetworkConfig& set_placement_pattern(PlacementPattern pattern) noexcept;
+
+    /**
+     * Place an NPU at a cell of a SparseMesh2D topology, switching to the Explicit placement pattern.
+     *
+     * @param x X coordinate of the cell
+     * @param y Y coordinate of the cell
+     * @param npu_id NPU ID placed at the cell
+     * @return this config
+     */
+    NetworkConfig& place_npu(int x, int y, int npu_id) noexcept;
+
+    /**
+     * Set the routing policy of a Mesh2D topology.
+     *
+     * @param routing routing policy
+     * @return this config
+     */
+    NetworkConfig& set_mesh_routing(MeshRouting routing) noexcept;
+
+    /**
+     * Set the shape of a FatTree topology.
+     *
+     * @param radix switch radix
+     * @param tiers number of switch tiers
+     * @param oversubscription leaf oversubscription
+     * @return this config
+     */
+    NetworkConfig& set_fat_tree(int radix, int tiers = 2, int oversubscription = 1) noexcept;
+
+    /**
+     * Set the shape and routing policy of a Dragonfly topology.
+     *
+     * @param npus_per_router NPUs per router
+     * @param routers_per_group routers per group
+     * @param global_links_per_router global links per router
+     * @param routing routing policy
+     * @return this config
+     */
+    NetworkConfig& set_dragonfly(int npus_per_router,
+                                 int routers_per_group,
+                                 int global_links_per_router,
+                                 DragonflyRouting routing = DragonflyRouting::Minimal) noexcept;
+
+    /**
+     * Set the rails of a MultiRail topology.
+     *
+     * @param rails_count number of rails
+     * @param routing rail selection policy
+     * @return this config
+     */
+    NetworkConfig& set_multi_rail(int rails_count, RailRouting routing = RailRouting::Hashed) noexcept;
+
+    /**
+     * Set the edge list file of a Custom topology.
+     *
+     * @param path path of the edge list file
+     * @return this config
+     */
+    NetworkConfig& set_edge_list(const std::string& path) noexcept;
+
+    /**
+     * Override the links between two devices, in both directions (a pair entry of link_overrides).
+     *
+     * @param src device at one end of the links
+     * @param dest device at the other end of the links
+     * @param bandwidth bandwidth of the links (GB/s)
+     * @param latency latency of the links (ns)
+     * @return this config
+     */
+    NetworkConfig& override_link_pair(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Override every link of a link group, e.g., "row 2" of a mesh (a group entry of link_overrides).
+     *
+     * @param group name of the link group
+     * @param bandwidth bandwidth of the links (GB/s)
+     * @param latency latency of the links (ns)
+     * @return this config
+     */
+    NetworkConfig& override_link_group(const std::string& group, Bandwidth bandwidth, Latency latency) noexcept;
+
+  private:
+    /// NetworkParser reads the configuration
+    friend class NetworkParser;
+
+    /// configuration built so far, not yet validated
+    NetworkParser parser;
+
+    /// errors of the values given to the setters, reported when the configuration is checked
+    std::vector<ConfigError> errors;
+
+    /**
+     * Find the link class of the given parameters, adding it if new.
+     *
+     * @param bandwidth bandwidth of the links
+     * @param latency latency of the links
+     * @return index of the link class, -1 if the parameters are invalid
+     */
+    int add_link_class(Bandwidth bandwidth, Latency latency) noexcept;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,77 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkConfig.h"
+#include "common/NetworkParser.h"
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * Similarity-scaled instance of a network, with the factors relating its workloads and results to the full one's
+ * (see downscale_network).
+ */
+struct DownscaledNetwork {
+    /// configuration of the downscaled network
+    NetworkConfig network_config;
+
+    /// number of NPUs of the full network
+    int full_npus_count = 0;
+
+    /// number of NPUs of the downscaled network
+    int npus_count = 0;
+
+    /// ratio of the NPUs of the full network to the downscaled one's
+    double npus_scale = 1;
+
+    /// factor the per-destination message sizes of a workload (e.g., collective shards) are multiplied by
+    double message_size_scale = 1;
+
+    /// factor the per-NPU buffer sizes of a workload (e.g., collective sizes) are multiplied by
+    double buffer_size_scale = 1;
+
+    /// factor the link bandwidth of each dimension is multiplied by
+    std::vector<double> bandwidth_scales;
+
+    /// factor the link latency of each dimension is multiplied by
+    std::vector<double> latency_scales;
+};
+
+/**
+ * Build a similarity-scaled instance of a multi-dimensional network of Ring, FullyConnected, and Switch dimensions,
+ * with fewer NPUs per dimension, for directional answers about networks too large to simulate
+ * (e.g., a 64K-NPU design from a 1K-NPU simulation).
+ *
+ * The parameters are scaled for uniform traffic (e.g., an all-to-all, or a direct collective):
+ * - messages are scaled so that every NPU injects as many bytes as in the full network,
+ * - the bandwidth of each dimension is scaled so that its busiest links are as loaded relative to their bandwidth,
+ *   given the hops the messages crossing the dimension take over them,
+ * - the latency of each dimension is scaled so that a message spends as long in the dimension on average.
+ * The finish times of the downscaled network then estimate the full network's directly,
+ * while effects of scale the model doesn't capture (e.g., the tail of the load of individual links) are lost.
+ * Link overrides name devices of the full network, so they can't be downscaled.
+ *
+ * @param network_parser configuration of the full network
+ * @param npus_counts_per_dim NPUs of each dimension of the downscaled network, at least 2 (or the full network's)
+ *                            and at most the full network's
+ * @return downscaled network
+ */
+[[nodiscard]] DownscaledNetwork downscale_network(const NetworkParser& network_parser,
+                                                  const std::vector<int>& npus_counts_per_dim) noexcept;
+
+/**
+ * Build a similarity-scaled instance of a network with about the given number of NPUs,
+ * shrinking every dimension by the same factor (see downscale_network).
+ *
+ * @param network_parser configuration of the full network
+ * @param target_npus_count number of NPUs to aim for
+ * @return downscaled network
+ */
+[[nodiscard]] DownscaledNetwork downscale_network(const NetworkParser& network_parser,
+                                                  int target_npus_count) noexcept;
+
+}  // namespace NetworkAnalytical
@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/Type.h"
+#include <utility>
+#include <vector>
 
 namespace NetworkAnalytical {
 
@@ -19,4 +21,45 @@ namespace NetworkAnalytical {
  */
 Bandwidth bw_GBps_to_Bpns(Bandwidth bw_GBps) noexcept;
 
+/**
+ * Mix the bits of a value (splitmix64 finalizer),
+ * e.g., to spread consecutive ids over a few choices deterministically.
+ *
+ * @param value value to mix
+ * @return mixed value
+ */
+uint64_t mix_bits(uint64_t value) noexcept;
+
+/**
+ * Split a transfer striped over both directions of a ring:
+ * each direction carries a share of the bytes proportional to the distance the other way,
+ * so both stripes take about as long when forwarded hop by hop.
+ *
+ * @param chunk_size size of the transfer
+ * @param hops_count number of hops of the direction
+ * @param opposite_hops_count number of hops of the other direction
+ * @return bytes striped over the direction
+ */
+ChunkSize ring_stripe_size(ChunkSize chunk_size, int hops_count, int opposite_hops_count) noexcept;
+
+/**
+ * Get the cell at a position along a Hilbert curve over a side x side grid.
+ *
+ * @param side side of the grid, a power of 2
+ * @param position position along the curve, in [0, side * side)
+ * @return (x, y) coordinates of the cell
+ */
+std::pair<int, int> hilbert_cell(int side, int position) noexcept;
+
+/**
+ * Order the cells of a grid so that cells close in the order are close on the grid,
+ * e.g., to lay out the state of neighboring cells close in memory:
+ * the grid is cut into squares along its longer side, each walked along a Hilbert curve.
+ *
+ * @param width number of columns of the grid
+ * @param height number of rows of the grid
+ * @return every cell index (y * width + x), in locality order
+ */
+std::vector<int> locality_order(int width, int height) noexcept;
+
 }  // namespace NetworkAnalytical
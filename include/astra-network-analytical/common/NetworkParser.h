@@ -6,14 +6,77 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/Type.h"
+#include <array>
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <optional>
 #include <set>
+#include <string>
 #include <utility>
+#include <vector>
 #include <yaml-cpp/yaml.h>
 
 namespace NetworkAnalytical {
 
+class NetworkConfig;
+
+/**
+ * Error found in a network configuration, collected rather than exiting by NetworkParser::try_parse.
+ */
+struct ConfigError {
+    /// yml key the error is about, e.g., "npus_count" (empty if not tied to a key)
+    std::string key;
+
+    /// description of the error
+    std::string message;
+};
+
+/**
+ * Bandwidth and latency shared by every link overridden with the same link class.
+ */
+struct LinkClass {
+    /// bandwidth of the links in GB/s
+    Bandwidth bandwidth;
+
+    /// latency of the links in ns
+    Latency latency;
+
+    /// (time in ns, bandwidth in GB/s) steps the bandwidth of the links changes at, in increasing time order
+    /// (empty: constant bandwidth)
+    std::vector<std::pair<Latency, Bandwidth>> bandwidth_schedule;
+
+    /// (time in ns, utilization) steps of the fraction of the bandwidth taken by background traffic,
+    /// in increasing time order (empty: no background traffic)
+    std::vector<std::pair<Latency, double>> background_schedule;
+};
+
+/**
+ * Override of the links between two devices, in both directions.
+ */
+struct LinkPairOverride {
+    /// device at one end of the links
+    DeviceId src;
+
+    /// device at the other end of the links
+    DeviceId dest;
+
+    /// index of the link class of the links
+    int link_class;
+};
+
+/**
+ * Override of every link of a link group of the congestion-aware backend (see Topology::get_link_group),
+ * e.g., "row 2" or "column 0" of a mesh, or "dim 1" of a multi-dim topology.
+ */
+struct LinkGroupOverride {
+    /// name of the link group
+    std::string group;
+
+    /// index of the link class of the links
+    int link_class;
+};
+
 /**
  * NetworkParser parses the network configuration file in YAML format.
  */
@@ -26,6 +89,83 @@ class NetworkParser {
      */
     explicit NetworkParser(const std::string& path) noexcept;
 
+    /**
+     * Constructor from an already loaded network configuration,
+     * e.g., generated programmatically for parameter sweeps.
+     * @param network_config YAML node holding the network configuration
+     */
+    explicit NetworkParser(const YAML::Node& network_config) noexcept;
+
+    /**
+     * Constructor from a network configuration built in memory, without parsing any yml.
+     *
+     * @param network_config network configuration (see NetworkConfig)
+     */
+    explicit NetworkParser(const NetworkConfig& network_config) noexcept;
+
+    /**
+     * Parse a network configuration, collecting its errors instead of exiting on the first one,
+     * e.g., so a sweep can skip its invalid points. Errors of other threads aren't collected.
+     *
+     * @param network_config YAML node holding the network configuration
+     * @param errors list the errors found are appended to
+     * @return parsed network configuration, std::nullopt if any error is found
+     */
+    [[nodiscard]] static std::optional<NetworkParser> try_parse(const YAML::Node& network_config,
+                                                                std::vector<ConfigError>& errors) noexcept;
+
+    /**
+     * Check a network configuration built in memory, collecting its errors instead of exiting on the first one.
+     *
+     * @param network_config network configuration (see NetworkConfig)
+     * @param errors list the errors found are appended to
+     * @return network configuration, std::nullopt if any error is found
+     */
+    [[nodiscard]] static std::optional<NetworkParser> try_parse(const NetworkConfig& network_config,
+                                                                std::vector<ConfigError>& errors) noexcept;
+
+    /**
+     * Parse the network configuration of a yml file, collecting its errors instead of exiting on the first one,
+     * including an unreadable file or contents that aren't yml.
+     *
+     * @param path path of the yml file
+     * @param errors list the errors found are appended to
+     * @return parsed network configuration, std::nullopt if any error is found
+     */
+    [[nodiscard]] static std::optional<NetworkParser> try_load(const std::string& path,
+                                                               std::vector<ConfigError>& errors) noexcept;
+
+    /**
+     * Load the network configuration of a yml file through its compiled binary form.
+     * The compiled file is used if it was compiled from the same yml contents with the same format version;
+     * otherwise the yml file is parsed, validated, and (re)compiled into it.
+     *
+     * @param path path of the yml file
+     * @param compiled_path path of the compiled file (default: path + ".bin")
+     * @return parsed network configuration
+     */
+    [[nodiscard]] static NetworkParser load_cached(const std::string& path, std::string compiled_path = "") noexcept;
+
+    /**
+     * Write the network configuration into a compiled binary file,
+     * tagged with the contents of the yml file it was parsed from (see load_cached).
+     * The file is replaced at once, so concurrent readers see either version.
+     *
+     * @param compiled_path path of the compiled file
+     * @return true if the file is written, false otherwise
+     */
+    bool save_compiled(const std::string& compiled_path) const noexcept;
+
+    /**
+     * Hash the parsed network configuration (64-bit FNV-1a of its compiled form),
+     * e.g., to key memoized simulation results.
+     * Equal configurations hash equally, however their yml is formatted or whether they're parsed from a file;
+     * files the configuration refers to (e.g., an edge list) are hashed by path, not contents.
+     *
+     * @return hash of the configuration
+     */
+    [[nodiscard]] uint64_t get_config_hash() const noexcept;
+
     /**
      * Return the number of network dimensions.
      * Which is calculated by the length of "topology" value
@@ -64,7 +204,7 @@ class NetworkParser {
     [[nodiscard]] std::vector<TopologyBuildingBlock> get_topologies_per_dim() const noexcept;
 
     /**
-     * Get mesh width (for Mesh2D topology).
+     * Get mesh width (for Mesh2D and Torus topology).
      * Returns -1 if not specified (will use square mesh based on npus_count).
      *
      * @return mesh width or -1 if not specified
@@ -72,16 +212,47 @@ class NetworkParser {
     [[nodiscard]] int get_mesh_width() const noexcept;
 
     /**
-     * Get mesh height (for Mesh2D topology).
+     * Get mesh height (for Mesh2D and Torus topology).
      * Returns -1 if not specified (will use square mesh based on npus_count).
      *
      * @return mesh height or -1 if not specified
      */
     [[nodiscard]] int get_mesh_height() const noexcept;
 
+    /**
+     * Get mesh depth (for Mesh3D and Torus3D topology).
+     * Returns -1 if not specified.
+     *
+     * @return mesh depth or -1 if not specified
+     */
+    [[nodiscard]] int get_mesh_depth() const noexcept;
+
+    /**
+     * Get the bandwidth of the vertical (Z) links of Mesh3D topology, e.g., TSVs or hybrid bonds.
+     *
+     * @return vertical bandwidth, the bandwidth of the first dimension if not specified
+     */
+    [[nodiscard]] Bandwidth get_vertical_bandwidth() const noexcept;
+
+    /**
+     * Get the latency of the vertical (Z) links of Mesh3D topology.
+     *
+     * @return vertical latency, the latency of the first dimension if not specified
+     */
+    [[nodiscard]] Latency get_vertical_latency() const noexcept;
+
+    /**
+     * Get the valid (non-excluded) cells of the width x height x depth grid of Mesh3D topology,
+     * expanding the excluded boxes.
+     *
+     * @return true for each grid cell holding a node, indexed by (z * height + y) * width + x
+     */
+    [[nodiscard]] std::vector<bool> get_valid_cells_3d() const noexcept;
+
     /**
      * Get excluded coordinates for SparseMesh2D topology.
      * Returns empty set if not specified (regular mesh).
+     * Prefer get_valid_cells, which doesn't list the excluded cells one by one.
      *
      * @return set of (x, y) coordinates to exclude from the mesh
      */
@@ -90,6 +261,7 @@ class NetworkParser {
     /**
      * Get custom NPU placement for SparseMesh2D topology.
      * Returns empty map if not specified (uses automatic row-major numbering).
+     * Prefer get_npu_placement_grid, which doesn't list the placed NPUs one by one.
      *
      * Format: map from (x, y) grid coordinate to NPU ID
      * This allows custom NPU ID assignment like snake patterns for optimized routing.
@@ -98,7 +270,170 @@ class NetworkParser {
      */
     [[nodiscard]] std::map<std::pair<int, int>, int> get_npu_placement() const noexcept;
 
+    /**
+     * Get the valid (non-excluded) cells of the width x height grid of SparseMesh2D topology,
+     * expanding the excluded regions and bitmap file on each call.
+     *
+     * @return true for each grid cell holding a node, indexed by y * width + x
+     */
+    [[nodiscard]] std::vector<bool> get_valid_cells() const noexcept;
+
+    /**
+     * Get the NPU placement pattern of SparseMesh2D topology.
+     * Returns RowMajor if not specified.
+     *
+     * @return NPU placement pattern
+     */
+    [[nodiscard]] PlacementPattern get_placement_pattern() const noexcept;
+
+    /**
+     * Get the custom NPU placement of SparseMesh2D topology as a grid,
+     * expanding the placement pattern (or explicit entries) on each call.
+     * Returns an empty grid for the (default) row-major placement.
+     *
+     * @return NPU ID of each grid cell (-1 if not placed), indexed by y * width + x
+     */
+    [[nodiscard]] std::vector<int> get_npu_placement_grid() const noexcept;
+
+    /**
+     * Get the ring dilation of the NPU placement of SparseMesh2D topology:
+     * the hops between each NPU and the next one in id order (the last one's next being NPU 0),
+     * along the shortest path over the valid cells.
+     * NPUs left unplaced by explicit entries are skipped.
+     *
+     * @return hops from each placed NPU to the next one, in id order (-1 if unreachable)
+     */
+    [[nodiscard]] std::vector<int> get_ring_dilations() const noexcept;
+
+    /**
+     * Write a copy of a yml file with its NPU placement expanded into explicit (x, y, npu_id) entries,
+     * e.g., to freeze the placement searched by the RingOrder pattern.
+     *
+     * @param path path of the yml file
+     * @param output_path path of the yml file to write
+     * @return true if the file is written, false otherwise
+     */
+    static bool save_npu_placement(const std::string& path, const std::string& output_path) noexcept;
+
+    /**
+     * Get the switch radix of FatTree topology.
+     * Returns -1 if not specified.
+     *
+     * @return switch radix or -1 if not specified
+     */
+    [[nodiscard]] int get_fat_tree_radix() const noexcept;
+
+    /**
+     * Get the number of switch tiers of FatTree topology.
+     * Returns 2 if not specified.
+     *
+     * @return number of tiers
+     */
+    [[nodiscard]] int get_fat_tree_tiers() const noexcept;
+
+    /**
+     * Get the leaf oversubscription (downlinks per uplink) of FatTree topology.
+     * Returns 1 if not specified.
+     *
+     * @return leaf oversubscription
+     */
+    [[nodiscard]] int get_fat_tree_oversubscription() const noexcept;
+
+    /**
+     * Get the routing policy of Mesh2D topology.
+     * Returns MeshRouting::XY if not specified.
+     *
+     * @return routing policy
+     */
+    [[nodiscard]] MeshRouting get_mesh_routing() const noexcept;
+
+    /**
+     * Get the number of NPUs per router of Dragonfly topology.
+     * Returns 1 if not specified.
+     *
+     * @return NPUs per router
+     */
+    [[nodiscard]] int get_dragonfly_npus_per_router() const noexcept;
+
+    /**
+     * Get the number of routers per group of Dragonfly topology.
+     * Returns -1 if not specified.
+     *
+     * @return routers per group or -1 if not specified
+     */
+    [[nodiscard]] int get_dragonfly_routers_per_group() const noexcept;
+
+    /**
+     * Get the number of global links per router of Dragonfly topology.
+     * Returns -1 if not specified.
+     *
+     * @return global links per router or -1 if not specified
+     */
+    [[nodiscard]] int get_dragonfly_global_links_per_router() const noexcept;
+
+    /**
+     * Get the routing policy of Dragonfly topology.
+     * Returns DragonflyRouting::Minimal if not specified.
+     *
+     * @return routing policy
+     */
+    [[nodiscard]] DragonflyRouting get_dragonfly_routing() const noexcept;
+
+    /**
+     * Get the number of rails of MultiRail topology.
+     * Returns -1 if not specified.
+     *
+     * @return number of rails or -1 if not specified
+     */
+    [[nodiscard]] int get_multi_rail_rails_count() const noexcept;
+
+    /**
+     * Get the rail selection policy of MultiRail topology.
+     * Returns RailRouting::Hashed if not specified.
+     *
+     * @return rail selection policy
+     */
+    [[nodiscard]] RailRouting get_multi_rail_routing() const noexcept;
+
+    /**
+     * Get the edge list file of Custom topology.
+     * Returns an empty path if not specified.
+     *
+     * @return path of the edge list file
+     */
+    [[nodiscard]] std::string get_edge_list_path() const noexcept;
+
+    /**
+     * Get the link classes, i.e., the bandwidth and latency shared by overridden links.
+     *
+     * @return link classes, indexed by the link_class of the overrides
+     */
+    [[nodiscard]] const std::vector<LinkClass>& get_link_classes() const noexcept;
+
+    /**
+     * Get the overrides of the links between device pairs, in configuration order.
+     *
+     * @return device pair overrides
+     */
+    [[nodiscard]] const std::vector<LinkPairOverride>& get_link_pair_overrides() const noexcept;
+
+    /**
+     * Get the overrides of link groups (mesh rows and columns included), in configuration order.
+     *
+     * @return link group overrides
+     */
+    [[nodiscard]] const std::vector<LinkGroupOverride>& get_link_group_overrides() const noexcept;
+
   private:
+    /// NetworkConfig builds configurations through the private members
+    friend class NetworkConfig;
+
+    /// identifies compiled network configuration files
+    static constexpr char compiled_magic[8] = {'A', 'N', 'A', 'N', 'E', 'T', 'C', 'F'};
+
+    /// version of the compiled file layout, bumped whenever the layout changes
+    static constexpr uint32_t compiled_version = 9;
+
     /// number of network dimensions
     int dims_count;
 
@@ -120,17 +455,218 @@ class NetworkParser {
     /// mesh height for Mesh2D topology (-1 if not specified)
     int mesh_height;
 
-    /// excluded coordinates for SparseMesh2D topology (empty for regular mesh)
-    std::set<std::pair<int, int>> excluded_coords;
+    /// mesh depth for Mesh3D and Torus3D topology (-1 if not specified)
+    int mesh_depth;
+
+    /// vertical link bandwidth for Mesh3D topology (-1 if not specified)
+    Bandwidth vertical_bandwidth;
+
+    /// vertical link latency for Mesh3D topology (-1 if not specified)
+    Latency vertical_latency;
+
+    /// excluded boxes for Mesh3D topology: (x_min, y_min, z_min, x_max, y_max, z_max), corners included
+    std::vector<std::array<int, 6>> excluded_boxes;
+
+    /// excluded rectangles for SparseMesh2D topology: (x_min, y_min, x_max, y_max), corners included
+    std::vector<std::array<int, 4>> excluded_regions;
+
+    /// bitmap file of excluded cells for SparseMesh2D topology (empty if not specified)
+    std::string excluded_bitmap_path;
+
+    /// NPU placement pattern for SparseMesh2D topology (RowMajor if not specified)
+    PlacementPattern placement_pattern;
 
-    /// custom NPU placement for SparseMesh2D: (x, y) -> npu_id (empty for auto row-major)
-    std::map<std::pair<int, int>, int> npu_placement;
+    /// explicit NPU placement for SparseMesh2D: (x, y, npu_id) entries, for the Explicit pattern
+    std::vector<std::array<int, 3>> npu_placement_entries;
+
+    /// routing policy for Mesh2D topology (XY if not specified)
+    MeshRouting mesh_routing;
+
+    /// switch radix for FatTree topology (-1 if not specified)
+    int fat_tree_radix;
+
+    /// number of switch tiers for FatTree topology
+    int fat_tree_tiers;
+
+    /// leaf oversubscription for FatTree topology
+    int fat_tree_oversubscription;
+
+    /// NPUs per router for Dragonfly topology
+    int dragonfly_npus_per_router;
+
+    /// routers per group for Dragonfly topology (-1 if not specified)
+    int dragonfly_routers_per_group;
+
+    /// global links per router for Dragonfly topology (-1 if not specified)
+    int dragonfly_global_links_per_router;
+
+    /// routing policy for Dragonfly topology (Minimal if not specified)
+    DragonflyRouting dragonfly_routing;
+
+    /// number of rails for MultiRail topology (-1 if not specified)
+    int multi_rail_rails_count;
+
+    /// rail selection policy for MultiRail topology (Hashed if not specified)
+    RailRouting multi_rail_routing;
+
+    /// edge list file for Custom topology (empty if not specified)
+    std::string edge_list_path;
+
+    /// bandwidth and latency of overridden links, each distinct pair stored once
+    std::vector<LinkClass> link_classes;
+
+    /// overrides of the links between device pairs
+    std::vector<LinkPairOverride> link_pair_overrides;
+
+    /// overrides of link groups
+    std::vector<LinkGroupOverride> link_group_overrides;
+
+    /// hash of the yml contents the configuration was parsed from (0 if not parsed from a file)
+    uint64_t source_hash;
+
+    /// list the errors reported on this thread are collected into (nullptr: errors exit)
+    static thread_local std::vector<ConfigError>* error_sink;
+
+    /**
+     * ErrorScope collects the errors reported on this thread into a list while it lives (see try_parse).
+     */
+    class ErrorScope {
+      public:
+        explicit ErrorScope(std::vector<ConfigError>& errors) noexcept : outer_sink(error_sink) {
+            error_sink = &errors;
+        }
+
+        ~ErrorScope() noexcept {
+            error_sink = outer_sink;
+        }
+
+        ErrorScope(const ErrorScope&) = delete;
+        ErrorScope& operator=(const ErrorScope&) = delete;
+
+      private:
+        /// list collecting the errors before the scope
+        std::vector<ConfigError>* outer_sink;
+    };
+
+    /**
+     * Report an error of the configuration: collected if in an ErrorScope, printed then exiting otherwise.
+     *
+     * @param key yml key the error is about (empty if not tied to a key)
+     * @param message description of the error
+     */
+    static void report_error(const std::string& key, const std::string& message) noexcept;
+
+    /**
+     * Constructor of an empty configuration, filled by the other constructors.
+     */
+    NetworkParser() noexcept;
+
+    /**
+     * Mark the cells excluded by the bitmap file as invalid.
+     *
+     * @param valid_cells valid cells of the width x height grid, updated
+     * @return true if the bitmap holds a cell for every cell of the grid, false otherwise
+     */
+    bool apply_excluded_bitmap(std::vector<bool>& valid_cells) const noexcept;
+
+    /**
+     * Describe a bitmap file not covering the grid.
+     *
+     * @return error message
+     */
+    [[nodiscard]] std::string excluded_bitmap_error() const noexcept;
+
+    /**
+     * Read the contents of a yml file.
+     *
+     * @param path path of the yml file
+     * @return contents of the file
+     */
+    [[nodiscard]] static std::string read_source(const std::string& path) noexcept;
+
+    /**
+     * Parse the contents of a yml file, remembering their hash.
+     *
+     * @param source contents of the yml file
+     */
+    void parse_network_config_source(const std::string& source) noexcept;
+
+    /**
+     * Hash the contents of a yml file (64-bit FNV-1a).
+     *
+     * @param source contents of the yml file
+     * @return hash of the contents
+     */
+    [[nodiscard]] static uint64_t hash_source(const std::string& source) noexcept;
+
+    /**
+     * Read the network configuration from a compiled binary file.
+     *
+     * @param compiled_path path of the compiled file
+     * @param expected_source_hash hash of the current yml contents
+     * @return true if the file is valid and compiled from the same contents, false otherwise
+     */
+    bool load_compiled(const std::string& compiled_path, uint64_t expected_source_hash) noexcept;
+
+    /**
+     * Append the parsed network configuration in its compiled form (without the header).
+     *
+     * @param buffer buffer to append to
+     */
+    void append_config(std::string& buffer) const noexcept;
+
+    /**
+     * Parse Mesh2D routing policy name (in string) into MeshRouting enum
+     *
+     * @param routing_name routing policy name in string
+     *    which can be "XY", "O1Turn", or "WestFirst"
+     * @return parsed MeshRouting enum class value
+     */
+    [[nodiscard]] static MeshRouting parse_mesh_routing_name(const std::string& routing_name) noexcept;
+
+    /**
+     * Parse SparseMesh2D NPU placement pattern name (in string) into PlacementPattern enum
+     *
+     * @param pattern_name placement pattern name in string
+     *    which can be "RowMajor", "Snake", "Hilbert", or "RingOrder"
+     * @return parsed PlacementPattern enum class value
+     */
+    [[nodiscard]] static PlacementPattern parse_placement_pattern_name(const std::string& pattern_name) noexcept;
+
+    /**
+     * Search an order of the valid cells of SparseMesh2D topology minimizing the ring dilation:
+     * snake, ring-closing snake (returning along the first column or row), Hilbert, and greedy nearest-cell
+     * orders are scored by their total (then largest) dilation, and the best one is kept.
+     *
+     * @param valid_cells true for each grid cell holding a node, indexed by y * width + x
+     * @return valid cells in NPU id order
+     */
+    [[nodiscard]] std::vector<int> search_ring_order(const std::vector<bool>& valid_cells) const noexcept;
+
+    /**
+     * Parse Dragonfly routing policy name (in string) into DragonflyRouting enum
+     *
+     * @param routing_name routing policy name in string
+     *    which can be "Minimal" or "Valiant"
+     * @return parsed DragonflyRouting enum class value
+     */
+    [[nodiscard]] static DragonflyRouting parse_dragonfly_routing_name(const std::string& routing_name) noexcept;
+
+    /**
+     * Parse MultiRail rail selection policy name (in string) into RailRouting enum
+     *
+     * @param routing_name rail selection policy name in string
+     *    which can be "Hashed" or "Sprayed"
+     * @return parsed RailRouting enum class value
+     */
+    [[nodiscard]] static RailRouting parse_rail_routing_name(const std::string& routing_name) noexcept;
 
     /**
      * Parse topology name (in string) into TopologyBuildingBlock enum
      *
      * @param topology_name topology name in string
-     *    which can be "Ring", "FullyConnected", or "Switch"
+     *    which can be "Ring", "FullyConnected", "Switch", "Mesh2D", "SparseMesh2D", "Mesh3D", "Torus2D", "Torus3D",
+     *    "FatTree", "Dragonfly", or "MultiRail"
      * @return parsed TopologyBuildingBlock enum class value
      */
     [[nodiscard]] static TopologyBuildingBlock parse_topology_name(const std::string& topology_name) noexcept;
@@ -140,14 +676,50 @@ class NetworkParser {
      *
      * @param network_config opened and parsed YAML node
      */
-    void parse_network_config_yml(const YAML::Node& network_config) noexcept;
+    void parse_network_config_yml(const YAML::Node& network_config);
+
+    /**
+     * Find the link class of the given bandwidth, latency, bandwidth schedule, and background traffic,
+     * adding it if new.
+     *
+     * @param bandwidth bandwidth of the links
+     * @param latency latency of the links
+     * @param bandwidth_schedule (time, bandwidth) steps of the links (empty: constant bandwidth)
+     * @param background_schedule (time, utilization) steps of the links (empty: no background traffic)
+     * @return index of the link class, -1 if the parameters are invalid
+     */
+    int add_link_class(Bandwidth bandwidth,
+                       Latency latency,
+                       const std::vector<std::pair<Latency, Bandwidth>>& bandwidth_schedule = {},
+                       const std::vector<std::pair<Latency, double>>& background_schedule = {}) noexcept;
+
+    /**
+     * Parse an entry of link_overrides.
+     *
+     * @param link_override YAML node of the entry
+     * @param link_class_ids index of each named link class
+     */
+    void parse_link_override(const YAML::Node& link_override, const std::map<std::string, int>& link_class_ids);
+
+    /**
+     * Complete the configuration (e.g., a Mesh2D with excluded cells becomes a SparseMesh2D,
+     * a Torus2D without dimensions is square), then check its validity.
+     */
+    void finalize() noexcept;
 
     /**
      * Check the validity and correctness of the parsed network input
-     * configurations.
+     * configurations, reporting every error found.
      */
     void check_validity() const noexcept;
 
+    /**
+     * Collect every error of the configuration.
+     *
+     * @return errors found (empty: valid configuration)
+     */
+    [[nodiscard]] std::vector<ConfigError> validate() const noexcept;
+
     /**
      * Given a yaml node whose type is list of type T,
      * Read the value from the node and create a std::vector<T>.
@@ -170,8 +742,7 @@ class NetworkParser {
                 parsed_vector.push_back(element_value);
             } catch (const YAML::BadConversion& e) {
                 // error reading an element from the yaml file as type T
-                std::cerr << "[Error] (network/analytical) " << e.what() << std::endl;
-                std::exit(-1);
+                report_error("", e.what());
             }
         }
 
@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include <optional>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+
+namespace NetworkAnalytical {
+
+/**
+ * NetworkScenarios is the table of the network configurations of a multi-scenario yml file,
+ * e.g., the hundreds of variants of one network a sweep runs on (see Sweep(const NetworkScenarios&)).
+ * The file is read and parsed by yaml-cpp once, and every scenario is built and checked once, in memory.
+ *
+ * The file holds a base network configuration, along with
+ * - scenarios: a list of deltas, each replacing top-level keys of the base, optionally named by a name key,
+ *     scenarios: [ { name: fast, bandwidth: [ 100 ] }, { npus_count: [ 16 ], latency: [ 1000 ] } ]
+ * - sweep: the values top-level keys range over, every combination applied to every scenario
+ *   (or to the base if there is none), the last key varying fastest,
+ *     sweep: { bandwidth: [ [ 50 ], [ 100 ], [ 200 ] ], latency: [ [ 500 ], [ 1000 ] ] }
+ * Invalid scenarios are kept in the table with their errors (see NetworkParser::try_parse).
+ */
+class NetworkScenarios {
+  public:
+    /**
+     * Constructor from a multi-scenario yml file.
+     *
+     * @param path path of the yml file
+     */
+    explicit NetworkScenarios(const std::string& path) noexcept;
+
+    /**
+     * Constructor from an already loaded multi-scenario configuration.
+     *
+     * @param scenarios_config YAML node holding the base configuration, scenarios, and sweep
+     */
+    explicit NetworkScenarios(const YAML::Node& scenarios_config) noexcept;
+
+    /**
+     * Get the number of scenarios.
+     *
+     * @return number of scenarios
+     */
+    [[nodiscard]] int get_scenarios_count() const noexcept;
+
+    /**
+     * Get the name of a scenario: its name key (or its index in the scenarios list, or "base" if there is none),
+     * followed by the swept values, e.g., "fast bandwidth=[100] latency=[500]".
+     *
+     * @param scenario index of the scenario
+     * @return name of the scenario
+     */
+    [[nodiscard]] const std::string& get_name(int scenario) const noexcept;
+
+    /**
+     * Get the network configuration of a scenario.
+     *
+     * @param scenario index of the scenario
+     * @return network configuration, std::nullopt if invalid
+     */
+    [[nodiscard]] const std::optional<NetworkParser>& get_network_parser(int scenario) const noexcept;
+
+    /**
+     * Get the errors of the network configuration of a scenario.
+     *
+     * @param scenario index of the scenario
+     * @return errors of the configuration (empty: valid scenario)
+     */
+    [[nodiscard]] const std::vector<ConfigError>& get_config_errors(int scenario) const noexcept;
+
+  private:
+    /// name of each scenario
+    std::vector<std::string> names;
+
+    /// network configuration of each scenario (std::nullopt: invalid scenario)
+    std::vector<std::optional<NetworkParser>> network_parsers;
+
+    /// errors of the network configuration of each scenario (empty: valid scenario)
+    std::vector<std::vector<ConfigError>> config_errors;
+
+    /**
+     * Build and check every scenario of a multi-scenario configuration.
+     *
+     * @param scenarios_config YAML node holding the base configuration, scenarios, and sweep
+     */
+    void build_scenarios(const YAML::Node& scenarios_config) noexcept;
+
+    /**
+     * Check a scenario and append it to the table.
+     *
+     * @param name name of the scenario
+     * @param network_config network configuration of the scenario
+     */
+    void add_scenario(std::string name, const YAML::Node& network_config) noexcept;
+};
+
+}  // namespace NetworkAnalytical
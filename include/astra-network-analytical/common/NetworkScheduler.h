@@ -0,0 +1,64 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Event.h"
+#include "common/Type.h"
+
+namespace NetworkAnalytical {
+
+/**
+ * NetworkScheduler abstracts where the network backend schedules its events.
+ * EventQueue implements it for standalone simulation;
+ * a host simulator (e.g., ASTRA-sim) may implement it on top of its own event queue,
+ * so network events are scheduled straight into the host's queue.
+ *
+ * A host implementation should invoke each scheduled event (Event::invoke_event)
+ * at its event time, with get_current_time() returning that time meanwhile.
+ * Events of the same event time should be invoked in the order they were scheduled.
+ */
+class NetworkScheduler {
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~NetworkScheduler() noexcept = default;
+
+    /**
+     * Get current event time of the scheduler.
+     *
+     * @return current event time
+     */
+    [[nodiscard]] virtual EventTime get_current_time() const noexcept = 0;
+
+    /**
+     * Schedule an event with a given event time.
+     *
+     * @param event_time time of event, at least the current event time
+     * @param event event to schedule
+     */
+    virtual void schedule_event(EventTime event_time, const Event& event) noexcept = 0;
+
+    /**
+     * Schedule a user callback event with a given event time.
+     *
+     * @param event_time time of event
+     * @param callback callback function pointer
+     * @param callback_arg argument of the callback function
+     */
+    void schedule_event(EventTime event_time, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Schedule an internal event with a given event time.
+     *
+     * @param event_time time of event
+     * @param event_kind kind of the event, other than EventKind::UserCallback
+     * @param callback_arg argument of the event handler
+     */
+    void schedule_event(EventTime event_time, EventKind event_kind, CallbackArg callback_arg) noexcept;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,20 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+/// Observer switch (0: off, 1: on)
+/// When off, the hooks feeding observers (link traces, critical paths, utilization samplers,
+/// completion logs, latency histograms) are removed at compile time, and attaching one is an error.
+#ifndef NETWORK_ANALYTICAL_ENABLE_OBSERVERS
+    #define NETWORK_ANALYTICAL_ENABLE_OBSERVERS 1
+#endif
+
+namespace NetworkAnalytical {
+
+/// true if the observer hooks are compiled in
+constexpr bool observers_enabled = (NETWORK_ANALYTICAL_ENABLE_OBSERVERS != 0);
+
+}  // namespace NetworkAnalytical
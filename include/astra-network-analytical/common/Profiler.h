@@ -0,0 +1,170 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/// Self-profiling switch (0: off, 1: on)
+/// When off, profiled zones are removed at compile time.
+#ifndef NETWORK_ANALYTICAL_ENABLE_PROFILING
+    #define NETWORK_ANALYTICAL_ENABLE_PROFILING 0
+#endif
+
+/// Zones are also emitted to the Tracy or the ITT (VTune) profiler if enabled (only when profiling is on)
+#ifndef NETWORK_ANALYTICAL_ENABLE_TRACY
+    #define NETWORK_ANALYTICAL_ENABLE_TRACY 0
+#endif
+#ifndef NETWORK_ANALYTICAL_ENABLE_ITT
+    #define NETWORK_ANALYTICAL_ENABLE_ITT 0
+#endif
+
+#if NETWORK_ANALYTICAL_ENABLE_PROFILING && NETWORK_ANALYTICAL_ENABLE_TRACY
+    #include <tracy/Tracy.hpp>
+    #define NETWORK_ANALYTICAL_PROFILE_TRACY_ZONE(zone) ZoneScopedN(#zone)
+#else
+    #define NETWORK_ANALYTICAL_PROFILE_TRACY_ZONE(zone) static_cast<void>(0)
+#endif
+
+/**
+ * Profile the rest of the enclosing scope as a zone, e.g.,
+ *   NETWORK_ANALYTICAL_PROFILE(ProfileZone::Route);
+ *
+ * Only compiled in if profiling is enabled.
+ */
+#if NETWORK_ANALYTICAL_ENABLE_PROFILING
+    #define NETWORK_ANALYTICAL_PROFILE(zone)                                                            \
+        NETWORK_ANALYTICAL_PROFILE_TRACY_ZONE(zone);                                                    \
+        [[maybe_unused]] const auto network_analytical_profile_scope = NetworkAnalytical::ProfileScope( \
+            NetworkAnalytical::zone)
+#else
+    #define NETWORK_ANALYTICAL_PROFILE(zone) static_cast<void>(0)
+#endif
+
+namespace NetworkAnalytical {
+
+/// true if profiled zones are compiled in
+constexpr bool profiling_enabled = (NETWORK_ANALYTICAL_ENABLE_PROFILING != 0);
+
+/**
+ * Zones of the simulator profiled by the Profiler: the event kinds and the topology operations.
+ */
+enum class ProfileZone {
+    EventLoop = 0,  ///< processing an EventList (EventQueue::proceed), every other zone nested inside
+    ChunkArrival,   ///< a chunk arriving at the next device of its route
+    LinkFree,       ///< a link getting free, sending its next pending chunk
+    Route,          ///< computing (or looking up) a route
+    Send,           ///< a topology injecting or forwarding a chunk (Topology::send)
+    LinkSend,       ///< a link starting or queueing the transmission of a chunk (Link::send)
+    Callback,       ///< a user callback invoked on chunk delivery
+    Count           ///< number of zones
+};
+
+/**
+ * Time and number of calls of a profiled zone.
+ */
+struct ProfileCounters {
+    /// number of times the zone was entered
+    uint64_t calls = 0;
+
+    /// total time spent in the zone, in cycles (nested zones included)
+    uint64_t cycles = 0;
+};
+
+/**
+ * Profiler accumulates the time the simulator spends in each zone (see ProfileZone),
+ * in cycles of the timestamp counter (or in ns where none is available), over every thread.
+ *
+ * Profiling is opt-in at build time (NETWORK_BACKEND_ENABLE_PROFILING):
+ * zones are marked with NETWORK_ANALYTICAL_PROFILE, which is removed at compile time otherwise.
+ * Times are inclusive: EventLoop holds every other zone, and, e.g., Send holds the LinkSend it triggers.
+ */
+class Profiler {
+  public:
+    /**
+     * Get the name of a zone.
+     *
+     * @param zone zone
+     * @return name of the zone
+     */
+    [[nodiscard]] static const char* zone_name(ProfileZone zone) noexcept;
+
+    /**
+     * Read the cycle counter.
+     *
+     * @return current cycle count
+     */
+    [[nodiscard]] static uint64_t read_cycles() noexcept;
+
+    /**
+     * Account a call of a zone.
+     *
+     * @param zone zone
+     * @param cycles time spent in the zone, in cycles
+     */
+    static void record(ProfileZone zone, uint64_t cycles) noexcept;
+
+    /**
+     * Get the counters of a zone, accumulated since the last reset.
+     *
+     * @param zone zone
+     * @return counters of the zone
+     */
+    [[nodiscard]] static ProfileCounters get_counters(ProfileZone zone) noexcept;
+
+    /**
+     * Clear the counters of every zone.
+     */
+    static void reset() noexcept;
+
+    /**
+     * Write the counters of every zone entered since the last reset, as a table:
+     * calls, cycles, cycles per call, and share of the EventLoop time.
+     *
+     * @param output stream to write to
+     */
+    static void report(std::ostream& output) noexcept;
+
+  private:
+    /// number of calls of each zone
+    static std::array<std::atomic<uint64_t>, static_cast<int>(ProfileZone::Count)> calls;
+
+    /// total cycles of each zone
+    static std::array<std::atomic<uint64_t>, static_cast<int>(ProfileZone::Count)> cycles;
+};
+
+/**
+ * ProfileScope accounts the time from its construction to its destruction to a zone
+ * (see NETWORK_ANALYTICAL_PROFILE).
+ */
+class ProfileScope {
+  public:
+    /**
+     * Constructor. Enters the zone.
+     *
+     * @param zone zone
+     */
+    explicit ProfileScope(ProfileZone zone) noexcept;
+
+    /**
+     * Destructor. Leaves the zone.
+     */
+    ~ProfileScope() noexcept;
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    /// zone
+    ProfileZone zone;
+
+    /// cycle count when the zone was entered
+    uint64_t start_cycles;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,219 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * Query of the times of a batch of chunks on the topology of a network config,
+ * answered by a long-lived QueryServer (see DelayService and SimulationService of each backend).
+ *
+ * Layout (native byte order, no padding):
+ *   request: config path length (u32), then its characters, chunks count (u32),
+ *            then the src (i32 each), dest (i32 each), and size (u64 each) of every chunk
+ *   answer: time of every chunk (u64 each)
+ */
+struct ChunkQuery {
+    /// path of the network config (yml) of the topology
+    std::string config_path;
+
+    /// src NPU id of each chunk
+    std::vector<DeviceId> srcs;
+
+    /// dest NPU id of each chunk
+    std::vector<DeviceId> dests;
+
+    /// size of each chunk
+    std::vector<ChunkSize> chunk_sizes;
+
+    /**
+     * Encode the query into a request.
+     *
+     * @return request
+     */
+    [[nodiscard]] std::string encode() const noexcept;
+
+    /**
+     * Decode a request.
+     *
+     * @param request request
+     * @param query decoded query
+     * @return true if the request is well-formed, false otherwise
+     */
+    static bool decode(const std::string& request, ChunkQuery& query) noexcept;
+
+    /**
+     * Encode the time of every chunk into an answer.
+     *
+     * @param times time of every chunk
+     * @return answer
+     */
+    [[nodiscard]] static std::string encode_answer(const std::vector<EventTime>& times) noexcept;
+
+    /**
+     * Decode an answer.
+     *
+     * @param answer answer
+     * @param times decoded time of every chunk
+     * @return true if the answer is well-formed (not an error), false otherwise
+     */
+    static bool decode_answer(const std::string& answer, std::vector<EventTime>& times) noexcept;
+};
+
+/**
+ * QueryServer answers requests of many client processes over a Unix domain socket,
+ * so topologies are constructed once by the server rather than once per client.
+ *
+ * Requests and answers are frames of bytes, each prefixed with its length (u64);
+ * an empty answer reports a malformed request.
+ * Every client connection is served by a thread of its own, and a client may send any number of requests.
+ * Answers depend only on their requests, so they're cached across clients, up to a given number of entries
+ * (the oldest entries are evicted first).
+ */
+class QueryServer {
+  public:
+    /// answers a request (empty answer: malformed request); called concurrently by the client threads
+    using Handler = std::function<std::string(const std::string& request)>;
+
+    /**
+     * Constructor.
+     *
+     * @param socket_path path of the Unix domain socket to listen on
+     * @param handler answers the requests
+     * @param cache_capacity number of answers cached (0: no caching)
+     */
+    QueryServer(std::string socket_path, Handler handler, size_t cache_capacity = 0) noexcept;
+
+    /**
+     * Destructor. Stops the server if running.
+     */
+    ~QueryServer() noexcept;
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * Listen on the socket (replacing a stale one), and accept clients on a background thread.
+     */
+    void start() noexcept;
+
+    /**
+     * Stop accepting clients, disconnect the connected ones, and remove the socket.
+     */
+    void stop() noexcept;
+
+    /**
+     * Get the number of requests answered.
+     *
+     * @return number of requests
+     */
+    [[nodiscard]] uint64_t get_requests_count() const noexcept;
+
+    /**
+     * Get the number of requests answered from the cache.
+     *
+     * @return number of cache hits
+     */
+    [[nodiscard]] uint64_t get_cache_hits_count() const noexcept;
+
+  private:
+    /// path of the socket
+    std::string socket_path;
+
+    /// answers the requests
+    Handler handler;
+
+    /// number of answers cached
+    size_t cache_capacity;
+
+    /// listening socket (-1 if not running)
+    int listen_fd;
+
+    /// thread accepting clients
+    std::thread accept_thread;
+
+    /// thread and socket of each client, guarded by clients_mutex
+    std::vector<std::thread> client_threads;
+    std::vector<int> client_fds;
+    std::mutex clients_mutex;
+
+    /// cached answer of each request, and the cached requests from the oldest, guarded by cache_mutex
+    std::unordered_map<std::string, std::string> cached_answers;
+    std::deque<std::string> cached_requests;
+    std::mutex cache_mutex;
+
+    /// number of requests answered
+    std::atomic<uint64_t> requests_count;
+
+    /// number of requests answered from the cache
+    std::atomic<uint64_t> cache_hits_count;
+
+    /**
+     * Accept clients until the server stops.
+     */
+    void accept_clients() noexcept;
+
+    /**
+     * Answer the requests of a client until it disconnects.
+     *
+     * @param client_fd socket of the client
+     */
+    void serve_client(int client_fd) noexcept;
+
+    /**
+     * Answer a request, from the cache if possible.
+     *
+     * @param request request
+     * @return answer
+     */
+    [[nodiscard]] std::string answer(const std::string& request) noexcept;
+};
+
+/**
+ * QueryClient sends requests to a QueryServer.
+ */
+class QueryClient {
+  public:
+    /**
+     * Constructor. Connects to the server.
+     *
+     * @param socket_path path of the server's Unix domain socket
+     */
+    explicit QueryClient(const std::string& socket_path) noexcept;
+
+    /**
+     * Destructor. Disconnects from the server.
+     */
+    ~QueryClient() noexcept;
+
+    QueryClient(const QueryClient&) = delete;
+    QueryClient& operator=(const QueryClient&) = delete;
+
+    /**
+     * Send a request and wait for its answer.
+     *
+     * @param request request
+     * @return answer (empty if the request is malformed or the server is gone)
+     */
+    [[nodiscard]] std::string query(const std::string& request) noexcept;
+
+  private:
+    /// socket connected to the server
+    int fd;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,123 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace NetworkAnalytical {
+
+/**
+ * Reclaimer releases discarded storage on a background thread:
+ * the storage of a finished simulation (e.g., millions of links and routes, see Topology::set_background_teardown)
+ * is handed over with a move, so the discarding thread moves on at once
+ * while the destructors run and the memory is freed elsewhere.
+ *
+ * At most max_pending_count storages wait at once: beyond that, the discarding thread releases its storage itself,
+ * so discarding faster than the background thread releases doesn't pile up memory.
+ */
+class Reclaimer {
+  public:
+    /// most storages waiting to be released at once
+    static constexpr int max_pending_count = 8;
+
+    /**
+     * Get the reclaimer of the process (its thread starts on the first storage handed over).
+     *
+     * @return reclaimer of the process
+     */
+    [[nodiscard]] static Reclaimer& get() noexcept;
+
+    /**
+     * Destructor. Releases every pending storage, then stops the background thread.
+     */
+    ~Reclaimer() noexcept;
+
+    Reclaimer(const Reclaimer&) = delete;
+    Reclaimer& operator=(const Reclaimer&) = delete;
+
+    /**
+     * Hand over storage to be released on the background thread.
+     *
+     * @param storage storage to release, moved in (its destructor shouldn't depend on the discarding thread)
+     */
+    template <typename Storage>
+    void reclaim(Storage storage) noexcept {
+        enqueue(std::make_unique<StorageHolder<Storage>>(std::move(storage)));
+    }
+
+    /**
+     * Wait until every storage handed over so far is released.
+     */
+    void drain() noexcept;
+
+    /**
+     * Get the number of storages released so far, by the background thread or the discarding ones.
+     *
+     * @return number of released storages
+     */
+    [[nodiscard]] uint64_t get_released_count() const noexcept;
+
+  private:
+    /// type-erased storage
+    struct Holder {
+        virtual ~Holder() noexcept = default;
+    };
+
+    /// holds storage of a given type until released
+    template <typename Storage>
+    struct StorageHolder final : Holder {
+        explicit StorageHolder(Storage&& storage) noexcept : storage(std::move(storage)) {}
+
+        /// storage to release
+        Storage storage;
+    };
+
+    /// storages waiting to be released, guarded by pending_mutex
+    std::deque<std::unique_ptr<Holder>> pending;
+
+    /// whether the background thread is releasing a storage, guarded by pending_mutex
+    bool releasing;
+
+    /// whether the background thread should stop once nothing is pending, guarded by pending_mutex
+    bool stopping;
+
+    /// number of released storages, guarded by pending_mutex
+    uint64_t released_count;
+
+    /// guards the pending storages
+    mutable std::mutex pending_mutex;
+
+    /// signals a change of the pending storages
+    std::condition_variable pending_changed;
+
+    /// thread releasing the pending storages
+    std::thread release_thread;
+
+    /**
+     * Constructor.
+     */
+    Reclaimer() noexcept;
+
+    /**
+     * Queue storage to be released, or release it right away if too many are pending.
+     *
+     * @param holder storage to release
+     */
+    void enqueue(std::unique_ptr<Holder> holder) noexcept;
+
+    /**
+     * Release the pending storages until stopped.
+     */
+    void release_pending() noexcept;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,131 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace NetworkAnalytical {
+
+/**
+ * Memoized result of a simulation.
+ */
+struct CachedResult {
+    /// time the simulation finished
+    EventTime finish_time = 0;
+
+    /// summary statistics of the simulation, per name (e.g., "chunks_delivered")
+    std::map<std::string, uint64_t> stats;
+};
+
+/**
+ * ResultCache memoizes simulation results on disk, so identical simulations
+ * (same network configuration, workload, backend, and time base) across runs and processes return at once.
+ *
+ * Every result is a file of the cache directory, named after the hash of its key
+ * and holding the whole key, so hash collisions are detected rather than returning a wrong result.
+ * Files are replaced at once, so concurrent processes may share a directory.
+ *
+ * The workload is described by the caller, and the description should cover everything the result depends on
+ * (e.g., the collective type, algorithm, and size, or the hash of a trace file's contents, see hash_file).
+ */
+class ResultCache {
+  public:
+    /// version of the result files; bump it when the timing model changes, invalidating older results
+    static constexpr uint32_t version = 1;
+
+    /**
+     * Constructor. Creates the cache directory if missing.
+     *
+     * @param directory directory of the result files
+     */
+    explicit ResultCache(std::string directory) noexcept;
+
+    /**
+     * Build the key of a simulation.
+     * The key covers the network configuration (see NetworkParser::get_config_hash), the workload,
+     * the backend, and the time base.
+     *
+     * @param network_parser network configuration of the simulation
+     * @param workload description of the workload
+     * @return key of the simulation
+     */
+    [[nodiscard]] static std::string make_key(const NetworkParser& network_parser,
+                                              const std::string& workload) noexcept;
+
+    /**
+     * Hash the contents of a file (64-bit FNV-1a), e.g., to describe a trace workload.
+     *
+     * @param path path of the file
+     * @return hash of the contents
+     */
+    [[nodiscard]] static uint64_t hash_file(const std::string& path) noexcept;
+
+    /**
+     * Look up the result of a simulation.
+     *
+     * @param key key of the simulation
+     * @param result output: cached result
+     * @return true if cached, false otherwise
+     */
+    bool lookup(const std::string& key, CachedResult& result) const noexcept;
+
+    /**
+     * Store the result of a simulation.
+     *
+     * @param key key of the simulation
+     * @param result result to store
+     * @return true if stored, false if the file can't be written
+     */
+    bool store(const std::string& key, const CachedResult& result) const noexcept;
+
+    /**
+     * Get the cached result of a simulation, simulating and storing it if missing.
+     *
+     * @param key key of the simulation
+     * @param simulate simulates on a cache miss
+     * @return result of the simulation
+     */
+    [[nodiscard]] CachedResult get_or_simulate(const std::string& key,
+                                               const std::function<CachedResult()>& simulate) noexcept;
+
+    /**
+     * Get the number of get_or_simulate calls answered from the cache.
+     *
+     * @return number of cache hits
+     */
+    [[nodiscard]] uint64_t get_hits_count() const noexcept;
+
+    /**
+     * Get the number of get_or_simulate calls that simulated.
+     *
+     * @return number of cache misses
+     */
+    [[nodiscard]] uint64_t get_misses_count() const noexcept;
+
+  private:
+    /// directory of the result files
+    std::string directory;
+
+    /// number of cache hits and misses
+    std::atomic<uint64_t> hits_count;
+    std::atomic<uint64_t> misses_count;
+
+    /**
+     * Get the path of the result file of a key.
+     *
+     * @param key key of the simulation
+     * @return path of the result file
+     */
+    [[nodiscard]] std::string get_path(const std::string& key) const noexcept;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,334 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/ExecutionTrace.h"
+#include "common/Type.h"
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/// id of a node of a SendGraph, in insertion order
+using SendNodeId = uint32_t;
+
+/**
+ * SendGraph is an in-memory dependency DAG of send operations, e.g., a multi-million-node communication schedule.
+ *
+ * A node sends size bytes from src to dest once all its dependencies completed and its delay elapsed,
+ * and completes once the message is delivered. A node of size 0 sends nothing: it completes after its delay,
+ * e.g., to model a computation or to join many dependencies.
+ *
+ * Nodes are held in columns, and dependencies in compressed sparse rows (CSR) built by finalize(),
+ * i.e., about 24 bytes per node and 4 bytes per dependency.
+ */
+class SendGraph {
+  public:
+    /**
+     * Constructor of an empty graph.
+     */
+    SendGraph() noexcept;
+
+    /**
+     * Add a send node. Only allowed before finalize().
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id, other than src unless size is 0
+     * @param size number of bytes to send (0: send nothing)
+     * @param delay time to wait once the dependencies completed, before sending
+     * @return id of the node
+     */
+    SendNodeId add_send(DeviceId src, DeviceId dest, ChunkSize size, EventTime delay = 0) noexcept;
+
+    /**
+     * Make a node wait for another one to complete. Only allowed before finalize().
+     *
+     * @param dependency node to complete first
+     * @param dependent node waiting for it
+     */
+    void add_dependency(SendNodeId dependency, SendNodeId dependent) noexcept;
+
+    /**
+     * Build the dependency rows, exiting if the dependencies form a cycle.
+     * The graph can't be modified afterwards.
+     */
+    void finalize() noexcept;
+
+    /**
+     * Check if the graph was finalized.
+     *
+     * @return true if finalized, false otherwise
+     */
+    [[nodiscard]] bool is_finalized() const noexcept;
+
+    /**
+     * Get the number of nodes.
+     *
+     * @return number of nodes
+     */
+    [[nodiscard]] SendNodeId get_nodes_count() const noexcept;
+
+    /**
+     * Get the number of dependencies.
+     *
+     * @return number of dependencies
+     */
+    [[nodiscard]] uint64_t get_dependencies_count() const noexcept;
+
+    /**
+     * Get the src NPU of a node.
+     *
+     * @param node node id
+     * @return src NPU id
+     */
+    [[nodiscard]] DeviceId get_src(SendNodeId node) const noexcept;
+
+    /**
+     * Get the dest NPU of a node.
+     *
+     * @param node node id
+     * @return dest NPU id
+     */
+    [[nodiscard]] DeviceId get_dest(SendNodeId node) const noexcept;
+
+    /**
+     * Get the number of bytes a node sends.
+     *
+     * @param node node id
+     * @return size of the message (0: none)
+     */
+    [[nodiscard]] ChunkSize get_size(SendNodeId node) const noexcept;
+
+    /**
+     * Get the delay of a node.
+     *
+     * @param node node id
+     * @return time the node waits once its dependencies completed
+     */
+    [[nodiscard]] EventTime get_delay(SendNodeId node) const noexcept;
+
+    /**
+     * Get the number of dependencies of a node (finalized graphs only).
+     *
+     * @param node node id
+     * @return number of nodes the node waits for
+     */
+    [[nodiscard]] uint32_t get_node_dependencies_count(SendNodeId node) const noexcept;
+
+    /**
+     * Get the nodes waiting for a node (finalized graphs only).
+     *
+     * @param node node id
+     * @return range of the dependent node ids
+     */
+    [[nodiscard]] std::pair<const SendNodeId*, const SendNodeId*> get_dependents(SendNodeId node) const noexcept;
+
+    /**
+     * Get the largest NPU id the nodes refer to.
+     *
+     * @return largest NPU id, -1 if the graph is empty
+     */
+    [[nodiscard]] DeviceId get_max_npu_id() const noexcept;
+
+    /**
+     * Get the bytes held by the graph.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
+
+  private:
+    /// src NPU of each node
+    std::vector<DeviceId> srcs;
+
+    /// dest NPU of each node
+    std::vector<DeviceId> dests;
+
+    /// size of each node
+    std::vector<ChunkSize> sizes;
+
+    /// delay of each node (empty while no node has a delay)
+    std::vector<EventTime> delays;
+
+    /// (dependency, dependent) pairs added so far (dropped by finalize)
+    std::vector<std::pair<SendNodeId, SendNodeId>> added_dependencies;
+
+    /// start of the dependents of each node in dependents, plus the end of the last node's
+    std::vector<uint32_t> dependents_offsets;
+
+    /// dependents of every node, grouped by node
+    std::vector<SendNodeId> dependents;
+
+    /// number of dependencies of each node
+    std::vector<uint32_t> dependencies_counts;
+
+    /// largest NPU id the nodes refer to
+    DeviceId max_npu_id;
+
+    /// true once the graph was finalized
+    bool finalized;
+};
+
+/**
+ * SendGraphRun executes a SendGraph on a network (either backend, see ExecutionTraceNetwork):
+ * nodes are issued from a ready queue as their dependencies complete, in the order they become ready.
+ * Only the issued nodes take memory beyond the per-node dependency counters.
+ */
+class SendGraphRun {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param network network to run the graph on
+     * @param graph finalized graph to run, outliving the run
+     */
+    SendGraphRun(ExecutionTraceNetwork& network, const SendGraph& graph) noexcept;
+
+    /**
+     * Issue the nodes without dependencies.
+     * The simulation is then driven by the network's scheduler.
+     *
+     * @param callback callback to be invoked when every node completed (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    void start(Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Check if every node completed.
+     *
+     * @return true if the run finished, false otherwise
+     */
+    [[nodiscard]] bool finished() const noexcept;
+
+    /**
+     * Get the time the last node completed.
+     *
+     * @return finish time of the run
+     */
+    [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+    /**
+     * Get the number of completed nodes.
+     *
+     * @return number of completed nodes
+     */
+    [[nodiscard]] uint64_t get_completed_nodes_count() const noexcept;
+
+    /**
+     * Get the largest number of nodes issued but not completed at once.
+     *
+     * @return peak number of in-flight nodes
+     */
+    [[nodiscard]] uint64_t get_peak_in_flight_count() const noexcept;
+
+  private:
+    /// an issued node, passed as the callback argument of its delay or send
+    struct Operation {
+        /// run the node belongs to
+        SendGraphRun* run;
+
+        /// id of the node
+        SendNodeId node;
+    };
+
+    /// network to run the graph on
+    ExecutionTraceNetwork& network;
+
+    /// graph to run
+    const SendGraph& graph;
+
+    /// dependencies not completed yet, per node
+    std::vector<uint32_t> pending_dependencies;
+
+    /// nodes whose dependencies completed, to be issued from ready_head on
+    std::vector<SendNodeId> ready_nodes;
+
+    /// index of the next ready node to issue
+    size_t ready_head;
+
+    /// true while ready nodes are being issued
+    bool issuing;
+
+    /// true once the finish callback was invoked
+    bool finish_reported;
+
+    /// number of completed nodes
+    uint64_t completed_nodes_count;
+
+    /// number of issued but not completed nodes
+    uint64_t in_flight_count;
+
+    /// largest number of issued but not completed nodes
+    uint64_t peak_in_flight_count;
+
+    /// time the last node completed
+    EventTime finish_time;
+
+    /// callback to be invoked when every node completed
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+
+    /// storage of issued operations (stable addresses, grows to the peak in-flight count)
+    std::deque<Operation> operations;
+
+    /// operations ready to be reused
+    std::vector<Operation*> free_operations;
+
+    /**
+     * Callback of an elapsed node delay: send the node's message.
+     *
+     * @param operation_ptr pointer to the operation
+     */
+    static void delay_elapsed(void* operation_ptr) noexcept;
+
+    /**
+     * Callback of a completed node.
+     *
+     * @param operation_ptr pointer to the operation
+     */
+    static void operation_completed(void* operation_ptr) noexcept;
+
+    /**
+     * Issue the ready nodes, including the ones they make ready,
+     * then invoke the finish callback if every node completed.
+     */
+    void issue_ready_nodes() noexcept;
+
+    /**
+     * Issue a node whose dependencies completed.
+     *
+     * @param node node id
+     */
+    void issue_node(SendNodeId node) noexcept;
+
+    /**
+     * Send the message of an issued node, or complete it if it sends nothing.
+     *
+     * @param operation operation of the node
+     */
+    void send(Operation* operation) noexcept;
+
+    /**
+     * Complete a node: release its dependents.
+     *
+     * @param node node id
+     */
+    void complete_node(SendNodeId node) noexcept;
+
+    /**
+     * Take an operation slot.
+     *
+     * @param node node id
+     * @return operation
+     */
+    Operation* acquire_operation(SendNodeId node) noexcept;
+};
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,39 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/// what-if branch of a simulation: simulates variant `branch` and returns its result (e.g., an encoded summary)
+using SimulationBranch = std::function<std::string(int branch)>;
+
+/**
+ * Fork the whole simulation state into what-if branches sharing the common prefix simulated so far,
+ * e.g., run a workload up to 90% once, then finish it under different priorities or failed links.
+ *
+ * Every branch runs in a child process forked from the current state
+ * (event queue, links, in-flight chunks, and the caller's own state alike, copied on write),
+ * so branches can't disturb each other or the caller, which resumes unchanged afterwards.
+ * Results are returned over a socket; anything else a branch changes is discarded with its process.
+ * Branches may fork further branches of their own.
+ *
+ * Forking duplicates the calling thread only:
+ * call it while no other thread is simulating (e.g., not from a running parallel event queue).
+ *
+ * @param branches_count number of branches
+ * @param branch simulates a branch, called in its child process
+ * @param max_concurrent_branches branches running at once (0: number of hardware threads)
+ * @return result of every branch, indexed by branch
+ */
+[[nodiscard]] std::vector<std::string> fork_branches(int branches_count,
+                                                     const SimulationBranch& branch,
+                                                     int max_concurrent_branches = 0) noexcept;
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,130 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * SpscRing is a bounded lock-free queue between a single producer thread and a single consumer thread.
+ *
+ * Slots form a power-of-2 ring indexed by two ever-increasing counters, each written by one side only,
+ * and each side keeps a copy of the other side's counter, only reloaded once the ring looks full (or empty),
+ * so pushing and popping usually touch no cache line written by the other thread.
+ *
+ * @tparam T type of the elements, default-constructible and movable
+ */
+template <typename T> class SpscRing {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param capacity least number of elements the ring holds, rounded up to a power of 2
+     */
+    explicit SpscRing(const size_t capacity) noexcept
+        : head(0),
+          cached_tail(0),
+          tail(0),
+          cached_head(0) {
+        assert(capacity > 0);
+
+        auto slots_count = static_cast<size_t>(1);
+        while (slots_count < capacity) {
+            slots_count *= 2;
+        }
+        slots.resize(slots_count);
+        mask = slots_count - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Push an element at the back of the ring, producer thread only.
+     *
+     * @param value element to push, moved from only if pushed
+     * @return true if pushed, false if the ring is full
+     */
+    [[nodiscard]] bool try_push(T& value) noexcept {
+        const auto current_tail = tail.load(std::memory_order_relaxed);
+        if (current_tail - cached_head == slots.size()) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (current_tail - cached_head == slots.size()) {
+                return false;
+            }
+        }
+
+        slots[current_tail & mask] = std::move(value);
+        tail.store(current_tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Get the element at the front of the ring, consumer thread only.
+     *
+     * @return front element, nullptr if the ring is empty
+     */
+    [[nodiscard]] T* front() noexcept {
+        const auto current_head = head.load(std::memory_order_relaxed);
+        if (current_head == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (current_head == cached_tail) {
+                return nullptr;
+            }
+        }
+
+        return &slots[current_head & mask];
+    }
+
+    /**
+     * Remove the element at the front of the ring (see front), consumer thread only.
+     */
+    void pop() noexcept {
+        const auto current_head = head.load(std::memory_order_relaxed);
+        assert(current_head != cached_tail);
+
+        slots[current_head & mask] = T();
+        head.store(current_head + 1, std::memory_order_release);
+    }
+
+    /**
+     * Get the number of elements the ring holds.
+     *
+     * @return capacity of the ring
+     */
+    [[nodiscard]] size_t capacity() const noexcept {
+        return slots.size();
+    }
+
+  private:
+    /// size of a cache line, the counters of each side are kept apart by
+    static constexpr size_t cache_line_size = 64;
+
+    /// slots of the ring
+    std::vector<T> slots;
+
+    /// slots count - 1, to wrap the counters around
+    size_t mask;
+
+    /// number of popped elements (written by the consumer)
+    alignas(cache_line_size) std::atomic<size_t> head;
+
+    /// copy of tail last seen by the consumer
+    size_t cached_tail;
+
+    /// number of pushed elements (written by the producer)
+    alignas(cache_line_size) std::atomic<size_t> tail;
+
+    /// copy of head last seen by the producer
+    size_t cached_head;
+};
+
+}  // namespace NetworkAnalytical
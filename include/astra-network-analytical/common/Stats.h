@@ -0,0 +1,32 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+/// Instrumentation switch (0: off, 1: on)
+/// When off, statistics counters are never updated and the updates are removed at compile time.
+#ifndef NETWORK_ANALYTICAL_ENABLE_STATS
+    #define NETWORK_ANALYTICAL_ENABLE_STATS 0
+#endif
+
+/**
+ * Update statistics counters, e.g.,
+ *   NETWORK_ANALYTICAL_STATS(stats.events_scheduled++);
+ *
+ * The statement is only compiled in if statistics are enabled.
+ */
+#define NETWORK_ANALYTICAL_STATS(statement)                    \
+    do {                                                       \
+        if constexpr (NetworkAnalytical::stats_enabled) {      \
+            statement;                                         \
+        }                                                      \
+    } while (false)
+
+namespace NetworkAnalytical {
+
+/// true if statistics counters are compiled in
+constexpr bool stats_enabled = (NETWORK_ANALYTICAL_ENABLE_STATS != 0);
+
+}  // namespace NetworkAnalytical
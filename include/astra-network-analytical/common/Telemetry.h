@@ -0,0 +1,167 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace NetworkAnalytical {
+
+/**
+ * Telemetry exposes the live progress of a long-running simulation or sweep in the Prometheus text format,
+ * over HTTP (any request is answered with the metrics) or through render():
+ * the simulated time, events processed (and per second of wall time), pending EventLists,
+ * gauges registered by the simulation (e.g., live chunks, see Topology::set_telemetry), and sweep progress.
+ *
+ * It is opt-in (see EventQueue::set_telemetry): the event loop publishes its progress every given number of
+ * EventLists only, so the simulation pays a counter decrement per EventList.
+ * Published values are atomics, so scrapes never stall the simulation.
+ */
+class Telemetry {
+  public:
+    /// samples a gauge, called on the event loop thread when progress is published
+    using GaugeSampler = std::function<double()>;
+
+    /**
+     * Constructor.
+     *
+     * @param publish_interval number of EventLists processed between two publications of the progress
+     */
+    explicit Telemetry(int publish_interval = 4'096) noexcept;
+
+    /**
+     * Destructor. Stops serving if serving.
+     */
+    ~Telemetry() noexcept;
+
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    /**
+     * Get the number of EventLists processed between two publications of the progress.
+     *
+     * @return publication interval
+     */
+    [[nodiscard]] int get_publish_interval() const noexcept;
+
+    /**
+     * Publish the progress of an event loop, sampling every registered gauge.
+     * Called by the event loop (see EventQueue::set_telemetry).
+     *
+     * @param current_time current simulated time
+     * @param events_processed number of events processed so far
+     * @param pending_event_lists number of EventLists pending
+     */
+    void publish(EventTime current_time, uint64_t events_processed, int pending_event_lists) noexcept;
+
+    /**
+     * Register (or replace) a gauge, sampled whenever progress is published.
+     *
+     * @param name metric name, e.g., "network_analytical_live_chunks"
+     * @param help description of the metric
+     * @param sampler samples the gauge
+     */
+    void set_gauge(const std::string& name, std::string help, GaugeSampler sampler) noexcept;
+
+    /**
+     * Unregister a gauge (nothing if not registered).
+     *
+     * @param name metric name
+     */
+    void remove_gauge(const std::string& name) noexcept;
+
+    /**
+     * Set the number of points of a sweep (see Sweep::set_telemetry), resetting its completed points.
+     *
+     * @param points_count number of points
+     */
+    void start_sweep(int points_count) noexcept;
+
+    /**
+     * Count a completed sweep point. Called concurrently by the sweep workers.
+     */
+    void complete_sweep_point() noexcept;
+
+    /**
+     * Render every metric in the Prometheus text exposition format.
+     *
+     * @return metrics
+     */
+    [[nodiscard]] std::string render() const noexcept;
+
+    /**
+     * Serve the metrics over HTTP on a TCP port of every interface, on a background thread.
+     *
+     * @param port port to listen on (0: any free port)
+     * @return port listened on
+     */
+    uint16_t serve(uint16_t port = 0) noexcept;
+
+    /**
+     * Stop serving the metrics.
+     */
+    void stop() noexcept;
+
+  private:
+    /// gauge registered by the simulation
+    struct Gauge {
+        /// description of the metric
+        std::string help;
+
+        /// samples the gauge
+        GaugeSampler sampler;
+
+        /// latest sample
+        double value = 0;
+    };
+
+    /// number of EventLists processed between two publications
+    int publish_interval;
+
+    /// latest published simulated time
+    std::atomic<EventTime> current_time;
+
+    /// latest published number of processed events
+    std::atomic<uint64_t> events_processed;
+
+    /// events processed per second of wall time, between the two latest publications
+    std::atomic<double> events_per_second;
+
+    /// latest published number of pending EventLists
+    std::atomic<int> pending_event_lists;
+
+    /// wall time and processed events of the latest publication, to derive the rate (event loop thread only)
+    std::chrono::steady_clock::time_point published_wall_time;
+    uint64_t published_events_processed;
+
+    /// registered gauges by name, guarded by gauges_mutex
+    std::map<std::string, Gauge> gauges;
+    mutable std::mutex gauges_mutex;
+
+    /// number of points of the sweep, and the completed ones
+    std::atomic<int> sweep_points_count;
+    std::atomic<int> sweep_points_completed;
+
+    /// listening socket (-1 if not serving)
+    int listen_fd;
+
+    /// thread answering the scrapes
+    std::thread serve_thread;
+
+    /**
+     * Answer the scrapes until serving stops.
+     */
+    void serve_scrapes() noexcept;
+};
+
+}  // namespace NetworkAnalytical
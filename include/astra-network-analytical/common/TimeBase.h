@@ -0,0 +1,49 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+
+/// Time base: number of simulation ticks per ns (1: ns, 1000: ps)
+/// EventTime counts ticks, so sub-ns serialization delays of fast links aren't rounded to zero.
+#ifndef NETWORK_ANALYTICAL_TICKS_PER_NS
+    #define NETWORK_ANALYTICAL_TICKS_PER_NS 1
+#endif
+
+namespace NetworkAnalytical {
+
+/// number of simulation ticks per ns
+constexpr EventTime ticks_per_ns = NETWORK_ANALYTICAL_TICKS_PER_NS;
+
+static_assert(ticks_per_ns >= 1, "NETWORK_ANALYTICAL_TICKS_PER_NS should be positive");
+
+/// unit of EventTime values, printed in reports
+constexpr const char* time_unit = (ticks_per_ns == 1)           ? "ns"
+                                  : (ticks_per_ns == 1'000)     ? "ps"
+                                  : (ticks_per_ns == 1'000'000) ? "fs"
+                                                                : "ticks";
+
+/**
+ * Convert a duration in ns (e.g., a link latency) to ticks, rounding down.
+ *
+ * @param ns duration in ns
+ * @return duration in ticks
+ */
+constexpr EventTime ns_to_ticks(const double ns) noexcept {
+    return static_cast<EventTime>(ns * static_cast<double>(ticks_per_ns));
+}
+
+/**
+ * Convert a duration in ticks to ns.
+ *
+ * @param ticks duration in ticks
+ * @return duration in ns
+ */
+constexpr double ticks_to_ns(const EventTime ticks) noexcept {
+    return static_cast<double>(ticks) / static_cast<double>(ticks_per_ns);
+}
+
+}  // namespace NetworkAnalytical
@@ -0,0 +1,136 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventListPool.h"
+#include "common/EventScheduler.h"
+#include "common/HeapEventScheduler.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * TimingWheelEventScheduler keeps near-future EventLists in a timing wheel.
+ *
+ * The wheel has one slot per nanosecond and covers the time window
+ * [wheel_start, wheel_start + slots_count).
+ * Events scheduled inside the window are inserted in O(1) time,
+ * and the next occupied slot is found by scanning an occupancy bitmap.
+ * Events beyond the window are kept in an overflow min-heap
+ * and migrated into the wheel once the window reaches them.
+ *
+ * Link transmissions schedule events within one communication delay
+ * of the current time, so most events never touch the overflow heap.
+ * Processed EventLists are recycled through an EventListPool.
+ */
+class TimingWheelEventScheduler final : public EventScheduler {
+  public:
+    /// default number of slots (covers 65.5 us of simulated time)
+    static constexpr int default_slots_count_log2 = 16;
+
+    /**
+     * Constructor.
+     *
+     * @param slots_count_log2 log2 of the number of slots in the wheel
+     */
+    explicit TimingWheelEventScheduler(int slots_count_log2 = default_slots_count_log2) noexcept;
+
+    /**
+     * Implementation of empty function in EventScheduler.
+     */
+    [[nodiscard]] bool empty() const noexcept override;
+
+    /**
+     * Implementation of size function in EventScheduler.
+     */
+    [[nodiscard]] int size() const noexcept override;
+
+    /**
+     * Implementation of front function in EventScheduler.
+     */
+    [[nodiscard]] EventList& front() noexcept override;
+
+    /**
+     * Implementation of pop_front function in EventScheduler.
+     */
+    void pop_front() noexcept override;
+
+    /**
+     * Implementation of get_or_create function in EventScheduler.
+     */
+    [[nodiscard]] EventList& get_or_create(EventTime event_time) noexcept override;
+
+    /**
+     * Implementation of clear function in EventScheduler.
+     */
+    void clear() noexcept override;
+
+    /**
+     * Implementation of get_memory_usage function in EventScheduler.
+     */
+    [[nodiscard]] MemoryUsage get_memory_usage() const noexcept override;
+
+  private:
+    /// number of slots in the wheel (power of 2)
+    EventTime slots_count;
+
+    /// bitmask to translate an event time into a slot index
+    EventTime slot_mask;
+
+    /// earliest event time the wheel can hold
+    /// every scheduled event time is at least wheel_start
+    EventTime wheel_start;
+
+    /// number of EventLists currently held in the wheel
+    int wheel_event_lists_count;
+
+    /// slots of the wheel, indexed by (event time & slot_mask)
+    std::vector<std::unique_ptr<EventList>> slots;
+
+    /// occupancy bitmap of the slots, 64 slots per word
+    std::vector<uint64_t> occupied;
+
+    /// EventLists beyond the wheel window
+    HeapEventScheduler overflow;
+
+    /// recycled EventLists
+    EventListPool event_list_pool;
+
+    /**
+     * Check if the given event time falls inside the current wheel window.
+     *
+     * @param event_time event time to check
+     * @return true if the event time can be held in the wheel, false otherwise
+     */
+    [[nodiscard]] bool in_window(EventTime event_time) const noexcept;
+
+    /**
+     * Find the occupied slot holding the earliest event time.
+     *
+     * @return slot index of the earliest EventList in the wheel
+     */
+    [[nodiscard]] EventTime find_first_occupied_slot() const noexcept;
+
+    /**
+     * Place an EventList into its slot.
+     *
+     * @param event_list EventList to place
+     * @return reference to the placed EventList
+     */
+    EventList& insert_into_wheel(std::unique_ptr<EventList> event_list) noexcept;
+
+    /**
+     * Advance the wheel window to start at the given event time,
+     * and migrate overflow EventLists that now fall inside the window.
+     *
+     * @param new_wheel_start new start time of the wheel window
+     */
+    void advance_window(EventTime new_wheel_start) noexcept;
+};
+
+}  // namespace NetworkAnalytical
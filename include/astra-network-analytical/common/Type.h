@@ -15,6 +15,17 @@ using Callback = void (*)(void*);
 /// Callback function argument: void*
 using CallbackArg = void*;
 
+/// Kinds of events: user callbacks, or internal events of the congestion-aware backend
+enum class EventKind { UserCallback, ChunkArrival, LinkFree };
+
+/// Resource an event touches, given its callback argument: "const void* func(void*)"
+/// Events touching different resources can be invoked concurrently (nullptr: the event runs alone)
+using EventResource = const void* (*)(void*);
+
+/// Order of an event among the events of the same time, given its callback argument: "uint64_t func(void*)"
+/// (see EventQueue::set_deterministic_order)
+using EventOrderKey = uint64_t (*)(void*);
+
 /// Device ID which starts from 0
 using DeviceId = int;
 
@@ -27,10 +38,104 @@ using Bandwidth = double;
 /// Latency in ns
 using Latency = double;
 
-/// Event time in ns
+/// Event time in ticks: ns, unless built with a finer time base (see common/TimeBase.h)
 using EventTime = uint64_t;
 
 /// Basic multi-dimensional topology building blocks
-enum class TopologyBuildingBlock { Undefined, Ring, FullyConnected, Switch, Mesh2D, SparseMesh2D };
+enum class TopologyBuildingBlock {
+    Undefined,
+    Ring,
+    FullyConnected,
+    Switch,
+    Mesh2D,
+    SparseMesh2D,
+    Mesh3D,
+    Torus2D,
+    Torus3D,
+    FatTree,
+    Dragonfly,
+    MultiRail,
+    Custom
+};
+
+/// Scheduler implementations backing the EventQueue
+enum class EventQueueType { List, Heap, TimingWheel };
+
+/// Transmission models of congestion-aware links
+///   - Event: a link-free event drains the pending chunks
+///   - VirtualTime: a chunk's start time is computed at enqueue from the link's busy-until time
+///   - Calendar: a chunk books the earliest gap of the link's reservation calendar that fits it at enqueue,
+///     backfilling the gaps left ahead of the slots reserved in advance
+enum class LinkModel : uint8_t { Event, VirtualTime, Calendar };
+
+/// Switching modes of congestion-aware links
+///   - StoreAndForward: a chunk (or packet) is forwarded once fully received
+///   - CutThrough: a chunk's head is forwarded after the link latency, its tail following
+enum class SwitchingMode : uint8_t { StoreAndForward, CutThrough };
+
+/// Service order of the pending chunks of congestion-aware links
+///   - FIFO: chunks are served in arrival order, regardless of their traffic class
+///   - StrictPriority: the lowest non-empty traffic class is served first (class 0 is the most urgent)
+///   - WeightedRoundRobin: classes take turns, each serving up to its weight in chunks per turn
+enum class QueueingPolicy : uint8_t { FIFO, StrictPriority, WeightedRoundRobin };
+
+/// Fidelity of a dimension of a congestion-aware MultiDimTopology
+///   - CongestionAware: chunks hop through the dimension's links, queueing at busy ones
+///   - ClosedForm: chunks cross the dimension in one contention-free hop,
+///     delayed by the congestion_unaware closed form (hops * latency + size / bandwidth)
+enum class DimFidelity : uint8_t { CongestionAware, ClosedForm };
+
+/// Use of the parallel channels (lanes) of a congestion-aware link
+///   - Striped: every chunk is split across all channels, as if the link had their combined bandwidth
+///   - PerChunk: each chunk takes a single free channel, so up to channels-count chunks are served at once
+enum class ChannelMode : uint8_t { Striped, PerChunk };
+
+/// Routing policies of Mesh2D
+///   - XY: dimension-order routing, X first
+///   - O1Turn: each chunk takes either the XY or the YX route, picked by hashing its id
+///   - WestFirst: minimal adaptive routing by the west-first turn model, chosen hop by hop from link occupancy
+enum class MeshRouting { XY, O1Turn, WestFirst };
+
+/// Routing policies of Dragonfly
+///   - Minimal: at most one global hop, to the dest group
+///   - Valiant: chunks between groups go through an intermediate group, picked by hashing their id
+enum class DragonflyRouting { Minimal, Valiant };
+
+/// Routing policies of FullyConnected
+///   - Direct: every chunk takes the direct link
+///   - Valiant: every chunk goes through an intermediate NPU, picked by hashing its id
+///   - Adaptive: a chunk goes through the intermediate NPU only if its direct link is congested (UGAL-style)
+enum class FullyConnectedRouting { Direct, Valiant, Adaptive };
+
+/// Rail selection policies of MultiRail
+///   - Hashed: the chunks of an NPU pair share a rail, picked by hashing the pair
+///   - Sprayed: consecutive chunks take the rails in turn (by chunk id), spreading a pair over every rail
+enum class RailRouting { Hashed, Sprayed };
+
+/// NPU placements of SparseMesh2D, numbering the valid cells in order along a path over the grid
+///   - RowMajor: row by row, each from left to right (the default numbering)
+///   - Snake: row by row, alternating direction, so consecutive NPUs are adjacent
+///   - Hilbert: along a Hilbert curve, so consecutive NPUs stay close in both dimensions
+///   - RingOrder: along a path searched to minimize the ring dilation around the excluded cells,
+///     so NPU i and NPU (i + 1) % N (last to first included) are as few hops apart as possible
+///   - Explicit: (x, y, npu_id) entries (cells left out are numbered in row-major order)
+enum class PlacementPattern { RowMajor, Snake, Hilbert, RingOrder, Explicit };
+
+/// Collective communication patterns
+enum class CollectiveType { AllGather, ReduceScatter, AllReduce, AllToAll };
+
+/// Execution trace node types (as in Chakra execution traces)
+enum class ExecutionTraceNodeType { Compute, Send, Recv, Collective };
+
+/// Algorithms a collective is decomposed into point-to-point steps with
+enum class CollectiveAlgorithm { Ring, Direct, HalvingDoubling, Hierarchical };
+
+/// Compression of streamed output files (traces and logs, see CompressedOutput)
+///   - None: bytes are written as is
+///   - Gzip: a gzip (deflate) stream, readable by zcat (available if zlib was found at build time)
+enum class Compression : uint8_t { None, Gzip };
+
+/// Verbosity of diagnostic logs, from least to most verbose
+enum class LogLevel { Off = 0, Error = 1, Warning = 2, Info = 3, Debug = 4, Trace = 5 };
 
 }  // namespace NetworkAnalytical
@@ -0,0 +1,95 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace NetworkAnalytical {
+
+/**
+ * WorkStealingExecutor runs a batch of independent tasks on a set of worker threads.
+ *
+ * Tasks are dealt round-robin to per-worker queues.
+ * Each worker drains its own queue from the front,
+ * and once empty, steals from the back of the other workers' queues,
+ * so no core stays idle while slow tasks are still pending elsewhere.
+ */
+class WorkStealingExecutor {
+  public:
+    /// task to run, identified by its index in the batch
+    using Task = std::function<void(int task_id)>;
+
+    /**
+     * Constructor.
+     *
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     */
+    explicit WorkStealingExecutor(int threads_count = 0) noexcept;
+
+    /**
+     * Run tasks [0, tasks_count) and return once all of them finished.
+     *
+     * @param tasks_count number of tasks
+     * @param task task to run for each task id
+     */
+    void run(int tasks_count, const Task& task) noexcept;
+
+    /**
+     * Set whether each worker is pinned to a core while running tasks (Linux only, ignored elsewhere).
+     * Workers are dealt round-robin over the NUMA nodes (worker 0 to the first core of node 0, worker 1 to the
+     * first core of node 1, ...), so they spread over the sockets and never migrate:
+     * the memory a task allocates is then first touched, hence placed, on the node of its worker,
+     * and the malloc arena of each worker thread stays node-local.
+     * The calling thread gets its former affinity back once run returns.
+     *
+     * @param enabled true to pin the workers, false otherwise (default)
+     */
+    void set_thread_pinning(bool enabled) noexcept;
+
+    /**
+     * Get the cores workers are pinned to, in worker order: the cores the process may run on,
+     * dealt round-robin over the NUMA nodes (a single node if the NUMA layout is unknown).
+     *
+     * @return core ids (empty if pinning isn't supported)
+     */
+    [[nodiscard]] static std::vector<int> get_pinned_cores() noexcept;
+
+    /**
+     * Get the number of worker threads.
+     *
+     * @return number of worker threads
+     */
+    [[nodiscard]] int get_threads_count() const noexcept;
+
+  private:
+    /// task ids waiting in one worker's queue
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<int> task_ids;
+    };
+
+    /// number of worker threads
+    int threads_count;
+
+    /// true if workers are pinned to cores
+    bool thread_pinning;
+
+    /**
+     * Take the next task for the given worker:
+     * from the front of its own queue, otherwise stolen from the back of another queue.
+     *
+     * @param worker_queues queues of all workers
+     * @param worker_id id of the worker taking a task
+     * @param task_id taken task id
+     * @return true if a task was taken, false if every queue is empty
+     */
+    [[nodiscard]] static bool take_task(std::vector<WorkerQueue>& worker_queues, int worker_id, int& task_id) noexcept;
+};
+
+}  // namespace NetworkAnalytical
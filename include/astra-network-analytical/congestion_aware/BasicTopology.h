@@ -42,6 +42,15 @@ class BasicTopology : public Topology {
      */
     [[nodiscard]] TopologyBuildingBlock get_basic_topology_type() const noexcept;
 
+    /**
+     * Implementation of get_zero_load_latency function in Topology:
+     * the hops count times the delay of a link, for single-dimension building blocks (whose links all share their
+     * parameters), the default otherwise.
+     */
+    [[nodiscard]] EventTime get_zero_load_latency(DeviceId src,
+                                                  DeviceId dest,
+                                                  ChunkSize chunk_size) const noexcept override;
+
   protected:
     /// bandwidth of each link
     Bandwidth bandwidth;
@@ -51,6 +60,17 @@ class BasicTopology : public Topology {
 
     /// basic topology type
     TopologyBuildingBlock basic_topology_type;
+
+    /**
+     * Get the communication delay of a chunk over a link of a dimension,
+     * as every link of a dimension shares its parameters (see Topology::set_dim_parameters).
+     * The first link of the dimension is read, so a dimension should have links.
+     *
+     * @param dim dimension
+     * @param chunk_size size of the chunk
+     * @return communication delay of the chunk over a link of the dimension
+     */
+    [[nodiscard]] EventTime dim_link_delay(int dim, ChunkSize chunk_size) const noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,155 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+/*
+ * C API of the congestion-aware backend, for host simulators embedding it from other languages.
+ * A simulation is an opaque handle owning a topology and the event queue driving it.
+ * The host steps the event queue, and polls the chunks delivered meanwhile into caller-owned buffers
+ * instead of receiving callbacks, so neither C++ types nor calls back into the host cross the API.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// version of the C API; functions are only ever added, and their signatures never change
+#define ANALYTICAL_AWARE_API_VERSION 1
+
+/// opaque handle of a congestion-aware simulation
+typedef struct AnalyticalAwareSimulation AnalyticalAwareSimulation;
+
+/**
+ * Get the version of the C API the library implements.
+ *
+ * @return ANALYTICAL_AWARE_API_VERSION of the library
+ */
+int analytical_aware_api_version(void);
+
+/**
+ * Construct a simulation of the topology of a network config, at time 0.
+ *
+ * @param config_path path of the network config (yml)
+ * @return handle of the simulation, NULL if the network config can't be read
+ */
+AnalyticalAwareSimulation* analytical_aware_create(const char* config_path);
+
+/**
+ * Destroy a simulation. Chunks in flight are dropped.
+ *
+ * @param simulation handle of the simulation (NULL is ignored)
+ */
+void analytical_aware_destroy(AnalyticalAwareSimulation* simulation);
+
+/**
+ * Get the number of NPUs of a simulation's topology.
+ *
+ * @param simulation handle of the simulation
+ * @return number of NPUs
+ */
+int32_t analytical_aware_npus_count(const AnalyticalAwareSimulation* simulation);
+
+/**
+ * Send a chunk at the current time. Once delivered, it's reported by analytical_aware_poll with its tag.
+ *
+ * @param simulation handle of the simulation
+ * @param src src NPU ID
+ * @param dest dest NPU ID
+ * @param chunk_size size of the chunk
+ * @param tag tag reported when the chunk is delivered, chosen by the host
+ * @return 0 on success, -1 if an NPU ID is invalid
+ */
+int analytical_aware_send(AnalyticalAwareSimulation* simulation,
+                          int32_t src,
+                          int32_t dest,
+                          uint64_t chunk_size,
+                          uint64_t tag);
+
+/**
+ * Send a batch of chunks at the current time (see analytical_aware_send).
+ *
+ * @param simulation handle of the simulation
+ * @param srcs src NPU ID of each chunk
+ * @param dests dest NPU ID of each chunk
+ * @param chunk_sizes size of each chunk
+ * @param tags tag of each chunk
+ * @param count number of chunks
+ * @return 0 on success, -1 if an NPU ID is invalid (no chunk is sent)
+ */
+int analytical_aware_send_batch(AnalyticalAwareSimulation* simulation,
+                                const int32_t* srcs,
+                                const int32_t* dests,
+                                const uint64_t* chunk_sizes,
+                                const uint64_t* tags,
+                                int32_t count);
+
+/**
+ * Get the current time of a simulation.
+ *
+ * @param simulation handle of the simulation
+ * @return current time
+ */
+uint64_t analytical_aware_current_time(const AnalyticalAwareSimulation* simulation);
+
+/**
+ * Get the time of the next event of a simulation, e.g., to synchronize with the host's event queue.
+ *
+ * @param simulation handle of the simulation
+ * @return next event time, UINT64_MAX if no event is left
+ */
+uint64_t analytical_aware_next_event_time(AnalyticalAwareSimulation* simulation);
+
+/**
+ * Advance a simulation to its next event time, and invoke the events there.
+ *
+ * @param simulation handle of the simulation
+ * @return 0 on success, -1 if no event is left
+ */
+int analytical_aware_step(AnalyticalAwareSimulation* simulation);
+
+/**
+ * Invoke the events of a simulation up to the given time, then advance its current time there.
+ *
+ * @param simulation handle of the simulation
+ * @param until_time time to run until, at least the current time
+ */
+void analytical_aware_run_until(AnalyticalAwareSimulation* simulation, uint64_t until_time);
+
+/**
+ * Invoke the events of a simulation until no event is left.
+ *
+ * @param simulation handle of the simulation
+ * @return current time after the last event
+ */
+uint64_t analytical_aware_run_to_completion(AnalyticalAwareSimulation* simulation);
+
+/**
+ * Take the chunks delivered since the last poll, in delivery order, into caller-owned buffers.
+ * Chunks beyond the buffers' capacity are kept for the next poll.
+ *
+ * @param simulation handle of the simulation
+ * @param tags output: tag of each delivered chunk
+ * @param delivery_times output: delivery time of each delivered chunk
+ * @param capacity number of entries of the buffers
+ * @return number of delivered chunks written
+ */
+int32_t analytical_aware_poll(AnalyticalAwareSimulation* simulation,
+                              uint64_t* tags,
+                              uint64_t* delivery_times,
+                              int32_t capacity);
+
+/**
+ * Rewind a simulation to time 0 with idle links, dropping chunks in flight and unpolled deliveries.
+ *
+ * @param simulation handle of the simulation
+ */
+void analytical_aware_reset(AnalyticalAwareSimulation* simulation);
+
+#ifdef __cplusplus
+}
+#endif
@@ -7,7 +7,11 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <type_traits>
 
 using namespace NetworkAnalytical;
 
@@ -19,6 +23,12 @@ namespace NetworkAnalyticalCongestionAware {
  */
 class Chunk {
   public:
+    /// largest user payload held inline by a chunk, in bytes (see set_payload)
+    static constexpr size_t payload_capacity = 32;
+
+    /// number of distinct job ids a chunk can be tagged with (see set_job_id)
+    static constexpr int max_jobs_count = 1 << 16;
+
     /**
      * Callback to be invoked when a chunk arrives at the next device.
      *   - if the chunk arrived at its destination, the final callback is invoked
@@ -30,6 +40,7 @@ class Chunk {
 
     /**
      * Constructor.
+     * The chunk keeps its own copy of the route.
      *
      * @param chunk_size: size of the chunk
      * @param route: route of the chunk from its source to destination
@@ -38,29 +49,96 @@ class Chunk {
      */
     Chunk(ChunkSize chunk_size, Route route, Callback callback, CallbackArg callback_arg) noexcept;
 
+    /**
+     * Constructor.
+     * The chunk refers to a shared route (see Topology::shared_route), which should outlive it.
+     *
+     * @param chunk_size: size of the chunk
+     * @param shared_route: route of the chunk from its source to destination
+     * @param callback: callback to be invoked when the chunk arrives destination
+     * @param callback_arg: argument of the callback
+     */
+    Chunk(ChunkSize chunk_size, const Route* shared_route, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Constructor of a source-routed chunk, e.g., along the ring direction or rail a collective library picked.
+     * The route is built in place from the given device ids, without routing through the topology.
+     * Its links are resolved once the chunk is sent, and checked to exist in debug builds only.
+     *
+     * @param chunk_size: size of the chunk
+     * @param device_ids: device ids of the route, from the source to the destination (at least 2)
+     * @param devices_count: number of device ids
+     * @param callback: callback to be invoked when the chunk arrives destination
+     * @param callback_arg: argument of the callback
+     */
+    Chunk(ChunkSize chunk_size,
+          const DeviceId* device_ids,
+          int devices_count,
+          Callback callback,
+          CallbackArg callback_arg) noexcept;
+
+    /**
+     * Copy a small user payload (e.g., message ids and tags) into the chunk itself.
+     * The callback is then invoked with a pointer to the payload instead of callback_arg,
+     * so no context has to be allocated per chunk.
+     * The pointer is only valid during the callback (the chunk is released right after).
+     *
+     * @tparam Payload trivially copyable type of at most payload_capacity bytes
+     * @param payload payload to be returned to the callback
+     */
+    template <typename Payload> void set_payload(const Payload& payload) noexcept {
+        static_assert(std::is_trivially_copyable_v<Payload>, "payload should be trivially copyable");
+        static_assert(sizeof(Payload) <= payload_capacity, "payload exceeds payload_capacity");
+        static_assert(alignof(Payload) <= alignof(std::max_align_t), "payload is overaligned");
+
+        std::memcpy(payload_bytes, &payload, sizeof(Payload));
+        has_payload = true;
+    }
+
     /**
      * Get the current sitting device of the chunk
      *
-     * @return current device of the chunk
+     * @return id of the current device of the chunk
      */
-    [[nodiscard]] std::shared_ptr<Device> current_device() const noexcept;
+    [[nodiscard]] DeviceId current_device() const noexcept;
 
     /**
      * Get the next destined device of the chunk
      *
-     * @return next device of the chunk
+     * @return id of the next device of the chunk
      */
-    [[nodiscard]] std::shared_ptr<Device> next_device() const noexcept;
+    [[nodiscard]] DeviceId next_device() const noexcept;
+
+    /**
+     * Get the source device of the chunk
+     *
+     * @return id of the source device
+     */
+    [[nodiscard]] DeviceId get_src() const noexcept;
+
+    /**
+     * Get the destination device of the chunk
+     *
+     * @return id of the destination device
+     */
+    [[nodiscard]] DeviceId get_dest() const noexcept;
+
+    /**
+     * Get the number of hops the chunk traversed so far
+     *
+     * @return number of traversed hops
+     */
+    [[nodiscard]] int get_hops_count() const noexcept;
 
     /**
      * Mark the chunk arrived at its next device
-     * i.e., drop the current device from the route
+     * i.e., advance the route cursor to the next device
      */
     void mark_arrived_next_device() noexcept;
 
     /**
      * Check if the chunk arrived at its destination
-     * i.e., if the route length is 1 (only destination device left)
+     * i.e., if the route cursor points to the destination device
      *
      * @return true if the chunk arrived at its destination, false otherwise
      */
@@ -79,21 +157,197 @@ class Chunk {
      */
     void invoke_callback() noexcept;
 
+    /**
+     * Set the traffic class of the chunk, which decides its service order at links
+     * whose queueing policy isn't FIFO (see Topology::set_queueing_policy).
+     *
+     * @param new_traffic_class traffic class, in [0, Link::max_traffic_classes)
+     */
+    void set_traffic_class(int new_traffic_class) noexcept;
+
+    /**
+     * Get the traffic class of the chunk.
+     *
+     * @return traffic class
+     */
+    [[nodiscard]] int get_traffic_class() const noexcept;
+
+    /**
+     * Set the job the chunk belongs to, e.g., one of several workloads sharing the topology.
+     * The topology accounts the delivered chunks per job (see Topology::set_job_accounting).
+     *
+     * @param new_job_id job id, in [0, max_jobs_count)
+     */
+    void set_job_id(int new_job_id) noexcept;
+
+    /**
+     * Get the job the chunk belongs to.
+     *
+     * @return job id
+     */
+    [[nodiscard]] int get_job_id() const noexcept;
+
+    /**
+     * Get the total time the chunk waited for busy links so far.
+     * Only tracked if NETWORK_ANALYTICAL_ENABLE_STATS is set.
+     *
+     * @return accumulated queueing delay of the chunk
+     */
+    [[nodiscard]] EventTime get_queueing_delay() const noexcept;
+
   private:
+    /**
+     * Constructor, referring to the owned route if given, otherwise to the shared route.
+     */
+    Chunk(ChunkSize chunk_size,
+          const Route* shared_route,
+          std::unique_ptr<Route> own_route,
+          Callback callback,
+          CallbackArg callback_arg) noexcept;
+
+    /// ChunkPool manages the chunk_pool field
+    friend class ChunkPool;
+
+    /// Topology manages the topology field
+    friend class Topology;
+
+    /// Link accounts the queueing delay and packet train fields
+    friend class Link;
+
+    /// ChunkQueue links queued chunks
+    friend class ChunkQueue;
+
+    /// CompletionLog records delivered chunks
+    friend class CompletionLog;
+
+    /// CriticalPath chains the transmissions of the chunk
+    friend class CriticalPath;
+
+    /// LatencyHistograms records delivered chunks
+    friend class LatencyHistograms;
+
+    /// ParallelSimulation assigns the chunk id
+    friend class ParallelSimulation;
+
+    /// DistributedSimulation migrates the chunk across ranks
+    friend class DistributedSimulation;
+
+    /// NicModel queues chunks waiting to be injected
+    friend class NicModel;
+
+    /// SwitchModel moves chunks across switches
+    friend class SwitchModel;
+
     /// size of the chunk
     ChunkSize chunk_size;
 
     /// route of the chunk to its destination.
-    /// Route has the structure of [current device, next device, ..., dest device]
+    /// Route has the structure of [src device, ..., dest device]
     /// e.g., if a chunk starts from device 5, then reaches destination 3,
     /// the route would be e.g., [5, 1, 6, 2, 3]
-    Route route;
+    /// (hop-by-hop chunks only hold their current hop: [current device, next device])
+    /// Points to a route shared through the topology, or to owned_route.
+    const Route* route;
+
+    /// route owned by the chunk itself (nullptr if the route is shared)
+    std::unique_ptr<Route> owned_route;
+
+    /// index of the current device in the route
+    int route_index;
+
+    /// source device of the chunk
+    DeviceId src;
+
+    /// destination device of the chunk
+    DeviceId dest;
+
+    /// number of hops traversed so far
+    int hops_count;
+
+    /// true if the topology routes the chunk one hop at a time (see Topology::set_hop_by_hop_routing)
+    bool hop_by_hop;
+
+    /// topology the chunk is being transmitted through
+    Topology* topology;
 
     /// callback to be invoked when the chunk arrives at its destination
     Callback callback;
 
     /// argument of the callback
     CallbackArg callback_arg;
+
+    /// pool to return this chunk to after arrival (nullptr if not pooled)
+    ChunkPool* chunk_pool;
+
+    /// time the chunk got enqueued to its current link
+    EventTime enqueued_time;
+
+    /// accumulated time the chunk waited for busy links
+    EventTime queueing_delay;
+
+    /// id of the chunk, in the order chunks are sent
+    uint64_t chunk_id;
+
+    /// time the chunk was injected at its source (only stamped if the topology logs completions)
+    EventTime inject_time;
+
+    /// time the last packet of the chunk arrives at its current device
+    /// (packetized links forward the chunk as soon as its head packet arrives)
+    EventTime tail_arrival_time;
+
+    /// next chunk of the ChunkQueue this chunk is waiting in (nullptr if last or not queued)
+    /// (with source arbitration: next chunk of the same source)
+    Chunk* next_queued_chunk;
+
+    /// head chunk of the next source's sub-queue, if this chunk heads one (ChunkQueue source arbitration)
+    Chunk* next_source_chunk;
+
+    /// last chunk of this chunk's source sub-queue, if this chunk heads one (ChunkQueue source arbitration)
+    Chunk* source_tail_chunk;
+
+    /// source the chunk is queued under (ChunkQueue source arbitration): the device it came from
+    DeviceId queue_source;
+
+    /// chunks coalesced behind this one, each holding the next (see Topology::set_chunk_coalescing)
+    std::unique_ptr<Chunk> coalesced_chunks;
+
+    /// bytes transmitted along with this chunk: its size plus the sizes of the coalesced chunks
+    ChunkSize transmission_size;
+
+    /// chunks of chunk_size bytes the chunk stands for, not delivered yet (see Topology::send_message)
+    /// (1: a single chunk)
+    uint32_t message_chunks_count;
+
+    /// time the first of these chunks fully arrived at the current device, the last one at tail_arrival_time
+    /// (only if message_chunks_count > 1)
+    EventTime message_head_arrival_time;
+
+    /// bytes the chunk reserved in the buffer of the link it's heading to (see Topology::set_link_buffer_capacity)
+    ChunkSize buffer_credit;
+
+    /// last transmission of the chunk recorded by the topology's CriticalPath (-1 if none)
+    int64_t critical_path_step;
+
+    /// multicast tree the chunk follows (nullptr if unicast)
+    const MulticastTree* multicast_tree;
+
+    /// node of the multicast tree the chunk is heading to
+    int multicast_node;
+
+    /// true if the callback is invoked with the inline payload instead of callback_arg
+    bool has_payload;
+
+    /// traffic class of the chunk (0: most urgent)
+    uint8_t traffic_class;
+
+    /// job the chunk belongs to
+    uint16_t job_id;
+
+    /// true if the chunk went through the NIC of its src NPU, holding one of its outstanding slots
+    bool nic_metered;
+
+    /// inline user payload (see set_payload)
+    alignas(std::max_align_t) unsigned char payload_bytes[payload_capacity];
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,78 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Type.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ChunkPool hands out and recycles Chunk objects.
+ *
+ * A Chunk acquired from a pool remembers the pool,
+ * and returns itself to the pool once it arrives at its destination
+ * (right after its callback is invoked),
+ * so steady-state injection performs no Chunk allocation.
+ */
+class ChunkPool {
+  public:
+    /**
+     * Constructor.
+     */
+    ChunkPool() noexcept;
+
+    /**
+     * Get a chunk from the pool.
+     * A recycled chunk is used if available, otherwise a new one is allocated.
+     *
+     * @param chunk_size size of the chunk
+     * @param shared_route route of the chunk from its source to destination (see Topology::shared_route)
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param callback_arg argument of the callback
+     * @return chunk handle, to be passed to Topology::send
+     */
+    [[nodiscard]] std::unique_ptr<Chunk> acquire(ChunkSize chunk_size,
+                                                 const Route* shared_route,
+                                                 Callback callback,
+                                                 CallbackArg callback_arg) noexcept;
+
+    /**
+     * Return an arrived chunk to the pool.
+     *
+     * @param chunk chunk to recycle
+     */
+    void release(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Get the number of chunks ready to be reused.
+     *
+     * @return number of free chunks in the pool
+     */
+    [[nodiscard]] int get_free_chunks_count() const noexcept;
+
+    /**
+     * Get the number of chunks the pool ever allocated,
+     * i.e., the most chunks acquired from the pool at once.
+     *
+     * @return number of allocated chunks
+     */
+    [[nodiscard]] int get_allocated_chunks_count() const noexcept;
+
+  private:
+    /// chunks ready to be reused
+    std::vector<std::unique_ptr<Chunk>> free_chunks;
+
+    /// number of chunks allocated by the pool (acquired or free)
+    int allocated_chunks_count;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,125 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Type.h"
+#include <memory>
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ChunkQueue is an intrusive FIFO of chunks.
+ *
+ * Queued chunks are linked through their own next pointer,
+ * so enqueueing and dequeueing never allocate.
+ * The queue owns its chunks until they are dequeued.
+ *
+ * With source arbitration, the queue keeps a FIFO sub-queue per source (Chunk::queue_source, e.g., input port)
+ * and serves the sources round robin: a source that was just served moves behind the other waiting sources,
+ * and a newly waiting source joins at the back.
+ * Sub-queues are linked through their head chunks too, so arbitration doesn't allocate either;
+ * enqueueing looks its source up among the waiting sources.
+ */
+class ChunkQueue {
+  public:
+    /**
+     * Constructor.
+     */
+    ChunkQueue() noexcept;
+
+    /**
+     * Destructor, destroying the chunks still queued.
+     */
+    ~ChunkQueue() noexcept;
+
+    /**
+     * Move constructor.
+     *
+     * @param other queue to take the chunks from
+     */
+    ChunkQueue(ChunkQueue&& other) noexcept;
+
+    /**
+     * Move assignment.
+     *
+     * @param other queue to take the chunks from
+     * @return this queue
+     */
+    ChunkQueue& operator=(ChunkQueue&& other) noexcept;
+
+    ChunkQueue(const ChunkQueue&) = delete;
+    ChunkQueue& operator=(const ChunkQueue&) = delete;
+
+    /**
+     * Set whether the chunks are served round robin across their sources, instead of in arrival order.
+     * The queue should be empty.
+     *
+     * @param new_source_arbitration true to arbitrate across sources, false for FIFO (default)
+     */
+    void set_source_arbitration(bool new_source_arbitration) noexcept;
+
+    /**
+     * Enqueue a chunk at the back (of its source's sub-queue, with source arbitration).
+     *
+     * @param chunk chunk to enqueue
+     */
+    void push_back(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Dequeue the chunk at the front (of the source whose turn it is, with source arbitration).
+     * The queue shouldn't be empty.
+     *
+     * @return dequeued chunk
+     */
+    [[nodiscard]] std::unique_ptr<Chunk> pop_front() noexcept;
+
+    /**
+     * Peek the chunk at the front.
+     * The queue shouldn't be empty.
+     *
+     * @return chunk at the front
+     */
+    [[nodiscard]] const Chunk& front() const noexcept;
+
+    /**
+     * Check if the queue is empty.
+     *
+     * @return true if no chunk is queued, false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+    /**
+     * Get the number of queued chunks.
+     *
+     * @return number of queued chunks
+     */
+    [[nodiscard]] int size() const noexcept;
+
+  private:
+    /// first queued chunk (nullptr if empty)
+    /// (with source arbitration: head chunk of the first sub-queue)
+    Chunk* head;
+
+    /// last queued chunk (nullptr if empty)
+    /// (with source arbitration: head chunk of the last sub-queue)
+    Chunk* tail;
+
+    /// number of queued chunks
+    int chunks_count;
+
+    /// whether chunks are served round robin across sources
+    bool source_arbitration;
+
+    /**
+     * Append a sub-queue, given by its head chunk, behind the other sub-queues (source arbitration).
+     *
+     * @param source_head head chunk of the sub-queue
+     */
+    void append_source(Chunk* source_head) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
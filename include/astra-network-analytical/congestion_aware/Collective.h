@@ -0,0 +1,340 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Route.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Collective simulates a collective communication among all NPUs of a topology.
+ *
+ * The collective is decomposed into steps of point-to-point messages by the chosen algorithm:
+ *   - Ring: N-1 steps (2(N-1) for AllReduce) to the next NPU of the ring embedded in the topology
+ *       (see Topology::get_ring_order, e.g., a Hamiltonian cycle of a Mesh2D), or to both neighbors,
+ *       half of the data each way, if bidirectional (see set_bidirectional);
+ *       AllToAll uses pairwise exchange, sending to the NPU step + 1 ahead in the ring at each step
+ *   - Direct: every NPU sends to every other NPU at once (twice for AllReduce)
+ *   - HalvingDoubling: log2(N) steps of recursive halving (ReduceScatter)
+ *       and/or recursive doubling (AllGather), N must be a power of 2 (not for AllToAll)
+ *   - Hierarchical: ring Reduce-Scatter dimension by dimension, from the lowest to the highest,
+ *       each on the shard left by the lower ones, and/or ring All-Gather from the highest back to the lowest:
+ *       (n_d - 1) steps per dimension d to the next NPU along d
+ *       (on Mesh2D, whose dimensions are lines, along a ring folded over the line: every step is 2 hops at most);
+ *       AllToAll transposes one dimension at a time instead (a single one on Ring and Switch topologies):
+ *       floor(n_d / 2) steps per dimension d, step k sending to the NPUs k apart along d both ways,
+ *       each message forwarding the 1/n_d of the buffer bound to the peer's coordinate,
+ *       so both directions of a ring are busy and only one dimension is loaded at a time
+ *
+ * Steps are issued lazily: an NPU sends its next step only once all messages of its previous step arrived,
+ * so only the chunks in flight are alive at any time.
+ * Messages can be further split into chunks_count chunks, which are pipelined independently:
+ * with Hierarchical, a chunk moves on to the next dimension while the later ones are still in the current one.
+ *
+ * On Ring, FullyConnected, and Switch topologies, the Ring and Direct algorithms are symmetric under rotation:
+ * rank r's traffic is rank 0's traffic shifted by r NPUs, and so are the links it crosses.
+ * In symmetric mode (see set_symmetric), only rank 0 is simulated,
+ * each of its hops queueing at the link of its rotation class that starts (or ends) at rank 0,
+ * which thereby carries the same traffic as every link of the class does in the full simulation.
+ * The finish time is the full collective's, at the cost of simulating a single NPU.
+ */
+class Collective {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to run the collective on
+     * @param collective_type collective communication pattern
+     * @param collective_algorithm algorithm to decompose the collective with
+     * @param collective_size size of the buffer each NPU holds
+     *     (i.e., the gathered output of AllGather and the input of ReduceScatter)
+     * @param chunks_count number of chunks each message is split into
+     */
+    Collective(std::shared_ptr<Topology> topology,
+               CollectiveType collective_type,
+               CollectiveAlgorithm collective_algorithm,
+               ChunkSize collective_size,
+               int chunks_count = 1) noexcept;
+
+    /**
+     * Issue the first step of the collective.
+     * The simulation is then driven by the topology's event queue.
+     *
+     * @param callback callback to be invoked when the collective finishes (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    void start(Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Set whether only rank 0 is simulated, standing for every rank by rotational symmetry.
+     * The topology should be a Ring, FullyConnected, or Switch, and the algorithm Ring or Direct.
+     * This should be set before start.
+     *
+     * @param new_symmetric true to simulate rank 0 only, false to simulate every rank (default)
+     */
+    void set_symmetric(bool new_symmetric) noexcept;
+
+    /**
+     * Check if symmetric mode applies to this collective (see set_symmetric).
+     *
+     * @return true if the topology is a Ring, FullyConnected, or Switch and the algorithm Ring or Direct
+     */
+    [[nodiscard]] bool supports_symmetric() const noexcept;
+
+    /**
+     * Set whether the Ring algorithm sends half of each message each way around the ring,
+     * so both directions of the links between ring neighbors are busy (e.g., every port of a Mesh2D NPU).
+     * The algorithm should be Ring, and the collective not AllToAll.
+     * This should be set before start.
+     *
+     * @param new_bidirectional true to send both ways, false to send to the next NPU only (default)
+     */
+    void set_bidirectional(bool new_bidirectional) noexcept;
+
+    /**
+     * Set the traffic class of every chunk of the collective (see Topology::set_queueing_policy),
+     * e.g., to prioritize a tensor-parallel collective over a concurrent data-parallel one.
+     * This should be set before start.
+     *
+     * @param new_traffic_class traffic class
+     */
+    void set_traffic_class(int new_traffic_class) noexcept;
+
+    /**
+     * Set the job every chunk of the collective belongs to (see Topology::set_job_accounting),
+     * e.g., to tell apart the collectives of jobs sharing the topology.
+     * This should be set before start.
+     *
+     * @param new_job_id job id
+     */
+    void set_job_id(int new_job_id) noexcept;
+
+    /**
+     * Cross-check symmetric mode: simulate every rank of the same collective on a reference topology
+     * (identical to this one, but fresh), and compare its finish time with this (finished) collective's.
+     * The reference runs on an event queue of its own.
+     *
+     * @param reference_topology fresh topology identical to this collective's
+     * @return true if both finish at the same time, false otherwise
+     */
+    [[nodiscard]] bool cross_check(std::shared_ptr<Topology> reference_topology) const noexcept;
+
+    /**
+     * Check if every NPU finished the collective.
+     *
+     * @return true if the collective finished, false otherwise
+     */
+    [[nodiscard]] bool finished() const noexcept;
+
+    /**
+     * Get the time the collective finished.
+     *
+     * @return finish time of the collective
+     */
+    [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+    /**
+     * Get the number of steps each NPU goes through.
+     *
+     * @return number of steps
+     */
+    [[nodiscard]] int get_steps_count() const noexcept;
+
+    /**
+     * Get the number of messages each NPU sends (and receives) at a step.
+     *
+     * @param step step
+     * @return number of messages per NPU
+     */
+    [[nodiscard]] int get_fanout(int step) const noexcept;
+
+    /**
+     * Get the destination of a message of a step.
+     *
+     * @param rank NPU sending the message
+     * @param step step
+     * @param message_id index of the message in the step, in [0, get_fanout(step))
+     * @return NPU receiving the message
+     */
+    [[nodiscard]] DeviceId get_peer(DeviceId rank, int step, int message_id) const noexcept;
+
+    /**
+     * Get the size of each message of a step, before splitting into chunks.
+     *
+     * @param step step
+     * @return message size
+     */
+    [[nodiscard]] ChunkSize get_message_size(int step) const noexcept;
+
+    /**
+     * Get the maximum number of messages that were in flight at the same time.
+     *
+     * @return peak number of in-flight messages
+     */
+    [[nodiscard]] int get_peak_in_flight_messages_count() const noexcept;
+
+    /**
+     * Get the number of messages the collective sends, extrapolated from rank 0 in symmetric mode.
+     *
+     * @return number of messages of every rank
+     */
+    [[nodiscard]] uint64_t get_messages_count() const noexcept;
+
+  private:
+    /// an in-flight message, passed as the callback argument of its chunk
+    struct Message {
+        /// collective the message belongs to
+        Collective* collective;
+
+        /// NPU receiving the message
+        DeviceId rank;
+
+        /// chunk of the message
+        int chunk_id;
+
+        /// step of the message
+        int step;
+    };
+
+    /// topology to run the collective on
+    std::shared_ptr<Topology> topology;
+
+    /// collective communication pattern
+    CollectiveType collective_type;
+
+    /// algorithm the collective is decomposed with
+    CollectiveAlgorithm collective_algorithm;
+
+    /// size of the buffer each NPU holds
+    ChunkSize collective_size;
+
+    /// number of chunks each message is split into
+    int chunks_count;
+
+    /// number of NPUs taking part
+    int npus_count;
+
+    /// number of ranks simulated (1 in symmetric mode)
+    int simulated_ranks_count;
+
+    /// whether only rank 0 is simulated
+    bool symmetric;
+
+    /// whether the Ring algorithm sends both ways
+    bool bidirectional;
+
+    /// traffic class of the chunks
+    int traffic_class;
+
+    /// job the chunks belong to
+    int job_id;
+
+    /// routes from rank 0 to each peer, mapped onto the rotation class links (symmetric mode, built on first use)
+    std::vector<Route> symmetric_routes;
+
+    /// number of messages sent
+    uint64_t sent_messages_count;
+
+    /// number of steps each NPU goes through
+    int steps_count;
+
+    /// NPUs in ring order, and the position of each NPU in it (Ring only)
+    std::vector<DeviceId> ring_order;
+    std::vector<int> ring_positions;
+
+    /// dimension and message size of each step (Hierarchical only)
+    std::vector<std::pair<int, ChunkSize>> hierarchical_steps;
+
+    /// distance along its dimension between an NPU and its peer, for each step (Hierarchical only)
+    std::vector<int> hierarchical_shifts;
+
+    /// number of NPUs per dimension (Hierarchical only)
+    std::vector<int> npus_count_per_dim;
+
+    /// distance between consecutive NPUs of each dimension (Hierarchical only)
+    std::vector<int> stride_per_dim;
+
+    /// coordinate following each coordinate of each dimension in the ring along it (Hierarchical only)
+    std::vector<std::vector<int>> next_coordinate_per_dim;
+
+    /// number of steps issued, per (rank, chunk)
+    std::vector<int> issued_steps;
+
+    /// number of messages received, per (rank, chunk, step)
+    std::vector<int> received_messages;
+
+    /// number of (rank, chunk) pairs that received every step
+    int finished_pairs_count;
+
+    /// time the collective finished
+    EventTime finish_time;
+
+    /// callback to be invoked when the collective finishes
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+
+    /// storage of in-flight messages (stable addresses, grows to the peak in-flight count)
+    std::deque<Message> messages;
+
+    /// messages ready to be reused
+    std::vector<Message*> free_messages;
+
+    /**
+     * Callback of every chunk of the collective.
+     *
+     * @param message_ptr pointer to the arrived message
+     */
+    static void message_arrived(void* message_ptr) noexcept;
+
+    /**
+     * Issue every step of (rank, chunk) whose dependencies are met,
+     * and check whether the pair finished.
+     *
+     * @param rank NPU id
+     * @param chunk_id chunk id
+     */
+    void advance(DeviceId rank, int chunk_id) noexcept;
+
+    /**
+     * Send the messages of a step.
+     *
+     * @param rank NPU sending the messages
+     * @param chunk_id chunk id
+     * @param step step to issue
+     */
+    void issue_step(DeviceId rank, int chunk_id, int step) noexcept;
+
+    /**
+     * Get the route from rank 0 to a peer in symmetric mode,
+     * whose every hop is mapped onto the link of its rotation class starting (or ending) at rank 0.
+     *
+     * @param peer NPU receiving the message
+     * @return route with its links mapped
+     */
+    [[nodiscard]] const Route* symmetric_route(DeviceId peer) noexcept;
+
+    /**
+     * Get the index of (rank, chunk).
+     *
+     * @param rank NPU id
+     * @param chunk_id chunk id
+     * @return index into issued_steps
+     */
+    [[nodiscard]] int pair_index(DeviceId rank, int chunk_id) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
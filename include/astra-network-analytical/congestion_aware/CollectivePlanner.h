@@ -0,0 +1,112 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/Topology.h"
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Algorithm selected by CollectivePlanner for a collective.
+ */
+struct CollectivePlan {
+    /// collective communication pattern
+    CollectiveType collective_type = CollectiveType::AllReduce;
+
+    /// size of the buffer each NPU holds
+    ChunkSize collective_size = 0;
+
+    /// selected algorithm, to construct the Collective with
+    CollectiveAlgorithm collective_algorithm = CollectiveAlgorithm::Ring;
+
+    /// estimated time of the selected algorithm
+    EventTime estimated_time = 0;
+
+    /// estimated time of every algorithm applicable to the collective
+    std::vector<std::pair<CollectiveAlgorithm, EventTime>> estimates;
+};
+
+/**
+ * CollectivePlanner selects the algorithm of a collective (see Collective) for a topology and size
+ * from an analytical cost model, without simulating it, much like NCCL picks its algorithms.
+ *
+ * Each step of an algorithm is costed from the routes of its messages on the topology:
+ * a step lasts until both its slowest message has crossed its route (latency plus serialization per hop),
+ * and its most loaded link has serialized every byte crossing it, plus the largest route latency.
+ * Steps run back to back. Contention inside a step is thereby accounted per link, and the per-hop latency
+ * per message, so the choice reflects the topology's shape (building blocks, NPUs per dimension) and the size:
+ * e.g., latency-bound small collectives favor fewer steps, bandwidth-bound large ones favor spreading the load.
+ */
+class CollectivePlanner {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology the collectives run on
+     */
+    explicit CollectivePlanner(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Check if an algorithm applies to a collective on the topology.
+     *
+     * @param collective_type collective communication pattern
+     * @param collective_algorithm algorithm
+     * @return false for HalvingDoubling on AllToAll or on a non-power-of-2 number of NPUs,
+     *     and for Hierarchical on a single dimension (but for AllToAll), true otherwise
+     */
+    [[nodiscard]] bool applicable(CollectiveType collective_type, CollectiveAlgorithm collective_algorithm) const
+        noexcept;
+
+    /**
+     * Estimate the time of a collective with an algorithm.
+     *
+     * @param collective_type collective communication pattern
+     * @param collective_algorithm algorithm, applicable to the collective
+     * @param collective_size size of the buffer each NPU holds
+     * @return estimated time
+     */
+    [[nodiscard]] EventTime estimate(CollectiveType collective_type,
+                                     CollectiveAlgorithm collective_algorithm,
+                                     ChunkSize collective_size) const noexcept;
+
+    /**
+     * Select the fastest estimated algorithm of a collective
+     * (on ties, the first of Ring, Direct, HalvingDoubling, and Hierarchical).
+     *
+     * @param collective_type collective communication pattern
+     * @param collective_size size of the buffer each NPU holds
+     * @return plan of the collective
+     */
+    [[nodiscard]] CollectivePlan plan(CollectiveType collective_type, ChunkSize collective_size) const noexcept;
+
+  private:
+    /// topology the collectives run on
+    std::shared_ptr<Topology> topology;
+
+    /// bytes crossing each link in the step being costed, indexed by LinkId
+    mutable std::vector<ChunkSize> link_loads;
+
+    /// links loaded in the step being costed
+    mutable std::vector<LinkId> loaded_links;
+
+    /**
+     * Estimate the time of a step of a collective.
+     *
+     * @param collective collective (not started), describing the messages of its steps
+     * @param step the step
+     * @return estimated time of the step
+     */
+    [[nodiscard]] EventTime estimate_step(const Collective& collective, int step) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
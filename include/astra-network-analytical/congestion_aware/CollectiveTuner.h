@@ -0,0 +1,149 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <functional>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Splitting granularity of a collective evaluated by CollectiveTuner.
+ */
+struct CollectiveTuning {
+    /// number of chunks each collective message is split into (see Collective)
+    int chunks_count = 1;
+
+    /// finish time estimated by the fast model
+    EventTime estimated_time = 0;
+
+    /// finish time of the full simulation (0 if not verified), a lower bound of it if pruned
+    EventTime verified_time = 0;
+
+    /// true if the full simulation stopped once the candidate couldn't beat the best verified one
+    bool pruned = false;
+};
+
+/**
+ * CollectiveTuner searches the number of chunks a collective's messages are split into,
+ * trading pipelining (more, smaller chunks) against per-chunk costs and simulation time.
+ *
+ * Every candidate is first estimated with a fast model of the congestion-aware backend:
+ * fast-forwarded chunks (see Topology::set_fast_forward),
+ * simulating rank 0 only where the collective is symmetric (see Collective::set_symmetric).
+ * The best estimated candidates are then verified by a full simulation, and the best verified one wins
+ * (the fewer chunks on ties, as they're cheaper to simulate).
+ * A verification stops as soon as its simulated time exceeds the best verified time so far (branch and bound),
+ * as the candidate can't win anymore.
+ * Every run has a topology and event queue of its own, and runs are spread over threads.
+ */
+class CollectiveTuner {
+  public:
+    /// applies per-run settings (e.g., a NIC model or packet size) to every topology the tuner constructs
+    using TopologySetup = std::function<void(Topology& topology)>;
+
+    /**
+     * Constructor.
+     *
+     * @param network_parser network to run the collective on
+     * @param collective_type collective communication pattern
+     * @param collective_algorithm algorithm the collective is decomposed with
+     * @param collective_size size of the buffer each NPU holds
+     */
+    CollectiveTuner(NetworkParser network_parser,
+                    CollectiveType collective_type,
+                    CollectiveAlgorithm collective_algorithm,
+                    ChunkSize collective_size) noexcept;
+
+    /**
+     * Set the candidate chunk counts.
+     * By default: the powers of 2 up to 64 (as long as chunks are at least a byte).
+     *
+     * @param new_chunks_counts candidate chunk counts, each positive
+     */
+    void set_chunks_counts(std::vector<int> new_chunks_counts) noexcept;
+
+    /**
+     * Set how many of the best estimated candidates are verified by a full simulation.
+     *
+     * @param new_verified_count number of candidates to verify (default: 3)
+     */
+    void set_verified_count(int new_verified_count) noexcept;
+
+    /**
+     * Set the per-run settings of the topologies.
+     *
+     * @param new_topology_setup invoked on every topology before its run (nullptr: none)
+     */
+    void set_topology_setup(TopologySetup new_topology_setup) noexcept;
+
+    /**
+     * Search the candidates.
+     *
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @return best verified candidate
+     */
+    [[nodiscard]] CollectiveTuning tune(int threads_count = 0) noexcept;
+
+    /**
+     * Get every candidate of the last search, ordered by estimated time (the fewer chunks on ties).
+     *
+     * @return candidates, the verified ones with their verified time
+     */
+    [[nodiscard]] const std::vector<CollectiveTuning>& get_candidates() const noexcept;
+
+    /**
+     * Simulate the collective split into a number of chunks.
+     *
+     * @param chunks_count number of chunks each message is split into
+     * @param fast true to use the fast model, false to simulate fully
+     * @return finish time of the collective
+     */
+    [[nodiscard]] EventTime simulate(int chunks_count, bool fast) const noexcept;
+
+    /**
+     * Simulate the collective split into a number of chunks, stopping once past a time bound.
+     *
+     * @param chunks_count number of chunks each message is split into
+     * @param fast true to use the fast model, false to simulate fully
+     * @param time_bound time past which the simulation stops
+     * @return whether the collective finished within the bound, with its finish time or a lower bound of it
+     */
+    [[nodiscard]] BoundedRun simulate_bounded(int chunks_count, bool fast, EventTime time_bound) const noexcept;
+
+  private:
+    /// network to run the collective on
+    NetworkParser network_parser;
+
+    /// collective communication pattern
+    CollectiveType collective_type;
+
+    /// algorithm the collective is decomposed with
+    CollectiveAlgorithm collective_algorithm;
+
+    /// size of the buffer each NPU holds
+    ChunkSize collective_size;
+
+    /// candidate chunk counts
+    std::vector<int> chunks_counts;
+
+    /// number of candidates verified by a full simulation
+    int verified_count;
+
+    /// per-run settings of the topologies (nullptr: none)
+    TopologySetup topology_setup;
+
+    /// candidates of the last search
+    std::vector<CollectiveTuning> candidates;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
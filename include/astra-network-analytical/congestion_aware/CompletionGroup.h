@@ -0,0 +1,65 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * CompletionGroup counts the arrivals of a group of chunks (e.g., every chunk of a collective),
+ * and invokes a single callback once all of them arrived.
+ *
+ * Chunks of the group are sent with CompletionGroup::chunk_arrived as their callback,
+ * and a pointer to the group (which should outlive them) as its argument,
+ * so no per-chunk callback argument is allocated.
+ */
+class CompletionGroup {
+  public:
+    /**
+     * Callback of the chunks of a group.
+     *
+     * @param group_ptr pointer to the group of the arrived chunk
+     */
+    static void chunk_arrived(void* group_ptr) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param chunks_count number of chunks of the group
+     * @param callback callback to be invoked when every chunk of the group arrived (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    CompletionGroup(int chunks_count, Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Get the number of chunks of the group yet to arrive.
+     *
+     * @return number of remaining chunks
+     */
+    [[nodiscard]] int get_remaining_chunks_count() const noexcept;
+
+    /**
+     * Check if every chunk of the group arrived.
+     *
+     * @return true if the group completed, false otherwise
+     */
+    [[nodiscard]] bool completed() const noexcept;
+
+  private:
+    /// number of chunks yet to arrive
+    int remaining_chunks_count;
+
+    /// callback to be invoked when every chunk arrived
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
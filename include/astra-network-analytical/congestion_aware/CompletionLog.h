@@ -0,0 +1,192 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/CompressedOutput.h"
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Columns of chunk completion records.
+ */
+struct CompletionColumns {
+    /// id of the chunk (in the order chunks were injected)
+    std::vector<uint64_t> chunk_ids;
+
+    /// src NPU of the chunk
+    std::vector<int32_t> srcs;
+
+    /// dest NPU of the chunk
+    std::vector<int32_t> dests;
+
+    /// size of the chunk
+    std::vector<uint64_t> sizes;
+
+    /// time the chunk was injected
+    std::vector<EventTime> inject_times;
+
+    /// time the chunk arrived at its destination
+    std::vector<EventTime> arrival_times;
+
+    /// number of hops of the chunk's route
+    std::vector<int32_t> hops;
+
+    /// total time the chunk waited for busy links (only tracked if NETWORK_ANALYTICAL_ENABLE_STATS is set)
+    std::vector<EventTime> queueing_delays;
+
+    /**
+     * Get the number of records.
+     *
+     * @return number of records
+     */
+    [[nodiscard]] size_t size() const noexcept;
+
+    /**
+     * Drop every record, keeping the allocated capacity.
+     */
+    void clear() noexcept;
+
+    /**
+     * Allocate room for the given number of records.
+     *
+     * @param capacity number of records
+     */
+    void reserve(size_t capacity) noexcept;
+};
+
+/**
+ * CompletionLog records every chunk delivered by a topology (see Topology::set_completion_log)
+ * into a binary columnar file.
+ *
+ * Records are appended to a preallocated block of columns.
+ * Once the block is full, it's swapped with a second block (double buffering),
+ * and written by a background thread while the simulation fills the other one,
+ * optionally gzip-compressed (see CompressedOutput).
+ *
+ * File layout (little endian): magic (uint64_t), then blocks of
+ * records count (uint64_t) followed by each column of the block, in CompletionColumns order.
+ */
+class CompletionLog {
+  public:
+    /// magic number identifying completion logs
+    static constexpr uint64_t log_magic = 0x31'47'4F'4C'50'4D'4F'43;  // "COMPLOG1"
+
+    /**
+     * Read every record of a completion log (compressed or not).
+     *
+     * @param log_path path of the log file
+     * @return records of the log
+     */
+    [[nodiscard]] static CompletionColumns read_log(const std::string& log_path) noexcept;
+
+    /**
+     * Constructor.
+     * Opens the log file and starts the writer thread.
+     *
+     * @param log_path path of the log file to write
+     * @param block_size number of records per block
+     * @param compression compression of the log file
+     */
+    explicit CompletionLog(const std::string& log_path,
+                           size_t block_size = 65'536,
+                           Compression compression = Compression::None) noexcept;
+
+    /**
+     * Destructor.
+     * Closes the log if it's still open.
+     */
+    ~CompletionLog() noexcept;
+
+    CompletionLog(const CompletionLog&) = delete;
+    CompletionLog& operator=(const CompletionLog&) = delete;
+
+    /**
+     * Append the record of a delivered chunk.
+     *
+     * @param chunk delivered chunk
+     * @param arrival_time time the chunk arrived at its destination
+     */
+    void record(const Chunk& chunk, EventTime arrival_time) noexcept;
+
+    /**
+     * Write the remaining records, then close the log file.
+     */
+    void close() noexcept;
+
+    /**
+     * Get the number of records appended so far.
+     *
+     * @return number of records
+     */
+    [[nodiscard]] uint64_t get_records_count() const noexcept;
+
+  private:
+    /// path of the log file
+    std::string log_path;
+
+    /// log file (written by the writer thread)
+    CompressedOutput log_file;
+
+    /// number of records per block
+    size_t block_size;
+
+    /// block the simulation appends to
+    CompletionColumns active_block;
+
+    /// block the writer thread writes
+    CompletionColumns flushing_block;
+
+    /// true while flushing_block holds records to be written
+    bool flush_pending;
+
+    /// true once the log is closed
+    bool closing;
+
+    /// number of records appended so far
+    uint64_t records_count;
+
+    /// guards active_block, as chunks may be delivered by concurrent partitions
+    std::mutex record_mutex;
+
+    /// guards flushing_block, flush_pending and closing
+    std::mutex flush_mutex;
+
+    /// signals flush requests and completions
+    std::condition_variable flush_condition;
+
+    /// background thread writing the blocks
+    std::thread writer;
+
+    /**
+     * Hand the active block to the writer thread,
+     * waiting for the previous block to be written first.
+     */
+    void swap_blocks() noexcept;
+
+    /**
+     * Body of the writer thread.
+     */
+    void write_blocks() noexcept;
+
+    /**
+     * Append a block to the log file.
+     *
+     * @param block block to write
+     */
+    void write_block(const CompletionColumns& block) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,416 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+    #error "congestion_aware/Coroutine.h needs C++20 coroutines"
+#endif
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * CoroutineFramePool recycles the frames of Task coroutines, per thread and per size class,
+ * so steady-state workloads spawning coroutines perform no frame allocation.
+ * Frames larger than the largest size class are allocated from the heap.
+ */
+class CoroutineFramePool {
+  public:
+    /**
+     * Get a frame of at least the given size.
+     *
+     * @param size frame size in bytes
+     * @return frame
+     */
+    [[nodiscard]] static void* allocate(const size_t size) noexcept {
+        const auto size_class = get_size_class(size);
+        if (size_class >= size_classes_count) {
+            return ::operator new(size);
+        }
+
+        auto& free_frames = get_free_frames()[size_class];
+        if (free_frames.empty()) {
+            return ::operator new((size_class + 1) * size_class_bytes);
+        }
+        auto* const frame = free_frames.back();
+        free_frames.pop_back();
+        return frame;
+    }
+
+    /**
+     * Return a frame to the pool of the calling thread.
+     *
+     * @param frame frame returned by allocate
+     * @param size size the frame was allocated with
+     */
+    static void deallocate(void* const frame, const size_t size) noexcept {
+        const auto size_class = get_size_class(size);
+        if (size_class >= size_classes_count) {
+            ::operator delete(frame);
+            return;
+        }
+
+        get_free_frames()[size_class].push_back(frame);
+    }
+
+  private:
+    /// granularity of the size classes in bytes
+    static constexpr size_t size_class_bytes = 64;
+
+    /// number of size classes (frames up to 1 KiB are pooled)
+    static constexpr size_t size_classes_count = 16;
+
+    /// free frames of each size class, released when the thread exits
+    struct FreeFrames : std::array<std::vector<void*>, size_classes_count> {
+        ~FreeFrames() noexcept {
+            for (auto& free_frames : *this) {
+                for (auto* const frame : free_frames) {
+                    ::operator delete(frame);
+                }
+            }
+        }
+    };
+
+    /**
+     * Get the size class of a frame size.
+     *
+     * @param size frame size in bytes
+     * @return size class (size_classes_count or more if not pooled)
+     */
+    [[nodiscard]] static size_t get_size_class(const size_t size) noexcept {
+        assert(size > 0);
+
+        return (size - 1) / size_class_bytes;
+    }
+
+    /**
+     * Get the free frames of the calling thread.
+     *
+     * @return free frames of each size class
+     */
+    [[nodiscard]] static FreeFrames& get_free_frames() noexcept {
+        thread_local auto free_frames = FreeFrames();
+        return free_frames;
+    }
+};
+
+/**
+ * Task is a workload coroutine, e.g., a multi-step collective written as straight-line code:
+ *
+ *     Task ring_step(Topology& topology, DeviceId npu, ChunkSize chunk_size) {
+ *         co_await send(topology, chunk_size, npu, next(npu));
+ *         co_await all_of(send(topology, chunk_size, npu, left(npu)), send(topology, chunk_size, npu, right(npu)));
+ *     }
+ *
+ * instead of callbacks chaining heap-allocated contexts.
+ * Frames come from the CoroutineFramePool, and a coroutine waiting for chunks
+ * is resumed directly from their arrival callbacks (its frame being the callback argument).
+ *
+ * A Task starts suspended. It is either started detached (start()),
+ * its frame then freeing itself once done, or co_awaited by another Task,
+ * which resumes once the awaited one returns.
+ */
+class Task {
+  public:
+    /// promise of Task coroutines
+    struct promise_type {
+        /// coroutine to resume once done (co_awaited Tasks only)
+        std::coroutine_handle<> continuation;
+
+        /// true if started detached, its frame then freeing itself once done
+        bool detached = false;
+
+        /// resumes the continuation (if any) once the coroutine is done
+        struct FinalAwaiter {
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            [[nodiscard]] std::coroutine_handle<> await_suspend(
+                const std::coroutine_handle<promise_type> handle) const noexcept {
+                auto& promise = handle.promise();
+                if (promise.detached) {
+                    handle.destroy();
+                    return std::noop_coroutine();
+                }
+                return (promise.continuation != nullptr) ? promise.continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        [[nodiscard]] static void* operator new(const size_t size) noexcept {
+            return CoroutineFramePool::allocate(size);
+        }
+
+        static void operator delete(void* const frame, const size_t size) noexcept {
+            CoroutineFramePool::deallocate(frame, size);
+        }
+
+        [[nodiscard]] static Task get_return_object_on_allocation_failure() noexcept {
+            return Task(nullptr);
+        }
+
+        [[nodiscard]] Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        [[nodiscard]] std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        [[nodiscard]] FinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+
+    /// resumes the awaiting coroutine once the awaited Task is done
+    struct Awaiter {
+        /// awaited coroutine
+        std::coroutine_handle<promise_type> handle;
+
+        [[nodiscard]] bool await_ready() const noexcept {
+            return handle == nullptr || handle.done();
+        }
+
+        [[nodiscard]] std::coroutine_handle<> await_suspend(const std::coroutine_handle<> awaiting) const noexcept {
+            handle.promise().continuation = awaiting;
+            return handle;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param handle coroutine owned by the Task
+     */
+    explicit Task(const std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+
+    /**
+     * Destructor. Frees the coroutine, unless started detached.
+     */
+    ~Task() noexcept {
+        if (handle != nullptr) {
+            handle.destroy();
+        }
+    }
+
+    Task(Task&& other) noexcept : handle(other.handle) {
+        other.handle = nullptr;
+    }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle != nullptr) {
+                handle.destroy();
+            }
+            handle = other.handle;
+            other.handle = nullptr;
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    /**
+     * Run the coroutine until it first waits, detached:
+     * it then goes on from the arrival callbacks, and frees itself once done.
+     */
+    void start() noexcept {
+        assert(handle != nullptr);
+
+        const auto detached_handle = handle;
+        handle = nullptr;
+        detached_handle.promise().detached = true;
+        detached_handle.resume();
+    }
+
+    /**
+     * Await the Task from another Task.
+     *
+     * @return awaiter resuming the awaiting coroutine once this one is done
+     */
+    [[nodiscard]] Awaiter operator co_await() && noexcept {
+        return {handle};
+    }
+
+  private:
+    /// coroutine owned by the Task (null once started detached)
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Awaitable sending a chunk, the awaiting coroutine resuming once the chunk arrives at dest.
+ * See send().
+ */
+class SendAwaitable {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to send the chunk through
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     */
+    SendAwaitable(Topology& topology, const ChunkSize chunk_size, const DeviceId src, const DeviceId dest) noexcept
+        : topology(&topology),
+          chunk_size(chunk_size),
+          src(src),
+          dest(dest) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(const std::coroutine_handle<> awaiting) const noexcept {
+        start(resume_coroutine, awaiting.address());
+    }
+
+    void await_resume() const noexcept {}
+
+    /**
+     * Send the chunk, invoking the given callback once it arrives.
+     *
+     * @param callback callback invoked when the chunk arrives
+     * @param callback_arg argument of the callback
+     */
+    void start(const Callback callback, const CallbackArg callback_arg) const noexcept {
+        topology->send(chunk_size, src, dest, callback, callback_arg);
+    }
+
+  private:
+    /// topology to send the chunk through
+    Topology* topology;
+
+    /// size of the chunk
+    ChunkSize chunk_size;
+
+    /// src and dest NPU ids
+    DeviceId src;
+    DeviceId dest;
+
+    /**
+     * Chunk arrival callback: resume the awaiting coroutine.
+     *
+     * @param coroutine address of the awaiting coroutine
+     */
+    static void resume_coroutine(void* const coroutine) noexcept {
+        std::coroutine_handle<>::from_address(coroutine).resume();
+    }
+};
+
+/**
+ * Awaitable sending several chunks at once, the awaiting coroutine resuming once all of them arrived.
+ * See all_of().
+ *
+ * @tparam Sends container of SendAwaitable (a std::array for a fixed number of chunks, a std::vector otherwise)
+ */
+template <typename Sends> class AllOfAwaitable {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param sends chunks to send
+     */
+    explicit AllOfAwaitable(Sends sends) noexcept : sends(std::move(sends)), remaining_sends_count(0) {}
+
+    [[nodiscard]] bool await_ready() const noexcept {
+        return sends.empty();
+    }
+
+    void await_suspend(const std::coroutine_handle<> awaiting_coroutine) noexcept {
+        // the awaitable lives in the frame of the suspended coroutine, so it is the callback argument
+        awaiting = awaiting_coroutine;
+        remaining_sends_count = static_cast<int>(sends.size());
+        for (const auto& send : sends) {
+            send.start(chunk_arrived, this);
+        }
+    }
+
+    void await_resume() const noexcept {}
+
+  private:
+    /// chunks to send
+    Sends sends;
+
+    /// number of chunks yet to arrive
+    int remaining_sends_count;
+
+    /// coroutine to resume once every chunk arrived
+    std::coroutine_handle<> awaiting;
+
+    /**
+     * Chunk arrival callback: resume the awaiting coroutine once the last chunk arrived.
+     *
+     * @param all_of pointer to the AllOfAwaitable
+     */
+    static void chunk_arrived(void* const all_of) noexcept {
+        auto* const awaitable = static_cast<AllOfAwaitable*>(all_of);
+        if (--awaitable->remaining_sends_count == 0) {
+            awaitable->awaiting.resume();
+        }
+    }
+};
+
+/**
+ * Send a chunk from a coroutine: `co_await send(topology, chunk_size, src, dest)` resumes once it arrives.
+ *
+ * @param topology topology to send the chunk through
+ * @param chunk_size size of the chunk
+ * @param src src NPU id
+ * @param dest dest NPU id
+ * @return awaitable sending the chunk
+ */
+[[nodiscard]] inline SendAwaitable send(Topology& topology,
+                                        const ChunkSize chunk_size,
+                                        const DeviceId src,
+                                        const DeviceId dest) noexcept {
+    return {topology, chunk_size, src, dest};
+}
+
+/**
+ * Send several chunks at once from a coroutine: `co_await all_of(send(...), send(...))` resumes once all arrived.
+ *
+ * @param sends chunks to send
+ * @return awaitable sending the chunks
+ */
+[[nodiscard]] inline AllOfAwaitable<std::vector<SendAwaitable>> all_of(std::vector<SendAwaitable> sends) noexcept {
+    return AllOfAwaitable<std::vector<SendAwaitable>>(std::move(sends));
+}
+
+/**
+ * Send a fixed number of chunks at once from a coroutine (see above), without allocating.
+ *
+ * @param sends chunks to send
+ * @return awaitable sending the chunks
+ */
+template <typename... Sends>
+[[nodiscard]] AllOfAwaitable<std::array<SendAwaitable, sizeof...(Sends)>> all_of(const Sends... sends) noexcept {
+    return AllOfAwaitable<std::array<SendAwaitable, sizeof...(Sends)>>({sends...});
+}
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,181 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Type.h"
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Transmission of a chunk through a link, recorded by CriticalPath.
+ */
+struct CriticalPathStep {
+    /// src device of the link
+    DeviceId link_src;
+
+    /// dest device of the link
+    DeviceId link_dest;
+
+    /// src device of the chunk
+    DeviceId chunk_src;
+
+    /// dest device of the chunk
+    DeviceId chunk_dest;
+
+    /// id of the chunk
+    uint64_t chunk_id;
+
+    /// time the chunk reached the link
+    EventTime ready_time;
+
+    /// time the transmission started
+    EventTime start_time;
+
+    /// time the link got free again
+    EventTime link_free_time;
+
+    /// time the chunk fully arrived at the next device
+    EventTime arrival_time;
+
+    /// step that determined the start of this one (-1 if none):
+    /// the previous transmission on the link if the chunk waited for it, otherwise the chunk's inbound hop
+    int64_t predecessor;
+
+    /// true if the predecessor is the transmission holding the link
+    bool waited_for_link;
+};
+
+/**
+ * First-order sensitivity of the finish time to the bandwidth of a link group, estimated by CriticalPath.
+ */
+struct BandwidthSensitivity {
+    /// link group (see Topology::get_link_group), e.g., "dim 1"
+    std::string group;
+
+    /// time the critical path spent serializing chunks on links of the group
+    EventTime serialization_time = 0;
+
+    /// d(finish time) / d(bandwidth): change of the finish time per GB/s added to every link of the group,
+    /// in time units per GB/s (negative, or 0 if the critical path doesn't cross the group)
+    double finish_time_per_GBps = 0;
+
+    /// busy time of the busiest link of the group, which the finish time can't drop below
+    /// however much the other groups are upgraded (0 if statistics aren't collected)
+    EventTime max_link_busy_time = 0;
+};
+
+/**
+ * CriticalPath records every transmission of a topology (see Topology::set_critical_path)
+ * with the transmission that determined its start,
+ * so the chain of hops and link waits leading to the last delivery can be extracted at the end of a run.
+ *
+ * A transmission that starts after its chunk reached the link waited for the previous transmission on the link;
+ * otherwise it was determined by the chunk's inbound hop (or by its injection, on the first hop).
+ * Following these predecessors back from the last delivery gives the critical path:
+ * shortening it (e.g., with more bandwidth on its links) is the only way to finish earlier.
+ */
+class CriticalPath {
+  public:
+    /**
+     * Constructor.
+     */
+    CriticalPath() noexcept;
+
+    /**
+     * Record a transmission of a chunk through a link.
+     *
+     * @param link link transmitting the chunk
+     * @param link_src src device of the link
+     * @param link_dest dest device of the link
+     * @param chunk transmitted chunk
+     * @param ready_time time the chunk reached the link
+     * @param start_time time the transmission started
+     * @param link_free_time time the link got free again
+     * @param arrival_time time the chunk fully arrived at the next device
+     */
+    void record_transmission(const Link* link,
+                             DeviceId link_src,
+                             DeviceId link_dest,
+                             Chunk& chunk,
+                             EventTime ready_time,
+                             EventTime start_time,
+                             EventTime link_free_time,
+                             EventTime arrival_time) noexcept;
+
+    /**
+     * Extract the critical path, ending at the delivery of the last chunk.
+     *
+     * @return steps of the critical path, in time order (empty if no chunk was delivered)
+     */
+    [[nodiscard]] std::vector<CriticalPathStep> extract() const noexcept;
+
+    /**
+     * Print the critical path, step by step, followed by the time spent on each of its links.
+     *
+     * @param output stream to print to
+     */
+    void dump(std::ostream& output) const noexcept;
+
+    /**
+     * Estimate how the finish time responds to the bandwidth of each link group, from this single run.
+     * Serializing a chunk takes size / bandwidth, so each step of the critical path
+     * shrinks by (serialization time / bandwidth) per GB/s added to its link;
+     * the sensitivity of a group sums this over the steps on its links
+     * (waits for a link held by another transmission follow from that transmission's step).
+     * The estimate holds as long as the critical path stays the same,
+     * i.e., for upgrades small enough not to let another chain of transmissions become critical;
+     * max_link_busy_time bounds how far that can go.
+     *
+     * @param topology topology the transmissions were recorded from
+     * @return sensitivity of every group of materialized links, the most sensitive first
+     */
+    [[nodiscard]] std::vector<BandwidthSensitivity> bandwidth_sensitivity(const Topology& topology) const noexcept;
+
+    /**
+     * Print the bandwidth sensitivity of every link group (see bandwidth_sensitivity).
+     *
+     * @param topology topology the transmissions were recorded from
+     * @param output stream to print to
+     */
+    void dump_bandwidth_sensitivity(const Topology& topology, std::ostream& output) const noexcept;
+
+    /**
+     * Forget every recorded transmission, e.g., before another run.
+     */
+    void clear() noexcept;
+
+    /**
+     * Get the number of transmissions recorded so far.
+     *
+     * @return number of transmissions
+     */
+    [[nodiscard]] uint64_t get_transmissions_count() const noexcept;
+
+  private:
+    /// every recorded transmission, in recording order
+    std::vector<CriticalPathStep> steps;
+
+    /// last transmission recorded on each link
+    std::unordered_map<const Link*, int64_t> last_step_per_link;
+
+    /// last-arriving transmission delivering a chunk to its destination (-1 if none)
+    int64_t last_delivery_step;
+
+    /// guards the records, as links of concurrent partitions may transmit at once
+    mutable std::mutex critical_path_mutex;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,145 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements an irregular topology (e.g., rail-optimized, or partially populated racks)
+ * loaded from an edge list of directed links.
+ *
+ * Devices 0 ~ npus_count-1 are NPUs, and any larger device id in the edge list is a switch.
+ * The edge list is either
+ *   - a CSV file: a link per line as "src,dest" or "src,dest,bandwidth,latency",
+ *     with blank lines and lines starting with '#' ignored,
+ *     and links without parameters taking the given bandwidth and latency; or
+ *   - a binary file written by save: flat scalars in native byte order, versioned and checked on load.
+ *
+ * Chunks follow shortest routes (in hops), breaking ties toward the lowest device id.
+ * Next-hop tables are computed upfront, one destination NPU per task, in parallel,
+ * and repaired in place as links fail or get restored (only the tables of the affected destinations).
+ */
+class CustomTopology final : public Topology {
+  public:
+    /**
+     * Write the links of a topology as a binary edge list, e.g., to edit them or to skip parsing a large CSV.
+     *
+     * @param topology topology whose links are written
+     * @param path path of the edge list file
+     * @return true if the edge list is written, false otherwise
+     */
+    static bool save(const Topology& topology, const std::string& path) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param path path of the edge list file (CSV or binary)
+     * @param npus_count number of NPUs
+     * @param bandwidth bandwidth of the links listed without parameters
+     * @param latency latency of the links listed without parameters
+     * @param threads_count number of threads computing the next-hop tables (0: number of hardware threads)
+     */
+    CustomTopology(const std::string& path,
+                   int npus_count,
+                   Bandwidth bandwidth,
+                   Latency latency,
+                   int threads_count = 0) noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+  private:
+    /// identifies binary edge list files
+    static constexpr char edge_list_magic[8] = {'A', 'N', 'A', 'N', 'E', 'T', 'E', 'L'};
+
+    /// version of the binary edge list layout, bumped whenever the layout changes
+    static constexpr uint32_t edge_list_version = 1;
+
+    /**
+     * Link listed in an edge list.
+     */
+    struct Edge {
+        /// src device id
+        DeviceId src;
+
+        /// dest device id
+        DeviceId dest;
+
+        /// bandwidth of the link
+        Bandwidth bandwidth;
+
+        /// latency of the link
+        Latency latency;
+    };
+
+    /// device each device moves to next toward each destination NPU (-1 if none),
+    /// indexed by dest * devices_count + device
+    std::vector<DeviceId> next_hops;
+
+    /**
+     * Parse the links of a CSV edge list.
+     *
+     * @param path path of the edge list file, for error messages
+     * @param contents contents of the file
+     * @param bandwidth bandwidth of the links listed without parameters
+     * @param latency latency of the links listed without parameters
+     * @return listed links
+     */
+    [[nodiscard]] static std::vector<Edge> parse_csv(const std::string& path,
+                                                     const std::string& contents,
+                                                     Bandwidth bandwidth,
+                                                     Latency latency) noexcept;
+
+    /**
+     * Parse the links of a binary edge list.
+     *
+     * @param path path of the edge list file, for error messages
+     * @param contents contents of the file
+     * @return listed links
+     */
+    [[nodiscard]] static std::vector<Edge> parse_binary(const std::string& path, const std::string& contents) noexcept;
+
+    /**
+     * Compute the next-hop table toward every NPU, by a breadth-first search from each of them
+     * over the incoming links.
+     *
+     * @param threads_count number of threads (0: number of hardware threads)
+     */
+    void compute_next_hops(int threads_count) noexcept;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
+    /**
+     * Implementation of repair_routes function in Topology:
+     * the next-hop tables of the destinations the changed links affect are recomputed over the live links.
+     */
+    void repair_routes(const std::vector<LinkId>& changed_link_ids, bool failed) noexcept override;
+
+    /**
+     * Implementation of live_next_hop function in Topology (the next-hop tables are kept repaired).
+     */
+    [[nodiscard]] DeviceId live_next_hop(DeviceId current, DeviceId dest) const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,246 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventMailbox.h"
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * DistributedSimulation runs a single topology as a conservative parallel discrete-event simulation
+ * spread over processes (ranks), possibly on different machines.
+ *
+ * Every rank constructs the same topology and owns one partition of its devices (see
+ * ParallelSimulation::partition_devices), i.e., simulates the links, chunks, and events of its devices only.
+ * A chunk crossing a link to a device of another rank migrates to that rank:
+ * it's encoded, sent over TCP, and rebuilt there.
+ * Ranks proceed in lock-step windows of `lookahead` ns, the smallest latency among the links crossing ranks;
+ * at the end of every window, rank 0 exchanges the migrated chunks and decides the next window.
+ * Migrated chunks are scheduled in a fixed order (by src rank, then in migration order),
+ * so the results are deterministic and match a ParallelSimulation with the same partitions.
+ *
+ * As callbacks can't cross processes, chunks are tagged with a u64 instead,
+ * and the delivery handler of the rank owning the destination is invoked with the tag.
+ */
+class DistributedSimulation {
+  public:
+    /// invoked by the rank owning dest when a chunk arrives there, with the tag it was sent with
+    using DeliveryHandler = std::function<void(DeviceId dest, uint64_t tag)>;
+
+    /**
+     * Constructor.
+     * Rank 0 listens for the other ranks, which connect to it right away
+     * (so rank 0 should be constructed first).
+     *
+     * @param topology topology to simulate, the same on every rank
+     * @param rank rank of this process, in [0, ranks_count)
+     * @param ranks_count number of ranks, in [1, NPUs count]
+     * @param host host of rank 0 (unused by rank 0 itself)
+     * @param port port of rank 0 (rank 0: port to listen on, 0 for any free port)
+     * @param delivery_handler invoked when a chunk arrives at a device of this rank
+     */
+    DistributedSimulation(std::shared_ptr<Topology> topology,
+                          int rank,
+                          int ranks_count,
+                          const std::string& host,
+                          uint16_t port,
+                          DeliveryHandler delivery_handler) noexcept;
+
+    /**
+     * Destructor.
+     * Disconnects the ranks, and hands the links back to the topology's own event queue.
+     */
+    ~DistributedSimulation() noexcept;
+
+    DistributedSimulation(const DistributedSimulation&) = delete;
+    DistributedSimulation& operator=(const DistributedSimulation&) = delete;
+
+    /**
+     * Send a chunk from src to dest.
+     * Called before run() (on every rank alike: chunks of other ranks' devices are dropped),
+     * or from the delivery handler with a src of this rank.
+     *
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param tag tag handed to the delivery handler of dest
+     */
+    void send(ChunkSize chunk_size, DeviceId src, DeviceId dest, uint64_t tag) noexcept;
+
+    /**
+     * Run the simulation until no event is left on any rank.
+     * Every rank should call this once.
+     *
+     * @return time the simulation finished, the latest time among the ranks
+     */
+    EventTime run() noexcept;
+
+    /**
+     * Invoke the same-time events of this rank in the deterministic order
+     * (by kind, then by link, see EventQueue::set_deterministic_order),
+     * so results are bit-identical to a sequential run with the same order, whatever the partitioning.
+     * This should be set before any chunk is sent.
+     *
+     * @param enabled true to order the events, false to invoke them in registration order (default)
+     */
+    void set_deterministic_order(bool enabled) noexcept;
+
+    /**
+     * Get the current time of this rank.
+     *
+     * @return current time
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Get the rank of this process.
+     *
+     * @return rank
+     */
+    [[nodiscard]] int get_rank() const noexcept;
+
+    /**
+     * Get the rank owning a device.
+     *
+     * @param device device id
+     * @return rank of the device
+     */
+    [[nodiscard]] int get_rank_of(DeviceId device) const noexcept;
+
+    /**
+     * Get the port rank 0 listens on.
+     *
+     * @return port (rank 0 only)
+     */
+    [[nodiscard]] uint16_t get_port() const noexcept;
+
+    /**
+     * Get the lookahead of the simulation,
+     * i.e., the smallest latency among the links crossing ranks.
+     *
+     * @return lookahead, the largest EventTime if no link crosses ranks
+     */
+    [[nodiscard]] EventTime get_lookahead() const noexcept;
+
+    /**
+     * Get the number of windows processed so far.
+     *
+     * @return number of windows
+     */
+    [[nodiscard]] int64_t get_windows_count() const noexcept;
+
+    /**
+     * Get the number of chunks this rank migrated to other ranks so far.
+     *
+     * @return number of migrated chunks
+     */
+    [[nodiscard]] int64_t get_migrated_chunks_count() const noexcept;
+
+  private:
+    /// payload of the chunks, identifying their delivery
+    struct Delivery {
+        /// simulation of the rank the chunk is on
+        DistributedSimulation* simulation;
+
+        /// tag of the chunk
+        uint64_t tag;
+
+        /// dest NPU id of the chunk
+        DeviceId dest;
+    };
+
+    /// topology being simulated
+    std::shared_ptr<Topology> topology;
+
+    /// scheduler of the topology before the simulation took it over
+    std::shared_ptr<NetworkScheduler> original_scheduler;
+
+    /// rank of this process
+    int rank;
+
+    /// number of ranks
+    int ranks_count;
+
+    /// rank of each device
+    std::vector<int> rank_per_device;
+
+    /// event queue of the devices of this rank
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// mailboxes of the chunk arrivals leaving this rank, indexed by dest rank
+    std::vector<EventMailbox> mailboxes;
+
+    /// smallest latency among the links crossing ranks (the largest EventTime if none)
+    EventTime lookahead;
+
+    /// invoked when a chunk arrives at a device of this rank
+    DeliveryHandler delivery_handler;
+
+    /// rank 0: listening socket, and the socket of every other rank (-1 for itself)
+    int listen_fd;
+    std::vector<int> rank_fds;
+
+    /// other ranks: socket connected to rank 0
+    int fd;
+
+    /// port rank 0 listens on
+    uint16_t port;
+
+    /// number of windows processed so far
+    int64_t windows_count;
+
+    /// number of chunks migrated to other ranks so far
+    int64_t migrated_chunks_count;
+
+    /**
+     * Callback of the chunks: invoke the delivery handler.
+     *
+     * @param delivery_ptr pointer to the Delivery payload of the chunk
+     */
+    static void deliver(void* delivery_ptr) noexcept;
+
+    /**
+     * Rank 0: accept the other ranks, checking they simulate the same topology.
+     */
+    void accept_ranks() noexcept;
+
+    /**
+     * Encode the chunks leaving this rank into migration records, releasing them.
+     *
+     * @param message message to append the records to
+     */
+    void encode_migrations(std::string& message) noexcept;
+
+    /**
+     * Rebuild the chunks migrated to this rank and schedule their arrivals.
+     *
+     * @param message message holding the records
+     * @param offset offset of the first record
+     */
+    void decode_migrations(const std::string& message, size_t offset) noexcept;
+
+    /**
+     * Exchange the state of this window with the other ranks.
+     *
+     * @param message next event time, current time, and migration records of this rank
+     * @return next window start and the latest current time among the ranks,
+     *         followed by the migration records to this rank
+     */
+    [[nodiscard]] std::string exchange(const std::string& message) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
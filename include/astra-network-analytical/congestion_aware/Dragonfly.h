@@ -0,0 +1,188 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include <cstdint>
+#include <unordered_map>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements a Dragonfly topology: groups of routers, with a local link between every two routers of a group
+ * and a global link between every two groups.
+ *
+ * Dragonfly(6, 1, 2, 1) example (1 NPU per router, 2 routers per group, 1 global link per router, 3 groups):
+ *
+ *      group 0          group 1          group 2
+ *    [6] --- [7]      [8] --- [9]      [10] --- [11]
+ *
+ *   - router 6 + i hosts NPU i
+ *   - global links: 6 - 9 (groups 0, 1), 7 - 10 (groups 0, 2), 8 - 11 (groups 1, 2)
+ *
+ * Device IDs: NPUs first (npus_per_router NPUs per router), then the routers, group by group.
+ *
+ * Global links are arranged in closed form: group i reaches group j through its global port
+ * (j - i - 1) mod groups_count, i.e., router ((j - i - 1) mod groups_count) / global_links_per_router.
+ *
+ * Routing (see set_routing):
+ *   - Minimal: local hop to the router holding the global link to the dest group (if needed),
+ *     the global hop, then a local hop to the dest router (if needed);
+ *     e.g., route(0, 2) = 0, 6, 9, 8, 2 on the example above
+ *   - Valiant: chunks between groups first take a minimal route to an intermediate group
+ *     (hashed from the chunk id), then a minimal route to the dest
+ * Both are computed arithmetically from the group and router indices, without any graph search.
+ */
+class Dragonfly final : public BasicTopology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs (a multiple of npus_per_router * routers_per_group)
+     * @param npus_per_router number of NPUs attached to every router
+     * @param routers_per_group number of routers of every group
+     * @param global_links_per_router number of global links of every router
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    Dragonfly(int npus_count,
+              int npus_per_router,
+              int routers_per_group,
+              int global_links_per_router,
+              Bandwidth bandwidth,
+              Latency latency) noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology (the minimal route).
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology (the minimal route).
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of select_route function in Topology.
+     * Valiant routing sends chunks between groups through an intermediate group.
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+    /**
+     * Implementation of build_route_tables function in Topology.
+     */
+    void build_route_tables() const noexcept override;
+
+    /**
+     * Set the routing policy.
+     *
+     * @param new_routing routing policy
+     */
+    void set_routing(DragonflyRouting new_routing) noexcept;
+
+    /**
+     * Get the routing policy.
+     *
+     * @return routing policy
+     */
+    [[nodiscard]] DragonflyRouting get_routing() const noexcept;
+
+    /**
+     * Get the number of groups.
+     *
+     * @return number of groups
+     */
+    [[nodiscard]] int get_groups_count() const noexcept;
+
+    /**
+     * Get the router an NPU is attached to.
+     *
+     * @param npu_id NPU ID
+     * @return device ID of the router
+     */
+    [[nodiscard]] DeviceId get_router(DeviceId npu_id) const noexcept;
+
+    /**
+     * Get the group of a router.
+     *
+     * @param router_id device ID of the router
+     * @return group index
+     */
+    [[nodiscard]] int get_group(DeviceId router_id) const noexcept;
+
+  private:
+    /// number of NPUs attached to every router
+    int npus_per_router;
+
+    /// number of routers of every group
+    int routers_per_group;
+
+    /// number of global links of every router
+    int global_links_per_router;
+
+    /// number of groups
+    int groups_count;
+
+    /// routing policy
+    DragonflyRouting routing;
+
+    /// Valiant routes interned per (src, dest, intermediate group), only for the triples chunks took
+    /// (a full table would hold groups_count routes per NPU pair)
+    mutable std::unordered_map<uint64_t, Route> valiant_routes;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
+    /**
+     * Get the router of a group holding the global link to another group.
+     *
+     * @param group group of the router
+     * @param target_group group the global link leads to
+     * @return device ID of the router
+     */
+    [[nodiscard]] DeviceId gateway_router(int group, int target_group) const noexcept;
+
+    /**
+     * Get the router a router moves to next on a minimal route to a group other than its own.
+     *
+     * @param router_id device ID of the current router
+     * @param target_group group to reach
+     * @return device ID of the next router
+     */
+    [[nodiscard]] DeviceId step_to_group(DeviceId router_id, int target_group) const noexcept;
+
+    /**
+     * Compute the Valiant route from src to dest through an intermediate group.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param intermediate_group group to pass through
+     * @return Valiant route from src to dest
+     */
+    [[nodiscard]] Route compute_valiant_route(DeviceId src, DeviceId dest, int intermediate_group) const noexcept;
+
+    /**
+     * Get the Valiant route from src to dest through an intermediate group, with its links resolved.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param intermediate_group group to pass through
+     * @return route, valid as long as the topology
+     */
+    [[nodiscard]] const Route* valiant_route(DeviceId src, DeviceId dest, int intermediate_group) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,90 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/ExecutionTrace.h"
+#include "common/Type.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/Topology.h"
+#include <list>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ExecutionTraceAdapter replays execution traces on a congestion-aware topology:
+ * point-to-point messages are sent as chunks, and collectives run as Collective.
+ */
+class ExecutionTraceAdapter final : public ExecutionTraceNetwork {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to replay on, driven by its scheduler
+     * @param collective_algorithm algorithm collectives are decomposed with
+     * @param chunks_count number of chunks each collective message is split into
+     */
+    explicit ExecutionTraceAdapter(std::shared_ptr<Topology> topology,
+                                   CollectiveAlgorithm collective_algorithm = CollectiveAlgorithm::Ring,
+                                   int chunks_count = 1) noexcept;
+
+    [[nodiscard]] NetworkScheduler& get_scheduler() noexcept override;
+
+    [[nodiscard]] int get_npus_count() const noexcept override;
+
+    void send(DeviceId src, DeviceId dest, ChunkSize size, Callback callback, CallbackArg callback_arg) noexcept override;
+
+    void run_collective(CollectiveType collective_type,
+                        ChunkSize size,
+                        Callback callback,
+                        CallbackArg callback_arg) noexcept override;
+
+  private:
+    /// a running collective
+    struct RunningCollective {
+        /// adapter running the collective
+        ExecutionTraceAdapter* adapter;
+
+        /// the collective
+        Collective collective;
+
+        /// callback to be invoked when the collective finishes
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+
+        /// position of this collective in running_collectives
+        std::list<RunningCollective>::iterator position;
+    };
+
+    /// topology to replay on
+    std::shared_ptr<Topology> topology;
+
+    /// algorithm collectives are decomposed with
+    CollectiveAlgorithm collective_algorithm;
+
+    /// number of chunks each collective message is split into
+    int chunks_count;
+
+    /// running collectives (stable addresses)
+    std::list<RunningCollective> running_collectives;
+
+    /// finished collectives, destroyed once their callbacks returned
+    std::vector<std::list<RunningCollective>::iterator> finished_collectives;
+
+    /**
+     * Callback of every collective.
+     *
+     * @param running_collective_ptr pointer to the finished collective
+     */
+    static void collective_finished(void* running_collective_ptr) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,136 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements a two- or three-tier fat-tree (folded Clos) topology of radix-port switches.
+ *
+ * FatTree(8, 4, 2) example (radix 4, 2 tiers, no oversubscription):
+ *
+ *          spine 12          spine 13
+ *      (each leaf connects to every spine)
+ *    leaf 8  leaf 9  leaf 10  leaf 11
+ *    |  |    |  |    |  |     |  |
+ *    0  1    2  3    4  5     6  7
+ *
+ * Leaf switches split their ports into downlinks (to NPUs) and uplinks,
+ * with oversubscription downlinks per uplink.
+ *   - 2 tiers: every leaf connects to every spine (one spine per leaf uplink).
+ *   - 3 tiers: radix / 2 leaves form a pod, connecting to every aggregation switch of the pod
+ *     (one per leaf uplink); aggregation switch a of every pod connects to the radix / 2 core switches of group a.
+ *
+ * Device IDs: NPUs first, then the leaves, then the spines (aggregation switches, pod by pod), then the cores.
+ *
+ * Routing: up/down routing with deterministic ECMP.
+ * A chunk climbs only as high as the lowest common tier of src and dest, then descends.
+ * At each upward hop, the uplink is picked by hashing (current switch, dest),
+ * so routes are computed in closed form without any routing table.
+ */
+class FatTree final : public BasicTopology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs
+     * @param radix number of ports of every switch (even)
+     * @param tiers number of switch tiers (2 or 3)
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     * @param oversubscription number of leaf downlinks per leaf uplink (radix should be divisible by it plus one)
+     */
+    FatTree(int npus_count,
+            int radix,
+            int tiers,
+            Bandwidth bandwidth,
+            Latency latency,
+            int oversubscription = 1) noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Get the number of switch tiers.
+     *
+     * @return number of tiers
+     */
+    [[nodiscard]] int get_tiers() const noexcept;
+
+    /**
+     * Get the leaf switch of an NPU.
+     *
+     * @param npu_id NPU ID
+     * @return device ID of the leaf
+     */
+    [[nodiscard]] DeviceId get_leaf(DeviceId npu_id) const noexcept;
+
+  private:
+    /// number of ports of every switch
+    int radix;
+
+    /// number of switch tiers
+    int tiers;
+
+    /// number of uplinks of every leaf
+    int leaf_up_ports;
+
+    /// number of NPUs per leaf
+    int leaf_down_ports;
+
+    /// number of leaf switches
+    int leaves_count;
+
+    /// number of leaves per pod (3 tiers), all leaves otherwise
+    int leaves_per_pod;
+
+    /// number of pods (1 for 2 tiers)
+    int pods_count;
+
+    /// device ID of the first leaf
+    DeviceId first_leaf_id;
+
+    /// device ID of the first spine (aggregation switch for 3 tiers)
+    DeviceId first_spine_id;
+
+    /// device ID of the first core switch (3 tiers)
+    DeviceId first_core_id;
+
+    /**
+     * Count the devices (NPUs and switches) of a fat-tree.
+     *
+     * @param npus_count number of NPUs
+     * @param radix number of ports of every switch
+     * @param tiers number of switch tiers
+     * @param oversubscription number of leaf downlinks per leaf uplink
+     * @return number of devices
+     */
+    [[nodiscard]] static int devices_count_of(int npus_count, int radix, int tiers, int oversubscription) noexcept;
+
+    /**
+     * Pick one of the up ports of a switch toward dest (ECMP).
+     *
+     * @param current current switch
+     * @param dest dest NPU ID
+     * @param up_ports_count number of up ports of the switch
+     * @return index of the up port
+     */
+    [[nodiscard]] static int ecmp_port(DeviceId current, DeviceId dest, int up_ports_count) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,256 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * FlowModel is a flow-level (fluid) congestion model over the link graph of a Topology.
+ *
+ * Instead of simulating every chunk at every hop, each transfer is a flow
+ * occupying all links of its route at once.
+ * Link bandwidth is shared among the flows crossing it with max-min fairness,
+ * and time only advances when a flow starts or drains,
+ * so the cost scales with the number of flows rather than chunks x hops.
+ *
+ * A flow of size S on a route with latencies L_i, draining at rate r, finishes at
+ * (drain time) + sum(L_i): transfers are pipelined across hops (cut-through),
+ * whereas the chunk-level simulation stores and forwards each chunk at every hop.
+ * Both models agree for single-hop transfers.
+ *
+ * Rates are updated incrementally, once for all the flows starting or draining at the same time.
+ * Progressive filling only changes below the smallest rate of the changed flows (a drained flow's rate,
+ * or the fair share a started flow is guaranteed on its links), so slower flows keep their rates,
+ * and only the faster flows connected to the changed links through shared links get their rates recomputed.
+ * Flows drain lazily, from the time their rate was last set, so an event never scans every active flow.
+ */
+class FlowModel {
+  public:
+    /// flow ID, in the order flows were added
+    using FlowId = int;
+
+    /**
+     * Constructor.
+     *
+     * @param topology topology whose links the flows share
+     */
+    explicit FlowModel(std::shared_ptr<Topology> topology) noexcept;
+
+    /**
+     * Add a flow to the simulation.
+     * Flows can also be added from the callbacks of finished flows.
+     *
+     * @param start_time time the flow starts (not earlier than the current time)
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param flow_size number of bytes to transfer
+     * @param callback callback to be invoked when the flow finishes (nullptr: none)
+     * @param callback_arg argument of the callback
+     * @return id of the flow
+     */
+    FlowId add_flow(EventTime start_time,
+                    DeviceId src,
+                    DeviceId dest,
+                    ChunkSize flow_size,
+                    Callback callback = nullptr,
+                    CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Simulate until every flow finished.
+     *
+     * @return time the last flow finished
+     */
+    EventTime run() noexcept;
+
+    /**
+     * Get the time a flow finished.
+     *
+     * @param flow_id id of the flow
+     * @return finish time of the flow
+     */
+    [[nodiscard]] EventTime get_finish_time(FlowId flow_id) const noexcept;
+
+    /**
+     * Get the current simulation time.
+     *
+     * @return current time
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Get the number of flows added so far.
+     *
+     * @return number of flows
+     */
+    [[nodiscard]] int get_flows_count() const noexcept;
+
+    /**
+     * Get the number of flow rates computed so far, i.e., the cost of the incremental rate updates.
+     *
+     * @return number of flow rates computed
+     */
+    [[nodiscard]] uint64_t get_rate_updates_count() const noexcept;
+
+  private:
+    /// state of a single flow
+    struct Flow {
+        /// route of the flow, links resolved
+        Route route;
+
+        /// time the flow starts
+        EventTime start_time;
+
+        /// bytes left to drain at update_time
+        double remaining_bytes;
+
+        /// current max-min fair rate (B/tick)
+        double rate;
+
+        /// time remaining_bytes was last updated (ticks)
+        double update_time;
+
+        /// incremented whenever the rate changes, invalidating the drain events of earlier rates
+        int generation;
+
+        /// true while the flow shares link bandwidth
+        bool active;
+
+        /// index of the flow's first hop in link_slots
+        int first_link_slot;
+
+        /// last rate update that visited the flow
+        int visit_epoch;
+
+        /// propagation latency along the route (ticks)
+        double path_latency;
+
+        /// time the flow finished (valid once finished)
+        EventTime finish_time;
+
+        /// callback invoked when the flow finishes
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+    };
+
+    /// time-ordered (time, flow id) pairs
+    using FlowEvents = std::priority_queue<std::pair<double, FlowId>,
+                                           std::vector<std::pair<double, FlowId>>,
+                                           std::greater<std::pair<double, FlowId>>>;
+
+    /// (drain time, flow id, generation) triple
+    using DrainEvent = std::tuple<double, FlowId, int>;
+
+    /// time-ordered (fair share, link id) pairs
+    using LinkShares = std::priority_queue<std::pair<double, LinkId>,
+                                           std::vector<std::pair<double, LinkId>>,
+                                           std::greater<std::pair<double, LinkId>>>;
+
+    /// topology whose links the flows share
+    std::shared_ptr<Topology> topology;
+
+    /// capacity of each link (B/tick)
+    std::vector<double> link_capacities;
+
+    /// every flow, indexed by FlowId
+    std::vector<Flow> flows;
+
+    /// flows waiting for their start time
+    FlowEvents pending_flows;
+
+    /// drained flows waiting for their last byte to propagate
+    FlowEvents delivering_flows;
+
+    /// projected drain times of the active flows, as a min-heap (entries of earlier generations are stale)
+    std::vector<DrainEvent> drain_events;
+
+    /// number of stale entries in drain_events
+    size_t stale_drain_events_count;
+
+    /// number of flows currently sharing link bandwidth
+    int active_flows_count;
+
+    /// active flows crossing each link
+    std::vector<std::vector<FlowId>> link_flows;
+
+    /// position of each flow in the flows of each link of its route, by flow then hop
+    std::vector<int> link_slots;
+
+    /// links whose set of flows changed since the last rate update
+    std::vector<LinkId> changed_links;
+
+    /// flows started since the last rate update
+    std::vector<FlowId> started_flows;
+
+    /// smallest rate of the flows drained since the last rate update (B/tick)
+    double min_drained_rate;
+
+    /// current simulation time (ns)
+    double current_time;
+
+    /// number of flow rates computed so far
+    uint64_t rate_updates_count;
+
+    /// id of the current rate update, marking the links and flows it visited
+    int visit_epoch;
+
+    /// last rate update that visited each link
+    std::vector<int> link_visit_epochs;
+
+    /// per-link scratch buffers of the max-min allocation
+    std::vector<double> residual_capacities;
+    std::vector<int> unfrozen_flows_count;
+
+    /// links and flows of the current rate update
+    std::vector<LinkId> component_links;
+    std::vector<FlowId> component_flows;
+
+    /**
+     * Start sharing link bandwidth with a flow.
+     *
+     * @param flow_id id of the flow
+     */
+    void activate(FlowId flow_id) noexcept;
+
+    /**
+     * Stop sharing link bandwidth with a drained flow.
+     *
+     * @param flow_id id of the flow
+     */
+    void deactivate(FlowId flow_id) noexcept;
+
+    /**
+     * Get the earliest time an active flow drains, dropping stale drain events.
+     *
+     * @return next drain time, infinity if none
+     */
+    [[nodiscard]] double next_drain_time() noexcept;
+
+    /**
+     * Move the flows drained by the current time to delivering_flows.
+     */
+    void drain() noexcept;
+
+    /**
+     * Recompute the max-min fair rates (progressive filling) of the flows whose rates can change,
+     * i.e., the flows connected to the changed links, through flows no slower than the changed ones.
+     */
+    void allocate_rates() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,148 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Configuration of flow sampling.
+ */
+struct FlowSamplingConfig {
+    /// fraction of the flows simulated, in (0, 1]
+    double sampling_fraction = 0.01;
+
+    /// number of independent samples, each simulated on a fresh topology (at least 2, for confidence intervals)
+    int replicas_count = 8;
+
+    /// seed of the first sample (sample i is drawn with seed + i)
+    uint64_t seed = 0;
+};
+
+/**
+ * Estimate of a quantity over independent samples, with its 95% confidence interval.
+ */
+struct SampledEstimate {
+    /// mean over the samples
+    double mean = 0;
+
+    /// bounds of the 95% confidence interval of the mean (Student's t over the samples)
+    double low = 0;
+    double high = 0;
+};
+
+/**
+ * Estimates of an all-to-all from sampled flows, in ticks.
+ */
+struct FlowSamplingResult {
+    /// time the last flow of the all-to-all arrives
+    SampledEstimate finish_time;
+
+    /// mean time a flow takes to arrive
+    SampledEstimate mean_flow_time;
+
+    /// number of flows of the whole all-to-all
+    uint64_t flows_count = 0;
+
+    /// number of flows simulated per sample
+    uint64_t sampled_flows_count = 0;
+
+    /// fraction of the flows actually simulated (the sampling fraction rounded to whole flows per src)
+    double effective_fraction = 0;
+
+    /// finish time of each sample
+    std::vector<EventTime> sample_finish_times;
+};
+
+/**
+ * FlowSampling estimates the congestion-aware finish time of all-to-all traffic too large to simulate exactly
+ * (e.g., the 268M flows of a 16K-NPU all-to-all), by simulating a stratified sample of its flows
+ * on links scaled down to the sampled fraction.
+ *
+ * The flows are stratified by src: every NPU sends to the same number of dests, drawn uniformly at random,
+ * so every injection link carries the same share of its traffic, and every other link that share on average.
+ * Each sampled flow is a single chunk of flow_size / fraction bytes, which serializes as flow_size bytes
+ * on links of fraction times their bandwidth, without materializing the links lazily built topologies skip.
+ * Independent samples give the spread of the estimates, hence their confidence intervals.
+ *
+ * Since the most loaded link sets the finish time, and sampling spreads the load of the links,
+ * the finish time tends to be slightly overestimated at small fractions.
+ */
+class FlowSampling {
+  public:
+    /// constructs a fresh topology on the calling thread's default event queue
+    using TopologyFactory = std::function<std::shared_ptr<Topology>()>;
+
+    /**
+     * Estimate an all-to-all, every NPU sending flow_size bytes to every other NPU at time 0.
+     * Each sample is an independent simulation on a fresh topology, run on a work-stealing thread pool.
+     *
+     * @param topology_factory constructs the topology of each sample
+     * @param flow_size size of each flow
+     * @param config sampling configuration
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @return estimates of the all-to-all
+     */
+    [[nodiscard]] static FlowSamplingResult estimate_all_to_all(const TopologyFactory& topology_factory,
+                                                                ChunkSize flow_size,
+                                                                const FlowSamplingConfig& config,
+                                                                int threads_count = 0) noexcept;
+
+    /**
+     * Draw distinct dests of a src uniformly at random (Floyd's algorithm, in O(dests_count)).
+     *
+     * @param npus_count number of NPUs
+     * @param src src NPU id, never drawn
+     * @param dests_count number of dests to draw, at most npus_count - 1
+     * @param random_engine random number generator
+     * @return dests, sorted
+     */
+    [[nodiscard]] static std::vector<DeviceId> sample_dests(int npus_count,
+                                                            DeviceId src,
+                                                            int dests_count,
+                                                            std::mt19937_64& random_engine) noexcept;
+
+  private:
+    /**
+     * Arrivals of the flows of a sample, passed as the argument of their callbacks.
+     */
+    struct SampleArrivals {
+        /// event queue of the sample
+        EventQueue* event_queue;
+
+        /// time the last flow arrived
+        EventTime finish_time;
+
+        /// sum of the arrival times of the flows
+        double arrival_times_sum;
+    };
+
+    /**
+     * Callback of a sampled flow arriving at its dest.
+     *
+     * @param arrivals_ptr pointer to the arrivals of the sample
+     */
+    static void flow_arrived(void* arrivals_ptr) noexcept;
+
+    /**
+     * Estimate the mean of independent samples of a quantity.
+     *
+     * @param samples samples of the quantity (at least 2)
+     * @return mean and confidence interval
+     */
+    [[nodiscard]] static SampledEstimate estimate(const std::vector<double>& samples) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -7,6 +7,9 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/BasicTopology.h"
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
 
 namespace NetworkAnalyticalCongestionAware {
 
@@ -23,6 +26,16 @@ namespace NetworkAnalyticalCongestionAware {
  * Therefore, the number of NPUs and devices are both 4.
  *
  * Arbitrary send between two pair of NPUs will take 1 hop.
+ *
+ * Link ids follow a closed form (src-major, skipping src itself),
+ * so links are only materialized once used (see LinkTable).
+ *
+ * Routing (see set_routing):
+ *   - Direct: src -> dest
+ *   - Valiant: src -> intermediate -> dest, the intermediate NPU hashed from the chunk id,
+ *     spreading skewed traffic over every link at the cost of a second hop
+ *   - Adaptive: Valiant only when the direct link is congested, i.e., queues at least adaptive_threshold chunks,
+ *     and more than twice as many as the first link of the indirect route (UGAL, weighing queues by hops)
  */
 class FullyConnected final : public BasicTopology {
   public:
@@ -36,9 +49,114 @@ class FullyConnected final : public BasicTopology {
     FullyConnected(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
     /**
-     * Implementation of route function in Topology.
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology, in closed form.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of compute_metrics function in Topology, in closed form.
+     */
+    [[nodiscard]] TopologyMetrics compute_metrics(int threads_count = 0) const noexcept override;
+
+    /**
+     * Implementation of find_link function in Topology.
+     */
+    [[nodiscard]] LinkId find_link(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of select_route function in Topology.
+     * Valiant and adaptive routing send chunks through an intermediate NPU.
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+    /**
+     * Implementation of build_route_tables function in Topology.
+     */
+    void build_route_tables() const noexcept override;
+
+    /**
+     * Set the routing policy.
+     *
+     * @param new_routing routing policy
+     * @param new_adaptive_threshold chunks queued at a direct link before adaptive routing avoids it
+     */
+    void set_routing(FullyConnectedRouting new_routing, int new_adaptive_threshold = 2) noexcept;
+
+    /**
+     * Get the routing policy.
+     *
+     * @return routing policy
+     */
+    [[nodiscard]] FullyConnectedRouting get_routing() const noexcept;
+
+    /**
+     * Write the route from src to dest (the one compute_route returns) into a caller-provided buffer.
+     * Defined inline, so loops templated on FullyConnected (see StaticRouting.h) route without virtual calls.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param route buffer of at least get_max_route_length() device ids
+     * @return number of devices written
+     */
+    int write_route(const DeviceId src, const DeviceId dest, DeviceId* const route) const noexcept {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+
+        // directly connected
+        route[0] = src;
+        route[1] = dest;
+        return 2;
+    }
+
+    /**
+     * Get the largest number of devices of a route.
+     *
+     * @return largest number of devices of a route
+     */
+    [[nodiscard]] int get_max_route_length() const noexcept {
+        return 2;
+    }
+
+  private:
+    /// routing policy
+    FullyConnectedRouting routing;
+
+    /// chunks queued at a direct link before adaptive routing avoids it
+    int adaptive_threshold;
+
+    /// indirect routes interned per (src, dest, intermediate NPU), only for the triples chunks took
+    /// unless built upfront (a full table holds npus_count routes per NPU pair)
+    mutable std::unordered_map<uint64_t, Route> indirect_routes;
+
+    /**
+     * Get the route from src to dest through an intermediate NPU, with its links resolved.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param intermediate intermediate NPU id
+     * @return route, valid as long as the topology
+     */
+    [[nodiscard]] const Route* indirect_route(DeviceId src, DeviceId dest, DeviceId intermediate) const noexcept;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
      */
-    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -5,20 +5,73 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/NetworkConfig.h"
 #include "common/NetworkParser.h"
 #include "congestion_aware/Topology.h"
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionAware {
 
 /**
- * Construct a topology from a NetworkParser.
+ * Construct a topology from a NetworkParser, link overrides applied.
  *
  * @param network_parser NetworkParser to parse the network input file
  * @return pointer to the constructed topology
  */
 [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
 
+/**
+ * Construct a topology from a valid NetworkParser (see NetworkParser::try_parse), link overrides applied,
+ * collecting the errors only found against the constructed links instead of exiting,
+ * i.e., overrides of device pairs that aren't linked and of link groups without links.
+ *
+ * @param network_parser network parser
+ * @param errors list the errors found are appended to
+ * @return pointer to the constructed topology, nullptr if any error is found
+ */
+[[nodiscard]] std::shared_ptr<Topology> try_construct_topology(const NetworkParser& network_parser,
+                                                               std::vector<ConfigError>& errors) noexcept;
+
+/**
+ * Construct a topology driven by the given event queue.
+ * Topologies constructed with separate event queues are independent simulations.
+ *
+ * @param network_parser network parser
+ * @param event_queue event queue driving the topology
+ * @return pointer to the constructed topology
+ */
+[[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser,
+                                                           std::shared_ptr<EventQueue> event_queue) noexcept;
+
+/**
+ * Construct a topology from a network configuration built in memory, link overrides applied.
+ *
+ * @param network_config network configuration
+ * @return pointer to the constructed topology
+ */
+[[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config) noexcept;
+
+/**
+ * Construct a topology from a network configuration built in memory, driven by the given event queue.
+ *
+ * @param network_config network configuration
+ * @param event_queue event queue driving the topology
+ * @return pointer to the constructed topology
+ */
+[[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config,
+                                                           std::shared_ptr<EventQueue> event_queue) noexcept;
+
+/**
+ * Apply the link overrides of a NetworkParser to a topology:
+ * link groups (e.g., mesh rows and columns) first, then device pairs, in both directions.
+ * construct_topology applies them already; this is for topologies constructed otherwise.
+ *
+ * @param topology topology whose links are overridden
+ * @param network_parser network parser holding the overrides
+ */
+void apply_link_overrides(Topology& topology, const NetworkParser& network_parser) noexcept;
+
 }  // namespace NetworkAnalyticalCongestionAware
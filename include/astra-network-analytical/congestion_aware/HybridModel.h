@@ -0,0 +1,205 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "congestion_aware/Route.h"
+#include "congestion_aware/Topology.h"
+#include <deque>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * HybridModel simulates mixed traffic on a Topology at two levels of detail:
+ * transfers of at least a threshold size (elephants, e.g., gradient buckets) are flows of a fluid model,
+ * and smaller ones (mice, e.g., latency-sensitive control messages) are chunks through the Link queues.
+ *
+ * Flows share link bandwidth with max-min fairness, as in FlowModel,
+ * the chunks in flight across a link counting as one more flow of that link;
+ * each link then serializes its chunks at the bandwidth the flows leave (see Link::set_bandwidth_share).
+ * The rates are only recomputed when a flow starts or drains,
+ * or when a link starts or stops carrying chunks along with flows,
+ * so elephants cost a few events however large they are, and mice are as accurate as the chunk-level simulation.
+ *
+ * A chunk holds its share on every link of its route from injection to delivery.
+ * A flow finishes once drained plus the latency of its route (cut-through, see FlowModel).
+ * Flows use the bandwidth of the links themselves, regardless of their bandwidth schedules.
+ *
+ * The model runs on the event queue of the topology, which should be attached,
+ * and should outlive the simulation.
+ */
+class HybridModel {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to simulate on, with an event queue attached
+     * @param flow_threshold smallest transfer simulated as a flow
+     */
+    HybridModel(std::shared_ptr<Topology> topology, ChunkSize flow_threshold) noexcept;
+
+    /**
+     * Destructor. Leaves the whole bandwidth of every link to its chunks again.
+     */
+    ~HybridModel() noexcept;
+
+    HybridModel(const HybridModel&) = delete;
+    HybridModel& operator=(const HybridModel&) = delete;
+
+    /**
+     * Start a transfer at the current time: a flow if it's at least the threshold size, a chunk otherwise.
+     *
+     * @param transfer_size number of bytes to transfer
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when the transfer arrives at dest
+     * @param callback_arg argument of the callback
+     */
+    void send(ChunkSize transfer_size, DeviceId src, DeviceId dest, Callback callback, CallbackArg callback_arg)
+        noexcept;
+
+    /**
+     * Get the smallest transfer simulated as a flow.
+     *
+     * @return flow threshold
+     */
+    [[nodiscard]] ChunkSize get_flow_threshold() const noexcept;
+
+    /**
+     * Get the number of transfers simulated as flows so far.
+     *
+     * @return number of flows
+     */
+    [[nodiscard]] int get_flows_count() const noexcept;
+
+    /**
+     * Get the number of transfers simulated as chunks so far.
+     *
+     * @return number of chunks
+     */
+    [[nodiscard]] int get_chunks_count() const noexcept;
+
+  private:
+    /// state of a transfer (a flow or a chunk) in flight
+    struct Transfer {
+        /// model the transfer belongs to, and index of the transfer in it
+        HybridModel* model;
+        int id;
+
+        /// true if simulated as a flow, false if as a chunk
+        bool is_flow;
+
+        /// route of the transfer, owned by the topology
+        const Route* route;
+
+        /// bytes left to drain (flows only)
+        double remaining_bytes;
+
+        /// current max-min fair rate in B/tick (flows only)
+        double rate;
+
+        /// callback invoked when the transfer arrives
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+    };
+
+    /// topology the transfers cross
+    std::shared_ptr<Topology> topology;
+
+    /// event queue of the topology
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// smallest transfer simulated as a flow
+    ChunkSize flow_threshold;
+
+    /// every transfer in flight, and the released slots (references stay valid as the deque grows)
+    std::deque<Transfer> transfers;
+    std::vector<int> free_transfers;
+
+    /// flows sharing link bandwidth, as indices into transfers
+    std::vector<int> active_flows;
+
+    /// number of active flows and of chunks in flight across each link
+    std::vector<int> link_flows_count;
+    std::vector<int> link_chunks_count;
+
+    /// links whose chunks are left a share of the bandwidth
+    std::vector<LinkId> shared_links;
+
+    /// per-link scratch buffers of the max-min allocation
+    std::vector<double> residual_capacities;
+    std::vector<int> unfrozen_counts;
+    std::vector<double> flow_rates;
+
+    /// time the flows last drained
+    EventTime last_drain_time;
+
+    /// event draining the next flow (if any)
+    EventHandle drain_event;
+
+    /// number of transfers simulated as flows and as chunks
+    int flows_count;
+    int chunks_count;
+
+    /**
+     * Take a slot for a transfer.
+     *
+     * @param route route of the transfer
+     * @param callback callback invoked when the transfer arrives
+     * @param callback_arg argument of the callback
+     * @return index of the transfer
+     */
+    int acquire_transfer(const Route* route, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Release the slot of an arrived transfer and invoke its callback.
+     *
+     * @param transfer_id index of the transfer
+     */
+    void complete_transfer(int transfer_id) noexcept;
+
+    /**
+     * Get the capacity of a link in B/tick.
+     *
+     * @param link_id id of the link
+     * @return capacity of the link
+     */
+    [[nodiscard]] double link_capacity(LinkId link_id) const noexcept;
+
+    /**
+     * Drain every active flow up to the current time, delivering the drained ones after their route latency.
+     */
+    void drain() noexcept;
+
+    /**
+     * Share the bandwidth among the active flows and the chunks again (progressive filling),
+     * leave the rest of each link to its chunks, and schedule the next flow to drain.
+     */
+    void allocate_rates() noexcept;
+
+    /**
+     * Event: the next flow drains.
+     *
+     * @param model pointer to the HybridModel
+     */
+    static void flow_drained(void* model) noexcept;
+
+    /**
+     * Event (or chunk callback): a transfer arrives at its destination.
+     *
+     * @param transfer pointer to the Transfer
+     */
+    static void transfer_arrived(void* transfer) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,233 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/SpscRing.h"
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Topology.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * An injection of a chunk described by a workload (see InjectionPipeline).
+ */
+struct PipelinedInjection {
+    /// time the chunk is injected
+    EventTime time = 0;
+
+    /// src NPU id
+    DeviceId src = 0;
+
+    /// dest NPU id (src itself: delivered at once)
+    DeviceId dest = 0;
+
+    /// size of the chunk
+    ChunkSize size = 0;
+};
+
+/**
+ * InjectionPipeline overlaps the preparation of a workload with its simulation:
+ * a producer thread pulls the injections from a generator (e.g., decoding a trace or drawing a synthetic pattern),
+ * computes their routes, and constructs their chunks ahead of simulated time,
+ * handing them to the simulation thread through a lock-free single-producer single-consumer ring.
+ *
+ * The simulation thread only sends the prepared chunks once the simulated time reaches them,
+ * with a single injection event pending at any time (as TraceReplay does).
+ * It waits for the producer only when the ring runs dry, so the results are the same as injecting inline.
+ *
+ * By default, chunks are sent as by Topology::send on the simulation thread, which selects their route.
+ * Routes can instead be precomputed by the producer, only on topologies whose routes are fixed
+ * (see Topology::has_fixed_routes): chunks then take the route of Topology::compute_route,
+ * the one Topology::select_route would select, and own it, as the topology's chunk pool can't be shared
+ * with the producer. Routing shouldn't change (e.g., links fail) while the pipeline runs.
+ */
+class InjectionPipeline {
+  public:
+    /// pulls the next injection, in non-decreasing time order, on the producer thread
+    /// (returns false once the workload is exhausted)
+    using Generator = std::function<bool(PipelinedInjection& injection)>;
+
+    /**
+     * Constructor.
+     *
+     * @param topology topology to inject the chunks into
+     * @param generator generator of the injections, only invoked on the producer thread
+     * @param precompute_routes true to compute the routes on the producer thread (fixed routes only),
+     *                          false to route on injection
+     * @param capacity least number of injections prepared ahead of the simulation
+     */
+    InjectionPipeline(std::shared_ptr<Topology> topology,
+                      Generator generator,
+                      bool precompute_routes = false,
+                      int capacity = 4'096) noexcept;
+
+    /**
+     * Destructor.
+     * Stops the producer thread, dropping the injections it prepared.
+     */
+    ~InjectionPipeline() noexcept;
+
+    InjectionPipeline(const InjectionPipeline&) = delete;
+    InjectionPipeline& operator=(const InjectionPipeline&) = delete;
+
+    /**
+     * Start the producer thread, and schedule the injection of the first chunks.
+     * The simulation is then driven by the topology's scheduler.
+     *
+     * @param callback callback to be invoked when every chunk is delivered (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    void start(Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Check if the workload is exhausted and every chunk delivered.
+     *
+     * @return true if the pipeline finished, false otherwise
+     */
+    [[nodiscard]] bool finished() const noexcept;
+
+    /**
+     * Get the time the last chunk was delivered.
+     *
+     * @return finish time of the pipeline
+     */
+    [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+    /**
+     * Get the number of injected chunks.
+     *
+     * @return number of injected chunks
+     */
+    [[nodiscard]] uint64_t get_injected_count() const noexcept;
+
+    /**
+     * Get the number of delivered chunks.
+     *
+     * @return number of delivered chunks
+     */
+    [[nodiscard]] uint64_t get_delivered_count() const noexcept;
+
+    /**
+     * Get the number of times the simulation thread waited for the producer, i.e., the ring ran dry
+     * (0: preparing the workload was fully overlapped with the simulation).
+     *
+     * @return number of stalls
+     */
+    [[nodiscard]] uint64_t get_stalls_count() const noexcept;
+
+  private:
+    /// an injection prepared by the producer
+    struct PreparedInjection {
+        /// injection
+        PipelinedInjection injection;
+
+        /// chunk on its precomputed route (nullptr: routed on injection)
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    /// topology to inject the chunks into
+    std::shared_ptr<Topology> topology;
+
+    /// generator of the injections
+    Generator generator;
+
+    /// true if routes are computed by the producer
+    bool precompute_routes;
+
+    /// prepared injections, from the producer to the simulation thread
+    SpscRing<PreparedInjection> ring;
+
+    /// producer thread
+    std::thread producer;
+
+    /// set to stop the producer early
+    std::atomic<bool> stop_requested;
+
+    /// set by the producer once every injection is pushed
+    std::atomic<bool> producer_done;
+
+    /// time of the last injection
+    EventTime last_injection_time;
+
+    /// number of injected chunks
+    uint64_t injected_count;
+
+    /// number of delivered chunks
+    uint64_t delivered_count;
+
+    /// number of times the simulation thread waited for the producer
+    uint64_t stalls_count;
+
+    /// true once the workload is exhausted
+    bool exhausted;
+
+    /// true once the finish callback was invoked
+    bool finish_reported;
+
+    /// time the last chunk was delivered
+    EventTime finish_time;
+
+    /// callback to be invoked when every chunk is delivered
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+
+    /**
+     * Body of the producer thread: prepare the injections of the generator into the ring.
+     */
+    void produce() noexcept;
+
+    /**
+     * Callback of the injection event:
+     * inject every prepared chunk whose time was reached, then schedule the next injection.
+     *
+     * @param pipeline_ptr pointer to the pipeline
+     */
+    static void inject_ready(void* pipeline_ptr) noexcept;
+
+    /**
+     * Callback of every chunk of the pipeline.
+     *
+     * @param pipeline_ptr pointer to the pipeline
+     */
+    static void chunk_delivered(void* pipeline_ptr) noexcept;
+
+    /**
+     * Get the next prepared injection, waiting for the producer if the ring is empty.
+     *
+     * @return next prepared injection, nullptr if the workload is exhausted
+     */
+    [[nodiscard]] PreparedInjection* wait_next() noexcept;
+
+    /**
+     * Inject a prepared chunk.
+     *
+     * @param prepared prepared injection
+     */
+    void inject(PreparedInjection& prepared) noexcept;
+
+    /**
+     * Schedule the injection event at the time of the next prepared injection,
+     * or mark the workload exhausted.
+     */
+    void schedule_next_injection() noexcept;
+
+    /**
+     * Record the finish time and invoke the callback, if the pipeline finished.
+     */
+    void check_finished() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
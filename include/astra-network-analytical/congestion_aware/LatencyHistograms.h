@@ -0,0 +1,131 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Histogram.h"
+#include "common/Type.h"
+#include "congestion_aware/Type.h"
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * LatencyHistograms records the distribution of every chunk delivered by a topology
+ * (see Topology::set_latency_histograms), to expose the tail effects averages hide:
+ * the end-to-end latency (from injection to the arrival of its last packet), the queueing delay,
+ * and the number of hops of each chunk, optionally per class of (src, dest) pairs (e.g., intra- vs inter-node).
+ *
+ * Each histogram holds a constant number of buckets (see Histogram), regardless of the number of chunks,
+ * and recording a chunk costs a few counter increments.
+ * Queueing delays are only tracked if NETWORK_ANALYTICAL_ENABLE_STATS is set (0 otherwise).
+ */
+class LatencyHistograms {
+  public:
+    /// maps a (src, dest) pair to its class, in [0, classes_count)
+    using Classifier = std::function<int(DeviceId src, DeviceId dest)>;
+
+    /**
+     * Constructor.
+     *
+     * @param classes_count number of classes
+     * @param classifier class of each (src, dest) pair (nullptr: every chunk in class 0)
+     * @param precision_bits precision of the histograms (see Histogram)
+     */
+    explicit LatencyHistograms(int classes_count = 1,
+                               Classifier classifier = nullptr,
+                               int precision_bits = 7) noexcept;
+
+    /**
+     * Record a delivered chunk.
+     *
+     * @param chunk delivered chunk
+     * @param arrival_time time its last packet arrived at its destination
+     */
+    void record(const Chunk& chunk, EventTime arrival_time) noexcept;
+
+    /**
+     * Drop every recorded chunk.
+     */
+    void reset() noexcept;
+
+    /**
+     * Get the number of classes.
+     *
+     * @return number of classes
+     */
+    [[nodiscard]] int get_classes_count() const noexcept;
+
+    /**
+     * Get the end-to-end latencies of a class.
+     *
+     * @param class_id class (-1: every class merged)
+     * @return histogram of the latencies
+     */
+    [[nodiscard]] Histogram get_latency(int class_id = -1) const noexcept;
+
+    /**
+     * Get the queueing delays of a class.
+     *
+     * @param class_id class (-1: every class merged)
+     * @return histogram of the queueing delays
+     */
+    [[nodiscard]] Histogram get_queueing_delay(int class_id = -1) const noexcept;
+
+    /**
+     * Get the hop counts of a class.
+     *
+     * @param class_id class (-1: every class merged)
+     * @return histogram of the hop counts
+     */
+    [[nodiscard]] Histogram get_hops(int class_id = -1) const noexcept;
+
+    /**
+     * Export the percentiles of every histogram as CSV, a row per class and metric
+     * (every class merged first, as class "all"):
+     * class,metric,count,min,mean,p50,p90,p99,p99.9,max
+     *
+     * @param output stream to write to
+     */
+    void dump(std::ostream& output) const noexcept;
+
+  private:
+    /// histograms of a class
+    struct ClassHistograms {
+        /// end-to-end latencies
+        Histogram latency;
+
+        /// queueing delays
+        Histogram queueing_delay;
+
+        /// hop counts
+        Histogram hops;
+    };
+
+    /// class of each (src, dest) pair (nullptr: a single class)
+    Classifier classifier;
+
+    /// histograms of each class
+    std::vector<ClassHistograms> class_histograms;
+
+    /// guards the histograms, as chunks may be delivered by concurrent partitions
+    mutable std::mutex record_mutex;
+
+    /**
+     * Get a histogram of a class, or of every class merged.
+     *
+     * @param class_id class (-1: every class merged)
+     * @param member histogram of a class to get
+     * @return histogram
+     */
+    [[nodiscard]] Histogram get_histogram(int class_id, Histogram ClassHistograms::*member) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
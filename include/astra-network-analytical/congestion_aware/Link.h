@@ -5,20 +5,122 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
-#include "common/EventQueue.h"
+#include "common/EventMailbox.h"
+#include "common/NetworkScheduler.h"
+#include "common/Stats.h"
+#include "common/TimeBase.h"
 #include "common/Type.h"
+#include "congestion_aware/ChunkQueue.h"
 #include "congestion_aware/Type.h"
+#include <array>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionAware {
 
+/**
+ * Statistics counters of a Link.
+ * Only updated if NETWORK_ANALYTICAL_ENABLE_STATS is set.
+ */
+struct LinkStats {
+    /// number of transmitted chunks
+    uint64_t chunks_transmitted = 0;
+
+    /// number of transmitted bytes
+    uint64_t bytes_transmitted = 0;
+
+    /// total time the link was busy serializing chunks
+    EventTime busy_time = 0;
+
+    /// total time chunks waited for the link before being transmitted
+    EventTime queueing_delay = 0;
+
+    /// largest number of chunks pending at once
+    int max_pending_chunks = 0;
+
+    /// number of chunks transmitted as part of another chunk's transmission (see set_chunk_coalescing)
+    uint64_t chunks_coalesced = 0;
+
+    /// total time the link held a chunk back, as the next link's buffer was full (see set_buffer_capacity)
+    EventTime backpressure_time = 0;
+};
+
+/**
+ * Current load of a Link, e.g., for host-side algorithms choosing routes or chunk orders by network state.
+ * Unlike LinkStats, this is always tracked.
+ */
+struct LinkLoad {
+    /// number of chunks queued at the link: pending, being served, or held back by backpressure
+    int queued_chunks = 0;
+
+    /// bytes of the chunks waiting for the link (pending, or held back by backpressure)
+    ChunkSize pending_bytes = 0;
+
+    /// time the link finishes serializing the chunks it's serving
+    /// (LinkModel::VirtualTime and Calendar: every chunk sent so far), at most the current time if the link is idle
+    EventTime busy_until = 0;
+};
+
+/**
+ * Framing of the transfers on a Link, applied analytically to its serialization delays
+ * (see Link::set_protocol): a chunk is split into MTU-sized packets, each carrying a header
+ * and followed by an inter-packet gap, without any per-packet event.
+ */
+struct LinkProtocol {
+    /// largest payload of a packet in bytes (0: a chunk is a single packet)
+    ChunkSize mtu = 0;
+
+    /// header (and trailer) bytes of every packet
+    ChunkSize header_size = 0;
+
+    /// gap after every packet in ns (e.g., inter-frame gap)
+    Latency packet_gap = 0;
+};
+
+/**
+ * A step of a piecewise-constant bandwidth schedule of a Link (see Link::set_bandwidth_schedule),
+ * e.g., thermal throttling or link retraining.
+ */
+struct BandwidthStep {
+    /// time the step starts
+    EventTime time = 0;
+
+    /// bandwidth of the link from then on, in GB/s
+    Bandwidth bandwidth = 0;
+};
+
+/// steps of a bandwidth schedule, in increasing time order
+using BandwidthSchedule = std::vector<BandwidthStep>;
+
+/**
+ * A step of a piecewise-constant background traffic schedule of a Link (see Link::set_background_schedule),
+ * i.e., traffic that isn't simulated but takes a fraction of the bandwidth of the link.
+ */
+struct BackgroundStep {
+    /// time the step starts
+    EventTime time = 0;
+
+    /// fraction of the bandwidth taken by background traffic from then on, in [0, 1)
+    double utilization = 0;
+};
+
+/// steps of a background traffic schedule, in increasing time order
+using BackgroundSchedule = std::vector<BackgroundStep>;
+
+class LinkTable;
+
 /**
  * Link models physical links between two devices.
  */
 class Link {
   public:
+    /// number of traffic classes a link tells apart
+    static constexpr int max_traffic_classes = 4;
+
     /**
      * Callback to be called when a link becomes free.
      *  - If the link has pending chunks, process the first one.
@@ -29,35 +131,330 @@ class Link {
     static void link_become_free(void* link_ptr) noexcept;
 
     /**
-     * Set the event queue to be used by the link.
+     * Constructor.
+     *
+     * @param src id of the device the link starts from
+     * @param dest id of the device the link goes to
+     * @param bandwidth bandwidth of the link
+     * @param latency latency of the link
+     * @param scheduler scheduler (e.g., event queue) to schedule events on (may be set later)
+     */
+    Link(DeviceId src,
+         DeviceId dest,
+         Bandwidth bandwidth,
+         Latency latency,
+         NetworkScheduler* scheduler = nullptr) noexcept;
+
+    /**
+     * Set the scheduler (e.g., event queue) to be used by the link.
      *
-     * @param event_queue_ptr pointer to the event queue
+     * @param new_scheduler pointer to the scheduler, owned by the topology
      */
-    static void set_event_queue(std::shared_ptr<EventQueue> event_queue_ptr) noexcept;
+    void set_scheduler(NetworkScheduler* new_scheduler) noexcept;
 
     /**
-     * Constructor.
+     * Get the current time of the scheduler driving the link.
      *
-     * @param bandwidth bandwidth of the link
-     * @param latency latency of the link
+     * @return current event time
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Record every transmission through the link into the given trace.
+     *
+     * @param new_link_trace link trace, nullptr to stop recording
+     */
+    void set_link_trace(LinkTrace* new_link_trace) noexcept;
+
+    /**
+     * Record every transmission through the link, with the transmission that determined its start.
+     *
+     * @param new_critical_path critical path tracker, nullptr to stop recording
+     */
+    void set_critical_path(CriticalPath* new_critical_path) noexcept;
+
+    /**
+     * Sample the load of the link into the given row of the utilization sampler.
+     *
+     * @param new_utilization_sampler utilization sampler, nullptr to stop sampling
+     * @param new_sampler_row row of the link in the sampler
+     */
+    void set_utilization_sampler(UtilizationSampler* new_utilization_sampler, int new_sampler_row) noexcept;
+
+    /**
+     * Post chunk arrivals to the given mailbox instead of the link's scheduler,
+     * e.g., when the next device is simulated by another event queue.
+     *
+     * @param new_arrival_mailbox pointer to the mailbox, nullptr to schedule arrivals directly
+     */
+    void set_arrival_mailbox(EventMailbox* new_arrival_mailbox) noexcept;
+
+    /**
+     * Set the transmission model of the link.
+     * This should be set before any chunk is sent through the link.
+     *
+     * @param new_link_model transmission model
+     */
+    void set_link_model(LinkModel new_link_model) noexcept;
+
+    /**
+     * Get the transmission model of the link.
+     *
+     * @return transmission model
+     */
+    [[nodiscard]] LinkModel get_link_model() const noexcept;
+
+    /**
+     * Set the packet size of the link.
+     * Chunks larger than a packet are transmitted as a packet train:
+     * the head packet is forwarded by the next device as soon as it arrives,
+     * so a chunk pays its full serialization delay once rather than at every hop.
+     * This should be set before any chunk is sent through the link.
+     *
+     * @param new_packet_size packet size in bytes, 0 to transmit chunks as a whole (default)
+     */
+    void set_packet_size(ChunkSize new_packet_size) noexcept;
+
+    /**
+     * Get the packet size of the link.
+     *
+     * @return packet size in bytes, 0 if chunks are transmitted as a whole
+     */
+    [[nodiscard]] ChunkSize get_packet_size() const noexcept;
+
+    /**
+     * Set the switching mode of the link.
+     * With SwitchingMode::CutThrough, a chunk's head reaches the next device after the link latency
+     * (so the chunk is forwarded right away), while the link stays reserved for the chunk's serialization,
+     * which can't end before the chunk's tail arrived from the previous hop.
+     * The packet size is ignored in this mode.
+     * This should be set before any chunk is sent through the link.
+     *
+     * @param new_switching_mode switching mode
+     */
+    void set_switching_mode(SwitchingMode new_switching_mode) noexcept;
+
+    /**
+     * Get the switching mode of the link.
+     *
+     * @return switching mode
+     */
+    [[nodiscard]] SwitchingMode get_switching_mode() const noexcept;
+
+    /**
+     * Set the protocol framing the transfers on the link.
+     * Serializing n bytes then takes ceil(n / mtu) packets, each adding its header bytes and gap,
+     * i.e., (n + packets * header_size) / bandwidth + packets * packet_gap,
+     * so the effective bandwidth grows with the transfer size as measured on real links.
+     * This should be set before any chunk is sent through the link.
+     *
+     * @param new_protocol protocol, owned by the caller (nullptr: raw bytes over bandwidth, default)
+     */
+    void set_protocol(const LinkProtocol* new_protocol) noexcept;
+
+    /**
+     * Get the protocol framing the transfers on the link.
+     *
+     * @return protocol, nullptr if none
+     */
+    [[nodiscard]] const LinkProtocol* get_protocol() const noexcept;
+
+    /**
+     * Vary the bandwidth of the link over simulated time, following a piecewise-constant schedule:
+     * the link has its own bandwidth until the first step, then the bandwidth of the last step started.
+     * A transmission is serialized at the bandwidth in effect when it starts,
+     * and the step is only looked up again once a transmission starts past its end.
+     * The bandwidth of the link itself (see set_parameters) is kept, so reset() rewinds the schedule.
+     * This should be set while the link is idle.
+     *
+     * @param new_bandwidth_schedule schedule, owned by the caller (nullptr: constant bandwidth, default)
      */
-    Link(Bandwidth bandwidth, Latency latency) noexcept;
+    void set_bandwidth_schedule(const BandwidthSchedule* new_bandwidth_schedule) noexcept;
+
+    /**
+     * Get the bandwidth schedule of the link.
+     *
+     * @return bandwidth schedule, nullptr if none
+     */
+    [[nodiscard]] const BandwidthSchedule* get_bandwidth_schedule() const noexcept;
+
+    /**
+     * Load the link with background traffic over simulated time, following a piecewise-constant schedule
+     * of the fraction of its bandwidth (of its bandwidth schedule, if any) the background traffic takes:
+     * none until the first step, then the utilization of the last step started
+     * (a single step at time 0 being a constant load).
+     * The background traffic isn't simulated: transmissions are serialized at the bandwidth it leaves,
+     * so contended results cost no extra event. Steps are applied like the ones of set_bandwidth_schedule.
+     * This should be set while the link is idle.
+     *
+     * @param new_background_schedule schedule, owned by the caller (nullptr: no background traffic, default)
+     */
+    void set_background_schedule(const BackgroundSchedule* new_background_schedule) noexcept;
+
+    /**
+     * Get the background traffic schedule of the link.
+     *
+     * @return background traffic schedule, nullptr if none
+     */
+    [[nodiscard]] const BackgroundSchedule* get_background_schedule() const noexcept;
+
+    /**
+     * Apply the steps of the bandwidth and background traffic schedules in effect at the given time, if any,
+     * so the delays of a transmission starting then are computed at its bandwidth.
+     * This is O(1) unless the time is out of the current steps.
+     *
+     * @param time start time of a transmission
+     */
+    void apply_bandwidth_schedule(const EventTime time) noexcept {
+        const auto scheduled = bandwidth_schedule != nullptr || background_schedule != nullptr;
+        if (scheduled && (time < bandwidth_step_begin || bandwidth_step_end <= time)) {
+            look_up_bandwidth_step(time);
+        }
+    }
+
+    /**
+     * Leave only a share of the bandwidth (of its schedule, if any) to the chunks of the link from now on,
+     * e.g., the share left by the flows of a HybridModel crossing it.
+     * Unlike set_parameters, this may be changed while chunks are in flight:
+     * a transmission is serialized at the share in effect when it starts. reset() restores the whole bandwidth.
+     *
+     * @param new_bandwidth_share share of the bandwidth, in (0, 1] (default: 1)
+     */
+    void set_bandwidth_share(double new_bandwidth_share) noexcept;
+
+    /**
+     * Get the share of the bandwidth left to the chunks of the link.
+     *
+     * @return share of the bandwidth
+     */
+    [[nodiscard]] double get_bandwidth_share() const noexcept;
+
+    /**
+     * Set the order in which the link serves its pending chunks.
+     * Under a policy other than FIFO, each traffic class is queued separately.
+     * This should be set while the link is idle.
+     *
+     * @param new_queueing_policy queueing policy
+     * @param class_weights weight of each traffic class in chunks per turn (WeightedRoundRobin only)
+     */
+    void set_queueing_policy(QueueingPolicy new_queueing_policy,
+                             const std::array<int, max_traffic_classes>& class_weights) noexcept;
+
+    /**
+     * Get the queueing policy of the link.
+     *
+     * @return queueing policy
+     */
+    [[nodiscard]] QueueingPolicy get_queueing_policy() const noexcept;
+
+    /**
+     * Set whether the link serves its pending chunks round robin across their input ports
+     * (the device each chunk came from, or its source NPU at injection), instead of in arrival order.
+     * Under a policy other than FIFO, the chunks of each traffic class are arbitrated separately.
+     * This should be set while the link is idle.
+     *
+     * @param new_source_arbitration true to arbitrate across input ports, false otherwise (default)
+     */
+    void set_source_arbitration(bool new_source_arbitration) noexcept;
+
+    /**
+     * Set whether the link coalesces the chunks pending back to back on the same route
+     * into a single transmission (see Topology::set_chunk_coalescing).
+     * This should be set while the link is idle.
+     *
+     * @param new_chunk_coalescing true to coalesce chunks, false otherwise (default)
+     */
+    void set_chunk_coalescing(bool new_chunk_coalescing) noexcept;
+
+    /**
+     * Set the buffer capacity of the link: the bytes of chunks forwarded from upstream links it holds at once,
+     * counted from the time an upstream link starts transmitting a chunk until this link starts transmitting it.
+     * An upstream link holds its next chunk back (credit-based backpressure) until this link's buffer has room,
+     * blocking the chunks queued behind it.
+     * An empty buffer takes any chunk, so chunks larger than the capacity still move.
+     * Chunks injected at the link's src device, hop-by-hop chunks, and multicast chunks aren't bounded.
+     * This should be set while the link is idle.
+     *
+     * @param new_buffer_capacity buffer capacity in bytes (0: unbounded, default)
+     * @param new_link_table links of the topology, to find the next link of the chunks sent through this link
+     * (nullptr: the buffers of the next links aren't checked)
+     */
+    void set_buffer_capacity(ChunkSize new_buffer_capacity, const LinkTable* new_link_table) noexcept;
+
+    /**
+     * Get the buffer capacity of the link.
+     *
+     * @return buffer capacity in bytes (0: unbounded)
+     */
+    [[nodiscard]] ChunkSize get_buffer_capacity() const noexcept;
+
+    /**
+     * Check if the link charges the chunks it transmits to the buffers of their next links (see set_buffer_capacity),
+     * which its events then touch too.
+     *
+     * @return true if the link checks the buffers of the next links
+     */
+    [[nodiscard]] bool charges_next_buffers() const noexcept;
+
+    /**
+     * Set whether the link is contention-free:
+     * every chunk starts transmitting as soon as it's sent, as in the congestion_unaware closed-form delay,
+     * costing a single arrival event (no queueing, no LinkFree event).
+     * This should be set while the link is idle.
+     *
+     * @param new_contention_free true to ignore contention, false to queue chunks (default)
+     */
+    void set_contention_free(bool new_contention_free) noexcept;
+
+    /**
+     * Check if the link is contention-free.
+     *
+     * @return true if the link is contention-free, false otherwise
+     */
+    [[nodiscard]] bool is_contention_free() const noexcept;
 
     /**
      * Try to send a chunk through the link.
      * - If the link is free, service the chunk immediately.
-     * - If the link is busy, add the chunk to the pending chunks list.
+     * - If the link is busy, add the chunk to the pending chunks list
+     *   (LinkModel::VirtualTime: schedule it right after the chunks ahead of it,
+     *   LinkModel::Calendar: schedule it in the earliest gap of the calendar that fits it).
      *
      * @param chunk the chunk to be served by the link
      */
     void send(std::unique_ptr<Chunk> chunk) noexcept;
 
+    /**
+     * Send chunks through the link (LinkModel::Event only), as if sent one by one in order:
+     * the first one is serviced immediately if the link is free, the others are added to the pending chunks at once.
+     *
+     * @param chunks chunks to be served by the link, moved from
+     * @param count number of chunks
+     */
+    void send_batch(std::unique_ptr<Chunk>* chunks, int count) noexcept;
+
     /**
      * Dequeue and try to send the first pending chunk
      * in the pending chunks list.
      */
     void process_pending_transmission() noexcept;
 
+    /**
+     * Take the chunks waiting for the link (pending, or held back by backpressure) out of it,
+     * e.g., to reroute them as the link fails. They leave the link's buffer.
+     *
+     * @return chunks waiting for the link, in the order they would have been served
+     */
+    [[nodiscard]] std::vector<std::unique_ptr<Chunk>> take_waiting_chunks() noexcept;
+
+    /**
+     * Release the buffer space held by a chunk (and the chunks coalesced into it),
+     * waking up the upstream links blocked on this link's buffer.
+     *
+     * @param chunk chunk leaving the buffer
+     */
+    void release_buffer(Chunk& chunk) noexcept;
+
     /**
      * Check if the link has pending chunks.
      *
@@ -66,42 +463,119 @@ class Link {
     [[nodiscard]] bool pending_chunk_exists() const noexcept;
 
     /**
-     * Set the link as busy.
+     * Get the occupancy of the link, i.e., its pending chunks plus the chunk being served.
+     *
+     * @return number of chunks queued at the link
+     */
+    [[nodiscard]] int get_queued_chunks_count() const noexcept;
+
+    /**
+     * Get the bytes of the chunks waiting for the link (pending, or held back by backpressure).
+     *
+     * @return bytes waiting for the link
+     */
+    [[nodiscard]] ChunkSize get_pending_bytes() const noexcept;
+
+    /**
+     * Get the time the link finishes serializing the chunks it's serving
+     * (LinkModel::VirtualTime and Calendar: every chunk sent so far).
+     *
+     * @return busy-until time, at most the current time if the link is idle
+     */
+    [[nodiscard]] EventTime get_busy_until() const noexcept;
+
+    /**
+     * Get the current load of the link.
+     *
+     * @return queued chunks, pending bytes and busy-until time of the link
+     */
+    [[nodiscard]] LinkLoad get_load() const noexcept;
+
+    /**
+     * Set a channel of the link as busy (the link is busy once all its channels are).
      */
     void set_busy() noexcept;
 
     /**
-     * Set the link as free.
+     * Set a channel of the link as free.
      */
     void set_free() noexcept;
 
-  private:
-    /// event queue Link uses to schedule events
-    static std::shared_ptr<EventQueue> event_queue;
+    /**
+     * Clear the dynamic state of the link (busy flag, virtual time, pending chunks, and statistics),
+     * keeping its parameters and settings, so the link can serve another simulation.
+     * Pending chunks from a chunk pool are returned to it, others are destroyed.
+     */
+    void reset() noexcept;
 
-    /// bandwidth of the link in GB/s
-    Bandwidth bandwidth;
+    /**
+     * Change the bandwidth and latency of the link.
+     * This should be set while the link is idle, e.g., between simulations.
+     *
+     * @param new_bandwidth bandwidth of the link
+     * @param new_latency latency of the link
+     */
+    void set_parameters(Bandwidth new_bandwidth, Latency new_latency) noexcept;
 
-    /// bandwidth of the link in B/ns, used in actual computation
-    Bandwidth bandwidth_Bpns;
+    /**
+     * Get the id of the device the link starts from.
+     *
+     * @return src device id
+     */
+    [[nodiscard]] DeviceId get_src() const noexcept;
 
-    /// latency of the link in ns
-    Latency latency;
+    /**
+     * Get the id of the device the link goes to.
+     *
+     * @return dest device id
+     */
+    [[nodiscard]] DeviceId get_dest() const noexcept;
 
-    /// queue of pending chunks
-    std::list<std::unique_ptr<Chunk>> pending_chunks;
+    /**
+     * Set the number of parallel channels (lanes) of the link, each with the link's bandwidth,
+     * and how chunks use them (see ChannelMode).
+     * LinkModel::VirtualTime and contention-free links always stripe chunks across their channels.
+     * This should be set while the link is idle.
+     *
+     * @param new_channels_count number of channels (default: 1)
+     * @param new_channel_mode use of the channels (default: ChannelMode::Striped)
+     */
+    void set_channels(int new_channels_count, ChannelMode new_channel_mode) noexcept;
 
-    /// flag to indicate if the link is busy
-    bool busy;
+    /**
+     * Get the number of parallel channels of the link.
+     *
+     * @return number of channels
+     */
+    [[nodiscard]] int get_channels_count() const noexcept;
 
     /**
-     * Compute the serialization delay of a chunk on the link.
-     * i.e., serialization delay = (chunk size) / (link bandwidth)
+     * Get how chunks use the parallel channels of the link.
      *
-     * @param chunk_size size of the target chunk
-     * @return serialization delay of the chunk
+     * @return channel mode
      */
-    [[nodiscard]] EventTime serialization_delay(ChunkSize chunk_size) const noexcept;
+    [[nodiscard]] ChannelMode get_channel_mode() const noexcept;
+
+    /**
+     * Get the bandwidth of the link (of each of its channels), without its bandwidth schedule.
+     *
+     * @return bandwidth of the link in GB/s
+     */
+    [[nodiscard]] Bandwidth get_bandwidth() const noexcept;
+
+    /**
+     * Get the latency of the link.
+     *
+     * @return latency of the link in ns
+     */
+    [[nodiscard]] Latency get_latency() const noexcept;
+
+    /**
+     * Get the statistics counters of the link.
+     *
+     * @return statistics counters
+     */
+    [[nodiscard]] const LinkStats& get_stats() const noexcept;
 
     /**
      * Compute the communication delay of a chunk.
@@ -112,6 +586,228 @@ class Link {
      */
     [[nodiscard]] EventTime communication_delay(ChunkSize chunk_size) const noexcept;
 
+    /**
+     * Timings of a chunk (packet train) transmitted through the link.
+     */
+    struct TrainTiming {
+        /// time the last packet is serialized, i.e., the link becomes free
+        EventTime link_free_time = 0;
+
+        /// time the head packet arrives at the next device
+        EventTime head_arrival_time = 0;
+
+        /// time the last packet arrives at the next device
+        EventTime tail_arrival_time = 0;
+    };
+
+    /**
+     * Check if the link is idle for a chunk starting at the given time (LinkModel::VirtualTime or Calendar),
+     * i.e., every chunk sent so far is serialized by then
+     * (LinkModel::Calendar: the chunk fits the gap of the calendar at that time).
+     *
+     * @param time time to check
+     * @param chunk chunk to transmit
+     * @return true if the link is idle at the given time, false otherwise
+     */
+    [[nodiscard]] bool idle_at(EventTime time, const Chunk& chunk) noexcept;
+
+    /**
+     * Compute the timings of a chunk starting at the given time, at the bandwidth in effect then,
+     * without reserving the link (LinkModel::VirtualTime).
+     *
+     * @param start_time time the chunk starts serialization
+     * @param chunk chunk to transmit
+     * @param tail_arrival_time time the last packet of the chunk arrives at the link
+     * @return timings of the chunk
+     */
+    [[nodiscard]] TrainTiming plan_transmission(EventTime start_time,
+                                                const Chunk& chunk,
+                                                EventTime tail_arrival_time) noexcept;
+
+    /**
+     * Reserve the (idle) link for a chunk planned by plan_transmission (LinkModel::VirtualTime),
+     * without scheduling any event.
+     *
+     * @param start_time time the chunk starts serialization, should be idle_at(start_time)
+     * @param timing timings of the chunk (see plan_transmission)
+     * @param chunk chunk to transmit, whose tail arrival time is updated to the time it arrives at the next device
+     */
+    void reserve(EventTime start_time, const TrainTiming& timing, Chunk& chunk) noexcept;
+
+  private:
+    /**
+     * Pending chunks of each traffic class, served by priority or in weighted turns.
+     */
+    struct ClassQueues {
+        /// pending chunks of each traffic class
+        std::array<ChunkQueue, max_traffic_classes> queues;
+
+        /// chunks each class serves per turn (WeightedRoundRobin)
+        std::array<int, max_traffic_classes> weights = {};
+
+        /// class whose turn it is (WeightedRoundRobin)
+        int current_class = 0;
+
+        /// chunks the current class served in its turn (WeightedRoundRobin)
+        int served_count = 0;
+
+        /// number of pending chunks of every class
+        int chunks_count = 0;
+    };
+
+    // members are ordered by size to keep links compact (a topology may hold millions of them)
+
+    /// scheduler (e.g., event queue) Link uses to schedule events
+    /// (owned by the topology the link belongs to)
+    NetworkScheduler* scheduler;
+
+    /// mailbox chunk arrivals are posted to (nullptr: scheduled on scheduler)
+    EventMailbox* arrival_mailbox;
+
+    /// trace transmissions are recorded into (nullptr: not recorded)
+    /// (owned by the topology the link belongs to)
+    LinkTrace* link_trace;
+
+    /// critical path tracker transmissions are recorded into (nullptr: not recorded)
+    /// (owned by the topology the link belongs to)
+    CriticalPath* critical_path;
+
+    /// sampler the load of the link is aggregated into (nullptr: not sampled)
+    /// (owned by the topology the link belongs to)
+    UtilizationSampler* utilization_sampler;
+
+    /// id of the device the link starts from
+    DeviceId src;
+
+    /// id of the device the link goes to
+    DeviceId dest;
+
+    /// row of the link in utilization_sampler
+    int sampler_row;
+
+    /// transmission model of the link
+    LinkModel link_model;
+
+    /// switching mode of the link
+    SwitchingMode switching_mode;
+
+    /// flag to indicate if the link is busy (all its channels are)
+    bool busy;
+
+    /// number of parallel channels of the link
+    int channels_count;
+
+    /// use of the parallel channels
+    ChannelMode channel_mode;
+
+    /// number of chunks being served (LinkModel::Event), at most one per channel if not striped
+    int busy_channels;
+
+    /// flag to indicate if chunks skip the link's queue
+    bool contention_free;
+
+    /// flag to indicate if pending chunks on the same route are transmitted together
+    bool chunk_coalescing;
+
+    /// flag to indicate if pending chunks are served round robin across input ports
+    bool source_arbitration;
+
+    /// bandwidth of the link in GB/s
+    Bandwidth bandwidth;
+
+    /// bandwidth schedule of the link (nullptr: none)
+    /// (owned by the topology the link belongs to)
+    const BandwidthSchedule* bandwidth_schedule;
+
+    /// background traffic schedule of the link (nullptr: none)
+    /// (owned by the topology the link belongs to)
+    const BackgroundSchedule* background_schedule;
+
+    /// time the current steps of the bandwidth and background traffic schedules start
+    EventTime bandwidth_step_begin;
+
+    /// time the current step of either schedule ends
+    EventTime bandwidth_step_end;
+
+    /// current step of the bandwidth schedule (-1: before the first step, at the bandwidth of the link)
+    int bandwidth_step;
+
+    /// current step of the background traffic schedule (-1: before the first step, without background traffic)
+    int background_step;
+
+    /// share of the bandwidth left to the chunks of the link (see set_bandwidth_share)
+    double bandwidth_share;
+
+    /// bandwidth of a transmission in B/ns (of a channel, or of all of them if striped),
+    /// serialization delays divide by it, so they're exact to the tick
+    Bandwidth transmission_bandwidth_Bpns;
+
+    /// latency of the link in ns
+    Latency latency;
+
+    /// latency of the link in ticks, used in actual computation
+    EventTime latency_ticks;
+
+    /// time the link finishes serializing the chunks sent so far (LinkModel::VirtualTime)
+    EventTime busy_until;
+
+    /// time the link finishes serializing the chunks being served (LinkModel::Event, reported by get_busy_until only)
+    EventTime serving_until;
+
+    /// packet size in bytes (0: chunks are transmitted as a whole)
+    ChunkSize packet_size;
+
+    /// protocol framing the transfers (nullptr: none)
+    /// (owned by the topology the link belongs to)
+    const LinkProtocol* protocol;
+
+    /// queue of pending chunks (intrusive, so enqueueing doesn't allocate)
+    /// (FIFO policy only, otherwise chunks wait in class_queues)
+    ChunkQueue pending_chunks;
+
+    /// bytes of the pending chunks, in every queue
+    ChunkSize pending_bytes;
+
+    /// order in which pending chunks are served
+    QueueingPolicy queueing_policy;
+
+    /// per-class pending chunks and round-robin state (allocated under a policy other than FIFO)
+    std::unique_ptr<ClassQueues> class_queues;
+
+    /// reserved serialization slots [start, end) by start, disjoint and not adjacent
+    /// (allocated under LinkModel::Calendar)
+    std::unique_ptr<std::map<EventTime, EventTime>> calendar;
+
+    /// buffer capacity in bytes for chunks forwarded from upstream links (0: unbounded)
+    ChunkSize buffer_capacity;
+
+    /// bytes of the buffer reserved by upstream links
+    ChunkSize buffered_bytes;
+
+    /// links of the topology, to find the next link of a chunk (nullptr if buffers are unbounded)
+    const LinkTable* link_table;
+
+    /// chunk held back until the next link's buffer has room (nullptr if none)
+    std::unique_ptr<Chunk> stalled_chunk;
+
+    /// time the stalled chunk was held back
+    EventTime stalled_since;
+
+    /// upstream links holding a chunk back until this link's buffer has room
+    std::vector<Link*> blocked_links;
+
+    /// statistics counters
+    LinkStats stats;
+
+    /**
+     * Compute the serialization delay of a chunk on the link.
+     * i.e., serialization delay = (chunk size) / (link bandwidth), plus the framing of the protocol if set
+     *
+     * @param chunk_size size of the target chunk
+     * @return serialization delay of the chunk
+     */
+    [[nodiscard]] EventTime serialization_delay(ChunkSize chunk_size) const noexcept;
+
     /**
      * Schedule the transmission of a chunk.
      * - Set the link as busy.
@@ -121,6 +817,189 @@ class Link {
      * @param chunk chunk to be transmitted
      */
     void schedule_chunk_transmission(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Callback to be called when a link blocked by backpressure may retry its stalled chunk
+     * (the next link's buffer may have room now).
+     *
+     * @param link_ptr pointer to the blocked link
+     */
+    static void retry_stalled_transmission(void* link_ptr) noexcept;
+
+    /**
+     * Compute the bandwidth of a transmission, from the bandwidth in effect and the use of the channels.
+     */
+    void update_transmission_bandwidth() noexcept;
+
+    /**
+     * Find the steps of the bandwidth and background traffic schedules in effect at the given time
+     * (binary search), and switch the link to the bandwidth they leave.
+     *
+     * @param time time to look up
+     */
+    void look_up_bandwidth_step(EventTime time) noexcept;
+
+    /**
+     * Start transmitting a chunk once the next link's buffer (if bounded) has room for it,
+     * otherwise hold it back as the stalled chunk until the next link wakes this link up.
+     * The chunk leaves this link's buffer once transmitted.
+     *
+     * @param chunk chunk to be transmitted
+     */
+    void start_transmission(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Get the link the chunk is forwarded to after this link, if its buffer is bounded.
+     *
+     * @param chunk chunk about to be transmitted
+     * @return next link with a bounded buffer, nullptr otherwise
+     */
+    [[nodiscard]] Link* next_buffered_link(const Chunk& chunk) const noexcept;
+
+    /**
+     * Schedule the transmission of a chunk in FIFO virtual time (LinkModel::VirtualTime).
+     * - Chunk starts once the link finishes the chunks ahead of it (busy_until),
+     *   or in the earliest gap of the calendar that fits it (LinkModel::Calendar).
+     * - Chunk arrives next node after the communication delay from its start.
+     * No link-free event is needed, as busy_until is advanced right away.
+     *
+     * @param chunk chunk to be transmitted
+     */
+    void schedule_virtual_time_transmission(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Find the earliest gap of the calendar fitting a chunk from the given time on (LinkModel::Calendar),
+     * first dropping the slots already over.
+     * Each slot the chunk would overlap is a lookup of the calendar, in O(log slots).
+     *
+     * @param earliest_start_time earliest time the chunk may start
+     * @param chunk chunk to transmit
+     * @param timing timings of the chunk started in the gap, filled in
+     * @return time the chunk starts
+     */
+    EventTime find_calendar_gap(EventTime earliest_start_time, const Chunk& chunk, TrainTiming& timing) noexcept;
+
+    /**
+     * Book a gap of the calendar (LinkModel::Calendar), merging the slot with its adjacent ones.
+     *
+     * @param start_time start of the slot
+     * @param end_time end of the slot, i.e., the time the link becomes free
+     */
+    void book_calendar_slot(EventTime start_time, EventTime end_time) noexcept;
+
+    /**
+     * Compute the timings of a chunk transmitted through the link.
+     * Packets are serialized back to back from the start time,
+     * except the last packet can't leave before it arrived from the previous hop.
+     * In SwitchingMode::CutThrough, the head advances after the latency,
+     * and the tail can't leave before it arrived from the previous hop.
+     *
+     * @param start_time time the link starts serializing the chunk
+     * @param chunk_size size of the chunk
+     * @param tail_arrival_time time the last packet of the chunk arrived at the link
+     * @param chunk_packet_size packet size of the chunk (see train_packet_size)
+     * @return timings of the chunk
+     */
+    [[nodiscard]] TrainTiming train_timing(EventTime start_time,
+                                           ChunkSize chunk_size,
+                                           EventTime tail_arrival_time,
+                                           ChunkSize chunk_packet_size) const noexcept;
+
+    /**
+     * Get the size of the packets a chunk is transmitted in:
+     * the packet size of the link, or the size of each chunk of a message if smaller (see Topology::send_message),
+     * so the chunks of a message are pipelined across the hops like packets.
+     *
+     * @param chunk chunk to be transmitted
+     * @return packet size in bytes (0: the chunk is transmitted as a whole)
+     */
+    [[nodiscard]] ChunkSize train_packet_size(const Chunk& chunk) const noexcept;
+
+    /**
+     * Record a transmission into the link trace, the critical path tracker, and the utilization sampler, if set.
+     *
+     * @param chunk transmitted chunk
+     * @param ready_time time the chunk reached the link
+     * @param start_time time the transmission started
+     * @param timing timings of the chunk
+     */
+    void record_transmission(Chunk& chunk,
+                             EventTime ready_time,
+                             EventTime start_time,
+                             const TrainTiming& timing) const noexcept;
+
+    /**
+     * Record the pending chunks count into the utilization sampler, if set.
+     */
+    void sample_pending_chunks() const noexcept;
+
+    /**
+     * Schedule the arrival of a transmitted chunk at the next device:
+     * at its tail arrival if the next device is its destination,
+     * otherwise at its head arrival, so it's forwarded right away.
+     * Coalesced chunks are split at their destination (see schedule_coalesced_arrivals).
+     *
+     * @param timing timings of the chunk
+     * @param chunk chunk to arrive
+     */
+    void schedule_train_arrival(const TrainTiming& timing, std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Enqueue a chunk to the pending chunks (of its class, under a policy other than FIFO).
+     *
+     * @param chunk chunk to enqueue
+     */
+    void enqueue_pending_chunk(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Enqueue the chunks of a message to the pending chunks, one by one, as other chunks contend for the link:
+     * the message goes on as its first chunk, and the later ones are taken from its chunk pool,
+     * each arrived at the link in turn from the head of the message to its tail.
+     *
+     * @param message message to enqueue (see Topology::send_message)
+     */
+    void enqueue_message_chunks(std::unique_ptr<Chunk> message) noexcept;
+
+    /**
+     * Pick the queue the next pending chunk is served from, following the queueing policy.
+     * There should be a pending chunk.
+     *
+     * @return queue to serve
+     */
+    [[nodiscard]] ChunkQueue& next_pending_queue() noexcept;
+
+    /**
+     * Get the number of pending chunks, of every class.
+     *
+     * @return number of pending chunks
+     */
+    [[nodiscard]] int pending_chunks_count() const noexcept;
+
+    /**
+     * Coalesce the pending chunks that follow the given chunk on the same route into it.
+     *
+     * @param chunk chunk about to be transmitted, just taken from the queue
+     * @param queue queue the chunk was taken from
+     */
+    void coalesce_pending_chunks(Chunk& chunk, ChunkQueue& queue) noexcept;
+
+    /**
+     * Split a coalesced chunk arriving at its destination,
+     * scheduling each chunk's arrival once its own bytes are serialized (in coalescing order).
+     *
+     * @param tail_arrival_time time the last byte of the coalesced chunk arrives
+     * @param chunk coalesced chunk
+     */
+    void schedule_coalesced_arrivals(EventTime tail_arrival_time, std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Schedule the arrival of a chunk at the next device,
+     * on the arrival mailbox if set, otherwise on the scheduler.
+     *
+     * @param chunk_arrival_time time the chunk arrives at the next device
+     * @param chunk chunk to arrive
+     */
+    void schedule_chunk_arrival(EventTime chunk_arrival_time, std::unique_ptr<Chunk> chunk) noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
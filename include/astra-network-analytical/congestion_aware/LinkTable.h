@@ -0,0 +1,547 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkScheduler.h"
+#include "common/Type.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Route.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * LinkTable holds the (directed) links of a topology, indexed by LinkId.
+ *
+ * Links are stored in blocks allocated once at their final capacity, so a link never moves once created
+ * (in-flight events point to it): a table filled by assign, or appended to within its reserved size,
+ * holds all its links in a single contiguous block, while a lazy table allocates a block per materialized page.
+ * Links are indexed through fixed-size pages, each pointing to its first link.
+ *
+ * A lazy table only knows its links by an endpoint formula:
+ * a page of links is materialized the first time one of its links is accessed,
+ * with the settings (scheduler, link model, packet size, switching mode) applied to the table so far.
+ * This keeps topologies with O(N^2) links (e.g., FullyConnected) at the footprint of the links actually used.
+ */
+class LinkTable {
+  public:
+    /// computes the (src, dest) devices of a lazy link
+    using LinkEndpoints = std::function<std::pair<DeviceId, DeviceId>(LinkId)>;
+
+    /// number of links per page (about 9 KB)
+    static constexpr int page_size = 64;
+
+    /**
+     * Iterator over the materialized links, in LinkId order.
+     */
+    template <typename LinkType>
+    class MaterializedIterator {
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Link;
+        using difference_type = std::ptrdiff_t;
+        using pointer = LinkType*;
+        using reference = LinkType&;
+
+        MaterializedIterator(const std::vector<Link*>* pages, const size_t links_count, const size_t link_id) noexcept
+            : pages(pages),
+              links_count(links_count),
+              link_id(link_id) {
+            skip_unmaterialized_pages();
+        }
+
+        reference operator*() const noexcept {
+            return (*pages)[link_id / page_size][link_id % page_size];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*pages)[link_id / page_size][link_id % page_size];
+        }
+
+        MaterializedIterator& operator++() noexcept {
+            if (++link_id % page_size == 0) {
+                skip_unmaterialized_pages();
+            }
+            return *this;
+        }
+
+        bool operator==(const MaterializedIterator& other) const noexcept {
+            return link_id == other.link_id;
+        }
+
+        bool operator!=(const MaterializedIterator& other) const noexcept {
+            return !(*this == other);
+        }
+
+      private:
+        /// first link of each page of the table
+        const std::vector<Link*>* pages;
+
+        /// number of links of the table
+        size_t links_count;
+
+        /// current link
+        size_t link_id;
+
+        /**
+         * Move to the next materialized page, if the current one isn't.
+         */
+        void skip_unmaterialized_pages() noexcept {
+            while (link_id < links_count && (*pages)[link_id / page_size] == nullptr) {
+                link_id = std::min((link_id / page_size + 1) * page_size, links_count);
+            }
+        }
+    };
+
+    using iterator = MaterializedIterator<Link>;
+    using const_iterator = MaterializedIterator<const Link>;
+
+    /**
+     * Constructor.
+     * The table starts empty, with links appended by emplace_back.
+     */
+    LinkTable() noexcept;
+
+    /**
+     * Turn the (empty) table into a lazy table of links_count links,
+     * whose endpoints are computed by the given formula, all sharing the given bandwidth and latency.
+     *
+     * @param links_count number of links
+     * @param endpoints computes the (src, dest) devices of each link id
+     * @param bandwidth bandwidth of every link
+     * @param latency latency of every link
+     */
+    void make_lazy(int links_count, LinkEndpoints endpoints, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Turn the (empty) table into a table of the same links as another table, without their state:
+     * a lazy table shares the endpoint formula (so links are still materialized on first use),
+     * other tables get a copy of every link's endpoints, bandwidth, latency, channels, and contention setting
+     * (bandwidth and background traffic schedules are copied either way).
+     * The other table is only read, so several tables may copy it concurrently.
+     *
+     * @param other table to copy the links of
+     */
+    void copy_layout(const LinkTable& other) noexcept;
+
+    /**
+     * Change the bandwidth and latency of every link of a lazy table, including the ones materialized later
+     * (overridden links included).
+     *
+     * @param bandwidth bandwidth of every link
+     * @param latency latency of every link
+     */
+    void set_lazy_parameters(Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Override the bandwidth and latency of a link, e.g., a degraded or upgraded one.
+     * A lazy table keeps the override until the link is materialized (and for the tables copying its layout),
+     * the overrides of the same bandwidth and latency sharing a single copy of them.
+     *
+     * @param link_id id of the link
+     * @param bandwidth bandwidth of the link
+     * @param latency latency of the link
+     */
+    void set_link_parameters(LinkId link_id, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Set the bandwidth schedule of a link (see Link::set_bandwidth_schedule).
+     * A lazy table keeps the schedule until the link is materialized (and for the tables copying its layout),
+     * the links of the same schedule sharing a single copy of it.
+     *
+     * @param link_id id of the link
+     * @param schedule steps of the schedule (empty: constant bandwidth)
+     */
+    void set_bandwidth_schedule(LinkId link_id, const BandwidthSchedule& schedule) noexcept;
+
+    /**
+     * Set the background traffic schedule of a link (see Link::set_background_schedule),
+     * kept and shared like bandwidth schedules.
+     *
+     * @param link_id id of the link
+     * @param schedule steps of the schedule (empty: no background traffic)
+     */
+    void set_background_schedule(LinkId link_id, const BackgroundSchedule& schedule) noexcept;
+
+    /**
+     * Check if links are materialized on first use.
+     *
+     * @return true if the table is lazy, false otherwise
+     */
+    [[nodiscard]] bool lazy() const noexcept;
+
+    /**
+     * Reserve space for the given number of appended links, in a single block
+     * (rounded up to whole pages, so that no page spans two blocks).
+     *
+     * @param links_count number of links
+     */
+    void reserve(size_t links_count) noexcept;
+
+    /**
+     * Append a link at the end of the table (non-lazy tables only).
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @param bandwidth bandwidth of the link
+     * @param latency latency of the link
+     */
+    void emplace_back(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Fill the (empty, non-lazy) table with a link per (src, dest) pair, in order, all sharing the given bandwidth
+     * and latency: the same links as appending each pair with emplace_back, but in a single block with the pages
+     * constructed concurrently, as constructing millions of links one by one dominates the startup of large topologies.
+     *
+     * @param endpoints (src, dest) devices of each link, by LinkId
+     * @param bandwidth bandwidth of every link
+     * @param latency latency of every link
+     * @param threads_count number of threads constructing the pages (0: number of hardware threads)
+     */
+    void assign(const std::vector<std::pair<DeviceId, DeviceId>>& endpoints,
+                Bandwidth bandwidth,
+                Latency latency,
+                int threads_count = 0) noexcept;
+
+    /**
+     * Get the number of links, materialized or not.
+     *
+     * @return number of links
+     */
+    [[nodiscard]] size_t size() const noexcept;
+
+    /**
+     * Get the number of materialized links.
+     *
+     * @return number of materialized links
+     */
+    [[nodiscard]] size_t materialized_size() const noexcept;
+
+    /**
+     * Check if a link is materialized, without materializing it.
+     *
+     * @param link_id id of the link
+     * @return true if the link is materialized, false otherwise
+     */
+    [[nodiscard]] bool materialized(LinkId link_id) const noexcept;
+
+    /**
+     * Get a link, materializing its page if needed.
+     *
+     * @param link_id id of the link
+     * @return link of the given id
+     */
+    [[nodiscard]] Link& operator[](LinkId link_id) const noexcept {
+        auto* page = pages[link_id / page_size];
+        if (page == nullptr) {
+            page = materialize_page(link_id / page_size);
+        }
+        return page[link_id % page_size];
+    }
+
+    /**
+     * Get the (src, dest) devices of a link, without materializing it.
+     *
+     * @param link_id id of the link
+     * @return src and dest device ids
+     */
+    [[nodiscard]] std::pair<DeviceId, DeviceId> endpoints(LinkId link_id) const noexcept;
+
+    /**
+     * Materialize every link, e.g., before assigning them settings of their own.
+     */
+    void materialize_all() noexcept;
+
+    /**
+     * Get the bytes held by the link blocks (materialized links and reserved space) and the page index.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
+
+    /**
+     * Set the scheduler of every link, including the ones materialized later.
+     *
+     * @param new_scheduler pointer to the scheduler
+     */
+    void set_scheduler(NetworkScheduler* new_scheduler) noexcept;
+
+    /**
+     * Set the transmission model of every link, including the ones materialized later.
+     *
+     * @param new_link_model transmission model
+     */
+    void set_link_model(LinkModel new_link_model) noexcept;
+
+    /**
+     * Get the transmission model of the links.
+     *
+     * @return transmission model
+     */
+    [[nodiscard]] LinkModel get_link_model() const noexcept;
+
+    /**
+     * Set the packet size of every link, including the ones materialized later.
+     *
+     * @param new_packet_size packet size in bytes
+     */
+    void set_packet_size(ChunkSize new_packet_size) noexcept;
+
+    /**
+     * Set the switching mode of every link, including the ones materialized later.
+     *
+     * @param new_switching_mode switching mode
+     */
+    void set_switching_mode(SwitchingMode new_switching_mode) noexcept;
+
+    /**
+     * Set the protocol framing the transfers on every link, including the ones materialized later
+     * (see Link::set_protocol).
+     *
+     * @param new_protocol protocol, held by the table
+     */
+    void set_protocol(const LinkProtocol& new_protocol) noexcept;
+
+    /**
+     * Set whether every link coalesces pending chunks, including the ones materialized later.
+     *
+     * @param new_chunk_coalescing true to coalesce chunks, false otherwise
+     */
+    void set_chunk_coalescing(bool new_chunk_coalescing) noexcept;
+
+    /**
+     * Set whether every link arbitrates across input ports, including the ones materialized later.
+     *
+     * @param new_source_arbitration true to arbitrate across input ports, false otherwise
+     */
+    void set_source_arbitration(bool new_source_arbitration) noexcept;
+
+    /**
+     * Set the parallel channels of every link, including the ones materialized later (see Link::set_channels).
+     *
+     * @param new_channels_count number of channels
+     * @param new_channel_mode use of the channels
+     */
+    void set_channels(int new_channels_count, ChannelMode new_channel_mode) noexcept;
+
+    /**
+     * Set the buffer capacity of every link, including the ones materialized later (see Link::set_buffer_capacity).
+     *
+     * @param new_buffer_capacity buffer capacity in bytes (0: unbounded)
+     */
+    void set_buffer_capacity(ChunkSize new_buffer_capacity) noexcept;
+
+    /**
+     * Set the queueing policy of every link, including the ones materialized later.
+     *
+     * @param new_queueing_policy queueing policy
+     * @param new_class_weights weight of each traffic class in chunks per turn
+     */
+    void set_queueing_policy(QueueingPolicy new_queueing_policy,
+                             const std::array<int, Link::max_traffic_classes>& new_class_weights) noexcept;
+
+    /**
+     * Iterate the materialized links.
+     */
+    [[nodiscard]] iterator begin() noexcept;
+    [[nodiscard]] iterator end() noexcept;
+    [[nodiscard]] const_iterator begin() const noexcept;
+    [[nodiscard]] const_iterator end() const noexcept;
+
+  private:
+    /**
+     * LinkBlock is a contiguous array of links, allocated once at a fixed capacity so its links never move.
+     */
+    class LinkBlock {
+      public:
+        /**
+         * Constructor.
+         *
+         * @param capacity number of links the block holds
+         */
+        explicit LinkBlock(size_t capacity) noexcept;
+
+        LinkBlock(const LinkBlock& other) = delete;
+        LinkBlock& operator=(const LinkBlock& other) = delete;
+        LinkBlock(LinkBlock&& other) noexcept;
+        LinkBlock& operator=(LinkBlock&& other) = delete;
+
+        /**
+         * Destructor, destroying the constructed links.
+         */
+        ~LinkBlock() noexcept;
+
+        /**
+         * Get the first link of the block.
+         *
+         * @return pointer to the first link
+         */
+        [[nodiscard]] Link* data() const noexcept;
+
+        /**
+         * Get the number of constructed links.
+         *
+         * @return number of constructed links
+         */
+        [[nodiscard]] size_t size() const noexcept;
+
+        /**
+         * Get the number of links the block holds.
+         *
+         * @return capacity of the block
+         */
+        [[nodiscard]] size_t capacity() const noexcept;
+
+        /**
+         * Construct a link at the given index, without counting it:
+         * distinct indices may be constructed concurrently, then counted by set_size.
+         *
+         * @param index index of the link in the block
+         * @param src src device id
+         * @param dest dest device id
+         * @param bandwidth bandwidth of the link
+         * @param latency latency of the link
+         * @param scheduler scheduler of the link
+         * @return constructed link
+         */
+        Link& emplace_at(size_t index,
+                         DeviceId src,
+                         DeviceId dest,
+                         Bandwidth bandwidth,
+                         Latency latency,
+                         NetworkScheduler* scheduler) noexcept;
+
+        /**
+         * Set the number of constructed links, once the links before it are constructed by emplace_at.
+         *
+         * @param new_size number of constructed links
+         */
+        void set_size(size_t new_size) noexcept;
+
+      private:
+        /// first link of the block
+        Link* links;
+
+        /// number of constructed links
+        size_t links_count;
+
+        /// number of links the block holds
+        size_t links_capacity;
+    };
+
+    /// first link of each page: lazy pages stay nullptr until materialized
+    mutable std::vector<Link*> pages;
+
+    /// blocks holding the links, each covering whole pages
+    mutable std::vector<LinkBlock> blocks;
+
+    /// number of links
+    size_t links_count;
+
+    /// number of materialized links
+    mutable size_t materialized_links_count;
+
+    /// endpoint formula of a lazy table (empty: links are appended)
+    LinkEndpoints lazy_endpoints;
+
+    /// bandwidth of the links of a lazy table
+    Bandwidth lazy_bandwidth;
+
+    /// latency of the links of a lazy table
+    Latency lazy_latency;
+
+    /// bandwidth and latency of the overridden links of a lazy table, each distinct pair stored once
+    std::vector<std::pair<Bandwidth, Latency>> override_parameters;
+
+    /// index into override_parameters of each overridden link of a lazy table
+    std::unordered_map<LinkId, int> overridden_links;
+
+    /// distinct bandwidth schedules of the links,
+    /// on the heap so links keep pointing to them when the table is moved or more are added
+    std::vector<std::unique_ptr<BandwidthSchedule>> bandwidth_schedules;
+
+    /// index into bandwidth_schedules of each scheduled link
+    std::unordered_map<LinkId, int> scheduled_links;
+
+    /// distinct background traffic schedules of the links, on the heap like bandwidth_schedules
+    std::vector<std::unique_ptr<BackgroundSchedule>> background_schedules;
+
+    /// index into background_schedules of each link with background traffic
+    std::unordered_map<LinkId, int> loaded_links;
+
+    /// scheduler given to newly created links
+    NetworkScheduler* scheduler;
+
+    /// link model given to newly created links
+    LinkModel link_model;
+
+    /// packet size given to newly created links
+    ChunkSize packet_size;
+
+    /// switching mode given to newly created links
+    SwitchingMode switching_mode;
+
+    /// protocol given to newly created links (nullptr: none),
+    /// on the heap so links keep pointing to it when the table is moved
+    std::unique_ptr<LinkProtocol> protocol;
+
+    /// chunk coalescing given to newly created links
+    bool chunk_coalescing;
+
+    /// source arbitration given to newly created links
+    bool source_arbitration;
+
+    /// number of channels given to newly created links
+    int channels_count;
+
+    /// channel mode given to newly created links
+    ChannelMode channel_mode;
+
+    /// buffer capacity given to newly created links
+    ChunkSize buffer_capacity;
+
+    /// queueing policy given to newly created links
+    QueueingPolicy queueing_policy;
+
+    /// traffic class weights given to newly created links
+    std::array<int, Link::max_traffic_classes> class_weights;
+
+    /**
+     * Apply the table-wide settings to a newly created link.
+     *
+     * @param link newly created link
+     */
+    void apply_settings(Link& link) const noexcept;
+
+    /**
+     * Set the bandwidth and background traffic schedules of the links of another table with the same links
+     * (see copy_layout).
+     *
+     * @param other table to copy the schedules of
+     */
+    void copy_bandwidth_schedules(const LinkTable& other) noexcept;
+
+    /**
+     * Materialize the links of a page of a lazy table.
+     *
+     * @param page page index
+     * @return first link of the page
+     */
+    Link* materialize_page(size_t page) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,260 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/CompressedOutput.h"
+#include "common/Type.h"
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Triggers of an armed LinkTrace (see LinkTrace::arm): a transmission fires if it matches any enabled trigger.
+ */
+struct TraceTrigger {
+    /// chunk_id of a trigger without chunk
+    static constexpr uint64_t no_chunk = std::numeric_limits<uint64_t>::max();
+
+    /// transmissions starting in [window_start, window_end) fire (empty window: none)
+    EventTime window_start = 0;
+    EventTime window_end = 0;
+
+    /// src and dest devices of the link whose queue depth fires (-1: none)
+    DeviceId link_src = -1;
+    DeviceId link_dest = -1;
+
+    /// least number of chunks queued at the link (the transmitted one included) for its transmissions to fire
+    int queue_depth_threshold = 1;
+
+    /// id of the chunk whose transmissions fire (no_chunk: none)
+    uint64_t chunk_id = no_chunk;
+};
+
+/**
+ * LinkTrace streams the link occupancy of a topology (see Topology::set_link_trace)
+ * into a Chrome JSON trace, which can be opened by Perfetto or chrome://tracing.
+ *
+ * Every transmission adds two events:
+ *   - a busy interval of the link (from transmission start until the link is free),
+ *     on the track of the link (process: src device, thread: dest device)
+ *   - the hop span of the chunk (from transmission start until the chunk fully arrived at the next device),
+ *     as an async event, since hop spans of consecutive chunks overlap.
+ *
+ * Events are buffered and appended to the trace file by a background thread once the buffer fills up,
+ * optionally gzip-compressed (see CompressedOutput), so the trace is never held in memory as a whole.
+ *
+ * An armed trace only writes the transmissions around an anomaly: until a trigger fires, the most recent
+ * transmissions are kept in a bounded ring, unformatted, so tracing a long run costs almost nothing until then.
+ */
+class LinkTrace {
+  public:
+    /**
+     * Constructor.
+     * Opens the trace file.
+     *
+     * @param trace_path path of the trace file to write
+     * @param buffer_size number of bytes buffered before being written
+     * @param compression compression of the trace file (e.g., Compression::Gzip for a .json.gz trace)
+     */
+    explicit LinkTrace(const std::string& trace_path,
+                       size_t buffer_size = 1 << 20,
+                       Compression compression = Compression::None) noexcept;
+
+    /**
+     * Destructor.
+     * Closes the trace if it's still open.
+     */
+    ~LinkTrace() noexcept;
+
+    LinkTrace(const LinkTrace&) = delete;
+    LinkTrace& operator=(const LinkTrace&) = delete;
+
+    /**
+     * Name the track of the link src -> dest.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     */
+    void name_link(DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Arm the trace: from now on, transmissions are only kept in a ring of the history_size most recent ones
+     * until a transmission fires a trigger. The ring is then written (oldest first), followed by the firing
+     * transmission and the next followup_count ones, after which the trace is armed again.
+     * Transmissions still in the ring when the trace is closed are dropped.
+     *
+     * @param trigger triggers of the trace
+     * @param history_size number of transmissions kept before a trigger fires
+     * @param followup_count number of transmissions written after a trigger fires
+     */
+    void arm(const TraceTrigger& trigger, size_t history_size, uint64_t followup_count) noexcept;
+
+    /**
+     * Record a transmission through the link src -> dest.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param chunk_src src device of the chunk
+     * @param chunk_dest dest device of the chunk
+     * @param chunk_size size of the chunk
+     * @param chunk_id id of the chunk
+     * @param queue_depth number of chunks queued at the link, the transmitted one included
+     * @param start_time time the transmission started
+     * @param link_free_time time the link got free again
+     * @param arrival_time time the chunk fully arrived at the next device
+     */
+    void record_transmission(DeviceId src,
+                             DeviceId dest,
+                             DeviceId chunk_src,
+                             DeviceId chunk_dest,
+                             ChunkSize chunk_size,
+                             uint64_t chunk_id,
+                             int queue_depth,
+                             EventTime start_time,
+                             EventTime link_free_time,
+                             EventTime arrival_time) noexcept;
+
+    /**
+     * Write the buffered events, then close the trace file.
+     */
+    void close() noexcept;
+
+    /**
+     * Get the number of transmissions recorded so far.
+     *
+     * @return number of transmissions
+     */
+    [[nodiscard]] uint64_t get_transmissions_count() const noexcept;
+
+    /**
+     * Get the number of transmissions written to the trace so far (all of them, unless armed).
+     *
+     * @return number of written transmissions
+     */
+    [[nodiscard]] uint64_t get_written_transmissions_count() const noexcept;
+
+    /**
+     * Get the number of times a trigger fired (firing transmissions written as a followup included).
+     *
+     * @return number of fired triggers
+     */
+    [[nodiscard]] uint64_t get_triggers_count() const noexcept;
+
+  private:
+    /// a recorded transmission, kept unformatted while armed
+    struct Transmission {
+        /// id of the hop span of the chunk
+        uint64_t hop_id;
+
+        /// src device of the link
+        DeviceId src;
+
+        /// dest device of the link
+        DeviceId dest;
+
+        /// src device of the chunk
+        DeviceId chunk_src;
+
+        /// dest device of the chunk
+        DeviceId chunk_dest;
+
+        /// size of the chunk
+        ChunkSize chunk_size;
+
+        /// id of the chunk
+        uint64_t chunk_id;
+
+        /// time the transmission started
+        EventTime start_time;
+
+        /// time the link got free again
+        EventTime link_free_time;
+
+        /// time the chunk fully arrived at the next device
+        EventTime arrival_time;
+    };
+
+    /// trace file, buffering the events not yet written
+    CompressedOutput trace_file;
+
+    /// number of transmissions recorded so far (also the id of the next hop span)
+    uint64_t transmissions_count;
+
+    /// true until the first event is written
+    bool first_event;
+
+    /// number of transmissions written so far
+    uint64_t written_transmissions_count;
+
+    /// true if armed (see arm)
+    bool armed;
+
+    /// triggers of the armed trace
+    TraceTrigger trigger;
+
+    /// most recent transmissions not written yet, while armed (a ring of history_size slots)
+    std::vector<Transmission> history;
+
+    /// slot of the oldest transmission of history
+    size_t history_head;
+
+    /// number of transmissions in history
+    size_t history_count;
+
+    /// number of transmissions written after a trigger fires
+    uint64_t followup_count;
+
+    /// number of transmissions still written as a followup of the last trigger
+    uint64_t remaining_followup_count;
+
+    /// number of times a trigger fired
+    uint64_t triggers_count;
+
+    /// guards the buffer, as links of concurrent partitions may transmit at once
+    std::mutex trace_mutex;
+
+    /**
+     * Append an event to the trace.
+     * trace_mutex should be held.
+     *
+     * @param event JSON object of the event
+     */
+    void append_event(const std::string& event) noexcept;
+
+    /**
+     * Check if a transmission fires a trigger of the armed trace.
+     *
+     * @param transmission recorded transmission
+     * @param queue_depth number of chunks queued at the link, the transmitted one included
+     * @return true if the transmission fires, false otherwise
+     */
+    [[nodiscard]] bool fires(const Transmission& transmission, int queue_depth) const noexcept;
+
+    /**
+     * Write the events of a transmission.
+     * trace_mutex should be held.
+     *
+     * @param transmission recorded transmission
+     */
+    void write_transmission(const Transmission& transmission) noexcept;
+
+    /**
+     * Format an event time (ns) as a trace timestamp (us).
+     *
+     * @param time event time
+     * @return timestamp in us
+     */
+    [[nodiscard]] static std::string timestamp(EventTime time) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -7,6 +7,8 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/BasicTopology.h"
+#include <cassert>
+#include <string>
 #include <utility>
 
 using namespace NetworkAnalytical;
@@ -37,6 +39,15 @@ namespace NetworkAnalyticalCongestionAware {
  * - For NPU 0 to NPU 11: 0→1→2→3→7→11 (move right, then down)
  * - Hops = Manhattan distance = |dest_x - src_x| + |dest_y - src_y|
  *
+ * Other routing policies (see set_routing):
+ * - O1Turn: each chunk takes the XY or the YX route (hashed from its chunk id),
+ *   balancing the load over both dimension orders; e.g., 0→4→8→9→10→11 for YX
+ * - WestFirst: minimal adaptive routing by the west-first turn model
+ *   - Chunks heading west move west first (deterministic)
+ *   - Otherwise, at each hop, the productive direction (east, north, or south)
+ *     whose outgoing link has the fewest queued chunks is taken (ties: X first)
+ *   - The west-first turn model never turns into west, so it's deadlock-free
+ *
  * The number of devices equals number of NPUs (no extra switch nodes).
  */
 class Mesh2D final : public BasicTopology {
@@ -69,7 +80,133 @@ class Mesh2D final : public BasicTopology {
      * @param dest destination NPU ID
      * @return sequence of devices (nodes) to traverse from src to dest
      */
-    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Get the next NPU of the XY route toward dest.
+     *
+     * @param current current NPU ID
+     * @param dest destination NPU ID
+     * @return next NPU ID (moving in X first, then in Y, unless routed by MeshRouting::WestFirst)
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology, in closed form: the Manhattan distance.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_zero_load_latency function in Topology, in closed form:
+     * the hops along each dimension times the delay of a link of that dimension.
+     */
+    [[nodiscard]] EventTime get_zero_load_latency(DeviceId src,
+                                                  DeviceId dest,
+                                                  ChunkSize chunk_size) const noexcept override;
+
+    /**
+     * Implementation of compute_metrics function in Topology, in closed form
+     * (but the bisection bandwidth of an odd highest dimension, computed by the default).
+     */
+    [[nodiscard]] TopologyMetrics compute_metrics(int threads_count = 0) const noexcept override;
+
+    /**
+     * Implementation of get_ring_order function in Topology: a ring through adjacent NPUs
+     * (a Hamiltonian cycle if the width or the height is even, see Topology::grid_ring_order).
+     */
+    [[nodiscard]] std::vector<DeviceId> get_ring_order() const noexcept override;
+
+    /**
+     * Implementation of get_link_dim function in Topology:
+     * row links belong to dimension 0, column links to dimension 1.
+     */
+    [[nodiscard]] int get_link_dim(LinkId link_id) const noexcept override;
+
+    /**
+     * Select the route of a newly sent chunk: its XY route, or with MeshRouting::O1Turn,
+     * either its XY or its YX route depending on the hash of its chunk id.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @param chunk_id id of the chunk
+     * @return route of the chunk
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+    /**
+     * Implementation of build_route_tables function in Topology.
+     */
+    void build_route_tables() const noexcept override;
+
+    /**
+     * Set the routing policy.
+     * MeshRouting::WestFirst chooses the next hop when a chunk reaches each NPU
+     * (using the occupancy of the candidate links at that time),
+     * so it enables hop-by-hop routing (see Topology::set_hop_by_hop_routing), and the other policies disable it.
+     * compute_route() keeps returning the XY route.
+     *
+     * @param new_routing routing policy
+     */
+    void set_routing(MeshRouting new_routing) noexcept;
+
+    /**
+     * Get the routing policy.
+     *
+     * @return routing policy
+     */
+    [[nodiscard]] MeshRouting get_routing() const noexcept;
+
+    /**
+     * Group the links by mesh line: "row y" for horizontal links, "column x" for vertical links.
+     *
+     * @param link_id id of the link
+     * @return name of the group of the link
+     */
+    [[nodiscard]] std::string get_link_group(LinkId link_id) const noexcept override;
+
+    /**
+     * Write the XY route from src to dest (the one compute_route returns) into a caller-provided buffer.
+     * Defined inline, so loops templated on Mesh2D (see StaticRouting.h) route without virtual calls.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @param route buffer of at least get_max_route_length() device ids
+     * @return number of devices written
+     */
+    int write_route(const DeviceId src, const DeviceId dest, DeviceId* const route) const noexcept {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+
+        auto [x, y] = get_2d_coords(src);
+        const auto [dest_x, dest_y] = get_2d_coords(dest);
+        auto length = 0;
+        route[length++] = src;
+
+        // move along X, then along Y
+        while (x != dest_x) {
+            x += (dest_x > x) ? 1 : -1;
+            route[length++] = coords_to_npu_id(x, y);
+        }
+        while (y != dest_y) {
+            y += (dest_y > y) ? 1 : -1;
+            route[length++] = coords_to_npu_id(x, y);
+        }
+        return length;
+    }
+
+    /**
+     * Get the largest number of devices of a route.
+     *
+     * @return largest number of devices of a route
+     */
+    [[nodiscard]] int get_max_route_length() const noexcept {
+        return width + height - 1;
+    }
 
   private:
     /// Width of mesh (number of columns)
@@ -78,6 +215,17 @@ class Mesh2D final : public BasicTopology {
     /// Height of mesh (number of rows)
     int height;
 
+    /// routing policy
+    MeshRouting routing;
+
+    /// YX routes taken by half of the chunks with MeshRouting::O1Turn
+    mutable RouteTable yx_routes;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
     /**
      * Convert linear NPU ID to 2D coordinates (x, y).
      *
@@ -124,6 +272,33 @@ class Mesh2D final : public BasicTopology {
      * @return Manhattan distance = |dest_x - src_x| + |dest_y - src_y|
      */
     [[nodiscard]] int manhattan_distance(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Compute route between two NPUs using YX routing (Y first, then X).
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return sequence of devices (nodes) to traverse from src to dest
+     */
+    [[nodiscard]] Route compute_yx_route(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the YX route between two NPUs, with its links resolved.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return route, valid as long as the topology
+     */
+    [[nodiscard]] const Route* yx_route(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the next NPU toward dest by minimal west-first adaptive routing.
+     *
+     * @param current current NPU ID
+     * @param dest destination NPU ID
+     * @return next NPU ID
+     */
+    [[nodiscard]] DeviceId adaptive_next_hop(DeviceId current, DeviceId dest) const noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,247 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements a 3D Mesh topology, e.g., of 3-D stacked dies:
+ * width x height 2D meshes (layers) stacked depth times,
+ * each NPU connected to the NPU right above and below it by a vertical link (e.g., a TSV or a hybrid bond),
+ * whose bandwidth and latency are set apart from the planar links.
+ *
+ * Mesh3D(3, 2, 2) example with width=3, height=2, depth=2:
+ *
+ *     layer z=0:            layer z=1:
+ *     0 --- 1 --- 2         6 --- 7 --- 8
+ *     |     |     |         |     |     |
+ *     3 --- 4 --- 5         9 --- 10--- 11
+ *
+ * and vertical links 0 <-> 6, 1 <-> 7, ..., 5 <-> 11.
+ *
+ * NPU IDs are laid out X first, then Y, then Z: id = (z * height + y) * width + x.
+ * Links are grouped in dimensions: X links in dimension 0, Y links in dimension 1, vertical links in dimension 2.
+ *
+ * Routing: dimension-order routing (X, then Y, then Z), in closed form.
+ * - For NPU 0 to NPU 11: 0→1→2→5→11
+ * - Hops = Manhattan distance = |dx| + |dy| + |dz|
+ *
+ * Like SparseMesh2D, grid cells can be excluded (e.g., defective dies, or layers smaller than the stack):
+ * valid cells are then numbered contiguously in the same order,
+ * and routes take shortest paths around the holes, preferring X, then Y, then Z (the XYZ route without holes).
+ * Each destination gets a next-hop table (BFS from the destination) on its first route.
+ *
+ * The links are built in a single pass over the grid, in locality order (see locality_order).
+ */
+class Mesh3D final : public BasicTopology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param width number of nodes in X dimension
+     * @param height number of nodes in Y dimension
+     * @param depth number of layers (Z dimension)
+     * @param bandwidth bandwidth per planar link (GB/s)
+     * @param latency latency per planar link (nanoseconds)
+     * @param vertical_bandwidth bandwidth per vertical link (GB/s)
+     * @param vertical_latency latency per vertical link (nanoseconds)
+     */
+    Mesh3D(int width,
+           int height,
+           int depth,
+           Bandwidth bandwidth,
+           Latency latency,
+           Bandwidth vertical_bandwidth,
+           Latency vertical_latency) noexcept;
+
+    /**
+     * Constructor with excluded cells.
+     *
+     * @param width number of nodes in X dimension
+     * @param height number of nodes in Y dimension
+     * @param depth number of layers (Z dimension)
+     * @param valid_cells true for each grid cell holding a node, indexed by (z * height + y) * width + x
+     * (empty: every cell holds a node)
+     * @param bandwidth bandwidth per planar link (GB/s)
+     * @param latency latency per planar link (nanoseconds)
+     * @param vertical_bandwidth bandwidth per vertical link (GB/s)
+     * @param vertical_latency latency per vertical link (nanoseconds)
+     */
+    Mesh3D(int width,
+           int height,
+           int depth,
+           const std::vector<bool>& valid_cells,
+           Bandwidth bandwidth,
+           Latency latency,
+           Bandwidth vertical_bandwidth,
+           Latency vertical_latency) noexcept;
+
+    /**
+     * Compute route between two NPUs using dimension-order (XYZ) routing.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return sequence of devices (nodes) to traverse from src to dest
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Get the next NPU of the route toward dest.
+     *
+     * @param current current NPU ID
+     * @param dest destination NPU ID
+     * @return next NPU ID
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology:
+     * the Manhattan distance in closed form, or walking the next-hop table of dest if cells are excluded.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_zero_load_latency function in Topology:
+     * the hops along each dimension times the delay of a link of that dimension.
+     */
+    [[nodiscard]] EventTime get_zero_load_latency(DeviceId src,
+                                                  DeviceId dest,
+                                                  ChunkSize chunk_size) const noexcept override;
+
+    /**
+     * Implementation of get_link_dim function in Topology:
+     * X links belong to dimension 0, Y links to dimension 1, vertical links to dimension 2.
+     */
+    [[nodiscard]] int get_link_dim(LinkId link_id) const noexcept override;
+
+    /**
+     * Group the links by grid line: "layer z row y" for X links, "layer z column x" for Y links,
+     * and "pillar x,y" for vertical links.
+     *
+     * @param link_id id of the link
+     * @return name of the group of the link
+     */
+    [[nodiscard]] std::string get_link_group(LinkId link_id) const noexcept override;
+
+    /**
+     * Get the grid coordinates of an NPU.
+     *
+     * @param npu_id NPU ID
+     * @return (x, y, z) coordinates
+     */
+    [[nodiscard]] std::array<int, 3> get_coords(DeviceId npu_id) const noexcept;
+
+    /**
+     * Get the NPU at grid coordinates.
+     *
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate (layer)
+     * @return NPU ID, -1 if outside of the grid or excluded
+     */
+    [[nodiscard]] DeviceId get_npu_at(int x, int y, int z) const noexcept;
+
+  private:
+    /// number of mesh dimensions
+    static constexpr int mesh_dims_count = 3;
+
+    /// number of nodes per dimension (X, Y, Z)
+    std::array<int, mesh_dims_count> sizes;
+
+    /// grid cell index distance between neighbors per dimension
+    std::array<int, mesh_dims_count> strides;
+
+    /// NPU ID of each grid cell (-1 if excluded), empty if no cell is excluded (the NPU ID is the cell index)
+    std::vector<DeviceId> cell_to_npu;
+
+    /// grid cell of each NPU, empty if no cell is excluded
+    std::vector<int> npu_to_cell;
+
+    /// Next-hop directions (a bit per direction one hop closer) of each NPU toward each destination,
+    /// indexed by destination then NPU ID (a table is empty until built), only if cells are excluded
+    mutable std::vector<std::vector<uint8_t>> next_hop_tables;
+
+    /// Guards building each next-hop table once, as routes may be computed concurrently
+    std::unique_ptr<std::once_flag[]> next_hop_tables_built;
+
+    /**
+     * Count the valid cells of a grid, checking the bitmap covers it.
+     *
+     * @param width number of nodes in X dimension
+     * @param height number of nodes in Y dimension
+     * @param depth number of layers
+     * @param valid_cells true for each grid cell holding a node (empty: every cell holds a node)
+     * @return number of valid cells
+     */
+    [[nodiscard]] static int count_valid_cells(int width,
+                                               int height,
+                                               int depth,
+                                               const std::vector<bool>& valid_cells) noexcept;
+
+    /**
+     * Get the grid cell of an NPU.
+     *
+     * @param npu_id NPU ID
+     * @return grid cell index
+     */
+    [[nodiscard]] int cell_of(const DeviceId npu_id) const noexcept {
+        return npu_to_cell.empty() ? npu_id : npu_to_cell[npu_id];
+    }
+
+    /**
+     * Get the coordinate of a grid cell along a dimension.
+     *
+     * @param cell grid cell index
+     * @param dim dimension
+     * @return coordinate along dim
+     */
+    [[nodiscard]] int coordinate(const int cell, const int dim) const noexcept {
+        return (cell / strides[dim]) % sizes[dim];
+    }
+
+    /**
+     * Get the neighbor of an NPU in a direction (+X, -X, +Y, -Y, +Z, -Z).
+     *
+     * @param npu_id NPU ID
+     * @param direction direction, 2 * dim for the positive one and 2 * dim + 1 for the negative one
+     * @return neighbor NPU ID, -1 if outside of the grid or excluded
+     */
+    [[nodiscard]] DeviceId neighbor(DeviceId npu_id, int direction) const noexcept;
+
+    /**
+     * Count the hops of the route along each dimension.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return hops along X, Y, and Z
+     */
+    [[nodiscard]] std::array<int, mesh_dims_count> count_hops(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the next-hop table of a destination, building it on first use (only if cells are excluded).
+     * Entry i holds a bit per direction NPU i may move in toward the destination (0 if unreachable).
+     */
+    [[nodiscard]] const std::vector<uint8_t>& next_hop_table(DeviceId dest) const noexcept;
+
+    /**
+     * Build the next-hop table of a destination: BFS from the destination,
+     * then every NPU may move to any neighbor one hop closer.
+     */
+    void build_next_hop_table(DeviceId dest) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
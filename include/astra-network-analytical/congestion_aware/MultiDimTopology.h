@@ -0,0 +1,138 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include "congestion_aware/Topology.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * MultiDimTopology implements multi-dimensional network topologies
+ * which can be constructed by stacking up multiple BasicTopology instances.
+ *
+ * Every dimension is replicated once per combination of the other dimensions' coordinates,
+ * so that each NPU participates in exactly one instance (slice) of every dimension.
+ * e.g., for [Ring(2), Switch(4)], NPUs {0, 1}, {2, 3}, {4, 5}, {6, 7} form rings,
+ * and NPUs {0, 2, 4, 6}, {1, 3, 5, 7} are connected to one switch each.
+ *
+ * Device ids: NPUs come first (0 ~ npus_count-1) with the same numbering as the congestion_unaware backend,
+ * followed by the non-NPU devices (e.g., switches) of each dimension, slice by slice.
+ *
+ * Chunks are routed in dimension order:
+ * the lowest dimension in which src and dest differ is traversed first.
+ *
+ * Each dimension is simulated at its own fidelity (see DimFidelity).
+ * A ClosedForm dimension (e.g., a rarely contended FullyConnected) drops its non-NPU devices
+ * and connects every NPU pair of a slice with a contention-free link,
+ * whose latency and bandwidth are those of the BasicTopology route between them:
+ * a chunk crosses the dimension with a single event, at the congestion_unaware delay,
+ * while only the CongestionAware dimensions' hops queue at links.
+ */
+class MultiDimTopology final : public Topology {
+  public:
+    /// maximum number of network dimensions
+    static constexpr int max_dims_count = 8;
+
+    /**
+     * Constructor.
+     *
+     * @param topology_per_dim BasicTopology of each dimension, starting from the lowest dimension
+     * @param fidelity_per_dim fidelity of each dimension (empty: every dimension is CongestionAware)
+     */
+    explicit MultiDimTopology(std::vector<std::unique_ptr<BasicTopology>> topology_per_dim,
+                              std::vector<DimFidelity> fidelity_per_dim = {}) noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_link_dim function in Topology.
+     */
+    [[nodiscard]] int get_link_dim(LinkId link_id) const noexcept override;
+
+    /**
+     * Get the fidelity of a dimension.
+     *
+     * @param dim dimension
+     * @return fidelity of the dimension
+     */
+    [[nodiscard]] DimFidelity get_dim_fidelity(int dim) const noexcept;
+
+  private:
+    /// BasicTopology instances per dimension,
+    /// used as the template of every slice of the dimension
+    std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
+
+    /// fidelity of each dimension
+    std::vector<DimFidelity> fidelity_per_dim;
+
+    /// NPU ID stride of each dimension
+    /// e.g., if the topology size is [2, 8, 4], the strides are [1, 2, 16].
+    std::vector<int> stride_per_dim;
+
+    /// number of non-NPU devices in one slice of each dimension
+    std::vector<int> extra_devices_count_per_dim;
+
+    /// id of the first non-NPU device of each dimension
+    std::vector<DeviceId> extra_devices_offset_per_dim;
+
+    /// id of the first link of each dimension (links are connected dimension by dimension)
+    std::vector<LinkId> links_offset_per_dim;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology,
+     * including the routes cached by the BasicTopology of each dimension.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
+    /**
+     * Get the slice of the given dimension the NPU belongs to.
+     *
+     * @param dim dimension
+     * @param npu_id NPU id
+     * @return slice id, in [0, npus_count / npus_count_per_dim[dim])
+     */
+    [[nodiscard]] int slice_id(int dim, DeviceId npu_id) const noexcept;
+
+    /**
+     * Translate a device id of a dimension's BasicTopology into the device id of this topology.
+     *
+     * @param dim dimension
+     * @param slice_id slice of the dimension
+     * @param local_id device id inside the dimension's BasicTopology
+     * @return device id in this topology
+     */
+    [[nodiscard]] DeviceId global_device_id(int dim, int slice_id, DeviceId local_id) const noexcept;
+
+    /**
+     * Count the links of all slices of all dimensions.
+     *
+     * @return number of links in the topology
+     */
+    [[nodiscard]] int expected_links_count() const noexcept;
+
+    /**
+     * Replicate the links of every dimension's BasicTopology into every slice.
+     */
+    void connect_slices() noexcept;
+
+    /**
+     * Connect every NPU pair of every slice of a ClosedForm dimension with a contention-free link.
+     *
+     * @param dim dimension
+     */
+    void connect_closed_form_slices(int dim) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,158 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include <cstdint>
+#include <unordered_map>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements a multi-rail topology: every NPU owns one NIC per rail,
+ * and the NICs of each rail are connected to a switch of their own (a rail plane).
+ *
+ * MultiRail(4, 2) example (4 NPUs, 2 rails):
+ *
+ *        <--- rail switch 12 --->          <--- rail switch 13 --->
+ *         |     |     |     |               |     |     |     |
+ *         4     6     8     10              5     7     9     11     (NICs)
+ *         |     |     |     |               |     |     |     |
+ *         0     1     2     3               0     1     2     3      (NPUs)
+ *
+ * Device IDs: NPUs first, then the NICs (NIC r of NPU i is npus_count + i * rails_count + r),
+ * then the rail switches.
+ *
+ * A chunk stays on a single rail: src -> src's NIC -> rail switch -> dest's NIC -> dest (4 hops).
+ * Routing (see set_routing):
+ *   - Hashed: the chunks of an NPU pair share a rail, hashed from the pair
+ *   - Sprayed: consecutive chunks take the rails in turn (by chunk id), spreading a pair over every rail
+ */
+class MultiRail final : public BasicTopology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs
+     * @param rails_count number of rails (NICs per NPU)
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    MultiRail(int npus_count, int rails_count, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology (through the hashed rail).
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology (through the hashed rail).
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of select_route function in Topology.
+     * Sprayed routing sends consecutive chunks of a pair through different rails.
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+    /**
+     * Implementation of build_route_tables function in Topology.
+     */
+    void build_route_tables() const noexcept override;
+
+    /**
+     * Set the routing policy.
+     *
+     * @param new_routing routing policy
+     */
+    void set_routing(RailRouting new_routing) noexcept;
+
+    /**
+     * Get the routing policy.
+     *
+     * @return routing policy
+     */
+    [[nodiscard]] RailRouting get_routing() const noexcept;
+
+    /**
+     * Get the number of rails.
+     *
+     * @return number of rails
+     */
+    [[nodiscard]] int get_rails_count() const noexcept;
+
+    /**
+     * Get the NIC of an NPU on a rail.
+     *
+     * @param npu_id NPU ID
+     * @param rail rail index
+     * @return device ID of the NIC
+     */
+    [[nodiscard]] DeviceId get_nic(DeviceId npu_id, int rail) const noexcept;
+
+    /**
+     * Get the switch of a rail.
+     *
+     * @param rail rail index
+     * @return device ID of the rail switch
+     */
+    [[nodiscard]] DeviceId get_rail_switch(int rail) const noexcept;
+
+    /**
+     * Get the rail the chunks of an NPU pair take under Hashed routing.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return rail index
+     */
+    [[nodiscard]] int hashed_rail(DeviceId src, DeviceId dest) const noexcept;
+
+  private:
+    /// number of rails
+    int rails_count;
+
+    /// routing policy
+    RailRouting routing;
+
+    /// routes through rails other than the hashed one, interned per (src, dest, rail), only for the triples chunks took
+    mutable std::unordered_map<uint64_t, Route> rail_routes;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
+    /**
+     * Compute the route from src to dest through a rail.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param rail rail index
+     * @return route from src to dest
+     */
+    [[nodiscard]] Route compute_rail_route(DeviceId src, DeviceId dest, int rail) const noexcept;
+
+    /**
+     * Get the route from src to dest through a rail other than the hashed one, with its links resolved.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param rail rail index
+     * @return route, valid as long as the topology
+     */
+    [[nodiscard]] const Route* rail_route(DeviceId src, DeviceId dest, int rail) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
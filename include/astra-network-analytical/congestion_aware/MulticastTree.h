@@ -0,0 +1,141 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Route.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * MulticastTree is the tree a multicast chunk follows from its src to its dests (see Topology::multicast).
+ *
+ * Node 0 is the src device; every other node is a device reached through a single tree edge
+ * (i.e., a link from its parent's device), which a multicast chunk crosses once,
+ * forking at devices with several children.
+ * Each edge holds the one-hop route (with its link id) the chunks crossing it share.
+ */
+class MulticastTree {
+  public:
+    /// node of the src device
+    static constexpr int root = 0;
+
+    /**
+     * Constructor.
+     *
+     * @param src src device id
+     */
+    explicit MulticastTree(DeviceId src) noexcept;
+
+    /**
+     * Merge a route from the src into the tree, marking its last device as a dest.
+     * Devices already in the tree keep their parent, so the route joins the tree at its last such device.
+     *
+     * @param route route from the src, with its link ids resolved
+     */
+    void add_route(const Route& route) noexcept;
+
+    /**
+     * Get the src device.
+     *
+     * @return src device id
+     */
+    [[nodiscard]] DeviceId get_src() const noexcept;
+
+    /**
+     * Get the number of nodes (devices) of the tree.
+     *
+     * @return number of nodes
+     */
+    [[nodiscard]] int get_nodes_count() const noexcept;
+
+    /**
+     * Get the number of edges of the tree, i.e., the number of link transmissions of a multicast chunk.
+     *
+     * @return number of edges
+     */
+    [[nodiscard]] int get_edges_count() const noexcept;
+
+    /**
+     * Get the number of dests of the tree.
+     *
+     * @return number of dests
+     */
+    [[nodiscard]] int get_dests_count() const noexcept;
+
+    /**
+     * Get the device of a node.
+     *
+     * @param node node index
+     * @return device id
+     */
+    [[nodiscard]] DeviceId get_device(int node) const noexcept;
+
+    /**
+     * Check if a node is a dest.
+     *
+     * @param node node index
+     * @return true if the node is a dest, false otherwise
+     */
+    [[nodiscard]] bool is_dest(int node) const noexcept;
+
+    /**
+     * Get the children of a node.
+     *
+     * @param node node index
+     * @return node indices of the children
+     */
+    [[nodiscard]] const std::vector<int>& get_children(int node) const noexcept;
+
+    /**
+     * Get the route of the edge from a node's parent to the node.
+     *
+     * @param node node index, other than the root
+     * @return one-hop route of the edge
+     */
+    [[nodiscard]] const Route& get_edge_route(int node) const noexcept;
+
+    /**
+     * Get the bytes held by the tree.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
+
+  private:
+    /**
+     * Node of the tree.
+     */
+    struct Node {
+        /// device of the node
+        DeviceId device;
+
+        /// true if the device is a dest
+        bool dest;
+
+        /// one-hop route from the parent's device (empty for the root)
+        Route edge_route;
+
+        /// node indices of the children
+        std::vector<int> children;
+    };
+
+    /// nodes of the tree, the root first
+    std::vector<Node> nodes;
+
+    /// node index of each device in the tree
+    std::unordered_map<DeviceId, int> node_per_device;
+
+    /// number of dests
+    int dests_count;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,117 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkScheduler.h"
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/ChunkQueue.h"
+#include "congestion_aware/Type.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * NicModel meters how fast each NPU injects chunks into the network (see Topology::set_nic_model).
+ *
+ * Each NPU's NIC keeps at most max_outstanding_chunks chunks in flight (injected but not delivered yet):
+ * further chunks wait at the NIC, in order, until an outstanding chunk is delivered.
+ * An admitted chunk is moved by the DMA engine that frees up first,
+ * each engine moving a chunk at a time at injection_bandwidth / dma_engines_count,
+ * and enters the network (its first link) once moved.
+ */
+class NicModel {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs
+     * @param injection_bandwidth injection bandwidth of each NIC in GB/s (0: unlimited)
+     * @param max_outstanding_chunks largest number of chunks in flight per NPU (0: unlimited)
+     * @param dma_engines_count number of DMA engines of each NIC
+     */
+    NicModel(int npus_count,
+             Bandwidth injection_bandwidth,
+             int max_outstanding_chunks,
+             int dma_engines_count) noexcept;
+
+    /**
+     * Callback invoked when a chunk is moved by its DMA engine: sends it into the network.
+     *
+     * @param chunk_ptr pointer to the chunk
+     */
+    static void chunk_injected(void* chunk_ptr) noexcept;
+
+    /**
+     * Inject a chunk through the NIC of its src NPU.
+     * The chunk enters the network through its topology once admitted and moved.
+     *
+     * @param chunk chunk to inject, whose topology is set
+     * @param scheduler scheduler of the topology
+     */
+    void inject(std::unique_ptr<Chunk> chunk, NetworkScheduler& scheduler) noexcept;
+
+    /**
+     * Release the outstanding slot of a delivered chunk, admitting the next chunk waiting at the NIC.
+     *
+     * @param src src NPU of the delivered chunk
+     * @param scheduler scheduler of the topology
+     */
+    void release(DeviceId src, NetworkScheduler& scheduler) noexcept;
+
+    /**
+     * Get the number of chunks in flight from an NPU.
+     *
+     * @param npu NPU id
+     * @return number of outstanding chunks
+     */
+    [[nodiscard]] int get_outstanding_chunks_count(DeviceId npu) const noexcept;
+
+    /**
+     * Get the number of chunks waiting at an NPU's NIC to be admitted.
+     *
+     * @param npu NPU id
+     * @return number of waiting chunks
+     */
+    [[nodiscard]] int get_waiting_chunks_count(DeviceId npu) const noexcept;
+
+    /**
+     * Drop the waiting chunks and reset every NIC, e.g., when the topology is reset.
+     */
+    void reset() noexcept;
+
+  private:
+    /// largest number of chunks in flight per NPU (0: unlimited)
+    int max_outstanding_chunks;
+
+    /// number of DMA engines of each NIC
+    int dma_engines_count;
+
+    /// time a DMA engine takes to move a byte, in ticks (0: unlimited bandwidth)
+    double engine_ticks_per_byte;
+
+    /// number of chunks in flight from each NPU
+    std::vector<int> outstanding_chunks_counts;
+
+    /// chunks waiting at each NPU's NIC to be admitted
+    std::vector<ChunkQueue> waiting_chunks;
+
+    /// time each DMA engine gets free, dma_engines_count per NPU
+    std::vector<EventTime> engine_free_times;
+
+    /**
+     * Move an admitted chunk by the DMA engine of its NIC that frees up first.
+     *
+     * @param chunk admitted chunk
+     * @param scheduler scheduler of the topology
+     */
+    void start_dma(std::unique_ptr<Chunk> chunk, NetworkScheduler& scheduler) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,238 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements NPUs connected through a reconfigurable optical circuit switch (OCS),
+ * whose circuits (direct NPU -> NPU links) change at runtime.
+ *
+ * Each NPU has ports_count ports, so at most ports_count circuits leave and enter it at once.
+ * Every NPU pair may be connected, so links are materialized once used, as in FullyConnected;
+ * the links that aren't circuits of the current configuration are dark, i.e., failed (see Topology::set_link_failed).
+ *
+ * A reconfiguration tears down the circuits leaving the configuration at once
+ * (the chunks waiting for them are rerouted over the remaining circuits),
+ * and lights up the new circuits after the reconfiguration delay (the blackout).
+ * Chunks follow shortest routes (in hops) over the lit circuits, breaking ties toward the lowest NPU id:
+ * next-hop tables are repaired in place, only for the destinations whose routes the change affects,
+ * and the routes of chunks sent afterwards toward those destinations are recomputed.
+ * Chunks unable to reach their destination meanwhile (e.g., during the blackout) wait at their current NPU
+ * for the circuits to light up.
+ *
+ * Every NPU pair is tracked as a link, so this suits the radix of optical switches (up to a few hundred ports).
+ */
+class OpticalCircuitSwitch final : public Topology {
+  public:
+    /// circuit: a (src, dest) NPU pair
+    using Circuit = std::pair<DeviceId, DeviceId>;
+
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs
+     * @param ports_count number of ports of each NPU
+     * @param bandwidth bandwidth of each circuit
+     * @param latency latency of each circuit
+     * @param reconfiguration_delay time new circuits take to light up (ns)
+     * @param circuits initial circuits
+     */
+    OpticalCircuitSwitch(int npus_count,
+                         int ports_count,
+                         Bandwidth bandwidth,
+                         Latency latency,
+                         Latency reconfiguration_delay,
+                         const std::vector<Circuit>& circuits) noexcept;
+
+    /**
+     * Reconfigure the circuits from the current time on:
+     * the circuits not in the new configuration are torn down at once, and the new ones light up
+     * after the reconfiguration delay. A reconfiguration shouldn't start before the previous one is done.
+     *
+     * @param circuits circuits of the new configuration
+     */
+    void reconfigure(const std::vector<Circuit>& circuits) noexcept;
+
+    /**
+     * Reconfigure the circuits at a simulated time (see reconfigure).
+     *
+     * @param time time of the reconfiguration, not before the current time
+     * @param circuits circuits of the new configuration
+     */
+    void schedule_reconfiguration(EventTime time, std::vector<Circuit> circuits) noexcept;
+
+    /**
+     * Get the circuits of the configuration, lit or lighting up.
+     *
+     * @return circuits, sorted
+     */
+    [[nodiscard]] const std::vector<Circuit>& get_circuits() const noexcept;
+
+    /**
+     * Check if a reconfiguration is in progress, i.e., new circuits are lighting up.
+     *
+     * @return true during the blackout of a reconfiguration, false otherwise
+     */
+    [[nodiscard]] bool is_reconfiguring() const noexcept;
+
+    /**
+     * Get the number of reconfigurations started so far.
+     *
+     * @return number of reconfigurations
+     */
+    [[nodiscard]] int get_reconfigurations_count() const noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology: the shortest route over the lit circuits,
+     * or the direct (dark) link if dest can't be reached, the chunk then waiting for the circuits to light up.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of find_link function in Topology.
+     */
+    [[nodiscard]] LinkId find_link(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of select_route function in Topology:
+     * the shared route of the pair, recomputed once the routes toward dest changed.
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+  private:
+    /**
+     * Route of an NPU pair, with the version of the routes toward dest it was computed at.
+     */
+    struct VersionedRoute {
+        /// route (nullptr until computed)
+        std::unique_ptr<Route> route;
+
+        /// version of the routes toward dest
+        uint32_t version = 0;
+    };
+
+    /**
+     * Reconfiguration scheduled at a simulated time.
+     */
+    struct ScheduledReconfiguration {
+        /// time of the reconfiguration
+        EventTime time;
+
+        /// circuits of the new configuration
+        std::vector<Circuit> circuits;
+    };
+
+    /// number of ports of each NPU
+    int ports_count;
+
+    /// time new circuits take to light up, in ticks
+    EventTime reconfiguration_delay;
+
+    /// circuits of the configuration, sorted
+    std::vector<Circuit> circuits;
+
+    /// circuits lighting up at the end of the reconfiguration in progress
+    std::vector<Circuit> lighting_circuits;
+
+    /// true during the blackout of a reconfiguration
+    bool reconfiguring;
+
+    /// number of reconfigurations started so far
+    int reconfigurations_count;
+
+    /// srcs of the lit circuits entering each NPU, sorted
+    std::vector<std::vector<DeviceId>> incoming_circuits;
+
+    /// NPU each NPU moves to next toward each destination NPU (-1 if none), indexed by dest * npus_count + device
+    std::vector<DeviceId> next_hops;
+
+    /// version of the routes toward each destination NPU, bumped whenever its next-hop table changes
+    std::vector<uint32_t> route_versions;
+
+    /// route of each NPU pair, rows allocated on the first route from their src
+    mutable std::vector<std::unique_ptr<VersionedRoute[]>> versioned_routes;
+
+    /// outdated routes, kept as chunks in flight may still follow them
+    mutable std::vector<std::unique_ptr<Route>> retired_routes;
+
+    /// reconfigurations scheduled but not started yet, in the order scheduled
+    std::vector<ScheduledReconfiguration> scheduled_reconfigurations;
+
+    /**
+     * Check a configuration fits the ports of the NPUs, exiting otherwise.
+     *
+     * @param circuits circuits of the configuration, sorted
+     */
+    void check_circuits(const std::vector<Circuit>& circuits) const noexcept;
+
+    /**
+     * Compute the next-hop table toward dest over the lit circuits, by a breadth-first search from dest.
+     *
+     * @param dest dest NPU id
+     */
+    void compute_next_hops(DeviceId dest) noexcept;
+
+    /**
+     * Light up the circuits of the reconfiguration in progress, ending its blackout.
+     */
+    void light_up_circuits() noexcept;
+
+    /**
+     * Event: the blackout of the reconfiguration in progress ends.
+     *
+     * @param topology_ptr pointer to the OpticalCircuitSwitch
+     */
+    static void reconfiguration_done(void* topology_ptr) noexcept;
+
+    /**
+     * Event: start the reconfigurations scheduled up to the current time.
+     *
+     * @param topology_ptr pointer to the OpticalCircuitSwitch
+     */
+    static void apply_scheduled_reconfigurations(void* topology_ptr) noexcept;
+
+    /**
+     * Implementation of links_restoring function in Topology: circuits light up at the end of a reconfiguration.
+     */
+    [[nodiscard]] bool links_restoring() const noexcept override;
+
+    /**
+     * Implementation of repair_routes function in Topology, repairing the next-hop tables in place.
+     */
+    void repair_routes(const std::vector<LinkId>& changed_link_ids, bool failed) noexcept override;
+
+    /**
+     * Implementation of live_next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId live_next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
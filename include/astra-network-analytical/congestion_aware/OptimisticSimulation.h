@@ -0,0 +1,332 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "common/WorkStealingExecutor.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * OptimisticSimulation runs chunks over a single topology as an optimistic (Time Warp) parallel simulation.
+ *
+ * Devices are split into partitions as in ParallelSimulation, a link belonging to the partition of its src.
+ * Unlike ParallelSimulation, partitions don't wait for each other within a lookahead window:
+ * each processes its events in timestamp order as far as it can,
+ * saving the state of the link it updates (the time the link gets free) along with every event.
+ * A chunk arriving from another partition earlier than events already processed (a straggler)
+ * rolls the partition back: the later events are undone, restoring their links,
+ * and the chunks they sent to other partitions are cancelled by anti-messages (possibly rolling those back too).
+ * Partitions synchronize in rounds, after which the global virtual time (GVT),
+ * the earliest time still pending or in transit, is computed:
+ * events before the GVT can't be rolled back anymore, so they are committed and their saved state freed
+ * (fossil collection).
+ * Zero-latency links may cross partitions, so fine-grained networks (e.g., on-chip meshes) still run in parallel.
+ *
+ * Events are ordered by (time, chunk id, hop), so results are identical whatever the partitioning.
+ * Links serve their chunks in that order (FIFO), store-and-forward,
+ * at the bandwidth and latency of the topology's links:
+ * queueing policies, channels, packetization, buffers, bandwidth schedules and switch models aren't simulated.
+ * Chunks take the shared route of their (src, dest) pair.
+ *
+ * Callbacks of arrived chunks are invoked once committed, in timestamp order, on the thread calling run().
+ * They may call send() from any device.
+ */
+class OptimisticSimulation {
+  public:
+    /**
+     * Constructor, partitioning the devices automatically (see ParallelSimulation::partition_devices).
+     *
+     * @param topology topology to simulate
+     * @param partitions_count number of partitions
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     */
+    OptimisticSimulation(std::shared_ptr<Topology> topology, int partitions_count, int threads_count = 0) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param topology topology to simulate
+     * @param partition_per_device partition id of each device, in [0, partitions count)
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     */
+    OptimisticSimulation(std::shared_ptr<Topology> topology,
+                         std::vector<int> partition_per_device,
+                         int threads_count = 0) noexcept;
+
+    /**
+     * Send a chunk from src to dest at the current time.
+     * Called before run(), or from a callback.
+     *
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param callback_arg argument of the callback
+     */
+    void send(ChunkSize chunk_size, DeviceId src, DeviceId dest, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Set the number of events a partition processes per round.
+     * Larger batches synchronize less often, but let partitions run further ahead (more rollbacks).
+     *
+     * @param new_batch_size number of events per round (default 1024)
+     */
+    void set_batch_size(int new_batch_size) noexcept;
+
+    /**
+     * Bound how far past the GVT partitions process events, throttling optimism.
+     *
+     * @param new_optimism_window window in ticks (default: unbounded)
+     */
+    void set_optimism_window(EventTime new_optimism_window) noexcept;
+
+    /**
+     * Run the simulation until no event is left.
+     *
+     * @return time the simulation finished
+     */
+    EventTime run() noexcept;
+
+    /**
+     * Get the current time: the time of the committed event being handled inside a callback,
+     * otherwise of the last committed event.
+     *
+     * @return current time
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Get the number of partitions.
+     *
+     * @return number of partitions
+     */
+    [[nodiscard]] int get_partitions_count() const noexcept;
+
+    /**
+     * Get the number of rounds processed so far.
+     *
+     * @return number of rounds
+     */
+    [[nodiscard]] int64_t get_rounds_count() const noexcept;
+
+    /**
+     * Get the number of events committed so far (every hop and every arrival of a chunk).
+     *
+     * @return number of committed events
+     */
+    [[nodiscard]] int64_t get_committed_events_count() const noexcept;
+
+    /**
+     * Get the number of rollbacks so far.
+     *
+     * @return number of rollbacks
+     */
+    [[nodiscard]] int64_t get_rollbacks_count() const noexcept;
+
+    /**
+     * Get the number of events undone by rollbacks so far.
+     *
+     * @return number of rolled back events
+     */
+    [[nodiscard]] int64_t get_rolled_back_events_count() const noexcept;
+
+  private:
+    /// event: a chunk reaches the device at the given hop of its route (delivered at its last hop)
+    struct Event {
+        /// time of the event
+        EventTime time;
+
+        /// index of the chunk
+        int chunk;
+
+        /// index of the device in the route of the chunk
+        int hop;
+
+        /**
+         * Order events by (time, chunk, hop).
+         *
+         * @param other event to compare with
+         * @return true if this event comes first
+         */
+        [[nodiscard]] bool operator<(const Event& other) const noexcept;
+    };
+
+    /// event sent to another partition, or cancelled (anti-message)
+    struct Message {
+        /// event sent or cancelled
+        Event event;
+
+        /// true to cancel the event, false to send it
+        bool anti;
+    };
+
+    /// processed event, with the state it overwrote
+    struct ProcessedEvent {
+        /// processed event
+        Event event;
+
+        /// time the link of the hop got free before the event (hops only)
+        EventTime saved_link_free_time;
+
+        /// event sent to the next hop, and its partition (-1 for an arrival)
+        Event sent_event;
+        int sent_partition;
+    };
+
+    /// link crossed by a chunk
+    struct ChunkHop {
+        /// id of the link
+        LinkId link_id;
+
+        /// partition of the link
+        int partition;
+
+        /// serialization delay of the chunk and latency of the link, in ticks
+        EventTime serialization_delay;
+        EventTime latency;
+    };
+
+    /// chunk, immutable while partitions run
+    struct OptimisticChunk {
+        /// links crossed, in route order
+        std::vector<ChunkHop> hops;
+
+        /// partition of the dest device
+        int dest_partition;
+
+        /// callback invoked when the chunk arrives
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+    };
+
+    /// state of a partition
+    struct Partition {
+        /// events to process, in order
+        std::set<Event> pending_events;
+
+        /// events processed but not committed yet, in order
+        std::deque<ProcessedEvent> processed_events;
+
+        /// messages received from other partitions, to apply at the next round
+        std::vector<Message> inbox;
+
+        /// number of rollbacks and of events they undid
+        int64_t rollbacks_count;
+        int64_t rolled_back_events_count;
+    };
+
+    /// topology being simulated
+    std::shared_ptr<Topology> topology;
+
+    /// partition id of each device
+    std::vector<int> partition_per_device;
+
+    /// number of partitions
+    int partitions_count;
+
+    /// state of each partition
+    std::vector<Partition> partitions;
+
+    /// messages posted during a round, indexed by (src partition * partitions_count + dest partition)
+    std::vector<std::vector<Message>> outboxes;
+
+    /// time each link gets free, only touched by the partition of the link
+    std::vector<EventTime> link_free_times;
+
+    /// every chunk sent (references stay valid as the deque grows)
+    std::deque<OptimisticChunk> chunks;
+
+    /// number of events a partition processes per round
+    int batch_size;
+
+    /// how far past the GVT partitions process events
+    EventTime optimism_window;
+
+    /// time of the last committed event
+    EventTime current_time;
+
+    /// true once a callback sent a chunk while committing
+    bool chunk_injected;
+
+    /// runs the partitions of a round
+    WorkStealingExecutor executor;
+
+    /// number of rounds processed so far
+    int64_t rounds_count;
+
+    /// number of events committed so far
+    int64_t committed_events_count;
+
+    /**
+     * Get the partition processing an event.
+     *
+     * @param event event
+     * @return partition of the event
+     */
+    [[nodiscard]] int event_partition(const Event& event) const noexcept;
+
+    /**
+     * Post a message from one partition to another (or to itself, inserting the event right away).
+     *
+     * @param src_partition sending partition
+     * @param dest_partition receiving partition
+     * @param message message to post
+     */
+    void post(int src_partition, int dest_partition, const Message& message) noexcept;
+
+    /**
+     * Process the next events of a partition in a round.
+     *
+     * @param partition_id partition to run
+     * @param window_end events from this time on wait for the next rounds
+     */
+    void run_partition(int partition_id, EventTime window_end) noexcept;
+
+    /**
+     * Process an event: serialize the chunk on the link of its hop and send it to the next hop.
+     *
+     * @param partition_id partition of the event
+     * @param event event to process
+     */
+    void process(int partition_id, const Event& event) noexcept;
+
+    /**
+     * Undo the processed events of a partition coming after the given event (or from it, if inclusive).
+     *
+     * @param partition_id partition to roll back
+     * @param event event to roll back to
+     * @param inclusive true to undo the event itself as well
+     */
+    void rollback(int partition_id, const Event& event, bool inclusive) noexcept;
+
+    /**
+     * Compute the GVT: the earliest time pending in a partition or in transit.
+     *
+     * @return GVT, the largest EventTime if no event is left
+     */
+    [[nodiscard]] EventTime compute_gvt() const noexcept;
+
+    /**
+     * Commit the processed events before the GVT in timestamp order, invoking the callbacks of arrived chunks.
+     * A callback sending a chunk stops the commit at its time, as the new chunk may roll back later events.
+     *
+     * @param gvt GVT
+     */
+    void commit(EventTime gvt) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
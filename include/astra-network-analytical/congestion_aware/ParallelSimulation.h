@@ -0,0 +1,193 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventMailbox.h"
+#include "common/EventQueue.h"
+#include "common/Type.h"
+#include "common/WorkStealingExecutor.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * ParallelSimulation runs a single topology as a conservative parallel discrete-event simulation.
+ *
+ * Devices are split into partitions, each driven by its own event queue.
+ * A link belongs to the partition of its src device;
+ * chunk arrivals crossing partitions are posted to mailboxes.
+ * Partitions proceed in lock-step windows of `lookahead` ns,
+ * the smallest latency among the links crossing partitions:
+ * an event processed inside a window can only affect another partition after the window,
+ * so the partitions of a window run concurrently without rollback.
+ *
+ * Same-time events run in the deterministic order by default (see set_deterministic_order),
+ * so every chunk is delivered at the same time as by a sequential run in that order, whatever the partitioning.
+ *
+ * Callbacks of arrived chunks run on the worker thread of the destination partition.
+ * They may call send() from devices of the same partition only,
+ * and must guard any state shared with other partitions.
+ */
+class ParallelSimulation {
+  public:
+    /**
+     * Constructor, partitioning the devices automatically (see partition_devices).
+     *
+     * @param topology topology to simulate
+     * @param partitions_count number of partitions
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     */
+    ParallelSimulation(std::shared_ptr<Topology> topology, int partitions_count, int threads_count = 0) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param topology topology to simulate
+     * @param partition_per_device partition id of each device, in [0, partitions count)
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     */
+    ParallelSimulation(std::shared_ptr<Topology> topology,
+                       std::vector<int> partition_per_device,
+                       int threads_count = 0) noexcept;
+
+    /**
+     * Destructor.
+     * The links of the topology are handed back to the topology's own event queue.
+     */
+    ~ParallelSimulation() noexcept;
+
+    /**
+     * Partition the devices of a topology.
+     * NPUs are tiled over their per-dimension coordinates,
+     * splitting the dimension with the largest tile extent first
+     * (e.g., 2 x 2 tiles of a 2D mesh for 4 partitions, or slices of a multi-dimensional topology).
+     * Non-NPU devices join the partition of their lowest-id NPU neighbor.
+     *
+     * @param topology topology to partition
+     * @param partitions_count number of partitions, in [1, NPUs count]
+     * @return partition id of each device
+     */
+    [[nodiscard]] static std::vector<int> partition_devices(const Topology& topology, int partitions_count) noexcept;
+
+    /**
+     * Send a chunk from src to dest.
+     * Called before run(), or from a callback running on the partition of src.
+     *
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param callback_arg argument of the callback
+     */
+    void send(ChunkSize chunk_size, DeviceId src, DeviceId dest, Callback callback, CallbackArg callback_arg) noexcept;
+
+    /**
+     * Invoke the same-time events of every partition in the deterministic order
+     * (by kind, then by link, see EventQueue::set_deterministic_order),
+     * so results are bit-identical to a sequential run with the same order, whatever the partitioning.
+     * In registration order, same-time events crossing partitions are registered at the end of a window,
+     * so they may run in another order than sequentially: the chunks may then be delivered at other times.
+     * This should be set before run().
+     *
+     * @param enabled true to order the events (default), false to invoke them in registration order
+     */
+    void set_deterministic_order(bool enabled) noexcept;
+
+    /**
+     * Run the simulation until no event is left.
+     *
+     * @return time the simulation finished
+     */
+    EventTime run() noexcept;
+
+    /**
+     * Get the current time.
+     * Inside a callback, this is the current time of the calling partition,
+     * otherwise, the latest time among the partitions.
+     *
+     * @return current time
+     */
+    [[nodiscard]] EventTime get_current_time() const noexcept;
+
+    /**
+     * Get the number of partitions.
+     *
+     * @return number of partitions
+     */
+    [[nodiscard]] int get_partitions_count() const noexcept;
+
+    /**
+     * Get the partition of a device.
+     *
+     * @param device device id
+     * @return partition id of the device
+     */
+    [[nodiscard]] int get_partition(DeviceId device) const noexcept;
+
+    /**
+     * Get the lookahead of the simulation,
+     * i.e., the smallest latency among the links crossing partitions.
+     *
+     * @return lookahead in ns, the largest EventTime if no link crosses partitions
+     */
+    [[nodiscard]] EventTime get_lookahead() const noexcept;
+
+    /**
+     * Get the number of windows processed so far.
+     *
+     * @return number of windows
+     */
+    [[nodiscard]] int64_t get_windows_count() const noexcept;
+
+  private:
+    /// partition the calling thread is simulating (-1 outside a window)
+    static thread_local int current_partition;
+
+    /// topology being simulated
+    std::shared_ptr<Topology> topology;
+
+    /// scheduler of the topology before the simulation took it over
+    std::shared_ptr<NetworkScheduler> original_scheduler;
+
+    /// partition id of each device
+    std::vector<int> partition_per_device;
+
+    /// number of partitions
+    int partitions_count;
+
+    /// event queue of each partition
+    std::vector<std::shared_ptr<EventQueue>> event_queues;
+
+    /// mailboxes of the chunk arrivals crossing partitions,
+    /// indexed by (src partition * partitions_count + dest partition)
+    std::vector<EventMailbox> mailboxes;
+
+    /// smallest latency among the links crossing partitions (the largest EventTime if none)
+    EventTime lookahead;
+
+    /// runs the partitions of a window
+    WorkStealingExecutor executor;
+
+    /// guards the shared routes (and route cache) of the topology
+    std::mutex route_mutex;
+
+    /// number of windows processed so far
+    int64_t windows_count;
+
+    /**
+     * Deliver the posted chunk arrivals to their partitions.
+     * Mailboxes are delivered in a fixed order, so runs are deterministic.
+     */
+    void deliver_mailboxes() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
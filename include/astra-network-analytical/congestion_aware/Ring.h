@@ -7,6 +7,9 @@ LICENSE file in the root directory of this source tree.
 
 #include "common/Type.h"
 #include "congestion_aware/BasicTopology.h"
+#include <cassert>
+#include <deque>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -28,6 +31,8 @@ namespace NetworkAnalyticalCongestionAware {
  * If the ring is bi-directional, then each chunk can flow through:
  * 0 -> 1 -> 2 -> 3 -> 4 -> 5 -> 6 -> 7 -> 0
  * 0 <- 1 <- 2 <- 3 <- 4 <- 5 <- 6 <- 7 <- 0
+ *
+ * Chunks take the shorter way around, but a large transfer can be striped over both ways (see send_striped).
  */
 class Ring final : public BasicTopology {
   public:
@@ -42,13 +47,172 @@ class Ring final : public BasicTopology {
     Ring(int npus_count, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
 
     /**
-     * Implementation of route function in Topology.
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology, in closed form.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of compute_metrics function in Topology, in closed form.
+     */
+    [[nodiscard]] TopologyMetrics compute_metrics(int threads_count = 0) const noexcept override;
+
+    /**
+     * Initiate a transfer striped over both directions of a bidirectional ring:
+     * it's split into a chunk the shorter way and a chunk the longer way, the bytes shared in proportion
+     * to the distance the other way (see ring_stripe_size), so both chunks arrive about together
+     * and the transfer gets the bandwidth of both directions.
+     * A unidirectional ring, or a transfer too small to split, is sent as a single chunk.
+     *
+     * @param chunk_size size of the transfer
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked once the whole transfer arrived at dest
+     * @param callback_arg argument of the callback
+     * @param traffic_class traffic class of the chunks (see set_queueing_policy)
+     * @param job_id job the chunks belong to (see set_job_accounting)
+     */
+    void send_striped(ChunkSize chunk_size,
+                      DeviceId src,
+                      DeviceId dest,
+                      Callback callback,
+                      CallbackArg callback_arg,
+                      int traffic_class = 0,
+                      int job_id = 0) noexcept;
+
+    /**
+     * Get the number of striped transfers that didn't arrive yet.
+     *
+     * @return number of active striped transfers
+     */
+    [[nodiscard]] int get_active_striped_transfers_count() const noexcept;
+
+    /**
+     * Write the route from src to dest (the one compute_route returns) into a caller-provided buffer.
+     * Defined inline, so loops templated on Ring (see StaticRouting.h) route without virtual calls.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param route buffer of at least get_max_route_length() device ids
+     * @return number of devices written
+     */
+    int write_route(const DeviceId src, const DeviceId dest, DeviceId* const route) const noexcept {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+
+        // traverse the ring until reaches dest, wrapping around
+        const auto step = ring_step(src, dest);
+        auto length = 0;
+        for (auto current = src; current != dest;) {
+            route[length++] = current;
+            current += step;
+            if (current < 0) {
+                current += npus_count;
+            } else if (current >= npus_count) {
+                current -= npus_count;
+            }
+        }
+
+        // arrives at dest
+        route[length++] = dest;
+        return length;
+    }
+
+    /**
+     * Get the largest number of devices of a route.
+     *
+     * @return largest number of devices of a route
      */
-    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+    [[nodiscard]] int get_max_route_length() const noexcept {
+        return bidirectional ? (npus_count / 2) + 1 : npus_count;
+    }
 
   private:
+    /**
+     * State of a striped transfer.
+     */
+    struct StripedTransfer {
+        /// ring carrying the transfer
+        Ring* topology;
+
+        /// id of the transfer
+        int transfer_id;
+
+        /// number of stripes yet to arrive
+        int pending_stripes_count;
+
+        /// callback to be invoked once the whole transfer arrived
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+    };
+
     /// true if the ring is bidirectional, false otherwise
     bool bidirectional;
+
+    /// routes the longer way around, taken by the smaller stripes of striped transfers
+    mutable RouteTable opposite_routes;
+
+    /// striped transfers, indexed by id (a deque, so in-flight chunks can point to them)
+    std::deque<StripedTransfer> striped_transfers;
+
+    /// ids of the arrived striped transfers, reused by new ones
+    std::vector<int> free_transfer_ids;
+
+    /**
+     * Get the route from src to dest the longer way around, with its links resolved.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return route, valid as long as the topology
+     */
+    [[nodiscard]] const Route& opposite_route(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
+    /**
+     * Callback of a stripe arriving at dest: the last one completes the transfer.
+     *
+     * @param transfer_ptr pointer to the striped transfer
+     */
+    static void stripe_arrived(void* transfer_ptr) noexcept;
+
+    /**
+     * Get the direction to traverse the ring from src to dest.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return 1 for clockwise, -1 for anticlockwise
+     */
+    [[nodiscard]] int ring_step(const DeviceId src, const DeviceId dest) const noexcept {
+        // default direction: clockwise
+        if (!bidirectional) {
+            return 1;
+        }
+
+        // check whether going anticlockwise is shorter
+        auto clockwise_dist = dest - src;
+        if (clockwise_dist < 0) {
+            clockwise_dist += npus_count;
+        }
+        const auto anticlockwise_dist = npus_count - clockwise_dist;
+
+        // traverse the ring anticlockwise if so
+        return (anticlockwise_dist < clockwise_dist) ? -1 : 1;
+    }
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
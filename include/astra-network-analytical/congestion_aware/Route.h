@@ -0,0 +1,262 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+/// Compact route storage switch (0: off, 1: on)
+/// When on, routes hold device and link ids on 16 bits, shrinking every route table,
+/// and topologies are limited to max_route_index devices and links.
+#ifndef NETWORK_ANALYTICAL_COMPACT_IDS
+    #define NETWORK_ANALYTICAL_COMPACT_IDS 0
+#endif
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/// Link ID, indexing the link table of a topology
+using LinkId = int;
+
+/// device or link id as stored in routes
+#if NETWORK_ANALYTICAL_COMPACT_IDS
+using RouteIndex = uint16_t;
+#else
+using RouteIndex = int;
+#endif
+
+/// largest device or link id routes can hold
+constexpr int max_route_index = (NETWORK_ANALYTICAL_COMPACT_IDS != 0) ? UINT16_MAX : INT32_MAX;
+
+/**
+ * Route is the sequence of device ids a chunk traverses,
+ * including the src and dest devices themselves.
+ *
+ * Once resolved by a topology, the route also holds the id of the link taken at each hop,
+ * so forwarding a chunk is a direct index into the topology's link table.
+ *
+ * Routes of up to inline_capacity devices are stored inline,
+ * longer routes spill over to a heap-allocated buffer.
+ * Ids are stored as RouteIndex, i.e., on 16 bits if built with NETWORK_ANALYTICAL_COMPACT_IDS.
+ */
+class Route {
+  public:
+    /// number of devices stored without heap allocation
+    static constexpr int inline_capacity = 12;
+
+    /**
+     * Constructor.
+     */
+    Route() noexcept;
+
+    /**
+     * Construct a route from the given device ids.
+     *
+     * @param device_ids device ids, ordered from src to dest
+     */
+    Route(std::initializer_list<DeviceId> device_ids) noexcept;
+
+    /**
+     * Construct a route from an array of device ids, e.g., a source route supplied by the caller.
+     * The storage is sized once, so routes longer than inline_capacity allocate once.
+     *
+     * @param device_ids device ids, ordered from src to dest
+     * @param devices_count number of device ids
+     */
+    Route(const DeviceId* device_ids, int devices_count) noexcept;
+
+    /**
+     * Copy constructor.
+     *
+     * @param other route to copy
+     */
+    Route(const Route& other) noexcept;
+
+    /**
+     * Move constructor.
+     *
+     * @param other route to move from
+     */
+    Route(Route&& other) noexcept;
+
+    /**
+     * Copy assignment.
+     *
+     * @param other route to copy
+     * @return this route
+     */
+    Route& operator=(const Route& other) noexcept;
+
+    /**
+     * Move assignment.
+     *
+     * @param other route to move from
+     * @return this route
+     */
+    Route& operator=(Route&& other) noexcept;
+
+    /**
+     * Append a device to the end of the route.
+     *
+     * @param device_id id of the device to append
+     */
+    void push_back(DeviceId device_id) noexcept;
+
+    /**
+     * Set the id of the link taken at the given hop,
+     * i.e., the link from device [hop] to device [hop + 1].
+     *
+     * @param hop index of the hop, in [0, size() - 1)
+     * @param link_id id of the link
+     */
+    void set_link_id(int hop, LinkId link_id) noexcept;
+
+    /**
+     * Get the id of the link taken at the given hop.
+     * Only valid once the route is resolved.
+     *
+     * @param hop index of the hop, in [0, size() - 1)
+     * @return id of the link
+     */
+    [[nodiscard]] LinkId link_id(int hop) const noexcept;
+
+    /**
+     * Mark every link id of the route as set.
+     */
+    void mark_links_resolved() noexcept;
+
+    /**
+     * Check if the link ids of the route are set.
+     * Appending a device invalidates them.
+     *
+     * @return true if link ids are set, false otherwise
+     */
+    [[nodiscard]] bool links_resolved() const noexcept;
+
+    /**
+     * Get the number of devices in the route.
+     *
+     * @return number of devices in the route
+     */
+    [[nodiscard]] int size() const noexcept;
+
+    /**
+     * Check if the route is empty.
+     *
+     * @return true if the route has no device, false otherwise
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+    /**
+     * Get the device id at the given position.
+     *
+     * @param index position in the route
+     * @return device id at the position
+     */
+    [[nodiscard]] DeviceId operator[](int index) const noexcept;
+
+    /**
+     * Get the first (src) device id of the route.
+     *
+     * @return src device id
+     */
+    [[nodiscard]] DeviceId front() const noexcept;
+
+    /**
+     * Get the last (dest) device id of the route.
+     *
+     * @return dest device id
+     */
+    [[nodiscard]] DeviceId back() const noexcept;
+
+    /**
+     * Get the iterator to the first device id.
+     *
+     * @return pointer to the first device id
+     */
+    [[nodiscard]] const RouteIndex* begin() const noexcept;
+
+    /**
+     * Get the iterator past the last device id.
+     *
+     * @return pointer past the last device id
+     */
+    [[nodiscard]] const RouteIndex* end() const noexcept;
+
+    /**
+     * Compare two routes.
+     *
+     * @param other route to compare with
+     * @return true if both routes hold the same device ids, false otherwise
+     */
+    [[nodiscard]] bool operator==(const Route& other) const noexcept;
+
+    /**
+     * Get the bytes the route allocated beyond its inline storage.
+     *
+     * @return heap-allocated bytes, 0 for short routes
+     */
+    [[nodiscard]] uint64_t get_heap_bytes() const noexcept;
+
+  private:
+    /// storage for short routes:
+    /// inline_capacity device ids, followed by inline_capacity link ids
+    std::array<RouteIndex, 2 * inline_capacity> inline_storage;
+
+    /// storage for routes longer than inline_capacity (nullptr otherwise),
+    /// laid out as capacity device ids followed by capacity link ids
+    std::unique_ptr<RouteIndex[]> heap_storage;
+
+    /// number of devices in the route
+    int devices_count;
+
+    /// number of devices the current storage can hold
+    int capacity;
+
+    /// true if link ids are set
+    bool resolved;
+
+    /**
+     * Grow the storage to hold the given number of devices, keeping its contents.
+     *
+     * @param new_capacity number of devices to hold
+     */
+    void reserve(int new_capacity) noexcept;
+
+    /**
+     * Get the storage currently holding the device ids.
+     *
+     * @return pointer to the first device id
+     */
+    [[nodiscard]] RouteIndex* data() noexcept;
+
+    /**
+     * Get the storage currently holding the device ids.
+     *
+     * @return pointer to the first device id
+     */
+    [[nodiscard]] const RouteIndex* data() const noexcept;
+
+    /**
+     * Get the storage currently holding the link ids.
+     *
+     * @return pointer to the first link id
+     */
+    [[nodiscard]] RouteIndex* link_data() noexcept;
+
+    /**
+     * Get the storage currently holding the link ids.
+     *
+     * @return pointer to the first link id
+     */
+    [[nodiscard]] const RouteIndex* link_data() const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,114 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Route.h"
+#include <cstdint>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * RouteCache memoizes routes of a static topology.
+ *
+ * The cache is a table indexed by (src, dest), populated lazily.
+ * If the capacity covers every (src, dest) pair, it is a complete all-pairs routing table.
+ * Otherwise, it becomes a direct-mapped cache of the given capacity,
+ * bounding the memory footprint for large topologies.
+ */
+class RouteCache {
+  public:
+    /// default maximum number of cached routes (120 B each, 72 B with compact ids)
+    static constexpr int default_capacity = 1 << 16;
+
+    /**
+     * Constructor.
+     *
+     * @param capacity maximum number of cached routes, 0 disables caching
+     */
+    explicit RouteCache(int capacity = default_capacity) noexcept;
+
+    /**
+     * Set the maximum number of cached routes.
+     * Any cached route is dropped.
+     *
+     * @param capacity maximum number of cached routes, 0 disables caching
+     */
+    void set_capacity(int capacity) noexcept;
+
+    /**
+     * Get the maximum number of cached routes.
+     *
+     * @return maximum number of cached routes
+     */
+    [[nodiscard]] int get_capacity() const noexcept;
+
+    /**
+     * Check if caching is enabled.
+     *
+     * @return true if caching is enabled, false otherwise
+     */
+    [[nodiscard]] bool enabled() const noexcept;
+
+    /**
+     * Look up the cached route from src to dest.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param npus_count number of NPUs in the topology
+     * @return pointer to the cached route, nullptr if not cached
+     */
+    [[nodiscard]] const Route* find(DeviceId src, DeviceId dest, int npus_count) const noexcept;
+
+    /**
+     * Cache the route from src to dest.
+     * In a direct-mapped cache, this replaces the route sharing the same slot.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param npus_count number of NPUs in the topology
+     * @param route route from src to dest
+     */
+    void insert(DeviceId src, DeviceId dest, int npus_count, const Route& route) noexcept;
+
+    /**
+     * Get the bytes held by the cached routes.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_allocated_bytes() const noexcept;
+
+  private:
+    /// marks an empty slot
+    static constexpr int64_t empty_key = -1;
+
+    /// cached route with the (src, dest) pair it belongs to
+    struct Entry {
+        int64_t key;
+        Route route;
+    };
+
+    /// maximum number of cached routes
+    int capacity;
+
+    /// slots of the cache, allocated on first insertion
+    std::vector<Entry> entries;
+
+    /**
+     * Compute the key of (src, dest).
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param npus_count number of NPUs in the topology
+     * @return key of the pair
+     */
+    [[nodiscard]] static int64_t key_of(DeviceId src, DeviceId dest, int npus_count) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
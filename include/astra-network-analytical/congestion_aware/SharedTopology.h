@@ -0,0 +1,139 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Route.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * SharedTopology holds a constructed topology as a read-only graph shared by many simulations,
+ * e.g., the points of a sweep running on different threads.
+ *
+ * The topology is never simulated on directly:
+ * every simulation runs on a TopologyInstance of its own, which only asks the shared topology for routes.
+ * The adjacency and route tables are built upfront (see Topology::build_route_tables),
+ * so lookups only read the topology, and run concurrently without locking.
+ */
+class SharedTopology {
+  public:
+    /**
+     * Constructor, building the adjacency and route tables of the topology.
+     *
+     * @param topology constructed topology (with its routing policy set), not to be modified or simulated on afterwards
+     */
+    explicit SharedTopology(std::shared_ptr<const Topology> topology) noexcept;
+
+    /**
+     * Get the shared topology.
+     *
+     * @return shared topology
+     */
+    [[nodiscard]] const Topology& get_topology() const noexcept;
+
+    /**
+     * Select the route of a chunk (see Topology::select_route).
+     * The route is owned by the shared topology, and never moves afterwards.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param chunk_id id of the chunk to route
+     * @return pointer to the selected route
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept;
+
+    /**
+     * Compute the route between two NPUs (see Topology::compute_route).
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return route between src and dest
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the next hop toward a destination (see Topology::next_hop).
+     *
+     * @param current current device id
+     * @param dest dest NPU id
+     * @return next device id
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept;
+
+    /**
+     * Find the link between two devices (see Topology::find_link).
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return id of the link, -1 if not connected
+     */
+    [[nodiscard]] LinkId find_link(DeviceId src, DeviceId dest) const noexcept;
+
+  private:
+    /// shared topology
+    std::shared_ptr<const Topology> topology;
+};
+
+/**
+ * TopologyInstance simulates on a SharedTopology:
+ * routes and route tables come from the shared topology,
+ * while the links (with their state), chunk pool, statistics, and event queue belong to the instance.
+ * Link ids match the ones of the shared topology, so shared routes index the instance's own links.
+ *
+ * Constructing an instance only copies the link parameters (a lazy link table stays lazy),
+ * so many instances of a single topology are cheaper than as many constructed topologies.
+ */
+class TopologyInstance final : public Topology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param shared_topology topology to simulate on
+     */
+    explicit TopologyInstance(std::shared_ptr<const SharedTopology> shared_topology) noexcept;
+
+    /**
+     * Implementation of select_route function in Topology.
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+    /**
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of find_link function in Topology.
+     */
+    [[nodiscard]] LinkId find_link(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_link_dim function in Topology.
+     */
+    [[nodiscard]] int get_link_dim(LinkId link_id) const noexcept override;
+
+  private:
+    /// topology the routes come from
+    std::shared_ptr<const SharedTopology> shared_topology;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
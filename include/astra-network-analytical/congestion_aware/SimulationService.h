@@ -0,0 +1,76 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/QueryServer.h"
+#include "congestion_aware/Topology.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * SimulationService answers ChunkQuery requests by simulating the chunks sent together at time 0
+ * on a fresh topology, answering the delivery time of every chunk.
+ * The topology of each network config is constructed once, and reset before every request.
+ *
+ * Serve it through a QueryServer:
+ *   auto simulation_service = SimulationService();
+ *   auto server = QueryServer(socket_path, [&](const auto& request) { return simulation_service.answer(request); });
+ */
+class SimulationService {
+  public:
+    /**
+     * Answer a request. Thread-safe: requests on different network configs are simulated concurrently,
+     * and requests on the same network config one at a time.
+     *
+     * @param request encoded ChunkQuery
+     * @return encoded delivery time of every chunk, empty if the request is malformed,
+     *         its network config can't be read, or a chunk has an invalid NPU ID
+     */
+    [[nodiscard]] std::string answer(const std::string& request) noexcept;
+
+    /**
+     * Get the number of topologies constructed so far.
+     *
+     * @return number of topologies
+     */
+    [[nodiscard]] int get_topologies_count() const noexcept;
+
+  private:
+    /**
+     * Simulation of a network config: its topology driven by an event queue of its own.
+     */
+    struct Simulation {
+        /// event queue of the topology
+        std::shared_ptr<EventQueue> event_queue;
+
+        /// topology of the network config
+        std::shared_ptr<Topology> topology;
+
+        /// serializes the requests on the topology
+        std::mutex mutex;
+    };
+
+    /// simulation of each network config path, guarded by simulations_mutex
+    std::map<std::string, std::shared_ptr<Simulation>> simulations;
+    mutable std::mutex simulations_mutex;
+
+    /**
+     * Get the simulation of a network config, constructing it on first use.
+     *
+     * @param config_path path of the network config
+     * @return simulation, nullptr if the network config can't be read
+     */
+    [[nodiscard]] std::shared_ptr<Simulation> get_simulation(const std::string& config_path) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
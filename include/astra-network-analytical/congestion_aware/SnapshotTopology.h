@@ -0,0 +1,76 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements a topology reloaded from a snapshot of a constructed topology,
+ * so repeated runs skip construction and route precomputation.
+ *
+ * A snapshot holds the devices, every link with its bandwidth and latency (in LinkId order),
+ * and a next-hop table: for each destination NPU, the device every device moves to next.
+ * Snapshot files are flat buffers of fixed-size scalars in native byte order,
+ * versioned and checked on load.
+ *
+ * Routing follows the next-hop table, i.e., the (consistent) routing of the original topology.
+ * Topology-specific route selection (e.g., O1TURN, Valiant, or multipath routes) isn't recorded.
+ */
+class SnapshotTopology final : public Topology {
+  public:
+    /**
+     * Write a snapshot of a topology.
+     * Every route of the topology is computed (and cached by it) to fill the next-hop table.
+     *
+     * @param topology topology to snapshot
+     * @param path path of the snapshot file
+     * @return true if the snapshot is written, false otherwise
+     */
+    static bool save(const Topology& topology, const std::string& path) noexcept;
+
+    /**
+     * Constructor, loading a snapshot written by save.
+     *
+     * @param path path of the snapshot file
+     */
+    explicit SnapshotTopology(const std::string& path) noexcept;
+
+    /**
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+  private:
+    /// identifies snapshot files
+    static constexpr char snapshot_magic[8] = {'A', 'N', 'A', 'N', 'E', 'T', 'S', 'S'};
+
+    /// version of the snapshot file layout, bumped whenever the layout changes
+    static constexpr uint32_t snapshot_version = 1;
+
+    /// device each device moves to next toward each destination NPU (-1 if none),
+    /// indexed by dest * devices_count + device
+    std::vector<DeviceId> next_hops;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -11,7 +11,11 @@ LICENSE file in the root directory of this source tree.
 #include <vector>
 #include <set>
 #include <map>
+#include <string>
+#include <cstdint>
 #include <cstdlib>  // for std::abs
+#include <memory>
+#include <mutex>
 
 using namespace NetworkAnalytical;
 
@@ -35,11 +39,16 @@ namespace NetworkAnalyticalCongestionAware {
  *
  * Here 'x' represents excluded positions. Valid NPUs are numbered 0-15 contiguously.
  *
- * Routing uses a modified XY algorithm that navigates around holes:
- * - Tries XY routing first (move X, then Y)
- * - If blocked by a hole, uses BFS to find shortest path
+ * Routing takes shortest paths around holes, preferring to move in X first (XY routing on hole-free meshes).
+ * Each destination gets a next-hop table (BFS from the destination) on its first route,
+ * holding every direction one hop closer, so routing is a walk over the table.
+ * With several multipath routes (see set_multipath_routes_count), chunks are spread over
+ * that many shortest paths by hashing their chunk ids, balancing the detours around holes.
+ * Failed links (see Topology::set_link_failed) are routed around like holes:
+ * only the next-hop tables of the destinations they affect are rebuilt.
  *
- * The ring for collective communication visits all valid nodes in order: 0→1→2→...→15→0
+ * The ring for collective communication (see get_ring_order) goes through adjacent nodes as far as the holes allow,
+ * e.g., 0→1→2→3→4→5→9→13→15→14→12→8→7→11→10→6 above, only 6→0 taking several hops.
  */
 class SparseMesh2D final : public BasicTopology {
   public:
@@ -56,6 +65,19 @@ class SparseMesh2D final : public BasicTopology {
                  const std::set<std::pair<int, int>>& excluded_coords,
                  Bandwidth bandwidth, Latency latency) noexcept;
 
+    /**
+     * Constructor for Sparse 2D Mesh topology from a bitmap of valid cells, with automatic NPU numbering.
+     * Runs in linear time of the grid size (e.g., for wafer-scale grids with many defective dies).
+     *
+     * @param width maximum number of columns in the grid
+     * @param height maximum number of rows in the grid
+     * @param valid_cells true for each grid cell holding a node, indexed by y * width + x
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    SparseMesh2D(int width, int height, const std::vector<bool>& valid_cells, Bandwidth bandwidth,
+                 Latency latency) noexcept;
+
     /**
      * Constructor for Sparse 2D Mesh topology with CUSTOM NPU placement.
      * 
@@ -74,6 +96,34 @@ class SparseMesh2D final : public BasicTopology {
                  const std::map<std::pair<int, int>, int>& npu_placement,
                  Bandwidth bandwidth, Latency latency) noexcept;
 
+    /**
+     * Constructor for Sparse 2D Mesh topology from a bitmap of valid cells, with CUSTOM NPU placement.
+     *
+     * @param width maximum number of columns in the grid
+     * @param height maximum number of rows in the grid
+     * @param valid_cells true for each grid cell holding a node, indexed by y * width + x
+     * @param npu_placement map from (x, y) to NPU ID for custom assignment
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    SparseMesh2D(int width, int height, const std::vector<bool>& valid_cells,
+                 const std::map<std::pair<int, int>, int>& npu_placement, Bandwidth bandwidth,
+                 Latency latency) noexcept;
+
+    /**
+     * Constructor for Sparse 2D Mesh topology from a bitmap of valid cells, with CUSTOM NPU placement as a grid
+     * (e.g., expanded from a placement pattern by NetworkParser::get_npu_placement_grid).
+     *
+     * @param width maximum number of columns in the grid
+     * @param height maximum number of rows in the grid
+     * @param valid_cells true for each grid cell holding a node, indexed by y * width + x
+     * @param npu_placement_grid NPU ID of each grid cell (-1 if not placed), indexed by y * width + x
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    SparseMesh2D(int width, int height, const std::vector<bool>& valid_cells,
+                 const std::vector<int>& npu_placement_grid, Bandwidth bandwidth, Latency latency) noexcept;
+
     /**
      * Compute route between two NPUs.
      * Uses modified XY routing that navigates around holes.
@@ -82,7 +132,96 @@ class SparseMesh2D final : public BasicTopology {
      * @param dest destination NPU ID (in contiguous numbering)
      * @return sequence of devices (nodes) to traverse from src to dest
      */
-    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Get the next NPU toward dest, from the next-hop table of dest.
+     *
+     * @param current current NPU ID
+     * @param dest destination NPU ID
+     * @return next NPU ID
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology, walking the next-hop table of dest.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_zero_load_latency function in Topology, walking the next-hop table of dest:
+     * the hops along each dimension times the delay of a link of that dimension.
+     */
+    [[nodiscard]] EventTime get_zero_load_latency(DeviceId src,
+                                                  DeviceId dest,
+                                                  ChunkSize chunk_size) const noexcept override;
+
+    /**
+     * Implementation of get_link_dim function in Topology:
+     * row links belong to dimension 0, column links to dimension 1.
+     */
+    [[nodiscard]] int get_link_dim(LinkId link_id) const noexcept override;
+
+    /**
+     * Implementation of get_ring_order function in Topology, around the holes:
+     * the ring of the full grid without holes (see Topology::grid_ring_order),
+     * otherwise a walk to an unvisited neighbor with the fewest unvisited neighbors (Warnsdorff's rule),
+     * jumping to the nearest unvisited node when stuck.
+     */
+    [[nodiscard]] std::vector<DeviceId> get_ring_order() const noexcept override;
+
+    /**
+     * Build the next-hop tables of every destination up front, in parallel across destinations.
+     * Otherwise, each table is built on the first route to its destination.
+     *
+     * @param threads_count number of threads building tables, 0 for the hardware concurrency
+     */
+    void build_next_hop_tables(int threads_count = 0) const noexcept;
+
+    /**
+     * Select the route of a newly sent chunk: one of the multipath routes from src to dest,
+     * by hashing its chunk id (the first one is the route of compute_route()).
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @param chunk_id id of the chunk
+     * @return route of the chunk
+     */
+    [[nodiscard]] const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept override;
+
+    /**
+     * Implementation of has_fixed_routes function in Topology.
+     */
+    [[nodiscard]] bool has_fixed_routes() const noexcept override;
+
+    /**
+     * Implementation of build_route_tables function in Topology.
+     */
+    void build_route_tables() const noexcept override;
+
+    /**
+     * Set the number of shortest paths the chunks of each (src, dest) pair are spread over.
+     * Each path takes a hashed choice among the shortest next hops at every NPU, so paths may coincide.
+     * Chunks routed hop by hop always take the first shortest next hop.
+     *
+     * @param routes_count number of paths per pair, 1 to route every chunk by compute_route() (default)
+     */
+    void set_multipath_routes_count(int routes_count) noexcept;
+
+    /**
+     * Get the number of shortest paths the chunks of each (src, dest) pair are spread over.
+     *
+     * @return number of paths per pair
+     */
+    [[nodiscard]] int get_multipath_routes_count() const noexcept;
+
+    /**
+     * Group the links by grid line, as Mesh2D: "row y" for horizontal links, "column x" for vertical links.
+     *
+     * @param link_id id of the link
+     * @return name of the group of the link
+     */
+    [[nodiscard]] std::string get_link_group(LinkId link_id) const noexcept override;
 
     /**
      * Get the number of valid (non-excluded) NPUs.
@@ -124,8 +263,9 @@ class SparseMesh2D final : public BasicTopology {
     /// Number of valid (non-excluded) NPUs
     int valid_npu_count;
 
-    /// Set of excluded coordinates
-    std::set<std::pair<int, int>> excluded;
+    /// Valid (non-excluded) grid cells
+    /// Index: y * width + x
+    std::vector<bool> valid_cells;
 
     /// Map from grid coordinates to NPU ID (-1 if excluded)
     /// Index: y * width + x
@@ -134,6 +274,35 @@ class SparseMesh2D final : public BasicTopology {
     /// Map from NPU ID to grid coordinates
     std::vector<std::pair<int, int>> npu_to_grid;
 
+    /// Next-hop directions (a bit per direction one hop closer) of each NPU toward each destination,
+    /// indexed by destination then NPU ID (a table is empty until built)
+    mutable std::vector<std::vector<uint8_t>> next_hop_tables;
+
+    /// Guards building each next-hop table once, as routes may be computed concurrently
+    std::unique_ptr<std::once_flag[]> next_hop_tables_built;
+
+    /// Number of shortest paths the chunks of each pair are spread over
+    int multipath_routes_count;
+
+    /// Interned routes of every path but the first one (the shared route)
+    mutable std::vector<RouteTable> multipath_routes;
+
+    /**
+     * Implementation of get_route_tables_bytes function in Topology.
+     */
+    [[nodiscard]] uint64_t get_route_tables_bytes() const noexcept override;
+
+    /**
+     * Implementation of repair_routes function in Topology:
+     * the built next-hop tables the changed links affect are rebuilt over the live links.
+     */
+    void repair_routes(const std::vector<LinkId>& changed_link_ids, bool failed) noexcept override;
+
+    /**
+     * Implementation of live_next_hop function in Topology (the next-hop tables are kept repaired).
+     */
+    [[nodiscard]] DeviceId live_next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
     /**
      * Convert grid coordinates to linear index.
      */
@@ -149,15 +318,82 @@ class SparseMesh2D final : public BasicTopology {
     }
 
     /**
-     * Get valid neighbors of a grid position.
-     * Returns list of (x, y) coordinates of valid adjacent nodes.
+     * Get the next-hop table of a destination, building it on first use.
+     * Entry i holds a bit per direction NPU i may move in toward the destination (no_next_hop if unreachable).
+     */
+    [[nodiscard]] const std::vector<uint8_t>& next_hop_table(DeviceId dest) const noexcept;
+
+    /**
+     * Build the next-hop table of a destination: BFS from the destination over the live links,
+     * then every NPU may move to any neighbor one hop closer.
+     */
+    void build_next_hop_table(DeviceId dest) const noexcept;
+
+    /**
+     * Count the hops of the route of compute_route() along each dimension, walking the next-hop table of dest.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return hops along rows (dimension 0) and along columns (dimension 1)
+     */
+    [[nodiscard]] std::pair<int, int> count_hops(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Compute the given multipath route (other than the first) between two NPUs.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID, other than src
+     * @param path index of the path
+     * @return sequence of devices (nodes) to traverse from src to dest
+     */
+    [[nodiscard]] Route compute_multipath_route(DeviceId src, DeviceId dest, int path) const noexcept;
+
+    /**
+     * Get the given multipath route (other than the first) between two NPUs, with its links resolved.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID, other than src
+     * @param path index of the path
+     * @return route, valid as long as the topology
+     */
+    [[nodiscard]] const Route* multipath_route(DeviceId src, DeviceId dest, int path) const noexcept;
+
+    /**
+     * Convert excluded coordinates into a bitmap of valid cells.
+     * Coordinates outside of the grid are ignored.
+     */
+    [[nodiscard]] static std::vector<bool> valid_cells_from_excluded(
+        int width, int height, const std::set<std::pair<int, int>>& excluded_coords) noexcept;
+
+    /**
+     * Convert a custom NPU placement into a grid of NPU IDs (-1 if not placed).
+     * Placements outside of the grid are reported and ignored.
+     */
+    [[nodiscard]] static std::vector<int> placement_grid_from_map(
+        int width, int height, const std::map<std::pair<int, int>, int>& npu_placement) noexcept;
+
+    /**
+     * Count the valid cells of a bitmap, checking it covers the width x height grid.
+     */
+    [[nodiscard]] static int count_valid_cells(int width, int height, const std::vector<bool>& valid_cells) noexcept;
+
+    /**
+     * Number the valid cells without a custom placement contiguously, in row-major order,
+     * skipping the NPU IDs already placed.
+     *
+     * @param npu_id_used true for each NPU ID already placed
+     */
+    void number_unplaced_npus(std::vector<bool>& npu_id_used) noexcept;
+
+    /**
+     * Set the topology metadata and connect the adjacent valid nodes.
      */
-    [[nodiscard]] std::vector<std::pair<int, int>> get_valid_neighbors(int x, int y) const noexcept;
+    void build_mesh(Bandwidth bandwidth, Latency latency) noexcept;
 
     /**
-     * Find shortest path using BFS when XY routing is blocked.
+     * Render the grid with NPU IDs and links, for diagnostic logs.
      */
-    [[nodiscard]] Route bfs_route(DeviceId src, DeviceId dest) const noexcept;
+    [[nodiscard]] std::string grid_layout() const noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,118 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/FullyConnected.h"
+#include "congestion_aware/Mesh2D.h"
+#include "congestion_aware/Ring.h"
+#include "congestion_aware/Switch.h"
+#include "congestion_aware/Topology.h"
+#include <algorithm>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Static routing dispatch: simulation loops templated on the concrete topology route without virtual calls.
+ *
+ * visit_topology resolves the concrete type of a topology once (not once per chunk),
+ * and runs the loop instantiated for that type, e.g.,
+ *   visit_topology(*topology, [&](const auto& concrete_topology) {
+ *       auto route = std::vector<DeviceId>(max_route_length(concrete_topology));
+ *       for (...) {
+ *           const auto length = write_route(concrete_topology, src, dest, route.data());
+ *           ...
+ *       }
+ *   });
+ *
+ * Ring, Switch, FullyConnected, and Mesh2D define write_route inline, writing into a caller-provided buffer,
+ * so their routes are computed in place, without constructing a Route.
+ * Other topologies are visited as a Topology, whose routes are copied from the shared routes.
+ */
+
+/// concrete topologies routed without virtual calls
+using StaticTopology = std::variant<const Ring*, const Switch*, const FullyConnected*, const Mesh2D*>;
+
+/**
+ * Trait: true if TopologyType writes its routes inline (i.e., defines write_route).
+ */
+template <typename TopologyType, typename = void> struct has_static_route : std::false_type {};
+
+template <typename TopologyType>
+struct has_static_route<TopologyType,
+                        std::void_t<decltype(std::declval<const TopologyType&>().write_route(0, 0, nullptr))>>
+    : std::true_type {};
+
+/**
+ * Resolve the concrete type of a topology.
+ *
+ * @param topology topology to resolve
+ * @return concrete topology, std::nullopt if it isn't one of StaticTopology
+ */
+[[nodiscard]] std::optional<StaticTopology> resolve_static_topology(const Topology& topology) noexcept;
+
+/**
+ * Run a visitor on the concrete type of a topology:
+ * as one of StaticTopology (e.g., const Ring&) if resolved, otherwise as a const Topology&.
+ * The visitor should return the same type in every case.
+ *
+ * @param topology topology to visit
+ * @param visitor generic callable taking the concrete topology
+ * @return result of the visitor
+ */
+template <typename Visitor>
+decltype(auto) visit_topology(const Topology& topology, Visitor&& visitor) noexcept {
+    if (const auto static_topology = resolve_static_topology(topology)) {
+        return std::visit([&visitor](const auto* const concrete_topology) -> decltype(auto) {
+            return visitor(*concrete_topology);
+        }, *static_topology);
+    }
+    return visitor(topology);
+}
+
+/**
+ * Get the largest number of devices of a route of a topology, to size route buffers.
+ *
+ * @param topology topology, concrete or not
+ * @return largest number of devices of a route
+ */
+template <typename TopologyType> [[nodiscard]] int max_route_length(const TopologyType& topology) noexcept {
+    if constexpr (has_static_route<TopologyType>::value) {
+        return topology.get_max_route_length();
+    } else {
+        // routes don't revisit devices
+        return topology.get_devices_count();
+    }
+}
+
+/**
+ * Write the route from src to dest into a caller-provided buffer:
+ * computed inline for the concrete types of StaticTopology, copied from the shared route otherwise.
+ *
+ * @param topology topology, concrete or not
+ * @param src src NPU id
+ * @param dest dest NPU id
+ * @param route buffer of at least max_route_length(topology) device ids
+ * @return number of devices written
+ */
+template <typename TopologyType>
+int write_route(const TopologyType& topology, const DeviceId src, const DeviceId dest, DeviceId* const route) noexcept {
+    if constexpr (has_static_route<TopologyType>::value) {
+        return topology.write_route(src, dest, route);
+    } else {
+        const auto* const shared_route = topology.shared_route(src, dest);
+        std::copy(shared_route->begin(), shared_route->end(), route);
+        return shared_route->size();
+    }
+}
+
+}  // namespace NetworkAnalyticalCongestionAware
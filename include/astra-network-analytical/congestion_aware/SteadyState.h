@@ -0,0 +1,122 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * SteadyState detects when an iterative workload (e.g., training steps repeating the same collectives)
+ * has converged, so the remaining iterations can be extrapolated instead of simulated.
+ *
+ * At every iteration boundary, the network behavior of the iteration is summarized into a signature:
+ * the iteration time, what each link transmitted and how long it was busy or queueing during the iteration
+ * (link statistics, if collected), the chunks delivered, hops taken, and queueing delay they accumulated,
+ * and the chunks still queued on each link at the boundary.
+ * Once the signatures of enough consecutive iterations are identical,
+ * every further iteration is assumed to take the same time.
+ */
+class SteadyState {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology running the workload
+     * @param matching_iterations_count consecutive identical iterations deemed converged (at least 2)
+     */
+    explicit SteadyState(std::shared_ptr<Topology> topology, int matching_iterations_count = 2) noexcept;
+
+    /**
+     * Record the end of an iteration (which is the start of the next one).
+     * The first iteration starts at the time the detector is constructed.
+     *
+     * @param time time the iteration ended
+     * @return true if the workload converged, false otherwise
+     */
+    bool end_iteration(EventTime time) noexcept;
+
+    /**
+     * Check if the workload converged.
+     *
+     * @return true if the last matching_iterations_count iterations were identical, false otherwise
+     */
+    [[nodiscard]] bool converged() const noexcept;
+
+    /**
+     * Get the time of an iteration once converged.
+     *
+     * @return time of the last iteration
+     */
+    [[nodiscard]] EventTime get_iteration_time() const noexcept;
+
+    /**
+     * Extrapolate the finish time of the workload once converged.
+     *
+     * @param remaining_iterations_count iterations left after the last recorded one
+     * @return time the last of them would end
+     */
+    [[nodiscard]] EventTime extrapolate(int64_t remaining_iterations_count) const noexcept;
+
+    /**
+     * Get the number of iterations recorded so far.
+     *
+     * @return number of iterations
+     */
+    [[nodiscard]] int64_t get_iterations_count() const noexcept;
+
+    /**
+     * Get the signature of the last recorded iteration.
+     *
+     * @return signature (0 if no iteration was recorded)
+     */
+    [[nodiscard]] uint64_t get_signature() const noexcept;
+
+  private:
+    /// topology running the workload
+    std::shared_ptr<Topology> topology;
+
+    /// consecutive identical iterations deemed converged
+    int matching_iterations_count;
+
+    /// time the current iteration started
+    EventTime iteration_start_time;
+
+    /// time of the last recorded iteration
+    EventTime iteration_time;
+
+    /// number of iterations recorded
+    int64_t iterations_count;
+
+    /// signature of the last recorded iteration
+    uint64_t signature;
+
+    /// number of consecutive iterations with that signature
+    int matching_count;
+
+    /// link statistics at the start of the current iteration, indexed by LinkId
+    std::vector<LinkStats> link_stats;
+
+    /// chunk statistics at the start of the current iteration
+    ChunkStats chunk_stats;
+
+    /**
+     * Summarize the current iteration and advance the baselines to its end.
+     *
+     * @param time time the iteration ended
+     * @return signature of the iteration
+     */
+    [[nodiscard]] uint64_t sign_iteration(EventTime time) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
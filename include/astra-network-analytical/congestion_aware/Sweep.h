@@ -0,0 +1,326 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/EventQueue.h"
+#include "common/NetworkConfig.h"
+#include "common/NetworkParser.h"
+#include "common/NetworkScenarios.h"
+#include "common/ResultCache.h"
+#include "common/Telemetry.h"
+#include "common/Type.h"
+#include "congestion_aware/SharedTopology.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Workload of a sweep point:
+ * injects chunks into the given topology before the simulation starts.
+ * It is invoked concurrently for different points, so it must not mutate shared state.
+ */
+using Workload = std::function<void(Topology& topology)>;
+
+class SweepTable;
+
+/**
+ * Result of a single sweep point.
+ */
+struct SweepResult {
+    /// index of the point in the sweep
+    int point_id;
+
+    /// topology building block of the point
+    TopologyBuildingBlock topology_type;
+
+    /// number of NPUs of the point
+    int npus_count;
+
+    /// bandwidth of the point
+    Bandwidth bandwidth;
+
+    /// latency of the point
+    Latency latency;
+
+    /// time the simulation of the point finished
+    EventTime finish_time;
+
+    /// true if the result was read from the result cache rather than simulated (see Sweep::set_result_cache)
+    bool cached = false;
+
+    /// errors of the network configuration of the point, which isn't simulated then (empty: valid point)
+    std::vector<ConfigError> config_errors = {};
+
+    /// number of events the simulation of the point invoked (the measurements below are 0 for cached points)
+    uint64_t events_count = 0;
+
+    /// bytes transmitted over every link, and the longest time a link was busy
+    /// (only measured if NETWORK_ANALYTICAL_ENABLE_STATS is set, 0 otherwise)
+    uint64_t bytes_transmitted = 0;
+    EventTime max_link_busy_time = 0;
+
+    /// wall-clock time the simulation of the point took, in seconds
+    double wall_time = 0;
+};
+
+/**
+ * Sweep runs a workload over many network configurations in one process.
+ * Every point is an independent simulation with its own topology and event queue,
+ * scheduled on a work-stealing thread pool.
+ */
+class Sweep {
+  public:
+    /**
+     * Build the configurations of a parameter grid
+     * (the Cartesian product of the given values) over 1-dim topologies.
+     *
+     * @param topology_name topology name as in the YAML config, e.g., "Ring"
+     * @param npus_counts candidate number of NPUs
+     * @param bandwidths candidate bandwidths
+     * @param latencies candidate latencies
+     * @return network configurations of every grid point
+     */
+    [[nodiscard]] static std::vector<NetworkParser> parameter_grid(const std::string& topology_name,
+                                                                   const std::vector<int>& npus_counts,
+                                                                   const std::vector<Bandwidth>& bandwidths,
+                                                                   const std::vector<Latency>& latencies) noexcept;
+
+    /**
+     * Run many workloads on a single topology, shared by every simulation:
+     * each workload is an independent simulation on its own TopologyInstance and event queue,
+     * released in the background once finished (see Topology::set_background_teardown).
+     *
+     * @param shared_topology topology to simulate on
+     * @param workloads workloads to simulate
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @param event_queue_type event queue implementation of every simulation
+     * @return time each simulation finished, ordered as the given workloads
+     */
+    [[nodiscard]] static std::vector<EventTime> run_shared(
+        const std::shared_ptr<const SharedTopology>& shared_topology,
+        const std::vector<Workload>& workloads,
+        int threads_count = 0,
+        EventQueueType event_queue_type = EventQueueType::Heap) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param network_parsers network configuration of every sweep point
+     * @param event_queue_type event queue implementation of every simulation
+     */
+    explicit Sweep(std::vector<NetworkParser> network_parsers,
+                   EventQueueType event_queue_type = EventQueueType::Heap) noexcept;
+
+    /**
+     * Constructor from network configurations built in memory, possibly invalid:
+     * the invalid points are kept in the result table with their errors (see SweepResult::config_errors)
+     * but never simulated, so one bad point doesn't stop the others.
+     *
+     * @param network_configs network configuration of every sweep point
+     * @param event_queue_type event queue implementation of every simulation
+     */
+    explicit Sweep(const std::vector<NetworkConfig>& network_configs,
+                   EventQueueType event_queue_type = EventQueueType::Heap) noexcept;
+
+    /**
+     * Constructor from the scenarios of a multi-scenario yml file, parsed once (see NetworkScenarios):
+     * each scenario is a point, the invalid ones kept in the result table with their errors.
+     *
+     * @param network_scenarios network configuration of every sweep point
+     * @param event_queue_type event queue implementation of every simulation
+     */
+    explicit Sweep(const NetworkScenarios& network_scenarios,
+                   EventQueueType event_queue_type = EventQueueType::Heap) noexcept;
+
+    /**
+     * Memoize the results of the points on disk:
+     * points already simulated with the same workload, in this or an earlier run, are read from the cache.
+     *
+     * @param new_result_cache cache of the results (nullptr: no caching)
+     * @param new_workload_key description of the workloads passed to run, covering everything their results
+     *                         depend on (see ResultCache)
+     */
+    void set_result_cache(std::shared_ptr<ResultCache> new_result_cache, std::string new_workload_key) noexcept;
+
+    /**
+     * Report the progress of run (the points of the sweep, and the completed ones) to the given telemetry.
+     *
+     * @param new_telemetry telemetry to report to, nullptr to stop reporting
+     */
+    void set_telemetry(std::shared_ptr<Telemetry> new_telemetry) noexcept;
+
+    /**
+     * Append the result row of every point to the given table as soon as the point finishes during run,
+     * so the results of large sweeps are written out incrementally.
+     *
+     * @param new_result_table table to append to, nullptr to stop appending
+     */
+    void set_result_table(std::shared_ptr<SweepTable> new_result_table) noexcept;
+
+    /**
+     * Set whether run pins its workers to cores, spread over the NUMA nodes
+     * (see WorkStealingExecutor::set_thread_pinning).
+     * The topology, links, chunks and events of a point are then allocated node-locally by its worker,
+     * and released at once when the point finishes.
+     *
+     * @param enabled true to pin the workers, false otherwise (default)
+     */
+    void set_thread_pinning(bool enabled) noexcept;
+
+    /**
+     * Run the workload on every sweep point.
+     * Each finished point is released in the background (see Topology::set_background_teardown).
+     *
+     * @param workload workload to simulate
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @return result table, one row per point, ordered as the given configurations
+     */
+    [[nodiscard]] std::vector<SweepResult> run(const Workload& workload, int threads_count = 0) const noexcept;
+
+    /**
+     * Run the workload on the points handed out by a SweepCoordinator, possibly on another machine,
+     * until every point of the sweep is done.
+     * Each thread pulls a point, simulates it, and reports its finish time along with the next pull.
+     * Workers should construct the same sweep (the same points, in the same order) as the coordinator,
+     * which rejects workers of another sweep.
+     *
+     * @param host host of the coordinator
+     * @param port port of the coordinator
+     * @param workload workload to simulate
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @return number of points simulated by this worker
+     */
+    int run_worker(const std::string& host, uint16_t port, const Workload& workload, int threads_count = 0) const
+        noexcept;
+
+    /**
+     * Get the number of sweep points.
+     *
+     * @return number of sweep points
+     */
+    [[nodiscard]] int get_points_count() const noexcept;
+
+    /**
+     * Get the fingerprint of the sweep points (hash of their network configurations, in order),
+     * telling the workers of a distributed sweep apart from the ones of another sweep.
+     *
+     * @return fingerprint of the points
+     */
+    [[nodiscard]] uint64_t get_fingerprint() const noexcept;
+
+  private:
+    /// network configuration of every sweep point (std::nullopt: invalid point)
+    std::vector<std::optional<NetworkParser>> network_parsers;
+
+    /// errors of the network configuration of every sweep point (empty: valid point)
+    std::vector<std::vector<ConfigError>> config_errors;
+
+    /// event queue implementation of every simulation
+    EventQueueType event_queue_type;
+
+    /// cache of the results of the points (nullptr: no caching), and the description of their workload
+    std::shared_ptr<ResultCache> result_cache;
+    std::string workload_key;
+
+    /// telemetry the progress of run is reported to (nullptr: none)
+    std::shared_ptr<Telemetry> telemetry;
+
+    /// table the result rows are appended to during run (nullptr: none)
+    std::shared_ptr<SweepTable> result_table;
+
+    /// true if run pins its workers to cores
+    bool thread_pinning;
+
+    /**
+     * Get the result row of a sweep point, without its finish time.
+     *
+     * @param point_id index of the point
+     * @return result row of the point
+     */
+    [[nodiscard]] SweepResult describe_point(int point_id) const noexcept;
+
+    /**
+     * Simulate the workload on a single sweep point.
+     *
+     * @param point_id index of the point
+     * @param workload workload to simulate
+     * @return result of the point
+     */
+    [[nodiscard]] SweepResult run_point(int point_id, const Workload& workload) const noexcept;
+
+    /**
+     * Simulate the points handed out by a SweepCoordinator through a connection, until none is left.
+     *
+     * @param fd connection to the coordinator
+     * @param workload workload to simulate
+     * @return number of points simulated
+     */
+    int run_worker_connection(int fd, const Workload& workload) const noexcept;
+
+    friend class SweepCoordinator;
+};
+
+/**
+ * SweepCoordinator distributes the points of a Sweep to worker processes across machines (see Sweep::run_worker)
+ * over TCP, and merges their results into one table.
+ *
+ * Workers pull one point at a time, so points whose simulation times differ by orders of magnitude
+ * still balance across workers; the point of a worker disconnecting before reporting it goes to another worker.
+ * Points found in the sweep's result cache (see Sweep::set_result_cache) aren't handed out,
+ * and the reported ones are stored into it.
+ */
+class SweepCoordinator {
+  public:
+    /**
+     * Constructor. Listens for workers.
+     *
+     * @param sweep sweep to distribute, outliving the coordinator
+     * @param port TCP port to listen on (0: any free port, see get_port)
+     */
+    SweepCoordinator(const Sweep& sweep, uint16_t port) noexcept;
+
+    /**
+     * Destructor. Stops listening.
+     */
+    ~SweepCoordinator() noexcept;
+
+    SweepCoordinator(const SweepCoordinator&) = delete;
+    SweepCoordinator& operator=(const SweepCoordinator&) = delete;
+
+    /**
+     * Get the TCP port the coordinator listens on.
+     *
+     * @return port
+     */
+    [[nodiscard]] uint16_t get_port() const noexcept;
+
+    /**
+     * Hand out the points to the workers until every point is reported.
+     *
+     * @return result table, one row per point, ordered as the sweep's configurations
+     */
+    [[nodiscard]] std::vector<SweepResult> run() noexcept;
+
+  private:
+    /// sweep to distribute
+    const Sweep& sweep;
+
+    /// listening socket
+    int listen_fd;
+
+    /// port listened on
+    uint16_t port;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
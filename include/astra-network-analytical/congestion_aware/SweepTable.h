@@ -0,0 +1,168 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/CompressedOutput.h"
+#include "common/Type.h"
+#include "congestion_aware/Sweep.h"
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Columns of sweep result rows (see SweepResult).
+ */
+struct SweepColumns {
+    /// index of the point in the sweep
+    std::vector<int32_t> point_ids;
+
+    /// topology building block of the point (as TopologyBuildingBlock values)
+    std::vector<int32_t> topology_types;
+
+    /// number of NPUs of the point
+    std::vector<int32_t> npus_counts;
+
+    /// bandwidth and latency of the point
+    std::vector<Bandwidth> bandwidths;
+    std::vector<Latency> latencies;
+
+    /// time the simulation of the point finished
+    std::vector<EventTime> finish_times;
+
+    /// number of events the simulation of the point invoked
+    std::vector<uint64_t> events_counts;
+
+    /// bytes transmitted over every link, and the longest time a link was busy
+    /// (only measured if NETWORK_ANALYTICAL_ENABLE_STATS is set)
+    std::vector<uint64_t> bytes_transmitted;
+    std::vector<EventTime> max_link_busy_times;
+
+    /// wall-clock time the simulation of the point took, in seconds
+    std::vector<double> wall_times;
+
+    /// 1 if the result was read from the result cache, 0 if simulated
+    std::vector<uint8_t> cached;
+
+    /// number of errors of the network configuration of the point (0: valid point)
+    std::vector<int32_t> config_errors_counts;
+
+    /**
+     * Get the number of rows.
+     *
+     * @return number of rows
+     */
+    [[nodiscard]] size_t size() const noexcept;
+
+    /**
+     * Drop every row, keeping the allocated capacity.
+     */
+    void clear() noexcept;
+
+    /**
+     * Allocate room for the given number of rows.
+     *
+     * @param capacity number of rows
+     */
+    void reserve(size_t capacity) noexcept;
+};
+
+/**
+ * SweepTable accumulates the result rows of a sweep (see Sweep::set_result_table) into a binary columnar file,
+ * so sweeps of hundreds of thousands of points are analyzed without parsing any text
+ * (each column of a block is a plain array, e.g., loaded with numpy.frombuffer).
+ *
+ * Rows are appended as points finish, from concurrent workers, to a block of columns.
+ * Once the block is full, it's written (optionally gzip-compressed, see CompressedOutput) and flushed,
+ * so the file holds every full block even if the sweep is interrupted.
+ *
+ * File layout (little endian): magic (uint64_t), then blocks of
+ * rows count (uint64_t) followed by each column of the block, in SweepColumns order.
+ */
+class SweepTable {
+  public:
+    /// magic number identifying sweep tables
+    static constexpr uint64_t table_magic = 0x31'4C'42'54'50'45'57'53;  // "SWEPTBL1"
+
+    /**
+     * Read every row of a sweep table (compressed or not).
+     *
+     * @param table_path path of the table file
+     * @return rows of the table
+     */
+    [[nodiscard]] static SweepColumns read_table(const std::string& table_path) noexcept;
+
+    /**
+     * Constructor. Opens the table file.
+     *
+     * @param table_path path of the table file to write
+     * @param block_size number of rows per block
+     * @param compression compression of the table file
+     */
+    explicit SweepTable(const std::string& table_path,
+                        size_t block_size = 1'024,
+                        Compression compression = Compression::None) noexcept;
+
+    /**
+     * Destructor.
+     * Closes the table if it's still open.
+     */
+    ~SweepTable() noexcept;
+
+    SweepTable(const SweepTable&) = delete;
+    SweepTable& operator=(const SweepTable&) = delete;
+
+    /**
+     * Append the row of a sweep point.
+     *
+     * @param result result of the point
+     */
+    void append(const SweepResult& result) noexcept;
+
+    /**
+     * Write the rows appended so far, even if their block isn't full.
+     */
+    void flush() noexcept;
+
+    /**
+     * Write the remaining rows, then close the table file.
+     */
+    void close() noexcept;
+
+    /**
+     * Get the number of rows appended so far.
+     *
+     * @return number of rows
+     */
+    [[nodiscard]] uint64_t get_rows_count() const noexcept;
+
+  private:
+    /// table file
+    CompressedOutput table_file;
+
+    /// number of rows per block
+    size_t block_size;
+
+    /// block being filled
+    SweepColumns block;
+
+    /// number of rows appended so far
+    uint64_t rows_count;
+
+    /// guards the table, as points finish on concurrent workers
+    mutable std::mutex table_mutex;
+
+    /**
+     * Write the block to the table file and empty it. Called with table_mutex held.
+     */
+    void write_block() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
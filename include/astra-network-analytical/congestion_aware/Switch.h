@@ -8,6 +8,8 @@ LICENSE file in the root directory of this source tree.
 #include "common/Type.h"
 #include "congestion_aware/BasicTopology.h"
 #include <cassert>
+#include <deque>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -27,9 +29,14 @@ namespace NetworkAnalyticalCongestionAware {
  * For example, send(0 -> 2) flows through:
  * 0 -> switch -> 2
  * so takes 2 hops.
+ *
+ * The switch can also aggregate the chunks of a reduction in the network (SHARP-style, see create_reduction).
  */
 class Switch final : public BasicTopology {
   public:
+    /// id of an in-network reduction
+    using ReductionId = int;
+
     /**
      * Constructor.
      *
@@ -40,13 +47,159 @@ class Switch final : public BasicTopology {
     Switch(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
     /**
-     * Implementation of route function in Topology.
+     * Implementation of compute_route function in Topology.
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of next_hop function in Topology.
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology, in closed form.
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of compute_metrics function in Topology, in closed form.
+     */
+    [[nodiscard]] TopologyMetrics compute_metrics(int threads_count = 0) const noexcept override;
+
+    /**
+     * Write the route from src to dest (the one compute_route returns) into a caller-provided buffer.
+     * Defined inline, so loops templated on Switch (see StaticRouting.h) route without virtual calls.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param route buffer of at least get_max_route_length() device ids
+     * @return number of devices written
+     */
+    int write_route(const DeviceId src, const DeviceId dest, DeviceId* const route) const noexcept {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+
+        // start at source, and go to switch, then go to destination
+        route[0] = src;
+        route[1] = switch_id;
+        route[2] = dest;
+        return 3;
+    }
+
+    /**
+     * Get the largest number of devices of a route.
+     *
+     * @return largest number of devices of a route
+     */
+    [[nodiscard]] int get_max_route_length() const noexcept {
+        return 3;
+    }
+
+    /**
+     * Start an in-network reduction among the given NPUs.
+     * Each member sends its contribution up to the switch (see contribute),
+     * which aggregates the contributions and, once all of them arrived, sends a single result down to every member.
+     * Each switch -> NPU link thus carries one chunk per reduction, however many members contribute.
+     *
+     * @param members NPUs taking part in the reduction
+     * @param chunk_size size of each contribution, and of the result
+     * @param callback callback to be invoked when the result arrives at each member
+     * @param callback_arg argument of the callback
+     * @return id of the reduction, valid until the result arrived at every member
+     */
+    [[nodiscard]] ReductionId create_reduction(const std::vector<DeviceId>& members,
+                                               ChunkSize chunk_size,
+                                               Callback callback,
+                                               CallbackArg callback_arg) noexcept;
+
+    /**
+     * Send the contribution of a member to a reduction up to the switch.
+     * Each member contributes once.
+     *
+     * @param reduction_id id of the reduction
+     * @param npu contributing member
+     */
+    void contribute(ReductionId reduction_id, DeviceId npu) noexcept;
+
+    /**
+     * Run an all-reduce in the network: start a reduction, with every member contributing right away.
+     *
+     * @param members NPUs taking part in the all-reduce
+     * @param chunk_size size of the reduced buffer
+     * @param callback callback to be invoked when the result arrives at each member
+     * @param callback_arg argument of the callback
+     */
+    void all_reduce(const std::vector<DeviceId>& members,
+                    ChunkSize chunk_size,
+                    Callback callback,
+                    CallbackArg callback_arg) noexcept;
+
+    /**
+     * Get the number of reductions whose result didn't arrive at every member yet.
+     *
+     * @return number of active reductions
      */
-    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept override;
+    [[nodiscard]] int get_active_reductions_count() const noexcept;
 
   private:
+    /**
+     * State of an in-network reduction.
+     */
+    struct Reduction {
+        /// switch aggregating the reduction
+        Switch* topology;
+
+        /// id of the reduction
+        ReductionId reduction_id;
+
+        /// members of the reduction
+        std::vector<DeviceId> members;
+
+        /// size of each contribution, and of the result
+        ChunkSize chunk_size;
+
+        /// number of contributions yet to arrive at the switch
+        int pending_contributions_count;
+
+        /// number of members the result is yet to arrive at
+        int pending_results_count;
+
+        /// callback to be invoked when the result arrives at each member
+        Callback callback;
+
+        /// argument of the callback
+        CallbackArg callback_arg;
+    };
+
     /// node_id of the switch node
     DeviceId switch_id;
+
+    /// one-hop route from each NPU up to the switch
+    std::vector<Route> uplink_routes;
+
+    /// one-hop route from the switch down to each NPU
+    std::vector<Route> downlink_routes;
+
+    /// reductions, indexed by id (a deque, so in-flight chunks can point to them)
+    std::deque<Reduction> reductions;
+
+    /// ids of the finished reductions, reused by new ones
+    std::vector<ReductionId> free_reduction_ids;
+
+    /**
+     * Callback of a contribution arriving at the switch:
+     * the last one sends the result down to every member.
+     *
+     * @param reduction_ptr pointer to the reduction
+     */
+    static void contribution_arrived(void* reduction_ptr) noexcept;
+
+    /**
+     * Callback of the result arriving at a member.
+     *
+     * @param reduction_ptr pointer to the reduction
+     */
+    static void result_arrived(void* reduction_ptr) noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
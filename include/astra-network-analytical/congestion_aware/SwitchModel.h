@@ -0,0 +1,98 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkScheduler.h"
+#include "common/Type.h"
+#include "congestion_aware/Chunk.h"
+#include "congestion_aware/Type.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * SwitchModel models the inside of each switch (every device beyond the NPUs, see Topology::set_switch_model),
+ * instead of forwarding any number of chunks through a switch at once.
+ *
+ * A chunk arriving at a switch crosses its crossbar before entering its next link:
+ * the crossbar moves a chunk at a time at the aggregate crossbar_bandwidth (in arrival order),
+ * and the chunk takes the traversal latency on top of it, distinct from the latency of the links.
+ * Once every input port of a switch receives at full rate, chunks thus wait for the crossbar.
+ */
+class SwitchModel {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs (devices from npus_count on are switches)
+     * @param devices_count number of devices
+     * @param crossbar_bandwidth aggregate crossbar bandwidth of each switch in GB/s (0: unlimited)
+     * @param traversal_latency time a chunk takes to cross a switch in ns, on top of its crossbar time
+     */
+    SwitchModel(int npus_count, int devices_count, Bandwidth crossbar_bandwidth, Latency traversal_latency) noexcept;
+
+    /**
+     * Callback invoked when a chunk crossed its switch: sends it through its next link.
+     *
+     * @param chunk_ptr pointer to the chunk
+     */
+    static void chunk_switched(void* chunk_ptr) noexcept;
+
+    /**
+     * Move a chunk that arrived at a switch across the crossbar.
+     * The chunk enters its next link through its topology once across.
+     *
+     * @param chunk chunk at a switch, whose topology is set
+     * @param scheduler scheduler of the topology
+     */
+    void traverse(std::unique_ptr<Chunk> chunk, NetworkScheduler& scheduler) noexcept;
+
+    /**
+     * Get the number of chunks that crossed a switch.
+     *
+     * @param device switch id
+     * @return number of switched chunks
+     */
+    [[nodiscard]] uint64_t get_switched_chunks_count(DeviceId device) const noexcept;
+
+    /**
+     * Get the total time chunks waited for the crossbar of a switch, while it moved other chunks.
+     *
+     * @param device switch id
+     * @return total crossbar waiting time, in ticks
+     */
+    [[nodiscard]] EventTime get_crossbar_waiting_time(DeviceId device) const noexcept;
+
+    /**
+     * Free every crossbar and clear the counters, e.g., when the topology is reset.
+     */
+    void reset() noexcept;
+
+  private:
+    /// number of NPUs (devices from npus_count on are switches)
+    int npus_count;
+
+    /// time the crossbar takes to move a byte, in ticks (0: unlimited bandwidth)
+    double crossbar_ticks_per_byte;
+
+    /// time a chunk takes to cross a switch on top of its crossbar time, in ticks
+    EventTime traversal_delay;
+
+    /// time the crossbar of each switch gets free
+    std::vector<EventTime> crossbar_free_times;
+
+    /// number of chunks that crossed each switch
+    std::vector<uint64_t> switched_chunks_counts;
+
+    /// total time chunks waited for the crossbar of each switch
+    std::vector<EventTime> crossbar_waiting_times;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -0,0 +1,275 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Synthetic traffic pattern, picking the dest of each chunk from its src.
+ * Grid patterns view the NPUs as a row-major grid of (x, y) coordinates.
+ */
+enum class TrafficPattern {
+    /// uniformly random dest
+    UniformRandom,
+
+    /// (x, y) -> (y, x), on a square grid
+    Transpose,
+
+    /// NPU i -> NPU (npus_count - 1 - i), i.e., every bit complemented on a power-of-2 NPU count
+    BitComplement,
+
+    /// (x, y) -> (x + ceil(width / 2) - 1, y + ceil(height / 2) - 1), wrapping around
+    Tornado,
+
+    /// a fraction of the chunks to the hotspot NPU, the others uniformly random
+    Hotspot
+};
+
+/**
+ * Process deciding when an NPU injects its chunks (open loop: regardless of the delivered ones).
+ */
+enum class InjectionProcess {
+    /// a chunk per time slot (serialization time of a chunk at the injection bandwidth) with probability offered_load
+    Bernoulli,
+
+    /// exponentially distributed inter-arrival times, averaging a slot / offered_load
+    Poisson
+};
+
+/**
+ * Configuration of synthetic traffic.
+ */
+struct SyntheticTrafficConfig {
+    /// traffic pattern
+    TrafficPattern pattern = TrafficPattern::UniformRandom;
+
+    /// injection process
+    InjectionProcess injection_process = InjectionProcess::Bernoulli;
+
+    /// offered load per NPU, as a fraction of the injection bandwidth (at most 1 for Bernoulli injection)
+    double offered_load = 0.1;
+
+    /// injection bandwidth of each NPU in GB/s, the load is relative to
+    Bandwidth injection_bandwidth = 50;
+
+    /// size of each chunk
+    ChunkSize chunk_size = 1'024;
+
+    /// width of the NPU grid of grid patterns (0: square grid)
+    int grid_width = 0;
+
+    /// hotspot NPU of TrafficPattern::Hotspot
+    DeviceId hotspot = 0;
+
+    /// fraction of the chunks sent to the hotspot by TrafficPattern::Hotspot
+    double hotspot_fraction = 0.1;
+
+    /// time before the chunks are measured, in ticks
+    EventTime warmup_time = 0;
+
+    /// time the chunks are measured for (injection stops afterwards), in ticks
+    EventTime measure_time = 1'000'000;
+
+    /// seed of the random number generator
+    uint64_t seed = 0;
+};
+
+/**
+ * Measured load and latency of synthetic traffic at an offered load.
+ */
+struct LoadLatencyPoint {
+    /// offered load per NPU, as a fraction of the injection bandwidth
+    double offered_load;
+
+    /// load delivered during the measurement, per NPU, as a fraction of the injection bandwidth
+    double accepted_load;
+
+    /// mean latency (injection to delivery) of the chunks injected during the measurement, in ticks
+    double mean_latency;
+
+    /// largest latency of the chunks injected during the measurement, in ticks
+    EventTime max_latency;
+
+    /// number of chunks injected during the measurement
+    uint64_t measured_chunks_count;
+};
+
+/**
+ * Latency-vs-throughput curve of a topology (and routing policy) under synthetic traffic.
+ */
+struct LoadLatencyCurve {
+    /// measured points, by increasing offered load
+    std::vector<LoadLatencyPoint> points;
+
+    /// lowest offered load whose mean latency exceeds the saturation threshold (-1: none)
+    double saturation_load;
+
+    /**
+     * Write the curve as CSV: "offered_load,accepted_load,mean_latency,max_latency,measured_chunks".
+     *
+     * @param csv_path path of the CSV file
+     */
+    void write_csv(const std::string& csv_path) const noexcept;
+};
+
+/**
+ * SyntheticTraffic injects open-loop synthetic traffic into a topology,
+ * and measures the latency and throughput of the chunks, e.g., to evaluate the routing policies of Mesh2D.
+ *
+ * Each NPU injects chunks by its injection process up to warmup_time + measure_time, to the dests of the pattern;
+ * the chunks injected after warmup_time are measured.
+ * Running the event queue to completion then drains the network.
+ */
+class SyntheticTraffic {
+  public:
+    /// constructs a fresh topology (with its routing policy) on the calling thread's default event queue
+    using TopologyFactory = std::function<std::shared_ptr<Topology>()>;
+
+    /**
+     * Measure the latency-vs-throughput curve of a topology over offered loads.
+     * Each load is an independent simulation on a fresh topology, run on a work-stealing thread pool.
+     * The network saturates at the first load whose mean latency exceeds
+     * saturation_latency_factor times the mean latency at the lowest load.
+     *
+     * @param topology_factory constructs the topology of each simulation
+     * @param config traffic configuration (but the offered load)
+     * @param offered_loads offered loads to simulate
+     * @param saturation_latency_factor latency increase marking saturation
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @return load-latency curve
+     */
+    [[nodiscard]] static LoadLatencyCurve sweep_load(const TopologyFactory& topology_factory,
+                                                     const SyntheticTrafficConfig& config,
+                                                     std::vector<double> offered_loads,
+                                                     double saturation_latency_factor = 3.0,
+                                                     int threads_count = 0) noexcept;
+
+    /**
+     * Constructor.
+     *
+     * @param topology topology to inject the traffic into
+     * @param config traffic configuration
+     */
+    SyntheticTraffic(std::shared_ptr<Topology> topology, const SyntheticTrafficConfig& config) noexcept;
+
+    /**
+     * Schedule the first injection of every NPU.
+     * The simulation is then driven by the topology's event queue.
+     */
+    void start() noexcept;
+
+    /**
+     * Pick the dest of a chunk by the traffic pattern.
+     *
+     * @param src src NPU id
+     * @return dest NPU id (src itself if the pattern maps src to itself, so it doesn't inject)
+     */
+    [[nodiscard]] DeviceId pick_dest(DeviceId src) noexcept;
+
+    /**
+     * Get the measured load and latency, once the network drained.
+     *
+     * @return measured point
+     */
+    [[nodiscard]] LoadLatencyPoint get_result() const noexcept;
+
+  private:
+    /// injection state of an NPU, passed as the argument of its injection events
+    struct Source {
+        /// traffic the NPU belongs to
+        SyntheticTraffic* traffic;
+
+        /// NPU id
+        DeviceId npu;
+    };
+
+    /// inline payload of every chunk
+    struct Delivery {
+        /// traffic the chunk belongs to
+        SyntheticTraffic* traffic;
+
+        /// time the chunk was injected
+        EventTime inject_time;
+    };
+
+    /// topology to inject the traffic into
+    std::shared_ptr<Topology> topology;
+
+    /// traffic configuration
+    SyntheticTrafficConfig config;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// width of the NPU grid
+    int grid_width;
+
+    /// height of the NPU grid
+    int grid_height;
+
+    /// serialization time of a chunk at the injection bandwidth, in ticks
+    EventTime slot_time;
+
+    /// random number generator
+    std::mt19937_64 random_engine;
+
+    /// injection state of each NPU
+    std::vector<Source> sources;
+
+    /// number of chunks injected during the measurement
+    uint64_t measured_chunks_count;
+
+    /// total latency of the measured chunks
+    double latency_sum;
+
+    /// largest latency of the measured chunks
+    EventTime max_latency;
+
+    /// bytes delivered during the measurement
+    uint64_t measured_delivered_bytes;
+
+    /**
+     * Inject a chunk from an NPU, and schedule its next injection.
+     *
+     * @param source_ptr pointer to the injection state of the NPU
+     */
+    static void inject(void* source_ptr) noexcept;
+
+    /**
+     * Callback of every chunk.
+     *
+     * @param delivery_ptr pointer to the payload of the delivered chunk
+     */
+    static void chunk_delivered(void* delivery_ptr) noexcept;
+
+    /**
+     * Draw the time to the next injection of an NPU.
+     *
+     * @return inter-arrival time in ticks
+     */
+    [[nodiscard]] EventTime next_interarrival_time() noexcept;
+
+    /**
+     * Draw a uniformly random dest other than src.
+     *
+     * @param src src NPU id
+     * @return dest NPU id
+     */
+    [[nodiscard]] DeviceId uniform_dest(DeviceId src) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -6,32 +6,271 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/EventQueue.h"
+#include "common/MemoryUsage.h"
+#include "common/NetworkScheduler.h"
+#include "common/Telemetry.h"
 #include "congestion_aware/Chunk.h"
-#include "congestion_aware/Device.h"
+#include "congestion_aware/ChunkPool.h"
+#include "congestion_aware/CompletionLog.h"
+#include "congestion_aware/LatencyHistograms.h"
+#include "congestion_aware/Link.h"
+#include "congestion_aware/LinkTable.h"
+#include "congestion_aware/MulticastTree.h"
+#include "congestion_aware/NicModel.h"
+#include "congestion_aware/RouteCache.h"
+#include "congestion_aware/SwitchModel.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using namespace NetworkAnalytical;
 
 namespace NetworkAnalyticalCongestionAware {
 
+/**
+ * Statistics counters of the chunks delivered through a Topology.
+ * Only updated if NETWORK_ANALYTICAL_ENABLE_STATS is set.
+ */
+struct ChunkStats {
+    /// number of chunks arrived at their destination
+    uint64_t chunks_delivered = 0;
+
+    /// total number of hops traversed by the delivered chunks
+    uint64_t hops_count = 0;
+
+    /// total time the delivered chunks waited for busy links
+    EventTime queueing_delay = 0;
+
+    /// largest queueing delay of a single delivered chunk
+    EventTime max_queueing_delay = 0;
+
+    /// number of times chunks were fast forwarded over their next hops
+    uint64_t chunks_fast_forwarded = 0;
+};
+
+/**
+ * Accounting of the chunks of one job delivered through a Topology (see Topology::set_job_accounting).
+ */
+struct JobStats {
+    /// number of chunks of the job arrived at their destination
+    uint64_t chunks_delivered = 0;
+
+    /// total size of the delivered chunks
+    uint64_t bytes_delivered = 0;
+
+    /// earliest time a delivered chunk of the job was injected
+    EventTime first_inject_time = 0;
+
+    /// latest time a chunk of the job was delivered
+    EventTime last_delivery_time = 0;
+
+    /**
+     * Get the completion time of the job: from its first injection to its last delivery.
+     *
+     * @return completion time (0 if no chunk was delivered)
+     */
+    [[nodiscard]] EventTime completion_time() const noexcept {
+        return (chunks_delivered == 0) ? 0 : last_delivery_time - first_inject_time;
+    }
+
+    /**
+     * Get the slowdown of the job relative to its completion time when run alone on the same topology,
+     * i.e., how much the jobs it shared the topology with delayed it.
+     *
+     * @param isolated_completion_time completion time of the job run alone
+     * @return completion time over isolated completion time (1: no interference)
+     */
+    [[nodiscard]] double slowdown(const EventTime isolated_completion_time) const noexcept {
+        assert(isolated_completion_time > 0);
+        return static_cast<double>(completion_time()) / static_cast<double>(isolated_completion_time);
+    }
+};
+
+/**
+ * Chunk to be injected by Topology::send_batch.
+ */
+struct ChunkDescriptor {
+    /// src NPU id
+    DeviceId src;
+
+    /// dest NPU id
+    DeviceId dest;
+
+    /// size of the chunk
+    ChunkSize chunk_size;
+
+    /// callback to be invoked when the chunk arrives destination
+    Callback callback;
+
+    /// argument of the callback, e.g., a tag telling the chunks of a collective apart
+    CallbackArg callback_arg;
+
+    /// traffic class of the chunk (see Topology::set_queueing_policy)
+    int traffic_class = 0;
+
+    /// job the chunk belongs to (see Topology::set_job_accounting)
+    int job_id = 0;
+};
+
+/// Batched completion callback: "void func(const uint64_t* chunk_ids, int chunks_count, void* arg)"
+using BatchCallback = void (*)(const uint64_t*, int, CallbackArg);
+
+/**
+ * Memory used by a Topology and the simulation it drives, per category.
+ * Collected regardless of NETWORK_ANALYTICAL_ENABLE_STATS.
+ */
+struct MemoryFootprint {
+    /// links (materialized ones), CSR adjacency and one-hop routes of hop-by-hop chunks
+    MemoryUsage link_graph;
+
+    /// shared routes, topology-specific route and next-hop tables, and the route cache
+    MemoryUsage route_tables;
+
+    /// chunks of the chunk pool: in flight (bytes) and ever allocated (peak_bytes)
+    MemoryUsage chunks;
+
+    /// event lists of the event queue
+    MemoryUsage event_queue;
+
+    /// chunks waiting for or being serialized by links (a share of chunks)
+    MemoryUsage link_queues;
+
+    /**
+     * Get the total bytes in use, link queues being part of the chunks.
+     *
+     * @return total bytes
+     */
+    [[nodiscard]] uint64_t total_bytes() const noexcept {
+        return link_graph.bytes + route_tables.bytes + chunks.bytes + event_queue.bytes;
+    }
+
+    /**
+     * Get the sum of the peaks of each category (the categories may peak at different times).
+     *
+     * @return total peak bytes
+     */
+    [[nodiscard]] uint64_t total_peak_bytes() const noexcept {
+        return link_graph.peak_bytes + route_tables.peak_bytes + chunks.peak_bytes + event_queue.peak_bytes;
+    }
+};
+
+/**
+ * Structural metrics of a topology (see Topology::compute_metrics),
+ * e.g., to prune design points before simulating them.
+ */
+struct TopologyMetrics {
+    /// largest number of hops between two NPUs
+    int diameter = 0;
+
+    /// average number of hops between two distinct NPUs
+    double average_hops_count = 0;
+
+    /// bandwidth from the first half of the NPUs (in id order) to the other half, in GB/s
+    Bandwidth bisection_bandwidth = 0;
+
+    /// number of links of each dimension
+    std::vector<int> links_count_per_dim;
+};
+
+/**
+ * Routes of many (src, dest) pairs in a single contiguous buffer (see Topology::route_batch), CSR-style:
+ * the devices of the i-th route, src and dest included, occupy devices[offsets[i], offsets[i + 1]).
+ */
+struct RouteBatch {
+    /// start of each route in devices, followed by the end of the last route
+    std::vector<uint64_t> offsets;
+
+    /// devices of every route, route after route
+    std::vector<DeviceId> devices;
+};
+
 /**
  * Topology abstracts a network topology.
  */
 class Topology {
   public:
     /**
-     * Set the event queue to be used by the topology.
+     * Set the default event queue of topologies created on the calling thread.
+     * A topology without its own event queue (see attach_event_queue) uses this one.
      *
      * @param event_queue pointer to the event queue
      */
     static void set_event_queue(std::shared_ptr<EventQueue> event_queue) noexcept;
 
+    /**
+     * Register the links touched by chunk transmission events on the event queue,
+     * so that same-time events of different links can be invoked concurrently
+     * (see EventQueue::set_parallel_invocation).
+     * Events touching state beyond their link still run alone: chunks arriving at their destination
+     * (which invoke user callbacks), fast forwarded, hop-by-hop and message chunks, chunks crossing a switch model,
+     * chunks sent while links are failed,
+     * and the events of links charging bounded buffers (see Link::set_buffer_capacity).
+     *
+     * @param event_queue event queue to register the resources on
+     */
+    static void register_event_resources(EventQueue& event_queue) noexcept;
+
+    /**
+     * Register the order keys of chunk transmission events on the event queue,
+     * so that same-time events are invoked in an order independent of the engine
+     * (see EventQueue::set_deterministic_order):
+     * chunk arrivals and link-free events are ordered by the endpoints of their link.
+     *
+     * @param event_queue event queue to register the order keys on
+     */
+    static void register_event_order_keys(EventQueue& event_queue) noexcept;
+
     /**
      * Constructor.
      */
     Topology() noexcept;
 
+    /**
+     * Destructor. Withdraws the gauge exposed to the telemetry, if any,
+     * and hands the storage over to the Reclaimer if background teardown is enabled.
+     */
+    virtual ~Topology() noexcept;
+
+    /**
+     * Set the event queue driving this topology.
+     * Topologies with separate event queues are independent simulations,
+     * which can run concurrently on different threads.
+     *
+     * @param new_event_queue pointer to the event queue
+     */
+    void attach_event_queue(std::shared_ptr<EventQueue> new_event_queue) noexcept;
+
+    /**
+     * Get the event queue driving this topology.
+     *
+     * @return pointer to the event queue, nullptr if not set
+     */
+    [[nodiscard]] std::shared_ptr<EventQueue> get_event_queue() const noexcept;
+
+    /**
+     * Set the scheduler driving this topology, e.g., an adapter to a host simulator's event queue,
+     * so that link and chunk events are scheduled straight into it.
+     * If the scheduler is an EventQueue, this is the same as attach_event_queue.
+     *
+     * @param new_scheduler pointer to the scheduler
+     */
+    void attach_scheduler(std::shared_ptr<NetworkScheduler> new_scheduler) noexcept;
+
+    /**
+     * Get the scheduler driving this topology.
+     *
+     * @return pointer to the scheduler, nullptr if not set
+     */
+    [[nodiscard]] std::shared_ptr<NetworkScheduler> get_scheduler() const noexcept;
+
     /**
      * Construct the route from src to dest.
      * Route is a list of devices (pointers) that the chunk should traverse,
@@ -42,93 +281,1619 @@ class Topology {
      * @param src src NPU id
      * @param dest dest NPU id
      *
+     * Routes are served from the route cache when available,
+     * otherwise computed by compute_route() and cached.
+     *
      * @return route from src NPU to dest NPU
      */
-    [[nodiscard]] virtual Route route(DeviceId src, DeviceId dest) const noexcept = 0;
+    [[nodiscard]] Route route(DeviceId src, DeviceId dest) const noexcept;
 
     /**
-     * Initiate a transmission of a chunk.
+     * Get the route from src to dest, shared by every chunk sent from src to dest.
+     * Routes are computed once, owned by the topology, and never change afterwards,
+     * so chunks refer to them instead of holding their own copy.
      *
-     * @param chunk chunk to be transmitted
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return route from src NPU to dest NPU, valid as long as the topology
      */
-    void send(std::unique_ptr<Chunk> chunk) noexcept;
+    [[nodiscard]] const Route* shared_route(DeviceId src, DeviceId dest) const noexcept;
 
     /**
-     * Get the number of NPUs in the topology.
-     * NPU excludes non-NPU devices such as switches.
+     * Compute the routes of many (src, dest) pairs into a single contiguous buffer, spread over threads,
+     * e.g., for tools reading the whole routing matrix at once.
+     * Routes are the ones of route(src, dest), computed by compute_route() without going through the route cache.
      *
-     * @return number of NPUs in the topology
+     * @param pairs (src, dest) NPU ids of each route
+     * @param threads_count number of worker threads (0: number of hardware threads)
+     * @return routes of the pairs, in the given order
      */
-    [[nodiscard]] int get_npus_count() const noexcept;
+    [[nodiscard]] RouteBatch route_batch(const std::vector<std::pair<DeviceId, DeviceId>>& pairs,
+                                         int threads_count = 0) const noexcept;
 
     /**
-     * Get the number of devices in the topology.
-     * Device includes non-NPU devices such as switches.
+     * Get the number of hops of the route from src to dest (the one route() returns).
+     * Regular building blocks compute it without constructing the route (SparseMesh2D walks its next-hop table);
+     * the default counts the hops of route(src, dest).
      *
-     * @return number of devices in the topology
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return number of hops
      */
-    [[nodiscard]] int get_devices_count() const noexcept;
+    [[nodiscard]] virtual int get_hops_count(DeviceId src, DeviceId dest) const noexcept;
 
     /**
-     * Get the number of network dimensions.
+     * Get the zero-load latency of a chunk from src to dest, i.e., its delay if it met no other traffic:
+     * the sum of the communication delays (see Link::communication_delay) of the links of route(src, dest),
+     * as chunks are stored and forwarded at each hop.
+     * Regular building blocks, whose links share the parameters of their dimension, compute it from the hops
+     * of each dimension without constructing the route; the default sums the delay of each link of the route.
      *
-     * @return number of network dimensions
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param chunk_size size of the chunk
+     * @return zero-load latency
      */
-    [[nodiscard]] int get_dims_count() const noexcept;
+    [[nodiscard]] virtual EventTime get_zero_load_latency(DeviceId src,
+                                                          DeviceId dest,
+                                                          ChunkSize chunk_size) const noexcept;
 
     /**
-     * Get the number of NPUs per each dimension.
+     * Select the shared route a newly sent chunk takes from src to dest.
+     * Topologies spreading the chunks of a pair over several routes override this (e.g., Mesh2D with O1TURN);
+     * the default is shared_route(src, dest).
      *
-     * @return number of NPUs per each dimension
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param chunk_id id of the chunk
+     * @return route of the chunk, valid as long as the topology
      */
-    [[nodiscard]] std::vector<int> get_npus_count_per_dim() const noexcept;
+    [[nodiscard]] virtual const Route* select_route(DeviceId src, DeviceId dest, uint64_t chunk_id) const noexcept;
 
     /**
-     * Get the bandwidth per each network dimension.
+     * Check if routes are fixed: every chunk from src to dest takes the route of compute_route(src, dest),
+     * and that route doesn't change while simulating, so it can be computed off the simulation thread
+     * (see InjectionPipeline). The default holds unless chunks are routed hop by hop or links are failed
+     * (or scheduled to fail); topologies spreading chunks over several routes or reconfiguring override this.
      *
-     * @return bandwidth per each dimension
+     * @return true if routes are fixed, false otherwise
      */
-    [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
+    [[nodiscard]] virtual bool has_fixed_routes() const noexcept;
 
-  protected:
-    /// number of total devices in the topology
-    /// device includes non-NPU devices such as switches
-    int devices_count;
+    /**
+     * Build the adjacency and every route select_route may return upfront
+     * (the shared route of every NPU pair, and the other routes the topology spreads chunks over),
+     * so that routing lookups only read the topology afterwards, e.g., from concurrent simulations.
+     * The routing policy should be set before.
+     */
+    virtual void build_route_tables() const noexcept;
 
-    /// number of NPUs in the topology
-    /// NPU excludes non-NPU devices such as switches
-    int npus_count;
+    /**
+     * Get the multicast tree from src to a set of dests, shared by every multicast chunk sent along it.
+     * Trees are computed once per (src, dests) pair and owned by the topology, like shared routes.
+     *
+     * @param src src NPU id
+     * @param dests dest NPU ids, in any order
+     * @return multicast tree, valid as long as the topology
+     */
+    [[nodiscard]] const MulticastTree& multicast_tree(DeviceId src, const std::vector<DeviceId>& dests) const noexcept;
 
-    /// number of network dimensions
-    int dims_count;
+    /**
+     * Compute the multicast tree from src to a set of dests, bypassing the tree cache.
+     * The default merges the shared routes from src to each dest, so chunks fork where the routes diverge
+     * (e.g., XY routes of Mesh2D form an XY tree, and routes through a Switch fork at the switch).
+     * Topologies with a dedicated multicast algorithm override this.
+     *
+     * @param src src NPU id
+     * @param dests dest NPU ids, sorted and unique
+     * @return multicast tree
+     */
+    [[nodiscard]] virtual std::unique_ptr<MulticastTree> compute_multicast_tree(
+        DeviceId src, const std::vector<DeviceId>& dests) const noexcept;
 
-    /// number of NPUs per each dimension
-    std::vector<int> npus_count_per_dim;
+    /**
+     * Compute the route from src to dest, bypassing the route cache.
+     * Each topology implements its routing algorithm here.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     *
+     * @return route from src NPU to dest NPU
+     */
+    [[nodiscard]] virtual Route compute_route(DeviceId src, DeviceId dest) const noexcept = 0;
 
-    /// holds the entire device instances in the topology
-    std::vector<std::shared_ptr<Device>> devices;
+    /**
+     * Get the device a chunk at the current device moves to next, on its way to dest.
+     * Routing should be consistent, i.e., the route from each device of a route follows the rest of that route.
+     *
+     * Topologies with closed-form routing override this;
+     * the default takes the second device of shared_route(current, dest), so current should be an NPU.
+     *
+     * @param current current device id
+     * @param dest dest NPU id, other than current
+     * @return next device id
+     */
+    [[nodiscard]] virtual DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept;
 
-    /// bandwidth per each network dimension
-    std::vector<Bandwidth> bandwidth_per_dim;
+    /**
+     * Enable (or disable) hop-by-hop routing of the chunks sent by send(chunk_size, src, dest, ...).
+     * Instead of the route to its destination, a chunk only carries its current hop,
+     * and asks next_hop() for the following one at each device,
+     * so its memory doesn't depend on the path length.
+     *
+     * Hop-by-hop chunks aren't fast forwarded (they don't know their remaining links).
+     *
+     * @param enabled true to enable hop-by-hop routing, false otherwise
+     */
+    void set_hop_by_hop_routing(bool enabled) noexcept;
 
     /**
-     * Instantiate Device objects in the topology.
+     * Set the maximum number of routes to cache.
+     * If the capacity covers all (src, dest) pairs, every route is computed once,
+     * otherwise a direct-mapped cache of the given capacity is used.
+     *
+     * @param capacity maximum number of cached routes, 0 disables caching
      */
-    void instantiate_devices() noexcept;
+    void set_route_cache_capacity(int capacity) noexcept;
 
     /**
-     * Connect src -> dest with the given bandwidth and latency.
-     * (i.e., a `Link` gets constructed between the two npus)
+     * Set the transmission model of every link in the topology.
+     * LinkModel::VirtualTime produces the same timings as LinkModel::Event (default),
+     * without scheduling a link-free event per hop.
+     * LinkModel::Calendar keeps the reserved slots of each link in a calendar, so chunks backfill the gaps
+     * left ahead of the slots reserved in advance (e.g., by fast forwarding), when they fit.
+     * This should be set before any chunk is sent.
      *
-     * if bidirectional=true, dest -> src connection is also established.
+     * @param link_model transmission model
+     */
+    void set_link_model(LinkModel link_model) noexcept;
+
+    /**
+     * Enable (or disable) fast forwarding of chunks over idle links.
+     * A chunk reserves its next link, and claims the following ones as long as they're idle by the time it
+     * reaches them: only its arrival past the last one is scheduled.
+     * If another chunk reaches a claimed link first and is still using it when the claim starts,
+     * the claim (and the later ones of the chunk) is revoked, and the chunk proceeds hop by hop from that link,
+     * so timings match per-hop simulation, up to the order of chunks reaching a link at the same time.
+     * Link states (e.g., busy times and statistics) catch up with the claims once the links are used again,
+     * or once the chunks arrive.
      *
-     * @param src src device id
-     * @param dest dest device id
-     * @param bandwidth bandwidth of link
-     * @param latency latency of link
-     * @param bidirectional true if connection is bidirectional, false otherwise
+     * Fast forwarding requires LinkModel::VirtualTime (which Event links are switched to):
+     * LinkModel::Calendar links aren't claimed, as chunks may overtake each other in their gaps,
+     * and crossbars of a SwitchModel aren't crossed.
+     * This should be set before any chunk is sent.
+     *
+     * @param enabled true to enable fast forwarding, false otherwise
      */
-    void connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
+    void set_fast_forward(bool enabled) noexcept;
+
+    /**
+     * Set the packet size of every link in the topology.
+     * Chunks larger than a packet pipeline across hops as packet trains
+     * (one arrival event per hop, not per packet): a chunk is forwarded once its head packet arrives,
+     * and delivered once its last packet arrives at the destination.
+     * This should be set before any chunk is sent.
+     *
+     * @param packet_size packet size in bytes, 0 to transmit chunks store-and-forward (default)
+     */
+    void set_packet_size(ChunkSize packet_size) noexcept;
+
+    /**
+     * Set the switching mode of every link in the topology.
+     * SwitchingMode::CutThrough (wormhole) models on-chip and wafer-scale NoCs, e.g., Mesh2D or SparseMesh2D:
+     * a chunk's head advances after each link's latency while its tail follows,
+     * reserving each link for the chunk's serialization window, with one arrival event per hop.
+     * This should be set before any chunk is sent.
+     *
+     * @param switching_mode switching mode
+     */
+    void set_switching_mode(SwitchingMode switching_mode) noexcept;
+
+    /**
+     * Set the protocol framing the transfers on every link in the topology (see Link::set_protocol):
+     * each chunk is serialized as MTU-sized packets, each paying its header bytes and inter-packet gap,
+     * computed analytically within the serialization delay (no per-packet event),
+     * so small transfers see a lower effective bandwidth than large ones.
+     * This should be set before any chunk is sent.
+     *
+     * @param mtu largest payload of a packet in bytes (0: a chunk is a single packet)
+     * @param header_size header (and trailer) bytes of every packet
+     * @param packet_gap gap after every packet in ns
+     */
+    void set_link_protocol(ChunkSize mtu, ChunkSize header_size, Latency packet_gap = 0) noexcept;
+
+    /**
+     * Set whether links coalesce the chunks pending back to back on the same route (same next hop and dest):
+     * once the link frees up, the run is transmitted as a single chunk of the combined size,
+     * costing one arrival event per hop and one link-free event per link for the whole run.
+     * At the last link, the run is split again, each chunk delivered once its own bytes are serialized,
+     * as if the chunks had been transmitted back to back.
+     * Earlier hops forward the run as a whole (store-and-forward), so chunks may be delivered slightly later.
+     * Only applies to unpacketized, store-and-forward links without a critical path, under LinkModel::Event.
+     * This should be set before any chunk is sent.
+     *
+     * @param enabled true to coalesce chunks, false otherwise (default)
+     */
+    void set_chunk_coalescing(bool enabled) noexcept;
+
+    /**
+     * Set the order in which every link serves its pending chunks, by their traffic class (see QueueingPolicy),
+     * e.g., to serve latency-critical tensor-parallel traffic ahead of data-parallel gradients.
+     * This should be set before any chunk is sent.
+     *
+     * @param queueing_policy queueing policy
+     * @param class_weights weight of each traffic class in chunks per turn, for WeightedRoundRobin
+     *                      (empty: 1 for every class)
+     */
+    void set_queueing_policy(QueueingPolicy queueing_policy, const std::vector<int>& class_weights = {}) noexcept;
+
+    /**
+     * Set whether every link serves its pending chunks round robin across input ports
+     * (the device each chunk came from), instead of in arrival order,
+     * so a flow arriving at a shared link later isn't starved by a long burst queued ahead of it.
+     * Per-port sub-queues are linked through the chunks, so arbitration doesn't allocate.
+     * This should be set before any chunk is sent.
+     *
+     * @param enabled true to arbitrate across input ports, false otherwise (default)
+     */
+    void set_source_arbitration(bool enabled) noexcept;
+
+    /**
+     * Bound the buffer of every link, in bytes, instead of letting its pending chunks grow without limit.
+     * A link forwards a chunk only once the next link's buffer has room for it (credit-based backpressure):
+     * otherwise the chunk waits at the upstream link, blocking the chunks queued behind it (head-of-line blocking).
+     * This bounds the chunks in flight between devices, while chunks still wait for their first link unbounded.
+     * Only applies to LinkModel::Event links, and routes with cyclic buffer dependencies may deadlock,
+     * leaving chunks undelivered once the event queue drains.
+     * This should be set before any chunk is sent.
+     *
+     * @param buffer_capacity buffer capacity of every link in bytes (0: unbounded, default)
+     */
+    void set_link_buffer_capacity(ChunkSize buffer_capacity) noexcept;
+
+    /**
+     * Meter how fast each NPU injects chunks into the network through its NIC (see NicModel),
+     * instead of handing every sent chunk to its first link right away:
+     * at most max_outstanding_chunks chunks per NPU are in flight, and admitted chunks are moved
+     * by dma_engines_count DMA engines sharing the injection bandwidth before entering the network.
+     * Multicast chunks aren't metered.
+     * This should be set before any chunk is sent.
+     *
+     * @param injection_bandwidth injection bandwidth of each NIC in GB/s (0: unlimited)
+     * @param max_outstanding_chunks largest number of chunks in flight per NPU (0: unlimited)
+     * @param dma_engines_count number of DMA engines of each NIC
+     */
+    void set_nic_model(Bandwidth injection_bandwidth, int max_outstanding_chunks, int dma_engines_count = 1) noexcept;
+
+    /**
+     * Get the NIC model of the topology.
+     *
+     * @return NIC model, nullptr if injection isn't metered
+     */
+    [[nodiscard]] const NicModel* get_nic_model() const noexcept;
+
+    /**
+     * Limit how fast each NPU absorbs the chunks it receives (e.g., its HBM or PCIe write bandwidth),
+     * instead of absorbing arrivals from all its inbound links at once, so incast is bound by the destination.
+     * The ingress of an NPU writes the chunks in their arrival order, each write overlapping its reception:
+     * a chunk is delivered once it arrived and the ingress wrote it after the chunks ahead of it,
+     * so chunks are only delayed once they arrive faster than the ingress bandwidth.
+     * The chunks of a message are written one after the other, and multicast chunks aren't metered.
+     * This should be set before any chunk is sent.
+     *
+     * @param ingress_bandwidth ingress bandwidth of each NPU in GB/s (0: unlimited, default)
+     */
+    void set_ingress_bandwidth(Bandwidth ingress_bandwidth) noexcept;
+
+    /**
+     * Get the ingress bandwidth of each NPU.
+     *
+     * @return ingress bandwidth in GB/s, 0 if unlimited
+     */
+    [[nodiscard]] Bandwidth get_ingress_bandwidth() const noexcept;
+
+    /**
+     * Model the inside of every switch (every device beyond the NPUs, see SwitchModel),
+     * instead of forwarding any number of chunks through a switch at once:
+     * chunks cross the crossbar of each switch on their way, a chunk at a time at crossbar_bandwidth,
+     * taking traversal_latency on top of it,
+     * and each output port (link leaving a switch) buffers at most port_buffer_capacity bytes,
+     * the links forwarding into a full port holding their chunks back (see Link::set_buffer_capacity).
+     * Bounded ports materialize every link, and override set_link_buffer_capacity for the links leaving switches.
+     * Chunks don't fast forward across switches, and multicast chunks don't cross crossbars.
+     * This should be set before any chunk is sent (and after set_link_buffer_capacity, if set).
+     *
+     * @param crossbar_bandwidth aggregate crossbar bandwidth of each switch in GB/s (0: unlimited)
+     * @param traversal_latency time a chunk takes to cross a switch in ns, on top of its crossbar time
+     * @param port_buffer_capacity buffer capacity of each output port in bytes (0: unbounded)
+     */
+    void set_switch_model(Bandwidth crossbar_bandwidth,
+                          Latency traversal_latency,
+                          ChunkSize port_buffer_capacity = 0) noexcept;
+
+    /**
+     * Get the switch model of the topology.
+     *
+     * @return switch model, nullptr if chunks cross switches at once
+     */
+    [[nodiscard]] const SwitchModel* get_switch_model() const noexcept;
+
+    /**
+     * Fail (or restore) the link src -> dest from the current time on.
+     * Chunks are routed around the failed links: the next-hop tables are repaired only for the destinations
+     * the change affects (see repair_routes), the chunks pending at a failing link are rerouted from its src,
+     * and chunks whose remaining route crosses a failed link are rerouted at their next hop.
+     * The chunks a link is transmitting as it fails still arrive,
+     * as do the chunks already scheduled on LinkModel::VirtualTime links. Multicast chunks aren't rerouted.
+     * Chunks cut off from their destination wait for a restore scheduled by schedule_link_failure,
+     * which is an error if none is.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param failed true to fail the link, false to restore it
+     */
+    void set_link_failed(DeviceId src, DeviceId dest, bool failed) noexcept;
+
+    /**
+     * Fail (or restore) every link to and from a device (e.g., a defective die) from the current time on,
+     * see set_link_failed.
+     *
+     * @param device device id
+     * @param failed true to fail the device, false to restore it
+     */
+    void set_device_failed(DeviceId device, bool failed) noexcept;
+
+    /**
+     * Fail (or restore) the link src -> dest at a simulated time (see set_link_failed).
+     *
+     * @param time time of the change, not before the current time
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param failed true to fail the link, false to restore it
+     */
+    void schedule_link_failure(EventTime time, DeviceId src, DeviceId dest, bool failed) noexcept;
+
+    /**
+     * Fail (or restore) every link to and from a device at a simulated time (see set_device_failed).
+     *
+     * @param time time of the change, not before the current time
+     * @param device device id
+     * @param failed true to fail the device, false to restore it
+     */
+    void schedule_device_failure(EventTime time, DeviceId device, bool failed) noexcept;
+
+    /**
+     * Check if a link is failed.
+     *
+     * @param link_id id of the link
+     * @return true if the link is failed, false otherwise
+     */
+    [[nodiscard]] bool is_link_failed(LinkId link_id) const noexcept;
+
+    /**
+     * Get the number of failed links.
+     *
+     * @return number of failed links
+     */
+    [[nodiscard]] int get_failed_links_count() const noexcept;
+
+    /**
+     * Initiate a transmission of a chunk from its current device.
+     * This is also used to forward the chunk at every intermediate hop.
+     *
+     * @param chunk chunk to be transmitted
+     */
+    void send(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Initiate a transmission of a chunk taken from the topology's chunk pool.
+     * The chunk is recycled into the pool once it arrives at its destination.
+     *
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param callback_arg argument of the callback
+     * @param traffic_class traffic class of the chunk (see set_queueing_policy)
+     * @param job_id job the chunk belongs to (see set_job_accounting)
+     */
+    void send(ChunkSize chunk_size,
+              DeviceId src,
+              DeviceId dest,
+              Callback callback,
+              CallbackArg callback_arg,
+              int traffic_class = 0,
+              int job_id = 0) noexcept;
+
+    /**
+     * Initiate a transmission of a message of chunks_count equally-sized chunks, e.g., a pipelined collective step,
+     * with a single chunk taken from the topology's chunk pool standing for all of them.
+     * The message crosses the links as a train, the chunks as its packets (see Link::train_packet_size),
+     * so it costs the events of a single chunk per hop; it's only split into its chunks at a busy link,
+     * where other chunks may interleave with them.
+     * At the destination, each chunk is delivered (and the callback invoked) once it arrived,
+     * the arrivals derived from the train's head and tail.
+     *
+     * @param chunk_size size of each chunk
+     * @param chunks_count number of chunks of the message
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when each chunk arrives destination
+     * @param callback_arg argument of the callback
+     * @param traffic_class traffic class of the chunks (see set_queueing_policy)
+     * @param job_id job the chunks belong to (see set_job_accounting)
+     */
+    void send_message(ChunkSize chunk_size,
+                      int chunks_count,
+                      DeviceId src,
+                      DeviceId dest,
+                      Callback callback,
+                      CallbackArg callback_arg,
+                      int traffic_class = 0,
+                      int job_id = 0) noexcept;
+
+    /**
+     * Initiate a transmission of a chunk taken from the topology's chunk pool,
+     * carrying a small user payload inline (see Chunk::set_payload):
+     * the callback is invoked with a pointer to the chunk's copy of the payload.
+     *
+     * @tparam Payload trivially copyable type of at most Chunk::payload_capacity bytes
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param payload payload passed to the callback
+     */
+    template <typename Payload>
+    void send_with_payload(const ChunkSize chunk_size,
+                           const DeviceId src,
+                           const DeviceId dest,
+                           const Callback callback,
+                           const Payload& payload) noexcept {
+        auto chunk = acquire_chunk(chunk_size, src, dest, callback, nullptr);
+        chunk->set_payload(payload);
+        send(std::move(chunk));
+    }
+
+    /**
+     * Initiate a transmission of a chunk taken from the chunk pool along a given route,
+     * e.g., a route to or from a non-NPU device, which shared_route doesn't cover,
+     * or a route whose hops were mapped onto other links (see Collective::set_symmetric).
+     *
+     * @param route route of the chunk with its links resolved, which should outlive the chunk
+     * @param chunk_size size of the chunk
+     * @param callback callback to be invoked when the chunk arrives at the end of the route
+     * @param callback_arg argument of the callback
+     * @param traffic_class traffic class of the chunk (see set_queueing_policy)
+     * @param job_id job the chunk belongs to (see set_job_accounting)
+     */
+    void send_along(const Route* route,
+                    ChunkSize chunk_size,
+                    Callback callback,
+                    CallbackArg callback_arg,
+                    int traffic_class = 0,
+                    int job_id = 0) noexcept;
+
+    /**
+     * Initiate the transmissions of a batch of chunks taken from the topology's chunk pool,
+     * e.g., every chunk of a collective, with the same result as sending them one by one in order.
+     * Chunk ids are reserved at once, routes are resolved from the route cache,
+     * and the chunks starting on the same link are enqueued to it together.
+     *
+     * @param descriptors chunks to be sent
+     * @param count number of chunks
+     */
+    void send_batch(const ChunkDescriptor* descriptors, int count) noexcept;
+
+    /**
+     * Initiate a multicast of a chunk from src to a set of dests (e.g., a broadcast),
+     * modeling hardware multicast: the chunk crosses every edge of the multicast tree once,
+     * and forks at the devices where the tree branches.
+     * The callback is invoked at every dest the chunk arrives at.
+     *
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dests dest NPU ids, in any order
+     * @param callback callback to be invoked when the chunk arrives at each dest
+     * @param callback_arg argument of the callback
+     */
+    void multicast(ChunkSize chunk_size,
+                   DeviceId src,
+                   const std::vector<DeviceId>& dests,
+                   Callback callback,
+                   CallbackArg callback_arg) noexcept;
+
+    /**
+     * Clear the dynamic state of the topology in O(links), so another workload can run on it:
+     * link states and pending chunks, chunk statistics, and chunk ids.
+     * Devices, links, settings and route tables are kept.
+     * The event queue is reset separately (see EventQueue::reset), as it may drive other topologies.
+     */
+    void reset() noexcept;
+
+    /**
+     * Rebind the bandwidth and latency of every link of a dimension in O(links),
+     * so a parameter sweep reuses the devices, links, and route tables of a single topology.
+     * Links should be idle, e.g., right after construction or reset().
+     *
+     * @param dim dimension whose links are rebound
+     * @param bandwidth new bandwidth of the dimension
+     * @param latency new latency of the dimension
+     */
+    void set_dim_parameters(int dim, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Override the bandwidth and latency of the link src -> dest, e.g., a degraded or upgraded link.
+     * Lazy links aren't materialized for it (see LinkTable::set_link_parameters).
+     * Links should be idle, e.g., right after construction or reset(); set_dim_parameters overrides it back.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param bandwidth new bandwidth of the link
+     * @param latency new latency of the link
+     */
+    void set_link_parameters(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Override the bandwidth and latency of every link of a link group (see get_link_group),
+     * e.g., "row 2" of a mesh or "dim 1", in O(links).
+     * Links should be idle, e.g., right after construction or reset().
+     *
+     * @param group name of the link group
+     * @param bandwidth new bandwidth of the links
+     * @param latency new latency of the links
+     */
+    void set_link_group_parameters(const std::string& group, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Vary the bandwidth of the link src -> dest over simulated time (see Link::set_bandwidth_schedule),
+     * e.g., thermal throttling, link retraining, or background traffic.
+     * Lazy links aren't materialized for it. Links should be idle, e.g., right after construction or reset().
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param schedule steps of the schedule, in increasing time order (empty: constant bandwidth)
+     */
+    void set_link_bandwidth_schedule(DeviceId src, DeviceId dest, const BandwidthSchedule& schedule) noexcept;
+
+    /**
+     * Vary the bandwidth of every link of a link group (see get_link_group) over simulated time,
+     * in O(links), the links sharing a single copy of the schedule.
+     * Links should be idle, e.g., right after construction or reset().
+     *
+     * @param group name of the link group
+     * @param schedule steps of the schedule, in increasing time order (empty: constant bandwidth)
+     */
+    void set_link_group_bandwidth_schedule(const std::string& group, const BandwidthSchedule& schedule) noexcept;
+
+    /**
+     * Load the link src -> dest with background traffic over simulated time (see Link::set_background_schedule):
+     * the traffic isn't simulated, but leaves its chunks only the rest of the bandwidth of the link,
+     * at no extra event cost. Lazy links aren't materialized for it.
+     * Links should be idle, e.g., right after construction or reset().
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param schedule utilization steps, in increasing time order (a single step at time 0: constant load,
+     *                 empty: no background traffic)
+     */
+    void set_link_background_schedule(DeviceId src, DeviceId dest, const BackgroundSchedule& schedule) noexcept;
+
+    /**
+     * Load every link of a link group (see get_link_group) with background traffic over simulated time,
+     * in O(links), the links sharing a single copy of the schedule.
+     * Links should be idle, e.g., right after construction or reset().
+     *
+     * @param group name of the link group
+     * @param schedule utilization steps, in increasing time order (empty: no background traffic)
+     */
+    void set_link_group_background_schedule(const std::string& group, const BackgroundSchedule& schedule) noexcept;
+
+    /**
+     * Leave only a share of the bandwidth of a link to its chunks (see Link::set_bandwidth_share),
+     * e.g., the rest being taken by the flows of a HybridModel.
+     *
+     * @param link_id id of the link
+     * @param share share of the bandwidth, in (0, 1]
+     */
+    void set_link_bandwidth_share(LinkId link_id, double share) noexcept;
+
+    /**
+     * Give every link of a dimension several parallel channels (e.g., NVLink lanes between the same devices),
+     * each with the dimension's bandwidth, so the bandwidth between two devices scales with the channels count.
+     * Chunks are either striped across all channels, or each served by a single free channel (see ChannelMode).
+     * Links should be idle, e.g., right after construction or reset().
+     *
+     * @param dim dimension whose links get the channels
+     * @param channels_count number of channels per link
+     * @param channel_mode use of the channels
+     */
+    void set_dim_channels(int dim, int channels_count, ChannelMode channel_mode = ChannelMode::Striped) noexcept;
+
+    /**
+     * Get the dimension a link belongs to.
+     * Links of 1-dim topologies all belong to dimension 0.
+     *
+     * @param link_id id of the link
+     * @return dimension of the link
+     */
+    [[nodiscard]] virtual int get_link_dim(LinkId link_id) const noexcept;
+
+    /**
+     * Get the name of the group a link is reported in by dump_link_ranking,
+     * i.e., its dimension (e.g., "dim 1"), unless the topology groups its links otherwise.
+     *
+     * @param link_id id of the link
+     * @return name of the group of the link
+     */
+    [[nodiscard]] virtual std::string get_link_group(LinkId link_id) const noexcept;
+
+    /**
+     * Get the chunk pool of the topology.
+     * Chunks acquired from this pool can be passed to send(std::unique_ptr<Chunk>).
+     *
+     * @return chunk pool of the topology
+     */
+    [[nodiscard]] ChunkPool& get_chunk_pool() noexcept;
+
+    /**
+     * Record every chunk delivered from now on into the given completion log.
+     * Chunks get ids in the order they are injected.
+     * Needs the observer hooks compiled in (see common/Observers.h).
+     *
+     * @param new_completion_log completion log, nullptr to stop recording
+     */
+    void set_completion_log(std::shared_ptr<CompletionLog> new_completion_log) noexcept;
+
+    /**
+     * Record the latency, queueing delay, and hops of every chunk delivered from now on
+     * into the given histograms.
+     * Needs the observer hooks compiled in (see common/Observers.h).
+     *
+     * @param new_latency_histograms latency histograms, nullptr to stop recording
+     */
+    void set_latency_histograms(std::shared_ptr<LatencyHistograms> new_latency_histograms) noexcept;
+
+    /**
+     * Expose the chunks in flight (acquired from the chunk pool and not delivered yet) as the
+     * network_analytical_live_chunks gauge of the given telemetry, sampled whenever the event loop publishes
+     * its progress (see EventQueue::set_telemetry).
+     *
+     * @param new_telemetry telemetry to expose the gauge to, nullptr to stop exposing it
+     */
+    void set_telemetry(std::shared_ptr<Telemetry> new_telemetry) noexcept;
+
+    /**
+     * Set whether the storage of the topology (its links, shared routes, and pooled chunks) is released on the
+     * background thread of the Reclaimer when the topology is destroyed, so discarding a finished simulation of
+     * millions of links returns at once instead of running every destructor on the discarding thread.
+     *
+     * @param enabled true to release the storage in the background, false otherwise (default)
+     */
+    void set_background_teardown(bool enabled) noexcept;
+
+    /**
+     * Notify the chunks delivered from now on in batches instead of one by one:
+     * the chunks arriving at their destinations at the same time are reported by a single callback,
+     * invoked with their ids once they all arrived (in the order they arrived).
+     * The callbacks of the chunks themselves aren't invoked meanwhile.
+     *
+     * @param new_batch_callback callback receiving the ids of the delivered chunks, nullptr to notify chunks one by one
+     * @param new_batch_callback_arg argument of the callback
+     */
+    void set_batched_completion(BatchCallback new_batch_callback,
+                                CallbackArg new_batch_callback_arg = nullptr) noexcept;
+
+    /**
+     * Record every transmission through the links from now on into the given trace.
+     * Needs the observer hooks compiled in (see common/Observers.h).
+     *
+     * @param new_link_trace link trace, nullptr to stop recording
+     */
+    void set_link_trace(std::shared_ptr<LinkTrace> new_link_trace) noexcept;
+
+    /**
+     * Record every transmission through the links from now on into the given critical path tracker,
+     * to extract the chain of hops and link waits that determined the finish time (see CriticalPath).
+     * The tracker is cleared by reset().
+     * Needs the observer hooks compiled in (see common/Observers.h).
+     *
+     * @param new_critical_path critical path tracker, nullptr to stop recording
+     */
+    void set_critical_path(std::shared_ptr<CriticalPath> new_critical_path) noexcept;
+
+    /**
+     * Sample the load of the links from now on into the given utilization sampler.
+     * Rows of the sampler are added in link order.
+     * Needs the observer hooks compiled in (see common/Observers.h).
+     *
+     * @param new_utilization_sampler utilization sampler, nullptr to stop sampling
+     */
+    void set_utilization_sampler(std::shared_ptr<UtilizationSampler> new_utilization_sampler) noexcept;
+
+    /**
+     * Get the number of NPUs in the topology.
+     * NPU excludes non-NPU devices such as switches.
+     *
+     * @return number of NPUs in the topology
+     */
+    [[nodiscard]] int get_npus_count() const noexcept;
+
+    /**
+     * Get the number of devices in the topology.
+     * Device includes non-NPU devices such as switches.
+     *
+     * @return number of devices in the topology
+     */
+    [[nodiscard]] int get_devices_count() const noexcept;
+
+    /**
+     * Get the number of (directed) links in the topology.
+     *
+     * @return number of links in the topology
+     */
+    [[nodiscard]] int get_links_count() const noexcept;
+
+    /**
+     * Get the number of links created so far.
+     * Topologies with lazy links (e.g., FullyConnected) only create the links chunks go through.
+     *
+     * @return number of materialized links in the topology
+     */
+    [[nodiscard]] int get_materialized_links_count() const noexcept;
+
+    /**
+     * Get a link of the topology.
+     *
+     * @param link_id id of the link
+     * @return link of the given id
+     */
+    [[nodiscard]] const Link& get_link(LinkId link_id) const noexcept;
+
+    /**
+     * Get the current load of a link, e.g., for a host-side algorithm choosing routes by network state.
+     * Lazy links aren't materialized by the query: the ones not used yet are idle.
+     *
+     * @param link_id id of the link
+     * @return load of the link
+     */
+    [[nodiscard]] LinkLoad get_link_load(LinkId link_id) const noexcept;
+
+    /**
+     * Copy the current load of a range of links into a caller buffer, without materializing lazy links.
+     *
+     * @param first_link_id id of the first link of the range
+     * @param links_count number of links of the range
+     * @param loads output: load of each link of the range, holding at least links_count entries
+     */
+    void snapshot_link_loads(LinkId first_link_id, int links_count, LinkLoad* loads) const noexcept;
+
+    /**
+     * Find the link connecting src -> dest.
+     * Topologies with closed-form link ids override this;
+     * the default searches the CSR adjacency.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @return id of the link, -1 if src is not connected to dest
+     */
+    [[nodiscard]] virtual LinkId find_link(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the number of network dimensions.
+     *
+     * @return number of network dimensions
+     */
+    [[nodiscard]] int get_dims_count() const noexcept;
+
+    /**
+     * Get the number of NPUs per each dimension.
+     *
+     * @return number of NPUs per each dimension
+     */
+    [[nodiscard]] std::vector<int> get_npus_count_per_dim() const noexcept;
+
+    /**
+     * Get the bandwidth per each network dimension.
+     *
+     * @return bandwidth per each dimension
+     */
+    [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
+
+    /**
+     * Compute the structural metrics of the topology:
+     * the hops between NPUs along the shortest paths of the link graph (regardless of the routing),
+     * the bandwidth of the bisection splitting the NPUs in id order (across every channel of the links,
+     * through any device; for the regular building blocks, a cut of their highest dimension in half),
+     * and the links of each dimension.
+     * Regular building blocks compute them in closed form.
+     * The default runs a BFS from every NPU, spread over threads, and a max-flow from one half of the NPUs
+     * to the other, so it also covers irregular (e.g., SparseMesh2D or custom) graphs.
+     * Every NPU should reach every other one.
+     *
+     * @param threads_count number of worker threads of the BFS (0: number of hardware threads)
+     * @return metrics of the topology
+     */
+    [[nodiscard]] virtual TopologyMetrics compute_metrics(int threads_count = 0) const noexcept;
+
+    /**
+     * Get the NPUs in the order of a ring embedded in the topology (e.g., for the Ring collective algorithm),
+     * consecutive NPUs, and the last and the first, being as few hops apart as possible.
+     * Grids override this (e.g., a Hamiltonian cycle of Mesh2D); the default is the NPU id order.
+     *
+     * @return every NPU id once, in ring order
+     */
+    [[nodiscard]] virtual std::vector<DeviceId> get_ring_order() const noexcept;
+
+    /**
+     * Get the cells of a width x height grid without wrap-around in the order of a ring through adjacent cells:
+     * a Hamiltonian cycle if a side is even, a line folded back on itself (every other cell out, the rest back)
+     * if a side is 1, and rows in boustrophedon order otherwise (only the last cell isn't next to the first).
+     *
+     * @param width number of columns
+     * @param height number of rows
+     * @return every cell index (y * width + x) once, in ring order
+     */
+    [[nodiscard]] static std::vector<int> grid_ring_order(int width, int height) noexcept;
+
+    /**
+     * Get the statistics counters of the chunks delivered through the topology.
+     *
+     * @return statistics counters
+     */
+    [[nodiscard]] const ChunkStats& get_chunk_stats() const noexcept;
+
+    /**
+     * Get the number of routes computed by compute_route so far (routes served by the route cache
+     * or shared by the chunks are only computed once). Counted only if NETWORK_ANALYTICAL_ENABLE_STATS is set.
+     *
+     * @return number of computed routes
+     */
+    [[nodiscard]] uint64_t get_routes_computed_count() const noexcept;
+
+    /**
+     * Set whether the chunks delivered from now on are accounted per job (see Chunk::set_job_id),
+     * so several workloads (e.g., Collective, TraceReplay) sharing the topology can be told apart.
+     * Accounting costs a few counter updates per delivered chunk, regardless of NETWORK_ANALYTICAL_ENABLE_STATS.
+     *
+     * @param enabled true to account chunks per job, false otherwise (default)
+     */
+    void set_job_accounting(bool enabled) noexcept;
+
+    /**
+     * Get the accounting of the delivered chunks per job, indexed by job id
+     * (up to the largest job id delivered so far).
+     *
+     * @return accounting of each job
+     */
+    [[nodiscard]] const std::vector<JobStats>& get_job_stats() const noexcept;
+
+    /**
+     * Print a summary of the simulation statistics:
+     * event queue counters, link utilization, and chunk hop/queueing delays.
+     * This is meant to be called once the simulation is finished.
+     *
+     * @param output stream to print the summary to
+     */
+    void dump_stats(std::ostream& output) const noexcept;
+
+    /**
+     * Rank the materialized links from the most to the least loaded:
+     * by busy time, then by the queueing delay imposed on chunks, then by peak number of pending chunks.
+     * Links of equal load keep their LinkId order.
+     *
+     * @return ids of the materialized links, most loaded first
+     */
+    [[nodiscard]] std::vector<LinkId> rank_links() const noexcept;
+
+    /**
+     * Print a bottleneck report:
+     * the load of each link group (see get_link_group), most loaded first,
+     * then the most loaded links (see rank_links).
+     * This is meant to be called once the simulation is finished.
+     *
+     * @param output stream to print the report to
+     * @param top_links_count number of links to list
+     */
+    void dump_link_ranking(std::ostream& output, int top_links_count = 10) const noexcept;
+
+    /**
+     * Get the memory used by the topology and its simulation, per category.
+     * Peaks cover the storage pools and containers kept for reuse,
+     * and every usage observed by previous calls (e.g., from a periodic callback),
+     * so link queues peak at the largest occupancy observed by the calls.
+     *
+     * @return memory footprint
+     */
+    [[nodiscard]] MemoryFootprint get_memory_footprint() const noexcept;
+
+    /**
+     * Print the memory footprint of the topology and its simulation, per category.
+     *
+     * @param output stream to print the footprint to
+     */
+    void dump_memory_footprint(std::ostream& output) const noexcept;
+
+  protected:
+    /// default event queue of topologies created on each thread
+    static thread_local std::shared_ptr<EventQueue> default_event_queue;
+
+    /// routes interned per (src, dest): rows indexed by src, allocated on first use (empty routes: not yet computed)
+    using RouteTable = std::vector<std::unique_ptr<Route[]>>;
+
+    /// scheduler driving this topology
+    std::shared_ptr<NetworkScheduler> scheduler;
+
+    /// event queue driving this topology (nullptr if the scheduler isn't an EventQueue)
+    std::shared_ptr<EventQueue> event_queue;
+
+    /// recycles chunks sent through this topology
+    ChunkPool chunk_pool;
+
+    /// memoizes routes, as the topology is static after construction
+    mutable RouteCache route_cache;
+
+    /// number of total devices in the topology
+    /// device includes non-NPU devices such as switches
+    int devices_count;
+
+    /// number of NPUs in the topology
+    /// NPU excludes non-NPU devices such as switches
+    int npus_count;
+
+    /// number of network dimensions
+    int dims_count;
+
+    /// number of NPUs per each dimension
+    std::vector<int> npus_count_per_dim;
+
+    /// holds the entire (directed) links in the topology, indexed by LinkId
+    /// (links never move once created, as in-flight events point into it)
+    LinkTable links;
+
+    /// CSR adjacency, built lazily once the links are in place:
+    /// outgoing links of device i occupy [adjacency_offsets[i], adjacency_offsets[i + 1])
+    /// of adjacency_dests and adjacency_link_ids, sorted by dest
+    mutable std::vector<int> adjacency_offsets;
+
+    /// dest device of each adjacency entry
+    mutable std::vector<DeviceId> adjacency_dests;
+
+    /// link id of each adjacency entry
+    mutable std::vector<LinkId> adjacency_link_ids;
+
+    /// bandwidth per each network dimension
+    std::vector<Bandwidth> bandwidth_per_dim;
+
+    /// statistics counters of the delivered chunks
+    ChunkStats chunk_stats;
+
+    /// guards chunk_stats, as chunks may be delivered by concurrent partitions
+    std::mutex chunk_stats_mutex;
+
+    /// number of routes computed by compute_route, as routes may be computed by concurrent partitions
+    mutable std::atomic<uint64_t> routes_computed;
+
+    /// true if the delivered chunks are accounted per job
+    bool job_accounting;
+
+    /// accounting of the delivered chunks per job id
+    std::vector<JobStats> job_stats;
+
+    /// guards job_stats, as chunks may be delivered by concurrent partitions
+    std::mutex job_stats_mutex;
+
+    /// log delivered chunks are recorded into (nullptr: not recorded)
+    std::shared_ptr<CompletionLog> completion_log;
+
+    /// histograms delivered chunks are recorded into (nullptr: not recorded)
+    std::shared_ptr<LatencyHistograms> latency_histograms;
+
+    /// telemetry the chunks in flight are exposed to (nullptr: none)
+    std::shared_ptr<Telemetry> telemetry;
+
+    /// callback the delivered chunks are notified through in batches (nullptr: notified one by one)
+    BatchCallback batch_callback;
+
+    /// argument of batch_callback
+    CallbackArg batch_callback_arg;
+
+    /// ids of the chunks delivered at the current time, not notified yet
+    std::vector<uint64_t> delivered_chunk_ids;
+
+    /// id of the next sent chunk (atomic, as partitions may send concurrently)
+    std::atomic<uint64_t> next_chunk_id;
+
+    /// true if chunks are routed one hop at a time
+    bool hop_by_hop_routing;
+
+    /// one-hop route of every link, shared by hop-by-hop chunks (built once hop-by-hop routing is enabled)
+    std::vector<Route> link_routes;
+
+    /// routes shared by the chunks
+    mutable RouteTable shared_routes;
+
+    /// multicast trees shared by the multicast chunks, keyed by src followed by the sorted dests
+    mutable std::map<std::vector<DeviceId>, std::unique_ptr<MulticastTree>> multicast_trees;
+
+    /// trace link transmissions are recorded into (nullptr: not recorded)
+    std::shared_ptr<LinkTrace> link_trace;
+
+    /// critical path tracker link transmissions are recorded into (nullptr: not recorded)
+    std::shared_ptr<CriticalPath> critical_path;
+
+    /// sampler the load of the links is aggregated into (nullptr: not sampled)
+    std::shared_ptr<UtilizationSampler> utilization_sampler;
+
+    /// true if chunks are fast forwarded over idle links
+    bool fast_forward;
+
+    /// true if the storage is released on the background thread of the Reclaimer (see set_background_teardown)
+    bool background_teardown;
+
+    /// NIC model metering the injection of chunks (nullptr: chunks enter their first link right away)
+    std::unique_ptr<NicModel> nic_model;
+
+    /// switch model moving chunks across switches (nullptr: chunks cross switches at once)
+    std::unique_ptr<SwitchModel> switch_model;
+
+    /// ingress bandwidth of each NPU in GB/s (0: unlimited)
+    Bandwidth ingress_bandwidth;
+
+    /// time the ingress of an NPU takes to write a byte, in ticks (0: unlimited)
+    double ingress_ticks_per_byte;
+
+    /// time the ingress of each NPU finishes writing the chunks received so far (empty if unlimited)
+    std::vector<EventTime> ingress_free_times;
+
+    /// failed links (see set_link_failed)
+    std::unordered_set<LinkId> failed_links;
+
+    /// largest memory usage observed by get_memory_footprint
+    mutable MemoryFootprint peak_memory_footprint;
+
+    /**
+     * Get the bytes held by the route tables of the topology.
+     * Topologies keeping their own route or next-hop tables extend this.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] virtual uint64_t get_route_tables_bytes() const noexcept;
+
+    /**
+     * Get the bytes held by a route table.
+     *
+     * @param route_table route table
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t route_table_bytes(const RouteTable& route_table) const noexcept;
+
+    /**
+     * Connect src -> dest with the given bandwidth and latency.
+     * (i.e., a `Link` gets constructed between the two npus)
+     *
+     * if bidirectional=true, dest -> src connection is also established.
+     *
+     * @param src src device id
+     * @param dest dest device id
+     * @param bandwidth bandwidth of link
+     * @param latency latency of link
+     * @param bidirectional true if connection is bidirectional, false otherwise
+     */
+    void connect(DeviceId src, DeviceId dest, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
+
+    /**
+     * Connect every (src, dest) pair, in order, with the given bandwidth and latency:
+     * the same links as calling connect(src, dest, bandwidth, latency, false) for each pair,
+     * constructed concurrently (see LinkTable::assign), for topologies built with millions of links.
+     * Only valid before any other link is connected.
+     *
+     * @param endpoints (src, dest) devices of each link, by LinkId
+     * @param bandwidth bandwidth of every link
+     * @param latency latency of every link
+     * @param threads_count number of threads constructing the links (0: number of hardware threads)
+     */
+    void connect_all(const std::vector<std::pair<DeviceId, DeviceId>>& endpoints,
+                     Bandwidth bandwidth,
+                     Latency latency,
+                     int threads_count = 0) noexcept;
+
+    /**
+     * Build the CSR adjacency from the links.
+     */
+    void build_adjacency() const noexcept;
+
+    /**
+     * Get the bandwidth a link carries across all its channels.
+     *
+     * @param link_id id of the link
+     * @return bandwidth of the link times its channels count
+     */
+    [[nodiscard]] Bandwidth get_link_capacity(LinkId link_id) const noexcept;
+
+    /**
+     * Get the average number of hops between two distinct NPUs of a grid, in closed form,
+     * its dimensions being lines or (bidirectional) rings.
+     *
+     * @param sizes number of NPUs along each dimension
+     * @param wrap_around true if the dimensions are rings, false if they are lines
+     * @return average number of hops
+     */
+    [[nodiscard]] static double grid_average_hops_count(const std::vector<int>& sizes, bool wrap_around) noexcept;
+
+    /**
+     * Get the entry of (src, dest) in a route table, allocating its row if needed.
+     * Entries stay empty until a route is stored, and never move afterwards.
+     *
+     * @param route_table route table
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @return entry of (src, dest)
+     */
+    [[nodiscard]] Route& route_table_entry(RouteTable& route_table, DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Get the one-hop route through the link src -> dest, shared by hop-by-hop chunks.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @return one-hop route of the link
+     */
+    [[nodiscard]] const Route& one_hop_route(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Set the link id of every hop of the route.
+     *
+     * @param route route to resolve
+     */
+    void resolve_links(Route& route) const noexcept;
+
+    /**
+     * Fail (or restore) links, repairing the routing and rerouting the chunks pending at failing links.
+     * Restoring links resumes the stranded chunks (see links_restoring).
+     *
+     * @param link_ids ids of the links
+     * @param failed true to fail the links, false to restore them
+     */
+    void set_links_failed(const std::vector<LinkId>& link_ids, bool failed) noexcept;
+
+    /**
+     * Check if failed links are due to come back, so chunks that can't reach their destination around the failed
+     * links wait at their current device (stranded) until links are restored, instead of being an error.
+     * The default checks the link state changes scheduled; topologies restoring links themselves override this.
+     *
+     * @return true if links are due to be restored
+     */
+    [[nodiscard]] virtual bool links_restoring() const noexcept;
+
+    /**
+     * Route the stranded chunks again, once the live links changed (called by set_links_failed on restores).
+     * The chunks still unable to reach their destination stay stranded.
+     */
+    void resume_stranded_chunks() noexcept;
+
+    /**
+     * Repair the next-hop routing after links failed or got restored, for the destinations whose routes change.
+     * The default keeps a detour table (see compute_live_next_hops) per destination chunks got rerouted toward,
+     * recomputing only the tables the changed links affect, and drops them once no link is failed.
+     * Topologies keeping their own next-hop tables repair them instead, along with live_next_hop.
+     *
+     * @param changed_link_ids links whose state changed
+     * @param failed true if the links failed, false if they got restored
+     */
+    virtual void repair_routes(const std::vector<LinkId>& changed_link_ids, bool failed) noexcept;
+
+    /**
+     * Get the next device from current toward dest, around the failed links.
+     *
+     * @param current current device id
+     * @param dest dest NPU id, other than current
+     * @return next device id, -1 if dest can't be reached
+     */
+    [[nodiscard]] virtual DeviceId live_next_hop(DeviceId current, DeviceId dest) const noexcept;
+
+    /**
+     * Compute the next device of every device toward dest over the live (not failed) links,
+     * by a breadth-first search from dest over the incoming links, breaking ties toward the lowest device id.
+     *
+     * @param dest dest device id
+     * @param next_hops next device of each device toward dest (-1 if none), of devices_count entries
+     */
+    void compute_live_next_hops(DeviceId dest, DeviceId* next_hops) const noexcept;
+
+    /**
+     * Build the incoming links of every device (incoming_offsets and incoming_link_ids), if not built yet.
+     */
+    void build_incoming_links() const noexcept;
+
+    /**
+     * Check if the change of a link affects a next-hop table toward dest:
+     * a failed link does if the table takes it, a restored one if it may shorten (or tie) a route of the table.
+     *
+     * @param next_hops next device of each device toward dest (-1 if none)
+     * @param dest dest device id
+     * @param link_id id of the changed link
+     * @param failed true if the link failed, false if it got restored
+     * @return true if the table should be recomputed
+     */
+    [[nodiscard]] bool next_hops_affected(const DeviceId* next_hops,
+                                          DeviceId dest,
+                                          LinkId link_id,
+                                          bool failed) const noexcept;
+
+  private:
+    /**
+     * Change of the state of a link or of a device, scheduled at a simulated time.
+     */
+    struct LinkStateChange {
+        /// time of the change
+        EventTime time;
+
+        /// src device of the link, or the device
+        DeviceId src;
+
+        /// dest device of the link (-1: every link to and from the device src)
+        DeviceId dest;
+
+        /// true to fail, false to restore
+        bool failed;
+    };
+
+    /**
+     * Reservation of a link a fast-forwarded chunk made before reaching it (see try_fast_forward).
+     */
+    struct LinkClaim {
+        /// claimed link
+        LinkId link_id;
+
+        /// time the chunk reaches the link and starts serialization
+        EventTime start_time;
+
+        /// timings of the chunk over the link
+        Link::TrainTiming timing;
+    };
+
+    /**
+     * Chunk fast forwarded over its next hops, with the links it claimed past the first one.
+     * Its arrival past the last claimed link is scheduled with the trip as argument:
+     * revoking claims schedules an earlier arrival, so only the earliest one arrives the chunk.
+     */
+    struct FastForwardTrip {
+        /// topology the chunk is fast forwarded through
+        Topology* topology = nullptr;
+
+        /// chunk fast forwarded (nullptr once arrived)
+        Chunk* chunk = nullptr;
+
+        /// claims of the hops following the chunk's first one, in route order
+        std::vector<LinkClaim> claims;
+
+        /// number of claims committed to their links so far, from the first one
+        int committed_count = 0;
+
+        /// number of arrival events scheduled for the trip and not invoked yet
+        int events_count = 0;
+    };
+
+    /// Chunk reports its delivery
+    friend class Chunk;
+
+    /// ParallelSimulation assigns the links to partitions
+    friend class ParallelSimulation;
+
+    /// DistributedSimulation assigns the links to ranks
+    friend class DistributedSimulation;
+
+    /// TopologyInstance copies the links of the shared topology
+    friend class TopologyInstance;
+
+    /// SwitchModel forwards the chunks that crossed a switch
+    friend class SwitchModel;
+
+    /// incoming links of device i occupy [incoming_offsets[i], incoming_offsets[i + 1]) of incoming_link_ids,
+    /// sorted by src (built on first use, see build_incoming_links)
+    mutable std::vector<int> incoming_offsets;
+
+    /// link id of each incoming adjacency entry
+    mutable std::vector<LinkId> incoming_link_ids;
+
+    /// detour next-hop tables of the destinations chunks got rerouted toward (default repair_routes)
+    mutable std::unordered_map<DeviceId, std::vector<DeviceId>> detour_next_hops;
+
+    /// link state changes scheduled but not applied yet, in the order scheduled
+    std::vector<LinkStateChange> scheduled_link_changes;
+
+    /// claims of each link not committed yet, as (trip, index of the claim in the trip), in start time order
+    /// (links without claims have no entry)
+    std::unordered_map<LinkId, std::vector<std::pair<FastForwardTrip*, int>>> link_claims;
+
+    /// trips arrived, recycled for the next fast-forwarded chunks
+    std::vector<std::unique_ptr<FastForwardTrip>> spare_trips;
+
+    /// chunks waiting at their current device for links to be restored, and whether each waits before send
+    /// (hop-by-hop chunks, resent through send) or before forward
+    std::vector<std::pair<std::unique_ptr<Chunk>, bool>> stranded_chunks;
+
+    /**
+     * Check a bandwidth schedule has positive bandwidths, in increasing time order, exiting otherwise.
+     *
+     * @param schedule steps of the schedule
+     */
+    static void check_bandwidth_schedule(const BandwidthSchedule& schedule) noexcept;
+
+    /**
+     * Check a background traffic schedule has utilizations in [0, 1), in increasing time order, exiting otherwise.
+     *
+     * @param schedule steps of the schedule
+     */
+    static void check_background_schedule(const BackgroundSchedule& schedule) noexcept;
+
+    /**
+     * Callback applying the link state changes scheduled up to the current time.
+     *
+     * @param topology_ptr pointer to the topology
+     */
+    static void apply_scheduled_link_changes(void* topology_ptr) noexcept;
+
+    /**
+     * Forward a chunk through the next link of its route, rerouting it first if the rest of its route
+     * crosses a failed link.
+     *
+     * @param chunk chunk to forward
+     */
+    void forward(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Check if the rest of a chunk's route crosses a failed link.
+     *
+     * @param chunk chunk to check
+     * @return true if the chunk should be rerouted
+     */
+    [[nodiscard]] bool crosses_failed_link(const Chunk& chunk) const noexcept;
+
+    /**
+     * Route a chunk from its current device around the failed links (see live_next_hop).
+     *
+     * @param chunk chunk to reroute, without coalesced chunks
+     * @return true if rerouted, false if the chunk can't reach its destination (its route is left as is)
+     */
+    [[nodiscard]] bool reroute(Chunk& chunk) const noexcept;
+
+    /**
+     * Keep a chunk unable to reach its destination waiting for links to be restored (see links_restoring),
+     * exiting if none is due to be.
+     *
+     * @param chunk chunk to strand
+     * @param resend true to resume it through send, false through forward
+     */
+    void strand(std::unique_ptr<Chunk> chunk, bool resend) noexcept;
+
+    /**
+     * Account a chunk arrived at its destination.
+     *
+     * @param chunk delivered chunk
+     */
+    void record_chunk_delivery(const Chunk& chunk) noexcept;
+
+    /**
+     * Account a chunk arrived at its destination to its job.
+     *
+     * @param chunk delivered chunk
+     */
+    void record_job_delivery(const Chunk& chunk) noexcept;
+
+    /**
+     * Check whether newly injected chunks are stamped with their inject time,
+     * i.e., whether anything recording delivered chunks needs it.
+     *
+     * @return true if chunks are stamped, false otherwise
+     */
+    [[nodiscard]] bool stamps_inject_time() const noexcept;
+
+    /**
+     * Take a chunk from the chunk pool, on the route selected for it (its first hop, if routed hop by hop).
+     *
+     * @param chunk_size size of the chunk
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param callback callback to be invoked when the chunk arrives destination
+     * @param callback_arg argument of the callback
+     * @return chunk ready to be sent
+     */
+    [[nodiscard]] std::unique_ptr<Chunk> acquire_chunk(ChunkSize chunk_size,
+                                                       DeviceId src,
+                                                       DeviceId dest,
+                                                       Callback callback,
+                                                       CallbackArg callback_arg) noexcept;
+
+    /**
+     * Account a chunk arrived at its destination, and notify it (through its callback or the batch callback).
+     *
+     * @param chunk delivered chunk
+     */
+    void deliver_chunk(Chunk& chunk) noexcept;
+
+    /**
+     * Write a chunk arrived at its destination through the ingress of its destination NPU (see set_ingress_bandwidth),
+     * postponing its delivery if the ingress is behind.
+     *
+     * @param chunk chunk arrived at its destination, taken if its delivery is postponed
+     * @return true if the delivery is postponed, false if the chunk should be delivered now
+     */
+    bool write_through_ingress(std::unique_ptr<Chunk>& chunk) noexcept;
+
+    /**
+     * Callback delivering a chunk written by the ingress of its destination NPU.
+     *
+     * @param chunk_ptr pointer to the chunk
+     */
+    static void chunk_written(void* chunk_ptr) noexcept;
+
+    /**
+     * Deliver the first remaining chunk of a message arrived at its destination,
+     * scheduling the arrival of the next one (see send_message).
+     *
+     * @param message message whose first remaining chunk arrived
+     */
+    void deliver_message_chunk(std::unique_ptr<Chunk> message) noexcept;
+
+    /**
+     * Callback delivering the next chunk of a message arrived at its destination.
+     *
+     * @param chunk_ptr pointer to the message
+     */
+    static void message_chunk_arrived(void* chunk_ptr) noexcept;
+
+    /**
+     * Handle a multicast chunk arrived at a node of its tree:
+     * deliver it if the node is a dest, and fork it to the node's children.
+     *
+     * @param chunk arrived multicast chunk
+     */
+    void arrive_multicast(std::unique_ptr<Chunk> chunk) noexcept;
+
+    /**
+     * Send a multicast chunk sitting at a node of its tree through every edge to the node's children:
+     * the chunk itself crosses the first edge, and copies of it the others.
+     * The chunk is released if the node is a leaf.
+     *
+     * @param chunk multicast chunk
+     * @param node node of the tree the chunk sits at
+     */
+    void fork_multicast(std::unique_ptr<Chunk> chunk, int node) noexcept;
+
+    /**
+     * Queue a delivered chunk to be notified in the current batch,
+     * scheduling the batch notification if it's the first chunk delivered at the current time.
+     *
+     * @param chunk delivered chunk
+     */
+    void batch_chunk_delivery(const Chunk& chunk) noexcept;
+
+    /**
+     * Notify the chunks delivered at the current time through the batch callback.
+     *
+     * @param topology_ptr pointer to the topology
+     */
+    static void notify_delivered_chunks(void* topology_ptr) noexcept;
+
+    /**
+     * Get the link a chunk arrival event touches,
+     * i.e., the link the chunk is forwarded to from the device it arrives at.
+     *
+     * @param chunk_ptr pointer to the arriving chunk
+     * @return pointer to the link, nullptr if the event touches more (see register_event_resources)
+     */
+    [[nodiscard]] static const void* chunk_arrival_resource(void* chunk_ptr) noexcept;
+
+    /**
+     * Get the link a link-free event touches.
+     *
+     * @param link_ptr pointer to the link becoming free
+     * @return pointer to the link, nullptr if the link charges the buffers of the next links (touching them too)
+     */
+    [[nodiscard]] static const void* link_free_resource(void* link_ptr) noexcept;
+
+    /**
+     * Get the order key of a link given its endpoints.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @return order key, (src, dest) packed into 64 bits
+     */
+    [[nodiscard]] static uint64_t link_order_key(DeviceId src, DeviceId dest) noexcept;
+
+    /**
+     * Get the order key of a chunk arrival event, i.e., of the link the chunk arrives through.
+     *
+     * @param chunk_ptr pointer to the arriving chunk
+     * @return order key of the event
+     */
+    [[nodiscard]] static uint64_t chunk_arrival_order_key(void* chunk_ptr) noexcept;
+
+    /**
+     * Get the order key of a link-free event, i.e., of the link.
+     *
+     * @param link_ptr pointer to the link becoming free
+     * @return order key of the event
+     */
+    [[nodiscard]] static uint64_t link_free_order_key(void* link_ptr) noexcept;
+
+    /**
+     * Try to fast forward a chunk over its next hops.
+     * The chunk reserves its next link if idle, and claims the following ones as long as they're idle
+     * (and unclaimed) by the time it reaches them; if it claims at least one,
+     * only its arrival at the device past the last one is scheduled.
+     * A claim is committed to its link once the chunk, or another chunk, reaches the link after its start,
+     * and revoked if another chunk reaches the link first and is still using it then (see revoke_claims).
+     *
+     * @param chunk chunk to fast forward, released only if fast forwarded
+     * @return true if the chunk is fast forwarded, false otherwise
+     */
+    bool try_fast_forward(std::unique_ptr<Chunk>& chunk) noexcept;
+
+    /**
+     * Check if a link is idle over an interval, for a chunk starting then,
+     * and if no fast-forwarded chunk claimed it over that interval.
+     *
+     * @param link_id id of the link
+     * @param start_time time the chunk starts serialization
+     * @param link_free_time time the chunk frees the link
+     * @param chunk chunk to transmit
+     * @return true if the link is idle and unclaimed, false otherwise
+     */
+    [[nodiscard]] bool unclaimed_at(LinkId link_id, EventTime start_time, EventTime link_free_time,
+                                    const Chunk& chunk) noexcept;
+
+    /**
+     * Commit the claims of a link started by now, before another chunk is sent over it,
+     * so the chunk queues behind them.
+     *
+     * @param link_id id of the link
+     */
+    void settle_link_claims(LinkId link_id) noexcept;
+
+    /**
+     * Revoke the claims of a link it isn't idle for anymore, once another chunk is sent over it.
+     *
+     * @param link_id id of the link
+     */
+    void revoke_overlapped_claims(LinkId link_id) noexcept;
+
+    /**
+     * Commit the first claims of a trip to their links, in route order.
+     *
+     * @param trip fast-forward trip
+     * @param claims_count number of claims committed from the first one once done
+     */
+    void commit_claims(FastForwardTrip& trip, int claims_count) noexcept;
+
+    /**
+     * Revoke the claims of a trip from one on, as another chunk reached its link first:
+     * the chunk is scheduled to arrive at the src of that link when it was to start serialization,
+     * and goes on from there as if it was forwarded hop by hop.
+     *
+     * @param trip fast-forward trip
+     * @param first_claim index of the first claim revoked
+     */
+    void revoke_claims(FastForwardTrip& trip, int first_claim) noexcept;
+
+    /**
+     * Remove a claim from the claims of its link.
+     *
+     * @param trip fast-forward trip
+     * @param claim index of the claim in the trip
+     */
+    void remove_link_claim(FastForwardTrip* trip, int claim) noexcept;
+
+    /**
+     * Callback to be called when a fast-forwarded chunk arrives past its last claimed link:
+     * its claims are committed, and it arrives at the next device.
+     * Arrivals superseded by revoking claims do nothing.
+     *
+     * @param trip_ptr pointer to the fast-forward trip
+     */
+    static void fast_forward_arrival(void* trip_ptr) noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionAware
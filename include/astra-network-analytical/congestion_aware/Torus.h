@@ -0,0 +1,133 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/BasicTopology.h"
+#include <array>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * Implements a 2D or 3D Torus topology: a mesh whose rows (and columns, and pillars)
+ * wrap around into rings.
+ *
+ * Torus(4, 3) example with width=4, height=3:
+ *
+ *     0 --- 1 --- 2 --- 3 --- (0)
+ *     |     |     |     |
+ *     4 --- 5 --- 6 --- 7 --- (4)
+ *     |     |     |     |
+ *     8 --- 9 --- 10--- 11--- (8)
+ *     |     |     |     |
+ *    (0)   (1)   (2)   (3)
+ *
+ * NPU IDs are laid out X first, then Y, then Z: id = (z * height + y) * width + x.
+ * A dimension of 2 nodes has a single (bidirectional) link, and a dimension of 1 node has none.
+ *
+ * Routing: dimension-order routing (X, then Y, then Z),
+ * taking the shorter way around each ring (the positive one on ties).
+ * - For NPU 0 to NPU 11: 0→3→11 (X wraps around to the left, then Y wraps around up)
+ * - Hops = sum over the dimensions of min(|d|, size - |d|)
+ *
+ * The links are built in linear time of the NPUs count.
+ */
+class Torus final : public BasicTopology {
+  public:
+    /**
+     * Constructor for 2D Torus topology.
+     *
+     * @param width number of nodes in X dimension
+     * @param height number of nodes in Y dimension
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    Torus(int width, int height, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Constructor for 3D Torus topology.
+     *
+     * @param width number of nodes in X dimension
+     * @param height number of nodes in Y dimension
+     * @param depth number of nodes in Z dimension
+     * @param bandwidth bandwidth per link (GB/s)
+     * @param latency latency per link (nanoseconds)
+     */
+    Torus(int width, int height, int depth, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Compute route between two NPUs using dimension-order routing.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return sequence of devices (nodes) to traverse from src to dest
+     */
+    [[nodiscard]] Route compute_route(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Get the next NPU of the dimension-order route toward dest.
+     *
+     * @param current current NPU ID
+     * @param dest destination NPU ID
+     * @return next NPU ID
+     */
+    [[nodiscard]] DeviceId next_hop(DeviceId current, DeviceId dest) const noexcept override;
+
+    /**
+     * Implementation of compute_metrics function in Topology, in closed form
+     * (but the bisection bandwidth of an odd highest dimension, computed by the default).
+     */
+    [[nodiscard]] TopologyMetrics compute_metrics(int threads_count = 0) const noexcept override;
+
+    /**
+     * Implementation of get_link_dim function in Topology: the dimension along which its NPUs differ.
+     */
+    [[nodiscard]] int get_link_dim(LinkId link_id) const noexcept override;
+
+    /**
+     * Implementation of get_hops_count function in Topology, in closed form.
+     *
+     * @param src source NPU ID
+     * @param dest destination NPU ID
+     * @return number of hops
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+  private:
+    /// largest number of torus dimensions
+    static constexpr int max_torus_dims = 3;
+
+    /// number of nodes per dimension (X, Y, Z), 1 for the missing Z of a 2D torus
+    std::array<int, max_torus_dims> sizes;
+
+    /// NPU ID distance between neighbors per dimension
+    std::array<int, max_torus_dims> strides;
+
+    /**
+     * Get the coordinate of an NPU along a dimension.
+     *
+     * @param npu_id NPU ID
+     * @param dim dimension
+     * @return coordinate along dim
+     */
+    [[nodiscard]] int coordinate(DeviceId npu_id, int dim) const noexcept {
+        return (npu_id / strides[dim]) % sizes[dim];
+    }
+
+    /**
+     * Get the step (+1, -1, or 0 once aligned) along the shorter way around a ring.
+     *
+     * @param dim dimension of the ring
+     * @param from current coordinate
+     * @param to dest coordinate
+     * @return step along dim
+     */
+    [[nodiscard]] int ring_step(int dim, int from, int to) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
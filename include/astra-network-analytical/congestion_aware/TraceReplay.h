@@ -0,0 +1,257 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * A message of a binary trace.
+ * Trace files hold a TraceHeader followed by the records, sorted by inject_time.
+ */
+struct TraceRecord {
+    /// dependency value of a record without dependency
+    static constexpr int64_t no_dependency = -1;
+
+    /// earliest time the message is injected
+    EventTime inject_time;
+
+    /// size of the message
+    uint64_t size;
+
+    /// index of an earlier record whose delivery the message waits for (no_dependency: none)
+    int64_t dependency;
+
+    /// NPU sending the message
+    int32_t src;
+
+    /// NPU receiving the message
+    int32_t dest;
+};
+
+/**
+ * Header of a binary trace.
+ */
+struct TraceHeader {
+    /// magic number identifying trace files
+    static constexpr uint64_t trace_magic = 0x31'45'43'41'52'54'41'4E;  // "NATRACE1"
+
+    /// should be trace_magic
+    uint64_t magic;
+
+    /// number of records following the header
+    uint64_t records_count;
+};
+
+/**
+ * TraceReplay replays a binary trace of messages through a topology.
+ *
+ * The trace file is memory-mapped, and messages are injected as the simulated time reaches them:
+ * a single injection event is pending at any time, and chunks are only allocated for in-flight messages,
+ * so traces with hundreds of millions of messages replay without being loaded up front.
+ * A message with a dependency is injected once that record is delivered, if it's later than its inject time.
+ */
+class TraceReplay {
+  public:
+    /**
+     * Write a binary trace file.
+     *
+     * @param trace_path path of the trace file to write
+     * @param records records of the trace, sorted by inject_time
+     */
+    static void write_trace(const std::string& trace_path, const std::vector<TraceRecord>& records) noexcept;
+
+    /**
+     * Constructor.
+     * Maps the trace file into memory.
+     *
+     * @param topology topology to replay the trace on
+     * @param trace_path path of the trace file
+     */
+    TraceReplay(std::shared_ptr<Topology> topology, const std::string& trace_path) noexcept;
+
+    /**
+     * Destructor.
+     * Unmaps the trace file.
+     */
+    ~TraceReplay() noexcept;
+
+    TraceReplay(const TraceReplay&) = delete;
+    TraceReplay& operator=(const TraceReplay&) = delete;
+
+    /**
+     * Schedule the injection of the first messages.
+     * The simulation is then driven by the topology's scheduler.
+     *
+     * @param callback callback to be invoked when every message is delivered (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    void start(Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Set the job every message of the trace belongs to (see Topology::set_job_accounting),
+     * e.g., to replay the traces of several jobs on the same topology.
+     * This should be set before start.
+     *
+     * @param new_job_id job id
+     */
+    void set_job_id(int new_job_id) noexcept;
+
+    /**
+     * Check if every message of the trace was delivered.
+     *
+     * @return true if the replay finished, false otherwise
+     */
+    [[nodiscard]] bool finished() const noexcept;
+
+    /**
+     * Get the time the last message was delivered.
+     *
+     * @return finish time of the replay
+     */
+    [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+    /**
+     * Get the number of records of the trace.
+     *
+     * @return number of records
+     */
+    [[nodiscard]] uint64_t get_records_count() const noexcept;
+
+    /**
+     * Get the number of delivered messages.
+     *
+     * @return number of delivered messages
+     */
+    [[nodiscard]] uint64_t get_delivered_count() const noexcept;
+
+    /**
+     * Get the maximum number of messages that were in flight at the same time.
+     *
+     * @return peak number of in-flight messages
+     */
+    [[nodiscard]] int get_peak_in_flight_messages_count() const noexcept;
+
+  private:
+    /// an in-flight message, passed as the callback argument of its chunk
+    struct Message {
+        /// replay the message belongs to
+        TraceReplay* trace_replay;
+
+        /// index of the record of the message
+        uint64_t record_index;
+    };
+
+    /// topology to replay the trace on
+    std::shared_ptr<Topology> topology;
+
+    /// path of the trace file
+    std::string trace_path;
+
+    /// mapped trace file
+    void* mapped_trace;
+
+    /// size of the mapped trace file
+    size_t mapped_size;
+
+    /// records of the trace (inside mapped_trace)
+    const TraceRecord* records;
+
+    /// number of records of the trace
+    uint64_t records_count;
+
+    /// index of the next record to inject
+    uint64_t next_record;
+
+    /// number of delivered messages
+    uint64_t delivered_count;
+
+    /// delivered flag per record, 64 records per word
+    std::vector<uint64_t> delivered;
+
+    /// records waiting for the delivery of their dependency, per dependency
+    std::unordered_map<uint64_t, std::vector<uint64_t>> waiting_records;
+
+    /// time the last message was delivered
+    EventTime finish_time;
+
+    /// job the messages belong to
+    int job_id;
+
+    /// callback to be invoked when every message is delivered
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+
+    /// storage of in-flight messages (stable addresses, grows to the peak in-flight count)
+    std::deque<Message> messages;
+
+    /// messages ready to be reused
+    std::vector<Message*> free_messages;
+
+    /**
+     * Callback of the injection event:
+     * inject every record whose inject time was reached, then schedule the next injection.
+     *
+     * @param trace_replay_ptr pointer to the replay
+     */
+    static void inject_records(void* trace_replay_ptr) noexcept;
+
+    /**
+     * Callback of every chunk of the replay.
+     *
+     * @param message_ptr pointer to the delivered message
+     */
+    static void message_delivered(void* message_ptr) noexcept;
+
+    /**
+     * Schedule the injection event at the inject time of the next record, if any.
+     */
+    void schedule_next_injection() noexcept;
+
+    /**
+     * Inject a record whose inject time was reached,
+     * or let it wait for its dependency.
+     *
+     * @param record_index index of the record
+     */
+    void inject_record(uint64_t record_index) noexcept;
+
+    /**
+     * Send the message of a record.
+     *
+     * @param record_index index of the record
+     */
+    void send_record(uint64_t record_index) noexcept;
+
+    /**
+     * Mark a record delivered, and inject the records waiting for it.
+     *
+     * @param record_index index of the record
+     */
+    void deliver_record(uint64_t record_index) noexcept;
+
+    /**
+     * Check if a record was delivered.
+     *
+     * @param record_index index of the record
+     * @return true if the record was delivered, false otherwise
+     */
+    [[nodiscard]] bool record_delivered(uint64_t record_index) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
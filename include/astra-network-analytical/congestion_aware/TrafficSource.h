@@ -0,0 +1,214 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_aware/Topology.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * TrafficSource generates the chunks one NPU injects, on demand.
+ * A TrafficInjector pulls the next chunk only when the NPU has room for it,
+ * so a source describes arbitrarily large traffic without materializing it.
+ */
+class TrafficSource {
+  public:
+    /**
+     * Destructor.
+     */
+    virtual ~TrafficSource() noexcept = default;
+
+    /**
+     * Pull the next chunk to inject.
+     *
+     * @param dest [out] dest NPU id of the chunk
+     * @param chunk_size [out] size of the chunk
+     * @return true if a chunk is pulled, false if the source is exhausted
+     */
+    [[nodiscard]] virtual bool pull(DeviceId& dest, ChunkSize& chunk_size) noexcept = 0;
+};
+
+/**
+ * AllToAllSource generates the share of an all-to-all one NPU sends:
+ * a message to every other NPU, in pairwise order (NPU rank + 1, rank + 2, ...),
+ * each split into chunks_count chunks.
+ */
+class AllToAllSource final : public TrafficSource {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param rank NPU the source belongs to
+     * @param npus_count number of NPUs taking part
+     * @param message_size size of the message sent to each other NPU
+     * @param chunks_count number of chunks each message is split into
+     */
+    AllToAllSource(DeviceId rank, int npus_count, ChunkSize message_size, int chunks_count = 1) noexcept;
+
+    /**
+     * Implement the pull method of TrafficSource.
+     */
+    [[nodiscard]] bool pull(DeviceId& dest, ChunkSize& chunk_size) noexcept override;
+
+  private:
+    /// NPU the source belongs to
+    DeviceId rank;
+
+    /// number of NPUs taking part
+    int npus_count;
+
+    /// size of each chunk
+    ChunkSize chunk_size;
+
+    /// number of chunks each message is split into
+    int chunks_count;
+
+    /// index of the next chunk, over every message
+    int64_t next_chunk;
+};
+
+/**
+ * TrafficInjector drives the traffic sources of the NPUs of a topology (pull-based injection).
+ *
+ * Each NPU keeps at most window_size chunks in flight (injected but not delivered yet), modeling NIC injection:
+ * the next chunk is pulled from the NPU's source whenever one of its chunks is delivered.
+ * The number of live chunks and of chunks pending at links thus stays bounded by npus_count * window_size,
+ * however much traffic the sources describe.
+ */
+class TrafficInjector {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to inject the traffic into
+     * @param window_size largest number of chunks each NPU keeps in flight
+     */
+    TrafficInjector(std::shared_ptr<Topology> topology, int window_size = 1) noexcept;
+
+    /**
+     * Set the traffic source of an NPU (NPUs without a source send nothing).
+     *
+     * @param npu NPU id
+     * @param source traffic source of the NPU
+     */
+    void set_source(DeviceId npu, std::unique_ptr<TrafficSource> source) noexcept;
+
+    /**
+     * Fill the window of every NPU.
+     * The simulation is then driven by the topology's event queue.
+     *
+     * @param callback callback to be invoked when every source is exhausted and delivered (nullptr: none)
+     * @param callback_arg argument of the callback
+     */
+    void start(Callback callback = nullptr, CallbackArg callback_arg = nullptr) noexcept;
+
+    /**
+     * Check if every source is exhausted and every chunk delivered.
+     *
+     * @return true if the traffic finished, false otherwise
+     */
+    [[nodiscard]] bool finished() const noexcept;
+
+    /**
+     * Get the time the traffic finished.
+     *
+     * @return finish time of the traffic
+     */
+    [[nodiscard]] EventTime get_finish_time() const noexcept;
+
+    /**
+     * Get the number of chunks delivered so far.
+     *
+     * @return number of delivered chunks
+     */
+    [[nodiscard]] uint64_t get_delivered_chunks_count() const noexcept;
+
+    /**
+     * Get the maximum number of chunks that were in flight at the same time, over every NPU.
+     *
+     * @return peak number of in-flight chunks
+     */
+    [[nodiscard]] int get_peak_in_flight_chunks_count() const noexcept;
+
+  private:
+    /// injection state of an NPU, passed as the callback argument of its chunks
+    struct Injector {
+        /// injector the NPU belongs to
+        TrafficInjector* traffic_injector;
+
+        /// NPU id
+        DeviceId npu;
+
+        /// traffic source of the NPU (nullptr: none)
+        std::unique_ptr<TrafficSource> source;
+
+        /// number of chunks of the NPU in flight
+        int in_flight_chunks_count;
+
+        /// true if the source is exhausted
+        bool exhausted;
+    };
+
+    /// topology to inject the traffic into
+    std::shared_ptr<Topology> topology;
+
+    /// largest number of chunks each NPU keeps in flight
+    int window_size;
+
+    /// injection state of each NPU (never resized once constructed, as chunks point to it)
+    std::vector<Injector> injectors;
+
+    /// number of NPUs whose source isn't exhausted
+    int active_sources_count;
+
+    /// number of chunks in flight, over every NPU
+    int in_flight_chunks_count;
+
+    /// peak of in_flight_chunks_count
+    int peak_in_flight_chunks_count;
+
+    /// number of chunks delivered
+    uint64_t delivered_chunks_count;
+
+    /// true once started
+    bool started;
+
+    /// time the traffic finished
+    EventTime finish_time;
+
+    /// callback to be invoked when the traffic finishes
+    Callback callback;
+
+    /// argument of the callback
+    CallbackArg callback_arg;
+
+    /**
+     * Callback of every injected chunk.
+     *
+     * @param injector_ptr pointer to the injection state of the chunk's src NPU
+     */
+    static void chunk_delivered(void* injector_ptr) noexcept;
+
+    /**
+     * Pull chunks from the source of an NPU until its window is full or the source is exhausted.
+     *
+     * @param injector injection state of the NPU
+     */
+    void fill_window(Injector& injector) noexcept;
+
+    /**
+     * Record the finish time and invoke the callback, if the traffic finished.
+     */
+    void check_finished() noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -5,17 +5,20 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
-#include <list>
-#include <memory>
+#include "congestion_aware/Route.h"
 
 namespace NetworkAnalyticalCongestionAware {
 
 /// Forward declarations of network components
 class Chunk;
+class ChunkPool;
+class ChunkQueue;
+class CriticalPath;
 class Link;
-class Device;
-
-/// Route is a list of devices
-using Route = std::list<std::shared_ptr<Device>>;
+class LinkTrace;
+class MulticastTree;
+class ParallelSimulation;
+class Topology;
+class UtilizationSampler;
 
 }  // namespace NetworkAnalyticalCongestionAware
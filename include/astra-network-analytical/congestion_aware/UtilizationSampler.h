@@ -0,0 +1,179 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionAware {
+
+/**
+ * UtilizationSampler aggregates the load of the links of a topology (see Topology::set_utilization_sampler)
+ * into fixed simulated-time buckets: the bytes each link transmitted and its largest pending chunks count
+ * within each bucket, i.e., a links x buckets matrix.
+ *
+ * Each link only touches its own row, so links of concurrent partitions can record at once.
+ */
+class UtilizationSampler {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param bucket_width width of a bucket in ns
+     */
+    explicit UtilizationSampler(EventTime bucket_width = 1'000) noexcept;
+
+    /**
+     * Add a row for the link src -> dest.
+     *
+     * @param src src device of the link
+     * @param dest dest device of the link
+     * @param bandwidth bandwidth of the link in GB/s
+     * @return row of the link
+     */
+    [[nodiscard]] int add_link(DeviceId src, DeviceId dest, Bandwidth bandwidth) noexcept;
+
+    /**
+     * Record a transmission: its bytes are spread over the buckets the link is busy in.
+     *
+     * @param row row of the link
+     * @param chunk_size size of the transmitted chunk
+     * @param start_time time the transmission started
+     * @param link_free_time time the link got free again
+     */
+    void record_transmission(int row, ChunkSize chunk_size, EventTime start_time, EventTime link_free_time) noexcept;
+
+    /**
+     * Record a change of the pending chunks count of a link.
+     *
+     * @param row row of the link
+     * @param time time of the change
+     * @param pending_chunks_count new pending chunks count
+     */
+    void record_pending_chunks(int row, EventTime time, int pending_chunks_count) noexcept;
+
+    /**
+     * Get the width of a bucket.
+     *
+     * @return bucket width in ns
+     */
+    [[nodiscard]] EventTime get_bucket_width() const noexcept;
+
+    /**
+     * Get the number of rows (links).
+     *
+     * @return number of rows
+     */
+    [[nodiscard]] int get_rows_count() const noexcept;
+
+    /**
+     * Get the number of buckets, i.e., up to the last bucket any link was active in.
+     *
+     * @return number of buckets
+     */
+    [[nodiscard]] size_t get_buckets_count() const noexcept;
+
+    /**
+     * Get the bytes a link transmitted within a bucket.
+     *
+     * @param row row of the link
+     * @param bucket bucket index
+     * @return transmitted bytes
+     */
+    [[nodiscard]] double get_bytes(int row, size_t bucket) const noexcept;
+
+    /**
+     * Get the utilization of a link within a bucket, i.e., transmitted bytes over the bucket capacity.
+     *
+     * @param row row of the link
+     * @param bucket bucket index
+     * @return utilization in [0, 1]
+     */
+    [[nodiscard]] double get_utilization(int row, size_t bucket) const noexcept;
+
+    /**
+     * Get the largest pending chunks count of a link within a bucket.
+     *
+     * @param row row of the link
+     * @param bucket bucket index
+     * @return largest pending chunks count
+     */
+    [[nodiscard]] int get_max_pending_chunks(int row, size_t bucket) const noexcept;
+
+    /**
+     * Write every non-idle (link, bucket) sample as CSV:
+     * src, dest, bucket, bytes, utilization, max_pending_chunks.
+     *
+     * @param csv_path path of the CSV file
+     */
+    void write_samples(const std::string& csv_path) const noexcept;
+
+    /**
+     * Write the hottest outgoing link utilization of each device over a bucket range
+     * as a CSV grid (e.g., of Mesh2D or SparseMesh2D), with empty cells where there's no device.
+     *
+     * @param csv_path path of the CSV file
+     * @param width number of grid columns
+     * @param height number of grid rows
+     * @param device_coords (x, y) grid position of each device, (-1, -1) to leave a device out (e.g., switches)
+     * @param first_bucket first bucket of the range
+     * @param last_bucket bucket past the end of the range, 0 for the last bucket
+     */
+    void write_heatmap(const std::string& csv_path,
+                       int width,
+                       int height,
+                       const std::vector<std::pair<int, int>>& device_coords,
+                       size_t first_bucket = 0,
+                       size_t last_bucket = 0) const noexcept;
+
+  private:
+    /**
+     * Samples of a link.
+     */
+    struct LinkSamples {
+        /// src device of the link
+        DeviceId src = 0;
+
+        /// dest device of the link
+        DeviceId dest = 0;
+
+        /// bytes the link can transmit within a bucket
+        double bucket_capacity = 0;
+
+        /// transmitted bytes per bucket
+        std::vector<double> bytes;
+
+        /// largest pending chunks count per bucket
+        std::vector<int> max_pending_chunks;
+
+        /// pending chunks count at the last change
+        int pending_chunks_count = 0;
+
+        /// bucket of the last pending chunks count change
+        size_t pending_chunks_bucket = 0;
+    };
+
+    /// width of a bucket in ns
+    EventTime bucket_width;
+
+    /// samples of each link
+    std::vector<LinkSamples> rows;
+
+    /**
+     * Grow the row to cover the given bucket.
+     *
+     * @param samples samples of the link
+     * @param bucket bucket index
+     */
+    static void cover_bucket(LinkSamples& samples, size_t bucket) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionAware
@@ -38,6 +38,16 @@ class BasicTopology : public Topology {
      */
     [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
 
+    /**
+     * Implement the send_batch method of Topology.
+     * Hop counts and delays are computed block by block with tight loops.
+     */
+    void send_batch(const DeviceId* srcs,
+                    const DeviceId* dests,
+                    const ChunkSize* chunk_sizes,
+                    EventTime* delays,
+                    int count) const noexcept override;
+
     /**
      * Return the type of the basic topology
      * as a TopologyBuildingBlock enum class element.
@@ -46,6 +56,27 @@ class BasicTopology : public Topology {
      */
     [[nodiscard]] TopologyBuildingBlock get_basic_topology_type() const noexcept;
 
+    /**
+     * Get the latency of each link.
+     *
+     * @return latency of each link in ns
+     */
+    [[nodiscard]] Latency get_latency() const noexcept;
+
+    /**
+     * Get the number of hops between src and dest.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @return number of hops between src and dest
+     */
+    [[nodiscard]] int get_hops_count(DeviceId src, DeviceId dest) const noexcept;
+
+    /**
+     * Implement the get_link_bandwidth method of Topology: every link has the same bandwidth.
+     */
+    [[nodiscard]] Bandwidth get_link_bandwidth(int link_id) const noexcept override;
+
   protected:
     /**
      * Compute the number of hops between src and dest.
@@ -56,10 +87,19 @@ class BasicTopology : public Topology {
      */
     [[nodiscard]] virtual int compute_hops_count(DeviceId src, DeviceId dest) const noexcept = 0;
 
-    /// type of the basic topology
-    TopologyBuildingBlock basic_topology_type;
+    /**
+     * Compute the number of hops of a batch of (src, dest) pairs.
+     * Defaults to calling compute_hops_count per pair.
+     * @param srcs src NPU IDs
+     * @param dests dest NPU IDs
+     * @param hops_counts output: number of hops between each src and dest
+     * @param count number of pairs
+     */
+    virtual void compute_hops_counts(const DeviceId* srcs,
+                                     const DeviceId* dests,
+                                     int* hops_counts,
+                                     int count) const noexcept;
 
-  private:
     /**
      * Analytically compute the communication delay.
      *
@@ -69,14 +109,39 @@ class BasicTopology : public Topology {
      */
     [[nodiscard]] EventTime compute_communication_delay(int hops_count, ChunkSize chunk_size) const noexcept;
 
+    /// type of the basic topology
+    TopologyBuildingBlock basic_topology_type;
+
+  private:
+    /// StaticMultiDimTopology calls the dimensions it holds by their concrete type
+    template <typename... DimTopologies> friend class StaticMultiDimTopology;
+
+    /// number of chunks processed at once by send_batch
+    static constexpr int batch_block_size = 256;
+
+    /**
+     * Analytically compute the communication delay of a batch of chunks.
+     * @param hops_counts number of hops of each chunk
+     * @param chunk_sizes size of each chunk
+     * @param delays output: communication delay of each chunk
+     * @param count number of chunks
+     */
+    void compute_communication_delays(const int* hops_counts,
+                                      const ChunkSize* chunk_sizes,
+                                      EventTime* delays,
+                                      int count) const noexcept;
+
     /// bandwidth of each link in GB/s
     Bandwidth bandwidth;
 
-    /// bandwidth of each link in B/ns, used for actual computation
-    Bandwidth bandwidth_Bpns;
+    /// bandwidth of each link in B/tick, used for actual computation
+    Bandwidth bandwidth_Bptick;
 
     /// latency of each link in ns
     Latency latency;
+
+    /// latency of each link in ticks, used for actual computation
+    double latency_ticks;
 };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
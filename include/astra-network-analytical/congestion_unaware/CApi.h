@@ -0,0 +1,90 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+/*
+ * C API of the congestion-unaware backend, for host simulators embedding it from other languages.
+ * Topologies are opaque handles, and batch calls read and write caller-owned buffers,
+ * so no C++ type crosses the API.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// version of the C API; functions are only ever added, and their signatures never change
+#define ANALYTICAL_UNAWARE_API_VERSION 1
+
+/// opaque handle of a congestion-unaware topology
+typedef struct AnalyticalUnawareTopology AnalyticalUnawareTopology;
+
+/**
+ * Get the version of the C API the library implements.
+ *
+ * @return ANALYTICAL_UNAWARE_API_VERSION of the library
+ */
+int analytical_unaware_api_version(void);
+
+/**
+ * Construct a topology from a network config.
+ *
+ * @param config_path path of the network config (yml)
+ * @return handle of the topology, NULL if the network config can't be read
+ */
+AnalyticalUnawareTopology* analytical_unaware_create(const char* config_path);
+
+/**
+ * Destroy a topology.
+ *
+ * @param topology handle of the topology (NULL is ignored)
+ */
+void analytical_unaware_destroy(AnalyticalUnawareTopology* topology);
+
+/**
+ * Get the number of NPUs of a topology.
+ *
+ * @param topology handle of the topology
+ * @return number of NPUs
+ */
+int32_t analytical_unaware_npus_count(const AnalyticalUnawareTopology* topology);
+
+/**
+ * Compute the time to send a chunk.
+ *
+ * @param topology handle of the topology
+ * @param src src NPU ID
+ * @param dest dest NPU ID
+ * @param chunk_size size of the chunk
+ * @return time to send the chunk, UINT64_MAX if an NPU ID is invalid
+ */
+uint64_t analytical_unaware_send(const AnalyticalUnawareTopology* topology,
+                                 int32_t src,
+                                 int32_t dest,
+                                 uint64_t chunk_size);
+
+/**
+ * Compute the time to send each chunk of a batch, i.e., delays[i] = send(srcs[i], dests[i], chunk_sizes[i]).
+ *
+ * @param topology handle of the topology
+ * @param srcs src NPU ID of each chunk
+ * @param dests dest NPU ID of each chunk
+ * @param chunk_sizes size of each chunk
+ * @param delays output: time to send each chunk
+ * @param count number of chunks
+ * @return 0 on success, -1 if an NPU ID is invalid (delays are left unwritten)
+ */
+int analytical_unaware_send_batch(const AnalyticalUnawareTopology* topology,
+                                  const int32_t* srcs,
+                                  const int32_t* dests,
+                                  const uint64_t* chunk_sizes,
+                                  uint64_t* delays,
+                                  int32_t count);
+
+#ifdef __cplusplus
+}
+#endif
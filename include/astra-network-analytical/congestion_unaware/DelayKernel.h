@@ -0,0 +1,87 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/// SIMD instruction sets the delay kernels can use
+enum class SimdLevel { Scalar, AVX2, AVX512 };
+
+/**
+ * DelayKernel evaluates hop counts and communication delays for whole arrays of requests.
+ *
+ * Each kernel has a scalar implementation and, on x86-64,
+ * AVX2 and AVX-512 implementations selected at runtime based on CPU support.
+ * All implementations produce bit-identical results.
+ */
+class DelayKernel {
+  public:
+    /**
+     * Get the instruction set used by the kernels.
+     *
+     * @return SIMD level in use
+     */
+    [[nodiscard]] static SimdLevel get_simd_level() noexcept;
+
+    /**
+     * Get the most capable instruction set supported by this CPU.
+     *
+     * @return most capable supported SIMD level
+     */
+    [[nodiscard]] static SimdLevel get_supported_simd_level() noexcept;
+
+    /**
+     * Restrict the instruction set used by the kernels (e.g., for testing or benchmarking).
+     * Levels beyond the CPU support are clamped to the supported level.
+     *
+     * @param simd_level SIMD level to use
+     */
+    static void set_simd_level(SimdLevel simd_level) noexcept;
+
+    /**
+     * Compute delays[i] = hops_counts[i] * latency + chunk_sizes[i] / bandwidth_Bpns.
+     *
+     * @param hops_counts number of hops of each chunk
+     * @param chunk_sizes size of each chunk
+     * @param delays output: communication delay of each chunk
+     * @param count number of chunks
+     * @param latency latency of each link in ticks
+     * @param bandwidth_Bpns bandwidth of each link in B/tick (B/ns with the default time base)
+     */
+    static void compute_delays(const int* hops_counts,
+                               const ChunkSize* chunk_sizes,
+                               EventTime* delays,
+                               int count,
+                               Latency latency,
+                               Bandwidth bandwidth_Bpns) noexcept;
+
+    /**
+     * Compute the number of hops between each (src, dest) pair of a ring.
+     *
+     * @param srcs src NPU IDs
+     * @param dests dest NPU IDs
+     * @param hops_counts output: number of hops of each pair
+     * @param count number of pairs
+     * @param npus_count number of NPUs in the ring
+     * @param bidirectional true if the ring is bidirectional, false otherwise
+     */
+    static void compute_ring_hops_counts(const DeviceId* srcs,
+                                         const DeviceId* dests,
+                                         int* hops_counts,
+                                         int count,
+                                         int npus_count,
+                                         bool bidirectional) noexcept;
+
+  private:
+    /// SIMD level in use
+    static SimdLevel simd_level;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
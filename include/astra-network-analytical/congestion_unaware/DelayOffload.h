@@ -0,0 +1,225 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include <vector>
+
+// kernels shared by the host and the GPU are compiled for both by nvcc
+#if defined(__CUDACC__)
+    #define NETWORK_ANALYTICAL_HOST_DEVICE __host__ __device__
+#else
+    #define NETWORK_ANALYTICAL_HOST_DEVICE
+#endif
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/// hop count rule of a dimension of a DelayPlan
+enum class DelayPlanHops : int { Ring, FullyConnected, Switch };
+
+/**
+ * DelayPlan is a flat, pointer-free description of a (multi-dimensional) Ring, FullyConnected, or Switch topology,
+ * which is copied as is to a GPU.
+ */
+struct DelayPlan {
+    /// number of dimensions
+    int dims_count;
+
+    /// true if the bottleneck dimension serializes the chunk, false if each dimension does
+    bool dim_pipelining;
+
+    /// number of NPUs of each dimension
+    int npus_count_per_dim[MultiDimTopology::max_dims_count];
+
+    /// NPU id stride of each dimension
+    int stride_per_dim[MultiDimTopology::max_dims_count];
+
+    /// hop count rule of each dimension
+    DelayPlanHops hops_per_dim[MultiDimTopology::max_dims_count];
+
+    /// latency of each dimension in ticks
+    double latency_ticks_per_dim[MultiDimTopology::max_dims_count];
+
+    /// bandwidth of each dimension in B/tick
+    double bandwidth_Bptick_per_dim[MultiDimTopology::max_dims_count];
+};
+
+/**
+ * Compute the delay of a chunk on a DelayPlan,
+ * with the same floating-point operations in the same order as MultiDimTopology::send and BasicTopology::send,
+ * so the results are bit-identical on the host and on the GPU (compiled without FMA contraction).
+ *
+ * @param plan topology
+ * @param src src NPU id
+ * @param dest dest NPU id
+ * @param chunk_size size of the chunk
+ * @return delay of the chunk (0 if src == dest)
+ */
+NETWORK_ANALYTICAL_HOST_DEVICE inline EventTime evaluate_delay(const DelayPlan& plan,
+                                                              const DeviceId src,
+                                                              const DeviceId dest,
+                                                              const ChunkSize chunk_size) noexcept {
+    auto link_delay = 0.0;
+    auto serialization_delay = 0.0;
+    for (auto dim = 0; dim < plan.dims_count; dim++) {
+        const auto dim_size = plan.npus_count_per_dim[dim];
+        const auto src_local_id = (src / plan.stride_per_dim[dim]) % dim_size;
+        const auto dest_local_id = (dest / plan.stride_per_dim[dim]) % dim_size;
+        if (src_local_id == dest_local_id) {
+            continue;
+        }
+
+        // rings are bidirectional: the shorter direction
+        auto hops_count = 1;
+        if (plan.hops_per_dim[dim] == DelayPlanHops::Ring) {
+            auto clockwise_distance = dest_local_id - src_local_id;
+            clockwise_distance += (clockwise_distance < 0) ? dim_size : 0;
+            const auto anticlockwise_distance = dim_size - clockwise_distance;
+            hops_count = (clockwise_distance < anticlockwise_distance) ? clockwise_distance : anticlockwise_distance;
+        } else if (plan.hops_per_dim[dim] == DelayPlanHops::Switch) {
+            hops_count = 2;
+        }
+        link_delay += hops_count * plan.latency_ticks_per_dim[dim];
+
+        const auto dim_serialization_delay = static_cast<double>(chunk_size) / plan.bandwidth_Bptick_per_dim[dim];
+        if (plan.dim_pipelining) {
+            serialization_delay =
+                (dim_serialization_delay > serialization_delay) ? dim_serialization_delay : serialization_delay;
+        } else {
+            serialization_delay += dim_serialization_delay;
+        }
+    }
+    return static_cast<EventTime>(link_delay + serialization_delay);
+}
+
+/**
+ * DelayOffload evaluates batches of congestion-unaware delays, and whole delay matrices,
+ * on a GPU when one is present (built with NETWORK_BACKEND_ENABLE_CUDA),
+ * falling back to host threads otherwise.
+ * Results are the same as those of the topology built by construct_topology.
+ *
+ * Supports Ring, FullyConnected, and Switch dimensions (and stacks of them).
+ */
+class DelayOffload {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param network_parser network config, of Ring, FullyConnected, and Switch dimensions only
+     */
+    explicit DelayOffload(const NetworkParser& network_parser) noexcept;
+
+    /**
+     * Check if a usable GPU is present.
+     *
+     * @return true if the backend is built with GPU support and a device is present, false otherwise
+     */
+    [[nodiscard]] static bool gpu_available() noexcept;
+
+    /**
+     * Allow or forbid using the GPU (e.g., for testing or benchmarking the host path).
+     *
+     * @param enabled true to use the GPU if available, false to always use the host
+     */
+    void set_gpu_enabled(bool enabled) noexcept;
+
+    /**
+     * Check if the batches are evaluated on the GPU.
+     *
+     * @return true if the GPU is enabled and available, false otherwise
+     */
+    [[nodiscard]] bool uses_gpu() const noexcept;
+
+    /**
+     * Set whether the dimensions are pipelined (see MultiDimTopology::set_dim_pipelining).
+     *
+     * @param pipelined true if the bottleneck dimension serializes the chunk, false if each dimension does
+     */
+    void set_dim_pipelining(bool pipelined) noexcept;
+
+    /**
+     * Get the flattened topology.
+     *
+     * @return plan of the topology
+     */
+    [[nodiscard]] const DelayPlan& get_plan() const noexcept;
+
+    /**
+     * Compute the delays of a batch of chunks (see Topology::send_batch).
+     *
+     * @param srcs src NPU id of each chunk
+     * @param dests dest NPU id of each chunk
+     * @param chunk_sizes size of each chunk
+     * @param delays output: delay of each chunk
+     * @param count number of chunks
+     * @param threads_count host threads, if not on the GPU (0: number of hardware threads)
+     */
+    void send_batch(const DeviceId* srcs,
+                    const DeviceId* dests,
+                    const ChunkSize* chunk_sizes,
+                    EventTime* delays,
+                    int64_t count,
+                    int threads_count = 1) const noexcept;
+
+    /**
+     * Compute the delay matrix of a chunk size (see Topology::compute_delay_matrix).
+     *
+     * @param chunk_size size of the chunks
+     * @param threads_count host threads, if not on the GPU (0: number of hardware threads)
+     * @return row-major NPUs count x NPUs count matrix, delay_matrix[src * NPUs count + dest]
+     */
+    [[nodiscard]] std::vector<EventTime> compute_delay_matrix(ChunkSize chunk_size,
+                                                              int threads_count = 1) const noexcept;
+
+  private:
+    /// flattened topology
+    DelayPlan plan;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// true if the GPU may be used
+    bool gpu_enabled;
+};
+
+#ifdef NETWORK_ANALYTICAL_ENABLE_CUDA
+
+/**
+ * Compute the delays of a batch of chunks on the GPU (DelayOffloadCuda.cu).
+ *
+ * @return true if computed, false if the GPU failed (the caller falls back to the host)
+ */
+bool cuda_send_batch(const DelayPlan& plan,
+                     const DeviceId* srcs,
+                     const DeviceId* dests,
+                     const ChunkSize* chunk_sizes,
+                     EventTime* delays,
+                     int64_t count) noexcept;
+
+/**
+ * Compute a delay matrix on the GPU (DelayOffloadCuda.cu).
+ *
+ * @return true if computed, false if the GPU failed (the caller falls back to the host)
+ */
+bool cuda_compute_delay_matrix(const DelayPlan& plan,
+                               int npus_count,
+                               ChunkSize chunk_size,
+                               EventTime* delay_matrix) noexcept;
+
+/**
+ * Check if a CUDA device is present (DelayOffloadCuda.cu).
+ *
+ * @return true if a device is present, false otherwise
+ */
+bool cuda_device_present() noexcept;
+
+#endif
+
+}  // namespace NetworkAnalyticalCongestionUnaware
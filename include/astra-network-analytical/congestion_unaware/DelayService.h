@@ -0,0 +1,59 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/QueryServer.h"
+#include "congestion_unaware/Topology.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * DelayService answers ChunkQuery requests with the congestion-unaware delay of every chunk,
+ * constructing the topology of each network config once and keeping it for the following requests.
+ *
+ * Serve it through a QueryServer:
+ *   auto delay_service = DelayService();
+ *   auto server = QueryServer(socket_path, [&](const auto& request) { return delay_service.answer(request); });
+ */
+class DelayService {
+  public:
+    /**
+     * Answer a request. Thread-safe.
+     *
+     * @param request encoded ChunkQuery
+     * @return encoded delay of every chunk, empty if the request is malformed,
+     *         its network config can't be read, or a chunk has an invalid NPU ID
+     */
+    [[nodiscard]] std::string answer(const std::string& request) noexcept;
+
+    /**
+     * Get the number of topologies constructed so far.
+     *
+     * @return number of topologies
+     */
+    [[nodiscard]] int get_topologies_count() const noexcept;
+
+  private:
+    /// topology of each network config path, guarded by topologies_mutex
+    std::map<std::string, std::shared_ptr<const Topology>> topologies;
+    mutable std::mutex topologies_mutex;
+
+    /**
+     * Get the topology of a network config, constructing it on first use.
+     *
+     * @param config_path path of the network config
+     * @return topology, nullptr if the network config can't be read
+     */
+    [[nodiscard]] std::shared_ptr<const Topology> get_topology(const std::string& config_path) noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -0,0 +1,67 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/ExecutionTrace.h"
+#include "common/NetworkScheduler.h"
+#include "common/Type.h"
+#include "congestion_unaware/Topology.h"
+#include <map>
+#include <memory>
+#include <utility>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * ExecutionTraceAdapter replays execution traces on a congestion-unaware topology:
+ * a message arrives after the topology's send delay,
+ * and a collective finishes after the closed-form cost of its ring algorithm
+ * (each step bound by its slowest message).
+ */
+class ExecutionTraceAdapter final : public ExecutionTraceNetwork {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology to replay on
+     * @param scheduler scheduler message arrivals and collective completions are scheduled on
+     */
+    ExecutionTraceAdapter(std::shared_ptr<Topology> topology, std::shared_ptr<NetworkScheduler> scheduler) noexcept;
+
+    [[nodiscard]] NetworkScheduler& get_scheduler() noexcept override;
+
+    [[nodiscard]] int get_npus_count() const noexcept override;
+
+    void send(DeviceId src, DeviceId dest, ChunkSize size, Callback callback, CallbackArg callback_arg) noexcept override;
+
+    void run_collective(CollectiveType collective_type,
+                        ChunkSize size,
+                        Callback callback,
+                        CallbackArg callback_arg) noexcept override;
+
+    /**
+     * Compute the cost of a ring-algorithm collective.
+     *
+     * @param collective_type collective communication pattern
+     * @param size size of the buffer each NPU holds
+     * @return time the collective takes
+     */
+    [[nodiscard]] EventTime compute_collective_cost(CollectiveType collective_type, ChunkSize size) const noexcept;
+
+  private:
+    /// topology to replay on
+    std::shared_ptr<Topology> topology;
+
+    /// scheduler message arrivals and collective completions are scheduled on
+    std::shared_ptr<NetworkScheduler> scheduler;
+
+    /// memoized collective costs, per (collective type, size)
+    mutable std::map<std::pair<CollectiveType, ChunkSize>, EventTime> collective_costs;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
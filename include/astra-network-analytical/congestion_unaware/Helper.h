@@ -5,9 +5,11 @@ LICENSE file in the root directory of this source tree.
 
 #pragma once
 
+#include "common/NetworkConfig.h"
 #include "common/NetworkParser.h"
 #include "congestion_unaware/Topology.h"
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -21,4 +23,24 @@ namespace NetworkAnalyticalCongestionUnaware {
  */
 [[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkParser& network_parser) noexcept;
 
+/**
+ * Construct a topology from a valid NetworkParser (see NetworkParser::try_parse),
+ * collecting the errors only found while constructing it instead of exiting,
+ * i.e., mesh and fat-tree shapes this backend can't build.
+ *
+ * @param network_parser network parser
+ * @param errors list the errors found are appended to
+ * @return pointer to the constructed topology, nullptr if any error is found
+ */
+[[nodiscard]] std::shared_ptr<Topology> try_construct_topology(const NetworkParser& network_parser,
+                                                               std::vector<ConfigError>& errors) noexcept;
+
+/**
+ * Construct a topology from a network configuration built in memory.
+ *
+ * @param network_config network configuration
+ * @return pointer to the constructed topology
+ */
+[[nodiscard]] std::shared_ptr<Topology> construct_topology(const NetworkConfig& network_config) noexcept;
+
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -0,0 +1,161 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * Implements a two-tier leaf/spine switch (a 2-tier FatTree), with oversubscribed leaf uplinks.
+ *
+ * LeafSpine(8, 4, 2) example (leaves of 4 NPUs, 2 downlinks per uplink):
+ *       <------ spines ------>
+ *        |                  |
+ *    <-leaf 0->         <-leaf 1->
+ *    |  |  |  |         |  |  |  |
+ *    0  1  2  3         4  5  6  7
+ *
+ * NPU i is attached to leaf (i / leaf_size).
+ * Within a leaf, send(0 -> 2) flows through 0 -> leaf 0 -> 2, so takes 2 hops at the link bandwidth.
+ * Across leaves, send(0 -> 5) flows through 0 -> leaf 0 -> spine -> leaf 1 -> 5, so takes 4 hops,
+ * and is serialized at the effective cross-spine bandwidth (bandwidth / oversubscription):
+ * a leaf carries leaf_size * bandwidth / oversubscription across the spines, shared by its NPUs.
+ * Both cases are closed-form, so every query is O(1) however large the cluster.
+ *
+ * Link i is the uplink i -> leaf, and link (npus_count + i) is the downlink leaf -> i.
+ * Link (2 * npus_count + l) aggregates the uplinks of leaf l to the spines,
+ * and link (2 * npus_count + leaves_count + l) the downlinks of the spines to leaf l.
+ *
+ * Oversubscription only shows in send and send_batch, so LeafSpine is a 1-dim topology:
+ * appended to a MultiDimTopology, it would be modeled by its hop counts and link bandwidth only.
+ */
+class LeafSpine final : public BasicTopology {
+  public:
+    /// building block of the topology
+    static constexpr TopologyBuildingBlock building_block = TopologyBuildingBlock::FatTree;
+
+    /**
+     * Constructor.
+     *
+     * @param npus_count number of NPUs
+     * @param leaf_size number of NPUs per leaf (the last leaf may hold fewer)
+     * @param oversubscription leaf downlink bandwidth per leaf uplink bandwidth, at least 1
+     * @param bandwidth bandwidth of each NPU link
+     * @param latency latency of each link
+     */
+    LeafSpine(int npus_count, int leaf_size, double oversubscription, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Implements the send method of Topology,
+     * serializing chunks crossing the spines at the effective cross-spine bandwidth.
+     */
+    [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
+
+    /**
+     * Implements the send_batch method of Topology.
+     */
+    void send_batch(const DeviceId* srcs,
+                    const DeviceId* dests,
+                    const ChunkSize* chunk_sizes,
+                    EventTime* delays,
+                    int count) const noexcept override;
+
+    /**
+     * Implements the get_links_count method of Topology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implements the get_link_bandwidth method of Topology: leaf-spine links aggregate the uplinks of a leaf.
+     */
+    [[nodiscard]] Bandwidth get_link_bandwidth(int link_id) const noexcept override;
+
+    /**
+     * Implements the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implements the write_route_links method of Topology.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
+    /**
+     * Get the number of NPUs per leaf.
+     *
+     * @return number of NPUs per leaf
+     */
+    [[nodiscard]] int get_leaf_size() const noexcept;
+
+    /**
+     * Get the number of leaves.
+     *
+     * @return number of leaves
+     */
+    [[nodiscard]] int get_leaves_count() const noexcept;
+
+    /**
+     * Get the oversubscription of the leaf uplinks.
+     *
+     * @return leaf downlink bandwidth per leaf uplink bandwidth
+     */
+    [[nodiscard]] double get_oversubscription() const noexcept;
+
+    /**
+     * Get the leaf of an NPU.
+     *
+     * @param npu_id NPU ID
+     * @return leaf index of the NPU
+     */
+    [[nodiscard]] int get_leaf(DeviceId npu_id) const noexcept;
+
+  private:
+    /// number of NPUs per leaf
+    int leaf_size;
+
+    /// number of leaves
+    int leaves_count;
+
+    /// leaf downlink bandwidth per leaf uplink bandwidth
+    double oversubscription;
+
+    /// latency of each link in ticks
+    double latency_ticks;
+
+    /// bandwidth of chunks within a leaf in B/tick
+    double leaf_bandwidth_Bptick;
+
+    /// effective bandwidth of chunks across the spines in B/tick
+    double spine_bandwidth_Bptick;
+
+    /**
+     * Compute the communication delay of a chunk.
+     *
+     * @param cross_spine true if the chunk crosses the spines, false if it stays within a leaf
+     * @param chunk_size size of the chunk
+     * @return communication delay of the chunk
+     */
+    [[nodiscard]] EventTime compute_delay(bool cross_spine, ChunkSize chunk_size) const noexcept;
+
+    /**
+     * Implements the compute_hops_count method of BasicTopology.
+     */
+    [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implements the compute_hops_counts method of BasicTopology.
+     */
+    void compute_hops_counts(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             int* hops_counts,
+                             int count) const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
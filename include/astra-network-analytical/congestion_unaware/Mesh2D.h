@@ -0,0 +1,81 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * Implements a 2D mesh topology.
+ *
+ * Mesh2D(4, 3) example:
+ * 0 - 1 - 2 - 3
+ * |   |   |   |
+ * 4 - 5 - 6 - 7
+ * |   |   |   |
+ * 8 - 9 - 10- 11
+ *
+ * NPU IDs are laid out row by row: id = y * width + x.
+ * Every routing policy of the congestion-aware Mesh2D is minimal,
+ * so a chunk takes the Manhattan distance of hops,
+ * e.g., send(0 -> 11) takes 3 + 2 = 5 hops.
+ * Link-level routes follow XY routing.
+ *
+ * Link (direction * npus_count + i) leaves NPU i to +X, -X, +Y, or -Y (direction 0 to 3).
+ */
+class Mesh2D final : public BasicTopology {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param width number of NPUs in X dimension
+     * @param height number of NPUs in Y dimension
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    Mesh2D(int width, int height, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Implements the get_links_count method of Topology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implements the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implements the write_route_links method of Topology.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
+  private:
+    /// number of NPUs in X dimension
+    int width;
+
+    /// number of NPUs in Y dimension
+    int height;
+
+    /**
+     * Implements the compute_hops_count method of BasicTopology.
+     */
+    [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implements the compute_hops_counts method of BasicTopology.
+     */
+    void compute_hops_counts(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             int* hops_counts,
+                             int count) const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
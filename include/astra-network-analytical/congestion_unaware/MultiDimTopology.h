@@ -8,7 +8,9 @@ LICENSE file in the root directory of this source tree.
 #include "common/Type.h"
 #include "congestion_unaware/BasicTopology.h"
 #include "congestion_unaware/Topology.h"
+#include <array>
 #include <memory>
+#include <vector>
 
 using namespace NetworkAnalytical;
 
@@ -17,9 +19,22 @@ namespace NetworkAnalyticalCongestionUnaware {
 /**
  * MultiDimTopology implements multi-dimensional network topologies
  * which can be constructed by stacking up multiple BasicTopology instances.
+ *
+ * A chunk is routed dimension by dimension, from the lowest to the highest,
+ * through every dimension in which the src and dest addresses differ.
+ * Its delay sums the link delays of every traversed dimension, plus the serialization delay:
+ * with dimension pipelining (the default), the chunk streams across dimensions,
+ * so only the slowest (bottleneck) dimension serializes it;
+ * otherwise, it is stored and forwarded between dimensions, serialized once per traversed dimension.
  */
 class MultiDimTopology : public Topology {
   public:
+    /// maximum number of network dimensions
+    static constexpr int max_dims_count = 8;
+
+    /// topologies up to this many NPUs precompute every NPU's address
+    static constexpr int address_table_max_npus_count = 1 << 16;
+
     /**
      * Constructor.
      */
@@ -27,9 +42,76 @@ class MultiDimTopology : public Topology {
 
     /**
      * Implement the send method of Topology.
+     * A chunk whose src and dest are the same NPU takes no time.
      */
     [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept override;
 
+    /**
+     * Implement the send_batch method of Topology.
+     * Every chunk is costed as by send, without heap allocation.
+     */
+    void send_batch(const DeviceId* srcs,
+                    const DeviceId* dests,
+                    const ChunkSize* chunk_sizes,
+                    EventTime* delays,
+                    int count) const noexcept override;
+
+    /**
+     * Implementation of compute_delay_matrix function in Topology.
+     * Hop counts are looked up from the hop matrix of each dimension,
+     * so only the (much smaller) per-dimension matrices query the dimension topologies.
+     */
+    [[nodiscard]] std::vector<EventTime> compute_delay_matrix(ChunkSize chunk_size,
+                                                              int threads_count = 1) const noexcept override;
+
+    /**
+     * Closed-form cost of a ring All-Reduce over a single ring of all NPUs (NPU i -> i+1).
+     * Each of the 2(N-1) steps sends (size / N) to the next NPU,
+     * and is bound by the slowest dimension the ring crosses.
+     *
+     * @param all_reduce_size size of the buffer each NPU reduces
+     * @return estimated time of the All-Reduce
+     */
+    [[nodiscard]] EventTime compute_ring_all_reduce_cost(ChunkSize all_reduce_size) const noexcept;
+
+    /**
+     * Closed-form cost of a hierarchical All-Reduce:
+     * ring Reduce-Scatter from the lowest to the highest dimension, each on the shard of the previous one,
+     * followed by ring All-Gather from the highest back to the lowest dimension.
+     *
+     * @param all_reduce_size size of the buffer each NPU reduces
+     * @return estimated time of the All-Reduce
+     */
+    [[nodiscard]] EventTime compute_hierarchical_all_reduce_cost(ChunkSize all_reduce_size) const noexcept;
+
+    /**
+     * Closed-form cost of a hierarchical collective with per-dimension chunk pipelining:
+     * ring Reduce-Scatter from the lowest to the highest dimension, each on the shard of the previous one,
+     * and/or ring All-Gather from the highest back to the lowest dimension.
+     * The buffer is split into chunks_count chunks, each moving on to the next dimension as soon as it's done
+     * with the current one, so the dimensions work on different chunks at once:
+     * the cost is one chunk through every phase, plus every other chunk through the busiest dimension's links.
+     *
+     * @param collective_type AllGather, ReduceScatter, or AllReduce
+     * @param collective_size size of the buffer each NPU holds
+     *     (i.e., the gathered output of AllGather and the input of ReduceScatter)
+     * @param chunks_count number of chunks the buffer is split into
+     * @return estimated time of the collective
+     */
+    [[nodiscard]] EventTime compute_hierarchical_collective_cost(CollectiveType collective_type,
+                                                                 ChunkSize collective_size,
+                                                                 int chunks_count = 1) const noexcept;
+
+    /**
+     * Closed-form cost of a pairwise-exchange All-to-All:
+     * every NPU sends (size / N) to each other NPU, one peer at a time,
+     * each message costed as by send.
+     *
+     * @param all_to_all_size size of the buffer each NPU scatters
+     * @return estimated time of the All-to-All
+     */
+    [[nodiscard]] EventTime compute_all_to_all_cost(ChunkSize all_to_all_size) const noexcept;
+
     /**
      * Add a dimension to the multi-dimensional topology.
      *
@@ -37,15 +119,135 @@ class MultiDimTopology : public Topology {
      */
     void append_dimension(std::unique_ptr<BasicTopology> basic_topology) noexcept;
 
+    /**
+     * Set whether chunks are pipelined across dimensions.
+     *
+     * @param pipelined true to serialize chunks once at the bottleneck dimension (default),
+     *                  false to serialize them once per traversed dimension
+     */
+    void set_dim_pipelining(bool pipelined) noexcept;
+
+    /**
+     * Check whether chunks are pipelined across dimensions.
+     *
+     * @return true if chunks are serialized once at the bottleneck dimension
+     */
+    [[nodiscard]] bool get_dim_pipelining() const noexcept;
+
+    /**
+     * Implement the get_links_count method of Topology.
+     * The links of each dimension come after those of the lower dimensions,
+     * with a copy of the dimension's links per address of the other dimensions.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implement the get_link_bandwidth method of Topology.
+     */
+    [[nodiscard]] Bandwidth get_link_bandwidth(int link_id) const noexcept override;
+
+    /**
+     * Implement the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implement the write_route_links method of Topology: dimension-ordered, as send.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
+    /**
+     * Get the number of links of a stack of dimensions, laid out as by get_links_count
+     * (shared with StaticMultiDimTopology).
+     *
+     * @param dim_topologies BasicTopology of each dimension, from the lowest
+     * @param dims_count number of dimensions
+     * @return number of link IDs
+     */
+    [[nodiscard]] static int get_dims_links_count(const BasicTopology* const* dim_topologies, int dims_count) noexcept;
+
+    /**
+     * Get the bandwidth of a link of a stack of dimensions.
+     *
+     * @param dim_topologies BasicTopology of each dimension, from the lowest
+     * @param dims_count number of dimensions
+     * @param link_id link ID
+     * @return bandwidth of the link in GB/s
+     */
+    [[nodiscard]] static Bandwidth get_dims_link_bandwidth(const BasicTopology* const* dim_topologies,
+                                                           int dims_count,
+                                                           int link_id) noexcept;
+
+    /**
+     * Get the largest number of links of a route over a stack of dimensions.
+     *
+     * @param dim_topologies BasicTopology of each dimension, from the lowest
+     * @param dims_count number of dimensions
+     * @return largest number of links of a route
+     */
+    [[nodiscard]] static int get_dims_max_route_links_count(const BasicTopology* const* dim_topologies,
+                                                            int dims_count) noexcept;
+
+    /**
+     * Write the links a chunk traverses over a stack of dimensions, dimension by dimension from the lowest.
+     *
+     * @param dim_topologies BasicTopology of each dimension, from the lowest
+     * @param dims_count number of dimensions
+     * @param src src NPU ID
+     * @param dest dest NPU ID (different from src)
+     * @param link_ids buffer of at least get_dims_max_route_links_count() link IDs
+     * @return number of links written
+     */
+    static int write_dims_route_links(const BasicTopology* const* dim_topologies,
+                                      int dims_count,
+                                      DeviceId src,
+                                      DeviceId dest,
+                                      int* link_ids) noexcept;
+
   private:
     /// Each NPU ID can be broken down into multiple dimensions.
     /// for example, if the topology size is [2, 8, 4] and the NPU ID is 31,
     /// then the NPU ID can be broken down into [1, 7, 1].
-    using MultiDimAddress = std::vector<DeviceId>;
+    /// Fixed-capacity, so translating an address performs no heap allocation.
+    using MultiDimAddress = std::array<DeviceId, max_dims_count>;
 
     /// BasicTopology instances per dimension.
     std::vector<std::unique_ptr<BasicTopology>> topology_per_dim;
 
+    /// BasicTopology instance of each dimension, as raw pointers for link-level routing
+    std::vector<const BasicTopology*> dim_topology_pointers;
+
+    /// NPU ID stride of each dimension
+    /// e.g., if the topology size is [2, 8, 4], the strides are [1, 2, 16].
+    std::vector<int> stride_per_dim;
+
+    /// link delay between neighboring NPUs (NPU 0 -> 1) of each dimension, in ns
+    std::vector<double> neighbor_link_delay_per_dim;
+
+    /// sum of the link delays from NPU 0 to every other NPU of each dimension, in ns
+    std::vector<double> peers_link_delay_per_dim;
+
+    /// serialization delay per byte of each dimension, in ns/B
+    std::vector<double> serialization_delay_per_byte_per_dim;
+
+    /// link latency of each dimension in ticks, as used by its BasicTopology
+    std::vector<double> latency_ticks_per_dim;
+
+    /// bandwidth of each dimension in B/tick, as used by its BasicTopology
+    std::vector<double> bandwidth_Bptick_per_dim;
+
+    /// whether chunks are pipelined across dimensions
+    bool dim_pipelining;
+
+    /// precomputed address of every NPU, flattened as [npu_id * dims_count + dim]
+    /// (empty if the topology has more than address_table_max_npus_count NPUs)
+    std::vector<DeviceId> address_table;
+
+    /**
+     * Rebuild the address table after the topology shape changed.
+     */
+    void build_address_table() noexcept;
+
     /**
      * Translate the NPU ID into a multi-dimensional address.
      *
@@ -55,16 +257,19 @@ class MultiDimTopology : public Topology {
     [[nodiscard]] MultiDimAddress translate_address(DeviceId npu_id) const noexcept;
 
     /**
-     * Given src and dest address in multi-dimensional form,
-     * return the dimension where the transfer should happen.
-     * i.e., the dimension where the src and dest addresses differ.
+     * Compute the delay of a chunk routed through every dimension where the src and dest addresses differ.
      *
      * @param src_address src NPU ID in multi-dimensional form
      * @param dest_address dest NPU ID in multi-dimensional form
-     * @return the dimension where the transfer should happen
+     * @param chunk_size size of the chunk
+     * @param hops_count_of returns the number of hops of (dim, src local id, dest local id)
+     * @return communication delay of the chunk
      */
-    [[nodiscard]] int get_dim_to_transfer(const MultiDimAddress& src_address,
-                                          const MultiDimAddress& dest_address) const noexcept;
+    template <typename HopsCountOf>
+    [[nodiscard]] EventTime compute_transfer_delay(const MultiDimAddress& src_address,
+                                                   const MultiDimAddress& dest_address,
+                                                   ChunkSize chunk_size,
+                                                   const HopsCountOf& hops_count_of) const noexcept;
 };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -0,0 +1,136 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/Topology.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * Message of a job's communication pattern, between ranks of the job.
+ */
+struct JobMessage {
+    /// src rank
+    int src_rank;
+
+    /// dest rank
+    int dest_rank;
+
+    /// size of the message
+    ChunkSize size;
+};
+
+/**
+ * Cost model scoring a placement.
+ */
+enum class PlacementCost {
+    /// largest congestion-unaware delay of a message (the messages sent concurrently, without contention)
+    Delay,
+
+    /// largest time a link takes to serialize the bytes of every message crossing it (the bottleneck link)
+    LinkLoad,
+};
+
+/**
+ * Score of a candidate placement.
+ */
+struct PlacementScore {
+    /// index of the candidate
+    int candidate;
+
+    /// cost of the candidate in ticks (the lower the better)
+    double cost;
+};
+
+/**
+ * PlacementEvaluator scores candidate placements of a job onto a topology.
+ *
+ * A placement maps each rank of the job to an NPU of the topology (placement[rank] = NPU ID),
+ * and is scored by routing the job's messages between the NPUs the ranks are placed on:
+ * with the topology's closed-form delays (PlacementCost::Delay),
+ * or with the load the messages put on each link along the topology's routes (PlacementCost::LinkLoad,
+ * which needs link-level routing, see Topology::write_route_links).
+ * Neither simulates a chunk, so thousands of candidates are scored per second, and candidates are scored in parallel.
+ */
+class PlacementEvaluator {
+  public:
+    /**
+     * Constructor.
+     *
+     * @param topology topology the job is placed on
+     * @param messages communication pattern of the job
+     * @param cost cost model
+     */
+    PlacementEvaluator(std::shared_ptr<const Topology> topology,
+                       std::vector<JobMessage> messages,
+                       PlacementCost cost) noexcept;
+
+    /**
+     * Get the number of ranks of the job, i.e., the length of a placement.
+     *
+     * @return number of ranks
+     */
+    [[nodiscard]] int get_ranks_count() const noexcept;
+
+    /**
+     * Score a placement.
+     *
+     * @param placement NPU ID of each rank
+     * @return cost of the placement in ticks (the lower the better)
+     */
+    [[nodiscard]] double evaluate(const std::vector<DeviceId>& placement) const noexcept;
+
+    /**
+     * Score candidate placements, and return the best ones, best first (ties broken by candidate index).
+     *
+     * @param candidates candidate placements
+     * @param best_count number of placements to return (at most the number of candidates)
+     * @param threads_count number of threads scoring the candidates (0: number of hardware threads)
+     * @return scores of the best placements, best first
+     */
+    [[nodiscard]] std::vector<PlacementScore> rank(const std::vector<std::vector<DeviceId>>& candidates,
+                                                   int best_count,
+                                                   int threads_count = 1) const noexcept;
+
+  private:
+    /// topology the job is placed on
+    std::shared_ptr<const Topology> topology;
+
+    /// communication pattern of the job
+    std::vector<JobMessage> messages;
+
+    /// cost model
+    PlacementCost cost;
+
+    /// number of ranks of the job
+    int ranks_count;
+
+    /// serialization time of each link per byte, in ticks/B (LinkLoad only)
+    std::vector<double> link_time_per_byte;
+
+    /**
+     * Score a placement by the largest message delay.
+     *
+     * @param placement NPU ID of each rank
+     * @return cost in ticks
+     */
+    [[nodiscard]] double evaluate_delay(const std::vector<DeviceId>& placement) const noexcept;
+
+    /**
+     * Score a placement by the bottleneck link load.
+     *
+     * @param placement NPU ID of each rank
+     * @return cost in ticks
+     */
+    [[nodiscard]] double evaluate_link_load(const std::vector<DeviceId>& placement) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -0,0 +1,118 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/Topology.h"
+#include <memory>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * QueueingModel approximates congestion on top of a congestion-unaware topology.
+ *
+ * Given a traffic matrix (the bandwidth each NPU offers to every other NPU),
+ * the offered load of every link is accumulated along the topology's routes (see Topology::write_route_links),
+ * and each hop of a chunk adds the mean waiting time of an M/D/1 queue at its link:
+ *   rho / (2 * (1 - rho)) * (chunk serialization time on the link),
+ * with rho the link utilization (capped at max_utilization, so saturated links stay finite).
+ * This gives congestion-sensitive delays of every pair at the cost of a route walk per pair,
+ * instead of simulating every chunk with the congestion-aware backend.
+ */
+class QueueingModel {
+  public:
+    /// utilization saturated links are capped at
+    static constexpr double max_utilization = 0.99;
+
+    /**
+     * Constructor. Every link starts idle, i.e., delays equal the topology's.
+     *
+     * @param topology topology supporting link-level routing
+     */
+    explicit QueueingModel(std::shared_ptr<const Topology> topology) noexcept;
+
+    /**
+     * Set the traffic matrix, and compute the utilization of every link.
+     *
+     * @param traffic_matrix row-major (npus_count x npus_count) bandwidth offered from src to dest in GB/s
+     */
+    void set_traffic_matrix(const std::vector<Bandwidth>& traffic_matrix) noexcept;
+
+    /**
+     * Get the utilization (offered load / bandwidth) of a link, uncapped.
+     *
+     * @param link_id link ID
+     * @return utilization of the link
+     */
+    [[nodiscard]] double get_link_utilization(int link_id) const noexcept;
+
+    /**
+     * Get the highest link utilization, uncapped.
+     *
+     * @return highest utilization
+     */
+    [[nodiscard]] double get_max_link_utilization() const noexcept;
+
+    /**
+     * Get the number of links offered at least their bandwidth.
+     *
+     * @return number of saturated links
+     */
+    [[nodiscard]] int get_saturated_links_count() const noexcept;
+
+    /**
+     * Estimate the time to send a chunk under the traffic matrix:
+     * the topology's delay plus the queueing delay of every hop.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @param chunk_size size of the chunk
+     * @return time to send the chunk from src to dest
+     */
+    [[nodiscard]] EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept;
+
+    /**
+     * Estimate the delay of a chunk between every pair of NPUs under the traffic matrix,
+     * i.e., delay_matrix[src * npus_count + dest] = send(src, dest, chunk_size), with 0 on the diagonal.
+     *
+     * @param chunk_size size of the chunk
+     * @param threads_count number of threads computing the rows (0: number of hardware threads)
+     * @return row-major (npus_count x npus_count) delay matrix
+     */
+    [[nodiscard]] std::vector<EventTime> compute_delay_matrix(ChunkSize chunk_size,
+                                                              int threads_count = 1) const noexcept;
+
+  private:
+    /// topology the chunks are routed on
+    std::shared_ptr<const Topology> topology;
+
+    /// number of NPUs
+    int npus_count;
+
+    /// largest number of links of a route
+    int max_route_links_count;
+
+    /// utilization of each link, uncapped
+    std::vector<double> link_utilizations;
+
+    /// queueing delay of each link per byte of the chunk, in ticks/B
+    std::vector<double> queueing_delay_per_byte;
+
+    /**
+     * Sum the per-byte queueing delays of the links from src to dest.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID
+     * @param link_ids buffer of at least max_route_links_count link IDs
+     * @return queueing delay per byte of the chunk, in ticks/B
+     */
+    [[nodiscard]] double route_queueing_delay_per_byte(DeviceId src, DeviceId dest, int* link_ids) const noexcept;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
@@ -26,9 +26,16 @@ namespace NetworkAnalyticalCongestionUnaware {
  * If the ring is bi-directional, then each chunk can flow through:
  * 0 -> 1 -> 2 -> 3 -> 4 -> 5 -> 6 -> 7 -> 0
  * 0 <- 1 <- 2 <- 3 <- 4 <- 5 <- 6 <- 7 <- 0
+ *
+ * Link i is i -> i + 1, and link (npus_count + i) is i -> i - 1 (bidirectional only).
+ *
+ * Chunks take the shorter way around, but a large transfer can be striped over both ways (see send_striped).
  */
 class Ring final : public BasicTopology {
   public:
+    /// building block of the topology
+    static constexpr TopologyBuildingBlock building_block = TopologyBuildingBlock::Ring;
+
     /**
      * Constructor
      *
@@ -39,12 +46,50 @@ class Ring final : public BasicTopology {
      */
     Ring(int npus_count, Bandwidth bandwidth, Latency latency, bool bidirectional = true) noexcept;
 
+    /**
+     * Compute the time to send a transfer striped over both directions of a bidirectional ring,
+     * i.e., the time its slower stripe takes, with the bytes split as in the congestion-aware Ring::send_striped
+     * (see ring_stripe_size). A unidirectional ring, or a transfer too small to split, is sent as a single chunk.
+     *
+     * @param src src NPU id
+     * @param dest dest NPU id
+     * @param chunk_size size of the transfer
+     * @return time to send the transfer from src to dest
+     */
+    [[nodiscard]] EventTime send_striped(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept;
+
+    /**
+     * Implements the get_links_count method of Topology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implements the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implements the write_route_links method of Topology.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
   private:
+    /// StaticMultiDimTopology calls the dimensions it holds by their concrete type
+    template <typename... DimTopologies> friend class StaticMultiDimTopology;
+
     /**
      * Implements the compute_hops_count method of BasicTopology.
      */
     [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
 
+    /**
+     * Implements the compute_hops_counts method of BasicTopology.
+     */
+    void compute_hops_counts(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             int* hops_counts,
+                             int count) const noexcept override;
+
     /// true if the ring is bidirectional, false otherwise
     bool bidirectional;
 };
@@ -0,0 +1,134 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+#include <cstdint>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * Implements a 2D mesh topology with excluded (missing) grid cells.
+ *
+ * Valid cells are numbered as by the congestion-aware SparseMesh2D:
+ * by the custom placement if given, the remaining cells in row-major order.
+ * Chunks take shortest paths around the holes, so the hop count of every (src, dest) pair
+ * is precomputed by a BFS from each NPU into a 16-bit distance matrix (2 bytes per pair),
+ * keeping each hop-count query a single lookup.
+ *
+ * Link (direction * width * height + cell) leaves a grid cell to +X, -X, +Y, or -Y (direction 0 to 3).
+ * Link-level routes take a shortest path, moving along X first whenever it gets closer.
+ */
+class SparseMesh2D final : public BasicTopology {
+  public:
+    /**
+     * Constructor, numbering the valid cells in row-major order.
+     *
+     * @param width number of grid columns
+     * @param height number of grid rows
+     * @param valid_cells true for each grid cell holding an NPU, indexed by y * width + x
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    SparseMesh2D(int width, int height, const std::vector<bool>& valid_cells, Bandwidth bandwidth,
+                 Latency latency) noexcept;
+
+    /**
+     * Constructor, with a custom NPU placement.
+     *
+     * @param width number of grid columns
+     * @param height number of grid rows
+     * @param valid_cells true for each grid cell holding an NPU, indexed by y * width + x
+     * @param npu_placement_grid NPU ID of each grid cell (-1 if not placed), indexed by y * width + x
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    SparseMesh2D(int width, int height, const std::vector<bool>& valid_cells,
+                 const std::vector<int>& npu_placement_grid, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Get the grid cell of an NPU.
+     *
+     * @param npu_id NPU ID
+     * @return grid cell index, y * width + x
+     */
+    [[nodiscard]] int get_npu_cell(DeviceId npu_id) const noexcept;
+
+    /**
+     * Get the bytes held by the distance matrix.
+     *
+     * @return allocated bytes
+     */
+    [[nodiscard]] uint64_t get_distance_matrix_bytes() const noexcept;
+
+    /**
+     * Implements the get_links_count method of Topology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implements the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implements the write_route_links method of Topology.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
+  private:
+    /// number of grid columns
+    int width;
+
+    /// number of grid rows
+    int height;
+
+    /// grid cell of each NPU
+    std::vector<int> npu_to_cell;
+
+    /// NPU of each grid cell (-1 if excluded)
+    std::vector<int> cell_to_npu;
+
+    /// hop count of each (src, dest) pair, indexed by src * npus_count + dest
+    std::vector<uint16_t> distances;
+
+    /**
+     * Count the valid cells of a grid, checking the bitmap size.
+     *
+     * @param width number of grid columns
+     * @param height number of grid rows
+     * @param valid_cells true for each grid cell holding an NPU
+     * @return number of valid cells
+     */
+    [[nodiscard]] static int count_valid_cells(int width, int height, const std::vector<bool>& valid_cells) noexcept;
+
+    /**
+     * Number the valid cells and precompute the distance matrix.
+     *
+     * @param valid_cells true for each grid cell holding an NPU
+     * @param npu_placement_grid NPU ID of each grid cell (-1 if not placed), empty for row-major numbering
+     */
+    void build(const std::vector<bool>& valid_cells, const std::vector<int>& npu_placement_grid) noexcept;
+
+    /**
+     * Implements the compute_hops_count method of BasicTopology.
+     */
+    [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implements the compute_hops_counts method of BasicTopology.
+     */
+    void compute_hops_counts(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             int* hops_counts,
+                             int count) const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
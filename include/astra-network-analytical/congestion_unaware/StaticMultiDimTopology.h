@@ -0,0 +1,273 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+#include "congestion_unaware/FullyConnected.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/Switch.h"
+#include "congestion_unaware/Topology.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * StaticMultiDimTopology implements a multi-dimensional topology
+ * whose stack of dimensions is fixed at compile time, e.g., StaticMultiDimTopology<Ring, FullyConnected, Switch>.
+ *
+ * It computes the same delays as the equivalent MultiDimTopology (dimension-ordered, optionally pipelined),
+ * but the dimensions are held by value (not behind BasicTopology pointers):
+ * address decoding is unrolled over the dimensions,
+ * and each dimension's hop count is called on its concrete (final) type, without virtual dispatch.
+ * The NPU counts, bandwidths, and latencies of the dimensions are still given at runtime.
+ *
+ * construct_topology picks a prebuilt specialization when the network config matches one,
+ * and falls back to MultiDimTopology otherwise.
+ *
+ * @tparam DimTopologies BasicTopology type of each dimension, from the lowest to the highest
+ */
+template <typename... DimTopologies> class StaticMultiDimTopology final : public Topology {
+  public:
+    /// number of network dimensions
+    static constexpr int static_dims_count = sizeof...(DimTopologies);
+
+    static_assert(static_dims_count >= 1 && static_dims_count <= MultiDimTopology::max_dims_count,
+                  "unsupported number of dimensions");
+    static_assert((std::is_base_of_v<BasicTopology, DimTopologies> && ...),
+                  "dimensions should be BasicTopology types");
+    static_assert((std::is_final_v<DimTopologies> && ...), "dimensions should be final, to be called without dispatch");
+
+    /**
+     * Constructor.
+     *
+     * @param npus_count_per_dim number of NPUs of each dimension
+     * @param bandwidth_per_dim bandwidth of each dimension in GB/s
+     * @param latency_per_dim latency of each dimension in ns
+     */
+    StaticMultiDimTopology(const std::array<int, static_dims_count>& npus_count_per_dim,
+                           const std::array<Bandwidth, static_dims_count>& bandwidth_per_dim,
+                           const std::array<Latency, static_dims_count>& latency_per_dim) noexcept
+        : Topology(),
+          dim_topologies(construct_dim_topologies(npus_count_per_dim,
+                                                  bandwidth_per_dim,
+                                                  latency_per_dim,
+                                                  std::index_sequence_for<DimTopologies...>())),
+          static_npus_count_per_dim(npus_count_per_dim),
+          dim_pipelining(true) {
+        // set topology shape
+        npus_count = 1;
+        dims_count = static_dims_count;
+        for (auto dim = 0; dim < static_dims_count; dim++) {
+            assert(npus_count_per_dim[dim] > 0);
+
+            npus_count *= npus_count_per_dim[dim];
+            this->npus_count_per_dim.push_back(npus_count_per_dim[dim]);
+            this->bandwidth_per_dim.push_back(bandwidth_per_dim[dim]);
+        }
+    }
+
+    /**
+     * Check if a network config describes this stack of dimensions.
+     *
+     * @param network_parser parsed network config
+     * @return true if the config has the same dimension types, in the same order
+     */
+    [[nodiscard]] static bool matches(const NetworkParser& network_parser) noexcept {
+        const auto topologies_per_dim = network_parser.get_topologies_per_dim();
+        if (network_parser.get_dims_count() != static_dims_count) {
+            return false;
+        }
+
+        auto dim = 0;
+        return ((topologies_per_dim[dim++] == DimTopologies::building_block) && ...);
+    }
+
+    /**
+     * Construct the topology described by a network config, which should match (see matches).
+     *
+     * @param network_parser parsed network config
+     * @return pointer to the constructed topology
+     */
+    [[nodiscard]] static std::shared_ptr<StaticMultiDimTopology> construct(
+        const NetworkParser& network_parser) noexcept {
+        assert(matches(network_parser));
+
+        auto npus_count_per_dim = std::array<int, static_dims_count>();
+        auto bandwidth_per_dim = std::array<Bandwidth, static_dims_count>();
+        auto latency_per_dim = std::array<Latency, static_dims_count>();
+        const auto npus_counts = network_parser.get_npus_counts_per_dim();
+        const auto bandwidths = network_parser.get_bandwidths_per_dim();
+        const auto latencies = network_parser.get_latencies_per_dim();
+        for (auto dim = 0; dim < static_dims_count; dim++) {
+            npus_count_per_dim[dim] = npus_counts[dim];
+            bandwidth_per_dim[dim] = bandwidths[dim];
+            latency_per_dim[dim] = latencies[dim];
+        }
+        return std::make_shared<StaticMultiDimTopology>(npus_count_per_dim, bandwidth_per_dim, latency_per_dim);
+    }
+
+    /**
+     * Implement the send method of Topology.
+     * A chunk whose src and dest are the same NPU takes no time.
+     */
+    [[nodiscard]] EventTime send(const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) const
+        noexcept override {
+        assert(0 <= src && src < npus_count);
+        assert(0 <= dest && dest < npus_count);
+        assert(chunk_size > 0);
+
+        auto link_delay = 0.0;
+        auto serialization_delay = 0.0;
+        add_transfer_delay<0>(src, dest, chunk_size, link_delay, serialization_delay);
+
+        // same formula as BasicTopology on a single dimension
+        return static_cast<EventTime>(link_delay + serialization_delay);
+    }
+
+    /**
+     * Implement the send_batch method of Topology.
+     * Every chunk is sent without virtual dispatch.
+     */
+    void send_batch(const DeviceId* const srcs,
+                    const DeviceId* const dests,
+                    const ChunkSize* const chunk_sizes,
+                    EventTime* const delays,
+                    const int count) const noexcept override {
+        assert(count >= 0);
+
+        for (auto i = 0; i < count; i++) {
+            delays[i] = StaticMultiDimTopology::send(srcs[i], dests[i], chunk_sizes[i]);
+        }
+    }
+
+    /**
+     * Set whether chunks are pipelined across dimensions (see MultiDimTopology::set_dim_pipelining).
+     *
+     * @param pipelined true to serialize chunks once at the bottleneck dimension (default),
+     *                  false to serialize them once per traversed dimension
+     */
+    void set_dim_pipelining(const bool pipelined) noexcept {
+        dim_pipelining = pipelined;
+    }
+
+    /**
+     * Implement the get_links_count method of Topology, laid out as by MultiDimTopology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override {
+        return MultiDimTopology::get_dims_links_count(dim_topology_pointers().data(), static_dims_count);
+    }
+
+    /**
+     * Implement the get_link_bandwidth method of Topology.
+     */
+    [[nodiscard]] Bandwidth get_link_bandwidth(const int link_id) const noexcept override {
+        return MultiDimTopology::get_dims_link_bandwidth(dim_topology_pointers().data(), static_dims_count, link_id);
+    }
+
+    /**
+     * Implement the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override {
+        return MultiDimTopology::get_dims_max_route_links_count(dim_topology_pointers().data(), static_dims_count);
+    }
+
+    /**
+     * Implement the write_route_links method of Topology.
+     */
+    int write_route_links(const DeviceId src, const DeviceId dest, int* const link_ids) const noexcept override {
+        return MultiDimTopology::write_dims_route_links(dim_topology_pointers().data(), static_dims_count, src, dest,
+                                                        link_ids);
+    }
+
+  private:
+    /// BasicTopology instance of each dimension, held by value
+    std::tuple<DimTopologies...> dim_topologies;
+
+    /// number of NPUs of each dimension
+    std::array<int, static_dims_count> static_npus_count_per_dim;
+
+    /// whether chunks are pipelined across dimensions
+    bool dim_pipelining;
+
+    /**
+     * Construct the BasicTopology instance of each dimension.
+     */
+    template <size_t... Dims>
+    [[nodiscard]] static std::tuple<DimTopologies...> construct_dim_topologies(
+        const std::array<int, static_dims_count>& npus_count_per_dim,
+        const std::array<Bandwidth, static_dims_count>& bandwidth_per_dim,
+        const std::array<Latency, static_dims_count>& latency_per_dim,
+        std::index_sequence<Dims...>) noexcept {
+        return std::tuple<DimTopologies...>(
+            DimTopologies(npus_count_per_dim[Dims], bandwidth_per_dim[Dims], latency_per_dim[Dims])...);
+    }
+
+    /**
+     * Get the dimensions as BasicTopology pointers, for link-level routing (not on the send path).
+     *
+     * @return pointer to each dimension
+     */
+    [[nodiscard]] std::array<const BasicTopology*, static_dims_count> dim_topology_pointers() const noexcept {
+        return std::apply(
+            [](const auto&... topologies) {
+                return std::array<const BasicTopology*, static_dims_count>{&topologies...};
+            },
+            dim_topologies);
+    }
+
+    /**
+     * Add the delays of the dimensions, from Dim upward, in which src and dest differ.
+     * src and dest are given as the NPU IDs within dimensions Dim and above,
+     * so each dimension's address is the remainder by its size.
+     *
+     * @param src src NPU ID within dimensions Dim and above
+     * @param dest dest NPU ID within dimensions Dim and above
+     * @param chunk_size size of the chunk
+     * @param link_delay accumulated link delay in ticks
+     * @param serialization_delay accumulated serialization delay in ticks
+     */
+    template <int Dim>
+    void add_transfer_delay(const DeviceId src,
+                            const DeviceId dest,
+                            const ChunkSize chunk_size,
+                            double& link_delay,
+                            double& serialization_delay) const noexcept {
+        const auto dim_size = static_npus_count_per_dim[Dim];
+        const auto src_local_id = src % dim_size;
+        const auto dest_local_id = dest % dim_size;
+
+        if (src_local_id != dest_local_id) {
+            const auto& topology = std::get<Dim>(dim_topologies);
+            link_delay += topology.compute_hops_count(src_local_id, dest_local_id) * topology.latency_ticks;
+
+            // pipelined: the bottleneck dimension serializes, otherwise each dimension does
+            const auto dim_serialization_delay = static_cast<double>(chunk_size) / topology.bandwidth_Bptick;
+            serialization_delay = dim_pipelining ? std::max(serialization_delay, dim_serialization_delay)
+                                                 : serialization_delay + dim_serialization_delay;
+        }
+
+        if constexpr (Dim + 1 < static_dims_count) {
+            add_transfer_delay<Dim + 1>(src / dim_size, dest / dim_size, chunk_size, link_delay, serialization_delay);
+        }
+    }
+};
+
+/// prebuilt specializations, picked by construct_topology
+extern template class StaticMultiDimTopology<Ring, FullyConnected, Switch>;
+
+}  // namespace NetworkAnalyticalCongestionUnaware
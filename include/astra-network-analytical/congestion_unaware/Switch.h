@@ -23,9 +23,14 @@ namespace NetworkAnalyticalCongestionUnaware {
  * For example, send(0 -> 2) flows through:
  * 0 -> switch -> 2
  * so takes 2 hops.
+ *
+ * Link i is the uplink i -> switch, and link (npus_count + i) is the downlink switch -> i.
  */
 class Switch final : public BasicTopology {
   public:
+    /// building block of the topology
+    static constexpr TopologyBuildingBlock building_block = TopologyBuildingBlock::Switch;
+
     /**
      * Constructor.
      *
@@ -35,11 +40,37 @@ class Switch final : public BasicTopology {
      */
     Switch(int npus_count, Bandwidth bandwidth, Latency latency) noexcept;
 
+    /**
+     * Implements the get_links_count method of Topology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implements the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implements the write_route_links method of Topology.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
   private:
+    /// StaticMultiDimTopology calls the dimensions it holds by their concrete type
+    template <typename... DimTopologies> friend class StaticMultiDimTopology;
+
     /**
      * Implements the compute_hops_count method of BasicTopology.
      */
     [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implements the compute_hops_counts method of BasicTopology.
+     */
+    void compute_hops_counts(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             int* hops_counts,
+                             int count) const noexcept override;
 };
 
 }  // namespace NetworkAnalyticalCongestionUnaware
@@ -6,6 +6,8 @@ LICENSE file in the root directory of this source tree.
 #pragma once
 
 #include "common/Type.h"
+#include <functional>
+#include <string>
 #include <vector>
 
 using namespace NetworkAnalytical;
@@ -33,6 +35,56 @@ class Topology {
      */
     [[nodiscard]] virtual EventTime send(DeviceId src, DeviceId dest, ChunkSize chunk_size) const noexcept = 0;
 
+    /**
+     * Estimate the transmission time of a batch of chunks,
+     * i.e., delays[i] = send(srcs[i], dests[i], chunk_sizes[i]) for every i.
+     * Topologies override this to amortize the per-call costs over the batch.
+     * @param srcs src NPU ID of each chunk
+     * @param dests dest NPU ID of each chunk
+     * @param chunk_sizes size of each chunk
+     * @param delays output: time to send each chunk from its src to dest
+     * @param count number of chunks in the batch
+     */
+    virtual void send_batch(const DeviceId* srcs,
+                            const DeviceId* dests,
+                            const ChunkSize* chunk_sizes,
+                            EventTime* delays,
+                            int count) const noexcept;
+
+    /**
+     * Estimate the transmission time of a chunk between every pair of NPUs,
+     * i.e., delay_matrix[src * npus_count + dest] = send(src, dest, chunk_size),
+     * with 0 on the diagonal.
+     *
+     * @param chunk_size size of the chunk to send
+     * @param threads_count number of threads computing the rows (0: number of hardware threads)
+     * @return row-major (npus_count x npus_count) delay matrix
+     */
+    [[nodiscard]] virtual std::vector<EventTime> compute_delay_matrix(ChunkSize chunk_size,
+                                                                      int threads_count = 1) const noexcept;
+
+    /**
+     * Compute the delay matrix and write it to a binary file.
+     * Layout: npus_count (int32_t), chunk_size (uint64_t), then the row-major matrix (uint64_t each).
+     *
+     * @param path path of the file to write
+     * @param chunk_size size of the chunk to send
+     * @param threads_count number of threads computing the rows (0: number of hardware threads)
+     */
+    void export_delay_matrix(const std::string& path, ChunkSize chunk_size, int threads_count = 1) const noexcept;
+
+    /**
+     * Read a delay matrix written by export_delay_matrix.
+     *
+     * @param path path of the file to read
+     * @param npus_count output: number of NPUs of the matrix
+     * @param chunk_size output: chunk size the matrix was computed with
+     * @return row-major (npus_count x npus_count) delay matrix
+     */
+    [[nodiscard]] static std::vector<EventTime> import_delay_matrix(const std::string& path,
+                                                                    int& npus_count,
+                                                                    ChunkSize& chunk_size) noexcept;
+
     /**
      * Get the number of NPUs in the topology.
      *
@@ -61,7 +113,54 @@ class Topology {
      */
     [[nodiscard]] std::vector<Bandwidth> get_bandwidth_per_dim() const noexcept;
 
+    /**
+     * Get the number of (directed) links chunks are routed over, e.g., to estimate their load.
+     * Link IDs range over [0, links_count), some possibly unused (e.g., beyond the edges of a mesh).
+     * Topologies without link-level routing exit with an error.
+     *
+     * @return number of link IDs
+     */
+    [[nodiscard]] virtual int get_links_count() const noexcept;
+
+    /**
+     * Get the bandwidth of a link.
+     *
+     * @param link_id link ID
+     * @return bandwidth of the link in GB/s
+     */
+    [[nodiscard]] virtual Bandwidth get_link_bandwidth(int link_id) const noexcept;
+
+    /**
+     * Get the largest number of links of a route, to size route buffers.
+     *
+     * @return largest number of links of a route
+     */
+    [[nodiscard]] virtual int get_max_route_links_count() const noexcept;
+
+    /**
+     * Write the links a chunk from src to dest traverses, in order, following the routing of send.
+     *
+     * @param src src NPU ID
+     * @param dest dest NPU ID (different from src)
+     * @param link_ids buffer of at least get_max_route_links_count() link IDs
+     * @return number of links written
+     */
+    virtual int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept;
+
   protected:
+    /**
+     * Run row_task for every src NPU of the delay matrix.
+     *
+     * @param threads_count number of threads (0: number of hardware threads)
+     * @param row_task task filling the row of the given src NPU
+     */
+    void for_each_delay_matrix_row(int threads_count, const std::function<void(DeviceId src)>& row_task) const noexcept;
+
+    /**
+     * Exit with an error: the topology doesn't support link-level routing.
+     */
+    [[noreturn]] static void exit_without_link_routing() noexcept;
+
     /// number of NPUs in the topology
     int npus_count;
 
@@ -0,0 +1,93 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/Type.h"
+#include "congestion_unaware/BasicTopology.h"
+#include <array>
+
+using namespace NetworkAnalytical;
+
+namespace NetworkAnalyticalCongestionUnaware {
+
+/**
+ * Implements a 2D or 3D torus topology.
+ *
+ * Torus(4, 3) example:
+ * 0 - 1 - 2 - 3 - (0)
+ * |   |   |   |
+ * 4 - 5 - 6 - 7 - (4)
+ * |   |   |   |
+ * 8 - 9 - 10- 11- (8)
+ * |   |   |   |
+ * (0) (1) (2) (3)
+ *
+ * NPU IDs are laid out X first, then Y, then Z: id = (z * height + y) * width + x.
+ * Chunks take the shorter way around each ring, dimension by dimension,
+ * e.g., send(0 -> 11) flows through 0 -> 3 -> 11, so takes 2 hops.
+ *
+ * Link ((dim * 2 + direction) * npus_count + i) leaves NPU i along dim, increasing (direction 0) or decreasing.
+ */
+class Torus final : public BasicTopology {
+  public:
+    /**
+     * Constructor for 2D torus.
+     *
+     * @param width number of NPUs in X dimension
+     * @param height number of NPUs in Y dimension
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    Torus(int width, int height, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Constructor for 3D torus.
+     *
+     * @param width number of NPUs in X dimension
+     * @param height number of NPUs in Y dimension
+     * @param depth number of NPUs in Z dimension
+     * @param bandwidth bandwidth of each link
+     * @param latency latency of each link
+     */
+    Torus(int width, int height, int depth, Bandwidth bandwidth, Latency latency) noexcept;
+
+    /**
+     * Implements the get_links_count method of Topology.
+     */
+    [[nodiscard]] int get_links_count() const noexcept override;
+
+    /**
+     * Implements the get_max_route_links_count method of Topology.
+     */
+    [[nodiscard]] int get_max_route_links_count() const noexcept override;
+
+    /**
+     * Implements the write_route_links method of Topology.
+     */
+    int write_route_links(DeviceId src, DeviceId dest, int* link_ids) const noexcept override;
+
+  private:
+    /// largest number of torus dimensions
+    static constexpr int max_torus_dims = 3;
+
+    /// number of NPUs per dimension (X, Y, Z), 1 for the missing Z of a 2D torus
+    std::array<int, max_torus_dims> sizes;
+
+    /**
+     * Implements the compute_hops_count method of BasicTopology.
+     */
+    [[nodiscard]] int compute_hops_count(DeviceId src, DeviceId dest) const noexcept override;
+
+    /**
+     * Implements the compute_hops_counts method of BasicTopology.
+     */
+    void compute_hops_counts(const DeviceId* srcs,
+                             const DeviceId* dests,
+                             int* hops_counts,
+                             int count) const noexcept override;
+};
+
+}  // namespace NetworkAnalyticalCongestionUnaware
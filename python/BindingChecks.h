@@ -0,0 +1,106 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "common/NetworkParser.h"
+#include "common/Type.h"
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+#include <string>
+#include <vector>
+
+namespace py = pybind11;
+using namespace NetworkAnalytical;
+
+/// input arrays are read in place when already C-contiguous of the right dtype (converted otherwise)
+template <typename T> using InputArray = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+/**
+ * Raise the errors of a network configuration as a Python ValueError, one error per line,
+ * instead of exiting the interpreter as the backends do.
+ *
+ * @param errors errors found (see NetworkParser::try_parse)
+ */
+[[noreturn]] inline void raise_config_errors(const std::vector<ConfigError>& errors) {
+    auto message = std::string("invalid network configuration");
+    for (const auto& error : errors) {
+        message += "\n  " + (error.key.empty() ? error.message : error.key + ": " + error.message);
+    }
+    throw py::value_error(message);
+}
+
+/**
+ * Describe what is wrong with a chunk, if anything:
+ * the backends only assert these, so a wrong chunk would crash the interpreter.
+ *
+ * @param npus_count number of NPUs of the topology
+ * @param src src NPU id
+ * @param dest dest NPU id
+ * @param chunk_size chunk size in bytes
+ * @return description of the error (empty: valid chunk)
+ */
+inline std::string chunk_error(const int npus_count,
+                               const DeviceId src,
+                               const DeviceId dest,
+                               const ChunkSize chunk_size) {
+    const auto npu_ids = " is not an NPU (0 to " + std::to_string(npus_count - 1) + ")";
+    if (src < 0 || src >= npus_count) {
+        return "src " + std::to_string(src) + npu_ids;
+    }
+    if (dest < 0 || dest >= npus_count) {
+        return "dest " + std::to_string(dest) + npu_ids;
+    }
+    if (src == dest) {
+        return "src and dest are both NPU " + std::to_string(src);
+    }
+    if (chunk_size == 0) {
+        return "chunk_size must be positive";
+    }
+    return "";
+}
+
+/**
+ * Check a chunk before it's sent (see chunk_error), raising a Python ValueError if wrong.
+ *
+ * @param npus_count number of NPUs of the topology
+ * @param src src NPU id
+ * @param dest dest NPU id
+ * @param chunk_size chunk size in bytes
+ */
+inline void check_chunk(const int npus_count, const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) {
+    const auto error = chunk_error(npus_count, src, dest, chunk_size);
+    if (!error.empty()) {
+        throw py::value_error(error);
+    }
+}
+
+/**
+ * Check a batch of chunks before it's sent (see chunk_error), raising a Python ValueError naming the first wrong one.
+ *
+ * @param npus_count number of NPUs of the topology
+ * @param srcs src NPU id of each chunk
+ * @param dests dest NPU id of each chunk
+ * @param chunk_sizes size of each chunk in bytes
+ */
+inline void check_chunk_batch(const int npus_count,
+                              const InputArray<DeviceId>& srcs,
+                              const InputArray<DeviceId>& dests,
+                              const InputArray<ChunkSize>& chunk_sizes) {
+    const auto count = srcs.size();
+    if (dests.size() != count || chunk_sizes.size() != count) {
+        throw py::value_error("srcs, dests, and chunk_sizes differ in length");
+    }
+
+    const auto* const src_data = srcs.data();
+    const auto* const dest_data = dests.data();
+    const auto* const chunk_size_data = chunk_sizes.data();
+    for (auto i = static_cast<py::ssize_t>(0); i < count; i++) {
+        const auto error = chunk_error(npus_count, src_data[i], dest_data[i], chunk_size_data[i]);
+        if (!error.empty()) {
+            throw py::value_error("chunk " + std::to_string(i) + ": " + error);
+        }
+    }
+}
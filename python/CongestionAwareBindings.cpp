@@ -0,0 +1,145 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "BindingChecks.h"
+#include "NetworkParserBindings.h"
+#include "common/EventQueue.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/Helper.h"
+#include "congestion_aware/Topology.h"
+#include <memory>
+#include <pybind11/numpy.h>
+#include <vector>
+
+using namespace NetworkAnalyticalCongestionAware;
+
+namespace {
+
+/// a chunk of simulate_batch, writing its delivery time into the output array
+struct BatchChunk {
+    /// event queue driving the simulation
+    const EventQueue* event_queue;
+
+    /// output slot of the chunk
+    EventTime* delivery_time;
+};
+
+/**
+ * Callback of the chunks of simulate_batch: record the delivery time.
+ *
+ * @param batch_chunk_ptr pointer to the BatchChunk
+ */
+void record_delivery(void* const batch_chunk_ptr) noexcept {
+    const auto* const batch_chunk = static_cast<const BatchChunk*>(batch_chunk_ptr);
+    *batch_chunk->delivery_time = batch_chunk->event_queue->get_current_time();
+}
+
+/**
+ * Send a batch of chunks at the current time and simulate until every chunk is delivered, without the GIL.
+ * Raises ValueError (before sending any chunk) if the arrays differ in length or a chunk is wrong.
+ *
+ * @return delivery time of each chunk
+ */
+py::array_t<EventTime> simulate_batch(Topology& topology,
+                                      const InputArray<DeviceId>& srcs,
+                                      const InputArray<DeviceId>& dests,
+                                      const InputArray<ChunkSize>& chunk_sizes) {
+    check_chunk_batch(topology.get_npus_count(), srcs, dests, chunk_sizes);
+
+    const auto count = srcs.size();
+    auto delivery_times = py::array_t<EventTime>(count);
+    const auto* const src_data = srcs.data();
+    const auto* const dest_data = dests.data();
+    const auto* const chunk_size_data = chunk_sizes.data();
+    auto* const delivery_time_data = delivery_times.mutable_data();
+    {
+        const auto release = py::gil_scoped_release();
+        const auto event_queue = topology.get_event_queue();
+        auto batch_chunks = std::vector<BatchChunk>(count);
+        auto descriptors = std::vector<ChunkDescriptor>(count);
+        for (auto i = 0; i < static_cast<int>(count); i++) {
+            batch_chunks[i] = BatchChunk{event_queue.get(), &delivery_time_data[i]};
+            descriptors[i] = ChunkDescriptor{src_data[i], dest_data[i], chunk_size_data[i], record_delivery,
+                                             &batch_chunks[i]};
+        }
+        topology.send_batch(descriptors.data(), static_cast<int>(count));
+        event_queue->run_to_completion();
+    }
+    return delivery_times;
+}
+
+/**
+ * Run a collective on a topology until it finishes, without the GIL.
+ * Raises ValueError if the collective size or the number of chunks isn't positive.
+ *
+ * @return finish time of the collective
+ */
+EventTime run_collective(const std::shared_ptr<Topology>& topology,
+                         const CollectiveType collective_type,
+                         const CollectiveAlgorithm collective_algorithm,
+                         const ChunkSize collective_size,
+                         const int chunks_count) {
+    if (collective_size == 0) {
+        throw py::value_error("collective_size must be positive");
+    }
+    if (chunks_count <= 0) {
+        throw py::value_error("chunks_count must be positive");
+    }
+
+    const auto release = py::gil_scoped_release();
+    auto collective = Collective(topology, collective_type, collective_algorithm, collective_size, chunks_count);
+    collective.start();
+    topology->get_event_queue()->run_to_completion();
+    return collective.get_finish_time();
+}
+
+}  // namespace
+
+PYBIND11_MODULE(analytical_congestion_aware, module) {
+    module.doc() = "ASTRA-sim analytical network backend, congestion-aware model";
+
+    bind_network_parser(module);
+
+    py::enum_<CollectiveType>(module, "CollectiveType")
+        .value("AllGather", CollectiveType::AllGather)
+        .value("ReduceScatter", CollectiveType::ReduceScatter)
+        .value("AllReduce", CollectiveType::AllReduce)
+        .value("AllToAll", CollectiveType::AllToAll);
+
+    py::enum_<CollectiveAlgorithm>(module, "CollectiveAlgorithm")
+        .value("Ring", CollectiveAlgorithm::Ring)
+        .value("Direct", CollectiveAlgorithm::Direct)
+        .value("HalvingDoubling", CollectiveAlgorithm::HalvingDoubling)
+        .value("Hierarchical", CollectiveAlgorithm::Hierarchical);
+
+    py::class_<EventQueue, std::shared_ptr<EventQueue>>(module, "EventQueue")
+        .def(py::init<>())
+        .def("get_current_time", &EventQueue::get_current_time)
+        .def("run_to_completion", &EventQueue::run_to_completion, py::call_guard<py::gil_scoped_release>());
+
+    py::class_<Topology, std::shared_ptr<Topology>>(module, "Topology")
+        .def("get_npus_count", &Topology::get_npus_count)
+        .def("get_devices_count", &Topology::get_devices_count)
+        .def("get_event_queue", &Topology::get_event_queue)
+        .def("reset", &Topology::reset)
+        .def("simulate_batch", &simulate_batch, py::arg("srcs"), py::arg("dests"), py::arg("chunk_sizes"));
+
+    // every topology gets an event queue of its own, so topologies are independent simulations
+    module.def(
+        "construct_topology",
+        [](const NetworkParser& network_parser) {
+            auto errors = std::vector<ConfigError>();
+            auto topology = try_construct_topology(network_parser, errors);
+            if (topology == nullptr) {
+                raise_config_errors(errors);
+            }
+            topology->attach_event_queue(std::make_shared<EventQueue>());
+            return topology;
+        },
+        py::arg("network_parser"));
+
+    module.def("run_collective", &run_collective, py::arg("topology"), py::arg("collective_type"),
+               py::arg("collective_algorithm"), py::arg("collective_size"), py::arg("chunks_count") = 1);
+}
@@ -0,0 +1,103 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#include "BindingChecks.h"
+#include "NetworkParserBindings.h"
+#include "congestion_unaware/Helper.h"
+#include "congestion_unaware/Topology.h"
+#include <memory>
+#include <pybind11/numpy.h>
+#include <vector>
+
+using namespace NetworkAnalyticalCongestionUnaware;
+
+namespace {
+
+/**
+ * Hand a vector over to NumPy without copying it: the array owns the vector's buffer.
+ *
+ * @param values vector to hand over
+ * @return array viewing the vector's elements
+ */
+template <typename T> py::array_t<T> to_array(std::vector<T>&& values) {
+    auto* const owned_values = new std::vector<T>(std::move(values));
+    const auto owner = py::capsule(owned_values, [](void* const pointer) {
+        delete static_cast<std::vector<T>*>(pointer);
+    });
+    return py::array_t<T>(owned_values->size(), owned_values->data(), owner);
+}
+
+/**
+ * Compute the delays of a batch of chunks into a new array (see Topology::send_batch), without the GIL.
+ * Raises ValueError (before computing any delay) if the arrays differ in length or a chunk is wrong.
+ */
+py::array_t<EventTime> send_batch(const Topology& topology,
+                                  const InputArray<DeviceId>& srcs,
+                                  const InputArray<DeviceId>& dests,
+                                  const InputArray<ChunkSize>& chunk_sizes) {
+    check_chunk_batch(topology.get_npus_count(), srcs, dests, chunk_sizes);
+
+    const auto count = srcs.size();
+    auto delays = py::array_t<EventTime>(count);
+    const auto* const src_data = srcs.data();
+    const auto* const dest_data = dests.data();
+    const auto* const chunk_size_data = chunk_sizes.data();
+    auto* const delay_data = delays.mutable_data();
+    {
+        const auto release = py::gil_scoped_release();
+        topology.send_batch(src_data, dest_data, chunk_size_data, delay_data, static_cast<int>(count));
+    }
+    return delays;
+}
+
+}  // namespace
+
+PYBIND11_MODULE(analytical_congestion_unaware, module) {
+    module.doc() = "ASTRA-sim analytical network backend, congestion-unaware model";
+
+    bind_network_parser(module);
+
+    py::class_<Topology, std::shared_ptr<Topology>>(module, "Topology")
+        .def("get_npus_count", &Topology::get_npus_count)
+        .def("get_dims_count", &Topology::get_dims_count)
+        .def(
+            "send",
+            [](const Topology& topology, const DeviceId src, const DeviceId dest, const ChunkSize chunk_size) {
+                check_chunk(topology.get_npus_count(), src, dest, chunk_size);
+                return topology.send(src, dest, chunk_size);
+            },
+            py::arg("src"), py::arg("dest"), py::arg("chunk_size"))
+        .def("send_batch", &send_batch, py::arg("srcs"), py::arg("dests"), py::arg("chunk_sizes"))
+        .def(
+            "compute_delay_matrix",
+            [](const Topology& topology, const ChunkSize chunk_size, const int threads_count) {
+                if (chunk_size == 0) {
+                    throw py::value_error("chunk_size must be positive");
+                }
+                if (threads_count < 0) {
+                    throw py::value_error("threads_count must not be negative");
+                }
+                auto delay_matrix = std::vector<EventTime>();
+                {
+                    const auto release = py::gil_scoped_release();
+                    delay_matrix = topology.compute_delay_matrix(chunk_size, threads_count);
+                }
+                const auto npus_count = static_cast<py::ssize_t>(topology.get_npus_count());
+                return to_array(std::move(delay_matrix)).reshape({npus_count, npus_count});
+            },
+            py::arg("chunk_size"), py::arg("threads_count") = 1);
+
+    module.def(
+        "construct_topology",
+        [](const NetworkParser& network_parser) {
+            auto errors = std::vector<ConfigError>();
+            auto topology = try_construct_topology(network_parser, errors);
+            if (topology == nullptr) {
+                raise_config_errors(errors);
+            }
+            return topology;
+        },
+        py::arg("network_parser"));
+}
@@ -0,0 +1,47 @@
+/******************************************************************************
+This source code is licensed under the MIT license found in the
+LICENSE file in the root directory of this source tree.
+*******************************************************************************/
+
+#pragma once
+
+#include "BindingChecks.h"
+#include "common/NetworkParser.h"
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace py = pybind11;
+using namespace NetworkAnalytical;
+
+/**
+ * Bind NetworkParser into a module.
+ * The binding is local to the module, so both backend modules can be imported together.
+ * An invalid configuration file raises ValueError listing its errors, rather than exiting the interpreter.
+ *
+ * @param module module to bind into
+ */
+inline void bind_network_parser(py::module_& module) {
+    py::class_<NetworkParser>(module, "NetworkParser", py::module_local())
+        .def(py::init([](const std::string& path) {
+                 auto errors = std::vector<ConfigError>();
+                 auto network_parser = NetworkParser::try_load(path, errors);
+                 if (!network_parser.has_value()) {
+                     raise_config_errors(errors);
+                 }
+                 return std::move(*network_parser);
+             }),
+             py::arg("path"))
+        .def_static("load_cached", &NetworkParser::load_cached, py::arg("path"), py::arg("compiled_path") = "")
+        .def("get_dims_count", &NetworkParser::get_dims_count)
+        .def("get_npus_counts_per_dim", &NetworkParser::get_npus_counts_per_dim)
+        .def("get_bandwidths_per_dim", &NetworkParser::get_bandwidths_per_dim)
+        .def("get_latencies_per_dim", &NetworkParser::get_latencies_per_dim)
+        .def("get_mesh_width", &NetworkParser::get_mesh_width)
+        .def("get_mesh_height", &NetworkParser::get_mesh_height)
+        .def("get_npu_placement_grid", &NetworkParser::get_npu_placement_grid)
+        .def("get_ring_dilations", &NetworkParser::get_ring_dilations);
+}
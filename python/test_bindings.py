@@ -0,0 +1,95 @@
+## ******************************************************************************
+## This source code is licensed under the MIT license found in the
+## LICENSE file in the root directory of this source tree.
+## ******************************************************************************
+
+"""Smoke tests of the Python bindings (run by ctest from the python/ build directory)."""
+
+import os
+
+import numpy as np
+import pytest
+
+import analytical_congestion_aware as aware
+import analytical_congestion_unaware as unaware
+
+INPUT_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "input")
+RING_PATH = os.path.join(INPUT_DIR, "Ring.yml")
+CHUNK_SIZE = 1_048_576
+
+
+@pytest.fixture
+def invalid_config_path(tmp_path):
+    path = tmp_path / "invalid.yml"
+    path.write_text("topology: [ Ring ]\nnpus_count: [ 1 ]\nbandwidth: [ -50.0 ]\nlatency: [ 500.0 ]\n")
+    return str(path)
+
+
+@pytest.mark.parametrize("backend", [aware, unaware])
+def test_network_parser(backend):
+    network_parser = backend.NetworkParser(RING_PATH)
+    assert network_parser.get_dims_count() == 1
+    assert network_parser.get_npus_counts_per_dim() == [16]
+
+
+@pytest.mark.parametrize("backend", [aware, unaware])
+def test_invalid_config_raises(backend, invalid_config_path):
+    with pytest.raises(ValueError, match="invalid network configuration"):
+        backend.NetworkParser(invalid_config_path)
+    with pytest.raises(ValueError):
+        backend.NetworkParser(os.path.join(INPUT_DIR, "missing.yml"))
+
+
+def test_unaware_send_batch():
+    topology = unaware.construct_topology(unaware.NetworkParser(RING_PATH))
+    srcs = np.array([0, 0, 3], dtype=np.int32)
+    dests = np.array([1, 8, 2], dtype=np.int32)
+    chunk_sizes = np.full(3, CHUNK_SIZE, dtype=np.uint64)
+    delays = topology.send_batch(srcs, dests, chunk_sizes)
+    assert list(delays) == [topology.send(src, dest, CHUNK_SIZE) for src, dest in zip(srcs, dests)]
+    assert delays[0] < delays[1]
+
+    delay_matrix = topology.compute_delay_matrix(CHUNK_SIZE)
+    assert delay_matrix.shape == (16, 16)
+    assert delay_matrix[0, 8] == delays[1]
+
+
+def test_unaware_invalid_chunks_raise():
+    topology = unaware.construct_topology(unaware.NetworkParser(RING_PATH))
+    with pytest.raises(ValueError, match="not an NPU"):
+        topology.send(0, 16, CHUNK_SIZE)
+    with pytest.raises(ValueError, match="both NPU"):
+        topology.send(2, 2, CHUNK_SIZE)
+    with pytest.raises(ValueError, match="differ in length"):
+        topology.send_batch(np.array([0, 1]), np.array([1]), np.array([CHUNK_SIZE, CHUNK_SIZE]))
+    with pytest.raises(ValueError, match="chunk 1"):
+        topology.send_batch(np.array([0, 1]), np.array([1, -1]), np.array([CHUNK_SIZE, CHUNK_SIZE]))
+    with pytest.raises(ValueError):
+        topology.compute_delay_matrix(0)
+
+
+def test_aware_simulate_batch():
+    topology = aware.construct_topology(aware.NetworkParser(RING_PATH))
+    srcs = np.array([0, 0], dtype=np.int32)
+    dests = np.array([1, 8], dtype=np.int32)
+    chunk_sizes = np.full(2, CHUNK_SIZE, dtype=np.uint64)
+    delivery_times = topology.simulate_batch(srcs, dests, chunk_sizes)
+    assert 0 < delivery_times[0] < delivery_times[1]
+    assert topology.get_event_queue().get_current_time() == delivery_times[1]
+
+
+def test_aware_invalid_requests_raise():
+    topology = aware.construct_topology(aware.NetworkParser(RING_PATH))
+    with pytest.raises(ValueError, match="chunk 0"):
+        topology.simulate_batch(np.array([-1]), np.array([1]), np.array([CHUNK_SIZE]))
+    with pytest.raises(ValueError, match="chunk_size"):
+        topology.simulate_batch(np.array([0]), np.array([1]), np.array([0]))
+    with pytest.raises(ValueError, match="differ in length"):
+        topology.simulate_batch(np.array([0]), np.array([1, 2]), np.array([CHUNK_SIZE]))
+    with pytest.raises(ValueError, match="chunks_count"):
+        aware.run_collective(topology, aware.CollectiveType.AllReduce, aware.CollectiveAlgorithm.Ring, CHUNK_SIZE, 0)
+
+    # nothing was sent, so the topology still simulates
+    finish_time = aware.run_collective(topology, aware.CollectiveType.AllReduce, aware.CollectiveAlgorithm.Ring,
+                                       CHUNK_SIZE, 4)
+    assert finish_time > 0
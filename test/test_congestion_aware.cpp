@@ -3,11 +3,90 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/CompressedOutput.h"
+#include "common/Event.h"
+#include "common/EventListPool.h"
+#include "common/EventListTable.h"
 #include "common/EventQueue.h"
+#include "common/FrameSocket.h"
+#include "common/Histogram.h"
+#include "common/Logger.h"
+#include "common/NetworkDownscaling.h"
+#include "common/NetworkFunction.h"
 #include "common/NetworkParser.h"
+#include "common/NetworkScenarios.h"
+#include "common/Profiler.h"
+#include "common/QueryServer.h"
+#include "common/Reclaimer.h"
+#include "common/ResultCache.h"
+#include "common/SendGraph.h"
+#include "common/SimulationFork.h"
+#include "common/SpscRing.h"
+#include "common/Telemetry.h"
+#include "common/TimeBase.h"
 #include "common/Type.h"
+#include "common/WorkStealingExecutor.h"
+#include "congestion_aware/CApi.h"
 #include "congestion_aware/Chunk.h"
+#include "congestion_aware/ChunkQueue.h"
+#include "congestion_aware/Collective.h"
+#include "congestion_aware/CollectivePlanner.h"
+#include "congestion_aware/CollectiveTuner.h"
+#include "congestion_aware/CompletionGroup.h"
+#include "congestion_aware/CompletionLog.h"
+#include "congestion_aware/Coroutine.h"
+#include "congestion_aware/CriticalPath.h"
+#include "congestion_aware/CustomTopology.h"
+#include "congestion_aware/DistributedSimulation.h"
+#include "congestion_aware/Dragonfly.h"
+#include "congestion_aware/ExecutionTraceAdapter.h"
+#include "congestion_aware/FatTree.h"
+#include "congestion_aware/FlowModel.h"
+#include "congestion_aware/FlowSampling.h"
+#include "congestion_aware/FullyConnected.h"
 #include "congestion_aware/Helper.h"
+#include "congestion_aware/HybridModel.h"
+#include "congestion_aware/InjectionPipeline.h"
+#include "congestion_aware/LatencyHistograms.h"
+#include "congestion_aware/LinkTrace.h"
+#include "congestion_aware/Mesh2D.h"
+#include "congestion_aware/Mesh3D.h"
+#include "congestion_aware/MultiDimTopology.h"
+#include "congestion_aware/MultiRail.h"
+#include "congestion_aware/OpticalCircuitSwitch.h"
+#include "congestion_aware/OptimisticSimulation.h"
+#include "congestion_aware/MulticastTree.h"
+#include "congestion_aware/ParallelSimulation.h"
+#include "congestion_aware/Ring.h"
+#include "congestion_aware/SharedTopology.h"
+#include "congestion_aware/SimulationService.h"
+#include "congestion_aware/SnapshotTopology.h"
+#include "congestion_aware/SparseMesh2D.h"
+#include "congestion_aware/SteadyState.h"
+#include "congestion_aware/StaticRouting.h"
+#include "congestion_aware/Sweep.h"
+#include "congestion_aware/SweepTable.h"
+#include "congestion_aware/Switch.h"
+#include "congestion_aware/SyntheticTraffic.h"
+#include "congestion_aware/Torus.h"
+#include "congestion_aware/TrafficSource.h"
+#include "congestion_aware/TraceReplay.h"
+#include "congestion_aware/UtilizationSampler.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <sched.h>
+#include <set>
+#include <sstream>
+#include <sys/socket.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
 #include <gtest/gtest.h>
 
 using namespace NetworkAnalytical;
@@ -53,6 +132,29 @@ TEST_F(TestNetworkAnalyticalCongestionAware, Ring) {
     EXPECT_EQ(simulation_time, 60'093);
 }
 
+TEST_F(TestNetworkAnalyticalCongestionAware, RingStriping) {
+    /// setup: 4 MB from NPU 0 to its neighbor 1, 3 MB going the shorter way, 1 MB the longer way (3 hops)
+    auto topology = std::make_shared<Ring>(4, 50, 500);
+
+    // test: the transfer arrives with its slower stripe, the 1 MB one
+    topology->send_striped(4 * chunk_size, 0, 1, callback, nullptr);
+    EXPECT_EQ(topology->get_active_striped_transfers_count(), 1);
+    EXPECT_EQ(event_queue->run_to_completion(), 3 * 20'031 * ticks_per_ns);
+    EXPECT_EQ(topology->get_active_striped_transfers_count(), 0);
+
+    // test: the same transfer the shorter way only takes longer
+    auto start_time = event_queue->get_current_time();
+    topology->send(4 * chunk_size, 0, 1, callback, nullptr);
+    EXPECT_GT(event_queue->run_to_completion() - start_time, 3 * 20'031 * ticks_per_ns);
+
+    // test: a unidirectional ring sends the transfer as a single chunk
+    auto unidirectional_topology = std::make_shared<Ring>(4, 50, 500, false);
+    start_time = event_queue->get_current_time();
+    unidirectional_topology->send_striped(chunk_size, 0, 1, callback, nullptr);
+    EXPECT_EQ(unidirectional_topology->get_active_striped_transfers_count(), 0);
+    EXPECT_EQ(event_queue->run_to_completion() - start_time, 20'031 * ticks_per_ns);
+}
+
 TEST_F(TestNetworkAnalyticalCongestionAware, FullyConnected) {
     /// setup
     const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
@@ -132,3 +234,6333 @@ TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRing) {
     const auto simulation_time = event_queue->get_current_time();
     EXPECT_EQ(simulation_time, 704'116);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRingWithEventQueueTypes) {
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::TimingWheel}) {
+        /// setup
+        event_queue = std::make_shared<EventQueue>(event_queue_type);
+        Topology::set_event_queue(event_queue);
+        const auto network_parser = NetworkParser("../../input/Ring.yml");
+        const auto topology = construct_topology(network_parser);
+        const auto npus_count = topology->get_npus_count();
+
+        /// Run All-Gather
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i == j) {
+                    continue;
+                }
+
+                // crate a chunk
+                auto route = topology->route(i, j);
+                auto chunk = std::make_unique<Chunk>(chunk_size, route, callback, nullptr);
+
+                // send a chunk
+                topology->send(std::move(chunk));
+            }
+        }
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        /// test: same result as the default heap-based event queue
+        const auto simulation_time = event_queue->get_current_time();
+        EXPECT_EQ(simulation_time, 704'116);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventQueueOrdering) {
+    // event times spanning both near and far future (beyond the timing wheel window)
+    const auto event_times = std::vector<EventTime>{70'000, 5, 1'000'000'000, 5, 65'541, 3, 65'536, 70'000};
+    const auto expected_times = std::vector<EventTime>{3, 5, 5, 65'536, 65'541, 70'000, 70'000, 1'000'000'000};
+
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::Heap, EventQueueType::TimingWheel}) {
+        auto queue = EventQueue(event_queue_type);
+        auto invoked_times = std::vector<EventTime>();
+        auto context = std::make_pair(&queue, &invoked_times);
+
+        // record the current time on every invocation
+        const auto record_time = [](void* const arg) {
+            auto* const ctx = static_cast<std::pair<EventQueue*, std::vector<EventTime>*>*>(arg);
+            ctx->second->push_back(ctx->first->get_current_time());
+        };
+
+        for (const auto event_time : event_times) {
+            queue.schedule_event(event_time, record_time, &context);
+        }
+
+        // run
+        while (!queue.finished()) {
+            queue.proceed();
+        }
+
+        EXPECT_EQ(invoked_times, expected_times);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventQueueStepping) {
+    const auto event_times = std::vector<EventTime>{70'000, 5, 1'000'000'000, 5, 65'541, 3, 65'536, 70'000};
+
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::Heap, EventQueueType::TimingWheel}) {
+        auto queue = EventQueue(event_queue_type);
+        auto invoked_times = std::vector<EventTime>();
+        auto context = std::make_pair(&queue, &invoked_times);
+
+        // record the current time on every invocation
+        const auto record_time = [](void* const arg) {
+            auto* const ctx = static_cast<std::pair<EventQueue*, std::vector<EventTime>*>*>(arg);
+            ctx->second->push_back(ctx->first->get_current_time());
+        };
+
+        for (const auto event_time : event_times) {
+            queue.schedule_event(event_time, record_time, &context);
+        }
+
+        // test: events up to (and including) the given time are invoked, then the time advances
+        queue.run_until(5);
+        EXPECT_EQ(invoked_times, (std::vector<EventTime>{3, 5, 5}));
+        EXPECT_EQ(queue.get_next_event_time(), 65'536);
+        queue.run_until(60'000);
+        EXPECT_EQ(invoked_times.size(), 3);
+        EXPECT_EQ(queue.get_current_time(), 60'000);
+
+        // test: the host can schedule at the time it ran until
+        queue.schedule_event(60'000, record_time, &context);
+        queue.run_until(60'000);
+        EXPECT_EQ(invoked_times.back(), 60'000);
+
+        // test: running to completion drains the queue
+        EXPECT_EQ(queue.run_to_completion(), 1'000'000'000);
+        EXPECT_EQ(invoked_times.size(), event_times.size() + 1);
+        EXPECT_EQ(queue.get_next_event_time(), std::numeric_limits<EventTime>::max());
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventListRecycling) {
+    /// setup
+    const auto noop = [](void* const) {};
+    const auto events_count = 100;
+
+    // test: a released event list is reused as is, keeping its event storage
+    auto pool = EventListPool();
+    auto event_list = pool.acquire(10);
+    for (auto i = 0; i < events_count; i++) {
+        event_list->add_event(noop, nullptr);
+    }
+    event_list->clear_events();
+    const auto* const recycled_list = event_list.get();
+    const auto list_bytes = event_list->get_allocated_bytes();
+    EXPECT_GE(list_bytes, sizeof(EventList) + (events_count * sizeof(Event)));
+    pool.release(std::move(event_list));
+    EXPECT_GE(pool.get_allocated_bytes(), list_bytes);
+
+    event_list = pool.acquire(20);
+    EXPECT_EQ(event_list.get(), recycled_list);
+    EXPECT_EQ(event_list->get_event_time(), 20);
+    EXPECT_EQ(event_list->get_events_count(), 0);
+    EXPECT_EQ(event_list->get_allocated_bytes(), list_bytes);
+    EXPECT_LT(pool.get_allocated_bytes(), list_bytes);
+
+    // test: the most recently released list is reused first, and an empty pool allocates a new one
+    auto other_list = pool.acquire(30);
+    EXPECT_NE(other_list.get(), recycled_list);
+    const auto* const other_recycled_list = other_list.get();
+    pool.release(std::move(event_list));
+    pool.release(std::move(other_list));
+    EXPECT_EQ(pool.acquire(40).get(), other_recycled_list);
+
+    // test: the table finds every registered list, also after erasing others (with colliding probes)
+    auto lists = std::vector<std::unique_ptr<EventList>>();
+    auto table = EventListTable();
+    for (auto i = 0; i < 1'000; i++) {
+        lists.push_back(std::make_unique<EventList>(static_cast<EventTime>(i) * 64));
+        table.insert(lists.back().get());
+    }
+    const auto table_bytes = table.get_allocated_bytes();
+    for (auto i = 0; i < 1'000; i += 2) {
+        table.erase(static_cast<EventTime>(i) * 64);
+    }
+    for (auto i = 0; i < 1'000; i++) {
+        EXPECT_EQ(table.find(static_cast<EventTime>(i) * 64), (i % 2 == 0) ? nullptr : lists[i].get());
+    }
+
+    // test: erasing and inserting up to the same number of lists never grows the table
+    for (auto i = 0; i < 1'000; i += 2) {
+        table.insert(lists[i].get());
+    }
+    EXPECT_EQ(table.find(0), lists[0].get());
+    EXPECT_EQ(table.get_allocated_bytes(), table_bytes);
+
+    // test: the heap queue reports its recycled event lists in its peak usage, not its current one,
+    // and reuses them instead of growing
+    auto queue = EventQueue(EventQueueType::Heap);
+    const auto idle_usage = queue.get_memory_usage();
+    const auto schedule_and_run = [&queue, noop]() {
+        const auto current_time = queue.get_current_time();
+        for (auto i = 1; i <= events_count; i++) {
+            queue.schedule_event(current_time + i, noop, nullptr);
+        }
+        const auto scheduled_usage = queue.get_memory_usage();
+        queue.run_to_completion();
+        return scheduled_usage;
+    };
+    const auto first_usage = schedule_and_run();
+    EXPECT_GE(first_usage.bytes, idle_usage.bytes + (events_count * sizeof(EventList)));
+    const auto drained_usage = queue.get_memory_usage();
+    EXPECT_LT(drained_usage.bytes, first_usage.bytes);
+    EXPECT_GE(drained_usage.peak_bytes, drained_usage.bytes + (events_count * sizeof(EventList)));
+    schedule_and_run();
+    EXPECT_EQ(queue.get_memory_usage().peak_bytes, drained_usage.peak_bytes);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventKindDispatch) {
+    // test: user events keep their callback, internal events only carry their kind and argument
+    auto value = 0;
+    const auto user_event = Event(callback, &value);
+    EXPECT_EQ(user_event.get_kind(), EventKind::UserCallback);
+    EXPECT_EQ(user_event.get_handler_arg(), std::make_pair(Callback(callback), CallbackArg(&value)));
+    const auto link_free_event = Event(EventKind::LinkFree, &value);
+    EXPECT_EQ(link_free_event.get_kind(), EventKind::LinkFree);
+    EXPECT_EQ(link_free_event.get_handler_arg(), std::make_pair(Callback(nullptr), CallbackArg(&value)));
+
+    /// setup
+    const auto topology = construct_topology(NetworkParser("../../input/Ring.yml"));
+    const auto npus_count = topology->get_npus_count();
+    const auto& link = topology->get_link(topology->find_link(0, 1));
+
+    // record the delivery time of chunks, and the chunks queued at the link at given times
+    struct Recorder {
+        const EventQueue* event_queue;
+        const Link* link;
+        std::vector<EventTime> delivery_times;
+        std::vector<int> queued_chunks_counts;
+    };
+    auto recorder = Recorder{event_queue.get(), &link, {}, {}};
+    const auto record_delivery = [](void* const arg) {
+        auto* const recorder = static_cast<Recorder*>(arg);
+        recorder->delivery_times.push_back(recorder->event_queue->get_current_time());
+    };
+    const auto record_queued_chunks = [](void* const arg) {
+        auto* const recorder = static_cast<Recorder*>(arg);
+        recorder->queued_chunks_counts.push_back(recorder->link->get_queued_chunks_count());
+    };
+
+    // test: a chunk over a link frees the link (LinkFree) once serialized, then arrives (ChunkArrival)
+    topology->send(chunk_size, 0, 1, record_delivery, &recorder);
+    const auto serialization_time = event_queue->get_next_event_time();
+    EXPECT_EQ(link.get_queued_chunks_count(), 1);
+    event_queue->proceed();
+    EXPECT_EQ(event_queue->get_current_time(), serialization_time);
+    EXPECT_EQ(link.get_queued_chunks_count(), 0);
+    EXPECT_TRUE(recorder.delivery_times.empty());
+    event_queue->run_to_completion();
+    const auto delivery_time = link.communication_delay(chunk_size);
+    ASSERT_EQ(recorder.delivery_times, std::vector<EventTime>{delivery_time});
+    ASSERT_GT(delivery_time, serialization_time);
+
+    // test: events of every kind at the same time are invoked in registration order,
+    // i.e., user callbacks scheduled before the link free see the link busy, and the ones after see it free
+    const auto start_time = event_queue->get_current_time();
+    event_queue->schedule_event(start_time + serialization_time, record_queued_chunks, &recorder);
+    topology->send(chunk_size, 0, 1, record_delivery, &recorder);
+    event_queue->schedule_event(start_time + serialization_time, record_queued_chunks, &recorder);
+    event_queue->run_to_completion();
+    EXPECT_EQ(recorder.queued_chunks_counts, (std::vector<int>{1, 0}));
+    EXPECT_EQ(recorder.delivery_times.back(), start_time + delivery_time);
+
+    // test: consecutive link frees are dispatched as a run, each starting the chunk pending at its link
+    const auto runs_start_time = event_queue->get_current_time();
+    recorder.delivery_times.clear();
+    for (auto round = 0; round < 2; round++) {
+        for (auto src = 0; src < npus_count; src++) {
+            topology->send(chunk_size, src, (src + 1) % npus_count, record_delivery, &recorder);
+        }
+    }
+    event_queue->run_to_completion();
+    auto expected_delivery_times = std::vector<EventTime>(npus_count, runs_start_time + delivery_time);
+    expected_delivery_times.resize(2 * npus_count, runs_start_time + serialization_time + delivery_time);
+    EXPECT_EQ(recorder.delivery_times, expected_delivery_times);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BoundedRun) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto send_all_gather = [&] {
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest++) {
+                if (src != dest) {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+    };
+    send_all_gather();
+    const auto finish_time = event_queue->run_to_completion();
+    event_queue->reset();
+    topology->reset();
+
+    // test: a time bound stops before the events past it, returning the next event time as a lower bound
+    send_all_gather();
+    auto bounds = RunBounds();
+    bounds.time_bound = finish_time / 2;
+    const auto time_bounded_run = event_queue->run_bounded(bounds);
+    EXPECT_FALSE(time_bounded_run.completed);
+    EXPECT_GT(time_bounded_run.finish_time, finish_time / 2);
+    EXPECT_LE(time_bounded_run.finish_time, finish_time);
+    EXPECT_LE(event_queue->get_current_time(), finish_time / 2);
+
+    // test: an event budget stops after a few event times
+    bounds = RunBounds();
+    bounds.events_budget = 3;
+    const auto budgeted_run = event_queue->run_bounded(bounds);
+    EXPECT_FALSE(budgeted_run.completed);
+    EXPECT_GE(budgeted_run.finish_time, time_bounded_run.finish_time);
+
+    // test: an exhausted wall-clock budget stops too
+    bounds = RunBounds();
+    bounds.wall_clock_budget = 0;
+    EXPECT_FALSE(event_queue->run_bounded(bounds).completed);
+
+    // test: a stopped run resumes to the same finish time
+    const auto resumed_run = event_queue->run_bounded(RunBounds());
+    EXPECT_TRUE(resumed_run.completed);
+    EXPECT_EQ(resumed_run.finish_time, finish_time);
+}
+
+namespace {
+
+/// host simulator's event queue, scheduling network events alongside its own
+class HostScheduler final : public NetworkScheduler {
+  public:
+    [[nodiscard]] EventTime get_current_time() const noexcept override {
+        return current_time;
+    }
+
+    void schedule_event(const EventTime event_time, const Event& event) noexcept override {
+        events.emplace(event_time, event);
+    }
+
+    void run() noexcept {
+        while (!events.empty()) {
+            auto [event_time, event] = *events.begin();
+            events.erase(events.begin());
+            current_time = event_time;
+            event.invoke_event();
+        }
+    }
+
+  private:
+    EventTime current_time = 0;
+
+    /// same-time events are invoked in scheduling order
+    std::multimap<EventTime, Event> events;
+};
+
+}  // namespace
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HostScheduler) {
+    auto host_scheduler = std::make_shared<HostScheduler>();
+    auto host_topology = std::make_shared<Ring>(8, 50, 500);
+    host_topology->attach_scheduler(host_scheduler);
+    EXPECT_EQ(host_topology->get_event_queue(), nullptr);
+
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    auto ring_topology = std::make_shared<Ring>(8, 50, 500);
+    ring_topology->attach_scheduler(ring_event_queue);
+    EXPECT_EQ(ring_topology->get_event_queue(), ring_event_queue);
+
+    // run All-Gather on both
+    auto host_all_gather = Collective(host_topology, CollectiveType::AllGather, CollectiveAlgorithm::Ring, chunk_size);
+    host_all_gather.start(callback, nullptr);
+    host_scheduler->run();
+
+    auto ring_all_gather = Collective(ring_topology, CollectiveType::AllGather, CollectiveAlgorithm::Ring, chunk_size);
+    ring_all_gather.start(callback, nullptr);
+    ring_event_queue->run_to_completion();
+
+    // test: events scheduled straight into the host's queue proceed identically
+    EXPECT_GT(host_scheduler->get_current_time(), 0);
+    EXPECT_EQ(host_scheduler->get_current_time(), ring_event_queue->get_current_time());
+    EXPECT_EQ(host_all_gather.get_finish_time(), ring_all_gather.get_finish_time());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, AllGatherOnRingWithChunkPool) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    /// Run All-Gather twice, the second round reusing recycled chunks
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i == j) {
+                    continue;
+                }
+
+                // send a pooled chunk
+                topology->send(chunk_size, i, j, callback, nullptr);
+            }
+        }
+
+        /// Run simulation
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+
+        /// test: every chunk has been returned to the pool
+        EXPECT_EQ(topology->get_chunk_pool().get_free_chunks_count(), npus_count * (npus_count - 1));
+    }
+
+    /// test: second round starts at 704'116 and takes the same time
+    const auto simulation_time = event_queue->get_current_time();
+    EXPECT_EQ(simulation_time, 2 * 704'116);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RouteStorage) {
+    // short route kept inline
+    auto route = Route({5, 1, 6, 2, 3});
+    EXPECT_EQ(route.size(), 5);
+    EXPECT_EQ(route.front(), 5);
+    EXPECT_EQ(route.back(), 3);
+
+    // long route spilled to the heap
+    auto long_route = Route();
+    for (int i = 0; i < 3 * Route::inline_capacity; i++) {
+        long_route.push_back(i);
+    }
+    EXPECT_EQ(long_route.size(), 3 * Route::inline_capacity);
+    EXPECT_EQ(long_route[Route::inline_capacity], Route::inline_capacity);
+
+    // copy and move preserve the device ids
+    auto copied_route = long_route;
+    EXPECT_EQ(copied_route, long_route);
+    auto moved_route = std::move(copied_route);
+    EXPECT_EQ(moved_route, long_route);
+    moved_route = route;
+    EXPECT_EQ(moved_route, route);
+
+    // ids up to the largest one routes hold (16 bits with compact ids) round-trip
+    auto edge_route = Route({0, max_route_index});
+    edge_route.set_link_id(0, max_route_index);
+    edge_route.mark_links_resolved();
+    EXPECT_EQ(edge_route.back(), max_route_index);
+    EXPECT_EQ(edge_route.link_id(0), max_route_index);
+    EXPECT_EQ(std::vector<DeviceId>(edge_route.begin(), edge_route.end()), std::vector<DeviceId>({0, max_route_index}));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RouteCacheCapacities) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    // disabled, direct-mapped (smaller than all pairs), and all-pairs caches
+    for (const auto capacity : {0, npus_count - 1, RouteCache::default_capacity}) {
+        topology->set_route_cache_capacity(capacity);
+
+        // query every pair twice: cached routes must match computed ones
+        for (int round = 0; round < 2; round++) {
+            for (int i = 0; i < npus_count; i++) {
+                for (int j = 0; j < npus_count; j++) {
+                    EXPECT_EQ(topology->route(i, j), topology->compute_route(i, j));
+                }
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LogLevels) {
+    auto log = std::ostringstream();
+    Logger::set_output(log);
+
+    // default level: topology construction and routing are silent
+    const auto mesh = Mesh2D(4, 4, 50, 500);
+    std::ignore = mesh.compute_route(0, 15);
+    EXPECT_TRUE(log.str().empty());
+
+    // debug level: routes are traced
+    Logger::set_level(LogLevel::Debug);
+    std::ignore = mesh.compute_route(0, 15);
+    EXPECT_NE(log.str().find("[Debug] [MESH2D-ROUTE] NPU 0"), std::string::npos);
+
+    // restore defaults
+    Logger::set_level(LogLevel::Warning);
+    Logger::set_output(std::cerr);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ConcurrentSimulations) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+
+    // run an All-Gather on a topology with its own event queue
+    const auto run_all_gather = [&network_parser](EventTime* const simulation_time) {
+        const auto simulation_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, simulation_event_queue);
+        const auto npus_count = topology->get_npus_count();
+
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology->send(1'048'576, i, j, callback, nullptr);
+                }
+            }
+        }
+
+        while (!simulation_event_queue->finished()) {
+            simulation_event_queue->proceed();
+        }
+        *simulation_time = simulation_event_queue->get_current_time();
+    };
+
+    /// Run two independent simulations concurrently
+    auto simulation_times = std::vector<EventTime>(2, 0);
+    auto first_simulation = std::thread(run_all_gather, &simulation_times[0]);
+    auto second_simulation = std::thread(run_all_gather, &simulation_times[1]);
+    first_simulation.join();
+    second_simulation.join();
+
+    /// test: neither simulation touched the default event queue
+    EXPECT_EQ(simulation_times, std::vector<EventTime>(2, 704'116));
+    EXPECT_TRUE(event_queue->finished());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SweepRingGrid) {
+    /// All-Gather workload
+    const auto all_gather = [](Topology& topology) {
+        const auto npus_count = topology.get_npus_count();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology.send(1'048'576, i, j, callback, nullptr);
+                }
+            }
+        }
+    };
+
+    /// 2 x 2 x 1 grid, with the first point matching Ring.yml
+    auto network_parsers = Sweep::parameter_grid("Ring", {16, 8}, {50.0, 100.0}, {500.0});
+    network_parsers.emplace_back("../../input/Ring.yml");
+    const auto sweep = Sweep(network_parsers);
+    const auto results = sweep.run(all_gather, 3);
+
+    /// test: one row per point, in order
+    ASSERT_EQ(results.size(), 5);
+    for (int i = 0; i < results.size(); i++) {
+        EXPECT_EQ(results[i].point_id, i);
+        EXPECT_EQ(results[i].topology_type, TopologyBuildingBlock::Ring);
+    }
+    EXPECT_EQ(results[0].npus_count, 16);
+    EXPECT_EQ(results[1].bandwidth, 100.0);
+    EXPECT_EQ(results[0].finish_time, 704'116);
+    EXPECT_EQ(results[4].finish_time, 704'116);
+
+    /// test: more bandwidth or fewer NPUs finish earlier
+    EXPECT_LT(results[1].finish_time, results[0].finish_time);
+    EXPECT_LT(results[2].finish_time, results[0].finish_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, MultiDimTopology) {
+    /// setup: Ring(2) x FullyConnected(8) x Switch(4)
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+
+    // 64 NPUs, and one switch per each of the 16 Switch slices
+    EXPECT_EQ(topology->get_npus_count(), 64);
+    EXPECT_EQ(topology->get_devices_count(), 80);
+    EXPECT_EQ(topology->get_dims_count(), 3);
+
+    // dimension-ordered route: 0 -(Ring)- 1 -(FullyConnected)- 15 -(Switch)- 63
+    const auto route = topology->route(0, 63);
+    ASSERT_EQ(route.size(), 5);
+    EXPECT_EQ(route[0], 0);
+    EXPECT_EQ(route[1], 1);
+    EXPECT_EQ(route[2], 15);
+    EXPECT_GE(route[3], 64);
+    EXPECT_EQ(route[4], 63);
+
+    // routes only differing in a dimension stay inside a single slice
+    EXPECT_EQ(topology->route(4, 6).size(), 2);
+    EXPECT_EQ(topology->route(5, 21).size(), 3);
+
+    /// send a chunk
+    topology->send(chunk_size, 0, 63, callback, nullptr);
+
+    /// Run simulation
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    /// test: each hop takes (latency + serialization delay) of its dimension
+    const auto hop_delay = [&](const Bandwidth bandwidth, const Latency latency) {
+        return static_cast<EventTime>(latency + (static_cast<Bandwidth>(chunk_size) / bw_GBps_to_Bpns(bandwidth)));
+    };
+    const auto expected_time = hop_delay(200.0, 50.0) + hop_delay(100.0, 500.0) + 2 * hop_delay(50.0, 2000.0);
+    EXPECT_EQ(event_queue->get_current_time(), expected_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkTable) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    // bidirectional ring: two directed links per NPU
+    EXPECT_EQ(topology->get_links_count(), 2 * npus_count);
+    EXPECT_GE(topology->find_link(0, 1), 0);
+    EXPECT_GE(topology->find_link(1, 0), 0);
+    EXPECT_EQ(topology->find_link(0, 2), -1);
+
+    // test: routes carry the link of each hop, also when copied
+    const auto route = Route(topology->route(1, 4));
+    ASSERT_TRUE(route.links_resolved());
+    for (int hop = 0; hop < route.size() - 1; hop++) {
+        const auto& link = topology->get_link(route.link_id(hop));
+        EXPECT_EQ(link.get_src(), route[hop]);
+        EXPECT_EQ(link.get_dest(), route[hop + 1]);
+    }
+
+    // test: hand-built routes are resolved when sent
+    auto chunk = std::make_unique<Chunk>(chunk_size, Route({1, 2, 3, 4}), callback, nullptr);
+    topology->send(std::move(chunk));
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    EXPECT_EQ(event_queue->get_current_time(), 60'093);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LazyLinks) {
+    /// setup
+    const auto npus_count = 256;
+    const auto topology = std::make_shared<FullyConnected>(npus_count, 50.0, 500.0);
+
+    // links are counted, but not created yet
+    EXPECT_EQ(topology->get_links_count(), npus_count * (npus_count - 1));
+    EXPECT_EQ(topology->get_materialized_links_count(), 0);
+
+    // test: closed-form link ids match the link endpoints
+    for (const auto& [src, dest] : {std::pair{0, 1}, std::pair{5, 3}, std::pair{255, 0}, std::pair{17, 255}}) {
+        const auto& link = topology->get_link(topology->find_link(src, dest));
+        EXPECT_EQ(link.get_src(), src);
+        EXPECT_EQ(link.get_dest(), dest);
+    }
+    EXPECT_EQ(topology->find_link(3, 3), -1);
+
+    // test: a ring of sends only materializes the pages of the links it uses
+    topology->set_link_model(LinkModel::VirtualTime);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        topology->send(chunk_size, npu, (npu + 1) % npus_count, callback, nullptr);
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    const auto hop_delay = topology->get_link(topology->find_link(0, 1)).communication_delay(chunk_size);
+    EXPECT_EQ(event_queue->get_current_time(), hop_delay);
+    EXPECT_LE(topology->get_materialized_links_count(), (npus_count + 4) * LinkTable::page_size);
+    EXPECT_LT(topology->get_materialized_links_count(), topology->get_links_count() / 2);
+    EXPECT_EQ(topology->get_link(topology->find_link(7, 8)).get_link_model(), LinkModel::VirtualTime);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FlowModel) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = network_parser.get_latencies_per_dim()[0];
+    const auto serialization_delay = static_cast<double>(chunk_size) / bw_GBps_to_Bpns(bandwidth);
+
+    // test: a single-hop flow matches the chunk-level simulation
+    auto single_flow_model = FlowModel(topology);
+    single_flow_model.add_flow(0, 1, 2, chunk_size);
+    EXPECT_EQ(single_flow_model.run(), 20'031);
+
+    // test: multi-hop flows are pipelined (one serialization delay, latency of every hop)
+    auto multi_hop_flow_model = FlowModel(topology);
+    multi_hop_flow_model.add_flow(0, 1, 4, chunk_size);
+    EXPECT_EQ(multi_hop_flow_model.run(), static_cast<EventTime>(serialization_delay + 3 * latency));
+
+    // test: flows sharing a link get half the bandwidth each,
+    // and a flow on a disjoint link is unaffected
+    auto shared_flow_model = FlowModel(topology);
+    const auto flow_a = shared_flow_model.add_flow(0, 1, 3, chunk_size);  // links 1->2, 2->3
+    const auto flow_b = shared_flow_model.add_flow(0, 2, 3, chunk_size);  // link 2->3
+    const auto flow_c = shared_flow_model.add_flow(0, 5, 6, chunk_size);  // link 5->6
+    shared_flow_model.run();
+    EXPECT_EQ(shared_flow_model.get_finish_time(flow_a), static_cast<EventTime>(2 * serialization_delay + 2 * latency));
+    EXPECT_EQ(shared_flow_model.get_finish_time(flow_b), static_cast<EventTime>(2 * serialization_delay + latency));
+    EXPECT_EQ(shared_flow_model.get_finish_time(flow_c), 20'031);
+
+    // test: a late flow only shares the bandwidth while both are active
+    auto late_flow_model = FlowModel(topology);
+    const auto early_flow = late_flow_model.add_flow(0, 1, 2, chunk_size);
+    const auto late_start_time = static_cast<EventTime>(serialization_delay / 2);
+    const auto late_flow = late_flow_model.add_flow(late_start_time, 1, 2, chunk_size);
+    late_flow_model.run();
+    EXPECT_EQ(late_flow_model.get_finish_time(early_flow),
+              static_cast<EventTime>(2 * serialization_delay - static_cast<double>(late_start_time) + latency));
+    EXPECT_EQ(late_flow_model.get_finish_time(late_flow), static_cast<EventTime>(2 * serialization_delay + latency));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HybridModel) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto bandwidth = network_parser.get_bandwidths_per_dim()[0];
+    const auto latency = network_parser.get_latencies_per_dim()[0];
+    const auto serialization_delay = static_cast<double>(chunk_size) / bw_GBps_to_Bpns(bandwidth);
+    const auto elephant_size = 64 * chunk_size;
+
+    // record the arrival time of a transfer
+    using Arrival = std::pair<EventQueue*, EventTime>;
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->second = arrival->first->get_current_time();
+    };
+    const auto run = [&] {
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+    };
+
+    // test: a mouse alone is a chunk, as in the chunk-level simulation
+    const auto mouse_topology = construct_topology(network_parser);
+    auto mouse_model = HybridModel(mouse_topology, 16 * chunk_size);
+    auto mouse_alone = Arrival(event_queue.get(), 0);
+    mouse_model.send(chunk_size, 1, 2, record_arrival, &mouse_alone);
+    run();
+    EXPECT_EQ(mouse_alone.second, 20'031);
+    EXPECT_EQ(mouse_model.get_chunks_count(), 1);
+    EXPECT_EQ(mouse_model.get_flows_count(), 0);
+
+    // test: an elephant alone is a flow, as in FlowModel
+    const auto elephant_topology = construct_topology(network_parser);
+    auto elephant_model = HybridModel(elephant_topology, 16 * chunk_size);
+    auto elephant_alone = Arrival(event_queue.get(), 0);
+    const auto elephant_start_time = event_queue->get_current_time();
+    elephant_model.send(elephant_size, 1, 3, record_arrival, &elephant_alone);
+    run();
+    auto flow_model = FlowModel(elephant_topology);
+    flow_model.add_flow(0, 1, 3, elephant_size);
+    EXPECT_NEAR(elephant_alone.second - elephant_start_time, flow_model.run(), 1);
+    EXPECT_EQ(elephant_model.get_flows_count(), 1);
+
+    // test: a mouse sharing a link with an elephant gets half its bandwidth,
+    // and delays the elephant by as much
+    const auto mixed_topology = construct_topology(network_parser);
+    auto mixed_model = HybridModel(mixed_topology, 16 * chunk_size);
+    auto elephant = Arrival(event_queue.get(), 0);
+    auto mouse = Arrival(event_queue.get(), 0);
+    const auto mixed_start_time = event_queue->get_current_time();
+    mixed_model.send(elephant_size, 1, 3, record_arrival, &elephant);  // links 1->2, 2->3
+    mixed_model.send(chunk_size, 1, 2, record_arrival, &mouse);        // link 1->2
+    run();
+    const auto mouse_delay = 2 * serialization_delay + latency;
+    EXPECT_NEAR(mouse.second - mixed_start_time, mouse_delay, 1);
+    EXPECT_NEAR(elephant.second - mixed_start_time, elephant_alone.second - elephant_start_time + mouse_delay / 2, 2);
+
+    // test: links serialize chunks at their whole bandwidth again
+    EXPECT_EQ(mixed_topology->get_link(mixed_topology->find_link(1, 2)).get_bandwidth_share(), 1);
+}
+
+namespace {
+
+/// send npus_count - 1 chunks to the next NPU, one after the other (as a ring all-gather does)
+Task ring_all_gather(Topology& topology, const DeviceId npu, const ChunkSize chunk_size, int& finished_npus_count) {
+    const auto npus_count = topology.get_npus_count();
+    for (auto step = 0; step < npus_count - 1; step++) {
+        co_await send(topology, chunk_size, npu, (npu + 1) % npus_count);
+    }
+    finished_npus_count++;
+}
+
+/// exchange with both neighbors, then run a nested all-gather step
+Task neighbor_exchange(Topology& topology, const DeviceId npu, const ChunkSize chunk_size, int& finished_npus_count) {
+    const auto npus_count = topology.get_npus_count();
+    co_await all_of(send(topology, chunk_size, npu, (npu + 1) % npus_count),
+                    send(topology, chunk_size, npu, (npu + npus_count - 1) % npus_count));
+    co_await all_of(std::vector<SendAwaitable>());
+    co_await ring_all_gather(topology, npu, chunk_size, finished_npus_count);
+}
+
+}  // namespace
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Coroutine) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    // test: a ring all-gather written as coroutines
+    auto finished_npus_count = 0;
+    for (auto npu = 0; npu < npus_count; npu++) {
+        ring_all_gather(*topology, npu, chunk_size, finished_npus_count).start();
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    EXPECT_EQ(finished_npus_count, npus_count);
+    EXPECT_EQ(event_queue->get_current_time(), (npus_count - 1) * 20'031);
+
+    // test: awaiting several chunks, then a nested coroutine
+    const auto start_time = event_queue->get_current_time();
+    finished_npus_count = 0;
+    for (auto npu = 0; npu < npus_count; npu++) {
+        neighbor_exchange(*topology, npu, chunk_size, finished_npus_count).start();
+    }
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    EXPECT_EQ(finished_npus_count, npus_count);
+    EXPECT_EQ(event_queue->get_current_time() - start_time, npus_count * 20'031);
+
+    // test: a task never started frees its frame
+    {
+        auto task = ring_all_gather(*topology, 0, chunk_size, finished_npus_count);
+    }
+    EXPECT_EQ(finished_npus_count, npus_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Collectives) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto npus_count = network_parser.get_npus_counts_per_dim()[0];
+    const auto collective_size = npus_count * chunk_size;
+
+    // simulate a collective on a fresh topology
+    const auto simulate = [&](const CollectiveType collective_type,
+                              const CollectiveAlgorithm collective_algorithm,
+                              const int chunks_count) {
+        auto collective_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, collective_event_queue);
+
+        auto collective = Collective(topology, collective_type, collective_algorithm, collective_size, chunks_count);
+        collective.start();
+        while (!collective_event_queue->finished()) {
+            collective_event_queue->proceed();
+        }
+
+        EXPECT_TRUE(collective.finished());
+        EXPECT_LE(collective.get_peak_in_flight_messages_count(), npus_count * (npus_count - 1) * chunks_count);
+        return std::make_tuple(collective.get_finish_time(), collective.get_steps_count(),
+                               collective.get_peak_in_flight_messages_count());
+    };
+
+    // test: direct All-Gather matches the hand-rolled one (AllGatherOnRing)
+    EXPECT_EQ(std::get<0>(simulate(CollectiveType::AllGather, CollectiveAlgorithm::Direct, 1)), 704'116);
+    EXPECT_EQ(std::get<0>(simulate(CollectiveType::AllToAll, CollectiveAlgorithm::Direct, 1)), 704'116);
+
+    // test: ring steps only use disjoint single-hop links, one message per NPU in flight
+    const auto [ring_all_gather_time, ring_all_gather_steps, ring_all_gather_peak] =
+        simulate(CollectiveType::AllGather, CollectiveAlgorithm::Ring, 1);
+    EXPECT_EQ(ring_all_gather_steps, npus_count - 1);
+    EXPECT_EQ(ring_all_gather_time, (npus_count - 1) * 20'031);
+    EXPECT_EQ(ring_all_gather_peak, npus_count);
+    EXPECT_EQ(std::get<0>(simulate(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 1)),
+              2 * (npus_count - 1) * 20'031);
+
+    // test: halving-doubling takes log2(npus_count) steps per phase
+    EXPECT_EQ(std::get<1>(simulate(CollectiveType::ReduceScatter, CollectiveAlgorithm::HalvingDoubling, 1)), 4);
+    EXPECT_EQ(std::get<1>(simulate(CollectiveType::AllReduce, CollectiveAlgorithm::HalvingDoubling, 2)), 8);
+
+    // test: pipelined chunks
+    EXPECT_LE(std::get<2>(simulate(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 4)), 4 * npus_count);
+    simulate(CollectiveType::AllToAll, CollectiveAlgorithm::Ring, 2);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SimulationStats) {
+    if constexpr (!stats_enabled) {
+        GTEST_SKIP() << "statistics are not compiled in";
+    }
+
+    // two chunks 0 -> 2 contend for the 0 -> 1 link
+    auto topology = std::make_shared<Ring>(8, 50, 500, false);
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    // test: event queue counters
+    const auto& event_queue_stats = event_queue->get_stats();
+    EXPECT_EQ(event_queue_stats.events_scheduled, 8);
+    EXPECT_EQ(event_queue_stats.events_processed, 8);
+    EXPECT_GE(event_queue_stats.max_pending_event_lists, 2);
+
+    // test: the second chunk waits one serialization delay on the first link only
+    const auto serialization_delay = static_cast<EventTime>(chunk_size / bw_GBps_to_Bpns(50));
+    const auto& first_link_stats = topology->get_link(topology->find_link(0, 1)).get_stats();
+    EXPECT_EQ(first_link_stats.chunks_transmitted, 2);
+    EXPECT_EQ(first_link_stats.bytes_transmitted, 2 * chunk_size);
+    EXPECT_EQ(first_link_stats.busy_time, 2 * serialization_delay);
+    EXPECT_EQ(first_link_stats.max_pending_chunks, 1);
+
+    const auto& chunk_stats = topology->get_chunk_stats();
+    EXPECT_EQ(chunk_stats.chunks_delivered, 2);
+    EXPECT_EQ(chunk_stats.hops_count, 4);
+    EXPECT_EQ(chunk_stats.queueing_delay, serialization_delay);
+    EXPECT_EQ(chunk_stats.max_queueing_delay, serialization_delay);
+
+    // test: summary
+    auto summary = std::ostringstream();
+    topology->dump_stats(summary);
+    EXPECT_NE(summary.str().find("chunks delivered: 2"), std::string::npos);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, MemoryFootprint) {
+    // four chunks 0 -> 2 contend for the 0 -> 1 link
+    auto topology = std::make_shared<Ring>(8, 50, 500, false);
+    for (auto i = 0; i < 4; i++) {
+        topology->send(chunk_size, 0, 2, callback, nullptr);
+    }
+
+    // test: every chunk is in flight, three of them queued behind the first one
+    const auto in_flight = topology->get_memory_footprint();
+    EXPECT_GE(in_flight.link_graph.bytes, 8 * sizeof(Link));
+    EXPECT_GT(in_flight.route_tables.bytes, 0);
+    EXPECT_EQ(in_flight.chunks.bytes, 4 * sizeof(Chunk));
+    EXPECT_EQ(in_flight.link_queues.bytes, 4 * sizeof(Chunk));
+    EXPECT_GT(in_flight.event_queue.bytes, 0);
+
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+
+    // test: chunks are back in the pool, peaks are kept
+    const auto finished = topology->get_memory_footprint();
+    EXPECT_EQ(finished.chunks.bytes, 0);
+    EXPECT_EQ(finished.chunks.peak_bytes, 4 * sizeof(Chunk));
+    EXPECT_EQ(finished.link_queues.bytes, 0);
+    EXPECT_EQ(finished.link_queues.peak_bytes, 4 * sizeof(Chunk));
+    EXPECT_GE(finished.event_queue.peak_bytes, in_flight.event_queue.bytes);
+    EXPECT_EQ(finished.link_graph.bytes, in_flight.link_graph.bytes);
+    EXPECT_EQ(finished.total_bytes(), finished.link_graph.bytes + finished.route_tables.bytes +
+                                          finished.event_queue.bytes);
+
+    // test: summary
+    auto summary = std::ostringstream();
+    topology->dump_memory_footprint(summary);
+    EXPECT_NE(summary.str().find("[Memory] link queues: 0 B"), std::string::npos);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TopologyReset) {
+    // all-to-all on a ring, on links keeping a virtual busy-until time
+    auto reset_event_queue = std::make_shared<EventQueue>(EventQueueType::TimingWheel);
+    const auto topology = std::make_shared<Ring>(8, 50, 500);
+    topology->attach_event_queue(reset_event_queue);
+    topology->set_link_model(LinkModel::VirtualTime);
+    const auto simulate = [&]() {
+        for (auto src = 0; src < 8; src++) {
+            for (auto dest = 0; dest < 8; dest++) {
+                if (src != dest) {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+        return reset_event_queue->run_to_completion();
+    };
+
+    const auto finish_time = simulate();
+    const auto events_processed = reset_event_queue->get_stats().events_processed;
+    const auto chunks_delivered = topology->get_chunk_stats().chunks_delivered;
+
+    // test: the second run on the reset topology and event queue matches the first one
+    topology->reset();
+    reset_event_queue->reset();
+    EXPECT_EQ(reset_event_queue->get_current_time(), 0);
+    EXPECT_EQ(simulate(), finish_time);
+    EXPECT_EQ(reset_event_queue->get_stats().events_processed, events_processed);
+    EXPECT_EQ(topology->get_chunk_stats().chunks_delivered, chunks_delivered);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, DimParameterRebinding) {
+    // send a chunk between every pair at once, returning the finish time
+    const auto simulate = [&](Topology& topology) {
+        auto rebinding_event_queue = std::make_shared<EventQueue>();
+        topology.attach_event_queue(rebinding_event_queue);
+        for (auto src = 0; src < topology.get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology.get_npus_count(); dest++) {
+                if (src != dest) {
+                    topology.send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+        return rebinding_event_queue->run_to_completion();
+    };
+    const auto ring_x_fully_connected = [](const Bandwidth bandwidth, const Latency latency) {
+        auto topology_per_dim = std::vector<std::unique_ptr<BasicTopology>>();
+        topology_per_dim.push_back(std::make_unique<Ring>(4, 50, 500));
+        topology_per_dim.push_back(std::make_unique<FullyConnected>(4, bandwidth, latency));
+        return MultiDimTopology(std::move(topology_per_dim));
+    };
+
+    /// setup: Ring(4) x FullyConnected(4), whose second dimension is rebound between runs
+    auto topology = ring_x_fully_connected(50, 500);
+    EXPECT_EQ(topology.get_link_dim(0), 0);
+    EXPECT_EQ(topology.get_link_dim(topology.get_links_count() - 1), 1);
+    simulate(topology);
+
+    /// test: the rebound topology matches a topology constructed with the new parameters
+    topology.reset();
+    topology.set_dim_parameters(1, 200, 100);
+    auto expected_topology = ring_x_fully_connected(200, 100);
+    EXPECT_EQ(simulate(topology), simulate(expected_topology));
+    EXPECT_EQ(topology.get_bandwidth_per_dim()[1], 200);
+    EXPECT_EQ(topology.get_link(0).get_bandwidth(), 50);
+
+    /// test: lazy links are rebound whether materialized already or not
+    auto fully_connected = FullyConnected(8, 50, 500);
+    fully_connected.send(chunk_size, 0, 1, callback, nullptr);
+    fully_connected.get_event_queue()->run_to_completion();
+    fully_connected.reset();
+    fully_connected.set_dim_parameters(0, 100, 200);
+    auto expected_fully_connected = FullyConnected(8, 100, 200);
+    EXPECT_EQ(simulate(fully_connected), simulate(expected_fully_connected));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SnapshotTopology) {
+    // send a chunk between every pair at once, returning the finish time
+    const auto simulate = [&](const std::shared_ptr<Topology>& topology) {
+        auto snapshot_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(snapshot_event_queue);
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest++) {
+                if (src != dest) {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+        while (!snapshot_event_queue->finished()) {
+            snapshot_event_queue->proceed();
+        }
+        return snapshot_event_queue->get_current_time();
+    };
+
+    const auto snapshot_path = std::string("topology_snapshot.bin");
+    const auto topologies = std::vector<std::shared_ptr<Topology>>({
+        std::make_shared<SparseMesh2D>(4, 3, std::set<std::pair<int, int>>({{1, 1}}), 50, 500),
+        std::make_shared<FatTree>(8, 4, 2, 50, 500),
+    });
+    for (const auto& topology : topologies) {
+        ASSERT_TRUE(SnapshotTopology::save(*topology, snapshot_path));
+        const auto snapshot = std::make_shared<SnapshotTopology>(snapshot_path);
+
+        // test: same devices, links and routes
+        EXPECT_EQ(snapshot->get_devices_count(), topology->get_devices_count());
+        EXPECT_EQ(snapshot->get_npus_count(), topology->get_npus_count());
+        EXPECT_EQ(snapshot->get_links_count(), topology->get_links_count());
+        for (auto link_id = 0; link_id < topology->get_links_count(); link_id++) {
+            EXPECT_EQ(snapshot->get_link(link_id).get_src(), topology->get_link(link_id).get_src());
+            EXPECT_EQ(snapshot->get_link(link_id).get_dest(), topology->get_link(link_id).get_dest());
+        }
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest++) {
+                if (src != dest) {
+                    EXPECT_EQ(snapshot->route(src, dest), topology->route(src, dest));
+                }
+            }
+        }
+
+        // test: same timings
+        EXPECT_EQ(simulate(snapshot), simulate(topology));
+    }
+    std::remove(snapshot_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, VirtualTimeLinkModel) {
+    // run an all-gather with the given link model,
+    // returning its finish time and the number of processed events
+    const auto simulate = [&](const std::shared_ptr<Topology>& topology, const LinkModel link_model) {
+        auto collective_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(collective_event_queue);
+        topology->set_link_model(link_model);
+
+        const auto collective_size = topology->get_npus_count() * 4 * chunk_size;
+        auto all_gather = Collective(topology, CollectiveType::AllGather, CollectiveAlgorithm::Direct, collective_size, 4);
+        all_gather.start();
+        while (!collective_event_queue->finished()) {
+            collective_event_queue->proceed();
+        }
+
+        EXPECT_TRUE(all_gather.finished());
+        return std::make_pair(all_gather.get_finish_time(), collective_event_queue->get_stats().events_processed);
+    };
+
+    const auto topologies = std::vector<std::shared_ptr<Topology>>({
+        std::make_shared<Ring>(8, 50, 500),
+        std::make_shared<Switch>(8, 50, 500),
+        std::make_shared<Mesh2D>(4, 4, 50, 500),
+    });
+    for (const auto& topology : topologies) {
+        const auto [event_finish_time, event_events_count] = simulate(topology, LinkModel::Event);
+        const auto [virtual_time_finish_time, virtual_time_events_count] = simulate(topology, LinkModel::VirtualTime);
+
+        // test: identical timings, without link-free events
+        EXPECT_EQ(virtual_time_finish_time, event_finish_time);
+        if constexpr (stats_enabled) {
+            EXPECT_LT(virtual_time_events_count, event_events_count);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FastForward) {
+    // send a chunk from every NPU to every other one at once, returning the delivery time of every chunk
+    // (the chunks differ in size, so no two of them reach a link at the same time, which fast forwarding may reorder)
+    struct Delivery {
+        EventQueue* event_queue;
+        EventTime time;
+    };
+    const auto record_delivery = [](void* const arg) {
+        auto* const delivery = static_cast<Delivery*>(arg);
+        delivery->time = delivery->event_queue->get_current_time();
+    };
+    const auto simulate_all_to_all = [&](const std::shared_ptr<Topology>& topology, const bool fast_forward) {
+        auto all_to_all_event_queue = std::make_shared<EventQueue>();
+        topology->reset();
+        topology->attach_event_queue(all_to_all_event_queue);
+        topology->set_fast_forward(fast_forward);
+
+        const auto npus_count = topology->get_npus_count();
+        auto deliveries = std::vector<Delivery>(npus_count * npus_count, Delivery{all_to_all_event_queue.get(), 0});
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    const auto size = chunk_size * (1 + (src + dest) % 3) + 4099 * src + 577 * dest;
+                    topology->send(size, src, dest, record_delivery, &deliveries[src * npus_count + dest]);
+                }
+            }
+        }
+        all_to_all_event_queue->run_to_completion();
+
+        auto delivery_times = std::vector<EventTime>();
+        for (const auto& delivery : deliveries) {
+            delivery_times.push_back(delivery.time);
+        }
+        return delivery_times;
+    };
+
+    // test: chunks are fast forwarded over NPUs and switches alike, revoking the claims other chunks reach first,
+    // and every chunk is delivered when it's delivered hop by hop
+    const auto topologies = std::vector<std::shared_ptr<Topology>>({
+        std::make_shared<Ring>(8, 50, 500),
+        std::make_shared<Mesh2D>(4, 4, 50, 500),
+        std::make_shared<Switch>(8, 50, 500),
+    });
+    for (const auto& topology : topologies) {
+        const auto per_hop_delivery_times = simulate_all_to_all(topology, false);
+        const auto chunks_transmitted = topology->get_link(0).get_stats().chunks_transmitted;
+        EXPECT_EQ(simulate_all_to_all(topology, true), per_hop_delivery_times);
+        EXPECT_EQ(topology->get_link(0).get_stats().chunks_transmitted, chunks_transmitted);
+        if constexpr (stats_enabled) {
+            EXPECT_GT(topology->get_chunk_stats().chunks_fast_forwarded, 0);
+        }
+    }
+
+    // test: collectives finish when they do hop by hop
+    const auto run_all_reduce = [&](const std::shared_ptr<Topology>& topology, const bool fast_forward) {
+        auto collective_event_queue = std::make_shared<EventQueue>();
+        topology->reset();
+        topology->attach_event_queue(collective_event_queue);
+        topology->set_fast_forward(fast_forward);
+        const auto collective_size = topology->get_npus_count() * 4 * chunk_size;
+        auto all_reduce =
+            Collective(topology, CollectiveType::AllReduce, CollectiveAlgorithm::Direct, collective_size, 4);
+        all_reduce.start();
+        collective_event_queue->run_to_completion();
+        EXPECT_TRUE(all_reduce.finished());
+        return all_reduce.get_finish_time();
+    };
+    for (const auto& topology : topologies) {
+        EXPECT_EQ(run_all_reduce(topology, true), run_all_reduce(topology, false));
+    }
+
+    // test: an uncontended chunk crosses its 4 hops in a single event, over NPUs
+    auto uncontended_event_queue = std::make_shared<EventQueue>();
+    auto ring = std::make_shared<Ring>(8, 50, 500, false);
+    ring->attach_event_queue(uncontended_event_queue);
+    ring->set_fast_forward(true);
+    auto delivery = Delivery{uncontended_event_queue.get(), 0};
+    ring->send(chunk_size, 0, 4, record_delivery, &delivery);
+    uncontended_event_queue->run_to_completion();
+    EXPECT_EQ(delivery.time, 4 * ring->get_link(0).communication_delay(chunk_size));
+    if constexpr (stats_enabled) {
+        EXPECT_EQ(uncontended_event_queue->get_stats().events_processed, 1);
+        EXPECT_EQ(ring->get_chunk_stats().chunks_fast_forwarded, 1);
+    }
+
+    // send a chunk 0 -> 4 over a unidirectional ring, crossed by chunks 2 -> 3 sent right after it,
+    // returning the delivery time of every chunk
+    const auto simulate_crossing = [&](const bool fast_forward) {
+        auto ring_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(8, 50, 500, false);
+        topology->attach_event_queue(ring_event_queue);
+        topology->set_fast_forward(fast_forward);
+        auto deliveries = std::vector<Delivery>(3, Delivery{ring_event_queue.get(), 0});
+        topology->send(chunk_size, 0, 4, record_delivery, &deliveries[0]);
+        topology->send(chunk_size, 2, 3, record_delivery, &deliveries[1]);
+        topology->send(chunk_size, 2, 3, record_delivery, &deliveries[2]);
+        ring_event_queue->run_to_completion();
+        return std::vector<EventTime>{deliveries[0].time, deliveries[1].time, deliveries[2].time};
+    };
+
+    // test: the crossing chunks reach link 2 -> 3 first and are served first,
+    // the chunk from NPU 0 claiming it from the time it reaches it
+    const auto crossing_delivery_times = simulate_crossing(true);
+    EXPECT_EQ(crossing_delivery_times, simulate_crossing(false));
+    EXPECT_LT(crossing_delivery_times[2], crossing_delivery_times[0]);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, PacketizedTransmission) {
+    // send chunks 0 -> 4 at once over a unidirectional ring, returning the finish time
+    const auto simulate = [&](const int chunks_count, const ChunkSize packet_size, const LinkModel link_model,
+                              const bool fast_forward) {
+        auto ring_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(8, 50, 500, false);
+        topology->attach_event_queue(ring_event_queue);
+        topology->set_link_model(link_model);
+        topology->set_fast_forward(fast_forward);
+        topology->set_packet_size(packet_size);
+
+        for (auto i = 0; i < chunks_count; i++) {
+            topology->send(chunk_size, 0, 4, callback, nullptr);
+        }
+        while (!ring_event_queue->finished()) {
+            ring_event_queue->proceed();
+        }
+
+        return ring_event_queue->get_current_time();
+    };
+
+    // a packet train pays the serialization of all but its last packet once,
+    // and a packet's communication delay at every hop
+    const auto packet_size = ChunkSize(4096);
+    const auto link = Link(0, 1, 50, 500);
+    const auto train_serialization = static_cast<EventTime>((chunk_size - packet_size) / bw_GBps_to_Bpns(50));
+    const auto expected_finish_time = 4 * link.communication_delay(packet_size) + train_serialization;
+
+    // test: uncontended chunk pipelines over its 4 hops
+    const auto store_and_forward_finish_time = simulate(1, 0, LinkModel::Event, false);
+    EXPECT_EQ(store_and_forward_finish_time, 4 * link.communication_delay(chunk_size));
+    EXPECT_EQ(simulate(1, packet_size, LinkModel::Event, false), expected_finish_time);
+    EXPECT_LT(expected_finish_time, store_and_forward_finish_time);
+
+    // test: packets as large as the chunk are store-and-forward
+    EXPECT_EQ(simulate(1, chunk_size, LinkModel::Event, false), store_and_forward_finish_time);
+
+    // test: every link model (and fast forwarding) agrees, also under contention
+    for (const auto chunks_count : {1, 2, 4}) {
+        const auto event_finish_time = simulate(chunks_count, packet_size, LinkModel::Event, false);
+        EXPECT_EQ(simulate(chunks_count, packet_size, LinkModel::VirtualTime, false), event_finish_time);
+        EXPECT_EQ(simulate(chunks_count, packet_size, LinkModel::VirtualTime, true), event_finish_time);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CutThroughTransmission) {
+    // send chunks 0 -> dest at once over a 4x4 mesh, returning the finish time
+    const auto simulate = [&](const int chunks_count, const DeviceId dest, const SwitchingMode switching_mode,
+                              const LinkModel link_model, const bool fast_forward) {
+        auto mesh_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Mesh2D>(4, 4, 50, 500);
+        topology->attach_event_queue(mesh_event_queue);
+        topology->set_link_model(link_model);
+        topology->set_fast_forward(fast_forward);
+        topology->set_switching_mode(switching_mode);
+
+        for (auto i = 0; i < chunks_count; i++) {
+            topology->send(chunk_size, 0, dest, callback, nullptr);
+        }
+        while (!mesh_event_queue->finished()) {
+            mesh_event_queue->proceed();
+        }
+
+        return mesh_event_queue->get_current_time();
+    };
+
+    // test: a single hop is identical to store-and-forward
+    EXPECT_EQ(simulate(1, 1, SwitchingMode::CutThrough, LinkModel::Event, false),
+              simulate(1, 1, SwitchingMode::StoreAndForward, LinkModel::Event, false));
+
+    // test: the chunk pays its serialization once, and the latency at every hop
+    // (up to a ns of rounding per hop)
+    const auto hops_count = Mesh2D(4, 4, 50, 500).route(0, 15).size() - 1;
+    const auto serialization_time = static_cast<EventTime>(chunk_size / bw_GBps_to_Bpns(50));
+    const auto expected_finish_time = hops_count * 500 + serialization_time;
+    const auto cut_through_finish_time = simulate(1, 15, SwitchingMode::CutThrough, LinkModel::Event, false);
+    EXPECT_NEAR(cut_through_finish_time, expected_finish_time, hops_count);
+    EXPECT_LT(cut_through_finish_time, simulate(1, 15, SwitchingMode::StoreAndForward, LinkModel::Event, false));
+
+    // test: every link model (and fast forwarding) agrees, also under contention
+    for (const auto chunks_count : {1, 2, 4}) {
+        const auto event_finish_time = simulate(chunks_count, 15, SwitchingMode::CutThrough, LinkModel::Event, false);
+        EXPECT_EQ(simulate(chunks_count, 15, SwitchingMode::CutThrough, LinkModel::VirtualTime, false),
+                  event_finish_time);
+        EXPECT_EQ(simulate(chunks_count, 15, SwitchingMode::CutThrough, LinkModel::VirtualTime, true),
+                  event_finish_time);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TraceReplay) {
+    // two independent messages, one waiting for the first, a local one waiting for the third, and a late one
+    const auto trace_path = std::string("trace_replay_test.bin");
+    TraceReplay::write_trace(trace_path, {
+                                             {0, chunk_size, TraceRecord::no_dependency, 0, 1},
+                                             {0, chunk_size, TraceRecord::no_dependency, 2, 3},
+                                             {10, chunk_size, 0, 1, 2},
+                                             {10, chunk_size, 2, 2, 2},
+                                             {1'000'000, chunk_size, TraceRecord::no_dependency, 4, 5},
+                                         });
+
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(8, 50, 500);
+    topology->attach_event_queue(ring_event_queue);
+
+    auto trace_replay = TraceReplay(topology, trace_path);
+    EXPECT_EQ(trace_replay.get_records_count(), 5);
+    trace_replay.start();
+
+    // test: the dependent message is injected once its dependency is delivered
+    const auto hop_delay = topology->get_link(topology->find_link(0, 1)).communication_delay(chunk_size);
+    ring_event_queue->run_until(2 * hop_delay);
+    EXPECT_EQ(trace_replay.get_delivered_count(), 4);
+    EXPECT_EQ(trace_replay.get_peak_in_flight_messages_count(), 2);
+
+    // test: the late message is injected at its inject time
+    ring_event_queue->run_to_completion();
+    EXPECT_TRUE(trace_replay.finished());
+    EXPECT_EQ(trace_replay.get_finish_time(), 1'000'000 + hop_delay);
+
+    std::remove(trace_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CompletionLog) {
+    // one-hop and two-hop chunks, flushed in blocks of two records
+    const auto log_path = std::string("completion_log_test.bin");
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(8, 50, 500);
+    topology->attach_event_queue(ring_event_queue);
+    auto completion_log = std::make_shared<CompletionLog>(log_path, 2);
+    topology->set_completion_log(completion_log);
+
+    topology->send(chunk_size, 0, 1, callback, nullptr);
+    topology->send(chunk_size, 2, 4, callback, nullptr);
+    ring_event_queue->run_until(1'000);
+    topology->send(chunk_size, 4, 5, callback, nullptr);
+    ring_event_queue->run_to_completion();
+    completion_log->close();
+    EXPECT_EQ(completion_log->get_records_count(), 3);
+
+    // test: every delivered chunk is recorded, in arrival order
+    const auto hop_delay = topology->get_link(topology->find_link(0, 1)).communication_delay(chunk_size);
+    const auto columns = CompletionLog::read_log(log_path);
+    ASSERT_EQ(columns.size(), 3);
+    EXPECT_EQ(columns.chunk_ids, (std::vector<uint64_t>{0, 2, 1}));
+    EXPECT_EQ(columns.srcs, (std::vector<int32_t>{0, 4, 2}));
+    EXPECT_EQ(columns.dests, (std::vector<int32_t>{1, 5, 4}));
+    EXPECT_EQ(columns.hops, (std::vector<int32_t>{1, 1, 2}));
+    EXPECT_EQ(columns.inject_times, (std::vector<EventTime>{0, 1'000, 0}));
+    EXPECT_EQ(columns.arrival_times, (std::vector<EventTime>{hop_delay, 1'000 + hop_delay, 2 * hop_delay}));
+
+    std::remove(log_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkTrace) {
+    // a two-hop chunk and a one-hop chunk sharing the link 1 -> 2, streamed through a tiny buffer
+    const auto trace_path = std::string("link_trace_test.json");
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(4, 50, 500, false);
+    topology->attach_event_queue(ring_event_queue);
+    auto link_trace = std::make_shared<LinkTrace>(trace_path, 64);
+    topology->set_link_trace(link_trace);
+
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    topology->send(chunk_size, 1, 2, callback, nullptr);
+    ring_event_queue->run_to_completion();
+    link_trace->close();
+    EXPECT_EQ(link_trace->get_transmissions_count(), 3);
+
+    auto trace_file = std::ifstream(trace_path);
+    auto trace_stream = std::stringstream();
+    trace_stream << trace_file.rdbuf();
+    const auto trace = trace_stream.str();
+    const auto count = [&trace](const std::string& pattern) {
+        auto occurrences = 0;
+        for (auto pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1)) {
+            occurrences++;
+        }
+        return occurrences;
+    };
+
+    // test: a named track per link, a busy interval and a hop span per transmission
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+    EXPECT_EQ(trace.substr(trace.size() - 3), "]}\n");
+    EXPECT_EQ(count("\"thread_name\""), 4);
+    EXPECT_EQ(count("\"ph\":\"X\""), 3);
+    EXPECT_EQ(count("\"ph\":\"b\""), 3);
+    EXPECT_EQ(count("\"ph\":\"e\""), 3);
+
+    // test: the one-hop chunk occupies the link 1 -> 2 first, then the two-hop chunk once it reached device 1
+    const auto& link = topology->get_link(topology->find_link(1, 2));
+    const auto serialization_time = link.communication_delay(chunk_size) - 500;
+    const auto timestamp = [](const EventTime time) {
+        auto stream = std::ostringstream();
+        stream << time / 1'000 << "." << std::setw(3) << std::setfill('0') << time % 1'000;
+        return stream.str();
+    };
+    EXPECT_NE(trace.find("\"pid\":1,\"tid\":2,\"ts\":0.000,\"dur\":" + timestamp(serialization_time)),
+              std::string::npos);
+    EXPECT_NE(trace.find("\"pid\":1,\"tid\":2,\"ts\":" + timestamp(link.communication_delay(chunk_size)) +
+                         ",\"dur\":" + timestamp(serialization_time)),
+              std::string::npos);
+
+    std::remove(trace_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CriticalPath) {
+    // a two-hop chunk reaching the link 1 -> 2 while three one-hop chunks are still queued on it
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(4, 50, 500, false);
+    topology->attach_event_queue(ring_event_queue);
+    auto critical_path = std::make_shared<CriticalPath>();
+    topology->set_critical_path(critical_path);
+
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    for (auto i = 0; i < 3; i++) {
+        topology->send(chunk_size, 1, 2, callback, nullptr);
+    }
+    const auto finish_time = ring_event_queue->run_to_completion();
+    EXPECT_EQ(critical_path->get_transmissions_count(), 5);
+
+    // test: the path runs through the queued chunks, not the first hop of the two-hop chunk
+    const auto path = critical_path->extract();
+    ASSERT_EQ(path.size(), 4);
+    for (auto i = 0; i < 4; i++) {
+        EXPECT_EQ(path[i].link_src, 1);
+        EXPECT_EQ(path[i].link_dest, 2);
+        EXPECT_EQ(path[i].waited_for_link, i > 0);
+    }
+    EXPECT_EQ(path.front().start_time, 0);
+    EXPECT_EQ(path.back().chunk_id, 0);
+    EXPECT_GT(path.back().start_time, path.back().ready_time);
+    EXPECT_EQ(path.back().arrival_time, finish_time);
+
+    // test: the report ends with the time spent on each link of the path
+    auto report = std::stringstream();
+    critical_path->dump(report);
+    EXPECT_EQ(report.str().rfind("[CriticalPath] finish time: " + std::to_string(finish_time) + " ns, 4 steps", 0), 0);
+    EXPECT_NE(report.str().find("[CriticalPath] link 1 -> 2: serialization"), std::string::npos);
+
+    // test: reset forgets the recorded transmissions
+    topology->reset();
+    EXPECT_EQ(critical_path->get_transmissions_count(), 0);
+    EXPECT_TRUE(critical_path->extract().empty());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, UtilizationSampler) {
+    // three chunks queue up on the link 0 -> 1 of a 2x2 mesh, sampled once per serialization
+    auto mesh_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Mesh2D>(2, 2, 50, 500);
+    topology->attach_event_queue(mesh_event_queue);
+    const auto link_id = topology->find_link(0, 1);
+    const auto serialization_time = topology->get_link(link_id).communication_delay(chunk_size) - 500;
+    auto utilization_sampler = std::make_shared<UtilizationSampler>(serialization_time);
+    topology->set_utilization_sampler(utilization_sampler);
+    EXPECT_EQ(utilization_sampler->get_rows_count(), topology->get_links_count());
+
+    for (auto i = 0; i < 3; i++) {
+        topology->send(chunk_size, 0, 1, callback, nullptr);
+    }
+    mesh_event_queue->run_to_completion();
+
+    // test: the link transmits a chunk per bucket, while the queue drains
+    EXPECT_EQ(utilization_sampler->get_buckets_count(), 3);
+    for (auto bucket = size_t(0); bucket < 3; bucket++) {
+        EXPECT_NEAR(utilization_sampler->get_bytes(link_id, bucket), chunk_size, 1);
+        EXPECT_NEAR(utilization_sampler->get_utilization(link_id, bucket), 1, 1e-3);
+        EXPECT_EQ(utilization_sampler->get_max_pending_chunks(link_id, bucket), 2 - static_cast<int>(bucket));
+    }
+    EXPECT_EQ(utilization_sampler->get_bytes(topology->find_link(1, 0), 0), 0);
+
+    // test: only device 0 is hot on the heatmap
+    const auto heatmap_path = std::string("utilization_heatmap_test.csv");
+    auto device_coords = std::vector<std::pair<int, int>>();
+    for (auto npu = 0; npu < 4; npu++) {
+        device_coords.emplace_back(npu % 2, npu / 2);
+    }
+    utilization_sampler->write_heatmap(heatmap_path, 2, 2, device_coords);
+    auto heatmap_file = std::ifstream(heatmap_path);
+    auto first_row = std::string();
+    auto second_row = std::string();
+    std::getline(heatmap_file, first_row);
+    std::getline(heatmap_file, second_row);
+    EXPECT_NEAR(std::stod(first_row), 1, 1e-3);
+    EXPECT_EQ(first_row.substr(first_row.find(',')), ",0");
+    EXPECT_EQ(second_row, "0,0");
+
+    std::remove(heatmap_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SparseMesh2DValidCells) {
+    // 4x3 grid with two holes, given as excluded coordinates and as a bitmap of valid cells
+    const auto excluded_coords = std::set<std::pair<int, int>>({{0, 1}, {2, 2}});
+    auto valid_cells = std::vector<bool>(12, true);
+    valid_cells[1 * 4 + 0] = false;
+    valid_cells[2 * 4 + 2] = false;
+
+    const auto excluded_mesh = SparseMesh2D(4, 3, excluded_coords, 50, 500);
+    const auto bitmap_mesh = SparseMesh2D(4, 3, valid_cells, 50, 500);
+
+    // test: both describe the same mesh
+    EXPECT_EQ(bitmap_mesh.get_npus_count(), 10);
+    EXPECT_EQ(bitmap_mesh.get_links_count(), excluded_mesh.get_links_count());
+    EXPECT_FALSE(bitmap_mesh.is_valid_position(0, 1));
+    EXPECT_EQ(bitmap_mesh.get_npu_at(1, 1), 4);
+    for (auto npu = 0; npu < 10; npu++) {
+        EXPECT_EQ(bitmap_mesh.get_coords(npu), excluded_mesh.get_coords(npu));
+        EXPECT_EQ(bitmap_mesh.compute_route(0, npu).size(), excluded_mesh.compute_route(0, npu).size());
+    }
+
+    // test: a partial custom placement keeps its NPU IDs, numbering the remaining cells around them
+    const auto placed_mesh = SparseMesh2D(4, 3, valid_cells, {{{3, 2}, 0}}, 50, 500);
+    EXPECT_EQ(placed_mesh.get_npu_at(3, 2), 0);
+    EXPECT_EQ(placed_mesh.get_npu_at(0, 0), 1);
+    EXPECT_EQ(placed_mesh.get_npu_at(1, 2), 9);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SparseMesh2DCompactConfig) {
+    // 6x4 grid: a 2x3 rectangle excluded in the config, and a corner in a bitmap file
+    const auto bitmap_path = std::string("compact_excluded.txt");
+    {
+        auto bitmap_file = std::ofstream(bitmap_path);
+        bitmap_file << "......\n......\n......\n.....x\n";
+    }
+    const auto network_config = YAML::Load("topology: [ Mesh2D ]\nnpus_count: [ 17 ]\nwidth: 6\nheight: 4\n"
+                                           "bandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\nexcluded: [ [0, 1, 1, 3] ]\n"
+                                           "excluded_bitmap: " +
+                                           bitmap_path + "\nnpu_placement: Snake\n");
+    const auto network_parser = NetworkParser(network_config);
+    const auto topology = std::dynamic_pointer_cast<SparseMesh2D>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+
+    // test: both exclusions apply, and rows alternate direction
+    EXPECT_EQ(topology->get_npus_count(), 17);
+    EXPECT_EQ(network_parser.get_excluded_coords().size(), 7);
+    EXPECT_EQ(topology->get_npu_at(5, 1), 6);
+    EXPECT_EQ(topology->get_npu_at(2, 2), 10);
+    EXPECT_EQ(topology->get_npu_at(2, 3), 16);
+
+    std::remove(bitmap_path.c_str());
+
+    // test: consecutive NPUs are adjacent along a Hilbert curve (on a full grid)
+    const auto hilbert_parser = NetworkParser(YAML::Load("topology: [ Mesh2D ]\nnpus_count: [ 16 ]\nwidth: 4\n"
+                                                         "height: 4\nbandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\n"
+                                                         "npu_placement: Hilbert\n"));
+    const auto hilbert_mesh = SparseMesh2D(4, 4, hilbert_parser.get_valid_cells(),
+                                           hilbert_parser.get_npu_placement_grid(), 50, 500);
+    EXPECT_EQ(hilbert_mesh.get_npu_at(0, 0), 0);
+    for (auto npu = 0; npu + 1 < 16; npu++) {
+        const auto [x, y] = hilbert_mesh.get_coords(npu);
+        const auto [next_x, next_y] = hilbert_mesh.get_coords(npu + 1);
+        EXPECT_EQ(std::abs(x - next_x) + std::abs(y - next_y), 1);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SparseMesh2DRouting) {
+    const auto route_devices = [](const Route& route) {
+        auto devices = std::vector<DeviceId>();
+        for (auto i = 0; i < route.size(); i++) {
+            devices.push_back(route[i]);
+        }
+        return devices;
+    };
+
+    // test: a hole-free mesh routes XY
+    const auto full_mesh = SparseMesh2D(4, 4, std::vector<bool>(16, true), 50, 500);
+    EXPECT_EQ(route_devices(full_mesh.compute_route(0, 15)), (std::vector<DeviceId>{0, 1, 2, 3, 7, 11, 15}));
+    EXPECT_EQ(route_devices(full_mesh.compute_route(13, 6)), (std::vector<DeviceId>{13, 14, 10, 6}));
+
+    // test: routes detour around holes (4x3 grid, (1, 1) and (2, 1) excluded)
+    auto valid_cells = std::vector<bool>(12, true);
+    valid_cells[1 * 4 + 1] = false;
+    valid_cells[1 * 4 + 2] = false;
+    const auto holed_mesh = SparseMesh2D(4, 3, valid_cells, 50, 500);
+    EXPECT_EQ(route_devices(holed_mesh.compute_route(1, 8)), (std::vector<DeviceId>{1, 2, 3, 5, 9, 8}));
+
+    // test: tables built up front in parallel give the same routes
+    const auto parallel_mesh = SparseMesh2D(4, 3, valid_cells, 50, 500);
+    parallel_mesh.build_next_hop_tables(3);
+    for (auto src = 0; src < 10; src++) {
+        for (auto dest = 0; dest < 10; dest++) {
+            EXPECT_EQ(route_devices(parallel_mesh.compute_route(src, dest)),
+                      route_devices(holed_mesh.compute_route(src, dest)));
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SparseMesh2DMultipathRouting) {
+    // 3x3 grid without its center: NPU 0 reaches NPU 7 through 1 -> 2 -> 4 or 3 -> 5 -> 6
+    auto valid_cells = std::vector<bool>(9, true);
+    valid_cells[1 * 3 + 1] = false;
+
+    // test: chunks are spread over both shortest paths, by chunk id
+    const auto mesh = std::make_shared<SparseMesh2D>(3, 3, valid_cells, 50, 500);
+    mesh->set_multipath_routes_count(4);
+    auto next_devices = std::set<DeviceId>();
+    for (auto chunk_id = uint64_t(0); chunk_id < 64; chunk_id++) {
+        const auto route = mesh->select_route(0, 7, chunk_id);
+        EXPECT_EQ(route, mesh->select_route(0, 7, chunk_id));
+        EXPECT_EQ(route->size(), 5);
+        next_devices.insert((*route)[1]);
+    }
+    EXPECT_EQ(next_devices, (std::set<DeviceId>{1, 3}));
+
+    // test: a burst between opposite corners finishes earlier once spread
+    auto finish_times = std::vector<EventTime>();
+    for (const auto routes_count : {1, 4}) {
+        auto topology_event_queue = std::make_shared<EventQueue>();
+        mesh->attach_event_queue(topology_event_queue);
+        mesh->set_multipath_routes_count(routes_count);
+        for (auto i = 0; i < 16; i++) {
+            mesh->send(chunk_size, 0, 7, callback, nullptr);
+        }
+        finish_times.push_back(topology_event_queue->run_to_completion());
+    }
+    EXPECT_LT(finish_times[1], finish_times[0]);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HopByHopRouting) {
+    const auto topologies = std::vector<std::shared_ptr<Topology>>{
+        std::make_shared<Ring>(8, 50, 500),
+        std::make_shared<Mesh2D>(4, 4, 50, 500),
+        std::make_shared<Switch>(8, 50, 500),
+        std::make_shared<SparseMesh2D>(4, 3, std::set<std::pair<int, int>>({{1, 1}}), 50, 500),
+    };
+
+    for (const auto& topology : topologies) {
+        const auto npus_count = topology->get_npus_count();
+
+        // test: next hops follow the routes
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+                const auto route = topology->route(src, dest);
+                auto current = src;
+                for (auto hop = 1; hop < route.size(); hop++) {
+                    current = topology->next_hop(current, dest);
+                    EXPECT_EQ(current, route[hop]);
+                }
+            }
+        }
+
+        // test: every NPU sending to every other NPU finishes at the same time either way
+        auto finish_times = std::vector<EventTime>();
+        auto delivered_hops = std::vector<uint64_t>();
+        for (const auto hop_by_hop : {false, true}) {
+            auto topology_event_queue = std::make_shared<EventQueue>();
+            topology->attach_event_queue(topology_event_queue);
+            topology->set_hop_by_hop_routing(hop_by_hop);
+            const auto hops_before = topology->get_chunk_stats().hops_count;
+            for (auto src = 0; src < npus_count; src++) {
+                for (auto dest = 0; dest < npus_count; dest++) {
+                    if (src != dest) {
+                        topology->send(chunk_size, src, dest, callback, nullptr);
+                    }
+                }
+            }
+            finish_times.push_back(topology_event_queue->run_to_completion());
+            delivered_hops.push_back(topology->get_chunk_stats().hops_count - hops_before);
+        }
+        EXPECT_EQ(finish_times[0], finish_times[1]);
+        EXPECT_EQ(delivered_hops[0], delivered_hops[1]);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Torus) {
+    // test: every dimension wraps around (4x4x4 torus)
+    const auto network_parser = NetworkParser("../../input/Torus3D.yml");
+    const auto topology = std::dynamic_pointer_cast<Torus>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+    EXPECT_EQ(topology->get_basic_topology_type(), TopologyBuildingBlock::Torus3D);
+    EXPECT_EQ(topology->get_npus_count_per_dim(), (std::vector<int>{4, 4, 4}));
+    EXPECT_EQ(topology->get_links_count(), 64 * 3 * 2);
+
+    // test: routes are minimal, matching the closed-form hops count
+    for (auto src = 0; src < 64; src++) {
+        for (auto dest = 0; dest < 64; dest++) {
+            EXPECT_EQ(topology->route(src, dest).size() - 1, topology->get_hops_count(src, dest));
+        }
+    }
+
+    // test: dimension-order routing, the shorter way around (4x3 torus)
+    const auto torus = Torus(4, 3, 50, 500);
+    const auto route = torus.compute_route(0, 11);
+    EXPECT_EQ(route.size(), 3);
+    EXPECT_EQ(route[1], 3);
+    EXPECT_EQ(route[2], 11);
+    EXPECT_EQ(torus.compute_route(0, 2).size(), 3);
+
+    // run communication: 3 hops
+    topology->send(chunk_size, 0, 63, callback, nullptr);
+    EXPECT_EQ(event_queue->run_to_completion(), 60'093);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FatTree) {
+    // 3 tiers of radix-8 switches: 32 leaves of 4 NPUs, 8 pods of 4 leaves, 32 aggregation switches, 16 cores
+    const auto network_parser = NetworkParser("../../input/FatTree.yml");
+    const auto topology = std::dynamic_pointer_cast<FatTree>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+    EXPECT_EQ(topology->get_tiers(), 3);
+    EXPECT_EQ(topology->get_devices_count(), 128 + 32 + 32 + 16);
+
+    // test: chunks climb only as high as needed
+    EXPECT_EQ(topology->route(0, 1).size(), 3);
+    EXPECT_EQ(topology->route(0, 4).size(), 5);
+    EXPECT_EQ(topology->route(0, 127).size(), 7);
+
+    // test: ECMP spreads the destinations of an NPU over the aggregation switches and cores
+    auto aggregations = std::set<DeviceId>();
+    auto cores = std::set<DeviceId>();
+    for (auto dest = 16; dest < 128; dest++) {
+        const auto route = topology->route(0, dest);
+        EXPECT_EQ(route[1], topology->get_leaf(0));
+        EXPECT_EQ(route[5], topology->get_leaf(dest));
+        aggregations.insert(route[2]);
+        cores.insert(route[3]);
+    }
+    EXPECT_EQ(aggregations.size(), 4);
+    EXPECT_GT(cores.size(), 4);
+
+    // test: 2 tiers (radix 4), every leaf reaches every spine, and an all-to-all completes either way
+    const auto two_tier = std::make_shared<FatTree>(8, 4, 2, 50, 500);
+    EXPECT_EQ(two_tier->get_devices_count(), 8 + 4 + 2);
+    EXPECT_EQ(two_tier->route(0, 7).size(), 5);
+    auto finish_times = std::vector<EventTime>();
+    for (const auto hop_by_hop : {false, true}) {
+        auto topology_event_queue = std::make_shared<EventQueue>();
+        two_tier->attach_event_queue(topology_event_queue);
+        two_tier->set_hop_by_hop_routing(hop_by_hop);
+        for (auto src = 0; src < 8; src++) {
+            for (auto dest = 0; dest < 8; dest++) {
+                if (src != dest) {
+                    two_tier->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+        finish_times.push_back(topology_event_queue->run_to_completion());
+    }
+    EXPECT_EQ(finish_times[0], finish_times[1]);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Dragonfly) {
+    // 3 groups of 2 routers (6 - 11), 1 NPU per router: global links 6 - 9, 7 - 10, 8 - 11
+    const auto topology = std::make_shared<Dragonfly>(6, 1, 2, 1, 50, 500);
+    EXPECT_EQ(topology->get_basic_topology_type(), TopologyBuildingBlock::Dragonfly);
+    EXPECT_EQ(topology->get_groups_count(), 3);
+    EXPECT_EQ(topology->get_devices_count(), 12);
+
+    // test: minimal routes take at most one global hop
+    EXPECT_EQ(topology->route(0, 1), (Route{0, 6, 7, 1}));
+    EXPECT_EQ(topology->route(0, 2), (Route{0, 6, 9, 8, 2}));
+    EXPECT_EQ(topology->route(0, 3), (Route{0, 6, 9, 3}));
+    EXPECT_EQ(topology->route(5, 0), (Route{5, 11, 10, 7, 6, 0}));
+
+    // test: a single chunk takes its minimal route
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    EXPECT_EQ(event_queue->run_to_completion(), 4 * 20'031);
+
+    // test: Valiant routing detours chunks between groups through the remaining group
+    topology->set_routing(DragonflyRouting::Valiant);
+    EXPECT_EQ(*topology->select_route(0, 2, 0), (Route{0, 6, 7, 10, 11, 8, 2}));
+    EXPECT_EQ(*topology->select_route(0, 1, 0), topology->route(0, 1));
+
+    // test: intermediate groups are spread over the other groups, and interned
+    const auto network_parser = NetworkParser("../../input/Dragonfly.yml");
+    const auto dragonfly = std::dynamic_pointer_cast<Dragonfly>(construct_topology(network_parser));
+    ASSERT_NE(dragonfly, nullptr);
+    EXPECT_EQ(dragonfly->get_routing(), DragonflyRouting::Valiant);
+    EXPECT_EQ(dragonfly->get_groups_count(), 9);
+    auto intermediate_groups = std::set<int>();
+    for (auto chunk_id = uint64_t(0); chunk_id < 64; chunk_id++) {
+        const auto* const route = dragonfly->select_route(0, 71, chunk_id);
+        EXPECT_EQ(route->front(), 0);
+        EXPECT_EQ(route->back(), 71);
+        for (auto hop = size_t(1); hop + 1 < route->size(); hop++) {
+            const auto group = dragonfly->get_group((*route)[hop]);
+            if (group != 0 && group != 8) {
+                intermediate_groups.insert(group);
+            }
+        }
+        EXPECT_EQ(route, dragonfly->select_route(0, 71, chunk_id));
+    }
+    EXPECT_EQ(intermediate_groups.size(), 7);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FullyConnectedIndirectRouting) {
+    /// setup: 8 chunks from NPU 0 to NPU 1, i.e., skewed traffic on a single link
+    const auto send_skewed = [&](const FullyConnectedRouting routing) {
+        auto topology = std::make_shared<FullyConnected>(8, 50, 500);
+        topology->set_routing(routing);
+        const auto start_time = event_queue->get_current_time();
+        for (auto i = 0; i < 8; i++) {
+            topology->send(chunk_size, 0, 1, callback, nullptr);
+        }
+        return event_queue->run_to_completion() - start_time;
+    };
+
+    // test: Valiant routes go through an NPU other than src and dest, interned
+    auto topology = std::make_shared<FullyConnected>(8, 50, 500);
+    topology->set_routing(FullyConnectedRouting::Valiant);
+    EXPECT_EQ(topology->get_routing(), FullyConnectedRouting::Valiant);
+    auto intermediates = std::set<DeviceId>();
+    for (auto chunk_id = uint64_t(0); chunk_id < 64; chunk_id++) {
+        const auto* const route = topology->select_route(0, 1, chunk_id);
+        ASSERT_EQ(route->size(), 3);
+        intermediates.insert((*route)[1]);
+        EXPECT_EQ(route, topology->select_route(0, 1, chunk_id));
+    }
+    EXPECT_EQ(intermediates.size(), 6);
+    EXPECT_EQ(intermediates.count(0) + intermediates.count(1), 0);
+
+    // test: the direct link serializes every chunk, while indirect routes spread them over the other links
+    const auto direct_time = send_skewed(FullyConnectedRouting::Direct);
+    EXPECT_EQ(direct_time, (8 * 19'531 + 500) * ticks_per_ns);
+    EXPECT_LT(send_skewed(FullyConnectedRouting::Valiant), direct_time);
+
+    // test: adaptive routing takes the direct link until it's congested, then detours
+    topology->set_routing(FullyConnectedRouting::Adaptive, 2);
+    EXPECT_EQ(topology->select_route(0, 1, 0)->size(), 2);
+    EXPECT_LT(send_skewed(FullyConnectedRouting::Adaptive), direct_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Mesh2DAdaptiveRouting) {
+    // test: west-first moves west before anything else, ties follow XY
+    const auto mesh = std::make_shared<Mesh2D>(4, 4, 50, 500);
+    mesh->set_routing(MeshRouting::WestFirst);
+    EXPECT_EQ(mesh->next_hop(15, 0), 14);
+    EXPECT_EQ(mesh->next_hop(12, 0), 8);
+    EXPECT_EQ(mesh->next_hop(0, 15), 1);
+
+    // test: a burst toward the opposite corner of a 2x2 mesh spreads over both minimal paths
+    auto finish_times = std::vector<EventTime>();
+    auto delivered_hops = std::vector<uint64_t>();
+    for (const auto adaptive : {false, true}) {
+        const auto topology = std::make_shared<Mesh2D>(2, 2, 50, 500);
+        topology->set_routing(adaptive ? MeshRouting::WestFirst : MeshRouting::XY);
+        auto topology_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(topology_event_queue);
+        for (auto i = 0; i < 8; i++) {
+            topology->send(chunk_size, 0, 3, callback, nullptr);
+        }
+        finish_times.push_back(topology_event_queue->run_to_completion());
+        delivered_hops.push_back(topology->get_chunk_stats().hops_count);
+    }
+    EXPECT_LT(finish_times[1], finish_times[0]);
+    EXPECT_EQ(delivered_hops[0], delivered_hops[1]);
+
+    // test: an all-to-all completes with minimal routes
+    for (const auto adaptive : {false, true}) {
+        auto topology_event_queue = std::make_shared<EventQueue>();
+        mesh->attach_event_queue(topology_event_queue);
+        mesh->set_routing(adaptive ? MeshRouting::WestFirst : MeshRouting::XY);
+        const auto hops_before = mesh->get_chunk_stats().hops_count;
+        auto expected_hops = uint64_t(0);
+        for (auto src = 0; src < 16; src++) {
+            for (auto dest = 0; dest < 16; dest++) {
+                if (src != dest) {
+                    mesh->send(chunk_size, src, dest, callback, nullptr);
+                    expected_hops += mesh->route(src, dest).size() - 1;
+                }
+            }
+        }
+        topology_event_queue->run_to_completion();
+        EXPECT_EQ(mesh->get_chunk_stats().hops_count - hops_before, expected_hops);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Mesh2DO1TurnRouting) {
+    // test: the routing policy is read from the config
+    const auto network_parser = NetworkParser("../../input/Mesh2D.yml");
+    const auto topology = std::dynamic_pointer_cast<Mesh2D>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+    EXPECT_EQ(topology->get_routing(), MeshRouting::O1Turn);
+
+    // test: chunks take either the XY or the YX route, depending on their id only
+    auto xy_chunks_count = 0;
+    auto yx_chunks_count = 0;
+    for (auto chunk_id = uint64_t(0); chunk_id < 64; chunk_id++) {
+        const auto route = topology->select_route(0, 15, chunk_id);
+        EXPECT_EQ(route, topology->select_route(0, 15, chunk_id));
+        EXPECT_EQ(route->size(), 7);
+        if ((*route)[1] == 1) {
+            xy_chunks_count++;
+        } else {
+            EXPECT_EQ((*route)[1], 4);
+            yx_chunks_count++;
+        }
+    }
+    EXPECT_GT(xy_chunks_count, 0);
+    EXPECT_GT(yx_chunks_count, 0);
+
+    // test: a transpose finishes no later than with XY routing
+    auto finish_times = std::vector<EventTime>();
+    for (const auto routing : {MeshRouting::XY, MeshRouting::O1Turn}) {
+        auto topology_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(topology_event_queue);
+        topology->set_routing(routing);
+        for (auto x = 0; x < 4; x++) {
+            for (auto y = 0; y < 4; y++) {
+                for (auto i = 0; i < 4 && x != y; i++) {
+                    topology->send(chunk_size, y * 4 + x, x * 4 + y, callback, nullptr);
+                }
+            }
+        }
+        finish_times.push_back(topology_event_queue->run_to_completion());
+    }
+    EXPECT_LE(finish_times[1], finish_times[0]);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SharedRoutes) {
+    const auto topology = std::make_shared<Mesh2D>(2, 2, 50, 500);
+
+    // test: a route is computed once and shared afterwards
+    const auto route = topology->shared_route(0, 3);
+    EXPECT_EQ(route, topology->shared_route(0, 3));
+    EXPECT_NE(route, topology->shared_route(3, 0));
+    EXPECT_EQ(route->size(), topology->route(0, 3).size());
+    EXPECT_TRUE(route->links_resolved());
+
+    // test: chunks on shared routes and hand-built routes are delivered alike
+    auto finish_times = std::vector<EventTime>();
+    for (const auto shared : {true, false}) {
+        auto topology_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(topology_event_queue);
+        for (auto i = 0; i < 4; i++) {
+            if (shared) {
+                topology->send(chunk_size, 0, 3, callback, nullptr);
+            } else {
+                topology->send(std::make_unique<Chunk>(chunk_size, topology->compute_route(0, 3), callback, nullptr));
+            }
+        }
+        finish_times.push_back(topology_event_queue->run_to_completion());
+    }
+    EXPECT_EQ(finish_times[0], finish_times[1]);
+    EXPECT_EQ(route, topology->shared_route(0, 3));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ExecutionTraceReplay) {
+    // NPU 0 computes, then sends to NPU 1; every NPU then joins an All-Reduce
+    // (NPU 1 only once it received the message)
+    const auto write_trace = [](const std::string& trace_path, const std::string& nodes) {
+        auto trace_file = std::ofstream(trace_path);
+        trace_file << nodes;
+        return trace_path;
+    };
+    const auto trace_paths = std::vector<std::string>{
+        write_trace("et_test.0.txt", "# NPU 0\n"
+                                     "id=1 type=COMP_NODE duration_micros=1\n"
+                                     "id=2 type=COMM_SEND_NODE comm_dst=1 comm_size=1048576 comm_tag=7 deps=1\n"
+                                     "id=3 type=COMM_COLL_NODE comm_type=ALL_REDUCE comm_size=4194304\n"),
+        write_trace("et_test.1.txt", "id=5 type=COMM_RECV_NODE comm_src=0 comm_size=1048576 comm_tag=7\n"
+                                     "\n"
+                                     "id=6 type=COMM_COLL_NODE comm_type=ALL_REDUCE comm_size=4194304 deps=5\n"),
+        write_trace("et_test.2.txt", "id=1 type=COMM_COLL_NODE comm_type=ALL_REDUCE comm_size=4194304\n"),
+        write_trace("et_test.3.txt", "id=1 type=COMM_COLL_NODE comm_type=ALL_REDUCE comm_size=4194304\n"),
+    };
+
+    // reference: the All-Reduce on its own
+    auto reference_event_queue = std::make_shared<EventQueue>();
+    auto reference_topology = std::make_shared<Ring>(4, 50, 500);
+    reference_topology->attach_event_queue(reference_event_queue);
+    auto all_reduce = Collective(reference_topology, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 4'194'304);
+    all_reduce.start();
+    reference_event_queue->run_to_completion();
+
+    // replay with a window of 2 nodes per NPU
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(4, 50, 500);
+    topology->attach_event_queue(ring_event_queue);
+    auto network = ExecutionTraceAdapter(topology);
+    auto replay = ExecutionTraceReplay(network, trace_paths, 2);
+    replay.start();
+    ring_event_queue->run_to_completion();
+
+    // test: the All-Reduce starts once the message was received
+    const auto hop_delay = topology->get_link(topology->find_link(0, 1)).communication_delay(chunk_size);
+    EXPECT_TRUE(replay.finished());
+    EXPECT_EQ(replay.get_completed_nodes_count(), 7);
+    EXPECT_EQ(replay.get_finish_time(), 1'000 + hop_delay + all_reduce.get_finish_time());
+    EXPECT_LE(replay.get_peak_window_size(), 2);
+
+    for (const auto& trace_path : trace_paths) {
+        std::remove(trace_path.c_str());
+    }
+}
+
+namespace {
+
+/// chunk forwarded around the NPUs, one hop at a time, by arrival callbacks
+struct ForwardedChunk {
+    Topology* topology;
+    ParallelSimulation* simulation;
+    ChunkSize chunk_size;
+    DeviceId device;
+    int remaining_sends;
+};
+
+void forward_chunk(void* const arg) {
+    auto* const forwarded_chunk = static_cast<ForwardedChunk*>(arg);
+    if (forwarded_chunk->remaining_sends == 0) {
+        return;
+    }
+    forwarded_chunk->remaining_sends--;
+
+    // send to the next NPU (in the other direction every other NPU)
+    const auto npus_count = forwarded_chunk->topology->get_npus_count();
+    const auto src = forwarded_chunk->device;
+    const auto dest = (src % 2 == 0) ? (src + 9) % npus_count : (src + npus_count - 5) % npus_count;
+    forwarded_chunk->device = dest;
+    if (forwarded_chunk->simulation != nullptr) {
+        forwarded_chunk->simulation->send(forwarded_chunk->chunk_size, src, dest, forward_chunk, arg);
+    } else {
+        forwarded_chunk->topology->send(forwarded_chunk->chunk_size, src, dest, forward_chunk, arg);
+    }
+}
+
+}  // namespace
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelSimulation) {
+    // test: 4 partitions of a 2D mesh are 2 x 2 tiles
+    const auto mesh = Mesh2D(8, 8, 50, 500);
+    const auto mesh_partitions = ParallelSimulation::partition_devices(mesh, 4);
+    EXPECT_EQ(mesh_partitions[0], 0);
+    EXPECT_EQ(mesh_partitions[7], 1);
+    EXPECT_EQ(mesh_partitions[56], 2);
+    EXPECT_EQ(mesh_partitions[63], 3);
+
+    // run an all-to-all, plus chunks forwarded by callbacks,
+    // sequentially (partitions_count == 0) or in parallel
+    const auto simulate = [&](const std::shared_ptr<Topology>& topology, const int partitions_count) {
+        const auto npus_count = topology->get_npus_count();
+        auto sequential_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(sequential_event_queue);
+        auto simulation = std::unique_ptr<ParallelSimulation>();
+        if (partitions_count > 0) {
+            simulation = std::make_unique<ParallelSimulation>(topology, partitions_count, 2);
+        }
+
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+                if (simulation != nullptr) {
+                    simulation->send(chunk_size, src, dest, callback, nullptr);
+                } else {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+
+        auto forwarded_chunks = std::vector<ForwardedChunk>();
+        for (auto npu = 0; npu < npus_count; npu++) {
+            forwarded_chunks.push_back({topology.get(), simulation.get(), chunk_size / 4, npu, 8});
+        }
+        for (auto& forwarded_chunk : forwarded_chunks) {
+            forward_chunk(&forwarded_chunk);
+        }
+
+        if (simulation != nullptr) {
+            EXPECT_GT(simulation->get_lookahead(), 0);
+            return simulation->run();
+        }
+        while (!sequential_event_queue->finished()) {
+            sequential_event_queue->proceed();
+        }
+        return sequential_event_queue->get_current_time();
+    };
+
+    // test: identical to the sequential simulation
+    const auto mesh_topology = std::make_shared<Mesh2D>(8, 8, 50, 500);
+    const auto mesh_finish_time = simulate(mesh_topology, 0);
+    EXPECT_EQ(simulate(mesh_topology, 4), mesh_finish_time);
+    EXPECT_EQ(simulate(mesh_topology, 16), mesh_finish_time);
+
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto multi_dim_topology = construct_topology(network_parser);
+    const auto multi_dim_finish_time = simulate(multi_dim_topology, 0);
+    EXPECT_EQ(simulate(multi_dim_topology, 4), multi_dim_finish_time);
+
+    // test: switches join the partition of their lowest-id NPU
+    const auto multi_dim_partitions = ParallelSimulation::partition_devices(*multi_dim_topology, 4);
+    auto lowest_npu_neighbor = std::vector<DeviceId>(80, 64);
+    for (auto link_id = 0; link_id < multi_dim_topology->get_links_count(); link_id++) {
+        const auto& link = multi_dim_topology->get_link(link_id);
+        if (link.get_src() >= 64 && link.get_dest() < 64) {
+            lowest_npu_neighbor[link.get_src()] = std::min(lowest_npu_neighbor[link.get_src()], link.get_dest());
+        }
+    }
+    for (auto device = 64; device < 80; device++) {
+        ASSERT_LT(lowest_npu_neighbor[device], 64);
+        EXPECT_EQ(multi_dim_partitions[device], multi_dim_partitions[lowest_npu_neighbor[device]]);
+    }
+}
+
+namespace {
+
+/// chunk forwarded around the NPUs by the arrival callbacks of an OptimisticSimulation
+struct OptimisticForwardedChunk {
+    OptimisticSimulation* simulation;
+    int npus_count;
+    DeviceId device;
+    int remaining_sends;
+};
+
+void forward_optimistic_chunk(void* const arg) {
+    auto* const forwarded_chunk = static_cast<OptimisticForwardedChunk*>(arg);
+    if (forwarded_chunk->remaining_sends == 0) {
+        return;
+    }
+    forwarded_chunk->remaining_sends--;
+
+    const auto src = forwarded_chunk->device;
+    const auto dest = (src + 9) % forwarded_chunk->npus_count;
+    forwarded_chunk->device = dest;
+    forwarded_chunk->simulation->send(1'000'000 / 4, src, dest, forward_optimistic_chunk, arg);
+}
+
+}  // namespace
+
+TEST_F(TestNetworkAnalyticalCongestionAware, OptimisticSimulation) {
+    // run an all-to-all, plus chunks forwarded by callbacks
+    const auto simulate = [&](const std::shared_ptr<Topology>& topology, const int partitions_count) {
+        const auto npus_count = topology->get_npus_count();
+        auto simulation = OptimisticSimulation(topology, partitions_count, 2);
+        simulation.set_batch_size(64);
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    simulation.send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+
+        auto forwarded_chunks = std::vector<OptimisticForwardedChunk>();
+        for (auto npu = 0; npu < npus_count; npu++) {
+            forwarded_chunks.push_back({&simulation, npus_count, npu, 8});
+        }
+        for (auto& forwarded_chunk : forwarded_chunks) {
+            forward_optimistic_chunk(&forwarded_chunk);
+        }
+
+        const auto finish_time = simulation.run();
+        EXPECT_EQ(simulation.get_partitions_count(), partitions_count);
+        if (partitions_count > 1) {
+            EXPECT_GT(simulation.get_rollbacks_count(), 0);
+        }
+        return std::make_pair(finish_time, simulation.get_committed_events_count());
+    };
+
+    // test: identical whatever the partitioning, even with zero-latency links crossing partitions
+    const auto mesh = std::make_shared<Mesh2D>(8, 8, 50, 500);
+    const auto mesh_result = simulate(mesh, 1);
+    EXPECT_EQ(simulate(mesh, 4), mesh_result);
+    EXPECT_EQ(simulate(mesh, 16), mesh_result);
+
+    const auto zero_latency_mesh = std::make_shared<Mesh2D>(8, 8, 50, 0);
+    const auto zero_latency_result = simulate(zero_latency_mesh, 1);
+    EXPECT_EQ(simulate(zero_latency_mesh, 4), zero_latency_result);
+    EXPECT_LT(zero_latency_result.first, mesh_result.first);
+
+    // test: same finish time as the conservative parallel simulation
+    auto parallel_simulation = ParallelSimulation(mesh, 4, 2);
+    for (auto src = 0; src < 64; src++) {
+        for (auto dest = 0; dest < 64; dest++) {
+            if (src != dest) {
+                parallel_simulation.send(chunk_size, src, dest, callback, nullptr);
+            }
+        }
+    }
+    auto optimistic_simulation = OptimisticSimulation(mesh, 4, 2);
+    for (auto src = 0; src < 64; src++) {
+        for (auto dest = 0; dest < 64; dest++) {
+            if (src != dest) {
+                optimistic_simulation.send(chunk_size, src, dest, callback, nullptr);
+            }
+        }
+    }
+    EXPECT_EQ(optimistic_simulation.run(), parallel_simulation.run());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelEventInvocation) {
+    // run an all-gather, invoking independent same-time events concurrently if threads_count > 1
+    const auto simulate = [&](const std::shared_ptr<Topology>& topology, const int threads_count) {
+        auto collective_event_queue = std::make_shared<EventQueue>();
+        Topology::register_event_resources(*collective_event_queue);
+        collective_event_queue->set_parallel_invocation(threads_count, 1);
+        topology->attach_event_queue(collective_event_queue);
+
+        const auto collective_size = topology->get_npus_count() * 4 * chunk_size;
+        auto all_gather = Collective(topology, CollectiveType::AllGather, CollectiveAlgorithm::Direct, collective_size, 4);
+        all_gather.start();
+        while (!collective_event_queue->finished()) {
+            collective_event_queue->proceed();
+        }
+
+        EXPECT_TRUE(all_gather.finished());
+        return std::make_pair(all_gather.get_finish_time(), collective_event_queue->get_stats().events_processed);
+    };
+
+    // test: identical to invoking the events one by one
+    const auto topologies = std::vector<std::shared_ptr<Topology>>({
+        std::make_shared<Ring>(16, 50, 500),
+        std::make_shared<Mesh2D>(4, 4, 50, 500),
+    });
+    for (const auto& topology : topologies) {
+        EXPECT_EQ(simulate(topology, 2), simulate(topology, 1));
+    }
+
+    // events touching more than their link run alone: messages split from the chunk pool,
+    // bounded buffers charged by upstream links, crossbars shared by a switch's links, and rerouting around failures
+    struct MessageDelivery {
+        EventQueue* event_queue;
+        std::vector<EventTime> times;
+    };
+    const auto record_delivery = [](void* const arg) {
+        auto* const delivery = static_cast<MessageDelivery*>(arg);
+        delivery->times.push_back(delivery->event_queue->get_current_time());
+    };
+    const auto simulate_messages = [&](const std::function<std::shared_ptr<Topology>()>& make_topology,
+                                       const int threads_count) {
+        auto message_event_queue = std::make_shared<EventQueue>();
+        Topology::register_event_resources(*message_event_queue);
+        message_event_queue->set_parallel_invocation(threads_count, 1);
+        const auto topology = make_topology();
+        topology->attach_event_queue(message_event_queue);
+
+        // an all-to-all of messages of 1 to 4 chunks, recording when each chunk is delivered
+        const auto npus_count = topology->get_npus_count();
+        auto deliveries = std::vector<MessageDelivery>(static_cast<size_t>(npus_count * npus_count));
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                auto& delivery = deliveries[src * npus_count + dest];
+                delivery.event_queue = message_event_queue.get();
+                if (src != dest) {
+                    const auto chunks_count = static_cast<uint32_t>(1 + (src + dest) % 4);
+                    topology->send_message(chunk_size, chunks_count, src, dest, record_delivery, &delivery);
+                }
+            }
+        }
+        message_event_queue->run_to_completion();
+
+        auto delivery_times = std::vector<std::vector<EventTime>>();
+        for (auto& delivery : deliveries) {
+            delivery_times.push_back(std::move(delivery.times));
+        }
+        return delivery_times;
+    };
+
+    // test: identical to invoking the events one by one, run after run
+    const auto make_topologies = std::vector<std::function<std::shared_ptr<Topology>()>>({
+        [] { return std::make_shared<Ring>(16, 50, 500); },
+        [&] {
+            auto mesh = std::make_shared<Mesh2D>(4, 4, 50, 500);
+            mesh->set_link_buffer_capacity(2 * chunk_size);
+            return mesh;
+        },
+        [&] {
+            auto switch_topology = std::make_shared<Switch>(8, 50, 500);
+            switch_topology->set_switch_model(200, 100, chunk_size);
+            return switch_topology;
+        },
+        [] {
+            auto ring = std::make_shared<Ring>(16, 50, 500);
+            ring->set_link_failed(3, 4, true);
+            return ring;
+        },
+    });
+    for (const auto& make_topology : make_topologies) {
+        const auto serial_delivery_times = simulate_messages(make_topology, 1);
+        for (auto run = 0; run < 8; run++) {
+            EXPECT_EQ(simulate_messages(make_topology, 4), serial_delivery_times);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkQueue) {
+    // enqueue chunks of distinct sizes
+    auto queue = ChunkQueue();
+    for (auto i = 1; i <= 4; i++) {
+        queue.push_back(std::make_unique<Chunk>(i * chunk_size, Route({0, 1}), callback, nullptr));
+    }
+    EXPECT_EQ(queue.size(), 4);
+
+    // test: FIFO order, also after the queue is moved
+    EXPECT_EQ(queue.pop_front()->get_size(), chunk_size);
+    auto moved_queue = std::move(queue);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(moved_queue.size(), 3);
+    moved_queue.push_back(std::make_unique<Chunk>(5 * chunk_size, Route({0, 1}), callback, nullptr));
+    for (auto i = 2; i <= 5; i++) {
+        EXPECT_EQ(moved_queue.pop_front()->get_size(), i * chunk_size);
+    }
+    EXPECT_TRUE(moved_queue.empty());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CompiledNetworkConfig) {
+    const auto config_path = std::string("compiled_network_config.yml");
+    const auto compiled_path = config_path + ".bin";
+    const auto write_config = [&](const int excluded_x) {
+        auto config_file = std::ofstream(config_path);
+        config_file << "topology: [ Mesh2D ]\nnpus_count: [ 15 ]\nwidth: 4\nheight: 4\nrouting: O1Turn\n"
+                    << "bandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\nexcluded: [ [" << excluded_x << ", 3] ]\n";
+    };
+
+    // compile on the first load
+    write_config(3);
+    std::remove(compiled_path.c_str());
+    const auto compiled = NetworkParser::load_cached(config_path);
+    EXPECT_TRUE(std::ifstream(compiled_path).good());
+
+    // test: loading the compiled file gives the parsed configuration
+    const auto parsed = NetworkParser(config_path);
+    const auto loaded = NetworkParser::load_cached(config_path);
+    for (const auto& network_parser : {compiled, loaded}) {
+        EXPECT_EQ(network_parser.get_dims_count(), parsed.get_dims_count());
+        EXPECT_EQ(network_parser.get_topologies_per_dim(), parsed.get_topologies_per_dim());
+        EXPECT_EQ(network_parser.get_npus_counts_per_dim(), parsed.get_npus_counts_per_dim());
+        EXPECT_EQ(network_parser.get_bandwidths_per_dim(), parsed.get_bandwidths_per_dim());
+        EXPECT_EQ(network_parser.get_latencies_per_dim(), parsed.get_latencies_per_dim());
+        EXPECT_EQ(network_parser.get_mesh_width(), parsed.get_mesh_width());
+        EXPECT_EQ(network_parser.get_mesh_routing(), MeshRouting::O1Turn);
+        EXPECT_EQ(network_parser.get_excluded_coords(), parsed.get_excluded_coords());
+        EXPECT_EQ(network_parser.get_npu_placement(), parsed.get_npu_placement());
+    }
+
+    // test: an edited yml file invalidates the compiled file
+    write_config(0);
+    const auto recompiled = NetworkParser::load_cached(config_path);
+    EXPECT_EQ(recompiled.get_excluded_coords(), (std::set<std::pair<int, int>>{{0, 3}}));
+
+    std::remove(config_path.c_str());
+    std::remove(compiled_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SharedTopology) {
+    /// All-Gather workload
+    const auto all_gather = [](Topology& topology) {
+        const auto npus_count = topology.get_npus_count();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology.send(1'048'576, i, j, callback, nullptr);
+                }
+            }
+        }
+    };
+
+    /// setup: a single Ring(16) shared by 8 concurrent simulations
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto shared_ring = std::make_shared<SharedTopology>(construct_topology(network_parser));
+    const auto ring_finish_times = Sweep::run_shared(shared_ring, std::vector<Workload>(8, all_gather), 4);
+
+    /// test: every simulation matches a topology of its own
+    EXPECT_EQ(ring_finish_times, std::vector<EventTime>(8, 704'116));
+
+    /// setup: FullyConnected(8), whose lazy links stay lazy in every instance
+    const auto shared_fully_connected =
+        std::make_shared<SharedTopology>(std::make_shared<FullyConnected>(8, 50.0, 500.0));
+    const auto single_chunk = [](Topology& topology) {
+        EXPECT_EQ(topology.get_materialized_links_count(), 0);
+        topology.send(1'048'576, 0, 7, callback, nullptr);
+    };
+    const auto fully_connected_finish_times =
+        Sweep::run_shared(shared_fully_connected, std::vector<Workload>(4, single_chunk), 2);
+
+    /// test: identical simulations, and the shared topology's links are never materialized
+    EXPECT_EQ(fully_connected_finish_times, std::vector<EventTime>(4, fully_connected_finish_times[0]));
+    EXPECT_GT(fully_connected_finish_times[0], 500);
+    EXPECT_EQ(shared_fully_connected->get_topology().get_materialized_links_count(), 0);
+
+    /// setup: an O1TURN mesh, whose XY and YX routes are all built along with the shared topology
+    const auto mesh = std::make_shared<Mesh2D>(4, 4, 50, 500);
+    mesh->set_routing(MeshRouting::O1Turn);
+    const auto shared_mesh = std::make_shared<SharedTopology>(mesh);
+    const auto route_tables_bytes = mesh->get_memory_footprint().route_tables.bytes;
+    EXPECT_GT(route_tables_bytes, 0);
+
+    /// test: concurrent lookups find every route built, and don't grow the route tables
+    auto routes_per_thread = std::vector<std::vector<const Route*>>(4);
+    auto lookup_threads = std::vector<std::thread>();
+    for (auto thread_id = 0; thread_id < 4; thread_id++) {
+        lookup_threads.emplace_back([&, thread_id] {
+            for (auto chunk_id = 0; chunk_id < 256; chunk_id++) {
+                const auto src = chunk_id % 16;
+                const auto dest = (src + 1 + chunk_id / 16) % 16;
+                if (src != dest) {
+                    routes_per_thread[thread_id].push_back(shared_mesh->select_route(src, dest, chunk_id));
+                    EXPECT_GE(shared_mesh->find_link(src, shared_mesh->next_hop(src, dest)), 0);
+                }
+            }
+        });
+    }
+    for (auto& lookup_thread : lookup_threads) {
+        lookup_thread.join();
+    }
+    for (const auto& routes : routes_per_thread) {
+        EXPECT_EQ(routes, routes_per_thread[0]);
+    }
+    EXPECT_EQ(mesh->get_memory_footprint().route_tables.bytes, route_tables_bytes);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CustomTopology) {
+    /// setup: 2 nodes of 4 NPUs, with a switch per node and a rail switch per local rank
+    const auto topology = std::make_shared<CustomTopology>("../../input/Custom.csv", 8, 50, 500, 2);
+    EXPECT_EQ(topology->get_npus_count(), 8);
+    EXPECT_EQ(topology->get_devices_count(), 14);
+    EXPECT_EQ(topology->get_links_count(), 32);
+
+    /// test: shortest routes, through the node switch or the rail switch
+    EXPECT_EQ(topology->route(0, 3), Route({0, 12, 3}));
+    EXPECT_EQ(topology->route(1, 5), Route({1, 9, 5}));
+    EXPECT_EQ(topology->route(0, 5).size(), 5);
+
+    /// test: links listed without parameters take the given ones
+    EXPECT_EQ(topology->get_link(topology->find_link(0, 12)).get_bandwidth(), 400);
+    EXPECT_EQ(topology->get_link(topology->find_link(0, 8)).get_bandwidth(), 50);
+
+    /// test: a chunk between nodes takes the rail
+    topology->send(chunk_size, 1, 5, callback, nullptr);
+    const auto rail_delay = topology->get_link(topology->find_link(1, 9)).communication_delay(chunk_size);
+    EXPECT_EQ(event_queue->run_to_completion(), 2 * rail_delay);
+
+    /// test: the network config constructs the same topology
+    auto network_config = YAML::Node();
+    network_config["topology"].push_back("Custom");
+    network_config["npus_count"].push_back(8);
+    network_config["bandwidth"].push_back(50.0);
+    network_config["latency"].push_back(500.0);
+    network_config["edge_list"] = "../../input/Custom.csv";
+    const auto configured_topology = construct_topology(NetworkParser(network_config));
+    EXPECT_EQ(configured_topology->route(0, 5), topology->route(0, 5));
+
+    /// test: a FatTree saved as a binary edge list keeps its links and minimal route lengths
+    const auto fat_tree = FatTree(8, 4, 2, 50, 500);
+    const auto edge_list_path = std::string("custom_topology_test.bin");
+    ASSERT_TRUE(CustomTopology::save(fat_tree, edge_list_path));
+    const auto custom_fat_tree = CustomTopology(edge_list_path, 8, 1, 0);
+    std::remove(edge_list_path.c_str());
+    EXPECT_EQ(custom_fat_tree.get_devices_count(), fat_tree.get_devices_count());
+    EXPECT_EQ(custom_fat_tree.get_links_count(), fat_tree.get_links_count());
+    for (auto src = 0; src < 8; src++) {
+        for (auto dest = 0; dest < 8; dest++) {
+            if (src != dest) {
+                EXPECT_EQ(custom_fat_tree.route(src, dest).size(), fat_tree.route(src, dest).size());
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkRanking) {
+    if constexpr (!stats_enabled) {
+        GTEST_SKIP() << "statistics are not compiled in";
+    }
+
+    /// setup: three chunks 0 -> 3 contend for the 0 -> 1 link of row 0, one chunk 0 -> 12 goes down column 0
+    const auto topology = std::make_shared<Mesh2D>(4, 4, 50, 500);
+    for (auto i = 0; i < 3; i++) {
+        topology->send(chunk_size, 0, 3, callback, nullptr);
+    }
+    topology->send(chunk_size, 0, 12, callback, nullptr);
+    event_queue->run_to_completion();
+
+    /// test: the 0 -> 1 link imposes the queueing delay, and the other row 0 links are just as busy
+    const auto serialization_delay = static_cast<EventTime>(chunk_size / bw_GBps_to_Bpns(50));
+    const auto& first_link_stats = topology->get_link(topology->find_link(0, 1)).get_stats();
+    EXPECT_EQ(first_link_stats.busy_time, 3 * serialization_delay);
+    EXPECT_EQ(first_link_stats.queueing_delay, 3 * serialization_delay);
+    EXPECT_EQ(first_link_stats.max_pending_chunks, 2);
+
+    /// test: links ranked by busy time, then queueing delay
+    const auto ranked_links = topology->rank_links();
+    ASSERT_EQ(ranked_links.size(), topology->get_links_count());
+    EXPECT_EQ(ranked_links[0], topology->find_link(0, 1));
+    EXPECT_EQ(topology->get_link(ranked_links[1]).get_stats().busy_time, 3 * serialization_delay);
+    EXPECT_EQ(topology->get_link(ranked_links[2]).get_stats().busy_time, 3 * serialization_delay);
+    EXPECT_EQ(topology->get_link(ranked_links[3]).get_stats().busy_time, serialization_delay);
+
+    /// test: report groups links by mesh row and column, most loaded first
+    EXPECT_EQ(topology->get_link_group(topology->find_link(4, 5)), "row 1");
+    EXPECT_EQ(topology->get_link_group(topology->find_link(8, 4)), "column 0");
+    auto report = std::ostringstream();
+    topology->dump_link_ranking(report, 3);
+    const auto text = report.str();
+    EXPECT_LT(text.find("group row 0: links: 6"), text.find("group column 0: links: 6"));
+    EXPECT_NE(text.find("link #1 0->1 (row 0)"), std::string::npos);
+    EXPECT_EQ(text.find("link #4"), std::string::npos);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TimeBase) {
+    /// setup: a 400 GB/s link serializes a 64 B packet in about 0.149 ns
+    const auto link = Link(0, 1, 400, 0.5);
+    const auto packet_serialization_time = 64.0 / bw_GBps_to_Bpns(400);
+
+    /// test: delays are rounded down to a tick, on any time base
+    EXPECT_EQ(link.communication_delay(64), ns_to_ticks(0.5) + ns_to_ticks(packet_serialization_time));
+    EXPECT_EQ(link.communication_delay(chunk_size), ns_to_ticks(0.5) + ns_to_ticks(chunk_size / bw_GBps_to_Bpns(400)));
+    EXPECT_EQ(ticks_to_ns(ns_to_ticks(2.0)), 2.0);
+
+    /// test: a train of packets serializes as much as the whole chunk, up to a tick per packet
+    const auto packets_serialization_time = 16384 * (link.communication_delay(64) - ns_to_ticks(0.5));
+    const auto chunk_serialization_time = link.communication_delay(chunk_size) - ns_to_ticks(0.5);
+    EXPECT_LE(packets_serialization_time, chunk_serialization_time);
+    EXPECT_LE(chunk_serialization_time - packets_serialization_time, 16384);
+
+    /// test: serialization delays are the size divided by the bandwidth, exactly
+    /// (e.g., 65713 B at 900 GB/s, which a 32.32 fixed-point reciprocal rounds a tick too low)
+    for (const auto bandwidth : {25.0, 50.0, 400.0, 900.0}) {
+        const auto bandwidth_link = Link(0, 1, bandwidth, 500);
+        for (const auto size : {ChunkSize(64), ChunkSize(65713), ChunkSize(131426), chunk_size, ChunkSize(1) << 30}) {
+            const auto serialization_delay = static_cast<double>(size) * ticks_per_ns / bw_GBps_to_Bpns(bandwidth);
+            EXPECT_EQ(bandwidth_link.communication_delay(size) - ns_to_ticks(500),
+                      static_cast<EventTime>(serialization_delay));
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, StaticRouting) {
+    /// setup: a loop templated on the concrete topology, writing every route into one buffer
+    const auto check_routes = [](const Topology& topology, const bool expect_static) {
+        const auto resolved = visit_topology(topology, [&topology](const auto& concrete_topology) {
+            using TopologyType = std::decay_t<decltype(concrete_topology)>;
+            auto route = std::vector<DeviceId>(max_route_length(concrete_topology));
+            for (auto src = 0; src < topology.get_npus_count(); src++) {
+                for (auto dest = 0; dest < topology.get_npus_count(); dest++) {
+                    if (src == dest) {
+                        continue;
+                    }
+                    const auto length = write_route(concrete_topology, src, dest, route.data());
+                    const auto expected_route = topology.route(src, dest);
+                    EXPECT_LE(length, static_cast<int>(route.size()));
+                    EXPECT_TRUE(std::equal(route.begin(), route.begin() + length, expected_route.begin(),
+                                           expected_route.end()));
+                }
+            }
+            return has_static_route<TopologyType>::value;
+        });
+        EXPECT_EQ(resolved, expect_static);
+    };
+
+    /// test: concrete topologies write the routes compute_route returns
+    check_routes(Ring(8, 50, 500), true);
+    check_routes(Ring(7, 50, 500, false), true);
+    check_routes(Switch(8, 50, 500), true);
+    check_routes(FullyConnected(8, 50, 500), true);
+    check_routes(Mesh2D(4, 3, 50, 500), true);
+
+    /// test: other topologies are visited as a Topology, copying their shared routes
+    check_routes(Torus(4, 3, 50, 500), false);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SendBatch) {
+    /// setup: an all-to-all on a ring, every chunk recording its arrival
+    struct Arrival {
+        EventQueue* event_queue;
+        std::vector<int>* arrival_order;
+        int index;
+        EventTime time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+        arrival->arrival_order->push_back(arrival->index);
+    };
+    const auto npus_count = 8;
+    const auto run_all_to_all = [&](const bool batched, std::vector<Arrival>& arrivals, std::vector<int>& order) {
+        auto all_to_all_event_queue = std::make_shared<EventQueue>();
+        Topology::set_event_queue(all_to_all_event_queue);
+        const auto topology = std::make_shared<Ring>(npus_count, 50, 500);
+        arrivals.resize(npus_count * (npus_count - 1));
+        auto descriptors = std::vector<ChunkDescriptor>();
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    const auto index = static_cast<int>(descriptors.size());
+                    arrivals[index] = {all_to_all_event_queue.get(), &order, index, 0};
+                    descriptors.push_back({src, dest, chunk_size, record_arrival, &arrivals[index]});
+                }
+            }
+        }
+
+        if (batched) {
+            topology->send_batch(descriptors.data(), descriptors.size());
+        } else {
+            for (const auto& descriptor : descriptors) {
+                topology->send(descriptor.chunk_size, descriptor.src, descriptor.dest, descriptor.callback,
+                               descriptor.callback_arg);
+            }
+        }
+        all_to_all_event_queue->run_to_completion();
+        const auto& chunk_pool = topology->get_chunk_pool();
+        EXPECT_EQ(chunk_pool.get_free_chunks_count(), chunk_pool.get_allocated_chunks_count());
+    };
+
+    auto sequential_arrivals = std::vector<Arrival>();
+    auto sequential_order = std::vector<int>();
+    run_all_to_all(false, sequential_arrivals, sequential_order);
+    auto batched_arrivals = std::vector<Arrival>();
+    auto batched_order = std::vector<int>();
+    run_all_to_all(true, batched_arrivals, batched_order);
+
+    /// test: the batch delivers every chunk at the same time, in the same order, as sending them one by one
+    ASSERT_EQ(batched_order.size(), sequential_arrivals.size());
+    EXPECT_EQ(batched_order, sequential_order);
+    for (auto i = 0; i < static_cast<int>(sequential_arrivals.size()); i++) {
+        EXPECT_EQ(batched_arrivals[i].time, sequential_arrivals[i].time);
+    }
+
+    Topology::set_event_queue(event_queue);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BatchedCompletion) {
+    /// setup: every NPU sends a chunk to the next one, and NPU 0 sends a second one, all notified in batches
+    struct Batches {
+        std::vector<std::vector<uint64_t>> chunk_ids;
+        std::vector<EventTime> times;
+        EventQueue* event_queue;
+    };
+    auto batches = Batches{{}, {}, event_queue.get()};
+    const auto record_batch = [](const uint64_t* const chunk_ids, const int chunks_count, void* const arg) {
+        auto* const batches = static_cast<Batches*>(arg);
+        batches->chunk_ids.emplace_back(chunk_ids, chunk_ids + chunks_count);
+        batches->times.push_back(batches->event_queue->get_current_time());
+    };
+    const auto npus_count = 8;
+    const auto topology = std::make_shared<FullyConnected>(npus_count, 50, 500);
+    topology->set_batched_completion(record_batch, &batches);
+    auto group = CompletionGroup(npus_count + 1);
+    for (auto src = 0; src < npus_count; src++) {
+        topology->send(chunk_size, src, (src + 1) % npus_count, CompletionGroup::chunk_arrived, &group);
+    }
+    topology->send(chunk_size, 0, 1, CompletionGroup::chunk_arrived, &group);
+    event_queue->run_to_completion();
+
+    /// test: the chunks arriving together are notified at once, the queued one separately
+    ASSERT_EQ(batches.chunk_ids.size(), 2);
+    EXPECT_EQ(batches.chunk_ids[0], std::vector<uint64_t>({0, 1, 2, 3, 4, 5, 6, 7}));
+    EXPECT_EQ(batches.chunk_ids[1], std::vector<uint64_t>({8}));
+    EXPECT_LT(batches.times[0], batches.times[1]);
+
+    /// test: the chunks' own callbacks are skipped in batched mode
+    EXPECT_EQ(group.get_remaining_chunks_count(), npus_count + 1);
+
+    /// setup: the same chunks notified one by one, counted by the group
+    topology->set_batched_completion(nullptr);
+    auto completed = false;
+    auto counted_group = CompletionGroup(npus_count + 1, [](void* const arg) { *static_cast<bool*>(arg) = true; },
+                                         &completed);
+    for (auto src = 0; src < npus_count; src++) {
+        topology->send(chunk_size, src, (src + 1) % npus_count, CompletionGroup::chunk_arrived, &counted_group);
+    }
+    topology->send(chunk_size, 0, 1, CompletionGroup::chunk_arrived, &counted_group);
+    event_queue->run_until(batches.times[1] + batches.times[0]);
+
+    /// test: the group's single callback fires once the last chunk arrived
+    EXPECT_EQ(counted_group.get_remaining_chunks_count(), 1);
+    EXPECT_FALSE(completed);
+    event_queue->run_to_completion();
+    EXPECT_TRUE(counted_group.completed());
+    EXPECT_TRUE(completed);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkPayload) {
+    /// setup: message ids and tags travel inline with the chunks, no context allocated per chunk
+    struct Message {
+        uint64_t message_id;
+        int32_t tag;
+        DeviceId dest;
+    };
+    static_assert(sizeof(Message) <= Chunk::payload_capacity);
+    static auto received_messages = std::vector<Message>();
+    received_messages.clear();
+    const auto receive_message = [](void* const payload) {
+        received_messages.push_back(*static_cast<const Message*>(payload));
+    };
+    const auto topology = std::make_shared<Ring>(8, 50, 500);
+    topology->send_with_payload(chunk_size, 0, 3, receive_message, Message{42, 7, 3});
+    topology->send_with_payload(chunk_size, 5, 1, receive_message, Message{43, 8, 1});
+    event_queue->run_to_completion();
+
+    /// test: each callback gets its chunk's copy of the payload
+    ASSERT_EQ(received_messages.size(), 2);
+    EXPECT_EQ(received_messages[0].message_id + received_messages[1].message_id, 85);
+    for (const auto& message : received_messages) {
+        EXPECT_EQ(message.tag, static_cast<int32_t>(message.message_id) - 35);
+        EXPECT_EQ(message.dest, (message.message_id == 42) ? 3 : 1);
+    }
+
+    /// test: recycled chunks go back to callback_arg
+    auto arrived = false;
+    topology->send(chunk_size, 0, 3, [](void* const arg) { *static_cast<bool*>(arg) = true; }, &arrived);
+    event_queue->run_to_completion();
+    EXPECT_TRUE(arrived);
+    EXPECT_EQ(topology->get_chunk_pool().get_allocated_chunks_count(), 2);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Multicast) {
+    /// setup: broadcasts counted by a completion group, recording the time the last dest is reached
+    struct Broadcast {
+        EventQueue* event_queue;
+        EventTime finish_time;
+    };
+    const auto record_finish = [](void* const arg) {
+        auto* const broadcast = static_cast<Broadcast*>(arg);
+        broadcast->finish_time = broadcast->event_queue->get_current_time();
+    };
+    const auto all_npus_but = [](const int npus_count, const DeviceId src) {
+        auto dests = std::vector<DeviceId>();
+        for (auto npu = npus_count - 1; npu >= 0; npu--) {
+            if (npu != src) {
+                dests.push_back(npu);
+            }
+        }
+        return dests;
+    };
+
+    /// test: a Switch replicates the chunk at the switch, so the uplink is crossed once
+    const auto switch_topology = std::make_shared<Switch>(8, 50, 500);
+    const auto& star = switch_topology->multicast_tree(0, all_npus_but(8, 0));
+    const auto switch_node = star.get_children(MulticastTree::root).front();
+    EXPECT_EQ(star.get_edges_count(), 8);
+    EXPECT_EQ(star.get_dests_count(), 7);
+    EXPECT_EQ(star.get_children(MulticastTree::root).size(), 1);
+    EXPECT_EQ(star.get_device(switch_node), 8);
+    EXPECT_EQ(star.get_children(switch_node).size(), 7);
+
+    auto switch_broadcast = Broadcast{event_queue.get(), 0};
+    auto switch_group = CompletionGroup(7, record_finish, &switch_broadcast);
+    switch_topology->multicast(chunk_size, 0, all_npus_but(8, 0), CompletionGroup::chunk_arrived, &switch_group);
+    event_queue->run_to_completion();
+    const auto hop_delay = switch_topology->get_link(switch_topology->find_link(0, 8)).communication_delay(chunk_size);
+    EXPECT_TRUE(switch_group.completed());
+    EXPECT_EQ(switch_broadcast.finish_time, 2 * hop_delay);
+
+    /// test: a Mesh2D broadcast follows the XY tree, each link crossed at most once and without contention
+    const auto mesh = std::make_shared<Mesh2D>(4, 4, 50, 500);
+    const auto& xy_tree = mesh->multicast_tree(0, all_npus_but(16, 0));
+    EXPECT_EQ(xy_tree.get_edges_count(), 15);
+    EXPECT_EQ(&mesh->multicast_tree(0, all_npus_but(16, 0)), &xy_tree);
+
+    const auto start_time = event_queue->get_current_time();
+    auto mesh_broadcast = Broadcast{event_queue.get(), 0};
+    auto mesh_group = CompletionGroup(15, record_finish, &mesh_broadcast);
+    mesh->multicast(chunk_size, 0, all_npus_but(16, 0), CompletionGroup::chunk_arrived, &mesh_group);
+    event_queue->run_to_completion();
+    EXPECT_TRUE(mesh_group.completed());
+    EXPECT_EQ(mesh_broadcast.finish_time - start_time, 6 * hop_delay);
+    if constexpr (stats_enabled) {
+        EXPECT_EQ(mesh->get_chunk_stats().chunks_delivered, 15);
+        EXPECT_EQ(mesh->get_chunk_stats().hops_count, 48);
+        auto busy_links_count = 0;
+        for (auto link_id = 0; link_id < static_cast<LinkId>(mesh->get_links_count()); link_id++) {
+            const auto busy_time = mesh->get_link(link_id).get_stats().busy_time;
+            EXPECT_TRUE(busy_time == 0 || busy_time == hop_delay - ns_to_ticks(500));
+            busy_links_count += (busy_time > 0) ? 1 : 0;
+        }
+        EXPECT_EQ(busy_links_count, 15);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InNetworkReduction) {
+    /// setup: an all-reduce of an 8 MB buffer among 8 NPUs, aggregated at the switch
+    const auto npus_count = 8;
+    const auto collective_size = npus_count * chunk_size;
+    auto members = std::vector<DeviceId>();
+    for (auto npu = 0; npu < npus_count; npu++) {
+        members.push_back(npu);
+    }
+    const auto switch_topology = std::make_shared<Switch>(npus_count, 50, 500);
+    auto group = CompletionGroup(npus_count);
+    switch_topology->all_reduce(members, collective_size, CompletionGroup::chunk_arrived, &group);
+    EXPECT_EQ(switch_topology->get_active_reductions_count(), 1);
+    const auto in_network_time = event_queue->run_to_completion();
+
+    /// test: the contributions go up once, and a single result comes down each switch -> NPU link
+    const auto downlink_busy_time = [](const Switch& topology, const DeviceId npu) {
+        return topology.get_link(topology.find_link(topology.get_npus_count(), npu)).get_stats().busy_time;
+    };
+    const auto hop_delay = switch_topology->get_link(0).communication_delay(collective_size);
+    EXPECT_TRUE(group.completed());
+    EXPECT_EQ(in_network_time, 2 * hop_delay);
+    EXPECT_EQ(switch_topology->get_active_reductions_count(), 0);
+    if constexpr (stats_enabled) {
+        for (auto npu = 0; npu < npus_count; npu++) {
+            EXPECT_EQ(downlink_busy_time(*switch_topology, npu), hop_delay - ns_to_ticks(500));
+        }
+    }
+
+    /// test: the result waits for the last contribution, and finished reductions are reused
+    auto pair_group = CompletionGroup(2);
+    const auto reduction_id =
+        switch_topology->create_reduction({1, 2}, chunk_size, CompletionGroup::chunk_arrived, &pair_group);
+    EXPECT_EQ(reduction_id, 0);
+    switch_topology->contribute(reduction_id, 1);
+    event_queue->run_to_completion();
+    EXPECT_EQ(pair_group.get_remaining_chunks_count(), 2);
+    switch_topology->contribute(reduction_id, 2);
+    event_queue->run_to_completion();
+    EXPECT_TRUE(pair_group.completed());
+
+    /// test: a ring all-reduce on the same topology takes longer, sending 2(N-1) chunks down every switch -> NPU link
+    auto ring_event_queue = std::make_shared<EventQueue>();
+    Topology::set_event_queue(ring_event_queue);
+    const auto ring_topology = std::make_shared<Switch>(npus_count, 50, 500);
+    auto ring_all_reduce =
+        Collective(ring_topology, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, collective_size);
+    ring_all_reduce.start();
+    ring_event_queue->run_to_completion();
+    EXPECT_TRUE(ring_all_reduce.finished());
+    EXPECT_GT(ring_all_reduce.get_finish_time(), in_network_time);
+    if constexpr (stats_enabled) {
+        EXPECT_GT(downlink_busy_time(*ring_topology, 0), downlink_busy_time(*switch_topology, 0));
+    }
+    Topology::set_event_queue(event_queue);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TrafficSource) {
+    /// setup: an all-to-all on a 16-NPU ring, pulled by each NPU with a window of 2 chunks
+    const auto npus_count = 16;
+    const auto chunks_count = 4;
+    const auto window_size = 2;
+    const auto topology = std::make_shared<Ring>(npus_count, 50, 500);
+    auto injector = TrafficInjector(topology, window_size);
+    for (auto npu = 0; npu < npus_count; npu++) {
+        injector.set_source(npu, std::make_unique<AllToAllSource>(npu, npus_count, chunk_size, chunks_count));
+    }
+    auto finished = false;
+    injector.start([](void* const arg) { *static_cast<bool*>(arg) = true; }, &finished);
+    EXPECT_EQ(injector.get_peak_in_flight_chunks_count(), npus_count * window_size);
+    event_queue->run_to_completion();
+
+    /// test: every chunk is delivered, with at most a window of chunks per NPU alive at once
+    const auto chunks_total = static_cast<uint64_t>(npus_count) * (npus_count - 1) * chunks_count;
+    EXPECT_TRUE(finished);
+    EXPECT_TRUE(injector.finished());
+    EXPECT_EQ(injector.get_delivered_chunks_count(), chunks_total);
+    EXPECT_EQ(injector.get_finish_time(), event_queue->get_current_time());
+    EXPECT_EQ(injector.get_peak_in_flight_chunks_count(), npus_count * window_size);
+
+    // (a delivered chunk is recycled right after its callback pulled the next one)
+    EXPECT_LE(topology->get_chunk_pool().get_allocated_chunks_count(), npus_count * window_size + 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SyntheticTraffic) {
+    /// setup: 16 NPUs viewed as a 4x4 grid
+    const auto npus_count = 16;
+    auto config = SyntheticTrafficConfig();
+    auto traffic_of = [&](const TrafficPattern pattern) {
+        config.pattern = pattern;
+        return SyntheticTraffic(std::make_shared<Ring>(npus_count, 50, 500), config);
+    };
+
+    /// test: pattern dests
+    EXPECT_EQ(traffic_of(TrafficPattern::Transpose).pick_dest(1), 4);
+    EXPECT_EQ(traffic_of(TrafficPattern::BitComplement).pick_dest(0), 15);
+    EXPECT_EQ(traffic_of(TrafficPattern::Tornado).pick_dest(0), 5);
+    auto uniform_traffic = traffic_of(TrafficPattern::UniformRandom);
+    for (auto i = 0; i < 100; i++) {
+        const auto dest = uniform_traffic.pick_dest(3);
+        EXPECT_NE(dest, 3);
+        EXPECT_TRUE(0 <= dest && dest < npus_count);
+    }
+
+    /// setup: load-latency sweep of uniform random traffic on the ring
+    config.pattern = TrafficPattern::UniformRandom;
+    config.injection_bandwidth = 50;
+    config.chunk_size = 1'024;
+    config.warmup_time = ns_to_ticks(20'000);
+    config.measure_time = ns_to_ticks(100'000);
+    const auto curve = SyntheticTraffic::sweep_load(
+        [] { return std::make_shared<Ring>(16, 50, 500); }, config, {0.9, 0.1, 0.3}, 3.0, 2);
+    Topology::set_event_queue(event_queue);
+
+    /// test: accepted load follows the offered load until the ring (bisection 4 links for 16 NPUs) saturates
+    ASSERT_EQ(curve.points.size(), 3);
+    EXPECT_DOUBLE_EQ(curve.points[0].offered_load, 0.1);
+    EXPECT_NEAR(curve.points[0].accepted_load, 0.1, 0.02);
+    EXPECT_GT(curve.points[0].measured_chunks_count, 0);
+    EXPECT_GT(curve.points[0].mean_latency, 0);
+    EXPECT_LT(curve.points[2].accepted_load, 0.9);
+    EXPECT_GT(curve.points[2].mean_latency, curve.points[0].mean_latency);
+    EXPECT_DOUBLE_EQ(curve.saturation_load, 0.9);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, FlowSampling) {
+    /// setup: exact all-to-all of 64 KB flows among 32 NPUs of a switch
+    const auto npus_count = 32;
+    const auto flow_size = ChunkSize(65'536);
+    const auto switch_factory = [] { return std::make_shared<Switch>(32, 50, 500); };
+    auto topology = switch_factory();
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                topology->send(flow_size, src, dest, callback, nullptr);
+            }
+        }
+    }
+    const auto exact_finish_time = static_cast<double>(event_queue->run_to_completion());
+
+    /// test: sampled dests are distinct, sorted, and never the src
+    auto random_engine = std::mt19937_64(0);
+    const auto dests = FlowSampling::sample_dests(npus_count, 5, 10, random_engine);
+    ASSERT_EQ(dests.size(), 10);
+    EXPECT_TRUE(std::is_sorted(dests.begin(), dests.end()));
+    EXPECT_EQ(std::adjacent_find(dests.begin(), dests.end()), dests.end());
+    EXPECT_EQ(std::count(dests.begin(), dests.end(), 5), 0);
+
+    /// test: sampling every flow is exact, every sample agreeing
+    auto config = FlowSamplingConfig();
+    config.sampling_fraction = 1;
+    config.replicas_count = 2;
+    const auto full = FlowSampling::estimate_all_to_all(switch_factory, flow_size, config, 2);
+    Topology::set_event_queue(event_queue);
+    EXPECT_EQ(full.flows_count, npus_count * (npus_count - 1));
+    EXPECT_EQ(full.sampled_flows_count, full.flows_count);
+    EXPECT_DOUBLE_EQ(full.finish_time.mean, exact_finish_time);
+    EXPECT_DOUBLE_EQ(full.finish_time.low, full.finish_time.high);
+
+    /// test: a quarter of the flows on links scaled down to a quarter estimates the finish time,
+    /// slightly over (the sampled flows spread the load of the downlinks)
+    config.sampling_fraction = 0.25;
+    config.replicas_count = 8;
+    const auto sampled = FlowSampling::estimate_all_to_all(switch_factory, flow_size, config, 2);
+    Topology::set_event_queue(event_queue);
+    EXPECT_EQ(sampled.sampled_flows_count, npus_count * 8);
+    EXPECT_DOUBLE_EQ(sampled.effective_fraction, 8.0 / 31);
+    EXPECT_EQ(sampled.sample_finish_times.size(), 8);
+    EXPECT_LE(sampled.finish_time.low, sampled.finish_time.mean);
+    EXPECT_LE(sampled.finish_time.mean, sampled.finish_time.high);
+    EXPECT_GE(sampled.finish_time.high, exact_finish_time);
+    EXPECT_NEAR(sampled.finish_time.mean, exact_finish_time, 0.2 * exact_finish_time);
+    EXPECT_LT(sampled.mean_flow_time.mean, sampled.finish_time.mean);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, MixedFidelity) {
+    /// setup: Ring(2) x Switch(4), both dimensions congestion-aware or the Switch in closed form
+    const auto construct_mixed_topology = [](const DimFidelity switch_fidelity) {
+        auto topology_per_dim = std::vector<std::unique_ptr<BasicTopology>>();
+        topology_per_dim.push_back(std::make_unique<Ring>(2, 200, 50));
+        topology_per_dim.push_back(std::make_unique<Switch>(4, 50, 500));
+        return std::make_shared<MultiDimTopology>(std::move(topology_per_dim),
+                                                  std::vector<DimFidelity>{DimFidelity::CongestionAware,
+                                                                           switch_fidelity});
+    };
+    const auto aware_topology = construct_mixed_topology(DimFidelity::CongestionAware);
+    const auto mixed_topology = construct_mixed_topology(DimFidelity::ClosedForm);
+
+    // the closed-form Switch drops its switches, connecting each NPU pair of a slice directly
+    EXPECT_EQ(aware_topology->get_devices_count(), 10);
+    EXPECT_EQ(mixed_topology->get_devices_count(), 8);
+    EXPECT_EQ(mixed_topology->get_dim_fidelity(1), DimFidelity::ClosedForm);
+    EXPECT_EQ(mixed_topology->route(0, 6).size(), 2);
+    EXPECT_EQ(mixed_topology->route(1, 6).size(), 3);
+    const auto& closed_form_link = mixed_topology->get_link(mixed_topology->find_link(0, 6));
+    EXPECT_TRUE(closed_form_link.is_contention_free());
+    EXPECT_EQ(mixed_topology->get_link_dim(mixed_topology->find_link(0, 6)), 1);
+    EXPECT_DOUBLE_EQ(closed_form_link.get_latency(), 1'000);
+    EXPECT_FALSE(mixed_topology->get_link(mixed_topology->find_link(0, 1)).is_contention_free());
+
+    /// run: NPUs 0, 2, and 4 send a chunk to NPU 6 at once (sharing the switch's downlink to 6)
+    struct Arrival {
+        EventQueue* event_queue;
+        EventTime time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+    };
+    const auto run_incast = [&](const std::shared_ptr<MultiDimTopology>& topology) {
+        auto incast_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(incast_event_queue);
+        auto arrivals = std::vector<Arrival>(3, {incast_event_queue.get(), 0});
+        for (auto i = 0; i < 3; i++) {
+            topology->send(chunk_size, 2 * i, 6, record_arrival, &arrivals[i]);
+        }
+        incast_event_queue->run_to_completion();
+        return arrivals;
+    };
+    const auto aware_arrivals = run_incast(aware_topology);
+    const auto mixed_arrivals = run_incast(mixed_topology);
+
+    /// test: congestion-aware chunks queue at the downlink, closed-form ones take the congestion_unaware delay
+    const auto serialization_delay = static_cast<Bandwidth>(chunk_size) / bw_GBps_to_Bpns(50);
+    const auto closed_form_delay = static_cast<EventTime>(2 * 500 + serialization_delay);
+    EXPECT_GT(aware_arrivals[2].time, closed_form_delay + serialization_delay);
+    for (const auto& arrival : mixed_arrivals) {
+        EXPECT_EQ(arrival.time, closed_form_delay);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SymmetricCollective) {
+    /// setup: 8 NPUs of each rotation-symmetric topology
+    const auto npus_count = 8;
+    const auto collective_size = npus_count * chunk_size;
+    const auto construct_symmetric_topology = [&](const TopologyBuildingBlock building_block) {
+        auto topology = std::shared_ptr<Topology>();
+        if (building_block == TopologyBuildingBlock::Ring) {
+            topology = std::make_shared<Ring>(npus_count, 50, 500);
+        } else if (building_block == TopologyBuildingBlock::FullyConnected) {
+            topology = std::make_shared<FullyConnected>(npus_count, 50, 500);
+        } else {
+            topology = std::make_shared<Switch>(npus_count, 50, 500);
+        }
+        return topology;
+    };
+
+    /// test: simulating rank 0 alone finishes with the full collective, extrapolating its messages
+    for (const auto building_block :
+         {TopologyBuildingBlock::Ring, TopologyBuildingBlock::FullyConnected, TopologyBuildingBlock::Switch}) {
+        for (const auto& [collective_type, collective_algorithm, chunks_count] :
+             {std::make_tuple(CollectiveType::AllGather, CollectiveAlgorithm::Direct, 1),
+              std::make_tuple(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 2),
+              std::make_tuple(CollectiveType::AllToAll, CollectiveAlgorithm::Ring, 1)}) {
+            auto symmetric_event_queue = std::make_shared<EventQueue>();
+            const auto topology = construct_symmetric_topology(building_block);
+            topology->attach_event_queue(symmetric_event_queue);
+
+            auto collective =
+                Collective(topology, collective_type, collective_algorithm, collective_size, chunks_count);
+            collective.set_symmetric(true);
+            collective.start();
+            symmetric_event_queue->run_to_completion();
+
+            ASSERT_TRUE(collective.finished());
+            EXPECT_GT(collective.get_finish_time(), 0);
+            EXPECT_EQ(collective.get_messages_count() % npus_count, 0);
+            EXPECT_LE(collective.get_peak_in_flight_messages_count(), (npus_count - 1) * chunks_count);
+            EXPECT_TRUE(collective.cross_check(construct_symmetric_topology(building_block)));
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ChunkCoalescing) {
+    /// setup: 4 chunks sent at once from NPU 0 to NPU dest of a unidirectional ring, recording their arrivals
+    struct Arrival {
+        EventQueue* event_queue;
+        EventTime time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+    };
+    const auto chunks_count = 4;
+    const auto run = [&](const DeviceId dest, const bool coalescing) {
+        auto coalescing_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(8, 50, 500, false);
+        topology->attach_event_queue(coalescing_event_queue);
+        topology->set_chunk_coalescing(coalescing);
+        auto arrivals = std::vector<Arrival>(chunks_count, {coalescing_event_queue.get(), 0});
+        for (auto i = 0; i < chunks_count; i++) {
+            topology->send(chunk_size, 0, dest, record_arrival, &arrivals[i]);
+        }
+        coalescing_event_queue->run_to_completion();
+
+        // the first chunk is served right away, the 3 pending ones are coalesced
+        if constexpr (stats_enabled) {
+            const auto& link_stats = topology->get_link(topology->find_link(0, 1)).get_stats();
+            EXPECT_EQ(link_stats.chunks_coalesced, coalescing ? chunks_count - 2 : 0);
+            EXPECT_EQ(link_stats.chunks_transmitted, coalescing ? 2 : chunks_count);
+        }
+        return arrivals;
+    };
+
+    /// test: over a single hop, each coalesced chunk arrives as if transmitted on its own
+    const auto one_hop_arrivals = run(1, false);
+    const auto coalesced_one_hop_arrivals = run(1, true);
+    for (auto i = 0; i < chunks_count; i++) {
+        EXPECT_EQ(coalesced_one_hop_arrivals[i].time, one_hop_arrivals[i].time);
+    }
+
+    /// test: over several hops, coalesced chunks arrive in order, no earlier than pipelined ones
+    const auto three_hop_arrivals = run(3, false);
+    const auto coalesced_three_hop_arrivals = run(3, true);
+    EXPECT_EQ(coalesced_three_hop_arrivals[0].time, three_hop_arrivals[0].time);
+    for (auto i = 1; i < chunks_count; i++) {
+        EXPECT_GT(coalesced_three_hop_arrivals[i].time, coalesced_three_hop_arrivals[i - 1].time);
+        EXPECT_GE(coalesced_three_hop_arrivals[i].time, three_hop_arrivals[i].time);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, QueueingPolicy) {
+    /// setup: 4 class-1 chunks, then 2 class-0 chunks sent at once over link 0 -> 1, recording the arrival order
+    struct Arrival {
+        std::vector<int>* arrival_order;
+        int index;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->arrival_order->push_back(arrival->index);
+    };
+    const auto run = [&](const QueueingPolicy queueing_policy, const std::vector<int>& class_weights) {
+        auto queueing_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500, false);
+        topology->attach_event_queue(queueing_event_queue);
+        topology->set_queueing_policy(queueing_policy, class_weights);
+        auto arrival_order = std::vector<int>();
+        auto arrivals = std::vector<Arrival>();
+        for (auto i = 0; i < 6; i++) {
+            arrivals.push_back({&arrival_order, i});
+        }
+        for (auto i = 0; i < 6; i++) {
+            topology->send(chunk_size, 0, 1, record_arrival, &arrivals[i], (i < 4) ? 1 : 0);
+        }
+        queueing_event_queue->run_to_completion();
+        return arrival_order;
+    };
+
+    /// test: FIFO ignores classes, strict priority serves class 0 once the link frees up,
+    /// and weighted round robin alternates turns of 1 class-0 chunk and 2 class-1 chunks
+    EXPECT_EQ(run(QueueingPolicy::FIFO, {}), std::vector<int>({0, 1, 2, 3, 4, 5}));
+    EXPECT_EQ(run(QueueingPolicy::StrictPriority, {}), std::vector<int>({0, 4, 5, 1, 2, 3}));
+    EXPECT_EQ(run(QueueingPolicy::WeightedRoundRobin, {1, 2}), std::vector<int>({0, 4, 1, 2, 5, 3}));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SourceArbitration) {
+    /// setup: on a unidirectional ring, NPU 1 injects 4 chunks to NPU 2 while NPU 0 forwards 4 more through NPU 1,
+    /// so both flows share link 1 -> 2, recording the source NPU of each arrival
+    struct Arrival {
+        std::vector<int>* arrival_sources;
+        int src;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->arrival_sources->push_back(arrival->src);
+    };
+    const auto run = [&](const bool source_arbitration) {
+        auto arbitration_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500, false);
+        topology->attach_event_queue(arbitration_event_queue);
+        topology->set_source_arbitration(source_arbitration);
+        auto arrival_sources = std::vector<int>();
+        auto arrivals = std::vector<Arrival>();
+        for (auto i = 0; i < 8; i++) {
+            arrivals.push_back({&arrival_sources, (i < 4) ? 1 : 0});
+        }
+        for (auto i = 0; i < 8; i++) {
+            topology->send(chunk_size, arrivals[i].src, 2, record_arrival, &arrivals[i]);
+        }
+        arbitration_event_queue->run_to_completion();
+        return arrival_sources;
+    };
+
+    /// test: FIFO drains NPU 1's burst first, while arbitration interleaves NPU 0's chunks once they reach NPU 1
+    EXPECT_EQ(run(false), std::vector<int>({1, 1, 1, 1, 0, 0, 0, 0}));
+    EXPECT_EQ(run(true), std::vector<int>({1, 1, 1, 0, 1, 0, 0, 0}));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkBufferBackpressure) {
+    /// setup: on a unidirectional ring, NPU 1 injects 8 chunks to NPU 2 while NPU 0 sends 4 chunks to NPU 2,
+    /// then 4 chunks to NPU 1, recording when the NPU 0 -> 1 chunks (which don't need link 1 -> 2) finish
+    struct Delivery {
+        EventQueue* event_queue;
+        int chunks_count;
+        EventTime finish_time;
+    };
+    const auto record_delivery = [](void* const arg) {
+        auto* const delivery = static_cast<Delivery*>(arg);
+        delivery->chunks_count++;
+        delivery->finish_time = delivery->event_queue->get_current_time();
+    };
+    const auto run = [&](const ChunkSize buffer_capacity) {
+        auto buffer_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500, false);
+        topology->attach_event_queue(buffer_event_queue);
+        topology->set_link_buffer_capacity(buffer_capacity);
+        auto shared_flow = Delivery{buffer_event_queue.get(), 0, 0};
+        auto local_flow = Delivery{buffer_event_queue.get(), 0, 0};
+        for (auto i = 0; i < 8; i++) {
+            topology->send(chunk_size, 1, 2, record_delivery, &shared_flow);
+        }
+        for (auto i = 0; i < 4; i++) {
+            topology->send(chunk_size, 0, 2, record_delivery, &shared_flow);
+        }
+        for (auto i = 0; i < 4; i++) {
+            topology->send(chunk_size, 0, 1, record_delivery, &local_flow);
+        }
+        buffer_event_queue->run_to_completion();
+        EXPECT_EQ(shared_flow.chunks_count, 12);
+        EXPECT_EQ(local_flow.chunks_count, 4);
+        const auto& upstream_link = topology->get_link(topology->find_link(0, 1));
+        return std::make_pair(local_flow.finish_time, upstream_link.get_stats().backpressure_time);
+    };
+
+    /// test: with a single-chunk buffer, link 0 -> 1 holds NPU 0's chunks back until link 1 -> 2 takes them,
+    /// blocking the NPU 0 -> 1 chunks queued behind them (head-of-line blocking)
+    const auto [unbounded_finish_time, unbounded_backpressure_time] = run(0);
+    const auto [bounded_finish_time, bounded_backpressure_time] = run(chunk_size);
+    EXPECT_EQ(unbounded_backpressure_time, 0);
+    EXPECT_GT(bounded_backpressure_time, 0);
+    EXPECT_GT(bounded_finish_time, unbounded_finish_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, NicModel) {
+    /// setup: NPU 0 sends 8 chunks to NPU 1 at once over a dedicated link, recording the finish time
+    const auto run = [&](const Bandwidth injection_bandwidth, const int max_outstanding_chunks,
+                         const int dma_engines_count) {
+        auto nic_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<FullyConnected>(4, 50, 500);
+        topology->attach_event_queue(nic_event_queue);
+        topology->set_nic_model(injection_bandwidth, max_outstanding_chunks, dma_engines_count);
+        auto arrivals_count = 0;
+        const auto count_arrival = [](void* const arg) {
+            (*static_cast<int*>(arg))++;
+        };
+        for (auto i = 0; i < 8; i++) {
+            topology->send(chunk_size, 0, 1, count_arrival, &arrivals_count);
+        }
+        nic_event_queue->run_to_completion();
+        EXPECT_EQ(arrivals_count, 8);
+        if (topology->get_nic_model() != nullptr) {
+            EXPECT_EQ(topology->get_nic_model()->get_outstanding_chunks_count(0), 0);
+        }
+        return nic_event_queue->get_current_time();
+    };
+
+    /// test: a single outstanding chunk adds the link latency between consecutive chunks,
+    /// a NIC slower than the link bounds the throughput,
+    /// and engines sharing its bandwidth finish moving their chunks later, pipelining less with the link
+    const auto unmetered_time = run(0, 0, 1);
+    EXPECT_EQ(run(0, 1, 1) - unmetered_time, 7 * 500 * ticks_per_ns);
+    const auto nic_bound_time = run(25, 0, 1);
+    EXPECT_GT(nic_bound_time, unmetered_time);
+    EXPECT_GT(run(25, 0, 4), nic_bound_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkChannels) {
+    /// setup: NPU 0 sends chunks_count chunks to NPU 1 at once over a ring link, recording the finish time
+    const auto run = [&](const int chunks_count, const int channels_count, const ChannelMode channel_mode) {
+        auto channel_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500);
+        topology->attach_event_queue(channel_event_queue);
+        topology->set_dim_channels(0, channels_count, channel_mode);
+        auto arrivals_count = 0;
+        const auto count_arrival = [](void* const arg) {
+            (*static_cast<int*>(arg))++;
+        };
+        for (auto i = 0; i < chunks_count; i++) {
+            topology->send(chunk_size, 0, 1, count_arrival, &arrivals_count);
+        }
+        channel_event_queue->run_to_completion();
+        EXPECT_EQ(arrivals_count, chunks_count);
+        return channel_event_queue->get_current_time();
+    };
+
+    /// test: 2 channels halve the serialization of a stream of chunks, striped or not,
+    /// but a single chunk only gets both channels' bandwidth if striped
+    const auto latency_ticks = 500 * ticks_per_ns;
+    const auto single_channel_time = run(4, 1, ChannelMode::Striped);
+    const auto striped_time = run(4, 2, ChannelMode::Striped);
+    const auto per_chunk_time = run(4, 2, ChannelMode::PerChunk);
+    EXPECT_NEAR(striped_time - latency_ticks, (single_channel_time - latency_ticks) / 2, 2);
+    EXPECT_NEAR(per_chunk_time - latency_ticks, (single_channel_time - latency_ticks) / 2, 2);
+    const auto single_chunk_time = run(1, 1, ChannelMode::Striped);
+    EXPECT_NEAR(run(1, 2, ChannelMode::Striped) - latency_ticks, (single_chunk_time - latency_ticks) / 2, 2);
+    EXPECT_EQ(run(1, 2, ChannelMode::PerChunk), single_chunk_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, MultiRail) {
+    // 4 NPUs (0 - 3), 2 rails: NICs 4 - 11 (NPU i's NIC on rail r is 4 + 2i + r), rail switches 12 and 13
+    const auto topology = std::make_shared<MultiRail>(4, 2, 50, 500);
+    EXPECT_EQ(topology->get_basic_topology_type(), TopologyBuildingBlock::MultiRail);
+    EXPECT_EQ(topology->get_devices_count(), 14);
+    EXPECT_EQ(topology->get_nic(1, 1), 7);
+    EXPECT_EQ(topology->get_rail_switch(1), 13);
+
+    // test: a chunk stays on a single rail, the hashed one by default
+    const auto rail = topology->hashed_rail(0, 3);
+    EXPECT_EQ(topology->route(0, 3), (Route{0, 4 + rail, 12 + rail, 10 + rail, 3}));
+    EXPECT_EQ(*topology->select_route(0, 3, 1), topology->route(0, 3));
+
+    // test: sprayed chunks take the rails in turn
+    topology->set_routing(RailRouting::Sprayed);
+    EXPECT_EQ(*topology->select_route(0, 3, 0), (Route{0, 4, 12, 10, 3}));
+    EXPECT_EQ(*topology->select_route(0, 3, 1), (Route{0, 5, 13, 11, 3}));
+
+    /// setup: NPU 0 sends 8 chunks to NPU 3 at once, recording the finish time
+    const auto run = [&](const RailRouting routing) {
+        auto rail_event_queue = std::make_shared<EventQueue>();
+        auto network_parser = NetworkParser("../../input/MultiRail.yml");
+        const auto multi_rail = std::dynamic_pointer_cast<MultiRail>(construct_topology(network_parser));
+        EXPECT_NE(multi_rail, nullptr);
+        EXPECT_EQ(multi_rail->get_rails_count(), 4);
+        EXPECT_EQ(multi_rail->get_routing(), RailRouting::Sprayed);
+        multi_rail->attach_event_queue(rail_event_queue);
+        multi_rail->set_routing(routing);
+        auto arrivals_count = 0;
+        const auto count_arrival = [](void* const arg) {
+            (*static_cast<int*>(arg))++;
+        };
+        for (auto i = 0; i < 8; i++) {
+            multi_rail->send(chunk_size, 0, 3, count_arrival, &arrivals_count);
+        }
+        rail_event_queue->run_to_completion();
+        EXPECT_EQ(arrivals_count, 8);
+        return rail_event_queue->get_current_time();
+    };
+
+    /// test: spraying a pair's chunks over the 4 rails serializes them 4 times faster than a single rail
+    const auto hashed_time = run(RailRouting::Hashed);
+    const auto sprayed_time = run(RailRouting::Sprayed);
+    EXPECT_LT(sprayed_time, hashed_time);
+    EXPECT_NEAR(hashed_time - sprayed_time, 6 * 19'531 * ticks_per_ns, 8 * ticks_per_ns);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkFailure) {
+    /// setup: NPU 0 sends chunks_count chunks to NPU 1 of a bidirectional ring at once (the link 0 -> 1 failing
+    /// at failure_time if failed), recording the finish time
+    const auto run = [&](const int chunks_count, const bool failed, const EventTime failure_time) {
+        auto failure_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500);
+        topology->attach_event_queue(failure_event_queue);
+        if (failed && failure_time == 0) {
+            topology->set_link_failed(0, 1, true);
+        } else if (failed) {
+            topology->schedule_link_failure(failure_time, 0, 1, true);
+        }
+        auto arrivals_count = 0;
+        const auto count_arrival = [](void* const arg) {
+            (*static_cast<int*>(arg))++;
+        };
+        for (auto i = 0; i < chunks_count; i++) {
+            topology->send(chunk_size, 0, 1, count_arrival, &arrivals_count);
+        }
+        failure_event_queue->run_to_completion();
+        EXPECT_EQ(arrivals_count, chunks_count);
+        EXPECT_EQ(topology->get_failed_links_count(), failed ? 1 : 0);
+        return failure_event_queue->get_current_time();
+    };
+
+    /// test: a chunk sent after the failure goes the other way around the ring (3 hops),
+    /// and chunks pending at the link as it fails are rerouted, while the one in transmission still arrives
+    EXPECT_EQ(run(1, true, 0), 3 * 20'031 * ticks_per_ns);
+    EXPECT_EQ(run(1, false, 0), 20'031 * ticks_per_ns);
+    EXPECT_EQ(run(4, true, 1'000 * ticks_per_ns), (1'000 + 3 * 19'531 + 500 + 2 * 20'031) * ticks_per_ns);
+
+    // test: a failed device is routed around in a sparse mesh, and restoring it brings the shortest route back
+    auto mesh = std::make_shared<SparseMesh2D>(3, 3, std::set<std::pair<int, int>>(), 50, 500);
+    mesh->set_device_failed(1, true);
+    EXPECT_EQ(mesh->get_failed_links_count(), 6);
+    EXPECT_EQ(mesh->compute_route(0, 2), (Route{0, 3, 4, 5, 2}));
+    mesh->send(chunk_size, 0, 2, callback, nullptr);
+    EXPECT_EQ(event_queue->run_to_completion(), 4 * 20'031 * ticks_per_ns);
+    mesh->set_device_failed(1, false);
+    EXPECT_EQ(mesh->compute_route(0, 2), (Route{0, 1, 2}));
+
+    // test: the next-hop tables of a custom topology are repaired for the failed rail link, then restored
+    auto custom = std::make_shared<CustomTopology>("../../input/Custom.csv", 8, 50, 500);
+    const auto rail_route = custom->compute_route(0, 4);
+    EXPECT_EQ(rail_route, (Route{0, 8, 4}));
+    custom->set_link_failed(8, 4, true);
+    const auto detour = custom->compute_route(0, 4);
+    EXPECT_EQ(detour.front(), 0);
+    EXPECT_EQ(detour.back(), 4);
+    for (auto hop = size_t(0); hop + 1 < detour.size(); hop++) {
+        EXPECT_FALSE(detour[hop] == 8 && detour[hop + 1] == 4);
+    }
+    custom->set_link_failed(8, 4, false);
+    EXPECT_EQ(custom->compute_route(0, 4), rail_route);
+
+    // test: a chunk cut off from its destination waits for the scheduled restore
+    const auto start_time = event_queue->get_current_time();
+    auto ring = std::make_shared<Ring>(4, 50, 500);
+    ring->set_device_failed(1, true);
+    ring->schedule_device_failure(start_time + 10'000 * ticks_per_ns, 1, false);
+    ring->send(chunk_size, 0, 1, callback, nullptr);
+    EXPECT_EQ(event_queue->run_to_completion() - start_time, (10'000 + 20'031) * ticks_per_ns);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, OpticalCircuitSwitch) {
+    /// setup: 4 NPUs of a single port each, with circuits 0 -> 1 -> 2 -> 3 -> 0 and a 10 us reconfiguration delay
+    using Circuits = std::vector<OpticalCircuitSwitch::Circuit>;
+    const auto ring = Circuits({{0, 1}, {1, 2}, {2, 3}, {3, 0}});
+    const auto pairs = Circuits({{0, 2}, {2, 0}, {1, 3}, {3, 1}});
+    auto topology = std::make_shared<OpticalCircuitSwitch>(4, 1, 50, 500, 10'000, ring);
+
+    // arrival time of each chunk
+    struct Arrival {
+        EventQueue* event_queue;
+        EventTime time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+    };
+
+    // test: chunks follow the circuits, every other link being dark
+    EXPECT_EQ(topology->get_failed_links_count(), 12 - 4);
+    EXPECT_EQ(topology->get_hops_count(0, 2), 2);
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    EXPECT_EQ(event_queue->run_to_completion(), 2 * 20'031 * ticks_per_ns);
+
+    // test: a chunk sent during the blackout waits for the new circuits, then takes the direct one
+    auto start_time = event_queue->get_current_time();
+    topology->reconfigure(pairs);
+    EXPECT_TRUE(topology->is_reconfiguring());
+    EXPECT_EQ(topology->get_circuits(), Circuits({{0, 2}, {1, 3}, {2, 0}, {3, 1}}));
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    EXPECT_EQ(event_queue->run_to_completion() - start_time, (10'000 + 20'031) * ticks_per_ns);
+    EXPECT_FALSE(topology->is_reconfiguring());
+    EXPECT_EQ(topology->get_hops_count(0, 2), 1);
+
+    // test: at a scheduled reconfiguration back to the ring, the chunk transmitting over a torn down circuit
+    // still arrives, while the one waiting for that circuit and the one cut off from its destination
+    // wait for the ring to light up, the latter (stranded first) taking circuit 0 -> 1 first
+    start_time = event_queue->get_current_time();
+    topology->schedule_reconfiguration(start_time + 5'000 * ticks_per_ns, ring);
+    auto arrivals = std::vector<Arrival>(3, Arrival{event_queue.get(), 0});
+    topology->send(chunk_size, 0, 2, record_arrival, &arrivals[0]);
+    topology->send(chunk_size, 0, 2, record_arrival, &arrivals[1]);
+    topology->send(chunk_size, 0, 1, record_arrival, &arrivals[2]);
+    event_queue->run_to_completion();
+    EXPECT_EQ(arrivals[0].time - start_time, 20'031 * ticks_per_ns);
+    EXPECT_EQ(arrivals[1].time - start_time, (15'000 + 19'531 + 2 * 20'031) * ticks_per_ns);
+    EXPECT_EQ(arrivals[2].time - start_time, (15'000 + 20'031) * ticks_per_ns);
+    EXPECT_EQ(topology->get_reconfigurations_count(), 2);
+    EXPECT_EQ(topology->get_hops_count(0, 2), 2);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, JobAccounting) {
+    /// setup: two jobs share the link 0 -> 1 of a ring, job 0 sending two chunks and job 1 (batched) one after them
+    auto topology = std::make_shared<Ring>(4, 50, 500);
+    topology->set_job_accounting(true);
+    topology->send(chunk_size, 0, 1, callback, nullptr, 0, 0);
+    topology->send(chunk_size, 0, 1, callback, nullptr, 0, 0);
+    const auto descriptor = ChunkDescriptor{0, 1, chunk_size, callback, nullptr, 0, 1};
+    topology->send_batch(&descriptor, 1);
+    event_queue->run_to_completion();
+
+    /// test: each job is accounted its own chunks, bytes, and completion time
+    const auto& job_stats = topology->get_job_stats();
+    ASSERT_EQ(job_stats.size(), 2);
+    EXPECT_EQ(job_stats[0].chunks_delivered, 2);
+    EXPECT_EQ(job_stats[0].bytes_delivered, 2 * chunk_size);
+    EXPECT_EQ(job_stats[0].completion_time(), (20'031 + 19'531) * ticks_per_ns);
+    EXPECT_EQ(job_stats[1].chunks_delivered, 1);
+    EXPECT_EQ(job_stats[1].completion_time(), (20'031 + 2 * 19'531) * ticks_per_ns);
+
+    /// test: job 1 alone would take a single hop, so sharing the link slows it down by the chunks of job 0
+    const auto isolated_time = 20'031 * ticks_per_ns;
+    EXPECT_DOUBLE_EQ(job_stats[1].slowdown(isolated_time), (20'031.0 + 2 * 19'531) / 20'031);
+
+    /// test: a reset clears the accounting
+    topology->reset();
+    EXPECT_TRUE(topology->get_job_stats().empty());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SparseMesh2DRingOrder) {
+    // 6x4 grid with a 2x2 hole in the middle
+    const auto config = std::string("topology: [ Mesh2D ]\nnpus_count: [ 20 ]\nwidth: 6\nheight: 4\n"
+                                    "bandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\nexcluded: [ [2, 1, 3, 2] ]\n");
+    const auto total_dilation = [](const NetworkParser& network_parser) {
+        const auto dilations = network_parser.get_ring_dilations();
+        EXPECT_EQ(dilations.size(), 20);
+        return std::accumulate(dilations.begin(), dilations.end(), 0);
+    };
+    const auto snake_parser = NetworkParser(YAML::Load(config + "npu_placement: Snake\n"));
+    const auto ring_parser = NetworkParser(YAML::Load(config + "npu_placement: RingOrder\n"));
+
+    // test: the searched order closes the ring around the hole with every NPU next to the following one
+    EXPECT_GT(total_dilation(snake_parser), 20);
+    EXPECT_EQ(total_dilation(ring_parser), 20);
+    const auto topology = std::dynamic_pointer_cast<SparseMesh2D>(construct_topology(ring_parser));
+    ASSERT_NE(topology, nullptr);
+    for (auto npu = 0; npu < 20; npu++) {
+        const auto [x, y] = topology->get_coords(npu);
+        const auto [next_x, next_y] = topology->get_coords((npu + 1) % 20);
+        EXPECT_EQ(std::abs(x - next_x) + std::abs(y - next_y), 1);
+    }
+
+    // test: the placement is written out as explicit entries, giving the same grid
+    const auto config_path = std::string("ring_order.yml");
+    const auto placed_path = std::string("ring_order_placed.yml");
+    {
+        auto config_file = std::ofstream(config_path);
+        config_file << config << "npu_placement: RingOrder\n";
+    }
+    ASSERT_TRUE(NetworkParser::save_npu_placement(config_path, placed_path));
+    const auto placed_parser = NetworkParser(placed_path);
+    EXPECT_EQ(placed_parser.get_placement_pattern(), PlacementPattern::Explicit);
+    EXPECT_EQ(placed_parser.get_npu_placement_grid(), ring_parser.get_npu_placement_grid());
+    std::remove(config_path.c_str());
+    std::remove(placed_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SimulationService) {
+    auto simulation_service = SimulationService();
+    auto server = QueryServer("/tmp/network_analytical_simulation_service.sock",
+                              [&simulation_service](const std::string& request) {
+                                  return simulation_service.answer(request);
+                              });
+    server.start();
+
+    // two chunks contending for the 0->1 link of a 16-NPU ring, and a third one not
+    auto query = ChunkQuery();
+    query.config_path = "../../input/Ring.yml";
+    query.srcs = {0, 0, 5};
+    query.dests = {1, 1, 6};
+    query.chunk_sizes = {chunk_size, chunk_size, chunk_size};
+
+    // test: every request is simulated from time 0, so repeating it gives the same delivery times
+    auto client = QueryClient("/tmp/network_analytical_simulation_service.sock");
+    for (auto request_id = 0; request_id < 2; request_id++) {
+        auto delivery_times = std::vector<EventTime>();
+        ASSERT_TRUE(ChunkQuery::decode_answer(client.query(query.encode()), delivery_times));
+        ASSERT_EQ(delivery_times.size(), 3);
+        EXPECT_EQ(delivery_times[0], 20031 * ticks_per_ns);
+        EXPECT_EQ(delivery_times[1], (20031 + 19531) * ticks_per_ns);
+        EXPECT_EQ(delivery_times[2], 20031 * ticks_per_ns);
+    }
+    EXPECT_EQ(simulation_service.get_topologies_count(), 1);
+    EXPECT_EQ(server.get_requests_count(), 2);
+    EXPECT_EQ(server.get_cache_hits_count(), 0);
+
+    // test: invalid NPU IDs get an empty answer
+    query.srcs[2] = -1;
+    EXPECT_TRUE(client.query(query.encode()).empty());
+
+    server.stop();
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CApi) {
+    EXPECT_EQ(analytical_aware_api_version(), ANALYTICAL_AWARE_API_VERSION);
+    EXPECT_EQ(analytical_aware_create("../../input/Missing.yml"), nullptr);
+
+    auto* const simulation = analytical_aware_create("../../input/Ring.yml");
+    ASSERT_NE(simulation, nullptr);
+    EXPECT_EQ(analytical_aware_npus_count(simulation), 16);
+
+    // two chunks contending for the 0->1 link, and a third one not
+    const int32_t srcs[] = {0, 0, 5};
+    const int32_t dests[] = {1, 1, 6};
+    const uint64_t chunk_sizes[] = {chunk_size, chunk_size, chunk_size};
+    const uint64_t tags[] = {10, 11, 12};
+    const int32_t invalid_srcs[] = {0, 16, 5};
+    EXPECT_EQ(analytical_aware_send_batch(simulation, invalid_srcs, dests, chunk_sizes, tags, 3), -1);
+    ASSERT_EQ(analytical_aware_send_batch(simulation, srcs, dests, chunk_sizes, tags, 3), 0);
+
+    // test: stepping to the first deliveries reports them, in delivery order
+    const auto first_delivery_time = EventTime(20031 * ticks_per_ns);
+    while (analytical_aware_next_event_time(simulation) < first_delivery_time) {
+        ASSERT_EQ(analytical_aware_step(simulation), 0);
+    }
+    ASSERT_EQ(analytical_aware_step(simulation), 0);
+    EXPECT_EQ(analytical_aware_current_time(simulation), first_delivery_time);
+    uint64_t polled_tags[4];
+    uint64_t delivery_times[4];
+    ASSERT_EQ(analytical_aware_poll(simulation, polled_tags, delivery_times, 1), 1);
+    ASSERT_EQ(analytical_aware_poll(simulation, polled_tags + 1, delivery_times + 1, 4), 1);
+    EXPECT_EQ(std::min(polled_tags[0], polled_tags[1]), 10);
+    EXPECT_EQ(std::max(polled_tags[0], polled_tags[1]), 12);
+    EXPECT_EQ(delivery_times[0], first_delivery_time);
+    EXPECT_EQ(delivery_times[1], first_delivery_time);
+    EXPECT_EQ(analytical_aware_poll(simulation, polled_tags, delivery_times, 4), 0);
+
+    // test: the contending chunk is delivered a serialization later
+    EXPECT_EQ(analytical_aware_run_to_completion(simulation), (20031 + 19531) * ticks_per_ns);
+    ASSERT_EQ(analytical_aware_poll(simulation, polled_tags, delivery_times, 4), 1);
+    EXPECT_EQ(polled_tags[0], 11);
+    EXPECT_EQ(analytical_aware_step(simulation), -1);
+
+    // test: a reset simulation starts over from time 0, reusing the slots of the chunks
+    analytical_aware_reset(simulation);
+    EXPECT_EQ(analytical_aware_current_time(simulation), 0);
+    ASSERT_EQ(analytical_aware_send(simulation, 5, 6, chunk_size, 20), 0);
+    analytical_aware_run_until(simulation, first_delivery_time);
+    ASSERT_EQ(analytical_aware_poll(simulation, polled_tags, delivery_times, 4), 1);
+    EXPECT_EQ(polled_tags[0], 20);
+    EXPECT_EQ(delivery_times[0], first_delivery_time);
+
+    analytical_aware_destroy(simulation);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ResultCache) {
+    const auto all_gather = [](Topology& topology) {
+        const auto npus_count = topology.get_npus_count();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology.send(1'048'576, i, j, callback, nullptr);
+                }
+            }
+        }
+    };
+
+    // test: the config hash depends on the parsed values only, not on how they were given
+    auto network_parsers = Sweep::parameter_grid("Ring", {16, 8}, {50.0}, {500.0});
+    const auto yml_parser = NetworkParser("../../input/Ring.yml");
+    EXPECT_EQ(network_parsers[0].get_config_hash(), yml_parser.get_config_hash());
+    EXPECT_NE(network_parsers[1].get_config_hash(), yml_parser.get_config_hash());
+
+    const auto cache_directory = std::string("result_cache_test");
+    std::filesystem::remove_all(cache_directory);
+    const auto result_cache = std::make_shared<ResultCache>(cache_directory);
+    auto sweep = Sweep(network_parsers);
+    sweep.set_result_cache(result_cache, "all_gather/1048576");
+
+    // test: a sweep simulates the points missing from the cache only
+    const auto results = sweep.run(all_gather, 2);
+    EXPECT_FALSE(results[0].cached);
+    EXPECT_EQ(results[0].finish_time, 704'116);
+    const auto cached_results = sweep.run(all_gather, 2);
+    for (auto i = 0; i < 2; i++) {
+        EXPECT_TRUE(cached_results[i].cached);
+        EXPECT_EQ(cached_results[i].finish_time, results[i].finish_time);
+    }
+
+    // test: results are keyed by workload, and read back with their stats
+    const auto key = ResultCache::make_key(yml_parser, "all_gather/1048576");
+    auto cached_result = CachedResult();
+    ASSERT_TRUE(result_cache->lookup(key, cached_result));
+    EXPECT_EQ(cached_result.finish_time, 704'116);
+    EXPECT_FALSE(result_cache->lookup(ResultCache::make_key(yml_parser, "all_gather/2097152"), cached_result));
+    auto simulations_count = 0;
+    const auto simulate = [&simulations_count]() {
+        simulations_count++;
+        auto result = CachedResult();
+        result.finish_time = 42;
+        result.stats["chunks_delivered"] = 7;
+        return result;
+    };
+    const auto other_key = ResultCache::make_key(yml_parser, "other");
+    EXPECT_EQ(result_cache->get_or_simulate(other_key, simulate).finish_time, 42);
+    EXPECT_EQ(result_cache->get_or_simulate(other_key, simulate).stats.at("chunks_delivered"), 7);
+    EXPECT_EQ(simulations_count, 1);
+    EXPECT_EQ(result_cache->get_hits_count(), 1);
+    EXPECT_EQ(result_cache->get_misses_count(), 1);
+
+    std::filesystem::remove_all(cache_directory);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, DistributedSweep) {
+    const auto all_gather = [](Topology& topology) {
+        const auto npus_count = topology.get_npus_count();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    topology.send(1'048'576, i, j, callback, nullptr);
+                }
+            }
+        }
+    };
+    const auto sweep = Sweep(Sweep::parameter_grid("Ring", {4, 8, 16}, {50.0, 100.0}, {500.0, 1000.0}));
+    const auto local_results = sweep.run(all_gather, 2);
+
+    // two workers pulling the points of a coordinator on any free port
+    auto coordinator = SweepCoordinator(sweep, 0);
+    const auto port = coordinator.get_port();
+    auto worker_points_counts = std::vector<int>(2);
+    auto workers = std::vector<std::thread>();
+    for (auto worker_id = 0; worker_id < 2; worker_id++) {
+        workers.emplace_back([&, worker_id]() {
+            const auto worker_sweep = Sweep(Sweep::parameter_grid("Ring", {4, 8, 16}, {50.0, 100.0}, {500.0, 1000.0}));
+            worker_points_counts[worker_id] = worker_sweep.run_worker("localhost", port, all_gather, worker_id + 1);
+        });
+    }
+    const auto results = coordinator.run();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // test: every point is simulated once, and the merged table matches a local run
+    EXPECT_EQ(worker_points_counts[0] + worker_points_counts[1], sweep.get_points_count());
+    ASSERT_EQ(results.size(), local_results.size());
+    for (auto i = 0; i < static_cast<int>(results.size()); i++) {
+        EXPECT_EQ(results[i].point_id, i);
+        EXPECT_EQ(results[i].npus_count, local_results[i].npus_count);
+        EXPECT_EQ(results[i].finish_time, local_results[i].finish_time);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, DistributedSimulation) {
+    // sequential reference: an all-to-all, plus chunks forwarded by callbacks
+    const auto sequential_topology = std::make_shared<Mesh2D>(8, 8, 50, 500);
+    const auto sequential_event_queue = std::make_shared<EventQueue>();
+    sequential_topology->attach_event_queue(sequential_event_queue);
+    const auto npus_count = sequential_topology->get_npus_count();
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                sequential_topology->send(chunk_size, src, dest, callback, nullptr);
+            }
+        }
+    }
+    auto forwarded_chunks = std::vector<ForwardedChunk>();
+    for (auto npu = 0; npu < npus_count; npu++) {
+        forwarded_chunks.push_back({sequential_topology.get(), nullptr, chunk_size / 4, npu, 8});
+    }
+    for (auto& forwarded_chunk : forwarded_chunks) {
+        forward_chunk(&forwarded_chunk);
+    }
+    sequential_event_queue->run_to_completion();
+    const auto sequential_finish_time = sequential_event_queue->get_current_time();
+
+    // the same on 4 ranks: the tag of a forwarded chunk is the number of forwards left (0: all-to-all chunks)
+    constexpr auto ranks_count = 4;
+    auto finish_times = std::vector<EventTime>(ranks_count);
+    auto delivered_counts = std::vector<int64_t>(ranks_count, 0);
+    auto migrated_counts = std::vector<int64_t>(ranks_count, 0);
+    const auto simulate = [&](DistributedSimulation& simulation) {
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    simulation.send(chunk_size, src, dest, 0);
+                }
+            }
+        }
+        for (auto npu = 0; npu < npus_count; npu++) {
+            const auto dest = (npu % 2 == 0) ? (npu + 9) % npus_count : (npu + npus_count - 5) % npus_count;
+            simulation.send(chunk_size / 4, npu, dest, 7);
+        }
+        finish_times[simulation.get_rank()] = simulation.run();
+        migrated_counts[simulation.get_rank()] = simulation.get_migrated_chunks_count();
+    };
+    const auto make_simulation = [&](const int rank, const uint16_t port) {
+        // the handler forwards through the simulation it's handed to
+        const auto simulation_ptr = std::make_shared<DistributedSimulation*>(nullptr);
+        const auto handler = [&, rank, simulation_ptr](const DeviceId device, const uint64_t tag) {
+            delivered_counts[rank]++;
+            if (tag > 0) {
+                const auto dest =
+                    (device % 2 == 0) ? (device + 9) % npus_count : (device + npus_count - 5) % npus_count;
+                (*simulation_ptr)->send(chunk_size / 4, device, dest, tag - 1);
+            }
+        };
+        auto simulation = std::make_unique<DistributedSimulation>(std::make_shared<Mesh2D>(8, 8, 50, 500), rank,
+                                                                   ranks_count, "localhost", port, handler);
+        *simulation_ptr = simulation.get();
+        return simulation;
+    };
+
+    const auto root_simulation = make_simulation(0, 0);
+    const auto port = root_simulation->get_port();
+    auto ranks = std::vector<std::thread>();
+    for (auto rank = 1; rank < ranks_count; rank++) {
+        ranks.emplace_back([&, rank]() {
+            const auto simulation = make_simulation(rank, port);
+            simulate(*simulation);
+        });
+    }
+    simulate(*root_simulation);
+    for (auto& rank : ranks) {
+        rank.join();
+    }
+
+    // test: every rank agrees with the sequential simulation, and chunks crossed ranks
+    EXPECT_GT(root_simulation->get_lookahead(), 0);
+    EXPECT_GT(root_simulation->get_windows_count(), 1);
+    for (auto rank = 0; rank < ranks_count; rank++) {
+        EXPECT_EQ(finish_times[rank], sequential_finish_time);
+        EXPECT_GT(migrated_counts[rank], 0);
+    }
+    EXPECT_EQ(std::accumulate(delivered_counts.begin(), delivered_counts.end(), int64_t(0)),
+              npus_count * (npus_count - 1) + npus_count * 8);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventQueuePostedEvents) {
+    constexpr auto producers_count = 4;
+    constexpr auto events_per_producer = 2'000;
+
+    auto queue = EventQueue();
+
+    // (producer, index) of every invoked event, on the simulation thread
+    struct Posted {
+        std::vector<std::pair<int, int>>* invoked;
+        int producer;
+        int index;
+    };
+    auto invoked = std::vector<std::pair<int, int>>();
+    auto posted = std::vector<Posted>();
+    for (auto producer = 0; producer < producers_count; producer++) {
+        for (auto index = 0; index < events_per_producer; index++) {
+            posted.push_back(Posted{&invoked, producer, index});
+        }
+    }
+    const auto record = [](void* const arg) {
+        const auto* const event = static_cast<Posted*>(arg);
+        event->invoked->emplace_back(event->producer, event->index);
+    };
+
+    // producers post at a common time, while the simulation thread keeps proceeding
+    auto producers = std::vector<std::thread>();
+    for (auto producer = 0; producer < producers_count; producer++) {
+        producers.emplace_back([&, producer] {
+            for (auto index = 0; index < events_per_producer; index++) {
+                queue.post_event(10, record, &posted[producer * events_per_producer + index]);
+            }
+        });
+    }
+    while (invoked.size() < posted.size()) {
+        if (!queue.finished()) {
+            queue.proceed();
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    // test: every event invoked once, in posting order per producer
+    auto next_index_per_producer = std::vector<int>(producers_count, 0);
+    for (const auto& [producer, index] : invoked) {
+        EXPECT_EQ(index, next_index_per_producer[producer]++);
+    }
+    EXPECT_EQ(next_index_per_producer, std::vector<int>(producers_count, events_per_producer));
+    EXPECT_TRUE(queue.finished());
+
+    // test: an event posted for a time already passed is invoked at the current time
+    queue.run_until(100);
+    auto late = Posted{&invoked, producers_count, 0};
+    queue.post_event(50, record, &late);
+    EXPECT_FALSE(queue.finished());
+    EXPECT_EQ(queue.get_next_event_time(), 100);
+    queue.run_to_completion();
+    EXPECT_EQ(invoked.back(), std::make_pair(producers_count, 0));
+    EXPECT_EQ(queue.get_current_time(), 100);
+
+    // test: reset drops the staged events
+    queue.post_event(200, record, &late);
+    queue.reset();
+    EXPECT_TRUE(queue.finished());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ForkBranches) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+
+    // common prefix: an all-to-all, branched while chunks are in flight
+    const auto send_all_to_all = [&] {
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src != dest) {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+    };
+    send_all_to_all();
+    event_queue->run_until(100'000);
+    ASSERT_FALSE(event_queue->finished());
+
+    // branch 0 finishes as is, branch 1 sends one more chunk, branch 2 forks two branches of its own
+    const auto branch = [&](const int branch_id) {
+        if (branch_id == 1) {
+            topology->send(chunk_size, 0, npus_count / 2, callback, nullptr);
+        }
+        if (branch_id == 2) {
+            const auto nested_results = fork_branches(2, [&](const int) {
+                return std::to_string(event_queue->run_to_completion());
+            });
+            return nested_results[0] + "," + nested_results[1];
+        }
+        return std::to_string(event_queue->run_to_completion());
+    };
+    const auto results = fork_branches(3, branch, 2);
+
+    // test: the caller resumes unchanged, matching the unmodified branch
+    const auto finish_time = event_queue->run_to_completion();
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0], std::to_string(finish_time));
+    EXPECT_EQ(results[2], std::to_string(finish_time) + "," + std::to_string(finish_time));
+
+    // test: the modified branch matches re-simulating the prefix
+    event_queue->reset();
+    topology->reset();
+    send_all_to_all();
+    event_queue->run_until(100'000);
+    topology->send(chunk_size, 0, npus_count / 2, callback, nullptr);
+    EXPECT_EQ(results[1], std::to_string(event_queue->run_to_completion()));
+    EXPECT_GT(std::stoull(results[1]), finish_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BandwidthSensitivity) {
+    // Ring(2) x FullyConnected(8) x Switch(4), chunks queueing along 0 -> 1 -> 15 -> switch -> 63
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto bandwidths = network_parser.get_bandwidths_per_dim();
+    const auto latencies = network_parser.get_latencies_per_dim();
+    const auto run = [&](const int upgraded_dim, const Bandwidth bandwidth_increase,
+                         const std::shared_ptr<CriticalPath>& critical_path) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser);
+        topology->attach_event_queue(run_event_queue);
+        topology->set_critical_path(critical_path);
+        if (upgraded_dim >= 0) {
+            topology->set_dim_parameters(upgraded_dim, bandwidths[upgraded_dim] + bandwidth_increase,
+                                         latencies[upgraded_dim]);
+        }
+        for (auto i = 0; i < 4; i++) {
+            topology->send(chunk_size, 0, 63, callback, nullptr);
+        }
+        const auto finish_time = run_event_queue->run_to_completion();
+        return std::make_tuple(finish_time, critical_path->bandwidth_sensitivity(*topology), topology);
+    };
+
+    const auto critical_path = std::make_shared<CriticalPath>();
+    const auto [finish_time, sensitivities, topology] = run(-1, 0, critical_path);
+    ASSERT_EQ(sensitivities.size(), 3);
+
+    // test: the slowest dimension matters the most, and every dimension is on the path
+    EXPECT_EQ(sensitivities.front().group, "dim 2");
+    for (const auto& sensitivity : sensitivities) {
+        EXPECT_GT(sensitivity.serialization_time, 0);
+        EXPECT_LT(sensitivity.finish_time_per_GBps, 0);
+        EXPECT_LE(sensitivity.max_link_busy_time, finish_time);
+    }
+
+    // test: the single-run estimate predicts the finish time of a run with a slightly faster dimension
+    for (const auto& sensitivity : sensitivities) {
+        const auto dim = sensitivity.group.back() - '0';
+        const auto bandwidth_increase = bandwidths[dim] / 100;
+        const auto upgraded_finish_time = std::get<0>(run(dim, bandwidth_increase, std::make_shared<CriticalPath>()));
+        const auto measured_change = static_cast<double>(upgraded_finish_time) - static_cast<double>(finish_time);
+        const auto predicted_change = sensitivity.finish_time_per_GBps * bandwidth_increase;
+        EXPECT_NEAR(measured_change, predicted_change, std::abs(predicted_change) * 0.05);
+    }
+
+    // test: the report lists every group
+    auto report = std::stringstream();
+    critical_path->dump_bandwidth_sensitivity(*topology, report);
+    EXPECT_EQ(report.str().rfind("[CriticalPath] group dim 2: serialization on path ", 0), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SteadyState) {
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    constexpr auto iterations_count = 50;
+
+    // iterations of a ring AllReduce, back to back
+    const auto run_iterations = [&](const bool extrapolate) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, run_event_queue);
+        auto steady_state = SteadyState(topology);
+        auto finish_time = EventTime(0);
+        for (auto iteration = 0; iteration < iterations_count; iteration++) {
+            auto collective = Collective(topology, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, chunk_size, 4);
+            collective.start();
+            finish_time = run_event_queue->run_to_completion();
+            if (steady_state.end_iteration(finish_time) && extrapolate) {
+                return std::make_pair(steady_state.extrapolate(iterations_count - iteration - 1),
+                                      steady_state.get_iterations_count());
+            }
+        }
+        return std::make_pair(finish_time, steady_state.get_iterations_count());
+    };
+
+    // test: the iterations converge after a couple, and extrapolating them matches simulating all of them
+    const auto [extrapolated_time, simulated_iterations_count] = run_iterations(true);
+    const auto [simulated_time, all_iterations_count] = run_iterations(false);
+    EXPECT_EQ(all_iterations_count, iterations_count);
+    EXPECT_LE(simulated_iterations_count, 3);
+    EXPECT_EQ(extrapolated_time, simulated_time);
+
+    // test: an iteration behaving differently restarts the detection
+    const auto topology = construct_topology(network_parser);
+    auto steady_state = SteadyState(topology, 3);
+    topology->send(chunk_size, 0, 1, callback, nullptr);
+    EXPECT_FALSE(steady_state.end_iteration(event_queue->run_to_completion()));
+    topology->send(chunk_size, 0, 1, callback, nullptr);
+    EXPECT_FALSE(steady_state.end_iteration(event_queue->run_to_completion()));
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    EXPECT_FALSE(steady_state.end_iteration(event_queue->run_to_completion()));
+    for (auto iteration = 0; iteration < 2; iteration++) {
+        topology->send(chunk_size, 0, 2, callback, nullptr);
+        EXPECT_EQ(steady_state.end_iteration(event_queue->run_to_completion()), iteration == 1);
+    }
+    EXPECT_EQ(steady_state.extrapolate(10), event_queue->get_current_time() + 10 * steady_state.get_iteration_time());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CollectiveTuner) {
+    // NICs with a few outstanding chunks: too few chunks don't pipeline, too many queue up at the NIC
+    for (const auto* const path : {"../../input/Switch.yml", "../../input/Mesh2D.yml"}) {
+        auto tuner = CollectiveTuner(NetworkParser(path), CollectiveType::AllReduce, CollectiveAlgorithm::Ring,
+                                     16 * 1'048'576);
+        tuner.set_topology_setup([](Topology& topology) { topology.set_nic_model(100, 4); });
+        const auto best = tuner.tune();
+
+        // test: candidates are ordered by estimate, and the best few are verified
+        const auto& candidates = tuner.get_candidates();
+        ASSERT_EQ(candidates.size(), 7);
+        for (auto i = size_t(0); i < candidates.size(); i++) {
+            EXPECT_EQ(candidates[i].verified_time > 0, i < 3);
+            if (i > 0) {
+                EXPECT_LE(candidates[i - 1].estimated_time, candidates[i].estimated_time);
+            }
+        }
+
+        // test: verifications falling behind the best one stop early, with a lower bound past it
+        for (auto i = size_t(0); i < 3; i++) {
+            if (candidates[i].pruned) {
+                EXPECT_GT(candidates[i].verified_time, best.verified_time);
+            }
+        }
+        EXPECT_FALSE(best.pruned);
+
+        // test: the best verified candidate is the best of a full search
+        auto best_full_time = std::numeric_limits<EventTime>::max();
+        for (const auto& candidate : candidates) {
+            best_full_time = std::min(best_full_time, tuner.simulate(candidate.chunks_count, false));
+        }
+        EXPECT_EQ(best.verified_time, best_full_time);
+        EXPECT_GT(best.chunks_count, 1);
+
+        // (ring neighbors of the Mesh2D are adjacent, its single-hop steps keep pipelining more chunks)
+        if (std::string(path) == "../../input/Switch.yml") {
+            EXPECT_LT(best.chunks_count, 64);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CollectivePlanner) {
+    // simulate a collective with an algorithm
+    const auto simulate = [](const NetworkParser& network_parser, const CollectiveType collective_type,
+                             const CollectiveAlgorithm collective_algorithm, const ChunkSize collective_size) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, run_event_queue);
+        auto collective = Collective(topology, collective_type, collective_algorithm, collective_size);
+        collective.start();
+        return run_event_queue->run_to_completion();
+    };
+
+    // test: the planned algorithm is the fastest simulated one
+    for (const auto* const path : {"../../input/Ring.yml", "../../input/Switch.yml", "../../input/Mesh2D.yml"}) {
+        const auto network_parser = NetworkParser(path);
+        const auto planner = CollectivePlanner(construct_topology(network_parser));
+        for (const auto collective_type : {CollectiveType::AllReduce, CollectiveType::AllToAll}) {
+            for (const auto collective_size : {ChunkSize(1'024), ChunkSize(64 * 1'048'576)}) {
+                const auto plan = planner.plan(collective_type, collective_size);
+                // (Hierarchical on the 2-dimensional Mesh2D only, along its rows and columns, but for AllToAll)
+                const auto mesh = (std::string(path) == "../../input/Mesh2D.yml");
+                EXPECT_EQ(plan.estimates.size(), (collective_type == CollectiveType::AllToAll) ? 3 : (mesh ? 4 : 3));
+
+                auto best_simulated_time = std::numeric_limits<EventTime>::max();
+                for (const auto& [collective_algorithm, estimated_time] : plan.estimates) {
+                    best_simulated_time = std::min(
+                        best_simulated_time, simulate(network_parser, collective_type, collective_algorithm,
+                                                      collective_size));
+                }
+                EXPECT_EQ(simulate(network_parser, collective_type, plan.collective_algorithm, collective_size),
+                          best_simulated_time);
+            }
+        }
+    }
+
+    // test: on a ring, latency-bound AllReduces go direct, bandwidth-bound ones around the ring
+    const auto planner = CollectivePlanner(construct_topology(NetworkParser("../../input/Ring.yml")));
+    EXPECT_EQ(planner.plan(CollectiveType::AllReduce, 1'024).collective_algorithm, CollectiveAlgorithm::Direct);
+    EXPECT_EQ(planner.plan(CollectiveType::AllReduce, 64 * 1'048'576).collective_algorithm, CollectiveAlgorithm::Ring);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, HierarchicalCollective) {
+    // Ring(2) x FullyConnected(8) x Switch(4)
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto collective_size = ChunkSize(64 * 1'048'576);
+
+    // simulate a collective with an algorithm
+    const auto simulate = [&](const CollectiveType collective_type, const CollectiveAlgorithm collective_algorithm,
+                              const int chunks_count) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, run_event_queue);
+        auto collective = Collective(topology, collective_type, collective_algorithm, collective_size, chunks_count);
+        collective.start();
+        run_event_queue->run_to_completion();
+        EXPECT_TRUE(collective.finished());
+        return collective.get_finish_time();
+    };
+
+    // test: Reduce-Scatter up the dimensions on ever smaller shards, All-Gather back down
+    const auto topology = construct_topology(network_parser);
+    const auto all_reduce =
+        Collective(topology, CollectiveType::AllReduce, CollectiveAlgorithm::Hierarchical, collective_size);
+    ASSERT_EQ(all_reduce.get_steps_count(), 2 * (1 + 7 + 3));
+    const auto expected_peers = std::vector<DeviceId>{1, 2, 2, 2, 2, 2, 2, 2, 16, 16, 16};
+    const auto expected_sizes = std::vector<ChunkSize>{collective_size / 2,  collective_size / 16, collective_size / 16,
+                                                       collective_size / 16, collective_size / 16, collective_size / 16,
+                                                       collective_size / 16, collective_size / 16, collective_size / 64,
+                                                       collective_size / 64, collective_size / 64};
+    for (auto step = 0; step < 11; step++) {
+        EXPECT_EQ(all_reduce.get_peer(0, step, 0), expected_peers[step]);
+        EXPECT_EQ(all_reduce.get_peer(0, 21 - step, 0), expected_peers[step]);
+        EXPECT_EQ(all_reduce.get_message_size(step), expected_sizes[step]);
+        EXPECT_EQ(all_reduce.get_message_size(21 - step), expected_sizes[step]);
+    }
+
+    // test: the peer wraps around its dimension only
+    EXPECT_EQ(all_reduce.get_peer(63, 0, 0), 62);
+    EXPECT_EQ(all_reduce.get_peer(63, 1, 0), 49);
+    EXPECT_EQ(all_reduce.get_peer(63, 8, 0), 15);
+
+    // test: ReduceScatter and AllGather are each half of the AllReduce
+    EXPECT_EQ(Collective(topology, CollectiveType::ReduceScatter, CollectiveAlgorithm::Hierarchical, collective_size)
+                  .get_steps_count(),
+              11);
+    const auto all_gather =
+        Collective(topology, CollectiveType::AllGather, CollectiveAlgorithm::Hierarchical, collective_size);
+    EXPECT_EQ(all_gather.get_peer(0, 0, 0), 16);
+    EXPECT_EQ(all_gather.get_message_size(0), collective_size / 64);
+
+    // test: the slow dimensions carry less data than around a flat ring
+    const auto hierarchical_time = simulate(CollectiveType::AllReduce, CollectiveAlgorithm::Hierarchical, 1);
+    EXPECT_LT(hierarchical_time, simulate(CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 1));
+
+    // test: pipelining chunks through the dimensions speeds it up
+    EXPECT_LT(simulate(CollectiveType::AllReduce, CollectiveAlgorithm::Hierarchical, 4), hierarchical_time);
+
+    // test: the planner considers it on multi-dimensional topologies only
+    const auto planner = CollectivePlanner(topology);
+    EXPECT_TRUE(planner.applicable(CollectiveType::AllReduce, CollectiveAlgorithm::Hierarchical));
+    EXPECT_TRUE(planner.applicable(CollectiveType::AllToAll, CollectiveAlgorithm::Hierarchical));
+    EXPECT_FALSE(CollectivePlanner(construct_topology(NetworkParser("../../input/Ring.yml")))
+                     .applicable(CollectiveType::AllReduce, CollectiveAlgorithm::Hierarchical));
+    EXPECT_EQ(planner.plan(CollectiveType::AllReduce, collective_size).collective_algorithm,
+              CollectiveAlgorithm::Hierarchical);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, PhasedAllToAll) {
+    // simulate an AllToAll with an algorithm: finish time, peak in-flight messages, and peak chunk memory
+    const auto simulate = [](const char* const path, const CollectiveAlgorithm collective_algorithm,
+                             const int chunks_count) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(NetworkParser(path), run_event_queue);
+        const auto collective_size = ChunkSize(topology->get_npus_count()) * 1'048'576;
+        auto collective =
+            Collective(topology, CollectiveType::AllToAll, collective_algorithm, collective_size, chunks_count);
+        collective.start();
+        run_event_queue->run_to_completion();
+        EXPECT_TRUE(collective.finished());
+        return std::make_tuple(collective.get_finish_time(), collective.get_peak_in_flight_messages_count(),
+                               topology->get_memory_footprint().chunks.peak_bytes);
+    };
+
+    // test: Mesh2D (4 x 4) transposes along its rows, then along its columns, both ways
+    const auto mesh_topology = construct_topology(NetworkParser("../../input/Mesh2D.yml"));
+    const auto transpose = Collective(mesh_topology, CollectiveType::AllToAll, CollectiveAlgorithm::Hierarchical,
+                                      16 * chunk_size);
+    ASSERT_EQ(transpose.get_steps_count(), 2 + 2);
+    const auto expected_fanouts = std::vector<int>{2, 1, 2, 1};
+    const auto expected_peers = std::vector<DeviceId>{6, 7, 9, 13};
+    for (auto step = 0; step < 4; step++) {
+        EXPECT_EQ(transpose.get_fanout(step), expected_fanouts[step]);
+        EXPECT_EQ(transpose.get_peer(5, step, 0), expected_peers[step]);
+        EXPECT_EQ(transpose.get_message_size(step), 4 * chunk_size);
+    }
+    EXPECT_EQ(transpose.get_peer(5, 0, 1), 4);
+    EXPECT_EQ(transpose.get_peer(5, 2, 1), 1);
+
+    // test: at the same pipelining (4 chunks per message), phases keep far fewer messages and chunks alive
+    // than flooding every link at once, at a cost in finish time depending on the topology
+    const auto compare = [&simulate](const char* const path) {
+        const auto [direct_time, direct_peak, direct_memory] = simulate(path, CollectiveAlgorithm::Direct, 4);
+        const auto [phased_time, phased_peak, phased_memory] = simulate(path, CollectiveAlgorithm::Hierarchical, 4);
+        EXPECT_LT(phased_peak, direct_peak);
+        EXPECT_LT(phased_memory, direct_memory);
+        return std::make_pair(direct_time, phased_time);
+    };
+
+    // Ring and Switch: every shift phase keeps both directions busy, so no time is lost
+    const auto [ring_direct_time, ring_phased_time] = compare("../../input/Ring.yml");
+    EXPECT_EQ(ring_phased_time, ring_direct_time);
+    const auto [switch_direct_time, switch_phased_time] = compare("../../input/Switch.yml");
+    EXPECT_EQ(switch_phased_time, switch_direct_time);
+
+    // Mesh2D: each phase only uses the ports of one dimension and relays through the intermediate row,
+    // so the phases trade finish time for memory
+    const auto [mesh_direct_time, mesh_phased_time] = compare("../../input/Mesh2D.yml");
+    EXPECT_GT(mesh_phased_time, mesh_direct_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, MeshCollectives) {
+    // count the steps between ring neighbors taking several hops
+    const auto multi_hop_steps_count = [](const Topology& topology) {
+        const auto ring_order = topology.get_ring_order();
+        auto steps_count = 0;
+        for (auto position = size_t(0); position < ring_order.size(); position++) {
+            const auto next = ring_order[(position + 1) % ring_order.size()];
+            steps_count += (topology.get_hops_count(ring_order[position], next) > 1) ? 1 : 0;
+        }
+        return steps_count;
+    };
+
+    // simulate an AllReduce with an algorithm
+    const auto simulate = [](const NetworkParser& network_parser, const CollectiveAlgorithm collective_algorithm,
+                             const bool bidirectional) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, run_event_queue);
+        auto collective = Collective(topology, CollectiveType::AllReduce, collective_algorithm, 64 * 1'048'576, 4);
+        collective.set_bidirectional(bidirectional);
+        collective.start();
+        run_event_queue->run_to_completion();
+        EXPECT_TRUE(collective.finished());
+        return collective.get_finish_time();
+    };
+
+    // test: a Hamiltonian cycle if a side is even, a single multi-hop step otherwise, a folded line
+    EXPECT_EQ(Mesh2D(4, 4, 50, 500).get_ring_order(),
+              (std::vector<DeviceId>{0, 1, 2, 3, 7, 6, 5, 9, 10, 11, 15, 14, 13, 12, 8, 4}));
+    EXPECT_EQ(multi_hop_steps_count(Mesh2D(5, 4, 50, 500)), 0);
+    EXPECT_EQ(multi_hop_steps_count(Mesh2D(4, 3, 50, 500)), 0);
+    EXPECT_EQ(multi_hop_steps_count(Mesh2D(3, 3, 50, 500)), 1);
+    EXPECT_EQ(Mesh2D(1, 5, 50, 500).get_ring_order(), (std::vector<DeviceId>{0, 2, 4, 3, 1}));
+
+    // test: the ring goes around the holes of a SparseMesh2D (the example of its documentation)
+    const auto holes = std::set<std::pair<int, int>>{{0, 1}, {1, 1}, {0, 2}, {1, 2}, {0, 3}, {1, 3}, {2, 3}, {3, 3}};
+    const auto sparse_mesh = SparseMesh2D(6, 4, holes, 50, 500);
+    EXPECT_EQ(sparse_mesh.get_ring_order(),
+              (std::vector<DeviceId>{0, 1, 2, 3, 4, 5, 9, 13, 15, 14, 12, 8, 7, 11, 10, 6}));
+    EXPECT_EQ(multi_hop_steps_count(sparse_mesh), 1);
+    EXPECT_EQ(multi_hop_steps_count(SparseMesh2D(4, 4, std::set<std::pair<int, int>>(), 50, 500)), 0);
+
+    // test: the Ring and Hierarchical algorithms step between neighbors
+    // (Hierarchical along rings folded over the rows and columns: 0 -> 2 -> 3 -> 1 -> 0)
+    const auto network_parser = NetworkParser("../../input/Mesh2D.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto ring = Collective(topology, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 64 * 1'048'576);
+    EXPECT_EQ(ring.get_peer(3, 0, 0), 7);
+    EXPECT_EQ(ring.get_peer(4, 0, 0), 0);
+    const auto hierarchical =
+        Collective(topology, CollectiveType::AllReduce, CollectiveAlgorithm::Hierarchical, 64 * 1'048'576);
+    EXPECT_EQ(hierarchical.get_peer(0, 0, 0), 2);
+    EXPECT_EQ(hierarchical.get_peer(2, 0, 0), 3);
+    EXPECT_EQ(hierarchical.get_peer(7, 0, 0), 5);
+    EXPECT_EQ(hierarchical.get_peer(5, 3, 0), 1);  // along the column
+
+    // test: a bidirectional ring sends half of the data each way, and so takes half the time
+    auto bidirectional_ring =
+        Collective(topology, CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 64 * 1'048'576);
+    bidirectional_ring.set_bidirectional(true);
+    EXPECT_EQ(bidirectional_ring.get_fanout(0), 2);
+    EXPECT_EQ(bidirectional_ring.get_peer(3, 0, 1), 2);
+    EXPECT_EQ(bidirectional_ring.get_message_size(0), 2 * 1'048'576);
+    const auto ring_time = simulate(network_parser, CollectiveAlgorithm::Ring, false);
+    EXPECT_LT(simulate(network_parser, CollectiveAlgorithm::Ring, true), ring_time * 51 / 100);
+    EXPECT_LT(simulate(network_parser, CollectiveAlgorithm::Hierarchical, false), ring_time);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TopologyMetrics) {
+    // check the closed form of a building block against the BFS and max-flow of the default
+    const auto check_closed_form = [](const Topology& topology, const TopologyMetrics& expected) {
+        const auto metrics = topology.compute_metrics();
+        EXPECT_EQ(metrics.diameter, expected.diameter);
+        EXPECT_NEAR(metrics.average_hops_count, expected.average_hops_count, 1e-9);
+        EXPECT_NEAR(metrics.bisection_bandwidth, expected.bisection_bandwidth, 1e-6);
+        EXPECT_EQ(metrics.links_count_per_dim, expected.links_count_per_dim);
+
+        const auto searched_metrics = topology.Topology::compute_metrics(2);
+        EXPECT_EQ(searched_metrics.diameter, metrics.diameter);
+        EXPECT_NEAR(searched_metrics.average_hops_count, metrics.average_hops_count, 1e-9);
+        EXPECT_NEAR(searched_metrics.bisection_bandwidth, metrics.bisection_bandwidth, 1e-6);
+        EXPECT_EQ(searched_metrics.links_count_per_dim, metrics.links_count_per_dim);
+    };
+
+    // test: 1-dimensional building blocks
+    check_closed_form(Ring(8, 50, 500), {4, 16.0 / 7, 100, {16}});
+    check_closed_form(Ring(2, 50, 500), {1, 1, 50, {2}});
+    check_closed_form(Ring(7, 50, 500, false), {6, 3.5, 50, {7}});
+    check_closed_form(FullyConnected(5, 50, 500), {1, 1, 6 * 50, {20}});
+    check_closed_form(Switch(7, 50, 500), {2, 2, 3 * 50, {14}});
+
+    // test: grids, cut across their highest dimension (odd ones by the default)
+    check_closed_form(Mesh2D(4, 4, 50, 500), {6, 160.0 / 60, 4 * 50, {24, 24}});
+    check_closed_form(Mesh2D(8, 1, 50, 500), {7, 3, 50, {14, 0}});
+    check_closed_form(Torus(4, 4, 2, 50, 500), {5, 80.0 / 31, 16 * 50, {64, 64, 32}});
+    const auto odd_mesh = Mesh2D(4, 3, 50, 500);
+    EXPECT_EQ(odd_mesh.compute_metrics().diameter, 5);
+    EXPECT_NEAR(odd_mesh.compute_metrics().bisection_bandwidth, 5 * 50, 1e-6);
+    EXPECT_EQ(Torus(4, 3, 50, 500).compute_metrics().diameter, 3);
+
+    // test: parallel channels multiply the bisection bandwidth
+    auto ring = Ring(8, 50, 500);
+    ring.set_dim_channels(0, 2);
+    EXPECT_NEAR(ring.compute_metrics().bisection_bandwidth, 200, 1e-6);
+    EXPECT_NEAR(ring.Topology::compute_metrics().bisection_bandwidth, 200, 1e-6);
+
+    // test: irregular graphs, by the default
+    // (row 0 complete, row 1 missing its first cell: NPUs 0-2 reach the others through 2 -> 3, 1 -> 4, and 2 -> 5)
+    const auto sparse_mesh = SparseMesh2D(4, 2, std::set<std::pair<int, int>>{{0, 1}}, 50, 500);
+    const auto sparse_metrics = sparse_mesh.compute_metrics();
+    EXPECT_EQ(sparse_metrics.diameter, 4);
+    EXPECT_EQ(sparse_metrics.links_count_per_dim, (std::vector<int>{10, 6}));
+    EXPECT_NEAR(sparse_metrics.bisection_bandwidth, 3 * 50, 1e-6);
+
+    // test: multi-dimensional topologies compose their dimensions' hops
+    const auto multi_dim_topology = construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch.yml"));
+    const auto multi_dim_metrics = multi_dim_topology->compute_metrics();
+    EXPECT_EQ(multi_dim_metrics.diameter, 1 + 1 + 2);
+    EXPECT_EQ(multi_dim_metrics.links_count_per_dim.size(), 3);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LatencyHistograms) {
+    // test: values below 2^precision_bits are exact, larger ones within 2^-(precision_bits - 1)
+    auto histogram = Histogram(7);
+    for (auto value = uint64_t(0); value < 1'000; value++) {
+        histogram.record(value);
+    }
+    histogram.record(1'000'000'000'000);
+    EXPECT_EQ(histogram.get_count(), 1'001);
+    EXPECT_EQ(histogram.get_min(), 0);
+    EXPECT_EQ(histogram.get_max(), 1'000'000'000'000);
+    EXPECT_EQ(histogram.get_percentile(10), 100);
+    EXPECT_NEAR(static_cast<double>(histogram.get_percentile(50)), 500, 500.0 / 64);
+    EXPECT_NEAR(static_cast<double>(histogram.get_percentile(99.9)), 999, 999.0 / 64);
+    EXPECT_EQ(histogram.get_percentile(100), 1'000'000'000'000);
+    EXPECT_EQ(histogram.get_buckets_count(), 128 + (57 * 64));
+
+    // a ring of 16 NPUs: 1 hop to the neighbors (class 0), more to the others (class 1)
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+    const auto neighbors = [npus_count](const DeviceId src, const DeviceId dest) {
+        return ((src + 1) % npus_count == dest || (dest + 1) % npus_count == src) ? 0 : 1;
+    };
+    const auto latency_histograms = std::make_shared<LatencyHistograms>(2, neighbors);
+    topology->set_latency_histograms(latency_histograms);
+
+    // every NPU sends a chunk to every other one at once
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            if (src != dest) {
+                topology->send(chunk_size, src, dest, callback, nullptr);
+            }
+        }
+    }
+    const auto finish_time = event_queue->run_to_completion();
+
+    // test: every chunk is recorded, in its class
+    const auto hops = latency_histograms->get_hops();
+    EXPECT_EQ(hops.get_count(), npus_count * (npus_count - 1));
+    EXPECT_EQ(latency_histograms->get_hops(0).get_count(), 2 * npus_count);
+    EXPECT_EQ(latency_histograms->get_hops(0).get_max(), 1);
+    EXPECT_EQ(latency_histograms->get_hops(1).get_min(), 2);
+    EXPECT_EQ(hops.get_max(), npus_count / 2);
+
+    // test: the slowest chunk finishes the run, and its latency is the tail
+    const auto latency = latency_histograms->get_latency();
+    EXPECT_EQ(latency.get_max(), finish_time);
+    EXPECT_EQ(latency.get_percentile(100), finish_time);
+    EXPECT_LE(latency.get_percentile(50), latency.get_percentile(99));
+    EXPECT_LT(latency_histograms->get_latency(0).get_mean(), latency_histograms->get_latency(1).get_mean());
+    if constexpr (stats_enabled) {
+        EXPECT_GT(latency_histograms->get_queueing_delay().get_max(), 0);
+    }
+
+    // test: the percentiles export as CSV, every class merged first
+    auto output = std::ostringstream();
+    latency_histograms->dump(output);
+    auto line = std::string();
+    auto lines = std::vector<std::string>();
+    auto input = std::istringstream(output.str());
+    while (std::getline(input, line)) {
+        lines.push_back(line);
+    }
+    ASSERT_EQ(lines.size(), 1 + (3 * 3));
+    EXPECT_EQ(lines[0], "class,metric,count,min,mean,p50,p90,p99,p99.9,max");
+    EXPECT_EQ(lines[3].substr(0, lines[3].find(',', 9)), "all,hops,240");
+    EXPECT_EQ(lines[4].substr(0, 10), "0,latency,");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, DeterministicCosts) {
+    if constexpr (!stats_enabled) {
+        GTEST_SKIP() << "statistics are not compiled in";
+    }
+
+    // deterministic costs of a reference workload, independent of the wall-clock time
+    struct Costs {
+        uint64_t events_scheduled;
+        uint64_t event_lists_created;
+        uint64_t routes_computed;
+        int chunks_allocated;
+    };
+
+    // run a collective of 16 MB on a topology
+    const auto run = [](const char* const path, const CollectiveType collective_type,
+                        const CollectiveAlgorithm collective_algorithm, const int chunks_count) {
+        auto run_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(NetworkParser(path), run_event_queue);
+        auto collective = Collective(topology, collective_type, collective_algorithm, 16 * 1'048'576, chunks_count);
+        collective.start();
+        run_event_queue->run_to_completion();
+        EXPECT_TRUE(collective.finished());
+
+        // test: every hop costs two events (transmission and arrival)
+        const auto& stats = run_event_queue->get_stats();
+        EXPECT_EQ(stats.events_scheduled, 2 * topology->get_chunk_stats().hops_count);
+        EXPECT_EQ(stats.event_lists_created, stats.event_lists_processed);
+        return Costs{stats.events_scheduled, stats.event_lists_created, topology->get_routes_computed_count(),
+                     topology->get_chunk_pool().get_allocated_chunks_count()};
+    };
+
+    // these are regression baselines: a change that adds events, routes, or chunks to the hot path shows up here
+    // Ring(16): 15 steps of 16 one-hop chunks, each NPU routes to its successor only,
+    // and chunks are recycled from one step to the next
+    auto costs = run("../../input/Ring.yml", CollectiveType::AllGather, CollectiveAlgorithm::Ring, 1);
+    EXPECT_EQ(costs.events_scheduled, 2 * 15 * 16);
+    EXPECT_EQ(costs.event_lists_created, 2 * 15);
+    EXPECT_EQ(costs.routes_computed, 16);
+    EXPECT_EQ(costs.chunks_allocated, 16 + 1);
+
+    // test: pipelined chunks share the routes, and are recycled as well
+    costs = run("../../input/Ring.yml", CollectiveType::AllReduce, CollectiveAlgorithm::Ring, 4);
+    EXPECT_EQ(costs.events_scheduled, 2 * 4 * 30 * 16);
+    EXPECT_EQ(costs.event_lists_created, 2 * 4 * 30);
+    EXPECT_EQ(costs.routes_computed, 16);
+    EXPECT_EQ(costs.chunks_allocated, (4 * 16) + 1);
+
+    // Switch(16): every pair exchanges a two-hop chunk at once, on a route of its own
+    costs = run("../../input/Switch.yml", CollectiveType::AllToAll, CollectiveAlgorithm::Direct, 1);
+    EXPECT_EQ(costs.events_scheduled, 2 * 2 * 16 * 15);
+    EXPECT_EQ(costs.event_lists_created, 46);
+    EXPECT_EQ(costs.routes_computed, 16 * 15);
+    EXPECT_EQ(costs.chunks_allocated, 16 * 15);
+
+    // Ring(2) x FullyConnected(8) x Switch(4): each NPU routes to its next peer along each dimension
+    costs = run("../../input/Ring_FullyConnected_Switch.yml", CollectiveType::AllReduce,
+                CollectiveAlgorithm::Hierarchical, 2);
+    EXPECT_EQ(costs.events_scheduled, 7'168);
+    EXPECT_EQ(costs.event_lists_created, 111);
+    EXPECT_EQ(costs.routes_computed, 3 * 64);
+    EXPECT_EQ(costs.chunks_allocated, (2 * 64) + 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Telemetry) {
+    // get the value of a metric from the Prometheus text
+    const auto metric = [](const std::string& text, const std::string& name) {
+        const auto position = text.find("\n" + name + " ");
+        EXPECT_NE(position, std::string::npos) << name;
+        return (position == std::string::npos) ? -1.0 : std::stod(text.substr(position + name.size() + 2));
+    };
+
+    // two chunks 0 -> 2 on a ring: 4 hops, 2 events each
+    const auto telemetry = std::make_shared<Telemetry>(2);
+    event_queue->set_telemetry(telemetry);
+    auto topology = std::make_shared<Ring>(8, 50, 500, false);
+    topology->set_telemetry(telemetry);
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+    topology->send(chunk_size, 0, 2, callback, nullptr);
+
+    // test: the progress is published every 2 EventLists, while the chunks are in flight
+    event_queue->proceed();
+    event_queue->proceed();
+    auto text = telemetry->render();
+    EXPECT_EQ(metric(text, "network_analytical_simulated_time_ns"), event_queue->get_current_time());
+    EXPECT_GT(metric(text, "network_analytical_pending_event_lists"), 0);
+    EXPECT_EQ(metric(text, "network_analytical_live_chunks"), 2);
+
+    // test: the final progress is published once the simulation finishes
+    const auto finish_time = event_queue->run_to_completion();
+    text = telemetry->render();
+    EXPECT_EQ(metric(text, "network_analytical_simulated_time_ns"), finish_time);
+    EXPECT_EQ(metric(text, "network_analytical_events_processed_total"), 8);
+    EXPECT_EQ(metric(text, "network_analytical_pending_event_lists"), 0);
+    EXPECT_EQ(metric(text, "network_analytical_live_chunks"), 0);
+    EXPECT_GE(metric(text, "network_analytical_events_per_second"), 0);
+
+    // test: the gauge of a destroyed topology is withdrawn
+    topology.reset();
+    EXPECT_EQ(telemetry->render().find("network_analytical_live_chunks"), std::string::npos);
+    event_queue->set_telemetry(nullptr);
+
+    // test: the sweep progress
+    auto sweep = Sweep(Sweep::parameter_grid("Ring", {4, 8, 16}, {50.0}, {500.0}));
+    sweep.set_telemetry(telemetry);
+    const auto results = sweep.run([](Topology& point_topology) {
+        point_topology.send(1'048'576, 0, 1, [](void*) {}, nullptr);
+    });
+    text = telemetry->render();
+    EXPECT_EQ(metric(text, "network_analytical_sweep_points"), 3);
+    EXPECT_EQ(metric(text, "network_analytical_sweep_points_completed"), 3);
+
+    // test: the metrics are served over HTTP
+    const auto port = telemetry->serve();
+    const auto fd = connect_tcp("127.0.0.1", port);
+    ASSERT_NE(fd, -1);
+    const auto request = std::string("GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+    ASSERT_EQ(send(fd, request.data(), request.size(), 0), static_cast<ssize_t>(request.size()));
+    auto response = std::string();
+    char buffer[1'024];
+    for (auto read_size = recv(fd, buffer, sizeof(buffer), 0); read_size > 0;
+         read_size = recv(fd, buffer, sizeof(buffer), 0)) {
+        response.append(buffer, static_cast<size_t>(read_size));
+    }
+    close(fd);
+    telemetry->stop();
+    EXPECT_EQ(response.substr(0, 15), "HTTP/1.0 200 OK");
+    EXPECT_EQ(metric(response, "network_analytical_sweep_points_completed"), 3);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SweepThreadPinning) {
+    // test: every core the process may run on is pinned once
+    const auto pinned_cores = WorkStealingExecutor::get_pinned_cores();
+    ASSERT_FALSE(pinned_cores.empty());
+    EXPECT_EQ(std::set<int>(pinned_cores.begin(), pinned_cores.end()).size(), pinned_cores.size());
+    auto allowed_cpu_set = cpu_set_t();
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed_cpu_set), &allowed_cpu_set), 0);
+    EXPECT_EQ(pinned_cores.size(), CPU_COUNT(&allowed_cpu_set));
+
+    // test: tasks run on the cores of their workers, and the caller gets its affinity back
+    auto executor = WorkStealingExecutor(2);
+    executor.set_thread_pinning(true);
+    auto task_cpus = std::vector<int>(8, -1);
+    executor.run(8, [&task_cpus](const int task_id) { task_cpus[task_id] = sched_getcpu(); });
+    const auto workers_count = std::min<size_t>(2, pinned_cores.size());
+    const auto worker_cores = std::set<int>(pinned_cores.begin(), pinned_cores.begin() + workers_count);
+    for (const auto cpu : task_cpus) {
+        EXPECT_EQ(worker_cores.count(cpu), 1) << cpu;
+    }
+    auto caller_cpu_set = cpu_set_t();
+    ASSERT_EQ(sched_getaffinity(0, sizeof(caller_cpu_set), &caller_cpu_set), 0);
+    EXPECT_TRUE(CPU_EQUAL(&caller_cpu_set, &allowed_cpu_set));
+
+    // test: pinned sweeps give the same results
+    const auto workload = [](Topology& topology) {
+        for (auto dest = 1; dest < topology.get_npus_count(); dest++) {
+            topology.send(1'048'576, 0, dest, [](void*) {}, nullptr);
+        }
+    };
+    auto sweep = Sweep(Sweep::parameter_grid("Ring", {4, 8, 16}, {50.0, 100.0}, {500.0}));
+    const auto results = sweep.run(workload, 2);
+    sweep.set_thread_pinning(true);
+    const auto pinned_results = sweep.run(workload, 2);
+    ASSERT_EQ(pinned_results.size(), results.size());
+    for (auto point = size_t(0); point < results.size(); point++) {
+        EXPECT_EQ(pinned_results[point].finish_time, results[point].finish_time);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SweepTable) {
+    const auto all_gather = [this](Topology& topology) {
+        for (auto src = 0; src < topology.get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology.get_npus_count(); dest++) {
+                if (src != dest) {
+                    topology.send(chunk_size, src, dest, [](void*) {}, nullptr);
+                }
+            }
+        }
+    };
+
+    // points of 4 to 12 NPUs, the fourth one being invalid
+    auto network_configs = std::vector<NetworkConfig>();
+    for (auto point_id = 0; point_id < 5; point_id++) {
+        const auto npus_count = (point_id == 3) ? -1 : 4 + 2 * point_id;
+        network_configs.push_back(NetworkConfig().add_dim(TopologyBuildingBlock::Ring, npus_count, 50.0, 500.0));
+    }
+
+    // test: every point is appended as it finishes, in blocks
+    const auto table_path = std::string("sweep_table_test.bin");
+    auto table = std::make_shared<SweepTable>(table_path, 2);
+    auto sweep = Sweep(network_configs);
+    sweep.set_result_table(table);
+    const auto results = sweep.run(all_gather, 2);
+    EXPECT_EQ(table->get_rows_count(), 5);
+    table->close();
+
+    // test: the table holds the rows of the result table, whatever order the points finished in
+    const auto columns = SweepTable::read_table(table_path);
+    ASSERT_EQ(columns.size(), 5);
+    for (auto row = 0; row < 5; row++) {
+        const auto& result = results[columns.point_ids[row]];
+        EXPECT_EQ(columns.npus_counts[row], result.npus_count);
+        EXPECT_EQ(columns.bandwidths[row], result.bandwidth);
+        EXPECT_EQ(columns.finish_times[row], result.finish_time);
+        EXPECT_EQ(columns.events_counts[row], result.events_count);
+        EXPECT_EQ(columns.wall_times[row], result.wall_time);
+        EXPECT_EQ(columns.config_errors_counts[row], static_cast<int32_t>(result.config_errors.size()));
+    }
+
+    // test: simulated points are measured, and the invalid point isn't simulated
+    EXPECT_GT(results[0].events_count, 0);
+    EXPECT_LT(results[0].events_count, results[4].events_count);
+    EXPECT_GT(results[4].wall_time, 0);
+    EXPECT_FALSE(results[3].config_errors.empty());
+    EXPECT_EQ(results[3].events_count, 0);
+
+    std::filesystem::remove(table_path);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ParallelLinkConstruction) {
+    /// setup
+    const auto devices_count = 512;
+    auto endpoints = std::vector<std::pair<DeviceId, DeviceId>>();
+    for (auto src = 0; src < devices_count; src++) {
+        for (const auto offset : {1, 7, 31}) {
+            endpoints.emplace_back(src, (src + offset) % devices_count);
+        }
+    }
+
+    // test: links constructed concurrently match the appended ones, with the table-wide settings
+    auto appended_links = LinkTable();
+    auto assigned_links = LinkTable();
+    appended_links.set_link_model(LinkModel::VirtualTime);
+    assigned_links.set_link_model(LinkModel::VirtualTime);
+    for (const auto& [src, dest] : endpoints) {
+        appended_links.emplace_back(src, dest, 50.0, 500.0);
+    }
+    assigned_links.assign(endpoints, 50.0, 500.0, 4);
+    ASSERT_EQ(assigned_links.size(), appended_links.size());
+    EXPECT_EQ(assigned_links.materialized_size(), assigned_links.size());
+    for (auto link_id = 0; link_id < static_cast<LinkId>(endpoints.size()); link_id++) {
+        EXPECT_EQ(assigned_links.endpoints(link_id), appended_links.endpoints(link_id));
+        EXPECT_EQ(assigned_links[link_id].get_link_model(), LinkModel::VirtualTime);
+    }
+
+    // test: links appended afterwards follow the assigned ones
+    assigned_links.emplace_back(3, 5, 50.0, 500.0);
+    EXPECT_EQ(assigned_links.endpoints(static_cast<LinkId>(endpoints.size())), std::make_pair(3, 5));
+
+    // test: mesh links keep their row-major order
+    const auto width = 48;
+    const auto height = 40;
+    const auto mesh = std::make_shared<Mesh2D>(width, height, 50.0, 500.0);
+    EXPECT_EQ(mesh->get_links_count(), 2 * ((width - 1) * height + width * (height - 1)));
+    EXPECT_EQ(mesh->find_link(0, 1), 0);
+    EXPECT_EQ(mesh->find_link(1, 0), 1);
+    EXPECT_EQ(mesh->find_link(0, width), 2);
+    EXPECT_EQ(mesh->find_link(width, 0), 3);
+    for (auto link_id = 0; link_id < mesh->get_links_count(); link_id++) {
+        const auto& link = mesh->get_link(link_id);
+        EXPECT_EQ(mesh->find_link(link.get_src(), link.get_dest()), link_id);
+    }
+
+    // test: a chunk crosses the mesh corner to corner, a hop at a time
+    mesh->send(chunk_size, 0, (width * height) - 1, callback, nullptr);
+    while (!event_queue->finished()) {
+        event_queue->proceed();
+    }
+    const auto hop_delay = mesh->get_link(0).communication_delay(chunk_size);
+    EXPECT_EQ(event_queue->get_current_time(), (width + height - 2) * hop_delay);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ContiguousLinkStorage) {
+    /// setup
+    const auto links_count = 200;
+    const auto reserved_count = 4 * LinkTable::page_size;
+    const auto page_index_bytes = static_cast<uint64_t>(1024);
+
+    // test: links appended within the reserved size are a single array, allocated once
+    auto appended_links = LinkTable();
+    appended_links.reserve(links_count);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        appended_links.emplace_back(link_id, link_id + 1, 50.0, 500.0);
+    }
+    const auto* const first_link = &appended_links[0];
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        EXPECT_EQ(&appended_links[link_id], first_link + link_id);
+    }
+    const auto allocated_bytes = appended_links.get_allocated_bytes();
+    EXPECT_GE(allocated_bytes, reserved_count * sizeof(Link));
+    EXPECT_LT(allocated_bytes, (reserved_count * sizeof(Link)) + page_index_bytes);
+
+    // test: appending past the reserved size opens a new block, without moving the existing links
+    for (auto link_id = links_count; link_id < reserved_count + 1; link_id++) {
+        appended_links.emplace_back(link_id, link_id + 1, 50.0, 500.0);
+    }
+    EXPECT_EQ(&appended_links[0], first_link);
+    EXPECT_EQ(&appended_links[reserved_count - 1], first_link + reserved_count - 1);
+    EXPECT_GE(appended_links.get_allocated_bytes(), (reserved_count + LinkTable::page_size) * sizeof(Link));
+
+    // test: assigned links are a single array as well
+    auto endpoints = std::vector<std::pair<DeviceId, DeviceId>>();
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        endpoints.emplace_back(link_id, link_id + 1);
+    }
+    auto assigned_links = LinkTable();
+    assigned_links.assign(endpoints, 50.0, 500.0, 4);
+    for (auto link_id = 0; link_id < links_count; link_id++) {
+        EXPECT_EQ(&assigned_links[link_id], &assigned_links[0] + link_id);
+    }
+    EXPECT_LT(assigned_links.get_allocated_bytes(), (reserved_count * sizeof(Link)) + page_index_bytes);
+
+    // test: so are the links of a topology, in LinkId order
+    const auto ring = std::make_shared<Ring>(64, 50.0, 500.0);
+    for (auto link_id = 0; link_id < ring->get_links_count(); link_id++) {
+        EXPECT_EQ(&ring->get_link(link_id), &ring->get_link(0) + link_id);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BackgroundTeardown) {
+    // test: storage is released on the background thread, and drain waits for it
+    auto& reclaimer = Reclaimer::get();
+    reclaimer.drain();
+    const auto released_count = reclaimer.get_released_count();
+    const auto discarding_thread = std::this_thread::get_id();
+    auto releasing_thread = std::thread::id();
+    struct Storage {
+        std::thread::id* releasing_thread = nullptr;
+        ~Storage() {
+            *releasing_thread = std::this_thread::get_id();
+        }
+    };
+    auto storage = std::make_unique<Storage>();
+    storage->releasing_thread = &releasing_thread;
+    reclaimer.reclaim(std::move(storage));
+    reclaimer.drain();
+    EXPECT_EQ(reclaimer.get_released_count(), released_count + 1);
+    EXPECT_NE(releasing_thread, std::thread::id());
+    EXPECT_NE(releasing_thread, discarding_thread);
+
+    // test: a topology released in the background simulates the same, and its storage is released
+    const auto simulation_time = [&](const bool background_teardown) {
+        const auto start_time = event_queue->get_current_time();
+        auto topology = std::make_shared<Mesh2D>(16, 16, 50.0, 500.0);
+        topology->set_background_teardown(background_teardown);
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest += 17) {
+                if (src != dest) {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+        event_queue->run_to_completion();
+        return event_queue->get_current_time() - start_time;
+    };
+    const auto finish_time = simulation_time(false);
+    reclaimer.drain();
+    const auto topology_released_count = reclaimer.get_released_count();
+    EXPECT_EQ(simulation_time(true), finish_time);
+    reclaimer.drain();
+    EXPECT_EQ(reclaimer.get_released_count(), topology_released_count + 1);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RouteBatch) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    const auto npus_count = topology->get_npus_count();
+    auto pairs = std::vector<std::pair<DeviceId, DeviceId>>();
+    for (auto src = 0; src < npus_count; src++) {
+        for (auto dest = 0; dest < npus_count; dest++) {
+            pairs.emplace_back(src, dest);
+        }
+    }
+
+    // test: every route of the routing matrix matches route(), in the given order
+    const auto batch = topology->route_batch(pairs, 4);
+    ASSERT_EQ(batch.offsets.size(), pairs.size() + 1);
+    EXPECT_EQ(batch.offsets.front(), 0);
+    EXPECT_EQ(batch.offsets.back(), batch.devices.size());
+    for (auto pair_id = static_cast<size_t>(0); pair_id < pairs.size(); pair_id++) {
+        const auto route = topology->route(pairs[pair_id].first, pairs[pair_id].second);
+        const auto batched_route = std::vector<DeviceId>(batch.devices.begin() + batch.offsets[pair_id],
+                                                         batch.devices.begin() + batch.offsets[pair_id + 1]);
+        EXPECT_EQ(batched_route, std::vector<DeviceId>(route.begin(), route.end()));
+    }
+
+    // test: a single thread gives the same buffer, and no pair an empty one
+    const auto serial_batch = topology->route_batch(pairs, 1);
+    EXPECT_EQ(serial_batch.offsets, batch.offsets);
+    EXPECT_EQ(serial_batch.devices, batch.devices);
+    const auto empty_batch = topology->route_batch({});
+    EXPECT_EQ(empty_batch.offsets, std::vector<uint64_t>({0}));
+    EXPECT_TRUE(empty_batch.devices.empty());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, ZeroLoadLatency) {
+    /// setup
+    auto cells = std::vector<bool>(6 * 5, true);
+    cells[7] = false;
+    cells[15] = false;
+    cells[16] = false;
+    auto topologies = std::vector<std::shared_ptr<Topology>>();
+    topologies.push_back(std::make_shared<Ring>(9, 50.0, 500.0));
+    topologies.push_back(std::make_shared<Ring>(8, 50.0, 500.0, false));
+    topologies.push_back(std::make_shared<Switch>(8, 50.0, 500.0));
+    topologies.push_back(std::make_shared<FullyConnected>(8, 50.0, 500.0));
+    topologies.push_back(std::make_shared<Mesh2D>(5, 4, 50.0, 500.0));
+    topologies.push_back(std::make_shared<SparseMesh2D>(6, 5, cells, 50.0, 500.0));
+    topologies.push_back(std::make_shared<Torus>(3, 4, 50.0, 500.0));
+    topologies.push_back(construct_topology(NetworkParser("../../input/Ring_FullyConnected_Switch.yml")));
+
+    // meshes get a slower dimension
+    topologies[4]->set_dim_parameters(1, 25.0, 700.0);
+    topologies[5]->set_dim_parameters(1, 25.0, 700.0);
+
+    // test: hops and zero-load latencies match the links of the routes
+    for (const auto& topology : topologies) {
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest++) {
+                if (src == dest) {
+                    continue;
+                }
+                const auto route = topology->route(src, dest);
+                auto expected_latency = EventTime(0);
+                for (auto hop = 0; hop < route.size() - 1; hop++) {
+                    expected_latency += topology->get_link(route.link_id(hop)).communication_delay(chunk_size);
+                }
+                EXPECT_EQ(topology->get_hops_count(src, dest), route.size() - 1) << src << " -> " << dest;
+                EXPECT_EQ(topology->get_zero_load_latency(src, dest, chunk_size), expected_latency);
+            }
+        }
+    }
+
+    // test: a chunk alone in the network arrives after its zero-load latency
+    const auto& mesh = topologies[4];
+    mesh->send(chunk_size, 0, mesh->get_npus_count() - 1, callback, nullptr);
+    event_queue->run_to_completion();
+    EXPECT_EQ(event_queue->get_current_time(), mesh->get_zero_load_latency(0, mesh->get_npus_count() - 1, chunk_size));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkProtocol) {
+    auto framed = Link(0, 1, 50, 500);
+    const auto raw = Link(0, 1, 50, 500);
+    const auto protocol = LinkProtocol{4'096, 64, 10};
+    framed.set_protocol(&protocol);
+
+    // test: every MTU-sized packet pays its header bytes and gap
+    const auto packets_count = (chunk_size + 4'095) / 4'096;
+    EXPECT_EQ(framed.communication_delay(chunk_size),
+              raw.communication_delay(chunk_size + packets_count * 64) + packets_count * ns_to_ticks(10));
+    EXPECT_EQ(framed.communication_delay(1), raw.communication_delay(65) + ns_to_ticks(10));
+
+    // test: the effective bandwidth grows with the transfer size up to the MTU, short of the link bandwidth
+    const auto effective_bandwidth = [&](const ChunkSize size) {
+        return static_cast<double>(size) / static_cast<double>(framed.communication_delay(size) - ns_to_ticks(500));
+    };
+    EXPECT_LT(effective_bandwidth(64), effective_bandwidth(512));
+    EXPECT_LT(effective_bandwidth(512), effective_bandwidth(4'096));
+    const auto raw_serialization_delay = raw.communication_delay(chunk_size) - ns_to_ticks(500);
+    EXPECT_LT(effective_bandwidth(chunk_size), static_cast<double>(chunk_size) / raw_serialization_delay);
+
+    const auto simulate = [&](const bool framing) {
+        auto ring_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(8, 50, 500, false);
+        topology->attach_event_queue(ring_event_queue);
+        if (framing) {
+            topology->set_link_protocol(4'096, 64, 10);
+        }
+        topology->send(chunk_size, 0, 4, callback, nullptr);
+        ring_event_queue->run_to_completion();
+        return ring_event_queue->get_current_time();
+    };
+
+    // test: a topology frames the transfers on all of its links
+    EXPECT_EQ(simulate(false), 4 * raw.communication_delay(chunk_size));
+    EXPECT_EQ(simulate(true), 4 * framed.communication_delay(chunk_size));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, CompressedOutput) {
+    const auto compressions = CompressedOutput::supports(Compression::Gzip)
+                                  ? std::vector<Compression>{Compression::None, Compression::Gzip}
+                                  : std::vector<Compression>{Compression::None};
+
+    // test: bytes stream through small blocks (the writer blocking on a full queue) and read back as written
+    const auto output_path = std::string("compressed_output_test.txt");
+    auto expected = std::string();
+    for (auto i = 0; i < 20'000; i++) {
+        expected += "event " + std::to_string(i % 97) + "\n";
+    }
+    for (const auto compression : compressions) {
+        auto output = CompressedOutput(output_path, compression, 256, 2);
+        for (auto i = static_cast<size_t>(0); i < expected.size(); i += 1'000) {
+            output << expected.substr(i, 1'000);
+        }
+        output.flush();
+        output << "";
+        output.close();
+        EXPECT_FALSE(output.is_open());
+        EXPECT_EQ(output.get_input_size(), expected.size());
+        EXPECT_EQ(CompressedOutput::read_file(output_path), expected);
+        if (compression == Compression::Gzip) {
+            EXPECT_LT(output.get_output_size() * 10, expected.size());
+        } else {
+            EXPECT_EQ(output.get_output_size(), expected.size());
+        }
+    }
+    std::remove(output_path.c_str());
+
+    // test: trace sinks write the same contents compressed or not
+    const auto log_path = std::string("compressed_completion_log_test.bin");
+    const auto trace_path = std::string("compressed_link_trace_test.json");
+    auto logs = std::vector<CompletionColumns>();
+    auto traces = std::vector<std::string>();
+    for (const auto compression : compressions) {
+        auto ring_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(8, 50, 500);
+        topology->attach_event_queue(ring_event_queue);
+        auto completion_log = std::make_shared<CompletionLog>(log_path, 4, compression);
+        auto link_trace = std::make_shared<LinkTrace>(trace_path, 128, compression);
+        topology->set_completion_log(completion_log);
+        topology->set_link_trace(link_trace);
+
+        for (auto src = 0; src < 8; src++) {
+            for (auto dest = 0; dest < 8; dest++) {
+                if (src != dest) {
+                    topology->send(chunk_size, src, dest, callback, nullptr);
+                }
+            }
+        }
+        ring_event_queue->run_to_completion();
+        completion_log->close();
+        link_trace->close();
+
+        logs.push_back(CompletionLog::read_log(log_path));
+        traces.push_back(CompressedOutput::read_file(trace_path));
+    }
+    for (auto i = static_cast<size_t>(1); i < logs.size(); i++) {
+        EXPECT_EQ(logs[i].chunk_ids, logs[0].chunk_ids);
+        EXPECT_EQ(logs[i].arrival_times, logs[0].arrival_times);
+        EXPECT_EQ(traces[i], traces[0]);
+    }
+    EXPECT_EQ(logs[0].size(), 56);
+    EXPECT_EQ(traces[0].substr(traces[0].size() - 3), "]}\n");
+
+    std::remove(log_path.c_str());
+    std::remove(trace_path.c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, DeterministicOrder) {
+    // events record their key in invocation order, the first one scheduling more events at the same time
+    struct OrderedEvent {
+        EventQueue* event_queue;
+        std::vector<uint64_t>* invoked_keys;
+        uint64_t key;
+        std::vector<OrderedEvent>* scheduled_events;
+    };
+    const auto invoke = [](void* const event_ptr) {
+        auto* const event = static_cast<OrderedEvent*>(event_ptr);
+        event->invoked_keys->push_back(event->key);
+        if (event->scheduled_events != nullptr) {
+            for (auto& scheduled_event : *event->scheduled_events) {
+                event->event_queue->schedule_event(event->event_queue->get_current_time(), +[](void* const ptr) {
+                    auto* const event = static_cast<OrderedEvent*>(ptr);
+                    event->invoked_keys->push_back(event->key);
+                }, &scheduled_event);
+            }
+        }
+    };
+    const auto order_key = [](void* const event_ptr) -> uint64_t {
+        return static_cast<OrderedEvent*>(event_ptr)->key;
+    };
+
+    auto ordered_event_queue = EventQueue();
+    ordered_event_queue.register_event_order_key(+invoke, +order_key);
+    ordered_event_queue.set_deterministic_order(true);
+    auto invoked_keys = std::vector<uint64_t>();
+    auto scheduled_events = std::vector<OrderedEvent>{{nullptr, &invoked_keys, 9, nullptr},
+                                                      {nullptr, &invoked_keys, 7, nullptr}};
+    auto events = std::vector<OrderedEvent>{{&ordered_event_queue, &invoked_keys, 3, nullptr},
+                                            {&ordered_event_queue, &invoked_keys, 1, &scheduled_events},
+                                            {&ordered_event_queue, &invoked_keys, 2, nullptr},
+                                            {&ordered_event_queue, &invoked_keys, 1, nullptr}};
+    for (auto& event : events) {
+        ordered_event_queue.schedule_event(100, +invoke, &event);
+    }
+    ordered_event_queue.run_to_completion();
+
+    // test: same-time events run by key (ties in registration order), then the ones they scheduled, by key again
+    // (the scheduled events have an unregistered callback, so key 0 to the event queue)
+    EXPECT_EQ(invoked_keys, (std::vector<uint64_t>{1, 1, 2, 3, 9, 7}));
+
+    // every chunk of an all-to-all records its delivery time
+    struct Delivery {
+        std::function<EventTime()> current_time;
+        EventTime* delivery_time;
+    };
+    const auto record_delivery = [](void* const delivery_ptr) {
+        const auto* const delivery = static_cast<Delivery*>(delivery_ptr);
+        *delivery->delivery_time = delivery->current_time();
+    };
+    const auto simulate = [&](const int partitions_count) {
+        auto topology = std::make_shared<Mesh2D>(4, 4, 50, 500);
+        auto sequential_event_queue = std::make_shared<EventQueue>();
+        topology->attach_event_queue(sequential_event_queue);
+        auto simulation = std::unique_ptr<ParallelSimulation>();
+        if (partitions_count > 0) {
+            // (parallel simulations run in the deterministic order by default)
+            simulation = std::make_unique<ParallelSimulation>(topology, partitions_count, 2);
+        } else {
+            sequential_event_queue->set_deterministic_order(true);
+            Topology::register_event_order_keys(*sequential_event_queue);
+        }
+
+        const auto npus_count = topology->get_npus_count();
+        auto delivery_times = std::vector<EventTime>(npus_count * npus_count);
+        auto deliveries = std::vector<Delivery>();
+        deliveries.reserve(delivery_times.size());
+        for (auto src = 0; src < npus_count; src++) {
+            for (auto dest = 0; dest < npus_count; dest++) {
+                if (src == dest) {
+                    continue;
+                }
+                auto current_time = std::function<EventTime()>();
+                if (simulation != nullptr) {
+                    current_time = [&] { return simulation->get_current_time(); };
+                } else {
+                    current_time = [&] { return sequential_event_queue->get_current_time(); };
+                }
+                deliveries.push_back({current_time, &delivery_times[src * npus_count + dest]});
+                if (simulation != nullptr) {
+                    simulation->send(chunk_size, src, dest, +record_delivery, &deliveries.back());
+                } else {
+                    topology->send(chunk_size, src, dest, +record_delivery, &deliveries.back());
+                }
+            }
+        }
+
+        if (simulation != nullptr) {
+            simulation->run();
+        } else {
+            sequential_event_queue->run_to_completion();
+        }
+        return delivery_times;
+    };
+
+    // test: every chunk is delivered at the same time, sequentially or over any partitioning
+    const auto sequential_delivery_times = simulate(0);
+    EXPECT_EQ(simulate(2), sequential_delivery_times);
+    EXPECT_EQ(simulate(4), sequential_delivery_times);
+    EXPECT_EQ(simulate(16), sequential_delivery_times);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, EventCancellation) {
+    // events record their invocation time
+    struct TimedEvent {
+        EventQueue* event_queue;
+        EventTime invoked_time;
+    };
+    const auto invoke = [](void* const event_ptr) {
+        auto* const event = static_cast<TimedEvent*>(event_ptr);
+        event->invoked_time = event->event_queue->get_current_time();
+    };
+
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::Heap, EventQueueType::TimingWheel}) {
+        auto cancellable_event_queue = EventQueue(event_queue_type);
+        auto events = std::vector<TimedEvent>(4, {&cancellable_event_queue, 0});
+        const auto cancelled = cancellable_event_queue.schedule_cancellable_event(100, +invoke, &events[0]);
+        const auto rescheduled = cancellable_event_queue.schedule_cancellable_event(200, +invoke, &events[1]);
+        cancellable_event_queue.schedule_cancellable_event(300, +invoke, &events[2]);
+        const auto last = cancellable_event_queue.schedule_cancellable_event(1'000, +invoke, &events[3]);
+
+        // test: cancelling is only valid once, and rescheduling hands out a new handle
+        EXPECT_TRUE(cancellable_event_queue.cancel(cancelled));
+        EXPECT_FALSE(cancellable_event_queue.cancel(cancelled));
+        EXPECT_FALSE(cancellable_event_queue.is_scheduled(cancelled));
+        const auto moved = cancellable_event_queue.reschedule(rescheduled, 400);
+        EXPECT_FALSE(cancellable_event_queue.is_scheduled(rescheduled));
+        EXPECT_TRUE(cancellable_event_queue.is_scheduled(moved));
+        EXPECT_FALSE(cancellable_event_queue.is_scheduled(cancellable_event_queue.reschedule(rescheduled, 500)));
+        EXPECT_TRUE(cancellable_event_queue.cancel(last));
+
+        // test: cancelled events never run, rescheduled ones run at their new time,
+        // and trailing cancelled events don't advance the completion time
+        EXPECT_EQ(cancellable_event_queue.run_to_completion(), 400);
+        EXPECT_EQ(events[0].invoked_time, 0);
+        EXPECT_EQ(events[1].invoked_time, 400);
+        EXPECT_EQ(events[2].invoked_time, 300);
+        EXPECT_EQ(events[3].invoked_time, 0);
+        EXPECT_TRUE(cancellable_event_queue.finished());
+
+        // test: handles of invoked events are stale, even once their slot is reused
+        EXPECT_FALSE(cancellable_event_queue.cancel(moved));
+        const auto reused = cancellable_event_queue.schedule_cancellable_event(500, +invoke, &events[0]);
+        EXPECT_FALSE(cancellable_event_queue.is_scheduled(moved));
+        EXPECT_FALSE(cancellable_event_queue.is_scheduled(cancelled));
+        EXPECT_TRUE(cancellable_event_queue.is_scheduled(reused));
+        cancellable_event_queue.run_to_completion();
+        EXPECT_EQ(events[0].invoked_time, 500);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkOverrides) {
+    const auto config = std::string("topology: [ Mesh2D ]\nnpus_count: [ 16 ]\nwidth: 4\nheight: 4\n"
+                                    "bandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\n"
+                                    "link_classes: { degraded: { bandwidth: 25.0, latency: 1000.0 } }\n"
+                                    "link_overrides:\n"
+                                    "  - { row: 3, bandwidth: 100.0, latency: 500.0 }\n"
+                                    "  - { column: 0, class: degraded }\n"
+                                    "  - { pair: [ 12, 13 ], bandwidth: 25.0, latency: 1000.0 }\n"
+                                    "  - { pair: [ 5, 6 ], class: degraded }\n");
+    const auto network_parser = NetworkParser(YAML::Load(config));
+
+    // test: overrides of the same parameters share their class
+    EXPECT_EQ(network_parser.get_link_classes().size(), 2);
+    EXPECT_EQ(network_parser.get_link_group_overrides().size(), 2);
+    EXPECT_EQ(network_parser.get_link_pair_overrides().size(), 2);
+
+    // test: groups are overridden, then device pairs refine them in both directions
+    const auto topology = construct_topology(network_parser);
+    const auto bandwidth_of = [&](const DeviceId src, const DeviceId dest) {
+        return topology->get_link(topology->find_link(src, dest)).get_bandwidth();
+    };
+    EXPECT_EQ(bandwidth_of(14, 15), 100.0);
+    EXPECT_EQ(bandwidth_of(4, 8), 25.0);
+    EXPECT_EQ(bandwidth_of(12, 13), 25.0);
+    EXPECT_EQ(bandwidth_of(13, 12), 25.0);
+    EXPECT_EQ(bandwidth_of(6, 5), 25.0);
+    EXPECT_EQ(topology->get_link(topology->find_link(6, 5)).get_latency(), 1000.0);
+    EXPECT_EQ(bandwidth_of(5, 9), 50.0);
+
+    // test: lazy links pick up their override once materialized, and so do the instances sharing the layout
+    const auto fully_connected = std::make_shared<FullyConnected>(64, 50, 500);
+    fully_connected->set_link_parameters(2, 5, 25, 1000);
+    EXPECT_EQ(fully_connected->get_materialized_links_count(), 0);
+    EXPECT_EQ(fully_connected->get_link(fully_connected->find_link(2, 5)).get_bandwidth(), 25.0);
+    EXPECT_EQ(fully_connected->get_link(fully_connected->find_link(5, 2)).get_bandwidth(), 50.0);
+    const auto instance = TopologyInstance(std::make_shared<SharedTopology>(fully_connected));
+    EXPECT_EQ(instance.get_link(instance.find_link(2, 5)).get_bandwidth(), 25.0);
+
+    // test: overrides survive the compiled form
+    const auto config_path = std::string("link_overrides.yml");
+    std::ofstream(config_path) << config;
+    static_cast<void>(NetworkParser::load_cached(config_path));  // compiles the config
+    const auto loaded = NetworkParser::load_cached(config_path);
+    ASSERT_EQ(loaded.get_link_classes().size(), 2);
+    EXPECT_EQ(loaded.get_link_classes()[0].latency, 1000.0);
+    EXPECT_EQ(loaded.get_link_classes()[1].bandwidth, 100.0);
+    ASSERT_EQ(loaded.get_link_group_overrides().size(), 2);
+    EXPECT_EQ(loaded.get_link_group_overrides()[1].group, "column 0");
+    ASSERT_EQ(loaded.get_link_pair_overrides().size(), 2);
+    EXPECT_EQ(loaded.get_link_pair_overrides()[1].src, 5);
+    EXPECT_EQ(loaded.get_link_pair_overrides()[1].link_class, 0);
+    std::remove(config_path.c_str());
+    std::remove((config_path + ".bin").c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SwitchModel) {
+    /// setup: on an 8-NPU switch, the given pairs each send a chunk at once, recording the finish time
+    const auto run = [&](const std::vector<std::pair<DeviceId, DeviceId>>& pairs, const Bandwidth crossbar_bandwidth,
+                         const Latency traversal_latency, const ChunkSize port_buffer_capacity) {
+        auto switch_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Switch>(8, 50, 500);
+        topology->attach_event_queue(switch_event_queue);
+        if (crossbar_bandwidth > 0 || traversal_latency > 0 || port_buffer_capacity > 0) {
+            topology->set_switch_model(crossbar_bandwidth, traversal_latency, port_buffer_capacity);
+        }
+        auto arrivals_count = 0;
+        const auto count_arrival = [](void* const arg) {
+            (*static_cast<int*>(arg))++;
+        };
+        for (const auto& [src, dest] : pairs) {
+            topology->send(chunk_size, src, dest, count_arrival, &arrivals_count);
+        }
+        switch_event_queue->run_to_completion();
+        EXPECT_EQ(arrivals_count, pairs.size());
+        if (topology->get_switch_model() != nullptr) {
+            EXPECT_EQ(topology->get_switch_model()->get_switched_chunks_count(8), pairs.size());
+        }
+        const auto backpressure_time = topology->get_link(topology->find_link(0, 8)).get_stats().backpressure_time;
+        return std::make_pair(switch_event_queue->get_current_time(), backpressure_time);
+    };
+
+    /// test: the traversal latency adds up to the link latencies
+    const auto single_pair = std::vector<std::pair<DeviceId, DeviceId>>{{0, 1}};
+    const auto unmodeled_time = run(single_pair, 0, 0, 0).first;
+    EXPECT_EQ(run(single_pair, 0, 100, 0).first - unmodeled_time, 100 * ticks_per_ns);
+
+    /// test: disjoint pairs only contend inside the switch, and a crossbar as fast as a link serializes them
+    const auto disjoint_pairs = std::vector<std::pair<DeviceId, DeviceId>>{{0, 1}, {2, 3}, {4, 5}, {6, 7}};
+    EXPECT_EQ(run(disjoint_pairs, 0, 0, 0).first, unmodeled_time);
+    const auto full_crossbar_time = run(disjoint_pairs, 200, 0, 0).first;
+    const auto saturated_crossbar_time = run(disjoint_pairs, 50, 0, 0).first;
+    EXPECT_GT(full_crossbar_time, unmodeled_time);
+    EXPECT_GT(saturated_crossbar_time, full_crossbar_time);
+
+    /// test: a single-chunk output port holds the chunks of an incast back at their input links
+    const auto incast_pairs = std::vector<std::pair<DeviceId, DeviceId>>{{0, 7}, {0, 7}, {1, 7}, {1, 7}, {0, 1}};
+    EXPECT_EQ(run(incast_pairs, 0, 0, 0).second, 0);
+    EXPECT_GT(run(incast_pairs, 0, 0, chunk_size).second, 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Mesh3D) {
+    // test: two stacked 4x4 layers, with faster vertical links
+    const auto network_parser = NetworkParser("../../input/Mesh3D.yml");
+    const auto topology = std::dynamic_pointer_cast<Mesh3D>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+    EXPECT_EQ(topology->get_basic_topology_type(), TopologyBuildingBlock::Mesh3D);
+    EXPECT_EQ(topology->get_npus_count_per_dim(), (std::vector<int>{4, 4, 2}));
+    EXPECT_EQ(topology->get_bandwidth_per_dim(), (std::vector<Bandwidth>{50, 50, 200}));
+    EXPECT_EQ(topology->get_links_count(), 2 * (2 * 2 * 4 * 3 + 16));
+    EXPECT_EQ(topology->get_link(topology->find_link(0, 16)).get_bandwidth(), 200.0);
+    EXPECT_EQ(topology->get_link(topology->find_link(0, 1)).get_bandwidth(), 50.0);
+    EXPECT_EQ(topology->get_link_group(topology->find_link(5, 21)), "pillar 1,1");
+
+    // test: dimension-order routing (X, then Y, then Z), matching the closed-form hops count
+    const auto route = topology->compute_route(0, 31);
+    EXPECT_EQ(route, (Route{0, 1, 2, 3, 7, 11, 15, 31}));
+    for (auto src = 0; src < 32; src++) {
+        for (auto dest = 0; dest < 32; dest++) {
+            EXPECT_EQ(topology->route(src, dest).size() - 1, topology->get_hops_count(src, dest));
+        }
+    }
+
+    // test: a vertical hop costs the vertical link delay
+    const auto planar_delay = topology->get_zero_load_latency(0, 1, chunk_size);
+    const auto vertical_delay = topology->get_zero_load_latency(0, 16, chunk_size);
+    EXPECT_LT(vertical_delay, planar_delay);
+    EXPECT_EQ(topology->get_zero_load_latency(0, 17, chunk_size), planar_delay + vertical_delay);
+
+    // test: excluded cells are numbered around, and routes go around them (3x1x2 mesh without (1, 0, 0))
+    auto valid_cells = std::vector<bool>(6, true);
+    valid_cells[1] = false;
+    const auto sparse = Mesh3D(3, 1, 2, valid_cells, 50, 500, 50, 500);
+    EXPECT_EQ(sparse.get_npus_count(), 5);
+    EXPECT_EQ(sparse.get_npu_at(1, 0, 0), -1);
+    EXPECT_EQ(sparse.get_npu_at(2, 0, 0), 1);
+    EXPECT_EQ(sparse.get_coords(3), (std::array<int, 3>{1, 0, 1}));
+    EXPECT_EQ(sparse.compute_route(0, 1), (Route{0, 2, 3, 4, 1}));
+    EXPECT_EQ(sparse.get_hops_count(0, 1), 4);
+
+    // test: [x, y, z] excluded cells shape the mesh from the config
+    const auto config_path = std::string("mesh_3d.yml");
+    std::ofstream(config_path) << "topology: [ Mesh3D ]\nnpus_count: [ 7 ]\nwidth: 2\nheight: 2\ndepth: 2\n"
+                               << "bandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\nexcluded: [ [1, 1, 1] ]\n";
+    const auto sparse_topology = std::dynamic_pointer_cast<Mesh3D>(construct_topology(NetworkParser(config_path)));
+    std::remove(config_path.c_str());
+    ASSERT_NE(sparse_topology, nullptr);
+    EXPECT_EQ(sparse_topology->get_npu_at(1, 1, 1), -1);
+    EXPECT_EQ(sparse_topology->get_links_count(), 2 * (12 - 3));
+    EXPECT_EQ(sparse_topology->get_bandwidth_per_dim()[2], 50.0);
+
+    // run communication: 7 hops, 1 of them vertical
+    topology->send(chunk_size, 0, 31, callback, nullptr);
+    event_queue->run_to_completion();
+    EXPECT_EQ(topology->get_chunk_stats().hops_count, 7);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LocalityOrder) {
+    // test: every cell is visited once, and consecutive cells are neighbors on a square grid
+    const auto order = locality_order(8, 8);
+    ASSERT_EQ(order.size(), 64);
+    EXPECT_EQ(std::set<int>(order.begin(), order.end()).size(), 64);
+    for (auto i = 0; i + 1 < 64; i++) {
+        EXPECT_EQ(std::abs(order[i] % 8 - order[i + 1] % 8) + std::abs(order[i] / 8 - order[i + 1] / 8), 1);
+    }
+
+    // test: grids with a longer side are cut into squares along it
+    const auto wide_order = locality_order(10, 3);
+    ASSERT_EQ(wide_order.size(), 30);
+    EXPECT_EQ(std::set<int>(wide_order.begin(), wide_order.end()).size(), 30);
+    EXPECT_EQ(locality_order(1, 5), (std::vector<int>{0, 1, 2, 3, 4}));
+
+    // test: most vertically adjacent links of a large mesh are less than a page of links apart
+    // (they're all a row of links apart in row-major order)
+    const auto mesh = Mesh2D(64, 64, 50, 500);
+    auto close_links_count = 0;
+    for (auto y = 0; y + 1 < 64; y++) {
+        for (auto x = 0; x + 1 < 64; x++) {
+            const auto npu = y * 64 + x;
+            const auto distance = std::abs(mesh.find_link(npu, npu + 1) - mesh.find_link(npu + 64, npu + 65));
+            close_links_count += (distance < LinkTable::page_size) ? 1 : 0;
+        }
+    }
+    EXPECT_GT(close_links_count, 63 * 63 * 3 / 4);
+
+    // test: routes are unaffected by the link layout
+    EXPECT_EQ(mesh.compute_route(0, 65), (Route{0, 1, 65}));
+    EXPECT_EQ(mesh.get_hops_count(0, 4095), 126);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Profiler) {
+    // setup: 4 chunks across a ring
+    auto profiled_event_queue = std::make_shared<EventQueue>();
+    const auto ring = std::make_shared<Ring>(8, 50, 500);
+    ring->attach_event_queue(profiled_event_queue);
+    Profiler::reset();
+    for (auto src = 0; src < 4; src++) {
+        ring->send(chunk_size, src, src + 2, callback, nullptr);
+    }
+    profiled_event_queue->run_to_completion();
+
+    // test: every zone is accounted once per occurrence (nothing if profiling is compiled out)
+    const auto calls_of = [](const ProfileZone zone) {
+        return Profiler::get_counters(zone).calls;
+    };
+    if constexpr (!profiling_enabled) {
+        EXPECT_EQ(calls_of(ProfileZone::EventLoop), 0);
+        return;
+    }
+    EXPECT_GT(calls_of(ProfileZone::EventLoop), 0);
+    EXPECT_EQ(calls_of(ProfileZone::Send), 8);
+    EXPECT_EQ(calls_of(ProfileZone::Route), 4);
+    EXPECT_EQ(calls_of(ProfileZone::ChunkArrival), 8);
+    EXPECT_EQ(calls_of(ProfileZone::Callback), 4);
+    EXPECT_GE(calls_of(ProfileZone::LinkSend), 8);
+
+    // test: nested zones take a share of the event loop
+    EXPECT_GE(Profiler::get_counters(ProfileZone::EventLoop).cycles,
+              Profiler::get_counters(ProfileZone::ChunkArrival).cycles);
+    auto report = std::ostringstream();
+    Profiler::report(report);
+    EXPECT_NE(report.str().find("chunk_arrival"), std::string::npos);
+    EXPECT_NE(report.str().find("callback"), std::string::npos);
+
+    // test: reset clears the counters
+    Profiler::reset();
+    EXPECT_EQ(calls_of(ProfileZone::Send), 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BandwidthSchedule) {
+    /// setup: a 4-NPU ring whose link 0 -> 1 is throttled to 25 GB/s from 10 us, then upgraded to 100 GB/s at 1 ms,
+    /// sending a chunk over it from the given time and returning its latency
+    const auto schedule = BandwidthSchedule{{ns_to_ticks(10'000), 25}, {ns_to_ticks(1'000'000), 100}};
+    const auto ring = std::make_shared<Ring>(4, 50, 500);
+    ring->attach_event_queue(event_queue);
+    ring->set_link_bandwidth_schedule(0, 1, schedule);
+    const auto latency_from = [&](const EventTime time) {
+        event_queue->schedule_event(time, callback, nullptr);
+        event_queue->run_to_completion();
+        ring->send(chunk_size, 0, 1, callback, nullptr);
+        event_queue->run_to_completion();
+        return event_queue->get_current_time() - time;
+    };
+    const auto latency_at = [&](const Bandwidth bandwidth) {
+        return ns_to_ticks(500 + static_cast<double>(chunk_size) / bw_GBps_to_Bpns(bandwidth));
+    };
+
+    // test: a chunk is serialized at the bandwidth in effect when it starts
+    const auto full_latency = latency_from(0);
+    EXPECT_NEAR(full_latency, latency_at(50), 1);
+    EXPECT_NEAR(latency_from(ns_to_ticks(20'000)), latency_at(25), 1);
+    EXPECT_NEAR(latency_from(ns_to_ticks(2'000'000)), latency_at(100), 1);
+
+    // test: reset rewinds the schedule
+    event_queue->reset();
+    ring->reset();
+    EXPECT_EQ(latency_from(0), full_latency);
+
+    // test: the same holds in virtual time
+    event_queue->reset();
+    ring->reset();
+    ring->set_link_model(LinkModel::VirtualTime);
+    EXPECT_EQ(latency_from(0), full_latency);
+    EXPECT_NEAR(latency_from(ns_to_ticks(20'000)), latency_at(25), 1);
+
+    // test: link classes carry their schedule, in the compiled form too
+    const auto config = std::string("topology: [ Ring ]\nnpus_count: [ 4 ]\nbandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\n"
+                                    "link_classes: { throttled: { bandwidth: 50.0, latency: 500.0, "
+                                    "bandwidth_schedule: [ [ 10000, 25.0 ] ] } }\n"
+                                    "link_overrides: [ { pair: [ 0, 1 ], class: throttled } ]\n");
+    const auto config_path = std::string("bandwidth_schedule.yml");
+    std::ofstream(config_path) << config;
+    static_cast<void>(NetworkParser::load_cached(config_path));  // compiles the config
+    const auto loaded = NetworkParser::load_cached(config_path);
+    ASSERT_EQ(loaded.get_link_classes().size(), 1);
+    ASSERT_EQ(loaded.get_link_classes()[0].bandwidth_schedule.size(), 1);
+    EXPECT_EQ(loaded.get_link_classes()[0].bandwidth_schedule[0].second, 25.0);
+    const auto topology = construct_topology(loaded);
+    const auto* const link_schedule = topology->get_link(topology->find_link(1, 0)).get_bandwidth_schedule();
+    ASSERT_NE(link_schedule, nullptr);
+    EXPECT_EQ((*link_schedule)[0].time, ns_to_ticks(10'000));
+    EXPECT_EQ(topology->get_link(topology->find_link(1, 2)).get_bandwidth_schedule(), nullptr);
+    std::remove(config_path.c_str());
+    std::remove((config_path + ".bin").c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, Message) {
+    /// setup: on an 8-NPU ring, 4 chunks from NPU 0 to NPU 3, sent as a message or one by one,
+    /// optionally behind a large chunk occupying the link 1 -> 2, returning the arrival times of the 4 chunks
+    struct Arrivals {
+        EventQueue* event_queue;
+        std::vector<EventTime> times;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrivals = static_cast<Arrivals*>(arg);
+        arrivals->times.push_back(arrivals->event_queue->get_current_time());
+    };
+    const auto run = [&](const bool as_message, const bool contended) {
+        auto message_event_queue = std::make_shared<EventQueue>();
+        auto ring = std::make_shared<Ring>(8, 50, 500);
+        ring->attach_event_queue(message_event_queue);
+        auto arrivals = Arrivals{message_event_queue.get(), {}};
+        if (contended) {
+            ring->send(4 * chunk_size, 1, 2, callback, nullptr);
+        }
+        if (as_message) {
+            ring->send_message(chunk_size, 4, 0, 3, record_arrival, &arrivals);
+        } else {
+            for (auto i = 0; i < 4; i++) {
+                ring->send(chunk_size, 0, 3, record_arrival, &arrivals);
+            }
+        }
+        message_event_queue->run_to_completion();
+        EXPECT_EQ(ring->get_chunk_stats().chunks_delivered, stats_enabled ? (contended ? 5 : 4) : 0);
+        return arrivals.times;
+    };
+
+    // test: the chunks of a message arrive as if sent one by one (up to rounding), pipelined across the hops
+    for (const auto contended : {false, true}) {
+        const auto message_arrivals = run(true, contended);
+        const auto chunk_arrivals = run(false, contended);
+        ASSERT_EQ(message_arrivals.size(), 4);
+        ASSERT_EQ(chunk_arrivals.size(), 4);
+        for (auto i = 0; i < 4; i++) {
+            EXPECT_NEAR(message_arrivals[i], chunk_arrivals[i], 4);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, NetworkConfig) {
+    // the yml configuration, built in memory
+    const auto network_parser = NetworkParser(YAML::Load(
+        "topology: [ Mesh2D ]\nnpus_count: [ 20 ]\nwidth: 6\nheight: 4\nbandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\n"
+        "excluded: [ [2, 1, 3, 2] ]\nnpu_placement: Snake\nrouting: O1Turn\n"
+        "link_overrides: [ { row: 0, bandwidth: 100.0, latency: 200.0 } ]\n"));
+    const auto network_config = NetworkConfig()
+                                    .add_dim(TopologyBuildingBlock::Mesh2D, 20, 50, 500)
+                                    .set_mesh_size(6, 4)
+                                    .exclude_region(2, 1, 3, 2)
+                                    .set_placement_pattern(PlacementPattern::Snake)
+                                    .set_mesh_routing(MeshRouting::O1Turn)
+                                    .override_link_group("row 0", 100, 200);
+
+    // test: same configuration as the yml one, the Mesh2D with excluded cells becoming a SparseMesh2D
+    const auto built_parser = NetworkParser(network_config);
+    EXPECT_EQ(built_parser.get_config_hash(), network_parser.get_config_hash());
+    EXPECT_EQ(built_parser.get_topologies_per_dim()[0], TopologyBuildingBlock::SparseMesh2D);
+
+    // test: same chunk arrival times as the topology of the yml one
+    auto arrival_times = std::vector<EventTime>();
+    for (const auto built : {false, true}) {
+        const auto topology = built ? construct_topology(network_config, event_queue)
+                                    : construct_topology(network_parser, event_queue);
+        const auto start_time = event_queue->get_current_time();
+        for (auto dest = 1; dest < topology->get_npus_count(); dest++) {
+            auto route = topology->route(0, dest);
+            auto chunk = std::make_unique<Chunk>(chunk_size, std::move(route), callback, nullptr);
+            topology->send(std::move(chunk));
+        }
+        while (!event_queue->finished()) {
+            event_queue->proceed();
+        }
+        arrival_times.push_back(event_queue->get_current_time() - start_time);
+    }
+    EXPECT_EQ(arrival_times[0], arrival_times[1]);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RecoverableConfigErrors) {
+    const auto has_error = [](const std::vector<ConfigError>& errors, const std::string& key) {
+        return std::any_of(errors.begin(), errors.end(), [&key](const ConfigError& error) {
+            return error.key == key;
+        });
+    };
+
+    // test: every error of a yml configuration is collected, instead of exiting
+    auto errors = std::vector<ConfigError>();
+    const auto bad_parser = NetworkParser::try_parse(
+        YAML::Load("topology: [ Ring, Hexagon ]\nnpus_count: [ 8, 1 ]\nbandwidth: [ 50.0, -1.0 ]\n"
+                   "latency: [ 500.0, 500.0 ]\nrouting: Zigzag\n"),
+        errors);
+    EXPECT_FALSE(bad_parser.has_value());
+    EXPECT_TRUE(has_error(errors, "topology"));
+    EXPECT_TRUE(has_error(errors, "npus_count"));
+    EXPECT_TRUE(has_error(errors, "bandwidth"));
+    EXPECT_TRUE(has_error(errors, "routing"));
+
+    // test: values of the wrong type are errors too
+    errors.clear();
+    EXPECT_FALSE(NetworkParser::try_parse(YAML::Load("topology: [ Ring ]\nnpus_count: [ 8 ]\nbandwidth: [ 50.0 ]\n"
+                                                     "latency: [ 500.0 ]\nwidth: wide\n"),
+                                          errors)
+                     .has_value());
+    EXPECT_EQ(errors.size(), 1);
+
+    // test: a valid configuration parses as with the constructor
+    errors.clear();
+    const auto ring_parser = NetworkParser::try_parse(YAML::LoadFile("../../input/Ring.yml"), errors);
+    ASSERT_TRUE(ring_parser.has_value());
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(ring_parser->get_config_hash(), NetworkParser("../../input/Ring.yml").get_config_hash());
+
+    // a sweep with invalid points: a single NPU, a Mesh2D stacked with a Ring, a negative link override
+    const auto ring = NetworkConfig().add_dim(TopologyBuildingBlock::Ring, 8, 50, 500);
+    auto network_configs = std::vector<NetworkConfig>(5, ring);
+    network_configs[1] = NetworkConfig().add_dim(TopologyBuildingBlock::Ring, 1, 50, 500);
+    network_configs[2].add_dim(TopologyBuildingBlock::Mesh2D, 4, 50, 500);
+    network_configs[3].override_link_pair(0, 1, -50, 500);
+    network_configs[4].override_link_pair(0, 1, 100, 500);
+    const auto sweep = Sweep(network_configs);
+    const auto results = sweep.run(
+        [](Topology& topology) {
+            topology.send(1'048'576, 0, 4, callback, nullptr);
+        },
+        2);
+
+    // test: the invalid points are reported with their errors, the others simulated
+    ASSERT_EQ(results.size(), 5);
+    for (const auto point_id : {0, 4}) {
+        EXPECT_TRUE(results[point_id].config_errors.empty());
+        EXPECT_GT(results[point_id].finish_time, 0);
+    }
+    for (const auto point_id : {1, 2, 3}) {
+        EXPECT_EQ(results[point_id].topology_type, TopologyBuildingBlock::Undefined);
+        EXPECT_EQ(results[point_id].finish_time, 0);
+    }
+    EXPECT_TRUE(has_error(results[1].config_errors, "npus_count"));
+    EXPECT_TRUE(has_error(results[2].config_errors, "topology"));
+    EXPECT_TRUE(has_error(results[3].config_errors, "link_overrides"));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkFreeRuns) {
+    /// setup: every NPU of a Switch sends 4 chunks to its neighbor,
+    /// so every up/down link gets free at the same ticks, as chunks arrive at the switch
+    const auto npus_count = 8;
+    const auto chunks_count = 4;
+    const auto topology = std::make_shared<Switch>(npus_count, 50, 500);
+    const auto hop_delay = topology->get_link(topology->find_link(0, npus_count)).communication_delay(chunk_size);
+    const auto serialization_delay = hop_delay - ns_to_ticks(500);
+
+    struct Arrivals {
+        EventQueue* event_queue;
+        std::vector<EventTime> times;
+    };
+    auto arrivals = std::vector<Arrivals>(npus_count, Arrivals{event_queue.get(), {}});
+    for (auto chunk = 0; chunk < chunks_count; chunk++) {
+        for (auto src = 0; src < npus_count; src++) {
+            const auto dest = (src + 1) % npus_count;
+            topology->send(
+                chunk_size, src, dest,
+                [](void* const arrivals_ptr) {
+                    auto* const dest_arrivals = static_cast<Arrivals*>(arrivals_ptr);
+                    dest_arrivals->times.push_back(dest_arrivals->event_queue->get_current_time());
+                },
+                &arrivals[dest]);
+        }
+    }
+    event_queue->run_to_completion();
+
+    /// test: the links freed together still serve their chunks back to back, as when freed one by one
+    for (const auto& dest_arrivals : arrivals) {
+        ASSERT_EQ(dest_arrivals.times.size(), chunks_count);
+        for (auto chunk = 0; chunk < chunks_count; chunk++) {
+            EXPECT_EQ(dest_arrivals.times[chunk], chunk * serialization_delay + 2 * hop_delay);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SendGraph) {
+    /// setup: 0 -> 1, then both 1 -> 2 and a 1 us wait, then 2 -> 3 once both completed,
+    /// and two independent 0 -> 1 sends queued behind the first one
+    auto graph = SendGraph();
+    const auto first = graph.add_send(0, 1, chunk_size);
+    const auto second = graph.add_send(1, 2, chunk_size);
+    const auto wait = graph.add_send(1, 1, 0, 1'000);
+    const auto last = graph.add_send(2, 3, chunk_size);
+    graph.add_dependency(first, second);
+    graph.add_dependency(first, wait);
+    graph.add_dependency(second, last);
+    graph.add_dependency(wait, last);
+    graph.add_send(0, 1, chunk_size);
+    graph.add_send(0, 1, chunk_size);
+    graph.finalize();
+
+    /// test: dependencies are stored per node
+    EXPECT_EQ(graph.get_nodes_count(), 6);
+    EXPECT_EQ(graph.get_dependencies_count(), 4);
+    EXPECT_EQ(graph.get_node_dependencies_count(last), 2);
+    const auto [dependents_begin, dependents_end] = graph.get_dependents(first);
+    EXPECT_EQ(std::vector<SendNodeId>(dependents_begin, dependents_end), std::vector<SendNodeId>({second, wait}));
+    EXPECT_EQ(graph.get_delay(wait), 1'000);
+    EXPECT_EQ(graph.get_delay(first), 0);
+    EXPECT_EQ(graph.get_max_npu_id(), 3);
+
+    const auto topology = std::make_shared<Ring>(4, 50, 500);
+    auto network = ExecutionTraceAdapter(topology);
+    auto run = SendGraphRun(network, graph);
+    run.start();
+    event_queue->run_to_completion();
+
+    /// test: a node is sent once its dependencies completed, so the chain takes 3 hops,
+    /// while the independent sends are still queued on link 0 -> 1 when the first one completes
+    const auto hop_delay = topology->get_link(topology->find_link(0, 1)).communication_delay(chunk_size);
+    EXPECT_TRUE(run.finished());
+    EXPECT_EQ(run.get_completed_nodes_count(), 6);
+    EXPECT_EQ(run.get_finish_time(), 3 * hop_delay);
+    EXPECT_EQ(run.get_peak_in_flight_count(), 4);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkLoad) {
+    /// setup: 3 chunks sent from NPU 0 to NPU 1 of a Ring at once
+    const auto topology = std::make_shared<Ring>(4, 50, 500);
+    const auto link_id = topology->find_link(0, 1);
+    const auto serialization_delay =
+        topology->get_link(link_id).communication_delay(chunk_size) - ns_to_ticks(500);
+    for (auto i = 0; i < 3; i++) {
+        topology->send(chunk_size, 0, 1, callback, nullptr);
+    }
+
+    /// test: one chunk is served, the others pending
+    auto load = topology->get_link_load(link_id);
+    EXPECT_EQ(load.queued_chunks, 3);
+    EXPECT_EQ(load.pending_bytes, 2 * chunk_size);
+    EXPECT_EQ(load.busy_until, serialization_delay);
+
+    /// test: once the first chunk is serialized, the next one is served
+    event_queue->run_until(serialization_delay);
+    load = topology->get_link_load(link_id);
+    EXPECT_EQ(load.queued_chunks, 2);
+    EXPECT_EQ(load.pending_bytes, chunk_size);
+    EXPECT_EQ(load.busy_until, 2 * serialization_delay);
+
+    /// test: a snapshot holds every link, the others idle
+    auto loads = std::vector<LinkLoad>(topology->get_links_count());
+    topology->snapshot_link_loads(0, topology->get_links_count(), loads.data());
+    for (auto i = 0; i < topology->get_links_count(); i++) {
+        EXPECT_EQ(loads[i].queued_chunks, (i == link_id) ? 2 : 0);
+        EXPECT_EQ(loads[i].pending_bytes, (i == link_id) ? chunk_size : 0);
+    }
+    event_queue->run_to_completion();
+    EXPECT_EQ(topology->get_link_load(link_id).queued_chunks, 0);
+    EXPECT_EQ(topology->get_link_load(link_id).pending_bytes, 0);
+
+    /// test: with virtual time, busy-until covers every chunk sent so far
+    const auto virtual_topology = std::make_shared<Ring>(4, 50, 500);
+    virtual_topology->set_link_model(LinkModel::VirtualTime);
+    const auto start_time = event_queue->get_current_time();
+    for (auto i = 0; i < 3; i++) {
+        virtual_topology->send(chunk_size, 0, 1, callback, nullptr);
+    }
+    EXPECT_EQ(virtual_topology->get_link_load(link_id).busy_until, start_time + 3 * serialization_delay);
+    event_queue->run_to_completion();
+
+    /// test: lazy links not used yet are idle, and stay unmaterialized
+    const auto fully_connected = std::make_shared<FullyConnected>(64, 50, 500);
+    const auto materialized_links_count = fully_connected->get_materialized_links_count();
+    const auto lazy_load = fully_connected->get_link_load(fully_connected->find_link(63, 62));
+    EXPECT_EQ(lazy_load.queued_chunks, 0);
+    EXPECT_EQ(fully_connected->get_materialized_links_count(), materialized_links_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, IngressBandwidth) {
+    /// setup: an incast of 7 NPUs to NPU 0 of a FullyConnected, each chunk taking a single hop
+    struct Arrival {
+        EventQueue* event_queue;
+        EventTime time;
+        int chunks_count;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+        arrival->chunks_count++;
+    };
+    const auto run_incast = [&](const Bandwidth ingress_bandwidth, const int senders_count) {
+        auto incast_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<FullyConnected>(8, 50, 500);
+        topology->attach_event_queue(incast_event_queue);
+        topology->set_ingress_bandwidth(ingress_bandwidth);
+        EXPECT_EQ(topology->get_ingress_bandwidth(), ingress_bandwidth);
+        auto arrivals = std::vector<Arrival>(senders_count, Arrival{incast_event_queue.get(), 0, 0});
+        for (auto i = 0; i < senders_count; i++) {
+            topology->send(chunk_size, i + 1, 0, record_arrival, &arrivals[i]);
+        }
+        incast_event_queue->run_to_completion();
+        auto arrival_times = std::vector<EventTime>();
+        for (const auto& arrival : arrivals) {
+            arrival_times.push_back(arrival.time);
+        }
+        return arrival_times;
+    };
+    const auto hop_delay = FullyConnected(8, 50, 500).get_link(0).communication_delay(chunk_size);
+    const auto serialization_delay = hop_delay - ns_to_ticks(500);
+
+    /// test: without an ingress limit, every chunk is delivered as it arrives
+    EXPECT_EQ(run_incast(0, 7), std::vector<EventTime>(7, hop_delay));
+
+    /// test: an ingress as fast as a link writes the chunks one after the other, the first one as it arrives
+    auto expected_arrival_times = std::vector<EventTime>();
+    for (auto i = 0; i < 7; i++) {
+        expected_arrival_times.push_back(hop_delay + i * serialization_delay);
+    }
+    EXPECT_EQ(run_incast(50, 7), expected_arrival_times);
+
+    /// test: a lone chunk isn't delayed, its write overlapping its reception
+    EXPECT_EQ(run_incast(50, 1), std::vector<EventTime>(1, hop_delay));
+
+    /// test: every chunk of a message is delivered, the last one once an ingress half as fast wrote the message
+    auto message_event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<FullyConnected>(8, 50, 500);
+    topology->attach_event_queue(message_event_queue);
+    topology->set_ingress_bandwidth(25);
+    auto message_arrival = Arrival{message_event_queue.get(), 0, 0};
+    topology->send_message(chunk_size, 4, 1, 0, record_arrival, &message_arrival);
+    message_event_queue->run_to_completion();
+    EXPECT_EQ(message_arrival.chunks_count, 4);
+    EXPECT_EQ(message_arrival.time, 8 * serialization_delay);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, LinkCalendar) {
+    /// setup: on a unidirectional ring, recording when each chunk arrives
+    struct Arrival {
+        EventQueue* event_queue;
+        EventTime time;
+    };
+    const auto record_arrival = [](void* const arg) {
+        auto* const arrival = static_cast<Arrival*>(arg);
+        arrival->time = arrival->event_queue->get_current_time();
+    };
+
+    /// test: without slots reserved in advance, a calendar serves a burst in FIFO order, as virtual time does
+    const auto run_burst = [&](const LinkModel link_model) {
+        auto burst_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500, false);
+        topology->attach_event_queue(burst_event_queue);
+        topology->set_link_model(link_model);
+        auto arrivals = std::vector<Arrival>(4, Arrival{burst_event_queue.get(), 0});
+        for (auto i = 0; i < 4; i++) {
+            topology->send(chunk_size * (i + 1), 0, 2, record_arrival, &arrivals[i]);
+        }
+        burst_event_queue->run_to_completion();
+        auto arrival_times = std::vector<EventTime>();
+        for (const auto& arrival : arrivals) {
+            arrival_times.push_back(arrival.time);
+        }
+        return arrival_times;
+    };
+    EXPECT_EQ(run_burst(LinkModel::Calendar), run_burst(LinkModel::VirtualTime));
+
+    /// setup: a chunk sent with fast forwarding from NPU 0 to NPU 2,
+    /// while a small chunk, then a large one, are sent from NPU 1 to NPU 2 right away
+    const auto run_crossing = [&](const LinkModel link_model, const bool fast_forward) {
+        auto crossing_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500, false);
+        topology->attach_event_queue(crossing_event_queue);
+        topology->set_link_model(link_model);
+        topology->set_fast_forward(fast_forward);
+        EXPECT_EQ(topology->get_link(0).get_link_model(), link_model);
+        auto arrivals = std::vector<Arrival>(3, Arrival{crossing_event_queue.get(), 0});
+        topology->send(chunk_size, 0, 2, record_arrival, &arrivals[0]);
+        topology->send(chunk_size / 4, 1, 2, record_arrival, &arrivals[1]);
+        topology->send(chunk_size * 2, 1, 2, record_arrival, &arrivals[2]);
+        crossing_event_queue->run_to_completion();
+        return std::vector<EventTime>{arrivals[0].time, arrivals[1].time, arrivals[2].time};
+    };
+    const auto& link = Ring(4, 50, 500, false).get_link(0);
+    const auto hop_delay = link.communication_delay(chunk_size);
+    const auto small_delay = link.communication_delay(chunk_size / 4);
+    const auto large_delay = link.communication_delay(chunk_size * 2);
+    const auto small_serialization_delay = small_delay - ns_to_ticks(500);
+    const auto large_serialization_delay = large_delay - ns_to_ticks(500);
+
+    /// test: the chunks of NPU 1 reach link 1 -> 2 first, and are served first by either link model,
+    /// the chunk of NPU 0 not reserving it in advance
+    const auto expected_arrival_times = std::vector<EventTime>{
+        small_serialization_delay + large_serialization_delay + hop_delay, small_delay,
+        small_serialization_delay + large_delay};
+    for (const auto link_model : {LinkModel::VirtualTime, LinkModel::Calendar}) {
+        EXPECT_EQ(run_crossing(link_model, true), expected_arrival_times);
+        EXPECT_EQ(run_crossing(link_model, false), expected_arrival_times);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, NetworkDownscaling) {
+    /// setup: a 256-NPU network of 32-NPU switches across 8-NPU rings
+    const auto full_parser = NetworkParser(NetworkConfig()
+                                               .add_dim(TopologyBuildingBlock::Switch, 32, 100, 500)
+                                               .add_dim(TopologyBuildingBlock::Ring, 8, 50, 500));
+    const auto simulate_all_to_all = [&](const NetworkParser& network_parser, const ChunkSize collective_size) {
+        auto collective_event_queue = std::make_shared<EventQueue>();
+        const auto topology = construct_topology(network_parser, collective_event_queue);
+        auto collective = Collective(topology, CollectiveType::AllToAll, CollectiveAlgorithm::Direct,
+                                     collective_size, 1);
+        collective.start();
+        collective_event_queue->run_to_completion();
+        EXPECT_TRUE(collective.finished());
+        return collective.get_finish_time();
+    };
+
+    /// test: every dimension shrinks by half to reach 64 NPUs, the factors following
+    const auto downscaled = downscale_network(full_parser, 64);
+    const auto downscaled_parser = NetworkParser(downscaled.network_config);
+    EXPECT_EQ(downscaled_parser.get_npus_counts_per_dim(), std::vector<int>({16, 4}));
+    EXPECT_EQ(downscaled.full_npus_count, 256);
+    EXPECT_EQ(downscaled.npus_count, 64);
+    EXPECT_DOUBLE_EQ(downscaled.npus_scale, 4);
+    EXPECT_DOUBLE_EQ(downscaled.message_size_scale, 255.0 / 63);
+    EXPECT_DOUBLE_EQ(downscaled.buffer_size_scale, 255.0 / 63 / 4);
+
+    /// test: a switch only changes by the share of the messages crossing it (2 hops each),
+    /// while a shorter ring carries fewer hops
+    EXPECT_DOUBLE_EQ(downscaled.bandwidth_scales[0], (255.0 / 63) * (64 * 15.0 / 16) / (256 * 31.0 / 32));
+    EXPECT_DOUBLE_EQ(downscaled.latency_scales[0], (256 * 31.0 / 32 * 2 / 255) / (64 * 15.0 / 16 * 2 / 63));
+    EXPECT_LT(downscaled.bandwidth_scales[1], 1);
+    EXPECT_GT(downscaled.latency_scales[1], 1);
+
+    /// test: the downscaled all-to-all estimates the full one's finish time
+    const auto collective_size = ChunkSize(64) * 1'048'576;
+    const auto full_finish_time = simulate_all_to_all(full_parser, collective_size);
+    const auto downscaled_collective_size =
+        static_cast<ChunkSize>(std::llround(static_cast<double>(collective_size) * downscaled.buffer_size_scale));
+    const auto downscaled_finish_time = simulate_all_to_all(downscaled_parser, downscaled_collective_size);
+    EXPECT_NEAR(static_cast<double>(downscaled_finish_time) / static_cast<double>(full_finish_time), 1, 0.05);
+
+    /// test: dimensions keep their NPUs when already small, and can also be given one by one
+    const auto unchanged = downscale_network(full_parser, std::vector<int>({32, 8}));
+    EXPECT_DOUBLE_EQ(unchanged.npus_scale, 1);
+    EXPECT_EQ(unchanged.bandwidth_scales, std::vector<double>({1, 1}));
+    EXPECT_EQ(unchanged.latency_scales, std::vector<double>({1, 1}));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, NetworkScenarios) {
+    /// setup: a base ring, 3 scenarios (one invalid), and 2 swept latencies
+    const auto scenarios_config = YAML::Load(R"(
+        topology: [ Ring ]
+        npus_count: [ 8 ]
+        bandwidth: [ 50 ]
+        latency: [ 500 ]
+        scenarios:
+          - { name: fast, bandwidth: [ 100 ] }
+          - { npus_count: [ 16 ] }
+          - { name: empty, npus_count: [ 0 ] }
+        sweep:
+          latency: [ [ 500 ], [ 1000 ] ]
+    )");
+    const auto network_scenarios = NetworkScenarios(scenarios_config);
+
+    /// test: every scenario is combined with every swept value, the deltas replacing the base's keys
+    ASSERT_EQ(network_scenarios.get_scenarios_count(), 6);
+    EXPECT_EQ(network_scenarios.get_name(0), "fast latency=[500]");
+    EXPECT_EQ(network_scenarios.get_name(3), "1 latency=[1000]");
+    EXPECT_EQ(network_scenarios.get_network_parser(1)->get_bandwidths_per_dim(), std::vector<Bandwidth>({100}));
+    EXPECT_EQ(network_scenarios.get_network_parser(1)->get_latencies_per_dim(), std::vector<Latency>({1000}));
+    EXPECT_EQ(network_scenarios.get_network_parser(2)->get_npus_counts_per_dim(), std::vector<int>({16}));
+    EXPECT_EQ(network_scenarios.get_network_parser(2)->get_bandwidths_per_dim(), std::vector<Bandwidth>({50}));
+
+    /// test: invalid scenarios keep their errors
+    for (const auto scenario : {4, 5}) {
+        EXPECT_FALSE(network_scenarios.get_network_parser(scenario).has_value());
+        EXPECT_FALSE(network_scenarios.get_config_errors(scenario).empty());
+    }
+
+    /// test: a sweep runs every scenario, higher latencies finishing later
+    const auto sweep = Sweep(network_scenarios);
+    const auto results = sweep.run(
+        [](Topology& topology) {
+            topology.send(1'048'576, 0, 4, callback, nullptr);
+        },
+        2);
+    ASSERT_EQ(results.size(), 6);
+    EXPECT_LT(results[0].finish_time, results[1].finish_time);
+    EXPECT_LT(results[0].finish_time, results[2].finish_time);
+    EXPECT_EQ(results[4].finish_time, 0);
+    EXPECT_FALSE(results[5].config_errors.empty());
+
+    /// test: without scenarios nor sweep, the base is the only scenario
+    const auto base_scenarios = NetworkScenarios(YAML::Load("{ topology: [ Ring ], npus_count: [ 8 ], "
+                                                            "bandwidth: [ 50 ], latency: [ 500 ] }"));
+    ASSERT_EQ(base_scenarios.get_scenarios_count(), 1);
+    EXPECT_EQ(base_scenarios.get_name(0), "base");
+    EXPECT_TRUE(base_scenarios.get_network_parser(0).has_value());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, SourceRoutedChunk) {
+    /// setup: a bidirectional ring, shortest routes going clockwise from 0 to 1 in 1 hop
+    auto topology = std::make_shared<Ring>(16, 50, 500);
+
+    /// test: a source route takes the long way around, past the inline route storage
+    auto device_ids = std::vector<DeviceId>({0});
+    for (auto device = 15; device >= 1; device--) {
+        device_ids.push_back(device);
+    }
+    auto chunk = std::make_unique<Chunk>(chunk_size, device_ids.data(), static_cast<int>(device_ids.size()),
+                                         callback, nullptr);
+    topology->send(std::move(chunk));
+    event_queue->run_to_completion();
+    EXPECT_EQ(event_queue->get_current_time(), 15 * 20'031);
+
+    /// test: the route matches one built from the same device ids
+    const auto route = Route(device_ids.data(), static_cast<int>(device_ids.size()));
+    EXPECT_EQ(route.size(), 16);
+    EXPECT_EQ(route.front(), 0);
+    EXPECT_EQ(route.back(), 1);
+    EXPECT_EQ(route[1], 15);
+    EXPECT_FALSE(route.links_resolved());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, IncrementalFlowRates) {
+    /// setup
+    const auto network_parser = NetworkParser("../../input/Ring.yml");
+    const auto topology = construct_topology(network_parser);
+
+    /// test: simultaneous starts share one rate update, and drained flows leave others untouched
+    auto disjoint_flow_model = FlowModel(topology);
+    const auto short_flow = disjoint_flow_model.add_flow(0, 1, 2, chunk_size);
+    const auto long_flow = disjoint_flow_model.add_flow(0, 5, 6, 2 * chunk_size);
+    disjoint_flow_model.run();
+    EXPECT_EQ(disjoint_flow_model.get_finish_time(short_flow), 20'031);
+    EXPECT_GT(disjoint_flow_model.get_finish_time(long_flow), 2 * 19'531);
+    EXPECT_EQ(disjoint_flow_model.get_rate_updates_count(), 2);
+
+    /// test: a flow starting on a link only updates the flows connected to it
+    auto late_flow_model = FlowModel(topology);
+    late_flow_model.add_flow(0, 1, 2, chunk_size);
+    const auto early_flow = late_flow_model.add_flow(0, 5, 7, chunk_size);
+    const auto late_flow = late_flow_model.add_flow(10'000, 6, 7, chunk_size);
+    late_flow_model.run();
+    EXPECT_EQ(late_flow_model.get_rate_updates_count(), 2 + 2 + 1);
+    EXPECT_GT(late_flow_model.get_finish_time(early_flow), 20'031);
+    EXPECT_GT(late_flow_model.get_finish_time(late_flow), late_flow_model.get_finish_time(early_flow));
+
+    /// test: a drained flow leaves the slower flows sharing its links untouched,
+    /// flow_a getting a third of link 2->3 and the short flow the rest of link 1->2
+    auto slower_flow_model = FlowModel(topology);
+    const auto flow_a = slower_flow_model.add_flow(0, 1, 3, chunk_size);
+    slower_flow_model.add_flow(0, 2, 3, chunk_size);
+    slower_flow_model.add_flow(0, 2, 3, chunk_size);
+    const auto faster_flow = slower_flow_model.add_flow(0, 1, 2, chunk_size / 2);
+    slower_flow_model.run();
+    EXPECT_EQ(slower_flow_model.get_rate_updates_count(), 4);
+    EXPECT_EQ(slower_flow_model.get_finish_time(faster_flow), static_cast<EventTime>(0.75 * 19'531.25 + 500));
+    EXPECT_EQ(slower_flow_model.get_finish_time(flow_a), static_cast<EventTime>(3 * 19'531.25 + 2 * 500));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TimeQuantization) {
+    /// test: event times are rounded up to the quantum, merging nearby events
+    for (const auto event_queue_type : {EventQueueType::List, EventQueueType::Heap, EventQueueType::TimingWheel}) {
+        auto queue = EventQueue(event_queue_type);
+        queue.set_time_quantum(100);
+        auto invoked_times = std::vector<EventTime>();
+        auto context = std::make_pair(&queue, &invoked_times);
+        const auto record_time = [](void* const arg) {
+            auto* const ctx = static_cast<std::pair<EventQueue*, std::vector<EventTime>*>*>(arg);
+            ctx->second->push_back(ctx->first->get_current_time());
+        };
+        for (const auto event_time : {30, 70, 100, 150}) {
+            queue.schedule_event(event_time, record_time, &context);
+        }
+        queue.run_to_completion();
+        EXPECT_EQ(invoked_times, std::vector<EventTime>({100, 100, 100, 200}));
+        EXPECT_DOUBLE_EQ(queue.get_time_error_bound(), 99.0 / 30);
+    }
+
+    /// setup: the same all-gather, exact and quantized (chunks arriving together coalesced)
+    const auto run_all_gather = [](const EventTime time_quantum) {
+        const auto queue = std::make_shared<EventQueue>();
+        queue->set_time_quantum(time_quantum);
+        const auto topology = std::make_shared<Ring>(16, 50, 500);
+        topology->attach_event_queue(queue);
+        topology->set_chunk_coalescing(time_quantum > 1);
+        auto all_gather =
+            Collective(topology, CollectiveType::AllGather, CollectiveAlgorithm::Direct, 16 * 1'048'576, 4);
+        all_gather.start();
+        const auto finish_time = queue->run_to_completion();
+        return std::make_tuple(finish_time, queue->get_time_error_bound(), queue->get_invoked_events_count());
+    };
+    const auto [exact_finish_time, exact_error_bound, exact_events_count] = run_all_gather(1);
+    const auto [finish_time, error_bound, events_count] = run_all_gather(100);
+
+    /// test: the quantized simulation is late by at most the error bound it reports, with fewer events
+    EXPECT_EQ(exact_error_bound, 0);
+    EXPECT_GT(error_bound, 0);
+    EXPECT_LT(error_bound, 0.05);
+    EXPECT_GE(finish_time, exact_finish_time);
+    EXPECT_LE(static_cast<double>(finish_time - exact_finish_time), error_bound * exact_finish_time);
+    EXPECT_LT(events_count, exact_events_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, BackgroundTraffic) {
+    /// setup: a 4-NPU ring, sending a chunk over the link 0 -> 1 from the given time and returning its latency
+    const auto ring = std::make_shared<Ring>(4, 50, 500);
+    ring->attach_event_queue(event_queue);
+    const auto latency_from = [&](const EventTime time) {
+        event_queue->schedule_event(time, callback, nullptr);
+        event_queue->run_to_completion();
+        ring->send(chunk_size, 0, 1, callback, nullptr);
+        event_queue->run_to_completion();
+        return event_queue->get_current_time() - time;
+    };
+    const auto latency_at = [&](const Bandwidth bandwidth) {
+        return ns_to_ticks(500 + static_cast<double>(chunk_size) / bw_GBps_to_Bpns(bandwidth));
+    };
+
+    // test: a constant background load leaves chunks the rest of the bandwidth
+    ring->set_link_background_schedule(0, 1, BackgroundSchedule{{0, 0.5}});
+    EXPECT_NEAR(latency_from(0), latency_at(25), 1);
+
+    // test: a time-varying load applies its step in effect, on top of the bandwidth schedule
+    event_queue->reset();
+    ring->reset();
+    ring->set_link_bandwidth_schedule(0, 1, BandwidthSchedule{{ns_to_ticks(1'000'000), 100}});
+    const auto background_schedule = BackgroundSchedule{{ns_to_ticks(10'000), 0.2}, {ns_to_ticks(50'000), 0.5}};
+    ring->set_link_background_schedule(0, 1, background_schedule);
+    EXPECT_NEAR(latency_from(0), latency_at(50), 1);
+    EXPECT_NEAR(latency_from(ns_to_ticks(20'000)), latency_at(40), 1);
+    EXPECT_NEAR(latency_from(ns_to_ticks(100'000)), latency_at(25), 1);
+    EXPECT_NEAR(latency_from(ns_to_ticks(2'000'000)), latency_at(50), 1);
+
+    // test: a link group is loaded at once, and an empty schedule unloads the links
+    event_queue->reset();
+    ring->reset();
+    ring->set_link_bandwidth_schedule(0, 1, {});
+    ring->set_link_group_background_schedule(ring->get_link_group(ring->find_link(0, 1)), {{0, 0.75}});
+    EXPECT_NEAR(latency_from(0), latency_at(12.5), 1);
+    ring->set_link_group_background_schedule(ring->get_link_group(ring->find_link(0, 1)), {});
+    EXPECT_NEAR(latency_from(event_queue->get_current_time()), latency_at(50), 1);
+
+    // test: link classes carry their background utilization, in the compiled form too
+    const auto config = std::string("topology: [ Ring ]\nnpus_count: [ 4 ]\nbandwidth: [ 50.0 ]\nlatency: [ 500.0 ]\n"
+                                    "link_classes: { loaded: { bandwidth: 50.0, latency: 500.0, "
+                                    "background_utilization: 0.5 }, "
+                                    "bursty: { bandwidth: 50.0, latency: 500.0, "
+                                    "background_utilization: [ [ 0, 0.1 ], [ 10000, 0.6 ] ] } }\n"
+                                    "link_overrides: [ { pair: [ 0, 1 ], class: loaded }, "
+                                    "{ pair: [ 2, 3 ], class: bursty } ]\n");
+    const auto config_path = std::string("background_traffic.yml");
+    std::ofstream(config_path) << config;
+    static_cast<void>(NetworkParser::load_cached(config_path));  // compiles the config
+    const auto loaded = NetworkParser::load_cached(config_path);
+    ASSERT_EQ(loaded.get_link_classes().size(), 2);
+    ASSERT_EQ(loaded.get_link_classes()[0].background_schedule.size(), 1);
+    EXPECT_EQ(loaded.get_link_classes()[0].background_schedule[0].second, 0.5);
+    ASSERT_EQ(loaded.get_link_classes()[1].background_schedule.size(), 2);
+    EXPECT_EQ(loaded.get_link_classes()[1].background_schedule[1].first, 10000.0);
+    const auto topology = construct_topology(loaded);
+    const auto* const link_schedule = topology->get_link(topology->find_link(1, 0)).get_background_schedule();
+    ASSERT_NE(link_schedule, nullptr);
+    EXPECT_EQ((*link_schedule)[0].utilization, 0.5);
+    const auto* const bursty_schedule = topology->get_link(topology->find_link(3, 2)).get_background_schedule();
+    ASSERT_NE(bursty_schedule, nullptr);
+    EXPECT_EQ((*bursty_schedule)[1].time, ns_to_ticks(10'000));
+    EXPECT_EQ(topology->get_link(topology->find_link(1, 2)).get_background_schedule(), nullptr);
+    std::remove(config_path.c_str());
+    std::remove((config_path + ".bin").c_str());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InjectionPipeline) {
+    // test: the ring hands every element over from the producer thread in order, however small
+    auto ring = SpscRing<int>(3);
+    EXPECT_EQ(ring.capacity(), 4);
+    auto producer = std::thread([&ring] {
+        for (auto value = 0; value < 100'000; value++) {
+            while (!ring.try_push(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    auto in_order = true;
+    for (auto expected = 0; expected < 100'000; expected++) {
+        auto* value = ring.front();
+        while (value == nullptr) {
+            std::this_thread::yield();
+            value = ring.front();
+        }
+        in_order = in_order && *value == expected;
+        ring.pop();
+    }
+    producer.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(ring.front(), nullptr);
+
+    /// setup: synthetic traffic on a 16-NPU ring (random pairs, including local ones, 4 per 1000 ticks),
+    /// as trace records
+    auto random_engine = std::mt19937_64(0);
+    auto npus_distribution = std::uniform_int_distribution<int>(0, 15);
+    auto records = std::vector<TraceRecord>();
+    for (auto i = 0; i < 2'000; i++) {
+        records.push_back({static_cast<EventTime>(i / 4 * 1'000), chunk_size / 16, TraceRecord::no_dependency,
+                           npus_distribution(random_engine), npus_distribution(random_engine)});
+    }
+    const auto trace_path = std::string("injection_pipeline_test.bin");
+    TraceReplay::write_trace(trace_path, records);
+    auto replay_event_queue = std::make_shared<EventQueue>();
+    auto replay_topology = std::make_shared<Ring>(16, 50, 500);
+    replay_topology->attach_event_queue(replay_event_queue);
+    auto trace_replay = TraceReplay(replay_topology, trace_path);
+    trace_replay.start();
+    replay_event_queue->run_to_completion();
+    ASSERT_TRUE(trace_replay.finished());
+    std::remove(trace_path.c_str());
+
+    // test: the pipelined injections give the same results as the replay, with routes precomputed or not,
+    // even when the ring is too small to run ahead
+    for (const auto precompute_routes : {true, false}) {
+        for (const auto capacity : {2, 4'096}) {
+            auto pipeline_event_queue = std::make_shared<EventQueue>();
+            auto pipeline_topology = std::make_shared<Ring>(16, 50, 500);
+            pipeline_topology->attach_event_queue(pipeline_event_queue);
+            auto next_record = size_t(0);
+            const auto generator = [&](PipelinedInjection& injection) {
+                if (next_record == records.size()) {
+                    return false;
+                }
+                const auto& record = records[next_record++];
+                injection = {record.inject_time, record.src, record.dest, record.size};
+                return true;
+            };
+            auto pipeline = InjectionPipeline(pipeline_topology, generator, precompute_routes, capacity);
+            auto finished_count = 0;
+            pipeline.start([](void* const count_ptr) { (*static_cast<int*>(count_ptr))++; }, &finished_count);
+            pipeline_event_queue->run_to_completion();
+            EXPECT_TRUE(pipeline.finished());
+            EXPECT_EQ(finished_count, 1);
+            EXPECT_EQ(pipeline.get_injected_count(), records.size());
+            EXPECT_EQ(pipeline.get_delivered_count(), records.size());
+            EXPECT_EQ(pipeline.get_finish_time(), trace_replay.get_finish_time());
+            const auto& pipeline_stats = pipeline_topology->get_link(pipeline_topology->find_link(3, 4)).get_stats();
+            const auto& replay_stats = replay_topology->get_link(replay_topology->find_link(3, 4)).get_stats();
+            EXPECT_EQ(pipeline_stats.bytes_transmitted, replay_stats.bytes_transmitted);
+            EXPECT_EQ(pipeline_stats.queueing_delay, replay_stats.queueing_delay);
+        }
+    }
+
+    // test: a pipeline dropped before its workload is exhausted stops its producer
+    auto endless_event_queue = std::make_shared<EventQueue>();
+    auto endless_topology = std::make_shared<Ring>(16, 50, 500);
+    endless_topology->attach_event_queue(endless_event_queue);
+    auto endless_time = EventTime(0);
+    {
+        auto pipeline = InjectionPipeline(
+            endless_topology,
+            [&](PipelinedInjection& injection) {
+                injection = {endless_time += 1'000, 0, 1, chunk_size};
+                return true;
+            },
+            true, 16);
+        pipeline.start();
+        endless_event_queue->run_until(100'000);
+        EXPECT_FALSE(pipeline.finished());
+        EXPECT_GE(pipeline.get_injected_count(), 99);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, InjectionPipelineMultipath) {
+    /// setup: synthetic traffic on a 4x4 mesh spreading chunks over their XY and YX routes (O1TURN), as trace records
+    auto random_engine = std::mt19937_64(1);
+    auto npus_distribution = std::uniform_int_distribution<int>(0, 15);
+    auto records = std::vector<TraceRecord>();
+    for (auto i = 0; i < 1'000; i++) {
+        records.push_back({static_cast<EventTime>(i / 8 * 1'000), chunk_size / 16, TraceRecord::no_dependency,
+                           npus_distribution(random_engine), npus_distribution(random_engine)});
+    }
+    const auto make_topology = [](const std::shared_ptr<EventQueue>& mesh_event_queue) {
+        auto topology = std::make_shared<Mesh2D>(4, 4, 50, 500);
+        topology->set_routing(MeshRouting::O1Turn);
+        topology->attach_event_queue(mesh_event_queue);
+        return topology;
+    };
+
+    // test: spread routes depend on the chunk, so they can't be precomputed
+    auto replay_event_queue = std::make_shared<EventQueue>();
+    auto replay_topology = make_topology(replay_event_queue);
+    EXPECT_FALSE(replay_topology->has_fixed_routes());
+    EXPECT_TRUE(Mesh2D(4, 4, 50, 500).has_fixed_routes());
+
+    const auto trace_path = std::string("injection_pipeline_multipath_test.bin");
+    TraceReplay::write_trace(trace_path, records);
+    auto trace_replay = TraceReplay(replay_topology, trace_path);
+    trace_replay.start();
+    replay_event_queue->run_to_completion();
+    ASSERT_TRUE(trace_replay.finished());
+    std::remove(trace_path.c_str());
+
+    // test: pipelined injections select the same routes as direct injection, so every link sees the same traffic
+    auto pipeline_event_queue = std::make_shared<EventQueue>();
+    auto pipeline_topology = make_topology(pipeline_event_queue);
+    auto next_record = size_t(0);
+    auto pipeline = InjectionPipeline(pipeline_topology, [&](PipelinedInjection& injection) {
+        if (next_record == records.size()) {
+            return false;
+        }
+        const auto& record = records[next_record++];
+        injection = {record.inject_time, record.src, record.dest, record.size};
+        return true;
+    });
+    pipeline.start();
+    pipeline_event_queue->run_to_completion();
+    ASSERT_TRUE(pipeline.finished());
+    EXPECT_EQ(pipeline.get_finish_time(), trace_replay.get_finish_time());
+    for (auto link_id = 0; link_id < static_cast<LinkId>(pipeline_topology->get_links_count()); link_id++) {
+        const auto& pipeline_stats = pipeline_topology->get_link(link_id).get_stats();
+        const auto& replay_stats = replay_topology->get_link(link_id).get_stats();
+        EXPECT_EQ(pipeline_stats.bytes_transmitted, replay_stats.bytes_transmitted);
+        EXPECT_EQ(pipeline_stats.queueing_delay, replay_stats.queueing_delay);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, TriggeredLinkTrace) {
+    // eight chunks sent at once over the link 0 -> 1, each transmission starting once the previous one left
+    const auto trace_path = std::string("triggered_link_trace_test.json");
+    const auto run = [&](const TraceTrigger& trigger, const size_t history_size, const uint64_t followup_count) {
+        auto ring_event_queue = std::make_shared<EventQueue>();
+        auto topology = std::make_shared<Ring>(4, 50, 500, false);
+        topology->attach_event_queue(ring_event_queue);
+        auto link_trace = std::make_shared<LinkTrace>(trace_path, 64);
+        link_trace->arm(trigger, history_size, followup_count);
+        topology->set_link_trace(link_trace);
+
+        for (auto i = 0; i < 8; i++) {
+            topology->send(chunk_size, 0, 1, callback, nullptr);
+        }
+        ring_event_queue->run_to_completion();
+        link_trace->close();
+        EXPECT_EQ(link_trace->get_transmissions_count(), 8);
+
+        auto trace_file = std::ifstream(trace_path);
+        auto trace_stream = std::stringstream();
+        trace_stream << trace_file.rdbuf();
+        const auto trace = trace_stream.str();
+        std::remove(trace_path.c_str());
+        return std::make_tuple(link_trace->get_written_transmissions_count(), link_trace->get_triggers_count(), trace);
+    };
+    const auto ring = Ring(4, 50, 500, false);
+    const auto serialization_time = ring.get_link(ring.find_link(0, 1)).communication_delay(chunk_size) - 500;
+
+    // test: nothing fires, so the history is dropped
+    const auto [idle_written, idle_triggers, idle_trace] = run(TraceTrigger(), 4, 4);
+    EXPECT_EQ(idle_written, 0);
+    EXPECT_EQ(idle_triggers, 0);
+    EXPECT_EQ(idle_trace.find("\"ph\":\"X\""), std::string::npos);
+
+    // test: the fifth transmission falls in the window, written after the two before it and followed by one more
+    auto window_trigger = TraceTrigger();
+    window_trigger.window_start = 4 * serialization_time;
+    window_trigger.window_end = 4 * serialization_time + 1;
+    const auto [window_written, window_triggers, window_trace] = run(window_trigger, 2, 1);
+    EXPECT_EQ(window_written, 4);
+    EXPECT_EQ(window_triggers, 1);
+    for (auto chunk_id = 0; chunk_id < 8; chunk_id++) {
+        const auto written = window_trace.find("\"chunk\":" + std::to_string(chunk_id) + "}") != std::string::npos;
+        EXPECT_EQ(written, 2 <= chunk_id && chunk_id <= 5);
+    }
+
+    // test: a chunk id fires alone
+    auto chunk_trigger = TraceTrigger();
+    chunk_trigger.chunk_id = 7;
+    const auto [chunk_written, chunk_triggers, chunk_trace] = run(chunk_trigger, 1, 0);
+    EXPECT_EQ(chunk_written, 2);
+    EXPECT_EQ(chunk_triggers, 1);
+
+    // test: the queue of the link fires while it's deep enough, but not on another link
+    // (the first chunk leaves before the others are sent, so the second and third transmissions fire)
+    auto queue_trigger = TraceTrigger();
+    queue_trigger.link_src = 0;
+    queue_trigger.link_dest = 1;
+    queue_trigger.queue_depth_threshold = 6;
+    const auto [queue_written, queue_triggers, queue_trace] = run(queue_trigger, 1, 0);
+    EXPECT_EQ(queue_written, 3);
+    EXPECT_EQ(queue_triggers, 2);
+    EXPECT_NE(queue_trace.find("\"chunk\":0}"), std::string::npos);
+    EXPECT_EQ(queue_trace.find("\"chunk\":3}"), std::string::npos);
+    queue_trigger.link_dest = 3;
+    const auto [other_written, other_triggers, other_trace] = run(queue_trigger, 1, 0);
+    EXPECT_EQ(other_written, 0);
+    EXPECT_EQ(other_triggers, 0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionAware, RecoverableTopologyErrors) {
+    const auto has_error = [](const std::vector<ConfigError>& errors, const std::string& key) {
+        return std::any_of(errors.begin(), errors.end(), [&key](const ConfigError& error) {
+            return error.key == key;
+        });
+    };
+
+    // test: a Mesh2D grid should cover its NPUs exactly, and a Mesh2D without grid be square
+    auto errors = std::vector<ConfigError>();
+    EXPECT_FALSE(NetworkParser::try_parse(NetworkConfig().add_dim(TopologyBuildingBlock::Mesh2D, 16, 50, 500)
+                                              .set_mesh_size(3, 3),
+                                          errors)
+                     .has_value());
+    EXPECT_TRUE(has_error(errors, "width"));
+    errors.clear();
+    EXPECT_FALSE(
+        NetworkParser::try_parse(NetworkConfig().add_dim(TopologyBuildingBlock::Mesh2D, 15, 50, 500), errors)
+            .has_value());
+    EXPECT_TRUE(has_error(errors, "npus_count"));
+    errors.clear();
+    EXPECT_TRUE(NetworkParser::try_parse(NetworkConfig().add_dim(TopologyBuildingBlock::Mesh2D, 12, 50, 500)
+                                             .set_mesh_size(4, 3),
+                                         errors)
+                    .has_value());
+    EXPECT_TRUE(errors.empty());
+
+    // parse a 1-dim topology of the given NPUs and extra parameters, constructing it if valid
+    const auto try_construct = [](const std::string& topology, const int npus_count, const std::string& parameters,
+                                  std::vector<ConfigError>& errors) {
+        const auto network_parser = NetworkParser::try_parse(
+            YAML::Load("{topology: [" + topology + "], npus_count: [" + std::to_string(npus_count) +
+                       "], bandwidth: [50], latency: [500], " + parameters + "}"),
+            errors);
+        return network_parser.has_value() ? try_construct_topology(*network_parser, errors) : nullptr;
+    };
+
+    // test: a FatTree should have 2 or 3 tiers, an even radix divisible by oversubscription + 1,
+    // and enough top ports to connect every NPU, instead of exiting once constructed
+    const auto fat_tree_error = [&](const int npus_count, const std::string& parameters, const std::string& key) {
+        auto fat_tree_errors = std::vector<ConfigError>();
+        EXPECT_EQ(try_construct("FatTree", npus_count, parameters, fat_tree_errors), nullptr);
+        return fat_tree_errors.size() == 1 && fat_tree_errors.front().key == key;
+    };
+    EXPECT_TRUE(fat_tree_error(1024, "radix: 4, tiers: 2", "npus_count"));
+    EXPECT_TRUE(fat_tree_error(1024, "radix: 8, tiers: 3", "npus_count"));
+    EXPECT_TRUE(fat_tree_error(16, "radix: 8, tiers: 4", "tiers"));
+    EXPECT_TRUE(fat_tree_error(16, "radix: 5", "radix"));
+    EXPECT_TRUE(fat_tree_error(16, "radix: 8, oversubscription: 2", "radix"));
+    EXPECT_TRUE(fat_tree_error(16, "radix: 8, oversubscription: 0", "radix"));
+    const auto fat_tree = try_construct("FatTree", 1024, "radix: 16, tiers: 3", errors);
+    ASSERT_NE(fat_tree, nullptr);
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(fat_tree->get_npus_count(), 1024);
+
+    // test: a MultiRail should have rails, instead of exiting once constructed
+    EXPECT_EQ(try_construct("MultiRail", 16, "rails: 0", errors), nullptr);
+    EXPECT_TRUE(has_error(errors, "rails"));
+    errors.clear();
+    ASSERT_NE(try_construct("MultiRail", 16, "rails: 4", errors), nullptr);
+    EXPECT_TRUE(errors.empty());
+
+    // test: a Mesh3D should have a grid whose valid cells hold every NPU, instead of exiting once constructed
+    EXPECT_EQ(try_construct("Mesh3D", 32, "width: 4, height: 4", errors), nullptr);
+    EXPECT_TRUE(has_error(errors, "depth"));
+    errors.clear();
+    EXPECT_EQ(try_construct("Mesh3D", 32, "width: 4, height: 4, depth: 3", errors), nullptr);
+    EXPECT_TRUE(has_error(errors, "npus_count"));
+    errors.clear();
+    ASSERT_NE(try_construct("Mesh3D", 32, "width: 4, height: 4, depth: 2", errors), nullptr);
+    EXPECT_TRUE(errors.empty());
+
+    // test: the bitmap of a SparseMesh2D should cover its grid, instead of exiting once constructed
+    const auto bitmap_path = std::string("recoverable_bitmap_test.txt");
+    std::ofstream(bitmap_path) << "0000\n0100\n";
+    EXPECT_EQ(try_construct("SparseMesh2D", 11, "width: 4, height: 3, excluded_bitmap: " + bitmap_path, errors),
+              nullptr);
+    EXPECT_TRUE(has_error(errors, "excluded_bitmap"));
+    errors.clear();
+    std::ofstream(bitmap_path) << "0000\n0100\n0000\n";
+    ASSERT_NE(try_construct("SparseMesh2D", 11, "width: 4, height: 3, excluded_bitmap: " + bitmap_path, errors),
+              nullptr);
+    EXPECT_TRUE(errors.empty());
+    std::remove(bitmap_path.c_str());
+
+    // test: unreadable files are errors, whether the configuration or a file it refers to
+    EXPECT_FALSE(NetworkParser::try_load("../../input/Missing.yml", errors).has_value());
+    EXPECT_EQ(errors.size(), 1);
+    errors.clear();
+    EXPECT_FALSE(NetworkParser::try_parse(NetworkConfig()
+                                              .add_dim(TopologyBuildingBlock::Custom, 8, 50, 500)
+                                              .set_edge_list("../../input/missing_edge_list.csv"),
+                                          errors)
+                     .has_value());
+    EXPECT_TRUE(has_error(errors, "edge_list"));
+    errors.clear();
+    const auto ring_parser = NetworkParser::try_load("../../input/Ring.yml", errors);
+    ASSERT_TRUE(ring_parser.has_value());
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(ring_parser->get_config_hash(), NetworkParser("../../input/Ring.yml").get_config_hash());
+
+    // a sweep over an 8-NPU ring overriding: a device out of range, two unlinked NPUs, a missing group, a link
+    const auto ring = NetworkConfig().add_dim(TopologyBuildingBlock::Ring, 8, 50, 500);
+    auto network_configs = std::vector<NetworkConfig>(4, ring);
+    network_configs[0].override_link_pair(0, 99, 100, 500);
+    network_configs[1].override_link_pair(0, 5, 100, 500);
+    network_configs[2].override_link_group("row 7", 100, 500);
+    network_configs[3].override_link_pair(0, 1, 100, 500);
+
+    // test: overrides are checked against the constructed links, failing their point only
+    for (const auto& network_config : network_configs) {
+        EXPECT_TRUE(NetworkParser::try_parse(network_config, errors).has_value());
+    }
+    const auto results = Sweep(network_configs).run(
+        [](Topology& topology) {
+            topology.send(1'048'576, 0, 1, callback, nullptr);
+        },
+        2);
+    ASSERT_EQ(results.size(), 4);
+    for (const auto point_id : {0, 1, 2}) {
+        EXPECT_TRUE(has_error(results[point_id].config_errors, "link_overrides"));
+        EXPECT_EQ(results[point_id].finish_time, 0);
+    }
+    EXPECT_TRUE(results[3].config_errors.empty());
+    EXPECT_GT(results[3].finish_time, 0);
+    EXPECT_EQ(errors.size(), 0);
+}
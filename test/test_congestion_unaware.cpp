@@ -3,9 +3,36 @@ This source code is licensed under the MIT license found in the
 LICENSE file in the root directory of this source tree.
 *******************************************************************************/
 
+#include "common/CommandLine.h"
+#include "common/EventQueue.h"
+#include "common/ExecutionTrace.h"
+#include "common/JsonObject.h"
+#include "common/NetworkFunction.h"
 #include "common/NetworkParser.h"
+#include "common/QueryServer.h"
+#include "common/SendGraph.h"
+#include "common/TimeBase.h"
 #include "common/Type.h"
+#include "congestion_unaware/CApi.h"
+#include "congestion_unaware/DelayKernel.h"
+#include "congestion_unaware/DelayOffload.h"
+#include "congestion_unaware/DelayService.h"
+#include "congestion_unaware/ExecutionTraceAdapter.h"
+#include "congestion_unaware/FullyConnected.h"
 #include "congestion_unaware/Helper.h"
+#include "congestion_unaware/LeafSpine.h"
+#include "congestion_unaware/Mesh2D.h"
+#include "congestion_unaware/MultiDimTopology.h"
+#include "congestion_unaware/PlacementEvaluator.h"
+#include "congestion_unaware/QueueingModel.h"
+#include "congestion_unaware/Ring.h"
+#include "congestion_unaware/SparseMesh2D.h"
+#include "congestion_unaware/StaticMultiDimTopology.h"
+#include "congestion_unaware/Switch.h"
+#include "congestion_unaware/Torus.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <gtest/gtest.h>
 
 using namespace NetworkAnalytical;
@@ -31,6 +58,17 @@ TEST_F(TestNetworkAnalyticalCongestionUnaware, Ring) {
     EXPECT_EQ(comm_delay, 21'031);
 }
 
+TEST_F(TestNetworkAnalyticalCongestionUnaware, RingStriping) {
+    // 4 MB from NPU 0 to its neighbor 1: 3 MB go the shorter way, 1 MB the longer way (3 hops)
+    const auto ring = Ring(4, 50, 500);
+    EXPECT_EQ(ring.send_striped(0, 1, 4 * chunk_size), ring.send(0, 1, 3 * chunk_size));
+    EXPECT_LT(ring.send_striped(0, 1, 4 * chunk_size), ring.send(0, 1, 4 * chunk_size));
+
+    // a unidirectional ring sends the transfer as a single chunk
+    const auto unidirectional_ring = Ring(4, 50, 500, false);
+    EXPECT_EQ(unidirectional_ring.send_striped(0, 1, 4 * chunk_size), unidirectional_ring.send(0, 1, 4 * chunk_size));
+}
+
 TEST_F(TestNetworkAnalyticalCongestionUnaware, FullyConnected) {
     // create network
     const auto network_parser = NetworkParser("../../input/FullyConnected.yml");
@@ -51,6 +89,116 @@ TEST_F(TestNetworkAnalyticalCongestionUnaware, Switch) {
     EXPECT_EQ(comm_delay, 20'531);
 }
 
+TEST_F(TestNetworkAnalyticalCongestionUnaware, Torus) {
+    // create network
+    const auto network_parser = NetworkParser("../../input/Torus3D.yml");
+    const auto topology = construct_topology(network_parser);
+    EXPECT_EQ(topology->get_npus_count(), 64);
+
+    // run communication: (0, 0, 0) -> (3, 3, 3) wraps around every dimension, taking 3 hops
+    const auto comm_delay = topology->send(0, 63, chunk_size);
+    EXPECT_EQ(comm_delay, 21'031);
+
+    // test: hops take the shorter way around each ring (4x3 torus)
+    const auto torus = Torus(4, 3, 50, 500);
+    EXPECT_EQ(torus.get_hops_count(0, 11), 2);
+    EXPECT_EQ(torus.get_hops_count(0, 2), 2);
+    EXPECT_EQ(torus.get_hops_count(5, 10), 2);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, LeafSpine) {
+    // create network: a 2-tier FatTree of 6-NPU leaves, 3 downlinks per uplink
+    const auto network_parser = NetworkParser("../../input/LeafSpine.yml");
+    const auto topology = std::dynamic_pointer_cast<LeafSpine>(construct_topology(network_parser));
+    ASSERT_NE(topology, nullptr);
+    EXPECT_EQ(topology->get_leaf_size(), 6);
+    EXPECT_EQ(topology->get_leaves_count(), 4);
+    EXPECT_DOUBLE_EQ(topology->get_oversubscription(), 3.0);
+
+    // test: within a leaf, a chunk takes 2 hops at the link bandwidth, as on a switch
+    const auto leaf_spine = LeafSpine(8, 4, 2.0, 50, 500);
+    EXPECT_EQ(leaf_spine.get_hops_count(0, 3), 2);
+    EXPECT_EQ(leaf_spine.send(0, 3, chunk_size), Switch(8, 50, 500).send(0, 3, chunk_size));
+
+    // test: across the spines, it takes 4 hops at the oversubscribed bandwidth (50 / 2 GB/s)
+    EXPECT_EQ(leaf_spine.get_hops_count(0, 5), 4);
+    EXPECT_EQ(leaf_spine.send(0, 5, chunk_size), 41'062);
+
+    // test: batches match single sends
+    const auto srcs = std::vector<DeviceId>{0, 1, 7, 4};
+    const auto dests = std::vector<DeviceId>{3, 6, 0, 5};
+    const auto chunk_sizes = std::vector<ChunkSize>(4, chunk_size);
+    auto delays = std::vector<EventTime>(4);
+    leaf_spine.send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), 4);
+    for (auto i = 0; i < 4; i++) {
+        EXPECT_EQ(delays[i], leaf_spine.send(srcs[i], dests[i], chunk_size));
+    }
+
+    // test: cross-spine routes go through the aggregated uplinks of the src leaf and downlinks of the dest leaf
+    auto link_ids = std::vector<int>(leaf_spine.get_max_route_links_count());
+    ASSERT_EQ(leaf_spine.write_route_links(0, 5, link_ids.data()), 4);
+    EXPECT_EQ(link_ids, (std::vector<int>{0, 16, 19, 13}));
+    EXPECT_EQ(leaf_spine.get_links_count(), 20);
+    EXPECT_DOUBLE_EQ(leaf_spine.get_link_bandwidth(16), 100.0);
+    EXPECT_DOUBLE_EQ(leaf_spine.get_link_bandwidth(13), 50.0);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, Mesh2D) {
+    // create network
+    const auto network_parser = NetworkParser("../../input/Mesh2D.yml");
+    const auto topology = construct_topology(network_parser);
+    EXPECT_EQ(topology->get_npus_count(), 16);
+
+    // run communication: corner to corner of the 4x4 mesh takes 6 hops, as 0 -> 6 on a 16-NPU ring
+    const auto ring = Ring(16, 50, 500);
+    EXPECT_EQ(topology->send(0, 15, chunk_size), ring.send(0, 6, chunk_size));
+
+    // test: Manhattan distance (4x3 mesh)
+    const auto mesh = Mesh2D(4, 3, 50, 500);
+    EXPECT_EQ(mesh.get_hops_count(0, 11), 5);
+    EXPECT_EQ(mesh.get_hops_count(5, 6), 1);
+    EXPECT_EQ(mesh.get_hops_count(3, 8), 5);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SparseMesh2D) {
+    // create network: 3x3 grid whose center is excluded
+    //   0 - 1 - 2
+    //   |       |
+    //   3   x   4
+    //   |       |
+    //   5 - 6 - 7
+    auto valid_cells = std::vector<bool>(9, true);
+    valid_cells[4] = false;
+    const auto mesh = SparseMesh2D(3, 3, valid_cells, 50, 500);
+    EXPECT_EQ(mesh.get_npus_count(), 8);
+    EXPECT_EQ(mesh.get_npu_cell(4), 5);
+    EXPECT_EQ(mesh.get_distance_matrix_bytes(), 8 * 8 * sizeof(uint16_t));
+
+    // test: shortest paths go around the hole
+    EXPECT_EQ(mesh.get_hops_count(1, 6), 4);
+    EXPECT_EQ(mesh.get_hops_count(3, 4), 4);
+    EXPECT_EQ(mesh.get_hops_count(0, 7), 4);
+    EXPECT_EQ(mesh.get_hops_count(0, 1), 1);
+
+    // test: batched queries match
+    const auto srcs = std::vector<DeviceId>{1, 3, 0, 2};
+    const auto dests = std::vector<DeviceId>{6, 4, 7, 5};
+    const auto chunk_sizes = std::vector<ChunkSize>(srcs.size(), chunk_size);
+    auto delays = std::vector<EventTime>(srcs.size());
+    mesh.send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), static_cast<int>(srcs.size()));
+    for (auto i = 0; i < static_cast<int>(srcs.size()); i++) {
+        EXPECT_EQ(delays[i], mesh.send(srcs[i], dests[i], chunk_size));
+    }
+
+    // test: custom placement numbers the placed cells first, the rest in row-major order
+    auto npu_placement_grid = std::vector<int>(9, -1);
+    npu_placement_grid[8] = 0;
+    const auto placed_mesh = SparseMesh2D(3, 3, valid_cells, npu_placement_grid, 50, 500);
+    EXPECT_EQ(placed_mesh.get_npu_cell(0), 8);
+    EXPECT_EQ(placed_mesh.get_npu_cell(1), 0);
+    EXPECT_EQ(placed_mesh.get_hops_count(0, 1), 4);
+}
+
 TEST_F(TestNetworkAnalyticalCongestionUnaware, Ring_FullyConnected_Switch) {
     // create network
     const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
@@ -68,3 +216,603 @@ TEST_F(TestNetworkAnalyticalCongestionUnaware, Ring_FullyConnected_Switch) {
     const auto comm_delay_dim3 = topology->send(26, 42, chunk_size);
     EXPECT_EQ(comm_delay_dim3, 23'531);
 }
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, MultiDimTransfer) {
+    // create network: Ring(2) x FullyConnected(8) x Switch(4), as in Ring_FullyConnected_Switch.yml
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    auto multi_dim_topology = MultiDimTopology();
+    multi_dim_topology.append_dimension(std::make_unique<Ring>(2, 200, 50));
+    multi_dim_topology.append_dimension(std::make_unique<FullyConnected>(8, 100, 500));
+    multi_dim_topology.append_dimension(std::make_unique<Switch>(4, 50, 2000));
+
+    // run communication: 0 = [0, 0, 0] -> 39 = [1, 3, 2] crosses every dimension,
+    // with 50 + 500 + 2 * 2000 ns of links, and 1 MB serialized at 50 GB/s (the bottleneck) when pipelined
+    EXPECT_EQ(topology->send(0, 39, chunk_size), 24'081);
+    EXPECT_EQ(multi_dim_topology.send(0, 39, chunk_size), 24'081);
+
+    // test: stored and forwarded between dimensions, serialized at 200, 100, and 50 GB/s in turn
+    multi_dim_topology.set_dim_pipelining(false);
+    EXPECT_FALSE(multi_dim_topology.get_dim_pipelining());
+    EXPECT_EQ(multi_dim_topology.send(0, 39, chunk_size), 38'729);
+    using RingFullyConnectedSwitch = StaticMultiDimTopology<Ring, FullyConnected, Switch>;
+    const auto static_topology = std::dynamic_pointer_cast<RingFullyConnectedSwitch>(topology);
+    ASSERT_NE(static_topology, nullptr);
+    static_topology->set_dim_pipelining(false);
+    EXPECT_EQ(topology->send(0, 39, chunk_size), 38'729);
+
+    // test: single-dimension transfers are unchanged, and local ones are free
+    EXPECT_EQ(multi_dim_topology.send(26, 42, chunk_size), 23'531);
+    EXPECT_EQ(multi_dim_topology.send(5, 5, chunk_size), 0);
+
+    // test: batched sends match
+    const auto srcs = std::vector<DeviceId>{0, 26, 5, 63};
+    const auto dests = std::vector<DeviceId>{39, 42, 5, 0};
+    const auto chunk_sizes = std::vector<ChunkSize>(srcs.size(), chunk_size);
+    auto delays = std::vector<EventTime>(srcs.size());
+    multi_dim_topology.send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(),
+                                  static_cast<int>(srcs.size()));
+    for (auto i = 0; i < static_cast<int>(srcs.size()); i++) {
+        EXPECT_EQ(delays[i], multi_dim_topology.send(srcs[i], dests[i], chunk_size));
+        EXPECT_EQ(delays[i], topology->send(srcs[i], dests[i], chunk_size));
+    }
+
+    // test: closed-form All-to-All follows the store-and-forward sends
+    const auto npus_count = multi_dim_topology.get_npus_count();
+    auto all_to_all = EventTime(0);
+    for (int dest = 1; dest < npus_count; dest++) {
+        all_to_all += multi_dim_topology.send(0, dest, chunk_size);
+    }
+    EXPECT_NEAR(multi_dim_topology.compute_all_to_all_cost(npus_count * chunk_size), all_to_all, npus_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, QueueingModel) {
+    // create network: NPU 0 offers 25 GB/s to NPU 1, half of the link 0 -> 1
+    const auto npus_count = 4;
+    const auto ring = std::make_shared<Ring>(npus_count, 50, 500);
+    auto model = QueueingModel(ring);
+    auto traffic_matrix = std::vector<Bandwidth>(npus_count * npus_count, 0);
+    traffic_matrix[0 * npus_count + 1] = 25;
+    model.set_traffic_matrix(traffic_matrix);
+
+    // test: M/D/1 at 50% utilization waits half a service time (1 MB at 50 GB/s) on the link 0 -> 1 only
+    EXPECT_DOUBLE_EQ(model.get_link_utilization(0), 0.5);
+    EXPECT_DOUBLE_EQ(model.get_max_link_utilization(), 0.5);
+    EXPECT_EQ(model.get_saturated_links_count(), 0);
+    EXPECT_EQ(model.send(0, 1, chunk_size), ring->send(0, 1, chunk_size) + 9'765);
+    EXPECT_EQ(model.send(1, 2, chunk_size), ring->send(1, 2, chunk_size));
+    EXPECT_EQ(model.send(0, 2, chunk_size), ring->send(0, 2, chunk_size));
+
+    // test: oversubscribed links are capped
+    traffic_matrix[0 * npus_count + 1] = 60;
+    model.set_traffic_matrix(traffic_matrix);
+    EXPECT_EQ(model.get_saturated_links_count(), 1);
+    EXPECT_GT(model.send(0, 1, chunk_size), 40 * ring->send(0, 1, chunk_size));
+
+    // test: routes cover as many links as hops
+    const auto torus = Torus(4, 3, 2, 50, 500);
+    const auto mesh = Mesh2D(4, 3, 50, 500);
+    auto valid_cells = std::vector<bool>(9, true);
+    valid_cells[4] = false;
+    const auto sparse_mesh = SparseMesh2D(3, 3, valid_cells, 50, 500);
+    for (const auto* const topology : std::initializer_list<const BasicTopology*>{&torus, &mesh, &sparse_mesh}) {
+        auto link_ids = std::vector<int>(topology->get_max_route_links_count());
+        for (auto src = 0; src < topology->get_npus_count(); src++) {
+            for (auto dest = 0; dest < topology->get_npus_count(); dest++) {
+                if (src != dest) {
+                    EXPECT_EQ(topology->write_route_links(src, dest, link_ids.data()),
+                              topology->get_hops_count(src, dest));
+                }
+            }
+        }
+    }
+
+    // setup: uniform traffic on Ring(2) x FullyConnected(8) x Switch(4)
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto multi_dim_topology = construct_topology(network_parser);
+    const auto multi_dim_npus_count = multi_dim_topology->get_npus_count();
+    auto multi_dim_model = QueueingModel(multi_dim_topology);
+    multi_dim_model.set_traffic_matrix(std::vector<Bandwidth>(multi_dim_npus_count * multi_dim_npus_count, 0.1));
+
+    // test: symmetric traffic loads every copy of the Ring links alike (NPU i -> i + 1 and back, 32 copies each)
+    EXPECT_EQ(multi_dim_topology->get_links_count(), 2 * 2 * 32 + 8 * 8 * 8 + 8 * 16);
+    for (auto link_id = 0; link_id < 2 * 2 * 32; link_id++) {
+        if (multi_dim_model.get_link_utilization(link_id) > 0) {
+            EXPECT_DOUBLE_EQ(multi_dim_model.get_link_utilization(link_id), 32 * 0.1 / 200);
+        }
+    }
+
+    // test: the delay matrix matches one send per pair, sequentially and in parallel
+    const auto delay_matrix = multi_dim_model.compute_delay_matrix(chunk_size);
+    EXPECT_EQ(delay_matrix, multi_dim_model.compute_delay_matrix(chunk_size, 4));
+    for (auto src = 0; src < multi_dim_npus_count; src++) {
+        for (auto dest = 0; dest < multi_dim_npus_count; dest++) {
+            const auto delay = delay_matrix[src * multi_dim_npus_count + dest];
+            EXPECT_EQ(delay, multi_dim_model.send(src, dest, chunk_size));
+            if (src != dest) {
+                EXPECT_GT(delay, multi_dim_topology->send(src, dest, chunk_size));
+            }
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SendBatch) {
+    for (const auto* const config : {"../../input/Ring.yml", "../../input/FullyConnected.yml",
+                                     "../../input/Switch.yml", "../../input/Ring_FullyConnected_Switch.yml",
+                                     "../../input/Torus3D.yml"}) {
+        // create network
+        const auto network_parser = NetworkParser(config);
+        const auto topology = construct_topology(network_parser);
+        const auto npus_count = topology->get_npus_count();
+
+        // all (src, dest) pairs, with varying chunk sizes
+        auto srcs = std::vector<DeviceId>();
+        auto dests = std::vector<DeviceId>();
+        auto chunk_sizes = std::vector<ChunkSize>();
+        for (int i = 0; i < npus_count; i++) {
+            for (int j = 0; j < npus_count; j++) {
+                if (i != j) {
+                    srcs.push_back(i);
+                    dests.push_back(j);
+                    chunk_sizes.push_back(chunk_size * (1 + (i + j) % 3));
+                }
+            }
+        }
+
+        // run batched communication
+        const auto count = static_cast<int>(srcs.size());
+        auto delays = std::vector<EventTime>(count);
+        topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), count);
+
+        // test: same as one send per chunk
+        for (int i = 0; i < count; i++) {
+            EXPECT_EQ(delays[i], topology->send(srcs[i], dests[i], chunk_sizes[i]));
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SendBatchSimdLevels) {
+    // odd-sized ring, so vector tails are exercised
+    const auto topology = Ring(509, 50.0, 500.0);
+    const auto npus_count = topology.get_npus_count();
+
+    // pseudo-random pairs and sizes, including a chunk beyond 2^52 bytes
+    auto srcs = std::vector<DeviceId>();
+    auto dests = std::vector<DeviceId>();
+    auto chunk_sizes = std::vector<ChunkSize>();
+    for (int i = 0; i < 1'003; i++) {
+        const auto src = (i * 7919) % npus_count;
+        const auto dest = (src + 1 + (i * 104'729) % (npus_count - 1)) % npus_count;
+        srcs.push_back(src);
+        dests.push_back(dest);
+        chunk_sizes.push_back(1 + (static_cast<ChunkSize>(i) * 2'654'435'761) % (64 * chunk_size));
+    }
+    chunk_sizes[5] = ChunkSize{1} << 53;
+
+    for (const auto simd_level : {SimdLevel::Scalar, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        DelayKernel::set_simd_level(simd_level);
+
+        // run batched communication
+        const auto count = static_cast<int>(srcs.size());
+        auto delays = std::vector<EventTime>(count);
+        topology.send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), count);
+
+        // test: bit-identical to one send per chunk
+        for (int i = 0; i < count; i++) {
+            EXPECT_EQ(delays[i], topology.send(srcs[i], dests[i], chunk_sizes[i]));
+        }
+    }
+
+    // restore the default
+    DelayKernel::set_simd_level(DelayKernel::get_supported_simd_level());
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, MultiDimAddressTable) {
+    // small topology (precomputed addresses) and large topology (decoded addresses) of the same inner shape
+    auto small_topology = MultiDimTopology();
+    small_topology.append_dimension(std::make_unique<Ring>(8, 50, 500));
+    small_topology.append_dimension(std::make_unique<Switch>(4, 25, 700));
+
+    auto large_topology = MultiDimTopology();
+    large_topology.append_dimension(std::make_unique<Ring>(8, 50, 500));
+    large_topology.append_dimension(std::make_unique<Switch>(16'384, 25, 700));
+    ASSERT_GT(large_topology.get_npus_count(), MultiDimTopology::address_table_max_npus_count);
+
+    // test: both address translations pick the same dimension and local ids
+    for (int src = 0; src < 32; src++) {
+        for (int dest = 0; dest < 32; dest++) {
+            if (src != dest) {
+                EXPECT_EQ(small_topology.send(src, dest, chunk_size), large_topology.send(src, dest, chunk_size));
+            }
+        }
+    }
+
+    // test: last NPUs of the large topology
+    const auto last_npu = large_topology.get_npus_count() - 1;
+    const auto ring = Ring(8, 50, 500);
+    const auto top_switch = Switch(16'384, 25, 700);
+    EXPECT_EQ(large_topology.send(last_npu, last_npu - 1, chunk_size), ring.send(7, 6, chunk_size));
+    EXPECT_EQ(large_topology.send(last_npu, last_npu - 8, chunk_size), top_switch.send(16'383, 16'382, chunk_size));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, StaticMultiDimTopology) {
+    // create network: the config matches the prebuilt Ring x FullyConnected x Switch stack
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto topology = construct_topology(network_parser);
+    using RingFullyConnectedSwitch = StaticMultiDimTopology<Ring, FullyConnected, Switch>;
+    ASSERT_NE(std::dynamic_pointer_cast<RingFullyConnectedSwitch>(topology), nullptr);
+    EXPECT_EQ(topology->get_npus_count(), 64);
+    EXPECT_EQ(topology->get_dims_count(), 3);
+
+    // equivalent runtime stack
+    auto multi_dim_topology = MultiDimTopology();
+    multi_dim_topology.append_dimension(std::make_unique<Ring>(2, 200, 50));
+    multi_dim_topology.append_dimension(std::make_unique<FullyConnected>(8, 100, 500));
+    multi_dim_topology.append_dimension(std::make_unique<Switch>(4, 50, 2000));
+
+    // test: same delays for every pair
+    for (int src = 0; src < 64; src++) {
+        for (int dest = 0; dest < 64; dest++) {
+            if (src != dest) {
+                EXPECT_EQ(topology->send(src, dest, chunk_size), multi_dim_topology.send(src, dest, chunk_size));
+            }
+        }
+    }
+
+    // test: other stacks don't match
+    EXPECT_FALSE(RingFullyConnectedSwitch::matches(NetworkParser("../../input/Ring.yml")));
+    EXPECT_FALSE((StaticMultiDimTopology<Ring, Switch, FullyConnected>::matches(network_parser)));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, DelayMatrix) {
+    for (const auto* const config : {"../../input/Ring.yml", "../../input/Ring_FullyConnected_Switch.yml"}) {
+        // create network
+        const auto network_parser = NetworkParser(config);
+        const auto topology = construct_topology(network_parser);
+        const auto npus_count = topology->get_npus_count();
+
+        // sequential and parallel matrices
+        const auto delay_matrix = topology->compute_delay_matrix(chunk_size);
+        EXPECT_EQ(delay_matrix, topology->compute_delay_matrix(chunk_size, 4));
+
+        // test: same as one send per pair
+        ASSERT_EQ(delay_matrix.size(), npus_count * npus_count);
+        for (int src = 0; src < npus_count; src++) {
+            for (int dest = 0; dest < npus_count; dest++) {
+                const auto expected = (src == dest) ? 0 : topology->send(src, dest, chunk_size);
+                EXPECT_EQ(delay_matrix[src * npus_count + dest], expected);
+            }
+        }
+
+        // test: binary file round trip
+        const auto path = ::testing::TempDir() + "delay_matrix.bin";
+        topology->export_delay_matrix(path, chunk_size);
+        auto imported_npus_count = 0;
+        auto imported_chunk_size = ChunkSize();
+        EXPECT_EQ(Topology::import_delay_matrix(path, imported_npus_count, imported_chunk_size), delay_matrix);
+        EXPECT_EQ(imported_npus_count, npus_count);
+        EXPECT_EQ(imported_chunk_size, chunk_size);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, CollectiveCosts) {
+    // Ring(2) x FullyConnected(8) x Switch(4), as in Ring_FullyConnected_Switch.yml
+    auto topology = MultiDimTopology();
+    topology.append_dimension(std::make_unique<Ring>(2, 200, 50));
+    topology.append_dimension(std::make_unique<FullyConnected>(8, 100, 500));
+    topology.append_dimension(std::make_unique<Switch>(4, 50, 2000));
+    const auto npus_count = topology.get_npus_count();
+    const auto collective_size = npus_count * chunk_size;
+
+    // reference: per-dimension sends
+    const auto ring = Ring(2, 200, 50);
+    const auto fully_connected = FullyConnected(8, 100, 500);
+    const auto top_switch = Switch(4, 50, 2000);
+
+    // test: hierarchical All-Reduce = 2 (p - 1) neighbor steps per dim on ever smaller shards
+    // (closed-form costs are truncated once, so allow one ns per summed step)
+    const auto hierarchical_all_reduce = 2 * ring.send(0, 1, collective_size / 2) +
+                                         14 * fully_connected.send(0, 1, collective_size / 16) +
+                                         6 * top_switch.send(0, 1, collective_size / 64);
+    EXPECT_NEAR(topology.compute_hierarchical_all_reduce_cost(collective_size), hierarchical_all_reduce, 22);
+
+    // test: hierarchical Reduce-Scatter and All-Gather are each half of the All-Reduce
+    const auto half_all_reduce = topology.compute_hierarchical_all_reduce_cost(collective_size) / 2;
+    EXPECT_NEAR(topology.compute_hierarchical_collective_cost(CollectiveType::ReduceScatter, collective_size),
+                half_all_reduce, 1);
+    EXPECT_NEAR(topology.compute_hierarchical_collective_cost(CollectiveType::AllGather, collective_size),
+                half_all_reduce, 1);
+
+    // test: pipelined chunks add only the busiest dimension's serialization per extra chunk
+    // (the fully-connected dimension: 14 steps on 1/16 of each chunk at 100 GB/s)
+    const auto chunk_cost = 2 * ring.send(0, 1, collective_size / 8) +
+                            14 * fully_connected.send(0, 1, collective_size / 64) +
+                            6 * top_switch.send(0, 1, collective_size / 256);
+    const auto busiest_dim_cost =
+        14 * (fully_connected.send(0, 1, collective_size / 64) - fully_connected.send(0, 1, 0));
+    EXPECT_NEAR(topology.compute_hierarchical_collective_cost(CollectiveType::AllReduce, collective_size, 4),
+                chunk_cost + (3 * busiest_dim_cost), 40);
+    EXPECT_LT(topology.compute_hierarchical_collective_cost(CollectiveType::AllReduce, collective_size, 4),
+              topology.compute_hierarchical_all_reduce_cost(collective_size));
+
+    // test: flat ring All-Reduce is bound by the slowest dimension
+    const auto slowest_step = std::max({ring.send(0, 1, chunk_size), fully_connected.send(0, 1, chunk_size),
+                                        top_switch.send(0, 1, chunk_size)});
+    EXPECT_NEAR(topology.compute_ring_all_reduce_cost(collective_size), 2 * (npus_count - 1) * slowest_step,
+                2 * (npus_count - 1));
+
+    // test: All-to-All = sum of the sends from an NPU to every peer
+    auto all_to_all = EventTime(0);
+    for (int dest = 1; dest < npus_count; dest++) {
+        all_to_all += topology.send(0, dest, chunk_size);
+    }
+    EXPECT_NEAR(topology.compute_all_to_all_cost(collective_size), all_to_all, npus_count);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, ExecutionTraceReplay) {
+    // NPU 0 sends to NPU 1 twice (matched by tag); every NPU then joins an All-Gather
+    const auto write_trace = [](const std::string& trace_path, const std::string& nodes) {
+        auto trace_file = std::ofstream(trace_path);
+        trace_file << nodes;
+        return trace_path;
+    };
+    const auto trace_paths = std::vector<std::string>{
+        write_trace("et_test.0.txt", "id=1 type=COMM_SEND_NODE comm_dst=1 comm_size=1048576 comm_tag=1\n"
+                                     "id=2 type=COMM_SEND_NODE comm_dst=1 comm_size=1048576 comm_tag=2 deps=1\n"
+                                     "id=3 type=COMM_COLL_NODE comm_type=ALL_GATHER comm_size=8388608 deps=2\n"),
+        write_trace("et_test.1.txt", "id=1 type=COMM_RECV_NODE comm_src=0 comm_size=1048576 comm_tag=2\n"
+                                     "id=2 type=COMM_COLL_NODE comm_type=ALL_GATHER comm_size=8388608 deps=1\n"
+                                     "id=3 type=COMM_RECV_NODE comm_src=0 comm_size=1048576 comm_tag=1\n"),
+        write_trace("et_test.2.txt", "id=1 type=COMM_COLL_NODE comm_type=ALL_GATHER comm_size=8388608\n"),
+        write_trace("et_test.3.txt", "id=1 type=COMM_COLL_NODE comm_type=ALL_GATHER comm_size=8388608\n"),
+    };
+
+    auto event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(4, 50, 500);
+    auto network = ExecutionTraceAdapter(topology, event_queue);
+    auto replay = ExecutionTraceReplay(network, trace_paths);
+    replay.start();
+    event_queue->run_to_completion();
+
+    // test: the sends are serialized, then the All-Gather takes 3 steps of a 1/4 shard
+    const auto all_gather_cost = 3 * topology->send(0, 1, 2'097'152);
+    EXPECT_EQ(network.compute_collective_cost(CollectiveType::AllGather, 8'388'608), all_gather_cost);
+    EXPECT_TRUE(replay.finished());
+    EXPECT_EQ(replay.get_completed_nodes_count(), 8);
+    EXPECT_EQ(replay.get_finish_time(), 2 * topology->send(0, 1, chunk_size) + all_gather_cost);
+
+    for (const auto& trace_path : trace_paths) {
+        std::remove(trace_path.c_str());
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, PlacementEvaluator) {
+    // a 4-rank ring job placed on a bidirectional ring of 8 NPUs
+    const auto topology = std::make_shared<Ring>(8, 50, 500);
+    auto messages = std::vector<JobMessage>();
+    for (auto rank = 0; rank < 4; rank++) {
+        messages.push_back(JobMessage{rank, (rank + 1) % 4, chunk_size});
+    }
+    const auto candidates = std::vector<std::vector<DeviceId>>{{0, 1, 2, 3}, {0, 2, 4, 6}, {0, 4, 1, 5}};
+
+    // test: Delay scores the slowest message, so spreading the ranks evenly (2 hops each) is best
+    const auto delay_evaluator = PlacementEvaluator(topology, messages, PlacementCost::Delay);
+    EXPECT_EQ(delay_evaluator.get_ranks_count(), 4);
+    EXPECT_EQ(delay_evaluator.evaluate(candidates[0]), topology->send(3, 0, chunk_size));
+    const auto delay_ranking = delay_evaluator.rank(candidates, 2);
+    ASSERT_EQ(delay_ranking.size(), 2);
+    EXPECT_EQ(delay_ranking[0].candidate, 1);
+    EXPECT_EQ(delay_ranking[0].cost, topology->send(0, 2, chunk_size));
+
+    // test: LinkLoad scores the bottleneck link, which the interleaved placement loads twice
+    const auto load_evaluator = PlacementEvaluator(topology, messages, PlacementCost::LinkLoad);
+    const auto serialization_time = static_cast<double>(chunk_size) / bw_GBps_to_Bpns(50) * ticks_per_ns;
+    EXPECT_DOUBLE_EQ(load_evaluator.evaluate(candidates[0]), serialization_time);
+    EXPECT_DOUBLE_EQ(load_evaluator.evaluate(candidates[2]), 2 * serialization_time);
+    const auto load_ranking = load_evaluator.rank(candidates, 3);
+    ASSERT_EQ(load_ranking.size(), 3);
+    EXPECT_EQ(load_ranking[0].candidate, 0);
+    EXPECT_EQ(load_ranking[1].candidate, 1);
+    EXPECT_EQ(load_ranking[2].candidate, 2);
+
+    // test: scoring in parallel gives the same ranking
+    const auto parallel_ranking = load_evaluator.rank(candidates, 3, 4);
+    for (auto i = 0; i < 3; i++) {
+        EXPECT_EQ(parallel_ranking[i].candidate, load_ranking[i].candidate);
+        EXPECT_EQ(parallel_ranking[i].cost, load_ranking[i].cost);
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, DelayService) {
+    auto delay_service = DelayService();
+    auto server = QueryServer(
+        "/tmp/network_analytical_delay_service.sock",
+        [&delay_service](const std::string& request) { return delay_service.answer(request); }, 16);
+    server.start();
+
+    auto query = ChunkQuery();
+    query.config_path = "../../input/Ring.yml";
+    query.srcs = {0, 0, 3};
+    query.dests = {1, 8, 3};
+    query.chunk_sizes = {chunk_size, chunk_size, chunk_size};
+
+    // test: two clients get the delays of the topology, which the server constructs once
+    const auto topology = construct_topology(NetworkParser(query.config_path));
+    for (auto client_id = 0; client_id < 2; client_id++) {
+        auto client = QueryClient("/tmp/network_analytical_delay_service.sock");
+        auto delays = std::vector<EventTime>();
+        ASSERT_TRUE(ChunkQuery::decode_answer(client.query(query.encode()), delays));
+        ASSERT_EQ(delays.size(), 3);
+        for (auto i = 0; i < 3; i++) {
+            EXPECT_EQ(delays[i], topology->send(query.srcs[i], query.dests[i], chunk_size));
+        }
+    }
+    EXPECT_EQ(delay_service.get_topologies_count(), 1);
+
+    // test: the second client is answered from the cache
+    EXPECT_EQ(server.get_requests_count(), 2);
+    EXPECT_EQ(server.get_cache_hits_count(), 1);
+
+    // test: malformed requests, missing configs, and invalid NPU IDs get an empty answer
+    auto client = QueryClient("/tmp/network_analytical_delay_service.sock");
+    EXPECT_TRUE(client.query("malformed").empty());
+    auto missing_query = query;
+    missing_query.config_path = "../../input/Missing.yml";
+    EXPECT_TRUE(client.query(missing_query.encode()).empty());
+    auto invalid_query = query;
+    invalid_query.dests[0] = 16;
+    EXPECT_TRUE(client.query(invalid_query.encode()).empty());
+
+    server.stop();
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, CApi) {
+    EXPECT_EQ(analytical_unaware_api_version(), ANALYTICAL_UNAWARE_API_VERSION);
+    EXPECT_EQ(analytical_unaware_create("../../input/Missing.yml"), nullptr);
+
+    auto* const handle = analytical_unaware_create("../../input/Ring.yml");
+    ASSERT_NE(handle, nullptr);
+    EXPECT_EQ(analytical_unaware_npus_count(handle), 16);
+
+    // test: the handle gives the delays of the topology
+    const auto topology = construct_topology(NetworkParser("../../input/Ring.yml"));
+    EXPECT_EQ(analytical_unaware_send(handle, 0, 5, chunk_size), topology->send(0, 5, chunk_size));
+    EXPECT_EQ(analytical_unaware_send(handle, 0, 16, chunk_size), UINT64_MAX);
+
+    // test: batches are written into caller-owned buffers
+    const int32_t srcs[] = {0, 3, 15};
+    const int32_t dests[] = {8, 4, 0};
+    const uint64_t chunk_sizes[] = {chunk_size, 1024, chunk_size};
+    uint64_t delays[3];
+    ASSERT_EQ(analytical_unaware_send_batch(handle, srcs, dests, chunk_sizes, delays, 3), 0);
+    for (auto i = 0; i < 3; i++) {
+        EXPECT_EQ(delays[i], topology->send(srcs[i], dests[i], chunk_sizes[i]));
+    }
+    const int32_t invalid_dests[] = {8, -1, 0};
+    EXPECT_EQ(analytical_unaware_send_batch(handle, srcs, invalid_dests, chunk_sizes, delays, 3), -1);
+
+    analytical_unaware_destroy(handle);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, DriverOptions) {
+    const char* const argv[] = {"driver", "--network", "Ring.yml", "--size", "4096", "--collective", "AllToAll"};
+    const auto command_line = CommandLine(7, argv, {"network", "size", "collective", "algorithm"}, "usage");
+
+    // test: given options are parsed, and missing ones take their default
+    EXPECT_EQ(command_line.get_string("network", ""), "Ring.yml");
+    EXPECT_EQ(command_line.get_uint64("size", 0), 4096);
+    EXPECT_EQ(command_line.get_collective_type("collective", CollectiveType::AllGather), CollectiveType::AllToAll);
+    EXPECT_FALSE(command_line.has("algorithm"));
+    EXPECT_EQ(command_line.get_collective_algorithm("algorithm", CollectiveAlgorithm::Ring), CollectiveAlgorithm::Ring);
+
+    // test: results are written as JSON, with strings escaped
+    auto workload = JsonObject();
+    workload.add("type", "send").add("size", uint64_t(4096));
+    auto results = JsonObject();
+    results.add("network", "a\"b").add("workload", workload).add("stats_enabled", false).add("seconds", 0.5);
+    EXPECT_EQ(results.str(), R"({"network": "a\"b", "workload": {"type": "send", "size": 4096}, )"
+                             R"("stats_enabled": false, "seconds": 0.5})");
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, DelayOffload) {
+    for (const auto* const config : {"../../input/Ring.yml", "../../input/FullyConnected.yml", "../../input/Switch.yml",
+                                     "../../input/Ring_FullyConnected_Switch.yml"}) {
+        const auto network_parser = NetworkParser(config);
+        const auto topology = construct_topology(network_parser);
+        const auto npus_count = topology->get_npus_count();
+
+        // the host path is checked even where a GPU is present
+        for (const auto gpu_enabled : {false, true}) {
+            auto delay_offload = DelayOffload(network_parser);
+            delay_offload.set_gpu_enabled(gpu_enabled);
+            EXPECT_EQ(delay_offload.uses_gpu(), gpu_enabled && DelayOffload::gpu_available());
+
+            // test: same delay matrix as the topology
+            const auto delay_matrix = topology->compute_delay_matrix(chunk_size);
+            EXPECT_EQ(delay_offload.compute_delay_matrix(chunk_size), delay_matrix);
+            EXPECT_EQ(delay_offload.compute_delay_matrix(chunk_size, 4), delay_matrix);
+
+            // test: same batch delays as the topology, for assorted pairs and sizes
+            auto srcs = std::vector<DeviceId>();
+            auto dests = std::vector<DeviceId>();
+            auto chunk_sizes = std::vector<ChunkSize>();
+            for (auto i = 0; i < 200'000; i++) {
+                const auto src = (i * 7) % npus_count;
+                srcs.push_back(src);
+                dests.push_back((src + 1 + (i * 13) % (npus_count - 1)) % npus_count);
+                chunk_sizes.push_back(1 + (static_cast<ChunkSize>(i) * 104'729) % (64 * chunk_size));
+            }
+            auto expected_delays = std::vector<EventTime>(srcs.size());
+            topology->send_batch(srcs.data(), dests.data(), chunk_sizes.data(), expected_delays.data(),
+                                 static_cast<int>(srcs.size()));
+            auto delays = std::vector<EventTime>(srcs.size());
+            delay_offload.send_batch(srcs.data(), dests.data(), chunk_sizes.data(), delays.data(), srcs.size(), 4);
+            EXPECT_EQ(delays, expected_delays);
+        }
+    }
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, NetworkConfig) {
+    // the yml configuration, built in memory
+    const auto network_parser = NetworkParser("../../input/Ring_FullyConnected_Switch.yml");
+    const auto network_config = NetworkConfig()
+                                    .add_dim(TopologyBuildingBlock::Ring, 2, 200, 50)
+                                    .add_dim(TopologyBuildingBlock::FullyConnected, 8, 100, 500)
+                                    .add_dim(TopologyBuildingBlock::Switch, 4, 50, 2000);
+
+    // test: same configuration and delays as the yml one
+    EXPECT_EQ(NetworkParser(network_config).get_config_hash(), network_parser.get_config_hash());
+    const auto topology = construct_topology(network_config);
+    EXPECT_EQ(topology->compute_delay_matrix(chunk_size),
+              construct_topology(network_parser)->compute_delay_matrix(chunk_size));
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, SendGraph) {
+    /// setup: a 4-NPU pipeline, each stage sending to the next once it received, after a 1 us wait
+    auto graph = SendGraph();
+    auto previous = graph.add_send(0, 1, chunk_size);
+    for (auto npu = 1; npu < 3; npu++) {
+        const auto node = graph.add_send(npu, npu + 1, chunk_size, 1'000);
+        graph.add_dependency(previous, node);
+        previous = node;
+    }
+    graph.finalize();
+    EXPECT_GT(graph.get_allocated_bytes(), 0);
+
+    auto event_queue = std::make_shared<EventQueue>();
+    auto topology = std::make_shared<Ring>(4, 50, 500);
+    auto network = ExecutionTraceAdapter(topology, event_queue);
+    auto run = SendGraphRun(network, graph);
+    auto finished = false;
+    run.start([](void* const finished_ptr) { *static_cast<bool*>(finished_ptr) = true; }, &finished);
+    event_queue->run_to_completion();
+
+    /// test: the sends run one after another, each after its wait
+    EXPECT_TRUE(finished);
+    EXPECT_TRUE(run.finished());
+    EXPECT_EQ(run.get_completed_nodes_count(), 3);
+    EXPECT_EQ(run.get_peak_in_flight_count(), 1);
+    EXPECT_EQ(run.get_finish_time(), 3 * topology->send(0, 1, chunk_size) + 2'000);
+}
+
+TEST_F(TestNetworkAnalyticalCongestionUnaware, TryConstructTopology) {
+    // test: a valid configuration is constructed without errors
+    auto errors = std::vector<ConfigError>();
+    const auto ring = NetworkParser::try_parse(YAML::Load("{topology: [Ring], npus_count: [8], bandwidth: [50], "
+                                                          "latency: [500]}"),
+                                               errors);
+    ASSERT_TRUE(ring.has_value());
+    const auto topology = try_construct_topology(*ring, errors);
+    ASSERT_NE(topology, nullptr);
+    EXPECT_TRUE(errors.empty());
+    EXPECT_EQ(topology->send(0, 1, chunk_size), construct_topology(*ring)->send(0, 1, chunk_size));
+
+    // test: a fat-tree this backend can't build is reported instead of exiting
+    const auto fat_tree_config = YAML::Load("{topology: [FatTree], npus_count: [16], bandwidth: [50], latency: [500], "
+                                            "radix: 8, tiers: 3}");
+    const auto fat_tree = NetworkParser::try_parse(fat_tree_config, errors);
+    ASSERT_TRUE(fat_tree.has_value());
+    EXPECT_EQ(try_construct_topology(*fat_tree, errors), nullptr);
+    ASSERT_EQ(errors.size(), 1);
+    EXPECT_EQ(errors.front().key, "tiers");
+}